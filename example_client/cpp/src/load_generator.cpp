@@ -0,0 +1,971 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+// Open-loop load generator for OpenVINO Model Server.
+//
+// Requests are sent at scheduled times regardless of how fast the server responds,
+// and latency is measured from the scheduled time rather than from the actual send.
+// Closed-loop clients wait for a response before sending the next request, which
+// hides queueing delay when the server falls behind (coordinated omission).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/command_line_flags.h"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+
+#include "grpcpp/create_channel.h"
+#include "grpcpp/security/credentials.h"
+#include "grpcpp/support/channel_arguments.h"
+
+using tensorflow::serving::PredictionService;
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Latency histogram with bounded relative error in the spirit of HdrHistogram.
+ * Values below 2 * SUB_BUCKETS microseconds are counted exactly, larger values in buckets
+ * of width value / SUB_BUCKETS, which keeps 3 significant digits of every percentile.
+ */
+class LatencyHistogram {
+    static constexpr int SUB_BUCKET_BITS = 10;
+    static constexpr uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Largest tracked value is 2^37 us, about 38 hours
+    static constexpr int MAX_SHIFT = 26;
+    static constexpr uint64_t MAX_VALUE = (2 * SUB_BUCKETS << MAX_SHIFT) - 1;
+
+    std::vector<uint64_t> counts = std::vector<uint64_t>(2 * SUB_BUCKETS + MAX_SHIFT * SUB_BUCKETS, 0);
+    uint64_t totalCount = 0;
+    uint64_t minValue = UINT64_MAX;
+    uint64_t maxValue = 0;
+    double sum = 0;
+
+    static size_t indexOf(uint64_t value) {
+        if (value < 2 * SUB_BUCKETS) {
+            return value;
+        }
+        // value >> shift falls in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+        int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+        return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    }
+
+    static uint64_t highestEquivalentValue(size_t index) {
+        if (index < 2 * SUB_BUCKETS) {
+            return index;
+        }
+        size_t offset = index - 2 * SUB_BUCKETS;
+        int shift = offset / SUB_BUCKETS + 1;
+        uint64_t subBucket = offset % SUB_BUCKETS + SUB_BUCKETS;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+public:
+    void record(uint64_t valueUs) {
+        valueUs = std::min(valueUs, MAX_VALUE);
+        counts[indexOf(valueUs)]++;
+        totalCount++;
+        minValue = std::min(minValue, valueUs);
+        maxValue = std::max(maxValue, valueUs);
+        sum += valueUs;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        totalCount += other.totalCount;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+        sum += other.sum;
+    }
+
+    uint64_t count() const { return totalCount; }
+    uint64_t min() const { return totalCount ? minValue : 0; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return totalCount ? sum / totalCount : 0; }
+
+    uint64_t percentile(double percentile) const {
+        if (totalCount == 0) {
+            return 0;
+        }
+        uint64_t target = std::max<uint64_t>(1, std::ceil(percentile / 100 * totalCount));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= target) {
+                return std::min(highestEquivalentValue(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+};
+
+struct Payload {
+    PredictRequest grpcRequest;
+    std::string restBody;
+};
+
+static const char BASE64_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string encodeBase64(const std::string& bytes) {
+    std::string encoded;
+    encoded.reserve((bytes.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < bytes.size(); i += 3) {
+        uint32_t triple = (uint8_t)bytes[i] << 16 | (uint8_t)bytes[i + 1] << 8 | (uint8_t)bytes[i + 2];
+        encoded += BASE64_CHARS[(triple >> 18) & 0x3F];
+        encoded += BASE64_CHARS[(triple >> 12) & 0x3F];
+        encoded += BASE64_CHARS[(triple >> 6) & 0x3F];
+        encoded += BASE64_CHARS[triple & 0x3F];
+    }
+    if (i < bytes.size()) {
+        uint32_t triple = (uint8_t)bytes[i] << 16 | (i + 1 < bytes.size() ? (uint8_t)bytes[i + 1] << 8 : 0);
+        encoded += BASE64_CHARS[(triple >> 18) & 0x3F];
+        encoded += BASE64_CHARS[(triple >> 12) & 0x3F];
+        encoded += i + 1 < bytes.size() ? BASE64_CHARS[(triple >> 6) & 0x3F] : '=';
+        encoded += '=';
+    }
+    return encoded;
+}
+
+bool readFile(const std::string& path, std::string& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Failed to open " << path << std::endl;
+        return false;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+std::vector<std::string> split(const std::string& value, char delimiter) {
+    std::vector<std::string> parts;
+    std::stringstream ss(value);
+    std::string part;
+    while (std::getline(ss, part, delimiter)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+// Images are sent as encoded bytes and decoded by the server
+bool loadImagePayloads(const std::string& imagesListPath, const std::string& modelName, const std::string& inputName, std::vector<std::shared_ptr<const Payload>>& payloads) {
+    std::ifstream list(imagesListPath);
+    if (!list.is_open()) {
+        std::cout << "Failed to open " << imagesListPath << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(list, line)) {
+        // Lines may contain expected label after the path as in resnet_client images list
+        std::stringstream ss(line);
+        std::string path;
+        if (!(ss >> path)) {
+            continue;
+        }
+        std::string image;
+        if (!readFile(path, image)) {
+            return false;
+        }
+        auto payload = std::make_shared<Payload>();
+        payload->grpcRequest.mutable_model_spec()->set_name(modelName);
+        auto& proto = (*payload->grpcRequest.mutable_inputs())[inputName];
+        proto.set_dtype(tensorflow::DataType::DT_STRING);
+        proto.add_string_val(image);
+        proto.mutable_tensor_shape()->add_dim()->set_size(1);
+        payload->restBody = "{\"inputs\": {\"" + inputName + "\": [{\"b64\": \"" + encodeBase64(image) + "\"}]}}";
+        payloads.push_back(std::move(payload));
+    }
+    return true;
+}
+
+struct NpyDtype {
+    const char* descr;
+    tensorflow::DataType dtype;
+    size_t size;
+    bool restSupported;
+};
+
+static const NpyDtype NPY_DTYPES[] = {
+    {"f4", tensorflow::DataType::DT_FLOAT, 4, true},
+    {"f8", tensorflow::DataType::DT_DOUBLE, 8, true},
+    {"f2", tensorflow::DataType::DT_HALF, 2, false},
+    {"i1", tensorflow::DataType::DT_INT8, 1, true},
+    {"i2", tensorflow::DataType::DT_INT16, 2, true},
+    {"i4", tensorflow::DataType::DT_INT32, 4, true},
+    {"i8", tensorflow::DataType::DT_INT64, 8, true},
+    {"u1", tensorflow::DataType::DT_UINT8, 1, true},
+    {"u2", tensorflow::DataType::DT_UINT16, 2, true},
+};
+
+template <typename T>
+void appendJsonValues(std::string& json, const T* data, const std::vector<int64_t>& shape, size_t dim, size_t& offset) {
+    if (dim == shape.size()) {
+        char value[32];
+        std::snprintf(value, sizeof(value), "%.9g", (double)data[offset++]);
+        json += value;
+        return;
+    }
+    json += '[';
+    for (int64_t i = 0; i < shape[dim]; i++) {
+        if (i) {
+            json += ", ";
+        }
+        appendJsonValues(json, data, shape, dim + 1, offset);
+    }
+    json += ']';
+}
+
+std::string makeJsonArray(const NpyDtype& type, const char* data, const std::vector<int64_t>& shape) {
+    std::string json;
+    size_t offset = 0;
+    std::string descr = type.descr;
+    if (descr == "f4") {
+        appendJsonValues(json, (const float*)data, shape, 0, offset);
+    } else if (descr == "f8") {
+        appendJsonValues(json, (const double*)data, shape, 0, offset);
+    } else if (descr == "i1") {
+        appendJsonValues(json, (const int8_t*)data, shape, 0, offset);
+    } else if (descr == "i2") {
+        appendJsonValues(json, (const int16_t*)data, shape, 0, offset);
+    } else if (descr == "i4") {
+        appendJsonValues(json, (const int32_t*)data, shape, 0, offset);
+    } else if (descr == "i8") {
+        appendJsonValues(json, (const int64_t*)data, shape, 0, offset);
+    } else if (descr == "u1") {
+        appendJsonValues(json, (const uint8_t*)data, shape, 0, offset);
+    } else if (descr == "u2") {
+        appendJsonValues(json, (const uint16_t*)data, shape, 0, offset);
+    }
+    return json;
+}
+
+// Supports little endian C-ordered arrays as written by numpy.save
+bool loadNpyPayload(const std::string& path, const std::string& modelName, const std::string& inputName, bool rest, Payload& payload) {
+    std::string content;
+    if (!readFile(path, content)) {
+        return false;
+    }
+    if (content.size() < 10 || content.compare(0, 6, "\x93NUMPY") != 0) {
+        std::cout << path << " is not a npy file" << std::endl;
+        return false;
+    }
+    uint8_t majorVersion = content[6];
+    size_t headerStart = majorVersion == 1 ? 10 : 12;
+    size_t headerLength = majorVersion == 1 ? ((uint8_t)content[8] | (uint8_t)content[9] << 8) : ((uint8_t)content[8] | (uint8_t)content[9] << 8 | (uint8_t)content[10] << 16 | (uint32_t)(uint8_t)content[11] << 24);
+    if (content.size() < headerStart + headerLength) {
+        std::cout << path << " has truncated header" << std::endl;
+        return false;
+    }
+    std::string header = content.substr(headerStart, headerLength);
+
+    auto descrPos = header.find("'descr':");
+    auto fortranPos = header.find("'fortran_order':");
+    auto shapeStart = header.find('(', header.find("'shape':"));
+    auto shapeEnd = header.find(')', shapeStart);
+    if (descrPos == std::string::npos || fortranPos == std::string::npos || shapeStart == std::string::npos || shapeEnd == std::string::npos) {
+        std::cout << path << " has unsupported header: " << header << std::endl;
+        return false;
+    }
+    if (header.compare(header.find_first_not_of(' ', fortranPos + 16), 5, "False") != 0) {
+        std::cout << path << " is stored in fortran order which is not supported" << std::endl;
+        return false;
+    }
+    auto descrStart = header.find('\'', descrPos + 8) + 1;
+    std::string descr = header.substr(descrStart, header.find('\'', descrStart) - descrStart);
+    if (descr.size() != 3 || (descr[0] != '<' && descr[0] != '|')) {
+        std::cout << path << " has unsupported dtype: " << descr << std::endl;
+        return false;
+    }
+    const NpyDtype* type = nullptr;
+    for (const auto& npyDtype : NPY_DTYPES) {
+        if (descr.compare(1, 2, npyDtype.descr) == 0) {
+            type = &npyDtype;
+        }
+    }
+    if (!type || (rest && !type->restSupported)) {
+        std::cout << path << " has unsupported dtype: " << descr << std::endl;
+        return false;
+    }
+
+    std::vector<int64_t> shape;
+    size_t elements = 1;
+    for (const auto& dim : split(header.substr(shapeStart + 1, shapeEnd - shapeStart - 1), ',')) {
+        if (dim.find_first_not_of(' ') == std::string::npos) {
+            continue;
+        }
+        shape.push_back(std::stoll(dim));
+        elements *= shape.back();
+    }
+    size_t dataStart = headerStart + headerLength;
+    if (content.size() - dataStart != elements * type->size) {
+        std::cout << path << " data size does not match shape" << std::endl;
+        return false;
+    }
+
+    payload.grpcRequest.mutable_model_spec()->set_name(modelName);
+    auto& proto = (*payload.grpcRequest.mutable_inputs())[inputName];
+    proto.set_dtype(type->dtype);
+    for (auto dim : shape) {
+        proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    proto.mutable_tensor_content()->assign(content.data() + dataStart, content.size() - dataStart);
+    if (rest) {
+        payload.restBody = "{\"inputs\": {\"" + inputName + "\": " + makeJsonArray(*type, content.data() + dataStart, shape) + "}}";
+    }
+    return true;
+}
+
+static const char CAPTURE_MAGIC[] = "OVMSCAP1";
+static const size_t CAPTURE_RECORD_HEADER_SIZE = 12;
+
+uint64_t readLittleEndian(const std::string& data, size_t offset, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= (uint64_t)(uint8_t)data[offset + i] << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Reads requests captured by the server with --traffic_capture_path.
+ * Arrival offsets are in seconds from the first captured request, captures of several server runs appended
+ * to one file are ordered by arrival time.
+ */
+bool loadCapture(const std::string& path, std::vector<std::shared_ptr<const Payload>>& payloads, std::vector<double>& offsets) {
+    std::string content;
+    if (!readFile(path, content)) {
+        return false;
+    }
+    const size_t magicSize = sizeof(CAPTURE_MAGIC) - 1;
+    if (content.compare(0, magicSize, CAPTURE_MAGIC) != 0) {
+        std::cout << path << " is not a capture file" << std::endl;
+        return false;
+    }
+    std::vector<std::pair<uint64_t, std::shared_ptr<const Payload>>> records;
+    size_t position = magicSize;
+    while (position + CAPTURE_RECORD_HEADER_SIZE <= content.size()) {
+        uint64_t arrivalUs = readLittleEndian(content, position, 8);
+        size_t size = readLittleEndian(content, position + 8, 4);
+        position += CAPTURE_RECORD_HEADER_SIZE;
+        if (position + size > content.size()) {
+            // Last record might be truncated when server was killed while writing it
+            break;
+        }
+        auto payload = std::make_shared<Payload>();
+        if (!payload->grpcRequest.ParseFromArray(content.data() + position, size)) {
+            std::cout << path << " has corrupted record at offset " << position << std::endl;
+            return false;
+        }
+        position += size;
+        records.emplace_back(arrivalUs, std::move(payload));
+    }
+    std::stable_sort(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto& [arrivalUs, payload] : records) {
+        offsets.push_back((arrivalUs - records.front().first) / 1e6);
+        payloads.push_back(std::move(payload));
+    }
+    return true;
+}
+
+static const uint32_t SEQUENCE_START = 1;
+static const uint32_t SEQUENCE_END = 2;
+
+/**
+ * Adds stateful model inputs to the request.
+ * Requests are spread over concurrent sequences in round robin, so consecutive requests of one sequence
+ * are scheduled concurrentSequences intervals apart and normally reach the server in order.
+ */
+std::shared_ptr<const Payload> makeSequenceRequest(const Payload& payload, uint64_t index, uint64_t sequenceLength, uint64_t concurrentSequences, uint64_t firstSequenceId, bool rest) {
+    uint64_t slot = index % concurrentSequences;
+    uint64_t round = index / concurrentSequences;
+    uint64_t position = round % sequenceLength;
+    uint64_t sequenceId = firstSequenceId + (round / sequenceLength) * concurrentSequences + slot;
+    uint32_t control = position == 0 ? SEQUENCE_START : (position == sequenceLength - 1 ? SEQUENCE_END : 0);
+
+    auto request = std::make_shared<Payload>();
+    if (rest) {
+        // Closing braces of inputs and request objects are moved after the sequence inputs
+        request->restBody = payload.restBody.substr(0, payload.restBody.size() - 2) +
+                            ", \"sequence_id\": [" + std::to_string(sequenceId) + "], \"sequence_control_input\": [" + std::to_string(control) + "]}}";
+        return request;
+    }
+    request->grpcRequest = payload.grpcRequest;
+    auto& inputs = *request->grpcRequest.mutable_inputs();
+    auto& id = inputs["sequence_id"];
+    id.set_dtype(tensorflow::DataType::DT_UINT64);
+    id.mutable_tensor_shape()->add_dim()->set_size(1);
+    id.add_uint64_val(sequenceId);
+    auto& controlInput = inputs["sequence_control_input"];
+    controlInput.set_dtype(tensorflow::DataType::DT_UINT32);
+    controlInput.mutable_tensor_shape()->add_dim()->set_size(1);
+    controlInput.add_uint32_val(control);
+    return request;
+}
+
+/**
+ * Outcome of the load test, each sender or receiver thread fills its own copy to avoid contention
+ */
+struct Results {
+    LatencyHistogram latency;
+    uint64_t errors = 0;
+
+    void merge(const Results& other) {
+        latency.merge(other.latency);
+        errors += other.errors;
+    }
+};
+
+uint64_t elapsedUs(Clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+}
+
+class Target {
+public:
+    virtual ~Target() = default;
+    // Called by scheduler thread, must not block on responses
+    virtual void send(Clock::time_point intendedStart, std::shared_ptr<const Payload> payload) = 0;
+    // Waits for outstanding requests and returns results of completed ones
+    virtual Results finish() = 0;
+};
+
+class GrpcTarget : public Target {
+    struct AsyncCall {
+        grpc::ClientContext context;
+        PredictResponse response;
+        grpc::Status status;
+        Clock::time_point intendedStart;
+        std::unique_ptr<grpc::ClientAsyncResponseReader<PredictResponse>> reader;
+    };
+
+    struct Connection {
+        std::unique_ptr<PredictionService::Stub> stub;
+        grpc::CompletionQueue queue;
+        std::thread receiver;
+        Results results;
+    };
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::chrono::milliseconds timeout;
+    size_t next = 0;
+
+    static void receive(Connection& connection) {
+        void* tag;
+        bool ok;
+        while (connection.queue.Next(&tag, &ok)) {
+            std::unique_ptr<AsyncCall> call(static_cast<AsyncCall*>(tag));
+            if (ok && call->status.ok()) {
+                connection.results.latency.record(elapsedUs(call->intendedStart));
+            } else {
+                connection.results.errors++;
+            }
+        }
+    }
+
+public:
+    GrpcTarget(const std::string& address, int connectionsCount, std::chrono::milliseconds timeout) :
+        timeout(timeout) {
+        for (int i = 0; i < connectionsCount; i++) {
+            grpc::ChannelArguments arguments;
+            // Channels with the same arguments would share one TCP connection otherwise
+            arguments.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+            arguments.SetMaxReceiveMessageSize(-1);
+            auto connection = std::make_unique<Connection>();
+            connection->stub = PredictionService::NewStub(grpc::CreateCustomChannel(address, grpc::InsecureChannelCredentials(), arguments));
+            connection->receiver = std::thread(&GrpcTarget::receive, std::ref(*connection));
+            connections.push_back(std::move(connection));
+        }
+    }
+
+    void send(Clock::time_point intendedStart, std::shared_ptr<const Payload> payload) override {
+        auto& connection = *connections[next++ % connections.size()];
+        auto call = new AsyncCall;
+        call->intendedStart = intendedStart;
+        call->context.set_deadline(intendedStart + timeout);
+        call->reader = connection.stub->PrepareAsyncPredict(&call->context, payload->grpcRequest, &connection.queue);
+        call->reader->StartCall();
+        call->reader->Finish(&call->response, &call->status, call);
+    }
+
+    Results finish() override {
+        Results results;
+        for (auto& connection : connections) {
+            // Pending calls are still delivered, at the latest when their deadline expires
+            connection->queue.Shutdown();
+            connection->receiver.join();
+            results.merge(connection->results);
+        }
+        return results;
+    }
+};
+
+/**
+ * Minimal HTTP/1.1 client with keep-alive connection, enough to talk to the model server REST API
+ */
+class HttpConnection {
+    std::string host;
+    std::string port;
+    std::chrono::milliseconds timeout;
+    int fd = -1;
+    std::string buffer;
+
+    bool connect() {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* addresses = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+            return false;
+        }
+        for (auto address = addresses; address != nullptr; address = address->ai_next) {
+            fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (fd < 0) {
+                continue;
+            }
+            if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+                break;
+            }
+            ::close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(addresses);
+        if (fd < 0) {
+            return false;
+        }
+        struct timeval tv;
+        tv.tv_sec = timeout.count() / 1000;
+        tv.tv_usec = (timeout.count() % 1000) * 1000;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        buffer.clear();
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    bool sendAll(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t result = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (result <= 0) {
+                return false;
+            }
+            sent += result;
+        }
+        return true;
+    }
+
+    bool receiveMore() {
+        char chunk[16384];
+        ssize_t result = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (result <= 0) {
+            return false;
+        }
+        buffer.append(chunk, result);
+        return true;
+    }
+
+    bool receiveUntil(size_t size) {
+        while (buffer.size() < size) {
+            if (!receiveMore()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool receiveLine(size_t from, size_t& lineEnd) {
+        while ((lineEnd = buffer.find("\r\n", from)) == std::string::npos) {
+            if (!receiveMore()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool receiveChunkedBody(size_t bodyStart) {
+        size_t position = bodyStart;
+        size_t lineEnd;
+        while (true) {
+            if (!receiveLine(position, lineEnd)) {
+                return false;
+            }
+            size_t chunkSize = std::stoul(buffer.substr(position, lineEnd - position), nullptr, 16);
+            position = lineEnd + 2;
+            if (chunkSize == 0) {
+                break;
+            }
+            position += chunkSize + 2;
+            if (!receiveUntil(position)) {
+                return false;
+            }
+        }
+        // Last chunk is followed by optional trailer headers and empty line
+        while (true) {
+            if (!receiveLine(position, lineEnd)) {
+                return false;
+            }
+            bool emptyLine = lineEnd == position;
+            position = lineEnd + 2;
+            if (emptyLine) {
+                break;
+            }
+        }
+        buffer.erase(0, position);
+        return true;
+    }
+
+    bool receiveResponse(int& statusCode) {
+        size_t headersEnd;
+        while ((headersEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!receiveMore()) {
+                return false;
+            }
+        }
+        std::string headers = buffer.substr(0, headersEnd);
+        std::transform(headers.begin(), headers.end(), headers.begin(), ::tolower);
+        if (headers.compare(0, 5, "http/") != 0) {
+            return false;
+        }
+        statusCode = std::atoi(headers.c_str() + headers.find(' ') + 1);
+        size_t bodyStart = headersEnd + 4;
+        bool keepAlive = headers.find("\r\nconnection: close") == std::string::npos;
+        auto lengthPos = headers.find("\r\ncontent-length:");
+        if (lengthPos != std::string::npos) {
+            size_t length = std::stoul(headers.substr(lengthPos + 17));
+            if (!receiveUntil(bodyStart + length)) {
+                return false;
+            }
+            buffer.erase(0, bodyStart + length);
+        } else if (headers.find("\r\ntransfer-encoding: chunked") != std::string::npos) {
+            if (!receiveChunkedBody(bodyStart)) {
+                return false;
+            }
+        } else {
+            // Body ends when server closes connection
+            while (receiveMore()) {
+            }
+            keepAlive = false;
+        }
+        if (!keepAlive) {
+            close();
+        }
+        return true;
+    }
+
+public:
+    HttpConnection(const std::string& host, const std::string& port, std::chrono::milliseconds timeout) :
+        host(host),
+        port(port),
+        timeout(timeout) {}
+
+    ~HttpConnection() {
+        close();
+    }
+
+    bool post(const std::string& path, const std::string& body, int& statusCode) {
+        std::string request = "POST " + path + " HTTP/1.1\r\nHost: " + host + ":" + port +
+                              "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        bool reused = fd >= 0;
+        if (!reused && !connect()) {
+            return false;
+        }
+        if (!sendAll(request) || !sendAll(body)) {
+            close();
+            // Server might have closed idle keep-alive connection
+            if (!reused || !connect() || !sendAll(request) || !sendAll(body)) {
+                close();
+                return false;
+            }
+        }
+        if (!receiveResponse(statusCode)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * Scheduled requests are picked up by connection threads, each having one request in flight.
+ * Time spent in this queue counts to latency, so lack of connections is visible in results.
+ */
+class RestTarget : public Target {
+    std::string host;
+    std::string port;
+    std::string path;
+    std::chrono::milliseconds timeout;
+
+    std::mutex mtx;
+    std::condition_variable condition;
+    std::deque<std::pair<Clock::time_point, std::shared_ptr<const Payload>>> scheduled;
+    bool finished = false;
+
+    std::vector<std::thread> workers;
+    std::vector<Results> workerResults;
+
+    void work(Results& results) {
+        HttpConnection connection(host, port, timeout);
+        while (true) {
+            std::pair<Clock::time_point, std::shared_ptr<const Payload>> request;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                condition.wait(lock, [this]() { return finished || !scheduled.empty(); });
+                if (scheduled.empty()) {
+                    return;
+                }
+                request = scheduled.front();
+                scheduled.pop_front();
+            }
+            int statusCode = 0;
+            if (connection.post(path, request.second->restBody, statusCode) && statusCode == 200) {
+                results.latency.record(elapsedUs(request.first));
+            } else {
+                results.errors++;
+            }
+        }
+    }
+
+public:
+    RestTarget(const std::string& host, const std::string& port, const std::string& modelName, int connectionsCount, std::chrono::milliseconds timeout) :
+        host(host),
+        port(port),
+        path("/v1/models/" + modelName + ":predict"),
+        timeout(timeout),
+        workerResults(connectionsCount) {
+        for (int i = 0; i < connectionsCount; i++) {
+            workers.emplace_back(&RestTarget::work, this, std::ref(workerResults[i]));
+        }
+    }
+
+    void send(Clock::time_point intendedStart, std::shared_ptr<const Payload> payload) override {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            scheduled.emplace_back(intendedStart, std::move(payload));
+        }
+        condition.notify_one();
+    }
+
+    Results finish() override {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            finished = true;
+        }
+        condition.notify_all();
+        Results results;
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+            results.merge(workerResults[i]);
+        }
+        return results;
+    }
+};
+
+void writeReport(std::ostream& out, const std::string& protocol, const std::string& distribution, double rate, double duration, uint64_t sent, const Results& results) {
+    const auto& latency = results.latency;
+    out << "{\n"
+        << "  \"protocol\": \"" << protocol << "\",\n"
+        << "  \"distribution\": \"" << distribution << "\",\n"
+        << "  \"target_rate\": " << rate << ",\n"
+        << "  \"duration_s\": " << duration << ",\n"
+        << "  \"sent\": " << sent << ",\n"
+        << "  \"completed\": " << latency.count() << ",\n"
+        << "  \"errors\": " << results.errors << ",\n"
+        << "  \"achieved_rate\": " << latency.count() / duration << ",\n"
+        << "  \"latency_us\": {\n"
+        << "    \"min\": " << latency.min() << ",\n"
+        << "    \"mean\": " << latency.mean() << ",\n"
+        << "    \"p50\": " << latency.percentile(50) << ",\n"
+        << "    \"p90\": " << latency.percentile(90) << ",\n"
+        << "    \"p99\": " << latency.percentile(99) << ",\n"
+        << "    \"p99.9\": " << latency.percentile(99.9) << ",\n"
+        << "    \"p99.99\": " << latency.percentile(99.99) << ",\n"
+        << "    \"max\": " << latency.max() << "\n"
+        << "  }\n"
+        << "}\n";
+}
+
+int main(int argc, char** argv) {
+    tensorflow::string address = "localhost";
+    tensorflow::string grpcPort = "9000";
+    tensorflow::string restPort = "8000";
+    tensorflow::string protocol = "grpc";
+    tensorflow::string modelName = "resnet";
+    tensorflow::string inputName = "0";
+    tensorflow::string imagesListPath = "";
+    tensorflow::string npyFiles = "";
+    tensorflow::string capturePath = "";
+    float rateScale = 1;
+    float rate = 100;
+    tensorflow::string distribution = "poisson";
+    float duration = 60;
+    tensorflow::int32 connections = 4;
+    tensorflow::int32 timeoutMs = 10000;
+    tensorflow::string reportPath = "";
+    tensorflow::int32 sequenceLength = 0;
+    tensorflow::int32 concurrentSequences = 16;
+    std::vector<tensorflow::Flag> flagList = {
+        tensorflow::Flag("address", &address, "server address"),
+        tensorflow::Flag("grpc_port", &grpcPort, "port to grpc service"),
+        tensorflow::Flag("rest_port", &restPort, "port to rest service"),
+        tensorflow::Flag("protocol", &protocol, "grpc or rest"),
+        tensorflow::Flag("model_name", &modelName, "model name to request"),
+        tensorflow::Flag("input_name", &inputName, "input tensor name"),
+        tensorflow::Flag("images_list", &imagesListPath, "path to a file with a list of images sent in binary format"),
+        tensorflow::Flag("npy_files", &npyFiles, "comma separated list of npy files with input data, first dimension is batch"),
+        tensorflow::Flag("capture", &capturePath, "path to a file with requests captured by the server, replayed at their original arrival times over grpc"),
+        tensorflow::Flag("rate_scale", &rateScale, "multiplies rate of replayed capture"),
+        tensorflow::Flag("rate", &rate, "requests per second"),
+        tensorflow::Flag("distribution", &distribution, "arrivals distribution, constant or poisson"),
+        tensorflow::Flag("duration", &duration, "test duration in seconds"),
+        tensorflow::Flag("connections", &connections, "number of connections to the server"),
+        tensorflow::Flag("timeout_ms", &timeoutMs, "request timeout counted from its scheduled time"),
+        tensorflow::Flag("sequence_length", &sequenceLength, "number of requests in sequence sent to stateful model, 0 for stateless models"),
+        tensorflow::Flag("concurrent_sequences", &concurrentSequences, "number of sequences sent in parallel to stateful model"),
+        tensorflow::Flag("report", &reportPath, "path to JSON report, printed to standard output if empty")};
+
+    tensorflow::string usage = tensorflow::Flags::Usage(argv[0], flagList);
+    const bool result = tensorflow::Flags::Parse(&argc, argv, flagList);
+
+    const int inputSources = !imagesListPath.empty() + !npyFiles.empty() + !capturePath.empty();
+    if (!result || inputSources != 1 || rate <= 0 || duration <= 0 || connections <= 0 || timeoutMs <= 0 ||
+        sequenceLength < 0 || sequenceLength == 1 || concurrentSequences <= 0 || rateScale <= 0 ||
+        (!capturePath.empty() && (protocol != "grpc" || sequenceLength > 0)) ||
+        (protocol != "grpc" && protocol != "rest") || (distribution != "constant" && distribution != "poisson")) {
+        std::cout << usage;
+        return -1;
+    }
+
+    std::vector<std::shared_ptr<const Payload>> payloads;
+    std::vector<double> captureOffsets;
+    if (!capturePath.empty()) {
+        if (!loadCapture(capturePath, payloads, captureOffsets)) {
+            std::cout << "Error reading capture" << std::endl;
+            return -1;
+        }
+    } else if (!imagesListPath.empty()) {
+        if (!loadImagePayloads(imagesListPath, modelName, inputName, payloads)) {
+            std::cout << "Error reading images" << std::endl;
+            return -1;
+        }
+    } else {
+        for (const auto& path : split(npyFiles, ',')) {
+            auto payload = std::make_shared<Payload>();
+            if (!loadNpyPayload(path, modelName, inputName, protocol == "rest", *payload)) {
+                std::cout << "Error reading npy file" << std::endl;
+                return -1;
+            }
+            payloads.push_back(std::move(payload));
+        }
+    }
+    if (payloads.empty()) {
+        std::cout << "No input data" << std::endl;
+        return -1;
+    }
+
+    const std::chrono::milliseconds timeout(timeoutMs);
+    std::unique_ptr<Target> target;
+    if (protocol == "grpc") {
+        target = std::make_unique<GrpcTarget>(address + ":" + grpcPort, connections, timeout);
+    } else {
+        target = std::make_unique<RestTarget>(address, restPort, modelName, connections, timeout);
+    }
+
+    // Capture is replayed in a loop, next pass starts one mean interval after the last request of the previous one
+    double capturePeriod = 0;
+    if (!captureOffsets.empty()) {
+        const double captureSpan = captureOffsets.back() / rateScale;
+        capturePeriod = captureOffsets.size() > 1 ? captureSpan * captureOffsets.size() / (captureOffsets.size() - 1) : 1.0 / rateScale;
+        rate = captureOffsets.size() / capturePeriod;
+        distribution = "capture";
+        std::cout << "Replaying " << captureOffsets.size() << " captured requests spanning " << captureSpan << "s, "
+                  << rate << " requests per second, for " << duration << "s over " << connections << " " << protocol << " connections" << std::endl;
+    } else {
+        std::cout << "Sending " << rate << " requests per second with " << distribution << " arrivals for " << duration << "s"
+                  << " over " << connections << " " << protocol << " connections" << std::endl;
+    }
+
+    std::mt19937_64 generator(std::random_device{}());
+    std::exponential_distribution<double> interval(rate);
+    const auto start = Clock::now() + std::chrono::milliseconds(100);
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(duration));
+    auto scheduledTime = start;
+    double scheduledOffset = 0;
+    // Sequence ids are randomized so that sequences left open by previous run do not collide
+    const uint64_t firstSequenceId = (generator() >> 24) + 1;
+    uint64_t sent = 0;
+    while (scheduledTime < end) {
+        std::this_thread::sleep_until(scheduledTime);
+        // Scheduler might be late, requests are sent immediately then but latency still counts from scheduled time
+        const auto& payload = payloads[sent % payloads.size()];
+        target->send(scheduledTime, sequenceLength ? makeSequenceRequest(*payload, sent, sequenceLength, concurrentSequences, firstSequenceId, protocol == "rest") : payload);
+        sent++;
+        // Schedule is computed from the start instead of accumulating rounding errors
+        if (!captureOffsets.empty()) {
+            scheduledOffset = (sent / captureOffsets.size()) * capturePeriod + captureOffsets[sent % captureOffsets.size()] / rateScale;
+        } else {
+            scheduledOffset += distribution == "poisson" ? interval(generator) : 1.0 / rate;
+        }
+        scheduledTime = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(scheduledOffset));
+    }
+    Results results = target->finish();
+
+    if (reportPath.empty()) {
+        writeReport(std::cout, protocol, distribution, rate, duration, sent, results);
+    } else {
+        std::ofstream report(reportPath);
+        writeReport(report, protocol, distribution, rate, duration, sent, results);
+        if (!report) {
+            std::cout << "Failed to write report to " << reportPath << std::endl;
+            return -1;
+        }
+        std::cout << "Report saved to " << reportPath << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "adaptive_batch_window.hpp"
+
+#include <algorithm>
+
+namespace ovms {
+
+namespace {
+const double ARRIVAL_SMOOTHING = 0.2;
+const double EXECUTION_SMOOTHING = 0.2;
+const double MIN_BUDGET_CORRECTION = 0.1;
+const double BUDGET_DECREASE_FACTOR = 0.8;
+const double BUDGET_INCREASE_STEP = 0.05;
+// budget grows back only when p99 is comfortably below target, so it does not oscillate around it
+const double BUDGET_INCREASE_THRESHOLD = 0.8;
+
+double ewma(double average, double sample, double smoothing) {
+    return average == 0 ? sample : average + smoothing * (sample - average);
+}
+}  // namespace
+
+AdaptiveBatchWindow::AdaptiveBatchWindow(size_t maxBatchSize, std::chrono::microseconds maxWindow, std::chrono::microseconds latencyTarget) :
+    maxBatchSize(std::max<size_t>(maxBatchSize, 1)),
+    maxWindowUs(maxWindow.count()),
+    latencyTargetUs(latencyTarget.count()),
+    executionUs(this->maxBatchSize + 1, 0),
+    targetBatchSize(this->maxBatchSize),
+    window(maxWindow) {
+    update();
+}
+
+void AdaptiveBatchWindow::recordArrival(clock::time_point time, size_t requestBatchSize) {
+    if (anyArrival) {
+        // arrivals are recorded in the order requests take batcher lock, not exactly in the order of their timestamps
+        const double gapUs = std::max<double>(std::chrono::duration<double, std::micro>(time - lastArrival).count(), 0);
+        // any interval longer than latency target means no batching, longer idle periods must not delay recovery
+        const double intervalUs = std::min(gapUs / std::max<size_t>(requestBatchSize, 1), latencyTargetUs);
+        entryIntervalUs = ewma(entryIntervalUs, intervalUs, ARRIVAL_SMOOTHING);
+        lastArrival = std::max(lastArrival, time);
+    } else {
+        anyArrival = true;
+        lastArrival = time;
+    }
+    update();
+}
+
+void AdaptiveBatchWindow::recordExecution(size_t batchSize, std::chrono::microseconds duration) {
+    if (batchSize == 0 || batchSize > maxBatchSize) {
+        return;
+    }
+    executionUs[batchSize] = ewma(executionUs[batchSize], std::max<double>(duration.count(), 1), EXECUTION_SMOOTHING);
+    update();
+}
+
+void AdaptiveBatchWindow::recordLatency(std::chrono::microseconds latency) {
+    latencySamplesUs[latencySamplesCount % LATENCY_SAMPLES] = latency.count();
+    ++latencySamplesCount;
+    if (++samplesSinceCorrection >= LATENCY_SAMPLES_PER_CORRECTION) {
+        samplesSinceCorrection = 0;
+        correctBudget();
+        update();
+    }
+}
+
+double AdaptiveBatchWindow::getEstimatedExecutionUs(size_t batchSize) const {
+    if (executionUs[batchSize] > 0) {
+        return executionUs[batchSize];
+    }
+    // larger batch takes at least as long, networks compiled for max batch size even pad partial batches
+    for (size_t larger = batchSize + 1; larger <= maxBatchSize; ++larger) {
+        if (executionUs[larger] > 0) {
+            return executionUs[larger];
+        }
+    }
+    for (size_t smaller = batchSize - 1; smaller > 0; --smaller) {
+        if (executionUs[smaller] > 0) {
+            return executionUs[smaller] * batchSize / smaller;
+        }
+    }
+    return 0;
+}
+
+void AdaptiveBatchWindow::correctBudget() {
+    const size_t count = std::min(latencySamplesCount, LATENCY_SAMPLES);
+    std::array<double, LATENCY_SAMPLES> samples = latencySamplesUs;
+    const size_t p99Index = (count * 99 + 99) / 100 - 1;
+    std::nth_element(samples.begin(), samples.begin() + p99Index, samples.begin() + count);
+    const double p99Us = samples[p99Index];
+    if (p99Us > latencyTargetUs) {
+        budgetCorrection = std::max(budgetCorrection * BUDGET_DECREASE_FACTOR, MIN_BUDGET_CORRECTION);
+    } else if (p99Us < latencyTargetUs * BUDGET_INCREASE_THRESHOLD) {
+        budgetCorrection = std::min(budgetCorrection + BUDGET_INCREASE_STEP, 1.0);
+    }
+}
+
+void AdaptiveBatchWindow::update() {
+    const double budgetUs = getLatencyBudgetUs();
+    if (entryIntervalUs == 0) {
+        // arrival rate not known yet, behave like static window limited by the budget
+        targetBatchSize = maxBatchSize;
+    } else {
+        targetBatchSize = 1;
+        for (size_t batchSize = maxBatchSize; batchSize > 1; --batchSize) {
+            const double fillUs = (batchSize - 1) * entryIntervalUs;
+            if (fillUs + getEstimatedExecutionUs(batchSize) <= budgetUs) {
+                targetBatchSize = batchSize;
+                break;
+            }
+        }
+    }
+    if (targetBatchSize == 1) {
+        window = std::chrono::microseconds(0);
+        return;
+    }
+    const double windowUs = std::clamp(budgetUs - getEstimatedExecutionUs(targetBatchSize), 0.0, maxWindowUs);
+    window = std::chrono::microseconds(static_cast<int64_t>(windowUs));
+}
+
+}  // namespace ovms
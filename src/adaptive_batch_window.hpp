@@ -0,0 +1,112 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Chooses batching window and target batch size of dynamic batcher aiming for p99 latency target
+ *
+ * Time between arrivals of batch entries and inference duration of each batch size are tracked with
+ * exponential moving averages. Target batch size is the largest one whose expected fill time and inference
+ * fit into the latency budget, window is what remains of the budget after inference, capped by batch timeout.
+ * Budget starts at the latency target and is corrected by p99 of recently observed request latencies,
+ * which compensates estimation errors and queueing for infer requests.
+ * Not thread safe, calls are serialized by the batcher.
+ */
+class AdaptiveBatchWindow {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr size_t LATENCY_SAMPLES = 256;
+    static constexpr size_t LATENCY_SAMPLES_PER_CORRECTION = 32;
+
+    /**
+     * @param maxBatchSize batch size the network is compiled for
+     * @param maxWindow window is never longer than that
+     * @param latencyTarget p99 latency of requests to aim for
+     */
+    AdaptiveBatchWindow(size_t maxBatchSize, std::chrono::microseconds maxWindow, std::chrono::microseconds latencyTarget);
+
+    /**
+     * @brief Records request with requestBatchSize entries arriving at time
+     */
+    void recordArrival(clock::time_point time, size_t requestBatchSize);
+
+    /**
+     * @brief Records how long it took to execute batch with batchSize entries
+     */
+    void recordExecution(size_t batchSize, std::chrono::microseconds duration);
+
+    /**
+     * @brief Records time from arrival of request to its completion
+     */
+    void recordLatency(std::chrono::microseconds latency);
+
+    std::chrono::microseconds getWindow() const {
+        return window;
+    }
+
+    size_t getTargetBatchSize() const {
+        return targetBatchSize;
+    }
+
+    /**
+     * @brief Expected duration of executing batch, 0 until any batch is executed
+     */
+    double getEstimatedExecutionUs(size_t batchSize) const;
+
+    /**
+     * @brief Average time between arrivals of batch entries, 0 until the second request arrives
+     */
+    double getEntryIntervalUs() const {
+        return entryIntervalUs;
+    }
+
+    /**
+     * @brief Part of latency target available for batching and inference, corrected by observed latencies
+     */
+    double getLatencyBudgetUs() const {
+        return latencyTargetUs * budgetCorrection;
+    }
+
+private:
+    void update();
+    void correctBudget();
+
+    const size_t maxBatchSize;
+    const double maxWindowUs;
+    const double latencyTargetUs;
+
+    bool anyArrival = false;
+    clock::time_point lastArrival;
+    double entryIntervalUs = 0;
+    // indexed by batch size, 0 when not observed yet
+    std::vector<double> executionUs;
+
+    std::array<double, LATENCY_SAMPLES> latencySamplesUs{};
+    size_t latencySamplesCount = 0;
+    size_t samplesSinceCorrection = 0;
+    double budgetCorrection = 1.0;
+
+    size_t targetBatchSize;
+    std::chrono::microseconds window;
+};
+}  // namespace ovms
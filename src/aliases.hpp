@@ -15,11 +15,17 @@
 //*****************************************************************************
 #pragma once
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace ovms {
 
 using Aliases = std::vector<std::pair<std::string, std::string>>;
+// mapping validated with pipeline definition, shared by nodes of all its executions
+using SharedAliases = std::shared_ptr<const Aliases>;
+// key: pipeline output connected to several nodes, value: names of these nodes in order of preference
+using alternative_sources_t = std::unordered_map<std::string, std::vector<std::string>>;
 }  // namespace ovms
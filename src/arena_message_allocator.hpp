@@ -0,0 +1,125 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/arena.h>
+#include <grpcpp/support/message_allocator.h>
+
+namespace ovms {
+
+/**
+ * @brief Allocates request and response messages of gRPC callback method in protobuf arena
+ *
+ * Every RPC gets its messages, map entries and nested tensors from a single arena
+ * which is released at once when gRPC is done with the call. Holders are recycled
+ * so arena initial block is reused by subsequent calls instead of being allocated again.
+ */
+template <typename RequestT, typename ResponseT>
+class ArenaMessageAllocator : public grpc::experimental::MessageAllocator<RequestT, ResponseT> {
+public:
+    static constexpr size_t DEFAULT_INITIAL_BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t DEFAULT_MAX_IDLE_HOLDERS = 256;
+
+    class Holder : public grpc::experimental::MessageHolder<RequestT, ResponseT> {
+        ArenaMessageAllocator& allocator;
+        std::unique_ptr<char[]> initialBlock;
+        google::protobuf::Arena arena;
+
+        static google::protobuf::ArenaOptions makeOptions(char* initialBlock, size_t initialBlockSize) {
+            google::protobuf::ArenaOptions options;
+            options.initial_block = initialBlock;
+            options.initial_block_size = initialBlockSize;
+            return options;
+        }
+
+        void createMessages() {
+            this->set_request(google::protobuf::Arena::CreateMessage<RequestT>(&arena));
+            this->set_response(google::protobuf::Arena::CreateMessage<ResponseT>(&arena));
+        }
+
+    public:
+        Holder(ArenaMessageAllocator& allocator, size_t initialBlockSize) :
+            allocator(allocator),
+            initialBlock(new char[initialBlockSize]),
+            arena(makeOptions(initialBlock.get(), initialBlockSize)) {
+            createMessages();
+        }
+
+        void Release() override {
+            allocator.release(this);
+        }
+
+        /**
+         * @brief Request is owned by the arena and is freed together with the response in Release
+         */
+        void FreeRequest() override {}
+
+        /**
+         * @brief Destroys messages and frees all arena blocks except the initial one
+         */
+        void reset() {
+            arena.Reset();
+            createMessages();
+        }
+
+        const google::protobuf::Arena& getArena() const {
+            return arena;
+        }
+    };
+
+    ArenaMessageAllocator(size_t initialBlockSize = DEFAULT_INITIAL_BLOCK_SIZE, size_t maxIdleHolders = DEFAULT_MAX_IDLE_HOLDERS) :
+        initialBlockSize(initialBlockSize),
+        maxIdleHolders(maxIdleHolders) {}
+
+    grpc::experimental::MessageHolder<RequestT, ResponseT>* AllocateMessages() override {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!idleHolders.empty()) {
+                auto holder = std::move(idleHolders.back());
+                idleHolders.pop_back();
+                return holder.release();
+            }
+        }
+        return new Holder(*this, initialBlockSize);
+    }
+
+    size_t getIdleHoldersCount() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return idleHolders.size();
+    }
+
+private:
+    const size_t initialBlockSize;
+    const size_t maxIdleHolders;
+    std::mutex mtx;
+    std::vector<std::unique_ptr<Holder>> idleHolders;
+
+    void release(Holder* holder) {
+        std::unique_ptr<Holder> released(holder);
+        released->reset();
+        std::lock_guard<std::mutex> lock(mtx);
+        if (idleHolders.size() < maxIdleHolders) {
+            idleHolders.push_back(std::move(released));
+        }
+    }
+};
+
+}  // namespace ovms
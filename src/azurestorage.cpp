@@ -16,9 +16,11 @@
 #include "azurestorage.hpp"
 
 #include <memory>
+#include <vector>
 
 #include "azurefilesystem.hpp"
 #include "logging.hpp"
+#include "remote_files_cache.hpp"
 
 namespace ovms {
 
@@ -26,6 +28,14 @@ using namespace utility;
 
 const std::string UNAVAILABLE_PATH_ERROR = "Unable to access path: {}";
 
+static const uint32_t DEFAULT_DOWNLOAD_CONCURRENCY = 4;
+
+// Used both as the number of files downloaded concurrently and the number of range reads per file
+static size_t getDownloadConcurrency() {
+    static const uint32_t concurrency = FileSystem::getPositiveEnvValue("AZURE_DOWNLOAD_CONCURRENCY", DEFAULT_DOWNLOAD_CONCURRENCY);
+    return concurrency;
+}
+
 const std::string AzureStorageAdapter::extractAzureStorageExceptionMessage(const as::storage_exception& e) {
     as::request_result result = e.result();
     as::storage_extended_error extended_error = result.extended_error();
@@ -424,7 +434,25 @@ StatusCode AzureStorageBlob::downloadFile(const std::string& local_path) {
             return StatusCode::AS_FILE_NOT_FOUND;
         }
 
-        as_blob_.download_to_file(local_path);
+        // Properties are fetched by exists(), Content-MD5 is set only by some uploaders
+        auto cache = RemoteFilesCache::getInstance();
+        std::string cacheKey;
+        if (cache) {
+            const auto& properties = as_blob_.properties();
+            cacheKey = properties.content_md5().empty() ? RemoteFilesCache::makeKey("azure-etag", properties.etag(), properties.size()) : RemoteFilesCache::makeKey("md5", properties.content_md5(), properties.size());
+            if (cache->fetch(cacheKey, local_path)) {
+                return StatusCode::OK;
+            }
+        }
+
+        // Blob is fetched with parallel range reads; failed ranges are retried by SDK retry policy
+        // from the last received byte and Content-MD5 of the blob is validated when present
+        as::blob_request_options options;
+        options.set_parallelism_factor(getDownloadConcurrency());
+        as_blob_.download_to_file(local_path, as::access_condition(), options, as::operation_context());
+        if (cache) {
+            cache->store(cacheKey, local_path);
+        }
         return StatusCode::OK;
     } catch (const as::storage_exception& e) {
         SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
@@ -496,7 +524,9 @@ StatusCode AzureStorageBlob::downloadFileFolderTo(const std::string& local_path)
             }
         }
 
-        for (auto&& f : files) {
+        std::vector<std::string> files_list(files.begin(), files.end());
+        return FileSystem::runConcurrently(files_list.size(), getDownloadConcurrency(), [this, &files_list, &local_path](size_t i) {
+            const std::string& f = files_list[i];
             std::string remote_file_path = joinPath({fullUri_, f});
             std::string local_file_path = joinPath({local_path, f});
             SPDLOG_LOGGER_TRACE(azurestorage_logger, "Processing file {} from {} -> {}", f, remote_file_path,
@@ -504,7 +534,7 @@ StatusCode AzureStorageBlob::downloadFileFolderTo(const std::string& local_path)
 
             auto factory = std::make_shared<ovms::AzureStorageFactory>();
             auto azureFiledirStorageObj = factory.get()->getNewAzureStorageObject(remote_file_path, account_);
-            status = azureFiledirStorageObj->checkPath(remote_file_path);
+            auto status = azureFiledirStorageObj->checkPath(remote_file_path);
             if (status != StatusCode::OK) {
                 SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to download directory from {} to {}",
                     remote_file_path, local_file_path);
@@ -516,10 +546,9 @@ StatusCode AzureStorageBlob::downloadFileFolderTo(const std::string& local_path)
             if (download_status != StatusCode::OK) {
                 SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to save file from {} to {}", remote_file_path,
                     local_file_path);
-                return download_status;
             }
-        }
-        return StatusCode::OK;
+            return download_status;
+        });
     } catch (const as::storage_exception& e) {
         SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
     } catch (const std::exception& e) {
@@ -1018,7 +1047,22 @@ StatusCode AzureStorageFile::downloadFile(const std::string& local_path) {
             return StatusCode::AS_FILE_NOT_FOUND;
         }
 
-        as_file1_.download_to_file(local_path);
+        auto cache = RemoteFilesCache::getInstance();
+        std::string cacheKey;
+        if (cache) {
+            const auto& properties = as_file1_.properties();
+            cacheKey = properties.content_md5().empty() ? RemoteFilesCache::makeKey("azfs-etag", properties.etag(), properties.length()) : RemoteFilesCache::makeKey("md5", properties.content_md5(), properties.length());
+            if (cache->fetch(cacheKey, local_path)) {
+                return StatusCode::OK;
+            }
+        }
+
+        as::file_request_options options;
+        options.set_parallelism_factor(getDownloadConcurrency());
+        as_file1_.download_to_file(local_path, as::file_access_condition(), options, as::operation_context());
+        if (cache) {
+            cache->store(cacheKey, local_path);
+        }
         return StatusCode::OK;
     } catch (const as::storage_exception& e) {
         SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
@@ -1090,7 +1134,9 @@ StatusCode AzureStorageFile::downloadFileFolderTo(const std::string& local_path)
             }
         }
 
-        for (auto&& f : files) {
+        std::vector<std::string> files_list(files.begin(), files.end());
+        return FileSystem::runConcurrently(files_list.size(), getDownloadConcurrency(), [this, &files_list, &local_path](size_t i) {
+            const std::string& f = files_list[i];
             std::string remote_file_path = joinPath({fullUri_, f});
             std::string local_file_path = joinPath({local_path, f});
             SPDLOG_LOGGER_TRACE(azurestorage_logger, "Processing file {} from {} -> {}", f, remote_file_path,
@@ -1110,10 +1156,9 @@ StatusCode AzureStorageFile::downloadFileFolderTo(const std::string& local_path)
             if (download_status != StatusCode::OK) {
                 SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to save file from {} to {}", remote_file_path,
                     local_file_path);
-                return download_status;
             }
-        }
-        return StatusCode::OK;
+            return download_status;
+        });
     } catch (const as::storage_exception& e) {
         SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
     } catch (const std::exception& e) {
@@ -0,0 +1,238 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "batch_splitter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "deserialization.hpp"
+#include "executingstreamidguard.hpp"
+#include "modelinstance.hpp"
+#include "ov_utils.hpp"
+#include "serialization.hpp"
+#include "shared_memory.hpp"
+
+namespace ovms {
+
+namespace {
+/**
+ * @brief Returns infer request taken without waiting to the queue
+ */
+class IdleStreamGuard {
+    OVInferRequestsQueue& queue;
+    const int streamId;
+
+public:
+    IdleStreamGuard(OVInferRequestsQueue& queue, int streamId) :
+        queue(queue),
+        streamId(streamId) {}
+    ~IdleStreamGuard() {
+        queue.returnStream(streamId);
+    }
+    IdleStreamGuard(const IdleStreamGuard&) = delete;
+    IdleStreamGuard& operator=(const IdleStreamGuard&) = delete;
+};
+
+struct SubBatch {
+    InferenceEngine::InferRequest* inferRequest;
+    size_t offset;
+    size_t count;
+};
+
+Status startInference(InferenceEngine::InferRequest& inferRequest) {
+    try {
+        inferRequest.StartAsync();
+    } catch (const InferenceEngine::Exception& e) {
+        Status status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+        SPDLOG_ERROR("Async caught an exception {}: {}", status.string(), e.what());
+        return status;
+    }
+    return StatusCode::OK;
+}
+
+Status waitForInference(InferenceEngine::InferRequest& inferRequest) {
+    try {
+        InferenceEngine::StatusCode sts = inferRequest.Wait(InferenceEngine::IInferRequest::RESULT_READY);
+        if (sts != InferenceEngine::StatusCode::OK) {
+            Status status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+            SPDLOG_ERROR("Async infer failed {}: {}", status.string(), sts);
+            return status;
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        Status status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+        SPDLOG_ERROR("Async caught an exception {}: {}", status.string(), e.what());
+        return status;
+    }
+    return StatusCode::OK;
+}
+}  // namespace
+
+Status BatchSplitter::infer(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    size_t requestBatchSize,
+    const RequestContext& context) {
+    tensor_map_t requestedOutputs;
+    auto status = filterRequestedOutputs(*requestProto, instance.getOutputsInfo(), requestedOutputs);
+    if (!status.ok())
+        return status;
+    const tensor_map_t& servedOutputs = requestProto->output_filter_size() > 0 ? requestedOutputs : instance.getOutputsInfo();
+
+    auto& queue = instance.getInferRequestsQueue();
+    ExecutingStreamIdGuard executingStreamIdGuard(queue, context, &instance.getSchedulingTenant());
+    if (!executingStreamIdGuard.getStatus().ok()) {
+        SPDLOG_DEBUG("Dropping request for model {}, version {}: {}",
+            requestProto->model_spec().name(), instance.getVersion(), executingStreamIdGuard.getStatus().string());
+        return executingStreamIdGuard.getStatus();
+    }
+    const size_t batchSize = instance.getBatchSize();
+    SPDLOG_DEBUG("Splitting request for model {}, version {} with batch size: {} into sub-batches of batch size: {}",
+        requestProto->model_spec().name(), instance.getVersion(), requestBatchSize, batchSize);
+
+    std::vector<std::unique_ptr<IdleStreamGuard>> idleStreamGuards;
+    std::deque<SubBatch> running;
+    InferenceEngine::InferRequest* idleInferRequest = &executingStreamIdGuard.getInferRequest();
+    for (size_t offset = 0; offset < requestBatchSize; offset += batchSize) {
+        if (idleInferRequest == nullptr) {
+            int streamId;
+            if (idleStreamGuards.size() + 1 < parallelism && queue.tryGetIdleStream(streamId)) {
+                idleStreamGuards.push_back(std::make_unique<IdleStreamGuard>(queue, streamId));
+                idleInferRequest = &queue.getInferRequest(streamId);
+            } else {
+                // outputs are gathered in order, so the oldest sub-batch is completed first
+                const SubBatch& oldest = running.front();
+                status = waitForInference(*oldest.inferRequest);
+                if (status.ok()) {
+                    status = gatherOutputs(*oldest.inferRequest, servedOutputs, *responseProto, requestBatchSize, oldest.offset, oldest.count);
+                }
+                idleInferRequest = oldest.inferRequest;
+                running.pop_front();
+                if (!status.ok())
+                    break;
+            }
+        }
+        SubBatch subBatch{idleInferRequest, offset, std::min(batchSize, requestBatchSize - offset)};
+        status = fillInputs(*subBatch.inferRequest, *requestProto, requestBatchSize, subBatch.offset, subBatch.count);
+        if (status.ok()) {
+            status = startInference(*subBatch.inferRequest);
+        }
+        if (!status.ok())
+            break;
+        running.push_back(subBatch);
+        idleInferRequest = nullptr;
+    }
+    // infer requests are returned to the queue only after their sub-batches finish
+    for (const auto& subBatch : running) {
+        auto subBatchStatus = waitForInference(*subBatch.inferRequest);
+        if (status.ok()) {
+            status = subBatchStatus.ok() ? gatherOutputs(*subBatch.inferRequest, servedOutputs, *responseProto, requestBatchSize, subBatch.offset, subBatch.count) : subBatchStatus;
+        }
+    }
+    if (status.ok()) {
+        SPDLOG_DEBUG("Request for model {}, version {} split into {} sub-batches inferred on {} infer requests",
+            requestProto->model_spec().name(), instance.getVersion(), (requestBatchSize + batchSize - 1) / batchSize, idleStreamGuards.size() + 1);
+    }
+    return status;
+}
+
+Status BatchSplitter::fillInputs(InferenceEngine::InferRequest& inferRequest, const tensorflow::serving::PredictRequest& request,
+    size_t requestBatchSize, size_t offset, size_t count) {
+    const size_t batchSize = instance.getBatchSize();
+    for (const auto& [name, tensorInfo] : instance.getInputsInfo()) {
+        // infer requests are shared with pipeline nodes and other requests, so each sub-batch gets its own blob
+        InferenceEngine::Blob::Ptr blob;
+        auto status = createSharedBlob(blob, tensorInfo->getTensorDesc());
+        if (!status.ok()) {
+            return status;
+        }
+        const size_t sampleByteSize = blob->byteSize() / batchSize;
+        const size_t sampleCount = blob->size() / batchSize;
+        auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
+        char* destination = holder.as<char*>();
+        const auto& requestInput = request.inputs().at(name);
+        const bool converted = tensorInfo->isConvertedFromDataType(requestInput.dtype());
+        const char* source = requestInput.tensor_content().data();
+        // keeps region mapped during copy
+        std::shared_ptr<SharedMemoryRegion> region;
+        if (isSharedMemoryReference(requestInput)) {
+            char* data = nullptr;
+            const size_t byteSize = requestBatchSize * (converted ? sampleCount * sizeof(float) : sampleByteSize);
+            status = resolveSharedMemoryReference(requestInput, byteSize, region, data);
+            if (!status.ok()) {
+                return status;
+            }
+            source = data;
+        }
+        if (converted) {
+            convertFromFp32(tensorInfo->getPrecision(), reinterpret_cast<const float*>(source) + offset * sampleCount,
+                destination, count * sampleCount);
+        } else if (region == nullptr && tensorInfo->getPrecision() == InferenceEngine::Precision::FP16 && requestInput.tensor_content().empty()) {
+            narrowInt32ToUint16(requestInput.half_val().data() + offset * sampleCount, reinterpret_cast<uint16_t*>(destination), count * sampleCount);
+        } else if (region == nullptr && tensorInfo->getPrecision() == InferenceEngine::Precision::U16) {
+            narrowInt32ToUint16(requestInput.int_val().data() + offset * sampleCount, reinterpret_cast<uint16_t*>(destination), count * sampleCount);
+        } else {
+            std::memcpy(destination, source + offset * sampleByteSize, count * sampleByteSize);
+        }
+        if (count < batchSize) {
+            std::memset(destination + count * sampleByteSize, 0, (batchSize - count) * sampleByteSize);
+        }
+        try {
+            inferRequest.SetBlob(tensorInfo->getName(), blob);
+        } catch (const InferenceEngine::Exception& e) {
+            status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+            SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status BatchSplitter::gatherOutputs(InferenceEngine::InferRequest& inferRequest, const tensor_map_t& outputsInfo,
+    tensorflow::serving::PredictResponse& response, size_t requestBatchSize, size_t offset, size_t count) {
+    for (const auto& [name, tensorInfo] : outputsInfo) {
+        InferenceEngine::Blob::Ptr blob;
+        OutputGetter<InferenceEngine::InferRequest&> outputGetter(inferRequest);
+        auto status = outputGetter.get(tensorInfo->getName(), blob);
+        if (!status.ok()) {
+            return status;
+        }
+        auto& output = (*response.mutable_outputs())[tensorInfo->getMappedName()];
+        if (offset == 0) {
+            status = serializeBlobBatchSliceToTensorProto(output, tensorInfo, blob, 0, count);
+            if (!status.ok()) {
+                return status;
+            }
+            output.mutable_tensor_content()->reserve(output.tensor_content().size() / count * requestBatchSize);
+            continue;
+        }
+        tensorflow::TensorProto slice;
+        status = serializeBlobBatchSliceToTensorProto(slice, tensorInfo, blob, 0, count);
+        if (!status.ok()) {
+            return status;
+        }
+        output.mutable_tensor_content()->append(slice.tensor_content());
+        auto* batchDim = output.mutable_tensor_shape()->mutable_dim(0);
+        batchDim->set_size(batchDim->size() + count);
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
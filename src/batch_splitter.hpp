@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstddef>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "requestcontext.hpp"
+#include "status.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+class ModelInstance;
+
+/**
+ * @brief Splits request with batch larger than the network batch into sub-batches inferred concurrently.
+ *
+ * Sub-batches of network batch size are copied from request inputs into new blobs of infer requests,
+ * the last one zero padded, and run asynchronously on up to parallelism infer requests at once.
+ * Outputs of sub-batches are gathered into the response in order of the sub-batches.
+ * Only the first infer request is waited for, the others are taken only when idle, otherwise
+ * the request reuses infer request of its oldest sub-batch. This way requests being split never
+ * wait for each other while holding infer requests.
+ */
+class BatchSplitter {
+    ModelInstance& instance;
+    const size_t parallelism;
+
+    Status fillInputs(InferenceEngine::InferRequest& inferRequest, const tensorflow::serving::PredictRequest& request,
+        size_t requestBatchSize, size_t offset, size_t count);
+    Status gatherOutputs(InferenceEngine::InferRequest& inferRequest, const tensor_map_t& outputsInfo,
+        tensorflow::serving::PredictResponse& response, size_t requestBatchSize, size_t offset, size_t count);
+
+public:
+    /**
+     * @param parallelism max number of infer requests running sub-batches of single request
+     */
+    BatchSplitter(ModelInstance& instance, size_t parallelism) :
+        instance(instance),
+        parallelism(parallelism) {}
+
+    /**
+     * @brief Blocks until all sub-batches of the request are inferred
+     *
+     * @param requestProto request validated for any batch size, without binary inputs
+     * @param responseProto
+     * @param requestBatchSize batch dimension of the request inputs
+     * @param context
+     *
+     * @return Status
+     */
+    Status infer(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        size_t requestBatchSize,
+        const RequestContext& context);
+
+    size_t getParallelism() const {
+        return parallelism;
+    }
+};
+}  // namespace ovms
@@ -0,0 +1,162 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "../servable_benchmark.hpp"
+#include "../test/test_utils.hpp"
+
+using namespace ovms;
+
+namespace {
+
+const std::string MODEL_NAME = "dummy";
+const std::string PIPELINE_NAME = "churnPipeline";
+const uint32_t CONCURRENCY = 4;
+const std::chrono::milliseconds LOAD_DURATION{5000};
+
+struct ChurnState {
+    bool churnServables = false;
+    uint32_t nireq = 8;
+    std::string outputAlias = "new_dummy_output";
+};
+
+std::string pipelineConfig(const std::string& name, const std::string& outputAlias) {
+    return R"({"name": ")" + name + R"(",
+            "inputs": ["custom_dummy_input"],
+            "nodes": [{"name": "dummyNode", "model_name": "dummy", "type": "DL model",
+                "inputs": [{"b": {"node_name": "request", "data_item": "custom_dummy_input"}}],
+                "outputs": [{"data_item": "a", "alias": ")" +
+           outputAlias + R"("}]}],
+            "outputs": [{"custom_dummy_output": {"node_name": "dummyNode", "data_item": ")" +
+           outputAlias + R"("}}]})";
+}
+
+std::string createConfig(const std::string& modelPath, const ChurnState& churn) {
+    std::string config = R"({"model_config_list": [
+        {"config": {"name": "dummy", "base_path": ")" +
+                         modelPath + R"(", "nireq": )" + std::to_string(churn.nireq) + R"(}})";
+    if (churn.churnServables) {
+        config += R"(, {"config": {"name": "dummyChurn", "base_path": ")" + modelPath + R"("}})";
+    }
+    config += R"(], "pipeline_config_list": [)" + pipelineConfig(PIPELINE_NAME, churn.outputAlias);
+    if (churn.churnServables) {
+        config += ", " + pipelineConfig("churnPipelineAdded", "churn_output");
+    }
+    return config + "]}";
+}
+
+/**
+ * @brief Applies next step of cycle adding, reloading and retiring models, versions and pipelines
+ *
+ * Measured model and pipeline are always present, but their versions are swapped and they are reloaded.
+ */
+void applyChurnStep(uint64_t step, const std::string& modelPath, ChurnState& churn) {
+    switch (step % 6) {
+    case 0:
+        churn.churnServables = true;
+        break;
+    case 1:
+        std::filesystem::copy(modelPath + "/1", modelPath + "/2", std::filesystem::copy_options::recursive);
+        break;
+    case 2:
+        churn.nireq = 16;
+        break;
+    case 3:
+        churn.outputAlias = "changed_dummy_output";
+        break;
+    case 4:
+        std::filesystem::remove_all(modelPath + "/2");
+        break;
+    default:
+        churn = ChurnState();
+        break;
+    }
+}
+
+}  // namespace
+
+// Drives steady load of model and pipeline predictions while config is changed every interval given as argument, 0 gives baseline without changes
+static void BM_PredictUnderConfigChurn(benchmark::State& state) {
+    const std::chrono::milliseconds churnInterval{state.range(0)};
+    const std::string directory = (std::filesystem::temp_directory_path() / "ovms_config_churn_benchmark").string();
+    const std::string modelPath = directory + "/dummy";
+    const std::string configPath = directory + "/config.json";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::copy("/ovms/src/test/dummy", modelPath, std::filesystem::copy_options::recursive);
+    ChurnState churn;
+    createConfigFileWithContent(createConfig(modelPath, churn), configPath);
+    ConstructorEnabledModelManager manager;
+    auto status = manager.loadConfig(configPath);
+    if (!status.ok()) {
+        state.SkipWithError(status.string().c_str());
+        return;
+    }
+    for (auto _ : state) {
+        ServableBenchmark model(manager, MODEL_NAME, CONCURRENCY, LOAD_DURATION);
+        ServableBenchmark pipeline(manager, PIPELINE_NAME, CONCURRENCY, LOAD_DURATION);
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> reloads{0};
+        std::atomic<uint64_t> failedReloads{0};
+        std::thread churner([&]() {
+            if (churnInterval.count() == 0) {
+                return;
+            }
+            for (uint64_t step = 0; !stop; ++step) {
+                std::this_thread::sleep_for(churnInterval);
+                applyChurnStep(step, modelPath, churn);
+                createConfigFileWithContent(createConfig(modelPath, churn), configPath);
+                if (!manager.loadConfig(configPath).ok()) {
+                    ++failedReloads;
+                }
+                ++reloads;
+            }
+        });
+        Status pipelineStatus;
+        std::thread pipelineLoad([&pipeline, &pipelineStatus]() { pipelineStatus = pipeline.run(); });
+        status = model.run();
+        pipelineLoad.join();
+        stop = true;
+        churner.join();
+        if (!status.ok() || !pipelineStatus.ok()) {
+            state.SkipWithError((status.ok() ? pipelineStatus : status).string().c_str());
+            break;
+        }
+        state.SetIterationTime(LOAD_DURATION.count() / 1000.0);
+        for (const auto& [prefix, servable] : {std::make_pair("model_", &model), std::make_pair("pipeline_", &pipeline)}) {
+            const std::string name(prefix);
+            const double requests = servable->getCompletedRequestsCount() + servable->getFailedRequestsCount();
+            state.counters[name + "rps"] = servable->getThroughput();
+            state.counters[name + "p50_us"] = servable->getLatencyPercentileUs(50);
+            state.counters[name + "p99_us"] = servable->getLatencyPercentileUs(99);
+            state.counters[name + "p999_us"] = servable->getLatencyPercentileUs(99.9);
+            state.counters[name + "max_us"] = servable->getLatencyPercentileUs(100);
+            state.counters[name + "error_rate"] = requests == 0 ? 0 : servable->getFailedRequestsCount() / requests;
+        }
+        state.counters["reloads"] = reloads;
+        state.counters["failed_reloads"] = failedReloads;
+    }
+    manager.join();
+    std::filesystem::remove_all(directory);
+}
+BENCHMARK(BM_PredictUnderConfigChurn)->Arg(0)->Arg(200)->Arg(50)->Iterations(1)->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../http_rest_api_handler.hpp"
+#include "../status.hpp"
+
+using namespace ovms;
+
+namespace {
+
+// Predict, status, metadata, KServe infer and unknown path
+const std::vector<std::string> ROUTED_PATHS = {
+    "/v1/models/dummy:predict",
+    "/v1/models/dummy/versions/1:predict",
+    "/v1/models/dummy",
+    "/v1/models/dummy/versions/1/metadata",
+    "/v2/models/dummy/versions/1/infer",
+    "/v1/unknown/path",
+};
+
+// Reference routing as it was done before, trying paths regular expressions in order until first match
+std::vector<std::regex> makeRegularExpressions() {
+    return {
+        std::regex(HttpRestApiHandler::predictionRegexExp),
+        std::regex(HttpRestApiHandler::modelstatusRegexExp),
+        std::regex(HttpRestApiHandler::configReloadRegexExp),
+        std::regex(HttpRestApiHandler::configStatusRegexExp),
+        std::regex(HttpRestApiHandler::slowRequestsRegexExp),
+        std::regex(HttpRestApiHandler::residencyRegexExp),
+        std::regex(HttpRestApiHandler::peerFileRegexExp),
+        std::regex(HttpRestApiHandler::healthRegexExp),
+        std::regex(HttpRestApiHandler::sharedMemoryRegexExp),
+        std::regex(HttpRestApiHandler::kfsInferRegexExp),
+        std::regex(HttpRestApiHandler::metricsRegexExp),
+        std::regex(HttpRestApiHandler::rawInputPredictionRegexExp),
+        std::regex(HttpRestApiHandler::kfsInferBatchRegexExp),
+        std::regex(HttpRestApiHandler::sequenceStateRegexExp),
+    };
+}
+
+}  // namespace
+
+static void BM_ParseRequestComponents(benchmark::State& state) {
+    HttpRestApiHandler handler(10);
+    for (auto _ : state) {
+        for (const auto& path : ROUTED_PATHS) {
+            HttpRequestComponents components;
+            auto status = handler.parseRequestComponents(components, "POST", path);
+            benchmark::DoNotOptimize(status);
+            benchmark::DoNotOptimize(components);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ROUTED_PATHS.size());
+}
+BENCHMARK(BM_ParseRequestComponents);
+
+static void BM_RegexMatchRequestPath(benchmark::State& state) {
+    const auto regularExpressions = makeRegularExpressions();
+    for (auto _ : state) {
+        for (const auto& path : ROUTED_PATHS) {
+            std::smatch match;
+            for (const auto& regularExpression : regularExpressions) {
+                if (std::regex_match(path, match, regularExpression)) {
+                    break;
+                }
+            }
+            benchmark::DoNotOptimize(match);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ROUTED_PATHS.size());
+}
+BENCHMARK(BM_RegexMatchRequestPath);
@@ -0,0 +1,55 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "../ovinferrequestsqueue.hpp"
+
+namespace {
+
+const std::string DUMMY_MODEL_PATH = std::filesystem::current_path().u8string() + "/src/test/dummy/1/dummy.xml";
+
+InferenceEngine::ExecutableNetwork& getDummyNetwork() {
+    static InferenceEngine::ExecutableNetwork network = []() {
+        InferenceEngine::Core engine;
+        return engine.LoadNetwork(engine.ReadNetwork(DUMMY_MODEL_PATH), "CPU");
+    }();
+    return network;
+}
+
+const int STREAMS = 4;
+
+}  // namespace
+
+// Shared by all benchmark threads so that contention on the queue is measured
+static std::unique_ptr<ovms::OVInferRequestsQueue> queue;
+
+static void BM_InferRequestsQueueAcquireRelease(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        queue = std::make_unique<ovms::OVInferRequestsQueue>(getDummyNetwork(), STREAMS);
+    }
+    for (auto _ : state) {
+        int streamId = queue->getIdleStream().get();
+        queue->returnStream(streamId);
+    }
+    if (state.thread_index() == 0) {
+        queue.reset();
+    }
+}
+BENCHMARK(BM_InferRequestsQueueAcquireRelease)->ThreadRange(1, 2 * STREAMS)->UseRealTime();
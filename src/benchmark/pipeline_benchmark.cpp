@@ -0,0 +1,171 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../dl_node.hpp"
+#include "../entry_node.hpp"
+#include "../exit_node.hpp"
+#include "../node.hpp"
+#include "../nodesession.hpp"
+#include "../pipeline.hpp"
+#include "../test/test_utils.hpp"
+
+using namespace ovms;
+
+namespace {
+
+const std::string OUTPUT_NAME = "output";
+const std::string DEMULTIPLEXER_NODE_NAME = "demultiplexer";
+
+/**
+ * @brief Node returning prepared blob as its results, does not run inference
+ */
+class MockNode : public Node {
+    InferenceEngine::Blob::Ptr result;
+
+public:
+    MockNode(const std::string& nodeName, std::optional<uint32_t> demultiplyCount = std::nullopt, std::set<std::string> gatherFrom = {}) :
+        Node(nodeName, demultiplyCount, std::move(gatherFrom)) {}
+
+    void setResult(InferenceEngine::Blob::Ptr blob) {
+        result = std::move(blob);
+    }
+
+    Status execute(session_key_t sessionId, PipelineEventQueue& notifyEndQueue) override {
+        return StatusCode::OK;
+    }
+
+    void prepareSession(const NodeSessionMetadata& metadata) {
+        getNodeSession(metadata);
+    }
+
+    using Node::fetchResults;
+
+protected:
+    Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) override {
+        const auto& metadata = nodeSession.getNodeSessionMetadata();
+        BlobMap blobs;
+        if (result) {
+            blobs.emplace(OUTPUT_NAME, result);
+        }
+        nodeSessionOutputs.emplace(metadata.getSessionKey(), std::make_pair(metadata, std::move(blobs)));
+        return StatusCode::OK;
+    }
+};
+
+InferenceEngine::Blob::Ptr makeBlob(const std::vector<size_t>& shape) {
+    auto blob = InferenceEngine::make_shared_blob<float>({InferenceEngine::Precision::FP32, shape, InferenceEngine::TensorDesc::getLayoutByDims(shape)});
+    blob->allocate();
+    return blob;
+}
+
+}  // namespace
+
+static void BM_DemultiplyOutputs(benchmark::State& state) {
+    const uint32_t shards = state.range(0);
+    MockNode demultiplexer(DEMULTIPLEXER_NODE_NAME, shards);
+    demultiplexer.setResult(makeBlob({shards, 1, 3, 224, 224}));
+    NodeSessionMetadata meta;
+    const auto sessionKey = meta.getSessionKey();
+    for (auto _ : state) {
+        demultiplexer.prepareSession(meta);
+        SessionResults results;
+        auto status = demultiplexer.fetchResults(sessionKey, results);
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * shards);
+}
+BENCHMARK(BM_DemultiplyOutputs)->Arg(2)->Arg(16)->Arg(64);
+
+static void BM_GatherShards(benchmark::State& state) {
+    const uint32_t shards = state.range(0);
+    MockNode dependency("dependency");
+    MockNode gather("gather", std::nullopt, {DEMULTIPLEXER_NODE_NAME});
+    Pipeline::connect(dependency, gather, {{OUTPUT_NAME, OUTPUT_NAME}});
+    auto shard = makeBlob({1, 3, 224, 224});
+    NodeSessionMetadata meta;
+    auto subsessions = meta.generateSubsessions(DEMULTIPLEXER_NODE_NAME, shards);
+    for (auto _ : state) {
+        for (auto& subsession : subsessions) {
+            BlobMap inputs{{OUTPUT_NAME, shard}};
+            auto status = gather.setInputs(dependency, inputs, subsession);
+            if (!status.ok()) {
+                state.SkipWithError(status.string().c_str());
+                return;
+            }
+        }
+        auto readySessions = gather.getReadySessions();
+        if (readySessions.size() != 1) {
+            state.SkipWithError("Gathered session is not ready");
+            break;
+        }
+        SessionResults results;
+        gather.fetchResults(readySessions[0], results);
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * shards);
+}
+BENCHMARK(BM_GatherShards)->Arg(2)->Arg(16)->Arg(64);
+
+// Includes creation of pipeline nodes as done by PipelineFactory for each request
+static void BM_PipelineExecute(benchmark::State& state) {
+    ConstructorEnabledModelManager manager;
+    ModelConfig config = DUMMY_MODEL_CONFIG;
+    auto status = manager.reloadModelWithVersions(config);
+    if (!status.ok()) {
+        state.SkipWithError(status.string().c_str());
+        return;
+    }
+    const std::string inputName = "pipeline_input";
+    const std::string outputName = "pipeline_output";
+    const tensor_map_t inputsInfo{{inputName, std::make_shared<TensorInfo>(inputName, InferenceEngine::Precision::FP32, DUMMY_MODEL_SHAPE, InferenceEngine::Layout::NC)}};
+    const tensor_map_t outputsInfo{{outputName, std::make_shared<TensorInfo>(outputName, InferenceEngine::Precision::FP32, DUMMY_MODEL_SHAPE, InferenceEngine::Layout::NC)}};
+    std::vector<float> requestData(DUMMY_MODEL_INPUT_SIZE, 1.0);
+    tensorflow::serving::PredictRequest request;
+    auto& proto = (*request.mutable_inputs())[inputName];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_content()->assign((char*)requestData.data(), requestData.size() * sizeof(float));
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(DUMMY_MODEL_INPUT_SIZE);
+    for (auto _ : state) {
+        tensorflow::serving::PredictResponse response;
+        auto inputNode = std::make_unique<EntryNode>(&request, inputsInfo);
+        auto modelNode = std::make_unique<DLNode>("dummy_node", "dummy", std::nullopt, manager);
+        auto outputNode = std::make_unique<ExitNode>(&response, outputsInfo);
+        Pipeline pipeline(*inputNode, *outputNode);
+        pipeline.connect(*inputNode, *modelNode, {{inputName, DUMMY_MODEL_INPUT_NAME}});
+        pipeline.connect(*modelNode, *outputNode, {{DUMMY_MODEL_OUTPUT_NAME, outputName}});
+        pipeline.push(std::move(inputNode));
+        pipeline.push(std::move(modelNode));
+        pipeline.push(std::move(outputNode));
+        status = pipeline.execute();
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(response);
+    }
+}
+BENCHMARK(BM_PipelineExecute)->UseRealTime();
@@ -0,0 +1,177 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../binaryutils.hpp"
+#include "../blobmap.hpp"
+#include "../deserialization.hpp"
+#include "../rest_parser.hpp"
+#include "../rest_utils.hpp"
+#include "../serialization.hpp"
+#include "../test/test_utils.hpp"
+
+using namespace ovms;
+
+namespace {
+
+const std::string INPUT_NAME = "input";
+
+std::shared_ptr<TensorInfo> makeTensorInfo(const std::string& name, const shape_t& shape) {
+    return std::make_shared<TensorInfo>(name, InferenceEngine::Precision::FP32, shape, shape.size() == 4 ? InferenceEngine::Layout::NCHW : InferenceEngine::Layout::NC);
+}
+
+tensorflow::serving::PredictRequest makeRequest(const shape_t& shape) {
+    tensorflow::serving::PredictRequest request;
+    auto& proto = (*request.mutable_inputs())[INPUT_NAME];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    size_t elements = 1;
+    for (auto dim : shape) {
+        proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+        elements *= dim;
+    }
+    std::vector<float> data(elements, 1.0);
+    proto.mutable_tensor_content()->assign((char*)data.data(), data.size() * sizeof(float));
+    return request;
+}
+
+// Batch of N images 3x224x224 as in typical classification model
+shape_t imageBatchShape(const benchmark::State& state) {
+    return {static_cast<size_t>(state.range(0)), 3, 224, 224};
+}
+
+}  // namespace
+
+static void BM_DeserializePredictRequest(benchmark::State& state) {
+    auto shape = imageBatchShape(state);
+    auto request = makeRequest(shape);
+    tensor_map_t inputsInfo{{INPUT_NAME, makeTensorInfo(INPUT_NAME, shape)}};
+    for (auto _ : state) {
+        BlobMap blobs;
+        InputSink<BlobMap&> inputSink(blobs);
+        auto status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(request, inputsInfo, inputSink, true);
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(blobs);
+    }
+    state.SetBytesProcessed(state.iterations() * request.inputs().at(INPUT_NAME).tensor_content().size());
+}
+BENCHMARK(BM_DeserializePredictRequest)->Arg(1)->Arg(8);
+
+static void BM_SerializePredictResponse(benchmark::State& state) {
+    auto shape = imageBatchShape(state);
+    auto outputInfo = makeTensorInfo(INPUT_NAME, shape);
+    tensor_map_t outputsInfo{{INPUT_NAME, outputInfo}};
+    auto blob = InferenceEngine::make_shared_blob<float>(outputInfo->getTensorDesc());
+    blob->allocate();
+    const BlobMap blobs{{INPUT_NAME, blob}};
+    for (auto _ : state) {
+        tensorflow::serving::PredictResponse response;
+        OutputGetter<const BlobMap&> outputGetter(blobs);
+        auto status = serializePredictResponse(outputGetter, outputsInfo, &response);
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(response);
+    }
+    state.SetBytesProcessed(state.iterations() * blob->byteSize());
+}
+BENCHMARK(BM_SerializePredictResponse)->Arg(1)->Arg(8);
+
+static std::string makeRowJson(size_t batch, size_t elements) {
+    std::string json = R"({"instances":[)";
+    for (size_t i = 0; i < batch; i++) {
+        json += i ? ",[" : "[";
+        for (size_t j = 0; j < elements; j++) {
+            json += j ? ",0.5" : "0.5";
+        }
+        json += "]";
+    }
+    json += "]}";
+    return json;
+}
+
+static void BM_RestParserParse(benchmark::State& state) {
+    const size_t batch = state.range(0);
+    const size_t elements = 1000;
+    const auto json = makeRowJson(batch, elements);
+    const auto inputsInfo = prepareTensors({{INPUT_NAME, {batch, elements}}});
+    for (auto _ : state) {
+        RestParser parser(inputsInfo);
+        auto status = parser.parse(json.c_str());
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(parser.getProto());
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_RestParserParse)->Arg(1)->Arg(8);
+
+static void BM_MakeJsonFromPredictResponse(benchmark::State& state) {
+    const size_t batch = state.range(0);
+    const size_t elements = 1000;
+    tensorflow::serving::PredictResponse response;
+    auto& proto = (*response.mutable_outputs())[INPUT_NAME];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_shape()->add_dim()->set_size(batch);
+    proto.mutable_tensor_shape()->add_dim()->set_size(elements);
+    std::vector<float> data(batch * elements, 0.5);
+    proto.mutable_tensor_content()->assign((char*)data.data(), data.size() * sizeof(float));
+    for (auto _ : state) {
+        std::string json;
+        auto status = makeJsonFromPredictResponse(response, &json, Order::ROW);
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_MakeJsonFromPredictResponse)->Arg(1)->Arg(8);
+
+static void BM_ConvertStringValToBlob(benchmark::State& state) {
+    const size_t batch = state.range(0);
+    size_t filesize;
+    std::unique_ptr<char[]> imageBytes;
+    readRgbJpg(filesize, imageBytes);
+    tensorflow::TensorProto stringVal;
+    stringVal.set_dtype(tensorflow::DataType::DT_STRING);
+    stringVal.mutable_tensor_shape()->add_dim()->set_size(batch);
+    for (size_t i = 0; i < batch; i++) {
+        stringVal.add_string_val(imageBytes.get(), filesize);
+    }
+    auto tensorInfo = std::make_shared<TensorInfo>(INPUT_NAME, InferenceEngine::Precision::U8, shape_t{batch, 3, 1, 1}, InferenceEngine::Layout::NHWC);
+    for (auto _ : state) {
+        InferenceEngine::Blob::Ptr blob;
+        auto status = convertStringValToBlob(stringVal, blob, tensorInfo, false);
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(blob);
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_ConvertStringValToBlob)->Arg(1)->Arg(8);
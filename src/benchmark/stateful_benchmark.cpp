@@ -0,0 +1,264 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../modelinstanceunloadguard.hpp"
+#include "../sequence_manager.hpp"
+#include "../statefulmodelinstance.hpp"
+#include "../test/test_utils.hpp"
+
+using namespace ovms;
+
+namespace {
+
+const std::string MODEL_NAME = "summator";
+const std::chrono::milliseconds LOAD_DURATION{10000};
+// steps of a sequence come at fixed rate, like audio frames of a streaming speech recognition session
+const std::chrono::milliseconds STEP_INTERVAL{20};
+// lifetimes of sequences are drawn uniformly from half to one and a half of the mean
+const uint32_t MEAN_SEQUENCE_STEPS = 50;
+const uint32_t IDLE_SEQUENCE_TIMEOUT_SECONDS = 1;
+const std::chrono::milliseconds MEMORY_SAMPLING_INTERVAL{500};
+
+enum StepKind {
+    START,
+    STEP,
+    END,
+    KINDS_COUNT
+};
+
+const char* STEP_KIND_NAMES[KINDS_COUNT] = {"start", "step", "end"};
+
+struct SimulatedSequence {
+    std::chrono::steady_clock::time_point nextStep;
+    uint64_t sequenceId = 0;
+    uint32_t stepsLeft = 0;
+    bool abandoned = false;
+
+    bool operator>(const SimulatedSequence& other) const {
+        return nextStep > other.nextStep;
+    }
+};
+
+struct WorkerResults {
+    std::vector<uint64_t> latenciesUs[KINDS_COUNT];
+    uint64_t errors = 0;
+};
+
+std::string createConfig(const std::string& modelPath, uint32_t maxSequenceNumber) {
+    return R"({"model_config_list": [
+        {"config": {"name": ")" +
+           MODEL_NAME + R"(", "base_path": ")" + modelPath + R"(", "stateful": true, "nireq": 8,
+            "max_sequence_number": )" +
+           std::to_string(maxSequenceNumber) + R"(, "idle_sequence_timeout_seconds": )" + std::to_string(IDLE_SEQUENCE_TIMEOUT_SECONDS) + R"(}}]})";
+}
+
+tensorflow::serving::PredictRequest createRequest(uint64_t sequenceId, uint32_t sequenceControl) {
+    tensorflow::serving::PredictRequest request;
+    request.mutable_model_spec()->set_name(MODEL_NAME);
+    auto& input = (*request.mutable_inputs())["input"];
+    input.set_dtype(tensorflow::DataType::DT_FLOAT);
+    input.mutable_tensor_shape()->add_dim()->set_size(1);
+    input.mutable_tensor_shape()->add_dim()->set_size(1);
+    input.add_float_val(1.0);
+    auto& id = (*request.mutable_inputs())["sequence_id"];
+    id.set_dtype(tensorflow::DataType::DT_UINT64);
+    id.mutable_tensor_shape()->add_dim()->set_size(1);
+    id.add_uint64_val(sequenceId);
+    auto& control = (*request.mutable_inputs())["sequence_control_input"];
+    control.set_dtype(tensorflow::DataType::DT_UINT32);
+    control.mutable_tensor_shape()->add_dim()->set_size(1);
+    control.add_uint32_val(sequenceControl);
+    return request;
+}
+
+/**
+ * @brief Drives its share of concurrent sequences, each step is sent at its scheduled time
+ *
+ * Latency is counted from the scheduled time, so steps delayed by earlier slow steps of the worker show up in results.
+ * Ended sequence is replaced by a new one starting at its next step time. Abandoned sequence stops sending steps
+ * without ending, and is left for idle sequence cleanup.
+ */
+void runWorker(ModelManager& manager, uint32_t sequencesCount, uint32_t abandonedPercent, std::chrono::steady_clock::time_point end, WorkerResults& results) {
+    std::mt19937 generator(std::random_device{}());
+    std::uniform_int_distribution<uint32_t> lifetime(MEAN_SEQUENCE_STEPS / 2, MEAN_SEQUENCE_STEPS * 3 / 2);
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+    std::uniform_int_distribution<int64_t> phase(0, std::chrono::duration_cast<std::chrono::microseconds>(STEP_INTERVAL).count());
+    std::priority_queue<SimulatedSequence, std::vector<SimulatedSequence>, std::greater<SimulatedSequence>> sequences;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < sequencesCount; ++i) {
+        // sequences are spread over step interval, so their steps do not arrive in bursts
+        sequences.push({start + std::chrono::microseconds(phase(generator)), 0, lifetime(generator), percent(generator) < abandonedPercent});
+    }
+    while (true) {
+        auto sequence = sequences.top();
+        if (sequence.nextStep >= end) {
+            break;
+        }
+        sequences.pop();
+        std::this_thread::sleep_until(sequence.nextStep);
+        StepKind kind = sequence.sequenceId == 0 ? START : (sequence.stepsLeft == 1 && !sequence.abandoned ? END : STEP);
+        auto request = createRequest(sequence.sequenceId, kind == START ? SEQUENCE_START : (kind == END ? SEQUENCE_END : NO_CONTROL_INPUT));
+        tensorflow::serving::PredictResponse response;
+        std::shared_ptr<ModelInstance> instance;
+        std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+        auto status = manager.getModelInstance(MODEL_NAME, 0, instance, unloadGuard);
+        if (status.ok()) {
+            status = instance->infer(&request, &response, unloadGuard);
+        }
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sequence.nextStep).count();
+        if (!status.ok()) {
+            ++results.errors;
+            // failed sequence is replaced by a new one
+            sequence.stepsLeft = 1;
+            sequence.abandoned = true;
+        } else {
+            results.latenciesUs[kind].push_back(latency);
+            if (kind == START) {
+                sequence.sequenceId = response.outputs().at("sequence_id").uint64_val(0);
+            }
+        }
+        sequence.nextStep += STEP_INTERVAL;
+        if (--sequence.stepsLeft == 0) {
+            sequence = {sequence.nextStep, 0, lifetime(generator), percent(generator) < abandonedPercent};
+        }
+        sequences.push(sequence);
+    }
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double percentile) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(1, rank)) - 1];
+}
+
+}  // namespace
+
+// Simulates concurrent sequences of stateful model given as the first argument, the second one is percentage of sequences
+// abandoned without end, which are removed by idle sequence cleanup running every second as the sequence cleaner does
+static void BM_StatefulSequences(benchmark::State& state) {
+    const uint32_t sequencesCount = static_cast<uint32_t>(state.range(0));
+    const uint32_t abandonedPercent = static_cast<uint32_t>(state.range(1));
+    const uint32_t workersCount = std::min<uint32_t>(sequencesCount, std::max<uint32_t>(1, std::thread::hardware_concurrency()));
+    const std::string directory = (std::filesystem::temp_directory_path() / "ovms_stateful_benchmark").string();
+    const std::string modelPath = directory + "/summator";
+    const std::string configPath = directory + "/config.json";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::copy("/ovms/src/test/summator", modelPath, std::filesystem::copy_options::recursive);
+    // abandoned sequences live until cleanup, so there is room for them on top of active ones
+    createConfigFileWithContent(createConfig(modelPath, sequencesCount * 4), configPath);
+    ConstructorEnabledModelManager manager;
+    auto status = manager.loadConfig(configPath);
+    std::shared_ptr<ModelInstance> instance;
+    std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+    if (status.ok()) {
+        status = manager.getModelInstance(MODEL_NAME, 0, instance, unloadGuard);
+    }
+    auto stateful = std::dynamic_pointer_cast<StatefulModelInstance>(instance);
+    if (!status.ok() || !stateful) {
+        state.SkipWithError(status.ok() ? "model is not stateful" : status.string().c_str());
+        return;
+    }
+    // instance is kept for sequence manager statistics, guard would block unloading at the end
+    unloadGuard.reset();
+    auto& sequenceManager = *stateful->getSequenceManager();
+
+    for (auto _ : state) {
+        const auto lockStatsStart = sequenceManager.getShardLockStats();
+        std::vector<WorkerResults> results(workersCount);
+        std::vector<std::thread> workers;
+        const auto start = std::chrono::steady_clock::now();
+        const auto end = start + LOAD_DURATION;
+        for (uint32_t i = 0; i < workersCount; ++i) {
+            const uint32_t share = sequencesCount / workersCount + (i < sequencesCount % workersCount ? 1 : 0);
+            workers.emplace_back(runWorker, std::ref(manager), share, abandonedPercent, end, std::ref(results[i]));
+        }
+        uint64_t peakSequences = 0;
+        uint64_t stateBytesPerSequence = 0;
+        auto nextCleanup = start + std::chrono::seconds(1);
+        while (std::chrono::steady_clock::now() < end) {
+            std::this_thread::sleep_for(MEMORY_SAMPLING_INTERVAL);
+            const uint64_t sequences = sequenceManager.getSequencesCount();
+            const uint64_t bytes = sequenceManager.getMemoryStateBytes();
+            if (sequences >= peakSequences && sequences > 0) {
+                peakSequences = sequences;
+                stateBytesPerSequence = bytes / sequences;
+            }
+            if (std::chrono::steady_clock::now() >= nextCleanup) {
+                sequenceManager.removeExpiredSequences();
+                nextCleanup += std::chrono::seconds(1);
+            }
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.SetIterationTime(elapsedSeconds);
+
+        uint64_t steps = 0;
+        uint64_t errors = 0;
+        std::vector<uint64_t> all;
+        for (int kind = 0; kind < KINDS_COUNT; ++kind) {
+            std::vector<uint64_t> latencies;
+            for (auto& worker : results) {
+                latencies.insert(latencies.end(), worker.latenciesUs[kind].begin(), worker.latenciesUs[kind].end());
+            }
+            std::sort(latencies.begin(), latencies.end());
+            const std::string name = STEP_KIND_NAMES[kind];
+            state.counters[name + "_p50_us"] = percentile(latencies, 50);
+            state.counters[name + "_p99_us"] = percentile(latencies, 99);
+            steps += latencies.size();
+            all.insert(all.end(), latencies.begin(), latencies.end());
+        }
+        for (auto& worker : results) {
+            errors += worker.errors;
+        }
+        std::sort(all.begin(), all.end());
+        const auto lockStats = sequenceManager.getShardLockStats();
+        const uint64_t acquisitions = lockStats.acquisitions - lockStatsStart.acquisitions;
+        const uint64_t contentions = lockStats.contentions - lockStatsStart.contentions;
+        state.counters["steps_per_second"] = steps / elapsedSeconds;
+        state.counters["p50_us"] = percentile(all, 50);
+        state.counters["p99_us"] = percentile(all, 99);
+        state.counters["p999_us"] = percentile(all, 99.9);
+        state.counters["max_us"] = percentile(all, 100);
+        state.counters["errors"] = errors;
+        state.counters["shard_lock_contention_ratio"] = acquisitions == 0 ? 0 : static_cast<double>(contentions) / acquisitions;
+        state.counters["shard_lock_wait_us_per_contention"] = contentions == 0 ? 0 : static_cast<double>(lockStats.waitUs - lockStatsStart.waitUs) / contentions;
+        state.counters["peak_sequences"] = peakSequences;
+        state.counters["state_bytes_per_sequence"] = stateBytesPerSequence;
+    }
+    instance.reset();
+    manager.join();
+    std::filesystem::remove_all(directory);
+}
+BENCHMARK(BM_StatefulSequences)->Args({16, 0})->Args({256, 0})->Args({1024, 0})->Args({256, 20})->Iterations(1)->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -22,16 +22,26 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <dlfcn.h>
 #include <inference_engine.hpp>
 
 #include "binaryutils.hpp"
+#include "deserialization.hpp"
+#include "image_decoder_interface.h"
 #include "logging.hpp"
 #include "opencv2/opencv.hpp"
+#include "tensor_buffer_pool.hpp"
+#include "workerpool.hpp"
 
 namespace ovms {
 
@@ -64,12 +74,104 @@ bool isPrecisionEqual(int matPrecision, InferenceEngine::Precision tensorPrecisi
     return false;
 }
 
-cv::Mat convertStringValToMat(const std::string& stringVal) {
-    std::vector<unsigned char> data(stringVal.begin(), stringVal.end());
-    cv::Mat dataMat(data, true);
+/**
+ * @brief Reads resolution and number of components from frame header of baseline, extended or progressive 8 bit JPEG
+ */
+bool readJpegFrameHeader(const std::string& data, int& width, int& height, int& components) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    const size_t size = data.size();
+    if (size < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) {
+        return false;
+    }
+    size_t i = 2;
+    while (i + 4 <= size) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = bytes[i + 1];
+        if (marker == 0xFF) {
+            // fill byte
+            i++;
+            continue;
+        }
+        i += 2;
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+            // markers without segment
+            continue;
+        }
+        if (marker == 0xD9 || marker == 0xDA) {
+            // end of image or scan data before frame header
+            return false;
+        }
+        const size_t length = (bytes[i] << 8) | bytes[i + 1];
+        if (length < 2 || i + length > size) {
+            return false;
+        }
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            const bool scalable = marker == 0xC0 || marker == 0xC1 || marker == 0xC2;
+            if (!scalable || length < 8 || bytes[i + 2] != 8) {
+                return false;
+            }
+            height = (bytes[i + 3] << 8) | bytes[i + 4];
+            width = (bytes[i + 5] << 8) | bytes[i + 6];
+            components = bytes[i + 7];
+            return true;
+        }
+        i += length;
+    }
+    return false;
+}
+
+/**
+ * @brief Selects imdecode flags, using JPEG DCT domain downscaling when input resolution is at least twice the target
+ *
+ * Reduced decoding is used only when target resolution and number of channels are known from tensor info
+ * and JPEG has the same number of components, so that result channels are the same as with IMREAD_UNCHANGED.
+ */
+int getDecodeFlags(const std::string& stringVal, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    const auto& shape = tensorInfo->getEffectiveShape();
+    size_t offset = 0;
+    if (shape.size() == 5 && tensorInfo->isInfluencedByDemultiplexer()) {
+        offset = 1;
+    } else if (shape.size() != 4) {
+        return cv::IMREAD_UNCHANGED;
+    }
+    if (tensorInfo->getLayout() != InferenceEngine::Layout::NHWC && tensorInfo->getLayout() != InferenceEngine::Layout::ANY) {
+        return cv::IMREAD_UNCHANGED;
+    }
+    const size_t rows = shape[offset + 1];
+    const size_t cols = shape[offset + 2];
+    const size_t channels = shape[offset + 3];
+    int width = 0, height = 0, components = 0;
+    if (rows == 0 || cols == 0 || (channels != 1 && channels != 3) ||
+        !readJpegFrameHeader(stringVal, width, height, components) || static_cast<size_t>(components) != channels) {
+        return cv::IMREAD_UNCHANGED;
+    }
+    // libjpeg scales to ceil(size / denominator), result should not be smaller than target
+    const auto fits = [&](size_t denominator) {
+        return (width + denominator - 1) / denominator >= cols && (height + denominator - 1) / denominator >= rows;
+    };
+    const bool grayscale = channels == 1;
+    int flags = cv::IMREAD_UNCHANGED;
+    if (fits(8)) {
+        flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8;
+    } else if (fits(4)) {
+        flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4;
+    } else if (fits(2)) {
+        flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2;
+    } else {
+        return cv::IMREAD_UNCHANGED;
+    }
+    // IMREAD_UNCHANGED does not apply EXIF orientation either
+    return flags | cv::IMREAD_IGNORE_ORIENTATION;
+}
+
+cv::Mat convertStringValToMat(const std::string& stringVal, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    // header over request data, decoder reads it without a copy
+    const cv::Mat dataMat(1, static_cast<int>(stringVal.size()), CV_8UC1, const_cast<char*>(stringVal.data()));
 
     try {
-        return cv::imdecode(dataMat, cv::IMREAD_UNCHANGED);
+        return cv::imdecode(dataMat, getDecodeFlags(stringVal, tensorInfo));
     } catch (const cv::Exception& e) {
         SPDLOG_ERROR("Error during string_val to mat conversion: {}", e.what());
         return cv::Mat{};
@@ -87,6 +189,10 @@ Status convertPrecision(const cv::Mat& src, cv::Mat& dst, const InferenceEngine:
 }
 
 bool resizeNeeded(const cv::Mat& image, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    if (tensorInfo->isResizedByPreprocessing()) {
+        // OpenVINO resizes images to network input during inference
+        return false;
+    }
     if (tensorInfo->getLayout() != InferenceEngine::Layout::NHWC && tensorInfo->getLayout() != InferenceEngine::Layout::ANY) {
         return false;
     }
@@ -115,7 +221,7 @@ bool resizeNeeded(const cv::Mat& image, const std::shared_ptr<TensorInfo>& tenso
     return false;
 }
 
-Status resizeMat(const cv::Mat& src, cv::Mat& dst, const std::shared_ptr<TensorInfo>& tensorInfo) {
+Status getResizeResolution(const cv::Mat& src, const std::shared_ptr<TensorInfo>& tensorInfo, cv::Size& size) {
     if (tensorInfo->getLayout() != InferenceEngine::Layout::NHWC && tensorInfo->getLayout() != InferenceEngine::Layout::ANY) {
         return StatusCode::UNSUPPORTED_LAYOUT;
     }
@@ -138,7 +244,17 @@ Status resizeMat(const cv::Mat& src, cv::Mat& dst, const std::shared_ptr<TensorI
             rows = src.rows;
         }
     }
-    cv::resize(src, dst, cv::Size(cols, rows));
+    size = cv::Size(cols, rows);
+    return StatusCode::OK;
+}
+
+Status resizeMat(const cv::Mat& src, cv::Mat& dst, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    cv::Size size;
+    auto status = getResizeResolution(src, tensorInfo, size);
+    if (!status.ok()) {
+        return status;
+    }
+    cv::resize(src, dst, size);
     return StatusCode::OK;
 }
 
@@ -200,7 +316,8 @@ Status validateInput(const std::shared_ptr<TensorInfo>& tensorInfo, const cv::Ma
     // With unknown layout, there is no way to deduce pipeline input resolution.
     // This forces binary utility to create blobs with resolution inherited from input binary image from request.
     // To achieve it, in this specific case we require all binary images to have the same resolution.
-    if (firstBatchImage && tensorInfo->getLayout() == InferenceEngine::Layout::ANY) {
+    // The same applies to inputs resized by OpenVINO preprocessing.
+    if (firstBatchImage && (tensorInfo->getLayout() == InferenceEngine::Layout::ANY || tensorInfo->isResizedByPreprocessing())) {
         auto status = validateResolutionAgainstFirstBatchImage(input, firstBatchImage);
         if (!status.ok()) {
             return status;
@@ -236,83 +353,116 @@ Status validateTensor(const std::shared_ptr<TensorInfo>& tensorInfo,
     return StatusCode::OK;
 }
 
-Status convertTensorToMatsMatchingTensorInfo(const tensorflow::TensorProto& src, std::vector<cv::Mat>& images, const std::shared_ptr<TensorInfo>& tensorInfo) {
-    for (int i = 0; i < src.string_val_size(); i++) {
-        cv::Mat image = convertStringValToMat(src.string_val(i));
-        if (image.data == nullptr)
-            return StatusCode::IMAGE_PARSING_FAILED;
+Status convertStringValToMatMatchingTensorInfo(const std::string& stringVal, cv::Mat& image, const std::shared_ptr<TensorInfo>& tensorInfo, cv::Mat* firstImage) {
+    image = convertStringValToMat(stringVal, tensorInfo);
+    if (image.data == nullptr)
+        return StatusCode::IMAGE_PARSING_FAILED;
+
+    auto status = validateInput(tensorInfo, image, firstImage);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+
+    if (!isPrecisionEqual(image.depth(), tensorInfo->getPrecision())) {
+        cv::Mat imageCorrectPrecision;
+        status = convertPrecision(image, imageCorrectPrecision, tensorInfo->getPrecision());
 
-        cv::Mat* firstImage = images.size() == 0 ? nullptr : &images.at(0);
-        auto status = validateInput(tensorInfo, image, firstImage);
         if (status != StatusCode::OK) {
             return status;
         }
+        image = std::move(imageCorrectPrecision);
+    }
+    if (resizeNeeded(image, tensorInfo)) {
+        cv::Mat imageResized;
+        status = resizeMat(image, imageResized, tensorInfo);
+        if (!status.ok()) {
+            return status;
+        }
+        image = std::move(imageResized);
+    }
+    return StatusCode::OK;
+}
 
-        if (!isPrecisionEqual(image.depth(), tensorInfo->getPrecision())) {
-            cv::Mat imageCorrectPrecision;
-            status = convertPrecision(image, imageCorrectPrecision, tensorInfo->getPrecision());
+/**
+ * @brief Converts string_val to image matching tensor info, last processing step writes into blob slot
+ */
+Status convertStringValToSlot(const std::string& stringVal, char* slot, size_t slotSize, const std::shared_ptr<TensorInfo>& tensorInfo, cv::Mat* firstImage) {
+    cv::Mat image = convertStringValToMat(stringVal, tensorInfo);
+    if (image.data == nullptr)
+        return StatusCode::IMAGE_PARSING_FAILED;
 
-            if (status != StatusCode::OK) {
-                return status;
-            }
-            image = std::move(imageCorrectPrecision);
-        }
-        if (resizeNeeded(image, tensorInfo)) {
-            cv::Mat imageResized;
-            status = resizeMat(image, imageResized, tensorInfo);
-            if (!status.ok()) {
-                return status;
-            }
-            image = std::move(imageResized);
-        }
-        images.push_back(image);
+    auto status = validateInput(tensorInfo, image, firstImage);
+    if (status != StatusCode::OK) {
+        return status;
     }
 
+    const int type = getMatTypeFromTensorPrecision(tensorInfo->getPrecision());
+    if (type == -1) {
+        return StatusCode::INVALID_PRECISION;
+    }
+    const bool convert = !isPrecisionEqual(image.depth(), tensorInfo->getPrecision());
+    const bool resize = resizeNeeded(image, tensorInfo);
+    cv::Size size = image.size();
+    if (resize) {
+        status = getResizeResolution(image, tensorInfo, size);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    cv::Mat slotMat(size, CV_MAKETYPE(type, image.channels()), slot);
+    if (static_cast<size_t>(size.area()) * slotMat.elemSize() != slotSize) {
+        SPDLOG_DEBUG("Binary image of {}x{} resolution does not match input: {}", size.width, size.height, tensorInfo->getMappedName());
+        return StatusCode::BINARY_IMAGES_RESOLUTION_MISMATCH;
+    }
+    // destination matches size and type of slotMat, so OpenCV writes into blob memory
+    if (convert && resize) {
+        cv::Mat imageCorrectPrecision;
+        image.convertTo(imageCorrectPrecision, type);
+        cv::resize(imageCorrectPrecision, slotMat, size);
+    } else if (convert) {
+        image.convertTo(slotMat, type);
+    } else if (resize) {
+        cv::resize(image, slotMat, size);
+    } else {
+        image.copyTo(slotMat);
+    }
     return StatusCode::OK;
 }
 
-InferenceEngine::SizeVector getShapeFromImages(const std::vector<cv::Mat>& images, const std::shared_ptr<TensorInfo>& tensorInfo) {
+InferenceEngine::SizeVector getShapeFromImages(const cv::Mat& firstImage, size_t batchSize, const std::shared_ptr<TensorInfo>& tensorInfo) {
     InferenceEngine::SizeVector dims;
-    dims.push_back(images.size());
+    dims.push_back(batchSize);
     if (tensorInfo->isInfluencedByDemultiplexer()) {
         dims.push_back(1);
     }
-    dims.push_back(images[0].rows);
-    dims.push_back(images[0].cols);
-    dims.push_back(images[0].channels());
+    dims.push_back(firstImage.rows);
+    dims.push_back(firstImage.cols);
+    dims.push_back(firstImage.channels());
     return dims;
 }
 
 template <typename T>
-InferenceEngine::Blob::Ptr createBlobFromMats(const std::vector<cv::Mat>& images, const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
-    auto dims = !isPipeline ? tensorInfo->getShape() : getShapeFromImages(images, tensorInfo);
-    InferenceEngine::TensorDesc desc{tensorInfo->getPrecision(), dims, InferenceEngine::Layout::ANY};
-    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<T>(desc);
-    blob->allocate();
-    char* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<char*>();
-    for (cv::Mat image : images) {
-        memcpy(ptr, (char*)image.data, image.total() * image.elemSize());
-        ptr += (image.total() * image.elemSize());
-    }
-    return blob;
+InferenceEngine::Blob::Ptr createBlob(const InferenceEngine::TensorDesc& desc) {
+    return makePooledBlob<T>(desc);
 }
 
-InferenceEngine::Blob::Ptr convertMatsToBlob(std::vector<cv::Mat>& images, const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
+InferenceEngine::Blob::Ptr createBlobForImages(const InferenceEngine::SizeVector& dims, const std::shared_ptr<TensorInfo>& tensorInfo, InferenceEngine::Layout layout = InferenceEngine::Layout::ANY) {
+    InferenceEngine::TensorDesc desc{tensorInfo->getPrecision(), dims, layout};
     switch (tensorInfo->getPrecision()) {
     case InferenceEngine::Precision::FP32:
-        return createBlobFromMats<float>(images, tensorInfo, isPipeline);
+        return createBlob<float>(desc);
     case InferenceEngine::Precision::I32:
-        return createBlobFromMats<int32_t>(images, tensorInfo, isPipeline);
+        return createBlob<int32_t>(desc);
     case InferenceEngine::Precision::I8:
-        return createBlobFromMats<int8_t>(images, tensorInfo, isPipeline);
+        return createBlob<int8_t>(desc);
     case InferenceEngine::Precision::U8:
-        return createBlobFromMats<uint8_t>(images, tensorInfo, isPipeline);
+        return createBlob<uint8_t>(desc);
     case InferenceEngine::Precision::FP16:
-        return createBlobFromMats<uint16_t>(images, tensorInfo, isPipeline);
+        return createBlob<uint16_t>(desc);
     case InferenceEngine::Precision::U16:
-        return createBlobFromMats<uint16_t>(images, tensorInfo, isPipeline);
+        return createBlob<uint16_t>(desc);
     case InferenceEngine::Precision::I16:
-        return createBlobFromMats<int16_t>(images, tensorInfo, isPipeline);
+        return createBlob<int16_t>(desc);
     case InferenceEngine::Precision::I64:
     case InferenceEngine::Precision::MIXED:
     case InferenceEngine::Precision::Q78:
@@ -324,20 +474,333 @@ InferenceEngine::Blob::Ptr convertMatsToBlob(std::vector<cv::Mat>& images, const
     }
 }
 
+namespace {
+std::shared_ptr<WorkerPool> imageDecodePool;
+
+/**
+ * @brief Runs task for indexes from begin to end on calling thread and idle image decode workers
+ */
+void parallelFor(size_t begin, size_t end, const std::function<bool(size_t)>& task) {
+    auto pool = std::atomic_load(&imageDecodePool);
+    WorkerPool::parallelFor(pool.get(), begin, end, task);
+}
+}  // namespace
+
+void setImageDecodeWorkers(size_t workers) {
+    std::atomic_store(&imageDecodePool, workers > 0 ? std::make_shared<WorkerPool>(workers) : std::shared_ptr<WorkerPool>());
+}
+
+namespace {
+typedef int (*decode_images_fn)(const struct ImageDecoderImage*, int, uint64_t, uint64_t, uint64_t, uint8_t*, int*);
+
+struct ImageDecoderLibrary {
+    void* handle = nullptr;
+    decode_images_fn decodeImages = nullptr;
+
+    ~ImageDecoderLibrary() {
+        if (handle) {
+            dlclose(handle);
+        }
+    }
+};
+
+// requests decoding with library keep it loaded when it is replaced
+std::shared_ptr<ImageDecoderLibrary> imageDecoderLibrary;
+}  // namespace
+
+Status loadImageDecoderLibrary(const std::string& path) {
+    if (path.empty()) {
+        std::atomic_store(&imageDecoderLibrary, std::shared_ptr<ImageDecoderLibrary>());
+        return StatusCode::OK;
+    }
+    void* handle = dlopen(path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+    char* error = dlerror();
+    if (handle == NULL) {
+        SPDLOG_ERROR("Image decoder library failed to open path: {} with error: {}", path, error);
+        return StatusCode::IMAGE_DECODER_LIBRARY_LOAD_FAILED;
+    }
+    decode_images_fn decodeImages = reinterpret_cast<decode_images_fn>(dlsym(handle, "decodeImages"));
+    error = dlerror();
+    if (error || decodeImages == nullptr) {
+        SPDLOG_ERROR("Image decoder library: {} does not export decodeImages: {}", path, error ? error : "");
+        dlclose(handle);
+        return StatusCode::IMAGE_DECODER_LIBRARY_LOAD_FAILED;
+    }
+    SPDLOG_INFO("Loaded image decoder library: {}", path);
+    auto library = std::make_shared<ImageDecoderLibrary>();
+    library->handle = handle;
+    library->decodeImages = decodeImages;
+    std::atomic_store(&imageDecoderLibrary, std::move(library));
+    return StatusCode::OK;
+}
+
+namespace {
+Status decodeImageForPlanarYuv(const std::string& stringVal, cv::Mat& image, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    if (stringVal.size() <= 0) {
+        return StatusCode::STRING_VAL_EMPTY;
+    }
+    cv::Mat data(1, stringVal.size(), CV_8UC1, const_cast<char*>(stringVal.data()));
+    image = cv::imdecode(data, cv::IMREAD_COLOR);
+    if (image.data == nullptr) {
+        return StatusCode::IMAGE_PARSING_FAILED;
+    }
+    if (tensorInfo->isResizedByPreprocessing()) {
+        return StatusCode::OK;
+    }
+    // dimensions of tensor descriptor are always in NCHW order
+    const auto& dims = tensorInfo->getTensorDesc().getDims();
+    const cv::Size size(dims[3], dims[2]);
+    if (image.size() != size) {
+        cv::Mat resized;
+        cv::resize(image, resized, size);
+        image = std::move(resized);
+    }
+    return StatusCode::OK;
+}
+
+void writePlanarYuvFrame(const cv::Mat& image, char* frame, InferenceEngine::ColorFormat colorFormat) {
+    // I420 frame has Y plane followed by U and V planes, NV12 frame has Y plane followed by interleaved U and V
+    if (colorFormat == InferenceEngine::ColorFormat::I420) {
+        cv::Mat i420(image.rows * 3 / 2, image.cols, CV_8UC1, frame);
+        cv::cvtColor(image, i420, cv::COLOR_BGR2YUV_I420);
+        return;
+    }
+    cv::Mat i420;
+    cv::cvtColor(image, i420, cv::COLOR_BGR2YUV_I420);
+    const size_t lumaSize = image.total();
+    const size_t chromaSize = lumaSize / 4;
+    std::memcpy(frame, i420.data, lumaSize);
+    const uint8_t* u = i420.data + lumaSize;
+    const uint8_t* v = u + chromaSize;
+    uint8_t* uv = reinterpret_cast<uint8_t*>(frame) + lumaSize;
+    for (size_t i = 0; i < chromaSize; i++) {
+        uv[2 * i] = u[i];
+        uv[2 * i + 1] = v[i];
+    }
+}
+
+/**
+ * @brief Converts images to NV12 or I420 frames of input converted by OpenVINO preprocessing
+ *
+ * Images are resized to input resolution unless it is resized by preprocessing, then they have to match the first image.
+ */
+Status convertStringValToPlanarYuvBlob(const tensorflow::TensorProto& src, InferenceEngine::Blob::Ptr& blob, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    if (checkBatchSizeMismatch(tensorInfo, src.string_val_size())) {
+        SPDLOG_DEBUG("Input: {} request batch size is incorrect. Expected: {} Actual: {}", tensorInfo->getMappedName(), tensorInfo->getEffectiveShape()[0], src.string_val_size());
+        return StatusCode::INVALID_BATCH_SIZE;
+    }
+    cv::Mat firstImage;
+    auto status = decodeImageForPlanarYuv(src.string_val(0), firstImage, tensorInfo);
+    if (!status.ok()) {
+        return status;
+    }
+    if (firstImage.rows % 2 != 0 || firstImage.cols % 2 != 0) {
+        SPDLOG_DEBUG("Binary image of {}x{} resolution cannot be converted to planar YUV of input: {}, width and height have to be even",
+            firstImage.cols, firstImage.rows, tensorInfo->getMappedName());
+        return StatusCode::BINARY_IMAGES_RESOLUTION_MISMATCH;
+    }
+
+    const size_t batchSize = src.string_val_size();
+    const size_t frameSize = firstImage.total() * 3 / 2;
+    const auto colorFormat = tensorInfo->getColorFormat();
+    std::shared_ptr<char> data(new char[batchSize * frameSize], std::default_delete<char[]>());
+    writePlanarYuvFrame(firstImage, data.get(), colorFormat);
+
+    std::vector<Status> statuses(batchSize);
+    parallelFor(1, batchSize, [&](size_t i) {
+        cv::Mat image;
+        statuses[i] = decodeImageForPlanarYuv(src.string_val(i), image, tensorInfo);
+        if (statuses[i].ok()) {
+            statuses[i] = validateResolutionAgainstFirstBatchImage(image, &firstImage);
+        }
+        if (statuses[i].ok()) {
+            writePlanarYuvFrame(image, data.get() + i * frameSize, colorFormat);
+        }
+        return statuses[i].ok();
+    });
+    for (const auto& imageStatus : statuses) {
+        if (!imageStatus.ok()) {
+            return imageStatus;
+        }
+    }
+
+    blob = makePlanarYuvBlob(colorFormat, batchSize, firstImage.rows, firstImage.cols, data.get(), data);
+    return StatusCode::OK;
+}
+}  // namespace
+
+bool isRawBinaryInput(const TensorInfo& tensorInfo) {
+    return tensorInfo.getPrecision() == InferenceEngine::Precision::U8 && tensorInfo.getEffectiveShape().size() == 1;
+}
+
+Status convertStringValToRawBlob(const tensorflow::TensorProto& src, InferenceEngine::Blob::Ptr& blob, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    // one dimensional tensor holds bytes of single encoded image
+    if (src.string_val_size() != 1) {
+        SPDLOG_DEBUG("Input: {} takes single binary data. Actual: {}", tensorInfo->getMappedName(), src.string_val_size());
+        return StatusCode::INVALID_BATCH_SIZE;
+    }
+    const std::string& stringVal = src.string_val(0);
+    if (stringVal.size() == 0) {
+        return StatusCode::STRING_VAL_EMPTY;
+    }
+    const size_t expectedSize = tensorInfo->getEffectiveShape()[0];
+    if (expectedSize > 0 && expectedSize != stringVal.size()) {
+        SPDLOG_DEBUG("Input: {} binary data size is incorrect. Expected: {} Actual: {}", tensorInfo->getMappedName(), expectedSize, stringVal.size());
+        return StatusCode::INVALID_SHAPE;
+    }
+    // bytes are not decoded nor copied, request outlives pipeline execution
+    blob = InferenceEngine::make_shared_blob<uint8_t>(
+        InferenceEngine::TensorDesc(InferenceEngine::Precision::U8, {stringVal.size()}, InferenceEngine::Layout::C),
+        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(stringVal.data())));
+    return StatusCode::OK;
+}
+
+bool isStringInput(const TensorInfo& tensorInfo) {
+    return tensorInfo.getPrecision() == InferenceEngine::Precision::U8 && tensorInfo.getEffectiveShape().size() == 2;
+}
+
+Status convertStringValToStringBlob(const tensorflow::TensorProto& src, InferenceEngine::Blob::Ptr& blob, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    const size_t batchSize = src.string_val_size();
+    if (batchSize == 0 || (tensorInfo->getEffectiveShape()[0] > 0 && tensorInfo->getEffectiveShape()[0] != batchSize)) {
+        SPDLOG_DEBUG("Input: {} request batch size is incorrect. Expected: {} Actual: {}", tensorInfo->getMappedName(), tensorInfo->getEffectiveShape()[0], batchSize);
+        return StatusCode::INVALID_BATCH_SIZE;
+    }
+    size_t maxStringSize = 0;
+    for (const auto& stringVal : src.string_val()) {
+        maxStringSize = std::max(maxStringSize, stringVal.size());
+    }
+    // room for terminating zero, so that strings can be read as C strings
+    const size_t rowSize = maxStringSize + 1;
+    const size_t expectedRowSize = tensorInfo->getEffectiveShape()[1];
+    if (expectedRowSize > 0 && expectedRowSize < rowSize) {
+        SPDLOG_DEBUG("Input: {} string is too long. Expected at most: {} Actual: {}", tensorInfo->getMappedName(), expectedRowSize - 1, maxStringSize);
+        return StatusCode::INVALID_SHAPE;
+    }
+    const size_t length = expectedRowSize > 0 ? expectedRowSize : rowSize;
+    auto result = InferenceEngine::make_shared_blob<uint8_t>(
+        InferenceEngine::TensorDesc(InferenceEngine::Precision::U8, {batchSize, length}, InferenceEngine::Layout::NC));
+    result->allocate();
+    uint8_t* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(result)->wmap().as<uint8_t*>();
+    std::memset(ptr, 0, batchSize * length);
+    for (size_t i = 0; i < batchSize; i++) {
+        const std::string& stringVal = src.string_val(i);
+        std::memcpy(ptr + i * length, stringVal.data(), stringVal.size());
+    }
+    blob = std::move(result);
+    return StatusCode::OK;
+}
+
+/**
+ * @brief Checks if images of input can be decoded by image decoder library into U8 NHWC frames of fixed resolution
+ */
+bool isDecodedByLibrary(const std::shared_ptr<TensorInfo>& tensorInfo) {
+    const auto& shape = tensorInfo->getEffectiveShape();
+    return tensorInfo->getLayout() == InferenceEngine::Layout::NHWC &&
+           tensorInfo->getPrecision() == InferenceEngine::Precision::U8 &&
+           !tensorInfo->isResizedByPreprocessing() &&
+           shape.size() == 4 && shape[0] > 0 && shape[1] > 0 && shape[2] > 0 && (shape[3] == 1 || shape[3] == 3);
+}
+
+/**
+ * @brief Decodes images of request with image decoder library in single call, images it does not support are decoded on CPU
+ */
+Status convertStringValToBlobWithDecoderLibrary(const ImageDecoderLibrary& library, const tensorflow::TensorProto& src, InferenceEngine::Blob::Ptr& blob, const std::shared_ptr<TensorInfo>& tensorInfo) {
+    const auto& shape = tensorInfo->getEffectiveShape();
+    const size_t batchSize = src.string_val_size();
+    InferenceEngine::Blob::Ptr result = createBlobForImages(tensorInfo->getShape(), tensorInfo);
+    if (result == nullptr) {
+        return StatusCode::INVALID_PRECISION;
+    }
+    char* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(result)->wmap().as<char*>();
+    std::vector<ImageDecoderImage> images(batchSize);
+    for (size_t i = 0; i < batchSize; i++) {
+        images[i].data = reinterpret_cast<const uint8_t*>(src.string_val(i).data());
+        images[i].dataBytes = src.string_val(i).size();
+    }
+    std::vector<int> decoded(batchSize, 1);
+    if (library.decodeImages(images.data(), static_cast<int>(batchSize), shape[1], shape[2], shape[3], reinterpret_cast<uint8_t*>(ptr), decoded.data()) != 0) {
+        SPDLOG_DEBUG("Image decoder library failed to decode images of input: {}, decoding them on CPU", tensorInfo->getMappedName());
+        std::fill(decoded.begin(), decoded.end(), 1);
+    }
+
+    const size_t slotSize = result->byteSize() / batchSize;
+    std::vector<Status> statuses(batchSize);
+    parallelFor(0, batchSize, [&](size_t i) {
+        if (decoded[i] == 0) {
+            return true;
+        }
+        statuses[i] = convertStringValToSlot(src.string_val(i), ptr + i * slotSize, slotSize, tensorInfo, nullptr);
+        return statuses[i].ok();
+    });
+    for (const auto& imageStatus : statuses) {
+        if (!imageStatus.ok()) {
+            return imageStatus;
+        }
+    }
+
+    blob = std::move(result);
+    return StatusCode::OK;
+}
+
 Status convertStringValToBlob(const tensorflow::TensorProto& src, InferenceEngine::Blob::Ptr& blob, const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
+    if (!isPipeline && tensorInfo->isPlanarYuv()) {
+        return convertStringValToPlanarYuvBlob(src, blob, tensorInfo);
+    }
+    if (isPipeline && isRawBinaryInput(*tensorInfo)) {
+        return convertStringValToRawBlob(src, blob, tensorInfo);
+    }
+    if (isPipeline && isStringInput(*tensorInfo)) {
+        return convertStringValToStringBlob(src, blob, tensorInfo);
+    }
     auto status = validateTensor(tensorInfo, src);
     if (status != StatusCode::OK) {
         return status;
     }
+    auto decoderLibrary = std::atomic_load(&imageDecoderLibrary);
+    if (decoderLibrary && !isPipeline && isDecodedByLibrary(tensorInfo)) {
+        return convertStringValToBlobWithDecoderLibrary(*decoderLibrary, src, blob, tensorInfo);
+    }
 
-    std::vector<cv::Mat> images;
-
-    status = convertTensorToMatsMatchingTensorInfo(src, images, tensorInfo);
+    // first image determines shape of pipeline inputs and is reference for validation of the others
+    cv::Mat firstImage;
+    status = convertStringValToMatMatchingTensorInfo(src.string_val(0), firstImage, tensorInfo, nullptr);
     if (!status.ok()) {
         return status;
     }
 
-    blob = convertMatsToBlob(images, tensorInfo, isPipeline);
+    const size_t batchSize = src.string_val_size();
+    InferenceEngine::Blob::Ptr result;
+    if (!isPipeline && tensorInfo->isResizedByPreprocessing()) {
+        // images keep their resolution, dimensions of NHWC tensor descriptor are in NCHW order
+        result = createBlobForImages({batchSize, static_cast<size_t>(firstImage.channels()), static_cast<size_t>(firstImage.rows), static_cast<size_t>(firstImage.cols)},
+            tensorInfo, InferenceEngine::Layout::NHWC);
+    } else {
+        auto dims = !isPipeline ? tensorInfo->getShape() : getShapeFromImages(firstImage, batchSize, tensorInfo);
+        result = createBlobForImages(dims, tensorInfo);
+    }
+    if (result == nullptr) {
+        return StatusCode::INVALID_PRECISION;
+    }
+    char* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(result)->wmap().as<char*>();
+    const size_t slotSize = result->byteSize() / batchSize;
+    if (firstImage.total() * firstImage.elemSize() != slotSize) {
+        SPDLOG_DEBUG("Binary image of {}x{} resolution does not match input: {}", firstImage.cols, firstImage.rows, tensorInfo->getMappedName());
+        return StatusCode::BINARY_IMAGES_RESOLUTION_MISMATCH;
+    }
+    firstImage.copyTo(cv::Mat(firstImage.size(), firstImage.type(), ptr));
+
+    std::vector<Status> statuses(batchSize);
+    parallelFor(1, batchSize, [&](size_t i) {
+        statuses[i] = convertStringValToSlot(src.string_val(i), ptr + i * slotSize, slotSize, tensorInfo, &firstImage);
+        return statuses[i].ok();
+    });
+    for (const auto& imageStatus : statuses) {
+        if (!imageStatus.ok()) {
+            return imageStatus;
+        }
+    }
+
+    blob = std::move(result);
     return StatusCode::OK;
 }
 }  // namespace ovms
@@ -16,10 +16,43 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "status.hpp"
 #include "tensorinfo.hpp"
 
 namespace ovms {
+/**
+ * @brief Sets number of threads shared by all requests, which decode binary images of a batch in parallel
+ *
+ * @param workers 0 means images are decoded on the request thread
+ */
+void setImageDecodeWorkers(size_t workers);
+
+/**
+ * @brief Loads library exporting decodeImages of image_decoder_interface.h, which then decodes binary images of model inputs
+ *
+ * Library decodes images of U8 NHWC inputs of fixed resolution with 1 or 3 channels, other inputs
+ * and images library does not support are decoded on CPU.
+ *
+ * @param path empty path unloads the library
+ */
+Status loadImageDecoderLibrary(const std::string& path);
+
+/**
+ * @brief Checks if pipeline input takes encoded binary data as is instead of decoded image
+ *
+ * Such input is U8 tensor with single dimension, e.g. input of custom node decoding images on its own.
+ */
+bool isRawBinaryInput(const TensorInfo& tensorInfo);
+
+/**
+ * @brief Checks if pipeline input takes batch of strings instead of images
+ *
+ * Such input is U8 tensor with two dimensions [batch, length], e.g. input of tokenizer custom node.
+ * Each row holds one string terminated and padded with zeros to the length of the longest string in request plus one.
+ */
+bool isStringInput(const TensorInfo& tensorInfo);
+
 Status convertStringValToBlob(const tensorflow::TensorProto& src, InferenceEngine::Blob::Ptr& blob, const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline);
 }  // namespace ovms
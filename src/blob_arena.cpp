@@ -0,0 +1,122 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "blob_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace ovms {
+
+static size_t alignUp(size_t value) {
+    return (value + BlobArena::ALIGNMENT - 1) / BlobArena::ALIGNMENT * BlobArena::ALIGNMENT;
+}
+
+BlobArena::BlobArena(size_t initialBlockSize) :
+    initialBlockSize(alignUp(std::max<size_t>(initialBlockSize, 1))) {}
+
+void BlobArena::addBlock(size_t size) {
+    // over allocate so that block data can be aligned
+    Block block{std::unique_ptr<char[]>(new char[size + ALIGNMENT]), nullptr, size};
+    block.data = reinterpret_cast<char*>(alignUp(reinterpret_cast<uintptr_t>(block.memory.get())));
+    blocks.emplace_back(std::move(block));
+    offset = 0;
+}
+
+void* BlobArena::alloc(size_t size) noexcept {
+    const size_t alignedSize = alignUp(std::max<size_t>(size, 1));
+    std::lock_guard<std::mutex> lock(mtx);
+    if (blocks.empty() || blocks.back().size - offset < alignedSize) {
+        // each next block is at least twice as big as the previous one to keep blocks count low
+        const size_t blockSize = std::max(alignedSize, blocks.empty() ? initialBlockSize : 2 * blocks.back().size);
+        try {
+            addBlock(blockSize);
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }
+    void* data = blocks.back().data + offset;
+    offset += alignedSize;
+    usedBytes += alignedSize;
+    return data;
+}
+
+void BlobArena::reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (blocks.size() > 1) {
+        size_t capacity = 0;
+        for (const auto& block : blocks) {
+            capacity += block.size;
+        }
+        blocks.clear();
+        try {
+            addBlock(capacity);
+        } catch (const std::bad_alloc&) {
+            blocks.clear();
+        }
+    }
+    offset = 0;
+    usedBytes = 0;
+}
+
+size_t BlobArena::getCapacity() const {
+    size_t capacity = 0;
+    for (const auto& block : blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+std::shared_ptr<BlobArena> BlobArenaPool::acquire() {
+    std::unique_ptr<BlobArena> arena;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!idleArenas.empty()) {
+            arena = std::move(idleArenas.back());
+            idleArenas.pop_back();
+        }
+    }
+    if (!arena) {
+        arena = std::make_unique<BlobArena>(initialBlockSize);
+    }
+    std::weak_ptr<BlobArenaPool> weakPool = shared_from_this();
+    return std::shared_ptr<BlobArena>(arena.release(), [weakPool](BlobArena* arena) {
+        if (auto pool = weakPool.lock()) {
+            pool->release(arena);
+        } else {
+            delete arena;
+        }
+    });
+}
+
+void BlobArenaPool::release(BlobArena* arena) {
+    std::unique_ptr<BlobArena> released(arena);
+    if (released->getCapacity() > maxArenaCapacity) {
+        return;
+    }
+    released->reset();
+    std::lock_guard<std::mutex> lock(mtx);
+    if (idleArenas.size() < maxIdleArenas) {
+        idleArenas.push_back(std::move(released));
+    }
+}
+
+size_t BlobArenaPool::getIdleArenasCount() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return idleArenas.size();
+}
+
+}  // namespace ovms
@@ -0,0 +1,115 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Allocates memory of intermediate pipeline blobs from large blocks, memory is released at once when arena is reset
+ *
+ * Freeing single blob does not return its memory to the arena. Blobs keep arena alive, so arena is reset only
+ * after the last blob using it is destroyed.
+ */
+class BlobArena : public InferenceEngine::IAllocator {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> memory;
+        char* data;
+        size_t size;
+    };
+
+    const size_t initialBlockSize;
+    std::mutex mtx;
+    std::vector<Block> blocks;
+    // offset of free memory in last block
+    size_t offset = 0;
+    size_t usedBytes = 0;
+
+    void addBlock(size_t size);
+
+public:
+    explicit BlobArena(size_t initialBlockSize);
+
+    void* lock(void* handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void* a) noexcept override {}
+
+    void* alloc(size_t size) noexcept override;
+
+    bool free(void* handle) noexcept override {
+        return true;
+    }
+
+    /**
+     * @brief Releases all allocations, memory of multiple blocks is merged into single block for next use
+     */
+    void reset();
+
+    size_t getCapacity() const;
+    size_t getUsedBytes() const { return usedBytes; }
+};
+
+/**
+ * @brief Keeps arenas of finished pipeline executions for reuse by following requests
+ *
+ * Pool can be destroyed before arenas it handed out, such arenas are then freed when released.
+ */
+class BlobArenaPool : public std::enable_shared_from_this<BlobArenaPool> {
+public:
+    static constexpr size_t DEFAULT_INITIAL_BLOCK_SIZE = 1024 * 1024;
+    static constexpr size_t DEFAULT_MAX_IDLE_ARENAS = 16;
+    static constexpr size_t DEFAULT_MAX_ARENA_CAPACITY = 512 * 1024 * 1024;
+
+private:
+    const size_t initialBlockSize;
+    const size_t maxIdleArenas;
+    const size_t maxArenaCapacity;
+    std::mutex mtx;
+    std::vector<std::unique_ptr<BlobArena>> idleArenas;
+
+    void release(BlobArena* arena);
+
+public:
+    BlobArenaPool(size_t initialBlockSize = DEFAULT_INITIAL_BLOCK_SIZE,
+        size_t maxIdleArenas = DEFAULT_MAX_IDLE_ARENAS,
+        size_t maxArenaCapacity = DEFAULT_MAX_ARENA_CAPACITY) :
+        initialBlockSize(initialBlockSize),
+        maxIdleArenas(maxIdleArenas),
+        maxArenaCapacity(maxArenaCapacity) {}
+
+    /**
+     * @brief Gets idle arena or creates new one, arena returns to the pool when last reference to it is dropped
+     *
+     * Pool has to be owned by shared pointer.
+     */
+    std::shared_ptr<BlobArena> acquire();
+
+    size_t getIdleArenasCount();
+};
+
+}  // namespace ovms
@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "compilation_pool.hpp"
+
+#include <future>
+#include <utility>
+#include <vector>
+
+#include "logging.hpp"
+
+namespace ovms {
+
+namespace {
+// compilation nested in another one would wait for a thread held by itself
+thread_local bool isCompilationThread = false;
+}  // namespace
+
+void CompilationPool::configure(uint32_t maxCompilations, int niceness, std::vector<int> cpuAffinity) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (maxCompilations == 0) {
+        workers.reset();
+        return;
+    }
+    SPDLOG_INFO("Model compilations limited to {} concurrent threads with nice value: {}", maxCompilations, niceness);
+    workers = std::make_shared<WorkerPool>(maxCompilations, std::move(cpuAffinity), niceness);
+}
+
+void CompilationPool::run(const std::function<void()>& compilation) {
+    std::shared_ptr<WorkerPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pool = workers;
+    }
+    if (!pool || isCompilationThread) {
+        compilation();
+        return;
+    }
+    auto task = std::make_shared<std::packaged_task<void()>>([&compilation]() {
+        // pool threads run only compilations
+        isCompilationThread = true;
+        compilation();
+    });
+    auto result = task->get_future();
+    pool->schedule([task]() { (*task)(); });
+    result.get();
+}
+
+}  // namespace ovms
@@ -0,0 +1,60 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "workerpool.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Runs compilations of model networks on limited number of background priority threads
+ *
+ * Loads and reloads of model versions compile networks on threads of this pool, so at most the configured number
+ * of compilations runs at once and they yield cores to inference. Compilations started from a pool thread,
+ * or when the pool is not configured, run on the calling thread.
+ */
+class CompilationPool {
+    std::mutex mtx;
+    std::shared_ptr<WorkerPool> workers;
+
+public:
+    static constexpr int DEFAULT_NICENESS = 10;
+
+    static CompilationPool& instance() {
+        static CompilationPool instance;
+        return instance;
+    }
+
+    /**
+     * @brief Sets number of concurrent compilations, nice value and CPU cores of their threads, 0 compilations disables the pool
+     *
+     * Compilations already running finish on the previous pool.
+     */
+    void configure(uint32_t maxCompilations, int niceness = DEFAULT_NICENESS, std::vector<int> cpuAffinity = {});
+
+    /**
+     * @brief Runs compilation and waits for it, exception thrown by compilation is rethrown
+     */
+    void run(const std::function<void()>& compilation);
+};
+
+}  // namespace ovms
@@ -0,0 +1,94 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "compiled_network_registry.hpp"
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+#include "mapped_file_allocator.hpp"
+
+namespace ovms {
+
+std::shared_ptr<InferenceEngine::ExecutableNetwork> CompiledNetworkRegistry::getOrCompile(const std::string& key, const compile_fn_t& compile, bool& shared) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = networks.find(key);
+        if (it != networks.end()) {
+            if (auto network = it->second.lock()) {
+                shared = true;
+                return network;
+            }
+        }
+    }
+    auto compiled = compile();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = networks.begin(); it != networks.end();) {
+        if (it->second.expired()) {
+            it = networks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    auto& entry = networks[key];
+    if (auto network = entry.lock()) {
+        SPDLOG_DEBUG("Network compiled concurrently by other model instance is used instead");
+        shared = true;
+        return network;
+    }
+    entry = compiled;
+    shared = false;
+    return compiled;
+}
+
+size_t CompiledNetworkRegistry::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const auto& [key, network] : networks) {
+        if (!network.expired()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool CompiledNetworkRegistry::hashFiles(const std::vector<std::string>& paths, std::string& hash) {
+    // FNV-1a, contents are mapped so that hashing does not allocate memory of file size
+    uint64_t value = 14695981039346656037ULL;
+    for (const auto& path : paths) {
+        auto file = MappedFile::open(path);
+        if (!file) {
+            SPDLOG_DEBUG("Failed to map file: {} for hashing", path);
+            return false;
+        }
+        const auto* data = static_cast<const uint8_t*>(file->getData());
+        for (size_t i = 0; i < file->getSize(); ++i) {
+            value ^= data[i];
+            value *= 1099511628211ULL;
+        }
+        // file boundaries are part of the hash
+        value ^= file->getSize();
+        value *= 1099511628211ULL;
+    }
+    std::stringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << value;
+    hash = stream.str();
+    return true;
+}
+
+}  // namespace ovms
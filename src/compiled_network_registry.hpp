@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Executable networks shared by model instances compiled from identical files with identical settings
+ *
+ * Networks are keyed by hash of model files contents, target device, plugin config and final shapes,
+ * layouts, precisions and preprocessing of inputs and outputs. Registry does not own networks,
+ * an entry is dropped when the last instance using it releases the network.
+ */
+class CompiledNetworkRegistry {
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<InferenceEngine::ExecutableNetwork>> networks;
+
+public:
+    using compile_fn_t = std::function<std::shared_ptr<InferenceEngine::ExecutableNetwork>()>;
+
+    static CompiledNetworkRegistry& instance() {
+        static CompiledNetworkRegistry instance;
+        return instance;
+    }
+
+    /**
+     * @brief Gets network compiled for the key or compiles it, exceptions of compile are propagated
+     *
+     * Registry lock is not held during compilation, when instances with the same key compile concurrently
+     * the network registered first is used by all of them.
+     *
+     * @param key
+     * @param compile
+     * @param shared set to true if network was compiled by other instance
+     *
+     * @return network
+     */
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> getOrCompile(const std::string& key, const compile_fn_t& compile, bool& shared);
+
+    /**
+     * @brief Number of networks in use
+     */
+    size_t size();
+
+    /**
+     * @brief Computes hash of files contents
+     *
+     * @param paths
+     * @param hash hex encoded hash
+     *
+     * @return false if some file cannot be read
+     */
+    static bool hashFiles(const std::vector<std::string>& paths, std::string& hash);
+};
+
+}  // namespace ovms
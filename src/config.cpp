@@ -22,6 +22,7 @@
 #include <thread>
 
 #include <boost/algorithm/string.hpp>
+#include <sys/un.h>
 #include <sysexits.h>
 
 #include "version.hpp"
@@ -30,6 +31,7 @@ namespace ovms {
 
 const uint AVAILABLE_CORES = std::thread::hardware_concurrency();
 const uint MAX_PORT_NUMBER = std::numeric_limits<ushort>::max();
+const size_t MAX_UNIX_SOCKET_PATH_LENGTH = sizeof(sockaddr_un::sun_path);
 
 const uint64_t DEFAULT_REST_WORKERS = AVAILABLE_CORES * 4.0;
 const std::string DEFAULT_REST_WORKERS_STRING{std::to_string(DEFAULT_REST_WORKERS)};
@@ -61,20 +63,72 @@ Config& Config::parse(int argc, char** argv) {
                 "Network interface address to bind to for the REST API",
                 cxxopts::value<std::string>()->default_value("0.0.0.0"),
                 "REST_BIND_ADDRESS")
+            ("grpc_unix_socket",
+                "Path of Unix domain socket the gRPC server listens on for co-located clients, in addition to the port. Setting port to 0 disables listening on TCP",
+                cxxopts::value<std::string>(),
+                "GRPC_UNIX_SOCKET")
+            ("rest_unix_socket",
+                "Path of Unix domain socket the REST server listens on for co-located clients, in addition to rest_port if it is set",
+                cxxopts::value<std::string>(),
+                "REST_UNIX_SOCKET")
             ("grpc_workers",
                 "Number of gRPC servers. Default 1. Increase for multi client, high throughput scenarios",
                 cxxopts::value<uint>()->default_value("1"),
                 "GRPC_WORKERS")
+            ("grpc_completion_queues",
+                "Number of completion queues of each gRPC server. Default 0 spreads one queue per CPU core across gRPC servers",
+                cxxopts::value<uint>()->default_value("0"),
+                "GRPC_COMPLETION_QUEUES")
+            ("grpc_max_pollers",
+                "Maximum number of threads polling each gRPC completion queue. Default 0 keeps gRPC default",
+                cxxopts::value<uint>()->default_value("0"),
+                "GRPC_MAX_POLLERS")
+            ("frontend_cpu_affinity",
+                "CPU cores gRPC predict workers and REST workers are pinned to, e.g. 0-3,8, or performance/efficiency cores of hybrid processor. Default empty does not pin threads",
+                cxxopts::value<std::string>(),
+                "FRONTEND_CPU_AFFINITY")
+            ("background_cpu_affinity",
+                "CPU cores model compilations, config and sequence cleanup threads and asynchronous logging are pinned to, e.g. 8-15, or performance/efficiency cores of hybrid processor. Default empty does not pin threads",
+                cxxopts::value<std::string>(),
+                "BACKGROUND_CPU_AFFINITY")
             ("rest_workers",
                 "Number of worker threads in REST server - has no effect if rest_port is not set. Default value depends on number of CPUs. ",
                 cxxopts::value<uint>()->default_value(DEFAULT_REST_WORKERS_STRING.c_str()),
                 "REST_WORKERS")
+            ("rest_reactors",
+                "Number of REST servers, each with its own event loop, listening on rest_port with SO_REUSEPORT. Default 1",
+                cxxopts::value<uint>()->default_value("1"),
+                "REST_REACTORS")
+            ("rest_max_body_size_mb",
+                "Maximum size of REST request body in megabytes. Larger requests are rejected with HTTP 413 once the body is received, the HTTP server buffers it before the limit is checked. Default 0, no limit",
+                cxxopts::value<uint64_t>()->default_value("0"),
+                "REST_MAX_BODY_SIZE_MB")
+            ("rest_compression_level",
+                "zlib compression level from 1 to 9 of REST responses sent to clients accepting gzip or deflate encoding. Default 0, responses are not compressed",
+                cxxopts::value<uint>()->default_value("0"),
+                "REST_COMPRESSION_LEVEL")
+            ("rest_compression_min_size",
+                "Minimum size in bytes of REST response to be compressed. Default 1024",
+                cxxopts::value<uint64_t>()->default_value("1024"),
+                "REST_COMPRESSION_MIN_SIZE")
+            ("grpc_compression_level",
+                "Default compression level of gRPC responses - one of none, low, medium, high. Default none",
+                cxxopts::value<std::string>()->default_value("none"),
+                "GRPC_COMPRESSION_LEVEL")
             ("log_level",
                 "serving log level - one of DEBUG, INFO, WARNING, ERROR",
                 cxxopts::value<std::string>()->default_value("INFO"), "LOG_LEVEL")
             ("log_path",
                 "Optional path to the log file",
                 cxxopts::value<std::string>(), "LOG_PATH")
+            ("log_queue_size",
+                "Number of log messages queued for writing by background thread, the oldest messages are dropped when the queue is full. Default 0 writes messages synchronously",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "LOG_QUEUE_SIZE")
+            ("log_rate_limit",
+                "Maximum number of messages below WARNING level written per second by each logger, the rest is dropped. Default 0 is unlimited",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "LOG_RATE_LIMIT")
             ("grpc_channel_arguments",
                 "A comma separated list of arguments to be passed to the grpc server. (e.g. grpc.max_connection_age_ms=2000)",
                 cxxopts::value<std::string>(), "GRPC_CHANNEL_ARGUMENTS")
@@ -82,10 +136,184 @@ Config& Config::parse(int argc, char** argv) {
                 "Time interval between config and model versions changes detection. Default is 1. Zero or negative value disables changes monitoring.",
                 cxxopts::value<uint>()->default_value("1"),
                 "FILE_SYSTEM_POLL_WAIT_SECONDS")
+            ("remote_listing_ttl_seconds",
+                "Time for which model versions listed in cloud storage are reused by changes detection. Default is 0, versions are listed on every check. Config reload API always lists versions again.",
+                cxxopts::value<uint>()->default_value("0"),
+                "REMOTE_LISTING_TTL_SECONDS")
             ("sequence_cleaner_poll_wait_minutes",
                 "Time interval between two consecutive sequence cleaner scans. Default is 5. Zero value disables sequence cleaner.",
                 cxxopts::value<uint32_t>()->default_value("5"),
-                "SEQUENCE_CLEANER_POLL_WAIT_MINUTES");
+                "SEQUENCE_CLEANER_POLL_WAIT_MINUTES")
+            ("model_load_workers",
+                "Number of threads loading models from the config file concurrently. Default 1. Increase to shorten startup and reload of configs with many models",
+                cxxopts::value<uint32_t>()->default_value("1"),
+                "MODEL_LOAD_WORKERS")
+            ("compilation_workers",
+                "Number of model compilations running concurrently on dedicated background priority threads. Default 0, models are compiled on loading threads with normal priority",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "COMPILATION_WORKERS")
+            ("compilation_nice",
+                "Nice value from 0 to 19 of threads compiling models, which also run with SCHED_BATCH policy. Used with compilation_workers. Default 10",
+                cxxopts::value<int>()->default_value("10"),
+                "COMPILATION_NICE")
+            ("models_memory_budget_mb",
+                "Memory budget in megabytes for all loaded model versions. When exceeded, least recently used idle versions of models with lazy loading are unloaded. Default 0, no limit",
+                cxxopts::value<uint64_t>()->default_value("0"),
+                "MODELS_MEMORY_BUDGET_MB")
+            ("version_swap_policy",
+                "How new model versions replace retired ones: overlap loads new versions while retired ones serve, serial unloads retired versions first, auto overlaps only when available memory fits new versions. Default overlap.",
+                cxxopts::value<std::string>()->default_value("overlap"),
+                "VERSION_SWAP_POLICY")
+            ("image_decode_workers",
+                "Number of threads, shared by all requests, decoding binary images of a batch in parallel with the request thread. Default 0, images are decoded on the request thread",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "IMAGE_DECODE_WORKERS")
+            ("deserialization_workers",
+                "Number of threads, shared by all requests, deserializing large inputs of a request in parallel with the request thread. Default 0, inputs are deserialized one after another on the request thread",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "DESERIALIZATION_WORKERS")
+            ("deserialization_parallel_min_bytes",
+                "Minimal size of input data in request to deserialize the input on deserialization_workers, smaller inputs are deserialized on the request thread. Default 262144",
+                cxxopts::value<uint64_t>()->default_value("262144"),
+                "DESERIALIZATION_PARALLEL_MIN_BYTES")
+            ("image_decoder_library",
+                "Path to library exporting decodeImages of image_decoder_interface.h, e.g. using hardware decoders, which decodes binary images of U8 NHWC model inputs. Images it does not support are decoded on CPU. Default empty, images are decoded on CPU",
+                cxxopts::value<std::string>()->default_value(""),
+                "IMAGE_DECODER_LIBRARY")
+            ("max_concurrent_inferences",
+                "Number of inferences running concurrently in all models. When reached, freed slots are shared between waiting models in proportion to their scheduling_weight. Default 0, no limit",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "MAX_CONCURRENT_INFERENCES")
+            ("cpu_threads_budget",
+                "Number of CPU threads shared by all models served on CPU, divided among them in proportion to their scheduling_weight. Applied to models without CPU_THREADS_NUM in plugin config. Default 0, each model uses all cores",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "CPU_THREADS_BUDGET")
+            ("cpu_streams_budget",
+                "Number of CPU throughput streams shared by all models served on CPU, divided among them in proportion to their scheduling_weight. Applied to models without CPU_THROUGHPUT_STREAMS in plugin config. Default 0, streams are set automatically per model",
+                cxxopts::value<uint32_t>()->default_value("0"),
+                "CPU_STREAMS_BUDGET")
+            ("tensor_buffer_pool_size_mb",
+                "Memory in megabytes kept in buffers of freed request blobs for reuse by following requests. 0 disables the pool. Default 256.",
+                cxxopts::value<uint64_t>()->default_value("256"),
+                "TENSOR_BUFFER_POOL_SIZE_MB")
+            ("tensor_buffer_pool_max_buffer_mb",
+                "Size limit in megabytes of a single pooled blob buffer, bigger blobs are allocated directly. Default 64.",
+                cxxopts::value<uint64_t>()->default_value("64"),
+                "TENSOR_BUFFER_POOL_MAX_BUFFER_MB")
+            ("tensor_buffer_huge_pages",
+                "Pages backing blob buffers of at least 2MB created by the server: none, transparent or explicit. Explicit huge pages fall back to transparent ones when none are reserved. Default none.",
+                cxxopts::value<std::string>()->default_value("none"),
+                "TENSOR_BUFFER_HUGE_PAGES")
+            ("tensor_buffer_lock_memory",
+                "Lock blob buffers created by the server in RAM while they are used or kept in the pool, so that inference does not wait for page faults. Buffers are only pre-faulted when RLIMIT_MEMLOCK is insufficient. Default false.",
+                cxxopts::value<bool>()->default_value("false"),
+                "TENSOR_BUFFER_LOCK_MEMORY")
+            ("cache_dir",
+                "Overrides model cache directory. Compiled models are stored there and imported on subsequent loads, skipping compilation. Default: empty, caching disabled.",
+                cxxopts::value<std::string>()->default_value(""),
+                "CACHE_DIR")
+            ("mmap_weights",
+                "Map IR weight files to memory instead of reading them to heap. Mapped weights are shared with page cache by all versions and instances using identical files, which lowers peak memory during model reloads.",
+                cxxopts::value<bool>()->default_value("false"),
+                "MMAP_WEIGHTS")
+            ("remote_model_in_memory",
+                "Read model files from S3, GCS and Azure storage directly to memory instead of downloading them to temporary directory. Model is parsed from memory and weights are used without copying.",
+                cxxopts::value<bool>()->default_value("false"),
+                "REMOTE_MODEL_IN_MEMORY")
+            ("share_compiled_models",
+                "Share one compiled network between model versions loaded from identical files with identical device, plugin config and shapes. Each version keeps its own infer requests.",
+                cxxopts::value<bool>()->default_value("false"),
+                "SHARE_COMPILED_MODELS")
+            ("remote_model_cache_dir",
+                "Directory for persistent cache of model files downloaded from cloud storage. Files are reused across restarts and models when their ETag or checksum matches. Default: empty, caching disabled.",
+                cxxopts::value<std::string>()->default_value(""),
+                "REMOTE_MODEL_CACHE_DIR")
+            ("remote_model_cache_size_mb",
+                "Size limit in megabytes of the remote model cache. Least recently used files are evicted when exceeded. Default 10240.",
+                cxxopts::value<uint64_t>()->default_value("10240"),
+                "REMOTE_MODEL_CACHE_SIZE_MB")
+            ("serve_peer_files",
+                "Serve files of the remote model cache to other server replicas over REST API, so that they do not download them from cloud storage. Requires remote_model_cache_dir.",
+                cxxopts::value<bool>()->default_value("false"),
+                "SERVE_PEER_FILES")
+            ("model_peers",
+                "Comma separated list of host:port REST API addresses of server replicas serving peer files. Files missing in remote model cache are downloaded from peers before cloud storage and verified against storage checksum. Requires remote_model_cache_dir. Default: empty.",
+                cxxopts::value<std::string>()->default_value(""),
+                "MODEL_PEERS")
+            ("trace_export_path",
+                "Path to a file spans of traced requests are appended to as JSON lines in OpenTelemetry format. Default: empty, tracing disabled.",
+                cxxopts::value<std::string>()->default_value(""),
+                "TRACE_EXPORT_PATH")
+            ("trace_sampling_ratio",
+                "Probability of tracing a request which does not carry sampled W3C traceparent header. Default 0.01.",
+                cxxopts::value<double>()->default_value("0.01"),
+                "TRACE_SAMPLING_RATIO")
+            ("traffic_capture_path",
+                "Path to a file sampled predict requests are appended to with their arrival times, to be replayed by load generator. Default: empty, capture disabled.",
+                cxxopts::value<std::string>()->default_value(""),
+                "TRAFFIC_CAPTURE_PATH")
+            ("traffic_capture_sampling_ratio",
+                "Probability of capturing a predict request. Default 0.01.",
+                cxxopts::value<double>()->default_value("0.01"),
+                "TRAFFIC_CAPTURE_SAMPLING_RATIO")
+            ("startup_profile_path",
+                "Path to a file durations of model loading phases during server startup are written to in Chrome trace event format. Default: empty, profile is not written.",
+                cxxopts::value<std::string>()->default_value(""),
+                "STARTUP_PROFILE_PATH")
+            ("slow_requests_log_size",
+                "Number of the slowest requests kept with their stage breakdown for each model version and pipeline, exposed at /v1/slow_requests REST endpoint. 0 disables the log. Default: 10.",
+                cxxopts::value<uint32_t>()->default_value("10"),
+                "SLOW_REQUESTS_LOG_SIZE")
+            ("residency_push_url",
+                "URL of registry to which model residency served at /v1/residency REST endpoint is posted periodically, for routing requests to replicas with models loaded. Default: empty, residency is not pushed.",
+                cxxopts::value<std::string>()->default_value(""),
+                "RESIDENCY_PUSH_URL")
+            ("residency_push_interval_ms",
+                "Interval of posting model residency to registry in milliseconds. Default: 1000.",
+                cxxopts::value<uint32_t>()->default_value("1000"),
+                "RESIDENCY_PUSH_INTERVAL_MS")
+            ("residency_server_id",
+                "Identifier of the server in model residency. Default: host name.",
+                cxxopts::value<std::string>(),
+                "RESIDENCY_SERVER_ID")
+            ("pipeline_critical_path_sampling_interval",
+                "Every n-th execution of each pipeline is sampled for critical path analysis, exposed at /v1/models/<pipeline>/critical_path REST endpoint. 0 disables sampling. Default: 100.",
+                cxxopts::value<uint32_t>()->default_value("100"),
+                "PIPELINE_CRITICAL_PATH_SAMPLING_INTERVAL")
+            ("model_status_load_times",
+                "Append durations of phases of the last load of model version to the error message of its status. Default: false.",
+                cxxopts::value<bool>()->default_value("false"),
+                "MODEL_STATUS_LOAD_TIMES");
+        options->add_options("benchmark")
+            ("benchmark",
+                "Instead of starting gRPC and REST servers, send requests with synthetic inputs to the model or pipeline in-process, print throughput, latency and infer requests utilization and exit. Default: false.",
+                cxxopts::value<bool>()->default_value("false"),
+                "BENCHMARK")
+            ("benchmark_servable",
+                "Name of the model or pipeline to benchmark. Default: model_name.",
+                cxxopts::value<std::string>(),
+                "BENCHMARK_SERVABLE")
+            ("benchmark_concurrency",
+                "Number of requests sent concurrently during benchmark. Default: 1.",
+                cxxopts::value<uint32_t>()->default_value("1"),
+                "BENCHMARK_CONCURRENCY")
+            ("benchmark_duration_seconds",
+                "Duration of benchmark in seconds. Default: 10.",
+                cxxopts::value<uint32_t>()->default_value("10"),
+                "BENCHMARK_DURATION_SECONDS")
+            ("benchmark_placement_devices",
+                "Comma separated devices, e.g. CPU,GPU, to measure models of benchmarked pipeline on after the benchmark and print target devices with the lowest latency and the highest throughput. Default: empty, placement is not planned.",
+                cxxopts::value<std::string>()->default_value(""),
+                "BENCHMARK_PLACEMENT_DEVICES")
+            ("benchmark_placement_iterations",
+                "Number of inferences measuring model on each device. Default: 20.",
+                cxxopts::value<uint32_t>()->default_value("20"),
+                "BENCHMARK_PLACEMENT_ITERATIONS")
+            ("benchmark_placement_transfer_bandwidth",
+                "Bandwidth of tensor transfers between devices assumed by placement planning, in MB/s. Default: 8000.",
+                cxxopts::value<uint32_t>()->default_value("8000"),
+                "BENCHMARK_PLACEMENT_TRANSFER_BANDWIDTH");
+
         options->add_options("multi model")
             ("config_path",
                 "Absolute path to json configuration file",
@@ -160,7 +388,7 @@ Config& Config::parse(int argc, char** argv) {
         }
 
         if (result->count("help") || result->arguments().size() == 0) {
-            std::cout << options->help({"", "multi model", "single model"}) << std::endl;
+            std::cout << options->help({"", "multi model", "single model", "benchmark"}) << std::endl;
             exit(EX_OK);
         }
 
@@ -202,6 +430,21 @@ void Config::validate() {
         exit(EX_USAGE);
     }
 
+    if (result->operator[]("benchmark").as<bool>()) {
+        if (!result->count("benchmark_servable") && !result->count("model_name")) {
+            std::cerr << "benchmark_servable has to be set when benchmarking models from config_path" << std::endl;
+            exit(EX_USAGE);
+        }
+        if (result->operator[]("benchmark_concurrency").as<uint32_t>() == 0 || result->operator[]("benchmark_duration_seconds").as<uint32_t>() == 0) {
+            std::cerr << "benchmark_concurrency and benchmark_duration_seconds have to be greater than 0" << std::endl;
+            exit(EX_USAGE);
+        }
+        if (!result->operator[]("benchmark_placement_devices").as<std::string>().empty() && result->operator[]("benchmark_placement_iterations").as<uint32_t>() == 0) {
+            std::cerr << "benchmark_placement_iterations has to be greater than 0" << std::endl;
+            exit(EX_USAGE);
+        }
+    }
+
     if (!result->count("config_path") && !(result->count("model_name") && result->count("model_path"))) {
         std::cerr << "Use config_path or model_path with model_name" << std::endl;
         exit(EX_USAGE);
@@ -220,14 +463,84 @@ void Config::validate() {
         exit(EX_USAGE);
     }
 
+    // check grpc_completion_queues value
+    if (result->count("grpc_completion_queues") && (this->grpcCompletionQueues() > AVAILABLE_CORES)) {
+        std::cerr << "grpc_completion_queues count should be from 0 to CPU core count : " << AVAILABLE_CORES << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // check frontend_cpu_affinity and background_cpu_affinity values
+    for (const std::string option : {"frontend_cpu_affinity", "background_cpu_affinity"}) {
+        if (!result->count(option)) {
+            continue;
+        }
+        auto cpus = parseCpuAffinity(result->operator[](option).as<std::string>());
+        if (!cpus || std::any_of(cpus.value().begin(), cpus.value().end(), [](int cpu) { return cpu >= static_cast<int>(AVAILABLE_CORES); })) {
+            std::cerr << option << " should be list of CPU cores from 0 to " << AVAILABLE_CORES - 1 << ", e.g. 0-3,8, " << PERFORMANCE_CORES << " or " << EFFICIENCY_CORES << std::endl;
+            exit(EX_USAGE);
+        }
+    }
+
     // check rest_workers value
     if (result->count("rest_workers") && ((this->restWorkers() > MAX_REST_WORKERS) || (this->restWorkers() < 2))) {
         std::cerr << "rest_workers count should be from 2 to " << MAX_REST_WORKERS << std::endl;
         exit(EX_USAGE);
     }
 
-    if (result->count("rest_workers") && (this->restWorkers() != DEFAULT_REST_WORKERS) && this->restPort() == 0) {
-        std::cerr << "rest_workers is set but rest_port is not set. rest_port is required to start rest servers" << std::endl;
+    // check compression levels
+    if (result->count("rest_compression_level") && this->restCompressionLevel() > 9) {
+        std::cerr << "rest_compression_level should be from 0 to 9" << std::endl;
+        exit(EX_USAGE);
+    }
+    if (result->count("grpc_compression_level") && this->grpcCompressionLevel() != "none" && this->grpcCompressionLevel() != "low" &&
+        this->grpcCompressionLevel() != "medium" && this->grpcCompressionLevel() != "high") {
+        std::cerr << "grpc_compression_level should be one of none, low, medium, high" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("version_swap_policy") && this->versionSwapPolicy() != "overlap" && this->versionSwapPolicy() != "serial" &&
+        this->versionSwapPolicy() != "auto") {
+        std::cerr << "version_swap_policy should be one of overlap, serial, auto" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("tensor_buffer_huge_pages") && this->tensorBufferHugePages() != "none" && this->tensorBufferHugePages() != "transparent" &&
+        this->tensorBufferHugePages() != "explicit") {
+        std::cerr << "tensor_buffer_huge_pages should be one of none, transparent, explicit" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("compilation_nice") && (this->compilationNice() < 0 || this->compilationNice() > 19)) {
+        std::cerr << "compilation_nice should be in range from 0 to 19" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // check model_load_workers value
+    if (result->count("model_load_workers") && this->modelLoadWorkers() < 1) {
+        std::cerr << "model_load_workers count should be greater than 0" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // check image_decode_workers value
+    if (result->count("image_decode_workers") && this->imageDecodeWorkers() > AVAILABLE_CORES) {
+        std::cerr << "image_decode_workers count should be from 0 to CPU core count : " << AVAILABLE_CORES << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // check deserialization_workers value
+    if (result->count("deserialization_workers") && this->deserializationWorkers() > AVAILABLE_CORES) {
+        std::cerr << "deserialization_workers count should be from 0 to CPU core count : " << AVAILABLE_CORES << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // check rest_reactors value
+    if (result->count("rest_reactors") && ((this->restReactors() > AVAILABLE_CORES) || (this->restReactors() < 1))) {
+        std::cerr << "rest_reactors count should be from 1 to CPU core count : " << AVAILABLE_CORES << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("rest_workers") && (this->restWorkers() != DEFAULT_REST_WORKERS) && this->restPort() == 0 && this->restUnixSocket().empty()) {
+        std::cerr << "rest_workers is set but rest_port is not set. rest_port or rest_unix_socket is required to start rest servers" << std::endl;
         exit(EX_USAGE);
     }
 
@@ -255,8 +568,22 @@ void Config::validate() {
         exit(EX_USAGE);
     }
 
-    // port and rest_port cannot be the same
-    if (this->port() == this->restPort()) {
+    // check unix socket paths, sun_path has to hold terminating null
+    if (result->count("grpc_unix_socket") && (this->grpcUnixSocket().empty() || this->grpcUnixSocket().size() >= MAX_UNIX_SOCKET_PATH_LENGTH)) {
+        std::cerr << "grpc_unix_socket path should be from 1 to " << MAX_UNIX_SOCKET_PATH_LENGTH - 1 << " characters long" << std::endl;
+        exit(EX_USAGE);
+    }
+    if (result->count("rest_unix_socket") && (this->restUnixSocket().empty() || this->restUnixSocket().size() >= MAX_UNIX_SOCKET_PATH_LENGTH)) {
+        std::cerr << "rest_unix_socket path should be from 1 to " << MAX_UNIX_SOCKET_PATH_LENGTH - 1 << " characters long" << std::endl;
+        exit(EX_USAGE);
+    }
+    if (result->count("grpc_unix_socket") && result->count("rest_unix_socket") && this->grpcUnixSocket() == this->restUnixSocket()) {
+        std::cerr << "grpc_unix_socket and rest_unix_socket cannot have the same values" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // port and rest_port cannot be the same, port 0 with unix socket means gRPC does not listen on TCP
+    if (this->port() == this->restPort() && !(this->port() == 0 && !this->grpcUnixSocket().empty())) {
         std::cerr << "port and rest_port cannot have the same values" << std::endl;
         exit(EX_USAGE);
     }
@@ -267,6 +594,43 @@ void Config::validate() {
         exit(EX_USAGE);
     }
 
+    // check cache_dir path:
+    if (result->count("cache_dir") && !this->cacheDir().empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(this->cacheDir(), ec);
+        if (ec || !std::filesystem::is_directory(this->cacheDir())) {
+            std::cerr << "Directory provided as an --cache_dir parameter cannot be created: " << this->cacheDir() << std::endl;
+            exit(EX_USAGE);
+        }
+    }
+
+    // check remote_model_cache_dir path:
+    if (result->count("remote_model_cache_dir") && !this->remoteModelCacheDir().empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(this->remoteModelCacheDir(), ec);
+        if (ec || !std::filesystem::is_directory(this->remoteModelCacheDir())) {
+            std::cerr << "Directory provided as an --remote_model_cache_dir parameter cannot be created: " << this->remoteModelCacheDir() << std::endl;
+            exit(EX_USAGE);
+        }
+    }
+
+    if ((this->servePeerFiles() || !this->modelPeers().empty()) && this->remoteModelCacheDir().empty()) {
+        std::cerr << "serve_peer_files and model_peers parameters require remote_model_cache_dir" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // check trace_sampling_ratio range
+    if (result->count("trace_sampling_ratio") && (this->traceSamplingRatio() < 0 || this->traceSamplingRatio() > 1)) {
+        std::cerr << "trace_sampling_ratio should be in range from 0 to 1" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    // check traffic_capture_sampling_ratio range
+    if (result->count("traffic_capture_sampling_ratio") && (this->trafficCaptureSamplingRatio() < 0 || this->trafficCaptureSamplingRatio() > 1)) {
+        std::cerr << "traffic_capture_sampling_ratio should be in range from 0 to 1" << std::endl;
+        exit(EX_USAGE);
+    }
+
     // check log_level values
     if (result->count("log_level")) {
         std::vector v({"DEBUG", "INFO", "WARNING", "ERROR"});
@@ -21,7 +21,9 @@
 
 #include <cxxopts.hpp>
 
+#include "cpu_topology.hpp"
 #include "modelconfig.hpp"
+#include "stringutils.hpp"
 
 namespace ovms {
 /**
@@ -119,6 +121,18 @@ public:
         return "";
     }
 
+    /**
+         * @brief Get the directory for compiled models cache, empty when caching is disabled
+         * 
+         * @return const std::string
+         */
+    const std::string cacheDir() {
+        if (result != nullptr && result->count("cache_dir")) {
+            return result->operator[]("cache_dir").as<std::string>();
+        }
+        return "";
+    }
+
     /**
          * @brief Get the gRPC network interface address to bind to
          * 
@@ -129,6 +143,17 @@ public:
             return result->operator[]("grpc_bind_address").as<std::string>();
         return "0.0.0.0";
     }
+    /**
+         * @brief Get the path of Unix domain socket gRPC server listens on, empty when not set
+         * 
+         * @return const std::string
+         */
+    const std::string grpcUnixSocket() {
+        if (result->count("grpc_unix_socket"))
+            return result->operator[]("grpc_unix_socket").as<std::string>();
+        return "";
+    }
+
     /**
          * @brief Gets the REST port
          * 
@@ -149,6 +174,17 @@ public:
         return "0.0.0.0";
     }
 
+    /**
+         * @brief Get the path of Unix domain socket REST server listens on, empty when not set
+         * 
+         * @return const std::string
+         */
+    const std::string restUnixSocket() {
+        if (result->count("rest_unix_socket"))
+            return result->operator[]("rest_unix_socket").as<std::string>();
+        return "";
+    }
+
     /**
          * @brief Gets the gRPC workers count
          * 
@@ -158,6 +194,64 @@ public:
         return result->operator[]("grpc_workers").as<uint>();
     }
 
+    /**
+         * @brief Gets the completion queues count of each gRPC server, 0 means one per CPU core
+         * 
+         * @return uint
+         */
+    uint grpcCompletionQueues() {
+        return result->operator[]("grpc_completion_queues").as<uint>();
+    }
+
+    /**
+         * @brief Gets the maximum number of polling threads per gRPC completion queue, 0 means gRPC default
+         * 
+         * @return uint
+         */
+    uint grpcMaxPollers() {
+        return result->operator[]("grpc_max_pollers").as<uint>();
+    }
+
+    /**
+         * @brief Gets the list of CPU cores frontend threads are pinned to
+         * 
+         * @return std::string
+         */
+    const std::string frontendCpuAffinity() {
+        if (result != nullptr && result->count("frontend_cpu_affinity"))
+            return result->operator[]("frontend_cpu_affinity").as<std::string>();
+        return "";
+    }
+
+    /**
+         * @brief Gets the CPU cores frontend threads are pinned to, empty if threads are not pinned
+         * 
+         * @return std::vector<int>
+         */
+    std::vector<int> frontendCpus() {
+        return parseCpuAffinity(frontendCpuAffinity()).value_or(std::vector<int>());
+    }
+
+    /**
+         * @brief Gets the list of CPU cores background threads are pinned to
+         * 
+         * @return std::string
+         */
+    const std::string backgroundCpuAffinity() {
+        if (result != nullptr && result->count("background_cpu_affinity"))
+            return result->operator[]("background_cpu_affinity").as<std::string>();
+        return "";
+    }
+
+    /**
+         * @brief Gets the CPU cores background threads are pinned to, empty if threads are not pinned
+         * 
+         * @return std::vector<int>
+         */
+    std::vector<int> backgroundCpus() {
+        return parseCpuAffinity(backgroundCpuAffinity()).value_or(std::vector<int>());
+    }
+
     /**
          * @brief Gets the rest workers count
          * 
@@ -167,6 +261,51 @@ public:
         return result->operator[]("rest_workers").as<uint>();
     }
 
+    /**
+         * @brief Gets the count of REST servers sharing rest_port
+         * 
+         * @return uint
+         */
+    uint restReactors() {
+        return result->operator[]("rest_reactors").as<uint>();
+    }
+
+    /**
+         * @brief Gets the maximum REST request body size in megabytes, 0 means no limit
+         * 
+         * @return uint64_t
+         */
+    uint64_t restMaxBodySizeMb() {
+        return result->operator[]("rest_max_body_size_mb").as<uint64_t>();
+    }
+
+    /**
+         * @brief Gets the zlib compression level of REST responses, 0 means compression is disabled
+         * 
+         * @return uint
+         */
+    uint restCompressionLevel() {
+        return result->operator[]("rest_compression_level").as<uint>();
+    }
+
+    /**
+         * @brief Gets the minimum size of REST response in bytes to be compressed
+         * 
+         * @return uint64_t
+         */
+    uint64_t restCompressionMinSize() {
+        return result->operator[]("rest_compression_min_size").as<uint64_t>();
+    }
+
+    /**
+         * @brief Gets the default gRPC compression level: none, low, medium or high
+         * 
+         * @return const std::string&
+         */
+    const std::string& grpcCompressionLevel() {
+        return result->operator[]("grpc_compression_level").as<std::string>();
+    }
+
     /**
          * @brief Get the model name
          * 
@@ -328,6 +467,24 @@ public:
         return empty;
     }
 
+    /**
+        * @brief Get the number of log messages queued for background writing, 0 writes synchronously
+        *
+        * @return uint32_t
+        */
+    uint32_t logQueueSize() {
+        return result->operator[]("log_queue_size").as<uint32_t>();
+    }
+
+    /**
+        * @brief Get the maximum number of messages below WARNING written per second by each logger, 0 is unlimited
+        *
+        * @return uint32_t
+        */
+    uint32_t logRateLimit() {
+        return result->operator[]("log_rate_limit").as<uint32_t>();
+    }
+
     /**
         * @brief Get the plugin config
         *
@@ -348,6 +505,15 @@ public:
         return result->operator[]("file_system_poll_wait_seconds").as<uint>();
     }
 
+    /**
+     * @brief Get the time for which listings of cloud storage are reused in seconds
+     * 
+     * @return uint 
+     */
+    uint remoteListingTtlSeconds() {
+        return result->operator[]("remote_listing_ttl_seconds").as<uint>();
+    }
+
     /**
      * @brief Get the sequence cleaner poll wait time in minutes
      * 
@@ -356,5 +522,440 @@ public:
     uint32_t sequenceCleanerPollWaitMinutes() {
         return result->operator[]("sequence_cleaner_poll_wait_minutes").as<uint32_t>();
     }
+
+    /**
+     * @brief Get the number of threads loading models concurrently
+     * 
+     * @return uint32_t 
+     */
+    uint32_t modelLoadWorkers() {
+        return result->operator[]("model_load_workers").as<uint32_t>();
+    }
+
+    /**
+     * @brief Get the number of concurrent model compilations on background threads, 0 means compilations run on loading threads
+     * 
+     * @return uint32_t 
+     */
+    uint32_t compilationWorkers() {
+        return result->operator[]("compilation_workers").as<uint32_t>();
+    }
+
+    /**
+     * @brief Get the nice value of threads compiling models
+     * 
+     * @return int 
+     */
+    int compilationNice() {
+        return result->operator[]("compilation_nice").as<int>();
+    }
+
+    /**
+     * @brief Get the memory budget for loaded model versions in megabytes, 0 means no limit
+     * 
+     * @return uint64_t 
+     */
+    uint64_t modelsMemoryBudgetMb() {
+        return result->operator[]("models_memory_budget_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Get the policy of replacing retired model versions with new ones: overlap, serial or auto
+     * 
+     * @return const std::string 
+     */
+    const std::string versionSwapPolicy() {
+        return result->operator[]("version_swap_policy").as<std::string>();
+    }
+
+    /**
+     * @brief Checks whether IR weights are mapped to memory
+     * 
+     * @return bool 
+     */
+    bool mmapWeights() {
+        if (result != nullptr && result->count("mmap_weights")) {
+            return result->operator[]("mmap_weights").as<bool>();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Checks whether compiled networks are shared between model versions loaded from identical files
+     * 
+     * @return bool 
+     */
+    bool shareCompiledModels() {
+        if (result != nullptr && result->count("share_compiled_models")) {
+            return result->operator[]("share_compiled_models").as<bool>();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Checks whether model files from online storage are read to memory instead of temporary directory
+     * 
+     * @return bool 
+     */
+    bool remoteModelInMemory() {
+        if (result != nullptr && result->count("remote_model_in_memory")) {
+            return result->operator[]("remote_model_in_memory").as<bool>();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get the directory of remote model files cache, empty means caching disabled
+     * 
+     * @return const std::string 
+     */
+    const std::string remoteModelCacheDir() {
+        if (result != nullptr && result->count("remote_model_cache_dir")) {
+            return result->operator[]("remote_model_cache_dir").as<std::string>();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Get the size limit of remote model files cache in megabytes
+     * 
+     * @return uint64_t 
+     */
+    uint64_t remoteModelCacheSizeMb() {
+        return result->operator[]("remote_model_cache_size_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Get whether files of remote model cache are served to peers
+     * 
+     * @return bool 
+     */
+    bool servePeerFiles() {
+        if (result != nullptr && result->count("serve_peer_files")) {
+            return result->operator[]("serve_peer_files").as<bool>();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get the comma separated REST addresses of peers serving remote model cache files
+     * 
+     * @return const std::string 
+     */
+    const std::string modelPeers() {
+        if (result != nullptr && result->count("model_peers")) {
+            return result->operator[]("model_peers").as<std::string>();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Get the path spans are exported to, empty means tracing disabled
+     * 
+     * @return const std::string 
+     */
+    const std::string traceExportPath() {
+        if (result != nullptr && result->count("trace_export_path")) {
+            return result->operator[]("trace_export_path").as<std::string>();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Get the probability of tracing request without sampled trace context
+     * 
+     * @return double 
+     */
+    double traceSamplingRatio() {
+        return result->operator[]("trace_sampling_ratio").as<double>();
+    }
+
+    /**
+     * @brief Get the path sampled predict requests are captured to, empty means capture disabled
+     * 
+     * @return const std::string 
+     */
+    const std::string trafficCapturePath() {
+        if (result != nullptr && result->count("traffic_capture_path")) {
+            return result->operator[]("traffic_capture_path").as<std::string>();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Get the probability of capturing predict request
+     * 
+     * @return double 
+     */
+    double trafficCaptureSamplingRatio() {
+        return result->operator[]("traffic_capture_sampling_ratio").as<double>();
+    }
+
+    /**
+     * @brief Get the path startup profile is written to, empty means profile is not written
+     * 
+     * @return const std::string 
+     */
+    const std::string startupProfilePath() {
+        if (result != nullptr && result->count("startup_profile_path")) {
+            return result->operator[]("startup_profile_path").as<std::string>();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Checks whether servable is benchmarked in-process instead of starting servers
+     * 
+     * @return bool 
+     */
+    bool benchmark() {
+        if (result != nullptr && result->count("benchmark")) {
+            return result->operator[]("benchmark").as<bool>();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get the name of benchmarked model or pipeline, defaults to model_name
+     * 
+     * @return const std::string 
+     */
+    const std::string benchmarkServable() {
+        if (result != nullptr && result->count("benchmark_servable")) {
+            return result->operator[]("benchmark_servable").as<std::string>();
+        }
+        return result != nullptr && result->count("model_name") ? modelName() : "";
+    }
+
+    /**
+     * @brief Get the number of requests sent concurrently during benchmark
+     * 
+     * @return uint32_t 
+     */
+    uint32_t benchmarkConcurrency() {
+        if (result != nullptr && result->count("benchmark_concurrency")) {
+            return result->operator[]("benchmark_concurrency").as<uint32_t>();
+        }
+        return 1;
+    }
+
+    /**
+     * @brief Get the duration of benchmark in seconds
+     * 
+     * @return uint32_t 
+     */
+    uint32_t benchmarkDurationSeconds() {
+        if (result != nullptr && result->count("benchmark_duration_seconds")) {
+            return result->operator[]("benchmark_duration_seconds").as<uint32_t>();
+        }
+        return 10;
+    }
+
+    /**
+     * @brief Get devices to measure models of benchmarked pipeline on, empty if placement is not planned
+     * 
+     * @return std::vector<std::string> 
+     */
+    std::vector<std::string> benchmarkPlacementDevices() {
+        if (result != nullptr && result->count("benchmark_placement_devices")) {
+            return tokenize(result->operator[]("benchmark_placement_devices").as<std::string>(), ',');
+        }
+        return {};
+    }
+
+    /**
+     * @brief Get the number of inferences measuring model on each device
+     * 
+     * @return uint32_t 
+     */
+    uint32_t benchmarkPlacementIterations() {
+        if (result != nullptr && result->count("benchmark_placement_iterations")) {
+            return result->operator[]("benchmark_placement_iterations").as<uint32_t>();
+        }
+        return 20;
+    }
+
+    /**
+     * @brief Get the bandwidth of transfers between devices assumed by placement planning, in MB/s
+     * 
+     * @return uint32_t 
+     */
+    uint32_t benchmarkPlacementTransferBandwidth() {
+        if (result != nullptr && result->count("benchmark_placement_transfer_bandwidth")) {
+            return result->operator[]("benchmark_placement_transfer_bandwidth").as<uint32_t>();
+        }
+        return 8000;
+    }
+
+    /**
+     * @brief Get the number of the slowest requests kept for each model version and pipeline
+     * 
+     * @return uint32_t 
+     */
+    uint32_t slowRequestsLogSize() {
+        if (result != nullptr && result->count("slow_requests_log_size")) {
+            return result->operator[]("slow_requests_log_size").as<uint32_t>();
+        }
+        return 10;
+    }
+
+    /**
+     * @brief Get the URL of registry model residency is posted to, empty if it is not pushed
+     * 
+     * @return const std::string 
+     */
+    const std::string residencyPushUrl() {
+        if (result != nullptr && result->count("residency_push_url")) {
+            return result->operator[]("residency_push_url").as<std::string>();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Get the interval of posting model residency to registry in milliseconds
+     * 
+     * @return uint32_t 
+     */
+    uint32_t residencyPushIntervalMs() {
+        if (result != nullptr && result->count("residency_push_interval_ms")) {
+            return result->operator[]("residency_push_interval_ms").as<uint32_t>();
+        }
+        return 1000;
+    }
+
+    /**
+     * @brief Get the identifier of the server in model residency, empty for host name
+     * 
+     * @return const std::string 
+     */
+    const std::string residencyServerId() {
+        if (result != nullptr && result->count("residency_server_id")) {
+            return result->operator[]("residency_server_id").as<std::string>();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Get the interval of pipeline executions sampled for critical path analysis
+     * 
+     * @return uint32_t 
+     */
+    uint32_t pipelineCriticalPathSamplingInterval() {
+        if (result != nullptr && result->count("pipeline_critical_path_sampling_interval")) {
+            return result->operator[]("pipeline_critical_path_sampling_interval").as<uint32_t>();
+        }
+        return 100;
+    }
+
+    /**
+     * @brief Checks whether load phase durations are reported in model version status
+     * 
+     * @return bool 
+     */
+    bool modelStatusLoadTimes() {
+        if (result != nullptr && result->count("model_status_load_times")) {
+            return result->operator[]("model_status_load_times").as<bool>();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get the number of threads decoding binary images in parallel, 0 means decoding on request thread
+     * 
+     * @return uint32_t 
+     */
+    uint32_t imageDecodeWorkers() {
+        return result->operator[]("image_decode_workers").as<uint32_t>();
+    }
+
+    /**
+     * @brief Get the number of threads deserializing large inputs in parallel, 0 means deserializing on request thread
+     * 
+     * @return uint32_t 
+     */
+    uint32_t deserializationWorkers() {
+        return result->operator[]("deserialization_workers").as<uint32_t>();
+    }
+
+    /**
+     * @brief Get the minimal size of input data deserialized on deserialization workers
+     * 
+     * @return uint64_t 
+     */
+    uint64_t deserializationParallelMinBytes() {
+        return result->operator[]("deserialization_parallel_min_bytes").as<uint64_t>();
+    }
+
+    /**
+     * @brief Get the path to library decoding binary images, empty when images are decoded on CPU
+     * 
+     * @return const std::string& 
+     */
+    const std::string& imageDecoderLibrary() {
+        return result->operator[]("image_decoder_library").as<std::string>();
+    }
+
+    /**
+     * @brief Get the number of inferences running concurrently in all models, 0 means unlimited
+     * 
+     * @return uint32_t 
+     */
+    uint32_t maxConcurrentInferences() {
+        return result->operator[]("max_concurrent_inferences").as<uint32_t>();
+    }
+
+    /**
+     * @brief Get the number of CPU threads divided among models served on CPU, 0 means unlimited
+     * 
+     * @return uint32_t 
+     */
+    uint32_t cpuThreadsBudget() {
+        return result->operator[]("cpu_threads_budget").as<uint32_t>();
+    }
+
+    /**
+     * @brief Get the number of CPU throughput streams divided among models served on CPU, 0 means unlimited
+     * 
+     * @return uint32_t 
+     */
+    uint32_t cpuStreamsBudget() {
+        return result->operator[]("cpu_streams_budget").as<uint32_t>();
+    }
+
+    /**
+     * @brief Get the memory kept in freed blob buffers for reuse, 0 means blobs are allocated directly
+     * 
+     * @return uint64_t 
+     */
+    uint64_t tensorBufferPoolSizeMb() {
+        return result->operator[]("tensor_buffer_pool_size_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Get the size limit of single pooled blob buffer
+     * 
+     * @return uint64_t 
+     */
+    uint64_t tensorBufferPoolMaxBufferMb() {
+        return result->operator[]("tensor_buffer_pool_max_buffer_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Get the kind of pages backing large blob buffers: none, transparent or explicit
+     * 
+     * @return const std::string 
+     */
+    const std::string tensorBufferHugePages() {
+        return result->operator[]("tensor_buffer_huge_pages").as<std::string>();
+    }
+
+    /**
+     * @brief Get whether blob buffers created by the server are locked in RAM
+     * 
+     * @return bool 
+     */
+    bool tensorBufferLockMemory() {
+        return result->operator[]("tensor_buffer_lock_memory").as<bool>();
+    }
 };
 }  // namespace ovms
@@ -0,0 +1,110 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "cpu_budget.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "config.hpp"
+
+namespace ovms {
+
+static std::shared_ptr<InferenceEngine::Core> createOVCore() {
+    auto engine = std::make_shared<InferenceEngine::Core>();
+    if (ovms::Config::instance().cpuExtensionLibraryPath() != "") {
+        SPDLOG_INFO("Loading custom CPU extension from {}", ovms::Config::instance().cpuExtensionLibraryPath());
+        try {
+            auto extension_ptr = std::make_shared<InferenceEngine::Extension>(ovms::Config::instance().cpuExtensionLibraryPath());
+            SPDLOG_INFO("Custom CPU extention loaded. Adding it.");
+            engine->AddExtension(extension_ptr, "CPU");
+            SPDLOG_INFO("Extention added.");
+        } catch (std::exception& ex) {
+            SPDLOG_CRITICAL("Custom CPU extention loading has failed! Reason: {}", ex.what());
+            throw;
+        } catch (...) {
+            SPDLOG_CRITICAL("Custom CPU extention loading has failed with an unknown error!");
+            throw;
+        }
+    }
+    const auto cacheDir = ovms::Config::instance().cacheDir();
+    if (cacheDir != "") {
+        SPDLOG_DEBUG("Using compiled model cache directory: {}", cacheDir);
+        // Blobs are keyed by OpenVINO with network hash, device and plugin config.
+        // Devices which cannot export compiled models ignore the setting.
+        engine->SetConfig({{CONFIG_KEY(CACHE_DIR), cacheDir}});
+    }
+    return engine;
+}
+
+std::shared_ptr<InferenceEngine::Core> getSharedOVCore() {
+    // creation failure leaves the core unset, so the next model load retries it
+    static std::mutex mtx;
+    static std::shared_ptr<InferenceEngine::Core> engine;
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!engine) {
+        engine = createOVCore();
+    }
+    return engine;
+}
+
+void CpuBudget::setBudget(uint32_t threads, uint32_t streams) {
+    std::lock_guard<std::mutex> lock(mtx);
+    this->threads = threads;
+    this->streams = streams;
+}
+
+bool CpuBudget::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return threads > 0 || streams > 0;
+}
+
+void CpuBudget::setModelWeights(std::map<std::string, uint32_t> weights) {
+    std::lock_guard<std::mutex> lock(mtx);
+    this->weights = std::move(weights);
+}
+
+CpuBudget::Share CpuBudget::getShare(const std::string& modelName) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    Share share;
+    if (threads == 0 && streams == 0) {
+        return share;
+    }
+    uint64_t totalWeight = 0;
+    for (const auto& [name, weight] : weights) {
+        totalWeight += std::max<uint32_t>(1, weight);
+    }
+    uint64_t weight = 1;
+    auto it = weights.find(modelName);
+    if (it != weights.end()) {
+        weight = std::max<uint32_t>(1, it->second);
+    } else {
+        totalWeight += weight;
+    }
+    if (threads > 0) {
+        share.threads = std::max<uint64_t>(1, threads * weight / totalWeight);
+    }
+    if (streams > 0) {
+        share.streams = std::max<uint64_t>(1, streams * weight / totalWeight);
+        if (share.threads > 0) {
+            share.streams = std::min(share.streams, share.threads);
+        }
+    }
+    return share;
+}
+
+}  // namespace ovms
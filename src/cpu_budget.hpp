@@ -0,0 +1,80 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Gets InferenceEngine::Core shared by all model instances
+ *
+ * Core is created on first use with CPU extension and compiled model cache directory from server configuration,
+ * so device plugins are loaded once per process. Plugin config of a model is passed when its network is loaded.
+ */
+std::shared_ptr<InferenceEngine::Core> getSharedOVCore();
+
+/**
+ * @brief Global CPU threads and streams budget divided among models served on CPU proportionally to their scheduling weight
+ *
+ * Without the budget each CPU network sizes its thread pools as if it owned the whole machine.
+ * Share of a model is applied when its version is loaded or reloaded.
+ */
+class CpuBudget {
+    mutable std::mutex mtx;
+    uint32_t threads = 0;
+    uint32_t streams = 0;
+    std::map<std::string, uint32_t> weights;
+
+public:
+    struct Share {
+        // 0 means not limited
+        uint32_t threads = 0;
+        uint32_t streams = 0;
+    };
+
+    static CpuBudget& instance() {
+        static CpuBudget instance;
+        return instance;
+    }
+
+    /**
+     * @brief Sets total CPU threads and streams, 0 disables the corresponding limit
+     */
+    void setBudget(uint32_t threads, uint32_t streams);
+
+    bool isEnabled() const;
+
+    /**
+     * @brief Replaces weights of models served on CPU
+     */
+    void setModelWeights(std::map<std::string, uint32_t> weights);
+
+    /**
+     * @brief Gets share of the budget of model, model without registered weight counts with weight 1
+     *
+     * Each limited share is at least 1 and streams never exceed threads.
+     */
+    Share getShare(const std::string& modelName) const;
+};
+
+}  // namespace ovms
@@ -0,0 +1,42 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "cpu_topology.hpp"
+
+#include <fstream>
+
+#include "stringutils.hpp"
+
+namespace ovms {
+
+std::optional<std::vector<int>> readCpuListFile(const std::string& path) {
+    std::ifstream file(path);
+    std::string content;
+    if (!file || !std::getline(file, content)) {
+        return std::nullopt;
+    }
+    trim(content);
+    return parseCpuList(content);
+}
+
+std::optional<std::vector<int>> parseCpuAffinity(const std::string& str) {
+    if (str == PERFORMANCE_CORES || str == EFFICIENCY_CORES) {
+        auto cpus = readCpuListFile(str == PERFORMANCE_CORES ? PERFORMANCE_CORES_PATH : EFFICIENCY_CORES_PATH);
+        return cpus.value_or(std::vector<int>());
+    }
+    return parseCpuList(str);
+}
+
+}  // namespace ovms
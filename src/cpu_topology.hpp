@@ -0,0 +1,55 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * Keywords of CPU affinity settings selecting core type of hybrid processors
+ */
+constexpr const char* PERFORMANCE_CORES = "performance";
+constexpr const char* EFFICIENCY_CORES = "efficiency";
+
+/**
+ * Files listing cores of each type, exposed by Linux on hybrid processors
+ */
+constexpr const char* PERFORMANCE_CORES_PATH = "/sys/devices/cpu_core/cpus";
+constexpr const char* EFFICIENCY_CORES_PATH = "/sys/devices/cpu_atom/cpus";
+
+/**
+ * @brief Reads list of CPU cores in form accepted by parseCpuList, e.g. 0-15
+ *
+ * @param path
+ * @return core numbers or std::nullopt if file cannot be read or is malformed
+ */
+std::optional<std::vector<int>> readCpuListFile(const std::string& path);
+
+/**
+ * @brief Parses CPU affinity setting, list of CPU cores as in parseCpuList or core type keyword
+ *
+ * Keywords performance and efficiency select cores of that type on hybrid processors. On processors
+ * with single core type they resolve to empty set, which leaves threads unpinned.
+ *
+ * @param str
+ * @return core numbers or std::nullopt if setting is malformed
+ */
+std::optional<std::vector<int>> parseCpuAffinity(const std::string& str);
+
+}  // namespace ovms
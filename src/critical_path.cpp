@@ -0,0 +1,177 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "critical_path.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <optional>
+
+namespace ovms {
+
+std::atomic<uint32_t> CriticalPathAnalyzer::samplingInterval{CriticalPathAnalyzer::DEFAULT_SAMPLING_INTERVAL};
+
+CriticalPathAnalyzer::CriticalPathAnalyzer(std::vector<std::string> nodeNames, const std::vector<std::pair<size_t, size_t>>& connections) :
+    nodeNames(std::move(nodeNames)),
+    dependencies(this->nodeNames.size()),
+    dependants(this->nodeNames.size()) {
+    for (size_t i = 0; i < this->nodeNames.size(); ++i) {
+        nodeIndexes.emplace(this->nodeNames[i], i);
+    }
+    std::vector<size_t> pendingDependencies(this->nodeNames.size(), 0);
+    for (const auto& [dependency, dependant] : connections) {
+        dependencies[dependant].push_back(dependency);
+        dependants[dependency].push_back(dependant);
+        ++pendingDependencies[dependant];
+    }
+    // validated definitions have no cycles, so all nodes get ordered
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < pendingDependencies.size(); ++i) {
+        if (pendingDependencies[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    while (!ready.empty()) {
+        const size_t node = ready.back();
+        ready.pop_back();
+        topologicalOrder.push_back(node);
+        for (size_t dependant : dependants[node]) {
+            if (--pendingDependencies[dependant] == 0) {
+                ready.push_back(dependant);
+            }
+        }
+    }
+}
+
+void CriticalPathAnalyzer::record(const std::vector<CriticalPathNodeTimes>& times) {
+    Sample sample;
+    sample.nodes.resize(nodeNames.size());
+    std::vector<uint64_t> ready(nodeNames.size(), 0);
+    std::vector<uint64_t> finished(nodeNames.size(), 0);
+    for (const auto& nodeTimes : times) {
+        auto it = nodeIndexes.find(nodeTimes.name);
+        if (it == nodeIndexes.end()) {
+            continue;
+        }
+        sample.nodes[it->second].present = true;
+        sample.nodes[it->second].streamWaitUs = nodeTimes.streamWaitUs;
+        ready[it->second] = nodeTimes.readyUs;
+        finished[it->second] = std::max(nodeTimes.readyUs, nodeTimes.finishedUs);
+        sample.latencyUs = std::max(sample.latencyUs, finished[it->second]);
+    }
+
+    std::vector<int64_t> latestFinish(nodeNames.size(), static_cast<int64_t>(sample.latencyUs));
+    for (auto it = topologicalOrder.rbegin(); it != topologicalOrder.rend(); ++it) {
+        const size_t node = *it;
+        if (!sample.nodes[node].present) {
+            continue;
+        }
+        for (size_t dependant : dependants[node]) {
+            if (sample.nodes[dependant].present) {
+                const int64_t latestStart = latestFinish[dependant] - static_cast<int64_t>(finished[dependant] - ready[dependant]);
+                latestFinish[node] = std::min(latestFinish[node], latestStart);
+            }
+        }
+        sample.nodes[node].slackUs = static_cast<uint64_t>(std::max<int64_t>(0, latestFinish[node] - static_cast<int64_t>(finished[node])));
+    }
+
+    // path ends with node finishing last, which is exit node
+    std::optional<size_t> current;
+    for (size_t node = 0; node < nodeNames.size(); ++node) {
+        if (sample.nodes[node].present && (!current || finished[node] > finished[current.value()])) {
+            current = node;
+        }
+    }
+    while (current) {
+        const size_t node = current.value();
+        current.reset();
+        for (size_t dependency : dependencies[node]) {
+            if (sample.nodes[dependency].present && !sample.nodes[dependency].critical && (!current || finished[dependency] > finished[current.value()])) {
+                current = dependency;
+            }
+        }
+        sample.nodes[node].critical = true;
+        sample.nodes[node].contributionUs = finished[node] - (current ? std::min(finished[current.value()], finished[node]) : 0);
+        sample.criticalPath.push_back(node);
+    }
+    std::reverse(sample.criticalPath.begin(), sample.criticalPath.end());
+
+    std::lock_guard<std::mutex> lock(mtx);
+    samples.push_back(std::move(sample));
+    if (samples.size() > WINDOW_SAMPLES) {
+        samples.pop_front();
+    }
+}
+
+CriticalPathReport CriticalPathAnalyzer::getReport() const {
+    CriticalPathReport report;
+    report.nodes.resize(nodeNames.size());
+    for (size_t i = 0; i < nodeNames.size(); ++i) {
+        report.nodes[i].name = nodeNames[i];
+        report.nodes[i].minSlackUs = std::numeric_limits<uint64_t>::max();
+    }
+    std::map<std::vector<size_t>, uint64_t> paths;
+    uint64_t latencyUs = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        report.samples = samples.size();
+        for (const auto& sample : samples) {
+            latencyUs += sample.latencyUs;
+            ++paths[sample.criticalPath];
+            for (size_t i = 0; i < nodeNames.size(); ++i) {
+                const auto& nodeSample = sample.nodes[i];
+                if (!nodeSample.present) {
+                    continue;
+                }
+                auto& node = report.nodes[i];
+                ++node.samples;
+                node.criticalFraction += nodeSample.critical ? 1 : 0;
+                node.contributionUs += static_cast<double>(nodeSample.contributionUs);
+                node.slackUs += static_cast<double>(nodeSample.slackUs);
+                node.minSlackUs = std::min(node.minSlackUs, nodeSample.slackUs);
+                node.streamWaitUs += static_cast<double>(nodeSample.streamWaitUs);
+            }
+        }
+    }
+    if (report.samples == 0) {
+        for (auto& node : report.nodes) {
+            node.minSlackUs = 0;
+        }
+        return report;
+    }
+    report.latencyUs = static_cast<double>(latencyUs) / static_cast<double>(report.samples);
+    for (auto& node : report.nodes) {
+        if (node.samples == 0) {
+            node.minSlackUs = 0;
+            continue;
+        }
+        const double samplesCount = static_cast<double>(node.samples);
+        node.contributionShare = latencyUs > 0 ? node.contributionUs / static_cast<double>(latencyUs) : 0;
+        node.criticalFraction /= samplesCount;
+        node.contributionUs /= samplesCount;
+        node.slackUs /= samplesCount;
+        node.streamWaitUs /= samplesCount;
+    }
+    auto mostFrequent = std::max_element(paths.begin(), paths.end(),
+        [](const auto& left, const auto& right) { return left.second < right.second; });
+    for (size_t node : mostFrequent->first) {
+        report.criticalPath.push_back(nodeNames[node]);
+    }
+    report.criticalPathFraction = static_cast<double>(mostFrequent->second) / static_cast<double>(report.samples);
+    return report;
+}
+
+}  // namespace ovms
@@ -0,0 +1,139 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Times of node in single sampled pipeline execution, in microseconds since execution start
+ *
+ * Node with several sessions is ready when its first session gets all inputs and finishes with its last session.
+ */
+struct CriticalPathNodeTimes {
+    std::string name;
+    uint64_t readyUs = 0;
+    uint64_t finishedUs = 0;
+    uint64_t streamWaitUs = 0;
+};
+
+/**
+ * @brief Aggregated critical path statistics of single node over sampled executions
+ */
+struct CriticalPathNodeReport {
+    std::string name;
+    // sampled executions the node took part in
+    uint64_t samples = 0;
+    // fraction of samples the node was on critical path
+    double criticalFraction = 0;
+    // mean time node added to execution latency, 0 for samples it was not on critical path
+    double contributionUs = 0;
+    // fraction of summed latency of samples added by the node
+    double contributionShare = 0;
+    // mean and minimum time node could have finished later without delaying the execution
+    double slackUs = 0;
+    uint64_t minSlackUs = 0;
+    // mean time sessions of node waited for infer request
+    double streamWaitUs = 0;
+};
+
+struct CriticalPathReport {
+    uint64_t samples = 0;
+    double latencyUs = 0;
+    // the most frequent critical path, from entry to exit node
+    std::vector<std::string> criticalPath;
+    double criticalPathFraction = 0;
+    // in order of nodes of pipeline definition
+    std::vector<CriticalPathNodeReport> nodes;
+};
+
+/**
+ * @brief Computes critical path through pipeline graph over the last sampled executions
+ *
+ * Critical path is followed back from exit node, through the dependency which finished last, to entry node.
+ * Each node on the path contributes time between finish of its predecessor on the path and its own finish,
+ * so contributions of sample sum up to its latency. Slack is computed backwards in topological order: latest
+ * finish of node is the earliest latest start of its dependants, where latest start of dependant is its latest
+ * finish less time it took since it was ready. Nodes not created for the execution, since they did not produce
+ * requested outputs, are left out of the sample.
+ */
+class CriticalPathAnalyzer {
+public:
+    static constexpr size_t WINDOW_SAMPLES = 100;
+    static constexpr uint32_t DEFAULT_SAMPLING_INTERVAL = 100;
+
+    /**
+     * @param nodeNames names of nodes of pipeline definition
+     * @param connections pairs of dependency and dependant indexes of nodes
+     */
+    CriticalPathAnalyzer(std::vector<std::string> nodeNames, const std::vector<std::pair<size_t, size_t>>& connections);
+
+    /**
+     * @brief Sets interval of sampled executions of all pipelines, 0 disables sampling
+     */
+    static void setSamplingInterval(uint32_t interval) {
+        samplingInterval.store(interval, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Decides whether execution is sampled, every n-th execution is
+     */
+    bool sample() {
+        const uint32_t interval = samplingInterval.load(std::memory_order_relaxed);
+        return interval > 0 && executions.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+    }
+
+    void record(const std::vector<CriticalPathNodeTimes>& times);
+
+    CriticalPathReport getReport() const;
+
+private:
+    static std::atomic<uint32_t> samplingInterval;
+
+    struct NodeSample {
+        bool present = false;
+        bool critical = false;
+        uint64_t contributionUs = 0;
+        uint64_t slackUs = 0;
+        uint64_t streamWaitUs = 0;
+    };
+    struct Sample {
+        uint64_t latencyUs = 0;
+        std::vector<size_t> criticalPath;
+        std::vector<NodeSample> nodes;
+    };
+
+    const std::vector<std::string> nodeNames;
+    std::unordered_map<std::string, size_t> nodeIndexes;
+    std::vector<std::vector<size_t>> dependencies;
+    std::vector<std::vector<size_t>> dependants;
+    // nodes ordered so that dependencies precede their dependants
+    std::vector<size_t> topologicalOrder;
+
+    std::atomic<uint64_t> executions{0};
+    mutable std::mutex mtx;
+    std::deque<Sample> samples;
+};
+
+}  // namespace ovms
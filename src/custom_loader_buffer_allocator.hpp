@@ -0,0 +1,76 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Calls custom loader release callback once the buffer is no longer used by the server
+ */
+class CustomLoaderBufferGuard {
+    std::function<void()> release;
+
+public:
+    explicit CustomLoaderBufferGuard(std::function<void()> release) :
+        release(std::move(release)) {}
+    ~CustomLoaderBufferGuard() {
+        if (release) {
+            release();
+        }
+    }
+    CustomLoaderBufferGuard(const CustomLoaderBufferGuard&) = delete;
+    CustomLoaderBufferGuard& operator=(const CustomLoaderBufferGuard&) = delete;
+};
+
+/**
+ * @brief Exposes memory returned by custom loader as blob memory, keeps owner alive for the lifetime of blob using this allocator
+ */
+class CustomLoaderBufferAllocator : public InferenceEngine::IAllocator {
+    void* data;
+    size_t size;
+    std::shared_ptr<void> owner;
+
+public:
+    CustomLoaderBufferAllocator(void* data, size_t size, std::shared_ptr<void> owner) :
+        data(data),
+        size(size),
+        owner(std::move(owner)) {}
+
+    void* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+    void* lock(void* handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void* a) noexcept override {}
+
+    void* alloc(size_t size) noexcept override {
+        return size <= this->size ? data : nullptr;
+    }
+
+    bool free(void* handle) noexcept override {
+        return true;
+    }
+};
+
+}  // namespace ovms
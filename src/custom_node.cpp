@@ -17,6 +17,8 @@
 
 #include <utility>
 
+#include "custom_node_executor.hpp"
+#include "custom_node_library_state.hpp"
 #include "custom_node_output_allocator.hpp"
 #include "customnodesession.hpp"
 #include "logging.hpp"
@@ -31,22 +33,82 @@ CustomNode::CustomNode(
     const parameters_t& parameters,
     const std::unordered_map<std::string, std::string>& nodeOutputNameAlias,
     std::optional<uint32_t> demultiplyCount,
-    std::set<std::string> gatherFromNode) :
+    std::set<std::string> gatherFromNode,
+    std::shared_ptr<CustomNodeLibraryState> libraryState) :
     Node(nodeName, demultiplyCount, gatherFromNode),
     library(library),
     parameters(parameters),
     nodeOutputNameAlias(nodeOutputNameAlias),
-    libraryParameters(createCustomNodeParamArray(this->parameters)) {
+    libraryParameters(createCustomNodeParamArray(this->parameters)),
+    libraryState(std::move(libraryState)) {
 }
 
 Status CustomNode::execute(session_key_t sessionKey, PipelineEventQueue& notifyEndQueue) {
     auto& nodeSession = getNodeSession(sessionKey);
     auto& customNodeSession = static_cast<CustomNodeSession&>(nodeSession);
-    return customNodeSession.execute(notifyEndQueue, *this, this->library, this->libraryParameters, this->parameters.size());
+    if (customNodeSession.isBatchMember()) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] session: {} is executed in batch of session: {}", getName(), sessionKey, customNodeSession.getBatchLeaderKey());
+        return StatusCode::OK;
+    }
+    // sessions are picked on pipeline thread even if they are executed on other one
+    customNodeSession.markInputsUsed();
+    std::vector<CustomNodeSession*> members;
+    if (this->library.executeBatch) {
+        members = collectBatchMembers(customNodeSession);
+    }
+    if (!this->library.executor) {
+        return executeSession(customNodeSession, members, notifyEndQueue);
+    }
+    // Session end events are passed to pipeline only after execution slot is given back
+    auto events = std::make_shared<std::vector<NodeSessionKeyPair>>();
+    auto status = std::make_shared<Status>();
+    this->library.executor->run(
+        [this, &customNodeSession, members, events, status]() {
+            PipelineEventQueue sessionsEndQueue;
+            sessionsEndQueue.setListener([events](NodeSessionKeyPair&& event) { events->emplace_back(std::move(event)); });
+            *status = executeSession(customNodeSession, members, sessionsEndQueue);
+        },
+        [events, &notifyEndQueue]() {
+            for (auto& event : *events) {
+                notifyEndQueue.push(std::move(event));
+            }
+        });
+    // errors of executions finished on dedicated threads are reported when fetching results
+    return this->library.executor->isAsync() ? StatusCode::OK : *status;
+}
+
+Status CustomNode::executeSession(CustomNodeSession& nodeSession, const std::vector<CustomNodeSession*>& members, PipelineEventQueue& notifyEndQueue) {
+    void* state = this->libraryState ? this->libraryState->get() : nullptr;
+    if (this->library.executeBatch) {
+        return nodeSession.executeBatch(notifyEndQueue, *this, this->library, this->libraryParameters, this->parameters.size(), state, members);
+    }
+    return nodeSession.execute(notifyEndQueue, *this, this->library, this->libraryParameters, this->parameters.size(), state);
+}
+
+std::vector<CustomNodeSession*> CustomNode::collectBatchMembers(CustomNodeSession& nodeSession) {
+    std::vector<CustomNodeSession*> members;
+    for (auto& [sessionKey, session] : nodeSessions) {
+        if (session.get() == &nodeSession || !session->isReady()) {
+            continue;
+        }
+        auto& candidate = static_cast<CustomNodeSession&>(*session);
+        if (candidate.peekInputs().size() != nodeSession.peekInputs().size()) {
+            continue;
+        }
+        candidate.joinBatch(nodeSession.getSessionKey());
+        members.emplace_back(&candidate);
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} executing batch of: {} sessions",
+        getName(), nodeSession.getSessionKey(), members.size() + 1);
+    return members;
 }
 
 Status CustomNode::fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) {
     auto& customNodeSession = static_cast<CustomNodeSession&>(nodeSession);
+    if (!customNodeSession.getExecutionStatus().ok()) {
+        customNodeSession.release();
+        return customNodeSession.getExecutionStatus();
+    }
     const auto& sessionMetadata = nodeSession.getNodeSessionMetadata();
     SessionResult sessionResults{sessionMetadata, {}};
     auto it = nodeSessionOutputs.emplace(sessionMetadata.getSessionKey(), std::move(sessionResults));
@@ -67,28 +129,26 @@ Status CustomNode::fetchResults(BlobMap& outputs, session_key_t sessionKey) {
     auto& session = static_cast<CustomNodeSession&>(this->getNodeSession(sessionKey));
     session.clearInputs();
 
-    for (const auto& node : this->next) {
-        for (const auto& pair : node.get().getMappingByDependency(*this)) {
-            const auto& output_name = pair.first;
-            if (outputs.find(output_name) != outputs.end()) {
-                continue;
-            }
-            const auto& realOutputName = this->getRealOutputName(output_name);
-            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Getting custom node output tensor with name: {}",
-                getName(), sessionKey, realOutputName);
-
-            InferenceEngine::Blob::Ptr resultBlob;
-            auto status = session.fetchResult(realOutputName, resultBlob);
-            if (!status.ok()) {
-                SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} Custom node output with name {} is missing",
-                    getName(), sessionKey, realOutputName);
-                return StatusCode::NODE_LIBRARY_MISSING_OUTPUT;
-            }
+    for (const auto& link : getOutputLinks()) {
+        const auto& output_name = *link.outputName;
+        if (outputs.find(output_name) != outputs.end()) {
+            continue;
+        }
+        const auto& realOutputName = this->getRealOutputName(output_name);
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Getting custom node output tensor with name: {}",
+            getName(), sessionKey, realOutputName);
 
-            outputs.emplace(std::make_pair(output_name, std::move(resultBlob)));
-            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Blob with name {} has been prepared under alias {}",
-                getName(), sessionKey, realOutputName, output_name);
+        InferenceEngine::Blob::Ptr resultBlob;
+        auto status = session.fetchResult(realOutputName, resultBlob);
+        if (!status.ok()) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} Custom node output with name {} is missing",
+                getName(), sessionKey, realOutputName);
+            return StatusCode::NODE_LIBRARY_MISSING_OUTPUT;
         }
+
+        outputs.emplace(std::make_pair(output_name, std::move(resultBlob)));
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Blob with name {} has been prepared under alias {}",
+            getName(), sessionKey, realOutputName, output_name);
     }
 
     return StatusCode::OK;
@@ -19,6 +19,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "custom_node_interface.h"  // NOLINT
 #include "node.hpp"
@@ -27,6 +28,8 @@
 
 namespace ovms {
 
+class CustomNodeLibraryState;
+class CustomNodeSession;
 class NodeLibrary;
 
 class CustomNode : public Node {
@@ -36,6 +39,8 @@ class CustomNode : public Node {
 
     std::unique_ptr<struct CustomNodeParam[]> libraryParameters = nullptr;
 
+    std::shared_ptr<CustomNodeLibraryState> libraryState;
+
 public:
     CustomNode(
         const std::string& nodeName,
@@ -43,10 +48,20 @@ public:
         const parameters_t& parameters,
         const std::unordered_map<std::string, std::string>& nodeOutputNameAlias = {},
         std::optional<uint32_t> demultiplyCount = std::nullopt,
-        std::set<std::string> gatherFromNode = {});
+        std::set<std::string> gatherFromNode = {},
+        std::shared_ptr<CustomNodeLibraryState> libraryState = nullptr);
 
     Status execute(session_key_t sessionKey, PipelineEventQueue& notifyEndQueue) override;
 
+private:
+    /**
+     * @brief Marks other ready sessions of node as executed in batch of session
+     */
+    std::vector<CustomNodeSession*> collectBatchMembers(CustomNodeSession& nodeSession);
+    Status executeSession(CustomNodeSession& nodeSession, const std::vector<CustomNodeSession*>& members, PipelineEventQueue& notifyEndQueue);
+
+public:
+
     Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) override;
     Status fetchResults(BlobMap& outputs, session_key_t sessionKey);
 
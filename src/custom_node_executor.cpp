@@ -0,0 +1,59 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "custom_node_executor.hpp"
+
+#include <utility>
+
+namespace ovms {
+
+CustomNodeExecutor::CustomNodeExecutor(const CustomNodeLibraryExecutionConfig& config) :
+    maxConcurrency(config.maxConcurrency),
+    workers(config.workerThreads > 0 ? std::make_unique<WorkerPool>(config.workerThreads, config.cpuAffinity) : nullptr) {}
+
+void CustomNodeExecutor::acquire() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this]() { return maxConcurrency == 0 || runningCount < maxConcurrency; });
+    ++runningCount;
+}
+
+void CustomNodeExecutor::release() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        --runningCount;
+    }
+    cv.notify_one();
+}
+
+void CustomNodeExecutor::run(std::function<void()> execution, std::function<void()> notify) {
+    auto guardedExecution = [this, execution = std::move(execution), notify = std::move(notify)]() {
+        acquire();
+        execution();
+        release();
+        notify();
+    };
+    if (workers) {
+        workers->schedule(std::move(guardedExecution));
+    } else {
+        guardedExecution();
+    }
+}
+
+uint32_t CustomNodeExecutor::getRunningCount() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return runningCount;
+}
+
+}  // namespace ovms
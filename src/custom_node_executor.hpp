@@ -0,0 +1,92 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "workerpool.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Execution settings of custom node library from custom_node_library_config_list
+ */
+struct CustomNodeLibraryExecutionConfig {
+    // maximum number of library executions at the same time, 0 means no limit
+    uint32_t maxConcurrency = 0;
+    // number of dedicated threads executing library, 0 means executing on pipeline threads
+    uint32_t workerThreads = 0;
+    // CPU cores dedicated threads are pinned to, empty means no pinning
+    std::vector<int> cpuAffinity;
+
+    bool operator==(const CustomNodeLibraryExecutionConfig& rhs) const {
+        return maxConcurrency == rhs.maxConcurrency &&
+               workerThreads == rhs.workerThreads &&
+               cpuAffinity == rhs.cpuAffinity;
+    }
+    bool operator!=(const CustomNodeLibraryExecutionConfig& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+/**
+ * @brief Runs custom node library executions within concurrency limit, optionally on dedicated threads
+ *
+ * Shared by all custom nodes using the library, so that the limit applies across pipelines.
+ */
+class CustomNodeExecutor {
+    const uint32_t maxConcurrency;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    uint32_t runningCount = 0;
+
+    // declared last so that it waits for scheduled executions before the rest is destroyed
+    std::unique_ptr<WorkerPool> workers;
+
+    void acquire();
+    void release();
+
+public:
+    explicit CustomNodeExecutor(const CustomNodeLibraryExecutionConfig& config);
+
+    CustomNodeExecutor(const CustomNodeExecutor&) = delete;
+    CustomNodeExecutor& operator=(const CustomNodeExecutor&) = delete;
+
+    /**
+     * @brief Tells whether run returns before execution finishes
+     */
+    bool isAsync() const {
+        return workers != nullptr;
+    }
+
+    /**
+     * @brief Runs execution on calling thread or schedules it on dedicated thread
+     *
+     * When concurrency limit is reached, waits until other execution finishes.
+     * Notify is called after execution gives its slot back, so it may let owner of executor go away.
+     */
+    void run(std::function<void()> execution, std::function<void()> notify);
+
+    uint32_t getRunningCount();
+};
+
+}  // namespace ovms
@@ -28,6 +28,12 @@ typedef enum {
     I32
 } CustomNodeTensorPrecision;
 
+/*
+ * Output data may point into data of an input tensor instead of newly allocated memory, e.g. when node
+ * only reshapes or slices its input, or modifies it in place. Server keeps the input alive as long as the
+ * output is used and such data, as well as input dims reused by outputs, is never passed to release.
+ * Input modified in place must not be consumed by other nodes of the pipeline.
+ */
 struct CustomNodeTensor {
     const char* name;
     uint8_t* data;
@@ -48,6 +54,16 @@ struct CustomNodeParam {
     const char *key, *value;
 };
 
+/*
+ * Memory allocator provided by the server to executeWithAllocator.
+ * Memory returned by allocate is owned by the server and is never passed to release.
+ * It is valid until outputs are no longer needed by the pipeline. Allocation failure returns NULL.
+ */
+struct CustomNodeAllocator {
+    void* (*allocate)(void* context, uint64_t bytes);
+    void* context;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -57,6 +73,29 @@ int getInputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const stru
 int getOutputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const struct CustomNodeParam* params, int paramsCount);
 int release(void* ptr);
 
+/*
+ * Optional. When exported by the library it is called instead of execute. Outputs array, output names,
+ * data and dims may be allocated with provided allocator instead of malloc.
+ * State is the one created by initialize for this node, NULL when library does not export initialize.
+ */
+int executeWithAllocator(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount, const struct CustomNodeAllocator* allocator, void* state);
+
+/*
+ * Optional. When exported by the library, all ready sessions of the node, e.g. shards produced by demultiplexer,
+ * are executed with single call instead of executeWithAllocator or execute per session. inputs[i] points to
+ * inputsCount tensors of session i, for each of batchSize sessions library sets outputs[i] and outputsCounts[i]
+ * as in execute. Non zero result fails all sessions of the batch.
+ */
+int executeBatch(const struct CustomNodeTensor** inputs, int inputsCount, int batchSize, struct CustomNodeTensor** outputs, int* outputsCounts, const struct CustomNodeParam* params, int paramsCount, const struct CustomNodeAllocator* allocator, void* state);
+
+/*
+ * Optional, exported together with deinitialize. Called once per custom node of pipeline definition when
+ * it is loaded, before any execution. Created state is passed to executeWithAllocator and to deinitialize
+ * when no execution uses it anymore. Non zero result fails pipeline definition validation.
+ */
+int initialize(void** state, const struct CustomNodeParam* params, int paramsCount);
+int deinitialize(void* state);
+
 #ifdef __cplusplus
 }
 #endif
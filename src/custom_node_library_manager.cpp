@@ -25,7 +25,14 @@
 
 namespace ovms {
 
-Status CustomNodeLibraryManager::loadLibrary(const std::string& name, const std::string& basePath) {
+static std::shared_ptr<CustomNodeExecutor> createExecutor(const CustomNodeLibraryExecutionConfig& config) {
+    if (config == CustomNodeLibraryExecutionConfig{}) {
+        return nullptr;
+    }
+    return std::make_shared<CustomNodeExecutor>(config);
+}
+
+Status CustomNodeLibraryManager::loadLibrary(const std::string& name, const std::string& basePath, const CustomNodeLibraryExecutionConfig& executionConfig) {
     if (FileSystem::isPathEscaped(basePath)) {
         SPDLOG_LOGGER_ERROR(modelmanager_logger, "Path {} escape with .. is forbidden.", basePath);
         return StatusCode::PATH_INVALID;
@@ -33,6 +40,14 @@ Status CustomNodeLibraryManager::loadLibrary(const std::string& name, const std:
 
     auto it = libraries.find(name);
     if (it != libraries.end() && it->second.basePath == basePath) {
+        if (executionConfigs[name] != executionConfig) {
+            SPDLOG_LOGGER_INFO(modelmanager_logger, "Custom node library name: {} execution settings changed; max_concurrency: {}; worker_threads: {}",
+                name, executionConfig.maxConcurrency, executionConfig.workerThreads);
+            // executions already started keep old executor alive until they finish
+            it->second.executor = createExecutor(executionConfig);
+            executionConfigs[name] = executionConfig;
+            return StatusCode::OK;
+        }
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Custom node library name: {} is already loaded", name);
         return StatusCode::NODE_LIBRARY_ALREADY_LOADED;
     }
@@ -78,12 +93,42 @@ Status CustomNodeLibraryManager::loadLibrary(const std::string& name, const std:
         return StatusCode::NODE_LIBRARY_LOAD_FAILED_SYM;
     }
 
+    // executeWithAllocator is optional, libraries exporting only execute keep working
+    execute_with_allocator_fn executeWithAllocator = reinterpret_cast<execute_with_allocator_fn>(dlsym(handle, "executeWithAllocator"));
+    dlerror();
+    if (executeWithAllocator) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Custom node library name: {} uses server provided output allocator", name);
+    }
+
+    // initialize and deinitialize are optional but have to be exported together
+    initialize_fn initialize = reinterpret_cast<initialize_fn>(dlsym(handle, "initialize"));
+    dlerror();
+    deinitialize_fn deinitialize = reinterpret_cast<deinitialize_fn>(dlsym(handle, "deinitialize"));
+    dlerror();
+    if ((initialize == nullptr) != (deinitialize == nullptr)) {
+        SPDLOG_LOGGER_ERROR(modelmanager_logger, "Failed to load library name: {}; initialize and deinitialize have to be exported together", name);
+        dlclose(handle);
+        return StatusCode::NODE_LIBRARY_LOAD_FAILED_SYM;
+    }
+
+    execute_batch_fn executeBatch = reinterpret_cast<execute_batch_fn>(dlsym(handle, "executeBatch"));
+    dlerror();
+    if (executeBatch) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Custom node library name: {} executes ready node sessions in batches", name);
+    }
+
     libraries[name] = NodeLibrary{
         execute,
         getInputsInfo,
         getOutputsInfo,
         release,
-        basePath};
+        basePath,
+        executeWithAllocator,
+        initialize,
+        deinitialize,
+        executeBatch,
+        createExecutor(executionConfig)};
+    executionConfigs[name] = executionConfig;
 
     SPDLOG_LOGGER_INFO(modelmanager_logger, "Successfully loaded custom node library name: {}; base_path: {}", name, basePath);
     return StatusCode::OK;
@@ -111,6 +156,7 @@ void CustomNodeLibraryManager::unloadLibrariesRemovedFromConfig(const std::set<s
         std::inserter(librariesToUnload, librariesToUnload.end()));
     for (auto& library : librariesToUnload) {
         libraries.erase(library);
+        executionConfigs.erase(library);
     }
 }
 
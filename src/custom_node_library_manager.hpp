@@ -19,6 +19,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "custom_node_executor.hpp"
 #include "node_library.hpp"
 #include "status.hpp"
 
@@ -26,9 +27,13 @@ namespace ovms {
 
 class CustomNodeLibraryManager {
     std::unordered_map<std::string, NodeLibrary> libraries;
+    std::unordered_map<std::string, CustomNodeLibraryExecutionConfig> executionConfigs;
 
 public:
-    Status loadLibrary(const std::string& name, const std::string& basePath);
+    /**
+     * @brief Loads library, or only replaces its executor when library is loaded with different execution config
+     */
+    Status loadLibrary(const std::string& name, const std::string& basePath, const CustomNodeLibraryExecutionConfig& executionConfig = {});
     Status getLibrary(const std::string& name, NodeLibrary& library) const;
     void unloadLibrariesRemovedFromConfig(const std::set<std::string>& librariesInConfig);
 };
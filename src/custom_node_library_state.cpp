@@ -0,0 +1,46 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "custom_node_library_state.hpp"
+
+#include "logging.hpp"
+#include "node_library_utils.hpp"
+
+namespace ovms {
+
+CustomNodeLibraryState::~CustomNodeLibraryState() {
+    int result = library.deinitialize(state);
+    if (result != 0) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Custom node library deinitialize failed with code: {}", result);
+    }
+}
+
+Status CustomNodeLibraryState::create(const NodeLibrary& library, const std::unordered_map<std::string, std::string>& parameters, std::shared_ptr<CustomNodeLibraryState>& result) {
+    result.reset();
+    if (library.initialize == nullptr) {
+        return StatusCode::OK;
+    }
+    auto libraryParameters = createCustomNodeParamArray(parameters);
+    void* state = nullptr;
+    int initializeResult = library.initialize(&state, libraryParameters.get(), parameters.size());
+    if (initializeResult != 0) {
+        SPDLOG_LOGGER_ERROR(modelmanager_logger, "Custom node library initialize failed with code: {}", initializeResult);
+        return StatusCode::NODE_LIBRARY_INITIALIZE_FAILED;
+    }
+    result = std::shared_ptr<CustomNodeLibraryState>(new CustomNodeLibraryState(library, state));
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "node_library.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief State of custom node created with library initialize and destroyed with deinitialize
+ *
+ * Shared by pipeline definition and custom nodes of pipelines created from it, so that state outlives
+ * executions started before definition reload.
+ */
+class CustomNodeLibraryState {
+    const NodeLibrary library;
+    void* state = nullptr;
+
+    CustomNodeLibraryState(const NodeLibrary& library, void* state) :
+        library(library),
+        state(state) {}
+
+public:
+    CustomNodeLibraryState(const CustomNodeLibraryState&) = delete;
+    CustomNodeLibraryState& operator=(const CustomNodeLibraryState&) = delete;
+    ~CustomNodeLibraryState();
+
+    /**
+     * @brief Initializes state of custom node, leaves result empty when library does not export initialize
+     *
+     * @param library
+     * @param parameters node parameters passed to initialize
+     * @param result
+     * @return Status
+     */
+    static Status create(const NodeLibrary& library, const std::unordered_map<std::string, std::string>& parameters, std::shared_ptr<CustomNodeLibraryState>& result);
+
+    void* get() const {
+        return state;
+    }
+};
+
+}  // namespace ovms
@@ -0,0 +1,70 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "custom_node_server_allocator.hpp"
+
+#include <new>
+
+#include "blob_arena.hpp"
+
+namespace ovms {
+
+CustomNodeServerAllocator::CustomNodeServerAllocator(std::shared_ptr<InferenceEngine::IAllocator> arena) :
+    arena(arena ? std::move(arena) : std::make_shared<BlobArena>(DEFAULT_ARENA_BLOCK_SIZE)) {}
+
+void* CustomNodeServerAllocator::allocate(void* context, uint64_t bytes) {
+    auto* allocator = static_cast<CustomNodeServerAllocator*>(context);
+    void* ptr = allocator->arena->alloc(bytes);
+    if (ptr != nullptr) {
+        try {
+            allocator->allocations.insert(ptr);
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }
+    return ptr;
+}
+
+void CustomNodeServerAllocator::addInput(const struct CustomNodeTensor& tensor, InferenceEngine::Blob::Ptr blob) {
+    inputs.push_back({tensor.data, tensor.dataBytes, tensor.dims, std::move(blob)});
+}
+
+const InferenceEngine::Blob::Ptr* CustomNodeServerAllocator::findInput(const void* data, uint64_t dataBytes) const {
+    const auto* begin = static_cast<const uint8_t*>(data);
+    for (const auto& input : inputs) {
+        if (input.data == nullptr || begin < input.data || begin > input.data + input.dataBytes) {
+            continue;
+        }
+        if (dataBytes <= static_cast<uint64_t>(input.data + input.dataBytes - begin)) {
+            return &input.blob;
+        }
+    }
+    return nullptr;
+}
+
+bool CustomNodeServerAllocator::borrows(const void* ptr) const {
+    const auto* address = static_cast<const uint8_t*>(ptr);
+    for (const auto& input : inputs) {
+        if (ptr == input.dims) {
+            return true;
+        }
+        if (input.data != nullptr && address >= input.data && address < input.data + input.dataBytes) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace ovms
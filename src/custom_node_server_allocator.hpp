@@ -0,0 +1,119 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#include "custom_node_interface.h"  // NOLINT
+#include "node_library.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Serves allocations of custom node library outputs passed to executeWithAllocator
+ *
+ * Memory comes from pipeline blob arena, or from own arena when node has none, and tracks served pointers
+ * so that they are not released by the library. It also knows input tensors passed to the library,
+ * so that outputs pointing into input data are recognized as aliases instead of library allocations.
+ */
+class CustomNodeServerAllocator {
+    struct InputRegion {
+        const uint8_t* data;
+        uint64_t dataBytes;
+        const uint64_t* dims;
+        InferenceEngine::Blob::Ptr blob;
+    };
+
+    std::shared_ptr<InferenceEngine::IAllocator> arena;
+    std::unordered_set<const void*> allocations;
+    std::vector<InputRegion> inputs;
+
+    static void* allocate(void* context, uint64_t bytes);
+
+public:
+    static constexpr size_t DEFAULT_ARENA_BLOCK_SIZE = 64 * 1024;
+
+    explicit CustomNodeServerAllocator(std::shared_ptr<InferenceEngine::IAllocator> arena);
+
+    struct CustomNodeAllocator getInterface() {
+        return {CustomNodeServerAllocator::allocate, this};
+    }
+
+    bool owns(const void* ptr) const {
+        return allocations.count(ptr) > 0;
+    }
+
+    /**
+     * @brief Registers input tensor passed to the library together with blob holding its data
+     */
+    void addInput(const struct CustomNodeTensor& tensor, InferenceEngine::Blob::Ptr blob);
+
+    /**
+     * @brief Finds input blob whose data contains whole region, nullptr if region is not part of any input
+     */
+    const InferenceEngine::Blob::Ptr* findInput(const void* data, uint64_t dataBytes) const;
+
+    /**
+     * @brief Checks if pointer belongs to input data or dims, such memory is never released by the library
+     */
+    bool borrows(const void* ptr) const;
+
+    /**
+     * @brief Releases memory with library unless it was served by this allocator or belongs to inputs
+     */
+    int release(const NodeLibrary& library, void* ptr) const {
+        return (owns(ptr) || borrows(ptr)) ? 0 : library.release(ptr);
+    }
+
+    const std::shared_ptr<InferenceEngine::IAllocator>& getArena() const {
+        return arena;
+    }
+};
+
+/**
+ * @brief Exposes output data served by CustomNodeServerAllocator, keeps its arena alive for the lifetime of blob
+ */
+class CustomNodeServerOutputAllocator : public InferenceEngine::IAllocator {
+    std::shared_ptr<InferenceEngine::IAllocator> arena;
+    void* data;
+
+public:
+    CustomNodeServerOutputAllocator(std::shared_ptr<InferenceEngine::IAllocator> arena, void* data) :
+        arena(std::move(arena)),
+        data(data) {}
+
+    void* lock(void* handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void* a) noexcept override {}
+
+    void* alloc(size_t size) noexcept override {
+        return data;
+    }
+
+    bool free(void* handle) noexcept override {
+        return true;
+    }
+};
+
+}  // namespace ovms
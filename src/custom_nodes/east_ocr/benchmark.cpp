@@ -0,0 +1,151 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+// Micro-benchmark comparing serial and parallel processing of detected text boxes for typical box counts.
+// Build inside custom node build image:
+// g++ -O3 -std=c++17 -pthread benchmark.cpp east_ocr.cpp -I/opencv/include/ -L/opencv/lib/ -lopencv_core -lopencv_imgproc -o benchmark
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../custom_node_interface.h"
+
+static constexpr int IMAGE_HEIGHT = 1024;
+static constexpr int IMAGE_WIDTH = 1024;
+static constexpr int CELLS_HEIGHT = IMAGE_HEIGHT / 4;
+static constexpr int CELLS_WIDTH = IMAGE_WIDTH / 4;
+// boxes of 48x16 pixels are laid out every 64x32 pixels, so none of them is removed by non max suppression
+static constexpr int BOX_SPACING_X = 16;
+static constexpr int BOX_SPACING_Y = 8;
+
+struct Inputs {
+    std::vector<float> image;
+    std::vector<float> scores;
+    std::vector<float> geometry;
+};
+
+static Inputs createInputs(int boxes, float angle) {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.0f, 255.0f);
+    Inputs inputs;
+    inputs.image.resize(IMAGE_HEIGHT * IMAGE_WIDTH * 3);
+    std::generate(inputs.image.begin(), inputs.image.end(), [&]() { return distribution(generator); });
+    inputs.scores.assign(CELLS_HEIGHT * CELLS_WIDTH, 0.0f);
+    inputs.geometry.assign(5 * CELLS_HEIGHT * CELLS_WIDTH, 0.0f);
+    const int boxesInRow = CELLS_WIDTH / BOX_SPACING_X;
+    for (int i = 0; i < boxes; ++i) {
+        const int x = BOX_SPACING_X / 2 + (i % boxesInRow) * BOX_SPACING_X;
+        const int y = BOX_SPACING_Y / 2 + (i / boxesInRow) * BOX_SPACING_Y;
+        const int cell = y * CELLS_WIDTH + x;
+        inputs.scores[cell] = 0.9f;
+        // distances to top, right, bottom and left edge of the box, then its angle
+        inputs.geometry[0 * CELLS_HEIGHT * CELLS_WIDTH + cell] = 8;
+        inputs.geometry[1 * CELLS_HEIGHT * CELLS_WIDTH + cell] = 24;
+        inputs.geometry[2 * CELLS_HEIGHT * CELLS_WIDTH + cell] = 8;
+        inputs.geometry[3 * CELLS_HEIGHT * CELLS_WIDTH + cell] = 24;
+        inputs.geometry[4 * CELLS_HEIGHT * CELLS_WIDTH + cell] = angle;
+    }
+    return inputs;
+}
+
+static bool run(Inputs& inputs, const std::vector<CustomNodeParam>& params, int iterations, double& averageMs, std::vector<float>& result) {
+    uint64_t imageDims[4] = {1, IMAGE_HEIGHT, IMAGE_WIDTH, 3};
+    uint64_t scoresDims[4] = {1, 1, CELLS_HEIGHT, CELLS_WIDTH};
+    uint64_t geometryDims[4] = {1, 5, CELLS_HEIGHT, CELLS_WIDTH};
+    CustomNodeTensor tensors[3] = {
+        {"image", (uint8_t*)inputs.image.data(), inputs.image.size() * sizeof(float), imageDims, 4, FP32},
+        {"scores", (uint8_t*)inputs.scores.data(), inputs.scores.size() * sizeof(float), scoresDims, 4, FP32},
+        {"geometry", (uint8_t*)inputs.geometry.data(), inputs.geometry.size() * sizeof(float), geometryDims, 4, FP32}};
+
+    void* state = nullptr;
+    if (initialize(&state, params.data(), params.size()) != 0) {
+        return false;
+    }
+    double totalMs = 0;
+    bool success = true;
+    for (int i = 0; i < iterations && success; ++i) {
+        CustomNodeTensor* outputs = nullptr;
+        int outputsCount = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        int ret = executeWithAllocator(tensors, 3, &outputs, &outputsCount, params.data(), params.size(), nullptr, state);
+        auto end = std::chrono::high_resolution_clock::now();
+        if (ret != 0) {
+            success = false;
+            break;
+        }
+        totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == iterations - 1) {
+            const float* data = (const float*)outputs[0].data;
+            result.assign(data, data + outputs[0].dataBytes / sizeof(float));
+        }
+        for (int j = 0; j < outputsCount; ++j) {
+            release(outputs[j].data);
+            release(outputs[j].dims);
+        }
+        release(outputs);
+    }
+    deinitialize(state);
+    averageMs = totalMs / iterations;
+    return success;
+}
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::stoi(argv[1]) : 20;
+    const std::string threads = argc > 2 ? argv[2] : "0";
+    const std::vector<int> boxCounts{10, 50, 100, 200, 500};
+    std::cout << std::setw(8) << "boxes" << std::setw(8) << "angle"
+              << std::setw(14) << "serial [ms]" << std::setw(16) << "parallel [ms]" << std::setw(10) << "speedup" << std::endl;
+    for (int boxes : boxCounts) {
+        // 0.5 radian exceeds rotation angle threshold, so boxes are rotated as well
+        for (float angle : {0.0f, 0.5f}) {
+            Inputs inputs = createInputs(boxes, angle);
+            const std::string maxOutputBatch = std::to_string(boxes);
+            std::vector<CustomNodeParam> params{
+                {"original_image_width", "1024"},
+                {"original_image_height", "1024"},
+                {"original_image_layout", "NHWC"},
+                {"target_image_width", "128"},
+                {"target_image_height", "32"},
+                {"target_image_layout", "NCHW"},
+                {"convert_to_gray_scale", "true"},
+                {"confidence_threshold", "0.5"},
+                {"max_output_batch", maxOutputBatch.c_str()},
+                {"processing_threads", "1"},
+            };
+            double serialMs = 0, parallelMs = 0;
+            std::vector<float> serialResult, parallelResult;
+            if (!run(inputs, params, iterations, serialMs, serialResult)) {
+                std::cout << "execution failed" << std::endl;
+                return 1;
+            }
+            const std::string parallelThreads = threads == "0" ? std::to_string(std::thread::hardware_concurrency()) : threads;
+            params.back().value = parallelThreads.c_str();
+            if (!run(inputs, params, iterations, parallelMs, parallelResult) || serialResult != parallelResult) {
+                std::cout << "execution failed or results differ" << std::endl;
+                return 1;
+            }
+            std::cout << std::setw(8) << boxes << std::setw(8) << angle
+                      << std::setw(14) << std::fixed << std::setprecision(3) << serialMs << std::setw(16) << parallelMs
+                      << std::setw(10) << std::setprecision(2) << serialMs / parallelMs << std::defaultfloat << std::endl;
+        }
+    }
+    return 0;
+}
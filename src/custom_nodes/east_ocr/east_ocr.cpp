@@ -13,13 +13,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <atomic>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "../../custom_node_interface.h"
 #include "nms.hpp"
 #include "opencv2/opencv.hpp"
+#include "thread_pool.hpp"
 #include "utils.hpp"
 
 static constexpr const char* IMAGE_TENSOR_NAME = "image";
@@ -35,7 +39,33 @@ struct BoxMetadata {
     float originalHeight;
 };
 
-bool copy_images_into_output(struct CustomNodeTensor* output, const std::vector<cv::Rect>& boxes, const std::vector<BoxMetadata>& metadata, const cv::Mat& originalImage, int targetImageHeight, int targetImageWidth, const std::string& targetImageLayout, bool convertToGrayScale, int rotationAngleThreshold) {
+bool copy_image_into_slot(float* slot, const cv::Rect& box, const BoxMetadata& metadata, const cv::Mat& originalImage, int targetImageHeight, int targetImageWidth, const std::string& targetImageLayout, bool convertToGrayScale, int rotationAngleThreshold) {
+    cv::Size targetShape(targetImageWidth, targetImageHeight);
+    bool isNhwc = targetImageLayout == "NHWC";
+    cv::Mat image;
+    if (isNhwc && !convertToGrayScale) {
+        // resize writes straight into the slot
+        image = cv::Mat(targetShape, CV_32FC3, slot);
+    }
+    float degree = metadata.angle * (180.0 / M_PI);
+    try {
+        if (!crop_rotate_resize(originalImage, image, box, (abs(degree) > rotationAngleThreshold) ? -degree : 0.0, metadata.originalWidth, metadata.originalHeight, targetShape)) {
+            return false;
+        }
+        if (convertToGrayScale) {
+            cv::Mat grayscaled = cv::Mat(targetShape, CV_32FC1, slot);
+            cv::cvtColor(image, grayscaled, cv::COLOR_BGR2GRAY);
+        } else if (!isNhwc) {
+            reorder_to_nchw_2((float*)image.data, slot, image.rows, image.cols, image.channels());
+        }
+    } catch (const cv::Exception& e) {
+        std::cout << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool copy_images_into_output(struct CustomNodeTensor* output, const std::vector<cv::Rect>& boxes, const std::vector<BoxMetadata>& metadata, const cv::Mat& originalImage, int targetImageHeight, int targetImageWidth, const std::string& targetImageLayout, bool convertToGrayScale, int rotationAngleThreshold, ThreadPool* pool) {
     const uint64_t outputBatch = boxes.size();
     int channels = convertToGrayScale ? 1 : 3;
 
@@ -47,26 +77,26 @@ bool copy_images_into_output(struct CustomNodeTensor* output, const std::vector<
         return false;
     }
 
-    for (uint64_t i = 0; i < outputBatch; i++) {
-        cv::Size targetShape(targetImageWidth, targetImageHeight);
-        cv::Mat image;
-        float degree = metadata[i].angle * (180.0 / M_PI);
-
-        if (!crop_rotate_resize(originalImage, image, boxes[i], (abs(degree) > rotationAngleThreshold) ? -degree : 0.0, metadata[i].originalWidth, metadata[i].originalHeight, targetShape)) {
-            std::cout << "box is outside of original image" << std::endl;
-            free(buffer);
-            return false;
+    // every box is processed independently and written directly into its slot of the output buffer
+    const uint64_t slotSize = channels * targetImageWidth * targetImageHeight;
+    std::atomic<bool> success{true};
+    std::function<void(size_t)> copyBox = [&](size_t i) {
+        if (!copy_image_into_slot(buffer + (i * slotSize), boxes[i], metadata[i], originalImage, targetImageHeight, targetImageWidth, targetImageLayout, convertToGrayScale, rotationAngleThreshold)) {
+            success = false;
         }
-        if (convertToGrayScale) {
-            image = apply_grayscale(image);
-        }
-        if (targetImageLayout == "NCHW") {
-            auto imgBuffer = reorder_to_nchw((float*)image.data, image.rows, image.cols, image.channels());
-            std::memcpy(buffer + (i * channels * targetImageWidth * targetImageHeight), imgBuffer.data(), byteSize / outputBatch);
-        } else {
-            std::memcpy(buffer + (i * channels * targetImageWidth * targetImageHeight), image.data, byteSize / outputBatch);
+    };
+    if (pool != nullptr) {
+        pool->parallel_for(outputBatch, copyBox);
+    } else {
+        for (uint64_t i = 0; i < outputBatch; i++) {
+            copyBox(i);
         }
     }
+    if (!success) {
+        std::cout << "box is outside of original image" << std::endl;
+        free(buffer);
+        return false;
+    }
 
     output->data = reinterpret_cast<uint8_t*>(buffer);
     output->dataBytes = byteSize;
@@ -140,7 +170,7 @@ void cleanup(CustomNodeTensor& tensor) {
     free(tensor.dims);
 }
 
-int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount) {
+static int execute_with_pool(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount, ThreadPool* pool) {
     // Parameters reading
     int originalImageHeight = get_int_parameter("original_image_height", params, paramsCount, -1);
     int originalImageWidth = get_int_parameter("original_image_width", params, paramsCount, -1);
@@ -170,6 +200,8 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     NODE_ASSERT(boxHeightAdjustment >= 0.0, "box height adjustment must be positive");
     int rotationAngleThreshold = get_int_parameter("rotation_angle_threshold", params, paramsCount, 20);
     NODE_ASSERT(rotationAngleThreshold >= 0, "rotation angle threshold must be positive");
+    std::string nmsImplementation = get_string_parameter("nms_implementation", params, paramsCount, "grid");
+    NODE_ASSERT(nmsImplementation == "grid" || nmsImplementation == "classic", "nms implementation must be grid or classic");
 
     const CustomNodeTensor* imageTensor = nullptr;
     const CustomNodeTensor* scoresTensor = nullptr;
@@ -240,6 +272,9 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     std::vector<float> scores;
     std::vector<BoxMetadata> metadata;
 
+    // Columns of cells in current row with sufficient probability
+    std::vector<int> candidates(numCols);
+
     // Extract the scores (probabilities), followed by the geometrical data used to derive potential bounding box coordinates that surround text
     for (int y = 0; y < numRows; y++) {
         float* scoresData = (float*)scoresTensor->data + (y * numCols);
@@ -249,12 +284,17 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
         float* xData3 = (float*)geometryTensor->data + ((3 * numRows * numCols) + (y * numCols));
         float* anglesData = (float*)geometryTensor->data + ((4 * numRows * numCols) + (y * numCols));
 
+        // If our score does not have sufficient probability, ignore it.
+        // Threshold pass is branch free, so only selected cells are decoded below.
+        int candidatesCount = 0;
         for (int x = 0; x < numCols; x++) {
+            candidates[candidatesCount] = x;
+            candidatesCount += !(scoresData[x] < confidenceThreshold);
+        }
+
+        for (int i = 0; i < candidatesCount; i++) {
+            int x = candidates[i];
             float score = scoresData[x];
-            // If our score does not have sufficient probability, ignore it
-            if (score < confidenceThreshold) {
-                continue;
-            }
 
             if (debugMode)
                 std::cout << "Found confidence: " << scoresData[x] << std::endl;
@@ -326,7 +366,11 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     std::vector<cv::Rect> filteredBoxes;
     std::vector<float> filteredScores;
     std::vector<BoxMetadata> filteredMetadata;
-    nms2(rects, scores, metadata, filteredBoxes, filteredScores, filteredMetadata, overlapThreshold);
+    if (nmsImplementation == "grid") {
+        nms2_grid(rects, scores, metadata, filteredBoxes, filteredScores, filteredMetadata, overlapThreshold);
+    } else {
+        nms2(rects, scores, metadata, filteredBoxes, filteredScores, filteredMetadata, overlapThreshold);
+    }
     NODE_ASSERT(filteredBoxes.size() == filteredScores.size(), "filtered boxes and scores are not equal length");
     if (filteredBoxes.size() > maxOutputBatch) {
         filteredBoxes.resize(maxOutputBatch);
@@ -343,7 +387,7 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     NODE_ASSERT((*outputs) != nullptr, "malloc has failed");
     CustomNodeTensor& textImagesTensor = (*outputs)[0];
     textImagesTensor.name = TEXT_IMAGES_TENSOR_NAME;
-    if (!copy_images_into_output(&textImagesTensor, filteredBoxes, filteredMetadata, image, targetImageHeight, targetImageWidth, targetImageLayout, convertToGrayScale, rotationAngleThreshold)) {
+    if (!copy_images_into_output(&textImagesTensor, filteredBoxes, filteredMetadata, image, targetImageHeight, targetImageWidth, targetImageLayout, convertToGrayScale, rotationAngleThreshold, pool)) {
         free(*outputs);
         return 1;
     }
@@ -368,6 +412,27 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     return 0;
 }
 
+int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount) {
+    return execute_with_pool(inputs, inputsCount, outputs, outputsCount, params, paramsCount, nullptr);
+}
+
+int executeWithAllocator(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount, const struct CustomNodeAllocator* allocator, void* state) {
+    // outputs are allocated with malloc and released by release
+    return execute_with_pool(inputs, inputsCount, outputs, outputsCount, params, paramsCount, static_cast<ThreadPool*>(state));
+}
+
+int initialize(void** state, const struct CustomNodeParam* params, int paramsCount) {
+    int processingThreads = get_int_parameter("processing_threads", params, paramsCount, std::thread::hardware_concurrency());
+    NODE_ASSERT(processingThreads >= 0, "processing threads must not be negative");
+    *state = new ThreadPool(processingThreads);
+    return 0;
+}
+
+int deinitialize(void* state) {
+    delete static_cast<ThreadPool*>(state);
+    return 0;
+}
+
 int getInputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const struct CustomNodeParam* params, int paramsCount) {
     int originalImageHeight = get_int_parameter("original_image_height", params, paramsCount, -1);
     int originalImageWidth = get_int_parameter("original_image_width", params, paramsCount, -1);
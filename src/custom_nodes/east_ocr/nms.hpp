@@ -23,7 +23,13 @@
 //*****************************************************************************
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -158,6 +164,151 @@ inline void nms2(const std::vector<cv::Rect>& srcRects,
     }
 }
 
+/**
+ * @brief nms2_grid
+ * Non maximum suppression with detection scores producing the same results as nms2.
+ * Boxes are sorted once by score and bucketed into uniform grid, so each selected box
+ * is compared only with boxes sharing grid cells with it instead of all remaining boxes.
+ * @param srcRects
+ * @param scores
+ * @param resRects
+ * @param thresh
+ * @param neighbors
+ */
+template <typename T>
+inline void nms2_grid(const std::vector<cv::Rect>& srcRects,
+    const std::vector<float>& scores,
+    const std::vector<T>& metadata,
+    std::vector<cv::Rect>& resRects,
+    std::vector<float>& resScores,
+    std::vector<T>& resMetadata,
+    float thresh,
+    int neighbors = 0,
+    float minScoresSum = 0.f) {
+    // boxes without common area are suppressed only for negative threshold
+    if (thresh < 0) {
+        nms2(srcRects, scores, metadata, resRects, resScores, resMetadata, thresh, neighbors, minScoresSum);
+        return;
+    }
+    resRects.clear();
+    resScores.clear();
+    resMetadata.clear();
+
+    const size_t size = srcRects.size();
+    if (!size)
+        return;
+
+    assert(srcRects.size() == scores.size());
+    assert(srcRects.size() == metadata.size());
+
+    // Same order as selection in nms2: descending scores, later boxes first for equal scores
+    std::vector<size_t> order(size);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&scores](size_t a, size_t b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a > b);
+    });
+
+    // Grid cell is as large as average box, boxes with empty area never overlap so they are not bucketed
+    int minX = std::numeric_limits<int>::max(), minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min(), maxY = std::numeric_limits<int>::min();
+    double widthSum = 0, heightSum = 0;
+    size_t bucketedCount = 0;
+    for (const auto& rect : srcRects) {
+        if (rect.width <= 0 || rect.height <= 0)
+            continue;
+        minX = std::min(minX, rect.x);
+        minY = std::min(minY, rect.y);
+        maxX = std::max(maxX, rect.x + rect.width - 1);
+        maxY = std::max(maxY, rect.y + rect.height - 1);
+        widthSum += rect.width;
+        heightSum += rect.height;
+        ++bucketedCount;
+    }
+    int cellWidth = 1, cellHeight = 1, gridCols = 0, gridRows = 0;
+    if (bucketedCount > 0) {
+        cellWidth = std::max(1, static_cast<int>(widthSum / bucketedCount));
+        cellHeight = std::max(1, static_cast<int>(heightSum / bucketedCount));
+        const double extentWidth = static_cast<double>(maxX) - minX + 1;
+        const double extentHeight = static_cast<double>(maxY) - minY + 1;
+        // limit number of cells for sparse boxes spread over large area
+        while ((extentWidth / cellWidth) * (extentHeight / cellHeight) > 4.0 * bucketedCount + 16) {
+            cellWidth *= 2;
+            cellHeight *= 2;
+        }
+        gridCols = static_cast<int>((static_cast<int64_t>(maxX) - minX) / cellWidth + 1);
+        gridRows = static_cast<int>((static_cast<int64_t>(maxY) - minY) / cellHeight + 1);
+    }
+    auto cellRange = [&](const cv::Rect& rect, int& col1, int& col2, int& row1, int& row2) {
+        col1 = static_cast<int>((static_cast<int64_t>(rect.x) - minX) / cellWidth);
+        col2 = static_cast<int>((static_cast<int64_t>(rect.x) + rect.width - 1 - minX) / cellWidth);
+        row1 = static_cast<int>((static_cast<int64_t>(rect.y) - minY) / cellHeight);
+        row2 = static_cast<int>((static_cast<int64_t>(rect.y) + rect.height - 1 - minY) / cellHeight);
+    };
+
+    // cells keep ranks of boxes in selection order
+    std::vector<std::vector<size_t>> cells(static_cast<size_t>(gridCols) * gridRows);
+    for (size_t rank = 0; rank < size; ++rank) {
+        const cv::Rect& rect = srcRects[order[rank]];
+        if (rect.width <= 0 || rect.height <= 0)
+            continue;
+        int col1, col2, row1, row2;
+        cellRange(rect, col1, col2, row1, row2);
+        for (int row = row1; row <= row2; ++row) {
+            for (int col = col1; col <= col2; ++col) {
+                cells[static_cast<size_t>(row) * gridCols + col].push_back(rank);
+            }
+        }
+    }
+
+    std::vector<bool> removed(size, false);
+    std::vector<size_t> suppressed;
+    for (size_t rank = 0; rank < size; ++rank) {
+        if (removed[rank])
+            continue;
+        removed[rank] = true;
+        const size_t index = order[rank];
+        const cv::Rect& rect1 = srcRects[index];
+
+        suppressed.clear();
+        if (rect1.width > 0 && rect1.height > 0) {
+            int col1, col2, row1, row2;
+            cellRange(rect1, col1, col2, row1, row2);
+            for (int row = row1; row <= row2; ++row) {
+                for (int col = col1; col <= col2; ++col) {
+                    const auto& cell = cells[static_cast<size_t>(row) * gridCols + col];
+                    // ranks in cell are increasing, boxes selected before current one are already removed
+                    for (auto it = std::upper_bound(cell.begin(), cell.end(), rank); it != cell.end(); ++it) {
+                        if (removed[*it])
+                            continue;
+                        const cv::Rect& rect2 = srcRects[order[*it]];
+
+                        float intArea = static_cast<float>((rect1 & rect2).area());
+                        float unionArea = rect1.area() + rect2.area() - intArea;
+                        float overlap = intArea / unionArea;
+
+                        // if there is sufficient overlap, suppress the current bounding box
+                        if (overlap > thresh) {
+                            removed[*it] = true;
+                            suppressed.push_back(*it);
+                        }
+                    }
+                }
+            }
+        }
+        // nms2 accumulates suppressed scores in ascending order
+        std::sort(suppressed.begin(), suppressed.end(), std::greater<size_t>());
+        float scoresSum = scores[index];
+        for (size_t suppressedRank : suppressed) {
+            scoresSum += scores[order[suppressedRank]];
+        }
+        if (static_cast<int>(suppressed.size()) >= neighbors && scoresSum >= minScoresSum) {
+            resRects.push_back(rect1);
+            resScores.push_back(scores[index]);
+            resMetadata.push_back(metadata[index]);
+        }
+    }
+}
+
 ///
 enum class Methods {
     ClassicNMS,
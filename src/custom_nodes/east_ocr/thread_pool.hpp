@@ -0,0 +1,123 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads executing parallel loops of concurrent node executions.
+// Thread calling parallel_for processes indices of its own loop as well, so loops never wait for idle workers.
+class ThreadPool {
+    struct Job {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> finished{0};
+    };
+
+    std::mutex mtx;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobFinished;
+    std::deque<std::shared_ptr<Job>> jobs;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    void run(Job& job) {
+        size_t processed = 0;
+        for (size_t index = job.next++; index < job.count; index = job.next++) {
+            (*job.task)(index);
+            processed++;
+        }
+        if (processed > 0 && job.finished.fetch_add(processed) + processed == job.count) {
+            std::lock_guard<std::mutex> lock(mtx);
+            jobFinished.notify_all();
+        }
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            std::shared_ptr<Job> job = jobs.front();
+            if (job->next >= job->count) {
+                jobs.pop_front();
+                continue;
+            }
+            lock.unlock();
+            run(*job);
+            lock.lock();
+        }
+    }
+
+public:
+    // threads includes the calling thread, 1 or less means loops run serially
+    explicit ThreadPool(size_t threads) {
+        for (size_t i = 1; i < threads; i++) {
+            workers.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    size_t size() const {
+        return workers.size() + 1;
+    }
+
+    void parallel_for(size_t count, const std::function<void(size_t)>& task) {
+        if (workers.empty() || count <= 1) {
+            for (size_t i = 0; i < count; i++) {
+                task(i);
+            }
+            return;
+        }
+        auto job = std::make_shared<Job>();
+        job->task = &task;
+        job->count = count;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            jobs.push_back(job);
+        }
+        jobAvailable.notify_all();
+        run(*job);
+        std::unique_lock<std::mutex> lock(mtx);
+        jobFinished.wait(lock, [&job]() { return job->finished == job->count; });
+        // workers may still hold the job, but they no longer call the task since all indices are taken
+        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            if (*it == job) {
+                jobs.erase(it);
+                break;
+            }
+        }
+    }
+};
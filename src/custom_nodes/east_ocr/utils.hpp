@@ -43,15 +43,20 @@ std::vector<T> reorder_to_nhwc(const T* nchwVector, int rows, int cols, int chan
 }
 
 template <typename T>
-std::vector<T> reorder_to_nchw(const T* nhwcVector, int rows, int cols, int channels) {
-    std::vector<T> nchwVector(rows * cols * channels);
+void reorder_to_nchw_2(const T* sourceNhwcBuffer, T* destNchwBuffer, int rows, int cols, int channels) {
     for (int y = 0; y < rows; ++y) {
         for (int x = 0; x < cols; ++x) {
             for (int c = 0; c < channels; ++c) {
-                nchwVector[c * (rows * cols) + y * cols + x] = reinterpret_cast<const T*>(nhwcVector)[y * channels * cols + x * channels + c];
+                destNchwBuffer[c * (rows * cols) + y * cols + x] = reinterpret_cast<const T*>(sourceNhwcBuffer)[y * channels * cols + x * channels + c];
             }
         }
     }
+}
+
+template <typename T>
+std::vector<T> reorder_to_nchw(const T* nhwcVector, int rows, int cols, int channels) {
+    std::vector<T> nchwVector(rows * cols * channels);
+    reorder_to_nchw_2(nhwcVector, nchwVector.data(), rows, cols, channels);
     return nchwVector;
 }
 
@@ -0,0 +1,128 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+// Micro-benchmark comparing fused transformation with OpenCV based processing for common resolutions.
+// Build inside custom node build image:
+// g++ -O3 -std=c++17 benchmark.cpp image_transformation.cpp -I/opencv/include/ -L/opencv/lib/ -lopencv_core -lopencv_imgproc -o benchmark
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../custom_node_interface.h"
+
+struct BenchmarkCase {
+    uint64_t originalHeight;
+    uint64_t originalWidth;
+    int targetHeight;
+    int targetWidth;
+    std::string originalLayout;
+    std::string targetLayout;
+    std::string targetColorOrder;
+};
+
+static bool run(const BenchmarkCase& benchmarkCase, const std::vector<float>& image, bool fused, int iterations, double& averageMs, std::vector<float>& result) {
+    const std::string height = std::to_string(benchmarkCase.targetHeight);
+    const std::string width = std::to_string(benchmarkCase.targetWidth);
+    const std::string fusedValue = fused ? "true" : "false";
+    std::vector<CustomNodeParam> params{
+        {"target_image_height", height.c_str()},
+        {"target_image_width", width.c_str()},
+        {"original_image_color_order", "BGR"},
+        {"target_image_color_order", benchmarkCase.targetColorOrder.c_str()},
+        {"original_image_layout", benchmarkCase.originalLayout.c_str()},
+        {"target_image_layout", benchmarkCase.targetLayout.c_str()},
+        {"mean_values", benchmarkCase.targetColorOrder == "GRAY" ? "[127.5]" : "[123.675,116.28,103.53]"},
+        {"scale_values", benchmarkCase.targetColorOrder == "GRAY" ? "[127.5]" : "[58.395,57.12,57.375]"},
+        {"fused_transformation", fusedValue.c_str()},
+    };
+    uint64_t dims[4] = {1, benchmarkCase.originalHeight, benchmarkCase.originalWidth, 3};
+    if (benchmarkCase.originalLayout == "NCHW") {
+        dims[1] = 3;
+        dims[2] = benchmarkCase.originalHeight;
+        dims[3] = benchmarkCase.originalWidth;
+    }
+    CustomNodeTensor input;
+    input.name = "image";
+    input.data = (uint8_t*)image.data();
+    input.dataBytes = image.size() * sizeof(float);
+    input.dims = dims;
+    input.dimsCount = 4;
+    input.precision = FP32;
+
+    double totalMs = 0;
+    for (int i = 0; i < iterations; ++i) {
+        CustomNodeTensor* outputs = nullptr;
+        int outputsCount = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        int ret = execute(&input, 1, &outputs, &outputsCount, params.data(), params.size());
+        auto end = std::chrono::high_resolution_clock::now();
+        if (ret != 0) {
+            return false;
+        }
+        totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == iterations - 1) {
+            const float* data = (const float*)outputs[0].data;
+            result.assign(data, data + outputs[0].dataBytes / sizeof(float));
+        }
+        release(outputs[0].data);
+        release(outputs[0].dims);
+        release(outputs);
+    }
+    averageMs = totalMs / iterations;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::stoi(argv[1]) : 100;
+    const std::vector<BenchmarkCase> cases{
+        {480, 640, 224, 224, "NHWC", "NHWC", "BGR"},
+        {480, 640, 224, 224, "NHWC", "NCHW", "RGB"},
+        {720, 1280, 416, 416, "NHWC", "NCHW", "RGB"},
+        {1080, 1920, 640, 640, "NHWC", "NCHW", "BGR"},
+        {1080, 1920, 384, 672, "NCHW", "NCHW", "BGR"},
+        {224, 224, 448, 448, "NHWC", "NCHW", "GRAY"},
+    };
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.0f, 255.0f);
+    std::cout << std::setw(15) << "input" << std::setw(15) << "output" << std::setw(8) << "color"
+              << std::setw(14) << "opencv [ms]" << std::setw(13) << "fused [ms]" << std::setw(10) << "speedup" << std::setw(14) << "max diff" << std::endl;
+    for (const auto& benchmarkCase : cases) {
+        std::vector<float> image(benchmarkCase.originalHeight * benchmarkCase.originalWidth * 3);
+        std::generate(image.begin(), image.end(), [&]() { return distribution(generator); });
+        double opencvMs = 0, fusedMs = 0;
+        std::vector<float> opencvResult, fusedResult;
+        if (!run(benchmarkCase, image, false, iterations, opencvMs, opencvResult) ||
+            !run(benchmarkCase, image, true, iterations, fusedMs, fusedResult) ||
+            opencvResult.size() != fusedResult.size()) {
+            std::cout << "execution failed" << std::endl;
+            return 1;
+        }
+        float maxDiff = 0;
+        for (size_t i = 0; i < fusedResult.size(); ++i) {
+            maxDiff = std::max(maxDiff, std::abs(fusedResult[i] - opencvResult[i]));
+        }
+        std::cout << std::setw(15) << (std::to_string(benchmarkCase.originalWidth) + "x" + std::to_string(benchmarkCase.originalHeight) + " " + benchmarkCase.originalLayout)
+                  << std::setw(15) << (std::to_string(benchmarkCase.targetWidth) + "x" + std::to_string(benchmarkCase.targetHeight) + " " + benchmarkCase.targetLayout)
+                  << std::setw(8) << benchmarkCase.targetColorOrder
+                  << std::setw(14) << std::fixed << std::setprecision(3) << opencvMs << std::setw(13) << fusedMs
+                  << std::setw(10) << std::setprecision(2) << opencvMs / fusedMs << std::setw(14) << std::scientific << maxDiff << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Single pass alternative to cv::Mat based processing.
+// Color conversion, bilinear resize, mean/scale normalization and layout change are applied per output row,
+// so input is read once and results are written directly into output buffer without full size temporaries.
+// Resize follows cv::resize INTER_LINEAR coordinate mapping and border handling.
+// Inner loops work on contiguous planar rows so that compiler can vectorize them.
+
+struct LinearResizeTable {
+    std::vector<int> first;
+    std::vector<int> second;
+    std::vector<float> alpha;
+};
+
+LinearResizeTable make_linear_resize_table(int sourceSize, int targetSize) {
+    LinearResizeTable table;
+    table.first.resize(targetSize);
+    table.second.resize(targetSize);
+    table.alpha.resize(targetSize);
+    const double ratio = static_cast<double>(sourceSize) / targetSize;
+    for (int i = 0; i < targetSize; ++i) {
+        float position = static_cast<float>((i + 0.5) * ratio - 0.5);
+        int index = static_cast<int>(std::floor(position));
+        float alpha = position - index;
+        if (index < 0) {
+            index = 0;
+            alpha = 0;
+        }
+        if (index >= sourceSize - 1) {
+            index = sourceSize - 1;
+            alpha = 0;
+        }
+        table.first[i] = index;
+        table.second[i] = std::min(index + 1, sourceSize - 1);
+        table.alpha[i] = alpha;
+    }
+    return table;
+}
+
+// Output channel is weighted sum of input channels, weights follow cv::cvtColor conversion codes.
+struct ColorConversion {
+    int inputChannels = 0;
+    int outputChannels = 0;
+    float weights[3][3] = {};
+};
+
+bool make_color_conversion(const std::string& originalColorOrder, const std::string& targetColorOrder, ColorConversion& conversion) {
+    conversion = ColorConversion{};
+    conversion.inputChannels = originalColorOrder == "GRAY" ? 1 : 3;
+    conversion.outputChannels = targetColorOrder == "GRAY" ? 1 : 3;
+    if (originalColorOrder == targetColorOrder) {
+        for (int c = 0; c < conversion.outputChannels; ++c) {
+            conversion.weights[c][c] = 1.0f;
+        }
+        return true;
+    }
+    if (originalColorOrder == "GRAY") {
+        for (int c = 0; c < 3; ++c) {
+            conversion.weights[c][0] = 1.0f;
+        }
+        return true;
+    }
+    const float blueWeight = 0.114f, greenWeight = 0.587f, redWeight = 0.299f;
+    const bool isBgr = originalColorOrder == "BGR";
+    if (targetColorOrder == "GRAY") {
+        conversion.weights[0][0] = isBgr ? blueWeight : redWeight;
+        conversion.weights[0][1] = greenWeight;
+        conversion.weights[0][2] = isBgr ? redWeight : blueWeight;
+        return true;
+    }
+    if ((originalColorOrder == "BGR" && targetColorOrder == "RGB") || (originalColorOrder == "RGB" && targetColorOrder == "BGR")) {
+        conversion.weights[0][2] = 1.0f;
+        conversion.weights[1][1] = 1.0f;
+        conversion.weights[2][0] = 1.0f;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Transforms FP32 image in single pass over output rows
+ *
+ * @param meanValues empty or one value per output channel
+ * @param scaleValues empty or one value per output channel, divisors applied after mean subtraction
+ */
+bool fused_transform(
+    const float* source, bool isSourceNchw, int sourceHeight, int sourceWidth,
+    const ColorConversion& conversion,
+    const std::vector<float>& meanValues,
+    const std::vector<float>& scaleValues,
+    float* target, bool isTargetNchw, int targetHeight, int targetWidth) {
+    const int inputChannels = conversion.inputChannels;
+    const int outputChannels = conversion.outputChannels;
+    if ((meanValues.size() > 0 && meanValues.size() != static_cast<size_t>(outputChannels)) ||
+        (scaleValues.size() > 0 && scaleValues.size() != static_cast<size_t>(outputChannels))) {
+        return false;
+    }
+    const LinearResizeTable columns = make_linear_resize_table(sourceWidth, targetWidth);
+    const LinearResizeTable rows = make_linear_resize_table(sourceHeight, targetHeight);
+
+    // Two horizontally resized source rows are cached, planar per input channel.
+    // When upscaling, consecutive output rows reuse already resized source rows.
+    std::vector<float> cache(2 * inputChannels * targetWidth);
+    int cachedRows[2] = {-1, -1};
+    std::vector<float> blended(inputChannels * targetWidth);
+    std::vector<float> converted(targetWidth);
+
+    const int* first = columns.first.data();
+    const int* second = columns.second.data();
+    const float* alpha = columns.alpha.data();
+    const size_t sourcePlane = static_cast<size_t>(sourceHeight) * sourceWidth;
+    const size_t targetPlane = static_cast<size_t>(targetHeight) * targetWidth;
+
+    auto resizeRowHorizontally = [&](int row, float* destination) {
+        for (int c = 0; c < inputChannels; ++c) {
+            float* out = destination + c * targetWidth;
+            if (isSourceNchw) {
+                const float* in = source + c * sourcePlane + static_cast<size_t>(row) * sourceWidth;
+                for (int x = 0; x < targetWidth; ++x) {
+                    out[x] = in[first[x]] * (1.0f - alpha[x]) + in[second[x]] * alpha[x];
+                }
+            } else {
+                const float* in = source + static_cast<size_t>(row) * sourceWidth * inputChannels + c;
+                for (int x = 0; x < targetWidth; ++x) {
+                    out[x] = in[first[x] * inputChannels] * (1.0f - alpha[x]) + in[second[x] * inputChannels] * alpha[x];
+                }
+            }
+        }
+    };
+    auto getResizedRow = [&](int row, int keptRow) -> const float* {
+        for (int slot = 0; slot < 2; ++slot) {
+            if (cachedRows[slot] == row) {
+                return cache.data() + slot * inputChannels * targetWidth;
+            }
+        }
+        // evict row which is not needed for current output row
+        int slot = cachedRows[0] == keptRow ? 1 : 0;
+        cachedRows[slot] = row;
+        float* destination = cache.data() + slot * inputChannels * targetWidth;
+        resizeRowHorizontally(row, destination);
+        return destination;
+    };
+
+    for (int y = 0; y < targetHeight; ++y) {
+        const float beta = rows.alpha[y];
+        const float* top = getResizedRow(rows.first[y], rows.second[y]);
+        const float* vertical = top;
+        if (beta != 0.0f) {
+            const float* bottom = getResizedRow(rows.second[y], rows.first[y]);
+            float* out = blended.data();
+            const int count = inputChannels * targetWidth;
+            for (int i = 0; i < count; ++i) {
+                out[i] = top[i] * (1.0f - beta) + bottom[i] * beta;
+            }
+            vertical = out;
+        }
+        for (int oc = 0; oc < outputChannels; ++oc) {
+            float* out = converted.data();
+            const float* weights = conversion.weights[oc];
+            bool isInitialized = false;
+            for (int ic = 0; ic < inputChannels; ++ic) {
+                const float weight = weights[ic];
+                if (weight == 0.0f) {
+                    continue;
+                }
+                const float* in = vertical + ic * targetWidth;
+                if (!isInitialized && weight == 1.0f) {
+                    for (int x = 0; x < targetWidth; ++x) {
+                        out[x] = in[x];
+                    }
+                } else if (!isInitialized) {
+                    for (int x = 0; x < targetWidth; ++x) {
+                        out[x] = in[x] * weight;
+                    }
+                } else {
+                    for (int x = 0; x < targetWidth; ++x) {
+                        out[x] += in[x] * weight;
+                    }
+                }
+                isInitialized = true;
+            }
+            if (meanValues.size() > 0) {
+                const float mean = meanValues[oc];
+                for (int x = 0; x < targetWidth; ++x) {
+                    out[x] -= mean;
+                }
+            }
+            if (scaleValues.size() > 0) {
+                const float scale = scaleValues[oc];
+                for (int x = 0; x < targetWidth; ++x) {
+                    out[x] /= scale;
+                }
+            }
+            if (isTargetNchw) {
+                float* destination = target + oc * targetPlane + static_cast<size_t>(y) * targetWidth;
+                for (int x = 0; x < targetWidth; ++x) {
+                    destination[x] = out[x];
+                }
+            } else {
+                float* destination = target + static_cast<size_t>(y) * targetWidth * outputChannels + oc;
+                for (int x = 0; x < targetWidth; ++x) {
+                    destination[x * outputChannels] = out[x];
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -18,11 +18,16 @@
 #include <string>
 
 #include "../../custom_node_interface.h"
+#include "fused_transformation.hpp"
 #include "opencv2/opencv.hpp"
 #include "utils.hpp"
 
 static constexpr const char* TENSOR_NAME = "image";
 
+static bool isPlanarYuvColorOrder(const std::string& colorOrder) {
+    return colorOrder == "NV12" || colorOrder == "I420";
+}
+
 int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount) {
     // Parameters reading
 
@@ -40,10 +45,13 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     //
     // Possible orders: BGR (default), RGB and GRAY.
     // Depending on the order, number of color channels will be selected - 3 for BGR/RGB and 1 for GRAY.
+    // Original image may also be NV12 or I420 frame, U8 data with Y plane followed by chroma planes in NHWC layout of shape 1,H*3/2,W,1.
+    // Such frame is converted to target color order, BGR by default, before other transformations.
     std::string originalImageColorOrder = get_string_parameter("original_image_color_order", params, paramsCount, "BGR");
+    const bool isPlanarYuv = isPlanarYuvColorOrder(originalImageColorOrder);
     std::string targetImageColorOrder = get_string_parameter("target_image_color_order", params, paramsCount);
-    targetImageColorOrder = targetImageColorOrder.empty() ? originalImageColorOrder : targetImageColorOrder;
-    NODE_ASSERT(originalImageColorOrder == "BGR" || originalImageColorOrder == "RGB" || originalImageColorOrder == "GRAY", "original image layout must be BGR, RGB or GRAY");
+    targetImageColorOrder = targetImageColorOrder.empty() ? (isPlanarYuv ? "BGR" : originalImageColorOrder) : targetImageColorOrder;
+    NODE_ASSERT(originalImageColorOrder == "BGR" || originalImageColorOrder == "RGB" || originalImageColorOrder == "GRAY" || isPlanarYuv, "original image layout must be BGR, RGB, GRAY, NV12 or I420");
     NODE_ASSERT(targetImageColorOrder == "BGR" || targetImageColorOrder == "RGB" || targetImageColorOrder == "GRAY", "target image layout must be BGR, RGB or GRAY");
     uint64_t targetImageColorChannels = targetImageColorOrder == "GRAY" ? 1 : 3;
 
@@ -81,6 +89,12 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     // The exact meaning and order of channels depend on input image.
     std::vector<float> meanValues = get_float_list_parameter("mean_values", params, paramsCount);
 
+    // Fused transformation.
+    //
+    // When enabled (default), color conversion, resize, scaling and layout change are performed in single pass
+    // writing directly into output buffer. When disabled, image is processed with separate OpenCV operations.
+    bool useFusedTransformation = get_string_parameter("fused_transformation", params, paramsCount, "true") == "true";
+
     // Debug flag for additional logging.
     bool debugMode = get_string_parameter("debug", params, paramsCount) == "true";
 
@@ -95,7 +109,17 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     uint64_t originalImageWidth = 0;
     uint64_t originalImageColorChannels = 0;
 
-    if (originalImageLayout == "NCHW") {
+    if (isPlanarYuv) {
+        NODE_ASSERT(originalImageLayout == "NHWC", "for color order NV12/I420 original image layout must be NHWC");
+        NODE_ASSERT(imageTensor->precision == U8, "for color order NV12/I420 image tensor precision must be U8");
+        NODE_ASSERT(imageTensor->dims[3] == 1, "for color order NV12/I420 image tensor shape must be 1,H*3/2,W,1");
+        NODE_ASSERT(imageTensor->dims[1] % 3 == 0, "for color order NV12/I420 image tensor shape must be 1,H*3/2,W,1");
+        originalImageHeight = imageTensor->dims[1] / 3 * 2;
+        originalImageWidth = imageTensor->dims[2];
+        NODE_ASSERT(originalImageHeight % 2 == 0 && originalImageWidth % 2 == 0, "for color order NV12/I420 image height and width must be even");
+        NODE_ASSERT(imageTensor->dims[1] * originalImageWidth == imageTensor->dataBytes, "number of input bytes does not match input shape");
+        NODE_ASSERT(originalImageHeight > 0 && originalImageWidth > 0, "original image size must be positive");
+    } else if (originalImageLayout == "NCHW") {
         originalImageColorChannels = imageTensor->dims[1];
         originalImageHeight = imageTensor->dims[2];
         originalImageWidth = imageTensor->dims[3];
@@ -108,9 +132,32 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
         return 1;
     }
 
-    NODE_ASSERT(originalImageHeight > 0 && originalImageWidth > 0, "original image size must be positive");
-    NODE_ASSERT(originalImageColorChannels == 1 || originalImageColorChannels == 3, "original image color channels must be 1 or 3");
-    NODE_ASSERT(originalImageHeight * originalImageWidth * originalImageColorChannels * sizeof(float) == imageTensor->dataBytes, "number of input bytes does not match input shape");
+    // Planar YUV frame is converted to target color order in NHWC layout, the rest of processing handles it as original image.
+    cv::Mat convertedImage;
+    const float* originalImageData = (const float*)imageTensor->data;
+    if (isPlanarYuv) {
+        static const std::map<std::pair<std::string, std::string>, int> yuvColors = {
+            {{"NV12", "BGR"}, cv::COLOR_YUV2BGR_NV12},
+            {{"NV12", "RGB"}, cv::COLOR_YUV2RGB_NV12},
+            {{"NV12", "GRAY"}, cv::COLOR_YUV2GRAY_NV12},
+            {{"I420", "BGR"}, cv::COLOR_YUV2BGR_I420},
+            {{"I420", "RGB"}, cv::COLOR_YUV2RGB_I420},
+            {{"I420", "GRAY"}, cv::COLOR_YUV2GRAY_I420},
+        };
+        const auto& colorIt = yuvColors.find({originalImageColorOrder, targetImageColorOrder});
+        NODE_ASSERT(colorIt != yuvColors.end(), "unsupported color conversion");
+        cv::Mat frame(imageTensor->dims[1], originalImageWidth, CV_8UC1, imageTensor->data);
+        cv::Mat converted;
+        cv::cvtColor(frame, converted, colorIt->second);
+        converted.convertTo(convertedImage, CV_32F);
+        originalImageColorOrder = targetImageColorOrder;
+        originalImageColorChannels = convertedImage.channels();
+        originalImageData = (const float*)convertedImage.data;
+    } else {
+        NODE_ASSERT(originalImageHeight > 0 && originalImageWidth > 0, "original image size must be positive");
+        NODE_ASSERT(originalImageColorChannels == 1 || originalImageColorChannels == 3, "original image color channels must be 1 or 3");
+        NODE_ASSERT(originalImageHeight * originalImageWidth * originalImageColorChannels * sizeof(float) == imageTensor->dataBytes, "number of input bytes does not match input shape");
+    }
 
     if (originalImageColorOrder == "GRAY") {
         NODE_ASSERT(originalImageColorChannels == 1, "for color order GRAY color channels must be equal 1");
@@ -142,67 +189,88 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
         std::cout << "Scale: " << (isScaleDefined ? std::to_string(scale) : "not defined") << std::endl;
         std::cout << "Scale values: " << floatListToString(scaleValues) << std::endl;
         std::cout << "Mean values: " << floatListToString(meanValues) << std::endl;
+        std::cout << "Fused transformation: " << (useFusedTransformation ? "true" : "false") << std::endl;
     }
     // ------------- validation end ---------------
 
-    // Prepare cv::Mat out of imageTensor input.
-    // In case input is in NCHW format, perform reordering to NHWC.
-    cv::Mat image = cv::Mat(originalImageHeight, originalImageWidth, originalImageColorChannels == 1 ? CV_32FC1 : CV_32FC3);
-    if (originalImageLayout == "NCHW") {
-        reorder_to_nhwc_2<float>((float*)imageTensor->data, (float*)image.data, originalImageHeight, originalImageWidth, originalImageColorChannels);
-    } else {
-        std::memcpy(image.data, imageTensor->data, imageTensor->dataBytes);
-    }
+    // Prepare output tensor
+    uint64_t byteSize = sizeof(float) * targetImageHeight * targetImageWidth * targetImageColorChannels;
+    float* buffer = (float*)malloc(byteSize);
+    NODE_ASSERT(buffer != nullptr, "malloc has failed");
 
-    // Change color order and number of channels.
-    static const std::map<std::pair<std::string, std::string>, int> colors = {
-        {{"GRAY", "BGR"}, cv::COLOR_GRAY2BGR},
-        {{"GRAY", "RGB"}, cv::COLOR_GRAY2RGB},
-        {{"BGR", "RGB"}, cv::COLOR_BGR2RGB},
-        {{"BGR", "GRAY"}, cv::COLOR_BGR2GRAY},
-        {{"RGB", "BGR"}, cv::COLOR_RGB2BGR},
-        {{"RGB", "GRAY"}, cv::COLOR_RGB2GRAY},
-    };
-
-    if (originalImageColorOrder != targetImageColorOrder) {
-        const auto& colorIt = colors.find({originalImageColorOrder, targetImageColorOrder});
-        NODE_ASSERT(colorIt != colors.end(), "unsupported color conversion");
-        cv::cvtColor(image, image, colorIt->second);
-    }
+    if (useFusedTransformation) {
+        ColorConversion conversion;
+        if (!make_color_conversion(originalImageColorOrder, targetImageColorOrder, conversion)) {
+            std::cout << "unsupported color conversion" << std::endl;
+            free(buffer);
+            return 1;
+        }
+        // If scale and scaleValues provided only scaleValues are used for scaling.
+        if (scaleValues.size() == 0 && isScaleDefined) {
+            scaleValues.assign(targetImageColorChannels, scale);
+        }
+        if (!fused_transform(originalImageData, originalImageLayout == "NCHW", originalImageHeight, originalImageWidth,
+                conversion, meanValues, scaleValues,
+                buffer, targetImageLayout == "NCHW", targetImageHeight, targetImageWidth)) {
+            std::cout << "Error during fused image transformation" << std::endl;
+            free(buffer);
+            return 1;
+        }
+    } else {
+        // Prepare cv::Mat out of imageTensor input.
+        // In case input is in NCHW format, perform reordering to NHWC.
+        cv::Mat image = cv::Mat(originalImageHeight, originalImageWidth, originalImageColorChannels == 1 ? CV_32FC1 : CV_32FC3);
+        if (originalImageLayout == "NCHW") {
+            reorder_to_nhwc_2<float>((float*)originalImageData, (float*)image.data, originalImageHeight, originalImageWidth, originalImageColorChannels);
+        } else {
+            std::memcpy(image.data, originalImageData, image.total() * image.elemSize());
+        }
 
-    // Perform procesesing with scale and mean values. If scale and scaleValues provided only scaleValues are used for scaling.
-    // If scale and meanValues provided mean values are substracted from pixels first then scaling is made.
-    // Scaling will be applied before resize if target resolution is smaller.
-    if ((isScaleDefined || scaleValues.size() > 0 || meanValues.size() > 0) && originalImageResolution < targetImageResolution) {
-        if (debugMode) {
-            std::cout << "Performing scaling before resize operation" << std::endl;
+        // Change color order and number of channels.
+        static const std::map<std::pair<std::string, std::string>, int> colors = {
+            {{"GRAY", "BGR"}, cv::COLOR_GRAY2BGR},
+            {{"GRAY", "RGB"}, cv::COLOR_GRAY2RGB},
+            {{"BGR", "RGB"}, cv::COLOR_BGR2RGB},
+            {{"BGR", "GRAY"}, cv::COLOR_BGR2GRAY},
+            {{"RGB", "BGR"}, cv::COLOR_RGB2BGR},
+            {{"RGB", "GRAY"}, cv::COLOR_RGB2GRAY},
+        };
+
+        if (originalImageColorOrder != targetImageColorOrder) {
+            const auto& colorIt = colors.find({originalImageColorOrder, targetImageColorOrder});
+            NODE_ASSERT(colorIt != colors.end(), "unsupported color conversion");
+            cv::cvtColor(image, image, colorIt->second);
         }
-        NODE_ASSERT(scale_image(isScaleDefined, scale, meanValues, scaleValues, image), "Error during image scaling");
-    }
 
-    // Perform resize operation.
-    if (originalImageHeight != targetImageHeight || originalImageWidth != targetImageWidth) {
-        cv::resize(image, image, cv::Size(targetImageWidth, targetImageHeight));
-    }
+        // Perform procesesing with scale and mean values. If scale and scaleValues provided only scaleValues are used for scaling.
+        // If scale and meanValues provided mean values are substracted from pixels first then scaling is made.
+        // Scaling will be applied before resize if target resolution is smaller.
+        if ((isScaleDefined || scaleValues.size() > 0 || meanValues.size() > 0) && originalImageResolution < targetImageResolution) {
+            if (debugMode) {
+                std::cout << "Performing scaling before resize operation" << std::endl;
+            }
+            NODE_ASSERT(scale_image(isScaleDefined, scale, meanValues, scaleValues, image), "Error during image scaling");
+        }
 
-    // Scaling should be applied after resize if target resolution is smaller.
-    if ((isScaleDefined || scaleValues.size() > 0 || meanValues.size() > 0) && originalImageResolution >= targetImageResolution) {
-        if (debugMode) {
-            std::cout << "Performing scaling after resize operation" << std::endl;
+        // Perform resize operation.
+        if (originalImageHeight != targetImageHeight || originalImageWidth != targetImageWidth) {
+            cv::resize(image, image, cv::Size(targetImageWidth, targetImageHeight));
         }
-        NODE_ASSERT(scale_image(isScaleDefined, scale, meanValues, scaleValues, image), "Error during image scaling");
-    }
 
-    // Prepare output tensor
-    uint64_t byteSize = sizeof(float) * targetImageHeight * targetImageWidth * targetImageColorChannels;
-    NODE_ASSERT(image.total() * image.elemSize() == byteSize, "buffer size differs");
-    float* buffer = (float*)malloc(byteSize);
-    NODE_ASSERT(buffer != nullptr, "malloc has failed");
+        // Scaling should be applied after resize if target resolution is smaller.
+        if ((isScaleDefined || scaleValues.size() > 0 || meanValues.size() > 0) && originalImageResolution >= targetImageResolution) {
+            if (debugMode) {
+                std::cout << "Performing scaling after resize operation" << std::endl;
+            }
+            NODE_ASSERT(scale_image(isScaleDefined, scale, meanValues, scaleValues, image), "Error during image scaling");
+        }
 
-    if (targetImageLayout == "NCHW") {
-        reorder_to_nchw_2<float>((float*)image.data, (float*)buffer, image.rows, image.cols, image.channels());
-    } else {
-        std::memcpy((uint8_t*)buffer, image.data, byteSize);
+        NODE_ASSERT(image.total() * image.elemSize() == byteSize, "buffer size differs");
+        if (targetImageLayout == "NCHW") {
+            reorder_to_nchw_2<float>((float*)image.data, (float*)buffer, image.rows, image.cols, image.channels());
+        } else {
+            std::memcpy((uint8_t*)buffer, image.data, byteSize);
+        }
     }
 
     *outputsCount = 1;
@@ -248,7 +316,8 @@ int getInputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const stru
     (*info)[0].dims[1] = 0;
     (*info)[0].dims[2] = 0;
     (*info)[0].dims[3] = 0;
-    (*info)[0].precision = FP32;
+    std::string originalImageColorOrder = get_string_parameter("original_image_color_order", params, paramsCount, "BGR");
+    (*info)[0].precision = isPlanarYuvColorOrder(originalImageColorOrder) ? U8 : FP32;
     return 0;
 }
 
@@ -260,9 +329,10 @@ int getOutputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const str
     NODE_ASSERT(targetImageWidth > 0 || targetImageWidth == -1, "target image width - when specified, must be larger than 0");
 
     std::string originalImageColorOrder = get_string_parameter("original_image_color_order", params, paramsCount);
+    const bool isPlanarYuv = isPlanarYuvColorOrder(originalImageColorOrder);
     std::string targetImageColorOrder = get_string_parameter("target_image_color_order", params, paramsCount);
-    targetImageColorOrder = targetImageColorOrder.empty() ? originalImageColorOrder : targetImageColorOrder;
-    NODE_ASSERT(originalImageColorOrder == "BGR" || originalImageColorOrder == "RGB" || originalImageColorOrder == "GRAY", "original image layout must be BGR, RGB or GRAY");
+    targetImageColorOrder = targetImageColorOrder.empty() ? (isPlanarYuv ? "BGR" : originalImageColorOrder) : targetImageColorOrder;
+    NODE_ASSERT(originalImageColorOrder == "BGR" || originalImageColorOrder == "RGB" || originalImageColorOrder == "GRAY" || isPlanarYuv, "original image layout must be BGR, RGB, GRAY, NV12 or I420");
     NODE_ASSERT(targetImageColorOrder == "BGR" || targetImageColorOrder == "RGB" || targetImageColorOrder == "GRAY", "target image layout must be BGR, RGB or GRAY");
 
     std::string originalImageLayout = get_string_parameter("original_image_layout", params, paramsCount);
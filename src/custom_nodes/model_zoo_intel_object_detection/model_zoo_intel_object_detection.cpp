@@ -79,6 +79,47 @@ bool copy_images_into_output(struct CustomNodeTensor* output, const std::vector<
     return true;
 }
 
+bool copy_original_image_into_output(struct CustomNodeTensor* output, const CustomNodeTensor* imageTensor, int imageHeight, int imageWidth, const std::string& originalImageLayout, const std::string& targetImageLayout) {
+    const int channels = 3;
+    uint64_t byteSize = sizeof(float) * imageHeight * imageWidth * channels;
+
+    float* buffer = (float*)malloc(byteSize);
+    NODE_ASSERT(buffer != nullptr, "malloc has failed");
+    if (buffer == nullptr) {
+        return false;
+    }
+
+    const float* imageData = reinterpret_cast<const float*>(imageTensor->data);
+    if (originalImageLayout == targetImageLayout) {
+        std::memcpy(buffer, imageData, byteSize);
+    } else if (targetImageLayout == "NCHW") {
+        auto imgBuffer = reorder_to_nchw(imageData, imageHeight, imageWidth, channels);
+        std::memcpy(buffer, imgBuffer.data(), byteSize);
+    } else {
+        auto imgBuffer = reorder_to_nhwc(imageData, imageHeight, imageWidth, channels);
+        std::memcpy(buffer, imgBuffer.data(), byteSize);
+    }
+
+    output->data = reinterpret_cast<uint8_t*>(buffer);
+    output->dataBytes = byteSize;
+    output->dimsCount = 5;
+    output->dims = (uint64_t*)malloc(output->dimsCount * sizeof(uint64_t));
+    NODE_ASSERT(output->dims != nullptr, "malloc has failed");
+    output->dims[0] = 1;
+    output->dims[1] = 1;
+    if (targetImageLayout == "NCHW") {
+        output->dims[2] = channels;
+        output->dims[3] = imageHeight;
+        output->dims[4] = imageWidth;
+    } else {
+        output->dims[2] = imageHeight;
+        output->dims[3] = imageWidth;
+        output->dims[4] = channels;
+    }
+    output->precision = FP32;
+    return true;
+}
+
 bool copy_coordinates_into_output(struct CustomNodeTensor* output, const std::vector<cv::Vec4f>& detections) {
     const uint64_t outputBatch = detections.size();
     uint64_t byteSize = sizeof(int32_t) * 4 * outputBatch;
@@ -138,15 +179,17 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     int originalImageWidth = get_int_parameter("original_image_width", params, paramsCount, -1);
     NODE_ASSERT(originalImageHeight > 0, "original image height must be larger than 0");
     NODE_ASSERT(originalImageWidth > 0, "original image width must be larger than 0");
+    bool outputRoi = get_string_parameter("output_roi", params, paramsCount) == "true";
     int targetImageHeight = get_int_parameter("target_image_height", params, paramsCount, -1);
     int targetImageWidth = get_int_parameter("target_image_width", params, paramsCount, -1);
-    NODE_ASSERT(targetImageHeight > 0, "target image height must be larger than 0");
-    NODE_ASSERT(targetImageWidth > 0, "target image width must be larger than 0");
+    NODE_ASSERT(outputRoi || targetImageHeight > 0, "target image height must be larger than 0");
+    NODE_ASSERT(outputRoi || targetImageWidth > 0, "target image width must be larger than 0");
     std::string originalImageLayout = get_string_parameter("original_image_layout", params, paramsCount, "NCHW");
     NODE_ASSERT(originalImageLayout == "NCHW" || originalImageLayout == "NHWC", "original image layout must be NCHW or NHWC");
     std::string targetImageLayout = get_string_parameter("target_image_layout", params, paramsCount, "NCHW");
     NODE_ASSERT(targetImageLayout == "NCHW" || targetImageLayout == "NHWC", "target image layout must be NCHW or NHWC");
     bool convertToGrayScale = get_string_parameter("convert_to_gray_scale", params, paramsCount) == "true";
+    NODE_ASSERT(!(outputRoi && convertToGrayScale), "gray scale conversion is not supported with output_roi");
     float confidenceThreshold = get_float_parameter("confidence_threshold", params, paramsCount, -1.0);
     NODE_ASSERT(confidenceThreshold >= 0 && confidenceThreshold <= 1.0, "confidence threshold must be in 0-1 range");
     uint64_t maxOutputBatch = get_int_parameter("max_output_batch", params, paramsCount, 100);
@@ -197,15 +240,18 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     NODE_ASSERT(imageHeight == originalImageHeight, "original image size parameter differs from original image tensor size");
     NODE_ASSERT(imageWidth == originalImageWidth, "original image size parameter differs from original image tensor size");
 
+    // in region of interest mode boxes are cropped and resized by the following model node, so image is not converted
     cv::Mat image;
-    if (originalImageLayout == "NHWC") {
-        image = nhwc_to_mat(imageTensor);
-    } else {
-        image = nchw_to_mat(imageTensor);
-    }
+    if (!outputRoi) {
+        if (originalImageLayout == "NHWC") {
+            image = nhwc_to_mat(imageTensor);
+        } else {
+            image = nchw_to_mat(imageTensor);
+        }
 
-    NODE_ASSERT(image.cols == imageWidth, "Mat generation failed");
-    NODE_ASSERT(image.rows == imageHeight, "Mat generation failed");
+        NODE_ASSERT(image.cols == imageWidth, "Mat generation failed");
+        NODE_ASSERT(image.rows == imageHeight, "Mat generation failed");
+    }
 
     uint64_t detectionsCount = detectionTensor->dims[2];
     uint64_t featuresCount = detectionTensor->dims[3];
@@ -243,6 +289,7 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
     NODE_ASSERT(boxes.size() == confidences.size(), "boxes and confidences are not equal length");
     if (boxes.size() > maxOutputBatch) {
         boxes.resize(maxOutputBatch);
+        detections.resize(maxOutputBatch);
         confidences.resize(maxOutputBatch);
     }
 
@@ -252,7 +299,12 @@ int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct Custo
 
     CustomNodeTensor& imagesTensor = (*outputs)[0];
     imagesTensor.name = OUTPUT_IMAGES_TENSOR_NAME;
-    if (!copy_images_into_output(&imagesTensor, boxes, image, targetImageHeight, targetImageWidth, targetImageLayout, convertToGrayScale)) {
+    if (outputRoi) {
+        if (!copy_original_image_into_output(&imagesTensor, imageTensor, imageHeight, imageWidth, originalImageLayout, targetImageLayout)) {
+            free(*outputs);
+            return 1;
+        }
+    } else if (!copy_images_into_output(&imagesTensor, boxes, image, targetImageHeight, targetImageWidth, targetImageLayout, convertToGrayScale)) {
         free(*outputs);
         return 1;
     }
@@ -318,13 +370,20 @@ int getInputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const stru
 }
 
 int getOutputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const struct CustomNodeParam* params, int paramsCount) {
+    bool outputRoi = get_string_parameter("output_roi", params, paramsCount) == "true";
     int targetImageHeight = get_int_parameter("target_image_height", params, paramsCount, -1);
     int targetImageWidth = get_int_parameter("target_image_width", params, paramsCount, -1);
+    if (outputRoi) {
+        // original image is returned once for all detected boxes
+        targetImageHeight = get_int_parameter("original_image_height", params, paramsCount, -1);
+        targetImageWidth = get_int_parameter("original_image_width", params, paramsCount, -1);
+    }
     NODE_ASSERT(targetImageHeight > 0, "target image height must be larger than 0");
     NODE_ASSERT(targetImageWidth > 0, "target image width must be larger than 0");
     std::string targetImageLayout = get_string_parameter("target_image_layout", params, paramsCount, "NCHW");
     NODE_ASSERT(targetImageLayout == "NCHW" || targetImageLayout == "NHWC", "target image layout must be NCHW or NHWC");
     bool convertToGrayScale = get_string_parameter("convert_to_gray_scale", params, paramsCount) == "true";
+    NODE_ASSERT(!(outputRoi && convertToGrayScale), "gray scale conversion is not supported with output_roi");
 
     *infoCount = 3;
     *info = (struct CustomNodeTensorInfo*)malloc(*infoCount * sizeof(struct CustomNodeTensorInfo));
@@ -334,7 +393,7 @@ int getOutputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const str
     (*info)[0].dimsCount = 5;
     (*info)[0].dims = (uint64_t*)malloc((*info)->dimsCount * sizeof(uint64_t));
     NODE_ASSERT(((*info)[0].dims) != nullptr, "malloc has failed");
-    (*info)[0].dims[0] = 0;
+    (*info)[0].dims[0] = outputRoi ? 1 : 0;
     (*info)[0].dims[1] = 1;
     if (targetImageLayout == "NCHW") {
         (*info)[0].dims[2] = convertToGrayScale ? 1 : 3;
@@ -0,0 +1,216 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../custom_node_interface.h"
+#include "tokenizers.hpp"
+#include "utils.hpp"
+
+static constexpr const char* TEXTS_TENSOR_NAME = "texts";
+static constexpr const char* INPUT_IDS_TENSOR_NAME = "input_ids";
+static constexpr const char* ATTENTION_MASK_TENSOR_NAME = "attention_mask";
+
+// Vocabulary is loaded once by initialize and shared by all executions of the node
+struct TokenizerState {
+    std::unique_ptr<Tokenizer> tokenizer;
+    int32_t clsId = -1;
+    int32_t sepId = -1;
+    int32_t padId = 0;
+    int maxIdsLength = 512;
+    bool padToMaxLength = false;
+};
+
+static int create_state(TokenizerState& state, const struct CustomNodeParam* params, int paramsCount) {
+    std::string tokenizerType = get_string_parameter("tokenizer_type", params, paramsCount, "wordpiece");
+    NODE_ASSERT(tokenizerType == "wordpiece" || tokenizerType == "bpe", "tokenizer type must be wordpiece or bpe");
+    std::string vocabularyPath = get_string_parameter("vocab_path", params, paramsCount);
+    NODE_ASSERT(!vocabularyPath.empty(), "vocab_path parameter is required");
+    bool isWordPiece = tokenizerType == "wordpiece";
+    bool lowerCase = get_string_parameter("lower_case", params, paramsCount, isWordPiece ? "true" : "false") == "true";
+    std::string unkToken = get_string_parameter("unk_token", params, paramsCount, isWordPiece ? "[UNK]" : "<unk>");
+    if (isWordPiece) {
+        auto tokenizer = std::make_unique<WordPieceTokenizer>();
+        NODE_ASSERT(tokenizer->load(vocabularyPath, unkToken, lowerCase), "failed to load vocabulary or unk_token is missing in it");
+        state.tokenizer = std::move(tokenizer);
+    } else {
+        std::string mergesPath = get_string_parameter("merges_path", params, paramsCount);
+        NODE_ASSERT(!mergesPath.empty(), "merges_path parameter is required by bpe tokenizer");
+        auto tokenizer = std::make_unique<BpeTokenizer>();
+        NODE_ASSERT(tokenizer->load(vocabularyPath, mergesPath, unkToken, lowerCase), "failed to load vocabulary or merges");
+        state.tokenizer = std::move(tokenizer);
+    }
+    if (get_string_parameter("add_special_tokens", params, paramsCount, isWordPiece ? "true" : "false") == "true") {
+        state.clsId = state.tokenizer->getId(get_string_parameter("cls_token", params, paramsCount, "[CLS]"));
+        state.sepId = state.tokenizer->getId(get_string_parameter("sep_token", params, paramsCount, "[SEP]"));
+        NODE_ASSERT(state.clsId >= 0 && state.sepId >= 0, "special tokens are missing in vocabulary");
+    }
+    state.padId = std::max(state.tokenizer->getId(get_string_parameter("pad_token", params, paramsCount, isWordPiece ? "[PAD]" : "<pad>")), 0);
+    state.maxIdsLength = get_int_parameter("max_ids_length", params, paramsCount, 512);
+    NODE_ASSERT(state.maxIdsLength > (state.clsId >= 0 ? 2 : 0), "max ids length must be larger than number of special tokens");
+    state.padToMaxLength = get_string_parameter("pad_to_max_length", params, paramsCount, "false") == "true";
+    return 0;
+}
+
+static void* allocate(const struct CustomNodeAllocator* allocator, uint64_t bytes) {
+    return allocator != nullptr ? allocator->allocate(allocator->context, bytes) : malloc(bytes);
+}
+
+static int execute_with_state(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeAllocator* allocator, const TokenizerState& state) {
+    const CustomNodeTensor* textsTensor = nullptr;
+    for (int i = 0; i < inputsCount; i++) {
+        if (std::strcmp(inputs[i].name, TEXTS_TENSOR_NAME) == 0) {
+            textsTensor = &(inputs[i]);
+        }
+    }
+    NODE_ASSERT(textsTensor != nullptr, "Missing texts input");
+    NODE_ASSERT(textsTensor->precision == U8, "texts input is not U8");
+    NODE_ASSERT(textsTensor->dimsCount == 2, "texts input shape must have 2 dimensions");
+    const uint64_t batchSize = textsTensor->dims[0];
+    const uint64_t rowSize = textsTensor->dims[1];
+    NODE_ASSERT(batchSize > 0 && rowSize > 0, "texts input must not be empty");
+
+    // each row holds one zero terminated string
+    const size_t specialTokens = state.clsId >= 0 ? 2 : 0;
+    std::vector<std::vector<int32_t>> ids(batchSize);
+    size_t maxLength = 0;
+    for (uint64_t i = 0; i < batchSize; i++) {
+        const char* text = reinterpret_cast<const char*>(textsTensor->data + i * rowSize);
+        const size_t length = strnlen(text, rowSize);
+        if (specialTokens > 0) {
+            ids[i].push_back(state.clsId);
+        }
+        state.tokenizer->tokenize(text, length, ids[i]);
+        if (ids[i].size() + specialTokens / 2 > static_cast<size_t>(state.maxIdsLength)) {
+            ids[i].resize(state.maxIdsLength - specialTokens / 2);
+        }
+        if (specialTokens > 0) {
+            ids[i].push_back(state.sepId);
+        }
+        maxLength = std::max(maxLength, ids[i].size());
+    }
+    maxLength = state.padToMaxLength ? state.maxIdsLength : std::max<size_t>(maxLength, 1);
+
+    // outputs are sized to the longest tokenized text of the batch unless model requires fixed length
+    const uint64_t byteSize = batchSize * maxLength * sizeof(int32_t);
+    int32_t* idsBuffer = static_cast<int32_t*>(allocate(allocator, byteSize));
+    int32_t* maskBuffer = static_cast<int32_t*>(allocate(allocator, byteSize));
+    uint64_t* idsDims = static_cast<uint64_t*>(allocate(allocator, 2 * sizeof(uint64_t)));
+    uint64_t* maskDims = static_cast<uint64_t*>(allocate(allocator, 2 * sizeof(uint64_t)));
+    *outputs = static_cast<struct CustomNodeTensor*>(allocate(allocator, 2 * sizeof(CustomNodeTensor)));
+    if (idsBuffer == nullptr || maskBuffer == nullptr || idsDims == nullptr || maskDims == nullptr || *outputs == nullptr) {
+        if (allocator == nullptr) {
+            free(idsBuffer);
+            free(maskBuffer);
+            free(idsDims);
+            free(maskDims);
+            free(*outputs);
+        }
+        std::cout << "allocation has failed" << std::endl;
+        return 1;
+    }
+    for (uint64_t i = 0; i < batchSize; i++) {
+        int32_t* idsRow = idsBuffer + i * maxLength;
+        int32_t* maskRow = maskBuffer + i * maxLength;
+        std::copy(ids[i].begin(), ids[i].end(), idsRow);
+        std::fill(idsRow + ids[i].size(), idsRow + maxLength, state.padId);
+        std::fill(maskRow, maskRow + ids[i].size(), 1);
+        std::fill(maskRow + ids[i].size(), maskRow + maxLength, 0);
+    }
+
+    *outputsCount = 2;
+    idsDims[0] = batchSize;
+    idsDims[1] = maxLength;
+    maskDims[0] = batchSize;
+    maskDims[1] = maxLength;
+    (*outputs)[0] = {INPUT_IDS_TENSOR_NAME, reinterpret_cast<uint8_t*>(idsBuffer), byteSize, idsDims, 2, I32};
+    (*outputs)[1] = {ATTENTION_MASK_TENSOR_NAME, reinterpret_cast<uint8_t*>(maskBuffer), byteSize, maskDims, 2, I32};
+    return 0;
+}
+
+int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount) {
+    // used only by servers not calling initialize, vocabulary is loaded on every execution
+    TokenizerState state;
+    if (create_state(state, params, paramsCount) != 0) {
+        return 1;
+    }
+    return execute_with_state(inputs, inputsCount, outputs, outputsCount, nullptr, state);
+}
+
+int executeWithAllocator(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount, const struct CustomNodeParam* params, int paramsCount, const struct CustomNodeAllocator* allocator, void* state) {
+    NODE_ASSERT(state != nullptr, "tokenizer is not initialized");
+    return execute_with_state(inputs, inputsCount, outputs, outputsCount, allocator, *static_cast<TokenizerState*>(state));
+}
+
+int initialize(void** state, const struct CustomNodeParam* params, int paramsCount) {
+    auto tokenizerState = std::make_unique<TokenizerState>();
+    if (create_state(*tokenizerState, params, paramsCount) != 0) {
+        return 1;
+    }
+    *state = tokenizerState.release();
+    return 0;
+}
+
+int deinitialize(void* state) {
+    delete static_cast<TokenizerState*>(state);
+    return 0;
+}
+
+int getInputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const struct CustomNodeParam* params, int paramsCount) {
+    *infoCount = 1;
+    *info = (struct CustomNodeTensorInfo*)malloc(*infoCount * sizeof(struct CustomNodeTensorInfo));
+    NODE_ASSERT((*info) != nullptr, "malloc has failed");
+
+    // batch of zero terminated strings of any length
+    (*info)[0].name = TEXTS_TENSOR_NAME;
+    (*info)[0].dimsCount = 2;
+    (*info)[0].dims = (uint64_t*)malloc((*info)[0].dimsCount * sizeof(uint64_t));
+    NODE_ASSERT(((*info)[0].dims) != nullptr, "malloc has failed");
+    (*info)[0].dims[0] = 0;
+    (*info)[0].dims[1] = 0;
+    (*info)[0].precision = U8;
+    return 0;
+}
+
+int getOutputsInfo(struct CustomNodeTensorInfo** info, int* infoCount, const struct CustomNodeParam* params, int paramsCount) {
+    *infoCount = 2;
+    *info = (struct CustomNodeTensorInfo*)malloc(*infoCount * sizeof(struct CustomNodeTensorInfo));
+    NODE_ASSERT((*info) != nullptr, "malloc has failed");
+
+    const char* names[] = {INPUT_IDS_TENSOR_NAME, ATTENTION_MASK_TENSOR_NAME};
+    bool padToMaxLength = get_string_parameter("pad_to_max_length", params, paramsCount, "false") == "true";
+    int maxIdsLength = get_int_parameter("max_ids_length", params, paramsCount, 512);
+    for (int i = 0; i < *infoCount; i++) {
+        (*info)[i].name = names[i];
+        (*info)[i].dimsCount = 2;
+        (*info)[i].dims = (uint64_t*)malloc((*info)[i].dimsCount * sizeof(uint64_t));
+        NODE_ASSERT(((*info)[i].dims) != nullptr, "malloc has failed");
+        (*info)[i].dims[0] = 0;
+        (*info)[i].dims[1] = padToMaxLength ? maxIdsLength : 0;
+        (*info)[i].precision = I32;
+    }
+    return 0;
+}
+
+int release(void* ptr) {
+    free(ptr);
+    return 0;
+}
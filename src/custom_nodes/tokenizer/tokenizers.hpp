@@ -0,0 +1,241 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Splits text into words on whitespace and ASCII punctuation, each punctuation character is a separate word.
+// Bytes of multibyte UTF-8 characters are kept within words.
+static void split_words(const char* text, size_t length, bool lowerCase, std::vector<std::string>& words) {
+    words.clear();
+    std::string word;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c < 0x80 && (std::isspace(c) || std::iscntrl(c) || std::ispunct(c))) {
+            if (!word.empty()) {
+                words.push_back(std::move(word));
+                word.clear();
+            }
+            if (std::ispunct(c)) {
+                words.emplace_back(1, static_cast<char>(c));
+            }
+            continue;
+        }
+        word.push_back(lowerCase && c < 0x80 ? static_cast<char>(std::tolower(c)) : static_cast<char>(c));
+    }
+    if (!word.empty()) {
+        words.push_back(std::move(word));
+    }
+}
+
+static bool is_utf8_continuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+// Reads vocabulary with one token per line, id of token is its line number
+static bool load_vocabulary(const std::string& path, std::unordered_map<std::string, int32_t>& vocabulary) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    int32_t id = 0;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        vocabulary.emplace(line, id++);
+    }
+    return !vocabulary.empty();
+}
+
+class Tokenizer {
+public:
+    virtual ~Tokenizer() = default;
+    // appends ids of words of text to ids
+    virtual void tokenize(const char* text, size_t length, std::vector<int32_t>& ids) const = 0;
+    virtual int32_t getId(const std::string& token) const = 0;
+};
+
+// Greedy longest-match-first WordPiece tokenizer of BERT like models, continuation pieces are prefixed with ##
+class WordPieceTokenizer : public Tokenizer {
+    static constexpr size_t MAX_WORD_LENGTH = 100;
+    std::unordered_map<std::string, int32_t> vocabulary;
+    int32_t unkId = -1;
+    bool lowerCase = true;
+
+public:
+    bool load(const std::string& vocabularyPath, const std::string& unkToken, bool lowerCase) {
+        this->lowerCase = lowerCase;
+        if (!load_vocabulary(vocabularyPath, vocabulary)) {
+            return false;
+        }
+        unkId = getId(unkToken);
+        return unkId >= 0;
+    }
+
+    int32_t getId(const std::string& token) const override {
+        auto it = vocabulary.find(token);
+        return it != vocabulary.end() ? it->second : -1;
+    }
+
+    void tokenize(const char* text, size_t length, std::vector<int32_t>& ids) const override {
+        std::vector<std::string> words;
+        split_words(text, length, lowerCase, words);
+        std::string candidate;
+        std::vector<int32_t> wordIds;
+        for (const auto& word : words) {
+            if (word.size() > MAX_WORD_LENGTH) {
+                ids.push_back(unkId);
+                continue;
+            }
+            wordIds.clear();
+            size_t start = 0;
+            while (start < word.size()) {
+                int32_t id = -1;
+                size_t end = word.size();
+                for (; end > start; end--) {
+                    if (end < word.size() && is_utf8_continuation(word[end])) {
+                        continue;
+                    }
+                    candidate.assign(start > 0 ? "##" : "");
+                    candidate.append(word, start, end - start);
+                    id = getId(candidate);
+                    if (id >= 0) {
+                        break;
+                    }
+                }
+                if (id < 0) {
+                    break;
+                }
+                wordIds.push_back(id);
+                start = end;
+            }
+            if (start < word.size()) {
+                // word which cannot be split into known pieces is unknown as a whole
+                ids.push_back(unkId);
+            } else {
+                ids.insert(ids.end(), wordIds.begin(), wordIds.end());
+            }
+        }
+    }
+};
+
+// Byte pair encoding tokenizer with merges ranked by their order in merges file, last symbol of word ends with </w>
+class BpeTokenizer : public Tokenizer {
+    std::unordered_map<std::string, int32_t> vocabulary;
+    std::unordered_map<std::string, size_t> mergeRanks;
+    int32_t unkId = -1;
+    bool lowerCase = false;
+
+    size_t getRank(const std::string& left, const std::string& right, std::string& pair) const {
+        pair.assign(left);
+        pair.push_back(' ');
+        pair.append(right);
+        auto it = mergeRanks.find(pair);
+        return it != mergeRanks.end() ? it->second : std::numeric_limits<size_t>::max();
+    }
+
+public:
+    bool load(const std::string& vocabularyPath, const std::string& mergesPath, const std::string& unkToken, bool lowerCase) {
+        this->lowerCase = lowerCase;
+        if (!load_vocabulary(vocabularyPath, vocabulary)) {
+            return false;
+        }
+        std::ifstream file(mergesPath);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty() || line.rfind("#version", 0) == 0) {
+                continue;
+            }
+            mergeRanks.emplace(line, mergeRanks.size());
+        }
+        unkId = getId(unkToken);
+        return true;
+    }
+
+    int32_t getId(const std::string& token) const override {
+        auto it = vocabulary.find(token);
+        return it != vocabulary.end() ? it->second : -1;
+    }
+
+    void tokenize(const char* text, size_t length, std::vector<int32_t>& ids) const override {
+        std::vector<std::string> words;
+        split_words(text, length, lowerCase, words);
+        std::vector<std::string> symbols;
+        std::string pair;
+        for (const auto& word : words) {
+            symbols.clear();
+            for (size_t i = 0; i < word.size(); i++) {
+                if (is_utf8_continuation(word[i]) && !symbols.empty()) {
+                    symbols.back().push_back(word[i]);
+                } else {
+                    symbols.emplace_back(1, word[i]);
+                }
+            }
+            symbols.back().append("</w>");
+            while (symbols.size() > 1) {
+                size_t bestRank = std::numeric_limits<size_t>::max();
+                size_t bestIndex = 0;
+                for (size_t i = 0; i + 1 < symbols.size(); i++) {
+                    size_t rank = getRank(symbols[i], symbols[i + 1], pair);
+                    if (rank < bestRank) {
+                        bestRank = rank;
+                        bestIndex = i;
+                    }
+                }
+                if (bestRank == std::numeric_limits<size_t>::max()) {
+                    break;
+                }
+                // merges all occurrences of the best pair in one pass
+                const std::string left = symbols[bestIndex];
+                const std::string right = symbols[bestIndex + 1];
+                std::vector<std::string> merged;
+                merged.reserve(symbols.size());
+                for (size_t i = 0; i < symbols.size(); i++) {
+                    if (i + 1 < symbols.size() && symbols[i] == left && symbols[i + 1] == right) {
+                        merged.push_back(left + right);
+                        i++;
+                    } else {
+                        merged.push_back(std::move(symbols[i]));
+                    }
+                }
+                symbols = std::move(merged);
+            }
+            for (const auto& symbol : symbols) {
+                int32_t id = getId(symbol);
+                if (id >= 0) {
+                    ids.push_back(id);
+                } else if (unkId >= 0) {
+                    ids.push_back(unkId);
+                }
+            }
+        }
+    }
+};
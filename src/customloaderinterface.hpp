@@ -15,6 +15,10 @@
 //*****************************************************************************
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -30,6 +34,26 @@ enum class CustomLoaderStatus {
     INTERNAL_ERROR     /*!< generic error */
 };
 
+/**
+     * @brief Model buffer returned by custom loader without copying
+     *
+     * Either data with size or descriptor of a regular file is set. Memory stays owned by the loader
+     * and must remain valid and unmodified until release is called. Server calls release once
+     * the model using the data is unloaded, or right after mapping the file when descriptor is used.
+     */
+struct CustomLoaderBuffer {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    int fd = -1;
+    std::function<void()> release;
+};
+
+/**
+     * @brief Callback notifying server that loader changed blacklist status of model version,
+     * status is MODEL_BLACKLISTED or OK. It can be called from any thread and returns without waiting for the change to be applied.
+     */
+using CustomLoaderBlacklistCallback = std::function<void(const std::string& modelName, const int version, const CustomLoaderStatus status)>;
+
 /**
      * @brief This class is the custom loader interface base class.
      * Custom Loader implementation shall derive from this base calss
@@ -76,6 +100,38 @@ public:
         std::vector<uint8_t>& modelBuffer,
         std::vector<uint8_t>& weights) = 0;
 
+    /**
+         * @brief Load the model by the custom loader without copying model buffers
+         *
+         * Server uses this function to load models. Default implementation wraps vectors returned by loadModel,
+         * loaders holding model in memory or files can override it to avoid copying.
+         *
+         * @param model name required to be loaded - defined under model config in the config file
+         * @param base path where the required model files are present
+         * @param version of the model
+         * @param loader config parameters json as string
+         * @param buffer of model
+         * @param buffer of weights
+         * @return status (On success, the return value will specify the type of model (IR,ONNX,BLOB) returned in buffers)
+         */
+    virtual CustomLoaderStatus loadModelBuffers(const std::string& modelName,
+        const std::string& basePath,
+        const int version,
+        const std::string& loaderOptions,
+        CustomLoaderBuffer& modelBuffer,
+        CustomLoaderBuffer& weights) {
+        auto modelVector = std::make_shared<std::vector<uint8_t>>();
+        auto weightsVector = std::make_shared<std::vector<uint8_t>>();
+        auto status = loadModel(modelName, basePath, version, loaderOptions, *modelVector, *weightsVector);
+        modelBuffer.data = modelVector->data();
+        modelBuffer.size = modelVector->size();
+        modelBuffer.release = [modelVector]() mutable { modelVector.reset(); };
+        weights.data = weightsVector->data();
+        weights.size = weightsVector->size();
+        weights.release = [weightsVector]() mutable { weightsVector.reset(); };
+        return status;
+    }
+
     /**
          * @brief Get the model black list status
          *
@@ -87,6 +143,20 @@ public:
         return CustomLoaderStatus::OK;
     }
 
+    /**
+         * @brief Register callback for pushing blacklist changes to the server
+         *
+         * Loader accepting the callback has to call it on every change of blacklist status. Server then asks
+         * getModelBlacklistStatus once per model version and applies pushed changes to the affected model right away,
+         * instead of polling all versions on every model manager check.
+         *
+         * @param callback
+         * @return true if loader pushes blacklist changes, false if they have to be polled
+         */
+    virtual bool registerBlacklistCallback(CustomLoaderBlacklistCallback callback) {
+        return false;
+    }
+
     /**
          * @brief Unload model resources by custom loader once model is unloaded by OVMS
          *
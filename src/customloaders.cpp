@@ -16,6 +16,8 @@
 
 #include "customloaders.hpp"
 
+#include <iterator>
+
 #include <spdlog/spdlog.h>
 
 #include "customloaderinterface.hpp"
@@ -77,6 +79,16 @@ Status CustomLoaders::finalize() {
         loaderPtr->loaderDeInit();
     }
 
+    {
+        std::lock_guard<std::mutex> lock(blacklistMtx);
+        for (const auto& [name, loader] : customLoaderInterfacePtrs) {
+            blacklistPushingLoaders.erase(name);
+            for (auto it = blacklistStatuses.begin(); it != blacklistStatuses.end();) {
+                it = std::get<0>(it->first) == name ? blacklistStatuses.erase(it) : std::next(it);
+            }
+        }
+    }
+
     SPDLOG_INFO("Clearing the list");
     customLoaderInterfacePtrs.clear();
 
@@ -87,4 +99,32 @@ Status CustomLoaders::finalize() {
     return StatusCode::OK;
 }
 
+void CustomLoaders::setBlacklistPushing(const std::string& name) {
+    std::lock_guard<std::mutex> lock(blacklistMtx);
+    blacklistPushingLoaders.insert(name);
+}
+
+void CustomLoaders::updateBlacklistStatus(const std::string& loaderName, const std::string& modelName, int version, CustomLoaderStatus status) {
+    std::lock_guard<std::mutex> lock(blacklistMtx);
+    blacklistStatuses[std::make_tuple(loaderName, modelName, version)] = status;
+}
+
+CustomLoaderStatus CustomLoaders::getModelBlacklistStatus(const std::string& loaderName, CustomLoaderInterface& loader, const std::string& modelName, int version) {
+    std::unique_lock<std::mutex> lock(blacklistMtx);
+    if (blacklistPushingLoaders.count(loaderName) == 0) {
+        lock.unlock();
+        return loader.getModelBlacklistStatus(modelName, version);
+    }
+    const auto key = std::make_tuple(loaderName, modelName, version);
+    auto it = blacklistStatuses.find(key);
+    if (it != blacklistStatuses.end()) {
+        return it->second;
+    }
+    lock.unlock();
+    auto status = loader.getModelBlacklistStatus(modelName, version);
+    lock.lock();
+    // status pushed in the meantime is newer
+    return blacklistStatuses.emplace(key, status).first->second;
+}
+
 }  // namespace ovms
@@ -17,7 +17,10 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -45,6 +48,18 @@ private:
 
     std::vector<std::string> currentCustomLoaderNames;
 
+    /**
+         * @brief Guards blacklist statuses, which are updated by loader threads
+         */
+    std::mutex blacklistMtx;
+
+    std::set<std::string> blacklistPushingLoaders;
+
+    /**
+         * @brief Blacklist statuses of loaders pushing changes, by loader name, model name and version
+         */
+    std::map<std::tuple<std::string, std::string, int>, CustomLoaderStatus> blacklistStatuses;
+
 public:
     /**
          * @brief Gets the instance of the CustomLoaders
@@ -88,5 +103,22 @@ public:
          * @return status
          */
     Status finalize();
+
+    /**
+         * @brief Marks loader as pushing blacklist changes, so that its statuses are cached instead of polled
+         */
+    void setBlacklistPushing(const std::string& name);
+
+    /**
+         * @brief Stores blacklist status pushed by loader
+         */
+    void updateBlacklistStatus(const std::string& loaderName, const std::string& modelName, int version, CustomLoaderStatus status);
+
+    /**
+         * @brief Gets blacklist status of model version, asks the loader only when it does not push changes or status is not known yet
+         *
+         * @return blacklist status OK or MODEL_BLACKLISTED
+         */
+    CustomLoaderStatus getModelBlacklistStatus(const std::string& loaderName, CustomLoaderInterface& loader, const std::string& modelName, int version);
 };
 }  // namespace ovms
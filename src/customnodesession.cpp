@@ -18,8 +18,11 @@
 #include <cstdint>
 #include <functional>
 #include <utility>
+#include <vector>
 
+#include "blob_view_allocator.hpp"
 #include "custom_node_output_allocator.hpp"
+#include "custom_node_server_allocator.hpp"
 #include "logging.hpp"
 #include "node.hpp"
 #include "node_library.hpp"
@@ -38,45 +41,144 @@ CustomNodeSession::CustomNodeSession(const NodeSessionMetadata&& metadata, const
 
 CustomNodeSession::~CustomNodeSession() = default;
 
-Status CustomNodeSession::execute(PipelineEventQueue& notifyEndQueue, Node& node, const NodeLibrary& library, std::unique_ptr<struct CustomNodeParam[]>& parameters, int parametersCount) {
-    const auto& blobMap = this->inputHandler->getInputs();
+Status CustomNodeSession::execute(PipelineEventQueue& notifyEndQueue, Node& node, const NodeLibrary& library, std::unique_ptr<struct CustomNodeParam[]>& parameters, int parametersCount, void* libraryState) {
+    const auto& blobMap = this->inputHandler->peekInputs();
     auto inputTensorsCount = blobMap.size();
     auto inputTensors = createCustomNodeTensorArray(blobMap);
     struct CustomNodeTensor* outputTensors = nullptr;
     int outputTensorsCount = 0;
 
-    this->timer->start("execution");
-    int result = library.execute(
-        inputTensors.get(),
-        inputTensorsCount,
-        &outputTensors,
-        &outputTensorsCount,
-        parameters.get(),
-        parametersCount);
-    this->timer->stop("execution");
+    CustomNodeServerAllocator serverAllocator(node.getBlobAllocator());
+    addInputs(serverAllocator, blobMap, inputTensors.get());
+    const struct CustomNodeAllocator allocatorInterface = serverAllocator.getInterface();
+
+    this->timer.start(EXECUTION);
+    int result;
+    if (library.executeWithAllocator) {
+        result = library.executeWithAllocator(
+            inputTensors.get(),
+            inputTensorsCount,
+            &outputTensors,
+            &outputTensorsCount,
+            parameters.get(),
+            parametersCount,
+            &allocatorInterface,
+            libraryState);
+    } else {
+        result = library.execute(
+            inputTensors.get(),
+            inputTensorsCount,
+            &outputTensors,
+            &outputTensorsCount,
+            parameters.get(),
+            parametersCount);
+    }
+    this->timer.stop(EXECUTION);
     SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Custom node execution processing time for node {}; session: {} - {} ms",
         this->getName(),
         this->getSessionKey(),
-        this->timer->elapsed<std::chrono::microseconds>("execution") / 1000);
+        this->timer.elapsed<std::chrono::microseconds>(EXECUTION) / 1000);
+    node.observeExecutionTime(this->timer.elapsed<std::chrono::microseconds>(EXECUTION));
 
     // If result is not 0, it means execution has failed.
     // In this case shared library is responsible for cleaning up resources (memory).
     if (result != 0) {
         SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node {}; session: {}; has failed custom node execution with return code: {}", getName(), getSessionKey(), result);
+        this->executionStatus = StatusCode::NODE_LIBRARY_EXECUTION_FAILED;
         notifyEndQueue.push({node, getSessionKey()});
         return StatusCode::NODE_LIBRARY_EXECUTION_FAILED;
     }
-    // In other cases we are responsible of cleaning whatever is possible.
+    auto status = this->createResultBlobs(outputTensors, outputTensorsCount, library, serverAllocator);
+    this->executionStatus = status;
+    notifyEndQueue.push({node, getSessionKey()});
+    return status;
+}
+
+Status CustomNodeSession::executeBatch(PipelineEventQueue& notifyEndQueue, Node& node, const NodeLibrary& library, std::unique_ptr<struct CustomNodeParam[]>& parameters, int parametersCount, void* libraryState, const std::vector<CustomNodeSession*>& members) {
+    // First shard of batch belongs to this session, remaining ones to members in order
+    std::vector<CustomNodeSession*> sessions{this};
+    sessions.insert(sessions.end(), members.begin(), members.end());
+    std::vector<session_key_t> sessionKeys;
+    std::vector<std::unique_ptr<struct CustomNodeTensor[]>> inputTensorsArrays;
+    std::vector<const struct CustomNodeTensor*> inputTensors;
+    sessionKeys.reserve(sessions.size());
+    inputTensorsArrays.reserve(sessions.size());
+    inputTensors.reserve(sessions.size());
+    const int inputTensorsCount = this->inputHandler->peekInputs().size();
+    for (auto* session : sessions) {
+        sessionKeys.emplace_back(session->getSessionKey());
+        inputTensorsArrays.emplace_back(createCustomNodeTensorArray(session->inputHandler->peekInputs()));
+        inputTensors.emplace_back(inputTensorsArrays.back().get());
+    }
+    std::vector<struct CustomNodeTensor*> outputTensors(sessions.size(), nullptr);
+    std::vector<int> outputTensorsCounts(sessions.size(), 0);
+
+    CustomNodeServerAllocator serverAllocator(node.getBlobAllocator());
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        addInputs(serverAllocator, sessions[i]->inputHandler->peekInputs(), inputTensorsArrays[i].get());
+    }
+    const struct CustomNodeAllocator allocatorInterface = serverAllocator.getInterface();
+
+    this->timer.start(EXECUTION);
+    int result = library.executeBatch(
+        inputTensors.data(),
+        inputTensorsCount,
+        sessions.size(),
+        outputTensors.data(),
+        outputTensorsCounts.data(),
+        parameters.get(),
+        parametersCount,
+        &allocatorInterface,
+        libraryState);
+    this->timer.stop(EXECUTION);
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Custom node batch execution processing time for node {}; session: {}; batch size: {} - {} ms",
+        this->getName(),
+        this->getSessionKey(),
+        sessions.size(),
+        this->timer.elapsed<std::chrono::microseconds>(EXECUTION) / 1000);
+    node.observeExecutionTime(this->timer.elapsed<std::chrono::microseconds>(EXECUTION));
+
+    Status status = StatusCode::OK;
+    if (result != 0) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node {}; session: {}; has failed custom node batch execution with return code: {}", getName(), getSessionKey(), result);
+        status = StatusCode::NODE_LIBRARY_EXECUTION_FAILED;
+    } else {
+        // outputs of all shards are converted, otherwise their resources would leak
+        for (size_t i = 0; i < sessions.size(); ++i) {
+            auto shardStatus = sessions[i]->createResultBlobs(outputTensors[i], outputTensorsCounts[i], library, serverAllocator);
+            if (status.ok()) {
+                status = shardStatus;
+            }
+        }
+    }
+    for (auto* session : sessions) {
+        session->executionStatus = status;
+    }
+    // Sessions may be removed once their end is processed, so keys were copied before
+    for (const auto& sessionKey : sessionKeys) {
+        notifyEndQueue.push({node, sessionKey});
+    }
+    return status;
+}
+
+void CustomNodeSession::addInputs(CustomNodeServerAllocator& serverAllocator, const BlobMap& blobMap, const struct CustomNodeTensor* inputTensors) {
+    // tensors were created by iterating the same map, so they follow its order
+    int i = 0;
+    for (const auto& [name, blob] : blobMap) {
+        serverAllocator.addInput(inputTensors[i++], blob);
+    }
+}
+
+Status CustomNodeSession::createResultBlobs(struct CustomNodeTensor* outputTensors, int outputTensorsCount, const NodeLibrary& library, const CustomNodeServerAllocator& serverAllocator) {
+    // We are responsible of cleaning whatever is possible.
     if (outputTensors == nullptr) {
         SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node {}; session: {}; has corrupted outputs handle", getName(), getSessionKey());
-        notifyEndQueue.push({node, getSessionKey()});
         return StatusCode::NODE_LIBRARY_OUTPUTS_CORRUPTED;
     }
 
     if (outputTensorsCount <= 0) {
         SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node {}; session: {}; has corrupted number of outputs", getName(), getSessionKey());
-        library.release(outputTensors);
-        notifyEndQueue.push({node, getSessionKey()});
+        serverAllocator.release(library, outputTensors);
         return StatusCode::NODE_LIBRARY_OUTPUTS_CORRUPTED_COUNT;
     }
 
@@ -86,7 +188,7 @@ Status CustomNodeSession::execute(PipelineEventQueue& notifyEndQueue, Node& node
     Status status = StatusCode::OK;
     for (int i = 0; i < outputTensorsCount; i++) {
         InferenceEngine::Blob::Ptr resultBlob;
-        auto result = this->createBlob(&outputTensors[i], resultBlob, library);
+        auto result = this->createBlob(&outputTensors[i], resultBlob, library, serverAllocator);
         if (outputTensors[i].name == nullptr) {
             SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node {}; session: {}; failed blob conversion - missing output name", getName(), getSessionKey());
             status = StatusCode::NODE_LIBRARY_OUTPUT_MISSING_NAME;
@@ -102,11 +204,19 @@ Status CustomNodeSession::execute(PipelineEventQueue& notifyEndQueue, Node& node
         this->resultBlobs.emplace(std::string(outputTensors[i].name), std::move(resultBlob));
     }
 
-    library.release(outputTensors);
-    notifyEndQueue.push({node, getSessionKey()});
+    serverAllocator.release(library, outputTensors);
     return status;
 }
 
+void CustomNodeSession::markInputsUsed() {
+    this->inputHandler->getInputs();
+}
+
+void CustomNodeSession::joinBatch(session_key_t leaderKey) {
+    markInputsUsed();
+    this->batchLeaderKey = leaderKey;
+}
+
 Status CustomNodeSession::fetchResult(const std::string& name, InferenceEngine::Blob::Ptr& resultBlob) {
     auto it = resultBlobs.find(name);
     if (it == resultBlobs.end()) {
@@ -128,18 +238,20 @@ void CustomNodeSession::releaseTensorResources(const struct CustomNodeTensor* te
 class TensorResourcesGuard {
     const struct CustomNodeTensor* tensor;
     const NodeLibrary& library;
+    const CustomNodeServerAllocator& serverAllocator;
     bool persistData = false;
 
 public:
-    TensorResourcesGuard(const struct CustomNodeTensor* tensor, const NodeLibrary& library) :
+    TensorResourcesGuard(const struct CustomNodeTensor* tensor, const NodeLibrary& library, const CustomNodeServerAllocator& serverAllocator) :
         tensor(tensor),
-        library(library) {}
+        library(library),
+        serverAllocator(serverAllocator) {}
     ~TensorResourcesGuard() {
         if (tensor->data && !persistData) {
-            library.release(tensor->data);
+            serverAllocator.release(library, tensor->data);
         }
         if (tensor->dims) {
-            library.release(tensor->dims);
+            serverAllocator.release(library, tensor->dims);
         }
     }
     void setPersistData() {
@@ -147,8 +259,8 @@ public:
     }
 };
 
-Status CustomNodeSession::createBlob(const struct CustomNodeTensor* tensor, InferenceEngine::Blob::Ptr& resultBlob, const NodeLibrary& library) {
-    TensorResourcesGuard tensorResourcesGuard(tensor, library);
+Status CustomNodeSession::createBlob(const struct CustomNodeTensor* tensor, InferenceEngine::Blob::Ptr& resultBlob, const NodeLibrary& library, const CustomNodeServerAllocator& serverAllocator) {
+    TensorResourcesGuard tensorResourcesGuard(tensor, library, serverAllocator);
     InferenceEngine::TensorDesc desc;
 
     InferenceEngine::Precision precision = toInferenceEnginePrecision(tensor->precision);
@@ -192,7 +304,18 @@ Status CustomNodeSession::createBlob(const struct CustomNodeTensor* tensor, Infe
             error.str());
         return StatusCode::NODE_LIBRARY_INVALID_CONTENT_SIZE;
     }
-    auto allocator = std::make_shared<CustomNodeOutputAllocator>(*tensor, library);
+    std::shared_ptr<InferenceEngine::IAllocator> allocator;
+    if (serverAllocator.owns(tensor->data)) {
+        allocator = std::make_shared<CustomNodeServerOutputAllocator>(serverAllocator.getArena(), tensor->data);
+    } else if (const auto* input = serverAllocator.findInput(tensor->data, tensor->dataBytes)) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node {}; session: {}; output {} aliases input data",
+            this->getName(),
+            this->getSessionKey(),
+            tensor->name);
+        allocator = std::make_shared<BlobViewAllocator>(*input, tensor->data);
+    } else {
+        allocator = std::make_shared<CustomNodeOutputAllocator>(*tensor, library);
+    }
     try {
         switch (tensor->precision) {
         case CustomNodeTensorPrecision::FP32:
@@ -16,7 +16,9 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "blobmap.hpp"
 #include "custom_node_interface.h"  // NOLINT
@@ -26,12 +28,17 @@
 
 namespace ovms {
 
+class CustomNodeServerAllocator;
 class ModelManager;
 class Node;
 class NodeLibrary;
 
 class CustomNodeSession : public NodeSession {
     BlobMap resultBlobs;
+    // Set for shard session executed in batch of other session
+    std::optional<session_key_t> batchLeaderKey;
+    // Result of execution, checked when fetching results of execution finished on other thread
+    Status executionStatus = StatusCode::OK;
 
 public:
     CustomNodeSession(const NodeSessionMetadata& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails);
@@ -43,7 +50,34 @@ public:
         Node& node,
         const NodeLibrary& library,
         std::unique_ptr<struct CustomNodeParam[]>& parameters,
-        int parametersCount);
+        int parametersCount,
+        void* libraryState);
+
+    /**
+     * @brief Executes this session together with member sessions in one library executeBatch call
+     *
+     * Results are stored in every session and all of them are notified as finished.
+     */
+    Status executeBatch(
+        PipelineEventQueue& notifyEndQueue,
+        Node& node,
+        const NodeLibrary& library,
+        std::unique_ptr<struct CustomNodeParam[]>& parameters,
+        int parametersCount,
+        void* libraryState,
+        const std::vector<CustomNodeSession*>& members);
+
+    /**
+     * @brief Marks inputs as used, so that session is not reported as ready while it is executed
+     */
+    void markInputsUsed();
+    const Status& getExecutionStatus() const { return executionStatus; }
+    /**
+     * @brief Marks session as executed in batch of leader session, its inputs are not executed on its own
+     */
+    void joinBatch(session_key_t leaderKey);
+    bool isBatchMember() const { return batchLeaderKey.has_value(); }
+    session_key_t getBatchLeaderKey() const { return batchLeaderKey.value(); }
 
     Status fetchResult(const std::string& name, InferenceEngine::Blob::Ptr& resultBlob);
 
@@ -51,7 +85,9 @@ public:
     void release() override;
 
 private:
+    static void addInputs(CustomNodeServerAllocator& serverAllocator, const BlobMap& blobMap, const struct CustomNodeTensor* inputTensors);
+    Status createResultBlobs(struct CustomNodeTensor* outputTensors, int outputTensorsCount, const NodeLibrary& library, const CustomNodeServerAllocator& serverAllocator);
     static void releaseTensorResources(const struct CustomNodeTensor* tensor, const NodeLibrary& library);
-    Status createBlob(const struct CustomNodeTensor* tensor, InferenceEngine::Blob::Ptr& resultBlob, const NodeLibrary& library);
+    Status createBlob(const struct CustomNodeTensor* tensor, InferenceEngine::Blob::Ptr& resultBlob, const NodeLibrary& library, const CustomNodeServerAllocator& serverAllocator);
 };
 }  // namespace ovms
@@ -15,8 +15,533 @@
 //*****************************************************************************
 #include "deserialization.hpp"
 
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "layout_transpose.hpp"
+#include "workerpool.hpp"
+
 namespace ovms {
 
+namespace {
+void narrowInt32ToUint16Scalar(const int32_t* source, uint16_t* destination, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        destination[i] = static_cast<uint16_t>(source[i]);
+    }
+}
+
+__attribute__((target("avx2"))) void narrowInt32ToUint16Avx2(const int32_t* source, uint16_t* destination, size_t count) {
+    // low 16 bits of each 32 bit value into low 8 bytes of each 128 bit lane
+    const __m256i shuffleMask = _mm256_setr_epi8(
+        0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i low = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i)), shuffleMask);
+        __m256i high = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 8)), shuffleMask);
+        // gather the low 8 bytes of all four lanes
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(low, high), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), packed);
+    }
+    narrowInt32ToUint16Scalar(source + i, destination + i, count - i);
+}
+
+__attribute__((target("avx512f"))) void narrowInt32ToUint16Avx512(const int32_t* source, uint16_t* destination, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm512_mask_cvtepi32_storeu_epi16(destination + i, 0xFFFF, _mm512_loadu_si512(source + i));
+    }
+    narrowInt32ToUint16Scalar(source + i, destination + i, count - i);
+}
+
+uint16_t convertFp32ToFp16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (((bits >> 23) & 0xFF) == 0xFF) {
+        // infinity or quiet NaN
+        return sign | 0x7C00 | (mantissa ? 0x200 | (mantissa >> 13) : 0);
+    }
+    if (exponent >= 0x1F) {
+        return sign | 0x7C00;
+    }
+    uint32_t shift = 13;
+    uint32_t half = 0;
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return sign;
+        }
+        // subnormal, implicit leading bit becomes explicit
+        mantissa |= 0x800000;
+        shift = 14 - exponent;
+        half = mantissa >> shift;
+    } else {
+        half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> shift);
+    }
+    // round to nearest even, carry into exponent is correct up to infinity
+    const uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1))) {
+        half++;
+    }
+    return sign | half;
+}
+
+template <typename T>
+T convertFp32ToInteger(float value) {
+    constexpr float lowest = static_cast<float>(std::numeric_limits<T>::lowest());
+    constexpr float highest = static_cast<float>(std::numeric_limits<T>::max());
+    // NaN saturates to lowest value like vectorized path
+    if (!(value >= lowest)) {
+        return std::numeric_limits<T>::lowest();
+    }
+    if (value >= highest) {
+        return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(std::nearbyint(value));
+}
+
+void convertFp32ToFp16Scalar(const float* source, uint16_t* destination, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        destination[i] = convertFp32ToFp16(source[i]);
+    }
+}
+
+template <typename T>
+void convertFp32ToIntegerScalar(const float* source, T* destination, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        destination[i] = convertFp32ToInteger<T>(source[i]);
+    }
+}
+
+__attribute__((target("avx,f16c"))) void convertFp32ToFp16F16c(const float* source, uint16_t* destination, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i converted = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), converted);
+    }
+    convertFp32ToFp16Scalar(source + i, destination + i, count - i);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void convertFp32ToIntegerAvx2(const float* source, T* destination, size_t count) {
+    static_assert(sizeof(T) == 1, "only 8 bit integers are supported");
+    // restores element order after in lane packing
+    const __m256i permuteMask = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    // clamping before conversion keeps values outside of int32 range and NaN saturated
+    const __m256 lowest = _mm256_set1_ps(static_cast<float>(std::numeric_limits<T>::lowest()));
+    const __m256 highest = _mm256_set1_ps(static_cast<float>(std::numeric_limits<T>::max()));
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i converted[4];
+        for (size_t j = 0; j < 4; j++) {
+            // max returns second operand for NaN, rounding to nearest even is the default MXCSR mode
+            __m256 values = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(source + i + j * 8), lowest), highest);
+            converted[j] = _mm256_cvtps_epi32(values);
+        }
+        __m256i ab = _mm256_packs_epi32(converted[0], converted[1]);
+        __m256i cd = _mm256_packs_epi32(converted[2], converted[3]);
+        __m256i packed;
+        if constexpr (std::is_signed_v<T>) {
+            packed = _mm256_packs_epi16(ab, cd);
+        } else {
+            packed = _mm256_packus_epi16(ab, cd);
+        }
+        packed = _mm256_permutevar8x32_epi32(packed, permuteMask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), packed);
+    }
+    convertFp32ToIntegerScalar(source + i, destination + i, count - i);
+}
+
+using narrow_function_t = void (*)(const int32_t*, uint16_t*, size_t);
+
+bool isF16cSupported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+}
+
+bool isAvx2Supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+narrow_function_t selectNarrowInt32ToUint16() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return narrowInt32ToUint16Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return narrowInt32ToUint16Avx2;
+    }
+    return narrowInt32ToUint16Scalar;
+}
+}  // namespace
+
+void narrowInt32ToUint16(const int32_t* source, uint16_t* destination, size_t count) {
+    static const narrow_function_t narrow = selectNarrowInt32ToUint16();
+    narrow(source, destination, count);
+}
+
+float convertFp16ToFp32(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+    if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // subnormal half is normal float
+        exponent = 113;
+        while ((mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+bool isConversionFromFp32Supported(InferenceEngine::Precision precision) {
+    return precision == InferenceEngine::Precision::FP16 ||
+           precision == InferenceEngine::Precision::U8 ||
+           precision == InferenceEngine::Precision::I8;
+}
+
+bool convertFromFp32(InferenceEngine::Precision precision, const float* source, void* destination, size_t count) {
+    static const bool f16c = isF16cSupported();
+    static const bool avx2 = isAvx2Supported();
+    switch (precision) {
+    case InferenceEngine::Precision::FP16:
+        if (f16c) {
+            convertFp32ToFp16F16c(source, static_cast<uint16_t*>(destination), count);
+        } else {
+            convertFp32ToFp16Scalar(source, static_cast<uint16_t*>(destination), count);
+        }
+        return true;
+    case InferenceEngine::Precision::U8:
+        if (avx2) {
+            convertFp32ToIntegerAvx2(source, static_cast<uint8_t*>(destination), count);
+        } else {
+            convertFp32ToIntegerScalar(source, static_cast<uint8_t*>(destination), count);
+        }
+        return true;
+    case InferenceEngine::Precision::I8:
+        if (avx2) {
+            convertFp32ToIntegerAvx2(source, static_cast<int8_t*>(destination), count);
+        } else {
+            convertFp32ToIntegerScalar(source, static_cast<int8_t*>(destination), count);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+InferenceEngine::Blob::Ptr makeConvertedBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
+    const auto tensorDesc = getFinalTensorDesc(*tensorInfo, requestInput, isPipeline);
+    const float* source = reinterpret_cast<const float*>(requestInput.tensor_content().data());
+    size_t count = requestInput.tensor_content().size() / sizeof(float);
+    // keeps region mapped during conversion, converted blob does not reference it
+    std::shared_ptr<SharedMemoryRegion> region;
+    if (isSharedMemoryReference(requestInput)) {
+        const auto& dims = tensorDesc.getDims();
+        count = std::accumulate(dims.begin(), dims.end(), size_t{1}, std::multiplies<size_t>());
+        char* data = nullptr;
+        if (!resolveSharedMemoryReference(requestInput, count * sizeof(float), region, data).ok()) {
+            return nullptr;
+        }
+        source = reinterpret_cast<const float*>(data);
+    }
+    InferenceEngine::Blob::Ptr blob;
+    switch (tensorInfo->getPrecision()) {
+    case InferenceEngine::Precision::FP16:
+        blob = makePooledBlob<uint16_t>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::U8:
+        blob = makePooledBlob<uint8_t>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::I8:
+        blob = makePooledBlob<int8_t>(tensorDesc);
+        break;
+    default:
+        return nullptr;
+    }
+    auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
+    convertFromFp32(tensorInfo->getPrecision(), source, holder.as<void*>(), count);
+    return blob;
+}
+
+InferenceEngine::Blob::Ptr makeSparseBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
+    const auto tensorDesc = getFinalTensorDesc(*tensorInfo, requestInput, isPipeline);
+    InferenceEngine::Blob::Ptr blob;
+    switch (tensorInfo->getPrecision()) {
+    case InferenceEngine::Precision::FP32:
+        blob = makePooledBlob<float>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::I32:
+        blob = makePooledBlob<int32_t>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::I16:
+        blob = makePooledBlob<int16_t>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::FP16:
+    case InferenceEngine::Precision::U16:
+        blob = makePooledBlob<uint16_t>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::U8:
+        blob = makePooledBlob<uint8_t>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::I8:
+        blob = makePooledBlob<int8_t>(tensorDesc);
+        break;
+    default:
+        return nullptr;
+    }
+    auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
+    if (!writeSparseTensor(requestInput, tensorInfo->getPrecision(), holder.as<void*>(), blob->byteSize())) {
+        return nullptr;
+    }
+    return blob;
+}
+
+bool writeTensorProtoIntoBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, const InferenceEngine::Blob::Ptr& blob) {
+    if (requestInput.dtype() == tensorflow::DataType::DT_STRING || isSharedMemoryReference(requestInput)) {
+        return false;
+    }
+    auto memoryBlob = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob);
+    if (!memoryBlob) {
+        return false;
+    }
+    if (isSparseTensor(requestInput)) {
+        auto holder = memoryBlob->wmap();
+        return writeSparseTensor(requestInput, tensorInfo->getPrecision(), holder.as<void*>(), blob->byteSize());
+    }
+    const auto& content = requestInput.tensor_content();
+    const size_t count = blob->size();
+    if (tensorInfo->isConvertedFromDataType(requestInput.dtype())) {
+        if (content.size() != count * sizeof(float)) {
+            return false;
+        }
+        auto holder = memoryBlob->wmap();
+        return convertFromFp32(tensorInfo->getPrecision(), reinterpret_cast<const float*>(content.data()), holder.as<void*>(), count);
+    }
+    if (content.size() > 0) {
+        if (content.size() != blob->byteSize()) {
+            return false;
+        }
+        auto holder = memoryBlob->wmap();
+        if (tensorInfo->isTransposedByServer()) {
+            return transposeLayout(tensorInfo->getPrecision(), blob->getTensorDesc().getDims(),
+                tensorInfo->getLayout(), content.data(), tensorInfo->getTransposedLayout(), holder.as<void*>());
+        }
+        std::memcpy(holder.as<void*>(), content.data(), content.size());
+        return true;
+    }
+    // values with zero padding are narrowed the same way as when new blob is created
+    const auto precision = tensorInfo->getPrecision();
+    const auto& values = precision == InferenceEngine::Precision::FP16 ? requestInput.half_val() : requestInput.int_val();
+    if ((precision != InferenceEngine::Precision::FP16 && precision != InferenceEngine::Precision::U16) ||
+        static_cast<size_t>(values.size()) != count) {
+        return false;
+    }
+    auto holder = memoryBlob->wmap();
+    narrowInt32ToUint16(values.data(), holder.as<uint16_t*>(), count);
+    return true;
+}
+
+namespace {
+InferenceEngine::Blob::Ptr makeTransposedBlobOfData(const char* data, size_t byteSize, const TensorInfo& tensorInfo) {
+    const auto tensorDesc = tensorInfo.getTransposedTensorDesc();
+    InferenceEngine::Blob::Ptr blob;
+    switch (tensorInfo.getPrecision()) {
+    case InferenceEngine::Precision::FP32:
+        blob = makePooledBlob<float>(tensorDesc);
+        break;
+    case InferenceEngine::Precision::U8:
+        blob = makePooledBlob<uint8_t>(tensorDesc);
+        break;
+    default:
+        return nullptr;
+    }
+    if (byteSize != blob->byteSize()) {
+        return nullptr;
+    }
+    auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
+    if (!transposeLayout(tensorInfo.getPrecision(), tensorDesc.getDims(),
+            tensorInfo.getLayout(), data, tensorInfo.getTransposedLayout(), holder.as<void*>())) {
+        return nullptr;
+    }
+    return blob;
+}
+}  // namespace
+
+InferenceEngine::Blob::Ptr makeTransposedBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo) {
+    const auto& content = requestInput.tensor_content();
+    return makeTransposedBlobOfData(content.data(), content.size(), *tensorInfo);
+}
+
+InferenceEngine::Blob::Ptr makeTransposedBlob(const InferenceEngine::Blob::Ptr& blob,
+    const std::shared_ptr<TensorInfo>& tensorInfo) {
+    auto memoryBlob = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob);
+    if (!memoryBlob || blob->getTensorDesc().getPrecision() != tensorInfo->getPrecision()) {
+        return nullptr;
+    }
+    auto holder = memoryBlob->rmap();
+    return makeTransposedBlobOfData(holder.as<const char*>(), blob->byteSize(), *tensorInfo);
+}
+
+namespace {
+template <typename T>
+InferenceEngine::Blob::Ptr makeSharedMemoryBlobOfType(const InferenceEngine::TensorDesc& tensorDesc,
+    std::shared_ptr<const void> owner, char* data) {
+    auto blob = InferenceEngine::make_shared_blob<T>(tensorDesc,
+        std::make_shared<SharedMemoryAllocator>(std::move(owner), data));
+    blob->allocate();
+    return blob;
+}
+
+InferenceEngine::Blob::Ptr makePlaneBlob(size_t channels, size_t height, size_t width, char* data, const std::shared_ptr<const void>& owner) {
+    // planes of NV12 and I420 blobs have to be 8 bit with NHWC layout
+    const InferenceEngine::TensorDesc tensorDesc(InferenceEngine::Precision::U8, {1, channels, height, width}, InferenceEngine::Layout::NHWC);
+    return makeSharedMemoryBlobOfType<uint8_t>(tensorDesc, owner, data);
+}
+}  // namespace
+
+InferenceEngine::Blob::Ptr makePlanarYuvBlob(InferenceEngine::ColorFormat colorFormat, size_t batch, size_t height, size_t width,
+    char* data, std::shared_ptr<const void> owner) {
+    const size_t lumaSize = height * width;
+    const size_t frameSize = lumaSize * 3 / 2;
+    std::vector<InferenceEngine::Blob::Ptr> frames;
+    frames.reserve(batch);
+    for (size_t i = 0; i < batch; ++i) {
+        char* luma = data + i * frameSize;
+        char* chroma = luma + lumaSize;
+        auto lumaBlob = makePlaneBlob(1, height, width, luma, owner);
+        switch (colorFormat) {
+        case InferenceEngine::ColorFormat::NV12:
+            frames.push_back(InferenceEngine::make_shared_blob<InferenceEngine::NV12Blob>(lumaBlob,
+                makePlaneBlob(2, height / 2, width / 2, chroma, owner)));
+            break;
+        case InferenceEngine::ColorFormat::I420:
+            frames.push_back(InferenceEngine::make_shared_blob<InferenceEngine::I420Blob>(lumaBlob,
+                makePlaneBlob(1, height / 2, width / 2, chroma, owner),
+                makePlaneBlob(1, height / 2, width / 2, chroma + lumaSize / 4, owner)));
+            break;
+        default:
+            return nullptr;
+        }
+    }
+    if (frames.size() == 1) {
+        return frames[0];
+    }
+    return InferenceEngine::make_shared_blob<InferenceEngine::BatchedBlob>(frames);
+}
+
+InferenceEngine::Blob::Ptr makePlanarYuvBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo) {
+    const auto& shape = requestInput.tensor_shape();
+    const size_t batch = shape.dim(0).size();
+    const size_t planesHeight = shape.dim(1).size();
+    const size_t width = shape.dim(2).size();
+    if (isSharedMemoryReference(requestInput)) {
+        std::shared_ptr<SharedMemoryRegion> region;
+        char* data = nullptr;
+        if (!resolveSharedMemoryReference(requestInput, batch * planesHeight * width, region, data).ok()) {
+            return nullptr;
+        }
+        return makePlanarYuvBlob(tensorInfo->getColorFormat(), batch, planesHeight / 3 * 2, width, data, std::move(region));
+    }
+    // like other blobs of models, planes wrap content of request outliving the inference
+    return makePlanarYuvBlob(tensorInfo->getColorFormat(), batch, planesHeight / 3 * 2, width,
+        const_cast<char*>(requestInput.tensor_content().data()), nullptr);
+}
+
+InferenceEngine::Blob::Ptr makeSharedMemoryBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
+    const auto tensorDesc = getFinalTensorDesc(*tensorInfo, requestInput, isPipeline);
+    std::shared_ptr<SharedMemoryRegion> region;
+    char* data = nullptr;
+    const auto& dims = tensorDesc.getDims();
+    const size_t byteSize = tensorDesc.getPrecision().size() * std::accumulate(dims.begin(), dims.end(), size_t{1}, std::multiplies<size_t>());
+    auto status = resolveSharedMemoryReference(requestInput, byteSize, region, data);
+    if (!status.ok()) {
+        return nullptr;
+    }
+    switch (tensorInfo->getPrecision()) {
+    case InferenceEngine::Precision::FP32:
+        return makeSharedMemoryBlobOfType<float>(tensorDesc, std::move(region), data);
+    case InferenceEngine::Precision::I32:
+        return makeSharedMemoryBlobOfType<int32_t>(tensorDesc, std::move(region), data);
+    case InferenceEngine::Precision::I8:
+        return makeSharedMemoryBlobOfType<int8_t>(tensorDesc, std::move(region), data);
+    case InferenceEngine::Precision::U8:
+        return makeSharedMemoryBlobOfType<uint8_t>(tensorDesc, std::move(region), data);
+    case InferenceEngine::Precision::I16:
+        return makeSharedMemoryBlobOfType<int16_t>(tensorDesc, std::move(region), data);
+    case InferenceEngine::Precision::FP16:
+    case InferenceEngine::Precision::U16:
+        return makeSharedMemoryBlobOfType<uint16_t>(tensorDesc, std::move(region), data);
+    default:
+        return nullptr;
+    }
+}
+
+namespace {
+std::shared_ptr<WorkerPool> deserializationPool;
+std::atomic<size_t> minParallelDeserializationBytes{0};
+
+size_t getRequestDataBytes(const tensorflow::TensorProto& requestInput) {
+    if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+        size_t bytes = 0;
+        for (const auto& value : requestInput.string_val()) {
+            bytes += value.size();
+        }
+        return bytes;
+    }
+    // half_val is padded to int32
+    return requestInput.tensor_content().size() +
+           sizeof(int32_t) * static_cast<size_t>(requestInput.int_val_size() + requestInput.half_val_size()) +
+           sizeof(float) * static_cast<size_t>(requestInput.float_val_size()) +
+           sizeof(int64_t) * static_cast<size_t>(requestInput.int64_val_size()) +
+           sizeof(double) * static_cast<size_t>(requestInput.double_val_size());
+}
+}  // namespace
+
+void setDeserializationWorkers(size_t workers, size_t minParallelInputBytes) {
+    minParallelDeserializationBytes = minParallelInputBytes;
+    std::atomic_store(&deserializationPool, workers > 0 ? std::make_shared<WorkerPool>(workers) : std::shared_ptr<WorkerPool>());
+}
+
+bool isDeserializedInParallel(const tensorflow::TensorProto& requestInput) {
+    return std::atomic_load(&deserializationPool) != nullptr && getRequestDataBytes(requestInput) >= minParallelDeserializationBytes;
+}
+
+void deserializeInParallel(size_t count, const std::function<bool(size_t)>& task) {
+    auto pool = std::atomic_load(&deserializationPool);
+    WorkerPool::parallelFor(pool.get(), 0, count, task);
+}
+
 template <>
 Status InputSink<InferenceEngine::InferRequest&>::give(const std::string& name, InferenceEngine::Blob::Ptr blob) {
     Status status;
@@ -39,10 +564,22 @@ Status InputSink<InferenceEngine::InferRequest&>::give(const std::string& name,
 }
 
 InferenceEngine::TensorDesc getFinalTensorDesc(const ovms::TensorInfo& servableInfo, const tensorflow::TensorProto& requestInput, bool isPipeline) {
-    InferenceEngine::Precision precision = servableInfo.getPrecision();
+    if (!isPipeline && servableInfo.isResizedByPreprocessing()) {
+        // request resolution is kept, OpenVINO resizes it to network input during inference
+        InferenceEngine::SizeVector dims;
+        for (int i = 0; i < requestInput.tensor_shape().dim_size(); i++) {
+            dims.push_back(requestInput.tensor_shape().dim(i).size());
+        }
+        if (servableInfo.getLayout() == InferenceEngine::Layout::NHWC && dims.size() == 4) {
+            // tensor descriptor dimensions are in NCHW order regardless of layout
+            dims = {dims[0], dims[3], dims[1], dims[2]};
+        }
+        return InferenceEngine::TensorDesc(servableInfo.getPrecision(), dims, servableInfo.getLayout());
+    }
     if (!isPipeline) {
-        return InferenceEngine::TensorDesc(precision, servableInfo.getShape(), servableInfo.getLayout());
+        return servableInfo.getTensorDesc();
     }
+    InferenceEngine::Precision precision = servableInfo.getPrecision();
     InferenceEngine::SizeVector shape;
     for (size_t i = 0; i < requestInput.tensor_shape().dim_size(); i++) {
         shape.push_back(requestInput.tensor_shape().dim(i).size());
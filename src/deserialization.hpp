@@ -15,8 +15,10 @@
 //*****************************************************************************
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
@@ -28,13 +30,121 @@
 #pragma GCC diagnostic pop
 
 #include "binaryutils.hpp"
+#include "shared_memory.hpp"
+#include "sparse_tensor.hpp"
 #include "status.hpp"
+#include "tensor_buffer_pool.hpp"
 #include "tensorinfo.hpp"
 
 namespace ovms {
 
 InferenceEngine::TensorDesc getFinalTensorDesc(const ovms::TensorInfo& servableInfo, const tensorflow::TensorProto& requestInput, bool isPipeline);
 
+/**
+ * @brief Copies low 16 bits of each value, used for half_val and int_val fields holding FP16 and U16 data
+ *
+ * Uses AVX-512 or AVX2 when supported by the CPU at runtime, scalar loop otherwise.
+ *
+ * @param source
+ * @param destination
+ * @param count number of values
+ */
+void narrowInt32ToUint16(const int32_t* source, uint16_t* destination, size_t count);
+
+/**
+ * @brief Converts FP16 value, given by its bits, to FP32 without loss
+ */
+float convertFp16ToFp32(uint16_t half);
+
+/**
+ * @brief Checks if FP32 request data can be converted to given precision
+ */
+bool isConversionFromFp32Supported(InferenceEngine::Precision precision);
+
+/**
+ * @brief Converts FP32 values to FP16, U8 or I8
+ *
+ * FP16 is rounded to nearest even, integer precisions are rounded to nearest even and saturated.
+ * Uses F16C and AVX2 when supported by the CPU at runtime.
+ *
+ * @param precision target precision
+ * @param source
+ * @param destination buffer with count values of target precision
+ * @param count number of values
+ *
+ * @return false if precision is not supported
+ */
+bool convertFromFp32(InferenceEngine::Precision precision, const float* source, void* destination, size_t count);
+
+/**
+ * @brief Allocates blob of tensor precision and fills it with converted FP32 request data
+ *
+ * @return blob or nullptr if precision is not supported
+ */
+InferenceEngine::Blob::Ptr makeConvertedBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline);
+
+/**
+ * @brief Allocates zero filled blob of tensor precision and writes validated sparse request values at their indices
+ *
+ * @return blob or nullptr if precision is not supported
+ */
+InferenceEngine::Blob::Ptr makeSparseBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline);
+
+/**
+ * @brief Writes validated request data into allocated blob of network input instead of creating a new blob
+ *
+ * FP32 data of converted inputs is converted, half_val and int_val are narrowed and tensor_content is copied,
+ * or transposed for inputs transposed by the server.
+ *
+ * @return false if data was not written, for binary and shared memory inputs or if data size does not match the blob
+ */
+bool writeTensorProtoIntoBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, const InferenceEngine::Blob::Ptr& blob);
+
+/**
+ * @brief Allocates blob in network input layout and fills it with request data transposed from request layout
+ *
+ * @return blob or nullptr if request data is not in tensor_content or transposition is not supported
+ */
+InferenceEngine::Blob::Ptr makeTransposedBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo);
+
+/**
+ * @brief Allocates blob in network input layout and fills it with data of blob in request layout, passed between pipeline nodes
+ *
+ * @return blob or nullptr if precision or size does not match the tensor
+ */
+InferenceEngine::Blob::Ptr makeTransposedBlob(const InferenceEngine::Blob::Ptr& blob,
+    const std::shared_ptr<TensorInfo>& tensorInfo);
+
+/**
+ * @brief Wraps data of validated tensor placed in shared memory region, region stays mapped while blob exists
+ *
+ * @return blob or nullptr if region cannot be resolved or precision is not supported
+ */
+InferenceEngine::Blob::Ptr makeSharedMemoryBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline);
+
+/**
+ * @brief Wraps batch of NV12 or I420 frames, each Y plane followed by chroma planes, into NV12Blob or I420Blob
+ *
+ * Frames of batch larger than 1 are combined into BatchedBlob. Owner of data is kept alive while the blob exists.
+ *
+ * @return blob or nullptr if color format is neither NV12 nor I420
+ */
+InferenceEngine::Blob::Ptr makePlanarYuvBlob(InferenceEngine::ColorFormat colorFormat, size_t batch, size_t height, size_t width,
+    char* data, std::shared_ptr<const void> owner);
+
+/**
+ * @brief Wraps validated planar YUV frames of shape [N, H*3/2, W, 1] sent in tensor_content or placed in shared memory
+ *
+ * @return blob or nullptr if region cannot be resolved
+ */
+InferenceEngine::Blob::Ptr makePlanarYuvBlob(const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo);
+
 template <typename T>
 InferenceEngine::Blob::Ptr makeBlob(const tensorflow::TensorProto& requestInput,
     const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
@@ -48,6 +158,21 @@ public:
     static InferenceEngine::Blob::Ptr deserializeTensorProto(
         const tensorflow::TensorProto& requestInput,
         const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline) {
+        if (isSparseTensor(requestInput)) {
+            return makeSparseBlob(requestInput, tensorInfo, isPipeline);
+        }
+        if (!isPipeline && tensorInfo->isPlanarYuv()) {
+            return makePlanarYuvBlob(requestInput, tensorInfo);
+        }
+        if (tensorInfo->isConvertedFromDataType(requestInput.dtype())) {
+            return makeConvertedBlob(requestInput, tensorInfo, isPipeline);
+        }
+        if (isSharedMemoryReference(requestInput)) {
+            return makeSharedMemoryBlob(requestInput, tensorInfo, isPipeline);
+        }
+        if (!isPipeline && tensorInfo->isTransposedByServer()) {
+            return makeTransposedBlob(requestInput, tensorInfo);
+        }
         switch (tensorInfo->getPrecision()) {
         case InferenceEngine::Precision::FP32:
             return makeBlob<float>(requestInput, tensorInfo, isPipeline);
@@ -60,27 +185,23 @@ public:
         case InferenceEngine::Precision::I16:
             return makeBlob<int16_t>(requestInput, tensorInfo, isPipeline);
         case InferenceEngine::Precision::FP16: {
-            InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<uint16_t>(getFinalTensorDesc(*tensorInfo, requestInput, isPipeline));
-            blob->allocate();
+            if (requestInput.tensor_content().size() > 0) {
+                // Raw half precision values are used without conversion
+                return makeBlob<uint16_t>(requestInput, tensorInfo, isPipeline);
+            }
+            InferenceEngine::Blob::Ptr blob = makePooledBlob<uint16_t>(getFinalTensorDesc(*tensorInfo, requestInput, isPipeline));
             // Needs conversion due to zero padding for each value:
             // https://github.com/tensorflow/tensorflow/blob/v2.2.0/tensorflow/core/framework/tensor.proto#L55
             uint16_t* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
-            auto size = static_cast<size_t>(requestInput.half_val_size());
-            for (size_t i = 0; i < size; i++) {
-                ptr[i] = requestInput.half_val(i);
-            }
+            narrowInt32ToUint16(requestInput.half_val().data(), ptr, static_cast<size_t>(requestInput.half_val_size()));
             return blob;
         }
         case InferenceEngine::Precision::U16: {
-            InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<uint16_t>(getFinalTensorDesc(*tensorInfo, requestInput, isPipeline));
-            blob->allocate();
+            InferenceEngine::Blob::Ptr blob = makePooledBlob<uint16_t>(getFinalTensorDesc(*tensorInfo, requestInput, isPipeline));
             // Needs conversion due to zero padding for each value:
             // https://github.com/tensorflow/tensorflow/blob/v2.2.0/tensorflow/core/framework/tensor.proto#L55
             uint16_t* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
-            auto size = static_cast<size_t>(requestInput.int_val_size());
-            for (size_t i = 0; i < size; i++) {
-                ptr[i] = requestInput.int_val(i);
-            }
+            narrowInt32ToUint16(requestInput.int_val().data(), ptr, static_cast<size_t>(requestInput.int_val_size()));
             return blob;
         }
         case InferenceEngine::Precision::I64:
@@ -112,57 +233,115 @@ public:
     Status give(const std::string& name, InferenceEngine::Blob::Ptr blob);
 };
 
+/**
+ * @brief Sets threads shared by all requests, which deserialize large inputs of a request in parallel with the request thread
+ *
+ * @param workers 0 means inputs are deserialized one after another on the request thread
+ * @param minParallelInputBytes inputs with less request data are deserialized on the request thread
+ */
+void setDeserializationWorkers(size_t workers, size_t minParallelInputBytes);
+
+/**
+ * @return true if deserialization workers are set and request data of input is large enough to be deserialized by them
+ */
+bool isDeserializedInParallel(const tensorflow::TensorProto& requestInput);
+
+/**
+ * @brief Runs task for indexes from 0 to count on request thread and idle deserialization workers, after task returns false no more indexes are started
+ */
+void deserializeInParallel(size_t count, const std::function<bool(size_t)>& task);
+
+template <class TensorProtoDeserializator>
+Status deserializeRequestInput(const std::string& name, const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo, bool isPipeline, InferenceEngine::Blob::Ptr& blob) {
+    Status status;
+    try {
+        if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+            SPDLOG_DEBUG("Request contains binary input: {}", name);
+            status = convertStringValToBlob(requestInput, blob, tensorInfo, isPipeline);
+            if (!status.ok()) {
+                SPDLOG_DEBUG("Binary inputs conversion failed.");
+                return status;
+            }
+        } else {
+            blob = deserializeTensorProto<TensorProtoDeserializator>(
+                requestInput, tensorInfo, isPipeline);
+        }
+
+        if (blob == nullptr) {
+            status = StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+            SPDLOG_DEBUG(status.string());
+            return status;
+        }
+        // OV implementation the InferenceEngine::Exception is not
+        // a base class for all other exceptions thrown from OV.
+        // OV can throw exceptions derived from std::logic_error.
+    } catch (const InferenceEngine::Exception& e) {
+        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    } catch (std::logic_error& e) {
+        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    }
+    return status;
+}
+
 template <class TensorProtoDeserializator, class Sink>
 Status deserializePredictRequest(
     const tensorflow::serving::PredictRequest& request,
     const tensor_map_t& inputMap,
     Sink& inputSink, bool isPipeline) {
+    struct ParallelInput {
+        const std::string* name;
+        const tensorflow::TensorProto* requestInput;
+        const std::shared_ptr<TensorInfo>* tensorInfo;
+        InferenceEngine::Blob::Ptr blob;
+        Status status;
+    };
+    std::vector<ParallelInput> parallelInputs;
     Status status;
-    for (const auto& pair : inputMap) {
-        try {
-            const auto& name = pair.first;
-            auto tensorInfo = pair.second;
-            auto requestInputItr = request.inputs().find(name);
-            if (requestInputItr == request.inputs().end()) {
-                SPDLOG_DEBUG("Failed to deserialize request. Validation of request failed");
-                return Status(StatusCode::INTERNAL_ERROR, "Failed to deserialize request");
-            }
-            auto& requestInput = requestInputItr->second;
-            InferenceEngine::Blob::Ptr blob;
-
-            if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
-                SPDLOG_DEBUG("Request contains binary input: {}", name);
-                status = convertStringValToBlob(requestInput, blob, tensorInfo, isPipeline);
-                if (!status.ok()) {
-                    SPDLOG_DEBUG("Binary inputs conversion failed.");
-                    return status;
-                }
-            } else {
-                blob = deserializeTensorProto<TensorProtoDeserializator>(
-                    requestInput, tensorInfo, isPipeline);
-            }
-
-            if (blob == nullptr) {
-                status = StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
-                SPDLOG_DEBUG(status.string());
-                return status;
-            }
-            const std::string ovBlobName = isPipeline ? name : tensorInfo->getName();
-            status = inputSink.give(ovBlobName, blob);
-            if (!status.ok()) {
-                SPDLOG_DEBUG("Feeding inputs to inference performer failed:{}", status.string());
-                return status;
-            }
-            // OV implementation the InferenceEngine::Exception is not
-            // a base class for all other exceptions thrown from OV.
-            // OV can throw exceptions derived from std::logic_error.
-        } catch (const InferenceEngine::Exception& e) {
-            status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
-            SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+    for (const auto& [name, tensorInfo] : inputMap) {
+        auto requestInputItr = request.inputs().find(name);
+        if (requestInputItr == request.inputs().end()) {
+            SPDLOG_DEBUG("Failed to deserialize request. Validation of request failed");
+            return Status(StatusCode::INTERNAL_ERROR, "Failed to deserialize request");
+        }
+        auto& requestInput = requestInputItr->second;
+        if (isDeserializedInParallel(requestInput)) {
+            parallelInputs.push_back({&name, &requestInput, &tensorInfo, nullptr, StatusCode::OK});
+            continue;
+        }
+        InferenceEngine::Blob::Ptr blob;
+        status = deserializeRequestInput<TensorProtoDeserializator>(name, requestInput, tensorInfo, isPipeline, blob);
+        if (!status.ok()) {
             return status;
-        } catch (std::logic_error& e) {
-            status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
-            SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        }
+        const std::string ovBlobName = isPipeline ? name : tensorInfo->getName();
+        status = inputSink.give(ovBlobName, blob);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Feeding inputs to inference performer failed:{}", status.string());
+            return status;
+        }
+    }
+    if (parallelInputs.empty()) {
+        return status;
+    }
+    deserializeInParallel(parallelInputs.size(), [&parallelInputs, isPipeline](size_t i) {
+        auto& input = parallelInputs[i];
+        input.status = deserializeRequestInput<TensorProtoDeserializator>(*input.name, *input.requestInput, *input.tensorInfo, isPipeline, input.blob);
+        return input.status.ok();
+    });
+    // inputs are handed out in order, so inputs not started after a failure follow the failed one
+    for (auto& input : parallelInputs) {
+        if (!input.status.ok()) {
+            return input.status;
+        }
+        const std::string ovBlobName = isPipeline ? *input.name : (*input.tensorInfo)->getName();
+        status = inputSink.give(ovBlobName, input.blob);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Feeding inputs to inference performer failed:{}", status.string());
             return status;
         }
     }
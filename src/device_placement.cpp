@@ -0,0 +1,328 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "device_placement.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+
+#include <spdlog/spdlog.h>
+
+#include "modelconfig.hpp"
+#include "modelinstance.hpp"
+#include "modelinstanceunloadguard.hpp"
+#include "modelmanager.hpp"
+#include "pipelinedefinition.hpp"
+#include "pipelinedefinitionunloadguard.hpp"
+#include "servable_benchmark.hpp"
+
+namespace ovms {
+
+DevicePlacementPlanner::DevicePlacementPlanner(std::vector<PlacementModel> models, std::vector<PlacementNode> nodes, std::vector<PlacementEdge> edges, double transferBytesPerUs) :
+    models(std::move(models)),
+    nodes(std::move(nodes)),
+    edges(std::move(edges)),
+    transferBytesPerUs(transferBytesPerUs) {
+    std::vector<size_t> pendingDependencies(this->nodes.size(), 0);
+    std::vector<std::vector<size_t>> dependants(this->nodes.size());
+    for (const auto& edge : this->edges) {
+        dependants[edge.dependency].push_back(edge.dependant);
+        ++pendingDependencies[edge.dependant];
+    }
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < pendingDependencies.size(); ++i) {
+        if (pendingDependencies[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    while (!ready.empty()) {
+        const size_t node = ready.back();
+        ready.pop_back();
+        topologicalOrder.push_back(node);
+        for (size_t dependant : dependants[node]) {
+            if (--pendingDependencies[dependant] == 0) {
+                ready.push_back(dependant);
+            }
+        }
+    }
+}
+
+Placement DevicePlacementPlanner::evaluate(const std::vector<std::string>& devices) const {
+    Placement placement;
+    placement.devices = devices;
+    std::vector<std::string> nodeDevices(nodes.size(), HOST_DEVICE);
+    std::vector<double> nodeLatencies(nodes.size(), 0);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].model) {
+            const size_t model = nodes[i].model.value();
+            nodeDevices[i] = devices[model];
+            nodeLatencies[i] = models[model].latencyUs.at(devices[model]);
+        }
+    }
+    std::vector<std::vector<const PlacementEdge*>> incoming(nodes.size());
+    for (const auto& edge : edges) {
+        incoming[edge.dependant].push_back(&edge);
+    }
+    std::map<std::string, double> deviceLoads;
+    std::vector<double> finished(nodes.size(), 0);
+    for (size_t node : topologicalOrder) {
+        double start = 0;
+        for (const auto* edge : incoming[node]) {
+            double transferUs = 0;
+            if (nodeDevices[edge->dependency] != nodeDevices[node] && transferBytesPerUs > 0) {
+                transferUs = static_cast<double>(edge->bytes) / transferBytesPerUs;
+            }
+            start = std::max(start, finished[edge->dependency] + transferUs);
+            deviceLoads[nodeDevices[node]] += transferUs;
+        }
+        finished[node] = start + nodeLatencies[node];
+        deviceLoads[nodeDevices[node]] += nodeLatencies[node];
+        placement.latencyUs = std::max(placement.latencyUs, finished[node]);
+    }
+    for (const auto& [device, load] : deviceLoads) {
+        placement.bottleneckUs = std::max(placement.bottleneckUs, load);
+    }
+    return placement;
+}
+
+bool DevicePlacementPlanner::isBetter(const Placement& candidate, const Placement& best, PlacementObjective objective) {
+    if (objective == PlacementObjective::LATENCY) {
+        return std::make_pair(candidate.latencyUs, candidate.bottleneckUs) < std::make_pair(best.latencyUs, best.bottleneckUs);
+    }
+    return std::make_pair(candidate.bottleneckUs, candidate.latencyUs) < std::make_pair(best.bottleneckUs, best.latencyUs);
+}
+
+Placement DevicePlacementPlanner::plan(PlacementObjective objective) const {
+    std::vector<std::vector<std::string>> candidates(models.size());
+    std::vector<std::string> devices(models.size());
+    size_t placementsCount = 1;
+    for (size_t i = 0; i < models.size(); ++i) {
+        for (const auto& [device, latencyUs] : models[i].latencyUs) {
+            candidates[i].push_back(device);
+            if (devices[i].empty() || latencyUs < models[i].latencyUs.at(devices[i])) {
+                devices[i] = device;
+            }
+        }
+        if (candidates[i].empty()) {
+            return {};
+        }
+        placementsCount = placementsCount > MAX_EXHAUSTIVE_PLACEMENTS / candidates[i].size() ? MAX_EXHAUSTIVE_PLACEMENTS + 1 : placementsCount * candidates[i].size();
+    }
+
+    Placement best = evaluate(devices);
+    if (placementsCount <= MAX_EXHAUSTIVE_PLACEMENTS) {
+        std::vector<size_t> indexes(models.size(), 0);
+        while (true) {
+            for (size_t i = 0; i < models.size(); ++i) {
+                devices[i] = candidates[i][indexes[i]];
+            }
+            auto placement = evaluate(devices);
+            if (isBetter(placement, best, objective)) {
+                best = std::move(placement);
+            }
+            size_t i = 0;
+            while (i < models.size() && ++indexes[i] == candidates[i].size()) {
+                indexes[i++] = 0;
+            }
+            if (i == models.size()) {
+                return best;
+            }
+        }
+    }
+
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (size_t i = 0; i < models.size(); ++i) {
+            devices = best.devices;
+            for (const auto& device : candidates[i]) {
+                devices[i] = device;
+                auto placement = evaluate(devices);
+                if (isBetter(placement, best, objective)) {
+                    best = std::move(placement);
+                    improved = true;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+DevicePlacementProfiler::DevicePlacementProfiler(ModelManager& manager, const std::string& pipelineName, std::vector<std::string> devices, uint32_t iterations, double transferBytesPerUs) :
+    manager(manager),
+    pipelineName(pipelineName),
+    devices(std::move(devices)),
+    iterations(std::max<uint32_t>(1, iterations)),
+    transferBytesPerUs(transferBytesPerUs) {}
+
+Status DevicePlacementProfiler::measure(const std::string& modelName, model_version_t version, const std::string& device, double& latencyUs) const {
+    auto served = manager.findModelInstance(modelName, version);
+    if (!served) {
+        return StatusCode::MODEL_VERSION_MISSING;
+    }
+    ModelConfig config = served->getModelConfig();
+    if (config.isStateful()) {
+        return StatusCode::NOT_IMPLEMENTED;
+    }
+    config.setTargetDevice(device);
+    config.setLazyLoading(false);
+    auto instance = std::make_shared<ModelInstance>(modelName, version);
+    auto status = instance->loadModel(config);
+    if (!status.ok()) {
+        return status;
+    }
+    std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+    status = instance->waitForLoaded(0, unloadGuard);
+    tensorflow::serving::PredictRequest request;
+    if (status.ok()) {
+        status = ServableBenchmark::prepareRequest(modelName, instance->getInputsInfo(), request);
+    }
+    std::chrono::steady_clock::duration elapsed{0};
+    for (uint32_t i = 0; status.ok() && i < WARMUP_ITERATIONS + iterations; ++i) {
+        tensorflow::serving::PredictResponse response;
+        const auto start = std::chrono::steady_clock::now();
+        status = instance->infer(&request, &response, unloadGuard);
+        if (i >= WARMUP_ITERATIONS) {
+            elapsed += std::chrono::steady_clock::now() - start;
+        }
+    }
+    unloadGuard.reset();
+    instance->retireModel();
+    if (!status.ok()) {
+        return status;
+    }
+    latencyUs = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) / iterations;
+    return StatusCode::OK;
+}
+
+static uint64_t getTensorBytes(const TensorInfo& info) {
+    uint64_t elementsCount = 1;
+    for (auto dim : info.getEffectiveShape()) {
+        elementsCount *= dim == 0 ? 1 : dim;
+    }
+    return elementsCount * info.getPrecision().size();
+}
+
+static uint64_t getTensorBytes(const tensor_map_t& tensors, const std::string& name) {
+    auto it = tensors.find(name);
+    return it == tensors.end() ? 0 : getTensorBytes(*it->second);
+}
+
+Status DevicePlacementProfiler::run() {
+    auto* definition = manager.getPipelineFactory().findDefinitionByName(pipelineName);
+    if (definition == nullptr) {
+        return StatusCode::PIPELINE_DEFINITION_NAME_MISSING;
+    }
+    std::unique_ptr<PipelineDefinitionUnloadGuard> unloadGuard;
+    auto status = definition->waitForLoaded(unloadGuard);
+    if (!status.ok()) {
+        return status;
+    }
+    std::vector<PlacementModel> models;
+    std::vector<PlacementNode> nodes;
+    std::map<std::string, size_t> nodeIndexes;
+    std::map<std::string, std::shared_ptr<ModelInstance>> nodeInstances;
+    const auto& nodeInfos = definition->getNodeInfos();
+    for (const auto& info : nodeInfos) {
+        PlacementNode node{info.nodeName, std::nullopt};
+        if (info.kind == NodeKind::DL) {
+            auto instance = manager.findModelInstance(info.modelName, info.modelVersion.value_or(0));
+            if (!instance) {
+                return StatusCode::MODEL_VERSION_MISSING;
+            }
+            nodeInstances[info.nodeName] = instance;
+            auto it = std::find_if(models.begin(), models.end(), [&instance](const PlacementModel& model) {
+                return model.name == instance->getName() && model.version == instance->getVersion();
+            });
+            node.model = static_cast<size_t>(it - models.begin());
+            if (it == models.end()) {
+                PlacementModel model{instance->getName(), instance->getVersion(), {}};
+                for (const auto& device : devices) {
+                    SPDLOG_INFO("Measuring model: {}; version: {} on device: {}", model.name, model.version, device);
+                    double latencyUs = 0;
+                    status = measure(model.name, model.version, device, latencyUs);
+                    if (!status.ok()) {
+                        SPDLOG_WARN("Cannot measure model: {}; version: {} on device: {}; {}", model.name, model.version, device, status.string());
+                        continue;
+                    }
+                    model.latencyUs[device] = latencyUs;
+                }
+                models.push_back(std::move(model));
+            }
+        }
+        nodeIndexes[info.nodeName] = nodes.size();
+        nodes.push_back(std::move(node));
+    }
+
+    const auto pipelineInputsInfo = definition->getInputsInfo();
+    std::vector<PlacementEdge> edges;
+    for (const auto& [dependantName, dependencies] : definition->getConnections()) {
+        for (const auto& [dependencyName, mapping] : dependencies) {
+            const auto& dependencyInfo = nodeInfos[nodeIndexes.at(dependencyName)];
+            uint64_t bytes = 0;
+            for (const auto& [alias, realName] : mapping) {
+                if (nodeInstances.count(dependantName)) {
+                    bytes += getTensorBytes(nodeInstances.at(dependantName)->getInputsInfo(), realName);
+                } else if (dependencyInfo.kind == NodeKind::DL) {
+                    auto it = dependencyInfo.outputNameAliases.find(alias);
+                    bytes += getTensorBytes(nodeInstances.at(dependencyName)->getOutputsInfo(), it == dependencyInfo.outputNameAliases.end() ? alias : it->second);
+                } else if (dependencyInfo.kind == NodeKind::ENTRY) {
+                    bytes += getTensorBytes(pipelineInputsInfo, alias);
+                }
+            }
+            edges.push_back({nodeIndexes.at(dependencyName), nodeIndexes.at(dependantName), bytes});
+        }
+    }
+    planner.emplace(std::move(models), std::move(nodes), std::move(edges), transferBytesPerUs);
+    return StatusCode::OK;
+}
+
+static void printPlacement(std::ostream& out, const std::string& title, const Placement& placement, const std::vector<PlacementModel>& models) {
+    if (placement.devices.size() != models.size()) {
+        out << title << ": none, some models could not be measured on any device" << std::endl;
+        return;
+    }
+    out << title << ", estimated latency: " << placement.latencyUs / 1000.0 << " ms, throughput: " << placement.getThroughput() << " executions/s" << std::endl;
+    for (size_t i = 0; i < models.size(); ++i) {
+        out << "  " << models[i].name << " version " << models[i].version << ": target_device " << placement.devices[i] << std::endl;
+    }
+}
+
+void DevicePlacementProfiler::report(std::ostream& out) const {
+    if (!planner) {
+        return;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "Device placement of pipeline: " << pipelineName << ", mean inference latency:" << std::endl;
+    for (const auto& model : planner->getModels()) {
+        out << "  " << model.name << " version " << model.version << ":";
+        for (const auto& device : devices) {
+            auto it = model.latencyUs.find(device);
+            out << " " << device << " ";
+            if (it == model.latencyUs.end()) {
+                out << "failed";
+            } else {
+                out << it->second / 1000.0 << " ms";
+            }
+        }
+        out << std::endl;
+    }
+    printPlacement(out, "Lowest latency placement", planner->plan(PlacementObjective::LATENCY), planner->getModels());
+    printPlacement(out, "Highest throughput placement", planner->plan(PlacementObjective::THROUGHPUT), planner->getModels());
+}
+
+}  // namespace ovms
@@ -0,0 +1,154 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "modelversion.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+class ModelManager;
+
+/**
+ * @brief Model used by DL nodes of pipeline, with mean inference latency measured on each device it could be loaded on
+ */
+struct PlacementModel {
+    std::string name;
+    model_version_t version = 0;
+    std::map<std::string, double> latencyUs;
+};
+
+/**
+ * @brief Node of pipeline, nodes without model run on host
+ */
+struct PlacementNode {
+    std::string name;
+    std::optional<size_t> model;
+};
+
+struct PlacementEdge {
+    size_t dependency;
+    size_t dependant;
+    // bytes of tensors sent over connection in single execution
+    uint64_t bytes;
+};
+
+enum class PlacementObjective {
+    LATENCY,
+    THROUGHPUT
+};
+
+/**
+ * @brief Target devices of models with estimated latency and device load of single pipeline execution
+ */
+struct Placement {
+    std::vector<std::string> devices;
+    // the longest path through pipeline, including transfers between devices
+    double latencyUs = 0;
+    // time the busiest device spends on single execution, bounding throughput
+    double bottleneckUs = 0;
+
+    double getThroughput() const {
+        return bottleneckUs > 0 ? 1'000'000.0 / bottleneckUs : 0;
+    }
+};
+
+/**
+ * @brief Chooses target device of each model of pipeline to minimize latency or maximize throughput
+ *
+ * Node takes measured latency of its model on the device the model is placed on. Tensors sent between nodes
+ * on different devices take their size divided by transfer bandwidth, nodes without model are on host device.
+ * Latency of placement is the longest path through the graph, throughput is bound by the device with the most
+ * node and incoming transfer time per execution. All placements are evaluated when there are at most
+ * MAX_EXHAUSTIVE_PLACEMENTS of them, otherwise the fastest device of each model is improved by moving single
+ * models while the objective improves.
+ */
+class DevicePlacementPlanner {
+public:
+    static constexpr const char* HOST_DEVICE = "CPU";
+    static constexpr size_t MAX_EXHAUSTIVE_PLACEMENTS = 4096;
+
+    /**
+     * @param transferBytesPerUs bandwidth of transfers between devices
+     */
+    DevicePlacementPlanner(std::vector<PlacementModel> models, std::vector<PlacementNode> nodes, std::vector<PlacementEdge> edges, double transferBytesPerUs);
+
+    /**
+     * @param devices target device of each model, has to be one the model has latency measured on
+     */
+    Placement evaluate(const std::vector<std::string>& devices) const;
+
+    /**
+     * @return placement with empty devices if any model has no measured device
+     */
+    Placement plan(PlacementObjective objective) const;
+
+    const std::vector<PlacementModel>& getModels() const {
+        return models;
+    }
+
+private:
+    const std::vector<PlacementModel> models;
+    const std::vector<PlacementNode> nodes;
+    const std::vector<PlacementEdge> edges;
+    const double transferBytesPerUs;
+    // nodes ordered so that dependencies precede their dependants
+    std::vector<size_t> topologicalOrder;
+
+    static bool isBetter(const Placement& candidate, const Placement& best, PlacementObjective objective);
+};
+
+/**
+ * @brief Measures models of DL nodes of pipeline on each device and prints placements planned from measurements
+ *
+ * Each model is loaded with configuration of the served version and target device replaced, in another instance
+ * not serving requests, and inferred with synthetic inputs. Bytes of tensors sent between nodes are computed from
+ * inputs info of dependant model or outputs info of dependency model, with dimensions not known before inference as 1.
+ */
+class DevicePlacementProfiler {
+public:
+    static constexpr uint32_t WARMUP_ITERATIONS = 2;
+
+    DevicePlacementProfiler(ModelManager& manager, const std::string& pipelineName, std::vector<std::string> devices, uint32_t iterations, double transferBytesPerUs);
+
+    Status run();
+
+    /**
+     * @brief Prints measured latencies and placements with the lowest latency and the highest throughput
+     */
+    void report(std::ostream& out) const;
+
+private:
+    ModelManager& manager;
+    const std::string pipelineName;
+    const std::vector<std::string> devices;
+    const uint32_t iterations;
+    const double transferBytesPerUs;
+
+    std::optional<DevicePlacementPlanner> planner;
+
+    Status measure(const std::string& modelName, model_version_t version, const std::string& device, double& latencyUs) const;
+};
+
+}  // namespace ovms
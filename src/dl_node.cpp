@@ -15,27 +15,30 @@
 //*****************************************************************************
 #include "dl_node.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include <inference_engine.hpp>
 
+#include "blob_view_allocator.hpp"
 #include "dlnodesession.hpp"
 #include "logging.hpp"
 #include "modelmanager.hpp"
 #include "ov_utils.hpp"
 #include "ovinferrequestsqueue.hpp"
 #include "prediction_service_utils.hpp"
+#include "tensorinfo.hpp"
 #include "timer.hpp"
 
 namespace ovms {
 
-const uint WAIT_FOR_STREAM_ID_TIMEOUT_MICROSECONDS = 1;
-
 Status DLNode::execute(session_key_t sessionKey, PipelineEventQueue& notifyEndQueue) {
     auto& nodeSession = getNodeSession(sessionKey);
     auto& dlNodeSession = static_cast<DLNodeSession&>(nodeSession);
-    return dlNodeSession.execute(notifyEndQueue, WAIT_FOR_STREAM_ID_TIMEOUT_MICROSECONDS, *this);
+    return dlNodeSession.execute(notifyEndQueue, *this);
 }
 
 Status DLNode::fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) {
@@ -50,14 +53,80 @@ Status DLNode::fetchResults(NodeSession& nodeSession, SessionResults& nodeSessio
     }
     auto& metadataBlobResultsPair = it.first->second;
     auto& blobResults = metadataBlobResultsPair.second;
+    if (dlNodeSession.isBatchMember()) {
+        // results were split from batched inference when fetching results of batch leader session
+        blobResults = std::move(dlNodeSession.getBatchResults());
+        return StatusCode::OK;
+    }
+    if (dlNodeSession.isInferenceSkipped()) {
+        ReleaseSessionGuard releaseSessionGuard(nodeSession);
+        return fetchEmptyResults(blobResults, dlNodeSession.getModelInstance());
+    }
+    if (dlNodeSession.isQueuedToModelBatcher()) {
+        return fetchModelBatcherResults(blobResults, dlNodeSession);
+    }
     Status status;
-    const uint waitTimeMicroseconds = 1;
-    auto& inferRequest = dlNodeSession.getInferRequest(waitTimeMicroseconds);
+    auto& inferRequest = dlNodeSession.getInferRequest();
     auto& model = dlNodeSession.getModelInstance();
     status = this->fetchResults(blobResults, inferRequest, model, nodeSession.getSessionKey());
     return status;
 }
 
+Status DLNode::fetchModelBatcherResults(BlobMap& outputs, DLNodeSession& nodeSession) {
+    ReleaseSessionGuard releaseSessionGuard(nodeSession);
+    observeExecutionTime(nodeSession.getTimer().elapsed<std::chrono::microseconds>(NodeSession::INFERENCE));
+    if (!nodeSession.getModelBatcherStatus().ok()) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} batch of model dynamic batcher failed: {}",
+            getName(), nodeSession.getSessionKey(), nodeSession.getModelBatcherStatus().string());
+        return nodeSession.getModelBatcherStatus();
+    }
+    // outputs of the batch are sliced for the session under model output names
+    auto& batchResults = nodeSession.getBatchResults();
+    for (const auto& link : getOutputLinks()) {
+        const auto& outputName = *link.outputName;
+        if (outputs.count(outputName) > 0) {
+            continue;
+        }
+        auto it = nodeOutputNameAlias.find(outputName);
+        const auto& modelOutputName = it != nodeOutputNameAlias.end() ? it->second : outputName;
+        auto resultIt = batchResults.find(modelOutputName);
+        if (resultIt == batchResults.end()) {
+            SPDLOG_LOGGER_WARN(dag_executor_logger, "Node: {} cannot find model output for alias: {}", getName(), outputName);
+            return StatusCode::INTERNAL_ERROR;
+        }
+        outputs.emplace(outputName, resultIt->second);
+    }
+    return StatusCode::OK;
+}
+
+Status DLNode::fetchEmptyResults(BlobMap& outputs, ModelInstance& model) {
+    for (const auto& link : getOutputLinks()) {
+        const auto& outputName = *link.outputName;
+        if (outputs.count(outputName) > 0) {
+            continue;
+        }
+        auto it = nodeOutputNameAlias.find(outputName);
+        const auto& modelOutputName = it != nodeOutputNameAlias.end() ? it->second : outputName;
+        auto outputIt = model.getOutputsInfo().find(modelOutputName);
+        if (outputIt == model.getOutputsInfo().end()) {
+            SPDLOG_LOGGER_WARN(dag_executor_logger, "Node: {} cannot find model output for alias: {}", getName(), outputName);
+            return StatusCode::INTERNAL_ERROR;
+        }
+        auto dims = outputIt->second->getShape();
+        if (!dims.empty()) {
+            dims[0] = 0;
+        }
+        const InferenceEngine::TensorDesc desc(outputIt->second->getPrecision(), dims, InferenceEngine::Layout::ANY);
+        InferenceEngine::Blob::Ptr blob;
+        auto status = blobAllocator ? createSharedBlob(blob, desc, blobAllocator) : createSharedBlob(blob, desc);
+        if (!status.ok()) {
+            return status;
+        }
+        outputs.emplace(outputName, std::move(blob));
+    }
+    return StatusCode::OK;
+}
+
 Status DLNode::fetchResults(BlobMap& outputs, InferenceEngine::InferRequest& inferRequest, ModelInstance& model, session_key_t sessionKey) {
     ReleaseSessionGuard releaseSessionGuard(this->getNodeSession(sessionKey));
     // Wait for blob results
@@ -77,7 +146,8 @@ Status DLNode::fetchResults(BlobMap& outputs, InferenceEngine::InferRequest& inf
         this->getName(),
         model.getName(),
         sessionKey,
-        this->getNodeSession(sessionKey).getTimer().elapsed<std::chrono::microseconds>("inference") / 1000);
+        this->getNodeSession(sessionKey).getTimer().elapsed<std::chrono::microseconds>(NodeSession::INFERENCE) / 1000);
+    observeExecutionTime(this->getNodeSession(sessionKey).getTimer().elapsed<std::chrono::microseconds>(NodeSession::INFERENCE));
 
     static_cast<DLNodeSession&>(this->getNodeSession(sessionKey)).clearInputs();
     if (ov_status != InferenceEngine::StatusCode::OK) {
@@ -87,56 +157,273 @@ Status DLNode::fetchResults(BlobMap& outputs, InferenceEngine::InferRequest& inf
     }
 
     // Fill outputs map with result blobs. Fetch only those that are required in following nodes.
-    for (const auto& node : this->next) {
-        for (const auto& pair : node.get().getMappingByDependency(*this)) {
-            const auto& output_name = pair.first;
-            if (outputs.find(output_name) != outputs.end()) {
+    const auto& gatheredOutputs = static_cast<DLNodeSession&>(this->getNodeSession(sessionKey)).getGatheredOutputs();
+    const auto& boundOutputs = static_cast<DLNodeSession&>(this->getNodeSession(sessionKey)).getBoundOutputs();
+    for (const auto& link : getOutputLinks()) {
+        const auto& output_name = *link.outputName;
+        if (outputs.find(output_name) != outputs.end()) {
+            continue;
+        }
+        auto gatheredIt = gatheredOutputs.find(output_name);
+        if (gatheredIt != gatheredOutputs.end()) {
+            // inference has written this output in place of following node input, no copy is needed
+            outputs.emplace(output_name, gatheredIt->second);
+            continue;
+        }
+        auto boundIt = boundOutputs.find(output_name);
+        if (boundIt != boundOutputs.end()) {
+            // inference has written this output into server owned blob, it is handed over instead of copied
+            auto& nodeSession = static_cast<DLNodeSession&>(this->getNodeSession(sessionKey));
+            if (nodeSession.hasBatchedInputs()) {
+                auto status = splitBatchedOutput(nodeSession, output_name, boundIt->second, outputs);
+                if (!status.ok()) {
+                    return status;
+                }
                 continue;
             }
+            outputs.emplace(output_name, boundIt->second);
+            continue;
+        }
 
-            try {
-                std::string realModelOutputName;
-                if (!getRealOutputName(model, output_name, &realModelOutputName).ok()) {
-                    SPDLOG_LOGGER_WARN(dag_executor_logger, "Node: {} session: {} Cannot find real model output name for alias: {}", getName(), sessionKey, output_name);
-                    return StatusCode::INTERNAL_ERROR;
-                }
-                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Getting blob from model: {}, inferRequestStreamId: {}, blobName: {}",
-                    getName(), sessionKey, modelName, sessionKey, realModelOutputName);
-                const auto blob = inferRequest.GetBlob(realModelOutputName);
-                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Creating copy of blob from model: {}, blobName: {}",
-                    getName(), sessionKey, modelName, realModelOutputName);
-                InferenceEngine::Blob::Ptr copiedBlob;
-                auto status = blobClone(copiedBlob, blob);
+        try {
+            std::string realModelOutputName;
+            if (!getRealOutputName(model, output_name, &realModelOutputName).ok()) {
+                SPDLOG_LOGGER_WARN(dag_executor_logger, "Node: {} session: {} Cannot find real model output name for alias: {}", getName(), sessionKey, output_name);
+                return StatusCode::INTERNAL_ERROR;
+            }
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Getting blob from model: {}, inferRequestStreamId: {}, blobName: {}",
+                getName(), sessionKey, modelName, sessionKey, realModelOutputName);
+            const auto blob = inferRequest.GetBlob(realModelOutputName);
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Creating copy of blob from model: {}, blobName: {}",
+                getName(), sessionKey, modelName, realModelOutputName);
+            InferenceEngine::Blob::Ptr copiedBlob;
+            auto status = blobClone(copiedBlob, blob, blobAllocator);
+            if (!status.ok()) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Could not clone result blob; node: {}; session: {}; model name: {}; output: {}",
+                    getName(),
+                    this->modelName,
+                    realModelOutputName);
+                return status;
+            }
+            auto& nodeSession = static_cast<DLNodeSession&>(this->getNodeSession(sessionKey));
+            if (nodeSession.hasBatchedInputs()) {
+                status = splitBatchedOutput(nodeSession, output_name, copiedBlob, outputs);
                 if (!status.ok()) {
-                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Could not clone result blob; node: {}; session: {}; model name: {}; output: {}",
-                        getName(),
-                        this->modelName,
-                        realModelOutputName);
                     return status;
                 }
-                outputs.emplace(std::make_pair(output_name, std::move(copiedBlob)));
-            } catch (const InferenceEngine::Exception& e) {
-                Status status = StatusCode::OV_INTERNAL_SERIALIZATION_ERROR;
-                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session:{} Error during getting blob {}; exception message: {}", getName(), sessionKey, status.string(), e.what());
-                return status;
+                continue;
             }
-            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Blob with name {} has been prepared", getName(), sessionKey, output_name);
+            outputs.emplace(std::make_pair(output_name, std::move(copiedBlob)));
+        } catch (const InferenceEngine::Exception& e) {
+            Status status = StatusCode::OV_INTERNAL_SERIALIZATION_ERROR;
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session:{} Error during getting blob {}; exception message: {}", getName(), sessionKey, status.string(), e.what());
+            return status;
         }
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Blob with name {} has been prepared", getName(), sessionKey, output_name);
     }
     return StatusCode::OK;
 }
 
+Status DLNode::splitBatchedOutput(DLNodeSession& nodeSession, const std::string& outputName, const InferenceEngine::Blob::Ptr& batchedBlob, BlobMap& outputs) {
+    const auto& memberKeys = nodeSession.getBatchMemberKeys();
+    const auto& batchedDesc = batchedBlob->getTensorDesc();
+    auto dims = batchedDesc.getDims();
+    if (dims.size() == 0 || dims[0] < memberKeys.size() + 1) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} output: {} with shape: {} cannot be split into: {} shards",
+            getName(), nodeSession.getSessionKey(), outputName, TensorInfo::shapeToString(dims), memberKeys.size() + 1);
+        return StatusCode::INTERNAL_ERROR;
+    }
+    const auto step = batchedBlob->byteSize() / dims[0];
+    dims[0] = 1;
+    const InferenceEngine::TensorDesc shardDesc(batchedDesc.getPrecision(), dims, InferenceEngine::Layout::ANY);
+    char* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(batchedBlob)->rmap().as<char*>();
+    // First shard of batch belongs to leader session, remaining ones to its members in order of batching
+    for (size_t i = 0; i <= memberKeys.size(); ++i) {
+        InferenceEngine::Blob::Ptr shard;
+        auto status = createSharedBlob(shard, shardDesc, std::make_shared<BlobViewAllocator>(batchedBlob, data + i * step));
+        if (!status.ok()) {
+            return status;
+        }
+        if (i == 0) {
+            outputs.emplace(outputName, std::move(shard));
+        } else {
+            static_cast<DLNodeSession&>(this->getNodeSession(memberKeys[i - 1])).getBatchResults().emplace(outputName, std::move(shard));
+        }
+    }
+    return StatusCode::OK;
+}
+
+static bool isShardOfBatch(const BlobMap& inputs, const tensor_map_t& inputsInfo, size_t batchSize) {
+    if (inputs.size() != inputsInfo.size()) {
+        return false;
+    }
+    for (const auto& [name, blob] : inputs) {
+        auto it = inputsInfo.find(name);
+        if (it == inputsInfo.end() || it->second->getPrecision() != blob->getTensorDesc().getPrecision()) {
+            return false;
+        }
+        const auto& modelShape = it->second->getEffectiveShape();
+        const auto& shardShape = getEffectiveBlobShape(blob);
+        if (modelShape.size() == 0 || modelShape.size() != shardShape.size() || modelShape[0] != batchSize || shardShape[0] != 1 ||
+            !std::equal(modelShape.begin() + 1, modelShape.end(), shardShape.begin() + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool areInputsMatching(const BlobMap& lhs, const BlobMap& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (const auto& [name, blob] : lhs) {
+        auto it = rhs.find(name);
+        if (it == rhs.end() ||
+            it->second->getTensorDesc().getPrecision() != blob->getTensorDesc().getPrecision() ||
+            it->second->getTensorDesc().getDims() != blob->getTensorDesc().getDims()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Status DLNode::batchShards(DLNodeSession& nodeSession, PipelineEventQueue& notifyEndQueue) {
+    // gathering node sessions collect their shards themselves
+    if (!batchShardsEnabled || gatherFrom) {
+        return StatusCode::OK;
+    }
+    auto& model = nodeSession.getModelInstance();
+    // with automatic batch size each batch size change would reload the model
+    if (model.getModelConfig().getBatchingMode() == Mode::AUTO) {
+        return StatusCode::OK;
+    }
+    const size_t batchSize = model.getBatchSize();
+    const auto& leaderInputs = nodeSession.peekInputs();
+    if (batchSize <= 1 || !isShardOfBatch(leaderInputs, model.getInputsInfo(), batchSize)) {
+        return StatusCode::OK;
+    }
+    std::vector<DLNodeSession*> members;
+    for (auto& [sessionKey, session] : nodeSessions) {
+        if (members.size() + 1 >= batchSize) {
+            break;
+        }
+        if (session.get() == &nodeSession || !session->isReady()) {
+            continue;
+        }
+        auto& candidate = static_cast<DLNodeSession&>(*session);
+        if (areInputsMatching(leaderInputs, candidate.peekInputs())) {
+            members.emplace_back(&candidate);
+        }
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} batching: {} shards into batch of size: {}",
+        getName(), nodeSession.getSessionKey(), members.size() + 1, batchSize);
+    BlobMap batchedInputs;
+    for (const auto& [name, blob] : leaderInputs) {
+        const auto& shardDesc = blob->getTensorDesc();
+        auto dims = shardDesc.getDims();
+        dims[0] = batchSize;
+        InferenceEngine::Blob::Ptr batchedBlob;
+        const InferenceEngine::TensorDesc batchedDesc(shardDesc.getPrecision(), dims, InferenceEngine::Layout::ANY);
+        auto status = blobAllocator ? createSharedBlob(batchedBlob, batchedDesc, blobAllocator) : createSharedBlob(batchedBlob, batchedDesc);
+        if (!status.ok()) {
+            return status;
+        }
+        const auto step = blob->byteSize();
+        char* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(batchedBlob)->wmap().as<char*>();
+        std::memcpy(data, InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const char*>(), step);
+        for (size_t i = 0; i < members.size(); ++i) {
+            const auto& memberBlob = members[i]->peekInputs().at(name);
+            std::memcpy(data + (i + 1) * step, InferenceEngine::as<InferenceEngine::MemoryBlob>(memberBlob)->rmap().as<const char*>(), step);
+        }
+        std::memset(data + (members.size() + 1) * step, 0, (batchSize - members.size() - 1) * step);
+        batchedInputs.emplace(name, std::move(batchedBlob));
+    }
+    std::vector<session_key_t> memberKeys;
+    memberKeys.reserve(members.size());
+    for (const auto* member : members) {
+        memberKeys.emplace_back(member->getSessionKey());
+    }
+    auto status = nodeSession.setBatchedInputs(batchedInputs, std::move(memberKeys), notifyEndQueue);
+    if (!status.ok()) {
+        return status;
+    }
+    for (auto* member : members) {
+        member->joinBatch(nodeSession.getSessionKey());
+    }
+    return StatusCode::OK;
+}
+
+void DLNode::setGatheredOutputs(DLNodeSession& nodeSession, InferenceEngine::InferRequest& inferRequest) {
+    // demultiplexer outputs are split into new sessions before reaching following nodes,
+    // batched outputs are split into shard sessions after inference
+    if (demultiplexCount || nodeSession.hasBatchedInputs()) {
+        return;
+    }
+    // outputs of network compiled for shapes of node inputs may differ from model outputs
+    const auto& outputsInfo = nodeSession.getOutputsInfo();
+    for (const auto& link : getOutputLinks()) {
+        const auto& outputName = *link.outputName;
+        if (nodeSession.getGatheredOutputs().count(outputName) > 0) {
+            continue;
+        }
+        auto it = nodeOutputNameAlias.find(outputName);
+        const auto& modelOutputName = it != nodeOutputNameAlias.end() ? it->second : outputName;
+        auto outputIt = outputsInfo.find(modelOutputName);
+        if (outputIt == outputsInfo.end()) {
+            // missing output is reported when fetching results
+            continue;
+        }
+        auto& outputInfo = *outputIt->second;
+        auto slot = link.node->getGatheredInputSlot(*link.inputName, nodeSession.getNodeSessionMetadata(), outputInfo.getTensorDesc());
+        if (!slot) {
+            continue;
+        }
+        nodeSession.setGatheredOutput(inferRequest, outputName, outputInfo.getName(), std::move(slot));
+    }
+}
+
+void DLNode::bindOutputs(DLNodeSession& nodeSession, InferenceEngine::InferRequest& inferRequest) {
+    if (!bindOutputsEnabled && handedOverOutputs.empty()) {
+        return;
+    }
+    auto& model = nodeSession.getModelInstance();
+    // blobs in device memory could not be read by following nodes on other devices
+    if (!bindOutputsEnabled && model.getRemoteContext()) {
+        return;
+    }
+    for (const auto& link : getOutputLinks()) {
+        const auto& outputName = *link.outputName;
+        if (nodeSession.getGatheredOutputs().count(outputName) > 0 || nodeSession.getBoundOutputs().count(outputName) > 0) {
+            continue;
+        }
+        if (!bindOutputsEnabled && handedOverOutputs.count(outputName) == 0) {
+            continue;
+        }
+        std::string realModelOutputName;
+        if (!getRealOutputName(model, outputName, &realModelOutputName).ok()) {
+            // missing output is reported when fetching results
+            continue;
+        }
+        nodeSession.bindOutput(inferRequest, outputName, realModelOutputName, blobAllocator);
+    }
+}
+
 void DLNode::release(session_key_t sessionId) {
     SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Release node: {} sessionKey: {}", getName(), sessionId);
     getNodeSession(sessionId).release();
 }
-bool DLNode::tryDisarm(const session_key_t& sessionKey, const uint microseconds) {
-    return getNodeSession(sessionKey).tryDisarm(microseconds);
+void DLNode::disarm(const session_key_t& sessionKey) {
+    auto& nodeSession = static_cast<DLNodeSession&>(getNodeSession(sessionKey));
+    nodeSession.disarm();
+    // shard sessions batched into disarmed session will not get results
+    for (const auto& memberKey : nodeSession.getBatchMemberKeys()) {
+        nodeSession.getBatchNotifyEndQueue()->push({*this, memberKey});
+    }
 }
 
 std::unique_ptr<NodeSession> DLNode::createNodeSession(const NodeSessionMetadata& metadata, const CollapseDetails& collapsingDetails) {
     return std::make_unique<DLNodeSession>(metadata, getName(), previous.size(), collapsingDetails,
-        this->modelManager, this->modelName, this->modelVersion.value_or(0));
+        this->modelManager, this->modelName, this->modelVersion.value_or(0), this->roiInputs);
 }
 
 }  // namespace ovms
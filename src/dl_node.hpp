@@ -20,17 +20,21 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include "executingstreamidguard.hpp"
 #include "model_version_policy.hpp"  // for model_version_t typename
 #include "modelinstance.hpp"
 #include "modelinstanceunloadguard.hpp"
 #include "node.hpp"
+#include "nodeinfo.hpp"
 #include "nodestreamidguard.hpp"
+#include "requestcontext.hpp"
 
 namespace ovms {
 
 class ModelManager;
+class DLNodeSession;
 
 class DLNode : public Node {
 protected:
@@ -38,6 +42,13 @@ protected:
     std::optional<model_version_t> modelVersion;
     ModelManager& modelManager;
     const std::unordered_map<std::string, std::string> nodeOutputNameAlias;
+    const bool batchShardsEnabled;
+    const roi_inputs_t roiInputs;
+    const bool bindOutputsEnabled;
+    // outputs which all following nodes take in layout they are produced in, bound even if binding outputs is not enabled
+    const std::set<std::string> handedOverOutputs;
+    // nodes are created for each pipeline execution, so it orders node sessions of different pipelines by their start
+    const RequestContext::clock_t::time_point pipelineStarted = RequestContext::clock_t::now();
 
     std::shared_ptr<ModelInstance> model;
     std::unique_ptr<NodeStreamIdGuard> nodeStreamIdGuard;
@@ -47,24 +58,66 @@ public:
     DLNode(const std::string& nodeName, const std::string& modelName, std::optional<model_version_t> modelVersion,
         ModelManager& modelManager,
         std::unordered_map<std::string, std::string> nodeOutputNameAlias = {},
-        std::optional<uint32_t> demultiplyCount = std::nullopt, std::set<std::string> gatherFromNode = {}) :
+        std::optional<uint32_t> demultiplyCount = std::nullopt, std::set<std::string> gatherFromNode = {},
+        bool batchShards = false,
+        roi_inputs_t roiInputs = {},
+        bool bindOutputs = false,
+        std::set<std::string> handedOverOutputs = {}) :
         Node(nodeName, demultiplyCount, gatherFromNode),
         modelName(modelName),
         modelVersion(modelVersion),
         modelManager(modelManager),
-        nodeOutputNameAlias(nodeOutputNameAlias) {
+        nodeOutputNameAlias(nodeOutputNameAlias),
+        batchShardsEnabled(batchShards),
+        roiInputs(std::move(roiInputs)),
+        bindOutputsEnabled(bindOutputs),
+        handedOverOutputs(std::move(handedOverOutputs)) {
     }
 
     Status execute(session_key_t sessionKey, PipelineEventQueue& notifyEndQueue) override;
 
+    RequestContext::clock_t::time_point getPipelineStartTime() const {
+        return pipelineStarted;
+    }
+
     Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) override;
 
 private:
     Status fetchResults(BlobMap& outputs, InferenceEngine::InferRequest& inferRequest, ModelInstance& model, session_key_t sessionKey);
+    Status splitBatchedOutput(DLNodeSession& nodeSession, const std::string& outputName, const InferenceEngine::Blob::Ptr& batchedBlob, BlobMap& outputs);
+    /**
+     * @brief Creates outputs with first dimension equal to 0 for session whose inputs gathered no shards
+     */
+    Status fetchEmptyResults(BlobMap& outputs, ModelInstance& model);
+    /**
+     * @brief Hands over outputs sliced for session from batch of model dynamic batcher
+     */
+    Status fetchModelBatcherResults(BlobMap& outputs, DLNodeSession& nodeSession);
 
 public:
     void release(session_key_t sessionId) override;
 
+    /**
+     * @brief Lets inference write outputs gathered by following nodes directly into their consolidated inputs
+     */
+    void setGatheredOutputs(DLNodeSession& nodeSession, InferenceEngine::InferRequest& inferRequest);
+
+    /**
+     * @brief Sets server owned blobs as outputs of infer request which following nodes use, so they are handed over without copy
+     *
+     * Binds all outputs if binding outputs is enabled for node, otherwise only outputs handed over to following DL nodes
+     * in layout they are produced in, in host memory. Outputs which plugin does not accept are copied as usual.
+     */
+    void bindOutputs(DLNodeSession& nodeSession, InferenceEngine::InferRequest& inferRequest);
+
+    /**
+     * @brief Batches inputs of other ready shard sessions into inputs of session, up to model batch size
+     *
+     * Does nothing if batching shards is not enabled for node or inputs cannot be batched.
+     * Missing part of batch is padded with zeros.
+     */
+    Status batchShards(DLNodeSession& nodeSession, PipelineEventQueue& notifyEndQueue);
+
 private:
     Status getRealInputName(ModelInstance& model, const std::string& alias, std::string* result) const {
         auto it = model.getInputsInfo().find(alias);
@@ -87,7 +140,7 @@ private:
     }
 
     Status executeInference(PipelineEventQueue& notifyEndQueue, InferenceEngine::InferRequest& infer_request);
-    bool tryDisarm(const session_key_t& sessionKey, const uint microseconds = 1) override;
+    void disarm(const session_key_t& sessionKey) override;
 
 protected:
     std::unique_ptr<NodeSession> createNodeSession(const NodeSessionMetadata& metadata, const CollapseDetails& collapsingDetails) override;
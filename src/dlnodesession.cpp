@@ -16,9 +16,16 @@
 
 #include "dlnodesession.hpp"
 
+#include <algorithm>
 #include <map>
+#include <optional>
 #include <string>
+#include <utility>
 
+#include "deserialization.hpp"
+#include "dl_node.hpp"
+#include "dynamic_batcher.hpp"
+#include "fair_share_scheduler.hpp"
 #include "logging.hpp"
 #include "modelinstance.hpp"
 #include "modelinstanceunloadguard.hpp"
@@ -27,21 +34,24 @@
 #include "nodeoutputhandler.hpp"
 #include "nodestreamidguard.hpp"
 #include "ov_utils.hpp"
+#include "shape_bucket_cache.hpp"
 #include "tensorinfo.hpp"
 #include "timer.hpp"
 
 namespace ovms {
-DLNodeSession::DLNodeSession(const NodeSessionMetadata& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion) :
+DLNodeSession::DLNodeSession(const NodeSessionMetadata& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion, const roi_inputs_t& roiInputs) :
     NodeSession(metadata, nodeName, inputsCount, collapsingDetails),
     modelManager(manager),
     modelName(modelName),
-    modelVersion(modelVersion) {}
+    modelVersion(modelVersion),
+    roiInputs(roiInputs) {}
 
-DLNodeSession::DLNodeSession(const NodeSessionMetadata&& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion) :
+DLNodeSession::DLNodeSession(const NodeSessionMetadata&& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion, const roi_inputs_t& roiInputs) :
     NodeSession(std::move(metadata), nodeName, inputsCount, collapsingDetails),
     modelManager(manager),
     modelName(modelName),
-    modelVersion(modelVersion) {}
+    modelVersion(modelVersion),
+    roiInputs(roiInputs) {}
 
 DLNodeSession::~DLNodeSession() = default;
 
@@ -53,9 +63,21 @@ ModelInstance& DLNodeSession::getModelInstance() {
     return *this->model;
 }
 
-InferenceEngine::InferRequest& DLNodeSession::getInferRequest(const uint microseconds) {
-    auto& inferRequestsQueue = this->model->getInferRequestsQueue();
-    auto streamIdOpt = this->nodeStreamIdGuard->tryGetId(microseconds);
+OVInferRequestsQueue& DLNodeSession::getInferRequestsQueue() {
+    return this->shapeBucket ? *this->shapeBucket->inferRequestsQueue : this->model->getInferRequestsQueue();
+}
+
+const tensor_map_t& DLNodeSession::getInputsInfo() const {
+    return this->shapeBucket ? this->shapeBucket->inputsInfo : this->model->getInputsInfo();
+}
+
+const tensor_map_t& DLNodeSession::getOutputsInfo() const {
+    return this->shapeBucket ? this->shapeBucket->outputsInfo : this->model->getOutputsInfo();
+}
+
+InferenceEngine::InferRequest& DLNodeSession::getInferRequest() {
+    auto& inferRequestsQueue = getInferRequestsQueue();
+    auto streamIdOpt = this->nodeStreamIdGuard->tryGetId();
     if (!streamIdOpt) {
         SPDLOG_LOGGER_ERROR(dag_executor_logger, "Failed to get streamId on already executed node: {} session: {}", getName(), getSessionKey());
         throw std::logic_error("Stream id is empty on already executed node");
@@ -63,7 +85,7 @@ InferenceEngine::InferRequest& DLNodeSession::getInferRequest(const uint microse
     return inferRequestsQueue.getInferRequest(streamIdOpt.value());
 }
 
-Status DLNodeSession::requestExecuteRequiredResources() {
+Status DLNodeSession::requestExecuteRequiredResources(PipelineEventQueue& notifyEndQueue, DLNode& node) {
     Status status = modelManager.getModelInstance(
         modelName,
         modelVersion,
@@ -75,33 +97,99 @@ Status DLNodeSession::requestExecuteRequiredResources() {
         return status;
     }
 
+    status = node.batchShards(*this, notifyEndQueue);
+    if (!status.ok()) {
+        return status;
+    }
+
+    if (queueToModelBatcher(notifyEndQueue, node)) {
+        return StatusCode::OK;
+    }
+
     status = prepareInputsAndModelForInference();
     if (!status.ok()) {
         return status;
     }
-    this->nodeStreamIdGuard = std::make_unique<NodeStreamIdGuard>(model->getInferRequestsQueue());
+    this->slotGuard = std::make_unique<FairShareNodeSlotGuard>(FairShareScheduler::instance(), &this->model->getSchedulingTenant());
     return status;
 }
 
+bool DLNodeSession::queueToModelBatcher(PipelineEventQueue& notifyEndQueue, DLNode& node) {
+    auto* batcher = this->model->getDynamicBatcher();
+    if (batcher == nullptr || hasBatchedInputs() || !this->roiInputs.empty()) {
+        return false;
+    }
+    const auto& inputs = this->inputHandler->peekInputs();
+    const auto& inputsInfo = this->model->getInputsInfo();
+    if (inputs.size() != inputsInfo.size()) {
+        return false;
+    }
+    size_t batchSize = 0;
+    for (const auto& [name, inputInfo] : inputsInfo) {
+        auto it = inputs.find(name);
+        if (it == inputs.end() || inputInfo->isTransposedByServer() ||
+            inputInfo->getPrecision() != it->second->getTensorDesc().getPrecision()) {
+            return false;
+        }
+        const auto& dims = getEffectiveBlobShape(it->second);
+        const auto& shape = inputInfo->getEffectiveShape();
+        if (dims.size() != shape.size() || dims.empty() || !std::equal(shape.begin() + 1, shape.end(), dims.begin() + 1) ||
+            (batchSize != 0 && dims[0] != batchSize)) {
+            return false;
+        }
+        batchSize = dims[0];
+    }
+    if (batchSize == 0 || batchSize > this->model->getModelConfig().getMaxBatchSize()) {
+        return false;
+    }
+    this->queuedToModelBatcher = true;
+    this->timer.stop(STREAM);
+    node.observeStreamWaitTime(this->timer.elapsed<std::chrono::microseconds>(STREAM));
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] session: {} with batch size: {} is queued to dynamic batcher of model: {}",
+        getName(), getSessionKey(), batchSize, getModelName());
+    this->timer.start(INFERENCE);
+    batcher->inferAsync(this->inputHandler->getInputs(), batchSize, [this, &notifyEndQueue, &node](const Status& status, BlobMap& outputs) {
+        this->timer.stop(INFERENCE);
+        this->modelBatcherStatus = status;
+        this->batchResults = std::move(outputs);
+        this->inputHandler->clearInputs();
+        notifyEnd(notifyEndQueue, node);
+    });
+    return true;
+}
+
 Status DLNodeSession::prepareInputsAndModelForInference() {
     size_t requestedBatchSize = 0;
     std::map<std::string, shape_t> requestedReshapes;
 
     // Validate each blob against its OV tensor info
-    const auto& inputsInfo = this->model->getInputsInfo();
+    const auto& inputsMetadata = this->model->getInputsMetadata();
     for (const auto& kv : this->inputHandler->getInputs()) {
         const auto& name = kv.first;
         auto& blob = kv.second;
 
-        auto it = inputsInfo.find(name);
-        if (it == inputsInfo.end()) {
+        if (isRoiCoordinatesInput(name)) {
+            continue;
+        }
+        const auto* metadata = inputsMetadata.find(name);
+        if (metadata == nullptr) {
             std::stringstream ss;
             ss << "Required input: " << name;
             const std::string details = ss.str();
             SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Missing input with specific name - {}", getName(), details);
             return Status(StatusCode::INVALID_MISSING_INPUT, details);
         }
-        auto& inputInfo = *it->second;
+        auto& inputInfo = *metadata->info;
+        // Region of interest is resized to model input shape by inference preprocessing
+        if (this->roiInputs.count(name) > 0) {
+            if (inputInfo.getPrecision() != blob->getTensorDesc().getPrecision() ||
+                blob->getTensorDesc().getDims().size() != inputInfo.getShape().size()) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Region of interest input: {} has invalid precision or number of dimensions: {}",
+                    getName(), name, TensorInfo::shapeToString(blob->getTensorDesc().getDims()));
+                return StatusCode::PIPELINE_INVALID_ROI_INPUT;
+            }
+            continue;
+        }
         auto status = validate(blob, inputInfo);
         if (status.ok()) {
             continue;
@@ -116,7 +204,7 @@ Status DLNodeSession::prepareInputsAndModelForInference() {
         if (status == StatusCode::INVALID_BATCH_SIZE) {
             if (this->model->getModelConfig().getBatchingMode() == Mode::AUTO) {
                 requestedBatchSize = blob->getTensorDesc().getDims()[0];
-            } else if (this->model->getModelConfig().isShapeAuto(name)) {
+            } else if (metadata->isShapeAuto) {
                 requestedReshapes[name] = blob->getTensorDesc().getDims();
             } else {
                 return status;
@@ -125,19 +213,38 @@ Status DLNodeSession::prepareInputsAndModelForInference() {
 
         // If shape is incorrect, perform reshape if allowed (mode=auto)
         if (status == StatusCode::INVALID_SHAPE) {
-            if (!this->model->getModelConfig().isShapeAuto(name)) {
+            if (!metadata->isShapeAuto) {
                 return status;
             }
             requestedReshapes[name] = blob->getTensorDesc().getDims();
         }
     }
     if (requestedReshapes.size() > 0) {
+        if (this->model->hasShapeBucketCache()) {
+            // network is compiled for shapes of all inputs, region of interest is resized to model input shape
+            const auto& inputs = this->inputHandler->getInputs();
+            std::map<std::string, shape_t> shapes;
+            for (const auto& metadata : inputsMetadata) {
+                const auto& name = metadata.name;
+                auto inputIt = inputs.find(name);
+                if (this->roiInputs.count(name) > 0 || inputIt == inputs.end()) {
+                    shapes[name] = metadata.info->getShape();
+                } else {
+                    shapes[name] = inputIt->second->getTensorDesc().getDims();
+                }
+            }
+            return this->model->getShapeBucket(shapes, this->shapeBucket, this->modelUnloadGuard);
+        }
         size_t bs = 0;
         auto status = this->model->reloadModel(bs, requestedReshapes, this->modelUnloadGuard);
         if (!status.ok()) {
             return status;
         }
     } else if (requestedBatchSize > 0) {
+        this->shapeBucket = this->model->getBatchSizeVariant(requestedBatchSize);
+        if (this->shapeBucket) {
+            return StatusCode::OK;
+        }
         auto status = this->model->reloadModel(requestedBatchSize, {}, this->modelUnloadGuard);
         if (!status.ok()) {
             return status;
@@ -197,38 +304,109 @@ Status DLNodeSession::validate(const InferenceEngine::Blob::Ptr& blob, const Ten
     return StatusCode::OK;
 }
 
-Status DLNodeSession::execute(PipelineEventQueue& notifyEndQueue, uint waitForStreamIdTimeoutMicroseconds, Node& node) {
+Status DLNodeSession::execute(PipelineEventQueue& notifyEndQueue, DLNode& node) {
+    if (isBatchMember()) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] session: {} is executed in batch of session: {}", getName(), getSessionKey(), batchLeaderKey.value());
+        return StatusCode::OK;
+    }
     Status status;
-    if (this->nodeStreamIdGuard == nullptr) {
-        status = requestExecuteRequiredResources();
+    if (this->slotGuard == nullptr && hasOnlyEmptyInputs()) {
+        // demultiplexer yielded no shards, model is only needed for shapes of empty outputs
+        // getting inputs marks them as used, so session is not reported as ready anymore
+        this->inputHandler->getInputs();
+        status = modelManager.getModelInstance(modelName, modelVersion, this->model, this->modelUnloadGuard);
+        if (!status.ok()) {
+            notifyEnd(notifyEndQueue, node);
+            return status;
+        }
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] session: {} has empty inputs, inference is skipped", getName(), getSessionKey());
+        this->inferenceSkipped = true;
+        notifyEnd(notifyEndQueue, node);
+        return StatusCode::OK;
+    }
+    if (this->slotGuard == nullptr) {
+        this->timer.start(STREAM);
+        status = requestExecuteRequiredResources(notifyEndQueue, node);
         if (!status.ok()) {
-            notifyEndQueue.push({node, getSessionKey()});
+            notifyEnd(notifyEndQueue, node);
             return status;
         }
+        if (isQueuedToModelBatcher()) {
+            // session end is notified once batch of the model is inferred
+            return StatusCode::OK;
+        }
+    }
+    if (this->nodeStreamIdGuard == nullptr) {
+        // session is pushed to the queue again once slot is granted
+        if (this->slotGuard->notifyWhenGranted([&notifyEndQueue, &node, sessionKey = getSessionKey()]() {
+                notifyEndQueue.push({node, sessionKey});
+            })) {
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Model: {} share of server inferences is used up", getName(), getModelName());
+            return StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET;
+        }
+        this->nodeStreamIdGuard = std::make_unique<NodeStreamIdGuard>(getInferRequestsQueue(), node.getPipelineStartTime());
     }
-    auto streamIdOpt = this->nodeStreamIdGuard->tryGetId(waitForStreamIdTimeoutMicroseconds);
+    auto streamIdOpt = this->nodeStreamIdGuard->tryGetId();
     if (!streamIdOpt) {
-        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Could not acquire stream Id right away", getName());
-        return StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET;
+        // session is pushed to the queue again once stream is handed over
+        if (this->nodeStreamIdGuard->notifyWhenReady([&notifyEndQueue, &node, sessionKey = getSessionKey()]() {
+                notifyEndQueue.push({node, sessionKey});
+            })) {
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Could not acquire stream Id right away", getName());
+            return StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET;
+        }
+        streamIdOpt = this->nodeStreamIdGuard->tryGetId();
     }
-    auto& inferRequestsQueue = this->model->getInferRequestsQueue();
-    auto& inferRequest = inferRequestsQueue.getInferRequest(streamIdOpt.value());
+    this->timer.stop(STREAM);
+    node.observeStreamWaitTime(this->timer.elapsed<std::chrono::microseconds>(STREAM));
+    auto& inferRequest = getInferRequestsQueue().getInferRequest(streamIdOpt.value());
     status = setInputsForInference(inferRequest);
     if (!status.ok()) {
-        notifyEndQueue.push({node, getSessionKey()});
+        notifyEnd(notifyEndQueue, node);
         return status;
     }
+    node.setGatheredOutputs(*this, inferRequest);
+    node.bindOutputs(*this, inferRequest);
     status = executeInference(notifyEndQueue, inferRequest, node);
     if (!status.ok()) {
-        notifyEndQueue.push({node, getSessionKey()});
+        notifyEnd(notifyEndQueue, node);
         return status;
     }
     return status;
 }
 
+void DLNodeSession::notifyEnd(PipelineEventQueue& notifyEndQueue, DLNode& node) {
+    // Session may be removed once its end is processed, batch member keys are copied before
+    const auto memberKeys = batchMemberKeys;
+    notifyEndQueue.push({node, getSessionKey()});
+    for (const auto& memberKey : memberKeys) {
+        notifyEndQueue.push({node, memberKey});
+    }
+}
+
+Status DLNodeSession::setBatchedInputs(BlobMap& batchedInputs, std::vector<session_key_t> memberKeys, PipelineEventQueue& notifyEndQueue) {
+    this->inputHandler->clearInputs();
+    for (auto& [name, blob] : batchedInputs) {
+        auto status = this->inputHandler->setInput(name, blob, 0);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    this->batchMemberKeys = std::move(memberKeys);
+    this->batchNotifyEndQueue = &notifyEndQueue;
+    return StatusCode::OK;
+}
+
+void DLNodeSession::joinBatch(session_key_t leaderKey) {
+    // getting inputs marks them as used, so session is not reported as ready anymore
+    this->inputHandler->getInputs();
+    this->inputHandler->clearInputs();
+    this->batchLeaderKey = leaderKey;
+}
+
 Status DLNodeSession::getRealInputName(const std::string& alias, std::string* result) const {
-    auto it = this->model->getInputsInfo().find(alias);
-    if (it == this->model->getInputsInfo().end()) {
+    auto it = getInputsInfo().find(alias);
+    if (it == getInputsInfo().end()) {
         return StatusCode::INVALID_MISSING_INPUT;
     }
     *result = it->second->getName();
@@ -239,7 +417,11 @@ Status DLNodeSession::setInputsForInference(InferenceEngine::InferRequest& infer
     Status status = StatusCode::OK;
     try {
         // Prepare inference request, fill with input blobs
-        for (const auto& [name, blob] : this->inputHandler->getInputs()) {
+        const auto& inputs = this->inputHandler->getInputs();
+        for (const auto& [name, blob] : inputs) {
+            if (isRoiCoordinatesInput(name)) {
+                continue;
+            }
             std::string realModelInputName;
             if (!getRealInputName(name, &realModelInputName).ok()) {
                 SPDLOG_LOGGER_WARN(dag_executor_logger, "DLNode::{} [Node name: {}]; cannot find real model input name for alias: {}",
@@ -247,8 +429,32 @@ Status DLNodeSession::setInputsForInference(InferenceEngine::InferRequest& infer
                 return StatusCode::INTERNAL_ERROR;
             }
             // Update blob layout with model input layout
-            auto& inputInfo = this->model->getInputsInfo().at(name);
+            auto& inputInfo = getInputsInfo().at(name);
 
+            auto roiIt = this->roiInputs.find(name);
+            if (roiIt != this->roiInputs.end()) {
+                auto coordinatesIt = inputs.find(roiIt->second);
+                if (coordinatesIt == inputs.end()) {
+                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Missing coordinates input: {} of region of interest input: {}", getName(), roiIt->second, name);
+                    return StatusCode::PIPELINE_INVALID_ROI_INPUT;
+                }
+                InferenceEngine::Blob::Ptr roiBlob;
+                status = createRoiBlob(blob, coordinatesIt->second, inputInfo->getLayout(), roiBlob);
+                if (!status.ok()) {
+                    return status;
+                }
+                InferenceEngine::PreProcessInfo preProcessInfo;
+                preProcessInfo.setResizeAlgorithm(InferenceEngine::ResizeAlgorithm::RESIZE_BILINEAR);
+                inferRequest.SetBlob(realModelInputName, roiBlob, preProcessInfo);
+                continue;
+            }
+            if (inputInfo->isTransposedByServer()) {
+                auto transposedBlob = makeTransposedBlob(blob, inputInfo);
+                if (transposedBlob) {
+                    inferRequest.SetBlob(realModelInputName, transposedBlob);
+                    continue;
+                }
+            }
             blob->getTensorDesc().setLayout(inputInfo->getLayout());
             blob->getTensorDesc().reshape(inputInfo->getTensorDesc().getDims());
             inferRequest.SetBlob(realModelInputName, blob);
@@ -269,19 +475,132 @@ Status DLNodeSession::setInputsForInference(InferenceEngine::InferRequest& infer
     return status;
 }
 
-Status DLNodeSession::executeInference(PipelineEventQueue& notifyEndQueue, InferenceEngine::InferRequest& inferRequest, Node& node) {
+bool DLNodeSession::hasOnlyEmptyInputs() const {
+    const auto& inputs = this->inputHandler->peekInputs();
+    return !inputs.empty() && std::all_of(inputs.begin(), inputs.end(), [](const auto& input) { return input.second->size() == 0; });
+}
+
+bool DLNodeSession::isRoiCoordinatesInput(const std::string& name) const {
+    return std::any_of(this->roiInputs.begin(), this->roiInputs.end(), [&name](const auto& roiInput) { return roiInput.second == name; });
+}
+
+Status DLNodeSession::createRoiBlob(const InferenceEngine::Blob::Ptr& image, const InferenceEngine::Blob::Ptr& coordinates, InferenceEngine::Layout layout, InferenceEngine::Blob::Ptr& roiBlob) const {
+    const auto& dims = image->getTensorDesc().getDims();
+    if (dims.size() != 4 || dims[0] != 1 || (layout != InferenceEngine::Layout::NCHW && layout != InferenceEngine::Layout::NHWC)) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Region of interest requires single image in NCHW or NHWC layout, actual shape: {}",
+            getName(), TensorInfo::shapeToString(dims));
+        return StatusCode::PIPELINE_INVALID_ROI_INPUT;
+    }
+    if (coordinates->getTensorDesc().getPrecision() != InferenceEngine::Precision::FP32 || coordinates->size() != 4) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Region of interest coordinates must be 4 FP32 values, actual shape: {}",
+            getName(), TensorInfo::shapeToString(coordinates->getTensorDesc().getDims()));
+        return StatusCode::PIPELINE_INVALID_ROI_COORDINATES;
+    }
+    const size_t height = layout == InferenceEngine::Layout::NCHW ? dims[2] : dims[1];
+    const size_t width = layout == InferenceEngine::Layout::NCHW ? dims[3] : dims[2];
+    const float* box = InferenceEngine::as<InferenceEngine::MemoryBlob>(coordinates)->rmap().as<const float*>();
+    // Same rounding as in detection custom nodes cropping boxes on their own
+    const int xMin = std::max(0, static_cast<int>(box[0] * width));
+    const int yMin = std::max(0, static_cast<int>(box[1] * height));
+    const int xMax = std::min(static_cast<int>(width), static_cast<int>(box[2] * width));
+    const int yMax = std::min(static_cast<int>(height), static_cast<int>(box[3] * height));
+    if (xMax <= xMin || yMax <= yMin) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Region of interest: [{}, {}, {}, {}] is empty for image: {}x{}",
+            getName(), box[0], box[1], box[2], box[3], width, height);
+        return StatusCode::PIPELINE_INVALID_ROI_COORDINATES;
+    }
+    image->getTensorDesc().setLayout(layout);
+    roiBlob = InferenceEngine::make_shared_blob(image, InferenceEngine::ROI(0, xMin, yMin, xMax - xMin, yMax - yMin));
+    return StatusCode::OK;
+}
+
+bool DLNodeSession::replaceOutputBlob(InferenceEngine::InferRequest& inferRequest, const std::string& outputName, const std::string& realModelOutputName, const InferenceEngine::Blob::Ptr& blob) {
+    try {
+        auto originalBlob = inferRequest.GetBlob(realModelOutputName);
+        inferRequest.SetBlob(realModelOutputName, blob);
+        replacedOutputBlobs.emplace_back(realModelOutputName, std::move(originalBlob));
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Could not set output: {} to be written in place; exception message: {}", getName(), outputName, e.what());
+        return false;
+    } catch (std::logic_error& e) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Could not set output: {} to be written in place; exception message: {}", getName(), outputName, e.what());
+        return false;
+    }
+    return true;
+}
+
+bool DLNodeSession::setGatheredOutput(InferenceEngine::InferRequest& inferRequest, const std::string& outputName, const std::string& realModelOutputName, InferenceEngine::Blob::Ptr blob) {
+    if (!replaceOutputBlob(inferRequest, outputName, realModelOutputName, blob)) {
+        return false;
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Output: {} will be written in place of following node input", getName(), outputName);
+    gatheredOutputs.emplace(outputName, std::move(blob));
+    return true;
+}
+
+bool DLNodeSession::bindOutput(InferenceEngine::InferRequest& inferRequest, const std::string& outputName, const std::string& realModelOutputName, const std::shared_ptr<InferenceEngine::IAllocator>& allocator) {
+    InferenceEngine::Blob::Ptr blob;
+    try {
+        // blob matches precision, layout and current shape of the output infer request would write otherwise
+        const auto desc = inferRequest.GetBlob(realModelOutputName)->getTensorDesc();
+        const auto& remoteContext = getModelInstance().getRemoteContext();
+        if (remoteContext) {
+            // output stays in device memory, so following node on the same device reads it without transfer
+            blob = remoteContext->CreateBlob(desc);
+            blob->allocate();
+        } else {
+            auto status = allocator ? createSharedBlob(blob, desc, allocator) : createSharedBlob(blob, desc);
+            if (!status.ok()) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Could not create blob bound to output: {}; {}", getName(), outputName, status.string());
+                return false;
+            }
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Could not get output: {} to bind; exception message: {}", getName(), outputName, e.what());
+        return false;
+    }
+    if (!replaceOutputBlob(inferRequest, outputName, realModelOutputName, blob)) {
+        return false;
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Output: {} will be handed over to following nodes without copy", getName(), outputName);
+    boundOutputs.emplace(outputName, std::move(blob));
+    return true;
+}
+
+void DLNodeSession::restoreInferRequestOutputs() {
+    if (replacedOutputBlobs.empty()) {
+        return;
+    }
+    std::optional<int> streamIdOpt;
+    if (this->nodeStreamIdGuard) {
+        streamIdOpt = this->nodeStreamIdGuard->tryGetId();
+    }
+    if (streamIdOpt) {
+        auto& inferRequest = getInferRequestsQueue().getInferRequest(streamIdOpt.value());
+        try {
+            for (auto& [realModelOutputName, blob] : replacedOutputBlobs) {
+                inferRequest.SetBlob(realModelOutputName, blob);
+            }
+        } catch (const std::exception& e) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "[Node: {}] Failed to restore infer request outputs; exception message: {}", getName(), e.what());
+        }
+    }
+    replacedOutputBlobs.clear();
+}
+
+Status DLNodeSession::executeInference(PipelineEventQueue& notifyEndQueue, InferenceEngine::InferRequest& inferRequest, DLNode& node) {
     try {
         SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Setting completion callback for node name: {}", this->getName());
         inferRequest.SetCompletionCallback([this, &notifyEndQueue, &inferRequest, &node]() {
-            this->timer->stop("inference");
+            this->timer.stop(INFERENCE);
             SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Completion callback received for node name: {}", this->getName());
             // After inference is completed, input blobs are not needed anymore
             this->inputHandler->clearInputs();
-            notifyEndQueue.push({node, getSessionKey()});
+            notifyEnd(notifyEndQueue, node);
             inferRequest.SetCompletionCallback([]() {});  // reset callback on infer request
         });
         SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Starting infer async for node name: {}", getName());
-        this->timer->start("inference");
+        this->timer.start(INFERENCE);
         inferRequest.StartAsync();
     } catch (const InferenceEngine::Exception& e) {
         SPDLOG_LOGGER_DEBUG(dag_executor_logger, "[Node: {}] Exception occured when starting async inference or setting completion callback on model: {}, error: {}",
@@ -300,16 +619,21 @@ Status DLNodeSession::executeInference(PipelineEventQueue& notifyEndQueue, Infer
 }
 
 void DLNodeSession::release() {
+    restoreInferRequestOutputs();
     this->nodeStreamIdGuard.reset();
+    this->slotGuard.reset();
+    this->shapeBucket.reset();
     this->model.reset();
     this->modelUnloadGuard.reset();
 }
 
-bool DLNodeSession::tryDisarm(uint microseconds) {
-    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Trying to disarm stream id guard of node: {}", getName());
-    if (this->nodeStreamIdGuard == nullptr) {
-        return true;
+void DLNodeSession::disarm() {
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Disarming stream id guard of node: {}", getName());
+    if (this->nodeStreamIdGuard) {
+        this->nodeStreamIdGuard->disarm();
+    }
+    if (this->slotGuard) {
+        this->slotGuard->disarm();
     }
-    return this->nodeStreamIdGuard->tryDisarm(microseconds);
 }
 }  // namespace ovms
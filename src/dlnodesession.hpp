@@ -19,10 +19,13 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <inference_engine.hpp>
 
+#include "blobmap.hpp"
 #include "modelversion.hpp"
+#include "nodeinfo.hpp"
 #include "nodesession.hpp"
 #include "pipelineeventqueue.hpp"
 #include "status.hpp"
@@ -31,43 +34,134 @@ namespace ovms {
 
 class ModelManager;
 class ModelInstance;
-class Node;
+class DLNode;
+class FairShareNodeSlotGuard;
 class NodeStreamIdGuard;
 class ModelInstanceUnloadGuard;
+class OVInferRequestsQueue;
+struct ShapeBucket;
 class TensorInfo;
 
 class DLNodeSession : public NodeSession {
     std::shared_ptr<ModelInstance> model;
+    // Executable network compiled for shapes of node inputs when default network of the model does not fit them
+    std::shared_ptr<ShapeBucket> shapeBucket;
+    // Share of server inferences of the model, taken before stream and released after it
+    std::unique_ptr<FairShareNodeSlotGuard> slotGuard;
     std::unique_ptr<NodeStreamIdGuard> nodeStreamIdGuard;
     std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuard;
 
     ModelManager& modelManager;
     const std::string& modelName;
     const model_version_t modelVersion;
+    const roi_inputs_t roiInputs;
+
+    // Outputs written by inference directly into consolidated inputs of gathering nodes
+    BlobMap gatheredOutputs;
+    // Server owned outputs written by inference and handed over to following nodes without copy
+    BlobMap boundOutputs;
+    // Infer request output blobs replaced with gathered or bound outputs, restored before stream is returned
+    std::vector<std::pair<std::string, InferenceEngine::Blob::Ptr>> replacedOutputBlobs;
+
+    // Shard sessions whose inputs were batched into inference of this session
+    std::vector<session_key_t> batchMemberKeys;
+    PipelineEventQueue* batchNotifyEndQueue = nullptr;
+    // Set for shard session batched into inference of other session
+    std::optional<session_key_t> batchLeaderKey;
+    BlobMap batchResults;
+    // Set when inputs gathered from no shards are empty, results are empty as well
+    bool inferenceSkipped = false;
+    // Set when inputs are inferred in batch of model dynamic batcher together with other requests to the model
+    bool queuedToModelBatcher = false;
+    Status modelBatcherStatus;
 
 public:
-    DLNodeSession(const NodeSessionMetadata& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion);
-    DLNodeSession(const NodeSessionMetadata&& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion);
+    DLNodeSession(const NodeSessionMetadata& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion, const roi_inputs_t& roiInputs = {});
+    DLNodeSession(const NodeSessionMetadata&& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails, ModelManager& manager, const std::string& modelName, model_version_t modelVersion, const roi_inputs_t& roiInputs = {});
     virtual ~DLNodeSession();
 
-    InferenceEngine::InferRequest& getInferRequest(const uint microseconds);
+    InferenceEngine::InferRequest& getInferRequest();
     ModelInstance& getModelInstance();
+    /**
+     * @brief Infer requests, inputs and outputs of executable network used by the session,
+     * network compiled for shapes of node inputs or default network of the model
+     */
+    OVInferRequestsQueue& getInferRequestsQueue();
+    const tensor_map_t& getInputsInfo() const;
+    const tensor_map_t& getOutputsInfo() const;
 
 private:
-    Status requestExecuteRequiredResources();
+    Status requestExecuteRequiredResources(PipelineEventQueue& notifyEndQueue, DLNode& node);
+    /**
+     * @brief Queues inputs to dynamic batcher of the model, so they are inferred in batch with concurrent pipelines and requests
+     *
+     * @return false if model has no dynamic batcher or inputs do not fit its batch, session is then executed on its own
+     */
+    bool queueToModelBatcher(PipelineEventQueue& notifyEndQueue, DLNode& node);
+    void notifyEnd(PipelineEventQueue& notifyEndQueue, DLNode& node);
 
 public:
     Status prepareInputsAndModelForInference();
     Status validate(const InferenceEngine::Blob::Ptr& blob, const TensorInfo& info);
-    Status execute(PipelineEventQueue& notifyEndQueue, uint waitForStreamIdTimeoutMicroseconds, Node& node);
-    Status executeInference(PipelineEventQueue& notifyEndQueue, InferenceEngine::InferRequest&, Node& node);
+    /**
+     * @brief Starts inference, returns PIPELINE_STREAM_ID_NOT_READY_YET when model share of server inferences is used up or all streams are busy
+     *
+     * Deferred session is pushed to notifyEndQueue again once slot is granted or stream is handed over.
+     */
+    Status execute(PipelineEventQueue& notifyEndQueue, DLNode& node);
+    Status executeInference(PipelineEventQueue& notifyEndQueue, InferenceEngine::InferRequest&, DLNode& node);
     Status setInputsForInference(InferenceEngine::InferRequest& inferRequest);
+    /**
+     * @brief Creates view of image blob limited to region given by normalized x_min, y_min, x_max, y_max coordinates blob
+     */
+    Status createRoiBlob(const InferenceEngine::Blob::Ptr& image, const InferenceEngine::Blob::Ptr& coordinates, InferenceEngine::Layout layout, InferenceEngine::Blob::Ptr& roiBlob) const;
+    /**
+     * @brief Sets output of infer request to blob provided by following node, so inference writes it in place
+     *
+     * @return false if infer request does not accept the blob, output is then copied after inference as usual
+     */
+    bool setGatheredOutput(InferenceEngine::InferRequest& inferRequest, const std::string& outputName, const std::string& realModelOutputName, InferenceEngine::Blob::Ptr blob);
+    const BlobMap& getGatheredOutputs() const { return gatheredOutputs; }
+    /**
+     * @brief Sets output of infer request to new server owned blob, so it is handed over to following nodes after inference
+     *
+     * Blob is created in device memory when remote blobs are enabled for the model.
+     *
+     * @param allocator provides memory of the blob, global blob pool is used if not set
+     * @return false if infer request does not accept the blob, output is then copied after inference as usual
+     */
+    bool bindOutput(InferenceEngine::InferRequest& inferRequest, const std::string& outputName, const std::string& realModelOutputName, const std::shared_ptr<InferenceEngine::IAllocator>& allocator);
+    const BlobMap& getBoundOutputs() const { return boundOutputs; }
+    /**
+     * @brief Replaces shard inputs with inputs batched together with shards of other sessions of the node
+     *
+     * Batch member sessions are notified as finished together with this session.
+     */
+    Status setBatchedInputs(BlobMap& batchedInputs, std::vector<session_key_t> memberKeys, PipelineEventQueue& notifyEndQueue);
+    bool hasBatchedInputs() const { return batchNotifyEndQueue != nullptr; }
+    const std::vector<session_key_t>& getBatchMemberKeys() const { return batchMemberKeys; }
+    PipelineEventQueue* getBatchNotifyEndQueue() const { return batchNotifyEndQueue; }
+    /**
+     * @brief Marks session as batched into inference of leader session, its inputs are not executed on its own
+     */
+    void joinBatch(session_key_t leaderKey);
+    bool isBatchMember() const { return batchLeaderKey.has_value(); }
+    BlobMap& getBatchResults() { return batchResults; }
+    bool isInferenceSkipped() const { return inferenceSkipped; }
+    bool isQueuedToModelBatcher() const { return queuedToModelBatcher; }
+    const Status& getModelBatcherStatus() const { return modelBatcherStatus; }
     Status getRealInputName(const std::string& alias, std::string* result) const;
     void release() override;
 
     void clearInputs();
 
     const std::string& getModelName() { return modelName; }
-    bool tryDisarm(uint microseconds) override;
+    void disarm() override;
+
+private:
+    bool replaceOutputBlob(InferenceEngine::InferRequest& inferRequest, const std::string& outputName, const std::string& realModelOutputName, const InferenceEngine::Blob::Ptr& blob);
+    void restoreInferRequestOutputs();
+    bool isRoiCoordinatesInput(const std::string& name) const;
+    bool hasOnlyEmptyInputs() const;
 };
 }  // namespace ovms
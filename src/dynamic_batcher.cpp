@@ -0,0 +1,438 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "dynamic_batcher.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "deserialization.hpp"
+#include "executingstreamidguard.hpp"
+#include "modelinstance.hpp"
+#include "ov_utils.hpp"
+#include "sequence.hpp"
+#include "sequence_manager.hpp"
+#include "serialization.hpp"
+#include "shared_memory.hpp"
+#include "timer.hpp"
+
+namespace ovms {
+
+enum : size_t {
+    GET_INFER_REQUEST,
+    DESERIALIZE,
+    PREDICTION,
+    SERIALIZE,
+    TIMER_END
+};
+
+DynamicBatcher::DynamicBatcher(ModelInstance& instance, size_t maxBatchSize, uint32_t batchTimeoutUs, uint32_t latencyTargetUs) :
+    DynamicBatcher(instance, instance.getInferRequestsQueue(), instance.getInputsInfo(), instance.getOutputsInfo(), maxBatchSize, batchTimeoutUs, latencyTargetUs) {}
+
+Status DynamicBatcher::infer(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    size_t requestBatchSize) {
+    return infer(requestProto, responseProto, requestBatchSize, nullptr, NO_CONTROL_INPUT);
+}
+
+Status DynamicBatcher::infer(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    Sequence& sequence, uint32_t sequenceControlInput) {
+    return infer(requestProto, responseProto, 1, &sequence, sequenceControlInput);
+}
+
+Status DynamicBatcher::infer(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    size_t requestBatchSize, Sequence* sequence, uint32_t sequenceControlInput) {
+    const auto arrival = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    bool isLeader = false;
+    std::chrono::microseconds window;
+    auto batch = join(
+        requestBatchSize, arrival, [&](Batch& opened) {
+            opened.requests.push_back(requestProto);
+            opened.responses.push_back(responseProto);
+            opened.requestBatchSizes.push_back(requestBatchSize);
+            if (sequence) {
+                opened.sequences.push_back(sequence);
+                opened.sequenceControlInputs.push_back(sequenceControlInput);
+            }
+        },
+        isLeader, window);
+
+    if (!isLeader) {
+        batch->cv.wait(lock, [&batch]() { return batch->done; });
+        recordLatency(arrival);
+        return batch->status;
+    }
+    return lead(lock, batch, std::chrono::steady_clock::now() + window, arrival);
+}
+
+void DynamicBatcher::inferAsync(const BlobMap& inputs, size_t batchSize, node_callback_t callback) {
+    const auto arrival = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    bool isLeader = false;
+    std::chrono::microseconds window;
+    auto batch = join(
+        batchSize, arrival, [&](Batch& opened) {
+            opened.nodeEntries.push_back({inputs, batchSize, std::move(callback), {}});
+        },
+        isLeader, window);
+    lock.unlock();
+    if (!isLeader) {
+        return;
+    }
+    nodeBatchLeaders->schedule([this, batch, deadline = arrival + window, arrival]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        lead(lock, batch, deadline, arrival);
+    });
+}
+
+std::shared_ptr<DynamicBatcher::Batch> DynamicBatcher::join(size_t entryBatchSize, std::chrono::steady_clock::time_point arrival,
+    const std::function<void(Batch&)>& addEntry, bool& isLeader, std::chrono::microseconds& window) {
+    size_t targetBatchSize = maxBatchSize;
+    window = batchTimeout;
+    if (adaptiveWindow) {
+        adaptiveWindow->recordArrival(arrival, entryBatchSize);
+        targetBatchSize = adaptiveWindow->getTargetBatchSize();
+        window = adaptiveWindow->getWindow();
+    }
+    if (openBatch && openBatch->collected + entryBatchSize > maxBatchSize) {
+        close(*openBatch);
+    }
+    isLeader = false;
+    if (!openBatch) {
+        openBatch = std::make_shared<Batch>();
+        isLeader = true;
+    }
+    auto batch = openBatch;
+    addEntry(*batch);
+    batch->collected += entryBatchSize;
+    if (batch->collected >= targetBatchSize) {
+        close(*batch);
+    }
+    return batch;
+}
+
+Status DynamicBatcher::lead(std::unique_lock<std::mutex>& lock, const std::shared_ptr<Batch>& batch, std::chrono::steady_clock::time_point deadline,
+    std::chrono::steady_clock::time_point arrival) {
+    batch->cv.wait_until(lock, deadline, [&batch]() { return batch->closed; });
+    close(*batch);
+    lock.unlock();
+
+    const auto executionStart = std::chrono::steady_clock::now();
+    auto status = execute(*batch);
+    const auto executionDuration = std::chrono::steady_clock::now() - executionStart;
+
+    lock.lock();
+    batch->status = status;
+    batch->done = true;
+    if (adaptiveWindow && status.ok()) {
+        adaptiveWindow->recordExecution(batch->collected, std::chrono::duration_cast<std::chrono::microseconds>(executionDuration));
+    }
+    recordLatency(arrival);
+    lock.unlock();
+    batch->cv.notify_all();
+    // node sessions are not waiting on the batch, so they are completed by its leader
+    for (auto& entry : batch->nodeEntries) {
+        entry.callback(status, entry.outputs);
+    }
+    return status;
+}
+
+void DynamicBatcher::recordLatency(std::chrono::steady_clock::time_point arrival) {
+    if (adaptiveWindow) {
+        adaptiveWindow->recordLatency(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - arrival));
+    }
+}
+
+void DynamicBatcher::close(Batch& batch) {
+    batch.closed = true;
+    if (openBatch.get() == &batch) {
+        openBatch.reset();
+    }
+    batch.cv.notify_all();
+}
+
+Status DynamicBatcher::execute(Batch& batch) {
+    Timer<TIMER_END> timer;
+    using std::chrono::microseconds;
+
+    timer.start(GET_INFER_REQUEST);
+    // batch takes single share of server inferences of the model for requests and pipeline node sessions it holds
+    ExecutingStreamIdGuard executingStreamIdGuard(inferRequestsQueue, RequestContext(), &instance.getSchedulingTenant());
+    if (!executingStreamIdGuard.getStatus().ok()) {
+        return executingStreamIdGuard.getStatus();
+    }
+    int executingInferId = executingStreamIdGuard.getId();
+    InferenceEngine::InferRequest& inferRequest = executingStreamIdGuard.getInferRequest();
+    timer.stop(GET_INFER_REQUEST);
+    SPDLOG_DEBUG("Getting infer req duration in model {}, version {}, nireq {}: {:.3f} ms",
+        instance.getName(), instance.getVersion(), executingInferId, timer.elapsed<microseconds>(GET_INFER_REQUEST) / 1000);
+
+    timer.start(DESERIALIZE);
+    auto status = fillInputs(inferRequest, batch);
+    timer.stop(DESERIALIZE);
+    if (!status.ok())
+        return status;
+    SPDLOG_DEBUG("Batch of {} requests and {} pipeline node sessions with {} entries collected for model {}, version {}; deserialization duration: {:.3f} ms",
+        batch.requests.size(), batch.nodeEntries.size(), batch.collected, instance.getName(), instance.getVersion(), timer.elapsed<microseconds>(DESERIALIZE) / 1000);
+
+    if (!batch.sequences.empty()) {
+        status = fillStates(inferRequest, batch);
+        if (!status.ok())
+            return status;
+    }
+
+    timer.start(PREDICTION);
+    status = instance.performInference(inferRequest);
+    timer.stop(PREDICTION);
+    if (!status.ok())
+        return status;
+    SPDLOG_DEBUG("Prediction duration in model {}, version {}, nireq {}: {:.3f} ms",
+        instance.getName(), instance.getVersion(), executingInferId, timer.elapsed<microseconds>(PREDICTION) / 1000);
+
+    timer.start(SERIALIZE);
+    status = scatterOutputs(inferRequest, batch);
+    timer.stop(SERIALIZE);
+    if (!status.ok())
+        return status;
+    SPDLOG_DEBUG("Serialization duration in model {}, version {}, nireq {}: {:.3f} ms",
+        instance.getName(), instance.getVersion(), executingInferId, timer.elapsed<microseconds>(SERIALIZE) / 1000);
+
+    if (!batch.sequences.empty()) {
+        return scatterStates(inferRequest, batch);
+    }
+    return StatusCode::OK;
+}
+
+Status DynamicBatcher::fillInputs(InferenceEngine::InferRequest& inferRequest, const Batch& batch) {
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        // Infer requests are shared with pipeline nodes which set their own blobs,
+        // so the batch is always assembled in a blob owned by this request.
+        InferenceEngine::Blob::Ptr blob;
+        auto status = createSharedBlob(blob, tensorInfo->getTensorDesc());
+        if (!status.ok()) {
+            return status;
+        }
+        const size_t sampleByteSize = blob->byteSize() / maxBatchSize;
+        auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
+        char* buffer = holder.as<char*>();
+        size_t offset = 0;
+        for (size_t i = 0; i < batch.requests.size(); ++i) {
+            const auto& requestInput = batch.requests[i]->inputs().at(name);
+            char* destination = buffer + offset * sampleByteSize;
+            if (isSharedMemoryReference(requestInput)) {
+                std::shared_ptr<SharedMemoryRegion> region;
+                char* data = nullptr;
+                const size_t byteSize = batch.requestBatchSizes[i] * sampleByteSize;
+                const bool converted = tensorInfo->isConvertedFromDataType(requestInput.dtype());
+                const size_t count = byteSize / tensorInfo->getPrecision().size();
+                auto status = resolveSharedMemoryReference(requestInput, converted ? count * sizeof(float) : byteSize, region, data);
+                if (!status.ok()) {
+                    return status;
+                }
+                if (converted) {
+                    convertFromFp32(tensorInfo->getPrecision(), reinterpret_cast<const float*>(data), destination, count);
+                } else {
+                    std::memcpy(destination, data, byteSize);
+                }
+                offset += batch.requestBatchSizes[i];
+                continue;
+            }
+            if (tensorInfo->isConvertedFromDataType(requestInput.dtype())) {
+                convertFromFp32(tensorInfo->getPrecision(), reinterpret_cast<const float*>(requestInput.tensor_content().data()),
+                    destination, requestInput.tensor_content().size() / sizeof(float));
+                offset += batch.requestBatchSizes[i];
+                continue;
+            }
+            switch (tensorInfo->getPrecision()) {
+            case InferenceEngine::Precision::FP16:
+                if (requestInput.tensor_content().size() > 0) {
+                    std::memcpy(destination, requestInput.tensor_content().data(), requestInput.tensor_content().size());
+                } else {
+                    narrowInt32ToUint16(requestInput.half_val().data(), reinterpret_cast<uint16_t*>(destination), requestInput.half_val_size());
+                }
+                break;
+            case InferenceEngine::Precision::U16:
+                narrowInt32ToUint16(requestInput.int_val().data(), reinterpret_cast<uint16_t*>(destination), requestInput.int_val_size());
+                break;
+            default:
+                std::memcpy(destination, requestInput.tensor_content().data(), requestInput.tensor_content().size());
+            }
+            offset += batch.requestBatchSizes[i];
+        }
+        status = fillNodeInputs(name, batch, buffer, sampleByteSize, offset);
+        if (!status.ok()) {
+            return status;
+        }
+        for (const auto& entry : batch.nodeEntries) {
+            offset += entry.batchSize;
+        }
+        if (offset < maxBatchSize) {
+            std::memset(buffer + offset * sampleByteSize, 0, (maxBatchSize - offset) * sampleByteSize);
+        }
+        try {
+            inferRequest.SetBlob(tensorInfo->getName(), blob);
+        } catch (const InferenceEngine::Exception& e) {
+            Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+            SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status DynamicBatcher::fillNodeInputs(const std::string& name, const Batch& batch, char* buffer, size_t sampleByteSize, size_t offset) {
+    for (const auto& entry : batch.nodeEntries) {
+        auto it = entry.inputs.find(name);
+        if (it == entry.inputs.end() || it->second->byteSize() != entry.batchSize * sampleByteSize) {
+            SPDLOG_DEBUG("Pipeline node session input: {} does not match batch of model {}, version {}", name, instance.getName(), instance.getVersion());
+            return StatusCode::INTERNAL_ERROR;
+        }
+        auto memoryBlob = InferenceEngine::as<InferenceEngine::MemoryBlob>(it->second);
+        if (!memoryBlob) {
+            return StatusCode::INTERNAL_ERROR;
+        }
+        std::memcpy(buffer + offset * sampleByteSize, memoryBlob->rmap().as<const char*>(), entry.batchSize * sampleByteSize);
+        offset += entry.batchSize;
+    }
+    return StatusCode::OK;
+}
+
+Status DynamicBatcher::scatterNodeOutputs(const std::string& name, const TensorInfo& tensorInfo, const InferenceEngine::Blob::Ptr& blob, Batch& batch, size_t offset) {
+    if (batch.nodeEntries.empty()) {
+        return StatusCode::OK;
+    }
+    auto memoryBlob = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob);
+    if (!memoryBlob) {
+        return StatusCode::INTERNAL_ERROR;
+    }
+    // infer request reuses its output blobs, so slices are copied out
+    const size_t sampleByteSize = blob->byteSize() / maxBatchSize;
+    auto holder = memoryBlob->rmap();
+    const char* data = holder.as<const char*>();
+    for (auto& entry : batch.nodeEntries) {
+        auto dims = blob->getTensorDesc().getDims();
+        dims[0] = entry.batchSize;
+        InferenceEngine::Blob::Ptr slice;
+        auto status = createSharedBlob(slice, InferenceEngine::TensorDesc(tensorInfo.getPrecision(), dims, InferenceEngine::Layout::ANY));
+        if (!status.ok()) {
+            return status;
+        }
+        std::memcpy(InferenceEngine::as<InferenceEngine::MemoryBlob>(slice)->wmap().as<char*>(), data + offset * sampleByteSize, entry.batchSize * sampleByteSize);
+        entry.outputs.emplace(name, std::move(slice));
+        offset += entry.batchSize;
+    }
+    return StatusCode::OK;
+}
+
+Status DynamicBatcher::scatterOutputs(InferenceEngine::InferRequest& inferRequest, Batch& batch) {
+    const auto& postprocessing = instance.getModelConfig().getPostprocessing();
+    for (const auto& [name, tensorInfo] : outputsInfo) {
+        InferenceEngine::Blob::Ptr blob;
+        OutputGetter<InferenceEngine::InferRequest&> outputGetter(inferRequest);
+        auto status = outputGetter.get(tensorInfo->getName(), blob);
+        if (!status.ok()) {
+            return status;
+        }
+        auto postprocessingIt = postprocessing.find(tensorInfo->getName());
+        size_t offset = 0;
+        for (size_t i = 0; i < batch.responses.size(); ++i) {
+            const auto& outputFilter = batch.requests[i]->output_filter();
+            if (!outputFilter.empty() && std::find(outputFilter.begin(), outputFilter.end(), name) == outputFilter.end()) {
+                offset += batch.requestBatchSizes[i];
+                continue;
+            }
+            if (postprocessingIt != postprocessing.end()) {
+                status = serializePostprocessedBlobBatchSlice(*batch.responses[i], tensorInfo, blob, postprocessingIt->second, offset, batch.requestBatchSizes[i]);
+            } else {
+                auto& tensorProto = (*batch.responses[i]->mutable_outputs())[tensorInfo->getMappedName()];
+                status = serializeBlobBatchSliceToTensorProto(tensorProto, tensorInfo, blob, offset, batch.requestBatchSizes[i]);
+            }
+            if (!status.ok()) {
+                return status;
+            }
+            offset += batch.requestBatchSizes[i];
+        }
+        status = scatterNodeOutputs(name, *tensorInfo, blob, batch, offset);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status DynamicBatcher::fillStates(InferenceEngine::InferRequest& inferRequest, const Batch& batch) {
+    try {
+        for (auto&& state : inferRequest.QueryState()) {
+            // Entries of starting sequences and padding get the initial state
+            state.Reset();
+            const std::string stateName = state.GetName();
+            InferenceEngine::Blob::Ptr blob;
+            auto status = blobClone<InferenceEngine::Blob::CPtr>(blob, state.GetState());
+            if (!status.ok()) {
+                return status;
+            }
+            const size_t sampleByteSize = blob->byteSize() / maxBatchSize;
+            auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap();
+            char* buffer = holder.as<char*>();
+            for (size_t i = 0; i < batch.sequences.size(); ++i) {
+                if (batch.sequenceControlInputs[i] == SEQUENCE_START) {
+                    continue;
+                }
+                const sequence_memory_state_t& sequenceMemoryState = batch.sequences[i]->getMemoryState();
+                auto it = sequenceMemoryState.find(stateName);
+                if (it == sequenceMemoryState.end() || it->second->byteSize() != sampleByteSize) {
+                    return StatusCode::INTERNAL_ERROR;
+                }
+                std::memcpy(buffer + i * sampleByteSize, (const void*)InferenceEngine::as<InferenceEngine::MemoryBlob>(it->second)->rmap(), sampleByteSize);
+            }
+            state.SetState(blob);
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_DEBUG("Setting batched memory state failed for model {}, version {}: {}", instance.getName(), instance.getVersion(), e.what());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    return StatusCode::OK;
+}
+
+Status DynamicBatcher::scatterStates(InferenceEngine::InferRequest& inferRequest, const Batch& batch) {
+    try {
+        for (auto&& state : inferRequest.QueryState()) {
+            const std::string stateName = state.GetName();
+            InferenceEngine::Blob::CPtr batchedState = state.GetState();
+            for (size_t i = 0; i < batch.sequences.size(); ++i) {
+                if (batch.sequenceControlInputs[i] == SEQUENCE_END) {
+                    continue;
+                }
+                auto status = batch.sequences[i]->updateMemoryState(stateName, batchedState, i);
+                if (!status.ok()) {
+                    return status;
+                }
+            }
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_DEBUG("Getting batched memory state failed for model {}, version {}: {}", instance.getName(), instance.getVersion(), e.what());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
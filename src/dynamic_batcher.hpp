@@ -0,0 +1,211 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "adaptive_batch_window.hpp"
+#include "blobmap.hpp"
+#include "status.hpp"
+#include "tensorinfo.hpp"
+#include "workerpool.hpp"
+
+namespace ovms {
+
+class ModelInstance;
+class OVInferRequestsQueue;
+class Sequence;
+
+/**
+ * @brief Coalesces concurrent predict requests into a single inference on the model instance.
+ *
+ * The first request arriving when no batch is open becomes the batch leader. It waits until
+ * the batch is full or the batch timeout expires, runs one inference for all collected requests
+ * and scatters the outputs along the batch dimension back into every caller's response.
+ * Partial batches are zero padded up to the batch size the network was compiled with.
+ * With zero batch timeout it only pads single requests to a network compiled for larger batch.
+ * Steps of stateful sequences are batched the same way, with memory states of the sequences
+ * stacked along the batch dimension before inference and saved back to the sequences afterwards.
+ * With latency target set, batch timeout only caps the window, which together with the batch size
+ * closing the batch is adjusted by AdaptiveBatchWindow from observed traffic and inference durations.
+ * Inputs of pipeline DL node sessions join the same batches without blocking, so concurrent pipeline executions
+ * are batched together with each other and with direct requests to the model.
+ */
+class DynamicBatcher {
+public:
+    /**
+     * @brief Called with status of batch and outputs of node session, keyed by model output names
+     */
+    using node_callback_t = std::function<void(const Status&, BlobMap&)>;
+
+private:
+    struct NodeEntry {
+        BlobMap inputs;
+        size_t batchSize;
+        node_callback_t callback;
+        BlobMap outputs;
+    };
+
+    struct Batch {
+        std::vector<const tensorflow::serving::PredictRequest*> requests;
+        std::vector<tensorflow::serving::PredictResponse*> responses;
+        std::vector<size_t> requestBatchSizes;
+        // empty for stateless models
+        std::vector<Sequence*> sequences;
+        std::vector<uint32_t> sequenceControlInputs;
+        // placed in batch after requests
+        std::vector<NodeEntry> nodeEntries;
+        size_t collected = 0;
+        bool closed = false;
+        bool done = false;
+        Status status;
+        std::condition_variable cv;
+    };
+
+    ModelInstance& instance;
+    OVInferRequestsQueue& inferRequestsQueue;
+    const tensor_map_t& inputsInfo;
+    const tensor_map_t& outputsInfo;
+    const size_t maxBatchSize;
+    const std::chrono::microseconds batchTimeout;
+
+    std::mutex mutex;
+    std::shared_ptr<Batch> openBatch;
+    // guarded by mutex, nullptr when batch window is static
+    std::unique_ptr<AdaptiveBatchWindow> adaptiveWindow;
+
+    // closes and executes batches opened by node sessions, declared last so that it waits for them before the rest is destroyed
+    std::unique_ptr<WorkerPool> nodeBatchLeaders;
+
+    void close(Batch& batch);
+    // requires mutex
+    void recordLatency(std::chrono::steady_clock::time_point arrival);
+    /**
+     * @brief Adds entry to open batch or opens a new one, requires mutex
+     *
+     * @param isLeader set when entry opened the batch, its caller has to lead it
+     * @param window set to time the leader waits for the batch to fill
+     */
+    std::shared_ptr<Batch> join(size_t entryBatchSize, std::chrono::steady_clock::time_point arrival, const std::function<void(Batch&)>& addEntry,
+        bool& isLeader, std::chrono::microseconds& window);
+    /**
+     * @brief Waits until batch is closed or deadline passes, executes it and completes its entries, lock has to hold mutex
+     */
+    Status lead(std::unique_lock<std::mutex>& lock, const std::shared_ptr<Batch>& batch, std::chrono::steady_clock::time_point deadline,
+        std::chrono::steady_clock::time_point arrival);
+    Status execute(Batch& batch);
+    Status fillInputs(InferenceEngine::InferRequest& inferRequest, const Batch& batch);
+    Status fillNodeInputs(const std::string& name, const Batch& batch, char* buffer, size_t sampleByteSize, size_t offset);
+    Status scatterOutputs(InferenceEngine::InferRequest& inferRequest, Batch& batch);
+    Status scatterNodeOutputs(const std::string& name, const TensorInfo& tensorInfo, const InferenceEngine::Blob::Ptr& blob, Batch& batch, size_t offset);
+    Status fillStates(InferenceEngine::InferRequest& inferRequest, const Batch& batch);
+    Status scatterStates(InferenceEngine::InferRequest& inferRequest, const Batch& batch);
+    Status infer(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        size_t requestBatchSize, Sequence* sequence, uint32_t sequenceControlInput);
+
+public:
+    /**
+     * @brief Batches requests on the default executable network of model instance
+     *
+     * @param latencyTargetUs p99 latency the batch window is adapted to, 0 keeps static batch timeout
+     */
+    DynamicBatcher(ModelInstance& instance, size_t maxBatchSize, uint32_t batchTimeoutUs, uint32_t latencyTargetUs = 0);
+
+    /**
+     * @brief Batches requests on other executable network of model instance
+     *
+     * @param inferRequestsQueue streams of network compiled for maxBatchSize
+     * @param inputsInfo tensor information matching the network, has to outlive the batcher
+     * @param outputsInfo
+     * @param maxBatchSize
+     * @param batchTimeoutUs
+     * @param latencyTargetUs p99 latency the batch window is adapted to, 0 keeps static batch timeout
+     */
+    DynamicBatcher(ModelInstance& instance, OVInferRequestsQueue& inferRequestsQueue,
+        const tensor_map_t& inputsInfo, const tensor_map_t& outputsInfo,
+        size_t maxBatchSize, uint32_t batchTimeoutUs, uint32_t latencyTargetUs = 0) :
+        instance(instance),
+        inferRequestsQueue(inferRequestsQueue),
+        inputsInfo(inputsInfo),
+        outputsInfo(outputsInfo),
+        maxBatchSize(maxBatchSize),
+        batchTimeout(batchTimeoutUs) {
+        if (latencyTargetUs > 0) {
+            adaptiveWindow = std::make_unique<AdaptiveBatchWindow>(maxBatchSize, batchTimeout, std::chrono::microseconds(latencyTargetUs));
+        }
+        // threads are started on demand, one more than streams so that a batch collects while others execute
+        nodeBatchLeaders = std::make_unique<WorkerPool>(static_cast<size_t>(inferRequestsQueue.getStreamsCount()) + 1);
+    }
+
+    /**
+     * @brief Blocks until the batch containing the request is executed
+     *
+     * @param requestProto validated request
+     * @param responseProto
+     * @param requestBatchSize batch dimension of the request inputs
+     *
+     * @return Status
+     */
+    Status infer(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        size_t requestBatchSize);
+
+    /**
+     * @brief Blocks until the batch containing the sequence step is executed
+     *
+     * Caller holds the sequence lock, so a sequence has at most one step in a batch.
+     *
+     * @param requestProto validated request with batch size 1
+     * @param responseProto
+     * @param sequence
+     * @param sequenceControlInput state of sequence starting with SEQUENCE_START is reset, state of sequence ending with SEQUENCE_END is not saved
+     *
+     * @return Status
+     */
+    Status infer(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        Sequence& sequence, uint32_t sequenceControlInput);
+
+    /**
+     * @brief Adds inputs of pipeline node session to batch and returns without waiting
+     *
+     * Batch opened by node session is closed and executed on thread of the batcher, batch opened by direct request
+     * on the thread of that request. Callback runs on the thread executing the batch once it is done.
+     *
+     * @param inputs blobs matching model inputs except for batch dimension, keyed by model input names
+     * @param batchSize batch dimension of inputs, not larger than max batch size
+     * @param callback receives status of batch and outputs sliced for the node session
+     */
+    void inferAsync(const BlobMap& inputs, size_t batchSize, node_callback_t callback);
+
+    size_t getMaxBatchSize() const {
+        return maxBatchSize;
+    }
+};
+}  // namespace ovms
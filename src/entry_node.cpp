@@ -25,6 +25,8 @@
 #include "binaryutils.hpp"
 #include "deserialization.hpp"
 #include "logging.hpp"
+#include "shared_memory.hpp"
+#include "sparse_tensor.hpp"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
@@ -78,45 +80,6 @@ Status InputSink<BlobMap&>::give(const std::string& name, InferenceEngine::Blob:
     return StatusCode::OK;
 }
 
-Status EntryNode::isInputBinary(const std::string& name, bool& isBinary) const {
-    auto it = request->inputs().find(name);
-    if (it == request->inputs().end()) {
-        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Error during checking binary input; input: {} does not exist", name);
-        return StatusCode::INTERNAL_ERROR;
-    }
-    isBinary = it->second.string_val_size() > 0;
-    return StatusCode::OK;
-}
-
-Status EntryNode::createShardedBlob(InferenceEngine::Blob::Ptr& dividedBlob, const InferenceEngine::TensorDesc& dividedBlobDesc, InferenceEngine::Blob::Ptr blob, size_t i, size_t step, const NodeSessionMetadata& metadata, const std::string blobName) {
-    bool isBinary = false;
-    auto status = this->isInputBinary(blobName, isBinary);
-    if (!status.ok()) {
-        return status;
-    }
-    if (isBinary) {
-        return Node::createShardedBlob(dividedBlob, dividedBlobDesc, blob, i, step, metadata, blobName);
-    }
-
-    // if condition is perf optimization
-    // when demultiplying from entry node from tensor content we can skip allocation for sharded blobs
-    // and reuse memory from original blob since its memory is kept for whole duration of predict request
-    if (dividedBlobDesc.getPrecision() == InferenceEngine::Precision::FP32) {
-        dividedBlob = InferenceEngine::make_shared_blob<float>(dividedBlobDesc, InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<float*>() + i * step / sizeof(float));
-    } else if (dividedBlobDesc.getPrecision() == InferenceEngine::Precision::I32) {
-        dividedBlob = InferenceEngine::make_shared_blob<int32_t>(dividedBlobDesc, InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<int32_t*>() + i * step / sizeof(int32_t));
-    } else if (dividedBlobDesc.getPrecision() == InferenceEngine::Precision::I8) {
-        dividedBlob = InferenceEngine::make_shared_blob<int8_t>(dividedBlobDesc, InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<int8_t*>() + i * step / sizeof(int8_t));
-    } else if (dividedBlobDesc.getPrecision() == InferenceEngine::Precision::U8) {
-        dividedBlob = InferenceEngine::make_shared_blob<uint8_t>(dividedBlobDesc, InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<uint8_t*>() + i * step / sizeof(uint8_t));
-    } else if (dividedBlobDesc.getPrecision() == InferenceEngine::Precision::I16) {
-        dividedBlob = InferenceEngine::make_shared_blob<int16_t>(dividedBlobDesc, InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<int16_t*>() + i * step / sizeof(int16_t));
-    } else {
-        return Node::createShardedBlob(dividedBlob, dividedBlobDesc, blob, i, step, metadata, blobName);
-    }
-    return StatusCode::OK;
-}
-
 const Status EntryNode::validateNumberOfInputs(const tensorflow::serving::PredictRequest* request, const size_t expectedNumberOfInputs) {
     if (request->inputs_size() < 0 || expectedNumberOfInputs != static_cast<size_t>(request->inputs_size())) {
         std::stringstream ss;
@@ -163,8 +126,9 @@ const bool EntryNode::checkBinaryInputBatchSizeMismatch(const ovms::TensorInfo&
 
 const Status EntryNode::validatePrecision(const ovms::TensorInfo& networkInput,
     const tensorflow::TensorProto& requestInput) {
-    // Network and request must have the same precision
-    if (requestInput.dtype() != networkInput.getPrecisionAsDataType()) {
+    // Network and request must have the same precision unless request precision is converted
+    if (requestInput.dtype() != networkInput.getPrecisionAsDataType() &&
+        !networkInput.isConvertedFromDataType(requestInput.dtype())) {
         std::stringstream ss;
         ss << "Expected: " << networkInput.getPrecisionAsString()
            << "; Actual: " << TensorInfo::getDataTypeAsString(requestInput.dtype());
@@ -218,6 +182,13 @@ const Status EntryNode::validateTensorContentSize(const ovms::TensorInfo& networ
         expectedValueCount *= requestInput.tensor_shape().dim(i).size();
     }
 
+    if (isSparseTensor(requestInput)) {
+        return validateSparseInput(networkInput, requestInput);
+    }
+    if (isSharedMemoryReference(requestInput)) {
+        return validateSharedMemoryInput(networkInput, requestInput, expectedValueCount);
+    }
+
     // Network expects tensor content size or value count
     if (requestInput.dtype() == tensorflow::DataType::DT_UINT16) {
         if (requestInput.int_val_size() < 0 ||
@@ -228,7 +199,7 @@ const Status EntryNode::validateTensorContentSize(const ovms::TensorInfo& networ
             SPDLOG_DEBUG("Invalid number of values in tensor proto container - {}", details);
             return Status(StatusCode::INVALID_VALUE_COUNT, details);
         }
-    } else if (requestInput.dtype() == tensorflow::DataType::DT_HALF) {
+    } else if (requestInput.dtype() == tensorflow::DataType::DT_HALF && requestInput.tensor_content().size() == 0) {
         if (requestInput.half_val_size() < 0 ||
             expectedValueCount != static_cast<size_t>(requestInput.half_val_size())) {
             std::stringstream ss;
@@ -238,7 +209,8 @@ const Status EntryNode::validateTensorContentSize(const ovms::TensorInfo& networ
             return Status(StatusCode::INVALID_VALUE_COUNT, details);
         }
     } else {
-        size_t expectedContentSize = expectedValueCount * networkInput.getPrecision().size();
+        const auto precision = networkInput.isConvertedFromDataType(requestInput.dtype()) ? networkInput.getRequestPrecision() : networkInput.getPrecision();
+        size_t expectedContentSize = expectedValueCount * precision.size();
         if (expectedContentSize != requestInput.tensor_content().size()) {
             std::stringstream ss;
             ss << "Expected: " << expectedContentSize << " bytes; Actual: " << requestInput.tensor_content().size() << " bytes";
@@ -289,7 +261,8 @@ const Status EntryNode::validate() {
                 return status;
             }
 
-            if (checkBinaryInputBatchSizeMismatch(*networkInput, requestInput)) {
+            // size of raw binary data is validated during conversion to blob
+            if (!isRawBinaryInput(*networkInput) && checkBinaryInputBatchSizeMismatch(*networkInput, requestInput)) {
                 std::stringstream ss;
                 ss << "Expected: " << networkInput->getEffectiveShape()[0] << "; Actual: " << requestInput.string_val_size();
                 const std::string details = ss.str();
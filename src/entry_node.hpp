@@ -17,6 +17,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
@@ -33,32 +34,41 @@ const std::string ENTRY_NODE_NAME = "request";
 
 class EntryNode : public Node {
     const tensorflow::serving::PredictRequest* request;
-    const tensor_map_t inputsInfo;
+    const std::shared_ptr<const tensor_map_t> sharedInputsInfo;
+    const tensor_map_t& inputsInfo;
 
 public:
     EntryNode(const tensorflow::serving::PredictRequest* request,
         const tensor_map_t& inputsInfo,
         std::optional<uint32_t> demultiplyCount = std::nullopt) :
+        EntryNode(request, std::make_shared<const tensor_map_t>(inputsInfo), demultiplyCount) {}
+
+    /**
+     * @brief Constructor sharing inputs info with pipeline definition instead of copying it per request
+     */
+    EntryNode(const tensorflow::serving::PredictRequest* request,
+        std::shared_ptr<const tensor_map_t> inputsInfo,
+        std::optional<uint32_t> demultiplyCount = std::nullopt) :
         Node(ENTRY_NODE_NAME, demultiplyCount),
         request(request),
-        inputsInfo(inputsInfo) {}
+        sharedInputsInfo(std::move(inputsInfo)),
+        inputsInfo(*sharedInputsInfo) {}
 
     Status execute(session_key_t sessionId, PipelineEventQueue& notifyEndQueue) override;
 
+    const tensorflow::serving::PredictRequest* getRequest() const { return request; }
+
     Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) override;
 
 protected:
     Status fetchResults(BlobMap& outputs);
-    Status createShardedBlob(InferenceEngine::Blob::Ptr& dividedBlob, const InferenceEngine::TensorDesc& dividedBlobDesc, InferenceEngine::Blob::Ptr blob, size_t i, size_t step, const NodeSessionMetadata& metadata, const std::string blobName) override;
 
 public:
     // Entry nodes have no dependency
-    void addDependency(Node&, const Aliases&) override {
+    void addDependency(Node&, SharedAliases) override {
         throw std::logic_error("This node cannot have dependency");
     }
 
-    Status isInputBinary(const std::string& name, bool& isBinary) const;
-
     const Status validateNumberOfInputs(const tensorflow::serving::PredictRequest* request,
         const size_t expectedNumberOfInputs);
 
@@ -15,23 +15,60 @@
 //*****************************************************************************
 #pragma once
 
+#include "fair_share_scheduler.hpp"
 #include "ovinferrequestsqueue.hpp"
+#include "requestcontext.hpp"
+#include "status.hpp"
 
 namespace ovms {
 struct ExecutingStreamIdGuard {
     ExecutingStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue) :
+        slotGuard(FairShareScheduler::instance(), nullptr, RequestContext()),
         inferRequestsQueue_(inferRequestsQueue),
-        id_(inferRequestsQueue_.getIdleStream().get()),
-        inferRequest(inferRequestsQueue.getInferRequest(id_)) {}
+        id_(acquireStream(inferRequestsQueue_)),
+        inferRequest(&inferRequestsQueue.getInferRequest(id_)) {}
+
+    /**
+     * @brief Waits for idle stream according to request priority and deadline, check getStatus() before use
+     *
+     * @param tenant if set, share of server capacity of the model is taken before the stream
+     */
+    ExecutingStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue, const RequestContext& context, FairShareScheduler::Tenant* tenant = nullptr) :
+        slotGuard(FairShareScheduler::instance(), tenant, context),
+        inferRequestsQueue_(inferRequestsQueue) {
+        status = slotGuard.getStatus();
+        if (status.ok()) {
+            status = inferRequestsQueue_.acquireIdleStream(id_, context);
+        }
+        if (status.ok()) {
+            inferRequest = &inferRequestsQueue_.getInferRequest(id_);
+        } else {
+            id_ = -1;
+        }
+    }
     ~ExecutingStreamIdGuard() {
-        inferRequestsQueue_.returnStream(id_);
+        if (id_ >= 0) {
+            inferRequestsQueue_.returnStream(id_);
+        }
     }
     int getId() { return id_; }
-    InferenceEngine::InferRequest& getInferRequest() { return inferRequest; }
+    InferenceEngine::InferRequest& getInferRequest() { return *inferRequest; }
+    const Status& getStatus() const { return status; }
 
 private:
+    static int acquireStream(ovms::OVInferRequestsQueue& inferRequestsQueue) {
+        int streamId;
+        if (inferRequestsQueue.tryGetIdleStream(streamId)) {
+            return streamId;
+        }
+        return inferRequestsQueue.getIdleStream().get();
+    }
+
+    // released after the stream is returned
+    FairShareSlotGuard slotGuard;
     ovms::OVInferRequestsQueue& inferRequestsQueue_;
-    const int id_;
-    InferenceEngine::InferRequest& inferRequest;
+    int id_ = -1;
+    InferenceEngine::InferRequest* inferRequest = nullptr;
+    Status status = StatusCode::OK;
 };
 }  //  namespace ovms
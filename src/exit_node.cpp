@@ -15,6 +15,7 @@
 //*****************************************************************************
 #include "exit_node.hpp"
 
+#include <set>
 #include <string>
 #include <utility>
 
@@ -32,7 +33,33 @@
 namespace ovms {
 Status ExitNode::fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) {
     auto& exitNodeSession = static_cast<ExitNodeSession&>(nodeSession);
-    return this->fetchResults(exitNodeSession.getInputBlobs());
+    return this->fetchResults(exitNodeSession.getInputBlobs(), exitNodeSession.hasSkippedDependencies());
+}
+
+static std::string getAlternativeInputName(const std::string& outputName, const std::string& nodeName) {
+    return nodeName + ":" + outputName;
+}
+
+void ExitNode::addDependency(Node& node, SharedAliases blobNamesMapping) {
+    if (alternativeSources.empty()) {
+        Node::addDependency(node, std::move(blobNamesMapping));
+        return;
+    }
+    // each alternative source sets its own input, output is chosen when all dependencies finished
+    auto mapping = std::make_shared<Aliases>(*blobNamesMapping);
+    for (auto& [dependencyOutputName, inputName] : *mapping) {
+        if (alternativeSources.count(inputName) > 0) {
+            auto alternativeInputName = getAlternativeInputName(inputName, node.getName());
+            alternativeInputs.emplace(alternativeInputName, inputName);
+            inputName = std::move(alternativeInputName);
+        }
+    }
+    Node::addDependency(node, std::move(mapping));
+}
+
+const std::string& ExitNode::getOutputName(const std::string& inputName) const {
+    auto it = alternativeInputs.find(inputName);
+    return it != alternativeInputs.end() ? it->second : inputName;
 }
 
 Status ExitNode::execute(session_key_t sessionId, PipelineEventQueue& notifyEndQueue) {
@@ -51,9 +78,80 @@ Status OutputGetter<const BlobMap&>::get(const std::string& name, InferenceEngin
     return StatusCode::OK;
 }
 
-Status ExitNode::fetchResults(const BlobMap& inputBlobs) {
-    OutputGetter<const BlobMap&> outputGetter(inputBlobs);
-    return serializePredictResponse(outputGetter, this->outputsInfo, this->response);
+Status ExitNode::fetchResults(const BlobMap& inputBlobs, bool hasSkippedDependencies) {
+    if (streamsPartialOutputs()) {
+        // all outputs were already sent when dependency sessions finished
+        return StatusCode::OK;
+    }
+    if (alternativeSources.empty() && !hasSkippedDependencies) {
+        OutputGetter<const BlobMap&> outputGetter(inputBlobs);
+        return serializePredictResponse(outputGetter, this->outputsInfo, this->response);
+    }
+    BlobMap outputs;
+    for (const auto& [inputName, blob] : inputBlobs) {
+        if (alternativeInputs.count(inputName) == 0) {
+            outputs.emplace(inputName, blob);
+        }
+    }
+    for (const auto& [outputName, nodeNames] : alternativeSources) {
+        for (const auto& nodeName : nodeNames) {
+            auto it = inputBlobs.find(getAlternativeInputName(outputName, nodeName));
+            if (it != inputBlobs.end()) {
+                outputs.emplace(outputName, it->second);
+                break;
+            }
+        }
+    }
+    tensor_map_t executedOutputsInfo;
+    if (hasSkippedDependencies) {
+        for (const auto& [outputName, outputInfo] : this->outputsInfo) {
+            if (outputs.count(outputName) > 0) {
+                executedOutputsInfo.emplace(outputName, outputInfo);
+            } else {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Pipeline output: {} is provided only by skipped nodes", outputName);
+            }
+        }
+    }
+    OutputGetter<const BlobMap&> outputGetter(outputs);
+    return serializePredictResponse(outputGetter, hasSkippedDependencies ? executedOutputsInfo : this->outputsInfo, this->response);
+}
+
+Status ExitNode::sendPartialOutputs(const Node& dependency, SessionResults& dependencyResults) {
+    static const std::set<std::string> emptySet;
+    const auto& mapping = getMappingByDependency(dependency);
+    for (auto& [sessionKey, metadataBlobsPair] : dependencyResults) {
+        auto& [metadata, blobs] = metadataBlobsPair;
+        session_id_t shardId;
+        try {
+            shardId = metadata.getShardId(gatherFrom.value_or(emptySet));
+        } catch (const std::exception& e) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Failed to get shardId of node: {} session: {} partial outputs", dependency.getName(), sessionKey);
+            return StatusCode::INTERNAL_ERROR;
+        }
+        tensorflow::serving::PredictResponse partialResponse;
+        for (const auto& [dependencyOutputName, inputName] : mapping) {
+            const auto& outputName = getOutputName(inputName);
+            auto blobIt = blobs.find(dependencyOutputName);
+            auto outputInfoIt = outputsInfo.find(outputName);
+            if (blobIt == blobs.end() || outputInfoIt == outputsInfo.end()) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Failed to find pipeline output: {} in node: {} session: {} results", outputName, dependency.getName(), sessionKey);
+                return StatusCode::INTERNAL_ERROR;
+            }
+            // shard does not have dimensions added by gathering
+            auto shardOutputInfo = outputInfoIt->second->createCopyWithNewShape(getEffectiveBlobShape(blobIt->second));
+            auto& tensorProto = (*partialResponse.mutable_outputs())[shardOutputInfo->getMappedName()];
+            auto status = serializeBlobToTensorProto(tensorProto, shardOutputInfo, blobIt->second);
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Sending partial outputs of node: {} session: {} shard: {}", dependency.getName(), sessionKey, shardId);
+        auto status = partialOutputsCallback(dependency.getName(), shardId, partialResponse);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
 }
 
 std::unique_ptr<NodeSession> ExitNode::createNodeSession(const NodeSessionMetadata& metadata, const CollapseDetails& collapsingDetails) {
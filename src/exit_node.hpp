@@ -14,15 +14,19 @@
 // limitations under the License.
 //*****************************************************************************
 #pragma once
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "aliases.hpp"
 #include "node.hpp"
 #include "tensorinfo.hpp"
 
@@ -30,23 +34,85 @@ namespace ovms {
 
 const std::string EXIT_NODE_NAME = "response";
 
+/**
+ * @brief Receives pipeline outputs produced by single node session as soon as the session finishes
+ *
+ * @param nodeName name of node producing outputs
+ * @param shardId position of session outputs in outputs gathered by exit node, 0 when exit node does not gather
+ * @param partialResponse outputs produced by session, with shapes of single shard
+ *
+ * @return error stops pipeline execution
+ */
+using PartialOutputsCallback = std::function<Status(const std::string& nodeName, session_id_t shardId, tensorflow::serving::PredictResponse& partialResponse)>;
+
 class ExitNode : public Node {
     tensorflow::serving::PredictResponse* response;
-    const tensor_map_t outputsInfo;
+    const std::shared_ptr<const tensor_map_t> sharedOutputsInfo;
+    const tensor_map_t& outputsInfo;
+    PartialOutputsCallback partialOutputsCallback;
+    alternative_sources_t alternativeSources;
+    // key: input of node fed by one of alternative sources, value: pipeline output
+    std::unordered_map<std::string, std::string> alternativeInputs;
+
+    const std::string& getOutputName(const std::string& inputName) const;
 
 public:
     ExitNode(tensorflow::serving::PredictResponse* response, const tensor_map_t& outputsInfo, std::set<std::string> gatherFromNode = {}) :
+        ExitNode(response, std::make_shared<const tensor_map_t>(outputsInfo), std::move(gatherFromNode)) {
+    }
+
+    /**
+     * @brief Constructor sharing outputs info with pipeline definition instead of copying it per request
+     */
+    ExitNode(tensorflow::serving::PredictResponse* response, std::shared_ptr<const tensor_map_t> outputsInfo, std::set<std::string> gatherFromNode = {}) :
         Node(EXIT_NODE_NAME, std::nullopt, gatherFromNode),
         response(response),
-        outputsInfo(outputsInfo) {
+        sharedOutputsInfo(std::move(outputsInfo)),
+        outputsInfo(*sharedOutputsInfo) {
+    }
+
+    const tensorflow::serving::PredictResponse* getResponse() const {
+        return response;
     }
 
     // Exit node does not have execute logic.
     // It serializes its received input blobs to proto in ::fetchResults
     Status execute(session_key_t sessionId, PipelineEventQueue& notifyEndQueue) override;
 
+    /**
+     * @brief Streams outputs of every dependency session through callback instead of serializing them into response
+     */
+    void setPartialOutputsCallback(PartialOutputsCallback callback) {
+        this->partialOutputsCallback = std::move(callback);
+    }
+
+    bool streamsPartialOutputs() const {
+        return static_cast<bool>(this->partialOutputsCallback);
+    }
+
+    /**
+     * @brief Sets nodes connected to the same pipeline output, the first one which was executed provides it
+     *
+     * Needs to be called before dependencies are added.
+     */
+    void setAlternativeSources(const alternative_sources_t& alternativeSources) {
+        this->alternativeSources = alternativeSources;
+    }
+
+    void addDependency(Node& node, SharedAliases blobNamesMapping) override;
+
+    /**
+     * @brief Serializes session results of dependency which are pipeline outputs and passes them to partial outputs callback
+     */
+    Status sendPartialOutputs(const Node& dependency, SessionResults& dependencyResults);
+
 protected:
-    Status fetchResults(const BlobMap& outputs);
+    /**
+     * @param hasSkippedDependencies outputs provided only by skipped nodes are missing from response instead of failing it
+     */
+    Status fetchResults(const BlobMap& outputs, bool hasSkippedDependencies = false);
+
+    bool isSkippedWithDependency() const override { return false; }
 
 public:
     Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) override;
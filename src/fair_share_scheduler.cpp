@@ -0,0 +1,193 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "fair_share_scheduler.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+FairShareScheduler::Tenant::Tenant(const std::string& name, MetricRegistry* registry) :
+    name(name) {
+    if (registry) {
+        metrics = TenantMetrics::create(*registry, name);
+    } else {
+        metrics.inFlight = &ownInFlight;
+        metrics.waiting = &ownWaiting;
+        metrics.throttled = &ownThrottled;
+    }
+}
+
+void FairShareScheduler::setCapacity(uint32_t capacity) {
+    std::lock_guard<std::mutex> lock(mtx);
+    this->capacity = capacity;
+    dispatch();
+}
+
+FairShareScheduler::Tenant& FairShareScheduler::getTenant(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& tenant = tenants[name];
+    if (!tenant) {
+        tenant = std::make_unique<Tenant>(name, registry);
+    }
+    return *tenant;
+}
+
+void FairShareScheduler::configureTenant(Tenant& tenant, uint32_t weight, uint32_t maxConcurrent) {
+    std::lock_guard<std::mutex> lock(mtx);
+    tenant.weight = std::max<uint32_t>(weight, 1);
+    tenant.maxConcurrent = maxConcurrent;
+    dispatch();
+}
+
+bool FairShareScheduler::canRun(const Tenant& tenant) const {
+    return (capacity == 0 || inFlight < capacity) && (tenant.maxConcurrent == 0 || tenant.inFlight < tenant.maxConcurrent);
+}
+
+void FairShareScheduler::dispatch() {
+    while (waitingCount > 0) {
+        Tenant* selected = nullptr;
+        for (auto& [name, tenant] : tenants) {
+            if (tenant->waiters.empty() || !canRun(*tenant)) {
+                continue;
+            }
+            if (!selected) {
+                selected = tenant.get();
+                continue;
+            }
+            // lowest share after taking the slot, (inFlight + 1) / weight, wins, then the longest waiting request
+            const uint64_t share = static_cast<uint64_t>(tenant->inFlight + 1) * selected->weight;
+            const uint64_t selectedShare = static_cast<uint64_t>(selected->inFlight + 1) * tenant->weight;
+            if (share < selectedShare || (share == selectedShare && tenant->waiters.front()->sequence < selected->waiters.front()->sequence)) {
+                selected = tenant.get();
+            }
+        }
+        if (!selected) {
+            return;
+        }
+        Waiter* waiter = selected->waiters.front();
+        selected->waiters.pop_front();
+        waitingCount--;
+        add(selected->metrics.waiting, -1);
+        selected->inFlight++;
+        inFlight++;
+        add(selected->metrics.inFlight, 1);
+        waiter->isGranted = true;
+        if (waiter->onGranted) {
+            observe(selected->metrics.waitTime, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - waiter->queued).count());
+            auto callback = std::move(waiter->onGranted);
+            waiter->onGranted = nullptr;
+            callback();
+        } else {
+            waiter->granted.notify_one();
+        }
+    }
+}
+
+Status FairShareScheduler::acquire(Tenant& tenant, const RequestContext& context, bool& scheduled) {
+    scheduled = false;
+    if (capacity == 0 && tenant.maxConcurrent == 0) {
+        return StatusCode::OK;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mtx);
+    if (tenant.waiters.empty() && canRun(tenant)) {
+        tenant.inFlight++;
+        inFlight++;
+        add(tenant.metrics.inFlight, 1);
+        scheduled = true;
+        lock.unlock();
+        observe(tenant.metrics.waitTime, 0);
+        return StatusCode::OK;
+    }
+    Waiter waiter;
+    waiter.sequence = waitersSequence++;
+    tenant.waiters.push_back(&waiter);
+    waitingCount++;
+    add(tenant.metrics.waiting, 1);
+    increment(tenant.metrics.throttled);
+    while (!waiter.granted.wait_for(lock, CANCELLATION_POLL_INTERVAL, [&waiter] { return waiter.isGranted; })) {
+        auto status = context.check();
+        if (!status.ok()) {
+            tenant.waiters.erase(std::find(tenant.waiters.begin(), tenant.waiters.end(), &waiter));
+            waitingCount--;
+            add(tenant.metrics.waiting, -1);
+            SPDLOG_DEBUG("Request for model {} stopped waiting for its share of inferences: {}", tenant.name, status.string());
+            return status;
+        }
+    }
+    scheduled = true;
+    lock.unlock();
+    observe(tenant.metrics.waitTime, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    return StatusCode::OK;
+}
+
+bool FairShareScheduler::tryAcquireOrQueue(Tenant& tenant, Waiter& waiter, bool& scheduled) {
+    scheduled = false;
+    if (capacity == 0 && tenant.maxConcurrent == 0) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (tenant.waiters.empty() && canRun(tenant)) {
+        tenant.inFlight++;
+        inFlight++;
+        add(tenant.metrics.inFlight, 1);
+        observe(tenant.metrics.waitTime, 0);
+        scheduled = true;
+        return true;
+    }
+    waiter.sequence = waitersSequence++;
+    waiter.queued = std::chrono::steady_clock::now();
+    tenant.waiters.push_back(&waiter);
+    waitingCount++;
+    add(tenant.metrics.waiting, 1);
+    increment(tenant.metrics.throttled);
+    return false;
+}
+
+bool FairShareScheduler::notifyWhenGranted(Waiter& waiter, std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (waiter.isGranted) {
+        return false;
+    }
+    waiter.onGranted = std::move(callback);
+    return true;
+}
+
+bool FairShareScheduler::cancel(Tenant& tenant, Waiter& waiter) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (waiter.isGranted) {
+        return false;
+    }
+    tenant.waiters.erase(std::find(tenant.waiters.begin(), tenant.waiters.end(), &waiter));
+    waitingCount--;
+    add(tenant.metrics.waiting, -1);
+    waiter.onGranted = nullptr;
+    SPDLOG_DEBUG("Pipeline node session of model {} stopped waiting for its share of inferences", tenant.name);
+    return true;
+}
+
+void FairShareScheduler::release(Tenant& tenant) {
+    std::lock_guard<std::mutex> lock(mtx);
+    tenant.inFlight--;
+    inFlight--;
+    add(tenant.metrics.inFlight, -1);
+    dispatch();
+}
+
+}  // namespace ovms
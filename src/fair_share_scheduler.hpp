@@ -0,0 +1,278 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "metrics.hpp"
+#include "requestcontext.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Shares concurrent inferences of the server between models
+ *
+ * Each model is a tenant with a weight and an optional limit of its concurrent inferences.
+ * Requests take a slot before acquiring infer request of the model. When server capacity is exhausted,
+ * freed slots go to the waiting tenant with the lowest number of inferences in flight per weight,
+ * so that busy tenants share the capacity in proportion to their weights and a burst of one model
+ * does not starve others. Requests of a tenant are served in arrival order.
+ * Tenants without own limit do not take slots while server capacity is unlimited.
+ * Pipeline node sessions wait for slots without blocking, they are notified through callback once slot is granted.
+ */
+class FairShareScheduler {
+public:
+    /**
+     * @brief How often waiting requests check whether they were cancelled
+     */
+    static constexpr std::chrono::milliseconds CANCELLATION_POLL_INTERVAL{10};
+
+    struct Waiter {
+        std::condition_variable granted;
+        bool isGranted = false;
+        uint64_t sequence;
+        std::chrono::steady_clock::time_point queued;
+        // set for waiters not blocking their thread, called instead of notifying granted
+        std::function<void()> onGranted;
+    };
+
+    class Tenant {
+        friend class FairShareScheduler;
+
+        const std::string name;
+        // modified under scheduler mutex, limits are read without it to skip scheduling of unlimited tenants
+        uint32_t weight = 1;
+        std::atomic<uint32_t> maxConcurrent = 0;
+        uint32_t inFlight = 0;
+        std::deque<Waiter*> waiters;
+
+        Gauge ownInFlight;
+        Gauge ownWaiting;
+        Counter ownThrottled;
+        TenantMetrics metrics;
+
+    public:
+        Tenant(const std::string& name, MetricRegistry* registry);
+
+        const std::string& getName() const { return name; }
+
+        /**
+         * @brief Number of requests which had to wait for a slot
+         */
+        uint64_t getThrottledCount() const { return metrics.throttled->get(); }
+
+        int64_t getInFlight() const { return metrics.inFlight->get(); }
+
+        int64_t getWaiting() const { return metrics.waiting->get(); }
+    };
+
+private:
+    std::mutex mtx;
+    // tenants are never removed so that references to them stay valid
+    std::map<std::string, std::unique_ptr<Tenant>> tenants;
+    MetricRegistry* registry;
+
+    std::atomic<uint32_t> capacity = 0;
+    uint32_t inFlight = 0;
+    size_t waitingCount = 0;
+    uint64_t waitersSequence = 0;
+
+    bool canRun(const Tenant& tenant) const;
+
+    /**
+     * @brief Hands free slots over to waiting requests, requires mtx
+     */
+    void dispatch();
+
+public:
+    /**
+     * @param registry if set, saturation of tenants is reported in its metrics
+     */
+    explicit FairShareScheduler(MetricRegistry* registry = nullptr) :
+        registry(registry) {}
+
+    static FairShareScheduler& instance() {
+        static FairShareScheduler instance(&MetricRegistry::getInstance());
+        return instance;
+    }
+
+    /**
+     * @brief Sets number of inferences running concurrently in all models, 0 means unlimited
+     */
+    void setCapacity(uint32_t capacity);
+
+    uint32_t getCapacity() const { return capacity; }
+
+    /**
+     * @brief Gets tenant of model, creating it with default weight and no limit if needed
+     */
+    Tenant& getTenant(const std::string& name);
+
+    /**
+     * @param weight share of capacity relative to other tenants, at least 1
+     * @param maxConcurrent limit of concurrent inferences of the tenant, 0 means unlimited
+     */
+    void configureTenant(Tenant& tenant, uint32_t weight, uint32_t maxConcurrent);
+
+    /**
+     * @brief Waits for a slot of tenant according to its share
+     *
+     * @param scheduled set if slot was taken and has to be released, unlimited tenants do not take slots
+     *
+     * @return REQUEST_DEADLINE_EXCEEDED or REQUEST_CANCELLED if request stopped waiting
+     */
+    Status acquire(Tenant& tenant, const RequestContext& context, bool& scheduled);
+
+    /**
+     * @brief Takes slot of tenant if it is available right away, otherwise queues waiter without blocking
+     *
+     * @param waiter queued waiter, has to outlive waiting until it is granted or cancelled
+     * @param scheduled set if slot was taken and has to be released, unlimited tenants do not take slots
+     *
+     * @return false if waiter was queued
+     */
+    bool tryAcquireOrQueue(Tenant& tenant, Waiter& waiter, bool& scheduled);
+
+    /**
+     * @brief Registers callback called once slot is granted to queued waiter
+     *
+     * Callback is called on the thread releasing the slot, with scheduler locked, so it cannot call the scheduler.
+     *
+     * @return false if slot is already granted, callback is not registered then
+     */
+    bool notifyWhenGranted(Waiter& waiter, std::function<void()> callback);
+
+    /**
+     * @brief Removes queued waiter
+     *
+     * @return false if slot was already granted to waiter, it has to be released then
+     */
+    bool cancel(Tenant& tenant, Waiter& waiter);
+
+    void release(Tenant& tenant);
+};
+
+/**
+ * @brief Holds slot of tenant taken for single inference
+ */
+class FairShareSlotGuard {
+    FairShareScheduler& scheduler;
+    FairShareScheduler::Tenant* tenant = nullptr;
+    Status status = StatusCode::OK;
+
+public:
+    /**
+     * @brief Waits for slot, check getStatus() before use
+     *
+     * @param tenant if null, no slot is taken
+     */
+    FairShareSlotGuard(FairShareScheduler& scheduler, FairShareScheduler::Tenant* tenant, const RequestContext& context) :
+        scheduler(scheduler) {
+        bool scheduled = false;
+        if (tenant) {
+            status = scheduler.acquire(*tenant, context, scheduled);
+        }
+        if (scheduled) {
+            this->tenant = tenant;
+        }
+    }
+
+    FairShareSlotGuard(const FairShareSlotGuard&) = delete;
+    FairShareSlotGuard& operator=(const FairShareSlotGuard&) = delete;
+
+    ~FairShareSlotGuard() {
+        if (tenant) {
+            scheduler.release(*tenant);
+        }
+    }
+
+    const Status& getStatus() const { return status; }
+};
+
+/**
+ * @brief Holds slot of tenant taken for pipeline node session, waiting for it does not block pipeline thread
+ */
+class FairShareNodeSlotGuard {
+    FairShareScheduler& scheduler;
+    // set while slot is held or waited for
+    FairShareScheduler::Tenant* tenant = nullptr;
+    // set while slot is waited for or was granted after waiting
+    std::unique_ptr<FairShareScheduler::Waiter> waiter;
+
+public:
+    /**
+     * @param tenant if null, no slot is taken
+     */
+    FairShareNodeSlotGuard(FairShareScheduler& scheduler, FairShareScheduler::Tenant* tenant) :
+        scheduler(scheduler) {
+        if (!tenant) {
+            return;
+        }
+        auto queued = std::make_unique<FairShareScheduler::Waiter>();
+        bool scheduled = false;
+        if (!scheduler.tryAcquireOrQueue(*tenant, *queued, scheduled)) {
+            waiter = std::move(queued);
+            this->tenant = tenant;
+        } else if (scheduled) {
+            this->tenant = tenant;
+        }
+    }
+
+    FairShareNodeSlotGuard(const FairShareNodeSlotGuard&) = delete;
+    FairShareNodeSlotGuard& operator=(const FairShareNodeSlotGuard&) = delete;
+
+    ~FairShareNodeSlotGuard() {
+        disarm();
+    }
+
+    /**
+     * @brief Registers callback called once slot is granted, on the thread releasing the slot
+     *
+     * @return false if slot is already granted, callback is not registered then
+     */
+    bool notifyWhenGranted(std::function<void()> callback) {
+        if (!waiter) {
+            return false;
+        }
+        return scheduler.notifyWhenGranted(*waiter, std::move(callback));
+    }
+
+    /**
+     * @brief Releases slot or gives up waiting for it
+     */
+    void disarm() {
+        if (!tenant) {
+            return;
+        }
+        if (!waiter || !scheduler.cancel(*tenant, *waiter)) {
+            scheduler.release(*tenant);
+        }
+        tenant = nullptr;
+        waiter.reset();
+    }
+};
+
+}  // namespace ovms
@@ -15,15 +15,22 @@
 //*****************************************************************************
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <spdlog/spdlog.h>
 
 #include "model_version_policy.hpp"
 #include "status.hpp"
+#include "stringutils.hpp"
 
 namespace ovms {
 
@@ -141,6 +148,85 @@ public:
         return StatusCode::OK;
     }
 
+    /**
+     * @brief Read positive integer setting from environment variable
+     * 
+     * @param name 
+     * @param defaultValue used when variable is not set or invalid
+     * @return uint32_t 
+     */
+    static uint32_t getPositiveEnvValue(const char* name, uint32_t defaultValue) {
+        const char* value = std::getenv(name);
+        if (value == nullptr) {
+            return defaultValue;
+        }
+        auto parsed = stou32(value);
+        if (!parsed || parsed.value() == 0) {
+            SPDLOG_WARN("Invalid value of {}: {}. Using default: {}", name, value, defaultValue);
+            return defaultValue;
+        }
+        return parsed.value();
+    }
+
+    /**
+     * @brief Run tasks with given number of threads, stopping at first failure
+     * 
+     * @param tasksCount 
+     * @param concurrency 
+     * @param task called with task index
+     * @return StatusCode of the first failed task or OK
+     */
+    static StatusCode runConcurrently(size_t tasksCount, size_t concurrency, const std::function<StatusCode(size_t)>& task) {
+        std::atomic<size_t> nextTask{0};
+        std::atomic<bool> failed{false};
+        StatusCode result = StatusCode::OK;
+        std::mutex resultMutex;
+        auto worker = [&]() {
+            while (!failed) {
+                size_t i = nextTask++;
+                if (i >= tasksCount) {
+                    return;
+                }
+                auto status = task(i);
+                if (status != StatusCode::OK) {
+                    std::lock_guard<std::mutex> lock(resultMutex);
+                    if (!failed.exchange(true)) {
+                        result = status;
+                    }
+                }
+            }
+        };
+        size_t threadsCount = std::min(std::max(concurrency, size_t(1)), tasksCount);
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadsCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Create local file of given size so that its parts can be written in any order
+     * 
+     * @param path 
+     * @param size 
+     * @return StatusCode 
+     */
+    static StatusCode createLocalFile(const std::string& path, uint64_t size) {
+        std::ofstream outputFile(path.c_str(), std::ios::binary);
+        outputFile.close();
+        std::error_code ec;
+        fs::resize_file(path, size, ec);
+        if (!outputFile || ec) {
+            SPDLOG_ERROR("Failed to create local file: {} {}", path, ec.message());
+            return StatusCode::PATH_INVALID;
+        }
+        return StatusCode::OK;
+    }
+
     static bool isPathEscaped(const std::string& path) {
         return std::string::npos != path.find("../") || std::string::npos != path.find("/..");
     }
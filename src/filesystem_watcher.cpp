@@ -0,0 +1,161 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "filesystem_watcher.hpp"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+static const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+// Filesystem magic numbers from linux/magic.h
+static const std::set<int64_t> NETWORK_FILESYSTEMS{
+    0x6969,      // NFS
+    0xFF534D42,  // CIFS
+    0xFE534D42,  // SMB2
+    0x517B,      // SMB
+    0x65735546,  // FUSE
+    0x564c,      // NCP
+    0x5346414F,  // AFS
+    0x6B414653,  // kAFS
+    0x73757245,  // CODA
+    0x47504653,  // GPFS
+    0x0BD00BD0,  // Lustre
+    0x19830326,  // BeeGFS
+    0x00C36400,  // CephFS
+};
+
+FileSystemWatcher::FileSystemWatcher() {
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    interruptFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!isValid()) {
+        SPDLOG_WARN("Filesystem events are not available, changes will be detected by polling");
+    }
+}
+
+FileSystemWatcher::~FileSystemWatcher() {
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+    if (interruptFd >= 0) {
+        close(interruptFd);
+    }
+}
+
+bool FileSystemWatcher::isWatchable(const std::string& path) {
+    struct statfs fsInfo;
+    if (statfs(path.c_str(), &fsInfo) != 0) {
+        return false;
+    }
+    return NETWORK_FILESYSTEMS.count(static_cast<int64_t>(fsInfo.f_type)) == 0;
+}
+
+bool FileSystemWatcher::watchDirectories(const std::set<std::string>& paths) {
+    if (!isValid()) {
+        return false;
+    }
+    for (auto it = watches.begin(); it != watches.end();) {
+        if (paths.count(it->first) == 0) {
+            inotify_rm_watch(inotifyFd, it->second);
+            it = watches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    bool allWatched = true;
+    for (const auto& path : paths) {
+        // Adding existing watch returns the same descriptor, directory replaced under the same path gets a new one
+        int wd = inotify_add_watch(inotifyFd, path.c_str(), WATCH_MASK);
+        if (wd < 0) {
+            SPDLOG_DEBUG("Cannot watch directory: {}", path);
+            watches.erase(path);
+            allWatched = false;
+            continue;
+        }
+        watches[path] = wd;
+    }
+    return allWatched;
+}
+
+bool FileSystemWatcher::readEvents() {
+    alignas(struct inotify_event) char buffer[4096];
+    bool anyChange = false;
+    while (true) {
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return anyChange;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            // Removed watches report IN_IGNORED, which is not a change
+            if (!(event->mask & IN_IGNORED)) {
+                anyChange = true;
+            }
+            offset += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+bool FileSystemWatcher::waitForChanges(int timeoutMs, int debounceMs) {
+    if (!isValid()) {
+        return false;
+    }
+    struct pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {interruptFd, POLLIN, 0}};
+    bool changed = false;
+    int currentTimeoutMs = timeoutMs;
+    while (true) {
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        int result = poll(fds, 2, currentTimeoutMs);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return changed;
+        }
+        if (fds[1].revents & POLLIN) {
+            uint64_t value;
+            if (read(interruptFd, &value, sizeof(value)) < 0) {
+                SPDLOG_DEBUG("Failed to reset filesystem watcher interrupt");
+            }
+            return false;
+        }
+        if (result == 0 || !(fds[0].revents & POLLIN) || !readEvents()) {
+            return changed;
+        }
+        changed = true;
+        currentTimeoutMs = debounceMs;
+    }
+}
+
+void FileSystemWatcher::interrupt() {
+    if (interruptFd < 0) {
+        return;
+    }
+    uint64_t value = 1;
+    if (write(interruptFd, &value, sizeof(value)) < 0) {
+        SPDLOG_DEBUG("Failed to interrupt filesystem watcher");
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,84 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+
+namespace ovms {
+
+/**
+ * @brief Detects changes of local directories with inotify
+ *
+ * Reports entries created, removed, renamed, written or with changed attributes in watched directories.
+ * Changes made on other hosts of network filesystems are not reported, such directories have to be polled.
+ */
+class FileSystemWatcher {
+    int inotifyFd = -1;
+    // Wakes up waiting thread on interrupt
+    int interruptFd = -1;
+    std::map<std::string, int> watches;
+
+    // Drains pending events, returns true if any of them is a change
+    bool readEvents();
+
+public:
+    FileSystemWatcher();
+    ~FileSystemWatcher();
+    FileSystemWatcher(const FileSystemWatcher&) = delete;
+    FileSystemWatcher& operator=(const FileSystemWatcher&) = delete;
+
+    /**
+     * @brief Checks whether inotify is available
+     */
+    bool isValid() const {
+        return inotifyFd >= 0 && interruptFd >= 0;
+    }
+
+    /**
+     * @brief Checks whether changes of the path can be detected, false for network filesystems
+     */
+    static bool isWatchable(const std::string& path);
+
+    /**
+     * @brief Replaces watched directories, watches of directories kept in the set are reused
+     *
+     * @return false if any directory could not be watched
+     */
+    bool watchDirectories(const std::set<std::string>& paths);
+
+    /**
+     * @brief Waits for changes of watched directories
+     *
+     * After the first change waits until there are no changes for debounce time, so that
+     * files being copied are reported once.
+     *
+     * @param timeoutMs negative value waits until change or interrupt
+     * @param debounceMs
+     *
+     * @return true if changes were detected, false on timeout or interrupt
+     */
+    bool waitForChanges(int timeoutMs, int debounceMs);
+
+    /**
+     * @brief Wakes up thread waiting for changes
+     */
+    void interrupt();
+};
+
+}  // namespace ovms
@@ -16,7 +16,11 @@
 #include "gathernodeinputhandler.hpp"
 
 #include <functional>
+#include <memory>
+#include <numeric>
+#include <utility>
 
+#include "blob_view_allocator.hpp"
 #include "logging.hpp"
 #include "nodesessionmetadata.hpp"
 #include "ov_utils.hpp"
@@ -27,14 +31,19 @@ namespace ovms {
 GatherNodeInputHandler::GatherNodeInputHandler(uint32_t inputsMissingCount, const CollapseDetails& collapsingDetails) :
     NodeInputHandler(inputsMissingCount),
     collapsingDetails(std::make_unique<CollapseDetails>(collapsingDetails)) {
-    remainingDependencies = std::accumulate(
+    shardsCount = std::accumulate(
         collapsingDetails.collapsedSessionSizes.begin(),
         collapsingDetails.collapsedSessionSizes.end(),
-        remainingDependencies,
+        session_id_t(1),
         std::multiplies<session_id_t>());
+    remainingDependencies *= shardsCount;
 }
 
 Status GatherNodeInputHandler::setInput(const std::string& inputName, InferenceEngine::Blob::Ptr& ptr, session_id_t shardId) {
+    if (shardsCount == 0) {
+        // with no shards to consolidate, empty input is set as already gathered
+        return NodeInputHandler::setInput(inputName, ptr, shardId);
+    }
     auto inputsShardsIt = shardsStorage.find(inputName);
     if (inputsShardsIt == shardsStorage.end()) {
         shard_map_t shardMap{{shardId, ptr}};
@@ -53,46 +62,88 @@ Status GatherNodeInputHandler::setInput(const std::string& inputName, InferenceE
     return StatusCode::OK;
 }
 
+Status GatherNodeInputHandler::createConsolidatedBlob(const InferenceEngine::TensorDesc& shardDesc, InferenceEngine::Blob::Ptr& consolidatedBlob) const {
+    auto desc = shardDesc;
+    auto newDims = getEffectiveShape(desc);
+    newDims.insert(newDims.begin(),
+        collapsingDetails->collapsedSessionSizes.begin(),
+        collapsingDetails->collapsedSessionSizes.end());
+    const InferenceEngine::TensorDesc consolidatedBlobDesc(
+        shardDesc.getPrecision(),
+        newDims,
+        InferenceEngine::Layout::ANY);
+    if (blobAllocator) {
+        return createSharedBlob(consolidatedBlob, consolidatedBlobDesc, blobAllocator);
+    }
+    return createSharedBlob(consolidatedBlob, consolidatedBlobDesc);
+}
+
+InferenceEngine::Blob::Ptr GatherNodeInputHandler::getInputSlot(const std::string& inputName, session_id_t shardId, const InferenceEngine::TensorDesc& shardDesc) {
+    if (shardId >= shardsCount) {
+        return nullptr;
+    }
+    auto it = preallocatedInputs.find(inputName);
+    if (it == preallocatedInputs.end()) {
+        InferenceEngine::Blob::Ptr consolidatedBlob;
+        if (!createConsolidatedBlob(shardDesc, consolidatedBlob).ok()) {
+            return nullptr;
+        }
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Preallocated consolidated blob for input: {} of: {} shards", inputName, shardsCount);
+        it = preallocatedInputs.emplace(inputName, PreallocatedInput{std::move(consolidatedBlob), shardDesc}).first;
+    } else if (it->second.shardDesc != shardDesc) {
+        return nullptr;
+    }
+    auto& consolidatedBlob = it->second.consolidatedBlob;
+    const auto memstep = consolidatedBlob->byteSize() / shardsCount;
+    char* shardData = InferenceEngine::as<InferenceEngine::MemoryBlob>(consolidatedBlob)->wmap().as<char*>() + shardId * memstep;
+    InferenceEngine::Blob::Ptr slot;
+    if (!createSharedBlob(slot, shardDesc, std::make_shared<BlobViewAllocator>(consolidatedBlob, shardData)).ok() ||
+        slot->byteSize() != memstep) {
+        return nullptr;
+    }
+    return slot;
+}
+
 Status GatherNodeInputHandler::notifyFinishedDependency() {
     NodeInputHandler::notifyFinishedDependency();
     if (remainingDependencies > 0) {
         return StatusCode::OK;
     }
     for (auto& [inputName, shardMap] : shardsStorage) {
-        const auto shardsCount = shardMap.size();
-        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Consolidating: {} shards for input: {}", shardsCount, inputName);
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Consolidating: {} shards for input: {}", shardMap.size(), inputName);
         session_id_t firstShardId = 0;
         auto firstShardTensorDesc = shardMap.at(firstShardId)->getTensorDesc();
-        auto shardDims = getEffectiveShape(firstShardTensorDesc);
-        auto newDims = shardDims;
-        newDims.insert(newDims.begin(),
-            collapsingDetails->collapsedSessionSizes.begin(),
-            collapsingDetails->collapsedSessionSizes.end());
-        const InferenceEngine::TensorDesc consolidatedBlobDesc(
-            firstShardTensorDesc.getPrecision(),
-            newDims,
-            InferenceEngine::Layout::ANY);
         InferenceEngine::Blob::Ptr consolidatedBlob;
-        auto status = createSharedBlob(consolidatedBlob, consolidatedBlobDesc);
-        if (!status.ok()) {
-            return status;
+        auto preallocatedIt = preallocatedInputs.find(inputName);
+        if (preallocatedIt != preallocatedInputs.end() && preallocatedIt->second.shardDesc == firstShardTensorDesc) {
+            consolidatedBlob = preallocatedIt->second.consolidatedBlob;
+        } else {
+            auto status = createConsolidatedBlob(firstShardTensorDesc, consolidatedBlob);
+            if (!status.ok()) {
+                return status;
+            }
         }
+        char* consolidatedData = InferenceEngine::as<InferenceEngine::MemoryBlob>(consolidatedBlob)->wmap().as<char*>();
         for (auto& [shardId, blob] : shardMap) {
             auto& shardTensorDesc = blob->getTensorDesc();
             if (shardTensorDesc != firstShardTensorDesc) {
                 SPDLOG_LOGGER_ERROR(dag_executor_logger, "Failed to consolidate blob: {} shards in gather node. First shard has different tensor description: {} than current shard: {}",
                     inputName,
+                    TensorInfo::tensorDescToString(firstShardTensorDesc),
                     TensorInfo::tensorDescToString(shardTensorDesc));
                 return StatusCode::PIPELINE_INCONSISTENT_SHARD_DIMENSIONS;
             }
             const auto memstep = blob->byteSize();
             size_t offset = shardId * memstep;
-            memcpy(InferenceEngine::as<InferenceEngine::MemoryBlob>(consolidatedBlob)->wmap().as<char*>() + offset,
-                InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<char*>(),
-                memstep);
+            const char* shardData = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const char*>();
+            // shards written in place through getInputSlot are already there
+            if (shardData != consolidatedData + offset) {
+                memcpy(consolidatedData + offset, shardData, memstep);
+            }
         }
         inputBlobs.insert({inputName, consolidatedBlob});
     }
+    preallocatedInputs.clear();
     return StatusCode::OK;
 }
 }  // namespace ovms
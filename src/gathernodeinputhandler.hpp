@@ -32,12 +32,28 @@ using shard_map_t = std::unordered_map<session_id_t, InferenceEngine::Blob::Ptr>
 class CollapseDetails;
 
 class GatherNodeInputHandler : public NodeInputHandler {
+    struct PreallocatedInput {
+        InferenceEngine::Blob::Ptr consolidatedBlob;
+        InferenceEngine::TensorDesc shardDesc;
+    };
+
     std::unordered_map<std::string, shard_map_t> shardsStorage;
+    std::unordered_map<std::string, PreallocatedInput> preallocatedInputs;
     std::unique_ptr<CollapseDetails> collapsingDetails;
+    session_id_t shardsCount;
 
 public:
     GatherNodeInputHandler(uint32_t inputsMissingCount, const CollapseDetails& collapsingDetails);
     Status setInput(const std::string& inputName, InferenceEngine::Blob::Ptr& blobPtr, session_id_t shardId) override;
     Status notifyFinishedDependency() override;
+    /**
+     * @brief Allocates consolidated input on first request and gets view of its part for given shard
+     *
+     * Shards set later with the view are not copied when consolidating.
+     */
+    InferenceEngine::Blob::Ptr getInputSlot(const std::string& inputName, session_id_t shardId, const InferenceEngine::TensorDesc& shardDesc) override;
+
+private:
+    Status createConsolidatedBlob(const InferenceEngine::TensorDesc& shardDesc, InferenceEngine::Blob::Ptr& consolidatedBlob) const;
 };
 }  // namespace ovms
@@ -25,13 +25,17 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "gcsfilesystem.hpp"
 
+#include <array>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "logging.hpp"
+#include "remote_files_cache.hpp"
 #include "stringutils.hpp"
 
 namespace ovms {
@@ -41,6 +45,12 @@ namespace gcs = google::cloud::storage;
 
 const std::string GCSFileSystem::GCS_URL_PREFIX = "gs://";
 
+const uint32_t GCSFileSystem::DEFAULT_DOWNLOAD_PART_SIZE_MB = 8;
+const uint32_t GCSFileSystem::DEFAULT_DOWNLOAD_CONCURRENCY = 8;
+const int GCSFileSystem::DOWNLOAD_PART_RETRIES = 3;
+
+static const size_t DOWNLOAD_BUFFER_SIZE = 64 * 1024;
+
 StatusCode GCSFileSystem::parsePath(const std::string& path,
     std::string* bucket, std::string* object) {
     int bucket_start = path.find(GCS_URL_PREFIX) + GCS_URL_PREFIX.size();
@@ -85,12 +95,16 @@ google::cloud::storage::ClientOptions createDefaultOrAnonymousClientOptions() {
 }  // namespace
 
 GCSFileSystem::GCSFileSystem() :
-    client_{createDefaultOrAnonymousClientOptions()} {
+    client_{createDefaultOrAnonymousClientOptions()},
+    download_part_size_(static_cast<uint64_t>(getPositiveEnvValue("GCS_DOWNLOAD_PART_SIZE_MB", DEFAULT_DOWNLOAD_PART_SIZE_MB)) * 1024 * 1024),
+    download_concurrency_(getPositiveEnvValue("GCS_DOWNLOAD_CONCURRENCY", DEFAULT_DOWNLOAD_CONCURRENCY)) {
     SPDLOG_LOGGER_TRACE(gcs_logger, "GCSFileSystem default ctor");
 }
 
 GCSFileSystem::GCSFileSystem(const gcs::v1::ClientOptions& options) :
-    client_{options, gcs::StrictIdempotencyPolicy()} {
+    client_{options, gcs::StrictIdempotencyPolicy()},
+    download_part_size_(static_cast<uint64_t>(getPositiveEnvValue("GCS_DOWNLOAD_PART_SIZE_MB", DEFAULT_DOWNLOAD_PART_SIZE_MB)) * 1024 * 1024),
+    download_concurrency_(getPositiveEnvValue("GCS_DOWNLOAD_CONCURRENCY", DEFAULT_DOWNLOAD_CONCURRENCY)) {
     SPDLOG_LOGGER_TRACE(gcs_logger, "GCSFileSystem ctor with custom options");
 }
 
@@ -273,29 +287,10 @@ StatusCode GCSFileSystem::readTextFile(const std::string& path,
         SPDLOG_LOGGER_ERROR(gcs_logger, "Downloading file has failed: ", path);
         return StatusCode::GCS_FILE_INVALID;
     }
-    std::string data = "";
-    char c = 0;
-    while (stream.get(c)) {
-        data += c;
-    }
-    *contents = data;
+    // objects can hold model weights, so they are read in bulk instead of by character
+    contents->assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
     SPDLOG_LOGGER_TRACE(gcs_logger, "File {} has been downloaded (bytes={})", path,
-        data.size());
-    return StatusCode::OK;
-}
-
-StatusCode GCSFileSystem::downloadFile(const std::string& remote_path,
-    const std::string& local_path) {
-    SPDLOG_LOGGER_TRACE(gcs_logger, "Saving file {} to {}", remote_path, local_path);
-    std::string contents;
-    auto read_status = this->readTextFile(remote_path, &contents);
-    if (read_status != StatusCode::OK) {
-        SPDLOG_LOGGER_ERROR(gcs_logger, "Failed to get object at {}", remote_path);
-        return read_status;
-    }
-    std::ofstream output_file(local_path.c_str(), std::ios::binary);
-    output_file << contents;
-    output_file.close();
+        contents->size());
     return StatusCode::OK;
 }
 
@@ -333,6 +328,16 @@ StatusCode GCSFileSystem::downloadModelVersions(const std::string& path,
 
 StatusCode GCSFileSystem::downloadFileFolder(const std::string& path, const std::string& local_path) {
     SPDLOG_LOGGER_TRACE(gcs_logger, "Downloading dir {} and saving to {}", path, local_path);
+    std::vector<std::pair<std::string, std::string>> files;
+    auto status = collectFilesToDownload(path, local_path, files);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    return downloadFiles(files);
+}
+
+StatusCode GCSFileSystem::collectFilesToDownload(const std::string& path, const std::string& local_path,
+    std::vector<std::pair<std::string, std::string>>& files) {
     bool is_dir;
     auto status = this->isDirectory(path, &is_dir);
     if (status != StatusCode::OK) {
@@ -350,8 +355,8 @@ StatusCode GCSFileSystem::downloadFileFolder(const std::string& path, const std:
         return status;
     }
 
-    std::set<std::string> files;
-    status = getDirectoryFiles(path, &files);
+    std::set<std::string> dir_files;
+    status = getDirectoryFiles(path, &dir_files);
     if (status != StatusCode::OK) {
         return status;
     }
@@ -366,7 +371,7 @@ StatusCode GCSFileSystem::downloadFileFolder(const std::string& path, const std:
             return status;
         }
         auto download_dir_status =
-            this->downloadFileFolder(remote_dir_path, local_dir_path);
+            this->collectFilesToDownload(remote_dir_path, local_dir_path, files);
         if (download_dir_status != StatusCode::OK) {
             SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to download directory from {} to {}",
                 remote_dir_path, local_dir_path);
@@ -374,26 +379,160 @@ StatusCode GCSFileSystem::downloadFileFolder(const std::string& path, const std:
         }
     }
 
-    for (auto&& f : files) {
+    for (auto&& f : dir_files) {
         if (std::any_of(acceptedFiles.begin(), acceptedFiles.end(), [&f](const std::string& x) {
                 return f.size() > 0 && endsWith(f, x);
             })) {
-            std::string remote_file_path = joinPath({path, f});
-            std::string local_file_path = joinPath({local_path, f});
-            SPDLOG_LOGGER_TRACE(gcs_logger, "Processing file {} from {} -> {}", f, remote_file_path,
-                local_file_path);
-            auto download_status =
-                this->downloadFile(remote_file_path, local_file_path);
-            if (download_status != StatusCode::OK) {
-                SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to save file from {} to {}", remote_file_path,
-                    local_file_path);
-                return download_status;
+            SPDLOG_LOGGER_TRACE(gcs_logger, "Processing file {} from {} -> {}", f, joinPath({path, f}),
+                joinPath({local_path, f}));
+            files.emplace_back(joinPath({path, f}), joinPath({local_path, f}));
+        }
+    }
+    return StatusCode::OK;
+}
+
+StatusCode GCSFileSystem::downloadFiles(const std::vector<std::pair<std::string, std::string>>& files) {
+    auto cache = RemoteFilesCache::getInstance();
+    std::vector<ObjectDownload> downloads;
+    std::vector<ObjectPart> parts;
+    downloads.reserve(files.size());
+    for (const auto& [remote_file_path, local_file_path] : files) {
+        ObjectDownload download;
+        auto status = parsePath(remote_file_path, &download.bucket, &download.object);
+        if (status != StatusCode::OK) {
+            return status;
+        }
+        download.localPath = local_file_path;
+
+        auto metadata = client_.GetObjectMetadata(download.bucket, download.object);
+        if (!metadata) {
+            SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to get object metadata {}: {}", remote_file_path,
+                metadata.status().message());
+            return StatusCode::GCS_FILE_NOT_FOUND;
+        }
+        download.crc32c = metadata->crc32c();
+        if (cache) {
+            // MD5 is missing for composite objects
+            download.cacheKey = metadata->md5_hash().empty() ? RemoteFilesCache::makeKey("gcs-crc32c", metadata->crc32c(), metadata->size()) : RemoteFilesCache::makeKey("md5", metadata->md5_hash(), metadata->size());
+            if (cache->fetch(download.cacheKey, local_file_path)) {
+                continue;
             }
         }
+
+        status = createLocalFile(local_file_path, metadata->size());
+        if (status != StatusCode::OK) {
+            return status;
+        }
+        for (uint64_t offset = 0; offset < metadata->size(); offset += download_part_size_) {
+            parts.push_back({downloads.size(), offset, std::min(download_part_size_, metadata->size() - offset)});
+        }
+        downloads.push_back(std::move(download));
+    }
+
+    // Parts of all files share one queue, so both large and many small files use all connections
+    auto status = runConcurrently(parts.size(), download_concurrency_, [this, &downloads, &parts](size_t i) {
+        return downloadObjectPart(downloads[parts[i].downloadIndex], parts[i]);
+    });
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    status = runConcurrently(downloads.size(), download_concurrency_, [this, &downloads](size_t i) {
+        return verifyChecksum(downloads[i]);
+    });
+    if (status == StatusCode::OK && cache) {
+        for (const auto& download : downloads) {
+            cache->store(download.cacheKey, download.localPath);
+        }
+    }
+    return status;
+}
+
+StatusCode GCSFileSystem::downloadObjectPart(const ObjectDownload& download, const ObjectPart& part) {
+    std::fstream output_file(download.localPath.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    if (!output_file) {
+        SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to open local file {}", download.localPath);
+        return StatusCode::GCS_FILE_INVALID;
+    }
+    std::vector<char> buffer(DOWNLOAD_BUFFER_SIZE);
+    uint64_t downloaded = 0;
+    for (int attempt = 0; attempt <= DOWNLOAD_PART_RETRIES && downloaded < part.size; ++attempt) {
+        // Retries continue from the last received byte instead of restarting the whole file
+        auto stream = client_.ReadObject(download.bucket, download.object,
+            gcs::ReadRange(part.offset + downloaded, part.offset + part.size));
+        output_file.seekp(part.offset + downloaded);
+        while (downloaded < part.size && (stream.read(buffer.data(), buffer.size()) || stream.gcount() > 0)) {
+            output_file.write(buffer.data(), stream.gcount());
+            downloaded += stream.gcount();
+        }
+        if (!output_file) {
+            SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to write local file {}", download.localPath);
+            return StatusCode::GCS_FILE_INVALID;
+        }
+        if (downloaded < part.size) {
+            SPDLOG_LOGGER_WARN(gcs_logger, "Download of {}/{} interrupted at byte {}: {}", download.bucket, download.object,
+                part.offset + downloaded, stream.status().message());
+        }
+    }
+    if (downloaded != part.size) {
+        SPDLOG_LOGGER_ERROR(gcs_logger, "Downloading file has failed: {}/{}", download.bucket, download.object);
+        return StatusCode::GCS_FILE_INVALID;
     }
     return StatusCode::OK;
 }
 
+StatusCode GCSFileSystem::verifyChecksum(const ObjectDownload& download) {
+    if (download.crc32c.empty()) {
+        // Composite objects created before checksums were introduced may not have one
+        return StatusCode::OK;
+    }
+    std::ifstream input_file(download.localPath.c_str(), std::ios::binary);
+    std::vector<char> buffer(DOWNLOAD_BUFFER_SIZE);
+    uint32_t crc = 0;
+    while (input_file.read(buffer.data(), buffer.size()) || input_file.gcount() > 0) {
+        crc = extendCrc32c(crc, buffer.data(), input_file.gcount());
+    }
+    auto actual = encodeCrc32c(crc);
+    if (actual != download.crc32c) {
+        SPDLOG_LOGGER_ERROR(gcs_logger, "Checksum mismatch of downloaded file {}/{}: expected {}, got {}",
+            download.bucket, download.object, download.crc32c, actual);
+        return StatusCode::GCS_FILE_INVALID;
+    }
+    return StatusCode::OK;
+}
+
+uint32_t GCSFileSystem::extendCrc32c(uint32_t crc, const char* data, size_t size) {
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < table.size(); ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? (value >> 1) ^ 0x82F63B78 : value >> 1;
+            }
+            table[i] = value;
+        }
+        return table;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::string GCSFileSystem::encodeCrc32c(uint32_t crc) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const uint8_t bytes[] = {uint8_t(crc >> 24), uint8_t(crc >> 16), uint8_t(crc >> 8), uint8_t(crc)};
+    std::string encoded;
+    encoded += alphabet[bytes[0] >> 2];
+    encoded += alphabet[((bytes[0] & 0x03) << 4) | (bytes[1] >> 4)];
+    encoded += alphabet[((bytes[1] & 0x0F) << 2) | (bytes[2] >> 6)];
+    encoded += alphabet[bytes[2] & 0x3F];
+    encoded += alphabet[bytes[3] >> 2];
+    encoded += alphabet[(bytes[3] & 0x03) << 4];
+    encoded += "==";
+    return encoded;
+}
+
 StatusCode GCSFileSystem::deleteFileFolder(const std::string& path) {
     SPDLOG_LOGGER_DEBUG(gcs_logger, "Deleting local file folder {}", path);
     if (::remove(path.c_str()) == 0) {
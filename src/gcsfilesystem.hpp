@@ -17,6 +17,7 @@
 
 #include <regex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "google/cloud/storage/client.h"
@@ -133,7 +134,43 @@ public:
 
     static const std::string GCS_URL_PREFIX;
 
+    static const uint32_t DEFAULT_DOWNLOAD_PART_SIZE_MB;
+    static const uint32_t DEFAULT_DOWNLOAD_CONCURRENCY;
+    static const int DOWNLOAD_PART_RETRIES;
+
+    /**
+   * @brief Extend CRC32C (Castagnoli) checksum with given data
+   *
+   * @param crc checksum of preceding data, 0 for the first chunk
+   * @param data
+   * @param size
+   * @return uint32_t
+   */
+    static uint32_t extendCrc32c(uint32_t crc, const char* data, size_t size);
+
+    /**
+   * @brief Encode checksum in the format of GCS object metadata (base64 of big-endian bytes)
+   *
+   * @param crc
+   * @return std::string
+   */
+    static std::string encodeCrc32c(uint32_t crc);
+
 private:
+    struct ObjectDownload {
+        std::string bucket;
+        std::string object;
+        std::string localPath;
+        std::string crc32c;
+        std::string cacheKey;
+    };
+
+    struct ObjectPart {
+        size_t downloadIndex;
+        uint64_t offset;
+        uint64_t size;
+    };
+
     /**
     * @brief
     *
@@ -146,20 +183,48 @@ private:
         std::string* object);
 
     /**
+    * @brief Create local directories tree and collect accepted files to download
     *
-    * @brief
-    *
-    * @param remote_path
+    * @param path
     * @param local_path
+    * @param files pairs of remote and local file path
+    * @return StatusCode
+    */
+    StatusCode collectFilesToDownload(const std::string& path, const std::string& local_path,
+        std::vector<std::pair<std::string, std::string>>& files);
+
+    /**
+    * @brief Download files concurrently with ranged reads and verify their checksums
+    *
+    * @param files pairs of remote and local file path
+    * @return StatusCode
+    */
+    StatusCode downloadFiles(const std::vector<std::pair<std::string, std::string>>& files);
+
+    /**
+    * @brief Download a byte range of an object, resuming from the last received byte on failure
+    *
+    * @param download
+    * @param part
+    * @return StatusCode
+    */
+    StatusCode downloadObjectPart(const ObjectDownload& download, const ObjectPart& part);
+
+    /**
+    * @brief Compare checksum of downloaded file with the object metadata
+    *
+    * @param download
+    * @return StatusCode
     */
-    StatusCode downloadFile(const std::string& remote_path,
-        const std::string& local_path);
+    StatusCode verifyChecksum(const ObjectDownload& download);
 
     /**
     * @brief
     *
     */
     google::cloud::storage::Client client_;
+    uint64_t download_part_size_;
+    uint32_t download_concurrency_;
 };
 
 }  // namespace ovms
@@ -37,6 +37,60 @@ Status GetModelMetadataImpl::getModelStatus(
     const tensorflow::serving::GetModelMetadataRequest* request,
     tensorflow::serving::GetModelMetadataResponse* response,
     ModelManager& manager) {
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelMetadataResponse>> cached;
+    auto status = getCachedResponse(request, cached, manager);
+    if (!status.ok()) {
+        return status;
+    }
+    *response = cached->response;
+    return StatusCode::OK;
+}
+
+Status GetModelMetadataImpl::getModelStatusJson(
+    const tensorflow::serving::GetModelMetadataRequest* request,
+    std::string* output) {
+    auto status = validate(request);
+    if (!status.ok()) {
+        return status;
+    }
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelMetadataResponse>> cached;
+    status = getCachedResponse(request, cached, ModelManager::getInstance());
+    if (!status.ok()) {
+        return status;
+    }
+    *output = cached->json;
+    return StatusCode::OK;
+}
+
+/**
+ * Builds response with its JSON serialization and stores it in cache if there is one
+ */
+template <typename Builder>
+static Status buildCachedResponse(ServiceResponseCache<tensorflow::serving::GetModelMetadataResponse>* cache, uint64_t key, Builder build,
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelMetadataResponse>>& cached) {
+    tensorflow::serving::GetModelMetadataResponse response;
+    auto status = build(response);
+    if (!status.ok()) {
+        return status;
+    }
+    std::string json;
+    status = GetModelMetadataImpl::serializeResponse2Json(&response, &json);
+    if (!status.ok()) {
+        return status;
+    }
+    if (cache) {
+        cached = cache->insert(key, std::move(response), std::move(json));
+    } else {
+        cached = std::make_shared<const CachedServiceResponse<tensorflow::serving::GetModelMetadataResponse>>(
+            CachedServiceResponse<tensorflow::serving::GetModelMetadataResponse>{key, std::move(response), std::move(json)});
+    }
+    return StatusCode::OK;
+}
+
+Status GetModelMetadataImpl::getCachedResponse(
+    const tensorflow::serving::GetModelMetadataRequest* request,
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelMetadataResponse>>& cached,
+    ModelManager& manager) {
     const auto& name = request->model_spec().name();
     model_version_t version = request->model_spec().has_version() ? request->model_spec().version().value() : 0;
 
@@ -45,9 +99,17 @@ Status GetModelMetadataImpl::getModelStatus(
         SPDLOG_DEBUG("GetModelMetadata: Model {} is missing, trying to find pipeline with such name", name);
         auto pipelineDefinition = manager.getPipelineFactory().findDefinitionByName(name);
         if (!pipelineDefinition) {
-            return StatusCode::MODEL_NAME_MISSING;
+            return manager.isModelLoadPending(name) ? StatusCode::MODEL_VERSION_NOT_LOADED_YET : StatusCode::MODEL_NAME_MISSING;
         }
-        return buildResponse(*pipelineDefinition, response, manager);
+        // metadata of published plan does not change, unavailable definition is reported by building response
+        auto cache = pipelineDefinition->getMetadataResponseCache();
+        if (cache) {
+            cached = cache->find(0);
+            if (cached && pipelineDefinition->getStatus().isAvailable()) {
+                return StatusCode::OK;
+            }
+        }
+        return buildCachedResponse(cache.get(), 0, [&](auto& response) { return buildResponse(*pipelineDefinition, &response, manager); }, cached);
     }
 
     std::shared_ptr<ModelInstance> instance = nullptr;
@@ -67,7 +129,13 @@ Status GetModelMetadataImpl::getModelStatus(
         }
     }
 
-    return buildResponse(instance, response);
+    // responses are built only for loaded versions, inputs and outputs change only while status changes
+    const uint64_t key = ModelVersionStatus::getChangesCount();
+    cached = instance->getMetadataResponseCache().find(key);
+    if (cached) {
+        return StatusCode::OK;
+    }
+    return buildCachedResponse(&instance->getMetadataResponseCache(), key, [&](auto& response) { return buildResponse(instance, &response); }, cached);
 }
 
 Status GetModelMetadataImpl::validate(
@@ -25,6 +25,7 @@
 #pragma GCC diagnostic pop
 
 #include "modelmanager.hpp"
+#include "service_response_cache.hpp"
 #include "status.hpp"
 
 namespace ovms {
@@ -34,6 +35,14 @@ using proto_signature_map_t = google::protobuf::Map<std::string, tensorflow::Ten
 class PipelineDefinition;
 
 class GetModelMetadataImpl {
+    /**
+     * @brief Finds response built since servable was loaded or builds and caches it
+     */
+    static Status getCachedResponse(
+        const tensorflow::serving::GetModelMetadataRequest* request,
+        std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelMetadataResponse>>& cached,
+        ModelManager& manager);
+
 public:
     static Status validate(
         const tensorflow::serving::GetModelMetadataRequest* request);
@@ -57,6 +66,12 @@ public:
         const tensorflow::serving::GetModelMetadataRequest* request,
         tensorflow::serving::GetModelMetadataResponse* response,
         ModelManager& manager);
+    /**
+     * @brief Returns JSON serialization of the response, serialized once per loaded version or pipeline validation
+     */
+    static Status getModelStatusJson(
+        const tensorflow::serving::GetModelMetadataRequest* request,
+        std::string* output);
     static Status createGrpcRequest(std::string model_name, std::optional<int64_t> model_version, tensorflow::serving::GetModelMetadataRequest* request);
     static Status serializeResponse2Json(const tensorflow::serving::GetModelMetadataResponse* response, std::string* output);
 };
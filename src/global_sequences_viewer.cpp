@@ -25,6 +25,7 @@
 #include "modelversion.hpp"
 #include "statefulmodelinstance.hpp"
 #include "status.hpp"
+#include "workerpool.hpp"
 
 namespace ovms {
 
@@ -63,6 +64,11 @@ Status GlobalSequencesViewer::removeIdleSequences() {
     std::unique_lock<std::mutex> viewerLock(viewerMutex);
     for (auto it = registeredSequenceManagers.begin(); it != registeredSequenceManagers.end();) {
         auto sequenceManager = it->second;
+        // Sequences of models with idle sequence timeout expire on their own
+        if (sequenceManager->getIdleSequenceTimeoutSeconds() > 0) {
+            it++;
+            continue;
+        }
         auto status = sequenceManager->removeIdleSequences();
         it++;
         if (status.getCode() != ovms::StatusCode::OK)
@@ -72,10 +78,32 @@ Status GlobalSequencesViewer::removeIdleSequences() {
     return ovms::StatusCode::OK;
 }
 
-void GlobalSequencesViewer::sequenceCleanerRoutine(uint32_t sequenceCleanerIntervalMinutes, std::future<void> exitSignal) {
-    SPDLOG_LOGGER_INFO(modelmanager_logger, "Started sequence cleaner thread");
+Status GlobalSequencesViewer::removeExpiredSequences() {
+    std::unique_lock<std::mutex> viewerLock(viewerMutex);
+    for (auto& [registrationId, sequenceManager] : registeredSequenceManagers) {
+        auto status = sequenceManager->removeExpiredSequences();
+        if (!status.ok())
+            return status;
+        status = sequenceManager->compressIdleSequences();
+        if (!status.ok())
+            return status;
+    }
 
-    while (exitSignal.wait_for(std::chrono::minutes(sequenceCleanerIntervalMinutes)) == std::future_status::timeout) {
+    return ovms::StatusCode::OK;
+}
+
+void GlobalSequencesViewer::sequenceCleanerRoutine(uint32_t sequenceCleanerIntervalMinutes, std::vector<int> cpuAffinity, std::future<void> exitSignal) {
+    SPDLOG_LOGGER_INFO(modelmanager_logger, "Started sequence cleaner thread");
+    WorkerPool::pinCurrentThread(cpuAffinity);
+
+    // Expiry and compression wheels advance every second, models without idle sequence timeout are scanned every interval
+    const uint64_t scanIntervalSeconds = uint64_t(sequenceCleanerIntervalMinutes) * 60;
+    uint64_t secondsSinceScan = 0;
+    while (exitSignal.wait_for(std::chrono::seconds(1)) == std::future_status::timeout) {
+        removeExpiredSequences();
+        if (++secondsSinceScan < scanIntervalSeconds)
+            continue;
+        secondsSinceScan = 0;
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Sequence cleaner scan begin");
 
         removeIdleSequences();
@@ -96,10 +124,10 @@ void GlobalSequencesViewer::join() {
     }
 }
 
-void GlobalSequencesViewer::startCleanerThread(uint32_t sequenceCleanerIntervalMinutes) {
+void GlobalSequencesViewer::startCleanerThread(uint32_t sequenceCleanerIntervalMinutes, std::vector<int> cpuAffinity) {
     if ((!sequenceCleanerStarted) && (sequenceCleanerIntervalMinutes > 0)) {
         std::future<void> exitSignal = exitTrigger.get_future();
-        std::thread t(std::thread(&GlobalSequencesViewer::sequenceCleanerRoutine, this, sequenceCleanerIntervalMinutes, std::move(exitSignal)));
+        std::thread t(std::thread(&GlobalSequencesViewer::sequenceCleanerRoutine, this, sequenceCleanerIntervalMinutes, std::move(cpuAffinity), std::move(exitSignal)));
         sequenceCleanerStarted = true;
         sequenceCleanerThread = std::move(t);
     }
@@ -23,6 +23,7 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "sequence_manager.hpp"
 #include "status.hpp"
@@ -39,15 +40,18 @@ private:
 
     std::map<std::string, std::shared_ptr<SequenceManager>> registeredSequenceManagers;
 
-    void sequenceCleanerRoutine(uint32_t sequenceCleanerIntervalMinutes, std::future<void> exitSignal);
+    void sequenceCleanerRoutine(uint32_t sequenceCleanerIntervalMinutes, std::vector<int> cpuAffinity, std::future<void> exitSignal);
 
     std::thread sequenceCleanerThread;
 
 protected:
     Status removeIdleSequences();
 
+    // Removes expired sequences of models with idle sequence timeout and compresses states of idle sequences
+    Status removeExpiredSequences();
+
 public:
-    void startCleanerThread(uint32_t sequenceCleanerIntervalMinutes = DEFAULT_SEQUENCE_CLEANER_INTERVAL);
+    void startCleanerThread(uint32_t sequenceCleanerIntervalMinutes = DEFAULT_SEQUENCE_CLEANER_INTERVAL, std::vector<int> cpuAffinity = {});
 
     // Gracefully finish sequence cleaner thread
     void join();
@@ -0,0 +1,174 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "http_compression.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+namespace ovms {
+
+static const int GZIP_WINDOW_BITS = 15 + 16;
+static const int ZLIB_WINDOW_BITS = 15;
+static const int AUTO_DETECT_WINDOW_BITS = 15 + 32;
+static const size_t CHUNK_SIZE = 64 * 1024;
+
+static std::string_view trim(std::string_view value) {
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+static bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+    return lhs.size() == rhs.size() &&
+           std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+               return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+           });
+}
+
+const char* getContentEncodingName(ContentEncoding encoding) {
+    switch (encoding) {
+    case ContentEncoding::GZIP:
+        return "gzip";
+    case ContentEncoding::DEFLATE:
+        return "deflate";
+    default:
+        return "identity";
+    }
+}
+
+ContentEncoding parseContentEncoding(std::string_view header) {
+    header = trim(header);
+    if (header.empty() || equalsIgnoreCase(header, "identity")) {
+        return ContentEncoding::IDENTITY;
+    }
+    if (equalsIgnoreCase(header, "gzip") || equalsIgnoreCase(header, "x-gzip")) {
+        return ContentEncoding::GZIP;
+    }
+    if (equalsIgnoreCase(header, "deflate")) {
+        return ContentEncoding::DEFLATE;
+    }
+    return ContentEncoding::UNSUPPORTED;
+}
+
+ContentEncoding negotiateContentEncoding(std::string_view acceptEncoding) {
+    bool gzipAccepted = false;
+    bool deflateAccepted = false;
+    while (!acceptEncoding.empty()) {
+        auto end = acceptEncoding.find(',');
+        auto entry = acceptEncoding.substr(0, end);
+        acceptEncoding.remove_prefix(end == std::string_view::npos ? acceptEncoding.size() : end + 1);
+
+        auto parametersStart = entry.find(';');
+        auto coding = trim(entry.substr(0, parametersStart));
+        bool accepted = true;
+        if (parametersStart != std::string_view::npos) {
+            auto parameter = trim(entry.substr(parametersStart + 1));
+            if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                accepted = std::strtod(std::string(parameter.substr(2)).c_str(), nullptr) > 0;
+            }
+        }
+        if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip") || coding == "*") {
+            gzipAccepted = gzipAccepted || accepted;
+        } else if (equalsIgnoreCase(coding, "deflate")) {
+            deflateAccepted = deflateAccepted || accepted;
+        }
+    }
+    if (gzipAccepted) {
+        return ContentEncoding::GZIP;
+    }
+    if (deflateAccepted) {
+        return ContentEncoding::DEFLATE;
+    }
+    return ContentEncoding::IDENTITY;
+}
+
+Status decompress(ContentEncoding encoding, const std::string& input, std::string& output, size_t maxSize) {
+    if (encoding != ContentEncoding::GZIP && encoding != ContentEncoding::DEFLATE) {
+        return StatusCode::REST_UNSUPPORTED_CONTENT_ENCODING;
+    }
+    z_stream stream{};
+    if (inflateInit2(&stream, AUTO_DETECT_WINDOW_BITS) != Z_OK) {
+        SPDLOG_ERROR("Failed to initialize zlib inflate stream");
+        return StatusCode::INTERNAL_ERROR;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.size();
+
+    output.clear();
+    int result = Z_OK;
+    while (result != Z_STREAM_END) {
+        const size_t offset = output.size();
+        output.resize(offset + CHUNK_SIZE);
+        stream.next_out = reinterpret_cast<Bytef*>(&output[offset]);
+        stream.avail_out = CHUNK_SIZE;
+        result = inflate(&stream, Z_NO_FLUSH);
+        output.resize(offset + CHUNK_SIZE - stream.avail_out);
+        if (result != Z_OK && result != Z_STREAM_END) {
+            SPDLOG_DEBUG("Failed to decompress {} request body: {}", getContentEncodingName(encoding), stream.msg ? stream.msg : "truncated data");
+            inflateEnd(&stream);
+            return StatusCode::REST_DECOMPRESSION_FAILED;
+        }
+        if (maxSize != 0 && output.size() > maxSize) {
+            SPDLOG_DEBUG("Decompressed request body exceeds limit of {} bytes", maxSize);
+            inflateEnd(&stream);
+            return StatusCode::REST_REQUEST_BODY_TOO_LARGE;
+        }
+        if (result == Z_OK && stream.avail_in == 0 && stream.avail_out != 0) {
+            SPDLOG_DEBUG("Failed to decompress {} request body: truncated data", getContentEncodingName(encoding));
+            inflateEnd(&stream);
+            return StatusCode::REST_DECOMPRESSION_FAILED;
+        }
+    }
+    inflateEnd(&stream);
+    return StatusCode::OK;
+}
+
+Status compress(ContentEncoding encoding, int level, const std::string& input, std::string& output) {
+    if (encoding != ContentEncoding::GZIP && encoding != ContentEncoding::DEFLATE) {
+        return StatusCode::REST_UNSUPPORTED_CONTENT_ENCODING;
+    }
+    z_stream stream{};
+    const int windowBits = encoding == ContentEncoding::GZIP ? GZIP_WINDOW_BITS : ZLIB_WINDOW_BITS;
+    if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        SPDLOG_ERROR("Failed to initialize zlib deflate stream with level {}", level);
+        return StatusCode::INTERNAL_ERROR;
+    }
+    // gzip header and trailer are not included in deflateBound
+    output.resize(deflateBound(&stream, input.size()) + 18);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = output.size();
+    const int result = deflate(&stream, Z_FINISH);
+    const size_t compressedSize = stream.total_out;
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        SPDLOG_ERROR("Failed to compress response with {}", getContentEncodingName(encoding));
+        return StatusCode::INTERNAL_ERROR;
+    }
+    output.resize(compressedSize);
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
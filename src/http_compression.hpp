@@ -0,0 +1,82 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "status.hpp"
+
+namespace ovms {
+
+enum class ContentEncoding {
+    IDENTITY,
+    GZIP,
+    DEFLATE,
+    UNSUPPORTED
+};
+
+/**
+ * @brief Gets value of Content-Encoding header for given encoding
+ */
+const char* getContentEncodingName(ContentEncoding encoding);
+
+/**
+ * @brief Parses Content-Encoding header of request, empty header means identity
+ */
+ContentEncoding parseContentEncoding(std::string_view header);
+
+/**
+ * @brief Selects response encoding from Accept-Encoding header
+ *
+ * gzip is preferred over deflate, encodings with q=0 are not accepted.
+ *
+ * @return IDENTITY if no supported compression is accepted
+ */
+ContentEncoding negotiateContentEncoding(std::string_view acceptEncoding);
+
+/**
+ * @brief Checks whether data starts with gzip magic bytes
+ */
+inline bool isGzipData(const std::string& data) {
+    return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f && static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+/**
+ * @brief Uncompresses gzip or zlib (deflate) data
+ *
+ * @param encoding
+ * @param input
+ * @param output
+ * @param maxSize maximum size of uncompressed data, 0 means no limit
+ *
+ * @return Status
+ */
+Status decompress(ContentEncoding encoding, const std::string& input, std::string& output, size_t maxSize = 0);
+
+/**
+ * @brief Compresses data to gzip or zlib (deflate) format
+ *
+ * @param encoding
+ * @param level zlib compression level from 1 to 9
+ * @param input
+ * @param output
+ *
+ * @return Status
+ */
+Status compress(ContentEncoding encoding, int level, const std::string& input, std::string& output);
+
+}  // namespace ovms
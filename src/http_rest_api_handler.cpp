@@ -15,6 +15,7 @@
 //*****************************************************************************
 #include "http_rest_api_handler.hpp"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -23,30 +24,67 @@
 #include <utility>
 #include <vector>
 
+#include <google/protobuf/util/json_util.h>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #include <spdlog/spdlog.h>
 
 #include "config.hpp"
+#include "critical_path.hpp"
 #include "filesystem.hpp"
 #include "get_model_metadata_impl.hpp"
+#include "kfs_batch_request.hpp"
+#include "kfs_rest_parser.hpp"
+#include "metrics.hpp"
 #include "model_service.hpp"
 #include "modelinstanceunloadguard.hpp"
+#include "peer_files.hpp"
 #include "pipelinedefinition.hpp"
+#include "prediction_service.hpp"
 #include "prediction_service_utils.hpp"
+#include "remote_files_cache.hpp"
 #include "rest_parser.hpp"
+#include "rest_request_buffers.hpp"
+#include "residency.hpp"
 #include "rest_utils.hpp"
+#include "shape_histogram.hpp"
+#include "shared_memory.hpp"
+#include "slow_requests.hpp"
+#include "statefulmodelinstance.hpp"
 #include "timer.hpp"
+#include "tracing.hpp"
+#include "usdt.hpp"
 
 using tensorflow::serving::PredictRequest;
 using tensorflow::serving::PredictResponse;
 
 namespace ovms {
 
+enum : size_t {
+    TOTAL,
+    PARSE,
+    TIMER_END
+};
+
 const std::string HttpRestApiHandler::predictionRegexExp =
     R"((.?)\/v1\/models\/([^\/:]+)(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?:(classify|regress|predict))";
 const std::string HttpRestApiHandler::modelstatusRegexExp =
-    R"((.?)\/v1\/models(?:\/([^\/:]+))?(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?(?:\/(metadata))?)";
+    R"((.?)\/v1\/models(?:\/([^\/:]+))?(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?(?:\/(metadata|memory|profile|saturation|shapes|critical_path))?)";
 const std::string HttpRestApiHandler::configReloadRegexExp = R"((.?)\/v1\/config\/reload)";
 const std::string HttpRestApiHandler::configStatusRegexExp = R"((.?)\/v1\/config)";
+const std::string HttpRestApiHandler::slowRequestsRegexExp = R"((.?)\/v1\/slow_requests)";
+const std::string HttpRestApiHandler::residencyRegexExp = R"((.?)\/v1\/residency)";
+const std::string HttpRestApiHandler::peerFileRegexExp = R"((.?)\/v1\/peer\/files\/([0-9A-Za-z-]+)\/bytes\/(\d+)-(\d+))";
+const std::string HttpRestApiHandler::healthRegexExp = R"((.?)\/v2\/health\/(live|ready))";
+const std::string HttpRestApiHandler::sharedMemoryRegexExp = R"((.?)\/v1\/shm\/regions\/([^\/:]+):(register|unregister))";
+const std::string HttpRestApiHandler::kfsInferRegexExp = R"((.?)\/v2\/models\/([^\/]+)(?:\/versions\/(\d+))?\/infer)";
+const std::string HttpRestApiHandler::metricsRegexExp = R"((.?)\/metrics)";
+const std::string HttpRestApiHandler::rawInputPredictionRegexExp =
+    R"((.?)\/v1\/models\/([^\/:]+)(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?\/inputs\/([^\/:]+):predict)";
+const std::string HttpRestApiHandler::kfsInferBatchRegexExp = R"((.?)\/v2\/infer_batch)";
+const std::string HttpRestApiHandler::sequenceStateRegexExp =
+    R"((.?)\/v1\/models\/([^\/:]+)(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?\/sequences\/(\d+):(export|import))";
 
 Status HttpRestApiHandler::parseModelVersion(std::string& model_version_str, std::optional<int64_t>& model_version) {
     if (!model_version_str.empty()) {
@@ -63,12 +101,13 @@ Status HttpRestApiHandler::parseModelVersion(std::string& model_version_str, std
 Status HttpRestApiHandler::dispatchToProcessor(
     const std::string& request_body,
     std::string* response,
-    const HttpRequestComponents& request_components) {
+    const HttpRequestComponents& request_components,
+    std::vector<std::pair<std::string, std::string>>* headers) {
 
     if (request_components.type == Predict) {
         if (request_components.processing_method == "predict") {
             return processPredictRequest(request_components.model_name, request_components.model_version,
-                request_components.model_version_label, request_body, response);
+                request_components.model_version_label, request_body, response, request_components.context, headers);
         } else {
             SPDLOG_WARN("Requested REST resource not found");
             return StatusCode::REST_NOT_FOUND;
@@ -82,6 +121,21 @@ Status HttpRestApiHandler::dispatchToProcessor(
         return processModelStatusRequest(request_components.model_name, request_components.model_version,
             request_components.model_version_label, response);
     }
+    if (request_components.type == GetModelMemory) {
+        return processModelMemoryRequest(request_components.model_name, request_components.model_version, *response);
+    }
+    if (request_components.type == GetModelProfile) {
+        return processModelProfileRequest(request_components.model_name, request_components.model_version, *response);
+    }
+    if (request_components.type == GetModelSaturation) {
+        return processModelSaturationRequest(request_components.model_name, request_components.model_version, *response);
+    }
+    if (request_components.type == GetModelShapes) {
+        return processModelShapesRequest(request_components.model_name, request_components.model_version, *response);
+    }
+    if (request_components.type == GetPipelineCriticalPath) {
+        return processPipelineCriticalPathRequest(request_components.model_name, *response);
+    }
     if (request_components.type == ConfigReload) {
         auto& manager = ModelManager::getInstance();
         return processConfigReloadRequest(*response, manager);
@@ -90,13 +144,329 @@ Status HttpRestApiHandler::dispatchToProcessor(
         auto& manager = ModelManager::getInstance();
         return processConfigStatusRequest(*response, manager);
     }
+    if (request_components.type == SharedMemory) {
+        return processSharedMemoryRequest(request_components.shared_memory_region, request_components.processing_method, request_body, *response);
+    }
+    if (request_components.type == KFSInfer) {
+        return processKFSInferRequest(request_components.model_name, request_components.model_version, request_body, headers, response, request_components.context);
+    }
+    if (request_components.type == Metrics) {
+        return processMetricsRequest(*response, headers);
+    }
+    if (request_components.type == GetSlowRequests) {
+        *response = SlowRequestsLog::instance().toJson();
+        return StatusCode::OK;
+    }
+    if (request_components.type == GetResidency) {
+        *response = ResidencyAdvertiser::instance().toJson(ModelManager::getInstance());
+        return StatusCode::OK;
+    }
+    if (request_components.type == GetPeerFile) {
+        return processPeerFileRequest(request_components.file_key, request_components.range_first, request_components.range_last, *response, headers);
+    }
+    if (request_components.type == ServerLive) {
+        return StatusCode::OK;
+    }
+    if (request_components.type == ServerReady) {
+        return ModelManager::getInstance().isReady() ? StatusCode::OK : StatusCode::SERVER_NOT_READY;
+    }
+    if (request_components.type == RawInputPredict) {
+        return processRawInputPredictRequest(request_components.model_name, request_components.model_version,
+            request_components.input_name, request_components.content_type, request_body, response, request_components.context);
+    }
+    if (request_components.type == KFSInferBatch) {
+        return processKFSInferBatchRequest(request_body, response, request_components.context);
+    }
+    if (request_components.type == SequenceState) {
+        return processSequenceStateRequest(request_components.model_name, request_components.model_version,
+            request_components.sequence_id, request_components.processing_method, request_body, *response, headers);
+    }
     return StatusCode::UNKNOWN_REQUEST_COMPONENTS_TYPE;
 }
 
+namespace {
+
+enum class Route {
+    NONE,
+    PREDICT,
+    MODEL_STATUS,
+    CONFIG_RELOAD,
+    CONFIG_STATUS,
+    SHARED_MEMORY,
+    KFS_INFER,
+    METRICS,
+    RAW_INPUT_PREDICT,
+    KFS_INFER_BATCH,
+    SEQUENCE_STATE,
+    SLOW_REQUESTS,
+    RESIDENCY,
+    PEER_FILE,
+    SERVER_LIVE,
+    SERVER_READY
+};
+
+/**
+ * @brief Path components extracted by matchRoute, views into request path
+ */
+struct RouteMatch {
+    Route route = Route::NONE;
+    std::string_view modelName;
+    std::string_view modelVersion;
+    std::string_view modelVersionLabel;
+    std::string_view method;
+    std::string_view subresource;
+    std::string_view region;
+    std::string_view inputName;
+    std::string_view sequenceId;
+    std::string_view fileKey;
+    std::string_view rangeFirst;
+    std::string_view rangeLast;
+};
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isWordChar(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isNameChar(char c) {
+    return c != '/' && c != ':';
+}
+
+template <typename Predicate>
+std::string_view consumeWhile(std::string_view& path, Predicate predicate) {
+    size_t length = 0;
+    while (length < path.size() && predicate(path[length])) {
+        length++;
+    }
+    auto consumed = path.substr(0, length);
+    path.remove_prefix(length);
+    return consumed;
+}
+
+bool consumePrefix(std::string_view& path, std::string_view prefix) {
+    if (path.substr(0, prefix.size()) != prefix) {
+        return false;
+    }
+    path.remove_prefix(prefix.size());
+    return true;
+}
+
+// API version may be preceded by single character other than line break, as (.?) in route regular expressions
+bool consumeApiVersion(std::string_view& path, std::string_view version) {
+    if (consumePrefix(path, version)) {
+        return true;
+    }
+    if (path.empty() || path[0] == '\n' || path[0] == '\r') {
+        return false;
+    }
+    auto rest = path.substr(1);
+    if (!consumePrefix(rest, version)) {
+        return false;
+    }
+    path = rest;
+    return true;
+}
+
+// Optional /versions/<number> or /labels/<label>
+bool matchVersionOrLabel(std::string_view& path, RouteMatch& match) {
+    if (consumePrefix(path, "/versions/")) {
+        match.modelVersion = consumeWhile(path, isDigit);
+        return !match.modelVersion.empty();
+    }
+    if (consumePrefix(path, "/labels/")) {
+        match.modelVersionLabel = consumeWhile(path, isWordChar);
+        return !match.modelVersionLabel.empty();
+    }
+    return true;
+}
+
+// /<name>[/versions/<number>|/labels/<label>][/inputs/<input>|/sequences/<id>]:<method>
+bool matchPredict(std::string_view path, RouteMatch& match) {
+    RouteMatch result;
+    if (!consumePrefix(path, "/")) {
+        return false;
+    }
+    result.modelName = consumeWhile(path, isNameChar);
+    if (result.modelName.empty() || !matchVersionOrLabel(path, result)) {
+        return false;
+    }
+    if (consumePrefix(path, "/inputs/")) {
+        result.inputName = consumeWhile(path, isNameChar);
+        if (result.inputName.empty() || !consumePrefix(path, ":") || path != "predict") {
+            return false;
+        }
+        result.method = path;
+        result.route = Route::RAW_INPUT_PREDICT;
+        match = result;
+        return true;
+    }
+    if (consumePrefix(path, "/sequences/")) {
+        result.sequenceId = consumeWhile(path, isDigit);
+        if (result.sequenceId.empty() || !consumePrefix(path, ":") || (path != "export" && path != "import")) {
+            return false;
+        }
+        result.method = path;
+        result.route = Route::SEQUENCE_STATE;
+        match = result;
+        return true;
+    }
+    if (!consumePrefix(path, ":")) {
+        return false;
+    }
+    if (path != "classify" && path != "regress" && path != "predict") {
+        return false;
+    }
+    result.method = path;
+    result.route = Route::PREDICT;
+    match = result;
+    return true;
+}
+
+// [/versions/<number>|/labels/<label>][/metadata|/memory|/profile|/saturation|/shapes|/critical_path]
+bool matchModelStatusTail(std::string_view path, RouteMatch& match) {
+    if (!matchVersionOrLabel(path, match)) {
+        return false;
+    }
+    if (consumePrefix(path, "/metadata")) {
+        match.subresource = "metadata";
+    } else if (consumePrefix(path, "/memory")) {
+        match.subresource = "memory";
+    } else if (consumePrefix(path, "/profile")) {
+        match.subresource = "profile";
+    } else if (consumePrefix(path, "/saturation")) {
+        match.subresource = "saturation";
+    } else if (consumePrefix(path, "/shapes")) {
+        match.subresource = "shapes";
+    } else if (consumePrefix(path, "/critical_path")) {
+        match.subresource = "critical_path";
+    }
+    return path.empty();
+}
+
+// [/<name>][/versions/<number>|/labels/<label>][/metadata|/memory|/profile|/saturation|/shapes|/critical_path]
+// Name is optional, so /versions/1 is either model named "versions" or version 1 of no model, the former is tried first
+bool matchModelStatus(std::string_view path, RouteMatch& match) {
+    RouteMatch result;
+    auto rest = path;
+    if (consumePrefix(rest, "/")) {
+        result.modelName = consumeWhile(rest, isNameChar);
+        if (!result.modelName.empty() && matchModelStatusTail(rest, result)) {
+            result.route = Route::MODEL_STATUS;
+            match = result;
+            return true;
+        }
+    }
+    result = RouteMatch();
+    if (!matchModelStatusTail(path, result)) {
+        return false;
+    }
+    result.route = Route::MODEL_STATUS;
+    match = result;
+    return true;
+}
+
+// <region>:<register|unregister>
+bool matchSharedMemory(std::string_view path, RouteMatch& match) {
+    auto region = consumeWhile(path, isNameChar);
+    if (region.empty() || !consumePrefix(path, ":") || (path != "register" && path != "unregister")) {
+        return false;
+    }
+    match.region = region;
+    match.method = path;
+    match.route = Route::SHARED_MEMORY;
+    return true;
+}
+
+// <name>[/versions/<number>]/infer
+bool matchKFSInfer(std::string_view path, RouteMatch& match) {
+    auto modelName = consumeWhile(path, [](char c) { return c != '/'; });
+    if (modelName.empty()) {
+        return false;
+    }
+    std::string_view modelVersion;
+    if (consumePrefix(path, "/versions/")) {
+        modelVersion = consumeWhile(path, isDigit);
+        if (modelVersion.empty()) {
+            return false;
+        }
+    }
+    if (path != "/infer") {
+        return false;
+    }
+    match.modelName = modelName;
+    match.modelVersion = modelVersion;
+    match.route = Route::KFS_INFER;
+    return true;
+}
+
+// <key>/bytes/<first>-<last>
+bool matchPeerFile(std::string_view path, RouteMatch& match) {
+    auto fileKey = consumeWhile(path, [](char c) { return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-'; });
+    if (fileKey.empty() || !consumePrefix(path, "/bytes/")) {
+        return false;
+    }
+    auto rangeFirst = consumeWhile(path, isDigit);
+    if (rangeFirst.empty() || !consumePrefix(path, "-")) {
+        return false;
+    }
+    auto rangeLast = consumeWhile(path, isDigit);
+    if (rangeLast.empty() || !path.empty()) {
+        return false;
+    }
+    match.fileKey = fileKey;
+    match.rangeFirst = rangeFirst;
+    match.rangeLast = rangeLast;
+    match.route = Route::PEER_FILE;
+    return true;
+}
+
+/**
+ * @brief Matches request path against REST API routes in single pass, accepting the same paths as HttpRestApiHandler::*RegexExp
+ */
+RouteMatch matchRoute(std::string_view path) {
+    RouteMatch match;
+    if (consumeApiVersion(path, "/v1")) {
+        if (path == "/config/reload") {
+            match.route = Route::CONFIG_RELOAD;
+        } else if (path == "/config") {
+            match.route = Route::CONFIG_STATUS;
+        } else if (path == "/slow_requests") {
+            match.route = Route::SLOW_REQUESTS;
+        } else if (path == "/residency") {
+            match.route = Route::RESIDENCY;
+        } else if (consumePrefix(path, "/peer/files/")) {
+            matchPeerFile(path, match);
+        } else if (consumePrefix(path, "/shm/regions/")) {
+            matchSharedMemory(path, match);
+        } else if (consumePrefix(path, "/models")) {
+            if (!matchPredict(path, match)) {
+                matchModelStatus(path, match);
+            }
+        }
+    } else if (consumeApiVersion(path, "/v2")) {
+        if (path == "/infer_batch") {
+            match.route = Route::KFS_INFER_BATCH;
+        } else if (path == "/health/live") {
+            match.route = Route::SERVER_LIVE;
+        } else if (path == "/health/ready") {
+            match.route = Route::SERVER_READY;
+        } else if (consumePrefix(path, "/models/")) {
+            matchKFSInfer(path, match);
+        }
+    } else if (consumeApiVersion(path, "/metrics") && path.empty()) {
+        match.route = Route::METRICS;
+    }
+    return match;
+}
+
+}  // namespace
+
 Status HttpRestApiHandler::parseRequestComponents(HttpRequestComponents& requestComponents,
     const std::string_view http_method,
     const std::string& request_path) {
-    std::smatch sm;
     requestComponents.http_method = http_method;
 
     if (http_method != "POST" && http_method != "GET") {
@@ -108,58 +478,154 @@ Status HttpRestApiHandler::parseRequestComponents(HttpRequestComponents& request
         return StatusCode::PATH_INVALID;
     }
 
+    const auto match = matchRoute(request_path);
     if (http_method == "POST") {
-        if (std::regex_match(request_path, sm, predictionRegex)) {
+        switch (match.route) {
+        case Route::PREDICT: {
             requestComponents.type = Predict;
-            requestComponents.model_name = sm[2];
+            requestComponents.model_name = std::string(match.modelName);
 
-            std::string model_version_str = sm[3];
+            std::string model_version_str(match.modelVersion);
             auto status = parseModelVersion(model_version_str, requestComponents.model_version);
             if (!status.ok())
                 return status;
 
-            std::string model_version_label_str = sm[4];
-            if (!model_version_label_str.empty()) {
-                requestComponents.model_version_label = model_version_label_str;
+            if (!match.modelVersionLabel.empty()) {
+                requestComponents.model_version_label = match.modelVersionLabel;
             }
 
-            requestComponents.processing_method = sm[5];
+            requestComponents.processing_method = std::string(match.method);
+            return StatusCode::OK;
+        }
+        case Route::RAW_INPUT_PREDICT: {
+            requestComponents.type = RawInputPredict;
+            requestComponents.model_name = std::string(match.modelName);
+            requestComponents.input_name = std::string(match.inputName);
+            std::string model_version_str(match.modelVersion);
+            auto status = parseModelVersion(model_version_str, requestComponents.model_version);
+            if (!status.ok())
+                return status;
+            if (!match.modelVersionLabel.empty()) {
+                requestComponents.model_version_label = match.modelVersionLabel;
+            }
+            requestComponents.processing_method = std::string(match.method);
             return StatusCode::OK;
         }
-        if (std::regex_match(request_path, sm, configReloadRegex)) {
+        case Route::CONFIG_RELOAD:
             requestComponents.type = ConfigReload;
             return StatusCode::OK;
+        case Route::SHARED_MEMORY:
+            requestComponents.type = SharedMemory;
+            requestComponents.shared_memory_region = std::string(match.region);
+            requestComponents.processing_method = std::string(match.method);
+            return StatusCode::OK;
+        case Route::KFS_INFER: {
+            requestComponents.type = KFSInfer;
+            requestComponents.model_name = std::string(match.modelName);
+            std::string model_version_str(match.modelVersion);
+            return parseModelVersion(model_version_str, requestComponents.model_version);
+        }
+        case Route::KFS_INFER_BATCH:
+            requestComponents.type = KFSInferBatch;
+            return StatusCode::OK;
+        case Route::SEQUENCE_STATE: {
+            requestComponents.type = SequenceState;
+            requestComponents.model_name = std::string(match.modelName);
+            std::string model_version_str(match.modelVersion);
+            auto status = parseModelVersion(model_version_str, requestComponents.model_version);
+            if (!status.ok())
+                return status;
+            try {
+                requestComponents.sequence_id = std::stoull(std::string(match.sequenceId));
+            } catch (std::exception& e) {
+                SPDLOG_DEBUG("Couldn't parse sequence id {}", match.sequenceId);
+                return StatusCode::SEQUENCE_ID_BAD_TYPE;
+            }
+            requestComponents.processing_method = std::string(match.method);
+            return StatusCode::OK;
         }
-        if (std::regex_match(request_path, sm, modelstatusRegex))
+        case Route::MODEL_STATUS:
+        case Route::METRICS:
+        case Route::SLOW_REQUESTS:
+        case Route::RESIDENCY:
+        case Route::PEER_FILE:
+        case Route::SERVER_LIVE:
+        case Route::SERVER_READY:
             return StatusCode::REST_UNSUPPORTED_METHOD;
+        default:
+            break;
+        }
     } else if (http_method == "GET") {
-        if (std::regex_match(request_path, sm, modelstatusRegex)) {
-            requestComponents.model_name = sm[2];
+        switch (match.route) {
+        case Route::MODEL_STATUS: {
+            requestComponents.model_name = std::string(match.modelName);
 
-            std::string model_version_str = sm[3];
+            std::string model_version_str(match.modelVersion);
             auto status = parseModelVersion(model_version_str, requestComponents.model_version);
             if (!status.ok())
                 return status;
 
-            std::string model_version_label_str = sm[4];
-            if (!model_version_label_str.empty()) {
-                requestComponents.model_version_label = model_version_label_str;
+            if (!match.modelVersionLabel.empty()) {
+                requestComponents.model_version_label = match.modelVersionLabel;
             }
 
-            requestComponents.model_subresource = sm[5];
+            requestComponents.model_subresource = std::string(match.subresource);
             if (!requestComponents.model_subresource.empty() && requestComponents.model_subresource == "metadata") {
                 requestComponents.type = GetModelMetadata;
+            } else if (requestComponents.model_subresource == "memory") {
+                requestComponents.type = GetModelMemory;
+            } else if (requestComponents.model_subresource == "profile") {
+                requestComponents.type = GetModelProfile;
+            } else if (requestComponents.model_subresource == "saturation") {
+                requestComponents.type = GetModelSaturation;
+            } else if (requestComponents.model_subresource == "shapes") {
+                requestComponents.type = GetModelShapes;
+            } else if (requestComponents.model_subresource == "critical_path") {
+                requestComponents.type = GetPipelineCriticalPath;
             } else {
                 requestComponents.type = GetModelStatus;
             }
             return StatusCode::OK;
         }
-        if (std::regex_match(request_path, sm, configStatusRegex)) {
+        case Route::CONFIG_STATUS:
             requestComponents.type = ConfigStatus;
             return StatusCode::OK;
-        }
-        if (std::regex_match(request_path, sm, predictionRegex))
+        case Route::METRICS:
+            requestComponents.type = Metrics;
+            return StatusCode::OK;
+        case Route::SLOW_REQUESTS:
+            requestComponents.type = GetSlowRequests;
+            return StatusCode::OK;
+        case Route::RESIDENCY:
+            requestComponents.type = GetResidency;
+            return StatusCode::OK;
+        case Route::PEER_FILE:
+            requestComponents.type = GetPeerFile;
+            requestComponents.file_key = std::string(match.fileKey);
+            try {
+                requestComponents.range_first = std::stoull(std::string(match.rangeFirst));
+                requestComponents.range_last = std::stoull(std::string(match.rangeLast));
+            } catch (std::exception& e) {
+                SPDLOG_DEBUG("Couldn't parse byte range {}-{}", match.rangeFirst, match.rangeLast);
+                return StatusCode::PEER_FILE_RANGE_INVALID;
+            }
+            return StatusCode::OK;
+        case Route::SERVER_LIVE:
+            requestComponents.type = ServerLive;
+            return StatusCode::OK;
+        case Route::SERVER_READY:
+            requestComponents.type = ServerReady;
+            return StatusCode::OK;
+        case Route::PREDICT:
+        case Route::SHARED_MEMORY:
+        case Route::KFS_INFER:
+        case Route::RAW_INPUT_PREDICT:
+        case Route::KFS_INFER_BATCH:
+        case Route::SEQUENCE_STATE:
             return StatusCode::REST_UNSUPPORTED_METHOD;
+        default:
+            break;
+        }
     }
     return StatusCode::REST_INVALID_URL;
 }
@@ -169,9 +635,10 @@ Status HttpRestApiHandler::processRequest(
     const std::string_view request_path,
     const std::string& request_body,
     std::vector<std::pair<std::string, std::string>>* headers,
-    std::string* response) {
+    std::string* response,
+    const RequestContext& context,
+    const std::string& content_type) {
 
-    std::smatch sm;
     std::string request_path_str(request_path);
     if (FileSystem::isPathEscaped(request_path_str)) {
         SPDLOG_ERROR("Path {} escape with .. is forbidden.", request_path);
@@ -186,7 +653,18 @@ Status HttpRestApiHandler::processRequest(
     auto status = parseRequestComponents(requestComponents, http_method, request_path_str);
     if (!status.ok())
         return status;
-    return dispatchToProcessor(request_body, response, requestComponents);
+    requestComponents.context = context;
+    requestComponents.content_type = content_type;
+    return dispatchToProcessor(request_body, response, requestComponents, headers);
+}
+
+// model spec is set in response only when request was served by fallback model
+static void addFallbackHeaders(const tensorflow::serving::PredictResponse& responseProto, std::vector<std::pair<std::string, std::string>>* headers) {
+    if (headers == nullptr || !responseProto.has_model_spec()) {
+        return;
+    }
+    headers->push_back({FALLBACK_MODEL_HEADER, responseProto.model_spec().name()});
+    headers->push_back({FALLBACK_MODEL_VERSION_HEADER, std::to_string(responseProto.model_spec().version().value())});
 }
 
 Status HttpRestApiHandler::processPredictRequest(
@@ -194,11 +672,13 @@ Status HttpRestApiHandler::processPredictRequest(
     const std::optional<int64_t>& modelVersion,
     const std::optional<std::string_view>& modelVersionLabel,
     const std::string& request,
-    std::string* response) {
+    std::string* response,
+    const RequestContext& context,
+    std::vector<std::pair<std::string, std::string>>* headers) {
     // model_version_label currently is not in use
 
-    Timer timer;
-    timer.start("total");
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
     using std::chrono::microseconds;
 
     SPDLOG_DEBUG("Processing REST request for model: {}; version: {}",
@@ -206,15 +686,17 @@ Status HttpRestApiHandler::processPredictRequest(
 
     ModelManager& modelManager = ModelManager::getInstance();
     Order requestOrder;
-    tensorflow::serving::PredictResponse responseProto;
+    // response of previous request on this thread, prepared for reuse once request is parsed
+    tensorflow::serving::PredictResponse& responseProto = RestRequestBuffers::current().response;
     Status status;
+    OVMS_TRACEPOINT(request_received, modelName.c_str(), modelVersion.value_or(0), tracepointRequestId(&responseProto));
 
     if (modelManager.modelExists(modelName)) {
         SPDLOG_DEBUG("Found model with name: {}. Searching for requested version...", modelName);
-        status = processSingleModelRequest(modelName, modelVersion, request, requestOrder, responseProto);
+        status = processSingleModelRequest(modelName, modelVersion, request, requestOrder, responseProto, context);
     } else if (modelManager.pipelineDefinitionExists(modelName)) {
         SPDLOG_DEBUG("Found pipeline with name: {}", modelName);
-        status = processPipelineRequest(modelName, request, requestOrder, responseProto);
+        status = processPipelineRequest(modelName, request, requestOrder, responseProto, context);
     } else {
         SPDLOG_WARN("Model or pipeline matching request parameters not found - name: {}, version: {}", modelName, modelVersion.value_or(0));
         status = StatusCode::MODEL_NAME_MISSING;
@@ -222,12 +704,160 @@ Status HttpRestApiHandler::processPredictRequest(
     if (!status.ok())
         return status;
 
+    removeUnwrittenOutputs(responseProto);
     status = makeJsonFromPredictResponse(responseProto, response, requestOrder);
     if (!status.ok())
         return status;
+    addFallbackHeaders(responseProto, headers);
+
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total REST request processing time: {} ms", timer.elapsed<std::chrono::microseconds>(TOTAL) / 1000);
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processKFSInferRequest(
+    const std::string& modelName,
+    const std::optional<int64_t>& modelVersion,
+    const std::string& request,
+    std::vector<std::pair<std::string, std::string>>* headers,
+    std::string* response,
+    const RequestContext& context) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
+    SPDLOG_DEBUG("Processing KServe REST request for model: {}; version: {}", modelName, modelVersion.value_or(0));
+
+    timer.start(PARSE);
+    Span parseSpan(context.trace, "parse");
+    KFSRestParser requestParser;
+    auto status = requestParser.parse(request);
+    parseSpan.setStatus(status);
+    parseSpan.end();
+    if (!status.ok()) {
+        return status;
+    }
+    timer.stop(PARSE);
+    SPDLOG_DEBUG("KServe request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>(PARSE) / 1000);
+
+    tensorflow::serving::PredictRequest& requestProto = requestParser.getProto();
+    requestProto.mutable_model_spec()->set_name(modelName);
+    if (modelVersion.has_value()) {
+        requestProto.mutable_model_spec()->mutable_version()->set_value(modelVersion.value());
+    }
+    tensorflow::serving::PredictResponse responseProto;
+    status = PredictionServiceImpl::infer(&requestProto, &responseProto, context);
+    if (!status.ok()) {
+        return status;
+    }
+
+    size_t headerLength = 0;
+    if (responseProto.has_model_spec()) {
+        status = makeKFSRestResponse(requestParser, responseProto, responseProto.model_spec().name(),
+            std::to_string(responseProto.model_spec().version().value()), *response, headerLength);
+    } else {
+        status = makeKFSRestResponse(requestParser, responseProto, modelName,
+            modelVersion.has_value() ? std::to_string(modelVersion.value()) : "", *response, headerLength);
+    }
+    if (!status.ok()) {
+        return status;
+    }
+    addFallbackHeaders(responseProto, headers);
+    if (headerLength > 0) {
+        for (auto& header : *headers) {
+            if (header.first == "Content-Type") {
+                header.second = "application/octet-stream";
+            }
+        }
+        headers->push_back({KFS_INFERENCE_HEADER_CONTENT_LENGTH, std::to_string(headerLength)});
+    }
+
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total KServe REST request processing time: {} ms", timer.elapsed<std::chrono::microseconds>(TOTAL) / 1000);
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processKFSInferBatchRequest(
+    const std::string& request,
+    std::string* response,
+    const RequestContext& context) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
+
+    timer.start(PARSE);
+    inference::ModelInferBatchRequest requestProto;
+    auto parseStatus = google::protobuf::util::JsonStringToMessage(request, &requestProto);
+    if (!parseStatus.ok()) {
+        SPDLOG_DEBUG("Failed to parse KServe batch request: {}", parseStatus.ToString());
+        return StatusCode::JSON_INVALID;
+    }
+    timer.stop(PARSE);
+    SPDLOG_DEBUG("Processing KServe REST batch of {} requests, parsing time: {} ms", requestProto.requests_size(), timer.elapsed<std::chrono::microseconds>(PARSE) / 1000);
+
+    inference::ModelInferBatchResponse responseProto;
+    KFSBatchRequest batchRequest(requestProto);
+    auto status = batchRequest.infer(responseProto, context);
+    if (!status.ok()) {
+        return status;
+    }
+    auto serializeStatus = google::protobuf::util::MessageToJsonString(responseProto, response);
+    if (!serializeStatus.ok()) {
+        SPDLOG_ERROR("Failed to convert proto to json. Error: {}", serializeStatus.ToString());
+        return StatusCode::JSON_SERIALIZATION_ERROR;
+    }
+
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total KServe REST batch request processing time: {} ms", timer.elapsed<std::chrono::microseconds>(TOTAL) / 1000);
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processRawInputPredictRequest(
+    const std::string& modelName,
+    const std::optional<int64_t>& modelVersion,
+    const std::string& inputName,
+    const std::string& contentType,
+    const std::string& request,
+    std::string* response,
+    const RequestContext& context) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
+    SPDLOG_DEBUG("Processing REST raw input request for model: {}; version: {}; input: {}", modelName, modelVersion.value_or(0), inputName);
+
+    // images are passed as binary input data, the same way as b64 encoded JSON values
+    tensorflow::serving::PredictRequest requestProto;
+    requestProto.mutable_model_spec()->set_name(modelName);
+    if (modelVersion.has_value()) {
+        requestProto.mutable_model_spec()->mutable_version()->set_value(modelVersion.value());
+    }
+    auto& tensor = (*requestProto.mutable_inputs())[inputName];
+    tensor.set_dtype(tensorflow::DataType::DT_STRING);
+    if (contentType.rfind("image/", 0) == 0) {
+        tensor.add_string_val(request);
+    } else if (contentType.rfind("multipart/", 0) == 0) {
+        std::vector<std::string_view> parts;
+        auto status = parseMultipartBody(contentType, request, parts);
+        if (!status.ok()) {
+            return status;
+        }
+        for (const auto& part : parts) {
+            tensor.add_string_val(part.data(), part.size());
+        }
+    } else {
+        SPDLOG_DEBUG("Unsupported Content-Type: {} of raw input request", contentType);
+        return StatusCode::REST_UNSUPPORTED_CONTENT_TYPE;
+    }
+    tensor.mutable_tensor_shape()->add_dim()->set_size(tensor.string_val_size());
+
+    tensorflow::serving::PredictResponse responseProto;
+    auto status = PredictionServiceImpl::infer(&requestProto, &responseProto, context);
+    if (!status.ok()) {
+        return status;
+    }
+    status = makeJsonFromPredictResponse(responseProto, response, Order::COLUMN);
+    if (!status.ok()) {
+        return status;
+    }
 
-    timer.stop("total");
-    SPDLOG_DEBUG("Total REST request processing time: {} ms", timer.elapsed<std::chrono::microseconds>("total") / 1000);
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total REST raw input request processing time: {} ms", timer.elapsed<std::chrono::microseconds>(TOTAL) / 1000);
     return StatusCode::OK;
 }
 
@@ -235,37 +865,56 @@ Status HttpRestApiHandler::processSingleModelRequest(const std::string& modelNam
     const std::optional<int64_t>& modelVersion,
     const std::string& request,
     Order& requestOrder,
-    tensorflow::serving::PredictResponse& responseProto) {
+    tensorflow::serving::PredictResponse& responseProto,
+    const RequestContext& context) {
 
     std::shared_ptr<ModelInstance> modelInstance;
     std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+    Span lookupSpan(context.trace, "servable lookup");
     auto status = ModelManager::getInstance().getModelInstance(
         modelName,
         modelVersion.value_or(0),
         modelInstance,
         modelInstanceUnloadGuard);
+    lookupSpan.setStatus(status);
+    lookupSpan.end();
+    OVMS_TRACEPOINT(servable_lookup, modelName.c_str(), modelVersion.value_or(0), tracepointRequestId(&responseProto), static_cast<int>(status.getCode()));
 
     if (!status.ok()) {
         SPDLOG_WARN("Requested model instance - name: {}, version: {} - does not exist.", modelName, modelVersion.value_or(0));
         return status;
     }
-    Timer timer;
-    timer.start("parse");
-    RestParser requestParser(modelInstance->getInputsInfo());
+    const bool routedToFallback = ModelManager::getInstance().routeToFallback(modelInstance, modelInstanceUnloadGuard);
+    Timer<TIMER_END> timer;
+    timer.start(PARSE);
+    Span parseSpan(context.trace, "parse");
+    auto& buffers = RestRequestBuffers::current();
+    RestParser requestParser(modelInstance->getInputsInfo(), buffers.request);
     status = requestParser.parse(request.c_str());
+    parseSpan.setStatus(status);
+    parseSpan.end();
     if (!status.ok()) {
+        buffers.request.Swap(&requestParser.getProto());
         return status;
     }
     requestOrder = requestParser.getOrder();
-    timer.stop("parse");
-    SPDLOG_DEBUG("JSON request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>("parse") / 1000);
+    timer.stop(PARSE);
+    SPDLOG_DEBUG("JSON request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>(PARSE) / 1000);
 
     tensorflow::serving::PredictRequest& requestProto = requestParser.getProto();
     requestProto.mutable_model_spec()->set_name(modelName);
     if (modelVersion.has_value()) {
         requestProto.mutable_model_spec()->mutable_version()->set_value(modelVersion.value());
     }
-    status = modelInstance->infer(&requestProto, &responseProto, modelInstanceUnloadGuard);
+    if (&responseProto == &buffers.response) {
+        buffers.prepareResponse(requestProto);
+    }
+    status = modelInstance->infer(&requestProto, &responseProto, modelInstanceUnloadGuard, context);
+    buffers.request.Swap(&requestProto);
+    if (status.ok() && routedToFallback) {
+        responseProto.mutable_model_spec()->set_name(modelInstance->getName());
+        responseProto.mutable_model_spec()->mutable_version()->set_value(modelInstance->getVersion());
+    }
     return status;
 }
 
@@ -287,34 +936,46 @@ Status getPipelineInputs(const std::string& modelName, ovms::tensor_map_t& input
 Status HttpRestApiHandler::processPipelineRequest(const std::string& modelName,
     const std::string& request,
     Order& requestOrder,
-    tensorflow::serving::PredictResponse& responseProto) {
+    tensorflow::serving::PredictResponse& responseProto,
+    const RequestContext& context) {
 
     std::unique_ptr<Pipeline> pipelinePtr;
 
-    Timer timer;
-    timer.start("parse");
+    Timer<TIMER_END> timer;
+    timer.start(PARSE);
+    Span parseSpan(context.trace, "parse");
     ovms::tensor_map_t inputs;
     auto status = getPipelineInputs(modelName, inputs);
     if (!status.ok()) {
         return status;
     }
 
-    RestParser requestParser(inputs);
+    auto& buffers = RestRequestBuffers::current();
+    RestParser requestParser(inputs, buffers.request);
     status = requestParser.parse(request.c_str());
+    parseSpan.setStatus(status);
+    parseSpan.end();
     if (!status.ok()) {
+        buffers.request.Swap(&requestParser.getProto());
         return status;
     }
     requestOrder = requestParser.getOrder();
-    timer.stop("parse");
-    SPDLOG_DEBUG("JSON request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>("parse") / 1000);
+    timer.stop(PARSE);
+    SPDLOG_DEBUG("JSON request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>(PARSE) / 1000);
 
     tensorflow::serving::PredictRequest& requestProto = requestParser.getProto();
     requestProto.mutable_model_spec()->set_name(modelName);
+    if (&responseProto == &buffers.response) {
+        buffers.prepareResponse(requestProto);
+    }
     status = ModelManager::getInstance().getPipeline(pipelinePtr, &requestProto, &responseProto);
-    if (!status.ok()) {
-        return status;
+    OVMS_TRACEPOINT(servable_lookup, modelName.c_str(), int64_t{0}, tracepointRequestId(&responseProto), static_cast<int>(status.getCode()));
+    if (status.ok()) {
+        status = pipelinePtr->execute(context);
     }
-    status = pipelinePtr->execute();
+    // pipeline referencing request proto is destroyed before the proto is recycled
+    pipelinePtr.reset();
+    buffers.request.Swap(&requestProto);
     return status;
 }
 
@@ -325,22 +986,13 @@ Status HttpRestApiHandler::processModelMetadataRequest(
     std::string* response) {
     // model_version_label currently is not in use
     tensorflow::serving::GetModelMetadataRequest grpc_request;
-    tensorflow::serving::GetModelMetadataResponse grpc_response;
     Status status;
     std::string modelName(model_name);
     status = GetModelMetadataImpl::createGrpcRequest(modelName, model_version, &grpc_request);
     if (!status.ok()) {
         return status;
     }
-    status = GetModelMetadataImpl::getModelStatus(&grpc_request, &grpc_response);
-    if (!status.ok()) {
-        return status;
-    }
-    status = GetModelMetadataImpl::serializeResponse2Json(&grpc_response, response);
-    if (!status.ok()) {
-        return status;
-    }
-    return StatusCode::OK;
+    return GetModelMetadataImpl::getModelStatusJson(&grpc_request, response);
 }
 
 Status HttpRestApiHandler::processModelStatusRequest(
@@ -351,22 +1003,13 @@ Status HttpRestApiHandler::processModelStatusRequest(
     // model_version_label currently is not in use
     SPDLOG_DEBUG("Processing model status request");
     tensorflow::serving::GetModelStatusRequest grpc_request;
-    tensorflow::serving::GetModelStatusResponse grpc_response;
     Status status;
     std::string modelName(model_name);
     status = GetModelStatusImpl::createGrpcRequest(modelName, model_version, &grpc_request);
     if (!status.ok()) {
         return status;
     }
-    status = GetModelStatusImpl::getModelStatus(&grpc_request, &grpc_response, ModelManager::getInstance());
-    if (!status.ok()) {
-        return status;
-    }
-    status = GetModelStatusImpl::serializeResponse2Json(&grpc_response, response);
-    if (!status.ok()) {
-        return status;
-    }
-    return StatusCode::OK;
+    return GetModelStatusImpl::getModelStatusJson(&grpc_request, response, ModelManager::getInstance());
 }
 
 std::string createErrorJsonWithMessage(std::string message) {
@@ -377,6 +1020,7 @@ Status HttpRestApiHandler::processConfigReloadRequest(std::string& response, Mod
     SPDLOG_DEBUG("Processing config reload request started.");
     Status status;
     auto& config = ovms::Config::instance();
+    manager.invalidateRemoteListings();
 
     bool reloadNeeded = false;
     if (manager.getConfigFilename() != "") {
@@ -455,4 +1099,461 @@ Status HttpRestApiHandler::processConfigStatusRequest(std::string& response, Mod
     return StatusCode::OK;
 }
 
+Status HttpRestApiHandler::processModelMemoryRequest(const std::string& modelName,
+    const std::optional<int64_t>& modelVersion,
+    std::string& response) {
+    SPDLOG_DEBUG("Processing model memory request for model: {}; version: {}", modelName, modelVersion.value_or(0));
+    auto model = ModelManager::getInstance().findModelByName(modelName);
+    if (model == nullptr) {
+        response = createErrorJsonWithMessage(Status(StatusCode::MODEL_NAME_MISSING).string());
+        return StatusCode::MODEL_NAME_MISSING;
+    }
+    std::vector<std::shared_ptr<ModelInstance>> instances;
+    if (modelVersion.has_value()) {
+        auto instance = model->getModelInstanceByVersion(modelVersion.value());
+        if (!instance) {
+            response = createErrorJsonWithMessage(Status(StatusCode::MODEL_VERSION_MISSING).string());
+            return StatusCode::MODEL_VERSION_MISSING;
+        }
+        instances.push_back(std::move(instance));
+    } else {
+        for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+            auto instance = model->getModelInstanceByVersion(version);
+            if (instance) {
+                instances.push_back(std::move(instance));
+            }
+        }
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("model_version_memory");
+    writer.StartArray();
+    for (auto& instance : instances) {
+        const auto usage = instance->getMemoryUsage();
+        writer.StartObject();
+        writer.Key("version");
+        writer.String(std::to_string(instance->getVersion()).c_str());
+        writer.Key("model_files_bytes");
+        writer.Uint64(usage.modelFiles);
+        writer.Key("infer_requests_bytes");
+        writer.Uint64(usage.inferRequests);
+        writer.Key("sequence_states_bytes");
+        writer.Uint64(usage.sequenceStates);
+        writer.Key("locked_bytes");
+        writer.Uint64(usage.locked);
+        writer.Key("total_bytes");
+        writer.Uint64(usage.total());
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    response = buffer.GetString();
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processModelProfileRequest(const std::string& modelName,
+    const std::optional<int64_t>& modelVersion,
+    std::string& response) {
+    SPDLOG_DEBUG("Processing model profile request for model: {}; version: {}", modelName, modelVersion.value_or(0));
+    auto model = ModelManager::getInstance().findModelByName(modelName);
+    if (model == nullptr) {
+        response = createErrorJsonWithMessage(Status(StatusCode::MODEL_NAME_MISSING).string());
+        return StatusCode::MODEL_NAME_MISSING;
+    }
+    std::vector<std::shared_ptr<ModelInstance>> instances;
+    if (modelVersion.has_value()) {
+        auto instance = model->getModelInstanceByVersion(modelVersion.value());
+        if (!instance) {
+            response = createErrorJsonWithMessage(Status(StatusCode::MODEL_VERSION_MISSING).string());
+            return StatusCode::MODEL_VERSION_MISSING;
+        }
+        instances.push_back(std::move(instance));
+    } else {
+        for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+            auto instance = model->getModelInstanceByVersion(version);
+            if (instance) {
+                instances.push_back(std::move(instance));
+            }
+        }
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("model_version_profile");
+    writer.StartArray();
+    for (auto& instance : instances) {
+        // profiler is kept alive by the copy even if the version is reloaded in the meantime
+        auto profiler = instance->getLayerProfiler();
+        if (!profiler) {
+            continue;
+        }
+        const auto& timings = profiler->getTimings();
+        writer.StartObject();
+        writer.Key("version");
+        writer.String(std::to_string(instance->getVersion()).c_str());
+        writer.Key("profiled_requests");
+        writer.Uint64(timings.getSamples());
+        writer.Key("layers");
+        writer.StartArray();
+        for (const auto& [name, layer] : timings.getLayers()) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(name.c_str());
+            writer.Key("layer_type");
+            writer.String(layer.layerType.c_str());
+            writer.Key("exec_type");
+            writer.String(layer.execType.c_str());
+            writer.Key("executions");
+            writer.Uint64(layer.executions);
+            writer.Key("real_time_us");
+            writer.Uint64(layer.realTimeUs);
+            writer.Key("cpu_time_us");
+            writer.Uint64(layer.cpuTimeUs);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    response = buffer.GetString();
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processModelSaturationRequest(const std::string& modelName,
+    const std::optional<int64_t>& modelVersion,
+    std::string& response) {
+    SPDLOG_DEBUG("Processing model saturation request for model: {}; version: {}", modelName, modelVersion.value_or(0));
+    auto model = ModelManager::getInstance().findModelByName(modelName);
+    if (model == nullptr) {
+        response = createErrorJsonWithMessage(Status(StatusCode::MODEL_NAME_MISSING).string());
+        return StatusCode::MODEL_NAME_MISSING;
+    }
+    std::vector<std::shared_ptr<ModelInstance>> instances;
+    if (modelVersion.has_value()) {
+        auto instance = model->getModelInstanceByVersion(modelVersion.value());
+        if (!instance) {
+            response = createErrorJsonWithMessage(Status(StatusCode::MODEL_VERSION_MISSING).string());
+            return StatusCode::MODEL_VERSION_MISSING;
+        }
+        instances.push_back(std::move(instance));
+    } else {
+        for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+            auto instance = model->getModelInstanceByVersion(version);
+            if (instance) {
+                instances.push_back(std::move(instance));
+            }
+        }
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("model_version_saturation");
+    writer.StartArray();
+    for (auto& instance : instances) {
+        const auto saturation = instance->getSaturation();
+        writer.StartObject();
+        writer.Key("version");
+        writer.String(std::to_string(instance->getVersion()).c_str());
+        writer.Key("busy_fraction");
+        writer.Double(saturation.busyFraction);
+        writer.Key("queue_wait_p95_us");
+        writer.Uint64(saturation.queueWaitP95Us);
+        writer.Key("service_time_us");
+        writer.Double(saturation.serviceTimeUs);
+        writer.Key("throughput");
+        writer.Double(saturation.throughput);
+        writer.Key("capacity");
+        writer.Double(saturation.capacity);
+        writer.Key("headroom");
+        writer.Double(saturation.headroom);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    response = buffer.GetString();
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processModelShapesRequest(const std::string& modelName,
+    const std::optional<int64_t>& modelVersion,
+    std::string& response) {
+    SPDLOG_DEBUG("Processing model shapes request for model: {}; version: {}", modelName, modelVersion.value_or(0));
+    auto model = ModelManager::getInstance().findModelByName(modelName);
+    if (model == nullptr) {
+        response = createErrorJsonWithMessage(Status(StatusCode::MODEL_NAME_MISSING).string());
+        return StatusCode::MODEL_NAME_MISSING;
+    }
+    std::vector<std::shared_ptr<ModelInstance>> instances;
+    if (modelVersion.has_value()) {
+        auto instance = model->getModelInstanceByVersion(modelVersion.value());
+        if (!instance) {
+            response = createErrorJsonWithMessage(Status(StatusCode::MODEL_VERSION_MISSING).string());
+            return StatusCode::MODEL_VERSION_MISSING;
+        }
+        instances.push_back(std::move(instance));
+    } else {
+        for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+            auto instance = model->getModelInstanceByVersion(version);
+            if (instance) {
+                instances.push_back(std::move(instance));
+            }
+        }
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("model_version_shapes");
+    writer.StartArray();
+    for (auto& instance : instances) {
+        const auto* histogram = instance->getShapeHistogram();
+        if (histogram == nullptr) {
+            continue;
+        }
+        writer.StartObject();
+        writer.Key("version");
+        writer.String(std::to_string(instance->getVersion()).c_str());
+        writer.Key("requests");
+        writer.Uint64(histogram->getRequests());
+        writer.Key("shapes");
+        writer.StartArray();
+        std::map<std::string, size_t> ranks;
+        for (const auto& [shapes, requests] : histogram->getMostFrequent()) {
+            writer.StartObject();
+            writer.Key("inputs");
+            writer.StartObject();
+            for (const auto& [name, shape] : shapes) {
+                ranks[name] = std::max(ranks[name], shape.size());
+                writer.Key(name.c_str());
+                writer.StartArray();
+                for (const auto dim : shape) {
+                    writer.Uint64(dim);
+                }
+                writer.EndArray();
+            }
+            writer.EndObject();
+            writer.Key("requests");
+            writer.Uint64(requests);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        // padding is only harmless along sequence dimension, so buckets are proposed for sequence_length_buckets
+        const size_t configuredBuckets = instance->getModelConfig().getSequenceLengthBuckets().size();
+        const size_t maxBuckets = configuredBuckets > 0 ? configuredBuckets : ShapeHistogram::DEFAULT_PADDED_BUCKETS;
+        writer.Key("proposed_padded_buckets");
+        writer.StartArray();
+        for (const auto& [name, rank] : ranks) {
+            if (rank < 2) {
+                continue;
+            }
+            const auto sizes = histogram->getDimensionHistogram(name, 1);
+            if (sizes.size() < 2) {
+                continue;
+            }
+            uint64_t paddedElements = 0;
+            const auto buckets = ShapeHistogram::proposePaddedBuckets(sizes, maxBuckets, paddedElements);
+            writer.StartObject();
+            writer.Key("input");
+            writer.String(name.c_str());
+            writer.Key("dimension");
+            writer.Uint64(1);
+            writer.Key("buckets");
+            writer.StartArray();
+            for (const auto bucket : buckets) {
+                writer.Uint64(bucket);
+            }
+            writer.EndArray();
+            writer.Key("padded_elements");
+            writer.Uint64(paddedElements);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    response = buffer.GetString();
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processPipelineCriticalPathRequest(const std::string& pipelineName, std::string& response) {
+    SPDLOG_DEBUG("Processing pipeline critical path request for pipeline: {}", pipelineName);
+    auto definition = ModelManager::getInstance().getPipelineFactory().findDefinitionByName(pipelineName);
+    if (definition == nullptr) {
+        response = createErrorJsonWithMessage(Status(StatusCode::PIPELINE_DEFINITION_NAME_MISSING).string());
+        return StatusCode::PIPELINE_DEFINITION_NAME_MISSING;
+    }
+    auto criticalPath = definition->getCriticalPath();
+    if (criticalPath == nullptr) {
+        response = createErrorJsonWithMessage(Status(StatusCode::PIPELINE_DEFINITION_NOT_LOADED_YET).string());
+        return StatusCode::PIPELINE_DEFINITION_NOT_LOADED_YET;
+    }
+    const auto report = criticalPath->getReport();
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("samples");
+    writer.Uint64(report.samples);
+    writer.Key("latency_us");
+    writer.Double(report.latencyUs);
+    writer.Key("critical_path");
+    writer.StartArray();
+    for (const auto& name : report.criticalPath) {
+        writer.String(name.c_str());
+    }
+    writer.EndArray();
+    writer.Key("critical_path_fraction");
+    writer.Double(report.criticalPathFraction);
+    writer.Key("nodes");
+    writer.StartArray();
+    for (const auto& node : report.nodes) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(node.name.c_str());
+        writer.Key("samples");
+        writer.Uint64(node.samples);
+        writer.Key("critical_fraction");
+        writer.Double(node.criticalFraction);
+        writer.Key("contribution_us");
+        writer.Double(node.contributionUs);
+        writer.Key("contribution_share");
+        writer.Double(node.contributionShare);
+        writer.Key("slack_us");
+        writer.Double(node.slackUs);
+        writer.Key("min_slack_us");
+        writer.Uint64(node.minSlackUs);
+        writer.Key("stream_wait_us");
+        writer.Double(node.streamWaitUs);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    response = buffer.GetString();
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processMetricsRequest(std::string& response, std::vector<std::pair<std::string, std::string>>* headers) {
+    SPDLOG_DEBUG("Processing metrics request started.");
+    ModelManager::getInstance().updateModelMetrics();
+    response = MetricRegistry::getInstance().serialize();
+    for (auto& [name, value] : *headers) {
+        if (name == "Content-Type") {
+            value = "text/plain; version=0.0.4";
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processPeerFileRequest(const std::string& key, uint64_t first, uint64_t last,
+    std::string& response, std::vector<std::pair<std::string, std::string>>* headers) {
+    auto cache = RemoteFilesCache::getInstance();
+    if (!Config::instance().servePeerFiles() || !cache) {
+        return StatusCode::PEER_FILE_SERVING_DISABLED;
+    }
+    if (first > last || last - first >= PEER_FILE_MAX_RANGE_SIZE) {
+        return StatusCode::PEER_FILE_RANGE_INVALID;
+    }
+    auto status = cache->readRange(key, first, last, response);
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Serving {} bytes {}-{} to peer failed: {}", key, first, last, status.string());
+        return status;
+    }
+    for (auto& [name, value] : *headers) {
+        if (name == "Content-Type") {
+            value = "application/octet-stream";
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processSharedMemoryRequest(const std::string& regionName,
+    const std::string& method,
+    const std::string& request,
+    std::string& response) {
+    SPDLOG_DEBUG("Processing shared memory {} request for region: {}", method, regionName);
+    auto& registry = SharedMemoryRegistry::getInstance();
+    Status status;
+    if (method == "unregister") {
+        status = registry.unregisterRegion(regionName);
+        if (!status.ok()) {
+            response = createErrorJsonWithMessage(status.string());
+            return status;
+        }
+        response = "{}";
+        return StatusCode::OK;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse(request.c_str()).HasParseError()) {
+        response = createErrorJsonWithMessage("Request is not a valid JSON");
+        return StatusCode::REST_MALFORMED_REQUEST;
+    }
+    if (!doc.IsObject() ||
+        !doc.HasMember("key") || !doc["key"].IsString() ||
+        !doc.HasMember("byte_size") || !doc["byte_size"].IsUint64() ||
+        (doc.HasMember("offset") && !doc["offset"].IsUint64())) {
+        response = createErrorJsonWithMessage("Expected object with key string, byte_size and optional offset unsigned integers");
+        return StatusCode::REST_MALFORMED_REQUEST;
+    }
+    const uint64_t offset = doc.HasMember("offset") ? doc["offset"].GetUint64() : 0;
+    status = registry.registerRegion(regionName, doc["key"].GetString(), offset, doc["byte_size"].GetUint64());
+    if (!status.ok()) {
+        response = createErrorJsonWithMessage(status.string());
+        return status;
+    }
+    response = "{}";
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processSequenceStateRequest(const std::string& modelName,
+    const std::optional<int64_t>& modelVersion,
+    uint64_t sequenceId,
+    const std::string& method,
+    const std::string& request,
+    std::string& response,
+    std::vector<std::pair<std::string, std::string>>* headers) {
+    SPDLOG_DEBUG("Processing sequence state {} request for model: {}; version: {}; sequence: {}", method, modelName, modelVersion.value_or(0), sequenceId);
+    std::shared_ptr<ModelInstance> modelInstance;
+    std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+    auto status = ModelManager::getInstance().getModelInstance(modelName, modelVersion.value_or(0), modelInstance, modelInstanceUnloadGuard);
+    if (!status.ok()) {
+        response = createErrorJsonWithMessage(status.string());
+        return status;
+    }
+    auto statefulModelInstance = dynamic_cast<StatefulModelInstance*>(modelInstance.get());
+    if (!statefulModelInstance) {
+        status = StatusCode::SEQUENCE_STATE_STATELESS_MODEL;
+        response = createErrorJsonWithMessage(status.string());
+        return status;
+    }
+    if (method == "import") {
+        status = statefulModelInstance->importSequence(sequenceId, request);
+        response = status.ok() ? "{}" : createErrorJsonWithMessage(status.string());
+        return status;
+    }
+
+    bool removeSequence = false;
+    if (!request.empty()) {
+        rapidjson::Document doc;
+        if (doc.Parse(request.c_str()).HasParseError() || !doc.IsObject() ||
+            (doc.HasMember("remove") && !doc["remove"].IsBool())) {
+            response = createErrorJsonWithMessage("Expected object with optional remove boolean");
+            return StatusCode::REST_MALFORMED_REQUEST;
+        }
+        removeSequence = doc.HasMember("remove") && doc["remove"].GetBool();
+    }
+    status = statefulModelInstance->exportSequence(sequenceId, response, removeSequence);
+    if (!status.ok()) {
+        response = createErrorJsonWithMessage(status.string());
+        return status;
+    }
+    for (auto& [name, value] : *headers) {
+        if (name == "Content-Type") {
+            value = "application/octet-stream";
+        }
+    }
+    return StatusCode::OK;
+}
+
 }  // namespace ovms
@@ -15,7 +15,6 @@
 //*****************************************************************************
 #pragma once
 
-#include <regex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,6 +26,7 @@
 
 #include "modelmanager.hpp"
 #include "rest_parser.hpp"
+#include "requestcontext.hpp"
 #include "status.hpp"
 
 namespace ovms {
@@ -34,7 +34,23 @@ enum RequestType { Predict,
     GetModelStatus,
     GetModelMetadata,
     ConfigReload,
-    ConfigStatus };
+    ConfigStatus,
+    SharedMemory,
+    KFSInfer,
+    Metrics,
+    RawInputPredict,
+    KFSInferBatch,
+    SequenceState,
+    GetModelMemory,
+    GetModelProfile,
+    GetModelSaturation,
+    GetModelShapes,
+    GetPipelineCriticalPath,
+    GetSlowRequests,
+    GetResidency,
+    GetPeerFile,
+    ServerLive,
+    ServerReady };
 struct HttpRequestComponents {
     RequestType type;
     std::string_view http_method;
@@ -43,14 +59,35 @@ struct HttpRequestComponents {
     std::optional<std::string_view> model_version_label;
     std::string processing_method;
     std::string model_subresource;
+    std::string shared_memory_region;
+    std::string input_name;
+    uint64_t sequence_id = 0;
+    std::string file_key;
+    uint64_t range_first = 0;
+    uint64_t range_last = 0;
+    std::string content_type;
+    RequestContext context;
 };
 
 class HttpRestApiHandler {
 public:
+    /**
+     * @brief Paths accepted by request routing, in form of regular expressions. Routing itself does not use them.
+     */
     static const std::string predictionRegexExp;
     static const std::string modelstatusRegexExp;
     static const std::string configReloadRegexExp;
     static const std::string configStatusRegexExp;
+    static const std::string sharedMemoryRegexExp;
+    static const std::string kfsInferRegexExp;
+    static const std::string metricsRegexExp;
+    static const std::string rawInputPredictionRegexExp;
+    static const std::string kfsInferBatchRegexExp;
+    static const std::string sequenceStateRegexExp;
+    static const std::string slowRequestsRegexExp;
+    static const std::string residencyRegexExp;
+    static const std::string peerFileRegexExp;
+    static const std::string healthRegexExp;
 
     /**
      * @brief Construct a new HttpRest Api Handler
@@ -58,10 +95,6 @@ public:
      * @param timeout_in_ms 
      */
     HttpRestApiHandler(int timeout_in_ms) :
-        predictionRegex(predictionRegexExp),
-        modelstatusRegex(modelstatusRegexExp),
-        configReloadRegex(configReloadRegexExp),
-        configStatusRegex(configStatusRegexExp),
         timeout_in_ms(timeout_in_ms) {}
 
     Status parseRequestComponents(HttpRequestComponents& components,
@@ -73,7 +106,8 @@ public:
     Status dispatchToProcessor(
         const std::string& request_body,
         std::string* response,
-        const HttpRequestComponents& request_components);
+        const HttpRequestComponents& request_components,
+        std::vector<std::pair<std::string, std::string>>* headers);
 
     /**
      * @brief Process Request
@@ -83,6 +117,8 @@ public:
      * @param request_body 
      * @param headers 
      * @param resposnse 
+     * @param context scheduling information from request headers
+     * @param content_type Content-Type header of request, used by endpoints accepting non JSON bodies
      *
      * @return StatusCode 
      */
@@ -91,7 +127,9 @@ public:
         const std::string_view request_path,
         const std::string& request_body,
         std::vector<std::pair<std::string, std::string>>* headers,
-        std::string* response);
+        std::string* response,
+        const RequestContext& context = RequestContext(),
+        const std::string& content_type = "");
 
     /**
      * @brief Process predict request
@@ -101,6 +139,8 @@ public:
      * @param modelVersionLabel 
      * @param request 
      * @param response 
+     * @param context 
+     * @param headers fallback model headers are added if request was served by fallback model
      *
      * @return StatusCode 
      */
@@ -109,20 +149,80 @@ public:
         const std::optional<int64_t>& modelVersion,
         const std::optional<std::string_view>& modelVersionLabel,
         const std::string& request,
-        std::string* response);
+        std::string* response,
+        const RequestContext& context = RequestContext(),
+        std::vector<std::pair<std::string, std::string>>* headers = nullptr);
+
+    /**
+     * @brief Process KServe v2 inference request, with optional binary tensor data extension
+     *
+     * @param modelName
+     * @param modelVersion
+     * @param request JSON header optionally followed by binary data of inputs
+     * @param headers
+     * @param response JSON header optionally followed by binary data of outputs
+     * @param context
+     *
+     * @return StatusCode
+     */
+    Status processKFSInferRequest(
+        const std::string& modelName,
+        const std::optional<int64_t>& modelVersion,
+        const std::string& request,
+        std::vector<std::pair<std::string, std::string>>* headers,
+        std::string* response,
+        const RequestContext& context = RequestContext());
+
+    /**
+     * @brief Process batch of KServe v2 inference requests, executed concurrently
+     *
+     * @param request ModelInferBatchRequest in protobuf JSON mapping, raw contents are base64 encoded
+     * @param response ModelInferBatchResponse in protobuf JSON mapping
+     * @param context shared by all requests
+     *
+     * @return JSON_INVALID if request does not match ModelInferBatchRequest
+     */
+    Status processKFSInferBatchRequest(
+        const std::string& request,
+        std::string* response,
+        const RequestContext& context = RequestContext());
+
+    /**
+     * @brief Process predict request with encoded images sent as the body, fed to single input as binary data
+     *
+     * @param modelName
+     * @param modelVersion
+     * @param inputName
+     * @param contentType image/* for single image or multipart/* for batch of images, one in each part
+     * @param request
+     * @param response JSON response in column format
+     * @param context
+     *
+     * @return REST_UNSUPPORTED_CONTENT_TYPE if body is neither image nor multipart
+     */
+    Status processRawInputPredictRequest(
+        const std::string& modelName,
+        const std::optional<int64_t>& modelVersion,
+        const std::string& inputName,
+        const std::string& contentType,
+        const std::string& request,
+        std::string* response,
+        const RequestContext& context = RequestContext());
 
     Status processSingleModelRequest(
         const std::string& modelName,
         const std::optional<int64_t>& modelVersion,
         const std::string& request,
         Order& requestOrder,
-        tensorflow::serving::PredictResponse& responseProto);
+        tensorflow::serving::PredictResponse& responseProto,
+        const RequestContext& context = RequestContext());
 
     Status processPipelineRequest(
         const std::string& modelName,
         const std::string& request,
         Order& requestOrder,
-        tensorflow::serving::PredictResponse& responseProto);
+        tensorflow::serving::PredictResponse& responseProto,
+        const RequestContext& context = RequestContext());
 
     /**
      * @brief Process Model Metadata request
@@ -155,16 +255,133 @@ public:
         const std::optional<std::string_view>& model_version_label,
         std::string* response);
 
+    /**
+     * @brief Process model memory request, reports estimated memory used by model versions
+     *
+     * @param modelName
+     * @param modelVersion all versions of the model if not set
+     * @param response JSON with memory used by model files, infer requests blobs and sequence states of each version
+     *
+     * @return StatusCode
+     */
+    Status processModelMemoryRequest(const std::string& modelName,
+        const std::optional<int64_t>& modelVersion,
+        std::string& response);
+
+    /**
+     * @brief Process model profile request, reports per layer timings of requests sampled for layer profiling
+     *
+     * @param modelName
+     * @param modelVersion all versions of the model with layer profiling enabled if not set
+     * @param response JSON with number of profiled requests and layers of each version, the most time consuming first
+     *
+     * @return StatusCode
+     */
+    Status processModelProfileRequest(const std::string& modelName,
+        const std::optional<int64_t>& modelVersion,
+        std::string& response);
+
+    /**
+     * @brief Process model saturation request, reports how busy infer requests were over the last seconds, signal for autoscalers
+     *
+     * @param modelName
+     * @param modelVersion all versions of the model if not set
+     * @param response JSON with busy fraction, queue wait p95, service time, throughput, capacity and headroom of each version
+     *
+     * @return StatusCode
+     */
+    Status processModelSaturationRequest(const std::string& modelName,
+        const std::optional<int64_t>& modelVersion,
+        std::string& response);
+
+    /**
+     * @brief Process model shapes request, reports the most frequent input shapes of requests and proposes padded sequence length buckets
+     *
+     * @param modelName
+     * @param modelVersion all versions of the model if not set
+     * @param response JSON with shape counts and proposed buckets of each version with shape set to auto
+     *
+     * @return StatusCode
+     */
+    Status processModelShapesRequest(const std::string& modelName,
+        const std::optional<int64_t>& modelVersion,
+        std::string& response);
+
+    /**
+     * @brief Process pipeline critical path request, reports which nodes bound latency of sampled executions
+     *
+     * @param pipelineName
+     * @param response JSON with the most frequent critical path and contribution and slack of each node
+     *
+     * @return StatusCode
+     */
+    Status processPipelineCriticalPathRequest(const std::string& pipelineName, std::string& response);
+
     Status processConfigReloadRequest(std::string& response, ModelManager& manager);
 
     Status processConfigStatusRequest(std::string& response, ModelManager& manager);
 
-private:
-    const std::regex predictionRegex;
-    const std::regex modelstatusRegex;
-    const std::regex configReloadRegex;
-    const std::regex configStatusRegex;
+    /**
+     * @brief Process metrics request, serializes server metrics in Prometheus text format
+     *
+     * @param response
+     * @param headers content type header is replaced with Prometheus one
+     *
+     * @return StatusCode
+     */
+    Status processMetricsRequest(std::string& response, std::vector<std::pair<std::string, std::string>>* headers);
+
+    /**
+     * @brief Process byte range request of remote model cache file from server replica
+     *
+     * @param key remote model cache key
+     * @param first first byte of range
+     * @param last last byte of range, inclusive
+     * @param response raw file bytes
+     * @param headers content type header is replaced with binary one
+     *
+     * @return StatusCode
+     */
+    Status processPeerFileRequest(const std::string& key, uint64_t first, uint64_t last,
+        std::string& response, std::vector<std::pair<std::string, std::string>>* headers);
 
+    /**
+     * @brief Process export or import of stateful model sequence state
+     *
+     * @param modelName
+     * @param modelVersion
+     * @param sequenceId
+     * @param method export or import
+     * @param request serialized state for import, for export optional JSON object with remove boolean
+     * @param response serialized state for export
+     * @param headers content type header is replaced with binary one for export
+     *
+     * @return SEQUENCE_STATE_STATELESS_MODEL if model is not stateful
+     */
+    Status processSequenceStateRequest(const std::string& modelName,
+        const std::optional<int64_t>& modelVersion,
+        uint64_t sequenceId,
+        const std::string& method,
+        const std::string& request,
+        std::string& response,
+        std::vector<std::pair<std::string, std::string>>* headers);
+
+    /**
+     * @brief Process shared memory region registration request
+     *
+     * @param regionName
+     * @param method register or unregister
+     * @param request JSON object with key, byte_size and optional offset of POSIX shared memory object, used by register
+     * @param response
+     *
+     * @return StatusCode
+     */
+    Status processSharedMemoryRequest(const std::string& regionName,
+        const std::string& method,
+        const std::string& request,
+        std::string& response);
+
+private:
     int timeout_in_ms;
 };
 
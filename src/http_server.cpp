@@ -15,6 +15,7 @@
 //*****************************************************************************
 #include "http_server.hpp"
 
+#include <cstdlib>
 #include <memory>
 #include <regex>
 #include <string>
@@ -31,8 +32,13 @@
 #include "tensorflow_serving/util/threadpool_executor.h"
 #pragma GCC diagnostic pop
 
+#include "http_compression.hpp"
 #include "http_rest_api_handler.hpp"
+#include "requestcontext.hpp"
+#include "rest_request_buffers.hpp"
 #include "status.hpp"
+#include "tracing.hpp"
+#include "workerpool.hpp"
 
 namespace ovms {
 
@@ -40,18 +46,37 @@ namespace net_http = tensorflow::serving::net_http;
 
 class RequestExecutor final : public net_http::EventExecutor {
 public:
-    explicit RequestExecutor(int num_threads) :
-        executor_(tensorflow::Env::Default(), "httprestserver", num_threads) {}
+    RequestExecutor(int num_threads, std::vector<int> cpu_affinity) :
+        executor_(tensorflow::Env::Default(), "httprestserver", num_threads),
+        cpu_affinity_(std::move(cpu_affinity)) {}
 
-    void Schedule(std::function<void()> fn) override { executor_.Schedule(fn); }
+    void Schedule(std::function<void()> fn) override {
+        if (cpu_affinity_.empty()) {
+            executor_.Schedule(fn);
+            return;
+        }
+        // threads of tensorflow pool are not exposed, each one is pinned by its first task
+        executor_.Schedule([this, fn = std::move(fn)]() {
+            thread_local bool pinned = false;
+            if (!pinned) {
+                WorkerPool::pinCurrentThread(cpu_affinity_);
+                pinned = true;
+            }
+            fn();
+        });
+    }
 
 private:
     tensorflow::serving::ThreadPoolExecutor executor_;
+    const std::vector<int> cpu_affinity_;
 };
 
 class RestApiRequestDispatcher {
 public:
-    RestApiRequestDispatcher(int timeout_in_ms) {
+    RestApiRequestDispatcher(int timeout_in_ms, size_t max_body_size, int compression_level, size_t compression_min_size) :
+        max_body_size_(max_body_size),
+        compression_level_(compression_level),
+        compression_min_size_(compression_min_size) {
         handler_ = std::make_unique<HttpRestApiHandler>(timeout_in_ms);
     }
 
@@ -62,23 +87,114 @@ public:
     }
 
 private:
-    void processRequest(net_http::ServerRequestInterface* req) {
-        SPDLOG_DEBUG("REST request {}", req->uri_path());
-        std::string body;
+    /**
+     * @brief Reads request body into buffer reserved from Content-Length, rejecting bodies over the size limit
+     *
+     * libevent calls the handler only after the whole body is received, chunks are already in memory here.
+     * Parsing cannot start while the upload is still arriving without replacing the HTTP server.
+     */
+    Status readRequestBody(net_http::ServerRequestInterface* req, std::string& body) {
+        const std::string content_length_header(req->GetRequestHeader("Content-Length"));
+        if (!content_length_header.empty()) {
+            char* end = nullptr;
+            const uint64_t content_length = std::strtoull(content_length_header.c_str(), &end, 10);
+            if (end == content_length_header.c_str() || *end != '\0') {
+                SPDLOG_DEBUG("Invalid Content-Length header: {}", content_length_header);
+                return StatusCode::REST_MALFORMED_REQUEST;
+            }
+            if (max_body_size_ != 0 && content_length > max_body_size_) {
+                SPDLOG_DEBUG("Request body of {} bytes exceeds limit of {} bytes", content_length, max_body_size_);
+                return StatusCode::REST_REQUEST_BODY_TOO_LARGE;
+            }
+            body.reserve(content_length);
+        }
         int64_t num_bytes = 0;
         auto request_chunk = req->ReadRequestBytes(&num_bytes);
         while (request_chunk != nullptr) {
-            body.append(std::string_view(request_chunk.get(), num_bytes));
+            if (max_body_size_ != 0 && body.size() + num_bytes > max_body_size_) {
+                SPDLOG_DEBUG("Request body exceeds limit of {} bytes", max_body_size_);
+                return StatusCode::REST_REQUEST_BODY_TOO_LARGE;
+            }
+            body.append(request_chunk.get(), num_bytes);
             request_chunk = req->ReadRequestBytes(&num_bytes);
         }
+        return StatusCode::OK;
+    }
 
+    /**
+     * @brief Replaces compressed request body with its uncompressed content, according to Content-Encoding header
+     */
+    Status decodeRequestBody(net_http::ServerRequestInterface* req, std::string& body) {
+        const auto encoding = parseContentEncoding(req->GetRequestHeader("Content-Encoding"));
+        if (encoding == ContentEncoding::IDENTITY) {
+            return StatusCode::OK;
+        }
+        if (encoding == ContentEncoding::UNSUPPORTED) {
+            SPDLOG_DEBUG("Unsupported Content-Encoding: {}", req->GetRequestHeader("Content-Encoding"));
+            return StatusCode::REST_UNSUPPORTED_CONTENT_ENCODING;
+        }
+        // net_http inflates gzip bodies itself when auto_uncompress_input is enabled
+        if (encoding == ContentEncoding::GZIP && !isGzipData(body)) {
+            return StatusCode::OK;
+        }
+        std::string decoded;
+        auto status = decompress(encoding, body, decoded, max_body_size_);
+        if (status.ok()) {
+            body.swap(decoded);
+        }
+        return status;
+    }
+
+    /**
+     * @brief Compresses response with encoding accepted by client, if it reaches minimum size
+     */
+    void encodeResponse(net_http::ServerRequestInterface* req, std::string& output) {
+        if (compression_level_ == 0 || output.size() < compression_min_size_) {
+            return;
+        }
+        const auto encoding = negotiateContentEncoding(req->GetRequestHeader("Accept-Encoding"));
+        if (encoding == ContentEncoding::IDENTITY) {
+            return;
+        }
+        std::string compressed;
+        if (!compress(encoding, compression_level_, output, compressed).ok()) {
+            return;
+        }
+        SPDLOG_DEBUG("Compressed response with {} from {} to {} bytes", getContentEncodingName(encoding), output.size(), compressed.size());
+        output.swap(compressed);
+        req->OverwriteResponseHeader("Content-Encoding", getContentEncodingName(encoding));
+        req->OverwriteResponseHeader("Vary", "Accept-Encoding");
+    }
+
+    void processRequest(net_http::ServerRequestInterface* req) {
+        SPDLOG_DEBUG("REST request {}", req->uri_path());
+        // body and output keep their capacity for the next request of this thread
+        auto& buffers = RestRequestBuffers::current();
+        std::string& body = buffers.body;
+        std::string& output = buffers.output;
+        body.clear();
+        output.clear();
         std::vector<std::pair<std::string, std::string>> headers;
-        std::string output;
-        SPDLOG_DEBUG("Processing HTTP request: {} {} body: {} bytes",
-            req->http_method(),
-            req->uri_path(),
-            body.size());
-        const auto status = handler_->processRequest(req->http_method(), req->uri_path(), body, &headers, &output);
+        auto status = readRequestBody(req, body);
+        if (status.ok()) {
+            status = decodeRequestBody(req, body);
+        }
+        if (status.ok()) {
+            SPDLOG_DEBUG("Processing HTTP request: {} {} body: {} bytes",
+                req->http_method(),
+                req->uri_path(),
+                body.size());
+            auto context = RequestContext::fromHeaders(
+                req->GetRequestHeader(RequestContext::PRIORITY_HEADER),
+                req->GetRequestHeader(RequestContext::TIMEOUT_HEADER),
+                req->GetRequestHeader(TraceContext::TRACEPARENT_HEADER));
+            Span requestSpan(context.trace, "http request");
+            requestSpan.setAttribute("method", std::string(req->http_method()));
+            requestSpan.setAttribute("path", std::string(req->uri_path()));
+            context.trace = requestSpan.getContext();
+            status = handler_->processRequest(req->http_method(), req->uri_path(), body, &headers, &output, context, std::string(req->GetRequestHeader("Content-Type")));
+            requestSpan.setStatus(status);
+        }
         if (!status.ok() && output.empty()) {
             output.append("{\"error\": \"" + status.string() + "\"}");
         }
@@ -86,7 +202,9 @@ private:
         for (const auto& kv : headers) {
             req->OverwriteResponseHeader(kv.first, kv.second);
         }
+        encodeResponse(req, output);
         req->WriteResponseString(output);
+        buffers.trim();
         if (http_status != net_http::HTTPStatusCode::OK && http_status != net_http::HTTPStatusCode::CREATED) {
             SPDLOG_DEBUG("Processing HTTP/REST request failed: {} {}. Reason: {}",
                 req->http_method(),
@@ -97,13 +215,24 @@ private:
     }
 
     std::unique_ptr<HttpRestApiHandler> handler_;
+    const size_t max_body_size_;
+    const int compression_level_;
+    const size_t compression_min_size_;
 };
 
-std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, int timeout_in_ms) {
+std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, size_t max_body_size,
+    int compression_level, size_t compression_min_size, int timeout_in_ms, const std::vector<int>& cpu_affinity,
+    bool reuse_port) {
     auto options = std::make_unique<net_http::ServerOptions>();
     options->AddPort(static_cast<uint32_t>(port));
-    options->SetAddress(address);
-    options->SetExecutor(std::make_unique<RequestExecutor>(num_threads));
+    const bool unixSocket = address.rfind(UNIX_SOCKET_ADDRESS_PREFIX, 0) == 0;
+    if (unixSocket) {
+        options->SetUnixSocketPath(address.substr(UNIX_SOCKET_ADDRESS_PREFIX.size()));
+    } else {
+        options->SetAddress(address);
+        options->SetReusePort(reuse_port);
+    }
+    options->SetExecutor(std::make_unique<RequestExecutor>(num_threads, cpu_affinity));
 
     auto server = net_http::CreateEvHTTPServer(std::move(options));
     if (server == nullptr) {
@@ -112,7 +241,7 @@ std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address
     }
 
     std::shared_ptr<RestApiRequestDispatcher> dispatcher =
-        std::make_shared<RestApiRequestDispatcher>(timeout_in_ms);
+        std::make_shared<RestApiRequestDispatcher>(timeout_in_ms, max_body_size, compression_level, compression_min_size);
 
     net_http::RequestHandlerOptions handler_options;
     server->RegisterRequestDispatcher(
@@ -122,7 +251,11 @@ std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address
         handler_options);
 
     if (server->StartAcceptingRequests()) {
-        SPDLOG_INFO("REST server listening on port {} with {} threads", port, num_threads);
+        if (unixSocket) {
+            SPDLOG_INFO("REST server listening on {} with {} threads", address, num_threads);
+        } else {
+            SPDLOG_INFO("REST server listening on port {} with {} threads", port, num_threads);
+        }
         return server;
     }
 
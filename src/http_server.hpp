@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
@@ -27,15 +28,28 @@ namespace ovms {
 
 using http_server = tensorflow::serving::net_http::HTTPServerInterface;
 
+/**
+ * @brief Prefix of address of Unix domain socket, followed by the socket path
+ */
+const std::string UNIX_SOCKET_ADDRESS_PREFIX = "unix:";
+
 /**
  * @brief Creates a and starts Http Server
  * 
+ * @param address network interface address, or UNIX_SOCKET_ADDRESS_PREFIX followed by path of Unix domain socket replacing the port
  * @param port 
  * @param num_threads 
+ * @param max_body_size maximum request body size in bytes, 0 means no limit
+ * @param compression_level zlib level of gzip/deflate response compression, 0 disables it
+ * @param compression_min_size minimum response size in bytes to be compressed
  * @param timeout_in_m not implemented
+ * @param cpu_affinity CPU cores worker threads are pinned to, empty leaves threads unpinned
+ * @param reuse_port listen with SO_REUSEPORT, so that servers started with the same address and port share incoming connections
  *  
  * @return std::unique_ptr<http_server> 
  */
-std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, int timeout_in_ms = -1);
+std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, size_t max_body_size = 0,
+    int compression_level = 0, size_t compression_min_size = 0, int timeout_in_ms = -1, const std::vector<int>& cpu_affinity = {},
+    bool reuse_port = false);
 
 }  // namespace ovms
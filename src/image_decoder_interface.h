@@ -0,0 +1,41 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <stdint.h>
+
+struct ImageDecoderImage {
+    const uint8_t* data;
+    uint64_t dataBytes;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Decodes batch of encoded images of a request, e.g. with hardware decoder of integrated GPU or media engine,
+ * into U8 frames of height x width x channels in NHWC layout, BGR order for 3 channels. Images of other
+ * resolution are scaled. Frame of image i is written to output + i * height * width * channels.
+ * Sets statuses[i] to 0 for decoded images and to non zero for images decoder does not support, e.g. of
+ * unsupported format, which the server then decodes on CPU. Non zero result means no image was decoded.
+ * Called concurrently by requests.
+ */
+int decodeImages(const struct ImageDecoderImage* images, int imagesCount, uint64_t height, uint64_t width, uint64_t channels, uint8_t* output, int* statuses);
+
+#ifdef __cplusplus
+}
+#endif
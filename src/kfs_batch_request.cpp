@@ -0,0 +1,181 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "kfs_batch_request.hpp"
+
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include <boost/algorithm/string.hpp>
+#include <spdlog/spdlog.h>
+
+#include "kfs_grpc_inference_service.hpp"
+#include "kfs_utils.hpp"
+#include "prediction_service.hpp"
+#include "shared_memory.hpp"
+
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+namespace ovms {
+
+const std::string KFSBatchRequest::SHARED_INPUTS_PARAMETER = "shared_inputs";
+const std::string KFSBatchRequest::ERROR_PARAMETER = "error";
+
+KFSBatchRequest::~KFSBatchRequest() {
+    for (const auto& name : regionNames) {
+        SharedMemoryRegistry::getInstance().unregisterRegion(name);
+    }
+}
+
+Status KFSBatchRequest::registerSharedInputs() {
+    if (request.shared_raw_input_contents_size() != request.shared_inputs_size()) {
+        SPDLOG_DEBUG("Batch request has {} shared inputs but {} shared_raw_input_contents", request.shared_inputs_size(), request.shared_raw_input_contents_size());
+        return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+    }
+    // contents are owned by the request, which outlives the regions
+    std::shared_ptr<const void> owner(&request, [](const void*) {});
+    for (int i = 0; i < request.shared_inputs_size(); ++i) {
+        const auto& input = request.shared_inputs(i);
+        size_t byteSize = getKFSDataTypeSize(input.datatype());
+        if (byteSize == 0) {
+            SPDLOG_DEBUG("Shared input: {} with datatype: {} cannot be shared", input.name(), input.datatype());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        for (auto dim : input.shape()) {
+            if (dim < 0 || (dim != 0 && byteSize > std::numeric_limits<size_t>::max() / dim)) {
+                return StatusCode::INVALID_SHAPE;
+            }
+            byteSize *= dim;
+        }
+        const auto& content = request.shared_raw_input_contents(i);
+        if (content.size() != byteSize) {
+            SPDLOG_DEBUG("Shared input: {} has {} bytes of content, expected: {}", input.name(), content.size(), byteSize);
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        if (!sharedInputIndexes.emplace(input.name(), i).second) {
+            SPDLOG_DEBUG("Shared input: {} is declared more than once", input.name());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        const std::string regionName = generateRequestRegionName();
+        auto status = SharedMemoryRegistry::getInstance().registerRequestRegion(regionName, const_cast<char*>(content.data()), content.size(), owner);
+        if (!status.ok()) {
+            return status;
+        }
+        regionNames.push_back(regionName);
+    }
+    return StatusCode::OK;
+}
+
+Status KFSBatchRequest::convertRequest(int index, PredictRequest& predictRequest) const {
+    const auto& inferRequest = request.requests(index);
+    auto status = KFSInferenceServiceImpl::convertRequest(inferRequest, predictRequest);
+    if (!status.ok()) {
+        return status;
+    }
+    auto it = inferRequest.parameters().find(SHARED_INPUTS_PARAMETER);
+    if (it == inferRequest.parameters().end()) {
+        return StatusCode::OK;
+    }
+    if (it->second.parameter_choice_case() != inference::InferParameter::kStringParam) {
+        SPDLOG_DEBUG("Parameter: {} has to be a string", SHARED_INPUTS_PARAMETER);
+        return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+    }
+    std::vector<std::string> names;
+    boost::split(names, it->second.string_param(), boost::is_any_of(","));
+    for (auto& name : names) {
+        boost::trim(name);
+        if (name.empty()) {
+            continue;
+        }
+        auto sharedIt = sharedInputIndexes.find(name);
+        if (sharedIt == sharedInputIndexes.end()) {
+            SPDLOG_DEBUG("Request uses shared input: {} which does not exist", name);
+            return Status(StatusCode::KFS_INVALID_INPUT_CONTENTS, "Shared input: " + name);
+        }
+        if (predictRequest.inputs().count(name) > 0) {
+            SPDLOG_DEBUG("Request uses shared input: {} and sends input with the same name", name);
+            return Status(StatusCode::KFS_INVALID_INPUT_CONTENTS, "Shared input: " + name);
+        }
+        const auto& sharedInput = request.shared_inputs(sharedIt->second);
+        auto& tensor = (*predictRequest.mutable_inputs())[name];
+        tensorflow::DataType dtype;
+        status = convertKFSDataTypeToTensorflow(sharedInput.datatype(), dtype);
+        if (!status.ok()) {
+            return status;
+        }
+        tensor.set_dtype(dtype);
+        for (auto dim : sharedInput.shape()) {
+            tensor.mutable_tensor_shape()->add_dim()->set_size(dim);
+        }
+        setSharedMemoryReference(tensor, regionNames[sharedIt->second], 0);
+    }
+    return StatusCode::OK;
+}
+
+Status KFSBatchRequest::infer(inference::ModelInferBatchResponse& response, const RequestContext& context) {
+    auto status = registerSharedInputs();
+    if (!status.ok()) {
+        return status;
+    }
+    const int count = request.requests_size();
+    std::vector<PredictRequest> predictRequests(count);
+    std::vector<PredictResponse> predictResponses(count);
+    std::vector<Status> statuses(count);
+    std::mutex mtx;
+    std::condition_variable cv;
+    int pending = count;
+    auto complete = [&](int index, Status status) {
+        std::unique_lock<std::mutex> lock(mtx);
+        statuses[index] = status;
+        if (--pending == 0) {
+            cv.notify_one();
+        }
+    };
+    for (int i = 0; i < count; ++i) {
+        status = convertRequest(i, predictRequests[i]);
+        if (!status.ok()) {
+            complete(i, status);
+            continue;
+        }
+        PredictionServiceImpl::inferAsync(&predictRequests[i], &predictResponses[i], context,
+            [&complete, i](Status status) { complete(i, status); });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&pending]() { return pending == 0; });
+    }
+    for (int i = 0; i < count; ++i) {
+        const auto& inferRequest = request.requests(i);
+        auto* inferResponse = response.add_responses();
+        status = statuses[i];
+        if (status.ok()) {
+            status = KFSInferenceServiceImpl::convertResponse(inferRequest, predictResponses[i], *inferResponse);
+        }
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Request {} of batch for model: {} failed: {}", i, inferRequest.model_name(), status.string());
+            inferResponse->Clear();
+            inferResponse->set_model_name(inferRequest.model_name());
+            inferResponse->set_model_version(inferRequest.model_version());
+            inferResponse->set_id(inferRequest.id());
+            (*inferResponse->mutable_parameters())[ERROR_PARAMETER].set_string_param(status.string());
+        }
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
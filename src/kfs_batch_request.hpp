@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "requestcontext.hpp"
+#include "src/kfserving_api/grpc_predict_v2.grpc.pb.h"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Runs requests of ModelInferBatch call concurrently
+ *
+ * Raw contents of shared inputs are registered as request regions of SharedMemoryRegistry and inputs of requests
+ * using them reference the regions like inputs placed in shared memory, so shared input data is not copied
+ * for any of the requests. Requests are started with PredictionServiceImpl::inferAsync one after another
+ * and the call waits for all of them. Regions are unregistered when the batch request is destroyed.
+ */
+class KFSBatchRequest {
+public:
+    /**
+     * @brief Request parameter listing shared inputs used by request, separated by commas
+     */
+    static const std::string SHARED_INPUTS_PARAMETER;
+
+    /**
+     * @brief Response parameter with failure reason of request
+     */
+    static const std::string ERROR_PARAMETER;
+
+    /**
+     * @param request has to outlive the batch request
+     */
+    explicit KFSBatchRequest(const inference::ModelInferBatchRequest& request) :
+        request(request) {}
+    ~KFSBatchRequest();
+
+    KFSBatchRequest(const KFSBatchRequest&) = delete;
+    KFSBatchRequest& operator=(const KFSBatchRequest&) = delete;
+
+    /**
+     * @brief Runs all requests, failures of single requests are reported in their responses
+     *
+     * @param response
+     * @param context shared by all requests
+     *
+     * @return KFS_INVALID_INPUT_CONTENTS if shared inputs are invalid
+     */
+    Status infer(inference::ModelInferBatchResponse& response, const RequestContext& context);
+
+    /**
+     * @brief Converts request at given index to PredictRequest, with shared inputs it uses referencing their regions
+     *
+     * Shared inputs have to be registered first.
+     *
+     * @param index
+     * @param predictRequest
+     *
+     * @return KFS_INVALID_INPUT_CONTENTS if shared input does not exist or is also sent in request inputs
+     */
+    Status convertRequest(int index, tensorflow::serving::PredictRequest& predictRequest) const;
+
+    /**
+     * @brief Registers raw contents of shared inputs as request regions
+     *
+     * @return KFS_INVALID_INPUT_CONTENTS if content is missing or does not match datatype and shape
+     */
+    Status registerSharedInputs();
+
+private:
+    const inference::ModelInferBatchRequest& request;
+    std::unordered_map<std::string, int> sharedInputIndexes;
+    std::vector<std::string> regionNames;
+};
+
+}  // namespace ovms
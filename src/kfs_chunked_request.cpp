@@ -0,0 +1,147 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "kfs_chunked_request.hpp"
+
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include <spdlog/spdlog.h>
+
+#include "kfs_grpc_inference_service.hpp"
+#include "kfs_utils.hpp"
+#include "shared_memory.hpp"
+
+namespace ovms {
+
+KFSChunkedRequest::~KFSChunkedRequest() {
+    for (const auto& name : regionNames) {
+        SharedMemoryRegistry::getInstance().unregisterRegion(name);
+    }
+}
+
+Status KFSChunkedRequest::start(const inference::ModelInferRequest& chunk) {
+    header = chunk;
+    header.clear_raw_input_contents();
+    for (const auto& input : header.inputs()) {
+        if (input.has_contents()) {
+            SPDLOG_DEBUG("Input: {} of chunked request has to be sent in raw_input_contents", input.name());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        size_t byteSize = getKFSDataTypeSize(input.datatype());
+        if (byteSize == 0) {
+            SPDLOG_DEBUG("Input: {} with datatype: {} cannot be sent in chunks", input.name(), input.datatype());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        for (auto dim : input.shape()) {
+            if (dim < 0) {
+                return StatusCode::INVALID_SHAPE;
+            }
+            if (dim != 0 && byteSize > std::numeric_limits<size_t>::max() / dim) {
+                SPDLOG_DEBUG("Input: {} of chunked request is too big", input.name());
+                return StatusCode::INVALID_SHAPE;
+            }
+            byteSize *= dim;
+        }
+        auto& buffer = buffers[input.name()];
+        if (buffer.data) {
+            SPDLOG_DEBUG("Input: {} of chunked request is declared more than once", input.name());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        // chunks are copied directly into memory used by inference
+        char* data = new (std::nothrow) char[byteSize];
+        if (data == nullptr) {
+            SPDLOG_DEBUG("Failed to allocate {} bytes for input: {} of chunked request", byteSize, input.name());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        buffer.data = std::shared_ptr<char>(data, std::default_delete<char[]>());
+        buffer.byteSize = byteSize;
+    }
+    started = true;
+    return StatusCode::OK;
+}
+
+Status KFSChunkedRequest::addChunk(const inference::ModelInferRequest& chunk) {
+    if (!started) {
+        auto status = start(chunk);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    if (chunk.raw_input_contents_size() == 0) {
+        return StatusCode::OK;
+    }
+    if (chunk.raw_input_contents_size() != chunk.inputs_size()) {
+        SPDLOG_DEBUG("Chunk has {} inputs but {} raw_input_contents", chunk.inputs_size(), chunk.raw_input_contents_size());
+        return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+    }
+    for (int i = 0; i < chunk.inputs_size(); ++i) {
+        auto it = buffers.find(chunk.inputs(i).name());
+        if (it == buffers.end()) {
+            SPDLOG_DEBUG("Chunk carries data of input: {} not declared by the first chunk", chunk.inputs(i).name());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        auto& buffer = it->second;
+        const auto& part = chunk.raw_input_contents(i);
+        if (part.size() > buffer.byteSize - buffer.received) {
+            SPDLOG_DEBUG("Data of input: {} exceeds its size: {}", it->first, buffer.byteSize);
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        std::memcpy(buffer.data.get() + buffer.received, part.data(), part.size());
+        buffer.received += part.size();
+    }
+    return StatusCode::OK;
+}
+
+bool KFSChunkedRequest::isComplete() const {
+    if (!started) {
+        return false;
+    }
+    for (const auto& [name, buffer] : buffers) {
+        if (buffer.received != buffer.byteSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Status KFSChunkedRequest::complete(tensorflow::serving::PredictRequest& predictRequest) {
+    if (!isComplete()) {
+        SPDLOG_DEBUG("Chunked request ended before data of all inputs was received");
+        return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+    }
+    // empty raw contents let the conversion accept datatypes allowed only in raw_input_contents
+    inference::ModelInferRequest request = header;
+    for (int i = 0; i < request.inputs_size(); ++i) {
+        request.add_raw_input_contents();
+    }
+    auto status = KFSInferenceServiceImpl::convertRequest(request, predictRequest);
+    if (!status.ok()) {
+        return status;
+    }
+    for (auto& [name, buffer] : buffers) {
+        const std::string regionName = generateRequestRegionName();
+        status = SharedMemoryRegistry::getInstance().registerRequestRegion(regionName, buffer.data.get(), buffer.byteSize, buffer.data);
+        if (!status.ok()) {
+            return status;
+        }
+        regionNames.push_back(regionName);
+        setSharedMemoryReference((*predictRequest.mutable_inputs())[name], regionName, 0);
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,96 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "src/kfserving_api/grpc_predict_v2.grpc.pb.h"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Assembles ModelInferRequest uploaded in chunks with ModelInferUpload call
+ *
+ * The first chunk carries the request without input data, inputs are declared with datatype and shape,
+ * so buffer of the final size is allocated for each of them. Each chunk may carry next parts of inputs data
+ * in raw_input_contents, with inputs entries naming inputs the parts belong to, and the parts are copied
+ * directly into the buffers. Completed buffers are registered as request regions of SharedMemoryRegistry
+ * and inputs reference them like inputs placed in shared memory, so blobs wrap the buffers without another copy.
+ * Regions are unregistered when the request is destroyed.
+ */
+class KFSChunkedRequest {
+public:
+    KFSChunkedRequest() = default;
+    ~KFSChunkedRequest();
+
+    KFSChunkedRequest(const KFSChunkedRequest&) = delete;
+    KFSChunkedRequest& operator=(const KFSChunkedRequest&) = delete;
+
+    /**
+     * @brief Adds next chunk of the request
+     *
+     * @param chunk
+     *
+     * @return KFS_INVALID_INPUT_CONTENTS if input cannot be uploaded in chunks or data exceeds its size
+     */
+    Status addChunk(const inference::ModelInferRequest& chunk);
+
+    /**
+     * @brief Checks if data of all inputs was received
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief Converts received request to PredictRequest, request has to outlive use of predictRequest
+     *
+     * @param predictRequest
+     *
+     * @return KFS_INVALID_INPUT_CONTENTS if data of some input is missing
+     */
+    Status complete(tensorflow::serving::PredictRequest& predictRequest);
+
+    /**
+     * @brief Gets the first chunk without input data, used to convert response
+     */
+    const inference::ModelInferRequest& getHeader() const {
+        return header;
+    }
+
+private:
+    struct InputBuffer {
+        std::shared_ptr<char> data;
+        size_t byteSize = 0;
+        size_t received = 0;
+    };
+
+    bool started = false;
+    inference::ModelInferRequest header;
+    std::map<std::string, InputBuffer> buffers;
+    std::vector<std::string> regionNames;
+
+    Status start(const inference::ModelInferRequest& chunk);
+};
+
+}  // namespace ovms
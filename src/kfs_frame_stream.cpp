@@ -0,0 +1,262 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "kfs_frame_stream.hpp"
+
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "kfs_batch_request.hpp"
+#include "kfs_grpc_inference_service.hpp"
+
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+namespace ovms {
+
+const std::string KFSFrameStream::MAX_FRAMES_IN_FLIGHT_PARAMETER = "max_frames_in_flight";
+const std::string KFSFrameStream::MAX_QUEUED_FRAMES_PARAMETER = "max_queued_frames";
+const std::string KFSFrameStream::OVERLOAD_POLICY_PARAMETER = "overload_policy";
+const std::string KFSFrameStream::FRAME_DROPPED_PARAMETER = "frame_dropped";
+
+static Status invalidStreamParameter(const std::string& details) {
+    SPDLOG_DEBUG("Invalid frame stream parameter - {}", details);
+    return Status(StatusCode::KFS_INVALID_STREAM_PARAMETER, details);
+}
+
+Status KFSFrameStreamOptions::parse(const inference::ModelInferRequest& request, KFSFrameStreamOptions& options) {
+    const auto& parameters = request.parameters();
+    for (const auto& [name, value] : {std::make_pair(&KFSFrameStream::MAX_FRAMES_IN_FLIGHT_PARAMETER, &options.maxFramesInFlight),
+             std::make_pair(&KFSFrameStream::MAX_QUEUED_FRAMES_PARAMETER, &options.maxQueuedFrames)}) {
+        auto it = parameters.find(*name);
+        if (it == parameters.end()) {
+            continue;
+        }
+        if (it->second.parameter_choice_case() != inference::InferParameter::kInt64Param ||
+            it->second.int64_param() < 1 || static_cast<uint64_t>(it->second.int64_param()) > MAX_FRAMES_LIMIT) {
+            return invalidStreamParameter(*name + " has to be int64 between 1 and " + std::to_string(MAX_FRAMES_LIMIT));
+        }
+        *value = static_cast<size_t>(it->second.int64_param());
+    }
+    auto it = parameters.find(KFSFrameStream::OVERLOAD_POLICY_PARAMETER);
+    if (it != parameters.end()) {
+        if (it->second.parameter_choice_case() == inference::InferParameter::kStringParam && it->second.string_param() == "drop_oldest") {
+            options.overloadPolicy = FrameOverloadPolicy::DROP_OLDEST;
+        } else if (it->second.parameter_choice_case() == inference::InferParameter::kStringParam && it->second.string_param() == "block") {
+            options.overloadPolicy = FrameOverloadPolicy::BLOCK;
+        } else {
+            return invalidStreamParameter(KFSFrameStream::OVERLOAD_POLICY_PARAMETER + " has to be drop_oldest or block");
+        }
+    }
+    return StatusCode::OK;
+}
+
+KFSFrameStream::KFSFrameStream(const KFSFrameStreamOptions& options, infer_t infer) :
+    options(options),
+    infer(std::move(infer)) {}
+
+KFSFrameStream::~KFSFrameStream() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this]() { return runningCount == 0; });
+}
+
+inference::ModelInferRequest& KFSFrameStream::prepareFrame() {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (!preparedFrame) {
+        if (idleFrames.empty()) {
+            preparedFrame = std::make_unique<Frame>();
+        } else {
+            preparedFrame = std::move(idleFrames.back());
+            idleFrames.pop_back();
+        }
+    }
+    return preparedFrame->request;
+}
+
+void KFSFrameStream::pushFrame() {
+    std::vector<Frame*> framesToStart;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!preparedFrame) {
+            return;
+        }
+        if (options.overloadPolicy == FrameOverloadPolicy::BLOCK) {
+            cv.wait(lock, [this]() { return queuedCount < options.maxQueuedFrames || cancelled; });
+        }
+        if (cancelled) {
+            idleFrames.push_back(std::move(preparedFrame));
+            return;
+        }
+        if (queuedCount >= options.maxQueuedFrames) {
+            for (auto& frame : frames) {
+                if (frame->state == FrameState::QUEUED) {
+                    SPDLOG_DEBUG("Dropping frame: {} of stream for model: {}, {} frames are waiting", frame->request.id(), frame->request.model_name(), queuedCount);
+                    frame->state = FrameState::DROPPED;
+                    --queuedCount;
+                    ++droppedCount;
+                    break;
+                }
+            }
+        }
+        preparedFrame->state = FrameState::QUEUED;
+        ++queuedCount;
+        frames.push_back(std::move(preparedFrame));
+        framesToStart = takeFramesToStart();
+    }
+    for (auto* frame : framesToStart) {
+        start(*frame);
+    }
+}
+
+void KFSFrameStream::close() {
+    std::unique_lock<std::mutex> lock(mtx);
+    closed = true;
+    cv.notify_all();
+}
+
+void KFSFrameStream::cancel() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cancelled = true;
+    for (auto& frame : frames) {
+        if (frame->state == FrameState::QUEUED) {
+            frame->state = FrameState::DROPPED;
+        }
+    }
+    queuedCount = 0;
+    cv.notify_all();
+}
+
+static void setResponseHeader(const inference::ModelInferRequest& request, inference::ModelInferResponse& response) {
+    response.set_model_name(request.model_name());
+    response.set_model_version(request.model_version());
+    response.set_id(request.id());
+}
+
+bool KFSFrameStream::nextResponse(inference::ModelInferResponse& response) {
+    std::unique_ptr<Frame> frame;
+    std::vector<Frame*> framesToStart;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() {
+            if (cancelled) {
+                return true;
+            }
+            if (frames.empty()) {
+                return closed;
+            }
+            return frames.front()->state == FrameState::DONE || frames.front()->state == FrameState::DROPPED;
+        });
+        if (cancelled || frames.empty()) {
+            return false;
+        }
+        frame = std::move(frames.front());
+        frames.pop_front();
+        if (frame->state == FrameState::DONE) {
+            --inFlightCount;
+            framesToStart = takeFramesToStart();
+        }
+    }
+    for (auto* frameToStart : framesToStart) {
+        start(*frameToStart);
+    }
+
+    response.Clear();
+    if (frame->state == FrameState::DROPPED) {
+        setResponseHeader(frame->request, response);
+        (*response.mutable_parameters())[FRAME_DROPPED_PARAMETER].set_bool_param(true);
+    } else {
+        auto status = frame->status;
+        if (status.ok()) {
+            status = KFSInferenceServiceImpl::convertResponse(frame->request, frame->predictResponse, response);
+        }
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Frame: {} of stream for model: {} failed: {}", frame->request.id(), frame->request.model_name(), status.string());
+            response.Clear();
+            setResponseHeader(frame->request, response);
+            (*response.mutable_parameters())[KFSBatchRequest::ERROR_PARAMETER].set_string_param(status.string());
+        }
+    }
+    recycle(std::move(frame));
+    return true;
+}
+
+size_t KFSFrameStream::getDroppedFramesCount() {
+    std::unique_lock<std::mutex> lock(mtx);
+    return droppedCount;
+}
+
+std::vector<KFSFrameStream::Frame*> KFSFrameStream::takeFramesToStart() {
+    std::vector<Frame*> framesToStart;
+    for (auto& frame : frames) {
+        if (inFlightCount >= options.maxFramesInFlight) {
+            break;
+        }
+        if (frame->state == FrameState::QUEUED) {
+            frame->state = FrameState::RUNNING;
+            --queuedCount;
+            ++inFlightCount;
+            ++runningCount;
+            framesToStart.push_back(frame.get());
+        }
+    }
+    if (!framesToStart.empty()) {
+        // frames blocked by full queue can be pushed
+        cv.notify_all();
+    }
+    return framesToStart;
+}
+
+void KFSFrameStream::start(Frame& frame) {
+    auto status = KFSInferenceServiceImpl::convertRequest(frame.request, frame.predictRequest);
+    // entries of inputs sent only in previous frames are left empty by conversion
+    auto& inputs = *frame.predictRequest.mutable_inputs();
+    for (auto it = inputs.begin(); it != inputs.end();) {
+        if (it->second.dtype() == tensorflow::DataType::DT_INVALID) {
+            it = inputs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!status.ok()) {
+        complete(frame, status);
+        return;
+    }
+    infer(&frame.predictRequest, &frame.predictResponse, [this, &frame](Status status) {
+        complete(frame, status);
+    });
+}
+
+void KFSFrameStream::complete(Frame& frame, const Status& status) {
+    std::unique_lock<std::mutex> lock(mtx);
+    frame.status = status;
+    frame.state = FrameState::DONE;
+    --runningCount;
+    cv.notify_all();
+}
+
+void KFSFrameStream::recycle(std::unique_ptr<Frame> frame) {
+    // input entries are kept with their buffers, conversion of the next frame assigns data into them
+    for (auto& [name, tensor] : *frame->predictRequest.mutable_inputs()) {
+        tensor.Clear();
+    }
+    frame->predictRequest.clear_model_spec();
+    frame->predictResponse.Clear();
+    frame->status = StatusCode::OK;
+    std::unique_lock<std::mutex> lock(mtx);
+    idleFrames.push_back(std::move(frame));
+}
+
+}  // namespace ovms
@@ -0,0 +1,166 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "src/kfserving_api/grpc_predict_v2.grpc.pb.h"
+#include "status.hpp"
+
+namespace ovms {
+
+enum class FrameOverloadPolicy {
+    DROP_OLDEST,
+    BLOCK
+};
+
+/**
+ * @brief Limits of frame stream, set by parameters of the first request
+ */
+struct KFSFrameStreamOptions {
+    static constexpr size_t DEFAULT_MAX_FRAMES_IN_FLIGHT = 2;
+    static constexpr size_t DEFAULT_MAX_QUEUED_FRAMES = 1;
+    // upper limit of both parameters, so that single stream does not take all resources
+    static constexpr size_t MAX_FRAMES_LIMIT = 64;
+
+    size_t maxFramesInFlight = DEFAULT_MAX_FRAMES_IN_FLIGHT;
+    size_t maxQueuedFrames = DEFAULT_MAX_QUEUED_FRAMES;
+    FrameOverloadPolicy overloadPolicy = FrameOverloadPolicy::DROP_OLDEST;
+
+    /**
+     * @brief Reads options from "max_frames_in_flight", "max_queued_frames" and "overload_policy" request parameters
+     *
+     * @return KFS_INVALID_STREAM_PARAMETER if parameter has wrong type or is out of range
+     */
+    static Status parse(const inference::ModelInferRequest& request, KFSFrameStreamOptions& options);
+};
+
+/**
+ * @brief Runs stream of independent requests, like video frames, through single model or pipeline
+ *
+ * Up to maxFramesInFlight frames are processed concurrently, frames arriving while all of them are busy wait in a queue.
+ * Once maxQueuedFrames frames wait, DROP_OLDEST policy drops the oldest waiting frame, so latency of camera feed
+ * stays bounded when the server cannot keep up, while BLOCK policy stops reading and slows the client down.
+ * Frames count as in flight until their responses are taken, so slow client is handled the same way as slow inference.
+ * Responses are returned in order of frames, dropped frames get response with "frame_dropped" parameter and failed frames
+ * with "error" parameter, without ending the stream.
+ * Messages of returned frames are reused for following frames together with their buffers.
+ */
+class KFSFrameStream {
+public:
+    static const std::string MAX_FRAMES_IN_FLIGHT_PARAMETER;
+    static const std::string MAX_QUEUED_FRAMES_PARAMETER;
+    static const std::string OVERLOAD_POLICY_PARAMETER;
+    static const std::string FRAME_DROPPED_PARAMETER;
+
+    using infer_t = std::function<void(const tensorflow::serving::PredictRequest*, tensorflow::serving::PredictResponse*, std::function<void(Status)>)>;
+
+    /**
+     * @param infer starts asynchronous inference of frame, completion callback may also be called before it returns
+     */
+    KFSFrameStream(const KFSFrameStreamOptions& options, infer_t infer);
+
+    /**
+     * @brief Waits for frames being processed
+     */
+    ~KFSFrameStream();
+
+    KFSFrameStream(const KFSFrameStream&) = delete;
+    KFSFrameStream& operator=(const KFSFrameStream&) = delete;
+
+    /**
+     * @brief Gets message for the next frame to be read into, it is queued by pushFrame
+     */
+    inference::ModelInferRequest& prepareFrame();
+
+    /**
+     * @brief Queues prepared frame and starts it if fewer than maxFramesInFlight frames are in flight
+     *
+     * Waits while the queue is full with BLOCK policy.
+     */
+    void pushFrame();
+
+    /**
+     * @brief Marks that no more frames will be pushed
+     */
+    void close();
+
+    /**
+     * @brief Stops returning responses and drops waiting frames, used once responses cannot be delivered
+     */
+    void cancel();
+
+    /**
+     * @brief Waits for response of the next frame
+     *
+     * @return false once the stream is closed and all responses were returned, or it was cancelled
+     */
+    bool nextResponse(inference::ModelInferResponse& response);
+
+    size_t getDroppedFramesCount();
+
+private:
+    enum class FrameState {
+        QUEUED,
+        RUNNING,
+        DONE,
+        DROPPED
+    };
+
+    struct Frame {
+        inference::ModelInferRequest request;
+        tensorflow::serving::PredictRequest predictRequest;
+        tensorflow::serving::PredictResponse predictResponse;
+        Status status;
+        FrameState state = FrameState::QUEUED;
+    };
+
+    std::vector<Frame*> takeFramesToStart();
+    void start(Frame& frame);
+    void complete(Frame& frame, const Status& status);
+    void recycle(std::unique_ptr<Frame> frame);
+
+    const KFSFrameStreamOptions options;
+    const infer_t infer;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    // frames in order of arrival, the first one gets the next response
+    std::deque<std::unique_ptr<Frame>> frames;
+    std::vector<std::unique_ptr<Frame>> idleFrames;
+    std::unique_ptr<Frame> preparedFrame;
+    size_t queuedCount = 0;
+    // started frames with responses not taken yet
+    size_t inFlightCount = 0;
+    // frames with inference not completed yet
+    size_t runningCount = 0;
+    size_t droppedCount = 0;
+    bool closed = false;
+    bool cancelled = false;
+};
+
+}  // namespace ovms
@@ -0,0 +1,607 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "kfs_grpc_inference_service.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+#include "blob_arena.hpp"
+#include "exit_node.hpp"
+#include "kfs_batch_request.hpp"
+#include "kfs_chunked_request.hpp"
+#include "kfs_frame_stream.hpp"
+#include "kfs_utils.hpp"
+#include "modelinstance.hpp"
+#include "modelmanager.hpp"
+#include "pipeline.hpp"
+#include "pipeline_executor.hpp"
+#include "pipeline_factory.hpp"
+#include "pipelinedefinition.hpp"
+#include "prediction_service.hpp"
+#include "statefulmodelinstance.hpp"
+#include "timer.hpp"
+#include "tracing.hpp"
+
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+namespace ovms {
+
+enum : size_t {
+    TOTAL,
+    TIMER_END
+};
+
+template <typename T, typename Values>
+static void packValues(const Values& values, std::string& content) {
+    content.resize(values.size() * sizeof(T));
+    T* destination = reinterpret_cast<T*>(content.data());
+    for (int i = 0; i < values.size(); ++i) {
+        destination[i] = static_cast<T>(values.Get(i));
+    }
+}
+
+static Status setTensorProtoContents(tensorflow::TensorProto& tensor, const std::string& datatype, const inference::InferTensorContents& contents) {
+    auto& content = *tensor.mutable_tensor_content();
+    switch (tensor.dtype()) {
+    case tensorflow::DataType::DT_FLOAT:
+        packValues<float>(contents.fp32_contents(), content);
+        break;
+    case tensorflow::DataType::DT_DOUBLE:
+        packValues<double>(contents.fp64_contents(), content);
+        break;
+    case tensorflow::DataType::DT_INT8:
+        packValues<int8_t>(contents.int_contents(), content);
+        break;
+    case tensorflow::DataType::DT_INT16:
+        packValues<int16_t>(contents.int_contents(), content);
+        break;
+    case tensorflow::DataType::DT_INT32:
+        packValues<int32_t>(contents.int_contents(), content);
+        break;
+    case tensorflow::DataType::DT_INT64:
+        packValues<int64_t>(contents.int64_contents(), content);
+        break;
+    case tensorflow::DataType::DT_UINT8:
+        packValues<uint8_t>(contents.uint_contents(), content);
+        break;
+    case tensorflow::DataType::DT_UINT16:
+        // Validation expects U16 values in int_val
+        for (auto value : contents.uint_contents()) {
+            tensor.add_int_val(static_cast<uint16_t>(value));
+        }
+        break;
+    case tensorflow::DataType::DT_UINT32:
+        packValues<uint32_t>(contents.uint_contents(), content);
+        break;
+    case tensorflow::DataType::DT_UINT64:
+        packValues<uint64_t>(contents.uint64_contents(), content);
+        break;
+    case tensorflow::DataType::DT_BOOL:
+        packValues<uint8_t>(contents.bool_contents(), content);
+        break;
+    case tensorflow::DataType::DT_STRING:
+        for (const auto& value : contents.bytes_contents()) {
+            tensor.add_string_val(value);
+        }
+        break;
+    default:
+        SPDLOG_DEBUG("Datatype: {} has to be sent in raw_input_contents", datatype);
+        return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+    }
+    return StatusCode::OK;
+}
+
+Status KFSInferenceServiceImpl::convertRequest(const inference::ModelInferRequest& request, PredictRequest& predictRequest) {
+    model_version_t modelVersion;
+    auto status = parseKFSModelVersion(request.model_version(), modelVersion);
+    if (!status.ok()) {
+        return status;
+    }
+    predictRequest.mutable_model_spec()->set_name(request.model_name());
+    if (modelVersion != 0) {
+        predictRequest.mutable_model_spec()->mutable_version()->set_value(modelVersion);
+    }
+
+    const bool rawContents = request.raw_input_contents_size() > 0;
+    if (rawContents && request.raw_input_contents_size() != request.inputs_size()) {
+        SPDLOG_DEBUG("Request has {} inputs but {} raw_input_contents", request.inputs_size(), request.raw_input_contents_size());
+        return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+    }
+    for (int i = 0; i < request.inputs_size(); ++i) {
+        const auto& input = request.inputs(i);
+        auto& tensor = (*predictRequest.mutable_inputs())[input.name()];
+        tensorflow::DataType dtype;
+        status = convertKFSDataTypeToTensorflow(input.datatype(), dtype);
+        if (!status.ok()) {
+            return status;
+        }
+        tensor.set_dtype(dtype);
+        for (auto dim : input.shape()) {
+            if (dim < 0) {
+                return StatusCode::INVALID_SHAPE;
+            }
+            tensor.mutable_tensor_shape()->add_dim()->set_size(dim);
+        }
+        if (rawContents) {
+            const auto& raw = request.raw_input_contents(i);
+            status = setTensorProtoRawContent(tensor, raw.data(), raw.size());
+        } else {
+            status = setTensorProtoContents(tensor, input.datatype(), input.contents());
+        }
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Invalid contents of input: {}", input.name());
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+static Status addOutput(const std::string& name, tensorflow::TensorProto& tensor, inference::ModelInferResponse& response) {
+    auto* output = response.add_outputs();
+    output->set_name(name);
+    std::string datatype;
+    auto status = getKFSDataType(tensor, datatype);
+    if (!status.ok()) {
+        return status;
+    }
+    output->set_datatype(datatype);
+    for (const auto& dim : tensor.tensor_shape().dim()) {
+        output->add_shape(dim.size());
+    }
+    response.add_raw_output_contents()->swap(*tensor.mutable_tensor_content());
+    return StatusCode::OK;
+}
+
+Status KFSInferenceServiceImpl::convertResponse(const inference::ModelInferRequest& request, PredictResponse& predictResponse, inference::ModelInferResponse& response) {
+    if (predictResponse.has_model_spec()) {
+        // request was served by fallback model of overloaded requested model
+        response.set_model_name(predictResponse.model_spec().name());
+        response.set_model_version(std::to_string(predictResponse.model_spec().version().value()));
+    } else {
+        response.set_model_name(request.model_name());
+        response.set_model_version(request.model_version());
+    }
+    response.set_id(request.id());
+    auto& outputs = *predictResponse.mutable_outputs();
+    if (request.outputs_size() == 0) {
+        for (auto& [name, tensor] : outputs) {
+            auto status = addOutput(name, tensor, response);
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        return StatusCode::OK;
+    }
+    for (const auto& requestedOutput : request.outputs()) {
+        auto it = outputs.find(requestedOutput.name());
+        if (it == outputs.end()) {
+            SPDLOG_DEBUG("Requested output: {} was not produced", requestedOutput.name());
+            return StatusCode::INVALID_MISSING_OUTPUT;
+        }
+        auto status = addOutput(it->first, it->second, response);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status KFSInferenceServiceImpl::convertPartialResponse(const inference::ModelInferRequest& request, const std::string& nodeName, uint64_t shardId, PredictResponse& partialResponse, inference::ModelInferResponse& response) {
+    response.set_model_name(request.model_name());
+    response.set_model_version(request.model_version());
+    response.set_id(request.id());
+    (*response.mutable_parameters())["node_name"].set_string_param(nodeName);
+    (*response.mutable_parameters())["shard_id"].set_int64_param(shardId);
+    auto& outputs = *partialResponse.mutable_outputs();
+    if (request.outputs_size() == 0) {
+        for (auto& [name, tensor] : outputs) {
+            auto status = addOutput(name, tensor, response);
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        return StatusCode::OK;
+    }
+    for (const auto& requestedOutput : request.outputs()) {
+        auto it = outputs.find(requestedOutput.name());
+        if (it == outputs.end()) {
+            continue;
+        }
+        auto status = addOutput(it->first, it->second, response);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status KFSInferenceServiceImpl::getSequenceParameters(const inference::ModelInferRequest& request, uint64_t& sequenceId, bool& sequenceEnd) {
+    sequenceEnd = false;
+    auto it = request.parameters().find("sequence_id");
+    if (it != request.parameters().end()) {
+        if (it->second.parameter_choice_case() != inference::InferParameter::kInt64Param || it->second.int64_param() < 0) {
+            return StatusCode::SEQUENCE_ID_BAD_TYPE;
+        }
+        sequenceId = it->second.int64_param();
+    }
+    it = request.parameters().find("sequence_end");
+    if (it != request.parameters().end()) {
+        if (it->second.parameter_choice_case() != inference::InferParameter::kBoolParam) {
+            return StatusCode::SEQUENCE_CONTROL_INPUT_BAD_TYPE;
+        }
+        sequenceEnd = it->second.bool_param();
+    }
+    return StatusCode::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ServerLive(grpc::ServerContext* context, const inference::ServerLiveRequest* request, inference::ServerLiveResponse* response) {
+    response->set_live(true);
+    return grpc::Status::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ServerReady(grpc::ServerContext* context, const inference::ServerReadyRequest* request, inference::ServerReadyResponse* response) {
+    response->set_ready(ModelManager::getInstance().isReady());
+    return grpc::Status::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ModelReady(grpc::ServerContext* context, const inference::ModelReadyRequest* request, inference::ModelReadyResponse* response) {
+    model_version_t modelVersion;
+    auto status = parseKFSModelVersion(request->version(), modelVersion);
+    if (!status.ok()) {
+        return status.grpc();
+    }
+    auto& manager = ModelManager::getInstance();
+    auto model = manager.findModelByName(request->name());
+    if (model) {
+        auto instance = modelVersion != 0 ? model->getModelInstanceByVersion(modelVersion) : model->getDefaultModelInstance();
+        if (!instance) {
+            return Status(StatusCode::MODEL_VERSION_MISSING).grpc();
+        }
+        response->set_ready(instance->getStatus().getState() == ModelVersionState::AVAILABLE);
+        return grpc::Status::OK;
+    }
+    auto pipelineDefinition = manager.getPipelineFactory().findDefinitionByName(request->name());
+    if (!pipelineDefinition) {
+        if (manager.isModelLoadPending(request->name())) {
+            response->set_ready(false);
+            return grpc::Status::OK;
+        }
+        return Status(StatusCode::MODEL_NAME_MISSING).grpc();
+    }
+    response->set_ready(pipelineDefinition->getStateCode() == PipelineDefinitionStateCode::AVAILABLE);
+    return grpc::Status::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ModelInfer(grpc::ServerContext* context, const inference::ModelInferRequest* request, inference::ModelInferResponse* response) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
+    using std::chrono::microseconds;
+    SPDLOG_DEBUG("Processing KServe gRPC request for model: {}; version: {}", request->model_name(), request->model_version());
+    auto requestContext = PredictionServiceImpl::getRequestContext(context);
+    Span requestSpan(requestContext.trace, "kfs grpc infer");
+    requestSpan.setAttribute("model", request->model_name());
+    requestSpan.setAttribute("version", request->model_version());
+    requestContext.trace = requestSpan.getContext();
+
+    PredictRequest predictRequest;
+    PredictResponse predictResponse;
+    Span parseSpan(requestContext.trace, "parse");
+    auto status = convertRequest(*request, predictRequest);
+    parseSpan.setStatus(status);
+    parseSpan.end();
+    if (!status.ok()) {
+        requestSpan.setStatus(status);
+        return status.grpc();
+    }
+    status = PredictionServiceImpl::infer(&predictRequest, &predictResponse, requestContext);
+    if (!status.ok()) {
+        requestSpan.setStatus(status);
+        return status.grpc();
+    }
+    status = convertResponse(*request, predictResponse, *response);
+    if (!status.ok()) {
+        requestSpan.setStatus(status);
+        return status.grpc();
+    }
+    if (context != nullptr && predictResponse.has_model_spec()) {
+        context->AddInitialMetadata(FALLBACK_MODEL_HEADER, response->model_name());
+        context->AddInitialMetadata(FALLBACK_MODEL_VERSION_HEADER, response->model_version());
+    }
+
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total KServe gRPC request processing time: {} ms", timer.elapsed<microseconds>(TOTAL) / 1000);
+    return grpc::Status::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ModelInferStream(grpc::ServerContext* context, const inference::ModelInferRequest* request, grpc::ServerWriter<inference::ModelInferResponse>* writer) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
+    using std::chrono::microseconds;
+    SPDLOG_DEBUG("Processing KServe gRPC streaming request for model: {}; version: {}", request->model_name(), request->model_version());
+
+    PredictRequest predictRequest;
+    PredictResponse predictResponse;
+    auto status = convertRequest(*request, predictRequest);
+    if (!status.ok()) {
+        return status.grpc();
+    }
+    auto& manager = ModelManager::getInstance();
+    if (manager.findModelByName(request->model_name()) || !manager.pipelineDefinitionExists(request->model_name())) {
+        // models produce all outputs at once
+        inference::ModelInferResponse response;
+        status = PredictionServiceImpl::infer(&predictRequest, &predictResponse, PredictionServiceImpl::getRequestContext(context));
+        if (!status.ok()) {
+            return status.grpc();
+        }
+        status = convertResponse(*request, predictResponse, response);
+        if (!status.ok()) {
+            return status.grpc();
+        }
+        writer->Write(response);
+        return grpc::Status::OK;
+    }
+    std::unique_ptr<Pipeline> pipeline;
+    status = manager.getPipeline(pipeline, &predictRequest, &predictResponse);
+    if (!status.ok()) {
+        return status.grpc();
+    }
+    pipeline->getExit().setPartialOutputsCallback([request, writer](const std::string& nodeName, session_id_t shardId, PredictResponse& partialResponse) -> Status {
+        inference::ModelInferResponse response;
+        auto status = convertPartialResponse(*request, nodeName, shardId, partialResponse, response);
+        if (!status.ok()) {
+            return status;
+        }
+        if (response.outputs_size() == 0) {
+            return StatusCode::OK;
+        }
+        if (!writer->Write(response)) {
+            SPDLOG_DEBUG("Failed to write partial response of node: {} shard: {}, stream is closed", nodeName, shardId);
+            return StatusCode::REQUEST_CANCELLED;
+        }
+        return StatusCode::OK;
+    });
+    status = pipeline->execute(PredictionServiceImpl::getRequestContext(context));
+    if (!status.ok()) {
+        return status.grpc();
+    }
+
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total KServe gRPC streaming request processing time: {} ms", timer.elapsed<microseconds>(TOTAL) / 1000);
+    return grpc::Status::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ModelInferUpload(grpc::ServerContext* context, grpc::ServerReader<inference::ModelInferRequest>* reader, inference::ModelInferResponse* response) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
+    using std::chrono::microseconds;
+
+    KFSChunkedRequest chunkedRequest;
+    inference::ModelInferRequest chunk;
+    // inference starts with the last chunk, without waiting for the client to close the stream
+    while (!chunkedRequest.isComplete() && reader->Read(&chunk)) {
+        auto status = chunkedRequest.addChunk(chunk);
+        if (!status.ok()) {
+            return status.grpc();
+        }
+    }
+    const auto& request = chunkedRequest.getHeader();
+    SPDLOG_DEBUG("Processing KServe gRPC upload request for model: {}; version: {}", request.model_name(), request.model_version());
+
+    PredictRequest predictRequest;
+    PredictResponse predictResponse;
+    auto status = chunkedRequest.complete(predictRequest);
+    if (!status.ok()) {
+        return status.grpc();
+    }
+    status = PredictionServiceImpl::infer(&predictRequest, &predictResponse, PredictionServiceImpl::getRequestContext(context));
+    if (!status.ok()) {
+        return status.grpc();
+    }
+    status = convertResponse(request, predictResponse, *response);
+    if (!status.ok()) {
+        return status.grpc();
+    }
+
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total KServe gRPC upload request processing time: {} ms", timer.elapsed<microseconds>(TOTAL) / 1000);
+    return grpc::Status::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ModelInferBatch(grpc::ServerContext* context, const inference::ModelInferBatchRequest* request, inference::ModelInferBatchResponse* response) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
+    using std::chrono::microseconds;
+    SPDLOG_DEBUG("Processing KServe gRPC batch of {} requests", request->requests_size());
+
+    KFSBatchRequest batchRequest(*request);
+    auto status = batchRequest.infer(*response, PredictionServiceImpl::getRequestContext(context));
+    if (!status.ok()) {
+        return status.grpc();
+    }
+
+    timer.stop(TOTAL);
+    SPDLOG_DEBUG("Total KServe gRPC batch request processing time: {} ms", timer.elapsed<microseconds>(TOTAL) / 1000);
+    return grpc::Status::OK;
+}
+
+static Status getStatefulModelInstance(const PredictRequest& predictRequest, std::shared_ptr<ModelInstance>& modelInstance,
+    StatefulModelInstance*& statefulModelInstance, std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuard) {
+    auto status = ModelManager::getInstance().getModelInstance(predictRequest.model_spec().name(), predictRequest.model_spec().version().value(), modelInstance, modelInstanceUnloadGuard);
+    if (!status.ok()) {
+        return status;
+    }
+    statefulModelInstance = dynamic_cast<StatefulModelInstance*>(modelInstance.get());
+    if (!statefulModelInstance) {
+        return StatusCode::SEQUENCE_STREAM_STATELESS_MODEL;
+    }
+    return StatusCode::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ModelSequenceStream(grpc::ServerContext* context, grpc::ServerReaderWriter<inference::ModelInferResponse, inference::ModelInferRequest>* stream) {
+    using std::chrono::microseconds;
+    const RequestContext requestContext = PredictionServiceImpl::getRequestContext(context);
+    // Model version is resolved by the first request, later steps must run on the same instance as the sequence state
+    model_version_t modelVersion = 0;
+    StreamedSequence streamedSequence;
+    std::shared_ptr<ModelInstance> modelInstance;
+    StatefulModelInstance* statefulModelInstance = nullptr;
+    // Sequence is ended when the stream is closed or fails, instead of waiting for idle sequence cleanup
+    auto endSequence = [&]() {
+        if (!streamedSequence.sequence) {
+            return;
+        }
+        std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+        PredictRequest predictRequest;
+        predictRequest.mutable_model_spec()->set_name(modelInstance->getName());
+        predictRequest.mutable_model_spec()->mutable_version()->set_value(modelVersion);
+        if (getStatefulModelInstance(predictRequest, modelInstance, statefulModelInstance, modelInstanceUnloadGuard).ok()) {
+            statefulModelInstance->endStreamedSequence(streamedSequence);
+        }
+    };
+
+    inference::ModelInferRequest request;
+    while (stream->Read(&request)) {
+        Timer<TIMER_END> timer;
+        timer.start(TOTAL);
+        SPDLOG_DEBUG("Processing KServe gRPC sequence stream request for model: {}; version: {}", request.model_name(), request.model_version());
+
+        PredictRequest predictRequest;
+        PredictResponse predictResponse;
+        auto status = convertRequest(request, predictRequest);
+        // sequence_id is used only by the request starting the sequence
+        uint64_t requestedSequenceId = 0;
+        bool sequenceEnd = false;
+        if (status.ok()) {
+            status = getSequenceParameters(request, requestedSequenceId, sequenceEnd);
+        }
+        if (!status.ok()) {
+            endSequence();
+            return status.grpc();
+        }
+        if (modelVersion != 0) {
+            predictRequest.mutable_model_spec()->mutable_version()->set_value(modelVersion);
+        }
+        std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+        status = getStatefulModelInstance(predictRequest, modelInstance, statefulModelInstance, modelInstanceUnloadGuard);
+        if (!status.ok()) {
+            // without unload guard sequence is dropped together with the model
+            return status.grpc();
+        }
+        modelVersion = modelInstance->getVersion();
+        if (!streamedSequence.sequence) {
+            streamedSequence.sequenceId = requestedSequenceId;
+        }
+        status = statefulModelInstance->inferStreamed(&predictRequest, &predictResponse, streamedSequence, sequenceEnd, requestContext);
+        const uint64_t sequenceId = streamedSequence.sequenceId;
+        if (!status.ok()) {
+            statefulModelInstance->endStreamedSequence(streamedSequence);
+            return status.grpc();
+        }
+        modelInstanceUnloadGuard.reset();
+
+        // sequence id is returned as response parameter
+        predictResponse.mutable_outputs()->erase("sequence_id");
+        inference::ModelInferResponse response;
+        status = convertResponse(request, predictResponse, response);
+        if (!status.ok()) {
+            endSequence();
+            return status.grpc();
+        }
+        (*response.mutable_parameters())["sequence_id"].set_int64_param(sequenceId);
+        if (!stream->Write(response)) {
+            SPDLOG_DEBUG("Failed to write response of sequence: {}, stream is closed", sequenceId);
+            endSequence();
+            return Status(StatusCode::REQUEST_CANCELLED).grpc();
+        }
+        if (sequenceEnd) {
+            modelVersion = 0;
+        }
+
+        timer.stop(TOTAL);
+        SPDLOG_DEBUG("Total KServe gRPC sequence stream request processing time: {} ms", timer.elapsed<microseconds>(TOTAL) / 1000);
+    }
+    endSequence();
+    return grpc::Status::OK;
+}
+
+grpc::Status KFSInferenceServiceImpl::ModelFrameStream(grpc::ServerContext* context, grpc::ServerReaderWriter<inference::ModelInferResponse, inference::ModelInferRequest>* stream) {
+    const RequestContext requestContext = PredictionServiceImpl::getRequestContext(context);
+    inference::ModelInferRequest firstRequest;
+    if (!stream->Read(&firstRequest)) {
+        return grpc::Status::OK;
+    }
+    SPDLOG_DEBUG("Processing KServe gRPC frame stream for model: {}; version: {}", firstRequest.model_name(), firstRequest.model_version());
+    KFSFrameStreamOptions options;
+    auto status = KFSFrameStreamOptions::parse(firstRequest, options);
+    if (!status.ok()) {
+        return status.grpc();
+    }
+
+    KFSFrameStream::infer_t infer;
+    auto& manager = ModelManager::getInstance();
+    if (manager.findModelByName(firstRequest.model_name()) || !manager.pipelineDefinitionExists(firstRequest.model_name())) {
+        infer = [requestContext](const PredictRequest* request, PredictResponse* response, std::function<void(Status)> onCompleted) {
+            PredictionServiceImpl::inferAsync(request, response, requestContext, std::move(onCompleted));
+        };
+    } else {
+        // definition is resolved once for the stream, intermediate blobs of its frames reuse arenas owned by the stream
+        auto* pipelineDefinition = manager.getPipelineFactory().findDefinitionByName(firstRequest.model_name());
+        auto arenaPool = std::make_shared<BlobArenaPool>(BlobArenaPool::DEFAULT_INITIAL_BLOCK_SIZE, options.maxFramesInFlight);
+        infer = [pipelineDefinition, arenaPool, requestContext, &manager](const PredictRequest* request, PredictResponse* response, std::function<void(Status)> onCompleted) {
+            std::unique_ptr<Pipeline> pipeline;
+            auto status = pipelineDefinition->create(pipeline, request, response, manager, arenaPool);
+            if (!status.ok()) {
+                onCompleted(status);
+                return;
+            }
+            PipelineExecutor::getInstance().execute(std::move(pipeline), requestContext, std::move(onCompleted));
+        };
+    }
+
+    const std::string modelName = firstRequest.model_name();
+    KFSFrameStream frameStream(options, std::move(infer));
+    frameStream.prepareFrame().Swap(&firstRequest);
+    frameStream.pushFrame();
+    // responses are written by separate thread, so that frames are read while earlier ones are processed
+    std::atomic<bool> writeFailed{false};
+    std::thread writer([&frameStream, &writeFailed, stream]() {
+        inference::ModelInferResponse response;
+        while (frameStream.nextResponse(response)) {
+            if (!stream->Write(response)) {
+                writeFailed = true;
+                frameStream.cancel();
+                return;
+            }
+        }
+    });
+    while (!writeFailed && stream->Read(&frameStream.prepareFrame())) {
+        frameStream.pushFrame();
+    }
+    frameStream.close();
+    writer.join();
+    SPDLOG_DEBUG("KServe gRPC frame stream for model: {} ended, dropped frames: {}", modelName, frameStream.getDroppedFramesCount());
+    if (writeFailed) {
+        return Status(StatusCode::REQUEST_CANCELLED).grpc();
+    }
+    return grpc::Status::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,100 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/sync_stream.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "src/kfserving_api/grpc_predict_v2.grpc.pb.h"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Serves KServe v2 inference protocol
+ *
+ * ModelInfer is translated to PredictRequest and executed the same way as TensorFlow Serving Predict,
+ * so models and pipelines are served by both APIs. Raw input and output contents are passed
+ * as tensor_content without parsing values.
+ */
+class KFSInferenceServiceImpl final : public inference::GRPCInferenceService::Service {
+public:
+    grpc::Status ServerLive(grpc::ServerContext* context, const inference::ServerLiveRequest* request, inference::ServerLiveResponse* response) override;
+    grpc::Status ServerReady(grpc::ServerContext* context, const inference::ServerReadyRequest* request, inference::ServerReadyResponse* response) override;
+    grpc::Status ModelReady(grpc::ServerContext* context, const inference::ModelReadyRequest* request, inference::ModelReadyResponse* response) override;
+    grpc::Status ModelInfer(grpc::ServerContext* context, const inference::ModelInferRequest* request, inference::ModelInferResponse* response) override;
+    grpc::Status ModelInferStream(grpc::ServerContext* context, const inference::ModelInferRequest* request, grpc::ServerWriter<inference::ModelInferResponse>* writer) override;
+    grpc::Status ModelInferUpload(grpc::ServerContext* context, grpc::ServerReader<inference::ModelInferRequest>* reader, inference::ModelInferResponse* response) override;
+    grpc::Status ModelInferBatch(grpc::ServerContext* context, const inference::ModelInferBatchRequest* request, inference::ModelInferBatchResponse* response) override;
+    grpc::Status ModelSequenceStream(grpc::ServerContext* context, grpc::ServerReaderWriter<inference::ModelInferResponse, inference::ModelInferRequest>* stream) override;
+    grpc::Status ModelFrameStream(grpc::ServerContext* context, grpc::ServerReaderWriter<inference::ModelInferResponse, inference::ModelInferRequest>* stream) override;
+
+    /**
+     * @brief Converts ModelInferRequest to PredictRequest
+     *
+     * @param request
+     * @param predictRequest
+     *
+     * @return Status
+     */
+    static Status convertRequest(const inference::ModelInferRequest& request, tensorflow::serving::PredictRequest& predictRequest);
+
+    /**
+     * @brief Moves outputs of PredictResponse to raw_output_contents of ModelInferResponse
+     *
+     * @param request used to select requested outputs and echo model name, version and id
+     * @param predictResponse
+     * @param response
+     *
+     * @return INVALID_MISSING_OUTPUT if requested output was not produced
+     */
+    static Status convertResponse(const inference::ModelInferRequest& request, tensorflow::serving::PredictResponse& predictResponse, inference::ModelInferResponse& response);
+
+    /**
+     * @brief Moves outputs of single pipeline node session to streamed ModelInferResponse
+     *
+     * Outputs not requested are skipped, requested outputs may be missing since they are produced by other sessions.
+     *
+     * @param request
+     * @param nodeName set as node_name response parameter
+     * @param shardId set as shard_id response parameter
+     * @param partialResponse
+     * @param response
+     *
+     * @return Status
+     */
+    static Status convertPartialResponse(const inference::ModelInferRequest& request, const std::string& nodeName, uint64_t shardId, tensorflow::serving::PredictResponse& partialResponse, inference::ModelInferResponse& response);
+
+    /**
+     * @brief Reads sequence_id and sequence_end parameters of sequence stream request
+     *
+     * @param request
+     * @param sequenceId left unchanged if parameter is not set
+     * @param sequenceEnd
+     *
+     * @return SEQUENCE_ID_BAD_TYPE or SEQUENCE_CONTROL_INPUT_BAD_TYPE if parameter has wrong type
+     */
+    static Status getSequenceParameters(const inference::ModelInferRequest& request, uint64_t& sequenceId, bool& sequenceEnd);
+};
+
+}  // namespace ovms
@@ -0,0 +1,427 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "kfs_rest_parser.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+
+#include "deserialization.hpp"
+#include "kfs_utils.hpp"
+
+namespace ovms {
+
+using json_writer_t = rapidjson::Writer<rapidjson::StringBuffer, rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag>;
+
+static bool getBoolParameter(const rapidjson::Value& object, const char* name, bool defaultValue) {
+    auto parametersItr = object.FindMember("parameters");
+    if (parametersItr == object.MemberEnd() || !parametersItr->value.IsObject()) {
+        return defaultValue;
+    }
+    auto parameterItr = parametersItr->value.FindMember(name);
+    if (parameterItr == parametersItr->value.MemberEnd() || !parameterItr->value.IsBool()) {
+        return defaultValue;
+    }
+    return parameterItr->value.GetBool();
+}
+
+template <typename T>
+static bool getValue(const rapidjson::Value& value, T& result) {
+    if constexpr (std::is_same_v<T, bool>) {
+        if (!value.IsBool()) {
+            return false;
+        }
+        result = value.GetBool();
+    } else if constexpr (std::is_floating_point_v<T>) {
+        if (!value.IsNumber()) {
+            return false;
+        }
+        result = static_cast<T>(value.GetDouble());
+    } else if constexpr (std::is_signed_v<T>) {
+        if (!value.IsInt64() ||
+            value.GetInt64() < std::numeric_limits<T>::min() ||
+            value.GetInt64() > std::numeric_limits<T>::max()) {
+            return false;
+        }
+        result = static_cast<T>(value.GetInt64());
+    } else {
+        if (!value.IsUint64() || value.GetUint64() > std::numeric_limits<T>::max()) {
+            return false;
+        }
+        result = static_cast<T>(value.GetUint64());
+    }
+    return true;
+}
+
+/**
+ * @brief Flattens nested arrays of values in row major order
+ */
+template <typename T>
+static bool appendValues(const rapidjson::Value& value, std::vector<T>& values) {
+    if (value.IsArray()) {
+        for (const auto& element : value.GetArray()) {
+            if (!appendValues(element, values)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    T result;
+    if (!getValue(value, result)) {
+        return false;
+    }
+    values.push_back(result);
+    return true;
+}
+
+template <typename T, typename StoredT = T>
+static Status setTensorContent(const rapidjson::Value& data, tensorflow::TensorProto& tensor) {
+    std::vector<T> values;
+    if (!appendValues(data, values)) {
+        return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+    }
+    auto& content = *tensor.mutable_tensor_content();
+    content.resize(values.size() * sizeof(StoredT));
+    StoredT* destination = reinterpret_cast<StoredT*>(content.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+        destination[i] = static_cast<StoredT>(values[i]);
+    }
+    return StatusCode::OK;
+}
+
+static bool appendStrings(const rapidjson::Value& value, tensorflow::TensorProto& tensor) {
+    if (value.IsArray()) {
+        for (const auto& element : value.GetArray()) {
+            if (!appendStrings(element, tensor)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (!value.IsString()) {
+        return false;
+    }
+    tensor.add_string_val(value.GetString(), value.GetStringLength());
+    return true;
+}
+
+static Status setTensorData(const rapidjson::Value& data, tensorflow::TensorProto& tensor) {
+    switch (tensor.dtype()) {
+    case tensorflow::DataType::DT_FLOAT:
+        return setTensorContent<float>(data, tensor);
+    case tensorflow::DataType::DT_DOUBLE:
+        return setTensorContent<double>(data, tensor);
+    case tensorflow::DataType::DT_INT8:
+        return setTensorContent<int8_t>(data, tensor);
+    case tensorflow::DataType::DT_INT16:
+        return setTensorContent<int16_t>(data, tensor);
+    case tensorflow::DataType::DT_INT32:
+        return setTensorContent<int32_t>(data, tensor);
+    case tensorflow::DataType::DT_INT64:
+        return setTensorContent<int64_t>(data, tensor);
+    case tensorflow::DataType::DT_UINT8:
+        return setTensorContent<uint8_t>(data, tensor);
+    case tensorflow::DataType::DT_UINT32:
+        return setTensorContent<uint32_t>(data, tensor);
+    case tensorflow::DataType::DT_UINT64:
+        return setTensorContent<uint64_t>(data, tensor);
+    case tensorflow::DataType::DT_BOOL:
+        return setTensorContent<bool, uint8_t>(data, tensor);
+    case tensorflow::DataType::DT_UINT16: {
+        // Validation expects U16 values in int_val
+        std::vector<uint16_t> values;
+        if (!appendValues(data, values)) {
+            return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+        }
+        for (auto value : values) {
+            tensor.add_int_val(value);
+        }
+        return StatusCode::OK;
+    }
+    case tensorflow::DataType::DT_HALF: {
+        std::vector<float> values;
+        if (!appendValues(data, values)) {
+            return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+        }
+        auto& content = *tensor.mutable_tensor_content();
+        content.resize(values.size() * sizeof(uint16_t));
+        convertFromFp32(InferenceEngine::Precision::FP16, values.data(), content.data(), values.size());
+        return StatusCode::OK;
+    }
+    case tensorflow::DataType::DT_STRING:
+        if (!appendStrings(data, tensor)) {
+            return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+        }
+        return StatusCode::OK;
+    default:
+        return StatusCode::KFS_UNSUPPORTED_DATATYPE;
+    }
+}
+
+Status KFSRestParser::parse(const std::string& body) {
+    rapidjson::Document doc;
+    rapidjson::StringStream stream(body.c_str());
+    // Parsing stops at the end of JSON header, binary data may follow
+    doc.ParseStream<rapidjson::kParseStopWhenDoneFlag>(stream);
+    if (doc.HasParseError()) {
+        return StatusCode::JSON_INVALID;
+    }
+    if (!doc.IsObject()) {
+        return StatusCode::REST_BODY_IS_NOT_AN_OBJECT;
+    }
+    auto idItr = doc.FindMember("id");
+    if (idItr != doc.MemberEnd() && idItr->value.IsString()) {
+        id = idItr->value.GetString();
+    }
+    binaryOutputsByDefault = getBoolParameter(doc, "binary_data_output", false);
+
+    auto inputsItr = doc.FindMember("inputs");
+    if (inputsItr == doc.MemberEnd()) {
+        return StatusCode::REST_NO_INPUTS_FOUND;
+    }
+    if (!inputsItr->value.IsArray()) {
+        return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+    }
+    std::vector<std::pair<tensorflow::TensorProto*, size_t>> binaryInputs;
+    for (const auto& input : inputsItr->value.GetArray()) {
+        if (!input.IsObject()) {
+            return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+        }
+        auto nameItr = input.FindMember("name");
+        auto datatypeItr = input.FindMember("datatype");
+        auto shapeItr = input.FindMember("shape");
+        if (nameItr == input.MemberEnd() || !nameItr->value.IsString() ||
+            datatypeItr == input.MemberEnd() || !datatypeItr->value.IsString() ||
+            shapeItr == input.MemberEnd() || !shapeItr->value.IsArray()) {
+            return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+        }
+        // protobuf map values keep their addresses when other entries are added
+        auto& tensor = (*requestProto.mutable_inputs())[nameItr->value.GetString()];
+        tensorflow::DataType dtype;
+        auto status = convertKFSDataTypeToTensorflow(datatypeItr->value.GetString(), dtype);
+        if (!status.ok()) {
+            return status;
+        }
+        tensor.set_dtype(dtype);
+        for (const auto& dim : shapeItr->value.GetArray()) {
+            if (!dim.IsInt64() || dim.GetInt64() < 0) {
+                return StatusCode::INVALID_SHAPE;
+            }
+            tensor.mutable_tensor_shape()->add_dim()->set_size(dim.GetInt64());
+        }
+
+        auto parametersItr = input.FindMember("parameters");
+        if (parametersItr != input.MemberEnd() && parametersItr->value.IsObject()) {
+            auto binarySizeItr = parametersItr->value.FindMember("binary_data_size");
+            if (binarySizeItr != parametersItr->value.MemberEnd()) {
+                if (!binarySizeItr->value.IsUint64()) {
+                    return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+                }
+                binaryInputs.emplace_back(&tensor, binarySizeItr->value.GetUint64());
+                continue;
+            }
+        }
+        auto dataItr = input.FindMember("data");
+        if (dataItr == input.MemberEnd()) {
+            SPDLOG_DEBUG("Input: {} has neither data nor binary_data_size", nameItr->value.GetString());
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        status = setTensorData(dataItr->value, tensor);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+
+    size_t offset = stream.Tell();
+    for (auto& [tensor, size] : binaryInputs) {
+        if (size > body.size() - offset) {
+            SPDLOG_DEBUG("Binary data of inputs exceeds request body");
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        auto status = setTensorProtoRawContent(*tensor, body.data() + offset, size);
+        if (!status.ok()) {
+            return status;
+        }
+        offset += size;
+    }
+    for (; offset < body.size(); ++offset) {
+        if (!std::isspace(static_cast<unsigned char>(body[offset]))) {
+            SPDLOG_DEBUG("Unexpected data after JSON header and binary data of inputs");
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+    }
+
+    auto outputsItr = doc.FindMember("outputs");
+    if (outputsItr != doc.MemberEnd()) {
+        if (!outputsItr->value.IsArray()) {
+            return StatusCode::REST_MALFORMED_REQUEST;
+        }
+        for (const auto& output : outputsItr->value.GetArray()) {
+            if (!output.IsObject()) {
+                return StatusCode::REST_MALFORMED_REQUEST;
+            }
+            auto nameItr = output.FindMember("name");
+            if (nameItr == output.MemberEnd() || !nameItr->value.IsString()) {
+                return StatusCode::REST_MALFORMED_REQUEST;
+            }
+            requestedOutputs.emplace_back(nameItr->value.GetString(), getBoolParameter(output, "binary_data", binaryOutputsByDefault));
+        }
+    }
+    return StatusCode::OK;
+}
+
+template <typename T>
+static void writeValues(json_writer_t& writer, const std::string& content) {
+    writer.StartArray();
+    for (size_t offset = 0; offset + sizeof(T) <= content.size(); offset += sizeof(T)) {
+        T value;
+        std::memcpy(&value, content.data() + offset, sizeof(T));
+        if constexpr (std::is_same_v<T, bool>) {
+            writer.Bool(value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            writer.Double(value);
+        } else if constexpr (std::is_signed_v<T>) {
+            writer.Int64(value);
+        } else {
+            writer.Uint64(value);
+        }
+    }
+    writer.EndArray();
+}
+
+static void writeHalfValues(json_writer_t& writer, const std::string& content) {
+    writer.StartArray();
+    for (size_t offset = 0; offset + sizeof(uint16_t) <= content.size(); offset += sizeof(uint16_t)) {
+        uint16_t value;
+        std::memcpy(&value, content.data() + offset, sizeof(value));
+        writer.Double(convertFp16ToFp32(value));
+    }
+    writer.EndArray();
+}
+
+static void writeData(json_writer_t& writer, const std::string& datatype, const std::string& content) {
+    if (datatype == "FP32") {
+        writeValues<float>(writer, content);
+    } else if (datatype == "FP64") {
+        writeValues<double>(writer, content);
+    } else if (datatype == "FP16") {
+        writeHalfValues(writer, content);
+    } else if (datatype == "INT8") {
+        writeValues<int8_t>(writer, content);
+    } else if (datatype == "INT16") {
+        writeValues<int16_t>(writer, content);
+    } else if (datatype == "INT32") {
+        writeValues<int32_t>(writer, content);
+    } else if (datatype == "INT64") {
+        writeValues<int64_t>(writer, content);
+    } else if (datatype == "UINT8") {
+        writeValues<uint8_t>(writer, content);
+    } else if (datatype == "UINT16") {
+        writeValues<uint16_t>(writer, content);
+    } else if (datatype == "UINT32") {
+        writeValues<uint32_t>(writer, content);
+    } else if (datatype == "UINT64") {
+        writeValues<uint64_t>(writer, content);
+    } else {
+        writeValues<bool>(writer, content);
+    }
+}
+
+Status makeKFSRestResponse(const KFSRestParser& parser,
+    tensorflow::serving::PredictResponse& responseProto,
+    const std::string& modelName,
+    const std::string& modelVersion,
+    std::string& response,
+    size_t& headerLength) {
+    auto& outputs = *responseProto.mutable_outputs();
+    std::vector<std::pair<const std::string*, bool>> selectedOutputs;
+    if (parser.getRequestedOutputs().empty()) {
+        for (const auto& [name, tensor] : outputs) {
+            selectedOutputs.emplace_back(&name, parser.areBinaryOutputsByDefault());
+        }
+    } else {
+        for (const auto& [name, binary] : parser.getRequestedOutputs()) {
+            if (outputs.find(name) == outputs.end()) {
+                SPDLOG_DEBUG("Requested output: {} was not produced", name);
+                return StatusCode::INVALID_MISSING_OUTPUT;
+            }
+            selectedOutputs.emplace_back(&name, binary);
+        }
+    }
+
+    rapidjson::StringBuffer buffer;
+    json_writer_t writer(buffer);
+    writer.StartObject();
+    writer.Key("model_name");
+    writer.String(modelName.c_str());
+    writer.Key("model_version");
+    writer.String(modelVersion.c_str());
+    if (!parser.getId().empty()) {
+        writer.Key("id");
+        writer.String(parser.getId().c_str());
+    }
+    writer.Key("outputs");
+    writer.StartArray();
+    bool hasBinaryOutputs = false;
+    std::string binaryData;
+    for (const auto& [name, binary] : selectedOutputs) {
+        const auto& tensor = outputs.at(*name);
+        std::string datatype;
+        auto status = getKFSDataType(tensor, datatype);
+        if (!status.ok()) {
+            return status;
+        }
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(name->c_str());
+        writer.Key("datatype");
+        writer.String(datatype.c_str());
+        writer.Key("shape");
+        writer.StartArray();
+        for (const auto& dim : tensor.tensor_shape().dim()) {
+            writer.Int64(dim.size());
+        }
+        writer.EndArray();
+        if (binary) {
+            writer.Key("parameters");
+            writer.StartObject();
+            writer.Key("binary_data_size");
+            writer.Uint64(tensor.tensor_content().size());
+            writer.EndObject();
+            binaryData.append(tensor.tensor_content());
+            hasBinaryOutputs = true;
+        } else {
+            writer.Key("data");
+            writeData(writer, datatype, tensor.tensor_content());
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    response.assign(buffer.GetString(), buffer.GetSize());
+    headerLength = hasBinaryOutputs ? response.size() : 0;
+    response.append(binaryData);
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
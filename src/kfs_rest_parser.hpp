@@ -0,0 +1,100 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief HTTP header holding size of JSON part of KServe request or response with binary tensor data
+ */
+constexpr const char* KFS_INFERENCE_HEADER_CONTENT_LENGTH = "Inference-Header-Content-Length";
+
+/**
+ * @brief Parses KServe v2 REST inference request into PredictRequest
+ *
+ * Supports binary tensor data extension: JSON header is followed by raw data of inputs
+ * which declare binary_data_size parameter, in order of inputs in the header.
+ * End of JSON header is found by the parser, so Inference-Header-Content-Length is not required.
+ */
+class KFSRestParser {
+    tensorflow::serving::PredictRequest requestProto;
+    std::string id;
+    bool binaryOutputsByDefault = false;
+    std::vector<std::pair<std::string, bool>> requestedOutputs;
+
+public:
+    /**
+     * @brief Parses request body
+     *
+     * @param body JSON header optionally followed by binary data
+     *
+     * @return Status
+     */
+    Status parse(const std::string& body);
+
+    tensorflow::serving::PredictRequest& getProto() {
+        return requestProto;
+    }
+
+    const std::string& getId() const {
+        return id;
+    }
+
+    /**
+     * @brief Gets outputs named in request with flag whether they are requested in binary format
+     */
+    const std::vector<std::pair<std::string, bool>>& getRequestedOutputs() const {
+        return requestedOutputs;
+    }
+
+    bool areBinaryOutputsByDefault() const {
+        return binaryOutputsByDefault;
+    }
+};
+
+/**
+ * @brief Serializes PredictResponse to KServe v2 REST inference response
+ *
+ * Outputs requested in binary format are appended after JSON header as raw data.
+ *
+ * @param parser parsed request selecting outputs and their format
+ * @param responseProto
+ * @param modelName
+ * @param modelVersion
+ * @param response
+ * @param headerLength set to size of JSON header if binary data follows it, 0 otherwise
+ *
+ * @return Status
+ */
+Status makeKFSRestResponse(const KFSRestParser& parser,
+    tensorflow::serving::PredictResponse& responseProto,
+    const std::string& modelName,
+    const std::string& modelVersion,
+    std::string& response,
+    size_t& headerLength);
+
+}  // namespace ovms
@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "kfs_utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+static const std::unordered_map<std::string, tensorflow::DataType> kfsDataTypes = {
+    {"BOOL", tensorflow::DataType::DT_BOOL},
+    {"UINT8", tensorflow::DataType::DT_UINT8},
+    {"UINT16", tensorflow::DataType::DT_UINT16},
+    {"UINT32", tensorflow::DataType::DT_UINT32},
+    {"UINT64", tensorflow::DataType::DT_UINT64},
+    {"INT8", tensorflow::DataType::DT_INT8},
+    {"INT16", tensorflow::DataType::DT_INT16},
+    {"INT32", tensorflow::DataType::DT_INT32},
+    {"INT64", tensorflow::DataType::DT_INT64},
+    {"FP16", tensorflow::DataType::DT_HALF},
+    {"FP32", tensorflow::DataType::DT_FLOAT},
+    {"FP64", tensorflow::DataType::DT_DOUBLE},
+    {"BYTES", tensorflow::DataType::DT_STRING},
+};
+
+Status convertKFSDataTypeToTensorflow(const std::string& datatype, tensorflow::DataType& dtype) {
+    auto it = kfsDataTypes.find(datatype);
+    if (it == kfsDataTypes.end()) {
+        SPDLOG_DEBUG("Unsupported KServe datatype: {}", datatype);
+        return StatusCode::KFS_UNSUPPORTED_DATATYPE;
+    }
+    dtype = it->second;
+    return StatusCode::OK;
+}
+
+size_t getKFSDataTypeSize(const std::string& datatype) {
+    auto it = kfsDataTypes.find(datatype);
+    if (it == kfsDataTypes.end()) {
+        return 0;
+    }
+    return tensorflow::DataTypeSize(it->second);
+}
+
+Status getKFSDataType(const tensorflow::TensorProto& tensor, std::string& datatype) {
+    auto it = std::find_if(kfsDataTypes.begin(), kfsDataTypes.end(),
+        [&tensor](const auto& entry) { return entry.second == tensor.dtype(); });
+    if (it == kfsDataTypes.end() || tensor.dtype() == tensorflow::DataType::DT_STRING) {
+        return StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION;
+    }
+    datatype = it->first;
+
+    size_t elementsCount = 1;
+    for (int i = 0; i < tensor.tensor_shape().dim_size(); i++) {
+        elementsCount *= tensor.tensor_shape().dim(i).size();
+    }
+    const size_t size = tensor.tensor_content().size();
+    if (size == elementsCount * tensorflow::DataTypeSize(tensor.dtype())) {
+        return StatusCode::OK;
+    }
+    // See setTensorProtoDataType in serialization.cpp
+    if (tensor.dtype() == tensorflow::DataType::DT_FLOAT && size == elementsCount * 2) {
+        datatype = "FP16";
+    } else if (tensor.dtype() == tensorflow::DataType::DT_UINT32 && size == elementsCount * 2) {
+        datatype = "UINT16";
+    } else if (tensor.dtype() == tensorflow::DataType::DT_INT32 && size == elementsCount * 8) {
+        datatype = "INT64";
+    } else {
+        return StatusCode::REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE;
+    }
+    return StatusCode::OK;
+}
+
+Status parseKFSModelVersion(const std::string& version, model_version_t& modelVersion) {
+    if (version.empty()) {
+        modelVersion = 0;
+        return StatusCode::OK;
+    }
+    if (!std::all_of(version.begin(), version.end(), ::isdigit)) {
+        return StatusCode::KFS_INVALID_MODEL_VERSION;
+    }
+    try {
+        modelVersion = std::stoll(version);
+    } catch (std::exception& e) {
+        return StatusCode::KFS_INVALID_MODEL_VERSION;
+    }
+    return StatusCode::OK;
+}
+
+Status setTensorProtoRawContent(tensorflow::TensorProto& tensor, const char* data, size_t size) {
+    switch (tensor.dtype()) {
+    case tensorflow::DataType::DT_UINT16: {
+        if (size % sizeof(uint16_t) != 0) {
+            return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+        }
+        const size_t count = size / sizeof(uint16_t);
+        auto* values = tensor.mutable_int_val();
+        values->Resize(count, 0);
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t value;
+            std::memcpy(&value, data + i * sizeof(uint16_t), sizeof(uint16_t));
+            values->Set(i, value);
+        }
+        return StatusCode::OK;
+    }
+    case tensorflow::DataType::DT_STRING: {
+        size_t offset = 0;
+        while (offset < size) {
+            uint32_t length;
+            if (size - offset < sizeof(length)) {
+                return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+            }
+            std::memcpy(&length, data + offset, sizeof(length));
+            offset += sizeof(length);
+            if (size - offset < length) {
+                return StatusCode::KFS_INVALID_INPUT_CONTENTS;
+            }
+            tensor.add_string_val(data + offset, length);
+            offset += length;
+        }
+        return StatusCode::OK;
+    }
+    default:
+        tensor.mutable_tensor_content()->assign(data, size);
+        return StatusCode::OK;
+    }
+}
+
+}  // namespace ovms
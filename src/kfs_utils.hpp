@@ -0,0 +1,82 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/tensor.h"
+#pragma GCC diagnostic pop
+
+#include "modelversion.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Converts KServe tensor datatype to TensorFlow data type used in PredictRequest
+ *
+ * @param datatype
+ * @param dtype
+ *
+ * @return KFS_UNSUPPORTED_DATATYPE if datatype is unknown
+ */
+Status convertKFSDataTypeToTensorflow(const std::string& datatype, tensorflow::DataType& dtype);
+
+/**
+ * @brief Gets size of single element of KServe datatype
+ *
+ * @return 0 for BYTES and unknown datatypes
+ */
+size_t getKFSDataTypeSize(const std::string& datatype);
+
+/**
+ * @brief Gets KServe datatype of response output
+ *
+ * Outputs are serialized with dtype holding wider type than the data for FP16, U16 and I64 precisions,
+ * so datatype is resolved from size of tensor_content.
+ *
+ * @param tensor output with data in tensor_content
+ * @param datatype
+ *
+ * @return OV_UNSUPPORTED_SERIALIZATION_PRECISION if dtype has no KServe counterpart
+ */
+Status getKFSDataType(const tensorflow::TensorProto& tensor, std::string& datatype);
+
+/**
+ * @brief Parses KServe model version, empty version selects default one
+ *
+ * @return KFS_INVALID_MODEL_VERSION if version is not a non negative integer
+ */
+Status parseKFSModelVersion(const std::string& version, model_version_t& modelVersion);
+
+/**
+ * @brief Fills PredictRequest input with raw KServe tensor data
+ *
+ * Data is placed where input validation expects it: int_val for UINT16 and string_val for BYTES,
+ * which raw format is a sequence of 4 byte little endian length followed by element bytes.
+ * Other datatypes are stored in tensor_content as they are.
+ *
+ * @param tensor input with dtype already set
+ * @param data
+ * @param size
+ *
+ * @return KFS_INVALID_INPUT_CONTENTS if BYTES data is malformed
+ */
+Status setTensorProtoRawContent(tensorflow::TensorProto& tensor, const char* data, size_t size);
+
+}  // namespace ovms
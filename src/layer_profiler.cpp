@@ -0,0 +1,79 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "layer_profiler.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+void LayerTimings::record(const std::map<std::string, InferenceEngine::InferenceEngineProfileInfo>& counts) {
+    std::lock_guard<std::mutex> lock(mtx);
+    samples++;
+    for (const auto& [name, info] : counts) {
+        if (info.status != InferenceEngine::InferenceEngineProfileInfo::EXECUTED) {
+            continue;
+        }
+        auto& layer = layers[name];
+        if (layer.executions == 0) {
+            layer.layerType = info.layer_type;
+            layer.execType = info.exec_type;
+        }
+        layer.executions++;
+        layer.realTimeUs += static_cast<uint64_t>(std::max<long long>(info.realTime_uSec, 0));
+        layer.cpuTimeUs += static_cast<uint64_t>(std::max<long long>(info.cpu_uSec, 0));
+    }
+}
+
+uint64_t LayerTimings::getSamples() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return samples;
+}
+
+std::vector<std::pair<std::string, LayerTimings::Layer>> LayerTimings::getLayers() const {
+    std::vector<std::pair<std::string, Layer>> result;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        result.assign(layers.begin(), layers.end());
+    }
+    std::stable_sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second.realTimeUs > rhs.second.realTimeUs;
+    });
+    return result;
+}
+
+LayerProfiler::LayerProfiler(std::shared_ptr<InferenceEngine::ExecutableNetwork> network, uint32_t interval) :
+    network(network),
+    queue(*network, 1),
+    interval(std::max<uint32_t>(interval, 1)) {}
+
+bool LayerProfiler::sample() {
+    if ((requests.fetch_add(1, std::memory_order_relaxed) + 1) % interval != 0) {
+        return false;
+    }
+    return queue.getWaitersCount() == 0;
+}
+
+void LayerProfiler::record(InferenceEngine::InferRequest& inferRequest) {
+    try {
+        timings.record(inferRequest.GetPerformanceCounts());
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_DEBUG("Unable to get performance counts of profiled inference: {}", e.what());
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,107 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#include "ovinferrequestsqueue.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Per layer execution times summed over profiled inferences
+ */
+class LayerTimings {
+public:
+    struct Layer {
+        std::string layerType;
+        std::string execType;
+        uint64_t executions = 0;
+        uint64_t realTimeUs = 0;
+        uint64_t cpuTimeUs = 0;
+    };
+
+    /**
+     * @brief Adds performance counts of single inference, layers which were not run are skipped
+     */
+    void record(const std::map<std::string, InferenceEngine::InferenceEngineProfileInfo>& counts);
+
+    /**
+     * @brief Number of recorded inferences
+     */
+    uint64_t getSamples() const;
+
+    /**
+     * @brief Layers by name, the most time consuming first
+     */
+    std::vector<std::pair<std::string, Layer>> getLayers() const;
+
+private:
+    mutable std::mutex mtx;
+    uint64_t samples = 0;
+    std::map<std::string, Layer> layers;
+};
+
+/**
+ * @brief Runs every n-th request of model version on single infer request of network compiled with PERF_COUNT
+ *
+ * PERF_COUNT plugin config applies to whole executable network and slows down all its infer requests,
+ * so only the separate profiling network has it enabled and the other requests are not affected.
+ */
+class LayerProfiler {
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> network;
+    OVInferRequestsQueue queue;
+    const uint32_t interval;
+    std::atomic<uint64_t> requests{0};
+    LayerTimings timings;
+
+public:
+    /**
+     * @param network compiled with PERF_COUNT enabled
+     * @param interval every interval-th request is profiled
+     */
+    LayerProfiler(std::shared_ptr<InferenceEngine::ExecutableNetwork> network, uint32_t interval);
+
+    /**
+     * @brief Counts request and decides if it is profiled
+     *
+     * Requests are not sampled while other sampled request waits for the profiling infer request.
+     */
+    bool sample();
+
+    OVInferRequestsQueue& getInferRequestsQueue() {
+        return queue;
+    }
+
+    /**
+     * @brief Records performance counts of finished inference of profiling infer request
+     */
+    void record(InferenceEngine::InferRequest& inferRequest);
+
+    const LayerTimings& getTimings() const {
+        return timings;
+    }
+};
+}  // namespace ovms
@@ -0,0 +1,281 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "layout_transpose.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace ovms {
+
+namespace {
+// tile of 32x32 FP32 values takes 4kB in source and destination, both stay in L1 cache
+constexpr size_t TILE = 32;
+
+// destination[column * rows + row] = source[row * columns + column]
+template <typename T>
+void transposeTiled(const T* source, T* destination, size_t rows, size_t columns) {
+    for (size_t rowBegin = 0; rowBegin < rows; rowBegin += TILE) {
+        const size_t rowEnd = std::min(rowBegin + TILE, rows);
+        for (size_t columnBegin = 0; columnBegin < columns; columnBegin += TILE) {
+            const size_t columnEnd = std::min(columnBegin + TILE, columns);
+            for (size_t column = columnBegin; column < columnEnd; column++) {
+                for (size_t row = rowBegin; row < rowEnd; row++) {
+                    destination[column * rows + row] = source[row * columns + column];
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void deinterleave3Scalar(const T* source, T* destination, size_t pixels, size_t begin) {
+    for (size_t channel = 0; channel < 3; channel++) {
+        for (size_t pixel = begin; pixel < pixels; pixel++) {
+            destination[channel * pixels + pixel] = source[3 * pixel + channel];
+        }
+    }
+}
+
+template <typename T>
+void interleave3Scalar(const T* source, T* destination, size_t pixels, size_t begin) {
+    for (size_t pixel = begin; pixel < pixels; pixel++) {
+        for (size_t channel = 0; channel < 3; channel++) {
+            destination[3 * pixel + channel] = source[channel * pixels + pixel];
+        }
+    }
+}
+
+/**
+ * Lanes of vectors exchanged when pixels of 3 channels are interleaved into three vectors of LANES values, -1 if value is in other vector
+ */
+template <typename Index, int LANES>
+struct Interleave3Table {
+    // [channel][interleaved vector][pixel]
+    alignas(32) Index deinterleave[3][3][LANES];
+    // [interleaved vector][channel][lane]
+    alignas(32) Index interleave[3][3][LANES];
+
+    Interleave3Table() {
+        for (int vector = 0; vector < 3; vector++) {
+            for (int channel = 0; channel < 3; channel++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    const int position = 3 * lane + channel;
+                    deinterleave[channel][vector][lane] = static_cast<Index>(position / LANES == vector ? position % LANES : -1);
+                    const int interleavedPosition = LANES * vector + lane;
+                    interleave[vector][channel][lane] = static_cast<Index>(interleavedPosition % 3 == channel ? interleavedPosition / 3 : -1);
+                }
+            }
+        }
+    }
+};
+
+// byte shuffle clears lanes of index -1, so values from three vectors are combined with bitwise or
+__attribute__((target("ssse3"))) void deinterleave3Ssse3(const uint8_t* source, uint8_t* destination, size_t pixels) {
+    static const Interleave3Table<int8_t, 16> table;
+    __m128i masks[3][3];
+    for (int channel = 0; channel < 3; channel++) {
+        for (int vector = 0; vector < 3; vector++) {
+            masks[channel][vector] = _mm_load_si128(reinterpret_cast<const __m128i*>(table.deinterleave[channel][vector]));
+        }
+    }
+    size_t pixel = 0;
+    for (; pixel + 16 <= pixels; pixel += 16) {
+        const uint8_t* in = source + 3 * pixel;
+        const __m128i vectors[3] = {
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32))};
+        for (int channel = 0; channel < 3; channel++) {
+            const __m128i value = _mm_or_si128(
+                _mm_or_si128(_mm_shuffle_epi8(vectors[0], masks[channel][0]), _mm_shuffle_epi8(vectors[1], masks[channel][1])),
+                _mm_shuffle_epi8(vectors[2], masks[channel][2]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + static_cast<size_t>(channel) * pixels + pixel), value);
+        }
+    }
+    deinterleave3Scalar(source, destination, pixels, pixel);
+}
+
+__attribute__((target("ssse3"))) void interleave3Ssse3(const uint8_t* source, uint8_t* destination, size_t pixels) {
+    static const Interleave3Table<int8_t, 16> table;
+    __m128i masks[3][3];
+    for (int vector = 0; vector < 3; vector++) {
+        for (int channel = 0; channel < 3; channel++) {
+            masks[vector][channel] = _mm_load_si128(reinterpret_cast<const __m128i*>(table.interleave[vector][channel]));
+        }
+    }
+    size_t pixel = 0;
+    for (; pixel + 16 <= pixels; pixel += 16) {
+        const __m128i channels[3] = {
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixels + pixel)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 2 * pixels + pixel))};
+        uint8_t* out = destination + 3 * pixel;
+        for (int vector = 0; vector < 3; vector++) {
+            const __m128i value = _mm_or_si128(
+                _mm_or_si128(_mm_shuffle_epi8(channels[0], masks[vector][0]), _mm_shuffle_epi8(channels[1], masks[vector][1])),
+                _mm_shuffle_epi8(channels[2], masks[vector][2]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * vector), value);
+        }
+    }
+    interleave3Scalar(source, destination, pixels, pixel);
+}
+
+// values are permuted across lanes and lanes of index -1 are taken from the other vectors by blend
+__attribute__((target("avx2"))) void deinterleave3Avx2(const float* source, float* destination, size_t pixels) {
+    static const Interleave3Table<int32_t, 8> table;
+    const __m256i invalid = _mm256_set1_epi32(-1);
+    __m256i indices[3][3];
+    __m256 selects[3][3];
+    for (int channel = 0; channel < 3; channel++) {
+        for (int vector = 0; vector < 3; vector++) {
+            indices[channel][vector] = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.deinterleave[channel][vector]));
+            selects[channel][vector] = _mm256_castsi256_ps(_mm256_cmpgt_epi32(indices[channel][vector], invalid));
+        }
+    }
+    size_t pixel = 0;
+    for (; pixel + 8 <= pixels; pixel += 8) {
+        const float* in = source + 3 * pixel;
+        const __m256 vectors[3] = {_mm256_loadu_ps(in), _mm256_loadu_ps(in + 8), _mm256_loadu_ps(in + 16)};
+        for (int channel = 0; channel < 3; channel++) {
+            __m256 value = _mm256_permutevar8x32_ps(vectors[0], indices[channel][0]);
+            value = _mm256_blendv_ps(value, _mm256_permutevar8x32_ps(vectors[1], indices[channel][1]), selects[channel][1]);
+            value = _mm256_blendv_ps(value, _mm256_permutevar8x32_ps(vectors[2], indices[channel][2]), selects[channel][2]);
+            _mm256_storeu_ps(destination + static_cast<size_t>(channel) * pixels + pixel, value);
+        }
+    }
+    deinterleave3Scalar(source, destination, pixels, pixel);
+}
+
+__attribute__((target("avx2"))) void interleave3Avx2(const float* source, float* destination, size_t pixels) {
+    static const Interleave3Table<int32_t, 8> table;
+    const __m256i invalid = _mm256_set1_epi32(-1);
+    __m256i indices[3][3];
+    __m256 selects[3][3];
+    for (int vector = 0; vector < 3; vector++) {
+        for (int channel = 0; channel < 3; channel++) {
+            indices[vector][channel] = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.interleave[vector][channel]));
+            selects[vector][channel] = _mm256_castsi256_ps(_mm256_cmpgt_epi32(indices[vector][channel], invalid));
+        }
+    }
+    size_t pixel = 0;
+    for (; pixel + 8 <= pixels; pixel += 8) {
+        const __m256 channels[3] = {
+            _mm256_loadu_ps(source + pixel),
+            _mm256_loadu_ps(source + pixels + pixel),
+            _mm256_loadu_ps(source + 2 * pixels + pixel)};
+        float* out = destination + 3 * pixel;
+        for (int vector = 0; vector < 3; vector++) {
+            __m256 value = _mm256_permutevar8x32_ps(channels[0], indices[vector][0]);
+            value = _mm256_blendv_ps(value, _mm256_permutevar8x32_ps(channels[1], indices[vector][1]), selects[vector][1]);
+            value = _mm256_blendv_ps(value, _mm256_permutevar8x32_ps(channels[2], indices[vector][2]), selects[vector][2]);
+            _mm256_storeu_ps(out + 8 * vector, value);
+        }
+    }
+    interleave3Scalar(source, destination, pixels, pixel);
+}
+
+bool isSsse3Supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+}
+
+bool isAvx2Supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+void deinterleave3(const uint8_t* source, uint8_t* destination, size_t pixels) {
+    static const bool ssse3 = isSsse3Supported();
+    if (ssse3) {
+        deinterleave3Ssse3(source, destination, pixels);
+    } else {
+        deinterleave3Scalar(source, destination, pixels, 0);
+    }
+}
+
+void interleave3(const uint8_t* source, uint8_t* destination, size_t pixels) {
+    static const bool ssse3 = isSsse3Supported();
+    if (ssse3) {
+        interleave3Ssse3(source, destination, pixels);
+    } else {
+        interleave3Scalar(source, destination, pixels, 0);
+    }
+}
+
+void deinterleave3(const float* source, float* destination, size_t pixels) {
+    static const bool avx2 = isAvx2Supported();
+    if (avx2) {
+        deinterleave3Avx2(source, destination, pixels);
+    } else {
+        deinterleave3Scalar(source, destination, pixels, 0);
+    }
+}
+
+void interleave3(const float* source, float* destination, size_t pixels) {
+    static const bool avx2 = isAvx2Supported();
+    if (avx2) {
+        interleave3Avx2(source, destination, pixels);
+    } else {
+        interleave3Scalar(source, destination, pixels, 0);
+    }
+}
+
+template <typename T>
+void transposeImages(const T* source, T* destination, size_t batch, size_t channels, size_t pixels, bool toPlanar) {
+    const size_t imageSize = channels * pixels;
+    for (size_t image = 0; image < batch; image++) {
+        const T* in = source + image * imageSize;
+        T* out = destination + image * imageSize;
+        if (channels == 3) {
+            toPlanar ? deinterleave3(in, out, pixels) : interleave3(in, out, pixels);
+        } else if (toPlanar) {
+            transposeTiled(in, out, pixels, channels);
+        } else {
+            transposeTiled(in, out, channels, pixels);
+        }
+    }
+}
+}  // namespace
+
+bool isLayoutTransposeSupported(InferenceEngine::Precision precision, InferenceEngine::Layout sourceLayout, InferenceEngine::Layout destinationLayout) {
+    if (precision != InferenceEngine::Precision::FP32 && precision != InferenceEngine::Precision::U8) {
+        return false;
+    }
+    return (sourceLayout == InferenceEngine::Layout::NHWC && destinationLayout == InferenceEngine::Layout::NCHW) ||
+           (sourceLayout == InferenceEngine::Layout::NCHW && destinationLayout == InferenceEngine::Layout::NHWC);
+}
+
+bool transposeLayout(InferenceEngine::Precision precision, const InferenceEngine::SizeVector& dims,
+    InferenceEngine::Layout sourceLayout, const void* source,
+    InferenceEngine::Layout destinationLayout, void* destination) {
+    if (!isLayoutTransposeSupported(precision, sourceLayout, destinationLayout) || dims.size() != 4) {
+        return false;
+    }
+    const size_t batch = dims[0];
+    const size_t channels = dims[1];
+    const size_t pixels = dims[2] * dims[3];
+    const bool toPlanar = sourceLayout == InferenceEngine::Layout::NHWC;
+    if (precision == InferenceEngine::Precision::FP32) {
+        transposeImages(static_cast<const float*>(source), static_cast<float*>(destination), batch, channels, pixels, toPlanar);
+    } else {
+        transposeImages(static_cast<const uint8_t*>(source), static_cast<uint8_t*>(destination), batch, channels, pixels, toPlanar);
+    }
+    return true;
+}
+
+}  // namespace ovms
@@ -0,0 +1,48 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Checks if data can be transposed between layouts by transposeLayout
+ *
+ * Supported are FP32 and U8 data with NHWC and NCHW layouts.
+ */
+bool isLayoutTransposeSupported(InferenceEngine::Precision precision, InferenceEngine::Layout sourceLayout, InferenceEngine::Layout destinationLayout);
+
+/**
+ * @brief Transposes 4 dimensional data from NHWC to NCHW layout or the other way around
+ *
+ * Channels and pixels are exchanged in tiles fitting in L1 cache. 3 channel images, the most common case,
+ * are deinterleaved or interleaved with AVX2 for FP32 and SSSE3 for U8 data when supported by the CPU at runtime.
+ *
+ * @param precision FP32 or U8
+ * @param dims dimensions in NCHW order, as in InferenceEngine::TensorDesc regardless of layout
+ * @param sourceLayout
+ * @param source
+ * @param destinationLayout
+ * @param destination buffer of the same size as source
+ *
+ * @return false if transposition is not supported
+ */
+bool transposeLayout(InferenceEngine::Precision precision, const InferenceEngine::SizeVector& dims,
+    InferenceEngine::Layout sourceLayout, const void* source,
+    InferenceEngine::Layout destinationLayout, void* destination);
+
+}  // namespace ovms
@@ -15,8 +15,14 @@
 //*****************************************************************************
 #include "logging.hpp"
 
+#include <atomic>
+#include <csignal>
 #include <vector>
 
+#include <spdlog/async.h>
+
+#include "rate_limited_sink.hpp"
+
 namespace ovms {
 
 std::shared_ptr<spdlog::logger> gcs_logger = std::make_shared<spdlog::logger>("gcs");
@@ -28,53 +34,103 @@ std::shared_ptr<spdlog::logger> sequence_manager_logger = std::make_shared<spdlo
 
 const std::string default_pattern = "[%Y-%m-%d %T.%e][%t][%n][%l][%s:%#] %v";
 
-void set_log_level(const std::string log_level, std::shared_ptr<spdlog::logger> logger) {
-    logger->set_level(spdlog::level::info);
-    if (!log_level.empty()) {
-        if (log_level == "DEBUG") {
-            logger->set_level(spdlog::level::debug);
-            logger->flush_on(spdlog::level::trace);
-        } else if (log_level == "ERROR") {
-            logger->set_level(spdlog::level::err);
-            logger->flush_on(spdlog::level::err);
+namespace {
+std::shared_ptr<spdlog::logger> serving_logger;
+std::atomic<spdlog::level::level_enum> configured_level{spdlog::level::info};
+std::atomic<bool> debug_toggled{false};
+volatile sig_atomic_t debug_toggle_requested = 0;
+
+spdlog::level::level_enum parse_log_level(const std::string& log_level) {
+    if (log_level == "DEBUG") {
+        return spdlog::level::debug;
+    }
+    if (log_level == "WARNING") {
+        return spdlog::level::warn;
+    }
+    if (log_level == "ERROR") {
+        return spdlog::level::err;
+    }
+    return spdlog::level::info;
+}
+
+void set_log_level(spdlog::level::level_enum level, spdlog::logger& logger) {
+    logger.set_level(level);
+    logger.flush_on(level == spdlog::level::debug ? spdlog::level::trace : spdlog::level::err);
+}
+
+std::shared_ptr<spdlog::logger> make_logger(const std::string& name, std::vector<spdlog::sink_ptr> sinks, size_t queue_size, uint64_t rate_limit) {
+    if (rate_limit > 0) {
+        auto limited = std::make_shared<RateLimitedSink>(rate_limit);
+        for (auto& sink : sinks) {
+            limited->add_sink(sink);
         }
+        sinks = {limited};
+    }
+    std::shared_ptr<spdlog::logger> logger;
+    if (queue_size > 0) {
+        // full queue overwrites the oldest messages instead of blocking request threads
+        logger = std::make_shared<spdlog::async_logger>(name, begin(sinks), end(sinks), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+    } else {
+        logger = std::make_shared<spdlog::logger>(name, begin(sinks), end(sinks));
     }
+    logger->set_pattern(default_pattern);
+    set_log_level(configured_level, *logger);
+    return logger;
 }
 
-void register_loggers(const std::string log_level, std::vector<spdlog::sink_ptr> sinks) {
-    auto serving_logger = std::make_shared<spdlog::logger>("serving", begin(sinks), end(sinks));
-    serving_logger->set_pattern(default_pattern);
-    gcs_logger->set_pattern(default_pattern);
-    azurestorage_logger->set_pattern(default_pattern);
-    s3_logger->set_pattern(default_pattern);
-    modelmanager_logger->set_pattern(default_pattern);
-    dag_executor_logger->set_pattern(default_pattern);
-    sequence_manager_logger->set_pattern(default_pattern);
-    for (auto sink : sinks) {
-        gcs_logger->sinks().push_back(sink);
-        azurestorage_logger->sinks().push_back(sink);
-        s3_logger->sinks().push_back(sink);
-        modelmanager_logger->sinks().push_back(sink);
-        dag_executor_logger->sinks().push_back(sink);
-        sequence_manager_logger->sinks().push_back(sink);
+std::vector<spdlog::logger*> all_loggers() {
+    return {serving_logger.get(), gcs_logger.get(), azurestorage_logger.get(), s3_logger.get(),
+        modelmanager_logger.get(), dag_executor_logger.get(), sequence_manager_logger.get()};
+}
+}  // namespace
+
+void register_loggers(const std::string log_level, std::vector<spdlog::sink_ptr> sinks, size_t queue_size, uint64_t rate_limit) {
+    configured_level = parse_log_level(log_level);
+    if (queue_size > 0) {
+        // single worker thread writes messages of all loggers, so sinks do not need to be thread safe
+        spdlog::init_thread_pool(queue_size, 1);
     }
-    set_log_level(log_level, serving_logger);
-    set_log_level(log_level, gcs_logger);
-    set_log_level(log_level, azurestorage_logger);
-    set_log_level(log_level, s3_logger);
-    set_log_level(log_level, modelmanager_logger);
-    set_log_level(log_level, dag_executor_logger);
-    set_log_level(log_level, sequence_manager_logger);
+    serving_logger = make_logger("serving", sinks, queue_size, rate_limit);
+    gcs_logger = make_logger("gcs", sinks, queue_size, rate_limit);
+    azurestorage_logger = make_logger("azurestorage", sinks, queue_size, rate_limit);
+    s3_logger = make_logger("s3", sinks, queue_size, rate_limit);
+    modelmanager_logger = make_logger("modelmanager", sinks, queue_size, rate_limit);
+    dag_executor_logger = make_logger("dag_executor", sinks, queue_size, rate_limit);
+    sequence_manager_logger = make_logger("sequence_manager", sinks, queue_size, rate_limit);
     spdlog::set_default_logger(serving_logger);
 }
 
-void configure_logger(const std::string log_level, const std::string log_path) {
+void configure_logger(const std::string log_level, const std::string log_path, size_t queue_size, uint64_t rate_limit) {
     std::vector<spdlog::sink_ptr> sinks;
     sinks.push_back(std::make_shared<spdlog::sinks::stdout_sink_st>());
     if (!log_path.empty()) {
         sinks.push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_path));
     }
-    register_loggers(log_level, sinks);
+    register_loggers(log_level, sinks, queue_size, rate_limit);
+}
+
+void toggle_debug_log_level() {
+    const bool debug = !debug_toggled.load();
+    debug_toggled = debug;
+    const auto level = debug ? spdlog::level::debug : configured_level.load();
+    for (auto* logger : all_loggers()) {
+        if (logger) {
+            set_log_level(level, *logger);
+        }
+    }
+}
+
+void on_debug_log_level_toggle_signal(int signal) {
+    debug_toggle_requested = 1;
+}
+
+bool apply_debug_log_level_toggle_request() {
+    if (!debug_toggle_requested) {
+        return false;
+    }
+    debug_toggle_requested = 0;
+    toggle_debug_log_level();
+    return true;
 }
 
 }  // namespace ovms
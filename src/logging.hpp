@@ -31,6 +31,31 @@ extern std::shared_ptr<spdlog::logger> modelmanager_logger;
 extern std::shared_ptr<spdlog::logger> dag_executor_logger;
 extern std::shared_ptr<spdlog::logger> sequence_manager_logger;
 
-void configure_logger(const std::string log_level, const std::string log_path);
+/**
+ * @brief Configures all loggers
+ *
+ * @param log_level one of DEBUG, INFO, WARNING, ERROR
+ * @param log_path optional log file
+ * @param queue_size messages queued for background writing, 0 writes messages synchronously on logging threads
+ * @param rate_limit messages below WARNING written per second by each logger, 0 is unlimited
+ */
+void configure_logger(const std::string log_level, const std::string log_path, size_t queue_size = 0, uint64_t rate_limit = 0);
+
+/**
+ * @brief Switches all loggers between DEBUG and configured log level
+ */
+void toggle_debug_log_level();
+
+/**
+ * @brief Handler of SIGUSR1, only requests switching of log level as loggers cannot be used in signal handlers
+ */
+void on_debug_log_level_toggle_signal(int signal);
+
+/**
+ * @brief Switches log level if it was requested by signal since the last call
+ *
+ * @return true if log level was switched
+ */
+bool apply_debug_log_level_toggle_request();
 
 }  // namespace ovms
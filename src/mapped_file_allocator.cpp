@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "mapped_file_allocator.hpp"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ovms {
+
+MappedFile::~MappedFile() {
+    munmap(data, size);
+}
+
+std::shared_ptr<MappedFile> MappedFile::map(int fd, size_t size) {
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return std::shared_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+std::shared_ptr<MappedFile> MappedFile::map(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        SPDLOG_WARN("Unable to map file descriptor {}: not a non-empty regular file", fd);
+        return nullptr;
+    }
+    auto file = map(fd, st.st_size);
+    if (!file) {
+        SPDLOG_WARN("Unable to map file descriptor {}: {}", fd, std::strerror(errno));
+    }
+    return file;
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    // Identity of file content, files replaced or modified in place get a new mapping
+    using FileId = std::tuple<dev_t, ino_t, off_t, int64_t, int64_t>;
+    static std::mutex mtx;
+    static std::map<FileId, std::weak_ptr<MappedFile>> mappings;
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        SPDLOG_WARN("Unable to open file {} for mapping: {}", path, std::strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    FileId id{st.st_dev, st.st_ino, st.st_size, st.st_mtim.tv_sec, st.st_mtim.tv_nsec};
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = mappings.find(id);
+    if (it != mappings.end()) {
+        if (auto existing = it->second.lock()) {
+            ::close(fd);
+            SPDLOG_DEBUG("Reusing mapping of file {}", path);
+            return existing;
+        }
+    }
+    auto file = map(fd, st.st_size);
+    if (!file) {
+        SPDLOG_WARN("Unable to map file {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return nullptr;
+    }
+    ::close(fd);
+    // Drop entries of released mappings
+    for (auto entry = mappings.begin(); entry != mappings.end();) {
+        entry = entry->second.expired() ? mappings.erase(entry) : std::next(entry);
+    }
+    mappings[id] = file;
+    return file;
+}
+
+}  // namespace ovms
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Private memory mapping of a file
+ *
+ * Unmodified pages are backed by page cache, so all mappings of the same file share physical memory.
+ * Writes are copy-on-write and never reach the file.
+ */
+class MappedFile {
+    void* data = nullptr;
+    size_t size = 0;
+
+    MappedFile(void* data, size_t size) :
+        data(data),
+        size(size) {}
+
+    static std::shared_ptr<MappedFile> map(int fd, size_t size);
+
+public:
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps file or returns existing mapping of the same unchanged file
+     *
+     * @return nullptr if file cannot be mapped
+     */
+    static std::shared_ptr<MappedFile> open(const std::string& path);
+
+    /**
+     * @brief Maps whole file referenced by descriptor, descriptor can be closed afterwards
+     *
+     * @return nullptr if file cannot be mapped
+     */
+    static std::shared_ptr<MappedFile> map(int fd);
+
+    void* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+/**
+ * @brief Exposes mapped file as blob memory, keeps mapping alive for the lifetime of blob using this allocator
+ */
+class MappedFileAllocator : public InferenceEngine::IAllocator {
+    std::shared_ptr<MappedFile> file;
+
+public:
+    MappedFileAllocator(std::shared_ptr<MappedFile> file) :
+        file(std::move(file)) {}
+
+    void* lock(void* handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void* a) noexcept override {}
+
+    void* alloc(size_t size) noexcept override {
+        return size <= file->getSize() ? file->getData() : nullptr;
+    }
+
+    bool free(void* handle) noexcept override {
+        return true;
+    }
+};
+
+}  // namespace ovms
@@ -0,0 +1,196 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "memory_lock.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace ovms {
+
+// advices populating page tables, available since Linux 5.14, older kernels reject them with EINVAL
+static constexpr int POPULATE_READ_ADVICE = 22;
+static constexpr int POPULATE_WRITE_ADVICE = 23;
+// guard pages of thread stacks, bigger inaccessible mappings are reservations like the rest of malloc arena
+static constexpr size_t MAX_STACK_GUARD_SIZE = 64 * 1024;
+
+std::vector<MemoryRange> getMappedMemory() {
+    std::vector<MemoryRange> mapped;
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    MemoryRange previous{0, 0};
+    bool previousInaccessible = false;
+    while (std::getline(maps, line)) {
+        std::istringstream fields(line);
+        std::string addresses, permissions, offset, device, inode, path;
+        fields >> addresses >> permissions >> offset >> device >> inode >> path;
+        const auto dash = addresses.find('-');
+        if (dash == std::string::npos || permissions.size() < 4) {
+            continue;
+        }
+        MemoryRange range;
+        try {
+            range = {static_cast<uintptr_t>(std::stoull(addresses.substr(0, dash), nullptr, 16)), static_cast<uintptr_t>(std::stoull(addresses.substr(dash + 1), nullptr, 16))};
+        } catch (const std::exception&) {
+            continue;
+        }
+        const bool isStack = previousInaccessible && previous.end == range.begin && previous.size() <= MAX_STACK_GUARD_SIZE &&
+                             permissions.compare(0, 3, "rw-") == 0 && path.empty();
+        const bool isSpecial = !path.empty() && path.front() == '[' && path != "[heap]";
+        previousInaccessible = permissions.compare(0, 3, "---") == 0;
+        previous = range;
+        if (permissions[0] != 'r' || isStack || isSpecial) {
+            continue;
+        }
+        mapped.push_back(range);
+    }
+    return mapped;
+}
+
+std::vector<MemoryRange> subtractRanges(const std::vector<MemoryRange>& ranges, const std::vector<MemoryRange>& subtracted) {
+    std::vector<MemoryRange> result;
+    auto it = subtracted.begin();
+    for (const auto& range : ranges) {
+        uintptr_t begin = range.begin;
+        while (it != subtracted.end() && it->end <= begin) {
+            ++it;
+        }
+        for (auto covering = it; covering != subtracted.end() && covering->begin < range.end; ++covering) {
+            if (covering->begin > begin) {
+                result.push_back({begin, covering->begin});
+            }
+            begin = std::max(begin, covering->end);
+        }
+        if (begin < range.end) {
+            result.push_back({begin, range.end});
+        }
+    }
+    return result;
+}
+
+size_t getMemoryLockLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return static_cast<size_t>(limit.rlim_cur);
+}
+
+size_t getLockedMemoryBytes() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmLck:") == 0) {
+            std::istringstream fields(line.substr(6));
+            size_t kilobytes = 0;
+            fields >> kilobytes;
+            return kilobytes * 1024;
+        }
+    }
+    return 0;
+}
+
+void prefaultMemory(const MemoryRange& range) {
+    void* address = reinterpret_cast<void*>(range.begin);
+    if (madvise(address, range.size(), POPULATE_WRITE_ADVICE) == 0 ||
+        madvise(address, range.size(), POPULATE_READ_ADVICE) == 0) {
+        return;
+    }
+    // older kernels only read ahead pages of file mappings
+    madvise(address, range.size(), MADV_WILLNEED);
+}
+
+MemoryLock::~MemoryLock() {
+    for (const auto& [begin, end] : ranges) {
+        munlock(reinterpret_cast<void*>(begin), end - begin);
+    }
+}
+
+size_t MemoryLock::getPageSize() {
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return pageSize;
+}
+
+bool MemoryLock::lock(const void* address, size_t size) {
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(address);
+    return lock(MemoryRange{begin, begin + size});
+}
+
+bool MemoryLock::lock(const MemoryRange& range) {
+    const size_t pageSize = getPageSize();
+    const MemoryRange pages{(range.begin + pageSize - 1) / pageSize * pageSize, range.end / pageSize * pageSize};
+    if (pages.begin >= pages.end) {
+        return true;
+    }
+    std::lock_guard<std::mutex> guard(mtx);
+    std::vector<MemoryRange> alreadyLocked;
+    auto it = ranges.upper_bound(pages.begin);
+    if (it != ranges.begin()) {
+        --it;
+    }
+    for (; it != ranges.end() && it->first < pages.end; ++it) {
+        alreadyLocked.push_back({it->first, it->second});
+    }
+    bool locked = true;
+    for (const auto& part : subtractRanges({pages}, alreadyLocked)) {
+        if (mlock(reinterpret_cast<void*>(part.begin), part.size()) == 0) {
+            ranges.emplace(part.begin, part.end);
+            lockedBytes += part.size();
+            continue;
+        }
+        if (lockError == 0) {
+            lockError = errno;
+        }
+        prefaultMemory(part);
+        prefaultedBytes += part.size();
+        locked = false;
+    }
+    return locked;
+}
+
+size_t MemoryLock::getLockedBytes() const {
+    std::lock_guard<std::mutex> guard(mtx);
+    return lockedBytes;
+}
+
+size_t MemoryLock::getPrefaultedBytes() const {
+    std::lock_guard<std::mutex> guard(mtx);
+    return prefaultedBytes;
+}
+
+int MemoryLock::getLockError() const {
+    std::lock_guard<std::mutex> guard(mtx);
+    return lockError;
+}
+
+std::vector<MemoryRange> MemoryLock::getRanges() const {
+    std::lock_guard<std::mutex> guard(mtx);
+    std::vector<MemoryRange> result;
+    result.reserve(ranges.size());
+    for (const auto& [begin, end] : ranges) {
+        result.push_back({begin, end});
+    }
+    return result;
+}
+
+}  // namespace ovms
@@ -0,0 +1,116 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Address range [begin, end)
+ */
+struct MemoryRange {
+    uintptr_t begin;
+    uintptr_t end;
+
+    size_t size() const { return end - begin; }
+    bool operator==(const MemoryRange& rhs) const { return begin == rhs.begin && end == rhs.end; }
+};
+
+/**
+ * @brief Readable mappings of the process from /proc/self/maps, sorted by address
+ *
+ * Kernel special mappings and thread stacks, recognized by guard page mapped right below them, are left out,
+ * so that locking new mappings does not populate whole stacks of threads started meanwhile.
+ */
+std::vector<MemoryRange> getMappedMemory();
+
+/**
+ * @brief Parts of sorted ranges not covered by sorted subtracted ranges
+ */
+std::vector<MemoryRange> subtractRanges(const std::vector<MemoryRange>& ranges, const std::vector<MemoryRange>& subtracted);
+
+/**
+ * @brief Soft RLIMIT_MEMLOCK of the process in bytes, SIZE_MAX when unlimited
+ */
+size_t getMemoryLockLimit();
+
+/**
+ * @brief Memory locked by the process in bytes, read from VmLck of /proc/self/status
+ */
+size_t getLockedMemoryBytes();
+
+/**
+ * @brief Populates page tables of range without locking it, on older kernels pages of file mappings are only read ahead
+ */
+void prefaultMemory(const MemoryRange& range);
+
+/**
+ * @brief Pre-faults and locks memory in RAM so that inference does not wait for page faults
+ *
+ * Ranges are rounded inwards to whole pages, so locked pages are not shared with other allocations
+ * and unlocking them does not unlock memory locked by others. Parts of range already locked by this object are skipped.
+ * When mlock fails, e.g. RLIMIT_MEMLOCK is insufficient, range is only pre-faulted and may be paged out later.
+ * Locked ranges are unlocked when the object is destroyed, memory released to the system meanwhile is unlocked by the kernel.
+ */
+class MemoryLock {
+    mutable std::mutex mtx;
+    // locked ranges by begin
+    std::map<uintptr_t, uintptr_t> ranges;
+    size_t lockedBytes = 0;
+    size_t prefaultedBytes = 0;
+    int lockError = 0;
+
+public:
+    MemoryLock() = default;
+    ~MemoryLock();
+    MemoryLock(const MemoryLock&) = delete;
+    MemoryLock& operator=(const MemoryLock&) = delete;
+
+    /**
+     * @return false if whole page aligned part of range could not be locked
+     */
+    bool lock(const void* address, size_t size);
+    bool lock(const MemoryRange& range);
+
+    /**
+     * @brief Memory locked by this object, in bytes
+     */
+    size_t getLockedBytes() const;
+
+    /**
+     * @brief Memory which could not be locked and was only pre-faulted, in bytes
+     */
+    size_t getPrefaultedBytes() const;
+
+    /**
+     * @brief errno of first failed mlock, 0 when all ranges were locked
+     */
+    int getLockError() const;
+
+    /**
+     * @brief Locked ranges sorted by address
+     */
+    std::vector<MemoryRange> getRanges() const;
+
+    static size_t getPageSize();
+};
+
+}  // namespace ovms
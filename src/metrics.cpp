@@ -0,0 +1,268 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "metrics.hpp"
+
+#include <algorithm>
+
+namespace ovms {
+
+Histogram::Histogram(const std::vector<uint64_t>& bucketBounds) :
+    bucketBounds(bucketBounds),
+    bucketCounts(std::make_unique<std::atomic<uint64_t>[]>(bucketBounds.size() + 1)) {
+    for (size_t i = 0; i <= bucketBounds.size(); ++i) {
+        bucketCounts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(uint64_t value) {
+    const size_t bucket = std::lower_bound(bucketBounds.begin(), bucketBounds.end(), value) - bucketBounds.begin();
+    bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::getBucketCounts() const {
+    std::vector<uint64_t> counts(bucketBounds.size() + 1);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] = bucketCounts[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+uint64_t Counter::get() const {
+    uint64_t sum = 0;
+    for (const auto& shard : shards) {
+        sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+static void appendSample(std::string& out, const std::string& name, const std::string& labels, const std::string& extraLabel, const std::string& value) {
+    out += name;
+    if (!labels.empty() || !extraLabel.empty()) {
+        out += "{";
+        out += labels;
+        if (!labels.empty() && !extraLabel.empty()) {
+            out += ",";
+        }
+        out += extraLabel;
+        out += "}";
+    }
+    out += " ";
+    out += value;
+    out += "\n";
+}
+
+static void appendSample(std::string& out, const std::string& name, const std::string& labels, const std::string& extraLabel, uint64_t value) {
+    appendSample(out, name, labels, extraLabel, std::to_string(value));
+}
+
+void Histogram::serialize(const std::string& name, const std::string& labels, std::string& out) const {
+    // buckets are cumulative in exposition format
+    uint64_t cumulativeCount = 0;
+    for (size_t i = 0; i < bucketBounds.size(); ++i) {
+        cumulativeCount += bucketCounts[i].load(std::memory_order_relaxed);
+        appendSample(out, name + "_bucket", labels, "le=\"" + std::to_string(bucketBounds[i]) + "\"", cumulativeCount);
+    }
+    cumulativeCount += bucketCounts[bucketBounds.size()].load(std::memory_order_relaxed);
+    appendSample(out, name + "_bucket", labels, "le=\"+Inf\"", cumulativeCount);
+    appendSample(out, name + "_sum", labels, "", getSum());
+    appendSample(out, name + "_count", labels, "", cumulativeCount);
+}
+
+MetricRegistry::Family& MetricRegistry::getFamily(const std::string& name, const std::string& type, const std::string& help, const std::vector<uint64_t>& bucketBounds) {
+    auto familyIt = families.find(name);
+    if (familyIt == families.end()) {
+        familyIt = families.emplace(name, Family{type, help, bucketBounds, {}, {}, {}}).first;
+    }
+    return familyIt->second;
+}
+
+Histogram& MetricRegistry::getHistogram(const std::string& name, const std::string& help, const std::vector<uint64_t>& bucketBounds, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& family = getFamily(name, "histogram", help, bucketBounds);
+    auto it = family.histograms.find(labels);
+    if (it == family.histograms.end()) {
+        it = family.histograms.emplace(labels, std::make_unique<Histogram>(family.bucketBounds)).first;
+    }
+    return *it->second;
+}
+
+Counter& MetricRegistry::getCounter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& family = getFamily(name, "counter", help);
+    auto it = family.counters.find(labels);
+    if (it == family.counters.end()) {
+        it = family.counters.emplace(labels, std::make_unique<Counter>()).first;
+    }
+    return *it->second;
+}
+
+Gauge& MetricRegistry::getGauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& family = getFamily(name, "gauge", help);
+    auto it = family.gauges.find(labels);
+    if (it == family.gauges.end()) {
+        it = family.gauges.emplace(labels, std::make_unique<Gauge>()).first;
+    }
+    return *it->second;
+}
+
+std::string MetricRegistry::serialize() const {
+    std::string out;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& [name, family] : families) {
+        out += "# HELP " + name + " " + family.help + "\n";
+        out += "# TYPE " + name + " " + family.type + "\n";
+        for (const auto& [labels, histogram] : family.histograms) {
+            histogram->serialize(name, labels, out);
+        }
+        for (const auto& [labels, counter] : family.counters) {
+            appendSample(out, name, labels, "", counter->get());
+        }
+        for (const auto& [labels, gauge] : family.gauges) {
+            appendSample(out, name, labels, "", std::to_string(gauge->get()));
+        }
+    }
+    return out;
+}
+
+static std::string escapeLabelValue(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+NodeMetrics NodeMetrics::create(MetricRegistry& registry, const std::string& pipelineName, const std::string& nodeName) {
+    static const std::vector<uint64_t> timeBuckets{100, 500, 1'000, 5'000, 10'000, 50'000, 100'000, 500'000, 1'000'000, 5'000'000};
+    static const std::vector<uint64_t> bytesBuckets{1'024, 16'384, 131'072, 1'048'576, 8'388'608, 67'108'864, 536'870'912};
+    static const std::vector<uint64_t> shardsBuckets{1, 2, 4, 8, 16, 32, 64, 128, 256, 1'024, 10'000};
+    const std::string labels = "pipeline=\"" + escapeLabelValue(pipelineName) + "\",node=\"" + escapeLabelValue(nodeName) + "\"";
+    NodeMetrics metrics;
+    metrics.inputsWaitTime = &registry.getHistogram("ovms_pipeline_node_inputs_wait_time_us",
+        "Time from first input of node session until all its inputs are ready, in microseconds", timeBuckets, labels);
+    metrics.streamWaitTime = &registry.getHistogram("ovms_pipeline_node_stream_wait_time_us",
+        "Time DL model node session waited for infer request stream, in microseconds", timeBuckets, labels);
+    metrics.executionTime = &registry.getHistogram("ovms_pipeline_node_execution_time_us",
+        "Inference or custom node execution time of node session, in microseconds", timeBuckets, labels);
+    metrics.outputBytes = &registry.getHistogram("ovms_pipeline_node_output_bytes",
+        "Total size of intermediate blobs produced by node session, in bytes", bytesBuckets, labels);
+    metrics.shardsCount = &registry.getHistogram("ovms_pipeline_node_shards",
+        "Number of shards produced by demultiplexer node session", shardsBuckets, labels);
+    return metrics;
+}
+
+static std::string modelLabels(const std::string& modelName, int64_t version) {
+    return "model=\"" + escapeLabelValue(modelName) + "\",version=\"" + std::to_string(version) + "\"";
+}
+
+ModelMetrics ModelMetrics::create(MetricRegistry& registry, const std::string& modelName, int64_t version) {
+    static const std::vector<uint64_t> timeBuckets{100, 500, 1'000, 5'000, 10'000, 50'000, 100'000, 500'000, 1'000'000, 5'000'000};
+    static const std::string stageTimeName = "ovms_model_stage_time_us";
+    static const std::string stageTimeHelp = "Time of model request processing stage, in microseconds";
+    const std::string labels = modelLabels(modelName, version);
+    ModelMetrics metrics;
+    metrics.requests = &registry.getCounter("ovms_model_requests_total",
+        "Number of requests to model version", labels);
+    metrics.getInferRequestTime = &registry.getHistogram(stageTimeName, stageTimeHelp, timeBuckets, labels + ",stage=\"get_infer_request\"");
+    metrics.deserializeTime = &registry.getHistogram(stageTimeName, stageTimeHelp, timeBuckets, labels + ",stage=\"deserialize\"");
+    metrics.predictionTime = &registry.getHistogram(stageTimeName, stageTimeHelp, timeBuckets, labels + ",stage=\"prediction\"");
+    metrics.serializeTime = &registry.getHistogram(stageTimeName, stageTimeHelp, timeBuckets, labels + ",stage=\"serialize\"");
+    metrics.inferRequestsInUse = &registry.getGauge("ovms_model_infer_requests_in_use",
+        "Number of infer requests of model version currently used by requests", labels);
+    metrics.inferRequestsWaiting = &registry.getGauge("ovms_model_infer_requests_waiting",
+        "Number of requests waiting for infer request of model version", labels);
+    metrics.inferRequests = &registry.getGauge("ovms_model_infer_requests",
+        "Number of infer requests of model version", labels);
+    static const std::string memoryName = "ovms_model_memory_bytes";
+    static const std::string memoryHelp = "Estimated memory used by model version, in bytes";
+    metrics.modelFilesMemory = &registry.getGauge(memoryName, memoryHelp, labels + ",component=\"model_files\"");
+    metrics.inferRequestsMemory = &registry.getGauge(memoryName, memoryHelp, labels + ",component=\"infer_requests\"");
+    metrics.sequenceStatesMemory = &registry.getGauge(memoryName, memoryHelp, labels + ",component=\"sequence_states\"");
+    metrics.lockedMemory = &registry.getGauge("ovms_model_locked_memory_bytes",
+        "Memory of model version locked in RAM with lock_memory, in bytes", labels);
+    metrics.busyPercent = &registry.getGauge("ovms_model_infer_requests_busy_percent",
+        "Percentage of time infer requests of model version were held by requests over the last 10 seconds", labels);
+    metrics.queueWaitP95 = &registry.getGauge("ovms_model_queue_wait_p95_us",
+        "95th percentile of time requests waited for infer request of model version over the last 10 seconds, in microseconds", labels);
+    metrics.headroom = &registry.getGauge("ovms_model_headroom_requests_per_second",
+        "Requests per second model version can take in addition before all infer requests are busy, at service time measured over the last 10 seconds", labels);
+    return metrics;
+}
+
+void ModelMetrics::countError(MetricRegistry& registry, const std::string& modelName, int64_t version, const std::string& code) {
+    registry.getCounter("ovms_model_request_errors_total", "Number of failed requests to model version",
+                modelLabels(modelName, version) + ",code=\"" + escapeLabelValue(code) + "\"")
+        .increment();
+}
+
+PipelineMetrics PipelineMetrics::create(MetricRegistry& registry, const std::string& pipelineName) {
+    static const std::vector<uint64_t> timeBuckets{100, 500, 1'000, 5'000, 10'000, 50'000, 100'000, 500'000, 1'000'000, 5'000'000};
+    const std::string labels = "pipeline=\"" + escapeLabelValue(pipelineName) + "\"";
+    PipelineMetrics metrics;
+    metrics.requests = &registry.getCounter("ovms_pipeline_requests_total",
+        "Number of requests to pipeline", labels);
+    metrics.requestTime = &registry.getHistogram("ovms_pipeline_request_time_us",
+        "Pipeline execution time, in microseconds", timeBuckets, labels);
+    return metrics;
+}
+
+void PipelineMetrics::countError(MetricRegistry& registry, const std::string& pipelineName, const std::string& code) {
+    registry.getCounter("ovms_pipeline_request_errors_total", "Number of failed requests to pipeline",
+                "pipeline=\"" + escapeLabelValue(pipelineName) + "\",code=\"" + escapeLabelValue(code) + "\"")
+        .increment();
+}
+
+TenantMetrics TenantMetrics::create(MetricRegistry& registry, const std::string& modelName) {
+    static const std::vector<uint64_t> timeBuckets{100, 500, 1'000, 5'000, 10'000, 50'000, 100'000, 500'000, 1'000'000, 5'000'000};
+    const std::string labels = "model=\"" + escapeLabelValue(modelName) + "\"";
+    TenantMetrics metrics;
+    metrics.inFlight = &registry.getGauge("ovms_tenant_inferences_in_flight",
+        "Number of inferences of model holding a share of server capacity", labels);
+    metrics.waiting = &registry.getGauge("ovms_tenant_requests_waiting",
+        "Number of requests waiting for share of server capacity of model", labels);
+    metrics.throttled = &registry.getCounter("ovms_tenant_throttled_requests_total",
+        "Number of requests of model which waited for share of server capacity", labels);
+    metrics.waitTime = &registry.getHistogram("ovms_tenant_wait_time_us",
+        "Time request of model waited for share of server capacity, in microseconds", timeBuckets, labels);
+    return metrics;
+}
+
+Histogram& getDeviceRequestTimeHistogram(MetricRegistry& registry, const std::string& modelName, int64_t version, const std::string& device) {
+    static const std::vector<uint64_t> timeBuckets{100, 500, 1'000, 5'000, 10'000, 50'000, 100'000, 500'000, 1'000'000, 5'000'000};
+    const std::string labels = modelLabels(modelName, version) + ",device=\"" + escapeLabelValue(device) + "\"";
+    return registry.getHistogram("ovms_device_infer_request_time_us",
+        "Time infer request of model version on device was held by a request, in microseconds", timeBuckets, labels);
+}
+
+Histogram& getModelLoadTimeHistogram(MetricRegistry& registry, const std::string& modelName, int64_t version, const std::string& phase) {
+    static const std::vector<uint64_t> timeBuckets{1'000, 10'000, 100'000, 500'000, 1'000'000, 5'000'000, 10'000'000, 30'000'000, 60'000'000, 300'000'000};
+    const std::string labels = modelLabels(modelName, version) + ",phase=\"" + escapeLabelValue(phase) + "\"";
+    return registry.getHistogram("ovms_model_load_time_us",
+        "Time of model version load phase, in microseconds", timeBuckets, labels);
+}
+
+}  // namespace ovms
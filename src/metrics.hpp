@@ -0,0 +1,263 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Monotonic counter, increments go to per thread shards so that hot counters are not contended
+ */
+class Counter {
+    static constexpr size_t SHARDS_COUNT = 16;
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value = 0;
+    };
+    Shard shards[SHARDS_COUNT];
+
+public:
+    void increment(uint64_t value = 1) {
+        static thread_local const size_t shard = std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARDS_COUNT;
+        shards[shard].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const;
+};
+
+/**
+ * @brief Value that goes up and down, e.g. number of busy infer requests
+ */
+class Gauge {
+    std::atomic<int64_t> value = 0;
+
+public:
+    void add(int64_t delta) { value.fetch_add(delta, std::memory_order_relaxed); }
+    void set(int64_t value) { this->value.store(value, std::memory_order_relaxed); }
+    int64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Histogram of integer observations with fixed bucket upper bounds, lock free to update
+ */
+class Histogram {
+    const std::vector<uint64_t> bucketBounds;
+    // one counter per bucket bound and the last one for observations above all bounds
+    std::unique_ptr<std::atomic<uint64_t>[]> bucketCounts;
+    std::atomic<uint64_t> sum = 0;
+    std::atomic<uint64_t> count = 0;
+
+public:
+    explicit Histogram(const std::vector<uint64_t>& bucketBounds);
+
+    void observe(uint64_t value);
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t getSum() const { return sum.load(std::memory_order_relaxed); }
+    const std::vector<uint64_t>& getBucketBounds() const { return bucketBounds; }
+
+    /**
+     * @brief Gets observation counts of buckets, the last one counts observations above all bounds
+     */
+    std::vector<uint64_t> getBucketCounts() const;
+
+    /**
+     * @brief Appends histogram in Prometheus text exposition format
+     *
+     * @param name metric family name
+     * @param labels comma separated label pairs without braces, may be empty
+     * @param out
+     */
+    void serialize(const std::string& name, const std::string& labels, std::string& out) const;
+};
+
+/**
+ * @brief Registry of server metrics exposed through metrics endpoint
+ *
+ * Metrics are created on first use and live until server shutdown, so references to them can be kept.
+ */
+class MetricRegistry {
+    struct Family {
+        std::string type;
+        std::string help;
+        std::vector<uint64_t> bucketBounds;
+        // keyed by labels, only the map matching family type is used
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, Family> families;
+
+    Family& getFamily(const std::string& name, const std::string& type, const std::string& help, const std::vector<uint64_t>& bucketBounds = {});
+
+public:
+    static MetricRegistry& getInstance() {
+        static MetricRegistry instance;
+        return instance;
+    }
+
+    /**
+     * @brief Gets histogram of metric family for labels, creating it if needed
+     *
+     * Help and bucket bounds are taken from the first call for the family.
+     */
+    Histogram& getHistogram(const std::string& name, const std::string& help, const std::vector<uint64_t>& bucketBounds, const std::string& labels);
+
+    /**
+     * @brief Gets counter of metric family for labels, creating it if needed
+     */
+    Counter& getCounter(const std::string& name, const std::string& help, const std::string& labels);
+
+    /**
+     * @brief Gets gauge of metric family for labels, creating it if needed
+     */
+    Gauge& getGauge(const std::string& name, const std::string& help, const std::string& labels);
+
+    /**
+     * @brief Serializes all metrics in Prometheus text exposition format
+     */
+    std::string serialize() const;
+};
+
+/**
+ * @brief Histograms of single pipeline node, empty pointers when node is not instrumented
+ */
+struct NodeMetrics {
+    Histogram* inputsWaitTime = nullptr;
+    Histogram* streamWaitTime = nullptr;
+    Histogram* executionTime = nullptr;
+    Histogram* outputBytes = nullptr;
+    Histogram* shardsCount = nullptr;
+
+    /**
+     * @brief Gets histograms of pipeline node from registry
+     */
+    static NodeMetrics create(MetricRegistry& registry, const std::string& pipelineName, const std::string& nodeName);
+};
+
+/**
+ * @brief Request metrics of single model version, empty pointers when model is not instrumented
+ */
+struct ModelMetrics {
+    Counter* requests = nullptr;
+    Histogram* getInferRequestTime = nullptr;
+    Histogram* deserializeTime = nullptr;
+    Histogram* predictionTime = nullptr;
+    Histogram* serializeTime = nullptr;
+    Gauge* inferRequestsInUse = nullptr;
+    Gauge* inferRequestsWaiting = nullptr;
+    Gauge* inferRequests = nullptr;
+    Gauge* modelFilesMemory = nullptr;
+    Gauge* inferRequestsMemory = nullptr;
+    Gauge* sequenceStatesMemory = nullptr;
+    Gauge* lockedMemory = nullptr;
+    Gauge* busyPercent = nullptr;
+    Gauge* queueWaitP95 = nullptr;
+    Gauge* headroom = nullptr;
+
+    /**
+     * @brief Gets metrics of model version from registry
+     */
+    static ModelMetrics create(MetricRegistry& registry, const std::string& modelName, int64_t version);
+
+    /**
+     * @brief Counts failed request of model version by status code
+     *
+     * Looks up counter in registry, errors are expected to be rare comparing to successful requests
+     */
+    static void countError(MetricRegistry& registry, const std::string& modelName, int64_t version, const std::string& code);
+};
+
+/**
+ * @brief Request metrics of single pipeline, empty pointers when pipeline is not instrumented
+ */
+struct PipelineMetrics {
+    Counter* requests = nullptr;
+    Histogram* requestTime = nullptr;
+
+    /**
+     * @brief Gets metrics of pipeline from registry
+     */
+    static PipelineMetrics create(MetricRegistry& registry, const std::string& pipelineName);
+
+    /**
+     * @brief Counts failed request of pipeline by status code
+     */
+    static void countError(MetricRegistry& registry, const std::string& pipelineName, const std::string& code);
+};
+
+/**
+ * @brief Saturation metrics of model sharing server capacity, empty wait time histogram when model is not instrumented
+ */
+struct TenantMetrics {
+    Gauge* inFlight = nullptr;
+    Gauge* waiting = nullptr;
+    Counter* throttled = nullptr;
+    Histogram* waitTime = nullptr;
+
+    /**
+     * @brief Gets metrics of model from registry
+     */
+    static TenantMetrics create(MetricRegistry& registry, const std::string& modelName);
+};
+
+/**
+ * @brief Gets histogram of time infer requests of model version on device are held by requests, in microseconds
+ */
+Histogram& getDeviceRequestTimeHistogram(MetricRegistry& registry, const std::string& modelName, int64_t version, const std::string& device);
+
+/**
+ * @brief Gets histogram of durations of model version load phase, in microseconds
+ */
+Histogram& getModelLoadTimeHistogram(MetricRegistry& registry, const std::string& modelName, int64_t version, const std::string& phase);
+
+/**
+ * @brief Records observation in histogram if node is instrumented
+ */
+inline void observe(Histogram* histogram, uint64_t value) {
+    if (histogram) {
+        histogram->observe(value);
+    }
+}
+
+inline void increment(Counter* counter) {
+    if (counter) {
+        counter->increment();
+    }
+}
+
+inline void add(Gauge* gauge, int64_t delta) {
+    if (gauge) {
+        gauge->add(delta);
+    }
+}
+
+inline void set(Gauge* gauge, int64_t value) {
+    if (gauge) {
+        gauge->set(value);
+    }
+}
+
+}  // namespace ovms
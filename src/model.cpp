@@ -15,33 +15,87 @@
 //*****************************************************************************
 #include "model.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <utility>
 
+#include "config.hpp"
 #include "customloaders.hpp"
 #include "localfilesystem.hpp"
 #include "logging.hpp"
 #include "modelmanager.hpp"
 #include "pipelinedefinition.hpp"
+#include "startupprofiler.hpp"
 
 namespace ovms {
 
+/**
+ * Reads files of versions from online storage to memory, subdirectories like warmup data are skipped
+ */
+static StatusCode readModelsToMemory(std::shared_ptr<FileSystem>& fs, ModelConfig& config, const model_versions_t& versions) {
+    auto files = std::make_shared<std::map<model_version_t, model_files_contents_t>>();
+    for (const auto version : versions) {
+        const auto versionPath = fs->joinPath({config.getBasePath(), std::to_string(version)});
+        files_list_t names;
+        auto sc = fs->getDirectoryFiles(versionPath, &names);
+        if (sc != StatusCode::OK) {
+            return sc;
+        }
+        auto& versionFiles = (*files)[version];
+        for (const auto& name : names) {
+            auto contents = std::make_shared<std::string>();
+            sc = fs->readTextFile(fs->joinPath({versionPath, name}), contents.get());
+            if (sc != StatusCode::OK) {
+                return sc;
+            }
+            SPDLOG_DEBUG("Read file: {} of model: {} version: {} to memory ({} bytes)", name, config.getName(), version, contents->size());
+            versionFiles[name] = std::move(contents);
+        }
+    }
+    config.setInMemoryFiles(std::move(files));
+    // versions are not stored locally, so there are no temporary files to clean up
+    config.setLocalPath(config.getBasePath());
+    return StatusCode::OK;
+}
+
 StatusCode downloadModels(std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t> versions) {
     if (versions->size() == 0) {
         return StatusCode::OK;
     }
+    if (ovms::Config::instance().remoteModelInMemory() && std::dynamic_pointer_cast<LocalFileSystem>(fs) == nullptr) {
+        SPDLOG_INFO("Reading model from {} to memory", config.getBasePath());
+        const auto readStart = StartupProfiler::clock_t::now();
+        auto sc = readModelsToMemory(fs, config, *versions);
+        const auto readEnd = StartupProfiler::clock_t::now();
+        if (sc != StatusCode::OK) {
+            SPDLOG_ERROR("Couldn't read model from {}", config.getBasePath());
+            return sc;
+        }
+        config.setDownloadTimeUs(std::chrono::duration_cast<std::chrono::microseconds>(readEnd - readStart).count());
+        return StatusCode::OK;
+    }
 
     std::string localPath;
     SPDLOG_INFO("Getting model from {}", config.getBasePath());
+    const auto downloadStart = StartupProfiler::clock_t::now();
     auto sc = fs->downloadModelVersions(config.getBasePath(), &localPath, *versions);
+    const auto downloadEnd = StartupProfiler::clock_t::now();
+    std::stringstream versionsList;
+    for (size_t i = 0; i < versions->size(); ++i) {
+        versionsList << (i ? "," : "") << versions->at(i);
+    }
+    StartupProfiler::instance().addEvent("download", "model_load", downloadStart, downloadEnd,
+        {{"model", config.getName()}, {"versions", versionsList.str()}, {"base_path", config.getBasePath()}});
     if (sc != StatusCode::OK) {
         SPDLOG_ERROR("Couldn't download model from {}", config.getBasePath());
         return sc;
     }
     config.setLocalPath(localPath);
+    // reported as download phase of each version load
+    config.setDownloadTimeUs(std::chrono::duration_cast<std::chrono::microseconds>(downloadEnd - downloadStart).count());
     SPDLOG_INFO("Model downloaded to {}", config.getLocalPath());
 
     return StatusCode::OK;
@@ -82,11 +136,12 @@ const std::map<model_version_t, std::shared_ptr<ModelInstance>>& Model::getModel
 
 void Model::updateDefaultVersion(int ignoredVersion) {
     model_version_t newDefaultVersion = 0;
-    SPDLOG_INFO("Updating default version for model: {}, from: {}", getName(), defaultVersion);
+    SPDLOG_INFO("Updating default version for model: {}, from: {}", getName(), getDefaultVersion());
     for (const auto& [version, versionInstance] : modelVersions) {
         if (version != ignoredVersion &&
             version > newDefaultVersion &&
-            ModelVersionState::AVAILABLE == versionInstance->getStatus().getState()) {
+            (ModelVersionState::AVAILABLE == versionInstance->getStatus().getState() ||
+                (versionInstance->isLoadedOnDemand() && ModelVersionState::START == versionInstance->getStatus().getState()))) {
             newDefaultVersion = version;
         }
     }
@@ -267,8 +322,26 @@ Status Model::reloadVersions(std::shared_ptr<model_versions_t> versionsToReload,
             downloadModels(fs, config, versionsToReload);
         } else {
             config.setLocalPath(modelVersion->getModelConfig().getLocalPath());
+            config.setInMemoryFiles(modelVersion->getModelConfig().getAllInMemoryFiles());
+        }
+        if (modelVersion->getStatus().getState() == ModelVersionState::AVAILABLE &&
+            modelVersion->getModelConfig().isInferRequestsQueueReloadSufficient(config)) {
+            status = modelVersion->reloadInferRequestsQueue(config);
+            if (!status.ok()) {
+                SPDLOG_WARN("Recreating infer requests of model: {}; version: {} failed: {}; reloading the model",
+                    getName(), version, status.string());
+                status = modelVersion->reloadModel(config);
+            }
+        } else if (canReplaceVersion(*modelVersion, config)) {
+            status = replaceVersion(modelVersion, config);
+            if (!status.ok()) {
+                SPDLOG_WARN("Loading model: {}; version: {} next to the serving instance failed: {}; reloading in place",
+                    getName(), version, status.string());
+                status = modelVersion->reloadModel(config);
+            }
+        } else {
+            status = modelVersion->reloadModel(config);
         }
-        status = modelVersion->reloadModel(config);
         if (!status.ok()) {
             SPDLOG_ERROR("Error occurred while loading model: {}; version: {}; error: {}",
                 getName(),
@@ -284,6 +357,35 @@ Status Model::reloadVersions(std::shared_ptr<model_versions_t> versionsToReload,
     return result;
 }
 
+bool Model::canReplaceVersion(const ModelInstance& instance, const ModelConfig& config) const {
+    // stateful instances hold sequences, custom loaders track loaded versions by name
+    // and versions loaded on demand are not compiled on reload
+    return versionReplacementEnabled &&
+           instance.getStatus().getState() == ModelVersionState::AVAILABLE &&
+           !isStateful() &&
+           !instance.isLoadedOnDemand() &&
+           !config.isLazyLoadingEnabled() &&
+           !config.isCustomLoaderRequiredToLoadModel() &&
+           !instance.getModelConfig().isCustomLoaderRequiredToLoadModel();
+}
+
+Status Model::replaceVersion(const std::shared_ptr<ModelInstance>& instance, const ModelConfig& config) {
+    SPDLOG_INFO("Loading model: {}; version: {} while previous instance serves requests", getName(), config.getVersion());
+    auto replacement = modelInstanceFactory(getName(), config.getVersion());
+    auto status = replacement->loadModel(config);
+    if (!status.ok()) {
+        return status;
+    }
+    std::unique_lock lock(modelVersionsMtx);
+    modelVersions[config.getVersion()] = replacement;
+    lock.unlock();
+    replacement->takeOverSubscriptions(*instance);
+    // local model files are used by the replacement, so they are not cleaned up
+    instance->retireModel();
+    SPDLOG_INFO("Switched model: {}; version: {} to new instance", getName(), config.getVersion());
+    return StatusCode::OK;
+}
+
 Status Model::cleanupModelTmpFiles(const ModelConfig& config) {
     auto lfstatus = StatusCode::OK;
 
@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -53,6 +54,24 @@ private:
       */
     void updateDefaultVersion(int ignoredVersion = 0);
 
+    /**
+      * @brief Checks if version can be reloaded next to its instance serving requests
+      */
+    bool canReplaceVersion(const ModelInstance& instance, const ModelConfig& config) const;
+
+    /**
+      * @brief Loads new instance of version while the previous one serves requests and switches requests to it,
+      * previous instance is retired once requests using it finish
+      *
+      * @return status of loading new instance, previous one keeps serving requests on failure
+      */
+    Status replaceVersion(const std::shared_ptr<ModelInstance>& instance, const ModelConfig& config);
+
+    /**
+     * @brief Last status response of all versions, keyed by version statuses changes count
+     */
+    ServiceResponseCache<tensorflow::serving::GetModelStatusResponse> statusResponseCache;
+
 protected:
     /**
          * @brief Model name
@@ -65,20 +84,10 @@ protected:
     std::map<model_version_t, std::shared_ptr<ModelInstance>> modelVersions;
 
     /**
-         * @brief Model default version
+         * @brief Model default version, read without lock while resolving servables
          *
          */
-    model_version_t defaultVersion = 0;
-
-    /**
-         * @brief Get default version
-         *
-         * @return default version
-         */
-    const model_version_t getDefaultVersion() const {
-        SPDLOG_DEBUG("Getting default version for model: {}, {}", getName(), defaultVersion);
-        return defaultVersion;
-    }
+    std::atomic<model_version_t> defaultVersion = 0;
 
     /**
          * @brief Adds a new version of ModelInstance to the list of versions
@@ -104,6 +113,11 @@ protected:
          */
     std::string customLoaderName;
 
+    /**
+         * @brief Whether reloaded versions are loaded next to their serving instances
+         */
+    bool versionReplacementEnabled = true;
+
 public:
     /**
          * @brief Constructor
@@ -121,6 +135,17 @@ public:
          */
     virtual ~Model() {}
 
+    /**
+         * @brief Get default version
+         *
+         * @return default version
+         */
+    const model_version_t getDefaultVersion() const {
+        const model_version_t version = defaultVersion;
+        SPDLOG_DEBUG("Getting default version for model: {}, {}", getName(), version);
+        return version;
+    }
+
     /**
          * @brief Gets the model name
          * 
@@ -155,6 +180,10 @@ public:
      */
     const std::map<model_version_t, const ModelInstance&> getModelVersionsMapCopy() const;
 
+    ServiceResponseCache<tensorflow::serving::GetModelStatusResponse>& getStatusResponseCache() {
+        return statusResponseCache;
+    }
+
     /**
          * @brief Finds ModelInstance with specific version
          *
@@ -237,6 +266,14 @@ public:
         customLoaderName.clear();
     }
 
+    /**
+         * @brief Sets whether reloaded versions are loaded next to their serving instances or in place,
+         * the latter when there is not enough memory for two instances
+         */
+    void setVersionReplacementEnabled(bool enabled) {
+        versionReplacementEnabled = enabled;
+    }
+
     /**
      * @brief Delete temporary model files
      *
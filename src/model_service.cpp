@@ -30,6 +30,7 @@
 #include "tensorflow_serving/apis/model_service.pb.h"
 #pragma GCC diagnostic pop
 
+#include "config.hpp"
 #include "modelmanager.hpp"
 #include "pipelinedefinition.hpp"
 #include "status.hpp"
@@ -46,11 +47,17 @@ void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response,
     status_to_fill->set_version(version);
     status_to_fill->clear_status();
     status_to_fill->mutable_status()->set_error_code(static_cast<tensorflow::error::Code>(static_cast<int>(model_version_status.getErrorCode())));
-    status_to_fill->mutable_status()->set_error_message(model_version_status.getErrorMsg());
+    std::string errorMessage = model_version_status.getErrorMsg();
+    if (!model_version_status.getDetails().empty()) {
+        errorMessage += "; " + model_version_status.getDetails();
+    }
+    if (!model_version_status.getLoadTimes().empty() && Config::instance().modelStatusLoadTimes()) {
+        errorMessage += "; load time: " + model_version_status.getLoadTimes();
+    }
+    status_to_fill->mutable_status()->set_error_message(errorMessage);
 }
 
-void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response, const model_version_t version, const PipelineDefinitionStatus& pipeline_status) {
-    auto [state, error_code] = pipeline_status.convertToModelStatus();
+static void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response, const model_version_t version, ModelVersionState state, ModelVersionStatusErrorCode error_code) {
     SPDLOG_DEBUG("add_status_to_response state={} error_code", state, error_code);
     auto status_to_fill = response->add_model_version_status();
     status_to_fill->set_state(static_cast<tensorflow::serving::ModelVersionStatus_State>(static_cast<int>(state)));
@@ -60,6 +67,33 @@ void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response,
     status_to_fill->mutable_status()->set_error_message(ModelVersionStatusErrorCodeToString(error_code));
 }
 
+void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response, const model_version_t version, const PipelineDefinitionStatus& pipeline_status) {
+    auto [state, error_code] = pipeline_status.convertToModelStatus();
+    addStatusToResponse(response, version, state, error_code);
+}
+
+/**
+ * Returns cached response built for key or builds it with JSON serialization and caches it
+ */
+template <typename Builder>
+static Status findOrBuildResponse(ServiceResponseCache<tensorflow::serving::GetModelStatusResponse>& cache, uint64_t key, Builder build,
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelStatusResponse>>& cached) {
+    cached = cache.find(key);
+    if (cached) {
+        return StatusCode::OK;
+    }
+    tensorflow::serving::GetModelStatusResponse response;
+    build(response);
+    SPDLOG_DEBUG("model_service: response: {}", response.DebugString());
+    std::string json;
+    auto status = GetModelStatusImpl::serializeResponse2Json(&response, &json);
+    if (!status.ok()) {
+        return status;
+    }
+    cached = cache.insert(key, std::move(response), std::move(json));
+    return StatusCode::OK;
+}
+
 ::grpc::Status ModelServiceImpl::GetModelStatus(
     ::grpc::ServerContext* context, const tensorflow::serving::GetModelStatusRequest* request,
     tensorflow::serving::GetModelStatusResponse* response) {
@@ -90,26 +124,57 @@ Status GetModelStatusImpl::getModelStatus(
     const tensorflow::serving::GetModelStatusRequest* request,
     tensorflow::serving::GetModelStatusResponse* response,
     ModelManager& manager) {
-    SPDLOG_DEBUG("model_service: request: {}", request->DebugString());
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelStatusResponse>> cached;
+    auto status = getCachedModelStatus(request, cached, manager);
+    if (!status.ok()) {
+        return status;
+    }
+    *response = cached->response;
+    return StatusCode::OK;
+}
+
+Status GetModelStatusImpl::getModelStatusJson(
+    const tensorflow::serving::GetModelStatusRequest* request,
+    std::string* output,
+    ModelManager& manager) {
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelStatusResponse>> cached;
+    auto status = getCachedModelStatus(request, cached, manager);
+    if (!status.ok()) {
+        return status;
+    }
+    *output = cached->json;
+    return StatusCode::OK;
+}
 
+Status GetModelStatusImpl::getCachedModelStatus(
+    const tensorflow::serving::GetModelStatusRequest* request,
+    std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelStatusResponse>>& cached,
+    ModelManager& manager) {
     bool has_requested_version = request->model_spec().has_version();
     auto requested_version = request->model_spec().version().value();
-    std::string requested_model_name = request->model_spec().name();
+    const std::string& requested_model_name = request->model_spec().name();
     auto model_ptr = manager.findModelByName(requested_model_name);
     if (!model_ptr) {
         SPDLOG_DEBUG("GetModelStatus: Model {} is missing, trying to find pipeline with such name", requested_model_name);
         auto pipelineDefinition = manager.getPipelineFactory().findDefinitionByName(requested_model_name);
         if (!pipelineDefinition) {
-            return StatusCode::MODEL_NAME_MISSING;
+            return manager.isModelLoadPending(requested_model_name) ? StatusCode::MODEL_VERSION_NOT_LOADED_YET : StatusCode::MODEL_NAME_MISSING;
         }
-
-        addStatusToResponse(response, pipelineDefinition->getVersion(), pipelineDefinition->getStatus());
-        SPDLOG_DEBUG("model_service: response: {}", response->DebugString());
+        // response is built from the same converted state it is cached for
+        auto [state, error_code] = pipelineDefinition->getStatus().convertToModelStatus();
+        const uint64_t key = (static_cast<uint64_t>(state) << 32) | static_cast<uint32_t>(error_code);
         SPDLOG_DEBUG("MODEL_STATUS created a response for {} - {}", requested_model_name, requested_version);
-        return StatusCode::OK;
+        return findOrBuildResponse(pipelineDefinition->getStatusResponseCache(), key,
+            [&, state = state, error_code = error_code](tensorflow::serving::GetModelStatusResponse& response) {
+                addStatusToResponse(&response, pipelineDefinition->getVersion(), state, error_code);
+            },
+            cached);
     }
 
     SPDLOG_DEBUG("requested model: {}, has_version: {} (version: {})", requested_model_name, has_requested_version, requested_version);
+    // read before statuses so that response built while any of them changes is not returned later
+    const uint64_t key = ModelVersionStatus::getChangesCount();
+    Status status;
     if (has_requested_version && requested_version != 0) {
         // return details only for a specific version of requested model; NOT_FOUND otherwise. If requested_version == 0, default is returned.
         std::shared_ptr<ModelInstance> model_instance = model_ptr->getModelInstanceByVersion(requested_version);
@@ -117,21 +182,28 @@ Status GetModelStatusImpl::getModelStatus(
             SPDLOG_WARN("requested model {} in version {} was not found.", requested_model_name, requested_version);
             return StatusCode::MODEL_VERSION_MISSING;
         }
-        const auto& status = model_instance->getStatus();
-        SPDLOG_DEBUG("adding model {} - {} :: {} to response", requested_model_name, requested_version, status.getStateString());
-        addStatusToResponse(response, requested_version, status);
+        status = findOrBuildResponse(model_instance->getStatusResponseCache(), key,
+            [&](tensorflow::serving::GetModelStatusResponse& response) {
+                const auto& versionStatus = model_instance->getStatus();
+                SPDLOG_DEBUG("adding model {} - {} :: {} to response", requested_model_name, requested_version, versionStatus.getStateString());
+                addStatusToResponse(&response, requested_version, versionStatus);
+            },
+            cached);
     } else {
         // return status details of all versions of a requested model.
-        auto modelVersionsInstances = model_ptr->getModelVersionsMapCopy();
-        for (const auto& [modelVersion, modelInstance] : modelVersionsInstances) {
-            const auto& status = modelInstance.getStatus();
-            SPDLOG_DEBUG("adding model {} - {} :: {} to response", requested_model_name, modelVersion, status.getStateString());
-            addStatusToResponse(response, modelVersion, status);
-        }
+        status = findOrBuildResponse(model_ptr->getStatusResponseCache(), key,
+            [&](tensorflow::serving::GetModelStatusResponse& response) {
+                auto modelVersionsInstances = model_ptr->getModelVersionsMapCopy();
+                for (const auto& [modelVersion, modelInstance] : modelVersionsInstances) {
+                    const auto& versionStatus = modelInstance.getStatus();
+                    SPDLOG_DEBUG("adding model {} - {} :: {} to response", requested_model_name, modelVersion, versionStatus.getStateString());
+                    addStatusToResponse(&response, modelVersion, versionStatus);
+                }
+            },
+            cached);
     }
-    SPDLOG_DEBUG("model_service: response: {}", response->DebugString());
     SPDLOG_DEBUG("MODEL_STATUS created a response for {} - {}", requested_model_name, requested_version);
-    return StatusCode::OK;
+    return status;
 }
 
 Status GetModelStatusImpl::getAllModelsStatuses(std::map<std::string, tensorflow::serving::GetModelStatusResponse>& modelsStatuses, ModelManager& manager) {
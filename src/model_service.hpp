@@ -16,6 +16,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include <grpcpp/server_context.h>
@@ -29,6 +30,7 @@
 #pragma GCC diagnostic pop
 
 #include "modelmanager.hpp"
+#include "service_response_cache.hpp"
 #include "status.hpp"
 
 namespace ovms {
@@ -46,8 +48,18 @@ public:
 };
 
 class GetModelStatusImpl {
+    /**
+     * @brief Finds response built since last change of servable status or builds and caches it
+     */
+    static Status getCachedModelStatus(const tensorflow::serving::GetModelStatusRequest* request,
+        std::shared_ptr<const CachedServiceResponse<tensorflow::serving::GetModelStatusResponse>>& cached, ModelManager& manager);
+
 public:
     static Status getModelStatus(const tensorflow::serving::GetModelStatusRequest* request, tensorflow::serving::GetModelStatusResponse* response, ModelManager& manager);
+    /**
+     * @brief Returns JSON serialization of the response, serialized once per servable status change
+     */
+    static Status getModelStatusJson(const tensorflow::serving::GetModelStatusRequest* request, std::string* output, ModelManager& manager);
     static Status createGrpcRequest(std::string model_name, const std::optional<int64_t> model_version, tensorflow::serving::GetModelStatusRequest* request);
     static Status serializeResponse2Json(const tensorflow::serving::GetModelStatusResponse* response, std::string* output);
 
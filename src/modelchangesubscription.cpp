@@ -45,6 +45,14 @@ void ModelChangeSubscription::unsubscribe(PipelineDefinition& pd) {
     }
 }
 
+void ModelChangeSubscription::takeOver(ModelChangeSubscription& other) {
+    for (auto& [pipelineName, pipelineDefinition] : other.subscriptions) {
+        SPDLOG_INFO("Subscription to {} from {} moved to {}", other.ownerName, pipelineName, ownerName);
+        subscriptions.insert({pipelineName, pipelineDefinition});
+    }
+    other.subscriptions.clear();
+}
+
 void ModelChangeSubscription::notifySubscribers() {
     if (subscriptions.size() == 0) {
         return;
@@ -37,6 +37,11 @@ public:
 
     void notifySubscribers();
 
+    /**
+     * @brief Moves subscriptions of other owner without notifying subscribers
+     */
+    void takeOver(ModelChangeSubscription& other);
+
     bool isSubscribed() const { return subscriptions.size() > 0; }
 };
 }  // namespace ovms
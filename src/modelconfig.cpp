@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <map>
 #include <set>
 #include <sstream>
 
@@ -58,10 +59,34 @@ bool ModelConfig::isReloadRequired(const ModelConfig& rhs) const {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to maxSequenceNumber mismatch", this->name);
         return true;
     }
+    if (this->maxBoundSequences != rhs.maxBoundSequences) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to maxBoundSequences mismatch", this->name);
+        return true;
+    }
+    if (this->idleSequenceTimeoutSeconds != rhs.idleSequenceTimeoutSeconds) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to idleSequenceTimeoutSeconds mismatch", this->name);
+        return true;
+    }
+    if (this->idleSequenceCompressionSeconds != rhs.idleSequenceCompressionSeconds) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to idleSequenceCompressionSeconds mismatch", this->name);
+        return true;
+    }
     if (this->lowLatencyTransformation != rhs.lowLatencyTransformation) {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to lowLatencyTransformation mismatch", this->name);
         return true;
     }
+    if (this->maxBatchSize != rhs.maxBatchSize) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to maxBatchSize mismatch", this->name);
+        return true;
+    }
+    if (this->batchTimeoutUs != rhs.batchTimeoutUs) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to batchTimeoutUs mismatch", this->name);
+        return true;
+    }
+    if (this->batchLatencyTargetUs != rhs.batchLatencyTargetUs) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to batchLatencyTargetUs mismatch", this->name);
+        return true;
+    }
     if (this->basePath != rhs.basePath) {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to original base path mismatch", this->name);
         return true;
@@ -82,6 +107,82 @@ bool ModelConfig::isReloadRequired(const ModelConfig& rhs) const {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to nireq mismatch", this->name);
         return true;
     }
+    if (this->maxQueueDepth != rhs.maxQueueDepth) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to maxQueueDepth mismatch", this->name);
+        return true;
+    }
+    if (this->maxQueueWaitMs != rhs.maxQueueWaitMs) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to maxQueueWaitMs mismatch", this->name);
+        return true;
+    }
+    if (this->pipelineReservedNireq != rhs.pipelineReservedNireq) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to pipelineReservedNireq mismatch", this->name);
+        return true;
+    }
+    if (this->minNireq != rhs.minNireq || this->nireqCooldownMs != rhs.nireqCooldownMs) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to elastic nireq mismatch", this->name);
+        return true;
+    }
+    if (this->responseCacheSizeMb != rhs.responseCacheSizeMb) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to responseCacheSizeMb mismatch", this->name);
+        return true;
+    }
+    if (this->coalesceRequests != rhs.coalesceRequests) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to coalesceRequests mismatch", this->name);
+        return true;
+    }
+    if (this->batchSplitParallelism != rhs.batchSplitParallelism) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to batchSplitParallelism mismatch", this->name);
+        return true;
+    }
+    if (this->schedulingWeight != rhs.schedulingWeight || this->maxConcurrentInferences != rhs.maxConcurrentInferences) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to scheduling params mismatch", this->name);
+        return true;
+    }
+    if (this->bindInputBlobs != rhs.bindInputBlobs) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to bindInputBlobs mismatch", this->name);
+        return true;
+    }
+    if (this->remoteBlobs != rhs.remoteBlobs) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to remoteBlobs mismatch", this->name);
+        return true;
+    }
+    if (this->lockMemory != rhs.lockMemory) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to lockMemory mismatch", this->name);
+        return true;
+    }
+    if (this->fallbackModelName != rhs.fallbackModelName || this->fallbackModelVersion != rhs.fallbackModelVersion || this->fallbackQueueDepth != rhs.fallbackQueueDepth) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to fallback mismatch", this->name);
+        return true;
+    }
+    if (this->layerProfilingInterval != rhs.layerProfilingInterval) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to layerProfilingInterval mismatch", this->name);
+        return true;
+    }
+    if (this->shapeCacheSize != rhs.shapeCacheSize || this->shapeCachePrewarm != rhs.shapeCachePrewarm) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to shape cache parameters mismatch", this->name);
+        return true;
+    }
+    if (this->batchSizeVariants != rhs.batchSizeVariants) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to batchSizeVariants mismatch", this->name);
+        return true;
+    }
+    if (this->sequenceLengthBuckets != rhs.sequenceLengthBuckets) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to sequenceLengthBuckets mismatch", this->name);
+        return true;
+    }
+    if (this->latencyProfile != rhs.latencyProfile) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to latencyProfile mismatch", this->name);
+        return true;
+    }
+    if (this->attentionMaskInput != rhs.attentionMaskInput) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to attentionMaskInput mismatch", this->name);
+        return true;
+    }
+    if (this->autoTune != rhs.autoTune || this->autoTuneMaxLatencyMs != rhs.autoTuneMaxLatencyMs) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to auto tune mismatch", this->name);
+        return true;
+    }
     if (this->pluginConfig != rhs.pluginConfig) {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to plugin config mismatch", this->name);
         return true;
@@ -90,6 +191,18 @@ bool ModelConfig::isReloadRequired(const ModelConfig& rhs) const {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to no named layout mismatch", this->name);
         return true;
     }
+    if (this->requestPrecisions != rhs.requestPrecisions) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to request precision mismatch", this->name);
+        return true;
+    }
+    if (this->preprocessing != rhs.preprocessing) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to preprocessing mismatch", this->name);
+        return true;
+    }
+    if (this->postprocessing != rhs.postprocessing) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to postprocessing mismatch", this->name);
+        return true;
+    }
     if (this->layouts != rhs.layouts) {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to named layout mismatch", this->name);
         return true;
@@ -104,6 +217,21 @@ bool ModelConfig::isReloadRequired(const ModelConfig& rhs) const {
     return false;
 }
 
+bool ModelConfig::isInferRequestsQueueReloadSufficient(const ModelConfig& rhs) const {
+    // memory states of sequences are kept in infer requests, batch size variants, sequence length buckets and latency profile have queues of their own networks
+    if (this->stateful || rhs.stateful || !this->batchSizeVariants.empty() || !this->sequenceLengthBuckets.empty() || this->latencyProfile.isEnabled()) {
+        return false;
+    }
+    ModelConfig config = *this;
+    config.nireq = rhs.nireq;
+    config.maxQueueDepth = rhs.maxQueueDepth;
+    config.maxQueueWaitMs = rhs.maxQueueWaitMs;
+    config.pipelineReservedNireq = rhs.pipelineReservedNireq;
+    config.minNireq = rhs.minNireq;
+    config.nireqCooldownMs = rhs.nireqCooldownMs;
+    return !config.isReloadRequired(rhs);
+}
+
 bool ModelConfig::isCustomLoaderConfigChanged(const ModelConfig& rhs) const {
     if (this->customLoaderOptionsConfigMap.size() != rhs.customLoaderOptionsConfigMap.size()) {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "ModelConfig {} reload required due to custom loader config mismatch", this->name);
@@ -234,6 +362,43 @@ Status ModelConfig::parsePluginConfig(const rapidjson::Value& node) {
     return StatusCode::OK;
 }
 
+Status ModelConfig::parseLatencyProfileParameter(const rapidjson::Value& node) {
+    if (!node.IsObject() || !node.HasMember("nireq") || !node["nireq"].IsUint() || node["nireq"].GetUint() == 0) {
+        SPDLOG_ERROR("Latency profile has to be an object with positive nireq");
+        return StatusCode::INVALID_LATENCY_PROFILE;
+    }
+    LatencyProfile profile;
+    profile.nireq = node["nireq"].GetUint();
+    if (node.HasMember("batch_size")) {
+        if (!node["batch_size"].IsUint() || node["batch_size"].GetUint() == 0) {
+            SPDLOG_ERROR("Latency profile batch_size has to be positive unsigned int value");
+            return StatusCode::INVALID_LATENCY_PROFILE;
+        }
+        profile.batchSize = node["batch_size"].GetUint();
+    }
+    if (node.HasMember("min_priority")) {
+        if (!node["min_priority"].IsInt()) {
+            SPDLOG_ERROR("Latency profile min_priority has to be int value");
+            return StatusCode::INVALID_LATENCY_PROFILE;
+        }
+        profile.minPriority = node["min_priority"].GetInt();
+    }
+    if (node.HasMember("plugin_config")) {
+        const auto& pluginConfigNode = node["plugin_config"];
+        if (!pluginConfigNode.IsObject()) {
+            return StatusCode::PLUGIN_CONFIG_WRONG_FORMAT;
+        }
+        for (auto it = pluginConfigNode.MemberBegin(); it != pluginConfigNode.MemberEnd(); ++it) {
+            if (!it->value.IsString()) {
+                return StatusCode::PLUGIN_CONFIG_WRONG_FORMAT;
+            }
+            profile.pluginConfig[it->name.GetString()] = it->value.GetString();
+        }
+    }
+    setLatencyProfile(profile);
+    return StatusCode::OK;
+}
+
 Status ModelConfig::parseShapeParameter(const rapidjson::Value& node) {
     if (!node.IsObject()) {
         return StatusCode::SHAPE_WRONG_FORMAT;
@@ -310,6 +475,131 @@ Status ModelConfig::parseLayoutParameter(const rapidjson::Value& node) {
     return StatusCode::OK;
 }
 
+Status ModelConfig::parsePreprocessingParameter(const rapidjson::Value& node) {
+    static const std::set<std::string> allowedResizeAlgorithms{"BILINEAR", "AREA"};
+    static const std::set<std::string> allowedColorFormats{"RGB", "BGR", "RGBX", "BGRX", "NV12", "I420"};
+    if (!node.IsObject()) {
+        return StatusCode::INVALID_PREPROCESSING;
+    }
+
+    preprocessing_map_t preprocessing;
+    for (auto it = node.MemberBegin(); it != node.MemberEnd(); ++it) {
+        const std::string inputName = it->name.GetString();
+        if (!it->value.IsObject()) {
+            SPDLOG_ERROR("Preprocessing of input {} has to be an object", inputName);
+            return StatusCode::INVALID_PREPROCESSING;
+        }
+        InputPreprocessing inputPreprocessing;
+        for (auto step = it->value.MemberBegin(); step != it->value.MemberEnd(); ++step) {
+            const std::string stepName = step->name.GetString();
+            if (stepName == "resize" || stepName == "color_format") {
+                if (!step->value.IsString()) {
+                    SPDLOG_ERROR("Preprocessing {} of input {} has to be a string", stepName, inputName);
+                    return StatusCode::INVALID_PREPROCESSING;
+                }
+                std::string value = step->value.GetString();
+                std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+                const auto& allowedValues = stepName == "resize" ? allowedResizeAlgorithms : allowedColorFormats;
+                if (allowedValues.count(value) == 0) {
+                    SPDLOG_ERROR("Preprocessing {}: {} of input {} is not supported", stepName, value, inputName);
+                    return StatusCode::INVALID_PREPROCESSING;
+                }
+                (stepName == "resize" ? inputPreprocessing.resizeAlgorithm : inputPreprocessing.colorFormat) = value;
+            } else if (stepName == "mean_values" || stepName == "scale_values") {
+                if (!step->value.IsArray() || step->value.Size() == 0) {
+                    SPDLOG_ERROR("Preprocessing {} of input {} has to be a non empty array of numbers", stepName, inputName);
+                    return StatusCode::INVALID_PREPROCESSING;
+                }
+                auto& values = stepName == "mean_values" ? inputPreprocessing.meanValues : inputPreprocessing.scaleValues;
+                for (const auto& value : step->value.GetArray()) {
+                    if (!value.IsNumber() || (stepName == "scale_values" && value.GetFloat() == 0.0f)) {
+                        SPDLOG_ERROR("Preprocessing {} of input {} has to be a non empty array of numbers, scale values cannot be zero", stepName, inputName);
+                        return StatusCode::INVALID_PREPROCESSING;
+                    }
+                    values.push_back(value.GetFloat());
+                }
+            } else {
+                SPDLOG_ERROR("Preprocessing {} of input {} is not supported", stepName, inputName);
+                return StatusCode::INVALID_PREPROCESSING;
+            }
+        }
+        preprocessing[inputName] = std::move(inputPreprocessing);
+    }
+    setPreprocessing(preprocessing);
+
+    return StatusCode::OK;
+}
+
+Status ModelConfig::parsePostprocessingParameter(const rapidjson::Value& node) {
+    // postprocessing type and parameters it accepts
+    static const std::map<std::string, std::set<std::string>> allowedTypes{
+        {"top_k", {"k"}},
+        {"argmax", {}},
+        {"threshold", {"threshold"}},
+        {"fp16", {}},
+        {"bf16", {}},
+        {"int8", {"scale"}},
+        {"rle", {}},
+        {"png", {"scale"}},
+        {"jpeg", {"scale"}}};
+    if (!node.IsObject()) {
+        return StatusCode::INVALID_POSTPROCESSING;
+    }
+
+    postprocessing_map_t postprocessing;
+    for (auto it = node.MemberBegin(); it != node.MemberEnd(); ++it) {
+        const std::string outputName = it->name.GetString();
+        if (!it->value.IsObject() || !it->value.HasMember("type") || !it->value["type"].IsString()) {
+            SPDLOG_ERROR("Postprocessing of output {} has to be an object with type", outputName);
+            return StatusCode::INVALID_POSTPROCESSING;
+        }
+        OutputPostprocessing outputPostprocessing;
+        outputPostprocessing.type = it->value["type"].GetString();
+        std::transform(outputPostprocessing.type.begin(), outputPostprocessing.type.end(), outputPostprocessing.type.begin(), ::tolower);
+        auto allowedType = allowedTypes.find(outputPostprocessing.type);
+        if (allowedType == allowedTypes.end()) {
+            SPDLOG_ERROR("Postprocessing {} of output {} is not supported", outputPostprocessing.type, outputName);
+            return StatusCode::INVALID_POSTPROCESSING;
+        }
+        const auto& allowedParameters = allowedType->second;
+        for (auto parameter = it->value.MemberBegin(); parameter != it->value.MemberEnd(); ++parameter) {
+            const std::string parameterName = parameter->name.GetString();
+            if (parameterName != "type" && allowedParameters.count(parameterName) == 0) {
+                SPDLOG_ERROR("Postprocessing {} of output {} does not accept parameter {}", outputPostprocessing.type, outputName, parameterName);
+                return StatusCode::INVALID_POSTPROCESSING;
+            }
+        }
+        if (outputPostprocessing.type == "top_k") {
+            if (!it->value.HasMember("k") || !it->value["k"].IsUint() || it->value["k"].GetUint() == 0) {
+                SPDLOG_ERROR("Postprocessing top_k of output {} requires positive k", outputName);
+                return StatusCode::INVALID_POSTPROCESSING;
+            }
+            outputPostprocessing.k = it->value["k"].GetUint();
+        } else if (outputPostprocessing.type == "threshold") {
+            if (!it->value.HasMember("threshold") || !it->value["threshold"].IsNumber()) {
+                SPDLOG_ERROR("Postprocessing threshold of output {} requires threshold number", outputName);
+                return StatusCode::INVALID_POSTPROCESSING;
+            }
+            outputPostprocessing.threshold = it->value["threshold"].GetFloat();
+        } else if (outputPostprocessing.type == "int8" && !it->value.HasMember("scale")) {
+            // image encodings default to values already in 0-255 range, int8 has no sensible default
+            SPDLOG_ERROR("Postprocessing int8 of output {} requires scale", outputName);
+            return StatusCode::INVALID_POSTPROCESSING;
+        }
+        if (it->value.HasMember("scale")) {
+            if (!it->value["scale"].IsNumber() || !(it->value["scale"].GetFloat() > 0.0f)) {
+                SPDLOG_ERROR("Postprocessing {} of output {} requires positive scale", outputPostprocessing.type, outputName);
+                return StatusCode::INVALID_POSTPROCESSING;
+            }
+            outputPostprocessing.scale = it->value["scale"].GetFloat();
+        }
+        postprocessing[outputName] = std::move(outputPostprocessing);
+    }
+    setPostprocessing(postprocessing);
+
+    return StatusCode::OK;
+}
+
 Status ModelConfig::parseLayoutParameter(const std::string& command) {
     this->layouts.clear();
     this->layout = std::string();
@@ -377,14 +667,23 @@ Status ModelConfig::parseModelMapping() {
     std::filesystem::path path = this->getPath();
     path.append(MAPPING_CONFIG_JSON);
 
-    std::ifstream ifs(path.c_str());
-    if (!ifs.good()) {
-        return StatusCode::FILE_INVALID;
-    }
-
     rapidjson::Document doc;
-    rapidjson::IStreamWrapper isw(ifs);
-    if (doc.ParseStream(isw).HasParseError()) {
+    const auto* inMemoryFiles = getInMemoryFiles();
+    if (inMemoryFiles) {
+        auto it = inMemoryFiles->find(MAPPING_CONFIG_JSON);
+        if (it == inMemoryFiles->end()) {
+            return StatusCode::FILE_INVALID;
+        }
+        doc.Parse(it->second->c_str(), it->second->size());
+    } else {
+        std::ifstream ifs(path.c_str());
+        if (!ifs.good()) {
+            return StatusCode::FILE_INVALID;
+        }
+        rapidjson::IStreamWrapper isw(ifs);
+        doc.ParseStream(isw);
+    }
+    if (doc.HasParseError()) {
         SPDLOG_ERROR("Configuration file is not a valid JSON file.");
         return StatusCode::JSON_INVALID;
     }
@@ -434,6 +733,27 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
     }
     if (v.HasMember("nireq"))
         this->setNireq(v["nireq"].GetUint64());
+    if (v.HasMember("max_queue_depth")) {
+        if (!v["max_queue_depth"].IsUint()) {
+            SPDLOG_ERROR("Max queue depth parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_QUEUE_LIMIT;
+        }
+        this->setMaxQueueDepth(v["max_queue_depth"].GetUint());
+    }
+    if (v.HasMember("max_queue_wait_ms")) {
+        if (!v["max_queue_wait_ms"].IsUint()) {
+            SPDLOG_ERROR("Max queue wait parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_QUEUE_LIMIT;
+        }
+        this->setMaxQueueWaitMs(v["max_queue_wait_ms"].GetUint());
+    }
+    if (v.HasMember("pipeline_reserved_nireq")) {
+        if (!v["pipeline_reserved_nireq"].IsUint()) {
+            SPDLOG_ERROR("Pipeline reserved nireq parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_NIREQ;
+        }
+        this->setPipelineReservedNireq(v["pipeline_reserved_nireq"].GetUint());
+    }
 
     if (v.HasMember("shape")) {
         // Legacy format as string
@@ -502,6 +822,38 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
         }
     }
 
+    if (v.HasMember("request_precision")) {
+        request_precisions_map_t requestPrecisions;
+        for (auto it = v["request_precision"].MemberBegin(); it != v["request_precision"].MemberEnd(); ++it) {
+            if (!it->value.IsString()) {
+                SPDLOG_ERROR("Request precision for input {} of model {} has to be a string.", it->name.GetString(), v["name"].GetString());
+                return StatusCode::INVALID_REQUEST_PRECISION;
+            }
+            std::string precision = it->value.GetString();
+            std::transform(precision.begin(), precision.end(), precision.begin(), ::toupper);
+            if (precision != "FP32") {
+                SPDLOG_ERROR("Request precision {} for input {} of model {} is not supported.", precision, it->name.GetString(), v["name"].GetString());
+                return StatusCode::INVALID_REQUEST_PRECISION;
+            }
+            requestPrecisions[it->name.GetString()] = precision;
+        }
+        this->setRequestPrecisions(requestPrecisions);
+    }
+
+    if (v.HasMember("preprocessing")) {
+        auto status = this->parsePreprocessingParameter(v["preprocessing"]);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+
+    if (v.HasMember("postprocessing")) {
+        auto status = this->parsePostprocessingParameter(v["postprocessing"]);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+
     if (v.HasMember("plugin_config")) {
         auto status = parsePluginConfig(v["plugin_config"]);
         if (!status.ok()) {
@@ -543,6 +895,271 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
         this->setMaxSequenceNumber(v["max_sequence_number"].GetUint());
     }
 
+    if (v.HasMember("max_bound_sequences")) {
+        if (!this->isStateful()) {
+            SPDLOG_ERROR("Max bound sequences parameter was set for non stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_NON_STATEFUL_MODEL_PARAMETER;
+        }
+        if (!v["max_bound_sequences"].IsUint()) {
+            SPDLOG_ERROR("Max bound sequences parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_MAX_BOUND_SEQUENCES;
+        }
+        this->setMaxBoundSequences(v["max_bound_sequences"].GetUint());
+    }
+
+    if (v.HasMember("idle_sequence_timeout_seconds")) {
+        if (!this->isStateful()) {
+            SPDLOG_ERROR("Idle sequence timeout parameter was set for non stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_NON_STATEFUL_MODEL_PARAMETER;
+        }
+        if (!v["idle_sequence_timeout_seconds"].IsUint()) {
+            SPDLOG_ERROR("Idle sequence timeout parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_IDLE_SEQUENCE_TIMEOUT;
+        }
+        this->setIdleSequenceTimeoutSeconds(v["idle_sequence_timeout_seconds"].GetUint());
+    }
+
+    if (v.HasMember("idle_sequence_compression_seconds")) {
+        if (!this->isStateful()) {
+            SPDLOG_ERROR("Idle sequence compression parameter was set for non stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_NON_STATEFUL_MODEL_PARAMETER;
+        }
+        if (!v["idle_sequence_compression_seconds"].IsUint()) {
+            SPDLOG_ERROR("Idle sequence compression parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_IDLE_SEQUENCE_COMPRESSION;
+        }
+        this->setIdleSequenceCompressionSeconds(v["idle_sequence_compression_seconds"].GetUint());
+    }
+
+    if (v.HasMember("max_batch_size")) {
+        if (!v["max_batch_size"].IsUint()) {
+            SPDLOG_ERROR("Max batch size parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS;
+        }
+        this->setMaxBatchSize(v["max_batch_size"].GetUint());
+    }
+
+    if (v.HasMember("batch_timeout_us")) {
+        if (!this->isDynamicBatchingEnabled()) {
+            SPDLOG_ERROR("Batch timeout parameter was set for model {} without max_batch_size.", v["name"].GetString());
+            return StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS;
+        }
+        if (!v["batch_timeout_us"].IsUint()) {
+            SPDLOG_ERROR("Batch timeout parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS;
+        }
+        this->setBatchTimeoutUs(v["batch_timeout_us"].GetUint());
+    }
+
+    if (v.HasMember("batch_latency_target_us")) {
+        if (!this->isDynamicBatchingEnabled()) {
+            SPDLOG_ERROR("Batch latency target parameter was set for model {} without max_batch_size.", v["name"].GetString());
+            return StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS;
+        }
+        if (!v["batch_latency_target_us"].IsUint()) {
+            SPDLOG_ERROR("Batch latency target parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS;
+        }
+        this->setBatchLatencyTargetUs(v["batch_latency_target_us"].GetUint());
+    }
+
+    if (v.HasMember("shape_cache_size")) {
+        if (!v["shape_cache_size"].IsUint()) {
+            SPDLOG_ERROR("Shape cache size parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_SHAPE_CACHE_SIZE;
+        }
+        this->setShapeCacheSize(v["shape_cache_size"].GetUint());
+        if (this->isShapeCacheEnabled() && !this->anyShapeSetToAuto()) {
+            SPDLOG_ERROR("Shape cache size parameter was set for model {} without any input shape set to auto.", v["name"].GetString());
+            return StatusCode::INVALID_SHAPE_CACHE_SIZE;
+        }
+    }
+
+    if (v.HasMember("shape_cache_prewarm")) {
+        this->setShapeCachePrewarm(v["shape_cache_prewarm"].GetBool());
+        if (this->isShapeCachePrewarmEnabled() && !this->isShapeCacheEnabled()) {
+            SPDLOG_ERROR("Shape cache prewarm parameter was set for model {} without shape cache size.", v["name"].GetString());
+            return StatusCode::INVALID_SHAPE_CACHE_SIZE;
+        }
+    }
+
+    if (v.HasMember("batch_size_variants")) {
+        if (this->getBatchingMode() != AUTO) {
+            SPDLOG_ERROR("Batch size variants were set for model {} without batch size set to auto.", v["name"].GetString());
+            return StatusCode::INVALID_BATCH_SIZE_VARIANTS;
+        }
+        std::set<size_t> variants;
+        for (const auto& variant : v["batch_size_variants"].GetArray()) {
+            if (!variant.IsUint() || variant.GetUint() == 0) {
+                SPDLOG_ERROR("Batch size variants for model {} have to be positive unsigned int values.", v["name"].GetString());
+                return StatusCode::INVALID_BATCH_SIZE_VARIANTS;
+            }
+            variants.insert(variant.GetUint());
+        }
+        this->setBatchSizeVariants(variants);
+    }
+
+    if (v.HasMember("sequence_length_buckets")) {
+        std::set<size_t> buckets;
+        for (const auto& bucket : v["sequence_length_buckets"].GetArray()) {
+            if (!bucket.IsUint() || bucket.GetUint() == 0) {
+                SPDLOG_ERROR("Sequence length buckets for model {} have to be positive unsigned int values.", v["name"].GetString());
+                return StatusCode::INVALID_SEQUENCE_LENGTH_BUCKETS;
+            }
+            buckets.insert(bucket.GetUint());
+        }
+        this->setSequenceLengthBuckets(buckets);
+    }
+
+    if (v.HasMember("latency_profile")) {
+        auto status = this->parseLatencyProfileParameter(v["latency_profile"]);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+
+    if (v.HasMember("attention_mask_input")) {
+        if (this->getSequenceLengthBuckets().empty()) {
+            SPDLOG_ERROR("Attention mask input was set for model {} without sequence length buckets.", v["name"].GetString());
+            return StatusCode::INVALID_SEQUENCE_LENGTH_BUCKETS;
+        }
+        this->setAttentionMaskInput(v["attention_mask_input"].GetString());
+    }
+
+    if (v.HasMember("warmup_iterations")) {
+        if (!v["warmup_iterations"].IsUint()) {
+            SPDLOG_ERROR("Warmup iterations parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_WARMUP_ITERATIONS;
+        }
+        this->setWarmupIterations(v["warmup_iterations"].GetUint());
+    }
+
+    if (v.HasMember("auto_tune")) {
+        this->setAutoTune(v["auto_tune"].GetBool());
+    }
+
+    if (v.HasMember("auto_tune_max_latency_ms")) {
+        if (!v["auto_tune_max_latency_ms"].IsUint()) {
+            SPDLOG_ERROR("Auto tune max latency parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_AUTO_TUNE_MAX_LATENCY;
+        }
+        this->setAutoTuneMaxLatencyMs(v["auto_tune_max_latency_ms"].GetUint());
+    }
+
+    if (v.HasMember("lazy_loading")) {
+        this->setLazyLoading(v["lazy_loading"].GetBool());
+        if (this->isLazyLoadingEnabled() && this->isStateful()) {
+            SPDLOG_ERROR("Lazy loading was set for stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_LAZY_LOADING;
+        }
+    }
+
+    if (v.HasMember("critical")) {
+        this->setCritical(v["critical"].GetBool());
+    }
+
+    if (v.HasMember("response_cache_size_mb")) {
+        if (!v["response_cache_size_mb"].IsUint()) {
+            SPDLOG_ERROR("Response cache size parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_RESPONSE_CACHE_SIZE;
+        }
+        this->setResponseCacheSizeMb(v["response_cache_size_mb"].GetUint());
+        if (this->isResponseCacheEnabled() && this->isStateful()) {
+            SPDLOG_ERROR("Response cache was set for stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_RESPONSE_CACHE_SIZE;
+        }
+    }
+
+    if (v.HasMember("bind_input_blobs")) {
+        this->setBindInputBlobs(v["bind_input_blobs"].GetBool());
+    }
+
+    if (v.HasMember("remote_blobs")) {
+        this->setRemoteBlobs(v["remote_blobs"].GetBool());
+    }
+
+    if (v.HasMember("lock_memory")) {
+        this->setLockMemory(v["lock_memory"].GetBool());
+    }
+
+    if (v.HasMember("coalesce_requests")) {
+        this->setCoalesceRequests(v["coalesce_requests"].GetBool());
+        if (this->isCoalesceRequestsEnabled() && this->isStateful()) {
+            SPDLOG_ERROR("Request coalescing was set for stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_COALESCE_REQUESTS;
+        }
+    }
+
+    if (v.HasMember("fallback")) {
+        const auto& fallback = v["fallback"];
+        const model_version_t version = fallback.HasMember("model_version") ? fallback["model_version"].GetInt64() : 0;
+        if (this->isStateful()) {
+            SPDLOG_ERROR("Fallback model was set for stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_FALLBACK;
+        }
+        if (fallback["model_name"].GetString() == this->getName() && version == 0) {
+            SPDLOG_ERROR("Fallback of model {} has to be other model or explicit version.", v["name"].GetString());
+            return StatusCode::INVALID_FALLBACK;
+        }
+        this->setFallback(fallback["model_name"].GetString(), version,
+            fallback.HasMember("queue_depth") ? fallback["queue_depth"].GetUint() : 1);
+    }
+
+    if (v.HasMember("layer_profiling_interval")) {
+        this->setLayerProfilingInterval(v["layer_profiling_interval"].GetUint());
+    }
+
+    if (v.HasMember("version_poll_interval_seconds")) {
+        this->setVersionPollIntervalSeconds(v["version_poll_interval_seconds"].GetUint());
+    }
+
+    if (v.HasMember("batch_split_parallelism")) {
+        if (!v["batch_split_parallelism"].IsUint()) {
+            SPDLOG_ERROR("Batch split parallelism parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_BATCH_SPLIT_PARALLELISM;
+        }
+        this->setBatchSplitParallelism(v["batch_split_parallelism"].GetUint());
+        if (this->getBatchSplitParallelism() > 0 && this->isStateful()) {
+            SPDLOG_ERROR("Batch splitting was set for stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_BATCH_SPLIT_PARALLELISM;
+        }
+    }
+
+    if (v.HasMember("min_nireq")) {
+        if (!v["min_nireq"].IsUint()) {
+            SPDLOG_ERROR("Min nireq parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_NIREQ;
+        }
+        this->setMinNireq(v["min_nireq"].GetUint());
+        if (this->getMinNireq() > 0 && this->isStateful()) {
+            SPDLOG_ERROR("Min nireq was set for stateful model {}.", v["name"].GetString());
+            return StatusCode::INVALID_NIREQ;
+        }
+    }
+    if (v.HasMember("nireq_cooldown_ms")) {
+        if (!v["nireq_cooldown_ms"].IsUint()) {
+            SPDLOG_ERROR("Nireq cooldown parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_NIREQ;
+        }
+        this->setNireqCooldownMs(v["nireq_cooldown_ms"].GetUint());
+    }
+
+    if (v.HasMember("scheduling_weight")) {
+        if (!v["scheduling_weight"].IsUint() || v["scheduling_weight"].GetUint() == 0) {
+            SPDLOG_ERROR("Scheduling weight parameter was set to 0 or above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_SCHEDULING_PARAMS;
+        }
+        this->setSchedulingWeight(v["scheduling_weight"].GetUint());
+    }
+
+    if (v.HasMember("max_concurrent_inferences")) {
+        if (!v["max_concurrent_inferences"].IsUint()) {
+            SPDLOG_ERROR("Max concurrent inferences parameter was set above unsigned int value for model {}.", v["name"].GetString());
+            return StatusCode::INVALID_SCHEDULING_PARAMS;
+        }
+        this->setMaxConcurrentInferences(v["max_concurrent_inferences"].GetUint());
+    }
+
     if (v.HasMember("model_version_policy")) {
         rapidjson::StringBuffer buffer;
         buffer.Clear();
@@ -575,6 +1192,62 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
         SPDLOG_DEBUG("model_version_policy: {}", std::string(*getModelVersionPolicy()));
     }
     SPDLOG_DEBUG("nireq: {}", getNireq());
+    SPDLOG_DEBUG("max_queue_depth: {}", getMaxQueueDepth());
+    SPDLOG_DEBUG("max_queue_wait_ms: {}", getMaxQueueWaitMs());
+    SPDLOG_DEBUG("pipeline_reserved_nireq: {}", getPipelineReservedNireq());
+    SPDLOG_DEBUG("min_nireq: {}", getMinNireq());
+    SPDLOG_DEBUG("nireq_cooldown_ms: {}", getNireqCooldownMs());
+    SPDLOG_DEBUG("shape_cache_size: {}", getShapeCacheSize());
+    SPDLOG_DEBUG("shape_cache_prewarm: {}", isShapeCachePrewarmEnabled());
+    SPDLOG_DEBUG("warmup_iterations: {}", getWarmupIterations());
+    SPDLOG_DEBUG("auto_tune: {}", isAutoTuneEnabled());
+    SPDLOG_DEBUG("auto_tune_max_latency_ms: {}", getAutoTuneMaxLatencyMs());
+    SPDLOG_DEBUG("lazy_loading: {}", isLazyLoadingEnabled());
+    SPDLOG_DEBUG("critical: {}", isCritical());
+    SPDLOG_DEBUG("response_cache_size_mb: {}", getResponseCacheSizeMb());
+    SPDLOG_DEBUG("bind_input_blobs: {}", isBindInputBlobsEnabled());
+    SPDLOG_DEBUG("remote_blobs: {}", isRemoteBlobsEnabled());
+    SPDLOG_DEBUG("lock_memory: {}", isLockMemoryEnabled());
+    SPDLOG_DEBUG("coalesce_requests: {}", isCoalesceRequestsEnabled());
+    if (isFallbackEnabled()) {
+        SPDLOG_DEBUG("fallback: model_name: {}; model_version: {}; queue_depth: {}", getFallbackModelName(), getFallbackModelVersion(), getFallbackQueueDepth());
+    }
+    SPDLOG_DEBUG("layer_profiling_interval: {}", getLayerProfilingInterval());
+    SPDLOG_DEBUG("version_poll_interval_seconds: {}", getVersionPollIntervalSeconds());
+    SPDLOG_DEBUG("batch_split_parallelism: {}", getBatchSplitParallelism());
+    SPDLOG_DEBUG("scheduling_weight: {}", getSchedulingWeight());
+    SPDLOG_DEBUG("max_concurrent_inferences: {}", getMaxConcurrentInferences());
+    SPDLOG_DEBUG("request_precision:");
+    for (const auto& [name, precision] : getRequestPrecisions()) {
+        SPDLOG_DEBUG("  {}: {}", name, precision);
+    }
+    SPDLOG_DEBUG("preprocessing:");
+    for (const auto& [name, inputPreprocessing] : getPreprocessing()) {
+        SPDLOG_DEBUG("  {}: resize: {}; color_format: {}; mean_values: {}; scale_values: {}", name,
+            inputPreprocessing.resizeAlgorithm, inputPreprocessing.colorFormat,
+            inputPreprocessing.meanValues.size(), inputPreprocessing.scaleValues.size());
+    }
+    SPDLOG_DEBUG("postprocessing:");
+    for (const auto& [name, outputPostprocessing] : getPostprocessing()) {
+        SPDLOG_DEBUG("  {}: type: {}; k: {}; threshold: {}; scale: {}", name,
+            outputPostprocessing.type, outputPostprocessing.k, outputPostprocessing.threshold, outputPostprocessing.scale);
+    }
+    SPDLOG_DEBUG("batch_size_variants:");
+    for (auto variant : getBatchSizeVariants()) {
+        SPDLOG_DEBUG("  {}", variant);
+    }
+    SPDLOG_DEBUG("sequence_length_buckets:");
+    for (auto bucket : getSequenceLengthBuckets()) {
+        SPDLOG_DEBUG("  {}", bucket);
+    }
+    if (getLatencyProfile().isEnabled()) {
+        SPDLOG_DEBUG("latency_profile: nireq: {}; batch_size: {}; min_priority: {}",
+            getLatencyProfile().nireq, getLatencyProfile().batchSize, getLatencyProfile().minPriority);
+        for (auto& [pluginParameter, pluginValue] : getLatencyProfile().pluginConfig) {
+            SPDLOG_DEBUG("  {}: {}", pluginParameter, pluginValue);
+        }
+    }
+    SPDLOG_DEBUG("attention_mask_input: {}", getAttentionMaskInput());
     SPDLOG_DEBUG("target_device: {}", getTargetDevice());
     SPDLOG_DEBUG("plugin_config:");
     for (auto& [pluginParameter, pluginValue] : getPluginConfig()) {
@@ -595,9 +1268,41 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
     if (isStateful()) {
         SPDLOG_DEBUG("idle_sequence_cleanup: {}", getIdleSequenceCleanup());
         SPDLOG_DEBUG("max_sequence_number: {}", getMaxSequenceNumber());
+        SPDLOG_DEBUG("max_bound_sequences: {}", getMaxBoundSequences());
+        SPDLOG_DEBUG("idle_sequence_timeout_seconds: {}", getIdleSequenceTimeoutSeconds());
+        SPDLOG_DEBUG("idle_sequence_compression_seconds: {}", getIdleSequenceCompressionSeconds());
         SPDLOG_DEBUG("low_latency_transformation: {}", isLowLatencyTransformationUsed());
     }
 
+    if (!getSequenceLengthBuckets().empty() && (getBatchingMode() == AUTO || anyShapeSetToAuto() || isStateful())) {
+        SPDLOG_ERROR("Sequence length buckets cannot be combined with batch_size auto, shape auto or stateful parameters for model {}.", getName());
+        return StatusCode::INVALID_SEQUENCE_LENGTH_BUCKETS;
+    }
+
+    if (getLatencyProfile().isEnabled() && isStateful()) {
+        SPDLOG_ERROR("Latency profile cannot be combined with stateful parameter for model {}.", getName());
+        return StatusCode::INVALID_LATENCY_PROFILE;
+    }
+
+    if (isDynamicBatchingEnabled()) {
+        if (getBatchingMode() == AUTO || shapeSet) {
+            SPDLOG_ERROR("Dynamic batching cannot be combined with batch_size auto or shape parameters for model {}.", getName());
+            return StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS;
+        }
+        if (getMaxBoundSequences() > 0) {
+            SPDLOG_ERROR("Dynamic batching cannot be combined with max_bound_sequences parameter for model {}.", getName());
+            return StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS;
+        }
+        if (getBatchSize() != 0 && getBatchSize() != getMaxBatchSize()) {
+            SPDLOG_WARN("Both batch size and max batch size have been defined for model {}. Batch size parameter will be ignored.", getName());
+        }
+        // network is compiled for the largest batch, partial batches are padded
+        setBatchSize(getMaxBatchSize());
+        SPDLOG_DEBUG("max_batch_size: {}", getMaxBatchSize());
+        SPDLOG_DEBUG("batch_timeout_us: {}", getBatchTimeoutUs());
+        SPDLOG_DEBUG("batch_latency_target_us: {}", getBatchLatencyTargetUs());
+    }
+
     // if the config has models which require custom loader to be used, then load the same here
     if (v.HasMember("custom_loader_options")) {
         if (!parseCustomLoaderOptionsConfig(v["custom_loader_options"]).ok()) {
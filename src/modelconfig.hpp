@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <algorithm>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -22,6 +23,7 @@
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <rapidjson/document.h>
@@ -29,17 +31,141 @@
 #include "model_version_policy.hpp"
 #include "shapeinfo.hpp"
 #include "status.hpp"
+#include "stringutils.hpp"
 
 namespace ovms {
 
 using layouts_map_t = std::unordered_map<std::string, std::string>;
+using request_precisions_map_t = std::unordered_map<std::string, std::string>;
+
+/**
+     * @brief Preprocessing of model input done by OpenVINO during inference
+     */
+struct InputPreprocessing {
+    /**
+         * @brief Resize algorithm name, empty when request data has to match input resolution
+         */
+    std::string resizeAlgorithm;
+
+    /**
+         * @brief Color format of request data, empty when it is the same as network color format
+         */
+    std::string colorFormat;
+
+    /**
+         * @brief Values subtracted from each channel, empty when not used
+         */
+    std::vector<float> meanValues;
+
+    /**
+         * @brief Values each channel is divided by after mean subtraction, empty when not used
+         */
+    std::vector<float> scaleValues;
+
+    bool operator==(const InputPreprocessing& rhs) const {
+        return resizeAlgorithm == rhs.resizeAlgorithm &&
+               colorFormat == rhs.colorFormat &&
+               meanValues == rhs.meanValues &&
+               scaleValues == rhs.scaleValues;
+    }
+
+    bool operator!=(const InputPreprocessing& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+using preprocessing_map_t = std::unordered_map<std::string, InputPreprocessing>;
+
+/**
+     * @brief Postprocessing of model output done by the server before serialization of predict response
+     */
+struct OutputPostprocessing {
+    /**
+         * @brief One of top_k, argmax or threshold reductions, fp16, bf16 or int8 downcasts,
+         * rle run-length encoding or png or jpeg image encoding
+         */
+    std::string type;
+
+    /**
+         * @brief Number of best scores returned by top_k
+         */
+    uint32_t k = 0;
+
+    /**
+         * @brief Minimal score returned by threshold
+         */
+    float threshold = 0.0f;
+
+    /**
+         * @brief Value of single unit of int8, png and jpeg encodings, encoded value is output value divided by scale
+         */
+    float scale = 1.0f;
+
+    bool operator==(const OutputPostprocessing& rhs) const {
+        return type == rhs.type &&
+               k == rhs.k &&
+               threshold == rhs.threshold &&
+               scale == rhs.scale;
+    }
+
+    bool operator!=(const OutputPostprocessing& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+using postprocessing_map_t = std::unordered_map<std::string, OutputPostprocessing>;
 using mapping_config_t = std::unordered_map<std::string, std::string>;
 using plugin_config_t = std::map<std::string, std::string>;
 using custom_loader_options_config_t = std::map<std::string, std::string>;
 
+/**
+     * @brief Second executable network of the model with its own streams and infer requests, tuned for latency of interactive requests
+     */
+struct LatencyProfile {
+    /**
+         * @brief Number of infer requests of the network, 0 disables the profile
+         */
+    uint32_t nireq = 0;
+
+    /**
+         * @brief Batch size the network is compiled for, only requests with this batch size are routed to it
+         */
+    size_t batchSize = 1;
+
+    /**
+         * @brief Plugin config entries replacing the ones of the model, streams are set to 1 unless given
+         */
+    plugin_config_t pluginConfig;
+
+    /**
+         * @brief Requests with at least this priority prefer the network when the default one fits them as well
+         */
+    int minPriority = 1;
+
+    bool isEnabled() const {
+        return nireq > 0;
+    }
+
+    bool operator==(const LatencyProfile& rhs) const {
+        return nireq == rhs.nireq &&
+               batchSize == rhs.batchSize &&
+               pluginConfig == rhs.pluginConfig &&
+               minPriority == rhs.minPriority;
+    }
+
+    bool operator!=(const LatencyProfile& rhs) const {
+        return !(*this == rhs);
+    }
+};
+/**
+ * @brief Contents of files of model version kept in memory, by file name
+ */
+using model_files_contents_t = std::map<std::string, std::shared_ptr<const std::string>>;
+
 const std::string ANONYMOUS_INPUT_NAME = "ANONYMOUS_INPUT_NAME";
 const std::string MAPPING_CONFIG_JSON = "mapping_config.json";
 const uint32_t DEFAULT_MAX_SEQUENCE_NUMBER = 500;
+const uint32_t DEFAULT_BATCH_TIMEOUT_US = 1000;
 
 /**
      * @brief This class represents model configuration
@@ -61,6 +187,16 @@ private:
          */
     std::string localPath;
 
+    /**
+         * @brief Files of versions read from online storage to memory instead of local path
+         */
+    std::shared_ptr<const std::map<model_version_t, model_files_contents_t>> inMemoryFiles;
+
+    /**
+         * @brief Time of downloading model versions to local path, in microseconds, 0 when not downloaded
+         */
+    uint64_t downloadTimeUs = 0;
+
     /**
          * @brief Target device
          */
@@ -86,6 +222,151 @@ private:
          */
     uint64_t nireq;
 
+    /**
+         * @brief Maximum number of requests waiting for idle infer request, 0 means unlimited
+         */
+    uint32_t maxQueueDepth = 0;
+
+    /**
+         * @brief Maximum time in milliseconds request waits for idle infer request, 0 means unlimited
+         */
+    uint32_t maxQueueWaitMs = 0;
+
+    /**
+         * @brief Number of infer requests reserved for pipeline nodes
+         */
+    uint32_t pipelineReservedNireq = 0;
+
+    /**
+         * @brief Minimum number of infer requests kept in elastic mode, 0 disables elastic mode
+         */
+    uint32_t minNireq = 0;
+
+    /**
+         * @brief Time in milliseconds without waiting requests after which idle infer requests are released in elastic mode
+         */
+    uint32_t nireqCooldownMs = 60000;
+
+    /**
+         * @brief Number of executable networks compiled for non default shapes kept for shape auto inputs, 0 disables the cache
+         */
+    uint32_t shapeCacheSize = 0;
+
+    /**
+         * @brief Most frequent shapes of requests are compiled into shape cache in background
+         */
+    bool shapeCachePrewarm = false;
+
+    /**
+         * @brief Batch sizes compiled side by side with batch size auto, requests are routed to the smallest fitting one
+         */
+    std::set<size_t> batchSizeVariants;
+
+    /**
+         * @brief Sequence lengths compiled side by side, requests are padded to the smallest fitting one
+         */
+    std::set<size_t> sequenceLengthBuckets;
+
+    /**
+         * @brief Network compiled side by side for interactive requests
+         */
+    LatencyProfile latencyProfile;
+
+    /**
+         * @brief Input filled with attention mask of padded sequences when request does not contain it
+         */
+    std::string attentionMaskInput;
+
+    /**
+         * @brief Number of warmup inferences run on every infer request before model is marked available, 0 disables warmup
+         */
+    uint32_t warmupIterations = 0;
+
+    /**
+         * @brief Flag determining if CPU streams and nireq are selected by benchmarking candidates on load
+         */
+    bool autoTune = false;
+
+    /**
+         * @brief Maximum average inference latency of configuration selected by auto tuning, 0 means no limit
+         */
+    uint32_t autoTuneMaxLatencyMs = 0;
+
+    /**
+         * @brief Flag determining if versions are compiled on first request instead of on config load
+         */
+    bool lazyLoading = false;
+
+    /**
+         * @brief Flag determining if server readiness waits for the model during startup
+         */
+    bool critical = false;
+
+    /**
+         * @brief Size in megabytes of cache of responses keyed by request inputs, 0 disables the cache
+         */
+    uint32_t responseCacheSizeMb = 0;
+
+    /**
+         * @brief Flag determining if infer requests own input blobs which request data is written into
+         */
+    bool bindInputBlobs = false;
+
+    /**
+         * @brief Flag determining if input blobs of infer requests and bound outputs of DL nodes are allocated in device memory
+         */
+    bool remoteBlobs = false;
+
+    /**
+         * @brief Flag determining if memory of loaded model is pre-faulted and locked in RAM
+         */
+    bool lockMemory = false;
+
+    /**
+         * @brief Flag determining if concurrent requests with identical inputs share single inference
+         */
+    bool coalesceRequests = false;
+
+    /**
+         * @brief Name of model serving requests while this model is overloaded, empty if none
+         */
+    std::string fallbackModelName;
+
+    /**
+         * @brief Version of fallback model, 0 for its default version
+         */
+    model_version_t fallbackModelVersion = 0;
+
+    /**
+         * @brief Number of requests waiting for infer request above which new requests are served by fallback model
+         */
+    uint32_t fallbackQueueDepth = 1;
+
+    /**
+         * @brief Every n-th request is run on infer request of network compiled with performance counters, 0 disables profiling
+         */
+    uint32_t layerProfilingInterval = 0;
+
+    /**
+         * @brief Minimum seconds between checks of base path for version changes by config watcher, 0 checks on every watcher cycle
+         */
+    uint32_t versionPollIntervalSeconds = 0;
+
+    /**
+         * @brief Number of infer requests running sub-batches of request with batch larger than network batch concurrently, 0 disables splitting
+         */
+    uint32_t batchSplitParallelism = 0;
+
+    /**
+         * @brief Share of server capacity of the model relative to other models
+         */
+    uint32_t schedulingWeight = 1;
+
+    /**
+         * @brief Limit of concurrent inferences of all versions of the model, 0 means unlimited
+         */
+    uint32_t maxConcurrentInferences = 0;
+
     /**
          * @brief Flag determining if model is stateful
          */
@@ -106,6 +387,36 @@ private:
          */
     uint32_t maxSequenceNumber;
 
+    /**
+         * @brief Maximum number of sequences bound to their own infer request, 0 disables affinity
+         */
+    uint32_t maxBoundSequences = 0;
+
+    /**
+         * @brief Seconds of inactivity after which sequence is removed, 0 keeps periodic idle sequence scans
+         */
+    uint32_t idleSequenceTimeoutSeconds = 0;
+
+    /**
+         * @brief Seconds of inactivity after which memory state of sequence is compressed, 0 disables compression
+         */
+    uint32_t idleSequenceCompressionSeconds = 0;
+
+    /**
+         * @brief Maximum number of batch entries coalesced from concurrent requests, 0 disables dynamic batching
+         */
+    uint32_t maxBatchSize = 0;
+
+    /**
+         * @brief Time in microseconds dynamic batcher waits for the batch to fill up
+         */
+    uint32_t batchTimeoutUs = DEFAULT_BATCH_TIMEOUT_US;
+
+    /**
+         * @brief p99 latency in microseconds dynamic batcher adapts batch window to, 0 keeps static batch timeout
+         */
+    uint32_t batchLatencyTargetUs = 0;
+
     /**
          * @brief Model version
          */
@@ -131,6 +442,21 @@ private:
          */
     layouts_map_t layouts;
 
+    /**
+         * @brief Map of precisions accepted from requests in addition to network input precisions
+         */
+    request_precisions_map_t requestPrecisions;
+
+    /**
+         * @brief Map of preprocessing steps offloaded to OpenVINO, per network input
+         */
+    preprocessing_map_t preprocessing;
+
+    /**
+         * @brief Map of postprocessing applied to predict responses, per network output
+         */
+    postprocessing_map_t postprocessing;
+
     /**
          * @brief Input mapping configuration
          */
@@ -221,6 +547,15 @@ public:
          */
     bool isReloadRequired(const ModelConfig& rhs) const;
 
+    /**
+         * @brief Checks if configs differ only in parameters of infer requests queue, which can be recreated without recompiling the network
+         *
+         * @param rhs
+         *
+         * @return true if only nireq, max_queue_depth, max_queue_wait_ms, pipeline_reserved_nireq, min_nireq or nireq_cooldown_ms changed
+         */
+    bool isInferRequestsQueueReloadSufficient(const ModelConfig& rhs) const;
+
     /**
          * @brief Compares two ModelConfig instances and decides if customloader configuration changed
          *
@@ -302,6 +637,53 @@ public:
         this->localPath = localPath;
     }
 
+    /**
+         * @brief Get files of the version read to memory
+         * 
+         * @return files or nullptr if version is read from local path
+         */
+    const model_files_contents_t* getInMemoryFiles() const {
+        if (!inMemoryFiles) {
+            return nullptr;
+        }
+        auto it = inMemoryFiles->find(version);
+        return it != inMemoryFiles->end() ? &it->second : nullptr;
+    }
+
+    /**
+         * @brief Set files of versions read to memory
+         * 
+         * @param inMemoryFiles 
+         */
+    void setInMemoryFiles(std::shared_ptr<const std::map<model_version_t, model_files_contents_t>> inMemoryFiles) {
+        this->inMemoryFiles = std::move(inMemoryFiles);
+    }
+
+    /**
+         * @brief Get files of all versions read to memory
+         */
+    const std::shared_ptr<const std::map<model_version_t, model_files_contents_t>>& getAllInMemoryFiles() const {
+        return inMemoryFiles;
+    }
+
+    /**
+         * @brief Get the time of downloading model versions to local path
+         * 
+         * @return uint64_t microseconds, 0 when model was not downloaded
+         */
+    uint64_t getDownloadTimeUs() const {
+        return this->downloadTimeUs;
+    }
+
+    /**
+         * @brief Set the time of downloading model versions to local path
+         * 
+         * @param downloadTimeUs 
+         */
+    void setDownloadTimeUs(uint64_t downloadTimeUs) {
+        this->downloadTimeUs = downloadTimeUs;
+    }
+
     /**
          * @brief Get the target device
          * 
@@ -329,13 +711,41 @@ public:
         return this->targetDevice.find("HETERO") != std::string::npos && this->targetDevice.find(device) != std::string::npos;
     }
 
+    /**
+         * @brief Prefix of target device compiling model on each listed device, e.g. BALANCE:GPU,CPU
+         */
+    static constexpr const char* BALANCED_TARGET_DEVICE_PREFIX = "BALANCE:";
+
+    /**
+         * @brief Get devices requests are balanced across
+         * 
+         * @return devices listed after BALANCE: prefix, empty if target device is not balanced
+         */
+    std::vector<std::string> getBalancedDevices() const {
+        const std::string prefix = BALANCED_TARGET_DEVICE_PREFIX;
+        if (this->targetDevice.compare(0, prefix.size(), prefix) != 0) {
+            return {};
+        }
+        return tokenize(this->targetDevice.substr(prefix.size()), ',');
+    }
+
+    /**
+         * @brief Checks if target device is balanced and contains specific device
+         * 
+         * @param bool
+         */
+    bool isBalancedTargetDevice(const std::string& device) const {
+        auto devices = getBalancedDevices();
+        return std::find(devices.begin(), devices.end(), device) != devices.end();
+    }
+
     /**
          * @brief Checks if given device name is used alone or as a part of multi device configuration
          * 
          * @param bool
          */
     bool isDeviceUsed(const std::string& device) const {
-        return this->targetDevice == device || this->isHeteroTargetDevice(device);
+        return this->targetDevice == device || this->isHeteroTargetDevice(device) || this->isBalancedTargetDevice(device);
     }
 
     /**
@@ -452,45 +862,580 @@ public:
     }
 
     /**
-         * @brief Get the plugin config
+         * @brief Get the max number of requests waiting for idle infer request
          * 
-         * @return const std::string&
+         * @return uint32_t 
          */
-    const plugin_config_t& getPluginConfig() const {
-        return this->pluginConfig;
+    uint32_t getMaxQueueDepth() const {
+        return this->maxQueueDepth;
     }
 
     /**
-         * @brief Set the plugin config
+         * @brief Set the max number of requests waiting for idle infer request
          * 
-         * @param pluginConfig 
+         * @param maxQueueDepth 
          */
-    void setPluginConfig(const plugin_config_t& pluginConfig) {
-        this->pluginConfig = pluginConfig;
+    void setMaxQueueDepth(const uint32_t maxQueueDepth) {
+        this->maxQueueDepth = maxQueueDepth;
     }
 
     /**
-     * @brief Get stateful model flag
-     *
-     * @return bool
-     */
-    const bool isStateful() const {
-        return this->stateful;
+         * @brief Get the max time in milliseconds request waits for idle infer request
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getMaxQueueWaitMs() const {
+        return this->maxQueueWaitMs;
     }
 
     /**
-     * @brief Set stateful model flag
-     *
-     * @return bool
-     */
-    void setStateful(bool stateful) {
-        this->stateful = stateful;
+         * @brief Set the max time in milliseconds request waits for idle infer request
+         * 
+         * @param maxQueueWaitMs 
+         */
+    void setMaxQueueWaitMs(const uint32_t maxQueueWaitMs) {
+        this->maxQueueWaitMs = maxQueueWaitMs;
     }
 
     /**
-     * @brief Set stateful low latency transformation flag
-     *
-     * @return bool
+         * @brief Get the number of infer requests reserved for pipeline nodes
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getPipelineReservedNireq() const {
+        return this->pipelineReservedNireq;
+    }
+
+    /**
+         * @brief Set the number of infer requests reserved for pipeline nodes
+         * 
+         * @param pipelineReservedNireq 
+         */
+    void setPipelineReservedNireq(const uint32_t pipelineReservedNireq) {
+        this->pipelineReservedNireq = pipelineReservedNireq;
+    }
+
+    /**
+         * @brief Get the minimum number of infer requests kept in elastic mode
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getMinNireq() const {
+        return this->minNireq;
+    }
+
+    /**
+         * @brief Set the minimum number of infer requests kept in elastic mode, 0 disables elastic mode
+         * 
+         * @param minNireq 
+         */
+    void setMinNireq(const uint32_t minNireq) {
+        this->minNireq = minNireq;
+    }
+
+    /**
+         * @brief Get the cooldown after which idle infer requests are released in elastic mode
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getNireqCooldownMs() const {
+        return this->nireqCooldownMs;
+    }
+
+    /**
+         * @brief Set the cooldown after which idle infer requests are released in elastic mode
+         * 
+         * @param nireqCooldownMs 
+         */
+    void setNireqCooldownMs(const uint32_t nireqCooldownMs) {
+        this->nireqCooldownMs = nireqCooldownMs;
+    }
+
+    /**
+         * @brief Get the number of executable networks cached for non default shapes
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getShapeCacheSize() const {
+        return this->shapeCacheSize;
+    }
+
+    /**
+         * @brief Set the number of executable networks cached for non default shapes
+         * 
+         * @param shapeCacheSize 
+         */
+    void setShapeCacheSize(const uint32_t shapeCacheSize) {
+        this->shapeCacheSize = shapeCacheSize;
+    }
+
+    /**
+         * @brief Checks if requests with non default shapes are served from cached executable networks instead of model reload
+         * 
+         * @return bool
+         */
+    bool isShapeCacheEnabled() const {
+        return this->shapeCacheSize > 0;
+    }
+
+    /**
+         * @brief Checks if the most frequent request shapes are compiled into shape cache in background
+         * 
+         * @return bool
+         */
+    bool isShapeCachePrewarmEnabled() const {
+        return this->shapeCachePrewarm;
+    }
+
+    /**
+         * @brief Set if the most frequent request shapes are compiled into shape cache in background
+         * 
+         * @param shapeCachePrewarm 
+         */
+    void setShapeCachePrewarm(const bool shapeCachePrewarm) {
+        this->shapeCachePrewarm = shapeCachePrewarm;
+    }
+
+    /**
+         * @brief Get the batch sizes compiled side by side
+         * 
+         * @return const std::set<size_t>& 
+         */
+    const std::set<size_t>& getBatchSizeVariants() const {
+        return this->batchSizeVariants;
+    }
+
+    /**
+         * @brief Set the batch sizes compiled side by side
+         * 
+         * @param batchSizeVariants 
+         */
+    void setBatchSizeVariants(const std::set<size_t>& batchSizeVariants) {
+        this->batchSizeVariants = batchSizeVariants;
+    }
+
+    /**
+         * @brief Get the sequence lengths compiled side by side
+         * 
+         * @return const std::set<size_t>& 
+         */
+    const std::set<size_t>& getSequenceLengthBuckets() const {
+        return this->sequenceLengthBuckets;
+    }
+
+    /**
+         * @brief Set the sequence lengths compiled side by side
+         * 
+         * @param sequenceLengthBuckets 
+         */
+    void setSequenceLengthBuckets(const std::set<size_t>& sequenceLengthBuckets) {
+        this->sequenceLengthBuckets = sequenceLengthBuckets;
+    }
+
+    /**
+         * @brief Get the network compiled side by side for interactive requests
+         * 
+         * @return const LatencyProfile& 
+         */
+    const LatencyProfile& getLatencyProfile() const {
+        return this->latencyProfile;
+    }
+
+    /**
+         * @brief Set the network compiled side by side for interactive requests
+         * 
+         * @param latencyProfile 
+         */
+    void setLatencyProfile(const LatencyProfile& latencyProfile) {
+        this->latencyProfile = latencyProfile;
+    }
+
+    /**
+         * @brief Get the input filled with attention mask of padded sequences
+         * 
+         * @return const std::string& 
+         */
+    const std::string& getAttentionMaskInput() const {
+        return this->attentionMaskInput;
+    }
+
+    /**
+         * @brief Set the input filled with attention mask of padded sequences
+         * 
+         * @param attentionMaskInput 
+         */
+    void setAttentionMaskInput(const std::string& attentionMaskInput) {
+        this->attentionMaskInput = attentionMaskInput;
+    }
+
+    /**
+         * @brief Get the number of warmup inferences run on every infer request
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getWarmupIterations() const {
+        return this->warmupIterations;
+    }
+
+    /**
+         * @brief Set the number of warmup inferences run on every infer request
+         * 
+         * @param warmupIterations 
+         */
+    void setWarmupIterations(const uint32_t warmupIterations) {
+        this->warmupIterations = warmupIterations;
+    }
+
+    /**
+         * @brief Checks if CPU streams and nireq are selected by benchmarking on load
+         * 
+         * @return bool
+         */
+    bool isAutoTuneEnabled() const {
+        return this->autoTune;
+    }
+
+    /**
+         * @brief Set auto tuning of CPU streams and nireq
+         * 
+         * @param autoTune 
+         */
+    void setAutoTune(const bool autoTune) {
+        this->autoTune = autoTune;
+    }
+
+    /**
+         * @brief Get the maximum average latency allowed for auto tuned configuration
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getAutoTuneMaxLatencyMs() const {
+        return this->autoTuneMaxLatencyMs;
+    }
+
+    /**
+         * @brief Set the maximum average latency allowed for auto tuned configuration
+         * 
+         * @param autoTuneMaxLatencyMs 
+         */
+    void setAutoTuneMaxLatencyMs(const uint32_t autoTuneMaxLatencyMs) {
+        this->autoTuneMaxLatencyMs = autoTuneMaxLatencyMs;
+    }
+
+    /**
+         * @brief Checks if versions are compiled on first request
+         * 
+         * @return bool
+         */
+    bool isLazyLoadingEnabled() const {
+        return this->lazyLoading;
+    }
+
+    /**
+         * @brief Set lazy loading of versions
+         * 
+         * @param lazyLoading 
+         */
+    void setLazyLoading(const bool lazyLoading) {
+        this->lazyLoading = lazyLoading;
+    }
+
+    /**
+         * @brief Checks if server readiness waits for the model during startup
+         * 
+         * @return bool
+         */
+    bool isCritical() const {
+        return this->critical;
+    }
+
+    /**
+         * @brief Set if server readiness waits for the model during startup
+         * 
+         * @param critical 
+         */
+    void setCritical(const bool critical) {
+        this->critical = critical;
+    }
+
+    /**
+         * @brief Get the size in megabytes of response cache
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getResponseCacheSizeMb() const {
+        return this->responseCacheSizeMb;
+    }
+
+    /**
+         * @brief Set the size in megabytes of response cache
+         * 
+         * @param responseCacheSizeMb 
+         */
+    void setResponseCacheSizeMb(const uint32_t responseCacheSizeMb) {
+        this->responseCacheSizeMb = responseCacheSizeMb;
+    }
+
+    /**
+         * @brief Checks if responses for repeated inputs are served from cache
+         * 
+         * @return bool
+         */
+    bool isResponseCacheEnabled() const {
+        return this->responseCacheSizeMb > 0;
+    }
+
+    /**
+         * @brief Checks if request data is written into input blobs bound to infer requests
+         * 
+         * @return bool
+         */
+    bool isBindInputBlobsEnabled() const {
+        return this->bindInputBlobs;
+    }
+
+    /**
+         * @brief Set writing request data into input blobs bound to infer requests
+         * 
+         * @param bindInputBlobs 
+         */
+    void setBindInputBlobs(const bool bindInputBlobs) {
+        this->bindInputBlobs = bindInputBlobs;
+    }
+
+    /**
+         * @brief Checks if blobs are allocated in memory of the target device
+         * 
+         * @return bool
+         */
+    bool isRemoteBlobsEnabled() const {
+        return this->remoteBlobs;
+    }
+
+    /**
+         * @brief Set allocating blobs in memory of the target device
+         * 
+         * @param remoteBlobs 
+         */
+    void setRemoteBlobs(const bool remoteBlobs) {
+        this->remoteBlobs = remoteBlobs;
+    }
+
+    /**
+         * @brief Checks if model weights, compiled network and infer request blobs are locked in RAM after load
+         * 
+         * @return bool
+         */
+    bool isLockMemoryEnabled() const {
+        return this->lockMemory;
+    }
+
+    /**
+         * @brief Set locking memory of loaded model in RAM
+         * 
+         * @param lockMemory 
+         */
+    void setLockMemory(const bool lockMemory) {
+        this->lockMemory = lockMemory;
+    }
+
+    /**
+         * @brief Checks if concurrent requests with identical inputs share single inference
+         * 
+         * @return bool
+         */
+    bool isCoalesceRequestsEnabled() const {
+        return this->coalesceRequests;
+    }
+
+    /**
+         * @brief Set sharing of single inference by concurrent requests with identical inputs
+         * 
+         * @param coalesceRequests 
+         */
+    void setCoalesceRequests(const bool coalesceRequests) {
+        this->coalesceRequests = coalesceRequests;
+    }
+
+    /**
+         * @brief Checks if requests are routed to fallback model while this model is overloaded
+         * 
+         * @return bool
+         */
+    bool isFallbackEnabled() const {
+        return !this->fallbackModelName.empty();
+    }
+
+    /**
+         * @brief Get the name of fallback model
+         * 
+         * @return const std::string&
+         */
+    const std::string& getFallbackModelName() const {
+        return this->fallbackModelName;
+    }
+
+    /**
+         * @brief Get the version of fallback model
+         * 
+         * @return model_version_t, 0 for default version
+         */
+    model_version_t getFallbackModelVersion() const {
+        return this->fallbackModelVersion;
+    }
+
+    /**
+         * @brief Get the number of waiting requests at which new requests are routed to fallback model
+         * 
+         * @return uint32_t
+         */
+    uint32_t getFallbackQueueDepth() const {
+        return this->fallbackQueueDepth;
+    }
+
+    /**
+         * @brief Set fallback model serving requests while this model is overloaded
+         * 
+         * @param name empty disables fallback
+         * @param version 0 for default version
+         * @param queueDepth number of waiting requests at which new requests are routed to fallback model
+         */
+    void setFallback(const std::string& name, const model_version_t version, const uint32_t queueDepth) {
+        this->fallbackModelName = name;
+        this->fallbackModelVersion = version;
+        this->fallbackQueueDepth = queueDepth;
+    }
+
+    /**
+         * @brief Get the interval of requests profiled per layer
+         * 
+         * @return uint32_t, 0 if profiling is disabled
+         */
+    uint32_t getLayerProfilingInterval() const {
+        return this->layerProfilingInterval;
+    }
+
+    /**
+         * @brief Set the interval of requests profiled per layer
+         * 
+         * @param layerProfilingInterval every n-th request is profiled, 0 disables profiling
+         */
+    void setLayerProfilingInterval(const uint32_t layerProfilingInterval) {
+        this->layerProfilingInterval = layerProfilingInterval;
+    }
+
+    /**
+         * @brief Get the minimum seconds between checks of base path for version changes
+         * 
+         * @return uint32_t, 0 if base path is checked on every watcher cycle
+         */
+    uint32_t getVersionPollIntervalSeconds() const {
+        return this->versionPollIntervalSeconds;
+    }
+
+    /**
+         * @brief Set the minimum seconds between checks of base path for version changes
+         * 
+         * @param versionPollIntervalSeconds
+         */
+    void setVersionPollIntervalSeconds(const uint32_t versionPollIntervalSeconds) {
+        this->versionPollIntervalSeconds = versionPollIntervalSeconds;
+    }
+
+    /**
+         * @brief Get the number of infer requests running sub-batches of a large request concurrently
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getBatchSplitParallelism() const {
+        return this->batchSplitParallelism;
+    }
+
+    /**
+         * @brief Set the number of infer requests running sub-batches of a large request concurrently, 0 disables splitting
+         * 
+         * @param batchSplitParallelism 
+         */
+    void setBatchSplitParallelism(const uint32_t batchSplitParallelism) {
+        this->batchSplitParallelism = batchSplitParallelism;
+    }
+
+    /**
+         * @brief Get the share of server capacity relative to other models
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getSchedulingWeight() const {
+        return this->schedulingWeight;
+    }
+
+    /**
+         * @brief Set the share of server capacity relative to other models
+         * 
+         * @param schedulingWeight 
+         */
+    void setSchedulingWeight(const uint32_t schedulingWeight) {
+        this->schedulingWeight = schedulingWeight;
+    }
+
+    /**
+         * @brief Get the limit of concurrent inferences of the model, 0 means unlimited
+         * 
+         * @return uint32_t 
+         */
+    uint32_t getMaxConcurrentInferences() const {
+        return this->maxConcurrentInferences;
+    }
+
+    /**
+         * @brief Set the limit of concurrent inferences of the model
+         * 
+         * @param maxConcurrentInferences 
+         */
+    void setMaxConcurrentInferences(const uint32_t maxConcurrentInferences) {
+        this->maxConcurrentInferences = maxConcurrentInferences;
+    }
+
+    /**
+         * @brief Get the plugin config
+         * 
+         * @return const std::string&
+         */
+    const plugin_config_t& getPluginConfig() const {
+        return this->pluginConfig;
+    }
+
+    /**
+         * @brief Set the plugin config
+         * 
+         * @param pluginConfig 
+         */
+    void setPluginConfig(const plugin_config_t& pluginConfig) {
+        this->pluginConfig = pluginConfig;
+    }
+
+    /**
+     * @brief Get stateful model flag
+     *
+     * @return bool
+     */
+    const bool isStateful() const {
+        return this->stateful;
+    }
+
+    /**
+     * @brief Set stateful model flag
+     *
+     * @return bool
+     */
+    void setStateful(bool stateful) {
+        this->stateful = stateful;
+    }
+
+    /**
+     * @brief Set stateful low latency transformation flag
+     *
+     * @return bool
      */
     void setLowLatencyTransformation(bool lowLatencyTransformation) {
         this->lowLatencyTransformation = lowLatencyTransformation;
@@ -523,6 +1468,123 @@ public:
         this->maxSequenceNumber = maxSequenceNumber;
     }
 
+    /**
+     * @brief Get max number of sequences bound to their own infer request
+     *
+     * @return uint
+     */
+    uint32_t getMaxBoundSequences() const {
+        return this->maxBoundSequences;
+    }
+
+    /**
+     * @brief Set max number of sequences bound to their own infer request
+     *
+     * @param maxBoundSequences
+     */
+    void setMaxBoundSequences(const uint32_t maxBoundSequences) {
+        this->maxBoundSequences = maxBoundSequences;
+    }
+
+    /**
+     * @brief Get seconds of inactivity after which sequence is removed
+     *
+     * @return uint
+     */
+    uint32_t getIdleSequenceTimeoutSeconds() const {
+        return this->idleSequenceTimeoutSeconds;
+    }
+
+    /**
+     * @brief Set seconds of inactivity after which sequence is removed
+     *
+     * @param idleSequenceTimeoutSeconds
+     */
+    void setIdleSequenceTimeoutSeconds(const uint32_t idleSequenceTimeoutSeconds) {
+        this->idleSequenceTimeoutSeconds = idleSequenceTimeoutSeconds;
+    }
+
+    /**
+     * @brief Get seconds of inactivity after which memory state of sequence is compressed
+     *
+     * @return uint
+     */
+    uint32_t getIdleSequenceCompressionSeconds() const {
+        return this->idleSequenceCompressionSeconds;
+    }
+
+    /**
+     * @brief Set seconds of inactivity after which memory state of sequence is compressed
+     *
+     * @param idleSequenceCompressionSeconds
+     */
+    void setIdleSequenceCompressionSeconds(const uint32_t idleSequenceCompressionSeconds) {
+        this->idleSequenceCompressionSeconds = idleSequenceCompressionSeconds;
+    }
+
+    /**
+     * @brief Get max number of batch entries coalesced by dynamic batching
+     *
+     * @return uint
+     */
+    uint32_t getMaxBatchSize() const {
+        return this->maxBatchSize;
+    }
+
+    /**
+     * @brief Set max number of batch entries coalesced by dynamic batching
+     *
+     * @param maxBatchSize
+     */
+    void setMaxBatchSize(const uint32_t maxBatchSize) {
+        this->maxBatchSize = maxBatchSize;
+    }
+
+    /**
+     * @brief Get dynamic batching timeout in microseconds
+     *
+     * @return uint
+     */
+    uint32_t getBatchTimeoutUs() const {
+        return this->batchTimeoutUs;
+    }
+
+    /**
+     * @brief Set dynamic batching timeout in microseconds
+     *
+     * @param batchTimeoutUs
+     */
+    void setBatchTimeoutUs(const uint32_t batchTimeoutUs) {
+        this->batchTimeoutUs = batchTimeoutUs;
+    }
+
+    /**
+     * @brief Get p99 latency target in microseconds of adaptive dynamic batching window
+     *
+     * @return uint
+     */
+    uint32_t getBatchLatencyTargetUs() const {
+        return this->batchLatencyTargetUs;
+    }
+
+    /**
+     * @brief Set p99 latency target in microseconds of adaptive dynamic batching window
+     *
+     * @param batchLatencyTargetUs
+     */
+    void setBatchLatencyTargetUs(const uint32_t batchLatencyTargetUs) {
+        this->batchLatencyTargetUs = batchLatencyTargetUs;
+    }
+
+    /**
+     * @brief Checks if requests for the model are coalesced by dynamic batching
+     *
+     * @return bool
+     */
+    bool isDynamicBatchingEnabled() const {
+        return this->maxBatchSize > 0;
+    }
+
     /**
      * @brief Get stateful sequence timeout
      *
@@ -605,6 +1667,33 @@ public:
          */
     Status parseLayoutParameter(const std::string& command);
 
+    /**
+         * @brief Parses value from json and extracts preprocessing info
+         * 
+         * @param node
+         * 
+         * @return status
+         */
+    Status parsePreprocessingParameter(const rapidjson::Value& node);
+
+    /**
+         * @brief Parses value from json and extracts postprocessing info
+         * 
+         * @param node
+         * 
+         * @return status
+         */
+    Status parsePostprocessingParameter(const rapidjson::Value& node);
+
+    /**
+         * @brief Parses value from json and extracts latency profile
+         * 
+         * @param node
+         * 
+         * @return status
+         */
+    Status parseLatencyProfileParameter(const rapidjson::Value& node);
+
     /**
          * @brief Returns true if any input shape specified in shapes map is in AUTO mode
          * 
@@ -725,6 +1814,60 @@ public:
         this->layout = "";
     }
 
+    /**
+         * @brief Get the precisions accepted from requests and converted to network input precisions
+         * 
+         * @return const request_precisions_map_t& 
+         */
+    const request_precisions_map_t& getRequestPrecisions() const {
+        return this->requestPrecisions;
+    }
+
+    /**
+         * @brief Set the precisions accepted from requests
+         * 
+         * @param requestPrecisions 
+         */
+    void setRequestPrecisions(const request_precisions_map_t& requestPrecisions) {
+        this->requestPrecisions = requestPrecisions;
+    }
+
+    /**
+         * @brief Get the preprocessing offloaded to OpenVINO
+         * 
+         * @return const preprocessing_map_t& 
+         */
+    const preprocessing_map_t& getPreprocessing() const {
+        return this->preprocessing;
+    }
+
+    /**
+         * @brief Set the preprocessing offloaded to OpenVINO
+         * 
+         * @param preprocessing 
+         */
+    void setPreprocessing(const preprocessing_map_t& preprocessing) {
+        this->preprocessing = preprocessing;
+    }
+
+    /**
+         * @brief Get the postprocessing applied to predict responses
+         * 
+         * @return const postprocessing_map_t& 
+         */
+    const postprocessing_map_t& getPostprocessing() const {
+        return this->postprocessing;
+    }
+
+    /**
+         * @brief Set the postprocessing applied to predict responses
+         * 
+         * @param postprocessing 
+         */
+    void setPostprocessing(const postprocessing_map_t& postprocessing) {
+        this->postprocessing = postprocessing;
+    }
+
     /**
          * @brief Add a named layout
          * 
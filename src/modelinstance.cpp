@@ -16,42 +16,79 @@
 #include "modelinstance.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <dirent.h>
 #include <spdlog/spdlog.h>
 #include <sys/types.h>
 
+#include "compilation_pool.hpp"
+#include "compiled_network_registry.hpp"
 #include "config.hpp"
+#include "cpu_budget.hpp"
+#include "custom_loader_buffer_allocator.hpp"
+#include "customloaderinterface.hpp"
 #include "customloaders.hpp"
 #include "deserialization.hpp"
 #include "executingstreamidguard.hpp"
 #include "filesystem.hpp"
+#include "layout_transpose.hpp"
 #include "logging.hpp"
+#include "mapped_file_allocator.hpp"
+#include "memory_lock.hpp"
+#include "metrics.hpp"
 #include "ov_utils.hpp"
 #include "prediction_service_utils.hpp"
+#include "sequence_padding.hpp"
 #include "serialization.hpp"
+#include "shared_memory.hpp"
+#include "sparse_tensor.hpp"
+#include "startupprofiler.hpp"
 #include "stringutils.hpp"
 #include "tensorinfo.hpp"
 #include "timer.hpp"
+#include "tracing.hpp"
+#include "usdt.hpp"
 
 using namespace InferenceEngine;
 
 namespace ovms {
 
+enum : size_t {
+    WARMUP,
+    COMPILE,
+    GET_INFER_REQUEST,
+    DESERIALIZE,
+    PREDICTION,
+    SERIALIZE,
+    TOTAL,
+    TIMER_END
+};
+
 const char* CPU_THROUGHPUT_STREAMS = "CPU_THROUGHPUT_STREAMS";
 const char* NIREQ = "NIREQ";
 
 const uint MAX_NIREQ_COUNT = 100000;
+const uint AUTO_TUNE_CANDIDATE_DURATION_MILLISECONDS = 500;
 
 const int DEFAULT_OV_STREAMS = std::thread::hardware_concurrency() / 4;
 
-const uint UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS = 10;
+const uint UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS = 100;
 
 void ModelInstance::subscribe(PipelineDefinition& pd) {
     subscriptionManager.subscribe(pd);
@@ -61,6 +98,70 @@ void ModelInstance::unsubscribe(PipelineDefinition& pd) {
     subscriptionManager.unsubscribe(pd);
 }
 
+void ModelInstance::takeOverSubscriptions(ModelInstance& replaced) {
+    subscriptionManager.takeOver(replaced.subscriptionManager);
+    subscriptionManager.notifySubscribers();
+}
+
+Status ModelInstance::applyPreprocessing(InferenceEngine::InputInfo& input, const InputPreprocessing& preprocessing) {
+    const auto& dims = input.getTensorDesc().getDims();
+    const auto layout = input.getLayout();
+    if (dims.size() != 4 || (layout != InferenceEngine::Layout::NCHW && layout != InferenceEngine::Layout::NHWC)) {
+        SPDLOG_WARN("Config preprocessing - {} requires 4 dimensional input with NCHW or NHWC layout", input.name());
+        return StatusCode::CONFIG_PREPROCESSING_NOT_SUPPORTED;
+    }
+    // dimensions of tensor descriptor are always in NCHW order
+    const size_t channels = dims[1];
+    for (const auto* values : {&preprocessing.meanValues, &preprocessing.scaleValues}) {
+        if (!values->empty() && values->size() != 1 && values->size() != channels) {
+            SPDLOG_WARN("Config preprocessing - {} mean and scale values have to be given for each of {} channels or once for all", input.name(), channels);
+            return StatusCode::CONFIG_PREPROCESSING_NOT_SUPPORTED;
+        }
+    }
+    auto& preProcess = input.getPreProcess();
+    if (preprocessing.resizeAlgorithm == "BILINEAR") {
+        preProcess.setResizeAlgorithm(InferenceEngine::ResizeAlgorithm::RESIZE_BILINEAR);
+    } else if (preprocessing.resizeAlgorithm == "AREA") {
+        preProcess.setResizeAlgorithm(InferenceEngine::ResizeAlgorithm::RESIZE_AREA);
+    }
+    static const std::unordered_map<std::string, InferenceEngine::ColorFormat> colorFormats{
+        {"RGB", InferenceEngine::ColorFormat::RGB},
+        {"BGR", InferenceEngine::ColorFormat::BGR},
+        {"RGBX", InferenceEngine::ColorFormat::RGBX},
+        {"BGRX", InferenceEngine::ColorFormat::BGRX},
+        {"NV12", InferenceEngine::ColorFormat::NV12},
+        {"I420", InferenceEngine::ColorFormat::I420}};
+    auto colorFormatIt = colorFormats.find(preprocessing.colorFormat);
+    if (colorFormatIt != colorFormats.end()) {
+        const bool isPlanarYuv = colorFormatIt->second == InferenceEngine::ColorFormat::NV12 ||
+                                 colorFormatIt->second == InferenceEngine::ColorFormat::I420;
+        if (isPlanarYuv && channels != 3) {
+            SPDLOG_WARN("Config preprocessing - {} color format {} requires input with 3 channels", input.name(), preprocessing.colorFormat);
+            return StatusCode::CONFIG_PREPROCESSING_NOT_SUPPORTED;
+        }
+        // planes of NV12 and I420 frames are 8 bit, conversion to network precision is done by OpenVINO
+        if (isPlanarYuv) {
+            input.setPrecision(InferenceEngine::Precision::U8);
+        }
+        preProcess.setColorFormat(colorFormatIt->second);
+    }
+    if (!preprocessing.meanValues.empty() || !preprocessing.scaleValues.empty()) {
+        preProcess.init(channels);
+        for (size_t c = 0; c < channels; ++c) {
+            const auto& mean = preprocessing.meanValues;
+            const auto& scale = preprocessing.scaleValues;
+            preProcess[c]->meanValue = mean.empty() ? 0.0f : mean[mean.size() == 1 ? 0 : c];
+            preProcess[c]->stdScale = scale.empty() ? 1.0f : scale[scale.size() == 1 ? 0 : c];
+        }
+        preProcess.setVariant(InferenceEngine::MeanVariant::MEAN_VALUE);
+    }
+    SPDLOG_INFO("Input: {} preprocessing offloaded to OpenVINO; resize: {}; color format: {}; mean values: {}; scale values: {}",
+        input.name(), preprocessing.resizeAlgorithm.empty() ? "none" : preprocessing.resizeAlgorithm,
+        preprocessing.colorFormat.empty() ? "none" : preprocessing.colorFormat,
+        preprocessing.meanValues.size(), preprocessing.scaleValues.size());
+    return StatusCode::OK;
+}
+
 Status ModelInstance::loadInputTensors(const ModelConfig& config, const DynamicModelParameter& parameter) {
     if (config.isShapeAnonymousFixed() && network->getInputsInfo().size() > 1) {
         Status status = StatusCode::ANONYMOUS_FIXED_SHAPE_NOT_ALLOWED;
@@ -91,6 +192,23 @@ Status ModelInstance::loadInputTensors(const ModelConfig& config, const DynamicM
             return StatusCode::CONFIG_LAYOUT_IS_NOT_IN_NETWORK;
         }
     }
+    for (const auto& [name, _] : config.getRequestPrecisions()) {
+        if (networkInputs.count(name) == 0) {
+            SPDLOG_WARN("Config request precision - {} not found in network", name);
+            return StatusCode::CONFIG_REQUEST_PRECISION_NOT_SUPPORTED;
+        }
+        if (!isConversionFromFp32Supported(networkInputs.at(name)->getPrecision())) {
+            SPDLOG_WARN("Config request precision - {} cannot be converted to network input precision {}",
+                name, networkInputs.at(name)->getPrecision().name());
+            return StatusCode::CONFIG_REQUEST_PRECISION_NOT_SUPPORTED;
+        }
+    }
+    for (const auto& [name, _] : config.getPreprocessing()) {
+        if (networkInputs.count(name) == 0) {
+            SPDLOG_WARN("Config preprocessing - {} not found in network", name);
+            return StatusCode::CONFIG_PREPROCESSING_NOT_SUPPORTED;
+        }
+    }
 
     this->inputsInfo.clear();
 
@@ -151,17 +269,61 @@ Status ModelInstance::loadInputTensors(const ModelConfig& config, const DynamicM
             }
         }
 
-        input->setLayout(layout);
+        auto preprocessingIt = config.getPreprocessing().find(name);
+        // on CPU request data is transposed by the server while it is deserialized, faster than generic reorder done by the plugin
+        const auto networkLayout = input->getLayout();
+        const bool transposedByServer = config.getTargetDevice() == "CPU" && shape.size() == 4 &&
+                                        preprocessingIt == config.getPreprocessing().end() &&
+                                        config.getRequestPrecisions().count(name) == 0 &&
+                                        isLayoutTransposeSupported(precision, layout, networkLayout);
+        if (transposedByServer) {
+            SPDLOG_DEBUG("model: {}, version: {}; input {} is transposed from {} to {} by the server", getName(), getVersion(), name,
+                TensorInfo::getStringFromLayout(layout), TensorInfo::getStringFromLayout(networkLayout));
+        } else {
+            input->setLayout(layout);
+        }
+
+        if (preprocessingIt != config.getPreprocessing().end()) {
+            auto status = applyPreprocessing(*input, preprocessingIt->second);
+            if (!status.ok()) {
+                return status;
+            }
+        }
 
+        // preprocessing of planar YUV frames changes input precision
+        precision = input->getPrecision();
         auto mappingName = config.getMappingInputByKey(name);
         auto tensor = std::make_shared<TensorInfo>(name, mappingName, precision, shape, layout);
+        if (config.getRequestPrecisions().count(name)) {
+            tensor->setRequestPrecision(InferenceEngine::Precision::FP32);
+        }
+        if (preprocessingIt != config.getPreprocessing().end() && !preprocessingIt->second.resizeAlgorithm.empty()) {
+            tensor->setResizedByPreprocessing(true);
+        }
+        tensor->setColorFormat(input->getPreProcess().getColorFormat());
+        if (transposedByServer) {
+            tensor->setTransposedLayout(networkLayout);
+        }
         this->inputsInfo[tensor->getMappedName()] = std::move(tensor);
     }
     SPDLOG_INFO("Final network inputs: {}", getNetworkInputsInfoString(networkInputs, config));
     return StatusCode::OK;
 }
 
-void ModelInstance::loadOutputTensors(const ModelConfig& config) {
+Status ModelInstance::loadOutputTensors(const ModelConfig& config) {
+    auto networkOutputs = network->getOutputsInfo();
+    for (const auto& [name, postprocessing] : config.getPostprocessing()) {
+        if (networkOutputs.count(name) == 0) {
+            SPDLOG_WARN("Config postprocessing - {} not found in network", name);
+            return StatusCode::CONFIG_POSTPROCESSING_NOT_SUPPORTED;
+        }
+        const auto& output = networkOutputs.at(name);
+        if (!isPostprocessingSupported(postprocessing, output->getPrecision(), output->getDims(), output->getLayout())) {
+            SPDLOG_WARN("Config postprocessing - {} of {} is not supported for output precision and shape", postprocessing.type, name);
+            return StatusCode::CONFIG_POSTPROCESSING_NOT_SUPPORTED;
+        }
+    }
+
     this->outputsInfo.clear();
     for (const auto& pair : network->getOutputsInfo()) {
         const auto& name = pair.first;
@@ -194,6 +356,7 @@ void ModelInstance::loadOutputTensors(const ModelConfig& config) {
             name, mappingName, shape_stream.str(), effective_shape_stream.str(), precision_str,
             TensorInfo::getStringFromLayout(output->getLayout()));
     }
+    return StatusCode::OK;
 }
 
 // Temporary methods. To be replaces with proper storage class.
@@ -243,11 +406,14 @@ std::string ModelInstance::findModelFilePathWithExtension(const std::string& ext
     return findFilePathWithExtension(path, extension);
 }
 
-uint ModelInstance::getNumOfParallelInferRequestsUnbounded(const ModelConfig& modelConfig) {
+uint ModelInstance::getNumOfParallelInferRequestsUnbounded(const ModelConfig& modelConfig, InferenceEngine::ExecutableNetwork& network) {
     uint numberOfParallelInferRequests = 0;
     if (modelConfig.getNireq() > 0) {
         return modelConfig.getNireq();
     }
+    if (tunedNireq > 0) {
+        return tunedNireq;
+    }
     auto& ovmsConfig = ovms::Config::instance();
     if (ovmsConfig.nireq() > 0) {
         // nireq is set globally for all models in ovms startup parameters
@@ -255,16 +421,24 @@ uint ModelInstance::getNumOfParallelInferRequestsUnbounded(const ModelConfig& mo
     }
     std::string key = METRIC_KEY(OPTIMAL_NUMBER_OF_INFER_REQUESTS);
     try {
-        numberOfParallelInferRequests = execNetwork->GetMetric(key).as<unsigned int>();
+        numberOfParallelInferRequests = network.GetMetric(key).as<unsigned int>();
     } catch (const Exception& ex) {
         SPDLOG_WARN("Failed to query OPTIMAL_NUMBER_OF_INFER_REQUESTS with error {}. Using 1 nireq.", ex.what());
         numberOfParallelInferRequests = 1u;
     }
+    if (modelConfig.isRemoteBlobsEnabled() && numberOfParallelInferRequests < 2) {
+        // with device memory of each infer request, data of the next request is transferred while the current one is inferred
+        numberOfParallelInferRequests = 2u;
+    }
     return numberOfParallelInferRequests;
 }
 
 uint ModelInstance::getNumOfParallelInferRequests(const ModelConfig& modelConfig) {
-    uint nireq = getNumOfParallelInferRequestsUnbounded(modelConfig);
+    return getNumOfParallelInferRequests(modelConfig, *execNetwork);
+}
+
+uint ModelInstance::getNumOfParallelInferRequests(const ModelConfig& modelConfig, InferenceEngine::ExecutableNetwork& network) {
+    uint nireq = getNumOfParallelInferRequestsUnbounded(modelConfig, network);
     if (nireq > MAX_NIREQ_COUNT) {
         SPDLOG_WARN("Invalid nireq because its value was too high: {}. Maximum value: {}", nireq, MAX_NIREQ_COUNT);
         return 0;
@@ -276,33 +450,74 @@ uint ModelInstance::getNumOfParallelInferRequests(const ModelConfig& modelConfig
 }
 
 void ModelInstance::loadOVEngine() {
-    engine = std::make_unique<InferenceEngine::Core>();
-    if (ovms::Config::instance().cpuExtensionLibraryPath() != "") {
-        SPDLOG_INFO("Loading custom CPU extension from {}", ovms::Config::instance().cpuExtensionLibraryPath());
-        try {
-            auto extension_ptr = std::make_shared<InferenceEngine::Extension>(ovms::Config::instance().cpuExtensionLibraryPath());
-            SPDLOG_INFO("Custom CPU extention loaded. Adding it.");
-            engine->AddExtension(extension_ptr, "CPU");
-            SPDLOG_INFO("Extention added.");
-        } catch (std::exception& ex) {
-            SPDLOG_CRITICAL("Custom CPU extention loading has failed! Reason: {}", ex.what());
-            throw;
-        } catch (...) {
-            SPDLOG_CRITICAL("Custom CPU extention loading has failed with an unknown error!");
-            throw;
-        }
-    }
+    engine = getSharedOVCore();
 }
 
 std::unique_ptr<InferenceEngine::CNNNetwork> ModelInstance::loadOVCNNNetworkPtr(const std::string& modelFile) {
     return std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(modelFile));
 }
 
+std::unique_ptr<InferenceEngine::CNNNetwork> ModelInstance::loadOVCNNNetworkWithMappedWeights(const std::string& modelFile, const std::string& weightsFile) {
+    auto mappedWeights = MappedFile::open(weightsFile);
+    if (!mappedWeights) {
+        return nullptr;
+    }
+    InferenceEngine::Blob::Ptr weights;
+    auto status = createSharedBlob(weights,
+        InferenceEngine::TensorDesc(InferenceEngine::Precision::U8, {mappedWeights->getSize()}, InferenceEngine::Layout::C),
+        std::make_shared<MappedFileAllocator>(mappedWeights));
+    if (!status.ok()) {
+        return nullptr;
+    }
+    std::ifstream modelStream(modelFile);
+    std::stringstream model;
+    model << modelStream.rdbuf();
+    SPDLOG_DEBUG("Reading model file: {} with mapped weights: {}", modelFile, weightsFile);
+    return std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(model.str(), weights));
+}
+
+Status ModelInstance::loadOVCNNNetworkFromMemory(const model_files_contents_t& files) {
+    try {
+        const auto& model = *files.at(modelFiles[0]);
+        SPDLOG_DEBUG("Reading model file: {} from memory", modelFiles[0]);
+        if (modelFiles.size() == 1) {
+            network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(model, InferenceEngine::Blob::CPtr()));
+            return StatusCode::OK;
+        }
+        // weights blob uses the downloaded contents directly, they are released when network constants are destroyed
+        auto weightsContents = files.at(modelFiles[1]);
+        InferenceEngine::Blob::Ptr weights;
+        if (weightsContents->empty()) {
+            weights = InferenceEngine::make_shared_blob<uint8_t>({InferenceEngine::Precision::U8, {0}, InferenceEngine::Layout::C});
+            weights->allocate();
+        } else {
+            auto status = createSharedBlob(weights,
+                InferenceEngine::TensorDesc(InferenceEngine::Precision::U8, {weightsContents->size()}, InferenceEngine::Layout::C),
+                std::make_shared<CustomLoaderBufferAllocator>(const_cast<char*>(weightsContents->data()), weightsContents->size(),
+                    std::shared_ptr<void>(weightsContents, const_cast<char*>(weightsContents->data()))));
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(model, weights));
+    } catch (std::exception& e) {
+        SPDLOG_ERROR("Error: {}; occurred during loading CNNNetwork for model: {} version: {}", e.what(), getName(), getVersion());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    return StatusCode::OK;
+}
+
 Status ModelInstance::loadOVCNNNetwork() {
     auto& modelFile = modelFiles[0];
     SPDLOG_DEBUG("Try reading model file: {}", modelFile);
     try {
-        network = loadOVCNNNetworkPtr(modelFile);
+        // Only IR weights can be provided separately from the model
+        if (ovms::Config::instance().mmapWeights() && modelFiles.size() == OV_MODEL_FILES_EXTENSIONS.size() && endsWith(modelFiles[1], ".bin")) {
+            network = loadOVCNNNetworkWithMappedWeights(modelFile, modelFiles[1]);
+        }
+        if (!network) {
+            network = loadOVCNNNetworkPtr(modelFile);
+        }
     } catch (std::exception& e) {
         SPDLOG_ERROR("Error: {}; occurred during loading CNNNetwork for model: {} version: {}", e.what(), getName(), getVersion());
         return StatusCode::INTERNAL_ERROR;
@@ -310,11 +525,27 @@ Status ModelInstance::loadOVCNNNetwork() {
     return StatusCode::OK;
 }
 
+/**
+ * Exposes custom loader buffer as memory, mapping the file if descriptor was returned.
+ * Custom loader is notified with release callback once the memory is no longer used.
+ */
+static std::shared_ptr<CustomLoaderBufferAllocator> wrapCustomLoaderBuffer(const CustomLoaderBuffer& buffer, std::shared_ptr<CustomLoaderBufferGuard> guard) {
+    if (buffer.data == nullptr && buffer.fd >= 0) {
+        // Mapping stays valid without the descriptor, so loader can release it right away
+        auto file = MappedFile::map(buffer.fd);
+        if (!file) {
+            return nullptr;
+        }
+        return std::make_shared<CustomLoaderBufferAllocator>(file->getData(), file->getSize(), file);
+    }
+    return std::make_shared<CustomLoaderBufferAllocator>(const_cast<uint8_t*>(buffer.data), buffer.size, std::move(guard));
+}
+
 Status ModelInstance::loadOVCNNNetworkUsingCustomLoader() {
     SPDLOG_DEBUG("Try reading model using a custom loader");
     try {
-        std::vector<uint8_t> model;
-        std::vector<uint8_t> weights;
+        CustomLoaderBuffer modelBuffer;
+        CustomLoaderBuffer weightsBuffer;
 
         SPDLOG_INFO("loading CNNNetwork for model: {} basepath: {} <> {} version: {}", getName(), getPath(), this->config.getBasePath().c_str(), getVersion());
 
@@ -328,10 +559,12 @@ Status ModelInstance::loadOVCNNNetworkUsingCustomLoader() {
             throw std::invalid_argument("customloader not exisiting");
         }
 
-        CustomLoaderStatus res = customLoaderInterfacePtr->loadModel(this->config.getName(),
+        CustomLoaderStatus res = customLoaderInterfacePtr->loadModelBuffers(this->config.getName(),
             this->config.getBasePath(),
             getVersion(),
-            this->config.getCustomLoaderOptionsConfigStr(), model, weights);
+            this->config.getCustomLoaderOptionsConfigStr(), modelBuffer, weightsBuffer);
+        auto modelGuard = std::make_shared<CustomLoaderBufferGuard>(std::move(modelBuffer.release));
+        auto weightsGuard = std::make_shared<CustomLoaderBufferGuard>(std::move(weightsBuffer.release));
 
         if (res == CustomLoaderStatus::MODEL_LOAD_ERROR) {
             return StatusCode::FILE_INVALID;
@@ -341,12 +574,27 @@ Status ModelInstance::loadOVCNNNetworkUsingCustomLoader() {
             return StatusCode::INTERNAL_ERROR;
         }
 
-        std::string strModel(model.begin(), model.end());
+        auto model = wrapCustomLoaderBuffer(modelBuffer, std::move(modelGuard));
+        auto weights = wrapCustomLoaderBuffer(weightsBuffer, std::move(weightsGuard));
+        if (!model || !weights) {
+            return StatusCode::FILE_INVALID;
+        }
+        // Model is parsed from string, so its buffer can be released right after copying
+        std::string strModel(static_cast<const char*>(model->getData()), model->getSize());
+        model.reset();
 
         if (res == CustomLoaderStatus::MODEL_TYPE_IR) {
-            Blob::Ptr blobWts = make_shared_blob<uint8_t>({Precision::U8, {weights.size()}, C});
-            blobWts->allocate();
-            std::memcpy(InferenceEngine::as<InferenceEngine::MemoryBlob>(blobWts)->wmap(), weights.data(), weights.size());
+            Blob::Ptr blobWts;
+            if (weights->getSize() == 0) {
+                blobWts = make_shared_blob<uint8_t>({Precision::U8, {0}, C});
+                blobWts->allocate();
+            } else {
+                // Weights blob uses loader memory directly, it is released when network constants are destroyed
+                auto status = createSharedBlob(blobWts, TensorDesc(Precision::U8, {weights->getSize()}, C), weights);
+                if (!status.ok()) {
+                    return status;
+                }
+            }
             network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(strModel, blobWts));
         } else if (res == CustomLoaderStatus::MODEL_TYPE_ONNX) {
             network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(strModel, InferenceEngine::Blob::CPtr()));
@@ -360,14 +608,92 @@ Status ModelInstance::loadOVCNNNetworkUsingCustomLoader() {
     return StatusCode::OK;
 }
 
+plugin_config_t ModelInstance::getDevicePluginConfig(const std::string& device, const plugin_config_t& pluginConfig) {
+    auto supportedKeys = engine->GetMetric(device, METRIC_KEY(SUPPORTED_CONFIG_KEYS)).as<std::vector<std::string>>();
+    plugin_config_t deviceConfig;
+    for (const auto& [key, value] : pluginConfig) {
+        if (std::find(supportedKeys.begin(), supportedKeys.end(), key) != supportedKeys.end()) {
+            deviceConfig[key] = value;
+        } else {
+            SPDLOG_DEBUG("Plugin config key {} is not supported by device {}, skipped for model: {}; version: {}", key, device, getName(), getVersion());
+        }
+    }
+    return deviceConfig;
+}
+
 void ModelInstance::loadExecutableNetworkPtr(const plugin_config_t& pluginConfig) {
-    execNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, targetDevice, pluginConfig));
+    balancedExecNetworks.clear();
+    auto devices = config.getBalancedDevices();
+    if (devices.empty()) {
+        execNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, targetDevice, pluginConfig));
+        return;
+    }
+    for (const auto& device : devices) {
+        balancedExecNetworks.emplace_back(device, std::make_shared<InferenceEngine::ExecutableNetwork>(
+                                                      engine->LoadNetwork(*network, device, getDevicePluginConfig(device, pluginConfig))));
+    }
+    execNetwork = balancedExecNetworks.front().second;
+}
+
+std::string ModelInstance::getCompiledNetworkKey(const plugin_config_t& pluginConfig) {
+    if (config.isCustomLoaderRequiredToLoadModel() || config.getInMemoryFiles() || !config.getBalancedDevices().empty() || modelFiles.empty()) {
+        return "";
+    }
+    std::string filesHash;
+    if (!CompiledNetworkRegistry::hashFiles(modelFiles, filesHash)) {
+        return "";
+    }
+    std::stringstream key;
+    key << filesHash << ";device:" << targetDevice << ";config:";
+    for (const auto& [name, value] : pluginConfig) {
+        key << name << "=" << value << ",";
+    }
+    for (const auto& [name, input] : network->getInputsInfo()) {
+        key << ";input:" << name << "," << input->getPrecision().name() << "," << input->getLayout() << ","
+            << TensorInfo::shapeToString(input->getTensorDesc().getDims());
+        auto& preProcess = input->getPreProcess();
+        key << "," << static_cast<int>(preProcess.getResizeAlgorithm()) << "," << static_cast<int>(preProcess.getColorFormat())
+            << "," << static_cast<int>(preProcess.getMeanVariant());
+        for (size_t c = 0; c < preProcess.getNumberOfChannels(); ++c) {
+            key << "," << preProcess[c]->meanValue << "/" << preProcess[c]->stdScale;
+        }
+    }
+    for (const auto& [name, output] : network->getOutputsInfo()) {
+        key << ";output:" << name << "," << output->getPrecision().name() << "," << output->getLayout() << ","
+            << TensorInfo::shapeToString(output->getTensorDesc().getDims());
+    }
+    return key.str();
+}
+
+void ModelInstance::loadSharedExecutableNetworkPtr(const plugin_config_t& pluginConfig) {
+    const auto key = ovms::Config::instance().shareCompiledModels() ? getCompiledNetworkKey(pluginConfig) : "";
+    if (key.empty()) {
+        loadExecutableNetworkPtr(pluginConfig);
+        return;
+    }
+    bool shared = false;
+    execNetwork = CompiledNetworkRegistry::instance().getOrCompile(key, [this, &pluginConfig]() {
+        loadExecutableNetworkPtr(pluginConfig);
+        return execNetwork;
+    },
+        shared);
+    balancedExecNetworks.clear();
+    if (shared) {
+        SPDLOG_INFO("Model: {}; version: {} uses network compiled by other model version from identical files", getName(), getVersion());
+    }
 }
 
 plugin_config_t ModelInstance::prepareDefaultPluginConfig(const ModelConfig& config) {
     plugin_config_t pluginConfig = config.getPluginConfig();
     // For CPU and GPU, if user did not specify, calculate CPU_THROUGHPUT_STREAMS automatically
     if (config.isDeviceUsed("CPU")) {
+        const auto share = CpuBudget::instance().getShare(config.getName());
+        if (share.threads > 0 && pluginConfig.count("CPU_THREADS_NUM") == 0) {
+            pluginConfig["CPU_THREADS_NUM"] = std::to_string(share.threads);
+        }
+        if (share.streams > 0 && pluginConfig.count("CPU_THROUGHPUT_STREAMS") == 0) {
+            pluginConfig["CPU_THROUGHPUT_STREAMS"] = std::to_string(share.streams);
+        }
         if (pluginConfig.count("CPU_THROUGHPUT_STREAMS") == 0) {
             pluginConfig["CPU_THROUGHPUT_STREAMS"] = "CPU_THROUGHPUT_AUTO";
         }
@@ -382,8 +708,24 @@ plugin_config_t ModelInstance::prepareDefaultPluginConfig(const ModelConfig& con
 
 Status ModelInstance::loadOVExecutableNetwork(const ModelConfig& config) {
     plugin_config_t pluginConfig = prepareDefaultPluginConfig(config);
+    tunedNireq = 0;
+    this->status.setDetails("");
     try {
-        loadExecutableNetworkPtr(pluginConfig);
+        CompilationPool::instance().run([this, &config, &pluginConfig]() {
+            if (isAutoTuneApplicable(config)) {
+                auto status = autoTuneExecutableNetwork(config, pluginConfig);
+                if (!status.ok()) {
+                    SPDLOG_WARN("Auto tuning of model: {}; version: {} failed: {}. Using default configuration",
+                        getName(), getVersion(), status.string());
+                    tunedNireq = 0;
+                    this->status.setDetails("");
+                    pluginConfig = prepareDefaultPluginConfig(config);
+                    loadExecutableNetworkPtr(pluginConfig);
+                }
+            } else {
+                loadSharedExecutableNetworkPtr(pluginConfig);
+            }
+        });
     } catch (std::exception& e) {
         Status status = StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE;
         SPDLOG_ERROR("{}; error: {}; model: {}; version: {}; device: {}",
@@ -409,6 +751,10 @@ Status ModelInstance::fetchModelFilepaths() {
         return StatusCode::OK;
     }
 
+    if (const auto* inMemoryFiles = this->config.getInMemoryFiles()) {
+        return fetchInMemoryModelFiles(*inMemoryFiles);
+    }
+
     SPDLOG_DEBUG("Getting model files from path: {}", path);
     if (!dirExists(path)) {
         SPDLOG_ERROR("Missing model directory {}", path);
@@ -443,125 +789,1242 @@ Status ModelInstance::fetchModelFilepaths() {
     return StatusCode::OK;
 }
 
-Status ModelInstance::prepareInferenceRequestsQueue(const ModelConfig& config) {
-    uint numberOfParallelInferRequests = getNumOfParallelInferRequests(config);
-    if (numberOfParallelInferRequests == 0) {
-        return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed nireq value");
+Status ModelInstance::fetchInMemoryModelFiles(const model_files_contents_t& files) {
+    SPDLOG_DEBUG("Getting model files of model: {} version: {} read to memory", getName(), getVersion());
+    auto findFiles = [this, &files](const auto& extensions) {
+        modelFiles.clear();
+        for (const auto* extension : extensions) {
+            auto it = std::find_if(files.begin(), files.end(), [extension](const auto& file) { return endsWith(file.first, extension); });
+            if (it == files.end()) {
+                modelFiles.clear();
+                return false;
+            }
+            modelFiles.push_back(it->first);
+        }
+        return true;
+    };
+    if (!findFiles(OV_MODEL_FILES_EXTENSIONS) && !findFiles(ONNX_MODEL_FILES_EXTENSIONS)) {
+        SPDLOG_ERROR("Could not find file for model: {} version: {} in path: {}", getName(), getVersion(), path);
+        return StatusCode::FILE_INVALID;
     }
-    inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*execNetwork, numberOfParallelInferRequests);
-    SPDLOG_INFO("Loaded model {}; version: {}; batch size: {}; No of InferRequests: {}",
-        getName(),
-        getVersion(),
-        getBatchSize(),
-        numberOfParallelInferRequests);
     return StatusCode::OK;
 }
 
-void ModelInstance::configureBatchSize(const ModelConfig& config, const DynamicModelParameter& parameter) {
-    if (parameter.isBatchSizeRequested()) {
-        network->setBatchSize(parameter.getBatchSize());
-    } else if (config.getBatchSize() > 0) {
-        network->setBatchSize(config.getBatchSize());
+void ModelInstance::prepareRemoteContext(const ModelConfig& config) {
+    remoteContext.reset();
+    if (!config.isRemoteBlobsEnabled()) {
+        return;
+    }
+    if (!balancedExecNetworks.empty()) {
+        SPDLOG_WARN("Remote blobs are not supported with balanced target device; model {}, version {} uses host memory blobs", getName(), getVersion());
+        return;
+    }
+    try {
+        remoteContext = execNetwork->GetContext();
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_WARN("Target device of model {}, version {} does not support remote blobs; host memory blobs are used: {}", getName(), getVersion(), e.what());
+        return;
     }
+    SPDLOG_INFO("Remote blobs enabled for model {}; version: {}; device: {}", getName(), getVersion(), remoteContext->getDeviceName());
 }
 
-Status ModelInstance::loadModelImpl(const ModelConfig& config, const DynamicModelParameter& parameter) {
-    subscriptionManager.notifySubscribers();
-    this->path = config.getPath();
-    this->targetDevice = config.getTargetDevice();
-    this->config = config;
-    auto status = fetchModelFilepaths();
-
+Status ModelInstance::bindInputBlobs(const ModelConfig& config, OVInferRequestsQueue& queue) {
+    if (!config.isBindInputBlobsEnabled() && !remoteContext) {
+        return StatusCode::OK;
+    }
+    std::map<std::string, InferenceEngine::TensorDesc> inputs;
+    for (const auto& [name, tensorInfo] : getInputsInfo()) {
+        // inputs resized or converted from planar YUV by preprocessing get new blob every time
+        if (!tensorInfo->isResizedByPreprocessing() && !tensorInfo->isPlanarYuv()) {
+            inputs.emplace(tensorInfo->getName(), tensorInfo->isTransposedByServer() ? tensorInfo->getTransposedTensorDesc() : tensorInfo->getTensorDesc());
+        }
+    }
+    auto status = queue.bindInputBlobs(inputs, remoteContext);
     if (!status.ok()) {
-        this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
-        return status;
+        SPDLOG_ERROR("Unable to bind input blobs of model {}, version {}: {}", getName(), getVersion(), status.string());
     }
-    try {
-        if (!this->engine)
-            loadOVEngine();
-        if (!this->network) {
-            if (this->config.isCustomLoaderRequiredToLoadModel()) {
-                // loading the model using the custom loader
-                status = loadOVCNNNetworkUsingCustomLoader();
-            } else {
-                status = loadOVCNNNetwork();
+    return status;
+}
+
+void ModelInstance::prepareElasticity(const ModelConfig& config, OVInferRequestsQueue& queue) {
+    if (config.getMinNireq() == 0) {
+        return;
+    }
+    if (config.isLockMemoryEnabled()) {
+        SPDLOG_WARN("Elastic infer requests are not supported with locked memory; model {}, version {} keeps all infer requests created", getName(), getVersion());
+        return;
+    }
+    queue.enableElasticity(config.getMinNireq(), std::chrono::milliseconds(config.getNireqCooldownMs()));
+    SPDLOG_INFO("Elastic infer requests enabled for model {}; version: {}; active infer requests: {}; cooldown: {} ms",
+        getName(), getVersion(), queue.getActiveStreamsCount(), config.getNireqCooldownMs());
+}
+
+static void logMemoryLock(const MemoryLock& memoryLock, const std::string& what, const std::string& name, model_version_t version) {
+    SPDLOG_INFO("Locked {} bytes of {} of model: {}; version: {} in RAM", memoryLock.getLockedBytes(), what, name, version);
+    if (memoryLock.getLockError() != 0) {
+        SPDLOG_WARN("Could not lock {} bytes of {} of model: {}; version: {} in RAM, memory is only pre-faulted and may be paged out; RLIMIT_MEMLOCK: {}; error: {}",
+            memoryLock.getPrefaultedBytes(), what, name, version, getMemoryLockLimit(), std::strerror(memoryLock.getLockError()));
+    }
+}
+
+void ModelInstance::lockInferRequestsMemory(const ModelConfig& config) {
+    inferRequestsMemoryLock.reset();
+    if (!config.isLockMemoryEnabled() || !inferRequestsQueue) {
+        return;
+    }
+    inferRequestsMemoryLock = std::make_unique<MemoryLock>();
+    std::vector<std::string> names;
+    for (const auto* tensors : {&getInputsInfo(), &getOutputsInfo()}) {
+        for (const auto& [name, tensorInfo] : *tensors) {
+            names.push_back(tensorInfo->getName());
+        }
+    }
+    for (int streamId = 0; streamId < inferRequestsQueue->getStreamsCount(); ++streamId) {
+        auto& inferRequest = inferRequestsQueue->getInferRequest(streamId);
+        for (const auto& name : names) {
+            try {
+                auto blob = inferRequest.GetBlob(name);
+                // remote blobs are in device memory
+                if (!blob || blob->is<InferenceEngine::RemoteBlob>()) {
+                    continue;
+                }
+                auto memoryBlob = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob);
+                if (!memoryBlob) {
+                    continue;
+                }
+                auto holder = memoryBlob->rwmap();
+                inferRequestsMemoryLock->lock(holder.as<const void*>(), memoryBlob->byteSize());
+            } catch (const InferenceEngine::Exception& e) {
+                SPDLOG_DEBUG("Could not lock blob: {} of model: {}; version: {}: {}", name, getName(), getVersion(), e.what());
             }
         }
+    }
+    logMemoryLock(*inferRequestsMemoryLock, "infer requests", getName(), getVersion());
+}
 
+void ModelInstance::lockMemory(const ModelConfig& config, const std::vector<MemoryRange>& mappedBefore) {
+    lockInferRequestsMemory(config);
+    // network read by previous load is kept on reload, its ranges which are still mapped stay locked
+    const auto previouslyLocked = modelMemoryLock ? modelMemoryLock->getRanges() : std::vector<MemoryRange>();
+    // previous lock unlocks its ranges when destroyed, so it has to be gone before they are locked again
+    modelMemoryLock.reset();
+    modelMemoryLock = std::make_unique<MemoryLock>();
+    const auto mapped = getMappedMemory();
+    const auto blobs = inferRequestsMemoryLock->getRanges();
+    for (const auto& range : subtractRanges(subtractRanges(previouslyLocked, subtractRanges(previouslyLocked, mapped)), blobs)) {
+        modelMemoryLock->lock(range);
+    }
+    // weights and compiled network are attributed by mappings created during load, blobs are already counted by infer requests
+    for (const auto& range : subtractRanges(subtractRanges(mapped, mappedBefore), blobs)) {
+        modelMemoryLock->lock(range);
+    }
+    logMemoryLock(*modelMemoryLock, "weights and compiled network", getName(), getVersion());
+}
+
+Status ModelInstance::prepareInferenceRequestsQueue(const ModelConfig& config) {
+    prepareRemoteContext(config);
+    if (!balancedExecNetworks.empty()) {
+        std::vector<OVInferRequestsQueue::DeviceStreams> devices;
+        for (auto& [device, deviceNetwork] : balancedExecNetworks) {
+            uint numberOfParallelInferRequests = getNumOfParallelInferRequests(config, *deviceNetwork);
+            if (numberOfParallelInferRequests == 0) {
+                return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed nireq value");
+            }
+            devices.push_back({device, *deviceNetwork, static_cast<int>(numberOfParallelInferRequests),
+                &getDeviceRequestTimeHistogram(MetricRegistry::getInstance(), getName(), getVersion(), device)});
+            SPDLOG_INFO("Loaded model {}; version: {}; batch size: {}; device: {}; No of InferRequests: {}",
+                getName(), getVersion(), getBatchSize(), device, numberOfParallelInferRequests);
+        }
+        inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(devices, config.getMaxQueueDepth(), config.getMaxQueueWaitMs(), config.getPipelineReservedNireq());
+        trackUtilization(*inferRequestsQueue);
+        auto status = bindInputBlobs(config, *inferRequestsQueue);
         if (!status.ok()) {
-            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
             return status;
         }
+        prepareElasticity(config, *inferRequestsQueue);
+        return StatusCode::OK;
+    }
+    uint numberOfParallelInferRequests = getNumOfParallelInferRequests(config);
+    if (numberOfParallelInferRequests == 0) {
+        return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed nireq value");
+    }
+    inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*execNetwork, numberOfParallelInferRequests,
+        config.getMaxQueueDepth(), config.getMaxQueueWaitMs(), config.getPipelineReservedNireq());
+    trackUtilization(*inferRequestsQueue);
+    auto status = bindInputBlobs(config, *inferRequestsQueue);
+    if (!status.ok()) {
+        return status;
+    }
+    prepareElasticity(config, *inferRequestsQueue);
+    SPDLOG_INFO("Loaded model {}; version: {}; batch size: {}; No of InferRequests: {}",
+        getName(),
+        getVersion(),
+        getBatchSize(),
+        numberOfParallelInferRequests);
+    return StatusCode::OK;
+}
 
-        configureBatchSize(this->config, parameter);
-        status = loadInputTensors(this->config, parameter);
-        if (!status.ok()) {
-            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
-            return status;
+void ModelInstance::prepareDynamicBatcher(const ModelConfig& config) {
+    dynamicBatcher.reset();
+    if (!config.isDynamicBatchingEnabled()) {
+        return;
+    }
+    for (const auto& [name, input] : getInputsInfo()) {
+        if (input->isResizedByPreprocessing()) {
+            SPDLOG_WARN("Dynamic batching disabled for model {}; version: {}. Input {} accepts any resolution to resize",
+                getName(), getVersion(), name);
+            return;
         }
-        loadOutputTensors(this->config);
-        status = loadOVExecutableNetwork(this->config);
-        if (!status.ok()) {
-            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
-            return status;
+        if (input->isPlanarYuv()) {
+            SPDLOG_WARN("Dynamic batching disabled for model {}; version: {}. Input {} accepts planar YUV frames",
+                getName(), getVersion(), name);
+            return;
         }
-        status = prepareInferenceRequestsQueue(this->config);
-        if (!status.ok()) {
-            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
-            return status;
+    }
+    for (const auto& [name, output] : getOutputsInfo()) {
+        const auto& shape = output->getEffectiveShape();
+        if (shape.size() == 0 || shape[0] != config.getMaxBatchSize()) {
+            SPDLOG_WARN("Dynamic batching disabled for model {}; version: {}. Output {} does not have batch dimension {}",
+                getName(), getVersion(), name, config.getMaxBatchSize());
+            return;
         }
-    } catch (const InferenceEngine::Exception& e) {
-        SPDLOG_ERROR("exception occurred while loading network: {}", e.what());
-        this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
-        return StatusCode::NETWORK_NOT_LOADED;
     }
-    this->status.setAvailable();
-    modelLoadedNotify.notify_all();
-    return status;
+    dynamicBatcher = std::make_unique<DynamicBatcher>(*this, config.getMaxBatchSize(), config.getBatchTimeoutUs(), config.getBatchLatencyTargetUs());
+    SPDLOG_INFO("Dynamic batching enabled for model {}; version: {}; max batch size: {}; batch timeout: {} us; latency target: {} us",
+        getName(), getVersion(), config.getMaxBatchSize(), config.getBatchTimeoutUs(), config.getBatchLatencyTargetUs());
 }
 
-Status ModelInstance::loadModel(const ModelConfig& config) {
-    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
-    SPDLOG_INFO("Loading model: {}, version: {}, from path: {}, with target device: {} ...",
-        config.getName(), config.getVersion(), config.getPath(), config.getTargetDevice());
-    if (config.getBatchingMode() == AUTO) {
-        SPDLOG_INFO("Batch size mode for model {} is set to auto", config.getName());
-    } else if (config.anyShapeSetToAuto()) {
-        SPDLOG_INFO("Some inputs shapes for model {} are set to auto", config.getName());
+void ModelInstance::prepareBatchSplitter(const ModelConfig& config) {
+    batchSplitter.reset();
+    if (config.getBatchSplitParallelism() == 0) {
+        return;
     }
-    this->status = ModelVersionStatus(config.getName(), config.getVersion());
-    this->status.setLoading();
-    return loadModelImpl(config);
+    if (dynamicBatcher) {
+        SPDLOG_WARN("Batch splitting disabled for model {}; version: {}. Dynamic batching is enabled", getName(), getVersion());
+        return;
+    }
+    if (!config.getPostprocessing().empty()) {
+        SPDLOG_WARN("Batch splitting disabled for model {}; version: {}. Outputs are postprocessed", getName(), getVersion());
+        return;
+    }
+    for (const auto& [name, input] : getInputsInfo()) {
+        if (input->isResizedByPreprocessing() || input->isPlanarYuv()) {
+            SPDLOG_WARN("Batch splitting disabled for model {}; version: {}. Input {} is converted by preprocessing",
+                getName(), getVersion(), name);
+            return;
+        }
+        const auto& shape = input->getEffectiveShape();
+        if (shape.size() == 0 || shape[0] != getBatchSize()) {
+            SPDLOG_WARN("Batch splitting disabled for model {}; version: {}. Input {} does not have batch dimension {}",
+                getName(), getVersion(), name, getBatchSize());
+            return;
+        }
+    }
+    for (const auto& [name, output] : getOutputsInfo()) {
+        const auto& shape = output->getEffectiveShape();
+        if (shape.size() == 0 || shape[0] != getBatchSize()) {
+            SPDLOG_WARN("Batch splitting disabled for model {}; version: {}. Output {} does not have batch dimension {}",
+                getName(), getVersion(), name, getBatchSize());
+            return;
+        }
+    }
+    batchSplitter = std::make_unique<BatchSplitter>(*this, config.getBatchSplitParallelism());
+    SPDLOG_INFO("Batch splitting enabled for model {}; version: {}; sub-batch size: {}; parallelism: {}",
+        getName(), getVersion(), getBatchSize(), config.getBatchSplitParallelism());
 }
 
-Status ModelInstance::reloadModel(const ModelConfig& config, const DynamicModelParameter& parameter) {
-    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
-    this->status.setLoading();
-    while (!canUnloadInstance()) {
-        SPDLOG_INFO("Waiting to reload model: {} version: {}. Blocked by: {} inferences in progress.",
-            getName(), getVersion(), predictRequestsHandlesCount);
-        std::this_thread::sleep_for(std::chrono::milliseconds(UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS));
+void ModelInstance::prepareShapeBucketCache(const ModelConfig& config) {
+    shapeBucketCache.reset();
+    shapeCachePrewarmWorker.reset();
+    if (!config.anyShapeSetToAuto()) {
+        shapeHistogram.reset();
+    } else if (!shapeHistogram) {
+        shapeHistogram = std::make_unique<ShapeHistogram>();
     }
-    if ((this->config.isCustomLoaderRequiredToLoadModel()) && (isCustomLoaderConfigChanged)) {
-        // unloading and the loading back the model
-        isCustomLoaderConfigChanged = false;
-        retireModel(isCustomLoaderConfigChanged);
+    if (!config.isShapeCacheEnabled()) {
+        return;
     }
-    return loadModelImpl(config, parameter);
+    shapeBucketCache = std::make_unique<ShapeBucketCache>(config.getShapeCacheSize());
+    if (config.isShapeCachePrewarmEnabled()) {
+        shapeCachePrewarmWorker = std::make_unique<WorkerPool>(1);
+    }
+    SPDLOG_INFO("Shape cache enabled for model {}; version: {}; cache size: {}; prewarm: {}",
+        getName(), getVersion(), config.getShapeCacheSize(), config.isShapeCachePrewarmEnabled());
 }
 
-Status ModelInstance::recoverFromReloadingError(const Status& status) {
-    SPDLOG_WARN("Failed to perform complete reload with requested dynamic parameter. Model: {} version: {} with error: {}. Reloading to previous configuration",
-        getName(), getVersion(), status.string());
-    bool changeStatus{false};
-    retireModel(changeStatus);
-
-    auto recoveryStatus = reloadModel(config);
-    if (!recoveryStatus.ok()) {
-        SPDLOG_WARN("Failed to recover model: {} version: {} to previous configuration with error: {}",
-            getName(), getVersion(), recoveryStatus.string());
+void ModelInstance::recordRequestShapes(const tensorflow::serving::PredictRequest* requestProto) {
+    if (!shapeHistogram) {
+        return;
+    }
+    const uint64_t requests = shapeHistogram->record(getRequestShapes(requestProto));
+    if (shapeCachePrewarmWorker && requests % SHAPE_CACHE_PREWARM_INTERVAL == 0 && !shapeCachePrewarmScheduled.exchange(true)) {
+        shapeCachePrewarmWorker->schedule([this]() {
+            prewarmShapeCache();
+            shapeCachePrewarmScheduled = false;
+        });
     }
-    return status;
+}
+
+void ModelInstance::prewarmShapeCache() {
+    // unload holds loading mutex while it waits for this task to finish
+    std::unique_lock<std::recursive_mutex> loadingLock(loadingMutex, std::try_to_lock);
+    if (!loadingLock.owns_lock() || getStatus().getState() != ModelVersionState::AVAILABLE || !shapeBucketCache) {
+        return;
+    }
+    std::map<std::string, shape_t> defaultShapes;
+    for (const auto& [name, tensorInfo] : getInputsInfo()) {
+        defaultShapes[name] = tensorInfo->getShape();
+    }
+    const auto frequentShapes = shapeHistogram->getMostFrequent(shapeBucketCache->getCapacity() + 1);
+    // the least frequent first, so that the most frequent shapes end up most recently used
+    for (auto it = frequentShapes.rbegin(); it != frequentShapes.rend(); ++it) {
+        const auto& [shapes, requests] = *it;
+        if (shapes == defaultShapes || shapeBucketCache->find(shapes)) {
+            continue;
+        }
+        std::shared_ptr<ShapeBucket> bucket;
+        auto status = compileShapeBucket(shapes, bucket);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Cannot prewarm shape cache of model: {}; version: {} with shape of {} requests: {}",
+                getName(), getVersion(), requests, status.string());
+            continue;
+        }
+        SPDLOG_INFO("Prewarmed shape cache of model: {}; version: {} with shape of {} requests", getName(), getVersion(), requests);
+        shapeBucketCache->insert(bucket);
+    }
+}
+
+void ModelInstance::prepareResponseCache(const ModelConfig& config) {
+    responseCache.reset();
+    if (!config.isResponseCacheEnabled()) {
+        return;
+    }
+    responseCache = std::make_unique<ResponseCache>(static_cast<size_t>(config.getResponseCacheSizeMb()) * 1024 * 1024);
+    SPDLOG_INFO("Response cache enabled for model {}; version: {}; cache size: {} MB",
+        getName(), getVersion(), config.getResponseCacheSizeMb());
+}
+
+void ModelInstance::prepareLayerProfiler(const ModelConfig& config) {
+    std::atomic_store(&layerProfiler, std::shared_ptr<LayerProfiler>());
+    if (config.getLayerProfilingInterval() == 0) {
+        return;
+    }
+    if (config.isStateful() || !config.getBalancedDevices().empty()) {
+        SPDLOG_WARN("Layer profiling is not supported for stateful models and balanced target devices; model: {}; version: {}", getName(), getVersion());
+        return;
+    }
+    plugin_config_t pluginConfig = prepareDefaultPluginConfig(config);
+    pluginConfig[CONFIG_KEY(PERF_COUNT)] = CONFIG_VALUE(YES);
+    // single infer request of the profiling network does not need more streams
+    if (pluginConfig.count("CPU_THROUGHPUT_STREAMS") > 0) {
+        pluginConfig["CPU_THROUGHPUT_STREAMS"] = "1";
+    }
+    if (pluginConfig.count("GPU_THROUGHPUT_STREAMS") > 0) {
+        pluginConfig["GPU_THROUGHPUT_STREAMS"] = "1";
+    }
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> profilingNetwork;
+    try {
+        CompilationPool::instance().run([this, &pluginConfig, &profilingNetwork]() {
+            profilingNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, targetDevice, pluginConfig));
+        });
+        std::atomic_store(&layerProfiler, std::make_shared<LayerProfiler>(profilingNetwork, config.getLayerProfilingInterval()));
+    } catch (const std::exception& e) {
+        SPDLOG_WARN("Unable to compile network with performance counters for layer profiling of model: {}; version: {}; error: {}",
+            getName(), getVersion(), e.what());
+        return;
+    }
+    SPDLOG_INFO("Layer profiling enabled for model {}; version: {}; every {} request is profiled",
+        getName(), getVersion(), config.getLayerProfilingInterval());
+}
+
+void ModelInstance::prepareRequestCoalescer(const ModelConfig& config) {
+    std::atomic_store(&requestCoalescer, config.isCoalesceRequestsEnabled() ? std::make_shared<RequestCoalescer>() : std::shared_ptr<RequestCoalescer>());
+    if (config.isCoalesceRequestsEnabled()) {
+        SPDLOG_INFO("Request coalescing enabled for model {}; version: {}", getName(), getVersion());
+    }
+}
+
+void ModelInstance::loadWarmupSamples(std::vector<tensorflow::serving::PredictRequest>& samples) {
+    const std::string warmupPath = path + "/" + WARMUP_DIRECTORY;
+    if (this->config.isCustomLoaderRequiredToLoadModel() || !dirExists(warmupPath)) {
+        return;
+    }
+    std::vector<std::string> fileNames;
+    DIR* dir = opendir(warmupPath.c_str());
+    if (!dir) {
+        SPDLOG_WARN("Failed to opendir: {}", warmupPath);
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_type == DT_REG) {
+            fileNames.emplace_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(fileNames.begin(), fileNames.end());
+
+    for (const auto& fileName : fileNames) {
+        const std::string filePath = warmupPath + "/" + fileName;
+        std::ifstream file(filePath, std::ios::binary);
+        tensorflow::serving::PredictRequest sample;
+        if (!file || !sample.ParseFromIstream(&file)) {
+            SPDLOG_WARN("Skipping warmup file: {} of model: {}; version: {}. It is not a serialized PredictRequest", filePath, getName(), getVersion());
+            continue;
+        }
+        auto status = validate(&sample);
+        if (!status.ok()) {
+            SPDLOG_WARN("Skipping warmup file: {} of model: {}; version: {}. Validation failed: {}", filePath, getName(), getVersion(), status.string());
+            continue;
+        }
+        samples.emplace_back(std::move(sample));
+    }
+}
+
+static Status setZeroFilledInputs(InferenceEngine::InferRequest& inferRequest, const tensor_map_t& inputsInfo) {
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        InferenceEngine::Blob::Ptr blob;
+        auto status = createSharedBlob(blob, tensorInfo->getTensorDesc());
+        if (!status.ok()) {
+            return status;
+        }
+        std::memset(InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<char*>(), 0, blob->byteSize());
+        inferRequest.SetBlob(tensorInfo->getName(), blob);
+    }
+    return StatusCode::OK;
+}
+
+Status ModelInstance::warmupInferRequests(OVInferRequestsQueue& queue,
+    const tensor_map_t& inputsInfo,
+    const std::vector<tensorflow::serving::PredictRequest>& samples,
+    uint32_t iterations) {
+    std::vector<int> streamIds;
+    int streamId;
+    while (queue.tryGetIdleStream(streamId)) {
+        streamIds.push_back(streamId);
+    }
+    Status status = StatusCode::OK;
+    for (int id : streamIds) {
+        auto& inferRequest = queue.getInferRequest(id);
+        for (uint32_t i = 0; i < iterations && status.ok(); ++i) {
+            if (!samples.empty()) {
+                InputSink<InferRequest&> inputSink(inferRequest);
+                bool isPipeline = false;
+                status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(samples[i % samples.size()], inputsInfo, inputSink, isPipeline);
+            } else if (i == 0) {
+                status = setZeroFilledInputs(inferRequest, inputsInfo);
+            }
+            if (status.ok()) {
+                status = performInference(inferRequest);
+            }
+        }
+        if (getModelConfig().isStateful()) {
+            // warmup must not leave anything in state of sequences served later
+            for (auto&& state : inferRequest.QueryState()) {
+                state.Reset();
+            }
+        }
+        if (!status.ok()) {
+            break;
+        }
+    }
+    for (int id : streamIds) {
+        queue.returnStream(id);
+    }
+    return status;
+}
+
+Status ModelInstance::warmupModel(const ModelConfig& config) {
+    const uint32_t iterations = config.getWarmupIterations();
+    if (iterations == 0) {
+        return StatusCode::OK;
+    }
+    std::vector<tensorflow::serving::PredictRequest> samples;
+    loadWarmupSamples(samples);
+    SPDLOG_INFO("Warming up model: {}; version: {}; iterations per infer request: {}; warmup requests: {}",
+        getName(), getVersion(), iterations, samples.empty() ? "zero filled" : std::to_string(samples.size()));
+    Timer<TIMER_END> timer;
+    timer.start(WARMUP);
+    Status status = StatusCode::OK;
+    try {
+        status = warmupInferRequests(getInferRequestsQueue(), getInputsInfo(), samples, iterations);
+        for (auto& [batchSize, variant] : batchSizeVariants) {
+            if (!status.ok()) {
+                break;
+            }
+            // samples match only the default executable network
+            status = warmupInferRequests(*variant.bucket->inferRequestsQueue, variant.bucket->inputsInfo, {}, iterations);
+        }
+        for (auto& [sequenceLength, bucket] : sequenceLengthBuckets) {
+            if (!status.ok()) {
+                break;
+            }
+            status = warmupInferRequests(*bucket.bucket->inferRequestsQueue, bucket.bucket->inputsInfo, {}, iterations);
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+    }
+    timer.stop(WARMUP);
+    if (!status.ok()) {
+        return status;
+    }
+    SPDLOG_INFO("Warmup of model: {}; version: {} finished in {:.3f} ms",
+        getName(), getVersion(), timer.elapsed<std::chrono::microseconds>(WARMUP) / 1000);
+    return StatusCode::OK;
+}
+
+bool ModelInstance::isAutoTuneApplicable(const ModelConfig& config) const {
+    if (!config.isAutoTuneEnabled()) {
+        return false;
+    }
+    if (config.getTargetDevice() != "CPU") {
+        SPDLOG_WARN("Auto tuning of model: {}; version: {} skipped. It is supported only on CPU target device", getName(), getVersion());
+        return false;
+    }
+    if (config.getNireq() > 0 || ovms::Config::instance().nireq() > 0 || config.getPluginConfig().count(CPU_THROUGHPUT_STREAMS)) {
+        SPDLOG_WARN("Auto tuning of model: {}; version: {} skipped. Nireq or {} is set explicitly", getName(), getVersion(), CPU_THROUGHPUT_STREAMS);
+        return false;
+    }
+    return true;
+}
+
+Status ModelInstance::benchmarkExecutableNetwork(uint32_t nireq, double& throughput, double& latencyMs) {
+    std::vector<InferenceEngine::InferRequest> inferRequests;
+    for (uint32_t i = 0; i < nireq; ++i) {
+        inferRequests.push_back(execNetwork->CreateInferRequest());
+        auto status = setZeroFilledInputs(inferRequests.back(), getInputsInfo());
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    std::atomic<uint64_t> inferences{0};
+    std::atomic<uint64_t> latencyUs{0};
+    std::atomic<bool> failed{false};
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::milliseconds(AUTO_TUNE_CANDIDATE_DURATION_MILLISECONDS);
+    std::vector<std::thread> threads;
+    for (auto& inferRequest : inferRequests) {
+        threads.emplace_back([&inferRequest, &inferences, &latencyUs, &failed, deadline]() {
+            try {
+                while (!failed && std::chrono::steady_clock::now() < deadline) {
+                    auto inferenceStart = std::chrono::steady_clock::now();
+                    inferRequest.Infer();
+                    latencyUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - inferenceStart).count();
+                    ++inferences;
+                }
+            } catch (const InferenceEngine::Exception& e) {
+                SPDLOG_DEBUG("Auto tuning inference failed: {}", e.what());
+                failed = true;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (failed || inferences == 0) {
+        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+    }
+    const auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    throughput = inferences * 1000000.0 / elapsedUs;
+    latencyMs = latencyUs / 1000.0 / inferences;
+    return StatusCode::OK;
+}
+
+Status ModelInstance::autoTuneExecutableNetwork(const ModelConfig& config, plugin_config_t& pluginConfig) {
+    struct Candidate {
+        uint32_t streams;
+        uint32_t nireq;
+        double throughput;
+        double latencyMs;
+    };
+    const double maxLatencyMs = config.getAutoTuneMaxLatencyMs();
+    auto fitsLatency = [maxLatencyMs](const Candidate& candidate) {
+        return maxLatencyMs == 0 || candidate.latencyMs <= maxLatencyMs;
+    };
+    auto isBetter = [&fitsLatency](const Candidate& candidate, const Candidate& best) {
+        if (fitsLatency(candidate) != fitsLatency(best)) {
+            return fitsLatency(candidate);
+        }
+        return fitsLatency(candidate) ? candidate.throughput > best.throughput : candidate.latencyMs < best.latencyMs;
+    };
+
+    uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+    // streams candidates stay within share of global CPU budget
+    const auto share = CpuBudget::instance().getShare(config.getName());
+    if (share.streams > 0) {
+        cores = std::min(cores, share.streams);
+    } else if (share.threads > 0) {
+        cores = std::min(cores, share.threads);
+    }
+    std::vector<uint32_t> streamsCandidates;
+    for (uint32_t streams = 1; streams < cores; streams *= 2) {
+        streamsCandidates.push_back(streams);
+    }
+    streamsCandidates.push_back(cores);
+
+    SPDLOG_INFO("Auto tuning model: {}; version: {}; streams candidates: {}; max latency: {} ms",
+        getName(), getVersion(), streamsCandidates.size(), config.getAutoTuneMaxLatencyMs());
+    std::optional<Candidate> best;
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> bestNetwork;
+    for (uint32_t streams : streamsCandidates) {
+        plugin_config_t candidateConfig = pluginConfig;
+        candidateConfig[CPU_THROUGHPUT_STREAMS] = std::to_string(streams);
+        loadExecutableNetworkPtr(candidateConfig);
+        for (uint32_t nireq : {streams, streams * 2}) {
+            Candidate candidate{streams, nireq, 0, 0};
+            auto status = benchmarkExecutableNetwork(nireq, candidate.throughput, candidate.latencyMs);
+            if (!status.ok()) {
+                return status;
+            }
+            SPDLOG_DEBUG("Auto tuning model: {}; version: {}; streams: {}; nireq: {}; throughput: {:.1f} fps; latency: {:.3f} ms",
+                getName(), getVersion(), streams, nireq, candidate.throughput, candidate.latencyMs);
+            if (!best || isBetter(candidate, best.value())) {
+                best = candidate;
+                bestNetwork = execNetwork;
+            }
+        }
+    }
+    execNetwork = bestNetwork;
+    pluginConfig[CPU_THROUGHPUT_STREAMS] = std::to_string(best->streams);
+    tunedNireq = best->nireq;
+
+    std::stringstream details;
+    details << std::fixed << std::setprecision(1) << "auto tuned " << CPU_THROUGHPUT_STREAMS << ": " << best->streams
+            << ", nireq: " << best->nireq << ", throughput: " << best->throughput << " fps, latency: " << best->latencyMs << " ms";
+    this->status.setDetails(details.str());
+    if (!fitsLatency(best.value())) {
+        SPDLOG_WARN("Auto tuning of model: {}; version: {} found no configuration within {} ms latency, using the fastest one",
+            getName(), getVersion(), config.getAutoTuneMaxLatencyMs());
+    }
+    SPDLOG_INFO("Model: {}; version: {} {}. Set nireq and plugin_config to keep it without tuning",
+        getName(), getVersion(), details.str());
+    return StatusCode::OK;
+}
+
+Status ModelInstance::prepareBatchSizeVariants(const ModelConfig& config, const DynamicModelParameter& parameter) {
+    if (parameter.isBatchSizeRequested() && !batchSizeVariants.empty()) {
+        // variants do not depend on batch size of the default executable network
+        return StatusCode::OK;
+    }
+    batchSizeVariants.clear();
+    for (size_t batchSize : config.getBatchSizeVariants()) {
+        std::map<std::string, shape_t> shapes;
+        for (const auto& [name, tensorInfo] : getInputsInfo()) {
+            auto shape = tensorInfo->getShape();
+            if (shape.empty()) {
+                SPDLOG_ERROR("Cannot compile batch size variant: {} of model: {}; version: {}. Input {} has no batch dimension",
+                    batchSize, getName(), getVersion(), name);
+                return StatusCode::INVALID_BATCH_SIZE_VARIANTS;
+            }
+            shape[0] = batchSize;
+            shapes[name] = shape;
+        }
+        std::shared_ptr<ShapeBucket> bucket;
+        auto status = compileShapeBucket(shapes, bucket);
+        if (!status.ok()) {
+            SPDLOG_ERROR("Cannot compile batch size variant: {} of model: {}; version: {}; error: {}",
+                batchSize, getName(), getVersion(), status.string());
+            batchSizeVariants.clear();
+            return status;
+        }
+        auto& variant = batchSizeVariants[batchSize];
+        variant.bucket = bucket;
+        bool outputsBatched = std::all_of(bucket->outputsInfo.begin(), bucket->outputsInfo.end(), [batchSize](const auto& output) {
+            const auto& shape = output.second->getEffectiveShape();
+            return shape.size() > 0 && shape[0] == batchSize;
+        });
+        if (outputsBatched) {
+            variant.padder = std::make_unique<DynamicBatcher>(*this, *bucket->inferRequestsQueue, bucket->inputsInfo, bucket->outputsInfo, batchSize, 0);
+        } else {
+            SPDLOG_WARN("Batch size variant: {} of model: {}; version: {} will serve only requests with exactly this batch size. Outputs do not have batch dimension",
+                batchSize, getName(), getVersion());
+        }
+        SPDLOG_INFO("Compiled batch size variant: {} of model: {}; version: {}", batchSize, getName(), getVersion());
+    }
+    return StatusCode::OK;
+}
+
+Status ModelInstance::inferWithBatchSizeVariant(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    const RequestContext& context,
+    bool& routed) {
+    routed = false;
+    const size_t requestBatchSize = getRequestBatchSize(requestProto);
+    auto it = batchSizeVariants.lower_bound(requestBatchSize);
+    if (it == batchSizeVariants.end()) {
+        return StatusCode::OK;
+    }
+    auto& [variantBatchSize, variant] = *it;
+    if (variantBatchSize == requestBatchSize) {
+        routed = true;
+        return inferWithQueue(requestProto, responseProto, *variant.bucket->inferRequestsQueue,
+            variant.bucket->inputsInfo, variant.bucket->outputsInfo, context);
+    }
+    if (!variant.padder) {
+        return StatusCode::OK;
+    }
+    for (const auto& [name, input] : requestProto->inputs()) {
+        if (input.dtype() == tensorflow::DataType::DT_STRING || isSparseTensor(input)) {
+            // binary and sparse inputs are decoded directly into infer request blobs and cannot be padded
+            return StatusCode::OK;
+        }
+    }
+    routed = true;
+    SPDLOG_DEBUG("Padding request for model {}, version {} with batch size: {} to batch size variant: {}",
+        requestProto->model_spec().name(), getVersion(), requestBatchSize, variantBatchSize);
+    return variant.padder->infer(requestProto, responseProto, requestBatchSize);
+}
+
+Status ModelInstance::prepareLatencyProfile(const ModelConfig& config, const DynamicModelParameter& parameter) {
+    if (parameter.isBatchSizeRequested() && latencyProfile) {
+        // profile does not depend on batch size of the default executable network
+        return StatusCode::OK;
+    }
+    latencyProfile.reset();
+    const auto& profile = config.getLatencyProfile();
+    if (!profile.isEnabled()) {
+        return StatusCode::OK;
+    }
+    std::map<std::string, shape_t> shapes;
+    for (const auto& [name, tensorInfo] : getInputsInfo()) {
+        auto shape = tensorInfo->getShape();
+        if (shape.empty()) {
+            SPDLOG_ERROR("Cannot compile latency profile of model: {}; version: {}. Input {} has no batch dimension",
+                getName(), getVersion(), name);
+            return StatusCode::INVALID_LATENCY_PROFILE;
+        }
+        shape[0] = profile.batchSize;
+        shapes[name] = shape;
+    }
+    // streams of the default network serve throughput, single stream serves latency unless profile says otherwise
+    plugin_config_t pluginConfig = prepareDefaultPluginConfig(config);
+    for (const char* streamsKey : {"CPU_THROUGHPUT_STREAMS", "GPU_THROUGHPUT_STREAMS"}) {
+        if (pluginConfig.count(streamsKey) > 0) {
+            pluginConfig[streamsKey] = "1";
+        }
+    }
+    for (const auto& [key, value] : profile.pluginConfig) {
+        pluginConfig[key] = value;
+    }
+    auto network = std::make_unique<LatencyProfileNetwork>();
+    auto status = compileShapeBucket(shapes, network->bucket, pluginConfig, profile.nireq);
+    if (!status.ok()) {
+        SPDLOG_ERROR("Cannot compile latency profile of model: {}; version: {}; error: {}",
+            getName(), getVersion(), status.string());
+        return status;
+    }
+    network->inputsMetadata = TensorMetadataTable(network->bucket->inputsInfo, nullptr);
+    latencyProfile = std::move(network);
+    SPDLOG_INFO("Compiled latency profile of model: {}; version: {}; batch size: {}; nireq: {}",
+        getName(), getVersion(), profile.batchSize, profile.nireq);
+    return StatusCode::OK;
+}
+
+Status ModelInstance::inferWithLatencyProfile(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    const RequestContext& context,
+    bool& routed) {
+    routed = false;
+    const auto& profile = getModelConfig().getLatencyProfile();
+    if (!isLatencyProfileBatchSize(getRequestBatchSize(requestProto))) {
+        return StatusCode::OK;
+    }
+    auto& queue = *latencyProfile->bucket->inferRequestsQueue;
+    const bool fitsDefaultNetwork = dynamicBatcher ? profile.batchSize <= getModelConfig().getMaxBatchSize() : profile.batchSize == getBatchSize();
+    if (fitsDefaultNetwork) {
+        const bool profileIdle = queue.getIdleStreamsCount() > 0;
+        const bool defaultIdle = getInferRequestsQueue().getIdleStreamsCount() > 0;
+        const bool interactive = context.priority >= profile.minPriority;
+        if (interactive ? (!profileIdle && defaultIdle) : (!profileIdle || defaultIdle)) {
+            return StatusCode::OK;
+        }
+    }
+    size_t requestBatchSize = 0;
+    auto status = validateForDynamicBatching(requestProto, latencyProfile->inputsMetadata, latencyProfile->bucket->outputsInfo, profile.batchSize, requestBatchSize);
+    if (!status.ok() || requestBatchSize != profile.batchSize) {
+        // default path reports its own validation errors
+        return StatusCode::OK;
+    }
+    routed = true;
+    SPDLOG_DEBUG("Routing request for model {}, version {} with batch size: {} to latency profile",
+        requestProto->model_spec().name(), getVersion(), requestBatchSize);
+    return inferWithQueue(requestProto, responseProto, queue, latencyProfile->bucket->inputsInfo, latencyProfile->bucket->outputsInfo, context);
+}
+
+Status ModelInstance::prepareSequenceLengthBuckets(const ModelConfig& config) {
+    sequenceLengthBuckets.clear();
+    sequenceOutputs.clear();
+    if (config.getSequenceLengthBuckets().empty()) {
+        return StatusCode::OK;
+    }
+    const size_t batchSize = getBatchSize();
+    for (const auto& [name, tensorInfo] : getOutputsInfo()) {
+        sequenceOutputs.insert(name);
+    }
+    for (size_t sequenceLength : config.getSequenceLengthBuckets()) {
+        std::map<std::string, shape_t> shapes;
+        bool anySequenceInput = false;
+        for (const auto& [name, tensorInfo] : getInputsInfo()) {
+            auto shape = tensorInfo->getShape();
+            if (shape.size() > 1) {
+                shape[1] = sequenceLength;
+                anySequenceInput = true;
+            }
+            shapes[name] = shape;
+        }
+        if (!anySequenceInput) {
+            SPDLOG_ERROR("Cannot compile sequence length bucket: {} of model: {}; version: {}. No input has sequence dimension",
+                sequenceLength, getName(), getVersion());
+            sequenceLengthBuckets.clear();
+            return StatusCode::INVALID_SEQUENCE_LENGTH_BUCKETS;
+        }
+        std::shared_ptr<ShapeBucket> bucket;
+        auto status = compileShapeBucket(shapes, bucket);
+        if (!status.ok()) {
+            SPDLOG_ERROR("Cannot compile sequence length bucket: {} of model: {}; version: {}; error: {}",
+                sequenceLength, getName(), getVersion(), status.string());
+            sequenceLengthBuckets.clear();
+            return status;
+        }
+        auto& sequenceBucket = sequenceLengthBuckets[sequenceLength];
+        sequenceBucket.bucket = bucket;
+        sequenceBucket.inputsMetadata = TensorMetadataTable(bucket->inputsInfo, nullptr);
+        bool outputsBatched = true;
+        for (const auto& [name, tensorInfo] : bucket->outputsInfo) {
+            const auto& shape = tensorInfo->getEffectiveShape();
+            outputsBatched = outputsBatched && shape.size() > 0 && shape[0] == batchSize;
+            if (shape.size() < 2 || shape[1] != sequenceLength) {
+                sequenceOutputs.erase(name);
+            }
+        }
+        if (outputsBatched) {
+            // with dynamic batching concurrent requests of the bucket are coalesced, otherwise smaller batches are only padded
+            const bool batching = config.isDynamicBatchingEnabled();
+            sequenceBucket.batcher = std::make_unique<DynamicBatcher>(*this, *bucket->inferRequestsQueue, bucket->inputsInfo, bucket->outputsInfo,
+                batchSize, batching ? config.getBatchTimeoutUs() : 0, batching ? config.getBatchLatencyTargetUs() : 0);
+        } else {
+            SPDLOG_WARN("Sequence length bucket: {} of model: {}; version: {} will serve only requests with batch size {}. Outputs do not have batch dimension",
+                sequenceLength, getName(), getVersion(), batchSize);
+        }
+        SPDLOG_INFO("Compiled sequence length bucket: {} of model: {}; version: {}", sequenceLength, getName(), getVersion());
+    }
+    return StatusCode::OK;
+}
+
+Status ModelInstance::inferWithSequenceLengthBucket(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    const RequestContext& context,
+    bool& routed) {
+    routed = false;
+    const auto& attentionMaskInput = getModelConfig().getAttentionMaskInput();
+    size_t requestLength = 0;
+    if (!getRequestSequenceLength(*requestProto, getInputsInfo(), attentionMaskInput, requestLength)) {
+        return StatusCode::OK;
+    }
+    auto it = sequenceLengthBuckets.lower_bound(requestLength);
+    if (it == sequenceLengthBuckets.end()) {
+        return StatusCode::OK;
+    }
+    auto& [bucketLength, sequenceBucket] = *it;
+    const auto& bucket = *sequenceBucket.bucket;
+    tensorflow::serving::PredictRequest paddedRequest;
+    if (!padRequestToSequenceLength(*requestProto, bucket.inputsInfo, attentionMaskInput, requestLength, bucketLength, paddedRequest)) {
+        return StatusCode::OK;
+    }
+    size_t requestBatchSize = 0;
+    auto status = validateForDynamicBatching(&paddedRequest, sequenceBucket.inputsMetadata, bucket.outputsInfo, getBatchSize(), requestBatchSize);
+    if (!status.ok()) {
+        routed = true;
+        return status;
+    }
+    if (!sequenceBucket.batcher && requestBatchSize != getBatchSize()) {
+        return StatusCode::OK;
+    }
+    routed = true;
+    SPDLOG_DEBUG("Padding request for model {}, version {} with sequence length: {} to sequence length bucket: {}",
+        requestProto->model_spec().name(), getVersion(), requestLength, bucketLength);
+    if (sequenceBucket.batcher) {
+        status = sequenceBucket.batcher->infer(&paddedRequest, responseProto, requestBatchSize);
+    } else {
+        status = inferWithQueue(&paddedRequest, responseProto, *bucket.inferRequestsQueue, bucket.inputsInfo, bucket.outputsInfo, context);
+    }
+    if (!status.ok()) {
+        return status;
+    }
+    trimResponseToSequenceLength(*responseProto, sequenceOutputs, requestLength, bucketLength);
+    return StatusCode::OK;
+}
+
+Status ModelInstance::getShapeBucket(const std::map<std::string, shape_t>& requestShapes,
+    std::shared_ptr<ShapeBucket>& bucket,
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr) {
+    bucket = shapeBucketCache->find(requestShapes);
+    if (bucket) {
+        return StatusCode::OK;
+    }
+    // compilation reshapes CNNNetwork shared with model reloads, unload guard is released
+    // while waiting for loading mutex so that reload in progress is not blocked
+    modelUnloadGuardPtr.reset();
+    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    modelUnloadGuardPtr = std::make_unique<ModelInstanceUnloadGuard>(*this);
+    if (getStatus().getState() != ModelVersionState::AVAILABLE || !shapeBucketCache) {
+        return StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE;
+    }
+    // other request could compile the same shapes in the meantime
+    bucket = shapeBucketCache->find(requestShapes);
+    if (bucket) {
+        return StatusCode::OK;
+    }
+    Timer<TIMER_END> timer;
+    timer.start(COMPILE);
+    auto status = compileShapeBucket(requestShapes, bucket);
+    timer.stop(COMPILE);
+    if (!status.ok()) {
+        return status;
+    }
+    SPDLOG_INFO("Compiled executable network for new shape of model: {}; version: {}; duration: {:.3f} ms",
+        getName(), getVersion(), timer.elapsed<std::chrono::microseconds>(COMPILE) / 1000);
+    shapeBucketCache->insert(bucket);
+    return StatusCode::OK;
+}
+
+Status ModelInstance::compileShapeBucket(const std::map<std::string, shape_t>& requestShapes, std::shared_ptr<ShapeBucket>& bucket) {
+    return compileShapeBucket(requestShapes, bucket, prepareDefaultPluginConfig(config), getNumOfParallelInferRequests(config));
+}
+
+Status ModelInstance::compileShapeBucket(const std::map<std::string, shape_t>& requestShapes, std::shared_ptr<ShapeBucket>& bucket,
+    const plugin_config_t& bucketPluginConfig, uint32_t nireq) {
+    auto newBucket = std::make_shared<ShapeBucket>();
+    newBucket->shapes = requestShapes;
+    const auto networkShapes = network->getInputShapes();
+    auto bucketNetworkShapes = networkShapes;
+    for (const auto& [name, tensorInfo] : getInputsInfo()) {
+        auto it = requestShapes.find(name);
+        if (it == requestShapes.end()) {
+            return StatusCode::INVALID_MISSING_INPUT;
+        }
+        bucketNetworkShapes[tensorInfo->getName()] = it->second;
+        newBucket->inputsInfo[name] = tensorInfo->createCopyWithNewShape(it->second);
+    }
+
+    Status status = StatusCode::OK;
+    try {
+        network->reshape(bucketNetworkShapes);
+        auto networkOutputs = network->getOutputsInfo();
+        for (const auto& [name, tensorInfo] : getOutputsInfo()) {
+            newBucket->outputsInfo[name] = tensorInfo->createCopyWithNewShape(networkOutputs.at(tensorInfo->getName())->getDims());
+        }
+    } catch (const std::exception& e) {
+        status = StatusCode::RESHAPE_ERROR;
+        SPDLOG_WARN("OV does not support reshaping model: {} with provided shape", getName());
+        SPDLOG_DEBUG("Description: {}", e.what());
+    }
+    if (status.ok()) {
+        try {
+            // buckets of balanced model are compiled only on its first device
+            auto balancedDevices = config.getBalancedDevices();
+            auto pluginConfig = bucketPluginConfig;
+            if (!balancedDevices.empty()) {
+                pluginConfig = getDevicePluginConfig(balancedDevices.front(), pluginConfig);
+            }
+            const auto& device = balancedDevices.empty() ? targetDevice : balancedDevices.front();
+            CompilationPool::instance().run([this, &newBucket, &device, &pluginConfig]() {
+                newBucket->execNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, device, pluginConfig));
+            });
+        } catch (const std::exception& e) {
+            status = StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE;
+            SPDLOG_ERROR("{}; error: {}; model: {}; version: {}; device: {}",
+                status.string(), e.what(), getName(), getVersion(), targetDevice);
+        }
+    }
+    // model reloads start from shapes of the default executable network
+    try {
+        network->reshape(networkShapes);
+    } catch (const std::exception& e) {
+        SPDLOG_ERROR("Failed to restore network shapes of model: {}; version: {}; error: {}", getName(), getVersion(), e.what());
+    }
+    if (!status.ok()) {
+        return status;
+    }
+    newBucket->inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*newBucket->execNetwork, nireq,
+        config.getMaxQueueDepth(), config.getMaxQueueWaitMs(), config.getPipelineReservedNireq());
+    trackUtilization(*newBucket->inferRequestsQueue);
+    bucket = std::move(newBucket);
+    return StatusCode::OK;
+}
+
+void ModelInstance::configureBatchSize(const ModelConfig& config, const DynamicModelParameter& parameter) {
+    if (parameter.isBatchSizeRequested()) {
+        network->setBatchSize(parameter.getBatchSize());
+    } else if (config.getBatchSize() > 0) {
+        network->setBatchSize(config.getBatchSize());
+    }
+}
+
+/**
+ * @brief Measures consecutive phases of model version load
+ *
+ * Each phase is observed in load time metric and added to startup profile when it ends,
+ * summary of all phases is reported in version status.
+ */
+class LoadPhasesTimer {
+    using clock_t = StartupProfiler::clock_t;
+
+    const std::string& modelName;
+    const model_version_t version;
+    const clock_t::time_point loadStart = clock_t::now();
+    const char* currentPhase = nullptr;
+    clock_t::time_point phaseStart;
+    std::vector<std::pair<const char*, uint64_t>> phaseTimesUs;
+
+    void record(const char* phase, uint64_t timeUs) {
+        phaseTimesUs.emplace_back(phase, timeUs);
+        getModelLoadTimeHistogram(MetricRegistry::getInstance(), modelName, version, phase).observe(timeUs);
+    }
+
+    void addProfileEvent(const char* name, clock_t::time_point start, clock_t::time_point end) {
+        StartupProfiler::instance().addEvent(name, "model_load", start, end, {{"model", modelName}, {"version", std::to_string(version)}});
+    }
+
+public:
+    LoadPhasesTimer(const std::string& modelName, model_version_t version, uint64_t downloadTimeUs) :
+        modelName(modelName),
+        version(version) {
+        // download is done once for all versions of the model before their loads start
+        if (downloadTimeUs > 0) {
+            record("download", downloadTimeUs);
+        }
+    }
+
+    void start(const char* phase) {
+        currentPhase = phase;
+        phaseStart = clock_t::now();
+    }
+
+    void stop() {
+        const auto phaseEnd = clock_t::now();
+        record(currentPhase, std::chrono::duration_cast<std::chrono::microseconds>(phaseEnd - phaseStart).count());
+        addProfileEvent(currentPhase, phaseStart, phaseEnd);
+    }
+
+    /**
+     * @brief Records whole load and returns summary of phases, e.g. "read_network 35.1 ms, compile 420.7 ms, total 460.2 ms"
+     */
+    std::string finish() {
+        const auto loadEnd = clock_t::now();
+        addProfileEvent("load", loadStart, loadEnd);
+        uint64_t totalUs = std::chrono::duration_cast<std::chrono::microseconds>(loadEnd - loadStart).count();
+        if (!phaseTimesUs.empty() && std::string(phaseTimesUs.front().first) == "download") {
+            totalUs += phaseTimesUs.front().second;
+        }
+        record("total", totalUs);
+        std::stringstream summary;
+        summary << std::fixed << std::setprecision(1);
+        for (size_t i = 0; i < phaseTimesUs.size(); ++i) {
+            summary << (i ? ", " : "") << phaseTimesUs[i].first << " " << phaseTimesUs[i].second / 1000.0 << " ms";
+        }
+        return summary.str();
+    }
+};
+
+Status ModelInstance::loadModelImpl(const ModelConfig& config, const DynamicModelParameter& parameter) {
+    LoadPhasesTimer loadTimer(getName(), getVersion(), config.getDownloadTimeUs());
+    subscriptionManager.notifySubscribers();
+    this->path = config.getPath();
+    this->targetDevice = config.getTargetDevice();
+    this->config = config;
+    if (const auto* inMemoryFiles = config.getInMemoryFiles()) {
+        // files of other versions are not kept alive by this one
+        this->config.setInMemoryFiles(std::make_shared<const std::map<model_version_t, model_files_contents_t>>(
+            std::map<model_version_t, model_files_contents_t>{{config.getVersion(), *inMemoryFiles}}));
+    }
+    auto status = fetchModelFilepaths();
+
+    if (!status.ok()) {
+        this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+        return status;
+    }
+    this->memoryFootprint = estimateMemoryFootprint();
+    const auto mappedBeforeLoad = config.isLockMemoryEnabled() ? getMappedMemory() : std::vector<MemoryRange>();
+    try {
+        if (!this->engine)
+            loadOVEngine();
+        loadTimer.start("read_network");
+        if (!this->network) {
+            if (this->config.isCustomLoaderRequiredToLoadModel()) {
+                // loading the model using the custom loader
+                status = loadOVCNNNetworkUsingCustomLoader();
+            } else if (const auto* inMemoryFiles = this->config.getInMemoryFiles()) {
+                status = loadOVCNNNetworkFromMemory(*inMemoryFiles);
+            } else {
+                status = loadOVCNNNetwork();
+            }
+        }
+        loadTimer.stop();
+
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+
+        loadTimer.start("reshape");
+        configureBatchSize(this->config, parameter);
+        status = loadInputTensors(this->config, parameter);
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+        status = loadOutputTensors(this->config);
+        inputsMetadata = TensorMetadataTable(inputsInfo, &this->config);
+        loadTimer.stop();
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+        loadTimer.start("compile");
+        status = loadOVExecutableNetwork(this->config);
+        loadTimer.stop();
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+        loadTimer.start("create_infer_requests");
+        status = prepareInferenceRequestsQueue(this->config);
+        loadTimer.stop();
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+        prepareDynamicBatcher(this->config);
+        prepareBatchSplitter(this->config);
+        prepareShapeBucketCache(this->config);
+        prepareResponseCache(this->config);
+        prepareRequestCoalescer(this->config);
+        prepareLayerProfiler(this->config);
+        FairShareScheduler::instance().configureTenant(schedulingTenant, this->config.getSchedulingWeight(), this->config.getMaxConcurrentInferences());
+        status = prepareBatchSizeVariants(this->config, parameter);
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+        status = prepareSequenceLengthBuckets(this->config);
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+        status = prepareLatencyProfile(this->config, parameter);
+        if (!status.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+        loadTimer.start("warmup");
+        auto warmupStatus = warmupModel(this->config);
+        loadTimer.stop();
+        if (!warmupStatus.ok()) {
+            SPDLOG_WARN("Warmup of model: {}; version: {} failed: {}. Model will be served without warmup",
+                getName(), getVersion(), warmupStatus.string());
+        }
+        // after warmup, so that lazily allocated memory of the network is locked as well
+        if (this->config.isLockMemoryEnabled()) {
+            loadTimer.start("lock_memory");
+            lockMemory(this->config, mappedBeforeLoad);
+            loadTimer.stop();
+        } else {
+            modelMemoryLock.reset();
+            inferRequestsMemoryLock.reset();
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_ERROR("exception occurred while loading network: {}", e.what());
+        this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+        return StatusCode::NETWORK_NOT_LOADED;
+    }
+    this->status.setLoadTimes(loadTimer.finish());
+    SPDLOG_INFO("Model: {}; version: {} load time: {}", getName(), getVersion(), this->status.getLoadTimes());
+    this->status.setAvailable();
+    notifyLoadingWaiters();
+    return status;
+}
+
+Status ModelInstance::loadModel(const ModelConfig& config) {
+    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    if (config.isLazyLoadingEnabled()) {
+        return deferLoading(config);
+    }
+    loadedOnDemand = false;
+    SPDLOG_INFO("Loading model: {}, version: {}, from path: {}, with target device: {} ...",
+        config.getName(), config.getVersion(), config.getPath(), config.getTargetDevice());
+    if (config.getBatchingMode() == AUTO) {
+        SPDLOG_INFO("Batch size mode for model {} is set to auto", config.getName());
+    } else if (config.anyShapeSetToAuto()) {
+        SPDLOG_INFO("Some inputs shapes for model {} are set to auto", config.getName());
+    }
+    this->status = ModelVersionStatus(config.getName(), config.getVersion());
+    this->status.setLoading();
+    return loadModelImpl(config);
+}
+
+Status ModelInstance::reloadModel(const ModelConfig& config, const DynamicModelParameter& parameter) {
+    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    if (config.isLazyLoadingEnabled() &&
+        (this->status.getState() == ModelVersionState::START || this->status.willEndUnloaded() || this->status.isFailedLoading())) {
+        // version is not in use, it is compiled with new config on next request
+        return deferLoading(config);
+    }
+    loadedOnDemand = config.isLazyLoadingEnabled();
+    this->status.setLoading();
+    if (!canUnloadInstance()) {
+        SPDLOG_INFO("Waiting to reload model: {} version: {}. Blocked by: {} inferences in progress.",
+            getName(), getVersion(), predictRequestsHandlesCount);
+        waitForPredictRequestsToFinish();
+    }
+    if ((this->config.isCustomLoaderRequiredToLoadModel()) && (isCustomLoaderConfigChanged)) {
+        // unloading and the loading back the model
+        isCustomLoaderConfigChanged = false;
+        retireModel(isCustomLoaderConfigChanged);
+    }
+    return loadModelImpl(config, parameter);
+}
+
+Status ModelInstance::reloadInferRequestsQueue(const ModelConfig& config) {
+    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    SPDLOG_INFO("Recreating infer requests of model: {}; version: {} without recompiling the network", getName(), getVersion());
+    this->status.setLoading();
+    if (!canUnloadInstance()) {
+        SPDLOG_INFO("Waiting to recreate infer requests of model: {} version: {}. Blocked by: {} inferences in progress.",
+            getName(), getVersion(), predictRequestsHandlesCount);
+        waitForPredictRequestsToFinish();
+    }
+    // batcher and splitter keep reference to the old queue
+    batchSplitter.reset();
+    dynamicBatcher.reset();
+    inferRequestsMemoryLock.reset();
+    this->config = config;
+    auto status = prepareInferenceRequestsQueue(this->config);
+    if (!status.ok()) {
+        this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+        return status;
+    }
+    prepareDynamicBatcher(this->config);
+    prepareBatchSplitter(this->config);
+    lockInferRequestsMemory(this->config);
+    this->status.setAvailable();
+    notifyLoadingWaiters();
+    return StatusCode::OK;
+}
+
+Status ModelInstance::recoverFromReloadingError(const Status& status) {
+    SPDLOG_WARN("Failed to perform complete reload with requested dynamic parameter. Model: {} version: {} with error: {}. Reloading to previous configuration",
+        getName(), getVersion(), status.string());
+    bool changeStatus{false};
+    retireModel(changeStatus);
+
+    auto recoveryStatus = reloadModel(config);
+    if (!recoveryStatus.ok()) {
+        SPDLOG_WARN("Failed to recover model: {} version: {} to previous configuration with error: {}",
+            getName(), getVersion(), recoveryStatus.string());
+    }
+    return status;
 }
 
 Status ModelInstance::reshapeWithFullReload(const Status& status, const DynamicModelParameter& parameter) {
@@ -642,23 +2105,16 @@ Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMillisec
     }
     modelInstanceUnloadGuard.reset();
 
-    // wait several time since no guarantee that cv wakeup will be triggered before calling wait_for
-    const uint waitLoadedTimestepMilliseconds = 100;
-    const uint waitCheckpoints = waitForModelLoadedTimeoutMilliseconds / waitLoadedTimestepMilliseconds;
-    uint waitCheckpointsCounter = waitCheckpoints;
-    SPDLOG_DEBUG("Waiting for loaded state for model: {} version: {} with timestep: {} timeout: {} check count: {}", getName(), getVersion(),
-        waitLoadedTimestepMilliseconds, waitForModelLoadedTimeoutMilliseconds, waitCheckpointsCounter);
-    std::mutex cv_mtx;
-    std::unique_lock<std::mutex> cv_lock(cv_mtx);
-    while (waitCheckpointsCounter-- > 0) {
-        if (modelLoadedNotify.wait_for(cv_lock,
-                std::chrono::milliseconds(waitLoadedTimestepMilliseconds),
-                [this]() {
-                    return this->getStatus().getState() > ModelVersionState::LOADING;
-                })) {
-            SPDLOG_INFO("Waiting for model: {} version: {} loaded state for: {} time",
-                getName(), getVersion(), waitCheckpoints - waitCheckpointsCounter);
-        }
+    SPDLOG_DEBUG("Waiting for loaded state for model: {} version: {} with timeout: {}", getName(), getVersion(),
+        waitForModelLoadedTimeoutMilliseconds);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitForModelLoadedTimeoutMilliseconds);
+    std::unique_lock<std::mutex> cv_lock(modelLoadedNotifyMtx);
+    // state may go back to loading after being woken up, e.g. when reload started right after loading
+    while (modelLoadedNotify.wait_until(cv_lock, deadline,
+        [this]() {
+            return this->getStatus().getState() > ModelVersionState::LOADING;
+        })) {
+        cv_lock.unlock();
         modelInstanceUnloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*this);
         if (getStatus().getState() == ModelVersionState::AVAILABLE) {
             SPDLOG_INFO("Succesfully waited for model: {}, version: {}", getName(), getVersion());
@@ -669,6 +2125,7 @@ Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMillisec
             SPDLOG_INFO("Stopped waiting for model: {} version: {} since it is unloading.", getName(), getVersion());
             return StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE;
         }
+        cv_lock.lock();
     }
     SPDLOG_INFO("Waiting for loaded state reached timeout for model: {} version: {}",
         getName(), getVersion());
@@ -681,19 +2138,145 @@ Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMillisec
     }
 }
 
+void ModelInstance::notifyLoadingWaiters() {
+    std::lock_guard<std::mutex> lock(modelLoadedNotifyMtx);
+    modelLoadedNotify.notify_all();
+}
+
+void ModelInstance::waitForPredictRequestsToFinish() {
+    ++unloadWaitersCount;
+    std::unique_lock<std::mutex> lock(unloadNotifyMtx);
+    while (!canUnloadInstance()) {
+        SPDLOG_DEBUG("Waiting to unload model: {} version: {}. Blocked by: {} inferences in progress.",
+            getName(), getVersion(), predictRequestsHandlesCount);
+        // woken up by the last released unload guard, timeout only guards against missed notifications
+        unloadNotify.wait_for(lock, std::chrono::milliseconds(UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS));
+    }
+    --unloadWaitersCount;
+}
+
+void ModelInstance::decreasePredictRequestsHandlesCount() {
+    if (--predictRequestsHandlesCount == 0 && unloadWaitersCount > 0) {
+        std::lock_guard<std::mutex> lock(unloadNotifyMtx);
+        unloadNotify.notify_all();
+    }
+}
+
 void ModelInstance::retireModel(bool isPermanent) {
     std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
     if (isPermanent) {
         this->status.setUnloading();
+        notifyLoadingWaiters();
     } else {
         this->status.setLoading();
     }
     unloadModelComponents();
     if (isPermanent) {
+        this->config.setInMemoryFiles(nullptr);
         status.setEnd();
     }
 }
 
+Status ModelInstance::deferLoading(const ModelConfig& config) {
+    SPDLOG_INFO("Model: {}, version: {} will be loaded on first request", config.getName(), config.getVersion());
+    this->path = config.getPath();
+    this->targetDevice = config.getTargetDevice();
+    this->config = config;
+    loadedOnDemand = true;
+    this->status = ModelVersionStatus(config.getName(), config.getVersion());
+    return StatusCode::OK;
+}
+
+Status ModelInstance::loadModelOnDemand() {
+    if (this->status.getState() == ModelVersionState::AVAILABLE) {
+        return StatusCode::OK;
+    }
+    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    if (this->status.getState() != ModelVersionState::START) {
+        // loaded by concurrent request in the meantime or retired, waitForLoaded reports the state
+        return StatusCode::OK;
+    }
+    SPDLOG_INFO("Loading model: {}, version: {} on demand", getName(), getVersion());
+    this->status.setLoading();
+    const ModelConfig config = this->config;
+    auto status = loadModelImpl(config);
+    if (!status.ok()) {
+        SPDLOG_ERROR("Loading model: {}, version: {} on demand failed: {}", getName(), getVersion(), status.string());
+    }
+    return status;
+}
+
+bool ModelInstance::evict() {
+    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    if (!isLoadedOnDemand() || this->status.getState() != ModelVersionState::AVAILABLE) {
+        return false;
+    }
+    SPDLOG_INFO("Unloading idle model: {}, version: {} to fit models memory budget", getName(), getVersion());
+    this->status.setUnloading();
+    notifyLoadingWaiters();
+    unloadModelComponents();
+    this->status = ModelVersionStatus(getName(), getVersion());
+    return true;
+}
+
+ModelMemoryUsage ModelInstance::getMemoryUsage() {
+    std::unique_lock<std::recursive_mutex> loadingLock(loadingMutex, std::try_to_lock);
+    std::lock_guard<std::mutex> usageLock(memoryUsageMutex);
+    if (!loadingLock.owns_lock()) {
+        return lastMemoryUsage;
+    }
+    ModelMemoryUsage usage;
+    usage.modelFiles = memoryFootprint;
+    usage.inferRequests = inferRequestsQueue ? inferRequestsQueue->getMemoryBytes() : 0;
+    usage.sequenceStates = getSequenceStatesMemoryBytes();
+    usage.locked = (modelMemoryLock ? modelMemoryLock->getLockedBytes() : 0) +
+                   (inferRequestsMemoryLock ? inferRequestsMemoryLock->getLockedBytes() : 0);
+    lastMemoryUsage = usage;
+    return usage;
+}
+
+void ModelInstance::updateMemoryMetrics() {
+    const auto usage = getMemoryUsage();
+    set(metrics.modelFilesMemory, usage.modelFiles);
+    set(metrics.inferRequestsMemory, usage.inferRequests);
+    set(metrics.sequenceStatesMemory, usage.sequenceStates);
+    set(metrics.lockedMemory, usage.locked);
+}
+
+Saturation ModelInstance::getSaturation() const {
+    // gauge counts infer requests of all queues of the version
+    int64_t inferRequests = metrics.inferRequests ? metrics.inferRequests->get() : 0;
+    if (inferRequests <= 0 && inferRequestsQueue) {
+        inferRequests = inferRequestsQueue->getActiveStreamsCount();
+    }
+    return saturation.getSaturation(inferRequests);
+}
+
+void ModelInstance::updateSaturationMetrics() {
+    const auto current = getSaturation();
+    set(metrics.busyPercent, std::lround(current.busyFraction * 100));
+    set(metrics.queueWaitP95, static_cast<int64_t>(current.queueWaitP95Us));
+    set(metrics.headroom, std::lround(current.headroom));
+}
+
+uint64_t ModelInstance::estimateMemoryFootprint() const {
+    uint64_t footprint = 0;
+    if (const auto* inMemoryFiles = config.getInMemoryFiles()) {
+        for (const auto& name : modelFiles) {
+            footprint += inMemoryFiles->at(name)->size();
+        }
+        return footprint;
+    }
+    for (const auto& file : modelFiles) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(file, ec);
+        if (!ec) {
+            footprint += size;
+        }
+    }
+    return footprint;
+}
+
 void ModelInstance::cleanupFailedLoad() {
     std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
     this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
@@ -702,18 +2285,38 @@ void ModelInstance::cleanupFailedLoad() {
 
 void ModelInstance::unloadModelComponents() {
     subscriptionManager.notifySubscribers();
-    while (!canUnloadInstance()) {
-        SPDLOG_DEBUG("Waiting to unload model: {} version: {}. Blocked by: {} inferences in progres.",
-            getName(), getVersion(), predictRequestsHandlesCount);
-        std::this_thread::sleep_for(std::chrono::milliseconds(UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS));
+    waitForPredictRequestsToFinish();
+    dynamicBatcher.reset();
+    batchSplitter.reset();
+    shapeCachePrewarmWorker.reset();
+    shapeBucketCache.reset();
+    if (responseCache) {
+        SPDLOG_INFO("Response cache of model {}; version: {} served {} hits and {} misses",
+            getName(), getVersion(), responseCache->getHits(), responseCache->getMisses());
+        responseCache.reset();
     }
+    auto coalescer = std::atomic_exchange(&requestCoalescer, std::shared_ptr<RequestCoalescer>());
+    if (coalescer) {
+        SPDLOG_INFO("Request coalescing of model {}; version: {} served {} requests with outputs of concurrent identical requests",
+            getName(), getVersion(), coalescer->getCoalesced());
+    }
+    std::atomic_store(&layerProfiler, std::shared_ptr<LayerProfiler>());
+    batchSizeVariants.clear();
+    sequenceLengthBuckets.clear();
+    sequenceOutputs.clear();
+    latencyProfile.reset();
+    inferRequestsMemoryLock.reset();
+    modelMemoryLock.reset();
     inferRequestsQueue.reset();
     execNetwork.reset();
+    balancedExecNetworks.clear();
     network.reset();
     engine.reset();
     outputsInfo.clear();
     inputsInfo.clear();
+    inputsMetadata = TensorMetadataTable();
     modelFiles.clear();
+    memoryFootprint = 0;
 
     if (this->config.isCustomLoaderRequiredToLoadModel()) {
         custom_loader_options_config_t customLoaderOptionsConfig = this->config.getCustomLoaderOptionsConfigMap();
@@ -751,12 +2354,12 @@ const Status ModelInstance::validateNumberOfInputs(const tensorflow::serving::Pr
     return StatusCode::OK;
 }
 
-const Status ModelInstance::validatePrecision(const ovms::TensorInfo& networkInput,
+const Status ModelInstance::validatePrecision(const TensorMetadata& networkInput,
     const tensorflow::TensorProto& requestInput) {
-    // Network and request must have the same precision
-    if (requestInput.dtype() != networkInput.getPrecisionAsDataType()) {
+    // Network and request must have the same precision unless request precision is converted
+    if (!networkInput.acceptsDataType(requestInput.dtype())) {
         std::stringstream ss;
-        ss << "Expected: " << networkInput.getPrecisionAsString()
+        ss << "Expected: " << networkInput.info->getPrecisionAsString()
            << "; Actual: " << TensorInfo::getDataTypeAsString(requestInput.dtype());
         const std::string details = ss.str();
         SPDLOG_DEBUG("[Model: {} version: {}] Invalid precision - {}", getName(), getVersion(), details);
@@ -765,14 +2368,13 @@ const Status ModelInstance::validatePrecision(const ovms::TensorInfo& networkInp
     return StatusCode::OK;
 }
 
-const Status ModelInstance::validateNumberOfShapeDimensions(const ovms::TensorInfo& networkInput,
+const Status ModelInstance::validateNumberOfShapeDimensions(const TensorMetadata& networkInput,
     const tensorflow::TensorProto& requestInput) {
     // Network and request must have the same number of shape dimensions, higher than 0
-    auto& shape = networkInput.getEffectiveShape();
     if (requestInput.tensor_shape().dim_size() <= 0 ||
-        shape.size() != static_cast<size_t>(requestInput.tensor_shape().dim_size())) {
+        networkInput.rank != static_cast<size_t>(requestInput.tensor_shape().dim_size())) {
         std::stringstream ss;
-        ss << "Expected: " << TensorInfo::shapeToString(shape)
+        ss << "Expected: " << TensorInfo::shapeToString(networkInput.info->getEffectiveShape())
            << "; Actual: " << TensorInfo::tensorShapeToString(requestInput.tensor_shape());
         const std::string details = ss.str();
         SPDLOG_DEBUG("[Model: {} version: {}] Invalid number of shape dimensions - {}", getName(), getVersion(), details);
@@ -788,22 +2390,24 @@ const bool ModelInstance::checkBatchSizeMismatch(const ovms::TensorInfo& network
     return false;
 }
 
-const bool ModelInstance::checkShapeMismatch(const ovms::TensorInfo& networkInput,
+const bool ModelInstance::checkShapeMismatch(const TensorMetadata& networkInput,
     const tensorflow::TensorProto& requestInput,
     const Mode& batchingMode) {
     // Network and request must have the same shape
-    auto& shape = networkInput.getEffectiveShape();
     int i = (batchingMode == AUTO) ? 1 : 0;  // If batch size is automatic, omit first dimension
     for (; i < requestInput.tensor_shape().dim_size(); i++) {
+        if (requestInput.tensor_shape().dim(i).size() > 0 && networkInput.isResizedDimension(i)) {
+            continue;
+        }
         if (requestInput.tensor_shape().dim(i).size() < 0 ||
-            shape[i] != static_cast<size_t>(requestInput.tensor_shape().dim(i).size())) {
+            networkInput.getDimension(i) != static_cast<size_t>(requestInput.tensor_shape().dim(i).size())) {
             return true;
         }
     }
     return false;
 }
 
-const Status ModelInstance::validateTensorContentSize(const ovms::TensorInfo& networkInput,
+const Status ModelInstance::validateTensorContentSize(const TensorMetadata& networkInput,
     const tensorflow::TensorProto& requestInput) {
     /*
     int8        data in request.tensor_content
@@ -814,7 +2418,7 @@ const Status ModelInstance::validateTensorContentSize(const ovms::TensorInfo& ne
     uint32      data in request.tensor_content
     int64       data in request.tensor_content
     uint64      data in request.tensor_content
-    float16     request.tensor_content is empty, data located in request.half_val
+    float16     data in request.half_val or raw values in request.tensor_content
     float32     data in request.tensor_content
     double      data in request.tensor_content
 
@@ -827,6 +2431,13 @@ const Status ModelInstance::validateTensorContentSize(const ovms::TensorInfo& ne
         expectedValueCount *= requestInput.tensor_shape().dim(i).size();
     }
 
+    if (isSparseTensor(requestInput)) {
+        return validateSparseInput(*networkInput.info, requestInput);
+    }
+    if (isSharedMemoryReference(requestInput)) {
+        return validateSharedMemoryInput(*networkInput.info, requestInput, expectedValueCount);
+    }
+
     // Network expects tensor content size or value count
     if (requestInput.dtype() == tensorflow::DataType::DT_UINT16) {
         if (requestInput.int_val_size() < 0 ||
@@ -837,7 +2448,7 @@ const Status ModelInstance::validateTensorContentSize(const ovms::TensorInfo& ne
             SPDLOG_DEBUG("[Model: {} version: {}] Invalid number of values in tensor proto container - {}", getName(), getVersion(), details);
             return Status(StatusCode::INVALID_VALUE_COUNT, details);
         }
-    } else if (requestInput.dtype() == tensorflow::DataType::DT_HALF) {
+    } else if (requestInput.dtype() == tensorflow::DataType::DT_HALF && requestInput.tensor_content().size() == 0) {
         if (requestInput.half_val_size() < 0 ||
             expectedValueCount != static_cast<size_t>(requestInput.half_val_size())) {
             std::stringstream ss;
@@ -846,53 +2457,162 @@ const Status ModelInstance::validateTensorContentSize(const ovms::TensorInfo& ne
             SPDLOG_DEBUG("[Model: {} version: {}] Invalid number of values in tensor proto container - {}", getName(), getVersion(), details);
             return Status(StatusCode::INVALID_VALUE_COUNT, details);
         }
-    } else {
-        size_t expectedContentSize = expectedValueCount * networkInput.getPrecision().size();
-        if (expectedContentSize != requestInput.tensor_content().size()) {
+    } else {
+        size_t expectedContentSize = expectedValueCount * networkInput.getElementSize(requestInput.dtype());
+        if (expectedContentSize != requestInput.tensor_content().size()) {
+            std::stringstream ss;
+            ss << "Expected: " << expectedContentSize << " bytes; Actual: " << requestInput.tensor_content().size() << " bytes";
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("[Model: {} version: {}] Invalid content size of tensor proto - {}", getName(), getVersion(), details);
+            return Status(StatusCode::INVALID_CONTENT_SIZE, details);
+        }
+    }
+    return StatusCode::OK;
+}
+
+const bool ModelInstance::checkBinaryInputBatchSizeMismatch(const ovms::TensorInfo& networkInput,
+    const tensorflow::TensorProto& requestInput) {
+    if (requestInput.string_val_size() < 0) {
+        return true;
+    }
+    if (getBatchSize() != static_cast<size_t>(requestInput.string_val_size())) {
+        return true;
+    }
+    return false;
+}
+
+const Status ModelInstance::validateNumberOfBinaryInputShapeDimensions(const tensorflow::TensorProto& requestInput) {
+    if (requestInput.tensor_shape().dim_size() != 1) {
+        std::stringstream ss;
+        ss << "Expected number of binary input shape dimensions: 1; Actual: " << requestInput.tensor_shape().dim_size();
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Model: {} version: {}] Invalid number of shape dimensions - {}", getName(), getVersion(), details);
+        return Status(StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS, details);
+    }
+    return StatusCode::OK;
+}
+
+const Status ModelInstance::validatePlanarYuvInput(const ovms::TensorInfo& networkInput,
+    const tensorflow::TensorProto& requestInput, Status& finalStatus) {
+    if (requestInput.dtype() != tensorflow::DataType::DT_UINT8) {
+        std::stringstream ss;
+        ss << "Expected: U8; Actual: " << TensorInfo::getDataTypeAsString(requestInput.dtype());
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Model: {} version: {}] Invalid precision of planar YUV input - {}", getName(), getVersion(), details);
+        return Status(StatusCode::INVALID_PRECISION, details);
+    }
+    const auto& requestShape = requestInput.tensor_shape();
+    if (requestShape.dim_size() != 4) {
+        std::stringstream ss;
+        ss << "Expected: [N, H*3/2, W, 1]; Actual: " << TensorInfo::tensorShapeToString(requestShape);
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Model: {} version: {}] Invalid number of shape dimensions of planar YUV input - {}", getName(), getVersion(), details);
+        return Status(StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS, details);
+    }
+    const size_t batch = requestShape.dim(0).size();
+    const size_t planesHeight = requestShape.dim(1).size();
+    const size_t width = requestShape.dim(2).size();
+    const size_t height = planesHeight / 3 * 2;
+    // dimensions of tensor descriptor are always in NCHW order
+    const auto& dims = networkInput.getTensorDesc().getDims();
+    const bool isResolutionValid = networkInput.isResizedByPreprocessing() || (height == dims[2] && width == dims[3]);
+    if (requestShape.dim(3).size() != 1 || planesHeight % 3 != 0 || height % 2 != 0 || width % 2 != 0 ||
+        height == 0 || width == 0 || !isResolutionValid) {
+        std::stringstream ss;
+        ss << "Expected: [N, H*3/2, W, 1] with even H and W";
+        if (!networkInput.isResizedByPreprocessing()) {
+            ss << ", H: " << dims[2] << ", W: " << dims[3];
+        }
+        ss << "; Actual: " << TensorInfo::tensorShapeToString(requestShape);
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Model: {} version: {}] Invalid shape of planar YUV input - {}", getName(), getVersion(), details);
+        return Status(StatusCode::INVALID_SHAPE, details);
+    }
+    if (batch != getBatchSize()) {
+        if (getModelConfig().getBatchingMode() == AUTO) {
+            finalStatus = StatusCode::BATCHSIZE_CHANGE_REQUIRED;
+        } else {
             std::stringstream ss;
-            ss << "Expected: " << expectedContentSize << " bytes; Actual: " << requestInput.tensor_content().size() << " bytes";
+            ss << "Expected: " << getBatchSize() << "; Actual: " << batch;
             const std::string details = ss.str();
-            SPDLOG_DEBUG("[Model: {} version: {}] Invalid content size of tensor proto - {}", getName(), getVersion(), details);
-            return Status(StatusCode::INVALID_CONTENT_SIZE, details);
+            SPDLOG_DEBUG("[Model: {} version: {}] Invalid batch size - {}", getName(), getVersion(), details);
+            return Status(StatusCode::INVALID_BATCH_SIZE, details);
         }
     }
+    const size_t expectedContentSize = batch * planesHeight * width;
+    if (isSharedMemoryReference(requestInput)) {
+        return validateSharedMemoryInput(networkInput, requestInput, expectedContentSize);
+    }
+    if (expectedContentSize != requestInput.tensor_content().size()) {
+        std::stringstream ss;
+        ss << "Expected: " << expectedContentSize << " bytes; Actual: " << requestInput.tensor_content().size() << " bytes";
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Model: {} version: {}] Invalid content size of tensor proto - {}", getName(), getVersion(), details);
+        return Status(StatusCode::INVALID_CONTENT_SIZE, details);
+    }
     return StatusCode::OK;
 }
 
-const bool ModelInstance::checkBinaryInputBatchSizeMismatch(const ovms::TensorInfo& networkInput,
-    const tensorflow::TensorProto& requestInput) {
-    if (requestInput.string_val_size() < 0) {
-        return true;
-    }
-    if (getBatchSize() != static_cast<size_t>(requestInput.string_val_size())) {
-        return true;
+const Status ModelInstance::validate(const tensorflow::serving::PredictRequest* request) {
+    return validateInputs(request, nullptr);
+}
+
+const Status ModelInstance::validateAndDeserialize(const tensorflow::serving::PredictRequest* request, input_blobs_t& inputBlobs) {
+    inputBlobs.clear();
+    inputBlobs.reserve(getInputsMetadata().size());
+    auto status = validateInputs(request, &inputBlobs);
+    if (!status.ok()) {
+        inputBlobs.clear();
     }
-    return false;
+    return status;
 }
 
-const Status ModelInstance::validateNumberOfBinaryInputShapeDimensions(const tensorflow::TensorProto& requestInput) {
-    if (requestInput.tensor_shape().dim_size() != 1) {
-        std::stringstream ss;
-        ss << "Expected number of binary input shape dimensions: 1; Actual: " << requestInput.tensor_shape().dim_size();
-        const std::string details = ss.str();
-        SPDLOG_DEBUG("[Model: {} version: {}] Invalid number of shape dimensions - {}", getName(), getVersion(), details);
-        return Status(StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS, details);
+Status ModelInstance::deserializeValidatedInput(const std::shared_ptr<TensorInfo>& networkInput,
+    const tensorflow::TensorProto& requestInput,
+    input_blobs_t& inputBlobs) {
+    const bool isPipeline = false;
+    InferenceEngine::Blob::Ptr blob;
+    try {
+        if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+            auto status = convertStringValToBlob(requestInput, blob, networkInput, isPipeline);
+            if (!status.ok()) {
+                SPDLOG_DEBUG("Binary inputs conversion failed.");
+                return status;
+            }
+        } else {
+            blob = deserializeTensorProto<ConcreteTensorProtoDeserializator>(requestInput, networkInput, isPipeline);
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    } catch (std::logic_error& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
     }
+    if (blob == nullptr) {
+        Status status = StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+        SPDLOG_DEBUG(status.string());
+        return status;
+    }
+    inputBlobs.emplace_back(networkInput->getName(), std::move(blob));
     return StatusCode::OK;
 }
 
-const Status ModelInstance::validate(const tensorflow::serving::PredictRequest* request) {
+const Status ModelInstance::validateInputs(const tensorflow::serving::PredictRequest* request, input_blobs_t* inputBlobs) {
     Status finalStatus = StatusCode::OK;
 
     // Network and request must have the same amount of inputs
-    auto expectedNumberOfInputs = getInputsInfo().size();
-    finalStatus = validateNumberOfInputs(request, expectedNumberOfInputs);
+    const auto& inputsMetadata = getInputsMetadata();
+    finalStatus = validateNumberOfInputs(request, inputsMetadata.size());
     if (!finalStatus.ok())
         return finalStatus;
 
-    for (const auto& pair : getInputsInfo()) {
-        const auto& name = pair.first;
-        auto networkInput = pair.second;
+    const Mode batchingMode = getModelConfig().getBatchingMode();
+    for (const auto& metadata : inputsMetadata) {
+        const auto& name = metadata.name;
+        const auto& networkInput = metadata.info;
         auto it = request->inputs().find(name);
 
         // Network and request must have the same names of inputs
@@ -905,8 +2625,7 @@ const Status ModelInstance::validate(const tensorflow::serving::PredictRequest*
         }
 
         auto& requestInput = it->second;
-        Mode batchingMode = getModelConfig().getBatchingMode();
-        Mode shapeMode = getModelConfig().isShapeAuto(name) ? AUTO : FIXED;
+        Mode shapeMode = metadata.isShapeAuto ? AUTO : FIXED;
 
         auto status = checkIfShapeValuesNegative(requestInput);
         if (!status.ok())
@@ -931,14 +2650,32 @@ const Status ModelInstance::validate(const tensorflow::serving::PredictRequest*
                     return Status(StatusCode::INVALID_BATCH_SIZE, details);
                 }
             }
+            // blobs are no longer needed once request has to be served by other network
+            if (inputBlobs && finalStatus.ok()) {
+                status = deserializeValidatedInput(networkInput, requestInput, *inputBlobs);
+                if (!status.ok())
+                    return status;
+            }
+            continue;
+        }
+
+        if (metadata.isPlanarYuv) {
+            status = validatePlanarYuvInput(*networkInput, requestInput, finalStatus);
+            if (!status.ok())
+                return status;
+            if (inputBlobs && finalStatus.ok()) {
+                status = deserializeValidatedInput(networkInput, requestInput, *inputBlobs);
+                if (!status.ok())
+                    return status;
+            }
             continue;
         }
 
-        status = validatePrecision(*networkInput, requestInput);
+        status = validatePrecision(metadata, requestInput);
         if (!status.ok())
             return status;
 
-        status = validateNumberOfShapeDimensions(*networkInput, requestInput);
+        status = validateNumberOfShapeDimensions(metadata, requestInput);
         if (!status.ok())
             return status;
 
@@ -954,7 +2691,7 @@ const Status ModelInstance::validate(const tensorflow::serving::PredictRequest*
             }
         }
 
-        if (checkShapeMismatch(*networkInput, requestInput, batchingMode)) {
+        if (checkShapeMismatch(metadata, requestInput, batchingMode)) {
             if (shapeMode == AUTO) {
                 finalStatus = StatusCode::RESHAPE_REQUIRED;
             } else {
@@ -967,13 +2704,210 @@ const Status ModelInstance::validate(const tensorflow::serving::PredictRequest*
             }
         }
 
-        status = validateTensorContentSize(*networkInput, requestInput);
+        status = validateTensorContentSize(metadata, requestInput);
         if (!status.ok())
             return status;
+
+        if (inputBlobs && finalStatus.ok()) {
+            status = deserializeValidatedInput(networkInput, requestInput, *inputBlobs);
+            if (!status.ok())
+                return status;
+        }
     }
     return finalStatus;
 }
 
+const Status ModelInstance::validateForDynamicBatching(const tensorflow::serving::PredictRequest* request, size_t maxBatchSize, size_t& requestBatchSize) {
+    return validateForDynamicBatching(request, getInputsMetadata(), getOutputsInfo(), maxBatchSize, requestBatchSize);
+}
+
+const Status ModelInstance::validateForDynamicBatching(const tensorflow::serving::PredictRequest* request,
+    const TensorMetadataTable& inputsMetadata, const tensor_map_t& outputsInfo,
+    size_t maxBatchSize, size_t& requestBatchSize) {
+    auto status = validateNumberOfInputs(request, inputsMetadata.size());
+    if (!status.ok())
+        return status;
+    // outputs are filtered when the batch is scattered, the filter has to be valid before the request joins it
+    tensor_map_t requestedOutputs;
+    status = filterRequestedOutputs(*request, outputsInfo, requestedOutputs);
+    if (!status.ok())
+        return status;
+
+    requestBatchSize = 0;
+    for (const auto& metadata : inputsMetadata) {
+        const auto& name = metadata.name;
+        auto it = request->inputs().find(name);
+        if (it == request->inputs().end()) {
+            std::stringstream ss;
+            ss << "Required input: " << name;
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("[Model: {} version: {}] Missing input with specific name - {}", getName(), getVersion(), details);
+            return Status(StatusCode::INVALID_MISSING_INPUT, details);
+        }
+
+        auto& requestInput = it->second;
+        status = checkIfShapeValuesNegative(requestInput);
+        if (!status.ok())
+            return status;
+
+        if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+            const std::string details = "Binary inputs are not supported with dynamic batching";
+            SPDLOG_DEBUG("[Model: {} version: {}] Invalid precision - {}", getName(), getVersion(), details);
+            return Status(StatusCode::INVALID_PRECISION, details);
+        }
+        if (isSparseTensor(requestInput)) {
+            const std::string details = "Sparse inputs are not supported with dynamic batching";
+            SPDLOG_DEBUG("[Model: {} version: {}] Invalid sparse tensor - {}", getName(), getVersion(), details);
+            return Status(StatusCode::INVALID_SPARSE_TENSOR, details);
+        }
+
+        status = validatePrecision(metadata, requestInput);
+        if (!status.ok())
+            return status;
+
+        status = validateNumberOfShapeDimensions(metadata, requestInput);
+        if (!status.ok())
+            return status;
+
+        size_t inputBatchSize = requestInput.tensor_shape().dim(0).size();
+        if (inputBatchSize == 0 || inputBatchSize > maxBatchSize ||
+            (requestBatchSize != 0 && inputBatchSize != requestBatchSize)) {
+            std::stringstream ss;
+            ss << "Expected: 1-" << maxBatchSize << " shared by all inputs; Actual: " << inputBatchSize;
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("[Model: {} version: {}] Invalid batch size - {}", getName(), getVersion(), details);
+            return Status(StatusCode::INVALID_BATCH_SIZE, details);
+        }
+        requestBatchSize = inputBatchSize;
+
+        if (checkShapeMismatch(metadata, requestInput, AUTO)) {
+            std::stringstream ss;
+            ss << "Expected: " << TensorInfo::shapeToString(metadata.info->getEffectiveShape())
+               << "; Actual: " << TensorInfo::tensorShapeToString(requestInput.tensor_shape());
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("[Model: {} version: {}] Invalid shape - {}", getName(), getVersion(), details);
+            return Status(StatusCode::INVALID_SHAPE, details);
+        }
+
+        status = validateTensorContentSize(metadata, requestInput);
+        if (!status.ok())
+            return status;
+    }
+    return StatusCode::OK;
+}
+
+static Status giveInputBlobs(const input_blobs_t& inputBlobs, InputSink<InferRequest&>& inputSink) {
+    for (const auto& [name, blob] : inputBlobs) {
+        auto status = inputSink.give(name, blob);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Feeding inputs to inference performer failed:{}", status.string());
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+/**
+ * Writes request data of input into its blob bound to infer request
+ *
+ * @param written false if data cannot be written in place
+ */
+static Status writeIntoBoundBlob(const tensorflow::TensorProto& requestInput, const std::shared_ptr<TensorInfo>& tensorInfo,
+    const InferenceEngine::Blob::Ptr& boundBlob, bool& written) {
+    try {
+        written = writeTensorProtoIntoBlob(requestInput, tensorInfo, boundBlob);
+    } catch (const InferenceEngine::Exception& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    } catch (std::logic_error& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    }
+    return StatusCode::OK;
+}
+
+/**
+ * Writes request inputs into blobs bound to infer request, inputs which cannot be written in place are deserialized into new blobs
+ *
+ * Large inputs are written by deserialization workers in parallel, small ones on the request thread.
+ */
+static Status deserializeIntoBoundBlobs(const tensorflow::serving::PredictRequest& request, const tensor_map_t& inputsInfo,
+    const BlobMap& boundBlobs, InferenceEngine::InferRequest& inferRequest, InputSink<InferRequest&>& inputSink) {
+    struct BoundInput {
+        const std::string* name;
+        const tensorflow::TensorProto* requestInput;
+        const std::shared_ptr<TensorInfo>* tensorInfo;
+        const InferenceEngine::Blob::Ptr* boundBlob;
+        bool parallel;
+        bool written = false;
+        Status status;
+    };
+    tensor_map_t remainingInputs;
+    std::vector<BoundInput> boundInputs;
+    std::vector<size_t> parallelInputs;
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        auto requestInput = request.inputs().find(name);
+        auto boundBlob = boundBlobs.find(tensorInfo->getName());
+        if (requestInput == request.inputs().end() || boundBlob == boundBlobs.end()) {
+            remainingInputs.emplace(name, tensorInfo);
+            continue;
+        }
+        const bool parallel = isDeserializedInParallel(requestInput->second);
+        if (parallel) {
+            parallelInputs.push_back(boundInputs.size());
+        }
+        boundInputs.push_back({&name, &requestInput->second, &tensorInfo, &boundBlob->second, parallel});
+    }
+    for (auto& input : boundInputs) {
+        if (input.parallel) {
+            continue;
+        }
+        input.status = writeIntoBoundBlob(*input.requestInput, *input.tensorInfo, *input.boundBlob, input.written);
+        if (!input.status.ok()) {
+            return input.status;
+        }
+    }
+    deserializeInParallel(parallelInputs.size(), [&boundInputs, &parallelInputs](size_t i) {
+        auto& input = boundInputs[parallelInputs[i]];
+        input.status = writeIntoBoundBlob(*input.requestInput, *input.tensorInfo, *input.boundBlob, input.written);
+        return input.status.ok();
+    });
+    for (const auto& input : boundInputs) {
+        if (!input.status.ok()) {
+            return input.status;
+        }
+        const auto& tensorInfo = *input.tensorInfo;
+        if (!input.written) {
+            remainingInputs.emplace(*input.name, tensorInfo);
+            continue;
+        }
+        try {
+            // pipelines and inputs which did not fit set their own blobs into the same infer requests
+            if (inferRequest.GetBlob(tensorInfo->getName()) != *input.boundBlob) {
+                auto status = inputSink.give(tensorInfo->getName(), *input.boundBlob);
+                if (!status.ok()) {
+                    return status;
+                }
+            }
+        } catch (const InferenceEngine::Exception& e) {
+            Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+            SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+            return status;
+        } catch (std::logic_error& e) {
+            Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+            SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+            return status;
+        }
+    }
+    if (remainingInputs.empty()) {
+        return StatusCode::OK;
+    }
+    bool isPipeline = false;
+    return deserializePredictRequest<ConcreteTensorProtoDeserializator>(request, remainingInputs, inputSink, isPipeline);
+}
+
 Status ModelInstance::performInference(InferenceEngine::InferRequest& inferRequest) {
     try {
         inferRequest.StartAsync();
@@ -991,50 +2925,452 @@ Status ModelInstance::performInference(InferenceEngine::InferRequest& inferReque
     return StatusCode::OK;
 }
 
+void ModelInstance::countError(const Status& status) {
+    // status code rather than message, messages may carry request specific details
+    ModelMetrics::countError(MetricRegistry::getInstance(), getName(), getVersion(), std::to_string(static_cast<int>(status.getCode())));
+}
+
+void ModelInstance::trackUtilization(OVInferRequestsQueue& queue) {
+    queue.trackUtilization(metrics.inferRequestsInUse, metrics.inferRequestsWaiting, metrics.inferRequests, &saturation);
+    queue.setTracepointLabels(getName(), getVersion());
+}
+
 Status ModelInstance::infer(const tensorflow::serving::PredictRequest* requestProto,
     tensorflow::serving::PredictResponse* responseProto,
-    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr) {
-    Timer timer;
-    using std::chrono::microseconds;
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    const RequestContext& context) {
+    increment(metrics.requests);
+    recordRequestShapes(requestProto);
+    auto status = inferCached(requestProto, responseProto, modelUnloadGuardPtr, context);
+    if (!status.ok()) {
+        countError(status);
+    }
+    return status;
+}
+
+Status ModelInstance::inferCached(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    const RequestContext& context) {
+    auto status = context.check();
+    if (!status.ok())
+        return status;
+    auto coalescer = std::atomic_load(&requestCoalescer);
+    // content of shared memory inputs is not part of the request so it cannot be used as cache key
+    if ((!responseCache && !coalescer) || hasSharedMemoryInputs(*requestProto)) {
+        return inferUncached(requestProto, responseProto, modelUnloadGuardPtr, context);
+    }
+    // only responses of successful requests are cached so hits skip validation as well
+    const auto responseCacheKey = ResponseCache::computeKey(*requestProto);
+    if (responseCache && responseCache->find(responseCacheKey, *responseProto)) {
+        SPDLOG_DEBUG("Response cache hit for model {}, version {}", requestProto->model_spec().name(), getVersion());
+        return StatusCode::OK;
+    }
+    if (coalescer) {
+        status = coalescer->infer(responseCacheKey, *responseProto, context,
+            [&]() { return inferUncached(requestProto, responseProto, modelUnloadGuardPtr, context); });
+    } else {
+        status = inferUncached(requestProto, responseProto, modelUnloadGuardPtr, context);
+    }
+    // cache could have been recreated by model reload in the meantime
+    if (status.ok() && responseCache) {
+        responseCache->insert(responseCacheKey, *responseProto);
+    }
+    return status;
+}
+
+Status ModelInstance::inferUncached(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    const RequestContext& context) {
+    Status status;
+    if (!sequenceLengthBuckets.empty()) {
+        bool routed = false;
+        status = inferWithSequenceLengthBucket(requestProto, responseProto, context, routed);
+        if (routed)
+            return status;
+    }
+    if (latencyProfile) {
+        bool routed = false;
+        status = inferWithLatencyProfile(requestProto, responseProto, context, routed);
+        if (routed)
+            return status;
+    }
+    if (dynamicBatcher) {
+        size_t requestBatchSize = 0;
+        status = validateForDynamicBatching(requestProto, getModelConfig().getMaxBatchSize(), requestBatchSize);
+        if (!status.ok())
+            return status;
+        return dynamicBatcher->infer(requestProto, responseProto, requestBatchSize);
+    }
 
-    auto status = validate(requestProto);
+    input_blobs_t inputBlobs;
+    // with bound input blobs inputs are written into blobs of infer request once it is acquired
+    const bool boundInputs = getInferRequestsQueue().hasBoundInputBlobs();
+    status = boundInputs ? validate(requestProto) : validateAndDeserialize(requestProto, inputBlobs);
+    if (status.ok()) {
+        auto profiler = getLayerProfiler();
+        if (profiler && profiler->sample()) {
+            return inferWithQueue(requestProto, responseProto, profiler->getInferRequestsQueue(), getInputsInfo(), getOutputsInfo(), context,
+                boundInputs ? nullptr : &inputBlobs, profiler.get());
+        }
+        return inferWithQueue(requestProto, responseProto, getInferRequestsQueue(), getInputsInfo(), getOutputsInfo(), context,
+            boundInputs ? nullptr : &inputBlobs);
+    }
+    if (status.reshapeRequired() && shapeBucketCache) {
+        std::shared_ptr<ShapeBucket> bucket;
+        status = getShapeBucket(getRequestShapes(requestProto), bucket, modelUnloadGuardPtr);
+        if (!status.ok())
+            return status;
+        return inferWithQueue(requestProto, responseProto, *bucket->inferRequestsQueue, bucket->inputsInfo, bucket->outputsInfo, context);
+    }
+    if (status.batchSizeChangeRequired() && !batchSizeVariants.empty()) {
+        bool routed = false;
+        auto variantStatus = inferWithBatchSizeVariant(requestProto, responseProto, context, routed);
+        if (routed)
+            return variantStatus;
+    }
+    if (batchSplitter && (status.batchSizeChangeRequired() || status == StatusCode::INVALID_BATCH_SIZE)) {
+        size_t requestBatchSize = 0;
+        // requests which cannot be split keep the original status
+        auto splitStatus = validateForDynamicBatching(requestProto, std::numeric_limits<size_t>::max(), requestBatchSize);
+        if (splitStatus.ok() && requestBatchSize > getBatchSize()) {
+            return batchSplitter->infer(requestProto, responseProto, requestBatchSize, context);
+        }
+    }
     status = reloadModelIfRequired(status, requestProto, modelUnloadGuardPtr);
     if (!status.ok())
         return status;
-    timer.start("get infer request");
-    ExecutingStreamIdGuard executingStreamIdGuard(getInferRequestsQueue());
+    return inferWithQueue(requestProto, responseProto, getInferRequestsQueue(), getInputsInfo(), getOutputsInfo(), context);
+}
+
+Status ModelInstance::inferWithQueue(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    OVInferRequestsQueue& queue,
+    const tensor_map_t& inputsInfo,
+    const tensor_map_t& outputsInfo,
+    const RequestContext& context,
+    const input_blobs_t* inputBlobs,
+    LayerProfiler* profiler) {
+    Timer<TIMER_END> timer;
+    using std::chrono::microseconds;
+    timer.start(TOTAL);
+
+    // unrequested outputs are neither bound to the response nor serialized
+    tensor_map_t requestedOutputs;
+    auto status = filterRequestedOutputs(*requestProto, outputsInfo, requestedOutputs);
+    if (!status.ok())
+        return status;
+    const tensor_map_t& servedOutputs = requestProto->output_filter_size() > 0 ? requestedOutputs : outputsInfo;
+
+    timer.start(GET_INFER_REQUEST);
+    Span streamSpan(context.trace, "stream wait");
+    streamSpan.setAttribute("model", getName());
+    streamSpan.setAttribute("version", std::to_string(getVersion()));
+    ExecutingStreamIdGuard executingStreamIdGuard(queue, context, &schedulingTenant);
+    streamSpan.setStatus(executingStreamIdGuard.getStatus());
+    streamSpan.end();
+    if (!executingStreamIdGuard.getStatus().ok()) {
+        SPDLOG_DEBUG("Dropping request for model {}, version {}: {}",
+            requestProto->model_spec().name(), getVersion(), executingStreamIdGuard.getStatus().string());
+        return executingStreamIdGuard.getStatus();
+    }
     int executingInferId = executingStreamIdGuard.getId();
     InferenceEngine::InferRequest& inferRequest = executingStreamIdGuard.getInferRequest();
-    timer.stop("get infer request");
+    timer.stop(GET_INFER_REQUEST);
+    observe(metrics.getInferRequestTime, timer.elapsed<microseconds>(GET_INFER_REQUEST));
     SPDLOG_DEBUG("Getting infer req duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("get infer request") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(GET_INFER_REQUEST) / 1000);
 
-    timer.start("deserialize");
+    timer.start(DESERIALIZE);
+    Span deserializeSpan(context.trace, "deserialize");
+    OVMS_TRACEPOINT(deserialize_start, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingInferId);
     InputSink<InferRequest&> inputSink(inferRequest);
     bool isPipeline = false;
-    status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, getInputsInfo(), inputSink, isPipeline);
-    timer.stop("deserialize");
+    if (inputBlobs) {
+        status = giveInputBlobs(*inputBlobs, inputSink);
+    } else if (queue.hasBoundInputBlobs()) {
+        status = deserializeIntoBoundBlobs(*requestProto, inputsInfo, queue.getBoundInputBlobs(executingInferId), inferRequest, inputSink);
+    } else {
+        status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, inputsInfo, inputSink, isPipeline);
+    }
+    timer.stop(DESERIALIZE);
+    OVMS_TRACEPOINT(deserialize_end, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingInferId, static_cast<int>(status.getCode()));
+    deserializeSpan.setStatus(status);
+    deserializeSpan.end();
+    observe(metrics.deserializeTime, timer.elapsed<microseconds>(DESERIALIZE));
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Deserialization duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("deserialize") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(DESERIALIZE) / 1000);
 
-    timer.start("prediction");
+    status = context.check();
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Dropping request for model {}, version {} before inference: {}",
+            requestProto->model_spec().name(), getVersion(), status.string());
+        return status;
+    }
+    // destroyed before executingStreamIdGuard so that infer request is returned with its own output blobs
+    ResponseOutputsBinding responseOutputsBinding(inferRequest);
+    status = responseOutputsBinding.bind(servedOutputs, responseProto, config.getPostprocessing());
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Outputs of model {}, version {} will be copied into response: {}",
+            requestProto->model_spec().name(), getVersion(), status.string());
+    }
+    timer.start(PREDICTION);
+    Span inferenceSpan(context.trace, "inference");
+    OVMS_TRACEPOINT(inference_start, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingInferId);
     status = performInference(inferRequest);
-    timer.stop("prediction");
+    timer.stop(PREDICTION);
+    OVMS_TRACEPOINT(inference_end, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingInferId, static_cast<int>(status.getCode()));
+    inferenceSpan.setStatus(status);
+    inferenceSpan.end();
+    observe(metrics.predictionTime, timer.elapsed<microseconds>(PREDICTION));
     if (!status.ok())
         return status;
+    if (profiler) {
+        profiler->record(inferRequest);
+    }
     SPDLOG_DEBUG("Prediction duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("prediction") / 1000);
-
-    timer.start("serialize");
-    status = serializePredictResponse(inferRequest, getOutputsInfo(), responseProto);
-    timer.stop("serialize");
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(PREDICTION) / 1000);
+
+    timer.start(SERIALIZE);
+    Span serializeSpan(context.trace, "serialize");
+    OVMS_TRACEPOINT(serialize_start, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingInferId);
+    status = serializePredictResponse(inferRequest, servedOutputs, responseProto, config.getPostprocessing());
+    timer.stop(SERIALIZE);
+    OVMS_TRACEPOINT(serialize_end, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingInferId, static_cast<int>(status.getCode()));
+    serializeSpan.setStatus(status);
+    serializeSpan.end();
+    observe(metrics.serializeTime, timer.elapsed<microseconds>(SERIALIZE));
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Serialization duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("serialize") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(SERIALIZE) / 1000);
+
+    timer.stop(TOTAL);
+    const uint64_t totalUs = timer.elapsed<microseconds>(TOTAL);
+    if (slowRequests.isSlow(totalUs)) {
+        SlowRequestRecord record;
+        record.time = std::chrono::system_clock::now();
+        record.durationUs = totalUs;
+        record.stages = {
+            {"stream_wait", static_cast<uint64_t>(timer.elapsed<microseconds>(GET_INFER_REQUEST))},
+            {"deserialize", static_cast<uint64_t>(timer.elapsed<microseconds>(DESERIALIZE))},
+            {"inference", static_cast<uint64_t>(timer.elapsed<microseconds>(PREDICTION))},
+            {"serialize", static_cast<uint64_t>(timer.elapsed<microseconds>(SERIALIZE))}};
+        record.setInputs(*requestProto);
+        slowRequests.record(std::move(record));
+    }
+    return StatusCode::OK;
+}
+
+Status ModelInstance::inferAsync(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    infer_completion_callback_t callback,
+    const RequestContext& context) {
+    increment(metrics.requests);
+    recordRequestShapes(requestProto);
+    auto status = startInferAsync(requestProto, responseProto, modelUnloadGuardPtr,
+        [this, callback](Status status) {
+            if (!status.ok()) {
+                countError(status);
+            }
+            callback(status);
+        },
+        context);
+    if (!status.ok()) {
+        countError(status);
+    }
+    return status;
+}
+
+Status ModelInstance::startInferAsync(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    infer_completion_callback_t callback,
+    const RequestContext& context) {
+    auto status = context.check();
+    if (!status.ok())
+        return status;
+    if (dynamicBatcher || responseCache || getModelConfig().isCoalesceRequestsEnabled() || getModelConfig().isStateful() ||
+        !sequenceLengthBuckets.empty()) {
+        // batched, cached, coalesced, stateful and sequence length bucketed requests complete on the calling thread
+        status = inferCached(requestProto, responseProto, modelUnloadGuardPtr, context);
+        if (!status.ok())
+            return status;
+        callback(status);
+        return StatusCode::OK;
+    }
+
+    // stages finishing in completion callback are timed there
+    auto timer = std::make_shared<Timer<TIMER_END>>();
+    using std::chrono::microseconds;
+    timer->start(TOTAL);
+    input_blobs_t inputBlobs;
+    const bool boundInputs = getInferRequestsQueue().hasBoundInputBlobs();
+    timer->start(DESERIALIZE);
+    status = boundInputs ? validate(requestProto) : validateAndDeserialize(requestProto, inputBlobs);
+    timer->stop(DESERIALIZE);
+    // inputs deserialized together with validation are given to infer request after stream wait
+    double deserializeUs = boundInputs ? 0 : timer->elapsed<microseconds>(DESERIALIZE);
+    if ((status.reshapeRequired() && shapeBucketCache) ||
+        (status.batchSizeChangeRequired() && !batchSizeVariants.empty()) ||
+        isLatencyProfileBatchSize(getRequestBatchSize(requestProto)) ||
+        (batchSplitter && (status.batchSizeChangeRequired() || status == StatusCode::INVALID_BATCH_SIZE))) {
+        // requests served by additional executable networks or split into sub-batches complete on the calling thread
+        status = inferCached(requestProto, responseProto, modelUnloadGuardPtr, context);
+        if (!status.ok())
+            return status;
+        callback(status);
+        return StatusCode::OK;
+    }
+    auto profiler = getLayerProfiler();
+    if (status.ok() && profiler && profiler->sample()) {
+        // profiled requests complete on the calling thread
+        status = inferWithQueue(requestProto, responseProto, profiler->getInferRequestsQueue(), getInputsInfo(), getOutputsInfo(), context,
+            boundInputs ? nullptr : &inputBlobs, profiler.get());
+        if (!status.ok())
+            return status;
+        callback(status);
+        return StatusCode::OK;
+    }
+    status = reloadModelIfRequired(status, requestProto, modelUnloadGuardPtr);
+    if (!status.ok())
+        return status;
+    std::shared_ptr<tensor_map_t> requestedOutputs;
+    if (requestProto->output_filter_size() > 0) {
+        requestedOutputs = std::make_shared<tensor_map_t>();
+        status = filterRequestedOutputs(*requestProto, getOutputsInfo(), *requestedOutputs);
+        if (!status.ok())
+            return status;
+    }
+    timer->start(GET_INFER_REQUEST);
+    Span streamSpan(context.trace, "stream wait");
+    streamSpan.setAttribute("model", getName());
+    streamSpan.setAttribute("version", std::to_string(getVersion()));
+    auto executingStreamIdGuard = std::make_shared<ExecutingStreamIdGuard>(getInferRequestsQueue(), context, &getSchedulingTenant());
+    streamSpan.setStatus(executingStreamIdGuard->getStatus());
+    streamSpan.end();
+    if (!executingStreamIdGuard->getStatus().ok()) {
+        SPDLOG_DEBUG("Dropping request for model {}, version {}: {}",
+            requestProto->model_spec().name(), getVersion(), executingStreamIdGuard->getStatus().string());
+        return executingStreamIdGuard->getStatus();
+    }
+    InferenceEngine::InferRequest& inferRequest = executingStreamIdGuard->getInferRequest();
+    timer->stop(GET_INFER_REQUEST);
+    observe(metrics.getInferRequestTime, timer->elapsed<microseconds>(GET_INFER_REQUEST));
+
+    timer->start(DESERIALIZE);
+    Span deserializeSpan(context.trace, "deserialize");
+    OVMS_TRACEPOINT(deserialize_start, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingStreamIdGuard->getId());
+    InputSink<InferRequest&> inputSink(inferRequest);
+    if (getInferRequestsQueue().hasBoundInputBlobs()) {
+        status = deserializeIntoBoundBlobs(*requestProto, getInputsInfo(),
+            getInferRequestsQueue().getBoundInputBlobs(executingStreamIdGuard->getId()), inferRequest, inputSink);
+    } else if (inputBlobs.empty()) {
+        // model was reloaded to match the request
+        bool isPipeline = false;
+        status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, getInputsInfo(), inputSink, isPipeline);
+    } else {
+        status = giveInputBlobs(inputBlobs, inputSink);
+    }
+    timer->stop(DESERIALIZE);
+    OVMS_TRACEPOINT(deserialize_end, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingStreamIdGuard->getId(), static_cast<int>(status.getCode()));
+    deserializeSpan.setStatus(status);
+    deserializeSpan.end();
+    deserializeUs += timer->elapsed<microseconds>(DESERIALIZE);
+    observe(metrics.deserializeTime, deserializeUs);
+    if (!status.ok())
+        return status;
+    status = context.check();
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Dropping request for model {}, version {} before inference: {}",
+            requestProto->model_spec().name(), getVersion(), status.string());
+        return status;
+    }
+    // released before the stream so that infer request is returned with its own output blobs
+    auto responseOutputsBinding = std::make_shared<ResponseOutputsBinding>(inferRequest);
+    status = responseOutputsBinding->bind(requestedOutputs ? *requestedOutputs : getOutputsInfo(), responseProto, config.getPostprocessing());
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Outputs of model {}, version {} will be copied into response: {}",
+            requestProto->model_spec().name(), getVersion(), status.string());
+    }
 
+    std::shared_ptr<ModelInstanceUnloadGuard> unloadGuard = std::move(modelUnloadGuardPtr);
+    Span inferenceSpan(context.trace, "inference");
+    OVMS_TRACEPOINT(inference_start, getName().c_str(), getVersion(), tracepointRequestId(responseProto), executingStreamIdGuard->getId());
+    auto trace = context.trace;
+    try {
+        inferRequest.SetCompletionCallback<std::function<void(InferenceEngine::InferRequest, InferenceEngine::StatusCode)>>(
+            [this, executingStreamIdGuard, responseOutputsBinding, requestedOutputs, unloadGuard, requestProto, responseProto, callback, inferenceSpan, trace, timer, deserializeUs](InferenceEngine::InferRequest, InferenceEngine::StatusCode code) {
+                // Resetting the callback destroys this lambda, take over everything it holds first
+                auto instance = this;
+                auto streamGuard = executingStreamIdGuard;
+                auto outputsBinding = responseOutputsBinding;
+                auto servedOutputs = requestedOutputs;
+                auto modelGuard = unloadGuard;
+                auto predictRequest = requestProto;
+                auto response = responseProto;
+                auto completionCallback = callback;
+                auto span = inferenceSpan;
+                auto requestTrace = trace;
+                auto stageTimer = timer;
+                const uint64_t deserializeDurationUs = static_cast<uint64_t>(deserializeUs);
+                auto& request = streamGuard->getInferRequest();
+                request.SetCompletionCallback([]() {});  // reset callback on infer request
+                stageTimer->stop(PREDICTION);
+                observe(instance->metrics.predictionTime, stageTimer->elapsed<microseconds>(PREDICTION));
+
+                Status status = StatusCode::OK;
+                if (code != InferenceEngine::StatusCode::OK) {
+                    status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+                }
+                OVMS_TRACEPOINT(inference_end, instance->getName().c_str(), instance->getVersion(), tracepointRequestId(response), streamGuard->getId(), static_cast<int>(status.getCode()));
+                if (!status.ok()) {
+                    SPDLOG_ERROR("Async infer failed {}: {}", status.string(), code);
+                    span.setStatus(status);
+                    span.end();
+                } else {
+                    span.end();
+                    stageTimer->start(SERIALIZE);
+                    Span serializeSpan(requestTrace, "serialize");
+                    OVMS_TRACEPOINT(serialize_start, instance->getName().c_str(), instance->getVersion(), tracepointRequestId(response), streamGuard->getId());
+                    status = serializePredictResponse(request, servedOutputs ? *servedOutputs : instance->getOutputsInfo(), response, instance->getModelConfig().getPostprocessing());
+                    stageTimer->stop(SERIALIZE);
+                    OVMS_TRACEPOINT(serialize_end, instance->getName().c_str(), instance->getVersion(), tracepointRequestId(response), streamGuard->getId(), static_cast<int>(status.getCode()));
+                    serializeSpan.setStatus(status);
+                    observe(instance->metrics.serializeTime, stageTimer->elapsed<microseconds>(SERIALIZE));
+                }
+                stageTimer->stop(TOTAL);
+                const uint64_t totalUs = stageTimer->elapsed<microseconds>(TOTAL);
+                if (status.ok() && instance->slowRequests.isSlow(totalUs)) {
+                    // request is owned by caller until completion callback is called
+                    SlowRequestRecord record;
+                    record.time = std::chrono::system_clock::now();
+                    record.durationUs = totalUs;
+                    record.stages = {
+                        {"stream_wait", static_cast<uint64_t>(stageTimer->elapsed<microseconds>(GET_INFER_REQUEST))},
+                        {"deserialize", deserializeDurationUs},
+                        {"inference", static_cast<uint64_t>(stageTimer->elapsed<microseconds>(PREDICTION))},
+                        {"serialize", static_cast<uint64_t>(stageTimer->elapsed<microseconds>(SERIALIZE))}};
+                    record.setInputs(*predictRequest);
+                    instance->slowRequests.record(std::move(record));
+                }
+                outputsBinding.reset();
+                streamGuard.reset();
+                completionCallback(status);
+            });
+        timer->start(PREDICTION);
+        inferRequest.StartAsync();
+    } catch (const InferenceEngine::Exception& e) {
+        inferRequest.SetCompletionCallback([]() {});
+        Status status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+        SPDLOG_ERROR("Async caught an exception {}: {}", status.string(), e.what());
+        inferenceSpan.setStatus(status);
+        return status;
+    }
     return StatusCode::OK;
 }
 }  // namespace ovms
@@ -15,12 +15,17 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <inference_engine.hpp>
@@ -28,23 +33,43 @@
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow_serving/apis/get_model_metadata.pb.h"
+#include "tensorflow_serving/apis/get_model_status.pb.h"
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "batch_splitter.hpp"
 #include "customloaderconfig.hpp"
 #include "customloaderinterface.hpp"
+#include "dynamic_batcher.hpp"
+#include "fair_share_scheduler.hpp"
+#include "layer_profiler.hpp"
+#include "memory_lock.hpp"
+#include "metrics.hpp"
 #include "modelchangesubscription.hpp"
 #include "modelconfig.hpp"
 #include "modelinstanceunloadguard.hpp"
 #include "modelversionstatus.hpp"
 #include "ovinferrequestsqueue.hpp"
+#include "request_coalescer.hpp"
+#include "requestcontext.hpp"
+#include "response_cache.hpp"
+#include "saturation_tracker.hpp"
 #include "sequence_processing_spec.hpp"
+#include "service_response_cache.hpp"
+#include "shape_bucket_cache.hpp"
+#include "shape_histogram.hpp"
+#include "slow_requests.hpp"
 #include "status.hpp"
+#include "tensor_metadata.hpp"
 #include "tensorinfo.hpp"
+#include "workerpool.hpp"
 
 namespace ovms {
 
 using tensor_map_t = std::map<std::string, std::shared_ptr<TensorInfo>>;
+using infer_completion_callback_t = std::function<void(const Status&)>;
+using input_blobs_t = std::vector<std::pair<std::string, InferenceEngine::Blob::Ptr>>;
 
 class DynamicModelParameter {
 public:
@@ -71,6 +96,21 @@ private:
 
 class PipelineDefinition;
 
+/**
+     * @brief Estimated memory used by model version by component, in bytes
+     */
+struct ModelMemoryUsage {
+    uint64_t modelFiles = 0;
+    uint64_t inferRequests = 0;
+    uint64_t sequenceStates = 0;
+    // memory locked in RAM with lock_memory, overlaps with components above so it is not part of total
+    uint64_t locked = 0;
+
+    uint64_t total() const {
+        return modelFiles + inferRequests + sequenceStates;
+    }
+};
+
 /**
      * @brief This class contains all the information about inference engine model
      */
@@ -84,9 +124,9 @@ protected:
     virtual Status loadModelImpl(const ModelConfig& config, const DynamicModelParameter& parameter = DynamicModelParameter());
 
     /**
-         * @brief Inference Engine core object
+         * @brief Inference Engine core object, shared by all model instances
          */
-    std::unique_ptr<InferenceEngine::Core> engine;
+    std::shared_ptr<InferenceEngine::Core> engine;
 
     /**
          * @brief Inference Engine CNNNetwork object
@@ -98,6 +138,11 @@ protected:
          */
     std::shared_ptr<InferenceEngine::ExecutableNetwork> execNetwork;
 
+    /**
+         * @brief Device networks of balanced target device, execNetwork points to the first one
+         */
+    std::vector<std::pair<std::string, std::shared_ptr<InferenceEngine::ExecutableNetwork>>> balancedExecNetworks;
+
     /**
          * @brief Model name
          */
@@ -144,11 +189,31 @@ protected:
       */
     static constexpr std::array<const char*, 1> ONNX_MODEL_FILES_EXTENSIONS{".onnx"};
 
+    /**
+      * @brief Directory in model version path with serialized PredictRequest files used for warmup
+      */
+    static constexpr const char* WARMUP_DIRECTORY = "warmup";
+
+    /**
+      * @brief Number of recorded requests between prewarms of shape cache
+      */
+    static constexpr uint64_t SHAPE_CACHE_PREWARM_INTERVAL = 256;
+
     /**
          * @brief Notifies model instance users who wait for loading
          */
     std::condition_variable modelLoadedNotify;
 
+    /**
+         * @brief Mutex of modelLoadedNotify, held while notifying so waiters do not miss state changes
+         */
+    std::mutex modelLoadedNotifyMtx;
+
+    /**
+         * @brief Wakes up users waiting in waitForLoaded, to be called after every status change they wait for
+         */
+    void notifyLoadingWaiters();
+
     /**
          * @brief Holds currently loaded model configuration
          */
@@ -161,13 +226,20 @@ protected:
          */
     virtual std::unique_ptr<InferenceEngine::CNNNetwork> loadOVCNNNetworkPtr(const std::string& modelFile);
 
+    /**
+         * @brief Load OV CNNNetwork ptr with weights file mapped to memory instead of read to heap
+         *
+         * @return CNNNetwork ptr, nullptr if weights file cannot be mapped
+         */
+    std::unique_ptr<InferenceEngine::CNNNetwork> loadOVCNNNetworkWithMappedWeights(const std::string& modelFile, const std::string& weightsFile);
+
     /**
          * @brief Lock to disable concurrent modelinstance load/unload/reload
          */
     std::recursive_mutex loadingMutex;
 
     /**
-         * @brief Load OV Engine
+         * @brief Load OV Engine shared by all model instances
          */
     void loadOVEngine();
 
@@ -178,11 +250,31 @@ protected:
          */
     Status loadOVCNNNetwork();
 
+    /**
+         * @brief Loads OV CNNNetwork from model files read to memory
+         *
+         * @return Status
+         */
+    Status loadOVCNNNetworkFromMemory(const model_files_contents_t& files);
+
     /**
          * @brief Sets OV ExecutableNetworkPtr
          */
     virtual void loadExecutableNetworkPtr(const plugin_config_t& pluginConfig);
 
+    /**
+         * @brief Sets OV ExecutableNetworkPtr to network compiled by other model instance from identical files with identical settings,
+         * compiles and registers it if there is none
+         */
+    void loadSharedExecutableNetworkPtr(const plugin_config_t& pluginConfig);
+
+    /**
+         * @brief Gets key of compiled network in CompiledNetworkRegistry
+         *
+         * @return key or empty string if network cannot be shared
+         */
+    std::string getCompiledNetworkKey(const plugin_config_t& pluginConfig);
+
     /**
          * @brief Loads OV ExecutableNetwork
          *
@@ -193,7 +285,313 @@ protected:
     /**
          * @brief Prepares inferenceRequestsQueue
          */
-    Status prepareInferenceRequestsQueue(const ModelConfig& config);
+    virtual Status prepareInferenceRequestsQueue(const ModelConfig& config);
+
+    /**
+         * @brief Allocates input blobs of infer requests in queue once if enabled in config,
+         * in device memory when remote blobs are enabled
+         */
+    Status bindInputBlobs(const ModelConfig& config, OVInferRequestsQueue& queue);
+
+    /**
+         * @brief Gets context of the device plugin if remote blobs are enabled in config
+         */
+    void prepareRemoteContext(const ModelConfig& config);
+
+    /**
+         * @brief Makes queue create infer requests on demand if min_nireq is set in config
+         */
+    void prepareElasticity(const ModelConfig& config, OVInferRequestsQueue& queue);
+
+    /**
+         * @brief Pre-faults and locks in RAM memory mapped since mappedBefore, like weights and compiled network,
+         * and blobs of infer requests
+         */
+    void lockMemory(const ModelConfig& config, const std::vector<MemoryRange>& mappedBefore);
+
+    /**
+         * @brief Pre-faults and locks in RAM input and output blobs of infer requests if enabled in config
+         */
+    void lockInferRequestsMemory(const ModelConfig& config);
+
+    /**
+         * @brief Prepares dynamic batcher if enabled in config
+         */
+    virtual void prepareDynamicBatcher(const ModelConfig& config);
+
+    /**
+         * @brief Creates batch splitter when batch split parallelism is set and outputs can be gathered
+         */
+    void prepareBatchSplitter(const ModelConfig& config);
+
+    /**
+         * @brief Prepares cache of executable networks for non default shapes if enabled in config
+         */
+    void prepareShapeBucketCache(const ModelConfig& config);
+
+    /**
+         * @brief Counts request shapes of shape auto models and schedules prewarm of shape cache every SHAPE_CACHE_PREWARM_INTERVAL requests
+         */
+    void recordRequestShapes(const tensorflow::serving::PredictRequest* requestProto);
+
+    /**
+         * @brief Compiles the most frequent request shapes missing in shape cache, skipped when model is being loaded or unloaded
+         */
+    void prewarmShapeCache();
+
+    /**
+         * @brief Prepares cache of responses keyed by request inputs if enabled in config
+         */
+    void prepareResponseCache(const ModelConfig& config);
+
+    /**
+         * @brief Prepares sharing of inferences by concurrent identical requests if enabled in config
+         */
+    void prepareRequestCoalescer(const ModelConfig& config);
+
+    /**
+         * @brief Compiles network with performance counters for sampled requests if enabled in config
+         */
+    void prepareLayerProfiler(const ModelConfig& config);
+
+    /**
+         * @brief Compiles executable networks for batch size variants set in config
+         *
+         * @param config
+         * @param parameter variants compiled earlier are kept when reloading for requested batch size
+         *
+         * @return Status
+         */
+    Status prepareBatchSizeVariants(const ModelConfig& config, const DynamicModelParameter& parameter);
+
+    /**
+         * @brief Compiles executable networks for sequence length buckets set in config
+         *
+         * @param config
+         *
+         * @return Status
+         */
+    Status prepareSequenceLengthBuckets(const ModelConfig& config);
+
+    /**
+         * @brief Compiles executable network of latency profile set in config
+         *
+         * @param config
+         * @param parameter profile compiled earlier is kept when reloading for requested batch size
+         *
+         * @return Status
+         */
+    Status prepareLatencyProfile(const ModelConfig& config, const DynamicModelParameter& parameter);
+
+    /**
+         * @brief Checks if model config requests auto tuning and leaves CPU streams and nireq to be selected
+         */
+    bool isAutoTuneApplicable(const ModelConfig& config) const;
+
+    /**
+         * @brief Loads executable network with candidate CPU streams counts and keeps the one with best throughput
+         *
+         * Each candidate is benchmarked with nireq equal to the number of streams and twice that number.
+         * Configurations exceeding maximum latency from config are selected only if none fits the limit.
+         *
+         * @param config
+         * @param pluginConfig updated with selected CPU_THROUGHPUT_STREAMS
+         *
+         * @return Status
+         */
+    Status autoTuneExecutableNetwork(const ModelConfig& config, plugin_config_t& pluginConfig);
+
+    /**
+         * @brief Runs zero filled inferences on nireq new infer requests of executable network in parallel
+         *
+         * @param nireq
+         * @param throughput inferences per second
+         * @param latencyMs average latency of single inference
+         *
+         * @return Status
+         */
+    Status benchmarkExecutableNetwork(uint32_t nireq, double& throughput, double& latencyMs);
+
+    /**
+         * @brief Runs warmup inferences on default executable network and batch size variants
+         *
+         * @param config
+         *
+         * @return Status
+         */
+    Status warmupModel(const ModelConfig& config);
+
+    /**
+         * @brief Reads warmup requests from WARMUP_DIRECTORY, requests not matching the network are skipped
+         *
+         * @param samples
+         */
+    void loadWarmupSamples(std::vector<tensorflow::serving::PredictRequest>& samples);
+
+    /**
+         * @brief Runs warmup inferences on every infer request of the queue
+         *
+         * @param queue idle queue, no other inferences can be in progress
+         * @param inputsInfo tensor information matching network of the queue
+         * @param samples requests to use, zero filled inputs are used if empty
+         * @param iterations number of inferences per infer request
+         *
+         * @return Status
+         */
+    Status warmupInferRequests(OVInferRequestsQueue& queue,
+        const tensor_map_t& inputsInfo,
+        const std::vector<tensorflow::serving::PredictRequest>& samples,
+        uint32_t iterations);
+
+    /**
+         * @brief Runs request on the smallest batch size variant fitting its batch, padding the batch if needed
+         *
+         * @param requestProto validated request
+         * @param responseProto
+         * @param context
+         * @param routed set to false if no variant fits the request
+         *
+         * @return Status
+         */
+    Status inferWithBatchSizeVariant(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        const RequestContext& context,
+        bool& routed);
+
+    /**
+         * @brief Pads request to the smallest sequence length bucket fitting its sequence and trims outputs back
+         *
+         * @param requestProto
+         * @param responseProto
+         * @param context
+         * @param routed set to false if request has no paddable sequence inputs or no bucket fits it
+         *
+         * @return Status
+         */
+    Status inferWithSequenceLengthBucket(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        const RequestContext& context,
+        bool& routed);
+
+    /**
+         * @brief Runs request with batch size of latency profile on its network
+         *
+         * When the default network fits the request as well, the profile is taken by requests with its priority
+         * while it has an idle infer request, and by other requests only while the default network has none idle.
+         *
+         * @param requestProto
+         * @param responseProto
+         * @param context
+         * @param routed set to false if request is left to the default network
+         *
+         * @return Status
+         */
+    Status inferWithLatencyProfile(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        const RequestContext& context,
+        bool& routed);
+
+    /**
+         * @brief Tells whether request with given batch size could be served by latency profile
+         */
+    bool isLatencyProfileBatchSize(size_t requestBatchSize) const {
+        return latencyProfile && requestBatchSize == getModelConfig().getLatencyProfile().batchSize;
+    }
+
+    /**
+         * @brief Compiles executable network for requested shapes, must be called with loading mutex held
+         *
+         * @param requestShapes
+         * @param bucket
+         *
+         * @return Status
+         */
+    Status compileShapeBucket(const std::map<std::string, shape_t>& requestShapes, std::shared_ptr<ShapeBucket>& bucket);
+
+    /**
+         * @brief Compiles executable network for requested shapes with given plugin config and number of infer requests
+         *
+         * @param requestShapes
+         * @param bucket
+         * @param pluginConfig
+         * @param nireq
+         *
+         * @return Status
+         */
+    Status compileShapeBucket(const std::map<std::string, shape_t>& requestShapes, std::shared_ptr<ShapeBucket>& bucket,
+        const plugin_config_t& pluginConfig, uint32_t nireq);
+
+    /**
+         * @brief Runs request, serving it from response cache when possible
+         *
+         * @param requestProto
+         * @param responseProto
+         * @param modelUnloadGuardPtr
+         * @param context
+         *
+         * @return Status
+         */
+    Status inferCached(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+        const RequestContext& context);
+
+    /**
+         * @brief Starts inference without blocking the calling thread, request is already counted in metrics
+         */
+    Status startInferAsync(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+        infer_completion_callback_t callback,
+        const RequestContext& context);
+
+    /**
+         * @brief Counts failed request in metrics
+         */
+    void countError(const Status& status);
+
+    /**
+         * @brief Adds queue counts to infer requests utilization metrics
+         */
+    void trackUtilization(OVInferRequestsQueue& queue);
+
+    /**
+         * @brief Runs request without looking it up in response cache
+         *
+         * @param requestProto
+         * @param responseProto
+         * @param modelUnloadGuardPtr
+         * @param context
+         *
+         * @return Status
+         */
+    Status inferUncached(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+        const RequestContext& context);
+
+    /**
+         * @brief Runs validated request on streams of given queue
+         *
+         * @param requestProto
+         * @param responseProto
+         * @param queue
+         * @param inputsInfo tensor information matching network compiled for the queue
+         * @param outputsInfo
+         * @param context
+         * @param inputBlobs blobs already built from request during validation, request is deserialized if null
+         * @param profiler records performance counts of inference if queue is its profiling queue
+         *
+         * @return Status
+         */
+    Status inferWithQueue(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        OVInferRequestsQueue& queue,
+        const tensor_map_t& inputsInfo,
+        const tensor_map_t& outputsInfo,
+        const RequestContext& context,
+        const input_blobs_t* inputBlobs = nullptr,
+        LayerProfiler* profiler = nullptr);
 
     /**
          * @brief Fetch model file paths
@@ -202,6 +600,13 @@ protected:
          */
     Status fetchModelFilepaths();
 
+    /**
+         * @brief Fetch names of model files read to memory
+         *
+         * @return Status
+         */
+    Status fetchInMemoryModelFiles(const model_files_contents_t& files);
+
     /**
          * @brief Find file path with extension in model path
          *
@@ -221,30 +626,83 @@ protected:
     virtual const Status validateNumberOfInputs(const tensorflow::serving::PredictRequest* request,
         const size_t expectedNumberOfInputs);
 
-    const Status validatePrecision(const ovms::TensorInfo& networkInput,
+    const Status validatePrecision(const TensorMetadata& networkInput,
         const tensorflow::TensorProto& requestInput);
 
-    const Status validateNumberOfShapeDimensions(const ovms::TensorInfo& networkInput,
+    const Status validateNumberOfShapeDimensions(const TensorMetadata& networkInput,
         const tensorflow::TensorProto& requestInput);
 
     const Status validateNumberOfBinaryInputShapeDimensions(const tensorflow::TensorProto& requestInput);
 
+    /**
+         * @brief Validates NV12 or I420 frames converted by OpenVINO preprocessing, sent as uint8 data of shape [N, H*3/2, W, 1]
+         *
+         * @param finalStatus set to BATCHSIZE_CHANGE_REQUIRED when batch size differs and may be changed
+         */
+    const Status validatePlanarYuvInput(const ovms::TensorInfo& networkInput,
+        const tensorflow::TensorProto& requestInput, Status& finalStatus);
+
     const bool checkBinaryInputBatchSizeMismatch(const ovms::TensorInfo& networkInput,
         const tensorflow::TensorProto& requestInput);
 
     const bool checkBatchSizeMismatch(const ovms::TensorInfo& networkInput,
         const tensorflow::TensorProto& requestInput);
 
-    const bool checkShapeMismatch(const ovms::TensorInfo& networkInput,
+    const bool checkShapeMismatch(const TensorMetadata& networkInput,
         const tensorflow::TensorProto& requestInput,
         const Mode& batchingMode);
 
-    const Status validateTensorContentSize(const ovms::TensorInfo& networkInput,
+    const Status validateTensorContentSize(const TensorMetadata& networkInput,
         const tensorflow::TensorProto& requestInput);
 
     virtual const Status validate(const tensorflow::serving::PredictRequest* request);
 
+    /**
+         * @brief Validates request and wraps its inputs in blobs of default network in the same pass over inputs
+         *
+         * Blobs are returned only if request can be served by default network as is.
+         * Otherwise inputBlobs is empty and status tells if reshape or batch size change is required.
+         *
+         * @param request
+         * @param inputBlobs blobs with network input names
+         *
+         * @return Status
+         */
+    const Status validateAndDeserialize(const tensorflow::serving::PredictRequest* request, input_blobs_t& inputBlobs);
+
+    /**
+         * @brief Validates request against network accepting any batch up to max batch size
+         *
+         * @param request
+         * @param maxBatchSize max batch dimension accepted
+         * @param requestBatchSize batch dimension shared by all request inputs
+         *
+         * @return Status
+         */
+    const Status validateForDynamicBatching(const tensorflow::serving::PredictRequest* request, size_t maxBatchSize, size_t& requestBatchSize);
+
+    /**
+         * @brief Validates request for batching on other executable network of the model
+         *
+         * @param request
+         * @param inputsMetadata inputs of the network
+         * @param outputsInfo outputs of the network
+         * @param maxBatchSize max batch dimension accepted
+         * @param requestBatchSize batch dimension shared by all request inputs
+         *
+         * @return Status
+         */
+    const Status validateForDynamicBatching(const tensorflow::serving::PredictRequest* request,
+        const TensorMetadataTable& inputsMetadata, const tensor_map_t& outputsInfo,
+        size_t maxBatchSize, size_t& requestBatchSize);
+
 private:
+    const Status validateInputs(const tensorflow::serving::PredictRequest* request, input_blobs_t* inputBlobs);
+
+    Status deserializeValidatedInput(const std::shared_ptr<TensorInfo>& networkInput,
+        const tensorflow::TensorProto& requestInput,
+        input_blobs_t& inputBlobs);
+
     /**
          * @brief Holds the information about inputs and it's parameters
          */
@@ -255,6 +713,11 @@ private:
          */
     tensor_map_t outputsInfo;
 
+    /**
+         * @brief Flat copy of inputs information read by request validation, rebuilt with inputsInfo
+         */
+    TensorMetadataTable inputsMetadata;
+
     /**
       * @brief Holds model required file names. First is loaded
       */
@@ -265,6 +728,127 @@ private:
          */
     std::unique_ptr<OVInferRequestsQueue> inferRequestsQueue;
 
+    /**
+         * @brief Context of the device plugin when remote blobs are enabled and supported by the device
+         */
+    InferenceEngine::RemoteContext::Ptr remoteContext;
+
+    /**
+         * @brief Coalesces concurrent requests when dynamic batching is enabled
+         */
+    std::unique_ptr<DynamicBatcher> dynamicBatcher;
+
+    /**
+         * @brief Splits requests with batch larger than the network batch when batch split parallelism is set
+         */
+    std::unique_ptr<BatchSplitter> batchSplitter;
+
+    /**
+         * @brief Executable networks compiled for shapes requested for shape auto inputs
+         */
+    std::unique_ptr<ShapeBucketCache> shapeBucketCache;
+
+    /**
+         * @brief Shapes of requests to shape auto inputs, kept over reloads of the version
+         */
+    std::unique_ptr<ShapeHistogram> shapeHistogram;
+
+    /**
+         * @brief Compiles frequent request shapes into shape cache in background
+         */
+    std::unique_ptr<WorkerPool> shapeCachePrewarmWorker;
+    std::atomic<bool> shapeCachePrewarmScheduled{false};
+
+    /**
+         * @brief Outputs of earlier responses reused for repeated inputs
+         */
+    std::unique_ptr<ResponseCache> responseCache;
+
+    /**
+         * @brief Inferences in flight shared by concurrent identical requests, accessed atomically
+         * since requests reloading the model replace it while other requests use it
+         */
+    std::shared_ptr<RequestCoalescer> requestCoalescer;
+
+    /**
+         * @brief Profiling infer request of network compiled with performance counters, accessed atomically
+         * since the model reload replaces it while requests and profile readers use it
+         */
+    std::shared_ptr<LayerProfiler> layerProfiler;
+
+    /**
+         * @brief Last metadata and status responses of this version, keyed by version statuses changes count
+         */
+    ServiceResponseCache<tensorflow::serving::GetModelMetadataResponse> metadataResponseCache;
+    ServiceResponseCache<tensorflow::serving::GetModelStatusResponse> statusResponseCache;
+
+    /**
+         * @brief Request counts, stage times and infer requests utilization reported at metrics endpoint
+         */
+    ModelMetrics metrics;
+
+    /**
+         * @brief Wait and hold times of infer requests of all queues of the version, signal for autoscalers
+         */
+    SaturationTracker saturation;
+
+    /**
+         * @brief The slowest requests with their stage breakdown, exposed through REST API
+         */
+    SlowRequests& slowRequests;
+
+    /**
+         * @brief Share of server capacity of the model, common for all its versions
+         */
+    FairShareScheduler::Tenant& schedulingTenant;
+
+    /**
+         * @brief Executable network compiled for one of configured batch sizes
+         */
+    struct BatchSizeVariant {
+        std::shared_ptr<ShapeBucket> bucket;
+        // pads requests with smaller batch, declared after bucket to be released first
+        std::unique_ptr<DynamicBatcher> padder;
+    };
+
+    /**
+         * @brief Batch size variants by their batch size
+         */
+    std::map<size_t, BatchSizeVariant> batchSizeVariants;
+
+    /**
+         * @brief Executable network compiled for one of configured sequence lengths
+         */
+    struct SequenceLengthBucket {
+        std::shared_ptr<ShapeBucket> bucket;
+        TensorMetadataTable inputsMetadata;
+        // groups requests of the bucket into batches, declared after bucket to be released first
+        std::unique_ptr<DynamicBatcher> batcher;
+    };
+
+    /**
+         * @brief Sequence length buckets by their sequence length
+         */
+    std::map<size_t, SequenceLengthBucket> sequenceLengthBuckets;
+
+    /**
+         * @brief Outputs with sequence dimension in all sequence length buckets, trimmed to request sequence length
+         */
+    std::set<std::string> sequenceOutputs;
+
+    /**
+         * @brief Executable network of latency profile
+         */
+    struct LatencyProfileNetwork {
+        std::shared_ptr<ShapeBucket> bucket;
+        TensorMetadataTable inputsMetadata;
+    };
+
+    /**
+         * @brief Network of latency profile, nullptr when the profile is not set
+         */
+    std::unique_ptr<LatencyProfileNetwork> latencyProfile;
+
     /**
          * @brief Holds current usage count in predict requests
          * 
@@ -272,6 +856,80 @@ private:
          */
     std::atomic<uint64_t> predictRequestsHandlesCount = 0;
 
+    /**
+         * @brief Number of threads waiting for predict requests to finish, release of the last unload guard notifies them
+         */
+    std::atomic<uint32_t> unloadWaitersCount = 0;
+
+    std::mutex unloadNotifyMtx;
+    std::condition_variable unloadNotify;
+
+    /**
+         * @brief Blocks until all unload guards are released
+         */
+    void waitForPredictRequestsToFinish();
+
+    /**
+         * @brief Set when version is compiled on first request and may be unloaded when idle
+         */
+    std::atomic<bool> loadedOnDemand = false;
+
+    /**
+         * @brief Time of last request for the version, in steady clock ticks
+         */
+    std::atomic<std::chrono::steady_clock::rep> lastUsedTime = 0;
+
+    /**
+         * @brief Estimated memory used by loaded version, in bytes
+         */
+    std::atomic<uint64_t> memoryFootprint = 0;
+
+    /**
+         * @brief Memory usage reported while version is being loaded or unloaded
+         */
+    ModelMemoryUsage lastMemoryUsage;
+    std::mutex memoryUsageMutex;
+
+    /**
+         * @brief Memory locked in RAM with lock_memory, infer request blobs are locked separately as they are recreated with the queue
+         */
+    std::unique_ptr<MemoryLock> modelMemoryLock;
+    std::unique_ptr<MemoryLock> inferRequestsMemoryLock;
+
+    /**
+         * @brief Gets memory held by states of sequences, must be called under loading lock
+         */
+    virtual uint64_t getSequenceStatesMemoryBytes() {
+        return 0;
+    }
+
+    /**
+         * @brief Number of infer requests selected by auto tuning, 0 if model is not auto tuned
+         */
+    uint32_t tunedNireq = 0;
+
+    /**
+         * @brief Stores config and leaves version in START state until loadModelOnDemand is called
+         *
+         * @param config
+         *
+         * @return Status
+         */
+    Status deferLoading(const ModelConfig& config);
+
+    /**
+         * @brief Estimates memory needed by loaded version based on model files size
+         */
+    uint64_t estimateMemoryFootprint() const;
+
+    /**
+         * @brief Sets preprocessing of network input done by OpenVINO during inference
+         *
+         * @param input
+         * @param preprocessing
+         */
+    static Status applyPreprocessing(InferenceEngine::InputInfo& input, const InputPreprocessing& preprocessing);
+
     /**
          * @brief Internal method for loading inputs
          *
@@ -283,8 +941,10 @@ private:
          * @brief Internal method for loading outputs
          *
          * @param config
+         *
+         * @return Status
          */
-    void loadOutputTensors(const ModelConfig& config);
+    Status loadOutputTensors(const ModelConfig& config);
 
     /**
          * @brief Configures batchsize
@@ -292,7 +952,13 @@ private:
     void configureBatchSize(const ModelConfig& config, const DynamicModelParameter& parameter = DynamicModelParameter());
 
     uint32_t getNumOfParallelInferRequests(const ModelConfig& config);
-    uint32_t getNumOfParallelInferRequestsUnbounded(const ModelConfig& config);
+    uint32_t getNumOfParallelInferRequests(const ModelConfig& config, InferenceEngine::ExecutableNetwork& network);
+    uint32_t getNumOfParallelInferRequestsUnbounded(const ModelConfig& config, InferenceEngine::ExecutableNetwork& network);
+
+    /**
+         * @brief Selects plugin config keys supported by device, so that one config can be used for all balanced devices
+         */
+    plugin_config_t getDevicePluginConfig(const std::string& device, const plugin_config_t& pluginConfig);
 
     /**
          * @brief Recover from any state model is put into when reload is requested
@@ -325,7 +991,10 @@ public:
     ModelInstance(const std::string& name, model_version_t version) :
         name(name),
         version(version),
-        subscriptionManager(std::string("model: ") + name + std::string(" version: ") + std::to_string(version)) { isCustomLoaderConfigChanged = false; }
+        subscriptionManager(std::string("model: ") + name + std::string(" version: ") + std::to_string(version)),
+        metrics(ModelMetrics::create(MetricRegistry::getInstance(), name, version)),
+        slowRequests(SlowRequestsLog::instance().getModel(name, version)),
+        schedulingTenant(FairShareScheduler::instance().getTenant(name)) { isCustomLoaderConfigChanged = false; }
 
     /**
          * @brief Destroy the Model Instance object
@@ -347,11 +1016,9 @@ public:
     }
 
     /**
-         * @brief Decreases predict requests usage count
+         * @brief Decreases predict requests usage count, notifies threads waiting to unload when it drops to zero
          */
-    void decreasePredictRequestsHandlesCount() {
-        --predictRequestsHandlesCount;
-    }
+    void decreasePredictRequestsHandlesCount();
 
     /**
          * @brief Gets the model name
@@ -434,6 +1101,15 @@ public:
         return outputsInfo;
     }
 
+    /**
+         * @brief Get inputs information laid out for request hot path, in the same order as inputs info
+         *
+         * @return const TensorMetadataTable&
+         */
+    virtual const TensorMetadataTable& getInputsMetadata() const {
+        return inputsMetadata;
+    }
+
     /**
          * @brief Check if can unload infer requests
          *
@@ -452,6 +1128,103 @@ public:
         return *inferRequestsQueue;
     }
 
+    /**
+         * @brief Get dynamic batcher coalescing requests to the model
+         *
+         * @return DynamicBatcher or nullptr when dynamic batching is disabled
+         */
+    DynamicBatcher* getDynamicBatcher() const {
+        return dynamicBatcher.get();
+    }
+
+    /**
+         * @brief Get response cache
+         * 
+         * @return cache or nullptr if disabled
+         */
+    const ResponseCache* getResponseCache() const {
+        return responseCache.get();
+    }
+
+    /**
+         * @brief Get context of the device plugin blobs in device memory are created with
+         * 
+         * @return context or nullptr if remote blobs are disabled or not supported by the device
+         */
+    const InferenceEngine::RemoteContext::Ptr& getRemoteContext() const {
+        return remoteContext;
+    }
+
+    /**
+         * @brief Get request coalescer
+         * 
+         * @return coalescer or nullptr if disabled
+         */
+    std::shared_ptr<const RequestCoalescer> getRequestCoalescer() const {
+        return std::atomic_load(&requestCoalescer);
+    }
+
+    /**
+         * @brief Get layer profiler
+         * 
+         * @return profiler or nullptr if layer profiling is disabled
+         */
+    std::shared_ptr<LayerProfiler> getLayerProfiler() const {
+        return std::atomic_load(&layerProfiler);
+    }
+
+    /**
+         * @brief Checks if executable networks for new shapes are compiled without reloading the model
+         */
+    bool hasShapeBucketCache() const {
+        return shapeBucketCache != nullptr;
+    }
+
+    /**
+         * @brief Get counts of request shapes, nullptr when no input shape is set to auto
+         */
+    const ShapeHistogram* getShapeHistogram() const {
+        return shapeHistogram.get();
+    }
+
+    /**
+         * @brief Gets cached executable network matching input shapes, compiles it if not cached
+         *
+         * @param shapes shapes of all model inputs by their names
+         * @param bucket
+         * @param modelUnloadGuardPtr released while waiting for concurrent model reloads
+         *
+         * @return Status
+         */
+    Status getShapeBucket(const std::map<std::string, shape_t>& shapes,
+        std::shared_ptr<ShapeBucket>& bucket,
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr);
+
+    /**
+         * @brief Get executable network of batch size variant
+         *
+         * @return network compiled for exactly this batch size or nullptr
+         */
+    std::shared_ptr<ShapeBucket> getBatchSizeVariant(size_t batchSize) const {
+        auto it = batchSizeVariants.find(batchSize);
+        return it != batchSizeVariants.end() ? it->second.bucket : nullptr;
+    }
+
+    /**
+         * @brief Get share of server capacity of the model
+         */
+    FairShareScheduler::Tenant& getSchedulingTenant() const {
+        return schedulingTenant;
+    }
+
+    ServiceResponseCache<tensorflow::serving::GetModelMetadataResponse>& getMetadataResponseCache() {
+        return metadataResponseCache;
+    }
+
+    ServiceResponseCache<tensorflow::serving::GetModelStatusResponse>& getStatusResponseCache() {
+        return statusResponseCache;
+    }
+
     /**
          * @brief Combines plugin config from user with default config calculated at runtime
          *
@@ -477,6 +1250,17 @@ public:
          */
     virtual Status reloadModel(const ModelConfig& config, const DynamicModelParameter& parameter = DynamicModelParameter());
 
+    /**
+         * @brief Recreates infer requests queue of loaded model version with new nireq and queue limits, without recompiling the network
+         *
+         * In progress inferences are drained from the old queue before it is replaced.
+         *
+         * @param config model configuration differing only in infer requests queue parameters
+         *
+         * @return Status
+         */
+    Status reloadInferRequestsQueue(const ModelConfig& config);
+
     /**
          * @brief Reloads model version with different batch size or shape, reads CNN network model from files (*.xml and *.bin files) and recreates inference engine
          *
@@ -513,6 +1297,71 @@ public:
          */
     virtual void cleanupFailedLoad();
 
+    /**
+         * @brief Compiles version with lazy loading enabled if it is not loaded yet, blocks callers until it is done
+         *
+         * @return Status
+         */
+    Status loadModelOnDemand();
+
+    /**
+         * @brief Unloads loaded version with lazy loading enabled and puts it back to START state, it is loaded again on next request
+         *
+         * @return true if version was unloaded
+         */
+    bool evict();
+
+    /**
+         * @brief Checks if version is compiled on first request and may be unloaded when idle
+         */
+    bool isLoadedOnDemand() const {
+        return loadedOnDemand;
+    }
+
+    /**
+         * @brief Marks version as used by a request, recently used versions are unloaded last
+         */
+    void updateLastUsedTime() {
+        lastUsedTime = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    std::chrono::steady_clock::rep getLastUsedTime() const {
+        return lastUsedTime;
+    }
+
+    /**
+         * @brief Gets estimated memory used by the version, 0 if not loaded
+         *
+         * @return bytes
+         */
+    uint64_t getMemoryFootprint() const {
+        return memoryFootprint;
+    }
+
+    /**
+         * @brief Gets estimated memory used by model files, infer requests blobs and sequence states
+         *
+         * Does not wait for load or unload in progress, usage reported last is returned then.
+         */
+    ModelMemoryUsage getMemoryUsage();
+
+    /**
+         * @brief Reports memory usage at metrics endpoint
+         */
+    void updateMemoryMetrics();
+
+    /**
+         * @brief Gets saturation of infer requests over the last seconds
+         */
+    Saturation getSaturation() const;
+
+    const ModelMetrics& getMetrics() const { return this->metrics; }
+
+    /**
+         * @brief Reports saturation at metrics endpoint
+         */
+    void updateSaturationMetrics();
+
     void unloadModelComponents();
 
     /**
@@ -530,12 +1379,39 @@ public:
 
     void unsubscribe(PipelineDefinition& pd);
 
+    /**
+         * @brief Moves pipelines subscribed to replaced instance of the same version and notifies them
+         */
+    void takeOverSubscriptions(ModelInstance& replaced);
+
     const ModelChangeSubscription& getSubscribtionManager() const { return subscriptionManager; }
 
     Status performInference(InferenceEngine::InferRequest& inferRequest);
 
     virtual Status infer(const tensorflow::serving::PredictRequest* requestProto,
         tensorflow::serving::PredictResponse* responseProto,
-        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr);
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+        const RequestContext& context = RequestContext());
+
+    /**
+         * @brief Starts inference without blocking the calling thread
+         *
+         * Response is serialized from OpenVINO completion callback which then invokes the callback
+         * with the final status. Request and response have to outlive the callback invocation.
+         * Ownership of the unload guard is taken over until the callback returns.
+         *
+         * @param requestProto
+         * @param responseProto
+         * @param modelUnloadGuardPtr
+         * @param callback invoked exactly once when OK status is returned
+         * @param context priority and deadline used while waiting for infer request
+         *
+         * @return Status of validation, deserialization and inference start
+         */
+    Status inferAsync(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+        infer_completion_callback_t callback,
+        const RequestContext& context = RequestContext());
 };
 }  // namespace ovms
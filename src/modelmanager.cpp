@@ -16,10 +16,13 @@
 #include "modelmanager.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <sstream>
 #include <unordered_map>
 #include <utility>
@@ -34,6 +37,7 @@
 
 #include "azurefilesystem.hpp"
 #include "config.hpp"
+#include "cpu_budget.hpp"
 #include "custom_node_library_manager.hpp"
 #include "customloaders.hpp"
 #include "entry_node.hpp"  // need for ENTRY_NODE_NAME
@@ -48,40 +52,152 @@
 #include "pipelinedefinition.hpp"
 #include "s3filesystem.hpp"
 #include "schema.hpp"
+#include "startupprofiler.hpp"
+#include "workerpool.hpp"
 
 namespace ovms {
 
 static uint16_t MAX_CONFIG_JSON_READ_RETRY_COUNT = 2;
 static bool watcherStarted = false;
+// Time without filesystem events after which changes are checked, so that files being copied are checked once
+static const int FILE_SYSTEM_EVENTS_DEBOUNCE_MS = 500;
+// Limits delay of the check when watched directories are modified continuously
+static const int FILE_SYSTEM_EVENTS_MAX_DEBOUNCE_ROUNDS = 10;
+
+// generations are unique across manager instances so a cached snapshot is never taken for another manager's one
+static std::atomic<uint64_t> servablesSnapshotGenerationCounter{0};
+
+struct CachedServablesSnapshot {
+    uint64_t generation = 0;
+    std::shared_ptr<const ServablesSnapshot> snapshot;
+};
+static thread_local CachedServablesSnapshot cachedServablesSnapshot;
 
 ModelManager::ModelManager() :
     waitForModelLoadedTimeoutMs(DEFAULT_WAIT_FOR_MODEL_LOADED_TIMEOUT_MS) {
     this->customNodeLibraryManager = std::make_unique<CustomNodeLibraryManager>();
 }
 
-ModelManager::~ModelManager() = default;
+ModelManager::~ModelManager() {
+    stopBlacklistEventsThread();
+    // release models held by snapshot cached in this thread
+    cachedServablesSnapshot = CachedServablesSnapshot();
+}
+
+void ModelManager::updateModelMetrics() {
+    std::vector<std::shared_ptr<ModelInstance>> instances;
+    {
+        std::shared_lock modelsLock(modelsMtx);
+        for (const auto& [name, model] : models) {
+            for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+                auto instance = model->getModelInstanceByVersion(version);
+                if (instance) {
+                    instances.push_back(std::move(instance));
+                }
+            }
+        }
+    }
+    for (auto& instance : instances) {
+        instance->updateMemoryMetrics();
+        instance->updateSaturationMetrics();
+    }
+}
+
+void ModelManager::publishServablesSnapshot() {
+    auto snapshot = std::make_shared<ServablesSnapshot>();
+    {
+        std::shared_lock modelsLock(modelsMtx);
+        for (const auto& [name, model] : models) {
+            auto& entry = snapshot->models[name];
+            entry.model = model;
+            for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+                auto instance = model->getModelInstanceByVersion(version);
+                if (instance) {
+                    entry.versions.emplace(version, std::move(instance));
+                }
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(servablesSnapshotMtx);
+    servablesSnapshot = std::move(snapshot);
+    servablesSnapshotGeneration = ++servablesSnapshotGenerationCounter;
+}
+
+const ServablesSnapshot* ModelManager::getServablesSnapshot() const {
+    if (cachedServablesSnapshot.generation != servablesSnapshotGeneration.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(servablesSnapshotMtx);
+        cachedServablesSnapshot.snapshot = servablesSnapshot;
+        cachedServablesSnapshot.generation = servablesSnapshotGeneration;
+    }
+    return cachedServablesSnapshot.snapshot.get();
+}
 
 Status ModelManager::start() {
     auto& config = ovms::Config::instance();
     watcherIntervalSec = config.filesystemPollWaitSeconds();
     sequenceCleanerIntervalMinutes = config.sequenceCleanerPollWaitMinutes();
+    backgroundCpus = config.backgroundCpus();
+    modelLoadWorkers = config.modelLoadWorkers();
+    modelsMemoryBudgetBytes = config.modelsMemoryBudgetMb() * 1024 * 1024;
+    remoteListingTtlSec = config.remoteListingTtlSeconds();
+    versionSwapPolicy = config.versionSwapPolicy() == "serial" ? VersionSwapPolicy::SERIAL : config.versionSwapPolicy() == "auto" ? VersionSwapPolicy::AUTO : VersionSwapPolicy::OVERLAP;
+    auto& profiler = StartupProfiler::instance();
+    const auto startupProfilePath = config.startupProfilePath();
+    if (!startupProfilePath.empty()) {
+        profiler.start();
+    }
+    const auto startTime = StartupProfiler::clock_t::now();
     Status status;
     if (config.configPath() != "") {
         status = startFromFile(config.configPath());
     } else {
         status = startFromConfig();
     }
+    if (!startupProfilePath.empty()) {
+        profiler.addEvent("start", "startup", startTime, StartupProfiler::clock_t::now(), {{"status", status.string()}});
+        // failing to write the profile is logged and does not stop the server
+        profiler.stop(startupProfilePath);
+    }
     if (!status.ok()) {
         SPDLOG_LOGGER_ERROR(modelmanager_logger, "Couldn't start model manager");
         return status;
     }
+    startupCompleted = true;
+    SPDLOG_LOGGER_INFO(modelmanager_logger, "Model manager started, server is ready");
     startWatcher();
     return status;
 }
 
+bool ModelManager::isReady() const {
+    if (startupCompleted) {
+        return true;
+    }
+    std::set<std::string> models;
+    {
+        std::lock_guard<std::mutex> lock(loadingModelsMtx);
+        models = criticalModels;
+    }
+    if (models.empty()) {
+        return false;
+    }
+    for (const auto& name : models) {
+        auto instance = findModelInstance(name);
+        if (!instance || instance->getStatus().getState() != ModelVersionState::AVAILABLE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModelManager::isModelLoadPending(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(loadingModelsMtx);
+    return pendingModels.find(name) != pendingModels.end();
+}
+
 void ModelManager::startWatcher() {
     if ((!watcherStarted) && (watcherIntervalSec > 0)) {
         std::future<void> exitSignal = exitTrigger.get_future();
+        fileSystemWatcher = std::make_unique<FileSystemWatcher>();
         std::thread t(std::thread(&ModelManager::watcher, this, std::move(exitSignal)));
         watcherStarted = true;
         monitor = std::move(t);
@@ -91,7 +207,7 @@ void ModelManager::startWatcher() {
 }
 
 void ModelManager::startSequenceCleaner() {
-    globalSequencesViewer.startCleanerThread(sequenceCleanerIntervalMinutes);
+    globalSequencesViewer.startCleanerThread(sequenceCleanerIntervalMinutes, backgroundCpus);
 }
 
 Status ModelManager::startFromConfig() {
@@ -150,7 +266,12 @@ Status ModelManager::startFromConfig() {
         modelConfig.setBatchSize(0);
     }
 
-    return reloadModelWithVersions(modelConfig);
+    if (modelConfig.isDeviceUsed("CPU")) {
+        CpuBudget::instance().setModelWeights({{modelConfig.getName(), modelConfig.getSchedulingWeight()}});
+    }
+    status = reloadModelWithVersions(modelConfig);
+    publishServablesSnapshot();
+    return status;
 }
 
 Status ModelManager::startFromFile(const std::string& jsonFilename) {
@@ -186,6 +307,30 @@ void processNodeInputs(const std::string nodeName, const rapidjson::Value::Const
     }
 }
 
+void processNodeCondition(const std::string& nodeName, const rapidjson::Value& condition, pipeline_connections_t& connections) {
+    const std::string sourceNodeName = condition["node_name"].GetString();
+    const std::string sourceOutputName = condition["data_item"].GetString();
+    SPDLOG_DEBUG("Node: {} will run only when output: {} of SourceNode: {} is not zero", nodeName, sourceOutputName, sourceNodeName);
+    connections[nodeName][sourceNodeName].push_back({sourceOutputName, NODE_CONDITION_INPUT_NAME});
+}
+
+alternative_sources_t getPipelineOutputsAlternativeSources(const rapidjson::Value::ConstMemberIterator& pipelineOutputsItr) {
+    alternative_sources_t sources;
+    for (const auto& pipelineOutput : pipelineOutputsItr->value.GetArray()) {
+        for (const auto& objectNameValue : pipelineOutput.GetObject()) {
+            auto& nodeNames = sources[objectNameValue.name.GetString()];
+            const std::string sourceNodeName = objectNameValue.value.GetObject()["node_name"].GetString();
+            if (std::find(nodeNames.begin(), nodeNames.end(), sourceNodeName) == nodeNames.end()) {
+                nodeNames.push_back(sourceNodeName);
+            }
+        }
+    }
+    for (auto it = sources.begin(); it != sources.end();) {
+        it = it->second.size() > 1 ? std::next(it) : sources.erase(it);
+    }
+    return sources;
+}
+
 void processPipelineInputs(const rapidjson::Value::ConstMemberIterator& pipelineInputsPtr, const std::string& nodeName, std::unordered_map<std::string, std::string>& nodeOutputNameAlias, const std::string& pipelineName) {
     for (const auto& pipelineInput : pipelineInputsPtr->value.GetArray()) {
         const std::string pipelineInputName = pipelineInput.GetString();
@@ -213,6 +358,34 @@ void processDLNodeConfig(const rapidjson::Value& nodeConfig, DLNodeInfo& info) {
     if (nodeConfig.HasMember("version")) {
         info.modelVersion = nodeConfig["version"].GetUint64();
     }
+    if (nodeConfig.HasMember("batch_shards")) {
+        info.batchShards = nodeConfig["batch_shards"].GetBool();
+    }
+    if (nodeConfig.HasMember("roi_inputs")) {
+        for (const auto& roiInput : nodeConfig["roi_inputs"].GetObject()) {
+            info.roiInputs.emplace(roiInput.name.GetString(), roiInput.value.GetString());
+        }
+    }
+    if (nodeConfig.HasMember("bind_outputs")) {
+        info.bindOutputs = nodeConfig["bind_outputs"].GetBool();
+    }
+}
+
+void processRemoteNodeConfig(const rapidjson::Value& nodeConfig, DLNodeInfo& info, RemoteModelInfo& remoteInfo) {
+    info.modelName = nodeConfig["model_name"].GetString();
+    if (nodeConfig.HasMember("version")) {
+        info.modelVersion = nodeConfig["version"].GetUint64();
+    }
+    remoteInfo.address = nodeConfig["address"].GetString();
+    if (nodeConfig.HasMember("connections")) {
+        remoteInfo.connections = nodeConfig["connections"].GetUint();
+    }
+    if (nodeConfig.HasMember("compression")) {
+        remoteInfo.compression = nodeConfig["compression"].GetString();
+    }
+    if (nodeConfig.HasMember("timeout_ms")) {
+        remoteInfo.timeoutMs = nodeConfig["timeout_ms"].GetUint();
+    }
 }
 
 #define IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status) \
@@ -255,6 +428,9 @@ Status processPipelineConfig(rapidjson::Document& configJson, const rapidjson::V
 
     std::vector<NodeInfo> info;
     NodeInfo entryInfo{NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {}, demultiplyCountEntry};
+    if (pipelineConfig.HasMember("max_in_flight_shards")) {
+        entryInfo.maxInFlightShards = pipelineConfig["max_in_flight_shards"].GetUint();
+    }
     info.emplace_back(std::move(entryInfo));
     processPipelineInputs(pipelineConfig.FindMember("inputs"), ENTRY_NODE_NAME, info[0].outputNameAliases, pipelineName);
     pipeline_connections_t connections;
@@ -274,8 +450,11 @@ Status processPipelineConfig(rapidjson::Document& configJson, const rapidjson::V
 
         DLNodeInfo dlNodeInfo;
         CustomNodeInfo customNodeInfo;
+        RemoteModelInfo remoteModelInfo;
         if (nodeKind == NodeKind::DL) {
             processDLNodeConfig(nodeConfig, dlNodeInfo);
+        } else if (nodeKind == NodeKind::REMOTE) {
+            processRemoteNodeConfig(nodeConfig, dlNodeInfo, remoteModelInfo);
         } else if (nodeKind == NodeKind::CUSTOM) {
             status = processCustomNodeConfig(nodeConfig, customNodeInfo, pipelineName, manager);
             if (!status.ok()) {
@@ -304,6 +483,14 @@ Status processPipelineConfig(rapidjson::Document& configJson, const rapidjson::V
             gatherFromNode.insert(nodeToGatherFrom);
             gatheredDemultiplexerNodes.insert(nodeToGatherFrom);
         }
+        if (dlNodeInfo.batchShards && demultiplyCount) {
+            SPDLOG_LOGGER_WARN(modelmanager_logger, "Pipeline: {} node: {} is demultiplexer, batch_shards setting is ignored", pipelineName, nodeName);
+            dlNodeInfo.batchShards = false;
+        }
+        if (dlNodeInfo.batchShards && !dlNodeInfo.roiInputs.empty()) {
+            SPDLOG_LOGGER_WARN(modelmanager_logger, "Pipeline: {} node: {} has roi_inputs, batch_shards setting is ignored", pipelineName, nodeName);
+            dlNodeInfo.batchShards = false;
+        }
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Creating node: {} type: {} model_name: {} modelVersion: {}",
             nodeName, nodeKindStr, dlNodeInfo.modelName, dlNodeInfo.modelVersion.value_or(0));
         info.emplace_back(
@@ -315,9 +502,19 @@ Status processPipelineConfig(rapidjson::Document& configJson, const rapidjson::V
             demultiplyCount,
             gatherFromNode,
             customNodeInfo.library,
-            customNodeInfo.parameters);
+            customNodeInfo.parameters,
+            dlNodeInfo.batchShards,
+            dlNodeInfo.roiInputs,
+            dlNodeInfo.bindOutputs);
+        if (nodeConfig.HasMember("cache_size_mb")) {
+            info.back().outputCacheSizeMb = nodeConfig["cache_size_mb"].GetUint();
+        }
+        info.back().remote = std::move(remoteModelInfo);
         auto nodeInputItr = nodeConfig.FindMember("inputs");
         processNodeInputs(nodeName, nodeInputItr, connections);
+        if (nodeConfig.HasMember("condition")) {
+            processNodeCondition(nodeName, nodeConfig["condition"], connections);
+        }
     }
     const auto iteratorOutputs = pipelineConfig.FindMember("outputs");
     // pipeline outputs are node exit inputs
@@ -326,7 +523,9 @@ Status processPipelineConfig(rapidjson::Document& configJson, const rapidjson::V
     std::set_difference(demultiplexerNodes.begin(), demultiplexerNodes.end(),
         gatheredDemultiplexerNodes.begin(), gatheredDemultiplexerNodes.end(),
         std::inserter(nonGatheredDemultiplexerNodes, nonGatheredDemultiplexerNodes.begin()));
-    info.emplace_back(std::move(NodeInfo(NodeKind::EXIT, EXIT_NODE_NAME, "", std::nullopt, {}, std::nullopt, nonGatheredDemultiplexerNodes)));
+    NodeInfo exitInfo(NodeKind::EXIT, EXIT_NODE_NAME, "", std::nullopt, {}, std::nullopt, nonGatheredDemultiplexerNodes);
+    exitInfo.alternativeSources = getPipelineOutputsAlternativeSources(iteratorOutputs);
+    info.emplace_back(std::move(exitInfo));
     if (!factory.definitionExists(pipelineName)) {
         SPDLOG_DEBUG("Pipeline:{} was not loaded so far. Triggering load", pipelineName);
         auto status = factory.createDefinition(pipelineName, info, connections, manager);
@@ -353,9 +552,22 @@ Status ModelManager::loadCustomNodeLibrariesConfig(rapidjson::Document& configJs
     std::set<std::string> librariesInConfig;
     for (const auto& libraryConfig : doc->value.GetArray()) {
         librariesInConfig.emplace(libraryConfig.FindMember("name")->value.GetString());
+        CustomNodeLibraryExecutionConfig executionConfig;
+        if (libraryConfig.HasMember("max_concurrency")) {
+            executionConfig.maxConcurrency = libraryConfig["max_concurrency"].GetUint();
+        }
+        if (libraryConfig.HasMember("worker_threads")) {
+            executionConfig.workerThreads = libraryConfig["worker_threads"].GetUint();
+        }
+        if (libraryConfig.HasMember("cpu_affinity")) {
+            for (const auto& cpu : libraryConfig["cpu_affinity"].GetArray()) {
+                executionConfig.cpuAffinity.emplace_back(cpu.GetInt());
+            }
+        }
         this->customNodeLibraryManager->loadLibrary(
             libraryConfig.FindMember("name")->value.GetString(),
-            libraryConfig.FindMember("base_path")->value.GetString());
+            libraryConfig.FindMember("base_path")->value.GetString(),
+            executionConfig);
     }
     this->customNodeLibraryManager->unloadLibrariesRemovedFromConfig(librariesInConfig);
     return StatusCode::OK;
@@ -415,6 +627,20 @@ Status ModelManager::createCustomLoader(CustomLoaderConfig& loaderConfig) {
             return StatusCode::CUSTOM_LOADER_INIT_FAILED;
         }
         customloaders.add(loaderName, customLoaderIfPtr, handleCL);
+        // queue is shared with the callback, since loader may outlive the manager
+        auto events = blacklistEvents;
+        bool pushing = customLoaderIfPtr->registerBlacklistCallback(
+            [events, loaderName](const std::string& modelName, const int version, const CustomLoaderStatus status) {
+                CustomLoaders::instance().updateBlacklistStatus(loaderName, modelName, version, status);
+                events->push(modelName);
+            });
+        if (pushing) {
+            SPDLOG_LOGGER_INFO(modelmanager_logger, "Custom loader: {} pushes blacklist changes", loaderName);
+            customloaders.setBlacklistPushing(loaderName);
+            if (!blacklistEventsThread.joinable()) {
+                blacklistEventsThread = std::thread(&ModelManager::blacklistEventsHandler, this);
+            }
+        }
     } else {
         // Loader is already in the existing loaders. Move it to new loaders.
         // Reload of customloader is not supported yet
@@ -465,6 +691,7 @@ Status ModelManager::loadModelsConfig(rapidjson::Document& configJson, std::vect
     std::set<std::string> modelsInConfigFile;
     std::set<std::string> modelsWithInvalidConfig;
     std::unordered_map<std::string, ModelConfig> newModelConfigs;
+    std::vector<ModelConfig> modelConfigsToLoad;
     for (const auto& configs : itr->value.GetArray()) {
         ModelConfig modelConfig;
         auto status = modelConfig.parseNode(configs["config"]);
@@ -486,10 +713,43 @@ Status ModelManager::loadModelsConfig(rapidjson::Document& configJson, std::vect
             SPDLOG_LOGGER_WARN(modelmanager_logger, "Duplicated model names: {} defined in config file. Only first definition will be loaded.", modelName);
             continue;
         }
-        status = reloadModelWithVersions(modelConfig);
-        IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
-
         modelsInConfigFile.emplace(modelName);
+        modelConfigsToLoad.emplace_back(std::move(modelConfig));
+    }
+    // critical models are loaded first, so the server gets ready before the rest is loaded
+    std::stable_partition(modelConfigsToLoad.begin(), modelConfigsToLoad.end(),
+        [](const ModelConfig& modelConfig) { return modelConfig.isCritical(); });
+    {
+        std::lock_guard<std::mutex> lock(loadingModelsMtx);
+        criticalModels.clear();
+        for (const auto& modelConfig : modelConfigsToLoad) {
+            if (modelConfig.isCritical()) {
+                criticalModels.insert(modelConfig.getName());
+            }
+            if (findModelByName(modelConfig.getName()) == nullptr) {
+                pendingModels.insert(modelConfig.getName());
+            }
+        }
+    }
+    std::map<std::string, uint32_t> cpuModelWeights;
+    for (const auto& modelConfig : modelConfigsToLoad) {
+        if (modelConfig.isDeviceUsed("CPU")) {
+            cpuModelWeights.emplace(modelConfig.getName(), modelConfig.getSchedulingWeight());
+        }
+    }
+    CpuBudget::instance().setModelWeights(std::move(cpuModelWeights));
+    // models are independent of each other, so they can be compiled concurrently
+    std::vector<Status> statuses;
+    reloadModelsWithVersions(modelConfigsToLoad, statuses);
+    {
+        std::lock_guard<std::mutex> lock(loadingModelsMtx);
+        pendingModels.clear();
+    }
+    for (size_t i = 0; i < modelConfigsToLoad.size(); ++i) {
+        auto& modelConfig = modelConfigsToLoad[i];
+        const auto modelName = modelConfig.getName();
+        const auto& status = statuses[i];
+        IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
         if (!status.ok()) {
             SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Cannot reload model: {} with versions due to error: {}", modelName, status.string());
         }
@@ -511,6 +771,40 @@ Status ModelManager::loadModelsConfig(rapidjson::Document& configJson, std::vect
     return firstErrorStatus;
 }
 
+void ModelManager::reloadModelsWithVersions(std::vector<ModelConfig>& modelConfigs, std::vector<Status>& statuses) {
+    std::vector<ModelConfig*> modelConfigsPtrs;
+    modelConfigsPtrs.reserve(modelConfigs.size());
+    for (auto& modelConfig : modelConfigs) {
+        modelConfigsPtrs.push_back(&modelConfig);
+    }
+    reloadModelsWithVersions(modelConfigsPtrs, statuses);
+}
+
+void ModelManager::reloadModelsWithVersions(const std::vector<ModelConfig*>& modelConfigs, std::vector<Status>& statuses) {
+    statuses.assign(modelConfigs.size(), StatusCode::OK);
+    const size_t workersCount = std::min<size_t>(std::max<uint32_t>(modelLoadWorkers, 1), modelConfigs.size());
+    if (workersCount <= 1) {
+        for (size_t i = 0; i < modelConfigs.size(); ++i) {
+            statuses[i] = reloadModelWithVersions(*modelConfigs[i]);
+        }
+        return;
+    }
+    SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Loading {} models using {} threads", modelConfigs.size(), workersCount);
+    std::atomic<size_t> nextModelIndex{0};
+    std::vector<std::thread> workers;
+    workers.reserve(workersCount);
+    for (size_t i = 0; i < workersCount; ++i) {
+        workers.emplace_back([this, &modelConfigs, &statuses, &nextModelIndex]() {
+            for (size_t index = nextModelIndex++; index < modelConfigs.size(); index = nextModelIndex++) {
+                statuses[index] = reloadModelWithVersions(*modelConfigs[index]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
 Status ModelManager::tryReloadGatedModelConfigs(std::vector<ModelConfig>& gatedModelConfigs) {
     Status firstErrorStatus = StatusCode::OK;
     for (auto& modelConfig : gatedModelConfigs) {
@@ -611,11 +905,15 @@ Status ModelManager::loadConfig(const std::string& jsonFilename) {
     if (!status.ok()) {
         IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
     }
+    auto& profiler = StartupProfiler::instance();
+    auto phaseStart = StartupProfiler::clock_t::now();
     std::vector<ModelConfig> gatedModelConfigs;
     status = loadModelsConfig(configJson, gatedModelConfigs);
     if (!status.ok()) {
         IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
     }
+    profiler.addEvent("load_models", "startup", phaseStart, StartupProfiler::clock_t::now());
+    phaseStart = StartupProfiler::clock_t::now();
     status = loadCustomNodeLibrariesConfig(configJson);
     if (!status.ok()) {
         IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
@@ -624,10 +922,12 @@ Status ModelManager::loadConfig(const std::string& jsonFilename) {
     if (!status.ok()) {
         IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
     }
+    profiler.addEvent("load_pipelines", "startup", phaseStart, StartupProfiler::clock_t::now());
     status = tryReloadGatedModelConfigs(gatedModelConfigs);
     if (!status.ok()) {
         IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
     }
+    publishServablesSnapshot();
 
     lastLoadConfigStatus = firstErrorStatus;
     return firstErrorStatus;
@@ -663,17 +963,33 @@ void ModelManager::retireModelsRemovedFromConfigFile(const std::set<std::string>
     }
 }
 
-Status ModelManager::updateConfigurationWithoutConfigFile() {
+Status ModelManager::updateConfigurationWithoutConfigFile(bool checkAllModels) {
     std::lock_guard<std::recursive_mutex> loadingLock(configMtx);
     SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Checking if something changed with model versions");
     bool reloadNeeded = false;
     Status firstErrorStatus = StatusCode::OK;
     Status status;
+    const auto now = std::chrono::steady_clock::now();
+    std::map<std::string, std::chrono::steady_clock::time_point> nextCheckTimes;
+    std::vector<ModelConfig*> configsToCheck;
     for (auto& [name, config] : servedModelConfigs) {
-        status = reloadModelWithVersions(config);
-        if (!status.ok()) {
-            IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
-        } else if (status == StatusCode::OK_RELOADED) {
+        auto it = nextVersionsCheckTimes.find(name);
+        if (!checkAllModels && it != nextVersionsCheckTimes.end() && now < it->second) {
+            nextCheckTimes.emplace(name, it->second);
+            continue;
+        }
+        nextCheckTimes.emplace(name, now + std::chrono::seconds(config.getVersionPollIntervalSeconds()));
+        configsToCheck.push_back(&config);
+    }
+    // entries of models removed from config are dropped
+    nextVersionsCheckTimes = std::move(nextCheckTimes);
+    // slow cloud storage listings do not delay checks of other models
+    std::vector<Status> statuses;
+    reloadModelsWithVersions(configsToCheck, statuses);
+    for (const auto& modelStatus : statuses) {
+        if (!modelStatus.ok()) {
+            IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(modelStatus);
+        } else if (modelStatus == StatusCode::OK_RELOADED) {
             reloadNeeded = true;
         }
     }
@@ -681,6 +997,9 @@ Status ModelManager::updateConfigurationWithoutConfigFile() {
     if (!status.ok()) {
         IF_ERROR_NOT_OCCURRED_EARLIER_THEN_SET_FIRST_ERROR(status);
     }
+    if (reloadNeeded) {
+        publishServablesSnapshot();
+    }
 
     if (!firstErrorStatus.ok()) {
         return firstErrorStatus;
@@ -714,10 +1033,64 @@ Status ModelManager::configFileReloadNeeded(bool& isNeeded) {
     return StatusCode::OK;
 }
 
+bool ModelManager::getWatchedDirectories(std::set<std::string>& directories) {
+    std::lock_guard<std::recursive_mutex> loadingLock(configMtx);
+    if (configFilename != "") {
+        auto configDirectory = std::filesystem::path(configFilename).parent_path();
+        directories.insert(configDirectory.empty() ? "." : configDirectory.string());
+    }
+    for (const auto& [name, config] : servedModelConfigs) {
+        const auto& basePath = config.getBasePath();
+        if (basePath.find("://") != std::string::npos) {
+            return false;
+        }
+        directories.insert(basePath);
+        // Files copied to version directories are watched, so that version is checked after copying finishes
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(basePath, ec)) {
+            if (entry.is_directory(ec)) {
+                directories.insert(entry.path().string());
+            }
+        }
+    }
+    for (const auto& directory : directories) {
+        if (!FileSystemWatcher::isWatchable(directory)) {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Directory: {} is on network filesystem, changes are polled", directory);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModelManager::waitForFileSystemChanges(std::future<void>& exitSignal, bool& changesNotified) {
+    std::set<std::string> directories;
+    changesNotified = false;
+    if (!fileSystemWatcher || !fileSystemWatcher->isValid() ||
+        !getWatchedDirectories(directories) || !fileSystemWatcher->watchDirectories(directories)) {
+        return exitSignal.wait_for(std::chrono::seconds(watcherIntervalSec)) == std::future_status::timeout;
+    }
+    if (fileSystemWatcher->waitForChanges(-1, FILE_SYSTEM_EVENTS_DEBOUNCE_MS)) {
+        changesNotified = true;
+        // Directories created by the change are watched as well until they are not modified anymore
+        int debounceRounds = 0;
+        do {
+            directories.clear();
+            if (!getWatchedDirectories(directories)) {
+                break;
+            }
+            fileSystemWatcher->watchDirectories(directories);
+        } while (++debounceRounds < FILE_SYSTEM_EVENTS_MAX_DEBOUNCE_ROUNDS &&
+                 fileSystemWatcher->waitForChanges(FILE_SYSTEM_EVENTS_DEBOUNCE_MS, FILE_SYSTEM_EVENTS_DEBOUNCE_MS));
+    }
+    return exitSignal.wait_for(std::chrono::seconds(0)) == std::future_status::timeout;
+}
+
 void ModelManager::watcher(std::future<void> exitSignal) {
     SPDLOG_LOGGER_INFO(modelmanager_logger, "Started model manager thread");
+    WorkerPool::pinCurrentThread(backgroundCpus);
 
-    while (exitSignal.wait_for(std::chrono::seconds(watcherIntervalSec)) == std::future_status::timeout) {
+    bool changesNotified = false;
+    while (waitForFileSystemChanges(exitSignal, changesNotified)) {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Models configuration and filesystem check cycle begin");
         std::lock_guard<std::recursive_mutex> loadingLock(configMtx);
         bool isNeeded;
@@ -725,16 +1098,59 @@ void ModelManager::watcher(std::future<void> exitSignal) {
         if (isNeeded) {
             loadConfig(configFilename);
         }
-        updateConfigurationWithoutConfigFile();
+        updateConfigurationWithoutConfigFile(changesNotified);
 
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Models configuration and filesystem check cycle end");
     }
     SPDLOG_LOGGER_INFO(modelmanager_logger, "Stopped model manager thread");
 }
 
+void ModelManager::blacklistEventsHandler() {
+    SPDLOG_LOGGER_INFO(modelmanager_logger, "Started custom loaders blacklist events thread");
+    WorkerPool::pinCurrentThread(backgroundCpus);
+    while (true) {
+        std::set<std::string> modelNames{blacklistEvents->pull()};
+        // changes pushed in bursts are applied together
+        while (auto name = blacklistEvents->tryPull(0)) {
+            modelNames.insert(name.value());
+        }
+        if (modelNames.count("")) {
+            break;
+        }
+        std::lock_guard<std::recursive_mutex> loadingLock(configMtx);
+        bool reloadNeeded = false;
+        for (const auto& name : modelNames) {
+            auto it = servedModelConfigs.find(name);
+            if (it == servedModelConfigs.end()) {
+                continue;
+            }
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Applying blacklist change of model: {}", name);
+            auto status = reloadModelWithVersions(it->second);
+            if (status == StatusCode::OK_RELOADED) {
+                reloadNeeded = true;
+            }
+        }
+        if (reloadNeeded) {
+            pipelineFactory.revalidatePipelines(*this);
+            publishServablesSnapshot();
+        }
+    }
+    SPDLOG_LOGGER_INFO(modelmanager_logger, "Stopped custom loaders blacklist events thread");
+}
+
+void ModelManager::stopBlacklistEventsThread() {
+    if (blacklistEventsThread.joinable()) {
+        blacklistEvents->push("");
+        blacklistEventsThread.join();
+    }
+}
+
 void ModelManager::join() {
     if (watcherStarted) {
         exitTrigger.set_value();
+        if (fileSystemWatcher) {
+            fileSystemWatcher->interrupt();
+        }
         if (monitor.joinable()) {
             monitor.join();
             watcherStarted = false;
@@ -742,6 +1158,7 @@ void ModelManager::join() {
         }
     }
 
+    stopBlacklistEventsThread();
     globalSequencesViewer.join();
 }
 
@@ -772,7 +1189,7 @@ void ModelManager::getVersionsToChange(
             // check existing version for blacklist
             for (const auto& [version, versionInstance] : modelVersionsInstances) {
                 SPDLOG_LOGGER_DEBUG(modelmanager_logger, "The model {} checking for blacklist", versionInstance->getName());
-                CustomLoaderStatus bres = loaderPtr->getModelBlacklistStatus(versionInstance->getName(), version);
+                CustomLoaderStatus bres = customloaders.getModelBlacklistStatus(loaderName, *loaderPtr, versionInstance->getName(), version);
                 if (bres != CustomLoaderStatus::OK) {
                     SPDLOG_LOGGER_INFO(modelmanager_logger, "The model {} is blacklisted", versionInstance->getName());
                     requestedVersions.erase(std::remove(requestedVersions.begin(), requestedVersions.end(), version), requestedVersions.end());
@@ -881,6 +1298,18 @@ Status ModelManager::readAvailableVersions(std::shared_ptr<FileSystem>& fs, cons
         return StatusCode::PATH_INVALID;
     }
 
+    // Listing cloud storage is billed and slow, unchanged listing is reused for remote_listing_ttl_seconds
+    const bool cacheListing = remoteListingTtlSec > 0 && base.find("://") != std::string::npos;
+    if (cacheListing) {
+        std::lock_guard<std::mutex> lock(remoteListingsMtx);
+        auto it = remoteListings.find(base);
+        if (it != remoteListings.end() &&
+            std::chrono::steady_clock::now() - it->second.time < std::chrono::seconds(remoteListingTtlSec)) {
+            versions = it->second.versions;
+            return StatusCode::OK;
+        }
+    }
+
     auto status = fs->isDirectory(base, &is_directory);
     if (status != StatusCode::OK) {
         SPDLOG_LOGGER_ERROR(modelmanager_logger, "Couldn't check directory: {}", base);
@@ -918,9 +1347,18 @@ Status ModelManager::readAvailableVersions(std::shared_ptr<FileSystem>& fs, cons
         SPDLOG_LOGGER_WARN(modelmanager_logger, "No version found for model in path: {}", base);
     }
 
+    if (cacheListing) {
+        std::lock_guard<std::mutex> lock(remoteListingsMtx);
+        remoteListings[base] = {std::chrono::steady_clock::now(), versions};
+    }
     return StatusCode::OK;
 }
 
+void ModelManager::invalidateRemoteListings() {
+    std::lock_guard<std::mutex> lock(remoteListingsMtx);
+    remoteListings.clear();
+}
+
 Status ModelManager::addModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToStart, std::shared_ptr<model_versions_t> versionsFailed) {
     Status status = StatusCode::OK;
     try {
@@ -1024,6 +1462,27 @@ Status ModelManager::reloadModelWithVersions(ModelConfig& config) {
         reloadNeeded = true;
     }
     std::set<ovms::model_version_t> allFailedVersions;
+    std::shared_ptr<model_versions_t> versionsRetiredFirst;
+    // versions compiled from scratch, reloaded available versions are checked separately
+    model_versions_t versionsToLoad = *versionsToStart;
+    for (const auto version : *versionsToReload) {
+        auto instance = model->getModelInstanceByVersion(version);
+        if (instance && instance->getStatus().getState() != ModelVersionState::AVAILABLE) {
+            versionsToLoad.push_back(version);
+        }
+    }
+    if (versionsToLoad.size() > 0 && versionsToRetire->size() > 0 && isSerialVersionSwapRequired(*model, versionsToLoad, *versionsToRetire)) {
+        // retiring waits for in-flight inferences of the versions, new requests go to remaining versions or fail until new ones are loaded
+        SPDLOG_LOGGER_INFO(modelmanager_logger, "Model: {} versions to retire are unloaded before new versions are loaded", config.getName());
+        auto status = model->retireVersions(versionsToRetire);
+        if (!status.ok()) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Error occurred while unloading model: {}; versions; error: {}",
+                config.getName(),
+                status.string());
+            return status;
+        }
+        versionsRetiredFirst = versionsToRetire;
+    }
     while (versionsToStart->size() > 0) {
         blocking_status = addModelVersions(model, fs, config, versionsToStart, versionsFailed);
         SPDLOG_LOGGER_TRACE(modelmanager_logger, "Adding new versions. Status: {};", blocking_status.string());
@@ -1043,6 +1502,7 @@ Status ModelManager::reloadModelWithVersions(ModelConfig& config) {
     }
 
     if (versionsToReload->size() > 0) {
+        model->setVersionReplacementEnabled(!isSerialVersionSwapRequired(*model, *versionsToReload, *versionsToReload));
         auto status = reloadModelVersions(model, fs, config, versionsToReload, versionsFailed);
         if (!status.ok()) {
             blocking_status = status;
@@ -1059,6 +1519,20 @@ Status ModelManager::reloadModelWithVersions(ModelConfig& config) {
     // refresh versions to retire based on failed reloads
     requestedVersions = config.getModelVersionPolicy()->filter(availableVersions);
     getVersionsToChange(config, model->getModelVersions(), requestedVersions, versionsToStart, versionsToReload, versionsToRetire);
+    if (versionsRetiredFirst && !allFailedVersions.empty()) {
+        // versions unloaded first and requested again in place of failed ones are loaded back
+        auto versionsToLoadBack = std::make_shared<model_versions_t>();
+        std::copy_if(versionsRetiredFirst->begin(), versionsRetiredFirst->end(), std::back_inserter(*versionsToLoadBack), [&](auto& version) {
+            return std::find(versionsToReload->begin(), versionsToReload->end(), version) != versionsToReload->end();
+        });
+        if (versionsToLoadBack->size() > 0) {
+            SPDLOG_LOGGER_WARN(modelmanager_logger, "Model: {} new versions failed to load, loading back unloaded versions", config.getName());
+            auto status = reloadModelVersions(model, fs, config, versionsToLoadBack, versionsFailed);
+            if (!status.ok()) {
+                blocking_status = status;
+            }
+        }
+    }
     std::shared_ptr<model_versions_t> versionsToCleanup = std::make_shared<model_versions_t>();
     std::copy_if(versionsToRetire->begin(), versionsToRetire->end(), std::back_inserter(*versionsToCleanup), [&](auto& version) { return allFailedVersions.find(version) != allFailedVersions.end(); });
     versionsToRetire->erase(std::remove_if(versionsToRetire->begin(), versionsToRetire->end(), [&](auto& version) { return allFailedVersions.find(version) != allFailedVersions.end(); }), versionsToRetire->end());
@@ -1100,23 +1574,217 @@ Status ModelManager::getModelInstance(const std::string& modelName,
     std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuardPtr) {
     SPDLOG_DEBUG("Requesting model: {}; version: {}.", modelName, modelVersionId);
 
-    auto model = findModelByName(modelName);
-    if (model == nullptr) {
-        return StatusCode::MODEL_NAME_MISSING;
+    modelInstance.reset();
+    const ModelInstance* unloadedInstance = nullptr;
+    const auto* snapshot = getServablesSnapshot();
+    if (snapshot != nullptr) {
+        auto modelIt = snapshot->models.find(modelName);
+        if (modelIt != snapshot->models.end()) {
+            const auto version = modelVersionId != 0 ? modelVersionId : modelIt->second.model->getDefaultVersion();
+            auto versionIt = modelIt->second.versions.find(version);
+            if (versionIt != modelIt->second.versions.end()) {
+                if (versionIt->second->getStatus().willEndUnloaded()) {
+                    // instance may have been replaced by reload after snapshot was published
+                    unloadedInstance = versionIt->second.get();
+                } else {
+                    modelInstance = versionIt->second;
+                }
+            }
+        }
     }
-    if (modelVersionId != 0) {
-        modelInstance = model->getModelInstanceByVersion(modelVersionId);
-        if (modelInstance == nullptr) {
-            return StatusCode::MODEL_VERSION_MISSING;
+    if (modelInstance == nullptr) {
+        // servable may have been added or replaced after snapshot was published
+        auto model = findModelByName(modelName);
+        if (model == nullptr) {
+            return isModelLoadPending(modelName) ? StatusCode::MODEL_VERSION_NOT_LOADED_YET : StatusCode::MODEL_NAME_MISSING;
         }
-    } else {
-        modelInstance = model->getDefaultModelInstance();
-        if (modelInstance == nullptr) {
-            return StatusCode::MODEL_VERSION_MISSING;
+        if (modelVersionId != 0) {
+            modelInstance = model->getModelInstanceByVersion(modelVersionId);
+            if (modelInstance == nullptr) {
+                return StatusCode::MODEL_VERSION_MISSING;
+            }
+        } else {
+            modelInstance = model->getDefaultModelInstance();
+            if (modelInstance == nullptr) {
+                return StatusCode::MODEL_VERSION_MISSING;
+            }
+        }
+        if (modelInstance.get() != unloadedInstance) {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Model: {}; version: {} missing in servables snapshot, publishing new one", modelName, modelInstance->getVersion());
+            publishServablesSnapshot();
+        }
+    }
+
+    if (!modelInstance->isLoadedOnDemand()) {
+        auto status = modelInstance->waitForLoaded(waitForModelLoadedTimeoutMs, modelInstanceUnloadGuardPtr);
+        if (status == StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE) {
+            // instance could have been replaced by reload in the meantime
+            auto model = findModelByName(modelName);
+            auto current = model == nullptr ? nullptr : modelVersionId != 0 ? model->getModelInstanceByVersion(modelVersionId) : model->getDefaultModelInstance();
+            if (current != nullptr && current != modelInstance) {
+                modelInstance = std::move(current);
+                status = modelInstance->waitForLoaded(waitForModelLoadedTimeoutMs, modelInstanceUnloadGuardPtr);
+            }
+        }
+        return status;
+    }
+    modelInstance->updateLastUsedTime();
+    auto status = loadModelVersionOnDemand(*modelInstance);
+    if (!status.ok()) {
+        return status;
+    }
+    status = modelInstance->waitForLoaded(waitForModelLoadedTimeoutMs, modelInstanceUnloadGuardPtr);
+    if (status == StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE) {
+        // version could have been unloaded due to memory budget in the meantime
+        status = loadModelVersionOnDemand(*modelInstance);
+        if (!status.ok()) {
+            return status;
+        }
+        status = modelInstance->waitForLoaded(waitForModelLoadedTimeoutMs, modelInstanceUnloadGuardPtr);
+    }
+    return status;
+}
+
+Status ModelManager::loadModelVersionOnDemand(ModelInstance& modelInstance) {
+    if (modelInstance.getStatus().getState() == ModelVersionState::AVAILABLE) {
+        return StatusCode::OK;
+    }
+    auto status = modelInstance.loadModelOnDemand();
+    if (!status.ok()) {
+        return status;
+    }
+    evictIdleModelVersions(modelInstance);
+    return StatusCode::OK;
+}
+
+uint64_t ModelManager::getAvailableMemoryBytes() const {
+    uint64_t available = 0;
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    uint64_t value;
+    std::string unit;
+    while (meminfo >> key >> value >> unit) {
+        if (key == "MemAvailable:") {
+            available = value * 1024;
+            break;
+        }
+    }
+    // cgroup v2 and v1 limits, unlimited cgroups report max or a value above physical memory
+    for (const auto& [limitFile, usageFile] : {std::make_pair("/sys/fs/cgroup/memory.max", "/sys/fs/cgroup/memory.current"),
+             std::make_pair("/sys/fs/cgroup/memory/memory.limit_in_bytes", "/sys/fs/cgroup/memory/memory.usage_in_bytes")}) {
+        std::ifstream limitStream(limitFile);
+        std::ifstream usageStream(usageFile);
+        uint64_t limit = 0;
+        uint64_t usage = 0;
+        if (!(limitStream >> limit) || !(usageStream >> usage)) {
+            continue;
+        }
+        const uint64_t headroom = limit > usage ? limit - usage : 0;
+        if (available == 0 || headroom < available) {
+            available = headroom;
+        }
+        break;
+    }
+    return available;
+}
+
+bool ModelManager::isSerialVersionSwapRequired(const Model& model, const model_versions_t& versionsToLoad, const model_versions_t& versionsReplaced) const {
+    if (versionSwapPolicy == VersionSwapPolicy::OVERLAP) {
+        return false;
+    }
+    if (versionSwapPolicy == VersionSwapPolicy::SERIAL) {
+        return true;
+    }
+    uint64_t largestFootprint = 0;
+    for (const auto version : versionsReplaced) {
+        auto instance = model.getModelInstanceByVersion(version);
+        if (instance && instance->getStatus().getState() == ModelVersionState::AVAILABLE) {
+            largestFootprint = std::max(largestFootprint, instance->getMemoryFootprint());
+        }
+    }
+    if (largestFootprint == 0) {
+        return false;
+    }
+    const uint64_t required = largestFootprint * VERSION_SWAP_MEMORY_FACTOR * versionsToLoad.size();
+    const uint64_t available = getAvailableMemoryBytes();
+    if (available == 0) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Available memory is unknown, model: {} versions are swapped with overlap", model.getName());
+        return false;
+    }
+    SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Model: {} new versions need estimated: {} bytes; available: {} bytes", model.getName(), required, available);
+    return required > available;
+}
+
+void ModelManager::evictIdleModelVersions(const ModelInstance& requestedInstance) {
+    if (modelsMemoryBudgetBytes == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> evictionLock(evictionMtx);
+    uint64_t loadedMemory = 0;
+    std::vector<std::shared_ptr<ModelInstance>> candidates;
+    {
+        std::shared_lock modelsLock(modelsMtx);
+        for (const auto& [name, model] : models) {
+            for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+                auto instance = model->getModelInstanceByVersion(version);
+                if (!instance || instance->getStatus().getState() != ModelVersionState::AVAILABLE) {
+                    continue;
+                }
+                loadedMemory += instance->getMemoryFootprint();
+                // versions used by pipelines are kept to avoid invalidating pipelines
+                if (instance->isLoadedOnDemand() && instance.get() != &requestedInstance && !instance->getSubscribtionManager().isSubscribed()) {
+                    candidates.push_back(instance);
+                }
+            }
+        }
+    }
+    if (loadedMemory <= modelsMemoryBudgetBytes) {
+        return;
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->getLastUsedTime() < rhs->getLastUsedTime();
+    });
+    for (auto& candidate : candidates) {
+        if (loadedMemory <= modelsMemoryBudgetBytes) {
+            break;
+        }
+        const auto footprint = candidate->getMemoryFootprint();
+        if (candidate->evict()) {
+            loadedMemory -= std::min(footprint, loadedMemory);
         }
     }
+    if (loadedMemory > modelsMemoryBudgetBytes) {
+        SPDLOG_LOGGER_WARN(modelmanager_logger, "Loaded models use: {} bytes which exceeds models memory budget: {} bytes. No more idle versions can be unloaded",
+            loadedMemory, modelsMemoryBudgetBytes);
+    }
+}
 
-    return modelInstance->waitForLoaded(waitForModelLoadedTimeoutMs, modelInstanceUnloadGuardPtr);
+bool ModelManager::routeToFallback(std::shared_ptr<ovms::ModelInstance>& modelInstance,
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuardPtr) {
+    const auto& config = modelInstance->getModelConfig();
+    if (!config.isFallbackEnabled()) {
+        return false;
+    }
+    const size_t waiting = modelInstance->getInferRequestsQueue().getWaitersCount();
+    if (waiting < config.getFallbackQueueDepth()) {
+        return false;
+    }
+    std::shared_ptr<ovms::ModelInstance> fallbackInstance;
+    std::unique_ptr<ModelInstanceUnloadGuard> fallbackUnloadGuard;
+    auto status = getModelInstance(config.getFallbackModelName(), config.getFallbackModelVersion(), fallbackInstance, fallbackUnloadGuard);
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Fallback model: {}; version: {} of overloaded model: {} is not available: {}",
+            config.getFallbackModelName(), config.getFallbackModelVersion(), modelInstance->getName(), status.string());
+        return false;
+    }
+    if (fallbackInstance->getInferRequestsQueue().getWaitersCount() >= waiting) {
+        return false;
+    }
+    SPDLOG_DEBUG("Model: {}; version: {} has {} waiting requests, request is routed to fallback model: {}; version: {}",
+        modelInstance->getName(), modelInstance->getVersion(), waiting, fallbackInstance->getName(), fallbackInstance->getVersion());
+    modelInstance = std::move(fallbackInstance);
+    modelInstanceUnloadGuardPtr = std::move(fallbackUnloadGuard);
+    return true;
 }
 
 Status ModelManager::getPipeline(std::unique_ptr<ovms::Pipeline>& pipelinePtr,
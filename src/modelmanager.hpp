@@ -15,9 +15,12 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 #include <string>
@@ -33,17 +36,47 @@
 
 #include "customloaders.hpp"
 #include "filesystem.hpp"
+#include "filesystem_watcher.hpp"
 #include "global_sequences_viewer.hpp"
 #include "model.hpp"
 #include "pipeline.hpp"
 #include "pipeline_factory.hpp"
+#include "threadsafequeue.hpp"
 
 namespace ovms {
 
 const uint32_t DEFAULT_WAIT_FOR_MODEL_LOADED_TIMEOUT_MS = 10000;
+const uint64_t VERSION_SWAP_MEMORY_FACTOR = 2;
+
+/**
+ * @brief How new versions replace retired ones
+ *
+ * OVERLAP loads and warms up new versions while retired ones keep serving, SERIAL unloads retired versions first,
+ * AUTO overlaps when available memory fits the new versions and serializes otherwise.
+ */
+enum class VersionSwapPolicy {
+    OVERLAP,
+    SERIAL,
+    AUTO
+};
 
 class IVersionReader;
 class CustomNodeLibraryManager;
+
+/**
+ * @brief Immutable view of served models and their versions, used to resolve servables without locking
+ *
+ * Models and versions are never removed from ModelManager, only retired, so a stale snapshot
+ * can only miss servables added after it was published.
+ */
+struct ServablesSnapshot {
+    struct ModelEntry {
+        std::shared_ptr<Model> model;
+        std::map<model_version_t, std::shared_ptr<ModelInstance>> versions;
+    };
+    std::unordered_map<std::string, ModelEntry> models;
+};
+
 /**
  * @brief Model manager is managing the list of model topologies enabled for serving and their versions.
  */
@@ -71,6 +104,63 @@ protected:
     GlobalSequencesViewer globalSequencesViewer;
     uint32_t waitForModelLoadedTimeoutMs;
 
+    /**
+     * Number of threads loading models from config file concurrently
+     */
+    uint32_t modelLoadWorkers = 1;
+
+    /**
+     * Memory budget for all loaded model versions in bytes, 0 means no limit
+     */
+    uint64_t modelsMemoryBudgetBytes = 0;
+
+    /**
+     * Time for which versions listed in cloud storage are reused, 0 means listing on every check
+     */
+    uint remoteListingTtlSec = 0;
+
+    /**
+     * Policy of replacing retired versions with new ones
+     */
+    VersionSwapPolicy versionSwapPolicy = VersionSwapPolicy::OVERLAP;
+
+    /**
+     * @brief Gets memory available to the server, the lower of system available memory and cgroup limit headroom
+     *
+     * @return bytes, 0 if unknown
+     */
+    virtual uint64_t getAvailableMemoryBytes() const;
+
+    /**
+     * @brief Checks whether versions being replaced have to be unloaded before new ones are loaded
+     *
+     * Memory needed by a new version is estimated as VERSION_SWAP_MEMORY_FACTOR times the footprint of the largest
+     * loaded version being replaced, since reading the network and compiling it keep two copies of weights for a while.
+     *
+     * @param model
+     * @param versionsToLoad versions to start or reload
+     * @param versionsReplaced versions to retire or reload
+     *
+     * @return bool
+     */
+    bool isSerialVersionSwapRequired(const Model& model, const model_versions_t& versionsToLoad, const model_versions_t& versionsReplaced) const;
+
+    /**
+     * @brief Loads version with lazy loading enabled and unloads least recently used idle versions exceeding the memory budget
+     *
+     * @param modelInstance
+     *
+     * @return Status
+     */
+    Status loadModelVersionOnDemand(ModelInstance& modelInstance);
+
+    /**
+     * @brief Unloads least recently used versions with lazy loading enabled until loaded versions fit the memory budget
+     *
+     * @param requestedInstance version which is kept loaded
+     */
+    void evictIdleModelVersions(const ModelInstance& requestedInstance);
+
 private:
     /**
      * @brief Private copying constructor
@@ -98,6 +188,31 @@ private:
      */
     void watcher(std::future<void> exitSignal);
 
+    /**
+     * @brief Waits until the next check of config and model versions
+     *
+     * Waits for filesystem events when config file and all model base paths are on local filesystems,
+     * otherwise waits for the watcher interval.
+     *
+     * @param exitSignal
+     * @param changesNotified set when woken up by filesystem events, so all model base paths have to be checked
+     *
+     * @return false if watcher has to exit
+     */
+    bool waitForFileSystemChanges(std::future<void>& exitSignal, bool& changesNotified);
+
+    /**
+     * @brief Gets directories of config file, model base paths and their versions
+     *
+     * @return false if any of them cannot be watched for filesystem events
+     */
+    bool getWatchedDirectories(std::set<std::string>& directories);
+
+    /**
+     * @brief Detects changes of local directories for watcher thread
+     */
+    std::unique_ptr<FileSystemWatcher> fileSystemWatcher;
+
     /**
      * @brief A JSON configuration filename
      */
@@ -113,12 +228,46 @@ private:
      */
     std::promise<void> exitTrigger;
 
+    /**
+     * @brief Names of models with blacklist status pushed by custom loaders, empty name stops the thread
+     */
+    std::shared_ptr<ThreadSafeQueue<std::string>> blacklistEvents = std::make_shared<ThreadSafeQueue<std::string>>();
+
+    /**
+     * @brief A thread reloading models affected by pushed blacklist changes
+     */
+    std::thread blacklistEventsThread;
+
+    /**
+     * @brief Reloads versions of models named in blacklistEvents until stopped
+     */
+    void blacklistEventsHandler();
+
+    /**
+     * @brief Stops and joins blacklistEventsThread
+     */
+    void stopBlacklistEventsThread();
+
     /**
      * @brief A current configurations of models
      * 
      */
     std::unordered_map<std::string, ModelConfig> servedModelConfigs;
 
+    /**
+     * @brief Applies model configs on up to modelLoadWorkers threads, each model is loaded by one thread
+     *
+     * @param modelConfigs
+     * @param statuses results of reloadModelWithVersions for respective model configs
+     */
+    void reloadModelsWithVersions(std::vector<ModelConfig>& modelConfigs, std::vector<Status>& statuses);
+    void reloadModelsWithVersions(const std::vector<ModelConfig*>& modelConfigs, std::vector<Status>& statuses);
+
+    /**
+     * @brief Time after which base path of served model is checked again for version changes, guarded by configMtx
+     */
+    std::map<std::string, std::chrono::steady_clock::time_point> nextVersionsCheckTimes;
+
     /**
      * @brief Retires models non existing in config file
      *
@@ -141,17 +290,74 @@ private:
      */
     uint32_t sequenceCleanerIntervalMinutes = 5;
 
+    /**
+     * CPU cores config watcher, custom loaders blacklist and sequence cleaner threads are pinned to, empty if not pinned
+     */
+    std::vector<int> backgroundCpus;
+
+    /**
+     * @brief Mutex for serializing unloading of idle versions
+     */
+    std::mutex evictionMtx;
+
+    struct RemoteListing {
+        std::chrono::steady_clock::time_point time;
+        model_versions_t versions;
+    };
+
+    /**
+     * @brief Versions listed in cloud storage base paths, guarded by remoteListingsMtx
+     */
+    std::map<std::string, RemoteListing> remoteListings;
+    std::mutex remoteListingsMtx;
+
+    /**
+     * @brief Latest published servables snapshot, guarded by servablesSnapshotMtx
+     */
+    std::shared_ptr<const ServablesSnapshot> servablesSnapshot;
+
+    /**
+     * @brief Unique id of latest published snapshot, 0 if none, threads reload their cached snapshot when it changes
+     */
+    std::atomic<uint64_t> servablesSnapshotGeneration = 0;
+
+    mutable std::mutex servablesSnapshotMtx;
+
+    /**
+     * @brief Gets snapshot cached by calling thread, takes the lock only when a new snapshot was published
+     *
+     * @return snapshot valid until next call in the same thread, nullptr if none was published
+     */
+    const ServablesSnapshot* getServablesSnapshot() const;
+
     /**
      * @brief Time of last config change
      */
     timespec lastConfigChangeTime;
 
+    /**
+     * @brief Set when initial config was loaded by start
+     */
+    std::atomic<bool> startupCompleted = false;
+
+    /**
+     * @brief Models from config file not created yet and critical models of the config file, guarded by loadingModelsMtx
+     */
+    std::set<std::string> pendingModels;
+    std::set<std::string> criticalModels;
+    mutable std::mutex loadingModelsMtx;
+
 public:
     /**
      * @brief Mutex for blocking concurrent add & find of model
      */
     mutable std::shared_mutex modelsMtx;
 
+    /**
+     * @brief Publishes snapshot of currently served models and versions for lock free lookups
+     */
+    void publishServablesSnapshot();
+
     /**
      * @brief Gets the instance of ModelManager
      */
@@ -208,11 +414,30 @@ public:
      */
     const std::shared_ptr<Model> findModelByName(const std::string& name) const;
 
+    /**
+     * @brief Reports memory usage and saturation of all model versions at metrics endpoint
+     */
+    void updateModelMetrics();
+
     Status getModelInstance(const std::string& modelName,
         ovms::model_version_t modelVersionId,
         std::shared_ptr<ovms::ModelInstance>& modelInstance,
         std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuardPtr);
 
+    /**
+     * @brief Replaces model instance with instance of its fallback model while requests wait for its infer requests
+     *
+     * Instance is replaced when at least fallback queue depth requests are waiting for infer request of the model
+     * and fewer requests are waiting for the fallback model. New requests return to the model once its queue drains.
+     *
+     * @param modelInstance instance obtained with getModelInstance, replaced by fallback instance
+     * @param modelInstanceUnloadGuardPtr guard of modelInstance, replaced by guard of fallback instance
+     *
+     * @return true if request is to be served by fallback instance
+     */
+    bool routeToFallback(std::shared_ptr<ovms::ModelInstance>& modelInstance,
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuardPtr);
+
     Status getPipeline(std::unique_ptr<ovms::Pipeline>& pipelinePtr,
         const tensorflow::serving::PredictRequest* request,
         tensorflow::serving::PredictResponse* response);
@@ -287,6 +512,24 @@ public:
      */
     Status start();
 
+    /**
+     * @brief Checks if server is ready to serve requests
+     *
+     * Ready once initial config is loaded, or earlier when all models marked critical in config file have available default version.
+     *
+     * @return bool
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Checks if model from config file is going to be loaded but was not created yet
+     *
+     * @param name of the model
+     *
+     * @return bool
+     */
+    bool isModelLoadPending(const std::string& name) const;
+
     /**
      * @brief Starts monitoring as new thread
      * 
@@ -354,8 +597,17 @@ public:
 
     /**
      * @brief Updates OVMS configuration with cached configuration file. Will check for newly added model versions
+     *
+     * Base paths of models are checked concurrently on up to model_load_workers threads.
+     *
+     * @param checkAllModels when false, models checked earlier than version_poll_interval_seconds ago are skipped
+     */
+    Status updateConfigurationWithoutConfigFile(bool checkAllModels = true);
+
+    /**
+     * @brief Drops cached listings of cloud storage, so that next check lists versions again
      */
-    Status updateConfigurationWithoutConfigFile();
+    void invalidateRemoteListings();
 };
 
 }  // namespace ovms
@@ -15,6 +15,8 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <unordered_map>
@@ -81,6 +83,8 @@ class ModelVersionStatus {
     model_version_t version;
     ModelVersionState state;
     ModelVersionStatusErrorCode errorCode;
+    std::string details;
+    std::string loadTimes;
 
 public:
     ModelVersionStatus() = default;
@@ -91,6 +95,7 @@ public:
         state(state),
         errorCode(ModelVersionStatusErrorCode::OK) {
         logStatus();
+        countChange();
     }
 
     ModelVersionState getState() const {
@@ -109,6 +114,37 @@ public:
         return ModelVersionStatusErrorCodeToString(this->errorCode);
     }
 
+    /**
+     * @brief Additional information about loaded version reported with its status, e.g. auto tuning result
+     */
+    const std::string& getDetails() const {
+        return this->details;
+    }
+
+    void setDetails(const std::string& details) {
+        this->details = details;
+        countChange();
+    }
+
+    /**
+     * @brief Durations of phases of the last load of version, e.g. "read_network 35.1 ms, compile 420.7 ms, total 460.2 ms"
+     */
+    const std::string& getLoadTimes() const {
+        return this->loadTimes;
+    }
+
+    void setLoadTimes(const std::string& loadTimes) {
+        this->loadTimes = loadTimes;
+        countChange();
+    }
+
+    /**
+     * @brief Number of changes of statuses of all versions, responses built from statuses stay valid until it changes
+     */
+    static uint64_t getChangesCount() {
+        return changesCount().load();
+    }
+
     /**
      * @brief Check if current state is state that is either transforming to END or already in that state.
      *
@@ -127,6 +163,7 @@ public:
         state = ModelVersionState::LOADING;
         errorCode = error_code;
         logStatus();
+        countChange();
     }
 
     void setAvailable(ModelVersionStatusErrorCode error_code = ModelVersionStatusErrorCode::OK) {
@@ -134,6 +171,7 @@ public:
         state = ModelVersionState::AVAILABLE;
         errorCode = error_code;
         logStatus();
+        countChange();
     }
 
     void setUnloading(ModelVersionStatusErrorCode error_code = ModelVersionStatusErrorCode::OK) {
@@ -141,6 +179,7 @@ public:
         state = ModelVersionState::UNLOADING;
         errorCode = error_code;
         logStatus();
+        countChange();
     }
 
     void setEnd(ModelVersionStatusErrorCode error_code = ModelVersionStatusErrorCode::OK) {
@@ -148,9 +187,20 @@ public:
         state = ModelVersionState::END;
         errorCode = error_code;
         logStatus();
+        countChange();
     }
 
 private:
+    static std::atomic<uint64_t>& changesCount() {
+        static std::atomic<uint64_t> count{0};
+        return count;
+    }
+
+    // counted after the change so that reader which got the count before it does not keep stale response
+    static void countChange() {
+        changesCount().fetch_add(1);
+    }
+
     void logStatus() {
         SPDLOG_INFO("STATUS CHANGE: Version {} of model {} status change. New status: ( \"state\": \"{}\", \"error_code\": \"{}\" )",
             this->version,
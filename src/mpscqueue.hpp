@@ -0,0 +1,162 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <utility>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace ovms {
+
+/**
+ * @brief Lock-free queue with many producers and single consumer
+ *
+ * Producers link nodes with single atomic exchange, so they never wait for each other nor for the consumer.
+ * Consumer which finds queue empty announces it sleeps and waits on futex, producers make wake up syscall
+ * only when they see the announcement. The same interface as ThreadSafeQueue, but pulling from
+ * more than one thread at a time is not allowed.
+ */
+template <typename T>
+class MPSCQueue {
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    // producers append after head, consumer takes after tail which is always consumed or stub node
+    std::atomic<Node*> head;
+    Node* tail;
+    std::atomic<int32_t> sleeping{0};
+
+public:
+    MPSCQueue() {
+        tail = new Node();
+        head.store(tail, std::memory_order_relaxed);
+    }
+
+    ~MPSCQueue() {
+        while (tail != nullptr) {
+            Node* next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    void push(const T& element) {
+        Node* node = new Node();
+        node->value.emplace(element);
+        link(node);
+    }
+
+    void push(T&& element) {
+        Node* node = new Node();
+        node->value.emplace(std::move(element));
+        link(node);
+    }
+
+    T pull() {
+        while (true) {
+            auto element = tryPop();
+            if (element) {
+                return std::move(element.value());
+            }
+            wait(nullptr);
+        }
+    }
+
+    template <typename Clock, typename Duration>
+    std::optional<T> tryPullUntil(const std::chrono::time_point<Clock, Duration>& deadline) {
+        while (true) {
+            auto element = tryPop();
+            if (element) {
+                return element;
+            }
+            const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now());
+            if (remaining.count() <= 0) {
+                return std::nullopt;
+            }
+            struct timespec timeout;
+            timeout.tv_sec = remaining.count() / 1'000'000'000;
+            timeout.tv_nsec = remaining.count() % 1'000'000'000;
+            wait(&timeout);
+        }
+    }
+
+    std::optional<T> tryPull(const uint waitDurationMicroseconds) {
+        return tryPullUntil(std::chrono::steady_clock::now() + std::chrono::microseconds(waitDurationMicroseconds));
+    }
+
+    /**
+     * @brief Gets number of queued elements, may be called only by consumer
+     */
+    size_t size() {
+        size_t count = 0;
+        for (Node* node = tail->next.load(std::memory_order_acquire); node != nullptr; node = node->next.load(std::memory_order_acquire)) {
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    void link(Node* node) {
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        // sequentially consistent with consumer announcing sleep, so either consumer sees the node or producer sees the announcement
+        previous->next.store(node, std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_seq_cst) != 0 && sleeping.exchange(0, std::memory_order_seq_cst) != 0) {
+            syscall(SYS_futex, reinterpret_cast<int32_t*>(&sleeping), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+
+    /**
+     * @brief Takes first element without waiting
+     *
+     * Element whose producer swapped head but did not link it yet is not visible, the producer wakes consumer after linking.
+     */
+    std::optional<T> tryPop() {
+        Node* next = tail->next.load(std::memory_order_seq_cst);
+        if (next == nullptr) {
+            return std::nullopt;
+        }
+        std::optional<T> element{std::move(next->value)};
+        next->value.reset();
+        delete tail;
+        tail = next;
+        return element;
+    }
+
+    void wait(const struct timespec* timeout) {
+        sleeping.store(1, std::memory_order_seq_cst);
+        if (tail->next.load(std::memory_order_seq_cst) != nullptr) {
+            sleeping.store(0, std::memory_order_relaxed);
+            return;
+        }
+        // returns immediately if producer has already reset the announcement, timeout and spurious wake ups are rechecked by caller
+        syscall(SYS_futex, reinterpret_cast<int32_t*>(&sleeping), FUTEX_WAIT_PRIVATE, 1, timeout, nullptr, 0);
+        sleeping.store(0, std::memory_order_relaxed);
+    }
+};
+}  // namespace ovms
@@ -16,15 +16,18 @@
 #include "node.hpp"
 
 #include <algorithm>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <vector>
 
+#include "blob_view_allocator.hpp"
 #include "logging.hpp"
 #include "nodesession.hpp"
 #include "ov_utils.hpp"
 #include "status.hpp"
 #include "tensorinfo.hpp"
+#include "timer.hpp"
 
 const uint64_t DEMULTIPLY_LIMIT = 10'000;
 
@@ -60,7 +63,35 @@ Status Node::fetchResults(session_key_t sessionId, SessionResults& nodeSessionOu
         SPDLOG_LOGGER_ERROR(dag_executor_logger, "Could not find session: {} for node: {}", sessionId, getName());
         return StatusCode::UNKNOWN_ERROR;
     }
-    auto status = fetchResults(*nodeSession, nodeSessionOutputs);
+    if (nodeSession->isSkipped()) {
+        // following nodes only learn that the session was skipped
+        nodeSessionOutputs.emplace(sessionId, SessionResult{nodeSession->getNodeSessionMetadata(), BlobMap{}});
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Will remove skipped node: {} session: {}", getName(), sessionId);
+        nodeSessions.erase(it);
+        return StatusCode::OK;
+    }
+    Status status;
+    auto& cachedOutputs = nodeSession->getCachedOutputs();
+    if (cachedOutputs) {
+        nodeSessionOutputs.emplace(sessionId, SessionResult{nodeSession->getNodeSessionMetadata(), std::move(cachedOutputs.value())});
+    } else {
+        status = fetchResults(*nodeSession, nodeSessionOutputs);
+        auto& cacheKey = nodeSession->getOutputCacheKey();
+        auto outputsIt = nodeSessionOutputs.find(sessionId);
+        if (status.ok() && cacheKey && outputsIt != nodeSessionOutputs.end()) {
+            outputCache->insert(cacheKey.value(), outputsIt->second.second);
+        }
+    }
+    if (status.ok()) {
+        size_t outputBytes = 0;
+        for (const auto& [sessionKey, metadataBlobsPair] : nodeSessionOutputs) {
+            for (const auto& [blobName, blob] : metadataBlobsPair.second) {
+                outputBytes += blob->byteSize();
+            }
+        }
+        observe(metrics.outputBytes, outputBytes);
+        timings.outputBytes.fetch_add(outputBytes, std::memory_order_relaxed);
+    }
     if (status.ok() && demultiplexCount) {
         SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Will demultiply node: {} outputs with demultiplyCount: {}", getName(), demultiplyCountSettingToString(demultiplexCount));
         status = demultiplyOutputs(nodeSessionOutputs);
@@ -79,6 +110,17 @@ void Node::printNodeConnections(const std::string& nodeName, const std::string&
     SPDLOG_DEBUG(ss.str());
 }
 
+const std::vector<Node::OutputLink>& Node::getOutputLinks() {
+    std::call_once(outputLinksFlag, [this]() {
+        for (const auto& node : next) {
+            for (const auto& [outputName, inputName] : node.get().getMappingByDependency(*this)) {
+                outputLinks.push_back({&node.get(), &outputName, &inputName});
+            }
+        }
+    });
+    return outputLinks;
+}
+
 Status Node::setInputs(const Node& dependency, SessionResults& sessionResults) {
     SPDLOG_LOGGER_DEBUG(dag_executor_logger, "node: {} set inputs from node: {}", getName(), dependency.getName());
     for (auto& [sessionKey, metadataInputsPair] : sessionResults) {
@@ -91,6 +133,26 @@ Status Node::setInputs(const Node& dependency, SessionResults& sessionResults) {
     return StatusCode::OK;
 }
 
+static Status isConditionMet(const InferenceEngine::Blob::Ptr& blob, bool& met) {
+    if (blob->size() != 1) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Condition tensor has: {} elements, expected 1", blob->size());
+        return StatusCode::PIPELINE_INVALID_CONDITION_VALUE;
+    }
+    const char* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const char*>();
+    switch (blob->getTensorDesc().getPrecision()) {
+    case InferenceEngine::Precision::FP32:
+        met = *reinterpret_cast<const float*>(data) != 0.0f;
+        break;
+    case InferenceEngine::Precision::FP16:
+        // sign bit does not make value non zero
+        met = (*reinterpret_cast<const uint16_t*>(data) & 0x7FFF) != 0;
+        break;
+    default:
+        met = std::any_of(data, data + blob->byteSize(), [](char byte) { return byte != 0; });
+    }
+    return StatusCode::OK;
+}
+
 Status Node::setInputs(const Node& dependency, BlobMap& inputs, NodeSessionMetadata& metadata) {
     // mapping for dependency - keeps mapping between dependency output name and this node input name
     const auto& mapping_for_dependency = this->getMappingByDependency(dependency);
@@ -120,6 +182,19 @@ Status Node::setInputs(const Node& dependency, BlobMap& inputs, NodeSessionMetad
                 dependency_output_name);
             return StatusCode::INVALID_MISSING_INPUT;
         }
+        if (current_node_input_name == NODE_CONDITION_INPUT_NAME) {
+            bool conditionMet = false;
+            auto status = isConditionMet(it->second, conditionMet);
+            if (!status.ok()) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "node: {} invalid condition: {} from node: {}", getName(), dependency_output_name, dependency.getName());
+                return status;
+            }
+            if (!conditionMet) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "node: {} session: {} condition not met, it will be skipped", getName(), nodeSession->getSessionKey());
+                nodeSession->skip();
+            }
+            continue;
+        }
         SPDLOG_LOGGER_DEBUG(dag_executor_logger, "node: {} setting required input from node: {}, input name: {}, dependency output name: {}",
             getName(),
             dependency.getName(),
@@ -131,7 +206,88 @@ Status Node::setInputs(const Node& dependency, BlobMap& inputs, NodeSessionMetad
             return status;
         }
     }
-    return nodeSession->notifyFinishedDependency();
+    auto status = nodeSession->notifyFinishedDependency();
+    if (status.ok() && nodeSession->isReady()) {
+        nodeSession->getTimer().stop(NodeSession::INPUTS);
+        const uint64_t inputsWaitUs = nodeSession->getTimer().elapsed<std::chrono::microseconds>(NodeSession::INPUTS);
+        observe(metrics.inputsWaitTime, inputsWaitUs);
+        timings.inputsWaitUs.fetch_add(inputsWaitUs, std::memory_order_relaxed);
+    }
+    return status;
+}
+
+Status Node::setSkippedInputs(const Node& dependency, SessionResults& sessionResults) {
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "node: {} dependency: {} was skipped", getName(), dependency.getName());
+    for (auto& [sessionKey, metadataInputsPair] : sessionResults) {
+        NodeSession* nodeSession = getNodeSession(metadataInputsPair.first);
+        if (!nodeSession) {
+            return StatusCode::INTERNAL_ERROR;
+        }
+        nodeSession->notifySkippedDependency();
+        if (isSkippedWithDependency()) {
+            nodeSession->skip();
+        }
+        auto status = nodeSession->notifyFinishedDependency();
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+bool Node::isSessionSkipped(const session_key_t& sessionKey) const {
+    auto it = nodeSessions.find(sessionKey);
+    return it != nodeSessions.end() && it->second->isSkipped();
+}
+
+bool Node::isSessionReady(const session_key_t& sessionKey) const {
+    auto it = nodeSessions.find(sessionKey);
+    return it != nodeSessions.end() && it->second->isReady();
+}
+
+bool Node::isShardSession(const session_key_t& sessionKey) const {
+    auto it = nodeSessions.find(sessionKey);
+    return it != nodeSessions.end() && it->second->getNodeSessionMetadata().isShard();
+}
+
+void Node::finishSkippedSession(const session_key_t& sessionKey, PipelineEventQueue& notifyEndQueue) {
+    getNodeSession(sessionKey).finishSkipped();
+    notifyEndQueue.push(NodeSessionKeyPair(*this, sessionKey));
+}
+
+bool Node::finishSessionFromCache(const session_key_t& sessionKey, PipelineEventQueue& notifyEndQueue) {
+    if (!outputCache) {
+        return false;
+    }
+    auto& nodeSession = getNodeSession(sessionKey);
+    const uint64_t key = NodeOutputCache::computeKey(nodeSession.peekInputs());
+    BlobMap outputs;
+    if (!outputCache->find(key, outputs)) {
+        nodeSession.setOutputCacheKey(key);
+        return false;
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} outputs found in cache", getName(), sessionKey);
+    nodeSession.finishFromCache(std::move(outputs));
+    notifyEndQueue.push(NodeSessionKeyPair(*this, sessionKey));
+    return true;
+}
+
+InferenceEngine::Blob::Ptr Node::getGatheredInputSlot(const std::string& inputName, const NodeSessionMetadata& dependencyMetadata, const InferenceEngine::TensorDesc& shardDesc) {
+    if (!gatherFrom) {
+        return nullptr;
+    }
+    NodeSession* nodeSession = getNodeSession(dependencyMetadata);
+    if (!nodeSession) {
+        return nullptr;
+    }
+    session_id_t shardId;
+    try {
+        shardId = dependencyMetadata.getShardId(gatherFrom.value());
+    } catch (const std::exception& e) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Failed to get shardId for node: {}", getName());
+        return nullptr;
+    }
+    return nodeSession->getInputSlot(inputName, shardId, shardDesc);
 }
 
 NodeSession& Node::getNodeSession(const session_key_t& sessionKey) const {
@@ -149,8 +305,8 @@ NodeSession* Node::getNodeSession(const NodeSessionMetadata& metadata) {
         try {
             sessionKey = metadata.getSessionKey(gatherFrom.value());
         } catch (const std::exception& e) {
-            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Failed to create collapsed metadata session key for node: {}, incomming session key: {}",
-                getName(), metadata.getSessionKey());
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Failed to create collapsed metadata session key for node: {}, incomming session: {}",
+                getName(), metadata.getSessionName());
             return nullptr;
         }
     } else {
@@ -175,6 +331,7 @@ NodeSession* Node::getNodeSession(const NodeSessionMetadata& metadata) {
         newSessionMetadata = metadata;
     }
     std::unique_ptr<NodeSession> nodeSession = createNodeSession(newSessionMetadata, collapsingDetails);
+    nodeSession->setBlobAllocator(blobAllocator);
     auto emplacePair = nodeSessions.emplace(sessionKey, std::move(nodeSession));
     return emplacePair.first->second.get();
 }
@@ -200,13 +357,25 @@ Status Node::demultiplyOutputs(SessionResults& nodeSessionOutputs) {
         return StatusCode::INTERNAL_ERROR;
     }
     auto& [metadata, blobMap] = nodeSessionOutputs.begin()->second;
-    auto& tensorDesc = blobMap.begin()->second->getTensorDesc();
+    auto countingBlobIt = blobMap.begin();
+    if (demultiplexCount.value() == 0) {
+        // with dynamic demultiplexing blobs with dim[0] equal to 1 are passed to every shard, count is taken from the other ones
+        auto it = std::find_if(blobMap.begin(), blobMap.end(), [](const auto& pair) {
+            return pair.second->getTensorDesc().getDims()[0] != 1;
+        });
+        if (it != blobMap.end()) {
+            countingBlobIt = it;
+        }
+    }
+    auto& tensorDesc = countingBlobIt->second->getTensorDesc();
     if (tensorDesc.getDims()[0] > DEMULTIPLY_LIMIT) {
         SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} - too large dim[0] size: {} of blob: {}. Maximum allowed is: {}",
-            getName(), tensorDesc.getDims()[0], blobMap.begin()->first, DEMULTIPLY_LIMIT);
+            getName(), tensorDesc.getDims()[0], countingBlobIt->first, DEMULTIPLY_LIMIT);
         return StatusCode::PIPELINE_TOO_LARGE_DIMENSION_SIZE_TO_DEMULTIPLY;
     }
     uint32_t resultsDemultiplyCount = tensorDesc.getDims()[0];
+    observe(metrics.shardsCount, resultsDemultiplyCount);
+    timings.shards.fetch_add(resultsDemultiplyCount, std::memory_order_relaxed);
     SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Will demultiply node: {} outputs to: {} shards", getName(), resultsDemultiplyCount);
     std::vector<NodeSessionMetadata> newSessionMetadatas;
     try {
@@ -229,10 +398,17 @@ Status Node::demultiplyOutputs(SessionResults& nodeSessionOutputs) {
                 newDims[0], blobName, demultiplexCount.value());
             return StatusCode::PIPELINE_WRONG_DIMENSION_SIZE_TO_DEMULTIPLY;
         }
+        const bool broadcast = (demultiplexCount.value() == 0) && (newDims[0] == 1) && (resultsDemultiplyCount != 1);
+        if ((demultiplexCount.value() == 0) && !broadcast &&
+            (newDims[0] != resultsDemultiplyCount)) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Wrong dim[0] size: {} of blob: {} expected: {} or 1 to demultiply",
+                newDims[0], blobName, resultsDemultiplyCount);
+            return StatusCode::PIPELINE_WRONG_DIMENSION_SIZE_TO_DEMULTIPLY;
+        }
         if (resultsDemultiplyCount == 0) {
-            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} has no results. Dynamic demultiplexer with demultiply == 0 is not supported yet.", this->getName());
+            auto status = skipToGatheringNodes(metadata);
             nodeSessionOutputs.erase(metadata.getSessionKey());
-            return StatusCode::PIPELINE_DEMULTIPLEXER_NO_RESULTS;
+            return status;
         }
 
         newDims.erase(newDims.begin());
@@ -240,10 +416,14 @@ Status Node::demultiplyOutputs(SessionResults& nodeSessionOutputs) {
             tensorDesc.getPrecision(),
             newDims,
             InferenceEngine::Layout::ANY);
-        const auto step = blob->byteSize() / resultsDemultiplyCount;
+        // every shard of broadcasted blob is a view of its whole memory
+        const auto step = broadcast ? blob->byteSize() : blob->byteSize() / resultsDemultiplyCount;
         for (size_t i = 0; i < newSessionMetadatas.size(); ++i) {
             InferenceEngine::Blob::Ptr dividedBlob;
-            this->createShardedBlob(dividedBlob, dividedBlobDesc, blob, i, step, metadata, blobName);
+            auto status = this->createShardedBlob(dividedBlob, dividedBlobDesc, blob, broadcast ? 0 : i, step, metadata, blobName);
+            if (!status.ok()) {
+                return status;
+            }
             std::stringstream ss;
             ss << "Node: " << getName() << " input demultiplied: " << blobName
                << "; Actual: " << TensorInfo::shapeToString(dividedBlob->getTensorDesc().getDims());
@@ -260,17 +440,66 @@ Status Node::demultiplyOutputs(SessionResults& nodeSessionOutputs) {
     return StatusCode::OK;
 }
 
+Status Node::skipToGatheringNodes(const NodeSessionMetadata& metadata) {
+    if (gatheringNodes.empty()) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} has no results and no node gathers its shards.", this->getName());
+        return StatusCode::PIPELINE_DEMULTIPLEXER_NO_RESULTS;
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} has no results, nodes until gathering are skipped", getName(), metadata.getSessionName());
+    for (auto& node : gatheringNodes) {
+        auto status = node.get().setEmptyGatheredInputs(metadata);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status Node::setEmptyGatheredInputs(const NodeSessionMetadata& metadata) {
+    if (!emptyGatheredInputsInfo || !gatherFrom || gatherFrom->size() != 1) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} cannot gather empty inputs since their shapes are unknown", getName());
+        return StatusCode::PIPELINE_DEMULTIPLEXER_NO_RESULTS;
+    }
+    const auto sessionKey = metadata.getSessionKey();
+    if (nodeSessions.count(sessionKey) > 0) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} already exists while gathering no shards", getName(), sessionKey);
+        return StatusCode::INTERNAL_ERROR;
+    }
+    CollapseDetails collapsingDetails;
+    collapsingDetails.collapsedSessionNames.emplace_back(*gatherFrom->begin());
+    collapsingDetails.collapsedSessionSizes.emplace_back(0);
+    auto nodeSession = createNodeSession(metadata, collapsingDetails);
+    nodeSession->setBlobAllocator(blobAllocator);
+    for (const auto& [inputName, tensorInfo] : *emptyGatheredInputsInfo) {
+        // gathered dimension is 0, so dimensions not known before execution do not change size of the blob
+        const InferenceEngine::TensorDesc desc(tensorInfo->getPrecision(), tensorInfo->getShape(), InferenceEngine::Layout::ANY);
+        InferenceEngine::Blob::Ptr blob;
+        auto status = createSharedBlob(blob, desc);
+        if (!status.ok()) {
+            return status;
+        }
+        status = nodeSession->setInput(inputName, blob, 0);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} gathered no shards", getName(), sessionKey);
+    nodeSessions.emplace(sessionKey, std::move(nodeSession));
+    return StatusCode::OK;
+}
+
 Status Node::createShardedBlob(InferenceEngine::Blob::Ptr& dividedBlob, const InferenceEngine::TensorDesc& dividedBlobDesc, InferenceEngine::Blob::Ptr blob, size_t i, size_t step, const NodeSessionMetadata& metadata, const std::string blobName) {
-    auto status = createSharedBlob(dividedBlob, dividedBlobDesc);
+    // Shards are views into parent blob memory, allocator keeps parent blob alive as long as any shard is used
+    char* shardData = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<char*>() + i * step;
+    auto status = createSharedBlob(dividedBlob, dividedBlobDesc, std::make_shared<BlobViewAllocator>(blob, shardData));
     if (!status.ok()) {
         return status;
     }
     if (dividedBlob->byteSize() != step) {
         SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {}, session: {} created blob: {} have wrong byte size: {}, expected: {}",
-            getName(), metadata.getSessionKey(), blobName, dividedBlob->byteSize(), step);
+            getName(), metadata.getSessionName(), blobName, dividedBlob->byteSize(), step);
         return StatusCode::UNKNOWN_ERROR;
     }
-    memcpy(InferenceEngine::as<InferenceEngine::MemoryBlob>(dividedBlob)->wmap().as<char*>(), InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<char*>() + i * step, step);
     return StatusCode::OK;
 }
 }  // namespace ovms
@@ -15,8 +15,12 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -26,6 +30,8 @@
 
 #include "aliases.hpp"
 #include "blobmap.hpp"
+#include "metrics.hpp"
+#include "node_output_cache.hpp"
 #include "nodesession.hpp"
 #include "nodesessionresult.hpp"
 #include "pipelineeventqueue.hpp"
@@ -33,8 +39,13 @@
 
 namespace ovms {
 
+class TensorInfo;
+
 using BlobNames = std::vector<std::string>;
-using session_key_t = std::string;
+using tensor_map_t = std::map<std::string, std::shared_ptr<TensorInfo>>;
+
+// Node input fed with condition tensor, node session is skipped when its value is zero
+const std::string NODE_CONDITION_INPUT_NAME = "__condition__";
 
 class Node {
 protected:
@@ -46,12 +57,37 @@ protected:
     // Blobs ready and waiting for execution
     std::unordered_map<session_key_t, std::unique_ptr<NodeSession>> nodeSessions;
 
-    // Input/Output name mapping and list of required inputs from previous nodes
-    std::unordered_map<std::string, Aliases> blobNamesMapping;
+    // Input/Output name mapping and list of required inputs from previous nodes, in order of previous nodes
+    std::vector<SharedAliases> previousMappings;
 
     const std::optional<uint32_t> demultiplexCount;
     const std::optional<std::set<std::string>> gatherFrom;
 
+    NodeMetrics metrics;
+
+    /**
+     * @brief Totals of node sessions of pipeline execution the node belongs to, reported for slow requests
+     */
+    struct Timings {
+        std::atomic<uint64_t> sessions{0};
+        std::atomic<uint64_t> inputsWaitUs{0};
+        std::atomic<uint64_t> streamWaitUs{0};
+        std::atomic<uint64_t> executionUs{0};
+        std::atomic<uint64_t> outputBytes{0};
+        std::atomic<uint64_t> shards{0};
+    } timings;
+
+    // Nodes gathering shards of this dynamic demultiplexer, given empty inputs when it yields no shards
+    std::vector<std::reference_wrapper<Node>> gatheringNodes;
+    // Inputs of this gathering node consolidated from no shards, with gathered dimension equal to 0
+    std::shared_ptr<const tensor_map_t> emptyGatheredInputsInfo;
+
+    // memory of intermediate blobs produced by node, default heap allocation when empty
+    std::shared_ptr<InferenceEngine::IAllocator> blobAllocator;
+
+    // outputs of previous sessions by their inputs, shared by pipelines of the same definition, not cached when empty
+    std::shared_ptr<NodeOutputCache> outputCache;
+
 public:
     Node(const std::string& nodeName, std::optional<uint32_t> demultiplyCount = std::nullopt, std::set<std::string> gatherFromNode = {});
 
@@ -59,35 +95,138 @@ public:
 
     const std::string& getName() const { return this->nodeName; }
 
+    void setMetrics(const NodeMetrics& metrics) { this->metrics = metrics; }
+    const NodeMetrics& getMetrics() const { return this->metrics; }
+    const Timings& getTimings() const { return this->timings; }
+
+    void observeStreamWaitTime(uint64_t microseconds) {
+        observe(metrics.streamWaitTime, microseconds);
+        timings.streamWaitUs.fetch_add(microseconds, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Observes execution of node session, custom node executed in batch counts as single session
+     */
+    void observeExecutionTime(uint64_t microseconds) {
+        observe(metrics.executionTime, microseconds);
+        timings.sessions.fetch_add(1, std::memory_order_relaxed);
+        timings.executionUs.fetch_add(microseconds, std::memory_order_relaxed);
+    }
+
+    void setBlobAllocator(std::shared_ptr<InferenceEngine::IAllocator> allocator) { this->blobAllocator = std::move(allocator); }
+    const std::shared_ptr<InferenceEngine::IAllocator>& getBlobAllocator() const { return this->blobAllocator; }
+
+    void setOutputCache(std::shared_ptr<NodeOutputCache> cache) { this->outputCache = std::move(cache); }
+
     virtual Status execute(session_key_t sessionId, PipelineEventQueue& notifyEndQueue) = 0;
     Status fetchResults(session_key_t sessionId, SessionResults& nodeSessionOutputs);
 
 protected:
     virtual Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) = 0;
     Status demultiplyOutputs(SessionResults& nodeSessionOutputs);
+    /**
+     * @brief Hands empty inputs over to nodes gathering shards of demultiplexer session which yielded none
+     */
+    Status skipToGatheringNodes(const NodeSessionMetadata& metadata);
+    /**
+     * @brief Whether session is skipped when its dependency was skipped, instead of running without inputs of the dependency
+     */
+    virtual bool isSkippedWithDependency() const { return true; }
     virtual Status createShardedBlob(InferenceEngine::Blob::Ptr& dividedBlob, const InferenceEngine::TensorDesc& dividedBlobDesc, InferenceEngine::Blob::Ptr blob, size_t i, size_t step, const NodeSessionMetadata& metadata, const std::string blobName);
 
 public:
     Status setInputs(const Node& dependency, BlobMap& inputs, NodeSessionMetadata& metadata);
     Status setInputs(const Node& dependency, SessionResults& inputs);
-
-    virtual void addDependency(Node& node, const Aliases& blobNamesMapping) {
+    /**
+     * @brief Notifies sessions that dependency sessions were skipped and have no outputs
+     */
+    Status setSkippedInputs(const Node& dependency, SessionResults& inputs);
+    bool isSessionSkipped(const session_key_t& sessionKey) const;
+    /**
+     * @brief Checks if session is ready and was not used yet, sessions batched into other session are not ready anymore
+     */
+    bool isSessionReady(const session_key_t& sessionKey) const;
+    bool isShardSession(const session_key_t& sessionKey) const;
+    /**
+     * @brief Finishes skipped session without execution, following nodes are notified when its results are fetched
+     */
+    void finishSkippedSession(const session_key_t& sessionKey, PipelineEventQueue& notifyEndQueue);
+    /**
+     * @brief Finishes ready session without execution if node caches outputs and they are cached for session inputs
+     *
+     * Following nodes are notified when its results are fetched. Otherwise session remembers its cache key,
+     * so that its outputs are cached once fetched.
+     *
+     * @return true if session was finished from cache
+     */
+    bool finishSessionFromCache(const session_key_t& sessionKey, PipelineEventQueue& notifyEndQueue);
+
+    virtual void addDependency(Node& node, SharedAliases blobNamesMapping) {
         this->previous.emplace_back(node);
-        this->blobNamesMapping[node.getName()] = blobNamesMapping;
+        this->previousMappings.emplace_back(std::move(blobNamesMapping));
     }
 
     virtual void addDependant(Node& node) { this->next.emplace_back(node); }
 
-    const Aliases& getMappingByDependency(const Node& dependency) {
-        return blobNamesMapping.at(dependency.getName());
+    /**
+     * @brief Gets mapping of dependency outputs to inputs of this node, dependency is found by identity, not by name
+     *
+     * @throws std::out_of_range if node is not a dependency
+     */
+    const Aliases& getMappingByDependency(const Node& dependency) const {
+        for (size_t i = 0; i < previous.size(); ++i) {
+            if (&previous[i].get() == &dependency) {
+                return *previousMappings[i];
+            }
+        }
+        throw std::out_of_range("node: " + dependency.getName() + " is not a dependency of node: " + getName());
     }
 
+    /**
+     * @brief Output of this node consumed by input of following node
+     *
+     * Names point into mappings shared with the pipeline definition.
+     */
+    struct OutputLink {
+        Node* node;
+        const std::string* outputName;
+        const std::string* inputName;
+    };
+
+    /**
+     * @brief Gets links to inputs of all following nodes, flattened on first call once pipeline is connected
+     *
+     * Sessions iterate the links instead of resolving mapping of every following node by name.
+     */
+    const std::vector<OutputLink>& getOutputLinks();
+
+    /**
+     * @brief Gets blob in consolidated input of gathering node session which dependency can write its session output into
+     *
+     * @return empty pointer if this node does not gather dependency sessions or slot could not be prepared
+     */
+    InferenceEngine::Blob::Ptr getGatheredInputSlot(const std::string& inputName, const NodeSessionMetadata& dependencyMetadata, const InferenceEngine::TensorDesc& shardDesc);
+
     std::vector<session_key_t> getReadySessions() const;
     const std::vector<std::reference_wrapper<Node>>& getNextNodes() {
         return next;
     }
+
+    void addGatheringNode(Node& node) { this->gatheringNodes.emplace_back(node); }
+    const std::vector<std::reference_wrapper<Node>>& getGatheringNodes() const { return gatheringNodes; }
+    void setEmptyGatheredInputsInfo(std::shared_ptr<const tensor_map_t> inputsInfo) { this->emptyGatheredInputsInfo = std::move(inputsInfo); }
+
+    /**
+     * @brief Creates ready session of gathering node with empty inputs, used when demultiplexer yields no shards
+     *
+     * Nodes between demultiplexer and gathering node do not get any session.
+     *
+     * @param metadata metadata of demultiplexer session
+     * @return PIPELINE_DEMULTIPLEXER_NO_RESULTS if shapes of empty inputs are not known
+     */
+    Status setEmptyGatheredInputs(const NodeSessionMetadata& metadata);
     virtual void release(session_key_t sessionId) {}
-    virtual bool tryDisarm(const session_key_t& sessionKey, const uint microseconds = 1) { return true; }
+    virtual void disarm(const session_key_t& sessionKey) {}
 
     static void printNodeConnections(const std::string& nodeName, const std::string& sourceNode, const Aliases& pairs);
 
@@ -95,6 +234,10 @@ protected:
     NodeSession* getNodeSession(const NodeSessionMetadata& metadata);
     NodeSession& getNodeSession(const session_key_t& sessionKey) const;
     virtual std::unique_ptr<NodeSession> createNodeSession(const NodeSessionMetadata& metadata, const CollapseDetails& collapsingDetails);
+
+private:
+    std::once_flag outputLinksFlag;
+    std::vector<OutputLink> outputLinks;
 };
 
 }  // namespace ovms
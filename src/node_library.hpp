@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <inference_engine.hpp>
@@ -23,9 +24,15 @@
 
 namespace ovms {
 
+class CustomNodeExecutor;
+
 typedef int (*execute_fn)(const struct CustomNodeTensor*, int, struct CustomNodeTensor**, int*, const struct CustomNodeParam*, int);
 typedef int (*metadata_fn)(struct CustomNodeTensorInfo**, int*, const struct CustomNodeParam*, int);
 typedef int (*release_fn)(void*);
+typedef int (*execute_with_allocator_fn)(const struct CustomNodeTensor*, int, struct CustomNodeTensor**, int*, const struct CustomNodeParam*, int, const struct CustomNodeAllocator*, void*);
+typedef int (*execute_batch_fn)(const struct CustomNodeTensor**, int, int, struct CustomNodeTensor**, int*, const struct CustomNodeParam*, int, const struct CustomNodeAllocator*, void*);
+typedef int (*initialize_fn)(void**, const struct CustomNodeParam*, int);
+typedef int (*deinitialize_fn)(void*);
 
 struct NodeLibrary {
     execute_fn execute = nullptr;
@@ -35,6 +42,17 @@ struct NodeLibrary {
 
     std::string basePath = "";
 
+    // optional, used instead of execute when library exports it
+    execute_with_allocator_fn executeWithAllocator = nullptr;
+    // optional, called once per pipeline definition load to create and destroy state of node
+    initialize_fn initialize = nullptr;
+    deinitialize_fn deinitialize = nullptr;
+    // optional, executes all ready sessions of node with single call
+    execute_batch_fn executeBatch = nullptr;
+
+    // limits concurrency of executions and runs them on dedicated threads if configured, executions run directly when empty
+    std::shared_ptr<CustomNodeExecutor> executor;
+
     bool isValid() const;
 };
 
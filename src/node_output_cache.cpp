@@ -0,0 +1,125 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "node_output_cache.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "logging.hpp"
+#include "ov_utils.hpp"
+
+namespace ovms {
+
+namespace {
+void combineHash(uint64_t& seed, uint64_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+void combineHash(uint64_t& seed, std::string_view bytes) {
+    combineHash(seed, std::hash<std::string_view>{}(bytes));
+}
+}  // namespace
+
+uint64_t NodeOutputCache::computeKey(const BlobMap& inputs) {
+    // blob map iteration order is unspecified
+    std::vector<const BlobMap::value_type*> sortedInputs;
+    sortedInputs.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        sortedInputs.push_back(&input);
+    }
+    std::sort(sortedInputs.begin(), sortedInputs.end(), [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+
+    uint64_t key = sortedInputs.size();
+    for (const auto* input : sortedInputs) {
+        const auto& blob = input->second;
+        const auto& desc = blob->getTensorDesc();
+        combineHash(key, input->first);
+        combineHash(key, static_cast<uint64_t>(desc.getPrecision()));
+        for (const auto dim : desc.getDims()) {
+            combineHash(key, static_cast<uint64_t>(dim));
+        }
+        const char* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const char*>();
+        combineHash(key, std::string_view(data, blob->byteSize()));
+    }
+    return key;
+}
+
+bool NodeOutputCache::find(uint64_t key, BlobMap& outputs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        misses++;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    outputs = it->second->outputs;
+    hits++;
+    return true;
+}
+
+void NodeOutputCache::insert(uint64_t key, const BlobMap& outputs) {
+    size_t byteSize = 0;
+    for (const auto& [name, blob] : outputs) {
+        byteSize += blob->byteSize();
+    }
+    if (byteSize > capacityBytes) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node outputs of size: {} bytes exceed node output cache capacity: {} bytes", byteSize, capacityBytes);
+        return;
+    }
+    // outputs may be owned by infer request or written into inputs of following nodes, cache keeps own copies
+    BlobMap copies;
+    for (const auto& [name, blob] : outputs) {
+        InferenceEngine::Blob::Ptr copy;
+        auto status = blobClone(copy, blob);
+        if (!status.ok()) {
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Failed to copy node output: {} into node output cache: {}", name, status.string());
+            return;
+        }
+        copies.emplace(name, std::move(copy));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.count(key) > 0) {
+        // concurrent session with the same inputs was stored first
+        return;
+    }
+    while (usedBytes + byteSize > capacityBytes) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Evicting least recently used node outputs from cache of size: {} bytes", capacityBytes);
+        usedBytes -= entries.back().byteSize;
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    entries.push_front(Entry{key, byteSize, std::move(copies)});
+    index.emplace(key, entries.begin());
+    usedBytes += byteSize;
+}
+
+size_t NodeOutputCache::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t NodeOutputCache::getUsedBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return usedBytes;
+}
+
+}  // namespace ovms
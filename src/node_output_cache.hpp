@@ -0,0 +1,89 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "blobmap.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Least recently used cache of pipeline node outputs keyed by hash of node session inputs
+ *
+ * Meant for deterministic nodes, sessions with cached inputs finish without inference or custom node call.
+ * Cache keeps own copies of outputs and is bounded by their size. Cached blobs are shared with following
+ * nodes, which only read their inputs.
+ */
+class NodeOutputCache {
+    struct Entry {
+        uint64_t key;
+        size_t byteSize;
+        BlobMap outputs;
+    };
+
+    const size_t capacityBytes;
+    size_t usedBytes = 0;
+    std::mutex mutex;
+    // most recently used entry first
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+
+    std::atomic<uint64_t> hits = 0;
+    std::atomic<uint64_t> misses = 0;
+
+public:
+    explicit NodeOutputCache(size_t capacityBytes) :
+        capacityBytes(capacityBytes) {}
+
+    /**
+     * @brief Computes cache key from names, precisions, shapes and contents of node session inputs
+     */
+    static uint64_t computeKey(const BlobMap& inputs);
+
+    /**
+     * @brief Gets cached outputs and marks entry as most recently used
+     *
+     * @return true on cache hit
+     */
+    bool find(uint64_t key, BlobMap& outputs);
+
+    /**
+     * @brief Stores copies of outputs evicting least recently used entries when cache is full
+     */
+    void insert(uint64_t key, const BlobMap& outputs);
+
+    size_t size();
+
+    size_t getUsedBytes();
+
+    size_t getCapacityBytes() const {
+        return capacityBytes;
+    }
+
+    uint64_t getHits() const {
+        return hits;
+    }
+
+    uint64_t getMisses() const {
+        return misses;
+    }
+};
+}  // namespace ovms
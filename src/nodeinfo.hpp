@@ -42,22 +42,29 @@ class Pipeline;
 using pipeline_connections_t = std::unordered_map<std::string, std::unordered_map<std::string, Aliases>>;
 using tensor_map_t = std::map<std::string, std::shared_ptr<TensorInfo>>;
 using parameters_t = std::unordered_map<std::string, std::string>;
+// key: model input fed with region of interest, value: input with region coordinates
+using roi_inputs_t = std::unordered_map<std::string, std::string>;
 
 enum class NodeKind {
     ENTRY,
     DL,
     CUSTOM,
+    REMOTE,
     EXIT
 };
 
 const std::string DL_NODE_CONFIG_TYPE = "DL model";
 const std::string CUSTOM_NODE_CONFIG_TYPE = "custom";
+const std::string REMOTE_NODE_CONFIG_TYPE = "Remote model";
 
 Status toNodeKind(const std::string& str, NodeKind& nodeKind);
 
 struct DLNodeInfo {
     std::string modelName;
     std::optional<model_version_t> modelVersion;
+    bool batchShards = false;
+    roi_inputs_t roiInputs;
+    bool bindOutputs = false;
 };
 
 struct CustomNodeInfo {
@@ -65,6 +72,21 @@ struct CustomNodeInfo {
     parameters_t parameters;
 };
 
+struct RemoteModelInfo {
+    // gRPC endpoint of other model server, host:port
+    std::string address;
+    // number of connections to the server, calls are spread over them in turns
+    uint32_t connections = 1;
+    // none, deflate or gzip
+    std::string compression = "none";
+    // 0 means no deadline of remote inference
+    uint32_t timeoutMs = 0;
+
+    bool operator==(const RemoteModelInfo& rhs) const {
+        return address == rhs.address && connections == rhs.connections && compression == rhs.compression && timeoutMs == rhs.timeoutMs;
+    }
+};
+
 struct NodeInfo {
     NodeKind kind;
     std::string nodeName;
@@ -75,6 +97,17 @@ struct NodeInfo {
     std::set<std::string> gatherFromNode;
     NodeLibrary library;
     parameters_t parameters;
+    bool batchShards;
+    roi_inputs_t roiInputs;
+    bool bindOutputs;
+    // set only for exit node
+    alternative_sources_t alternativeSources;
+    // memory limit of node outputs cache, 0 disables caching
+    uint32_t outputCacheSizeMb = 0;
+    // set only for remote model node
+    RemoteModelInfo remote;
+    // set only for entry node, limit of shard sessions executed at once in the pipeline, 0 disables the limit
+    uint32_t maxInFlightShards = 0;
 
     NodeInfo(NodeKind kind,
         const std::string& nodeName,
@@ -84,7 +117,10 @@ struct NodeInfo {
         std::optional<size_t> demultiplyCount = std::nullopt,
         const std::set<std::string>& gatherFromNode = {},
         const NodeLibrary& library = {},
-        const parameters_t& parameters = {}) :
+        const parameters_t& parameters = {},
+        bool batchShards = false,
+        const roi_inputs_t& roiInputs = {},
+        bool bindOutputs = false) :
         kind(kind),
         nodeName(nodeName),
         modelName(modelName),
@@ -93,6 +129,9 @@ struct NodeInfo {
         demultiplyCount(demultiplyCount),
         gatherFromNode(gatherFromNode),
         library(library),
-        parameters(parameters) {}
+        parameters(parameters),
+        batchShards(batchShards),
+        roiInputs(roiInputs),
+        bindOutputs(bindOutputs) {}
 };
 }  // namespace ovms
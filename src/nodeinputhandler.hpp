@@ -35,6 +35,7 @@ protected:
     BlobMap inputBlobs;
     uint32_t remainingDependencies;
     bool isUsed = false;
+    std::shared_ptr<InferenceEngine::IAllocator> blobAllocator;
 
 public:
     NodeInputHandler(uint32_t inputsMissingCount);
@@ -43,9 +44,24 @@ public:
         isUsed = true;
         return inputBlobs;
     }
+    /**
+     * @brief Gets inputs without marking them as used by execution
+     */
+    const BlobMap& peekInputs() const {
+        return inputBlobs;
+    }
+    void setBlobAllocator(std::shared_ptr<InferenceEngine::IAllocator> allocator) {
+        blobAllocator = std::move(allocator);
+    }
     void clearInputs();
     bool isReady();
     virtual Status notifyFinishedDependency();
+    /**
+     * @brief Gets blob which dependency can write input shard into in place, empty when input is not gathered
+     */
+    virtual InferenceEngine::Blob::Ptr getInputSlot(const std::string& inputName, session_id_t shardId, const InferenceEngine::TensorDesc& shardDesc) {
+        return nullptr;
+    }
     virtual ~NodeInputHandler() = default;
 };
 }  // namespace ovms
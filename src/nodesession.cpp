@@ -15,6 +15,8 @@
 //*****************************************************************************
 #include "nodesession.hpp"
 
+#include <utility>
+
 #include "gathernodeinputhandler.hpp"
 #include "logging.hpp"
 #include "nodeinputhandler.hpp"
@@ -44,17 +46,23 @@ NodeSession::NodeSession(const NodeSessionMetadata& metadata, const std::string&
     metadata(metadata),
     sessionKey(metadata.getSessionKey()),
     nodeName(nodeName),
-    timer(std::make_unique<Timer>()),
     inputHandler(createNodeInputHandler(inputsCount, collapsingDetails)),
-    outputHandler(std::make_unique<NodeOutputHandler>()) {}
+    outputHandler(std::make_unique<NodeOutputHandler>()) {
+    this->timer.start(INPUTS);
+}
 
 NodeSession::NodeSession(const NodeSessionMetadata&& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails) :
     metadata(std::move(metadata)),
     sessionKey(this->metadata.getSessionKey()),
     nodeName(nodeName),
-    timer(std::make_unique<Timer>()),
     inputHandler(std::make_unique<NodeInputHandler>(inputsCount)),
-    outputHandler(std::make_unique<NodeOutputHandler>()) {}
+    outputHandler(std::make_unique<NodeOutputHandler>()) {
+    this->timer.start(INPUTS);
+}
+
+void NodeSession::setBlobAllocator(std::shared_ptr<InferenceEngine::IAllocator> allocator) {
+    this->inputHandler->setBlobAllocator(std::move(allocator));
+}
 
 bool NodeSession::isReady() const {
     bool isReady = inputHandler->isReady();
@@ -62,12 +70,25 @@ bool NodeSession::isReady() const {
     return isReady;
 }
 
+void NodeSession::finishSkipped() {
+    this->inputHandler->getInputs();
+}
+
+const BlobMap& NodeSession::peekInputs() const {
+    return this->inputHandler->peekInputs();
+}
+
+void NodeSession::finishFromCache(BlobMap outputs) {
+    this->inputHandler->getInputs();
+    this->cachedOutputs = std::move(outputs);
+}
+
 Status NodeSession::notifyFinishedDependency() {
     return this->inputHandler->notifyFinishedDependency();
 }
 
-Timer& NodeSession::getTimer() const {
-    return *this->timer;
+InferenceEngine::Blob::Ptr NodeSession::getInputSlot(const std::string& inputName, session_id_t shardId, const InferenceEngine::TensorDesc& shardDesc) {
+    return this->inputHandler->getInputSlot(inputName, shardId, shardDesc);
 }
 
 ReleaseSessionGuard::ReleaseSessionGuard(NodeSession& nodeSession) :
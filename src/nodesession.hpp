@@ -16,26 +16,47 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include <inference_engine.hpp>
 
+#include "blobmap.hpp"
 #include "nodesessionmetadata.hpp"
 #include "status.hpp"
+#include "timer.hpp"
 
 namespace ovms {
 struct NodeInputHandler;
 struct NodeOutputHandler;
-class Timer;
 
 class NodeSession {
+public:
+    /**
+     * @brief Stages measured by node session timer
+     */
+    enum TimerStage : size_t {
+        INPUTS,
+        STREAM,
+        INFERENCE,
+        EXECUTION,
+        TIMER_END
+    };
+
+private:
     NodeSessionMetadata metadata;
     session_key_t sessionKey;
     const std::string& nodeName;
+    bool skipped = false;
+    bool skippedDependencies = false;
+    // key of inputs in node output cache, set when outputs were not cached yet
+    std::optional<uint64_t> outputCacheKey;
+    // set when session finished with outputs found in node output cache
+    std::optional<BlobMap> cachedOutputs;
 
 protected:
-    std::unique_ptr<Timer> timer;
+    Timer<TIMER_END> timer;
     std::unique_ptr<NodeInputHandler> inputHandler;
     std::unique_ptr<NodeOutputHandler> outputHandler;
 
@@ -49,9 +70,39 @@ public:
     const session_key_t& getSessionKey() const { return sessionKey; }
     bool isReady() const;
     virtual void release() {}
-    virtual bool tryDisarm(uint microseconds) { return true; }
+    virtual void disarm() {}
     Status notifyFinishedDependency();
-    Timer& getTimer() const;
+    InferenceEngine::Blob::Ptr getInputSlot(const std::string& inputName, session_id_t shardId, const InferenceEngine::TensorDesc& shardDesc);
+    Timer<TIMER_END>& getTimer() { return timer; }
+    /**
+     * @brief Marks session as not executed, since condition of its node was not met or its dependency was skipped
+     */
+    void skip() { skipped = true; }
+    bool isSkipped() const { return skipped; }
+    /**
+     * @brief Marks inputs of skipped session as used instead of executing it, so that it is not ready anymore
+     */
+    void finishSkipped();
+    /**
+     * @brief Marks that some dependency session was skipped and did not set its inputs
+     */
+    void notifySkippedDependency() { skippedDependencies = true; }
+    bool hasSkippedDependencies() const { return skippedDependencies; }
+    /**
+     * @brief Gets inputs without marking them as used by execution
+     */
+    const BlobMap& peekInputs() const;
+    /**
+     * @brief Finishes session with outputs found in node output cache instead of executing it
+     */
+    void finishFromCache(BlobMap outputs);
+    std::optional<BlobMap>& getCachedOutputs() { return cachedOutputs; }
+    void setOutputCacheKey(uint64_t key) { outputCacheKey = key; }
+    const std::optional<uint64_t>& getOutputCacheKey() const { return outputCacheKey; }
+    /**
+     * @brief Sets allocator of blobs consolidated from gathered shards
+     */
+    void setBlobAllocator(std::shared_ptr<InferenceEngine::IAllocator> allocator);
 };
 
 class ReleaseSessionGuard {
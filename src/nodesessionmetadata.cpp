@@ -56,10 +56,7 @@ std::vector<NodeSessionMetadata> NodeSessionMetadata::generateSubsessions(const
     return metas;
 }
 
-std::string NodeSessionMetadata::getSessionKey(const std::set<std::string>& ignoredNodeNames) const {
-    if (details.size() == 0) {
-        return "";
-    }
+size_t NodeSessionMetadata::getKeyLevelsCount(const std::set<std::string>& ignoredNodeNames) const {
     if (std::any_of(ignoredNodeNames.begin(),
             ignoredNodeNames.end(),
             [this](auto& ignoredNodeName) {
@@ -71,27 +68,40 @@ std::string NodeSessionMetadata::getSessionKey(const std::set<std::string>& igno
             })) {
         throw std::logic_error("Tried to create session key ignoring non-existing subsession");
     }
-    std::stringstream ss;
-    size_t j = 0;
-    for (int32_t i = sessionsLevels.size() - 1; i >= 0; --i, ++j) {
-        if ((ignoredNodeNames.size() > 0) &&
-            (ignoredNodeNames.size() > j) &&
-            ((sessionsLevels.size() - ignoredNodeNames.size()) >= 0) &&
-            (ignoredNodeNames.find(sessionsLevels[i]) == ignoredNodeNames.end())) {
-            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Tried to collapse sessions not in LIFO order. Should collapse: {} first", sessionsLevels[i]);
+    for (size_t j = 0; j < ignoredNodeNames.size(); ++j) {
+        const auto& sessionLevel = sessionsLevels[sessionsLevels.size() - 1 - j];
+        if (ignoredNodeNames.find(sessionLevel) == ignoredNodeNames.end()) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Tried to collapse sessions not in LIFO order. Should collapse: {} first", sessionLevel);
             throw std::logic_error("Cannot collapse sessions not in LIFO order");
-        } else {
-            if (j < ignoredNodeNames.size()) {
-                continue;
-            }
-            if (ss.tellp() > 0) {
-                ss << "_";
-            }
-            ss << sessionsLevels[i] << "_" << std::get<0>(details.at(sessionsLevels[i]));
         }
-        if (i == 0) {
-            break;
+    }
+    return sessionsLevels.size() - ignoredNodeNames.size();
+}
+
+session_key_t NodeSessionMetadata::getSessionKey(const std::set<std::string>& ignoredNodeNames) const {
+    if (details.size() == 0) {
+        return 0;
+    }
+    const size_t levelsCount = getKeyLevelsCount(ignoredNodeNames);
+    session_key_t key = 0;
+    for (size_t i = 0; i < levelsCount; ++i) {
+        const auto& [id, sessionSize] = details.at(sessionsLevels[i]);
+        key = key * sessionSize + id;
+    }
+    return key;
+}
+
+std::string NodeSessionMetadata::getSessionName(const std::set<std::string>& ignoredNodeNames) const {
+    if (details.size() == 0) {
+        return "";
+    }
+    const size_t levelsCount = getKeyLevelsCount(ignoredNodeNames);
+    std::stringstream ss;
+    for (size_t i = levelsCount; i > 0; --i) {
+        if (ss.tellp() > 0) {
+            ss << "_";
         }
+        ss << sessionsLevels[i - 1] << "_" << std::get<0>(details.at(sessionsLevels[i - 1]));
     }
     return ss.str();
 }
@@ -26,9 +26,6 @@
 
 namespace ovms {
 
-using session_id_t = uint32_t;
-using session_key_t = std::string;
-
 struct CollapseDetails {
     std::vector<std::string> collapsedSessionNames;
     std::vector<session_id_t> collapsedSessionSizes;
@@ -40,9 +37,26 @@ class NodeSessionMetadata {
 
 public:
     std::vector<NodeSessionMetadata> generateSubsessions(const std::string& nodeName, session_id_t subsessionSize) const;
-    std::string getSessionKey(const std::set<std::string>& ignoredNodeNames = {}) const;
+    /**
+     * @brief Gets compact key of session, unique among sessions with the same subsession levels
+     *
+     * Key is built from subsession ids as mixed radix number with subsession sizes as radixes.
+     * Collapsing ignoredNodeNames levels gives the same key as one of collapsed session.
+     */
+    session_key_t getSessionKey(const std::set<std::string>& ignoredNodeNames = {}) const;
+    /**
+     * @brief Gets human readable session name to be used in logs
+     */
+    std::string getSessionName(const std::set<std::string>& ignoredNodeNames = {}) const;
     std::pair<NodeSessionMetadata, CollapseDetails> getCollapsedSessionMetadata(const std::set<std::string>& ignoredNodeNames) const;
     session_id_t getSubsessionSize(const std::string& subsessionName) const;
     session_id_t getShardId(const std::set<std::string>& collapsedNames = {}) const;
+    /**
+     * @brief Checks if session belongs to shard of demultiplexer which was not gathered yet
+     */
+    bool isShard() const { return !sessionsLevels.empty(); }
+
+private:
+    size_t getKeyLevelsCount(const std::set<std::string>& ignoredNodeNames) const;
 };
 }  // namespace ovms
@@ -15,53 +15,124 @@
 //*****************************************************************************
 #pragma once
 
-#include <future>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
 #include "ovinferrequestsqueue.hpp"
+#include "requestcontext.hpp"
 
 namespace ovms {
+/**
+* @brief Holds stream id requested for pipeline node session
+*
+* When all streams are busy the guard is parked in infer requests queue and stream is handed over
+* through callback, so neither acquiring nor disarming blocks pipeline thread.
+*/
 struct NodeStreamIdGuard {
-    NodeStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue) :
+    /**
+    * @param pipelineStarted sessions of earlier started pipelines get streams first
+    */
+    NodeStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue, RequestContext::clock_t::time_point pipelineStarted = RequestContext::clock_t::time_point()) :
         inferRequestsQueue_(inferRequestsQueue),
-        futureStreamId(inferRequestsQueue_.getIdleStream()) {}
+        state(std::make_shared<State>()) {
+        int streamId;
+        auto sharedState = state;
+        parked = !inferRequestsQueue_.getIdleStreamOrNotify(
+            streamId,
+            [sharedState, &inferRequestsQueue](int streamId) { sharedState->handOver(inferRequestsQueue, streamId); },
+            waiterKey, pipelineStarted);
+        if (!parked) {
+            state->streamId = streamId;
+        }
+    }
 
     ~NodeStreamIdGuard() {
-        if (!disarmed) {
-            if (!streamId) {
-                SPDLOG_DEBUG("Trying to disarm stream Id that is not needed anymore...");
-                streamId = futureStreamId.get();
-            }
-            SPDLOG_DEBUG("Returning streamId: {}", streamId.value());
-            inferRequestsQueue_.returnStream(streamId.value());
-        }
+        disarm();
     }
 
-    std::optional<int> tryGetId(const uint microseconds = 1) {
-        if (!streamId) {
-            if (std::future_status::ready == futureStreamId.wait_for(std::chrono::microseconds(microseconds))) {
-                streamId = futureStreamId.get();
-            }
+    std::optional<int> tryGetId() {
+        std::unique_lock<std::mutex> lock(state->mtx);
+        return state->streamId;
+    }
+
+    /**
+    * @brief Registers callback called once stream id is handed over
+    *
+    * Callback is called on the thread returning the stream and cannot be called anymore once guard is disarmed.
+    *
+    * @return false if stream id is already available, callback is not registered then
+    */
+    bool notifyWhenReady(std::function<void()> callback) {
+        std::unique_lock<std::mutex> lock(state->mtx);
+        if (state->streamId) {
+            return false;
         }
-        return streamId;
+        state->onReady = std::move(callback);
+        return true;
     }
 
-    bool tryDisarm(const uint microseconds = 1) {
-        if (std::future_status::ready == futureStreamId.wait_for(std::chrono::microseconds(microseconds))) {
-            streamId = futureStreamId.get();
-            SPDLOG_DEBUG("Returning streamId:", streamId.value());
+    /**
+    * @brief Returns stream id or gives up waiting for it, stream handed over later is returned right away
+    */
+    void disarm() {
+        if (disarmed) {
+            return;
+        }
+        disarmed = true;
+        if (parked && inferRequestsQueue_.cancelWaiter(waiterKey)) {
+            SPDLOG_DEBUG("Stream id guard disarmed before stream was handed over");
+            return;
+        }
+        std::optional<int> streamId;
+        {
+            std::unique_lock<std::mutex> lock(state->mtx);
+            state->disarmed = true;
+            state->onReady = nullptr;
+            std::swap(streamId, state->streamId);
+        }
+        if (streamId) {
+            SPDLOG_DEBUG("Returning streamId: {}", streamId.value());
             inferRequestsQueue_.returnStream(streamId.value());
-            disarmed = true;
         }
-        return disarmed;
     }
 
 private:
+    /**
+    * @brief State shared with callback parked in infer requests queue, which can outlive the guard
+    */
+    struct State {
+        std::mutex mtx;
+        std::optional<int> streamId = std::nullopt;
+        std::function<void()> onReady;
+        bool disarmed = false;
+
+        void handOver(ovms::OVInferRequestsQueue& inferRequestsQueue, int id) {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (disarmed) {
+                lock.unlock();
+                SPDLOG_DEBUG("Returning streamId: {} handed over to already disarmed guard", id);
+                inferRequestsQueue.returnStream(id);
+                return;
+            }
+            streamId = id;
+            // called under lock so that disarm does not return while callback is still running
+            if (onReady) {
+                auto callback = std::move(onReady);
+                onReady = nullptr;
+                callback();
+            }
+        }
+    };
+
     ovms::OVInferRequestsQueue& inferRequestsQueue_;
-    std::future<int> futureStreamId;
-    std::optional<int> streamId = std::nullopt;
+    std::shared_ptr<State> state;
+    ovms::OVInferRequestsQueue::WaiterKey waiterKey;
+    bool parked = false;
     bool disarmed = false;
 };
 }  // namespace ovms
@@ -15,39 +15,55 @@
 //*****************************************************************************
 #include "ov_utils.hpp"
 
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <sstream>
+#include <utility>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
 
+#include "tensor_buffer_pool.hpp"
 #include "tensorinfo.hpp"
 
 namespace ovms {
 
-Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEngine::TensorDesc tensorDesc) {
+template <typename T>
+static InferenceEngine::Blob::Ptr makeSharedBlob(const InferenceEngine::TensorDesc& tensorDesc, void* data, const std::shared_ptr<InferenceEngine::IAllocator>& allocator) {
+    if (allocator) {
+        return InferenceEngine::make_shared_blob<T>(tensorDesc, allocator);
+    }
+    if (data == nullptr) {
+        auto pool = TensorBufferPool::getGlobal();
+        return pool ? InferenceEngine::make_shared_blob<T>(tensorDesc, std::move(pool)) : InferenceEngine::make_shared_blob<T>(tensorDesc);
+    }
+    return InferenceEngine::make_shared_blob<T>(tensorDesc, static_cast<T*>(data));
+}
+
+static Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, const InferenceEngine::TensorDesc& tensorDesc, void* data, const std::shared_ptr<InferenceEngine::IAllocator>& allocator) {
     try {
         switch (tensorDesc.getPrecision()) {
         case InferenceEngine::Precision::FP32:
-            destinationBlob = InferenceEngine::make_shared_blob<float>(tensorDesc);
+            destinationBlob = makeSharedBlob<float>(tensorDesc, data, allocator);
             break;
         case InferenceEngine::Precision::I32:
-            destinationBlob = InferenceEngine::make_shared_blob<int32_t>(tensorDesc);
+            destinationBlob = makeSharedBlob<int32_t>(tensorDesc, data, allocator);
             break;
         case InferenceEngine::Precision::I8:
-            destinationBlob = InferenceEngine::make_shared_blob<int8_t>(tensorDesc);
+            destinationBlob = makeSharedBlob<int8_t>(tensorDesc, data, allocator);
             break;
         case InferenceEngine::Precision::U8:
-            destinationBlob = InferenceEngine::make_shared_blob<uint8_t>(tensorDesc);
+            destinationBlob = makeSharedBlob<uint8_t>(tensorDesc, data, allocator);
             break;
         case InferenceEngine::Precision::FP16:
-            destinationBlob = InferenceEngine::make_shared_blob<uint16_t>(tensorDesc);
+            destinationBlob = makeSharedBlob<uint16_t>(tensorDesc, data, allocator);
             break;
         case InferenceEngine::Precision::I16:
-            destinationBlob = InferenceEngine::make_shared_blob<int16_t>(tensorDesc);
+            destinationBlob = makeSharedBlob<int16_t>(tensorDesc, data, allocator);
             break;
         case InferenceEngine::Precision::U16:
-            destinationBlob = InferenceEngine::make_shared_blob<uint16_t>(tensorDesc);
+            destinationBlob = makeSharedBlob<uint16_t>(tensorDesc, data, allocator);
             break;
         case InferenceEngine::Precision::I64:
         case InferenceEngine::Precision::MIXED:
@@ -67,10 +83,32 @@ Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEn
         SPDLOG_DEBUG("Blob clone failed; exception message: {}", e.what());
         return StatusCode::OV_CLONE_BLOB_ERROR;
     }
-    destinationBlob->allocate();
+    if (data == nullptr) {
+        destinationBlob->allocate();
+    }
     return StatusCode::OK;
 }
 
+Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEngine::TensorDesc tensorDesc) {
+    return createSharedBlob(destinationBlob, tensorDesc, nullptr, nullptr);
+}
+
+Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEngine::TensorDesc tensorDesc, void* data) {
+    return createSharedBlob(destinationBlob, tensorDesc, data, nullptr);
+}
+
+Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEngine::TensorDesc tensorDesc, std::shared_ptr<InferenceEngine::IAllocator> allocator) {
+    if (!allocator) {
+        return StatusCode::OV_CLONE_BLOB_ERROR;
+    }
+    return createSharedBlob(destinationBlob, tensorDesc, nullptr, allocator);
+}
+
+size_t getTensorByteSize(const InferenceEngine::TensorDesc& desc) {
+    const auto& dims = desc.getDims();
+    return desc.getPrecision().size() * std::accumulate(dims.begin(), dims.end(), size_t{1}, std::multiplies<size_t>());
+}
+
 std::string getNetworkInputsInfoString(const InferenceEngine::InputsDataMap& inputsInfo, const ModelConfig& config) {
     std::stringstream stringStream;
 
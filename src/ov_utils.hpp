@@ -18,6 +18,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
@@ -31,15 +32,33 @@ class TensorInfo;
 
 Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEngine::TensorDesc tensorDesc);
 
+/**
+ * @brief Creates blob wrapping external memory which has to outlive the blob
+ */
+Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEngine::TensorDesc tensorDesc, void* data);
+
+/**
+ * @brief Creates blob with memory provided by allocator
+ */
+Status createSharedBlob(InferenceEngine::Blob::Ptr& destinationBlob, InferenceEngine::TensorDesc tensorDesc, std::shared_ptr<InferenceEngine::IAllocator> allocator);
+
+/**
+ * @brief Gets size of data described by tensor description, in bytes
+ */
+size_t getTensorByteSize(const InferenceEngine::TensorDesc& desc);
+
 std::string getNetworkInputsInfoString(const InferenceEngine::InputsDataMap& inputsInfo, const ModelConfig& config);
 std::string getTensorMapString(const std::map<std::string, std::shared_ptr<TensorInfo>>& tensorMap);
 const InferenceEngine::SizeVector& getEffectiveShape(InferenceEngine::TensorDesc& desc);
 const InferenceEngine::SizeVector& getEffectiveBlobShape(const InferenceEngine::Blob::Ptr& blob);
 
+/**
+ * @brief Copies blob, memory of copy is provided by allocator when it is set
+ */
 template <typename T>
-Status blobClone(InferenceEngine::Blob::Ptr& destinationBlob, const T sourceBlob) {
+Status blobClone(InferenceEngine::Blob::Ptr& destinationBlob, const T sourceBlob, std::shared_ptr<InferenceEngine::IAllocator> allocator = nullptr) {
     auto& description = sourceBlob->getTensorDesc();
-    auto status = createSharedBlob(destinationBlob, description);
+    auto status = allocator ? createSharedBlob(destinationBlob, description, std::move(allocator)) : createSharedBlob(destinationBlob, description);
     if (!status.ok()) {
         return status;
     }
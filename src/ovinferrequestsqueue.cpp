@@ -16,43 +16,533 @@
 
 #include "ovinferrequestsqueue.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include "ov_utils.hpp"
+#include "usdt.hpp"
 
 namespace ovms {
+OVInferRequestsQueue::OVInferRequestsQueue(const std::vector<DeviceStreams>& devices, uint32_t maxQueueDepth, uint32_t maxQueueWaitMs, uint32_t reservedStreams) :
+    capacity(roundUpToPowerOfTwo(countStreams(devices))),
+    cells(new Cell[capacity]),
+    enqueuePos{0},
+    dequeuePos{0},
+    waitersCount{0},
+    // at least one stream is left for other callers
+    reservedStreams(std::min<int64_t>(reservedStreams, std::max(countStreams(devices) - 1, 0))),
+    idleStreamsCount{0},
+    waitersSequence{0},
+    maxQueueDepth(maxQueueDepth),
+    maxQueueWait(maxQueueWaitMs),
+    rejectedRequestsCount{0},
+    devices(devices),
+    requestTimeTracked(std::any_of(devices.begin(), devices.end(), [](const DeviceStreams& device) { return device.requestTime != nullptr; })),
+    activeStreams{countStreams(devices)},
+    lastWaitAt{0} {
+    for (size_t i = 0; i < capacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    std::vector<int> firstStreamIds;
+    for (size_t deviceIndex = 0; deviceIndex < devices.size(); ++deviceIndex) {
+        firstStreamIds.push_back(inferRequests.size());
+        for (int i = 0; i < devices[deviceIndex].streamsLength; ++i) {
+            inferRequests.push_back(devices[deviceIndex].network.CreateInferRequest());
+            streamDevices.push_back(deviceIndex);
+        }
+    }
+    streamAcquiredAt.resize(inferRequests.size());
+    if (!devices.empty()) {
+        try {
+            for (const auto& [name, input] : devices[0].network.GetInputsInfo()) {
+                requestBlobsBytes += getTensorByteSize(input->getTensorDesc());
+            }
+            for (const auto& [name, output] : devices[0].network.GetOutputsInfo()) {
+                requestBlobsBytes += getTensorByteSize(output->getTensorDesc());
+            }
+        } catch (const InferenceEngine::Exception& e) {
+            SPDLOG_DEBUG("Unable to estimate memory of infer requests: {}", e.what());
+        }
+    }
+    // interleaved so that first callers are spread across devices
+    int maxStreamsLength = 0;
+    for (const auto& device : devices) {
+        maxStreamsLength = std::max(maxStreamsLength, device.streamsLength);
+    }
+    for (int i = 0; i < maxStreamsLength; ++i) {
+        for (size_t deviceIndex = 0; deviceIndex < devices.size(); ++deviceIndex) {
+            if (i < devices[deviceIndex].streamsLength) {
+                push(firstStreamIds[deviceIndex] + i);
+            }
+        }
+    }
+    idleStreamsCount.store(inferRequests.size(), std::memory_order_release);
+    if (this->reservedStreams != static_cast<int>(reservedStreams)) {
+        SPDLOG_WARN("Number of infer requests reserved for pipelines: {} has to be lower than number of infer requests: {}; reserving {}",
+            reservedStreams, inferRequests.size(), this->reservedStreams);
+    }
+}
+
+OVInferRequestsQueue::~OVInferRequestsQueue() {
+    add(totalGauge, -static_cast<int64_t>(activeStreams.load()));
+}
+
+void OVInferRequestsQueue::trackUtilization(Gauge* inUse, Gauge* waiting, Gauge* total, SaturationTracker* saturation) {
+    inUseGauge = inUse;
+    waitingGauge = waiting;
+    totalGauge = total;
+    this->saturation = saturation;
+    if (saturation) {
+        requestTimeTracked = true;
+    }
+    add(totalGauge, activeStreams.load());
+}
+
+Status OVInferRequestsQueue::bindStreamInputBlobs(int streamID, BlobMap& blobs) {
+    for (const auto& [name, tensorDesc] : boundInputs) {
+        InferenceEngine::Blob::Ptr blob;
+        if (remoteContext) {
+            // device memory of the plugin, request data written through the mapped host pointer needs no further copy
+            try {
+                blob = remoteContext->CreateBlob(tensorDesc);
+                blob->allocate();
+            } catch (const InferenceEngine::Exception& e) {
+                SPDLOG_ERROR("Unable to create remote input blob {}: {}", name, e.what());
+                return StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+            }
+        } else {
+            auto status = createSharedBlob(blob, tensorDesc);
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        try {
+            inferRequests[streamID].SetBlob(name, blob);
+        } catch (const InferenceEngine::Exception& e) {
+            SPDLOG_ERROR("Unable to bind input blob {} to infer request: {}", name, e.what());
+            return StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        } catch (std::logic_error& e) {
+            SPDLOG_ERROR("Unable to bind input blob {} to infer request: {}", name, e.what());
+            return StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        }
+        blobs.emplace(name, std::move(blob));
+    }
+    return StatusCode::OK;
+}
+
+Status OVInferRequestsQueue::bindInputBlobs(const std::map<std::string, InferenceEngine::TensorDesc>& inputs, InferenceEngine::RemoteContext::Ptr remoteContext) {
+    boundInputs = inputs;
+    this->remoteContext = std::move(remoteContext);
+    std::vector<BlobMap> blobs(inferRequests.size());
+    for (size_t streamID = 0; streamID < inferRequests.size(); ++streamID) {
+        auto status = bindStreamInputBlobs(streamID, blobs[streamID]);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    boundInputBlobs = std::move(blobs);
+    return StatusCode::OK;
+}
+
+static int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void OVInferRequestsQueue::enableElasticity(int minStreams, std::chrono::milliseconds cooldown) {
+    const int streams = inferRequests.size();
+    minStreams = std::max(minStreams, reservedStreams + 1);
+    if (minStreams >= streams) {
+        return;
+    }
+    elastic = true;
+    this->minStreams = minStreams;
+    this->cooldown = cooldown;
+    lastWaitAt.store(steadyNowNs(), std::memory_order_relaxed);
+    // all streams are idle before the queue is used, the first ones in ring order are kept
+    std::vector<int> idle;
+    int streamID;
+    while (popRing(streamID)) {
+        idle.push_back(streamID);
+    }
+    for (int i = 0; i < minStreams; ++i) {
+        push(idle[i]);
+    }
+    for (int i = streams - 1; i >= minStreams; --i) {
+        releaseInferRequest(idle[i]);
+        dormantStreams.push_back(idle[i]);
+    }
+    idleStreamsCount.store(minStreams, std::memory_order_release);
+    activeStreams.store(minStreams, std::memory_order_relaxed);
+    add(totalGauge, minStreams - streams);
+}
+
+Status OVInferRequestsQueue::createInferRequest(int streamID) {
+    try {
+        inferRequests[streamID] = devices[streamDevices[streamID]].network.CreateInferRequest();
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_ERROR("Unable to create infer request: {}", e.what());
+        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+    }
+    if (boundInputBlobs.empty()) {
+        return StatusCode::OK;
+    }
+    BlobMap blobs;
+    auto status = bindStreamInputBlobs(streamID, blobs);
+    if (!status.ok()) {
+        return status;
+    }
+    boundInputBlobs[streamID] = std::move(blobs);
+    return StatusCode::OK;
+}
+
+void OVInferRequestsQueue::releaseInferRequest(int streamID) {
+    inferRequests[streamID] = InferenceEngine::InferRequest();
+    if (!boundInputBlobs.empty()) {
+        boundInputBlobs[streamID].clear();
+    }
+}
+
+void OVInferRequestsQueue::growIfNeeded() {
+    if (!elastic) {
+        return;
+    }
+    int streamID;
+    {
+        std::lock_guard<std::mutex> lock(elasticMutex);
+        if (dormantStreams.empty()) {
+            return;
+        }
+        streamID = dormantStreams.back();
+        dormantStreams.pop_back();
+    }
+    auto status = createInferRequest(streamID);
+    if (!status.ok()) {
+        releaseInferRequest(streamID);
+        std::lock_guard<std::mutex> lock(elasticMutex);
+        dormantStreams.push_back(streamID);
+        return;
+    }
+    SPDLOG_DEBUG("Created infer request for stream: {}; active streams: {}", streamID, activeStreams.fetch_add(1, std::memory_order_relaxed) + 1);
+    add(totalGauge, 1);
+    pushIdle(streamID);
+}
+
+bool OVInferRequestsQueue::shrinkIfIdle(int streamID) {
+    if (waitersCount.load(std::memory_order_relaxed) > 0 ||
+        steadyNowNs() - lastWaitAt.load(std::memory_order_relaxed) < std::chrono::duration_cast<std::chrono::nanoseconds>(cooldown).count()) {
+        return false;
+    }
+    int active = activeStreams.load(std::memory_order_relaxed);
+    do {
+        if (active <= minStreams) {
+            return false;
+        }
+    } while (!activeStreams.compare_exchange_weak(active, active - 1, std::memory_order_relaxed));
+    releaseInferRequest(streamID);
+    {
+        std::lock_guard<std::mutex> lock(elasticMutex);
+        dormantStreams.push_back(streamID);
+    }
+    add(totalGauge, -1);
+    SPDLOG_DEBUG("Released infer request of idle stream: {}; active streams: {}", streamID, active - 1);
+    return true;
+}
+
+bool OVInferRequestsQueue::push(int streamID) {
+    const size_t mask = capacity - 1;
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // ring is full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->streamID = streamID;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool OVInferRequestsQueue::popRing(int& streamID) {
+    const size_t mask = capacity - 1;
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // no idle stream
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    streamID = cell->streamID;
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+bool OVInferRequestsQueue::pop(int& streamID, bool pipeline, const RequestContext::clock_t::time_point* parkedAt) {
+    if (reservedStreams == 0) {
+        if (!popRing(streamID)) {
+            return false;
+        }
+    } else {
+        const int minIdleStreams = pipeline ? 0 : reservedStreams;
+        int idle = idleStreamsCount.load(std::memory_order_relaxed);
+        do {
+            if (idle <= minIdleStreams) {
+                return false;
+            }
+        } while (!idleStreamsCount.compare_exchange_weak(idle, idle - 1, std::memory_order_acquire, std::memory_order_relaxed));
+        // claimed stream is in the ring, the cell at dequeue position may still be written by concurrent push
+        while (!popRing(streamID)) {
+            std::this_thread::yield();
+        }
+    }
+    if (requestTimeTracked) {
+        const auto now = std::chrono::steady_clock::now();
+        streamAcquiredAt[streamID] = now;
+        if (saturation) {
+            saturation->recordAcquired(parkedAt ? std::chrono::duration_cast<std::chrono::microseconds>(now - *parkedAt).count() : 0, now);
+        }
+    }
+    add(inUseGauge, 1);
+    OVMS_TRACEPOINT(stream_acquire, tracepointModelName.c_str(), tracepointModelVersion, streamID);
+    return true;
+}
+
+bool OVInferRequestsQueue::tryGetIdleStream(int& streamID) {
+    return pop(streamID);
+}
+
+bool OVInferRequestsQueue::registerWaiter(int& streamID, WaiterKey& key, stream_callback_t callback) {
+    waitersCount.fetch_add(1, std::memory_order_relaxed);
+    add(waitingGauge, 1);
+    // pairs with the fence in returnStream so either the retry sees the returned stream
+    // or the returning thread sees this waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (pop(streamID, key.pipeline)) {
+        waitersCount.fetch_sub(1, std::memory_order_relaxed);
+        add(waitingGauge, -1);
+        return true;
+    }
+    key.sequence = waitersSequence++;
+    key.parkedAt = RequestContext::clock_t::now();
+    waiters.emplace(key, std::move(callback));
+    if (elastic) {
+        lastWaitAt.store(steadyNowNs(), std::memory_order_relaxed);
+    }
+    return false;
+}
+
+bool OVInferRequestsQueue::registerWaiter(int& streamID, WaiterKey& key, std::future<int>& future) {
+    auto promise = std::make_shared<std::promise<int>>();
+    future = promise->get_future();
+    return registerWaiter(streamID, key, [promise](int streamID) { promise->set_value(streamID); });
+}
+
+bool OVInferRequestsQueue::getIdleStreamOrNotify(int& streamID, stream_callback_t callback, WaiterKey& key, RequestContext::clock_t::time_point pipelineStarted) {
+    if (pop(streamID, true)) {
+        return true;
+    }
+    bool taken;
+    {
+        std::unique_lock<std::mutex> lk(waitersMutex);
+        key = WaiterKey();
+        key.pipeline = true;
+        key.started = pipelineStarted;
+        taken = registerWaiter(streamID, key, std::move(callback));
+    }
+    if (!taken) {
+        growIfNeeded();
+    }
+    return taken;
+}
+
+bool OVInferRequestsQueue::cancelWaiter(const WaiterKey& key) {
+    std::unique_lock<std::mutex> lk(waitersMutex);
+    auto it = waiters.find(key);
+    if (it == waiters.end()) {
+        return false;
+    }
+    waiters.erase(it);
+    waitersCount.fetch_sub(1, std::memory_order_relaxed);
+    add(waitingGauge, -1);
+    return true;
+}
+
 std::future<int> OVInferRequestsQueue::getIdleStream() {
-    int value;
-    std::promise<int> idleStreamPromise;
-    std::future<int> idleStreamFuture = idleStreamPromise.get_future();
-    std::unique_lock<std::mutex> lk(front_mut);
-    if (streams[front_idx] < 0) {  // we need to wait for any idle stream to be returned
-        std::unique_lock<std::mutex> queueLock(queue_mutex);
-        promises.push(std::move(idleStreamPromise));
-    } else {  // we can give idle stream right away
-        value = streams[front_idx];
-        streams[front_idx] = -1;  // negative value indicate consumed vector index
-        front_idx = (front_idx + 1) % streams.size();
-        lk.unlock();
-        idleStreamPromise.set_value(value);
+    std::future<int> idleStreamFuture;
+    int streamID;
+    if (!pop(streamID)) {
+        bool taken;
+        {
+            std::unique_lock<std::mutex> lk(waitersMutex);
+            WaiterKey key;
+            taken = registerWaiter(streamID, key, idleStreamFuture);
+        }
+        if (!taken) {
+            growIfNeeded();
+            return idleStreamFuture;
+        }
     }
+    std::promise<int> idleStreamPromise;
+    idleStreamFuture = idleStreamPromise.get_future();
+    idleStreamPromise.set_value(streamID);
     return idleStreamFuture;
 }
 
+Status OVInferRequestsQueue::acquireIdleStream(int& streamID, const RequestContext& context) {
+    if (pop(streamID)) {
+        return StatusCode::OK;
+    }
+    auto status = context.check();
+    if (!status.ok()) {
+        return status;
+    }
+    RequestContext waitContext = context;
+    bool limitedByQueueWait = false;
+    if (maxQueueWait.count() > 0) {
+        auto queueWaitDeadline = RequestContext::clock_t::now() + maxQueueWait;
+        if (queueWaitDeadline < waitContext.deadline) {
+            waitContext.deadline = queueWaitDeadline;
+            limitedByQueueWait = true;
+        }
+    }
+    auto expiredStatus = [this, limitedByQueueWait]() -> Status {
+        if (limitedByQueueWait) {
+            rejectedRequestsCount.fetch_add(1, std::memory_order_relaxed);
+            return StatusCode::INFER_REQUEST_QUEUE_TIMEOUT;
+        }
+        return StatusCode::REQUEST_DEADLINE_EXCEEDED;
+    };
+
+    WaiterKey key;
+    key.priority = waitContext.priority;
+    key.deadline = waitContext.deadline;
+    std::future<int> idleStreamFuture;
+    {
+        std::unique_lock<std::mutex> lk(waitersMutex);
+        if (maxQueueDepth > 0 && waiters.size() >= maxQueueDepth) {
+            if (pop(streamID)) {
+                return StatusCode::OK;
+            }
+            rejectedRequestsCount.fetch_add(1, std::memory_order_relaxed);
+            return StatusCode::INFER_REQUEST_QUEUE_FULL;
+        }
+        if (registerWaiter(streamID, key, idleStreamFuture)) {
+            return StatusCode::OK;
+        }
+    }
+    growIfNeeded();
+    while (waitContext.hasDeadline() || context.isCancellable()) {
+        // cancellation cannot be signalled through the future so it is polled
+        auto waitUntil = waitContext.deadline;
+        if (context.isCancellable()) {
+            waitUntil = std::min(waitUntil, RequestContext::clock_t::now() + CANCELLATION_POLL_INTERVAL);
+        }
+        if (idleStreamFuture.wait_until(waitUntil) == std::future_status::ready) {
+            break;
+        }
+        bool cancelled = context.isCancelled();
+        if (!cancelled && !waitContext.isDeadlineExceeded()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(waitersMutex);
+        auto it = waiters.find(key);
+        if (it != waiters.end()) {
+            waiters.erase(it);
+            waitersCount.fetch_sub(1, std::memory_order_relaxed);
+            add(waitingGauge, -1);
+            return cancelled ? Status(StatusCode::REQUEST_CANCELLED) : expiredStatus();
+        }
+        // stream was handed over right before the deadline
+        break;
+    }
+    streamID = idleStreamFuture.get();
+    if (streamID < 0) {
+        return expiredStatus();
+    }
+    return StatusCode::OK;
+}
+
 void OVInferRequestsQueue::returnStream(int streamID) {
-    std::unique_lock<std::mutex> lk(queue_mutex);
-    if (promises.size()) {
-        std::promise<int> promise = std::move(promises.front());
-        promises.pop();
-        lk.unlock();
-        promise.set_value(streamID);
+    if (requestTimeTracked) {
+        const auto now = std::chrono::steady_clock::now();
+        const uint64_t requestTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(now - streamAcquiredAt[streamID]).count();
+        observe(devices[streamDevices[streamID]].requestTime, requestTimeUs);
+        if (saturation) {
+            saturation->recordReturned(requestTimeUs, now);
+        }
+    }
+    add(inUseGauge, -1);
+    OVMS_TRACEPOINT(stream_release, tracepointModelName.c_str(), tracepointModelVersion, streamID);
+    if (elastic && shrinkIfIdle(streamID)) {
+        return;
+    }
+    pushIdle(streamID);
+}
+
+void OVInferRequestsQueue::pushIdle(int streamID) {
+    if (!push(streamID)) {
+        SPDLOG_ERROR("Failed to return stream: {}. Idle streams ring is full", streamID);
         return;
     }
-    std::uint32_t old_back = back_idx.load();
-    while (!back_idx.compare_exchange_weak(
-        old_back,
-        (old_back + 1) % streams.size(),
-        std::memory_order_relaxed)) {
+    if (reservedStreams > 0) {
+        idleStreamsCount.fetch_add(1, std::memory_order_release);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waitersCount.load(std::memory_order_relaxed) > 0) {
+        serveWaiters();
+    }
+}
+
+void OVInferRequestsQueue::serveWaiters() {
+    std::vector<std::pair<stream_callback_t, int>> handovers;
+    {
+        std::unique_lock<std::mutex> lk(waitersMutex);
+        const auto now = RequestContext::clock_t::now();
+        while (waiters.size()) {
+            auto it = waiters.begin();
+            if (it->first.deadline != RequestContext::clock_t::time_point::max() && it->first.deadline <= now) {
+                // negative stream id notifies the caller its deadline has passed
+                handovers.emplace_back(std::move(it->second), -1);
+                waiters.erase(it);
+                waitersCount.fetch_sub(1, std::memory_order_relaxed);
+                add(waitingGauge, -1);
+                continue;
+            }
+            int streamID;
+            // pipeline waiters come first, so if the first waiter cannot take a stream neither can the following ones
+            if (!pop(streamID, it->first.pipeline, &it->first.parkedAt)) {
+                break;
+            }
+            handovers.emplace_back(std::move(it->second), streamID);
+            waiters.erase(it);
+            waitersCount.fetch_sub(1, std::memory_order_relaxed);
+            add(waitingGauge, -1);
+        }
+    }
+    // callbacks may return streams themselves
+    for (auto& [callback, streamID] : handovers) {
+        callback(streamID);
     }
-    streams[old_back] = streamID;
 }
 
 }  // namespace ovms
@@ -16,28 +16,138 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <future>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
 
+#include "blobmap.hpp"
+#include "metrics.hpp"
+#include "requestcontext.hpp"
+#include "saturation_tracker.hpp"
+#include "status.hpp"
+
 namespace ovms {
 /**
-* @brief Class representing circular buffer for managing IE streams
+* @brief Class managing IE streams
+*
+* Idle stream ids are kept in a bounded lock-free MPMC ring, so acquiring an idle stream
+* is a single CAS when any stream is available. Callers park, waiting on a future or callback, only when all
+* streams are busy. Parked callers are served by priority, then by earliest deadline,
+* then in arrival order. Callers whose deadline has passed are dropped.
+* Optional admission limits reject callers when too many are already parked
+* or when they would wait longer than allowed.
+* Streams may come from executable networks compiled on several devices, idle streams of all devices
+* share the ring so callers get whichever device has a free infer request.
+* Pipeline node sessions, which hold partial work of already started pipelines, are served before other parked callers,
+* sessions of earlier started pipelines first. Optionally some streams are reserved for them, other callers
+* take a stream only while more than the reserved number of streams is idle.
+* In elastic mode only some infer requests exist, further ones are created while callers are parked
+* and released again when load drops.
 */
 class OVInferRequestsQueue {
 public:
+    /**
+    * @brief How often waiting callers check whether their request was cancelled
+    */
+    static constexpr std::chrono::milliseconds CANCELLATION_POLL_INTERVAL{10};
+
+    struct WaiterKey {
+        bool pipeline = false;
+        int priority = RequestContext::DEFAULT_PRIORITY;
+        // start of pipeline the node session belongs to, not used by other callers
+        RequestContext::clock_t::time_point started;
+        RequestContext::clock_t::time_point deadline = RequestContext::clock_t::time_point::max();
+        uint64_t sequence = 0;
+        // when caller was parked, not part of the order
+        RequestContext::clock_t::time_point parkedAt;
+
+        bool operator<(const WaiterKey& rhs) const {
+            return std::tie(rhs.pipeline, rhs.priority, started, deadline, sequence) < std::tie(pipeline, priority, rhs.started, rhs.deadline, rhs.sequence);
+        }
+    };
+
+    /**
+    * @brief Infer requests created on one of devices the queue spans
+    */
+    struct DeviceStreams {
+        std::string device;
+        InferenceEngine::ExecutableNetwork& network;
+        int streamsLength;
+        // time streams of the device are held by callers, not recorded if null
+        Histogram* requestTime = nullptr;
+    };
+
+    /**
+    * @brief Called with stream id handed over to parked caller, negative when caller deadline has passed
+    */
+    using stream_callback_t = std::function<void(int)>;
+
     /**
     * @brief Allocating idle stream for execution
     */
     std::future<int> getIdleStream();
 
+    /**
+    * @brief Allocating idle stream without waiting
+    *
+    * @return false if all streams are busy
+    */
+    bool tryGetIdleStream(int& streamID);
+
+    /**
+    * @brief Allocating idle stream for pipeline node session without blocking, caller is notified through callback when all streams are busy
+    *
+    * Callback runs on the thread returning the stream, outside of queue locks, so it should not block.
+    * Reserved streams can be taken.
+    *
+    * @param pipelineStarted parked sessions of earlier started pipelines are served first
+    *
+    * @return true if stream was idle and is set in streamID right away, callback is not called then
+    */
+    bool getIdleStreamOrNotify(int& streamID, stream_callback_t callback, WaiterKey& key,
+        RequestContext::clock_t::time_point pipelineStarted = RequestContext::clock_t::time_point());
+
+    /**
+    * @brief Removes caller parked with getIdleStreamOrNotify
+    *
+    * @return false if stream was already handed over, so callback is called or is about to be called
+    */
+    bool cancelWaiter(const WaiterKey& key);
+
+    /**
+    * @brief Allocating idle stream for execution, waiting according to request priority and deadline
+    *
+    * @return REQUEST_DEADLINE_EXCEEDED if deadline passed before any stream was available,
+    * INFER_REQUEST_QUEUE_FULL or INFER_REQUEST_QUEUE_TIMEOUT if rejected by admission limits
+    */
+    Status acquireIdleStream(int& streamID, const RequestContext& context);
+
+    /**
+    * @brief Number of requests rejected by admission limits
+    */
+    uint64_t getRejectedRequestsCount() const {
+        return rejectedRequestsCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @brief Number of callers currently waiting for idle stream
+    */
+    size_t getWaitersCount() const {
+        return waitersCount.load(std::memory_order_relaxed);
+    }
+
     /**
     * @brief Release stream after execution
     */
@@ -45,15 +155,107 @@ public:
 
     /**
     * @brief Constructor with initialization
+    *
+    * @param maxQueueDepth max number of callers waiting for idle stream, 0 means unlimited
+    * @param maxQueueWaitMs max time in milliseconds caller waits for idle stream, 0 means unlimited
+    * @param reservedStreams number of streams only pipeline node sessions can take, lower than number of streams
     */
-    OVInferRequestsQueue(InferenceEngine::ExecutableNetwork& network, int streamsLength) :
-        streams(streamsLength),
-        front_idx{0},
-        back_idx{0} {
-        for (int i = 0; i < streamsLength; ++i) {
-            streams[i] = i;
-            inferRequests.push_back(network.CreateInferRequest());
-        }
+    OVInferRequestsQueue(InferenceEngine::ExecutableNetwork& network, int streamsLength, uint32_t maxQueueDepth = 0, uint32_t maxQueueWaitMs = 0, uint32_t reservedStreams = 0) :
+        OVInferRequestsQueue(std::vector<DeviceStreams>{{std::string(), network, streamsLength}}, maxQueueDepth, maxQueueWaitMs, reservedStreams) {}
+
+    /**
+    * @brief Constructor with infer requests of several devices
+    *
+    * Stream ids of each device are contiguous, idle streams are initially interleaved between devices.
+    *
+    * @param maxQueueDepth max number of callers waiting for idle stream, 0 means unlimited
+    * @param maxQueueWaitMs max time in milliseconds caller waits for idle stream, 0 means unlimited
+    * @param reservedStreams number of streams only pipeline node sessions can take, lower than number of streams
+    */
+    OVInferRequestsQueue(const std::vector<DeviceStreams>& devices, uint32_t maxQueueDepth = 0, uint32_t maxQueueWaitMs = 0, uint32_t reservedStreams = 0);
+
+    ~OVInferRequestsQueue();
+
+    /**
+    * @brief Reports infer requests count, infer requests in use and waiting callers in gauges
+    *
+    * Gauges may be shared by several queues of the same model, queue adds its own counts to them.
+    * Has to be called before the queue is used.
+    *
+    * @param saturation records wait and hold times of infer requests if not null, may be shared by queues as well
+    */
+    void trackUtilization(Gauge* inUse, Gauge* waiting, Gauge* total, SaturationTracker* saturation = nullptr);
+
+    /**
+    * @brief Sets model name and version passed to stream_acquire and stream_release tracepoints
+    *
+    * Has to be called before the queue is used.
+    */
+    void setTracepointLabels(const std::string& modelName, int64_t modelVersion) {
+        tracepointModelName = modelName;
+        tracepointModelVersion = modelVersion;
+    }
+
+    /**
+    * @brief Allocates input blobs once for every infer request and sets them, request data is then written into them in place
+    *
+    * Has to be called before the queue is used.
+    *
+    * @param inputs tensor descriptors of bound inputs by network input name
+    * @param remoteContext context of the device plugin allocating blobs in device memory, host memory is used if empty
+    */
+    Status bindInputBlobs(const std::map<std::string, InferenceEngine::TensorDesc>& inputs, InferenceEngine::RemoteContext::Ptr remoteContext = nullptr);
+
+    /**
+    * @brief Creates infer requests on demand, keeping between minStreams and the number of streams the queue was created with
+    *
+    * Infer requests above minStreams are released right away. Each caller parked because all streams are busy
+    * creates one of them again. Stream returned when no caller had to wait for cooldown is released
+    * while more than minStreams are active, so the queue shrinks as streams are returned after load drops.
+    * Streams reserved for pipelines and one more stream are always kept.
+    * Has to be called after bindInputBlobs, before the queue is used.
+    */
+    void enableElasticity(int minStreams, std::chrono::milliseconds cooldown);
+
+    /**
+    * @brief Number of streams the queue was created with
+    */
+    int getStreamsCount() const {
+        return static_cast<int>(inferRequests.size());
+    }
+
+    /**
+    * @brief Approximate number of idle streams, may already be stale when used for routing decisions
+    */
+    size_t getIdleStreamsCount() const {
+        const size_t enqueued = enqueuePos.load(std::memory_order_relaxed);
+        const size_t dequeued = dequeuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    /**
+    * @brief Number of streams with infer request created
+    */
+    int getActiveStreamsCount() const {
+        return activeStreams.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @brief Estimated memory of input and output blobs of created infer requests, in bytes
+    */
+    uint64_t getMemoryBytes() const {
+        return getActiveStreamsCount() * requestBlobsBytes;
+    }
+
+    bool hasBoundInputBlobs() const {
+        return !boundInputBlobs.empty();
+    }
+
+    /**
+     * @brief Input blobs owned by infer request of stream, by network input name
+     */
+    const BlobMap& getBoundInputBlobs(int streamID) const {
+        return boundInputBlobs[streamID];
     }
 
     /**
@@ -63,31 +265,201 @@ public:
         return inferRequests[streamID];
     }
 
+    /**
+     * @brief Device the infer request of stream was created on, empty for single device queue
+     */
+    const std::string& getStreamDevice(int streamID) const {
+        return devices[streamDevices[streamID]].device;
+    }
+
 protected:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        int streamID;
+    };
+
+    static size_t roundUpToPowerOfTwo(int value) {
+        size_t result = 1;
+        while (result < static_cast<size_t>(value)) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    bool push(int streamID);
+    bool popRing(int& streamID);
+
+    /**
+    * @brief Takes idle stream, leaving reserved streams idle unless taken for pipeline
+    *
+    * @param parkedAt when the caller the stream is handed over to was parked, null if caller did not wait
+    */
+    bool pop(int& streamID, bool pipeline = false, const RequestContext::clock_t::time_point* parkedAt = nullptr);
+
+    /**
+    * @brief Hands idle streams over to parked callers, callbacks are called after releasing waitersMutex
+    */
+    void serveWaiters();
+
+    /**
+    * @brief Puts stream to idle streams ring and serves parked callers
+    */
+    void pushIdle(int streamID);
+
+    /**
+    * @brief Creates infer request of dormant stream for parked caller in elastic mode, called without waitersMutex
+    */
+    void growIfNeeded();
+
+    /**
+    * @brief Releases infer request of returned stream if elastic queue is above minimum and no caller waited for cooldown
+    *
+    * @return true if stream became dormant
+    */
+    bool shrinkIfIdle(int streamID);
+
+    /**
+    * @brief Creates infer request of stream and binds its input blobs
+    */
+    Status createInferRequest(int streamID);
+
+    /**
+    * @brief Releases infer request of stream and its input blobs
+    */
+    void releaseInferRequest(int streamID);
+
+    /**
+    * @brief Allocates input blobs of stream and sets them to its infer request
+    */
+    Status bindStreamInputBlobs(int streamID, BlobMap& blobs);
+
+    /**
+    * @brief Registers parked caller or takes idle stream if it was returned in the meantime, requires waitersMutex
+    *
+    * @param key filled by caller, sequence is assigned here
+    *
+    * @return true if stream was taken
+    */
+    bool registerWaiter(int& streamID, WaiterKey& key, stream_callback_t callback);
+
+    /**
+    * @brief Registers parked caller notified through future, requires waitersMutex
+    */
+    bool registerWaiter(int& streamID, WaiterKey& key, std::future<int>& future);
+
+    /**
+    * @brief Number of cells in the idle streams ring, power of two not lower than number of streams
+    */
+    const size_t capacity;
+
+    /**
+    * @brief Idle streams ring
+    */
+    std::unique_ptr<Cell[]> cells;
+
+    /**
+    * @brief Position of the next push to the ring
+    */
+    alignas(64) std::atomic<size_t> enqueuePos;
+
     /**
-    * @brief Vector representing circular buffer for infer queue
+    * @brief Position of the next pop from the ring
     */
-    std::vector<int> streams;
+    alignas(64) std::atomic<size_t> dequeuePos;
 
     /**
-    * @brief Index of the front of the idle streams list
+    * @brief Number of callers waiting for idle stream
     */
-    std::uint32_t front_idx;
+    alignas(64) std::atomic<size_t> waitersCount;
 
     /**
-    * @brief Index of the back of the idle streams list
+    * @brief Number of streams reserved for pipeline node sessions
     */
-    std::atomic<std::uint32_t> back_idx;
+    const int reservedStreams;
 
     /**
-    * @brief Vector representing OV streams and used for notification about completed inference operations
+    * @brief Number of idle streams not yet claimed, tracked only if streams are reserved
+    *
+    * Increased after stream is pushed to the ring, so stream claimed by decreasing it is in the ring.
     */
-    std::mutex front_mut;
-    std::mutex queue_mutex;
+    alignas(64) std::atomic<int> idleStreamsCount;
+
+    std::mutex waitersMutex;
+    std::map<WaiterKey, stream_callback_t> waiters;
+    uint64_t waitersSequence;
+
+    /**
+    * @brief Admission limits
+    */
+    const uint32_t maxQueueDepth;
+    const std::chrono::milliseconds maxQueueWait;
+    std::atomic<uint64_t> rejectedRequestsCount;
+
     /**
      * 
      */
     std::vector<InferenceEngine::InferRequest> inferRequests;
-    std::queue<std::promise<int>> promises;
+
+    /**
+    * @brief Size of input and output blobs of single infer request, for compiled shapes
+    */
+    uint64_t requestBlobsBytes = 0;
+
+    /**
+    * @brief Input blobs bound to each infer request, empty if inputs are not bound
+    */
+    std::vector<BlobMap> boundInputBlobs;
+
+    /**
+    * @brief Devices the queue spans, index in devices for each stream
+    */
+    std::vector<DeviceStreams> devices;
+    std::vector<size_t> streamDevices;
+
+    /**
+    * @brief Time each stream was last acquired, tracked only if any device records request time or saturation is tracked
+    */
+    bool requestTimeTracked;
+    std::vector<std::chrono::steady_clock::time_point> streamAcquiredAt;
+
+    /**
+    * @brief Elastic mode, streams without infer request are kept in dormantStreams guarded by elasticMutex
+    */
+    bool elastic = false;
+    int minStreams = 0;
+    std::chrono::milliseconds cooldown{0};
+    std::atomic<int> activeStreams;
+    std::atomic<int64_t> lastWaitAt;
+    std::mutex elasticMutex;
+    std::vector<int> dormantStreams;
+
+    /**
+    * @brief Tensor descriptors of bound inputs, used to bind blobs of infer requests created later
+    */
+    std::map<std::string, InferenceEngine::TensorDesc> boundInputs;
+
+    /**
+    * @brief Context of the device plugin bound input blobs are allocated with, empty for host memory
+    */
+    InferenceEngine::RemoteContext::Ptr remoteContext;
+
+    /**
+    * @brief Utilization gauges, not reported if null
+    */
+    Gauge* inUseGauge = nullptr;
+    Gauge* waitingGauge = nullptr;
+    Gauge* totalGauge = nullptr;
+    SaturationTracker* saturation = nullptr;
+
+    std::string tracepointModelName;
+    int64_t tracepointModelVersion = 0;
+
+    static int countStreams(const std::vector<DeviceStreams>& devices) {
+        int count = 0;
+        for (const auto& device : devices) {
+            count += device.streamsLength;
+        }
+        return count;
+    }
 };
 }  // namespace ovms
@@ -0,0 +1,450 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "peer_files.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <utility>
+
+#include <cpprest/http_client.h>
+#include <spdlog/spdlog.h>
+
+#include "absl/strings/escaping.h"
+#include "config.hpp"
+#include "filesystem.hpp"
+#include "stringutils.hpp"
+
+namespace ovms {
+
+namespace {
+
+const size_t READ_BUFFER_SIZE = 1024 * 1024;
+const uint64_t MB = 1024 * 1024;
+// Part sizes of common S3 clients, multipart ETag does not tell which was used
+const uint64_t S3_PART_SIZES_MB[] = {5, 8, 15, 16, 32, 64, 100, 128, 256, 512};
+
+class Md5 {
+    std::array<uint32_t, 4> state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+    std::array<unsigned char, 64> block{};
+    size_t blockSize = 0;
+    uint64_t length = 0;
+
+    static uint32_t rotate(uint32_t x, uint32_t n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    void transform(const unsigned char* data) {
+        static const uint32_t shifts[64] = {
+            7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+            5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+            4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+            6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+        static const uint32_t constants[64] = {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+        uint32_t words[16];
+        for (size_t i = 0; i < 16; ++i) {
+            words[i] = uint32_t(data[i * 4]) | (uint32_t(data[i * 4 + 1]) << 8) | (uint32_t(data[i * 4 + 2]) << 16) | (uint32_t(data[i * 4 + 3]) << 24);
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        for (uint32_t i = 0; i < 64; ++i) {
+            uint32_t f, g;
+            if (i < 16) {
+                f = (b & c) | (~b & d);
+                g = i;
+            } else if (i < 32) {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) % 16;
+            } else if (i < 48) {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) % 16;
+            } else {
+                f = c ^ (b | ~d);
+                g = (7 * i) % 16;
+            }
+            f += a + constants[i] + words[g];
+            a = d;
+            d = c;
+            c = b;
+            b += rotate(f, shifts[i]);
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+    }
+
+public:
+    void update(const char* data, size_t size) {
+        length += size;
+        while (size > 0) {
+            size_t chunk = std::min(size, block.size() - blockSize);
+            std::memcpy(block.data() + blockSize, data, chunk);
+            blockSize += chunk;
+            data += chunk;
+            size -= chunk;
+            if (blockSize == block.size()) {
+                transform(block.data());
+                blockSize = 0;
+            }
+        }
+    }
+
+    // Raw 16 bytes
+    std::string digest() {
+        uint64_t bits = length * 8;
+        const char padding = static_cast<char>(0x80);
+        update(&padding, 1);
+        const char zero = 0;
+        while (blockSize != 56) {
+            update(&zero, 1);
+        }
+        char encodedLength[8];
+        for (size_t i = 0; i < 8; ++i) {
+            encodedLength[i] = static_cast<char>((bits >> (8 * i)) & 0xFF);
+        }
+        update(encodedLength, 8);
+        std::string result(16, '\0');
+        for (size_t i = 0; i < 16; ++i) {
+            result[i] = static_cast<char>((state[i / 4] >> (8 * (i % 4))) & 0xFF);
+        }
+        return result;
+    }
+};
+
+class Crc32c {
+    uint32_t crc = 0xFFFFFFFF;
+
+public:
+    void update(const char* data, size_t size) {
+        static const auto table = []() {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value & 1) ? (value >> 1) ^ 0x82F63B78 : value >> 1;
+                }
+                table[i] = value;
+            }
+            return table;
+        }();
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+    }
+
+    // Big endian 4 bytes, as reported by GCS
+    std::string digest() const {
+        uint32_t value = ~crc;
+        std::string result(4, '\0');
+        for (size_t i = 0; i < 4; ++i) {
+            result[i] = static_cast<char>((value >> (8 * (3 - i))) & 0xFF);
+        }
+        return result;
+    }
+};
+
+std::string toHex(const std::string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (unsigned char c : bytes) {
+        hex += digits[c >> 4];
+        hex += digits[c & 0x0F];
+    }
+    return hex;
+}
+
+bool isHex(const std::string& str) {
+    return std::all_of(str.begin(), str.end(), [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+}
+
+// Calls consumer with consecutive chunks of file, returns false when file could not be read whole
+template <typename Consumer>
+bool readFile(const std::string& path, uint64_t size, Consumer consumer) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    uint64_t remaining = size;
+    while (file && remaining > 0) {
+        auto chunk = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+        file.read(buffer.data(), static_cast<std::streamsize>(chunk));
+        if (static_cast<size_t>(file.gcount()) != chunk) {
+            return false;
+        }
+        consumer(buffer.data(), chunk);
+        remaining -= chunk;
+    }
+    return remaining == 0 && file.peek() == std::ifstream::traits_type::eof();
+}
+
+// S3 ETag is quoted hex MD5 for objects uploaded in single part,
+// for multipart uploads it is hex MD5 of concatenated part MD5s followed by -<parts count>
+struct S3ETag {
+    std::string md5Hex;
+    uint64_t partsCount = 0;
+};
+
+bool parseS3ETag(std::string etag, S3ETag& parsed) {
+    if (etag.size() >= 2 && etag.front() == '"' && etag.back() == '"') {
+        etag = etag.substr(1, etag.size() - 2);
+    }
+    auto separator = etag.find('-');
+    parsed.md5Hex = etag.substr(0, separator);
+    if (parsed.md5Hex.size() != 32 || !isHex(parsed.md5Hex)) {
+        return false;
+    }
+    parsed.partsCount = 0;
+    if (separator == std::string::npos) {
+        return true;
+    }
+    auto count = stou32(etag.substr(separator + 1));
+    if (!count || count.value() == 0) {
+        return false;
+    }
+    parsed.partsCount = count.value();
+    return true;
+}
+
+std::vector<uint64_t> s3PartSizeCandidates(uint64_t size, uint64_t partsCount) {
+    std::vector<uint64_t> candidates;
+    auto matches = [size, partsCount](uint64_t partSize) {
+        return (size + partSize - 1) / partSize == partsCount;
+    };
+    for (auto partSizeMb : S3_PART_SIZES_MB) {
+        if (matches(partSizeMb * MB)) {
+            candidates.push_back(partSizeMb * MB);
+        }
+    }
+    // Part size derived from parts count by clients splitting objects into fixed number of parts
+    uint64_t derived = (size + partsCount - 1) / partsCount;
+    derived = (derived + MB - 1) / MB * MB;
+    if (derived > 0 && matches(derived) && std::find(candidates.begin(), candidates.end(), derived) == candidates.end()) {
+        candidates.push_back(derived);
+    }
+    return candidates;
+}
+
+bool verifyS3ETag(const S3ETag& etag, const std::string& path, uint64_t size) {
+    if (etag.partsCount == 0) {
+        Md5 md5;
+        return readFile(path, size, [&md5](const char* data, size_t chunk) { md5.update(data, chunk); }) && toHex(md5.digest()) == etag.md5Hex;
+    }
+    for (auto partSize : s3PartSizeCandidates(size, etag.partsCount)) {
+        Md5 partsMd5;
+        Md5 partMd5;
+        uint64_t partRemaining = partSize;
+        bool read = readFile(path, size, [&](const char* data, size_t chunk) {
+            while (chunk > 0) {
+                auto consumed = static_cast<size_t>(std::min<uint64_t>(chunk, partRemaining));
+                partMd5.update(data, consumed);
+                data += consumed;
+                chunk -= consumed;
+                partRemaining -= consumed;
+                if (partRemaining == 0) {
+                    partsMd5.update(partMd5.digest().data(), 16);
+                    partMd5 = Md5();
+                    partRemaining = partSize;
+                }
+            }
+        });
+        if (!read) {
+            return false;
+        }
+        if (partRemaining != partSize) {
+            partsMd5.update(partMd5.digest().data(), 16);
+        }
+        if (toHex(partsMd5.digest()) == etag.md5Hex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+PeerFilesClient::PeerFilesClient(std::vector<std::string> peers, uint64_t partSize) :
+    peers(std::move(peers)),
+    partSize(std::max<uint64_t>(partSize, 1)) {}
+
+std::shared_ptr<PeerFilesClient> PeerFilesClient::getInstance() {
+    static std::shared_ptr<PeerFilesClient> instance = []() -> std::shared_ptr<PeerFilesClient> {
+        auto peers = parsePeers(Config::instance().modelPeers());
+        if (peers.empty()) {
+            return nullptr;
+        }
+        SPDLOG_INFO("Remote model files are downloaded from {} peers before cloud storage", peers.size());
+        return std::make_shared<PeerFilesClient>(std::move(peers));
+    }();
+    return instance;
+}
+
+std::vector<std::string> PeerFilesClient::parsePeers(const std::string& peers) {
+    std::vector<std::string> result;
+    for (auto peer : tokenize(peers, ',')) {
+        trim(peer);
+        if (!peer.empty()) {
+            result.push_back(std::move(peer));
+        }
+    }
+    return result;
+}
+
+bool PeerFilesClient::parseKey(const std::string& key, RemoteFileIdentity& identity) {
+    auto sizeSeparator = key.rfind('-');
+    if (sizeSeparator == std::string::npos || sizeSeparator == 0) {
+        return false;
+    }
+    auto contentIdSeparator = key.rfind('-', sizeSeparator - 1);
+    if (contentIdSeparator == std::string::npos || contentIdSeparator == 0) {
+        return false;
+    }
+    auto sizeStr = key.substr(sizeSeparator + 1);
+    auto hex = key.substr(contentIdSeparator + 1, sizeSeparator - contentIdSeparator - 1);
+    if (sizeStr.empty() || !std::all_of(sizeStr.begin(), sizeStr.end(), [](char c) { return c >= '0' && c <= '9'; }) ||
+        hex.size() % 2 != 0 || !isHex(hex)) {
+        return false;
+    }
+    try {
+        identity.size = std::stoull(sizeStr);
+    } catch (const std::exception&) {
+        return false;
+    }
+    identity.storage = key.substr(0, contentIdSeparator);
+    identity.contentId.clear();
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        identity.contentId += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+    }
+    return true;
+}
+
+bool PeerFilesClient::isVerifiable(const std::string& key) {
+    RemoteFileIdentity identity;
+    if (!parseKey(key, identity)) {
+        return false;
+    }
+    S3ETag etag;
+    return identity.storage == "md5" || identity.storage == "gcs-crc32c" ||
+           (identity.storage == "s3" && parseS3ETag(identity.contentId, etag));
+}
+
+bool PeerFilesClient::verify(const std::string& key, const std::string& path) {
+    RemoteFileIdentity identity;
+    if (!parseKey(key, identity)) {
+        return false;
+    }
+    std::error_code ec;
+    if (std::filesystem::file_size(path, ec) != identity.size || ec) {
+        return false;
+    }
+    if (identity.storage == "md5") {
+        Md5 md5;
+        return readFile(path, identity.size, [&md5](const char* data, size_t size) { md5.update(data, size); }) &&
+               absl::Base64Escape(md5.digest()) == identity.contentId;
+    }
+    if (identity.storage == "gcs-crc32c") {
+        Crc32c crc;
+        return readFile(path, identity.size, [&crc](const char* data, size_t size) { crc.update(data, size); }) &&
+               absl::Base64Escape(crc.digest()) == identity.contentId;
+    }
+    S3ETag etag;
+    if (identity.storage == "s3" && parseS3ETag(identity.contentId, etag)) {
+        return verifyS3ETag(etag, path, identity.size);
+    }
+    return false;
+}
+
+bool PeerFilesClient::downloadFromPeer(const std::string& peer, const std::string& key, uint64_t size, const std::string& path) const {
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            SPDLOG_WARN("Unable to create file {} for download from peer", path);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::resize_file(path, size, ec);
+    if (ec) {
+        return false;
+    }
+    web::http::client::http_client_config clientConfig;
+    clientConfig.set_timeout(std::chrono::seconds(60));
+    web::http::client::http_client client(utility::conversions::to_string_t("http://" + peer), clientConfig);
+    size_t partsCount = static_cast<size_t>((size + partSize - 1) / partSize);
+    auto status = FileSystem::runConcurrently(partsCount, PEER_FILE_DOWNLOAD_CONCURRENCY, [&](size_t i) {
+        uint64_t first = i * partSize;
+        uint64_t last = std::min(first + partSize, size) - 1;
+        auto requestPath = "/v1/peer/files/" + key + "/bytes/" + std::to_string(first) + "-" + std::to_string(last);
+        try {
+            auto response = client.request(web::http::methods::GET, utility::conversions::to_string_t(requestPath)).get();
+            if (response.status_code() != web::http::status_codes::OK) {
+                SPDLOG_DEBUG("Peer {} responded with HTTP status {} to {}", peer, response.status_code(), requestPath);
+                return StatusCode::PEER_FILE_NOT_FOUND;
+            }
+            auto body = response.extract_vector().get();
+            if (body.size() != last - first + 1) {
+                return StatusCode::PEER_FILE_RANGE_INVALID;
+            }
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(first));
+            file.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+            if (!file) {
+                return StatusCode::FILE_INVALID;
+            }
+        } catch (const std::exception& e) {
+            SPDLOG_DEBUG("Request {} to peer {} failed: {}", requestPath, peer, e.what());
+            return StatusCode::PEER_FILE_NOT_FOUND;
+        }
+        return StatusCode::OK;
+    });
+    if (status != StatusCode::OK) {
+        return false;
+    }
+    if (!verify(key, path)) {
+        SPDLOG_WARN("File {} downloaded from peer {} does not match storage checksum", key, peer);
+        return false;
+    }
+    return true;
+}
+
+bool PeerFilesClient::download(const std::string& key, const std::string& path) const {
+    RemoteFileIdentity identity;
+    if (peers.empty() || !isVerifiable(key) || !parseKey(key, identity)) {
+        return false;
+    }
+    static thread_local std::mt19937 generator{std::random_device{}()};
+    size_t firstPeer = std::uniform_int_distribution<size_t>(0, peers.size() - 1)(generator);
+    for (size_t i = 0; i < peers.size(); ++i) {
+        const auto& peer = peers[(firstPeer + i) % peers.size()];
+        if (downloadFromPeer(peer, key, identity.size, path)) {
+            SPDLOG_INFO("Downloaded {} bytes of {} from peer {}", identity.size, key, peer);
+            return true;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return false;
+}
+
+}  // namespace ovms
@@ -0,0 +1,94 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ovms {
+
+// Peers refuse longer ranges, so that single request does not hold large buffer
+const uint64_t PEER_FILE_MAX_RANGE_SIZE = 64 * 1024 * 1024;
+const uint64_t PEER_FILE_PART_SIZE = 16 * 1024 * 1024;
+const size_t PEER_FILE_DOWNLOAD_CONCURRENCY = 4;
+
+/**
+ * @brief Identity of remote file content the remote model cache key is built from
+ */
+struct RemoteFileIdentity {
+    std::string storage;
+    std::string contentId;
+    uint64_t size = 0;
+};
+
+/**
+ * @brief Downloads remote model cache files from other server replicas instead of cloud storage
+ *
+ * Peers serve files of their remote model caches by key at REST API path /v1/peer/files/<key>/bytes/<first>-<last>.
+ * File is downloaded in parts concurrently from one peer, peers are tried starting from random one so that replicas
+ * starting together spread the load. Peers are not trusted, downloaded file is used only when it matches
+ * checksum reported by cloud storage, so files identified by ETag only are never downloaded from peers.
+ */
+class PeerFilesClient {
+    const std::vector<std::string> peers;
+    const uint64_t partSize;
+
+    bool downloadFromPeer(const std::string& peer, const std::string& key, uint64_t size, const std::string& path) const;
+
+public:
+    PeerFilesClient(std::vector<std::string> peers, uint64_t partSize = PEER_FILE_PART_SIZE);
+
+    /**
+     * @brief Returns client configured with server parameters, nullptr when no peers are set
+     */
+    static std::shared_ptr<PeerFilesClient> getInstance();
+
+    /**
+     * @brief Splits comma separated host:port addresses
+     */
+    static std::vector<std::string> parsePeers(const std::string& peers);
+
+    /**
+     * @brief Inverse of RemoteFilesCache::makeKey
+     *
+     * @return false if key is malformed
+     */
+    static bool parseKey(const std::string& key, RemoteFileIdentity& identity);
+
+    /**
+     * @brief Checks if content of file with given key can be verified after download from untrusted peer
+     */
+    static bool isVerifiable(const std::string& key);
+
+    /**
+     * @brief Checks file content against checksum in key
+     *
+     * Supports base64 MD5 of Azure and GCS, S3 ETags of objects uploaded in single part or in parts of common sizes
+     * and base64 CRC32C of GCS composite objects.
+     */
+    static bool verify(const std::string& key, const std::string& path);
+
+    /**
+     * @brief Downloads file with given key from the first peer having it and verifies it
+     *
+     * @return true if verified file is at path
+     */
+    bool download(const std::string& key, const std::string& path) const;
+};
+
+}  // namespace ovms
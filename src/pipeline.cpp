@@ -16,7 +16,9 @@
 #include "pipeline.hpp"
 
 #include <algorithm>
+#include <deque>
 #include <map>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -25,7 +27,9 @@
 #include "exit_node.hpp"
 #include "logging.hpp"
 #include "node.hpp"
+#include "ovinferrequestsqueue.hpp"
 #include "pipelineeventqueue.hpp"
+#include "usdt.hpp"
 
 namespace ovms {
 Pipeline::~Pipeline() = default;
@@ -39,10 +43,14 @@ void Pipeline::push(std::unique_ptr<Node> node) {
     nodes.emplace_back(std::move(node));
 }
 void Pipeline::connect(Node& from, Node& to, const Aliases& blobNamesMapping) {
+    connect(from, to, std::make_shared<const Aliases>(blobNamesMapping));
+}
+
+void Pipeline::connect(Node& from, Node& to, SharedAliases blobNamesMapping) {
     SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Connecting from: {}, to: {}", from.getName(), to.getName());
-    printNodeConnections(to.getName(), from.getName(), blobNamesMapping);
+    printNodeConnections(to.getName(), from.getName(), *blobNamesMapping);
     from.addDependant(to);
-    to.addDependency(from, blobNamesMapping);
+    to.addDependency(from, std::move(blobNamesMapping));
 }
 
 void printNodeConnections(const std::string& nodeName, const std::string& sourceNode, const Aliases& pairs) {
@@ -63,13 +71,9 @@ void setFailIfNotFailEarlier(ovms::Status& earlierStatusCode, ovms::Status& newF
     }
 }
 
-#define IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE \
-    if (!firstErrorStatus.ok()) {                                                       \
-        if (finishedSessions.size() == startedSessions.size()) {                        \
-            break;                                                                      \
-        } else {                                                                        \
-            continue;                                                                   \
-        }                                                                               \
+#define IF_ERROR_OCCURRED_EARLIER_THEN_RETURN \
+    if (!firstErrorStatus.ok()) {             \
+        return;                               \
     }
 
 #define CHECK_AND_LOG_ERROR(NODE)                                                                                                          \
@@ -79,128 +83,360 @@ void setFailIfNotFailEarlier(ovms::Status& earlierStatusCode, ovms::Status& newF
             getName(), NODE.getName(), sessionKey, status.getCode(), status.string());                                                     \
     }
 
-Status Pipeline::execute() {
+Status Pipeline::execute(const RequestContext& context) {
+    auto status = start(context);
+    if (!status.ok()) {
+        return status;
+    }
+    // Pipeline thread sleeps until any node session event
+    bool finished = false;
+    while (!finished) {
+        spdlog::trace("Pipeline: {} waiting for message that node finished.", getName());
+        auto contextCheckTime = getContextCheckTime();
+        std::optional<NodeSessionKeyPair> event;
+        if (contextCheckTime) {
+            event = finishedNodeQueue.tryPullUntil(contextCheckTime.value());
+        } else {
+            event = finishedNodeQueue.pull();
+        }
+        finished = event ? processEvent(event.value()) : checkContext();
+    }
+    return firstErrorStatus;
+}
+
+Status Pipeline::start(const RequestContext& context) {
     SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Started execution of pipeline: {}", getName());
-    PipelineEventQueue finishedNodeQueue;
-    ovms::Status firstErrorStatus{ovms::StatusCode::OK};
-    std::set<std::string> startedSessions;
-    std::set<std::string> finishedSessions;
+    this->context = context;
+    increment(metrics.requests);
+    timer.start(EXECUTION);
+    criticalPathSampled = criticalPath && criticalPath->sample();
+    if (criticalPathSampled) {
+        executionStart = std::chrono::steady_clock::now();
+    }
+    span = Span(context.trace, "pipeline");
+    span.setAttribute("pipeline", getName());
+    ovms::Status status = context.check();
+    if (!status.ok()) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Dropping execution of pipeline: {}: {}", getName(), status.string());
+        recordCompletion(status);
+        return status;
+    }
     NodeSessionMetadata meta;
     // entry node does not have setInputsCalled so it has no
     // session created. Here is just assumption that this meta has the same key
     // that the one in EntryNode::execute();
     auto entrySessionKey = meta.getSessionKey();
-    startedSessions.emplace(entry.getName() + entrySessionKey);
-    ovms::Status status = entry.execute(entrySessionKey, finishedNodeQueue);  // first node will triger first message
+    startedSessions.emplace(&entry, entrySessionKey);
+    observeNodeReady(entry);
+    startSessionSpan(entry, entrySessionKey);
+    OVMS_TRACEPOINT(node_session_start, getName().c_str(), int64_t{0}, tracepointRequestId(exit.getResponse()), entry.getName().c_str(), entrySessionKey);
+    status = entry.execute(entrySessionKey, finishedNodeQueue);  // first node will triger first message
     if (!status.ok()) {
         SPDLOG_LOGGER_WARN(dag_executor_logger, "Executing pipeline: {} node: {} failed with: {}",
             getName(), entry.getName(), status.string());
+        recordCompletion(status);
         return status;
     }
-    std::vector<std::pair<std::reference_wrapper<Node>, session_key_t>> deferredNodeSessions;
-    const uint WAIT_FOR_FINISHED_NODE_TIMEOUT_MICROSECONDS = 5000;
-    const uint WAIT_FOR_DEFERRED_NODE_DISARM_TIMEOUT_MICROSECONDS = 500;
-    // process finished session nodes and if no one is finished check if any node session with deferred execution
-    // has necessary resources already
-    while (true) {
-        spdlog::trace("Pipeline: {} waiting for message that node finished.", getName());
-        auto optionallyFinishedNode = finishedNodeQueue.tryPull(WAIT_FOR_FINISHED_NODE_TIMEOUT_MICROSECONDS);
-        if (optionallyFinishedNode) {
-            auto& [finishedNodeRef, sessionKey] = optionallyFinishedNode.value();
-            Node& finishedNode = finishedNodeRef.get();
-            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Pipeline: {} got message that node: {} session: {} finished.", getName(), finishedNode.getName(), sessionKey);
-            finishedSessions.emplace(finishedNode.getName() + sessionKey);
+    return StatusCode::OK;
+}
+
+bool Pipeline::processEvent(NodeSessionKeyPair& event) {
+    handleEvent(event);
+    bool finished = disarmDeferredSessionsIfErrorOccurred();
+    if (finished) {
+        recordCompletion(firstErrorStatus);
+    }
+    return finished;
+}
+
+bool Pipeline::checkContext() {
+    auto status = context.check();
+    if (!status.ok()) {
+        setFailIfNotFailEarlier(firstErrorStatus, status);
+        SPDLOG_LOGGER_WARN(dag_executor_logger, "Executing pipeline: {} stopped waiting for {} deferred node sessions: {}",
+            getName(), deferredNodeSessions.size(), status.string());
+    }
+    bool finished = disarmDeferredSessionsIfErrorOccurred();
+    if (finished) {
+        recordCompletion(firstErrorStatus);
+    }
+    return finished;
+}
+
+void Pipeline::recordSlowRequest(uint64_t executionUs) {
+    SlowRequestRecord record;
+    record.time = std::chrono::system_clock::now();
+    record.durationUs = executionUs;
+    for (const auto& node : nodes) {
+        if (node.get() == &entry || node.get() == &exit) {
+            continue;
+        }
+        const auto& timings = node->getTimings();
+        record.nodes.push_back({node->getName(),
+            timings.sessions.load(std::memory_order_relaxed),
+            timings.inputsWaitUs.load(std::memory_order_relaxed),
+            timings.streamWaitUs.load(std::memory_order_relaxed),
+            timings.executionUs.load(std::memory_order_relaxed),
+            timings.outputBytes.load(std::memory_order_relaxed),
+            timings.shards.load(std::memory_order_relaxed)});
+    }
+    if (entry.getRequest() != nullptr) {
+        record.setInputs(*entry.getRequest());
+    }
+    slowRequests->record(std::move(record));
+}
+
+void Pipeline::observeNodeReady(const Node& node) {
+    if (!criticalPathSampled) {
+        return;
+    }
+    const uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - executionStart).count();
+    // node is ready with its first session
+    nodeTimes.try_emplace(&node, now, now);
+}
+
+void Pipeline::observeNodeFinished(const Node& node) {
+    if (!criticalPathSampled) {
+        return;
+    }
+    const uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - executionStart).count();
+    // node finishes with its last session
+    nodeTimes.try_emplace(&node, now, now).first->second.second = now;
+}
+
+void Pipeline::recordCriticalPathSample() {
+    std::vector<CriticalPathNodeTimes> times;
+    times.reserve(nodeTimes.size());
+    for (const auto& [node, readyAndFinished] : nodeTimes) {
+        times.push_back({node->getName(), readyAndFinished.first, readyAndFinished.second,
+            node->getTimings().streamWaitUs.load(std::memory_order_relaxed)});
+    }
+    criticalPath->record(times);
+}
+
+void Pipeline::startSessionSpan(const Node& node, const session_key_t& sessionKey) {
+    if (!span.isRecording()) {
+        return;
+    }
+    Span sessionSpan(span.getContext(), "node session");
+    sessionSpan.setAttribute("node", node.getName());
+    sessionSpan.setAttribute("session", std::to_string(sessionKey));
+    sessionSpans.emplace(NodeSessionId{&node, sessionKey}, std::move(sessionSpan));
+}
+
+void Pipeline::recordCompletion(const Status& status) {
+    timer.stop(EXECUTION);
+    const uint64_t executionUs = timer.elapsed<std::chrono::microseconds>(EXECUTION);
+    observe(metrics.requestTime, executionUs);
+    if (status.ok() && slowRequests && slowRequests->isSlow(executionUs)) {
+        recordSlowRequest(executionUs);
+    }
+    if (status.ok() && criticalPathSampled) {
+        recordCriticalPathSample();
+    }
+    if (!status.ok() && metrics.requests) {
+        PipelineMetrics::countError(MetricRegistry::getInstance(), getName(), std::to_string(static_cast<int>(status.getCode())));
+    }
+    // sessions disarmed after error do not finish
+    sessionSpans.clear();
+    span.setStatus(status);
+    span.end();
+}
+
+std::optional<RequestContext::clock_t::time_point> Pipeline::getContextCheckTime() const {
+    // Context is polled only while deferred sessions wait for streams, since started inferences finish on their own
+    if (deferredNodeSessions.empty() || !(context.isCancellable() || context.hasDeadline())) {
+        return std::nullopt;
+    }
+    auto contextCheckTime = context.deadline;
+    if (context.isCancellable()) {
+        contextCheckTime = std::min(contextCheckTime, RequestContext::clock_t::now() + OVInferRequestsQueue::CANCELLATION_POLL_INTERVAL);
+    }
+    return contextCheckTime;
+}
+
+bool Pipeline::disarmDeferredSessionsIfErrorOccurred() {
+    if (!firstErrorStatus.ok() && deferredNodeSessions.size() > 0) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Disarming stream id guards of {} deferred node sessions due to previous error in pipeline", deferredNodeSessions.size());
+        for (auto& [nodeRef, sessionKey] : deferredNodeSessions) {
+            auto& node = nodeRef.get();
+            node.disarm(sessionKey);
+            finishedSessions.emplace(&node, sessionKey);
+        }
+        deferredNodeSessions.clear();
+    }
+    if (!firstErrorStatus.ok() && pendingShardSessions.size() > 0) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Dropping {} pending shard sessions due to previous error in pipeline", pendingShardSessions.size());
+        for (auto& [nodeRef, sessionKey] : pendingShardSessions) {
+            finishedSessions.emplace(&nodeRef.get(), sessionKey);
+        }
+        pendingShardSessions.clear();
+    }
+    return startedSessions.size() == finishedSessions.size();
+}
+
+void Pipeline::executeSession(Node& node, const session_key_t& sessionKey) {
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Started execution of pipeline: {} node: {} session: {}", getName(), node.getName(), sessionKey);
+    startSessionSpan(node, sessionKey);
+    OVMS_TRACEPOINT(node_session_start, getName().c_str(), int64_t{0}, tracepointRequestId(exit.getResponse()), node.getName().c_str(), sessionKey);
+    auto status = node.execute(sessionKey, finishedNodeQueue);
+    if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} not ready for execution yet", node.getName(), sessionKey);
+        if (span.isRecording()) {
+            sessionSpans[{&node, sessionKey}].setAttribute("deferred", "true");
+        }
+        deferredNodeSessions.emplace_back(node, sessionKey);
+        status = StatusCode::OK;
+    }
+    CHECK_AND_LOG_ERROR(node)
+}
+
+void Pipeline::startPendingShardSessions() {
+    while (firstErrorStatus.ok() && !pendingShardSessions.empty() && inFlightShardSessions.size() < maxInFlightShards) {
+        Node& node = pendingShardSessions.front().first.get();
+        const session_key_t sessionKey = pendingShardSessions.front().second;
+        if (!node.isSessionReady(sessionKey)) {
+            // session was batched into inference of other shard session and finishes with it
+            pendingShardSessions.pop_front();
+            continue;
+        }
+        auto status = context.check();
+        CHECK_AND_LOG_ERROR(node)
+        if (!firstErrorStatus.ok()) {
+            return;
+        }
+        pendingShardSessions.pop_front();
+        inFlightShardSessions.emplace(&node, sessionKey);
+        executeSession(node, sessionKey);
+    }
+}
+
+void Pipeline::handleEvent(NodeSessionKeyPair& event) {
+    ovms::Status status;
+    // Node sessions push events both when they finish and, if their execution was deferred
+    // because all streams were busy, when stream gets handed over to them.
+    auto& [eventNodeRef, sessionKey] = event;
+    auto deferredIt = std::find_if(deferredNodeSessions.begin(), deferredNodeSessions.end(),
+        [&eventNodeRef = eventNodeRef, &sessionKey = sessionKey](const auto& deferred) {
+            return &deferred.first.get() == &eventNodeRef.get() && deferred.second == sessionKey;
+        });
+    if (deferredIt != deferredNodeSessions.end()) {
+        Node& node = eventNodeRef.get();
+        deferredNodeSessions.erase(deferredIt);
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} got stream id, triggering deferred execution", node.getName(), sessionKey);
+        status = node.execute(sessionKey, finishedNodeQueue);
+        if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
+            deferredNodeSessions.emplace_back(node, sessionKey);
+            status = StatusCode::OK;
+        }
+        CHECK_AND_LOG_ERROR(node)
+        return;
+    }
+    Node& finishedNode = eventNodeRef.get();
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Pipeline: {} got message that node: {} session: {} finished.", getName(), finishedNode.getName(), sessionKey);
+    // Sessions batched into inference of other session may finish before pipeline started them
+    startedSessions.emplace(&finishedNode, sessionKey);
+    finishedSessions.emplace(&finishedNode, sessionKey);
+    // following sessions of finished shard take over its place before pending shard sessions
+    const bool continuesShard = inFlightShardSessions.erase({&finishedNode, sessionKey}) > 0;
+    OVMS_TRACEPOINT(node_session_finish, getName().c_str(), int64_t{0}, tracepointRequestId(exit.getResponse()), finishedNode.getName().c_str(), sessionKey);
+    observeNodeFinished(finishedNode);
+    if (span.isRecording()) {
+        // span ends and is exported once removed
+        sessionSpans.erase({&finishedNode, sessionKey});
+    }
+    if (!firstErrorStatus.ok()) {
+        finishedNode.release(sessionKey);
+    }
+    IF_ERROR_OCCURRED_EARLIER_THEN_RETURN
+    BlobMap finishedNodeOutputBlobMap;
+    SessionResults sessionResults;
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Fetching results of pipeline: {} node: {} session: {}", getName(), finishedNode.getName(), sessionKey);
+    const bool skipped = finishedNode.isSessionSkipped(sessionKey);
+    status = finishedNode.fetchResults(sessionKey, sessionResults);
+    CHECK_AND_LOG_ERROR(finishedNode)
+    IF_ERROR_OCCURRED_EARLIER_THEN_RETURN
+    auto& nextNodesFromFinished = finishedNode.getNextNodes();
+    for (auto& nextNode : nextNodesFromFinished) {
+        if (skipped) {
+            status = nextNode.get().setSkippedInputs(finishedNode, sessionResults);
+            CHECK_AND_LOG_ERROR(nextNode.get())
             if (!firstErrorStatus.ok()) {
-                finishedNode.release(sessionKey);
+                break;
             }
-            IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE
-            BlobMap finishedNodeOutputBlobMap;
-            SessionResults sessionResults;
-            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Fetching results of pipeline: {} node: {} session: {}", getName(), finishedNode.getName(), sessionKey);
-            status = finishedNode.fetchResults(sessionKey, sessionResults);
-            CHECK_AND_LOG_ERROR(finishedNode)
-            IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE
-            auto& nextNodesFromFinished = finishedNode.getNextNodes();
-            for (auto& nextNode : nextNodesFromFinished) {
-                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "setting pipeline: {} node: {} session: {} outputs as inputs for node: {}",
-                    getName(), finishedNode.getName(), sessionKey, nextNode.get().getName());
-                status = nextNode.get().setInputs(finishedNode, sessionResults);
-                CHECK_AND_LOG_ERROR(nextNode.get())
-                if (!firstErrorStatus.ok()) {
-                    break;
-                }
+            continue;
+        }
+        if (&nextNode.get() == &exit && exit.streamsPartialOutputs()) {
+            status = exit.sendPartialOutputs(finishedNode, sessionResults);
+            CHECK_AND_LOG_ERROR(exit)
+            if (!firstErrorStatus.ok()) {
+                break;
             }
-            finishedNodeOutputBlobMap.clear();
-            for (auto& nextNode : nextNodesFromFinished) {
-                auto readySessions = nextNode.get().getReadySessions();
-                for (auto sessionKey : readySessions) {
-                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Started execution of pipeline: {} node: {} session: {}", getName(), nextNode.get().getName(), sessionKey);
-                    startedSessions.emplace(nextNode.get().getName() + sessionKey);
-                    status = nextNode.get().execute(sessionKey, finishedNodeQueue);
-                    if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
-                        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} not ready for execution yet", nextNode.get().getName(), sessionKey);
-                        deferredNodeSessions.emplace_back(nextNode.get(), sessionKey);
-                        status = StatusCode::OK;
-                    }
-                    CHECK_AND_LOG_ERROR(nextNode.get())
-                    if (!firstErrorStatus.ok()) {
-                        break;
-                    }
-                }
+        }
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "setting pipeline: {} node: {} session: {} outputs as inputs for node: {}",
+            getName(), finishedNode.getName(), sessionKey, nextNode.get().getName());
+        status = nextNode.get().setInputs(finishedNode, sessionResults);
+        CHECK_AND_LOG_ERROR(nextNode.get())
+        if (!firstErrorStatus.ok()) {
+            break;
+        }
+    }
+    finishedNodeOutputBlobMap.clear();
+    // demultiplexer which yielded no shards hands empty inputs over directly to nodes gathering its shards
+    const auto* nodesToStart = &nextNodesFromFinished;
+    std::vector<std::reference_wrapper<Node>> nextAndGatheringNodes;
+    if (!finishedNode.getGatheringNodes().empty()) {
+        nextAndGatheringNodes = nextNodesFromFinished;
+        for (auto& gatheringNode : finishedNode.getGatheringNodes()) {
+            if (std::none_of(nextNodesFromFinished.begin(), nextNodesFromFinished.end(),
+                    [&gatheringNode](const auto& nextNode) { return &nextNode.get() == &gatheringNode.get(); })) {
+                nextAndGatheringNodes.push_back(gatheringNode);
             }
-            if (startedSessions.size() == finishedSessions.size()) {
+        }
+        nodesToStart = &nextAndGatheringNodes;
+    }
+    for (auto& nextNode : *nodesToStart) {
+        auto readySessions = nextNode.get().getReadySessions();
+        for (auto sessionKey : readySessions) {
+            status = context.check();
+            CHECK_AND_LOG_ERROR(nextNode.get())
+            if (!firstErrorStatus.ok()) {
                 break;
             }
-        } else {
-            // If error occurred earlier, disarm stream id guards of all deferred nodes and exit
-            if (!firstErrorStatus.ok()) {
-                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Will try to disarm all stream id guards of all {} deferred node sessions due to previous error in pipeline", deferredNodeSessions.size());
-                if (deferredNodeSessions.size() > 0) {
-                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Trying to disarm {} remaining deferred node sessions ...", deferredNodeSessions.size());
-                    for (auto it = deferredNodeSessions.begin(); it != deferredNodeSessions.end();) {
-                        auto& [nodeRef, sessionKey] = *it;
-                        auto& node = nodeRef.get();
-                        if (node.tryDisarm(sessionKey, WAIT_FOR_DEFERRED_NODE_DISARM_TIMEOUT_MICROSECONDS)) {
-                            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Stream id guard disarm of node {} session: {} has succeeded", node.getName(), sessionKey);
-                            finishedSessions.emplace(node.getName() + sessionKey);
-                            it = deferredNodeSessions.erase(it);
-                        } else {
-                            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Cannot disarm stream id guard of node: {}, session: {} yet, will try again later", node.getName(), sessionKey);
-                            it++;
-                        }
+            if (startedSessions.count({&nextNode.get(), sessionKey}) > 0) {
+                // ready session waiting in pending shard sessions
+                continue;
+            }
+            startedSessions.emplace(&nextNode.get(), sessionKey);
+            observeNodeReady(nextNode.get());
+            if (nextNode.get().isSessionSkipped(sessionKey)) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Skipped execution of pipeline: {} node: {} session: {}", getName(), nextNode.get().getName(), sessionKey);
+                nextNode.get().finishSkippedSession(sessionKey, finishedNodeQueue);
+                continue;
+            }
+            if (nextNode.get().finishSessionFromCache(sessionKey, finishedNodeQueue)) {
+                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Finished pipeline: {} node: {} session: {} with cached outputs", getName(), nextNode.get().getName(), sessionKey);
+                continue;
+            }
+            if (maxInFlightShards > 0 && nextNode.get().isShardSession(sessionKey)) {
+                if (inFlightShardSessions.size() >= maxInFlightShards) {
+                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} waits for one of {} shard sessions in flight to finish",
+                        nextNode.get().getName(), sessionKey, inFlightShardSessions.size());
+                    if (continuesShard) {
+                        pendingShardSessions.emplace_front(nextNode.get(), sessionKey);
+                    } else {
+                        pendingShardSessions.emplace_back(nextNode.get(), sessionKey);
                     }
-                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Disarming iteration completed, remaining deferred node sessions count: {}", deferredNodeSessions.size());
-                }
-                // Check for deferred node queue size again to indicate if all nodes got freed
-                if (deferredNodeSessions.size() > 0) {
                     continue;
-                } else {
-                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Disarming all stream id guards of deferred nodes completed, pipeline will shut down");
-                    IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE
                 }
+                inFlightShardSessions.emplace(&nextNode.get(), sessionKey);
             }
-            // else scope could be executed always however it seems most reasonable at the time to
-            // free blocked inferRequests from exeuction first rather than free models for reloading
-            for (auto it = deferredNodeSessions.begin(); it != deferredNodeSessions.end();) {
-                auto& [nodeRef, sessionKey] = *it;
-                auto& node = nodeRef.get();
-                SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Trying to trigger node: {} session: {} execution", node.getName(), sessionKey);
-                status = node.execute(sessionKey, finishedNodeQueue);
-                if (status.ok()) {
-                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} is ready", node.getName(), sessionKey);
-                    it = deferredNodeSessions.erase(it);
-                    continue;
-                }
-                it++;
-                if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
-                    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} not ready for execution yet", node.getName(), sessionKey);
-                    status = StatusCode::OK;
-                } else {
-                    CHECK_AND_LOG_ERROR(node)
-                }
+            executeSession(nextNode.get(), sessionKey);
+            if (!firstErrorStatus.ok()) {
+                break;
             }
         }
     }
-    return firstErrorStatus;
+    startPendingShardSessions();
 }
 }  // namespace ovms
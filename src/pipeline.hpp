@@ -15,14 +15,27 @@
 //*****************************************************************************
 #pragma once
 
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "aliases.hpp"
+#include "critical_path.hpp"
+#include "metrics.hpp"
+#include "pipelineeventqueue.hpp"
+#include "requestcontext.hpp"
+#include "slow_requests.hpp"
 #include "status.hpp"
+#include "timer.hpp"
+#include "tracing.hpp"
 
 namespace ovms {
 
@@ -32,12 +45,63 @@ struct ExitNode;
 
 void printNodeConnections(const std::string& nodeName, const std::string& sourceNode, const Aliases& pairs);
 
+using NodeSessionId = std::pair<const Node*, session_key_t>;
+
+struct NodeSessionIdHash {
+    size_t operator()(const NodeSessionId& id) const {
+        return std::hash<const Node*>()(id.first) ^ (std::hash<session_key_t>()(id.second) * 31);
+    }
+};
+
 class Pipeline {
+    enum : size_t {
+        EXECUTION,
+        TIMER_END
+    };
+
     std::vector<std::unique_ptr<Node>> nodes;
     const std::string name;
     EntryNode& entry;
     ExitNode& exit;
 
+    /**
+     * @brief State of execution
+     */
+    RequestContext context;
+    PipelineEventQueue finishedNodeQueue;
+    Status firstErrorStatus{StatusCode::OK};
+    std::unordered_set<NodeSessionId, NodeSessionIdHash> startedSessions;
+    std::unordered_set<NodeSessionId, NodeSessionIdHash> finishedSessions;
+    std::vector<std::pair<std::reference_wrapper<Node>, session_key_t>> deferredNodeSessions;
+
+    /**
+     * @brief Shard sessions executed at once are limited to maxInFlightShards, further ready ones wait in pending queue
+     *
+     * Sessions continuing shards already in flight are queued first, so shards run through to gathering node
+     * before next shards start, bounding intermediate blobs of large demultiplexer fan-outs.
+     */
+    size_t maxInFlightShards = 0;
+    std::unordered_set<NodeSessionId, NodeSessionIdHash> inFlightShardSessions;
+    std::deque<std::pair<std::reference_wrapper<Node>, session_key_t>> pendingShardSessions;
+    Timer<TIMER_END> timer;
+
+    PipelineMetrics metrics;
+    SlowRequests* slowRequests = nullptr;
+
+    /**
+     * @brief Ready and finish times of nodes in execution sampled for critical path analysis
+     */
+    std::shared_ptr<CriticalPathAnalyzer> criticalPath;
+    bool criticalPathSampled = false;
+    std::chrono::steady_clock::time_point executionStart;
+    std::unordered_map<const Node*, std::pair<uint64_t, uint64_t>> nodeTimes;
+
+    /**
+     * @brief Spans of traced execution and of its node sessions still running
+     */
+    Span span;
+    std::unordered_map<NodeSessionId, Span, NodeSessionIdHash> sessionSpans;
+
 public:
     Pipeline(EntryNode& entry, ExitNode& exit, const std::string& name = "default_name");
 
@@ -48,13 +112,87 @@ public:
     ExitNode& getExit() const { return this->exit; }
 
     static void connect(Node& from, Node& to, const Aliases& blobNamesMapping);
+    static void connect(Node& from, Node& to, SharedAliases blobNamesMapping);
+
+    void setMetrics(const PipelineMetrics& metrics) {
+        this->metrics = metrics;
+    }
+
+    void setSlowRequests(SlowRequests* slowRequests) {
+        this->slowRequests = slowRequests;
+    }
+
+    void setCriticalPath(std::shared_ptr<CriticalPathAnalyzer> criticalPath) {
+        this->criticalPath = std::move(criticalPath);
+    }
+
+    /**
+     * @param maxInFlightShards limit of shard sessions executed at once, 0 disables the limit
+     */
+    void setMaxInFlightShards(size_t maxInFlightShards) {
+        this->maxInFlightShards = maxInFlightShards;
+    }
+
+    /**
+     * @brief Executes the pipeline, scheduling of further nodes stops once request deadline passed or it was cancelled
+     */
+    Status execute(const RequestContext& context = RequestContext());
+
+    /**
+     * @brief Starts execution driven by events rather than by waiting thread, used by PipelineExecutor
+     *
+     * Node session events are passed to onEvent, which has to be set as listener of event queue before.
+     *
+     * @return error if execution could not start, execution is completed then
+     */
+    Status start(const RequestContext& context);
+
+    /**
+     * @brief Handles single node session event
+     *
+     * @return true when all started node sessions finished
+     */
+    bool processEvent(NodeSessionKeyPair& event);
+
+    /**
+     * @brief Checks request context while deferred node sessions wait for streams
+     *
+     * @return true when all started node sessions finished
+     */
+    bool checkContext();
+
+    /**
+     * @brief Time of next context check, empty if none is needed
+     */
+    std::optional<RequestContext::clock_t::time_point> getContextCheckTime() const;
+
+    /**
+     * @brief Status of completed execution
+     */
+    const Status& getStatus() const {
+        return firstErrorStatus;
+    }
+
+    PipelineEventQueue& getEventQueue() {
+        return finishedNodeQueue;
+    }
 
-    Status execute();
     const std::string& getName() const {
         return name;
     }
 
 private:
+    void handleEvent(NodeSessionKeyPair& event);
+    bool disarmDeferredSessionsIfErrorOccurred();
+    void executeSession(Node& node, const session_key_t& sessionKey);
+    void startPendingShardSessions();
+    void recordCompletion(const Status& status);
+    void recordSlowRequest(uint64_t executionUs);
+    void recordCriticalPathSample();
+    void observeNodeReady(const Node& node);
+    void observeNodeFinished(const Node& node);
+    void startSessionSpan(const Node& node, const session_key_t& sessionKey);
+
     std::map<const std::string, bool> prepareStatusMap() const;
 };
 
@@ -0,0 +1,200 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "pipeline_executor.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+#include "logging.hpp"
+#include "pipeline.hpp"
+#include "pipelineeventqueue.hpp"
+
+namespace ovms {
+
+struct PipelineExecutor::Execution : public std::enable_shared_from_this<PipelineExecutor::Execution> {
+    std::unique_ptr<Pipeline> pipeline;
+    RequestContext context;
+    completion_callback_t onCompleted;
+    // keeps execution alive while no task is scheduled and it waits for node session events
+    std::shared_ptr<Execution> self;
+
+    std::mutex mtx;
+    std::queue<NodeSessionKeyPair> events;
+    bool contextCheckRequested = false;
+    bool contextCheckScheduled = false;
+    // set while task handling events is scheduled or running
+    bool processing = true;
+    bool finished = false;
+};
+
+PipelineExecutor::PipelineExecutor(size_t maxWorkers) :
+    workers(maxWorkers),
+    timerThread(&PipelineExecutor::timerRoutine, this) {}
+
+PipelineExecutor::~PipelineExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        stopping = true;
+    }
+    timerSignal.notify_all();
+    timerThread.join();
+}
+
+PipelineExecutor& PipelineExecutor::getInstance() {
+    static PipelineExecutor instance(std::max<size_t>(1, std::thread::hardware_concurrency()));
+    return instance;
+}
+
+void PipelineExecutor::execute(std::unique_ptr<Pipeline> pipeline, const RequestContext& context, completion_callback_t onCompleted) {
+    auto execution = std::make_shared<Execution>();
+    execution->pipeline = std::move(pipeline);
+    execution->context = context;
+    execution->onCompleted = std::move(onCompleted);
+    execution->self = execution;
+    // Listener is owned by pipeline so it cannot hold shared pointer to execution. Events stop
+    // once all started node sessions finished, which is before execution releases itself.
+    Execution* rawExecution = execution.get();
+    execution->pipeline->getEventQueue().setListener([this, rawExecution](NodeSessionKeyPair&& event) {
+        std::unique_lock<std::mutex> lock(rawExecution->mtx);
+        if (rawExecution->finished) {
+            return;
+        }
+        rawExecution->events.push(std::move(event));
+        if (rawExecution->processing) {
+            return;
+        }
+        rawExecution->processing = true;
+        // listener must not be touched after unlocking since execution may complete in the meantime
+        auto execution = rawExecution->shared_from_this();
+        auto* executor = this;
+        lock.unlock();
+        executor->scheduleProcessing(execution);
+    });
+    workers.schedule([this, execution]() {
+        auto status = execution->pipeline->start(execution->context);
+        if (!status.ok()) {
+            complete(execution, status);
+            return;
+        }
+        process(execution);
+    });
+}
+
+void PipelineExecutor::scheduleProcessing(const std::shared_ptr<Execution>& execution) {
+    workers.schedule([this, execution]() {
+        process(execution);
+    });
+}
+
+void PipelineExecutor::process(const std::shared_ptr<Execution>& execution) {
+    auto& pipeline = *execution->pipeline;
+    std::unique_lock<std::mutex> lock(execution->mtx);
+    bool finished = false;
+    while (!finished) {
+        if (execution->contextCheckRequested) {
+            execution->contextCheckRequested = false;
+            lock.unlock();
+            finished = pipeline.checkContext();
+            lock.lock();
+        } else if (!execution->events.empty()) {
+            auto event = std::move(execution->events.front());
+            execution->events.pop();
+            lock.unlock();
+            finished = pipeline.processEvent(event);
+            lock.lock();
+        } else {
+            break;
+        }
+    }
+    if (finished) {
+        lock.unlock();
+        complete(execution, pipeline.getStatus());
+        return;
+    }
+    // pipeline state is still accessed by this task only
+    auto contextCheckTime = pipeline.getContextCheckTime();
+    bool scheduleCheck = contextCheckTime && !execution->contextCheckScheduled;
+    execution->contextCheckScheduled |= scheduleCheck;
+    execution->processing = false;
+    lock.unlock();
+    if (scheduleCheck) {
+        scheduleContextCheck(execution, contextCheckTime.value());
+    }
+}
+
+void PipelineExecutor::complete(const std::shared_ptr<Execution>& execution, const Status& status) {
+    {
+        std::lock_guard<std::mutex> lock(execution->mtx);
+        execution->finished = true;
+        std::queue<NodeSessionKeyPair>().swap(execution->events);
+    }
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Pipeline: {} execution completed: {}", execution->pipeline->getName(), status.string());
+    execution->pipeline.reset();
+    auto onCompleted = std::move(execution->onCompleted);
+    execution->self.reset();
+    onCompleted(status);
+}
+
+void PipelineExecutor::requestContextCheck(const std::shared_ptr<Execution>& execution) {
+    std::unique_lock<std::mutex> lock(execution->mtx);
+    execution->contextCheckScheduled = false;
+    if (execution->finished) {
+        return;
+    }
+    execution->contextCheckRequested = true;
+    if (execution->processing) {
+        return;
+    }
+    execution->processing = true;
+    lock.unlock();
+    scheduleProcessing(execution);
+}
+
+void PipelineExecutor::scheduleContextCheck(const std::shared_ptr<Execution>& execution, RequestContext::clock_t::time_point time) {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        if (stopping) {
+            return;
+        }
+        contextChecks.emplace(time, execution);
+    }
+    timerSignal.notify_one();
+}
+
+void PipelineExecutor::timerRoutine() {
+    std::unique_lock<std::mutex> lock(timerMutex);
+    while (!stopping) {
+        if (contextChecks.empty()) {
+            timerSignal.wait(lock);
+            continue;
+        }
+        auto it = contextChecks.begin();
+        if (it->first > RequestContext::clock_t::now()) {
+            timerSignal.wait_until(lock, it->first);
+            continue;
+        }
+        auto execution = std::move(it->second);
+        contextChecks.erase(it);
+        lock.unlock();
+        requestContextCheck(execution);
+        execution.reset();
+        lock.lock();
+    }
+    contextChecks.clear();
+}
+
+}  // namespace ovms
@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "requestcontext.hpp"
+#include "status.hpp"
+#include "workerpool.hpp"
+
+namespace ovms {
+
+class Pipeline;
+
+/**
+ * @brief Runs pipelines without blocking threads which requested them
+ *
+ * Node session events of a pipeline are handled by tasks on shared worker pool, one task
+ * at a time per pipeline so its state needs no locking, while different pipelines progress in parallel.
+ * No thread waits for inference to finish, so few workers drive many pipelines in flight.
+ */
+class PipelineExecutor {
+public:
+    using completion_callback_t = std::function<void(Status)>;
+
+    PipelineExecutor(size_t maxWorkers);
+    ~PipelineExecutor();
+
+    PipelineExecutor(const PipelineExecutor&) = delete;
+    PipelineExecutor& operator=(const PipelineExecutor&) = delete;
+
+    /**
+     * @brief Gets executor shared by all requests
+     */
+    static PipelineExecutor& getInstance();
+
+    /**
+     * @brief Starts pipeline execution and returns right away
+     *
+     * @param onCompleted called from executor thread with pipeline status once all started node sessions
+     * finished and pipeline is destroyed
+     */
+    void execute(std::unique_ptr<Pipeline> pipeline, const RequestContext& context, completion_callback_t onCompleted);
+
+private:
+    struct Execution;
+
+    void process(const std::shared_ptr<Execution>& execution);
+    void scheduleProcessing(const std::shared_ptr<Execution>& execution);
+    void complete(const std::shared_ptr<Execution>& execution, const Status& status);
+    void requestContextCheck(const std::shared_ptr<Execution>& execution);
+    void scheduleContextCheck(const std::shared_ptr<Execution>& execution, RequestContext::clock_t::time_point time);
+    void timerRoutine();
+
+    WorkerPool workers;
+
+    /**
+     * @brief Context checks of pipelines with node sessions waiting for streams
+     */
+    std::mutex timerMutex;
+    std::condition_variable timerSignal;
+    std::multimap<RequestContext::clock_t::time_point, std::shared_ptr<Execution>> contextChecks;
+    bool stopping = false;
+    std::thread timerThread;
+};
+
+}  // namespace ovms
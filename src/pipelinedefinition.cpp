@@ -15,11 +15,17 @@
 //*****************************************************************************
 #include "pipelinedefinition.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <map>
+#include <mutex>
 #include <set>
 #include <thread>
+#include <utility>
 
+#include "critical_path.hpp"
 #include "custom_node.hpp"
+#include "custom_node_library_state.hpp"
 #include "dl_node.hpp"
 #include "entry_node.hpp"
 #include "exit_node.hpp"
@@ -29,6 +35,8 @@
 #include "pipeline.hpp"
 #include "pipelinedefinitionunloadguard.hpp"
 #include "prediction_service_utils.hpp"
+#include "remote_node.hpp"
+#include "serialization.hpp"
 
 namespace ovms {
 
@@ -41,6 +49,10 @@ Status toNodeKind(const std::string& str, NodeKind& nodeKind) {
         nodeKind = NodeKind::CUSTOM;
         return StatusCode::OK;
     }
+    if (str == REMOTE_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::REMOTE;
+        return StatusCode::OK;
+    }
     SPDLOG_LOGGER_ERROR(modelmanager_logger, "Unsupported node type: {}", str);
     return StatusCode::PIPELINE_NODE_WRONG_KIND_CONFIGURATION;
 }
@@ -68,7 +80,16 @@ Status PipelineDefinition::validate(ModelManager& manager) {
     if (!validationResult.ok()) {
         return validationResult;
     }
+
+    validationResult = validateConditions();
+    if (!validationResult.ok()) {
+        return validationResult;
+    }
     std::unique_lock lock(metadataMtx);
+    validationResult = initializeCustomNodes();
+    if (!validationResult.ok()) {
+        return validationResult;
+    }
     validationResult = updateInputsInfo(manager);
     if (!validationResult.ok()) {
         return validationResult;
@@ -77,6 +98,11 @@ Status PipelineDefinition::validate(ModelManager& manager) {
     if (!validationResult.ok()) {
         return validationResult;
     }
+    validationResult = updateEmptyGatheredInputsInfo(manager);
+    if (!validationResult.ok()) {
+        return validationResult;
+    }
+    buildExecutionPlan();
     lock.unlock();
     notifier.passed = true;
     SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Finished validation of pipeline: {}", getName());
@@ -85,14 +111,49 @@ Status PipelineDefinition::validate(ModelManager& manager) {
     return validationResult;
 }
 
+static bool isSameNodeInfo(const NodeInfo& lhs, const NodeInfo& rhs) {
+    return lhs.kind == rhs.kind &&
+           lhs.nodeName == rhs.nodeName &&
+           lhs.modelName == rhs.modelName &&
+           lhs.modelVersion == rhs.modelVersion &&
+           lhs.outputNameAliases == rhs.outputNameAliases &&
+           lhs.demultiplyCount == rhs.demultiplyCount &&
+           lhs.gatherFromNode == rhs.gatherFromNode &&
+           lhs.library.basePath == rhs.library.basePath &&
+           lhs.library.execute == rhs.library.execute &&
+           lhs.library.executor == rhs.library.executor &&
+           lhs.parameters == rhs.parameters &&
+           lhs.batchShards == rhs.batchShards &&
+           lhs.roiInputs == rhs.roiInputs &&
+           lhs.bindOutputs == rhs.bindOutputs &&
+           lhs.alternativeSources == rhs.alternativeSources &&
+           lhs.outputCacheSizeMb == rhs.outputCacheSizeMb &&
+           lhs.maxInFlightShards == rhs.maxInFlightShards &&
+           lhs.remote == rhs.remote;
+}
+
+bool PipelineDefinition::isReloadRequired(const std::vector<NodeInfo>& nodeInfos, const pipeline_connections_t& connections) const {
+    if (!this->status.isAvailable()) {
+        return true;
+    }
+    return this->connections != connections ||
+           !std::equal(this->nodeInfos.begin(), this->nodeInfos.end(), nodeInfos.begin(), nodeInfos.end(), isSameNodeInfo);
+}
+
 Status PipelineDefinition::reload(ModelManager& manager, const std::vector<NodeInfo>&& nodeInfos, const pipeline_connections_t&& connections) {
-    // block creating new unloadGuards
+    if (!isReloadRequired(nodeInfos, connections)) {
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Pipeline: {} definition did not change, skipping reload", getName());
+        return StatusCode::OK;
+    }
+    // requests are served from the published execution plan until validation of new definition replaces it,
+    // plan of definition which was not available must not be served while reloading
+    if (!this->status.isAvailable()) {
+        std::atomic_store(&this->executionPlan, std::shared_ptr<const ExecutionPlan>());
+    }
     this->status.handle(ReloadEvent());
     resetSubscriptions(manager);
-    while (requestsHandlesCounter > 0) {
-        std::this_thread::sleep_for(std::chrono::microseconds(1));
-    }
 
+    this->customNodesStates.clear();
     this->nodeInfos = std::move(nodeInfos);
     this->connections = std::move(connections);
     makeSubscriptions(manager);
@@ -106,12 +167,18 @@ void PipelineDefinition::retire(ModelManager& manager) {
     while (requestsHandlesCounter > 0) {
         std::this_thread::sleep_for(std::chrono::microseconds(1));
     }
+    std::atomic_store(&this->executionPlan, std::shared_ptr<const ExecutionPlan>());
+    this->customNodesStates.clear();
     this->nodeInfos.clear();
     this->connections.clear();
 }
 
 Status PipelineDefinition::waitForLoaded(std::unique_ptr<PipelineDefinitionUnloadGuard>& unloadGuard, const uint waitForLoadedTimeoutMicroseconds) {
     unloadGuard = std::make_unique<PipelineDefinitionUnloadGuard>(*this);
+    if (status.getStateCode() == PipelineDefinitionStateCode::RELOADING && std::atomic_load(&executionPlan)) {
+        SPDLOG_DEBUG("Pipeline definition: {} is reloading, using previous definition", getName());
+        return StatusCode::OK;
+    }
 
     const uint waitLoadedTimestepMicroseconds = 100;
     const uint waitCheckpoints = waitForLoadedTimeoutMicroseconds / waitLoadedTimestepMicroseconds;
@@ -159,72 +226,286 @@ Status PipelineDefinition::waitForLoaded(std::unique_ptr<PipelineDefinitionUnloa
 Status PipelineDefinition::create(std::unique_ptr<Pipeline>& pipeline,
     const tensorflow::serving::PredictRequest* request,
     tensorflow::serving::PredictResponse* response,
-    ModelManager& manager) {
+    ModelManager& manager,
+    const std::shared_ptr<BlobArenaPool>& arenaPool) {
     std::unique_ptr<PipelineDefinitionUnloadGuard> unloadGuard;
     Status status = waitForLoaded(unloadGuard);
     if (!status.ok()) {
         return status;
     }
 
-    std::unordered_map<std::string, std::unique_ptr<Node>> nodes;
+    auto plan = std::atomic_load(&executionPlan);
+    if (!plan) {
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Requested pipeline: {} has no execution plan", getName());
+        return StatusCode::PIPELINE_DEFINITION_NOT_LOADED_YET;
+    }
+
+    // unrequested outputs are not served and nodes computing only them are not created
+    std::shared_ptr<const tensor_map_t> outputsInfo = plan->outputsInfo;
+    std::vector<bool> required(plan->nodes.size(), true);
+    if (request->output_filter_size() > 0) {
+        auto requestedOutputs = std::make_shared<tensor_map_t>();
+        status = filterRequestedOutputs(*request, *plan->outputsInfo, *requestedOutputs);
+        if (!status.ok()) {
+            return status;
+        }
+        required = getRequiredNodes(*plan, *requestedOutputs);
+        outputsInfo = std::move(requestedOutputs);
+    }
+
+    std::vector<std::unique_ptr<Node>> nodes(plan->nodes.size());
     EntryNode* entry = nullptr;
     ExitNode* exit = nullptr;
-
-    for (const auto& info : nodeInfos) {
+    // all intermediate blobs of this request share an arena which returns to the pool once they are gone
+    std::shared_ptr<InferenceEngine::IAllocator> arena = (arenaPool ? arenaPool : blobArenaPool)->acquire();
+
+    for (size_t i = 0; i < plan->nodes.size(); ++i) {
+        const auto& info = plan->nodes[i];
+        if (!required[i]) {
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Creating pipeline: {}. Skipping nodeName: {} not producing requested outputs",
+                getName(), info.nodeName);
+            continue;
+        }
         SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Creating pipeline: {}. Adding nodeName: {}, modelName: {}",
             getName(), info.nodeName, info.modelName);
         switch (info.kind) {
         case NodeKind::ENTRY: {
-            auto node = std::make_unique<EntryNode>(request, getInputsInfo(), info.demultiplyCount);
+            auto node = std::make_unique<EntryNode>(request, plan->inputsInfo, info.demultiplyCount);
             entry = node.get();
-            nodes.emplace(info.nodeName, std::move(node));
+            nodes[i] = std::move(node);
             break;
         }
         case NodeKind::DL:
-            nodes.emplace(info.nodeName, std::make_unique<DLNode>(
-                                             info.nodeName,
-                                             info.modelName,
-                                             info.modelVersion,
-                                             manager,
-                                             info.outputNameAliases,
-                                             info.demultiplyCount,
-                                             info.gatherFromNode));
+            nodes[i] = std::make_unique<DLNode>(
+                info.nodeName,
+                info.modelName,
+                info.modelVersion,
+                manager,
+                info.outputNameAliases,
+                info.demultiplyCount,
+                info.gatherFromNode,
+                info.batchShards,
+                info.roiInputs,
+                info.bindOutputs,
+                plan->handedOverOutputs[i]);
             break;
         case NodeKind::CUSTOM:
-            nodes.emplace(info.nodeName, std::make_unique<CustomNode>(
-                                             info.nodeName,
-                                             info.library,
-                                             info.parameters,
-                                             info.outputNameAliases,
-                                             info.demultiplyCount,
-                                             info.gatherFromNode));
+            nodes[i] = std::make_unique<CustomNode>(
+                info.nodeName,
+                info.library,
+                info.parameters,
+                info.outputNameAliases,
+                info.demultiplyCount,
+                info.gatherFromNode,
+                plan->librariesStates[i]);
+            break;
+        case NodeKind::REMOTE:
+            nodes[i] = std::make_unique<RemoteNode>(
+                info.nodeName,
+                info.modelName,
+                info.modelVersion,
+                plan->remoteClients[i],
+                info.outputNameAliases,
+                info.demultiplyCount,
+                info.gatherFromNode);
             break;
         case NodeKind::EXIT: {
-            auto node = std::make_unique<ExitNode>(response, getOutputsInfo(), info.gatherFromNode);
+            auto node = std::make_unique<ExitNode>(response, outputsInfo, info.gatherFromNode);
+            if (!info.alternativeSources.empty()) {
+                node->setAlternativeSources(info.alternativeSources);
+            }
             exit = node.get();
-            nodes.emplace(info.nodeName, std::move(node));
+            nodes[i] = std::move(node);
             break;
         }
         default:
             SPDLOG_LOGGER_ERROR(dag_executor_logger, "Requested pipeline: {} contains unknown node kind", getName());
             throw std::invalid_argument("unknown node kind");
         }
+        nodes[i]->setMetrics(plan->nodesMetrics[i]);
+        nodes[i]->setBlobAllocator(arena);
+        nodes[i]->setOutputCache(plan->outputCaches[i]);
+    }
+    for (const auto& connection : plan->connections) {
+        if (!required[connection.dependency] || !required[connection.dependant]) {
+            continue;
+        }
+        auto& dependencyNode = *nodes[connection.dependency];
+        auto& dependantNode = *nodes[connection.dependant];
+        if (&dependantNode == exit && outputsInfo != plan->outputsInfo) {
+            auto mapping = std::make_shared<Aliases>();
+            for (const auto& alias : *connection.mapping) {
+                if (outputsInfo->count(alias.second) > 0) {
+                    mapping->push_back(alias);
+                }
+            }
+            if (mapping->empty()) {
+                continue;
+            }
+            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Connecting pipeline: {}, from: {}, to: {}", getName(), dependencyNode.getName(), dependantNode.getName());
+            Pipeline::connect(dependencyNode, dependantNode, std::move(mapping));
+            continue;
+        }
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Connecting pipeline: {}, from: {}, to: {}", getName(), dependencyNode.getName(), dependantNode.getName());
+        Pipeline::connect(dependencyNode, dependantNode, connection.mapping);
     }
-    for (const auto& kv : connections) {
-        const auto& dependantNode = nodes.at(kv.first);
-        for (const auto& pair : kv.second) {
-            const auto& dependencyNode = nodes.at(pair.first);
-            SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Connecting pipeline: {}, from: {}, to: {}", getName(), dependencyNode->getName(), dependantNode->getName());
-            Pipeline::connect(*dependencyNode, *dependantNode, pair.second);
+    for (const auto& emptyGather : plan->emptyGathers) {
+        if (!required[emptyGather.demultiplexer] || !required[emptyGather.gathering]) {
+            continue;
         }
+        nodes[emptyGather.demultiplexer]->addGatheringNode(*nodes[emptyGather.gathering]);
+        nodes[emptyGather.gathering]->setEmptyGatheredInputsInfo(emptyGather.inputsInfo);
     }
     pipeline = std::make_unique<Pipeline>(*entry, *exit, pipelineName);
-    for (auto& kv : nodes) {
-        pipeline->push(std::move(kv.second));
+    pipeline->setMetrics(plan->metrics);
+    pipeline->setSlowRequests(plan->slowRequests);
+    pipeline->setCriticalPath(plan->criticalPath);
+    pipeline->setMaxInFlightShards(plan->maxInFlightShards);
+    for (auto& node : nodes) {
+        if (node) {
+            pipeline->push(std::move(node));
+        }
     }
     return status;
 }
 
+std::vector<bool> PipelineDefinition::getRequiredNodes(const ExecutionPlan& plan, const tensor_map_t& requestedOutputs) {
+    std::vector<bool> required(plan.nodes.size(), false);
+    std::vector<size_t> pending;
+    size_t exitIndex = 0;
+    for (size_t i = 0; i < plan.nodes.size(); ++i) {
+        // entry node starts every pipeline
+        if (plan.nodes[i].kind == NodeKind::ENTRY) {
+            required[i] = true;
+        } else if (plan.nodes[i].kind == NodeKind::EXIT) {
+            exitIndex = i;
+            pending.push_back(i);
+        }
+    }
+    while (!pending.empty()) {
+        const size_t nodeIndex = pending.back();
+        pending.pop_back();
+        if (required[nodeIndex]) {
+            continue;
+        }
+        required[nodeIndex] = true;
+        for (const auto& connection : plan.connections) {
+            if (connection.dependant != nodeIndex) {
+                continue;
+            }
+            const bool producesRequestedOutput = nodeIndex != exitIndex ||
+                                                 std::any_of(connection.mapping->begin(), connection.mapping->end(),
+                                                     [&requestedOutputs](const auto& alias) { return requestedOutputs.count(alias.second) > 0; });
+            if (producesRequestedOutput) {
+                pending.push_back(connection.dependency);
+            }
+        }
+    }
+    for (size_t i = 0; i < plan.nodes.size(); ++i) {
+        if (!required[i] && plan.nodes[exitIndex].gatherFromNode.count(plan.nodes[i].nodeName) > 0) {
+            return std::vector<bool>(plan.nodes.size(), true);
+        }
+    }
+    return required;
+}
+
+void PipelineDefinition::buildExecutionPlan() {
+    auto plan = std::make_shared<ExecutionPlan>();
+    std::unordered_map<std::string, size_t> nodeIndexes;
+    plan->nodes.reserve(nodeInfos.size());
+    plan->nodesMetrics.reserve(nodeInfos.size());
+    plan->librariesStates.reserve(nodeInfos.size());
+    plan->outputCaches.reserve(nodeInfos.size());
+    plan->remoteClients.reserve(nodeInfos.size());
+    plan->handedOverOutputs.reserve(nodeInfos.size());
+    plan->metrics = PipelineMetrics::create(MetricRegistry::getInstance(), getName());
+    plan->slowRequests = &SlowRequestsLog::instance().getPipeline(getName());
+    for (const auto& info : nodeInfos) {
+        if (info.kind == NodeKind::ENTRY) {
+            plan->maxInFlightShards = info.maxInFlightShards;
+        }
+        nodeIndexes.emplace(info.nodeName, plan->nodes.size());
+        plan->nodes.push_back(info);
+        plan->nodesMetrics.push_back(NodeMetrics::create(MetricRegistry::getInstance(), getName(), info.nodeName));
+        auto state = customNodesStates.find(info.nodeName);
+        plan->librariesStates.push_back(state != customNodesStates.end() ? state->second : nullptr);
+        const bool cacheable = (info.kind == NodeKind::DL || info.kind == NodeKind::CUSTOM || info.kind == NodeKind::REMOTE) && info.outputCacheSizeMb > 0;
+        plan->outputCaches.push_back(cacheable ? std::make_shared<NodeOutputCache>(static_cast<size_t>(info.outputCacheSizeMb) * 1024 * 1024) : nullptr);
+        plan->remoteClients.push_back(info.kind == NodeKind::REMOTE ? RemoteModelClient::get(info.remote) : nullptr);
+        std::set<std::string> handedOverOutputs;
+        auto compatibility = outputsLayoutCompatibility.find(info.nodeName);
+        if (compatibility != outputsLayoutCompatibility.end()) {
+            for (const auto& [outputName, compatible] : compatibility->second) {
+                if (compatible) {
+                    handedOverOutputs.insert(outputName);
+                }
+            }
+        }
+        if (!handedOverOutputs.empty() && !info.bindOutputs) {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Pipeline: {} node: {} hands over {} outputs to following nodes without copy",
+                getName(), info.nodeName, handedOverOutputs.size());
+        }
+        plan->handedOverOutputs.push_back(std::move(handedOverOutputs));
+    }
+    for (const auto& [dependantName, dependencies] : connections) {
+        for (const auto& [dependencyName, mapping] : dependencies) {
+            plan->connections.push_back({nodeIndexes.at(dependencyName), nodeIndexes.at(dependantName), std::make_shared<const Aliases>(mapping)});
+        }
+    }
+    for (const auto& [nodeName, gatheredInputsInfo] : emptyGatheredInputsInfo) {
+        const auto& info = findNodeByName(nodeName);
+        plan->emptyGathers.push_back({nodeIndexes.at(*info.gatherFromNode.begin()), nodeIndexes.at(nodeName), gatheredInputsInfo});
+    }
+    std::vector<std::string> nodeNames;
+    std::vector<std::pair<size_t, size_t>> nodeConnections;
+    for (const auto& info : plan->nodes) {
+        nodeNames.push_back(info.nodeName);
+    }
+    for (const auto& connection : plan->connections) {
+        nodeConnections.emplace_back(connection.dependency, connection.dependant);
+    }
+    plan->criticalPath = std::make_shared<CriticalPathAnalyzer>(std::move(nodeNames), nodeConnections);
+    plan->inputsInfo = std::make_shared<const tensor_map_t>(inputsInfo);
+    plan->outputsInfo = std::make_shared<const tensor_map_t>(outputsInfo);
+    std::atomic_store(&executionPlan, std::shared_ptr<const ExecutionPlan>(std::move(plan)));
+}
+
+Status PipelineDefinition::initializeCustomNodes() {
+    for (const auto& info : nodeInfos) {
+        if (info.kind != NodeKind::CUSTOM || customNodesStates.count(info.nodeName)) {
+            continue;
+        }
+        std::shared_ptr<CustomNodeLibraryState> state;
+        auto status = CustomNodeLibraryState::create(info.library, info.parameters, state);
+        if (!status.ok()) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Pipeline: {} failed to initialize custom node: {}", getName(), info.nodeName);
+            return status;
+        }
+        if (state) {
+            customNodesStates.emplace(info.nodeName, std::move(state));
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status PipelineDefinition::fetchRemoteModelsMetadata() {
+    remoteModelsMetadata.clear();
+    for (const auto& info : nodeInfos) {
+        if (info.kind != NodeKind::REMOTE) {
+            continue;
+        }
+        RemoteModelMetadata metadata;
+        auto status = RemoteModelClient::get(info.remote)->getMetadata(info.modelName, info.modelVersion, metadata);
+        if (!status.ok()) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Pipeline: {} node: {} refers to unavailable remote model: {} at: {}",
+                getName(), info.nodeName, info.modelName, info.remote.address);
+            return status;
+        }
+        remoteModelsMetadata.emplace(info.nodeName, std::move(metadata));
+    }
+    return StatusCode::OK;
+}
+
 void PipelineDefinition::resetSubscriptions(ModelManager& manager) {
     for (auto& [modelName, modelVersion] : subscriptions) {
         if (modelVersion) {
@@ -276,12 +557,52 @@ void PipelineDefinition::makeSubscriptions(ModelManager& manager) {
     }
 }
 
+static std::shared_ptr<TensorInfo> createDynamicTensorInfo(const std::shared_ptr<TensorInfo>& tensorInfo, bool dynamicBatch, bool dynamicShape) {
+    auto shape = tensorInfo->getShape();
+    if (dynamicShape) {
+        std::fill(shape.begin(), shape.end(), 0);
+    } else if (dynamicBatch && !shape.empty()) {
+        shape[0] = 0;
+    } else {
+        return tensorInfo;
+    }
+    auto copy = std::make_shared<TensorInfo>(*tensorInfo);
+    copy->setShape(shape);
+    return copy;
+}
+
+/**
+ * @brief Gets model inputs with dimensions changed at execution by batch size or shape set to auto set to 0, so they match any value
+ */
+static tensor_map_t getPipelineModelInputsInfo(const ModelInstance& instance) {
+    const auto& config = instance.getModelConfig();
+    tensor_map_t inputsInfo;
+    for (const auto& [name, tensorInfo] : instance.getInputsInfo()) {
+        inputsInfo[name] = createDynamicTensorInfo(tensorInfo, config.getBatchingMode() == Mode::AUTO, config.isShapeAuto(name));
+    }
+    return inputsInfo;
+}
+
+/**
+ * @brief Gets model outputs with dimensions which may follow changed input shapes set to 0
+ */
+static tensor_map_t getPipelineModelOutputsInfo(const ModelInstance& instance) {
+    const auto& config = instance.getModelConfig();
+    tensor_map_t outputsInfo;
+    for (const auto& [name, tensorInfo] : instance.getOutputsInfo()) {
+        outputsInfo[name] = createDynamicTensorInfo(tensorInfo, config.getBatchingMode() == Mode::AUTO, config.anyShapeSetToAuto());
+    }
+    return outputsInfo;
+}
+
 class NodeValidator {
     const std::string& pipelineName;
     ModelManager& manager;
     const NodeInfo& dependantNodeInfo;
     const pipeline_connections_t& connections;
     const std::vector<NodeInfo>& nodeInfos;
+    const std::unordered_map<std::string, RemoteModelMetadata>& remoteModelsMetadata;
+    std::unordered_map<std::string, std::map<std::string, bool>>& outputsLayoutCompatibility;
     const bool isMultiBatchAllowed;
 
     std::unique_ptr<ModelInstanceUnloadGuard> dependantModelUnloadGuard;
@@ -298,12 +619,16 @@ public:
         const NodeInfo& dependantNodeInfo,
         const pipeline_connections_t& connections,
         const std::vector<NodeInfo>& nodeInfos,
+        const std::unordered_map<std::string, RemoteModelMetadata>& remoteModelsMetadata,
+        std::unordered_map<std::string, std::map<std::string, bool>>& outputsLayoutCompatibility,
         const bool isMultiBatchAllowed = true) :
         pipelineName(pipelineName),
         manager(manager),
         dependantNodeInfo(dependantNodeInfo),
         connections(connections),
         nodeInfos(nodeInfos),
+        remoteModelsMetadata(remoteModelsMetadata),
+        outputsLayoutCompatibility(outputsLayoutCompatibility),
         isMultiBatchAllowed(isMultiBatchAllowed) {
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Validation of pipeline: {}; node name: {}; node kind: {}",
             pipelineName,
@@ -350,18 +675,6 @@ public:
         return StatusCode::OK;
     }
 
-    Status checkForForbiddenDynamicParameters() {
-        const auto& config = dependantModelInstance->getModelConfig();
-        if (config.getBatchingMode() == Mode::AUTO || config.anyShapeSetToAuto()) {
-            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Validation of pipeline: {} definition failed. Node name: {} used model name: {} with dynamic batch/shape parameter which is forbidden.",
-                pipelineName,
-                dependantNodeInfo.nodeName,
-                dependantNodeInfo.modelName);
-            return StatusCode::FORBIDDEN_MODEL_DYNAMIC_PARAMETER;
-        }
-        return StatusCode::OK;
-    }
-
     Status checkForRestrictedBatchSize() {
         if (!isMultiBatchAllowed) {
             for (auto& [inputName, tensorInfo] : this->inputsInfo) {
@@ -381,6 +694,35 @@ public:
         return StatusCode::OK;
     }
 
+    Status validateRoiInputs() {
+        for (const auto& [imageInputName, coordinatesInputName] : dependantNodeInfo.roiInputs) {
+            auto it = this->inputsInfo.find(imageInputName);
+            if (it == this->inputsInfo.end() || it->second->getEffectiveShape().size() != 4 ||
+                (it->second->getLayout() != InferenceEngine::Layout::NCHW && it->second->getLayout() != InferenceEngine::Layout::NHWC)) {
+                SPDLOG_LOGGER_ERROR(modelmanager_logger, "Validation of pipeline: {} definition failed. Node: {} region of interest input: {} is not 4 dimensional NCHW or NHWC model input",
+                    pipelineName, dependantNodeInfo.nodeName, imageInputName);
+                return StatusCode::PIPELINE_INVALID_ROI_INPUT;
+            }
+            if (this->inputsInfo.count(coordinatesInputName) > 0) {
+                SPDLOG_LOGGER_ERROR(modelmanager_logger, "Validation of pipeline: {} definition failed. Node: {} region of interest coordinates input: {} is already model input",
+                    pipelineName, dependantNodeInfo.nodeName, coordinatesInputName);
+                return StatusCode::PIPELINE_INVALID_ROI_INPUT;
+            }
+        }
+        // Coordinates are additional inputs of the node, not passed to the model
+        for (const auto& [imageInputName, coordinatesInputName] : dependantNodeInfo.roiInputs) {
+            this->inputsInfo.emplace(coordinatesInputName,
+                std::make_shared<TensorInfo>(coordinatesInputName, InferenceEngine::Precision::FP32, shape_t{1, 4}, InferenceEngine::Layout::NC));
+        }
+        return StatusCode::OK;
+    }
+
+    bool isRoiInput(const std::string& name) const {
+        return std::any_of(dependantNodeInfo.roiInputs.begin(), dependantNodeInfo.roiInputs.end(), [&name](const auto& roiInput) {
+            return roiInput.first == name || roiInput.second == name;
+        });
+    }
+
     Status validateGatherNode(const NodeInfo& dependantNodeInfo) const {
         for (const auto& gather : dependantNodeInfo.gatherFromNode) {
             auto it = std::find_if(nodeInfos.begin(), nodeInfos.end(), [gather](const NodeInfo& nodeInfo) { return nodeInfo.nodeName == gather; });
@@ -414,7 +756,7 @@ public:
         }
 
         // If dependency node is of type DL model, make sure there is underlying model output present.
-        if (dependencyNodeInfo.kind == NodeKind::DL || dependencyNodeInfo.kind == NodeKind::CUSTOM) {
+        if (dependencyNodeInfo.kind == NodeKind::DL || dependencyNodeInfo.kind == NodeKind::CUSTOM || dependencyNodeInfo.kind == NodeKind::REMOTE) {
             // Check whether underlying model contains required output.
             const auto& modelOutputName = dependencyNodeInfo.outputNameAliases.at(dataSource);
             if (this->dependencyOutputsInfo.count(modelOutputName) == 0) {
@@ -468,6 +810,14 @@ public:
         return StatusCode::OK;
     }
 
+    Status validateDemultiplexedOutputShape(const shape_t& shape, const NodeInfo& demultiplicatorNodeInfo) const {
+        // with dynamic demultiplexing output with single element is passed to every shard
+        if (demultiplicatorNodeInfo.demultiplyCount && demultiplicatorNodeInfo.demultiplyCount.value() == 0 && shape.size() >= 3 && shape[0] == 1) {
+            return StatusCode::OK;
+        }
+        return validateShapeWithDemultiplexer(shape, demultiplicatorNodeInfo);
+    }
+
     Status influenceShapeWithDemultiplexer(shape_t& shape, const NodeInfo& demultiplicatorNodeInfo) {
         auto result = validateShapeWithDemultiplexer(shape, demultiplicatorNodeInfo);
         if (!result.ok()) {
@@ -499,10 +849,19 @@ public:
         shape_t tensorInputShape = tensorInput->getEffectiveShape();
         shape_t tensorOutputShape = tensorOutput->getEffectiveShape();
         if (dependencyNodeInfo.demultiplyCount) {
-            auto result = influenceShapeWithDemultiplexer(tensorOutputShape, dependencyNodeInfo);
+            auto result = validateDemultiplexedOutputShape(tensorOutputShape, dependencyNodeInfo);
             if (!result.ok()) {
                 return result;
             }
+            tensorOutputShape.erase(tensorOutputShape.begin());
+        }
+        // Batched inference results are split back into shards of batch 1
+        if (dependencyNodeInfo.batchShards && tensorOutputShape.size() > 0) {
+            tensorOutputShape[0] = 1;
+        }
+        if (dependantNodeInfo.batchShards && dependantNodeInfo.gatherFromNode.empty() &&
+            tensorInputShape.size() > 0 && tensorOutputShape.size() > 0 && tensorOutputShape[0] == 1) {
+            tensorInputShape[0] = 1;
         }
         if (dependantNodeInfo.gatherFromNode.size() == 1) {
             std::vector<NodeInfo>::const_iterator demultiplicatorNode;
@@ -526,7 +885,9 @@ public:
                 dependantNodeInfo.nodeName);
             return StatusCode::PIPELINE_MANUAL_GATHERING_FROM_MULTIPLE_NODES_NOT_SUPPORTED;
         }
-        if (!areShapesMatching(tensorInputShape, tensorOutputShape)) {
+        // Region of interest is resized to model input shape, only number of dimensions has to match
+        const bool isRoiImageInput = dependantNodeInfo.roiInputs.count(modelInputName) > 0;
+        if (isRoiImageInput ? tensorInputShape.size() != tensorOutputShape.size() : !areShapesMatching(tensorInputShape, tensorOutputShape)) {
             SPDLOG_LOGGER_ERROR(modelmanager_logger, "Validation of pipeline: {} definition failed. Shape mismatch between: dependant node: {}; input: {}; shape: {} vs dependency node: {}; output: {}; shape: {}",
                 pipelineName,
                 dependantNodeInfo.nodeName,
@@ -601,8 +962,27 @@ public:
         return StatusCode::OK;
     }
 
+    void negotiateOutputLayout(const NodeInfo& dependencyNodeInfo, const std::string& alias, const std::string& modelInputName) {
+        // output is handed over only if no node using it needs a copy of it in other layout
+        bool compatible = false;
+        if (dependantNodeInfo.kind == NodeKind::DL) {
+            const auto& tensorInput = this->inputsInfo.at(modelInputName);
+            const auto& tensorOutput = this->dependencyOutputsInfo.at(dependencyNodeInfo.outputNameAliases.at(alias));
+            compatible = tensorInput->getLayout() == tensorOutput->getLayout();
+            if (!compatible) {
+                SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Pipeline: {} node: {} output: {} in layout: {} is copied for node: {} input: {} in layout: {}",
+                    pipelineName, dependencyNodeInfo.nodeName, alias, TensorInfo::getStringFromLayout(tensorOutput->getLayout()),
+                    dependantNodeInfo.nodeName, modelInputName, TensorInfo::getStringFromLayout(tensorInput->getLayout()));
+            }
+        }
+        auto [it, inserted] = outputsLayoutCompatibility[dependencyNodeInfo.nodeName].emplace(alias, compatible);
+        if (!inserted) {
+            it->second = it->second && compatible;
+        }
+    }
+
     Status validateConnection(const NodeInfo& dependencyNodeInfo, const Aliases& mapping) {
-        // At this point dependency node can only be either DL model node, Custom node or entry node.
+        // At this point dependency node can only be either DL model node, Custom node, Remote model node or entry node.
         // Take care when adding new node types.
         std::unique_ptr<ModelInstanceUnloadGuard> dependencyModelUnloadGuard;
         std::shared_ptr<ModelInstance> dependencyModelInstance;
@@ -629,8 +1009,27 @@ public:
             }
         }
 
+        if (dependencyNodeInfo.kind == NodeKind::REMOTE) {
+            const auto& metadata = remoteModelsMetadata.at(dependencyNodeInfo.nodeName);
+            this->dependencyInputsInfo = metadata.inputsInfo;
+            this->dependencyOutputsInfo = metadata.outputsInfo;
+        }
+
         for (const auto& [alias, realName] : mapping) {
-            if (dependantNodeInfo.kind == NodeKind::DL || dependantNodeInfo.kind == NodeKind::CUSTOM) {
+            if (realName == NODE_CONDITION_INPUT_NAME) {
+                // condition is not a model input, any single element tensor can be used
+                auto result = checkConnectionMappedToExistingDataSource(dependencyNodeInfo, alias);
+                if (!result.ok()) {
+                    return result;
+                }
+                continue;
+            }
+            if (dependencyNodeInfo.kind == NodeKind::ENTRY && dependantNodeInfo.kind == NodeKind::DL && isRoiInput(realName)) {
+                SPDLOG_LOGGER_ERROR(modelmanager_logger, "Validation of pipeline: {} definition failed. Node: {} region of interest input: {} cannot be connected to pipeline input",
+                    pipelineName, dependantNodeInfo.nodeName, realName);
+                return StatusCode::PIPELINE_INVALID_ROI_INPUT;
+            }
+            if (dependantNodeInfo.kind == NodeKind::DL || dependantNodeInfo.kind == NodeKind::CUSTOM || dependantNodeInfo.kind == NodeKind::REMOTE) {
                 auto result = markInputAsConnected(realName);
                 if (!result.ok()) {
                     return result;
@@ -643,13 +1042,16 @@ public:
             }
 
             if (
-                (dependantNodeInfo.kind == NodeKind::DL || dependantNodeInfo.kind == NodeKind::CUSTOM) &&
-                (dependencyNodeInfo.kind == NodeKind::DL || dependencyNodeInfo.kind == NodeKind::CUSTOM)) {
+                (dependantNodeInfo.kind == NodeKind::DL || dependantNodeInfo.kind == NodeKind::CUSTOM || dependantNodeInfo.kind == NodeKind::REMOTE) &&
+                (dependencyNodeInfo.kind == NodeKind::DL || dependencyNodeInfo.kind == NodeKind::CUSTOM || dependencyNodeInfo.kind == NodeKind::REMOTE)) {
                 result = checkConnectionMetadataCorrectness(dependencyNodeInfo, realName, dependencyNodeInfo.outputNameAliases.at(alias));
                 if (!result.ok()) {
                     return result;
                 }
             }
+            if (dependencyNodeInfo.kind == NodeKind::DL) {
+                negotiateOutputLayout(dependencyNodeInfo, alias, realName);
+            }
         }
 
         return StatusCode::OK;
@@ -657,8 +1059,8 @@ public:
 
     Status retrieveDependantMetadata() {
         if (dependantNodeInfo.kind == NodeKind::DL) {
-            this->inputsInfo = this->dependantModelInstance->getInputsInfo();
-            this->outputsInfo = this->dependantModelInstance->getOutputsInfo();
+            this->inputsInfo = getPipelineModelInputsInfo(*this->dependantModelInstance);
+            this->outputsInfo = getPipelineModelOutputsInfo(*this->dependantModelInstance);
             return StatusCode::OK;
         } else if (dependantNodeInfo.kind == NodeKind::CUSTOM) {
             auto result = PipelineDefinition::getCustomNodeMetadata(
@@ -677,13 +1079,17 @@ public:
             if (!result.ok()) {
                 return result;
             }
+        } else if (dependantNodeInfo.kind == NodeKind::REMOTE) {
+            const auto& metadata = remoteModelsMetadata.at(dependantNodeInfo.nodeName);
+            this->inputsInfo = metadata.inputsInfo;
+            this->outputsInfo = metadata.outputsInfo;
         }
         return StatusCode::OK;
     }
 
     void retrieveModelNodeDependencyMetadata(const std::shared_ptr<ModelInstance>& dependencyModelInstance) {
-        this->dependencyInputsInfo = dependencyModelInstance->getInputsInfo();
-        this->dependencyOutputsInfo = dependencyModelInstance->getOutputsInfo();
+        this->dependencyInputsInfo = getPipelineModelInputsInfo(*dependencyModelInstance);
+        this->dependencyOutputsInfo = getPipelineModelOutputsInfo(*dependencyModelInstance);
     }
 
     Status retrieveCustomNodeDependencyMetadata(const NodeInfo& dependencyNodeInfo) {
@@ -718,12 +1124,12 @@ public:
                 return result;
             }
 
-            result = checkForForbiddenDynamicParameters();
+            result = checkForRestrictedBatchSize();
             if (!result.ok()) {
                 return result;
             }
 
-            result = checkForRestrictedBatchSize();
+            result = validateRoiInputs();
             if (!result.ok()) {
                 return result;
             }
@@ -750,9 +1156,23 @@ public:
             prepareRemainingUnconnectedDependantInputsSet();
         }
 
-        if (dependantNodeInfo.kind == NodeKind::DL || dependantNodeInfo.kind == NodeKind::CUSTOM) {
+        if (dependantNodeInfo.kind == NodeKind::REMOTE) {
+            auto result = retrieveDependantMetadata();
+            if (!result.ok()) {
+                return result;
+            }
+
+            result = checkForRestrictedBatchSize();
+            if (!result.ok()) {
+                return result;
+            }
+
+            prepareRemainingUnconnectedDependantInputsSet();
+        }
+
+        if (dependantNodeInfo.kind == NodeKind::DL || dependantNodeInfo.kind == NodeKind::CUSTOM || dependantNodeInfo.kind == NodeKind::REMOTE) {
             for (const auto& [name, tensorOutput] : outputsInfo) {
-                auto result = validateShapeWithDemultiplexer(tensorOutput->getEffectiveShape(), dependantNodeInfo);
+                auto result = validateDemultiplexedOutputShape(tensorOutput->getEffectiveShape(), dependantNodeInfo);
                 if (!result.ok()) {
                     return result;
                 }
@@ -792,7 +1212,7 @@ public:
 };
 
 Status PipelineDefinition::validateNode(ModelManager& manager, const NodeInfo& dependantNodeInfo, const bool isMultiBatchAllowed) {
-    NodeValidator validator(this->pipelineName, manager, dependantNodeInfo, connections, nodeInfos, isMultiBatchAllowed);
+    NodeValidator validator(this->pipelineName, manager, dependantNodeInfo, connections, nodeInfos, remoteModelsMetadata, outputsLayoutCompatibility, isMultiBatchAllowed);
     return validator.validate();
 }
 
@@ -929,6 +1349,28 @@ Status PipelineDefinition::validateDemultiplexerGatherNodesOrder() {
     return StatusCode::OK;
 }
 
+Status PipelineDefinition::validateConditions() {
+    const bool hasDemultiplexing = std::any_of(nodeInfos.begin(), nodeInfos.end(), [](const NodeInfo& info) {
+        return info.demultiplyCount || !info.gatherFromNode.empty();
+    });
+    if (!hasDemultiplexing) {
+        return StatusCode::OK;
+    }
+    for (const auto& [dependantNodeName, allMappings] : connections) {
+        for (const auto& [dependencyNodeName, mapping] : allMappings) {
+            for (const auto& [alias, realName] : mapping) {
+                if (realName == NODE_CONDITION_INPUT_NAME) {
+                    // skipped shards would leave gaps in gathered inputs
+                    SPDLOG_LOGGER_ERROR(modelmanager_logger, "Validation of pipeline: {} definition failed. Node: {} has condition, which cannot be used with demultiplexing",
+                        getName(), dependantNodeName);
+                    return StatusCode::PIPELINE_INVALID_CONDITION;
+                }
+            }
+        }
+    }
+    return StatusCode::OK;
+}
+
 Status PipelineDefinition::validateNodes(ModelManager& manager) {
     SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Validation of pipeline definition: {} nodes started.", getName());
 
@@ -977,6 +1419,13 @@ Status PipelineDefinition::validateNodes(ModelManager& manager) {
         return StatusCode::NOT_IMPLEMENTED;
     }
 
+    auto status = fetchRemoteModelsMetadata();
+    if (!status.ok()) {
+        return status;
+    }
+
+    outputsLayoutCompatibility.clear();
+
     const bool isMultiBatchAllowed = !std::any_of(nodeInfos.begin(), nodeInfos.end(), [](const auto& node) { return node.demultiplyCount; });
     for (const auto& node : nodeInfos) {
         auto findByName = [node](const NodeInfo& nodeInfo) {
@@ -1012,6 +1461,15 @@ std::shared_ptr<TensorInfo> applyDemultiplexerShapeForTensor(const std::shared_p
     return tensorInfo->createCopyWithEffectiveDimensionPrefix(demultiplyCount);
 }
 
+std::shared_ptr<TensorInfo> createShardTensorInfo(const std::shared_ptr<TensorInfo>& tensorInfo) {
+    shape_t shape = tensorInfo->getEffectiveShape();
+    if (shape.size() == 0) {
+        return tensorInfo;
+    }
+    shape[0] = 1;
+    return tensorInfo->createCopyWithNewShape(shape);
+}
+
 std::shared_ptr<TensorInfo> createOutputTensorInfoForPipeline(const std::string& mappedName, const std::shared_ptr<TensorInfo>& tensorInfo, const shape_t& gatherShape, bool isConnectionFromDemultiplexer) {
     std::shared_ptr<TensorInfo> newOwnedTensorInfo;
     if (gatherShape.size() == 0) {
@@ -1029,6 +1487,11 @@ std::shared_ptr<TensorInfo> createOutputTensorInfoForPipeline(const std::string&
     return newOwnedTensorInfo;
 }
 
+// Node condition provided directly in request is a single I32 element
+static std::shared_ptr<TensorInfo> getConditionTensorInfo() {
+    return std::make_shared<TensorInfo>("", InferenceEngine::Precision::I32, shape_t{1});
+}
+
 Status PipelineDefinition::updateInputsInfo(const ModelManager& manager) {
     // Assumptions: this can only be called on available pipeline definition.
     // Add check if available when pipeline status will be implemented.
@@ -1066,8 +1529,16 @@ Status PipelineDefinition::updateInputsInfo(const ModelManager& manager) {
                     return status;
                 }
 
+                const auto modelInputsInfo = getPipelineModelInputsInfo(*instance);
                 for (const auto& [alias, realName] : specificDependencyMapping) {
-                    auto tensorInfo = std::make_shared<TensorInfo>(*instance->getInputsInfo().at(realName));
+                    if (realName == NODE_CONDITION_INPUT_NAME) {
+                        inputsInfo.insert({alias, getConditionTensorInfo()});
+                        continue;
+                    }
+                    auto tensorInfo = std::make_shared<TensorInfo>(*modelInputsInfo.at(realName));
+                    if (dependantNodeInfo->batchShards) {
+                        tensorInfo = createShardTensorInfo(tensorInfo);
+                    }
                     auto it = inputsInfo.find(alias);
                     if (it != inputsInfo.end()) {
                         // Already exists in map
@@ -1097,6 +1568,10 @@ Status PipelineDefinition::updateInputsInfo(const ModelManager& manager) {
                 }
 
                 for (const auto& [alias, realName] : specificDependencyMapping) {
+                    if (realName == NODE_CONDITION_INPUT_NAME) {
+                        inputsInfo.insert({alias, getConditionTensorInfo()});
+                        continue;
+                    }
                     auto tensorInfo = std::make_shared<TensorInfo>(*info.at(realName));
                     auto it = inputsInfo.find(alias);
                     if (it != inputsInfo.end()) {
@@ -1116,6 +1591,31 @@ Status PipelineDefinition::updateInputsInfo(const ModelManager& manager) {
                 }
                 break;
             }
+            case NodeKind::REMOTE: {
+                const auto& remoteInputsInfo = remoteModelsMetadata.at(dependantNodeInfo->nodeName).inputsInfo;
+                for (const auto& [alias, realName] : specificDependencyMapping) {
+                    if (realName == NODE_CONDITION_INPUT_NAME) {
+                        inputsInfo.insert({alias, getConditionTensorInfo()});
+                        continue;
+                    }
+                    auto tensorInfo = std::make_shared<TensorInfo>(*remoteInputsInfo.at(realName));
+                    auto it = inputsInfo.find(alias);
+                    if (it != inputsInfo.end()) {
+                        // Already exists in map
+                        if (tensorInfo->isTensorUnspecified()) {
+                            continue;
+                        }
+                        if (!it->second->isTensorSpecEqual(*tensorInfo) &&
+                            !it->second->isTensorUnspecified()) {
+                            Status result = StatusCode::PIPELINE_INPUTS_AMBIGUOUS_METADATA;
+                            SPDLOG_ERROR(result.string());
+                            return result;
+                        }
+                    }
+                    inputsInfo[alias] = tensorInfo;
+                }
+                break;
+            }
             default: {
                 // Pipeline validation does not allow connections into entry node.
                 SPDLOG_ERROR("Unexpected dependant node kind (name: {})", this->getName());
@@ -1146,9 +1646,14 @@ Status PipelineDefinition::populateOutputsInfoWithDLModelOutputs(const NodeInfo&
         SPDLOG_DEBUG("Model: {} was unavailable during pipeline: {} outputs info fetching", instance->getName(), this->getName());
         return status;
     }
+    const auto modelOutputsInfo = getPipelineModelOutputsInfo(*instance);
     for (const auto& [alias, realName] : specificDependencyMapping) {
         const auto& finalName = dependencyNodeInfo.outputNameAliases.count(alias) > 0 ? dependencyNodeInfo.outputNameAliases.at(alias) : alias;
-        outputsInfo[realName] = createOutputTensorInfoForPipeline(realName, instance->getOutputsInfo().at(finalName), gatherShape, dependencyNodeInfo.demultiplyCount.has_value());
+        auto tensorInfo = modelOutputsInfo.at(finalName);
+        if (dependencyNodeInfo.batchShards) {
+            tensorInfo = createShardTensorInfo(tensorInfo);
+        }
+        outputsInfo[realName] = createOutputTensorInfoForPipeline(realName, tensorInfo, gatherShape, dependencyNodeInfo.demultiplyCount.has_value());
     }
     return StatusCode::OK;
 }
@@ -1169,6 +1674,28 @@ Status PipelineDefinition::populateOutputsInfoWithCustomNodeOutputs(const NodeIn
     return StatusCode::OK;
 }
 
+Status PipelineDefinition::populateOutputsInfoWithRemoteModelOutputs(const NodeInfo& dependencyNodeInfo, tensor_map_t& outputsInfo, const Aliases& specificDependencyMapping, const shape_t& gatherShape) const {
+    const auto& remoteOutputsInfo = remoteModelsMetadata.at(dependencyNodeInfo.nodeName).outputsInfo;
+    for (const auto& [alias, realName] : specificDependencyMapping) {
+        const auto& finalName = dependencyNodeInfo.outputNameAliases.count(alias) > 0 ? dependencyNodeInfo.outputNameAliases.at(alias) : alias;
+        outputsInfo[realName] = createOutputTensorInfoForPipeline(realName, remoteOutputsInfo.at(finalName), gatherShape, dependencyNodeInfo.demultiplyCount.has_value());
+    }
+    return StatusCode::OK;
+}
+
+Status PipelineDefinition::mergeOutputsInfo(const tensor_map_t& dependencyOutputsInfo) {
+    for (const auto& [outputName, tensorInfo] : dependencyOutputsInfo) {
+        auto it = outputsInfo.find(outputName);
+        // output with alternative sources needs to be the same whichever of them is executed
+        if (it != outputsInfo.end() && !it->second->isTensorUnspecified() && !it->second->isTensorSpecEqual(*tensorInfo)) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Pipeline: {} nodes connected to output: {} produce different tensor metadata", getName(), outputName);
+            return StatusCode::PIPELINE_OUTPUTS_AMBIGUOUS_METADATA;
+        }
+        outputsInfo[outputName] = tensorInfo;
+    }
+    return StatusCode::OK;
+}
+
 Status PipelineDefinition::updateOutputsInfo(const ModelManager& manager) {
     // Assumptions: this can only be called on available pipeline definition.
     // Add check if available when pipeline status will be implemented.
@@ -1197,16 +1724,39 @@ Status PipelineDefinition::updateOutputsInfo(const ModelManager& manager) {
                 break;
             }
             case NodeKind::DL: {
+                tensor_map_t dependencyOutputsInfo;
                 auto status = populateOutputsInfoWithDLModelOutputs(
-                    *dependencyNodeInfo, manager, outputsInfo, specificDependencyMapping, gatherShape);
+                    *dependencyNodeInfo, manager, dependencyOutputsInfo, specificDependencyMapping, gatherShape);
+                if (!status.ok()) {
+                    return status;
+                }
+                status = mergeOutputsInfo(dependencyOutputsInfo);
                 if (!status.ok()) {
                     return status;
                 }
                 break;
             }
             case NodeKind::CUSTOM: {
+                tensor_map_t dependencyOutputsInfo;
                 auto status = populateOutputsInfoWithCustomNodeOutputs(
-                    *dependencyNodeInfo, manager, outputsInfo, specificDependencyMapping, gatherShape);
+                    *dependencyNodeInfo, manager, dependencyOutputsInfo, specificDependencyMapping, gatherShape);
+                if (!status.ok()) {
+                    return status;
+                }
+                status = mergeOutputsInfo(dependencyOutputsInfo);
+                if (!status.ok()) {
+                    return status;
+                }
+                break;
+            }
+            case NodeKind::REMOTE: {
+                tensor_map_t dependencyOutputsInfo;
+                auto status = populateOutputsInfoWithRemoteModelOutputs(
+                    *dependencyNodeInfo, dependencyOutputsInfo, specificDependencyMapping, gatherShape);
+                if (!status.ok()) {
+                    return status;
+                }
+                status = mergeOutputsInfo(dependencyOutputsInfo);
                 if (!status.ok()) {
                     return status;
                 }
@@ -1223,7 +1773,66 @@ Status PipelineDefinition::updateOutputsInfo(const ModelManager& manager) {
     return StatusCode::OK;
 }
 
+Status PipelineDefinition::updateEmptyGatheredInputsInfo(const ModelManager& manager) {
+    emptyGatheredInputsInfo.clear();
+    for (const auto& info : nodeInfos) {
+        if (info.gatherFromNode.size() != 1) {
+            continue;
+        }
+        const auto& demultiplexer = findNodeByName(*info.gatherFromNode.begin());
+        // only dynamic demultiplexers can yield no shards
+        if (!demultiplexer.demultiplyCount || demultiplexer.demultiplyCount.value() != 0) {
+            continue;
+        }
+        tensor_map_t gatheredInputsInfo;
+        bool shapesKnown = true;
+        for (const auto& [dependencyNodeName, specificDependencyMapping] : connections.at(info.nodeName)) {
+            const auto& dependencyNodeInfo = findNodeByName(dependencyNodeName);
+            Status status;
+            if (dependencyNodeInfo.kind == NodeKind::DL) {
+                status = populateOutputsInfoWithDLModelOutputs(dependencyNodeInfo, manager, gatheredInputsInfo, specificDependencyMapping, {0});
+            } else if (dependencyNodeInfo.kind == NodeKind::CUSTOM) {
+                status = populateOutputsInfoWithCustomNodeOutputs(dependencyNodeInfo, manager, gatheredInputsInfo, specificDependencyMapping, {0});
+            } else if (dependencyNodeInfo.kind == NodeKind::REMOTE) {
+                status = populateOutputsInfoWithRemoteModelOutputs(dependencyNodeInfo, gatheredInputsInfo, specificDependencyMapping, {0});
+            } else {
+                shapesKnown = false;
+                break;
+            }
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        if (!shapesKnown) {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Pipeline: {} node: {} gathers pipeline inputs, requests without shards of node: {} will fail",
+                getName(), info.nodeName, demultiplexer.nodeName);
+            continue;
+        }
+        emptyGatheredInputsInfo.emplace(info.nodeName, std::make_shared<const tensor_map_t>(std::move(gatheredInputsInfo)));
+    }
+    return StatusCode::OK;
+}
+
+static tensor_map_t copyTensorMap(const tensor_map_t& tensorMap) {
+    tensor_map_t copy;
+    for (const auto& [name, tensorInfo] : tensorMap) {
+        copy.emplace(name, std::make_shared<TensorInfo>(*tensorInfo));
+    }
+    return copy;
+}
+
 Status PipelineDefinition::getCustomNodeMetadata(const NodeInfo& customNodeInfo, tensor_map_t& inputsInfo, metadata_fn callback, const std::string& pipelineName) {
+    static std::mutex cacheMtx;
+    static std::map<std::pair<metadata_fn, std::map<std::string, std::string>>, tensor_map_t> cache;
+    auto key = std::make_pair(callback, std::map<std::string, std::string>(customNodeInfo.parameters.begin(), customNodeInfo.parameters.end()));
+    std::unique_lock<std::mutex> lock(cacheMtx);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        inputsInfo = copyTensorMap(it->second);
+        return StatusCode::OK;
+    }
+    lock.unlock();
+
     struct CustomNodeTensorInfo* info = nullptr;
     int infoCount = 0;
     auto paramArray = createCustomNodeParamArray(customNodeInfo.parameters);
@@ -1234,7 +1843,13 @@ Status PipelineDefinition::getCustomNodeMetadata(const NodeInfo& customNodeInfo,
             customNodeInfo.nodeName, pipelineName, result);
         return StatusCode::NODE_LIBRARY_METADATA_FAILED;
     }
-    return createTensorInfoMap(info, infoCount, inputsInfo, customNodeInfo.library.release);
+    auto status = createTensorInfoMap(info, infoCount, inputsInfo, customNodeInfo.library.release);
+    if (!status.ok()) {
+        return status;
+    }
+    lock.lock();
+    cache.emplace(std::move(key), copyTensorMap(inputsInfo));
+    return status;
 }
 
 const NodeInfo& PipelineDefinition::findNodeByName(const std::string& name) const {
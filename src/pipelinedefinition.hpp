@@ -28,19 +28,29 @@
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/get_model_metadata.pb.h"
+#include "tensorflow_serving/apis/get_model_status.pb.h"
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
 #include "aliases.hpp"
+#include "blob_arena.hpp"
+#include "metrics.hpp"
 #include "modelversion.hpp"
+#include "node_output_cache.hpp"
 #include "nodeinfo.hpp"
 #include "pipelinedefinitionstatus.hpp"
 #include "pipelinedefinitionunloadguard.hpp"
+#include "remote_model_client.hpp"
+#include "service_response_cache.hpp"
+#include "slow_requests.hpp"
 #include "status.hpp"
 #include "tensorinfo.hpp"
 
 namespace ovms {
 
+class CriticalPathAnalyzer;
+class CustomNodeLibraryState;
 class ModelManager;
 class Pipeline;
 
@@ -77,6 +87,8 @@ class PipelineDefinition {
 protected:
     tensor_map_t inputsInfo;
     tensor_map_t outputsInfo;
+    // inputs of nodes gathering dynamic demultiplexer shards when it yields none, by node name
+    std::unordered_map<std::string, std::shared_ptr<const tensor_map_t>> emptyGatheredInputsInfo;
 
 private:
     mutable std::shared_mutex metadataMtx;
@@ -94,8 +106,90 @@ protected:
 private:
     std::set<std::pair<const std::string, model_version_t>> subscriptions;
 
+    /**
+     * @brief Nodes and connections resolved once per validation so that create does not look nodes up
+     * by name nor copy tensor infos for every request
+     *
+     * Plan owns copies of node infos and mappings, so reload can replace the definition while requests
+     * keep creating pipelines from the previously published plan.
+     */
+    struct ExecutionPlan {
+        struct Connection {
+            size_t dependency;
+            size_t dependant;
+            SharedAliases mapping;
+        };
+        std::vector<NodeInfo> nodes;
+        // histograms of nodes, in order of nodes
+        std::vector<NodeMetrics> nodesMetrics;
+        PipelineMetrics metrics;
+        SlowRequests* slowRequests = nullptr;
+        // samples of executions, dropped with the plan
+        std::shared_ptr<CriticalPathAnalyzer> criticalPath;
+        // library states of custom nodes in order of nodes, empty for other nodes
+        std::vector<std::shared_ptr<CustomNodeLibraryState>> librariesStates;
+        // outputs caches in order of nodes, empty for nodes without cache_size_mb, dropped with the plan
+        std::vector<std::shared_ptr<NodeOutputCache>> outputCaches;
+        // clients of remote model nodes in order of nodes, empty for other nodes
+        std::vector<std::shared_ptr<RemoteModelClient>> remoteClients;
+        // outputs of DL nodes handed over to following DL nodes without copy, in order of nodes
+        std::vector<std::set<std::string>> handedOverOutputs;
+        std::vector<Connection> connections;
+        struct EmptyGather {
+            size_t demultiplexer;
+            size_t gathering;
+            std::shared_ptr<const tensor_map_t> inputsInfo;
+        };
+        // gathering nodes completing branches of dynamic demultiplexers which yield no shards
+        std::vector<EmptyGather> emptyGathers;
+        size_t maxInFlightShards = 0;
+        std::shared_ptr<const tensor_map_t> inputsInfo;
+        std::shared_ptr<const tensor_map_t> outputsInfo;
+        // metadata does not change until the plan is replaced
+        mutable ServiceResponseCache<tensorflow::serving::GetModelMetadataResponse> metadataResponseCache;
+    };
+    std::shared_ptr<const ExecutionPlan> executionPlan;
+
+    // last status response, keyed by state code
+    ServiceResponseCache<tensorflow::serving::GetModelStatusResponse> statusResponseCache;
+
+    // custom node library states by node name, kept across revalidations until definition is reloaded or retired
+    std::unordered_map<std::string, std::shared_ptr<CustomNodeLibraryState>> customNodesStates;
+
+    // metadata of remote models by node name, fetched from their servers on each validation
+    std::unordered_map<std::string, RemoteModelMetadata> remoteModelsMetadata;
+
+    // DL node outputs by node name and output alias, true if all nodes using output are DL nodes
+    // taking it in layout it is produced in, negotiated on each validation
+    std::unordered_map<std::string, std::map<std::string, bool>> outputsLayoutCompatibility;
+
+    // arenas of intermediate blobs, recycled across requests
+    std::shared_ptr<BlobArenaPool> blobArenaPool = std::make_shared<BlobArenaPool>();
+
+    /**
+     * @brief Publishes execution plan of validated definition, requires metadataMtx
+     */
+    void buildExecutionPlan();
+
+    /**
+     * @brief Marks nodes producing requested pipeline outputs directly or through their dependants
+     *
+     * All nodes are required when exit node gathers from demultiplexer which would be pruned.
+     */
+    static std::vector<bool> getRequiredNodes(const ExecutionPlan& plan, const tensor_map_t& requestedOutputs);
+
     Status validateNode(ModelManager& manager, const NodeInfo& node, const bool isMultiBatchAllowed);
 
+    /**
+     * @brief Initializes states of custom nodes which do not have one yet
+     */
+    Status initializeCustomNodes();
+
+    /**
+     * @brief Fetches metadata of remote models from their servers
+     */
+    Status fetchRemoteModelsMetadata();
+
     const NodeInfo& findNodeByName(const std::string& name) const;
     shape_t getNodeGatherShape(const NodeInfo& info) const;
 
@@ -109,16 +203,29 @@ public:
         connections(connections),
         status(this->pipelineName) {}
 
+    /**
+     * @brief Creates pipeline for the request from published execution plan
+     *
+     * @param arenaPool pool of arenas for intermediate blobs, definition's own pool is used if not set
+     */
     Status create(std::unique_ptr<Pipeline>& pipeline,
         const tensorflow::serving::PredictRequest* request,
         tensorflow::serving::PredictResponse* response,
-        ModelManager& manager);
+        ModelManager& manager,
+        const std::shared_ptr<BlobArenaPool>& arenaPool = nullptr);
+    /**
+     * @brief Replaces definition and validates it, available definition with the same nodes and connections is kept without revalidation
+     *
+     * Changes of used models are delivered through model change subscription and revalidated separately.
+     */
     Status reload(ModelManager& manager, const std::vector<NodeInfo>&& nodeInfos, const pipeline_connections_t&& connections);
+    bool isReloadRequired(const std::vector<NodeInfo>& nodeInfos, const pipeline_connections_t& connections) const;
     void retire(ModelManager& manager);
     Status validate(ModelManager& manager);
     Status validateNodes(ModelManager& manager);
     Status validateForCycles();
     Status validateDemultiplexerGatherNodesOrder();
+    Status validateConditions();
 
     const std::string& getName() const { return pipelineName; }
     const PipelineDefinitionStateCode getStateCode() const { return status.getStateCode(); }
@@ -132,22 +239,79 @@ public:
         return this->status;
     }
 
+    /**
+     * @brief Cache of metadata response of published execution plan, nullptr if no plan is published
+     *
+     * Has to be taken before reading inputs and outputs info so that response of replaced plan is not cached in the new one.
+     */
+    std::shared_ptr<ServiceResponseCache<tensorflow::serving::GetModelMetadataResponse>> getMetadataResponseCache() const {
+        auto plan = std::atomic_load(&executionPlan);
+        if (!plan) {
+            return nullptr;
+        }
+        return std::shared_ptr<ServiceResponseCache<tensorflow::serving::GetModelMetadataResponse>>(plan, &plan->metadataResponseCache);
+    }
+
+    /**
+     * @brief Critical path analysis of executions sampled since execution plan was published, nullptr if no plan is published
+     */
+    std::shared_ptr<const CriticalPathAnalyzer> getCriticalPath() const {
+        auto plan = std::atomic_load(&executionPlan);
+        if (!plan) {
+            return nullptr;
+        }
+        return plan->criticalPath;
+    }
+
+    /**
+     * @brief Outputs of DL node handed over to following DL nodes without copy, negotiated on validation
+     */
+    std::set<std::string> getHandedOverOutputs(const std::string& nodeName) const {
+        auto plan = std::atomic_load(&executionPlan);
+        if (!plan) {
+            return {};
+        }
+        for (size_t i = 0; i < plan->nodes.size(); ++i) {
+            if (plan->nodes[i].nodeName == nodeName) {
+                return plan->handedOverOutputs[i];
+            }
+        }
+        return {};
+    }
+
+    ServiceResponseCache<tensorflow::serving::GetModelStatusResponse>& getStatusResponseCache() {
+        return statusResponseCache;
+    }
+
     const std::vector<NodeInfo>& getNodeInfos() {
         return this->nodeInfos;
     }
 
+    const pipeline_connections_t& getConnections() const {
+        return this->connections;
+    }
+
     void makeSubscriptions(ModelManager& manager);
     void resetSubscriptions(ModelManager& manager);
 
 protected:
     virtual Status updateInputsInfo(const ModelManager& manager);
     virtual Status updateOutputsInfo(const ModelManager& manager);
+    /**
+     * @brief Prepares inputs of nodes gathering shards of dynamic demultiplexers for requests where no shards are produced
+     */
+    Status updateEmptyGatheredInputsInfo(const ModelManager& manager);
 
 public:
     const tensor_map_t getInputsInfo() const;
     const tensor_map_t getOutputsInfo() const;
 
 private:
+    /**
+     * @brief Gets custom node inputs or outputs metadata, results are cached per library function and node parameters
+     *
+     * Libraries are not unloaded, so the same function with the same parameters reports the same metadata.
+     */
     static Status getCustomNodeMetadata(const NodeInfo& customNodeInfo, tensor_map_t& inputsInfo, metadata_fn callback, const std::string& pipelineName);
 
     Status populateOutputsInfoWithDLModelOutputs(
@@ -164,6 +328,17 @@ private:
         const Aliases& aliases,
         const shape_t& gatherShape) const;
 
+    Status populateOutputsInfoWithRemoteModelOutputs(
+        const NodeInfo& dependencyNodeInfo,
+        tensor_map_t& outputsInfo,
+        const Aliases& aliases,
+        const shape_t& gatherShape) const;
+
+    /**
+     * @brief Adds outputs info of exit node dependency, outputs provided by several nodes need to have the same metadata
+     */
+    Status mergeOutputsInfo(const tensor_map_t& dependencyOutputsInfo);
+
     void increaseRequestsHandlesCount() {
         ++requestsHandlesCounter;
     }
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <exception>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -64,6 +65,8 @@ public:
         name(name) {}
     template <typename Event>
     void handle(const Event& event) {
+        // used models of one pipeline may be loaded and notify about changes concurrently
+        std::lock_guard<std::mutex> lock(handleMtx);
         SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Pipeline: {} state: {} handling: {}: {}",
             name, pipelineDefinitionStateCodeToString(getStateCode()), event.name, event.getDetails());
         try {
@@ -95,6 +98,7 @@ public:
 
 private:
     const std::string& name;
+    std::mutex handleMtx;
     std::tuple<States...> allPossibleStates;
     std::variant<States*...> currentState{&std::get<0>(allPossibleStates)};
 };
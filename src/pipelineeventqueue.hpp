@@ -15,14 +15,44 @@
 //*****************************************************************************
 #pragma once
 
+#include <functional>
 #include <utility>
 
-#include "threadsafequeue.hpp"
+#include "mpscqueue.hpp"
+#include "session_id.hpp"
 
 namespace ovms {
 
 class Node;
 
 using NodeSessionKeyPair = std::pair<std::reference_wrapper<Node>, session_key_t>;
-using PipelineEventQueue = ThreadSafeQueue<NodeSessionKeyPair>;
+
+/**
+ * @brief Queue of node session events of single pipeline execution
+ *
+ * Events are pushed from inference completion callbacks of many shards at once and pulled only by pipeline thread,
+ * so lock-free queue with single consumer is used.
+ *
+ * When listener is set events are passed to it on the pushing thread instead of being queued,
+ * which lets asynchronous pipeline execution react to them without thread waiting on the queue.
+ */
+class PipelineEventQueue : public MPSCQueue<NodeSessionKeyPair> {
+    std::function<void(NodeSessionKeyPair&&)> listener;
+
+public:
+    /**
+     * @brief Has to be set before pipeline execution starts
+     */
+    void setListener(std::function<void(NodeSessionKeyPair&&)> listener) {
+        this->listener = std::move(listener);
+    }
+
+    void push(NodeSessionKeyPair&& event) {
+        if (listener) {
+            listener(std::move(event));
+            return;
+        }
+        MPSCQueue<NodeSessionKeyPair>::push(std::move(event));
+    }
+};
 }  // namespace ovms
@@ -15,9 +15,12 @@
 //*****************************************************************************
 #include "prediction_service.hpp"
 
+#include <algorithm>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include <inference_engine.hpp>
@@ -28,15 +31,23 @@
 #include "tensorflow/core/framework/tensor.h"
 #pragma GCC diagnostic pop
 
+#include "config.hpp"
 #include "get_model_metadata_impl.hpp"
 #include "modelinstanceunloadguard.hpp"
 #include "modelmanager.hpp"
 #include "ovinferrequestsqueue.hpp"
+#include "pipeline_executor.hpp"
 #include "prediction_service_utils.hpp"
+#include "requestcontext.hpp"
+#include "shared_memory.hpp"
 #include "status.hpp"
 #include "timer.hpp"
+#include "tracing.hpp"
+#include "traffic_capture.hpp"
+#include "usdt.hpp"
+#include "zero_copy_request_parser.hpp"
 
-using grpc::ServerContext;
+using grpc::ServerContextBase;
 
 using namespace InferenceEngine;
 
@@ -48,6 +59,11 @@ using tensorflow::serving::PredictResponse;
 
 namespace ovms {
 
+enum : size_t {
+    TOTAL,
+    TIMER_END
+};
+
 Status getModelInstance(const PredictRequest* request,
     std::shared_ptr<ovms::ModelInstance>& modelInstance,
     std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuardPtr) {
@@ -62,45 +78,211 @@ Status getPipeline(const PredictRequest* request,
     return manager.getPipeline(pipelinePtr, request, response);
 }
 
-grpc::Status ovms::PredictionServiceImpl::Predict(
-    ServerContext* context,
+static std::string getClientMetadataValue(const ServerContextBase* context, const char* key) {
+    if (context == nullptr) {
+        return "";
+    }
+    auto it = context->client_metadata().find(key);
+    if (it == context->client_metadata().end()) {
+        return "";
+    }
+    return std::string(it->second.data(), it->second.size());
+}
+
+RequestContext PredictionServiceImpl::getRequestContext(const ServerContextBase* context) {
+    auto requestContext = RequestContext::fromHeaders(
+        getClientMetadataValue(context, RequestContext::PRIORITY_HEADER),
+        getClientMetadataValue(context, RequestContext::TIMEOUT_HEADER),
+        getClientMetadataValue(context, TraceContext::TRACEPARENT_HEADER));
+    if (context == nullptr) {
+        return requestContext;
+    }
+    auto grpcDeadline = context->deadline();
+    if (grpcDeadline != std::chrono::system_clock::time_point::max()) {
+        // gRPC deadline is expressed in wall clock time
+        requestContext.restrictDeadline(RequestContext::clock_t::now() +
+                                        std::chrono::duration_cast<RequestContext::clock_t::duration>(grpcDeadline - std::chrono::system_clock::now()));
+    }
+    requestContext.cancellationCheck = [context]() { return context->IsCancelled(); };
+    return requestContext;
+}
+
+PredictionServiceImpl::PredictionServiceImpl() :
+    predictWorkers(std::max<size_t>(1, std::thread::hardware_concurrency()) * PREDICT_WORKERS_PER_CORE, Config::instance().frontendCpus()) {}
+
+grpc::experimental::ServerUnaryReactor* PredictionServiceImpl::Predict(
+    grpc::experimental::CallbackServerContext* context,
+    const grpc::ByteBuffer* requestBuffer,
+    grpc::ByteBuffer* responseBuffer) {
+    auto reactor = context->DefaultReactor();
+    predictWorkers.schedule([this, context, requestBuffer, responseBuffer, reactor]() {
+        std::shared_ptr<grpc::experimental::MessageHolder<PredictRequest, PredictResponse>> messages(
+            predictAllocator.AllocateMessages(),
+            [](grpc::experimental::MessageHolder<PredictRequest, PredictResponse>* holder) { holder->Release(); });
+        auto parser = std::make_shared<ZeroCopyRequestParser>();
+        auto status = parser->parse(*requestBuffer, *messages->request());
+        if (!status.ok()) {
+            SPDLOG_DEBUG("Parsing gRPC predict request failed: {}", status.string());
+            reactor->Finish(status.grpc());
+            return;
+        }
+        processPredict(context, messages->request(), messages->response(),
+            [context, messages, parser, responseBuffer, reactor](grpc::Status status) mutable {
+                if (status.ok() && messages->response()->has_model_spec()) {
+                    const auto& modelSpec = messages->response()->model_spec();
+                    context->AddInitialMetadata(FALLBACK_MODEL_HEADER, modelSpec.name());
+                    context->AddInitialMetadata(FALLBACK_MODEL_VERSION_HEADER, std::to_string(modelSpec.version().value()));
+                }
+                if (status.ok()) {
+                    bool ownBuffer;
+                    status = grpc::SerializationTraits<PredictResponse>::Serialize(*messages->response(), responseBuffer, &ownBuffer);
+                }
+                // request regions are unregistered and arena is recycled before the call completes
+                parser.reset();
+                messages.reset();
+                reactor->Finish(status);
+            });
+    });
+    return reactor;
+}
+
+void PredictionServiceImpl::processPredict(
+    const ServerContextBase* context,
     const PredictRequest* request,
-    PredictResponse* response) {
-    Timer timer;
-    timer.start("total");
-    using std::chrono::microseconds;
+    PredictResponse* response,
+    std::function<void(grpc::Status)> onCompleted) {
+    Timer<TIMER_END> timer;
+    timer.start(TOTAL);
     SPDLOG_DEBUG("Processing gRPC request for model: {}; version: {}",
         request->model_spec().name(),
         request->model_spec().version().value());
+    OVMS_TRACEPOINT(request_received, request->model_spec().name().c_str(), request->model_spec().version().value(), tracepointRequestId(response));
+    auto requestContext = getRequestContext(context);
+    Span requestSpan(requestContext.trace, "grpc predict");
+    requestSpan.setAttribute("model", request->model_spec().name());
+    requestSpan.setAttribute("version", std::to_string(request->model_spec().version().value()));
+    requestContext.trace = requestSpan.getContext();
 
-    std::shared_ptr<ovms::ModelInstance> modelInstance;
-    std::unique_ptr<ovms::Pipeline> pipelinePtr;
+    shared_memory_outputs_t sharedMemoryOutputs;
+    auto status = parseSharedMemoryOutputs(getClientMetadataValue(context, SHARED_MEMORY_OUTPUTS_HEADER), sharedMemoryOutputs);
+    if (!status.ok()) {
+        requestSpan.setStatus(status);
+        onCompleted(status.grpc());
+        return;
+    }
 
-    std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+    inferAsync(request, response, requestContext,
+        [response, timer, requestSpan, sharedMemoryOutputs = std::move(sharedMemoryOutputs), onCompleted = std::move(onCompleted)](Status status) mutable {
+            if (!status.ok()) {
+                requestSpan.setStatus(status);
+                requestSpan.end();
+                onCompleted(status.grpc());
+                return;
+            }
+            if (!sharedMemoryOutputs.empty()) {
+                status = writeOutputsToSharedMemory(sharedMemoryOutputs, *response);
+                if (!status.ok()) {
+                    requestSpan.setStatus(status);
+                    requestSpan.end();
+                    onCompleted(status.grpc());
+                    return;
+                }
+            }
+            requestSpan.end();
+            timer.stop(TOTAL);
+            SPDLOG_DEBUG("Total gRPC request processing time: {} ms", timer.elapsed<std::chrono::microseconds>(TOTAL) / 1000);
+            onCompleted(grpc::Status::OK);
+        });
+}
+
+static Status getModelInstanceOrPipeline(const PredictRequest* request,
+    PredictResponse* response,
+    std::shared_ptr<ovms::ModelInstance>& modelInstance,
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuard,
+    std::unique_ptr<ovms::Pipeline>& pipelinePtr,
+    bool& routedToFallback) {
     auto status = getModelInstance(request, modelInstance, modelInstanceUnloadGuard);
+    routedToFallback = status.ok() && ModelManager::getInstance().routeToFallback(modelInstance, modelInstanceUnloadGuard);
 
     if (status == StatusCode::MODEL_NAME_MISSING) {
         SPDLOG_DEBUG("Requested model: {} does not exist. Searching for pipeline with that name...", request->model_spec().name());
         status = getPipeline(request, response, pipelinePtr);
     }
+    OVMS_TRACEPOINT(servable_lookup, request->model_spec().name().c_str(), request->model_spec().version().value(), tracepointRequestId(response), static_cast<int>(status.getCode()));
     if (!status.ok()) {
         SPDLOG_INFO("Getting modelInstance or pipeline failed. {}", status.string());
-        return status.grpc();
+    }
+    return status;
+}
+
+// model spec is set after inference since cached responses replace the whole response
+static void setFallbackModelSpec(PredictResponse* response, const std::string& name, model_version_t version) {
+    response->mutable_model_spec()->set_name(name);
+    response->mutable_model_spec()->mutable_version()->set_value(version);
+}
+
+Status PredictionServiceImpl::infer(
+    const PredictRequest* request,
+    PredictResponse* response,
+    const RequestContext& requestContext) {
+    TrafficCapture::instance().capture(*request);
+    std::shared_ptr<ovms::ModelInstance> modelInstance;
+    std::unique_ptr<ovms::Pipeline> pipelinePtr;
+    std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+    bool routedToFallback = false;
+    Span lookupSpan(requestContext.trace, "servable lookup");
+    auto status = getModelInstanceOrPipeline(request, response, modelInstance, modelInstanceUnloadGuard, pipelinePtr, routedToFallback);
+    lookupSpan.setStatus(status);
+    lookupSpan.end();
+    if (!status.ok()) {
+        return status;
     }
 
     if (pipelinePtr) {
-        status = pipelinePtr->execute();
-    } else {
-        status = modelInstance->infer(request, response, modelInstanceUnloadGuard);
+        return pipelinePtr->execute(requestContext);
+    }
+    status = modelInstance->infer(request, response, modelInstanceUnloadGuard, requestContext);
+    if (status.ok() && routedToFallback) {
+        setFallbackModelSpec(response, modelInstance->getName(), modelInstance->getVersion());
     }
+    return status;
+}
 
+void PredictionServiceImpl::inferAsync(
+    const PredictRequest* request,
+    PredictResponse* response,
+    const RequestContext& requestContext,
+    std::function<void(Status)> onCompleted) {
+    TrafficCapture::instance().capture(*request);
+    std::shared_ptr<ovms::ModelInstance> modelInstance;
+    std::unique_ptr<ovms::Pipeline> pipelinePtr;
+    std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+    bool routedToFallback = false;
+    Span lookupSpan(requestContext.trace, "servable lookup");
+    auto status = getModelInstanceOrPipeline(request, response, modelInstance, modelInstanceUnloadGuard, pipelinePtr, routedToFallback);
+    lookupSpan.setStatus(status);
+    lookupSpan.end();
     if (!status.ok()) {
-        return status.grpc();
+        onCompleted(status);
+        return;
     }
 
-    timer.stop("total");
-    SPDLOG_DEBUG("Total gRPC request processing time: {} ms", timer.elapsed<microseconds>("total") / 1000);
-    return grpc::Status::OK;
+    if (pipelinePtr) {
+        PipelineExecutor::getInstance().execute(std::move(pipelinePtr), requestContext, std::move(onCompleted));
+        return;
+    }
+    if (routedToFallback) {
+        onCompleted = [response, name = modelInstance->getName(), version = modelInstance->getVersion(), onCompleted = std::move(onCompleted)](Status status) {
+            if (status.ok()) {
+                setFallbackModelSpec(response, name, version);
+            }
+            onCompleted(status);
+        };
+    }
+    status = modelInstance->inferAsync(request, response, modelInstanceUnloadGuard, onCompleted, requestContext);
+    if (!status.ok()) {
+        onCompleted(status);
+    }
 }
 
 grpc::Status PredictionServiceImpl::GetModelMetadata(
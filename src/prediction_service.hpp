@@ -15,25 +15,87 @@
 //*****************************************************************************
 #pragma once
 
+#include <functional>
+
 #include <grpcpp/server_context.h>
+#include <grpcpp/support/server_callback.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "arena_message_allocator.hpp"
+#include "requestcontext.hpp"
+#include "status.hpp"
+#include "workerpool.hpp"
+
 namespace ovms {
 
-class PredictionServiceImpl final : public tensorflow::serving::PredictionService::Service {
-    grpc::Status Predict(
-        grpc::ServerContext* context,
-        const tensorflow::serving::PredictRequest* request,
-        tensorflow::serving::PredictResponse* response) override;
+/**
+ * @brief Response headers naming model which served the request in place of overloaded requested model
+ */
+constexpr const char* FALLBACK_MODEL_HEADER = "ovms-fallback-model";
+constexpr const char* FALLBACK_MODEL_VERSION_HEADER = "ovms-fallback-model-version";
+
+/**
+ * @brief Serves Predict with raw gRPC callback API so its messages are allocated in per call protobuf arena
+ *
+ * Callback only schedules the call on worker pool and returns reactor. Workers parse the message with
+ * ZeroCopyRequestParser, so large tensor_content of inputs is not copied out of gRPC slices, then validate
+ * and deserialize the request. Single model inference completes on OpenVINO callback and pipelines run
+ * on PipelineExecutor, reactor is finished from there so workers are not held for inference duration.
+ * Remaining methods use the synchronous API.
+ */
+class PredictionServiceImpl final : public tensorflow::serving::PredictionService::ExperimentalWithRawCallbackMethod_Predict<tensorflow::serving::PredictionService::Service> {
+    static constexpr size_t PREDICT_WORKERS_PER_CORE = 8;
+
+    ArenaMessageAllocator<tensorflow::serving::PredictRequest, tensorflow::serving::PredictResponse> predictAllocator;
+    WorkerPool predictWorkers;
+
+    grpc::experimental::ServerUnaryReactor* Predict(
+        grpc::experimental::CallbackServerContext* context,
+        const grpc::ByteBuffer* request,
+        grpc::ByteBuffer* response) override;
 
     grpc::Status GetModelMetadata(
         grpc::ServerContext* context,
         const tensorflow::serving::GetModelMetadataRequest* request,
         tensorflow::serving::GetModelMetadataResponse* response) override;
+
+public:
+    PredictionServiceImpl();
+
+    /**
+     * @brief Processes predict call, onCompleted is called with call status once response is ready
+     */
+    static void processPredict(
+        const grpc::ServerContextBase* context,
+        const tensorflow::serving::PredictRequest* request,
+        tensorflow::serving::PredictResponse* response,
+        std::function<void(grpc::Status)> onCompleted);
+
+    /**
+     * @brief Gets scheduling information from client metadata and gRPC deadline of the call
+     */
+    static RequestContext getRequestContext(const grpc::ServerContextBase* context);
+
+    /**
+     * @brief Runs inference on model or pipeline named in request model_spec
+     */
+    static Status infer(
+        const tensorflow::serving::PredictRequest* request,
+        tensorflow::serving::PredictResponse* response,
+        const RequestContext& requestContext);
+
+    /**
+     * @brief Runs inference like infer without waiting for its completion, onCompleted is called once response is ready
+     */
+    static void inferAsync(
+        const tensorflow::serving::PredictRequest* request,
+        tensorflow::serving::PredictResponse* response,
+        const RequestContext& requestContext,
+        std::function<void(Status)> onCompleted);
 };
 
 }  // namespace ovms
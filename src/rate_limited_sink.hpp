@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <spdlog/sinks/dist_sink.h>
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+/**
+ * @brief Forwards messages to sinks, dropping messages below WARNING exceeding the limit per second
+ *
+ * Each logger has its own sink, so hot path messages of one logger do not suppress messages of others.
+ * The number of dropped messages is logged with the first message of the next second.
+ */
+class RateLimitedSink : public spdlog::sinks::dist_sink_mt {
+public:
+    explicit RateLimitedSink(uint64_t messagesPerSecond) :
+        messagesPerSecond(messagesPerSecond) {}
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        if (msg.level >= spdlog::level::warn) {
+            spdlog::sinks::dist_sink_mt::sink_it_(msg);
+            return;
+        }
+        const auto second = std::chrono::duration_cast<std::chrono::seconds>(msg.time.time_since_epoch()).count();
+        if (second != currentSecond) {
+            currentSecond = second;
+            logged = 0;
+            if (dropped > 0) {
+                const std::string text = std::to_string(dropped) + " log messages dropped by log_rate_limit";
+                spdlog::details::log_msg notice = msg;
+                notice.level = spdlog::level::warn;
+                notice.payload = spdlog::string_view_t(text.data(), text.size());
+                spdlog::sinks::dist_sink_mt::sink_it_(notice);
+                dropped = 0;
+            }
+        }
+        if (logged >= messagesPerSecond) {
+            ++dropped;
+            return;
+        }
+        ++logged;
+        spdlog::sinks::dist_sink_mt::sink_it_(msg);
+    }
+
+private:
+    // guarded by sink mutex
+    const uint64_t messagesPerSecond;
+    int64_t currentSecond = 0;
+    uint64_t logged = 0;
+    uint64_t dropped = 0;
+};
+
+}  // namespace ovms
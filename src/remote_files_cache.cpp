@@ -0,0 +1,243 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "remote_files_cache.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "config.hpp"
+#include "peer_files.hpp"
+#include "stringutils.hpp"
+
+namespace ovms {
+
+namespace fs = std::filesystem;
+
+static const char* TMP_SUFFIX = ".tmp";
+
+RemoteFilesCache::RemoteFilesCache(const std::string& directory, uint64_t sizeLimit, std::shared_ptr<PeerFilesClient> peers) :
+    directory(directory),
+    sizeLimit(sizeLimit),
+    peers(std::move(peers)) {
+    loadEntries();
+}
+
+std::shared_ptr<RemoteFilesCache> RemoteFilesCache::getInstance() {
+    static std::shared_ptr<RemoteFilesCache> instance = []() -> std::shared_ptr<RemoteFilesCache> {
+        auto& config = Config::instance();
+        if (config.remoteModelCacheDir().empty()) {
+            return nullptr;
+        }
+        return std::make_shared<RemoteFilesCache>(config.remoteModelCacheDir(), config.remoteModelCacheSizeMb() * 1024 * 1024, PeerFilesClient::getInstance());
+    }();
+    return instance;
+}
+
+std::string RemoteFilesCache::makeKey(const std::string& storage, const std::string& contentId, uint64_t size) {
+    // Hex encoding keeps the key a valid file name without losing distinction between identities
+    static const char digits[] = "0123456789abcdef";
+    std::string key = storage + "-";
+    for (unsigned char c : contentId) {
+        key += digits[c >> 4];
+        key += digits[c & 0x0F];
+    }
+    key += "-" + std::to_string(size);
+    return key;
+}
+
+std::string RemoteFilesCache::getEntryPath(const std::string& key) const {
+    return (fs::path(directory) / key).string();
+}
+
+void RemoteFilesCache::loadEntries() {
+    std::error_code ec;
+    std::vector<std::pair<fs::file_time_type, fs::directory_entry>> files;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (!entry.is_regular_file(ec)) {
+            continue;
+        }
+        if (endsWith(entry.path().string(), TMP_SUFFIX)) {
+            // Left by interrupted store
+            fs::remove(entry.path(), ec);
+            continue;
+        }
+        files.emplace_back(entry.last_write_time(ec), entry);
+    }
+    if (ec) {
+        SPDLOG_WARN("Unable to read remote model cache directory {}: {}", directory, ec.message());
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [time, entry] : files) {
+        auto key = entry.path().filename().string();
+        lru.push_front(key);
+        uint64_t size = entry.file_size(ec);
+        entries[key] = {size, lru.begin()};
+        totalSize += size;
+    }
+    evict();
+    SPDLOG_INFO("Remote model cache {} contains {} files of total size {} bytes", directory, entries.size(), totalSize);
+}
+
+void RemoteFilesCache::evict() {
+    while (totalSize > sizeLimit && !lru.empty()) {
+        auto key = lru.back();
+        std::error_code ec;
+        fs::remove(getEntryPath(key), ec);
+        totalSize -= entries[key].size;
+        entries.erase(key);
+        lru.pop_back();
+        SPDLOG_DEBUG("Evicted {} from remote model cache", key);
+    }
+}
+
+bool RemoteFilesCache::fetch(const std::string& key, const std::string& localPath) {
+    if (link(key, localPath)) {
+        return true;
+    }
+    return fetchFromPeers(key) && link(key, localPath);
+}
+
+bool RemoteFilesCache::link(const std::string& key, const std::string& localPath) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    auto entryPath = getEntryPath(key);
+    std::error_code ec;
+    fs::remove(localPath, ec);
+    fs::create_hard_link(entryPath, localPath, ec);
+    if (ec) {
+        // Cache directory on different filesystem than temporary model directory
+        ec.clear();
+        fs::copy_file(entryPath, localPath, fs::copy_options::overwrite_existing, ec);
+    }
+    if (ec) {
+        SPDLOG_WARN("Unable to use cached file {}: {}", entryPath, ec.message());
+        totalSize -= it->second.size;
+        lru.erase(it->second.lruPosition);
+        entries.erase(it);
+        fs::remove(entryPath, ec);
+        return false;
+    }
+    // Modification time persists the LRU order across restarts
+    fs::last_write_time(entryPath, fs::file_time_type::clock::now(), ec);
+    lru.splice(lru.begin(), lru, it->second.lruPosition);
+    SPDLOG_DEBUG("Using cached file {} for {}", entryPath, localPath);
+    return true;
+}
+
+void RemoteFilesCache::store(const std::string& key, const std::string& localPath) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (entries.find(key) != entries.end()) {
+        return;
+    }
+    std::error_code ec;
+    uint64_t size = fs::file_size(localPath, ec);
+    if (ec || size > sizeLimit) {
+        return;
+    }
+    auto entryPath = getEntryPath(key);
+    auto tmpPath = entryPath + TMP_SUFFIX;
+    fs::create_hard_link(localPath, tmpPath, ec);
+    if (ec) {
+        ec.clear();
+        fs::copy_file(localPath, tmpPath, fs::copy_options::overwrite_existing, ec);
+    }
+    if (!ec) {
+        fs::rename(tmpPath, entryPath, ec);
+    }
+    if (ec) {
+        SPDLOG_WARN("Unable to store {} in remote model cache: {}", localPath, ec.message());
+        fs::remove(tmpPath, ec);
+        return;
+    }
+    addEntry(key, size);
+}
+
+bool RemoteFilesCache::fetchFromPeers(const std::string& key) {
+    RemoteFileIdentity identity;
+    if (!peers || !PeerFilesClient::parseKey(key, identity) || identity.size > sizeLimit) {
+        return false;
+    }
+    // The same file may be fetched concurrently for different models
+    auto tmpPath = getEntryPath(key) + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + TMP_SUFFIX;
+    if (!peers->download(key, tmpPath)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    std::error_code ec;
+    if (entries.find(key) != entries.end()) {
+        fs::remove(tmpPath, ec);
+        return true;
+    }
+    fs::rename(tmpPath, getEntryPath(key), ec);
+    if (ec) {
+        SPDLOG_WARN("Unable to store {} downloaded from peer in remote model cache: {}", key, ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    addEntry(key, identity.size);
+    return true;
+}
+
+void RemoteFilesCache::addEntry(const std::string& key, uint64_t size) {
+    lru.push_front(key);
+    entries[key] = {size, lru.begin()};
+    totalSize += size;
+    evict();
+}
+
+Status RemoteFilesCache::readRange(const std::string& key, uint64_t first, uint64_t last, std::string& bytes) {
+    std::ifstream file;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return StatusCode::PEER_FILE_NOT_FOUND;
+        }
+        if (first > last || last >= it->second.size) {
+            return StatusCode::PEER_FILE_RANGE_INVALID;
+        }
+        // Opened under lock, so that file evicted later stays readable
+        file.open(getEntryPath(key), std::ios::binary);
+    }
+    if (!file) {
+        return StatusCode::PEER_FILE_NOT_FOUND;
+    }
+    bytes.resize(last - first + 1);
+    file.seekg(static_cast<std::streamoff>(first));
+    file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (static_cast<size_t>(file.gcount()) != bytes.size()) {
+        bytes.clear();
+        return StatusCode::PEER_FILE_NOT_FOUND;
+    }
+    return StatusCode::OK;
+}
+
+uint64_t RemoteFilesCache::getTotalSize() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return totalSize;
+}
+
+}  // namespace ovms
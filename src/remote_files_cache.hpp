@@ -0,0 +1,100 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "status.hpp"
+
+namespace ovms {
+
+class PeerFilesClient;
+
+/**
+ * @brief Persistent cache of files downloaded from remote model repositories
+ *
+ * Files are stored under a key derived from the remote content identity (ETag or checksum and size),
+ * so identical files referenced by different models or versions are stored once and survive restarts.
+ * Cached files are hard linked into model directories when possible, evicted entries stay valid
+ * for models that still use them. Total size is bounded, least recently used entries are evicted first.
+ * Files missing in cache are downloaded from peers when configured, cached files can be served to peers by byte ranges.
+ */
+class RemoteFilesCache {
+    struct Entry {
+        uint64_t size;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    const std::string directory;
+    const uint64_t sizeLimit;
+    const std::shared_ptr<PeerFilesClient> peers;
+
+    std::mutex mtx;
+    // Most recently used at front
+    std::list<std::string> lru;
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t totalSize = 0;
+
+    void loadEntries();
+    void evict();
+    std::string getEntryPath(const std::string& key) const;
+    void addEntry(const std::string& key, uint64_t size);
+    bool link(const std::string& key, const std::string& localPath);
+    bool fetchFromPeers(const std::string& key);
+
+public:
+    RemoteFilesCache(const std::string& directory, uint64_t sizeLimit, std::shared_ptr<PeerFilesClient> peers = nullptr);
+
+    /**
+     * @brief Returns cache configured with server parameters, nullptr when caching is disabled
+     */
+    static std::shared_ptr<RemoteFilesCache> getInstance();
+
+    /**
+     * @brief Builds cache key from remote content identity
+     *
+     * @param storage prefix separating identities of different storage types
+     * @param contentId ETag, checksum or other value changing with the content
+     * @param size
+     */
+    static std::string makeKey(const std::string& storage, const std::string& contentId, uint64_t size);
+
+    /**
+     * @brief Places cached file at local path, file missing in cache is downloaded from peers first
+     *
+     * @return true if key was found in cache or at peers
+     */
+    bool fetch(const std::string& key, const std::string& localPath);
+
+    /**
+     * @brief Adds downloaded file to cache
+     */
+    void store(const std::string& key, const std::string& localPath);
+
+    /**
+     * @brief Reads bytes from first to last inclusive of cached file, for peers downloading it
+     */
+    Status readRange(const std::string& key, uint64_t first, uint64_t last, std::string& bytes);
+
+    uint64_t getTotalSize();
+};
+
+}  // namespace ovms
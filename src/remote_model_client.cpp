@@ -0,0 +1,155 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "remote_model_client.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/get_model_metadata.pb.h"
+#pragma GCC diagnostic pop
+
+#include "logging.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+static grpc_compression_algorithm getCompressionAlgorithm(const std::string& compression) {
+    if (compression == "gzip") {
+        return GRPC_COMPRESS_GZIP;
+    }
+    if (compression == "deflate") {
+        return GRPC_COMPRESS_DEFLATE;
+    }
+    return GRPC_COMPRESS_NONE;
+}
+
+RemoteModelClient::RemoteModelClient(const RemoteModelInfo& info) :
+    info(info) {
+    grpc::ChannelArguments arguments;
+    arguments.SetMaxReceiveMessageSize(std::numeric_limits<int>::max());
+    arguments.SetMaxSendMessageSize(std::numeric_limits<int>::max());
+    arguments.SetCompressionAlgorithm(getCompressionAlgorithm(info.compression));
+    // channels with own subchannel pools do not share connection
+    arguments.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    const uint32_t connections = std::max<uint32_t>(info.connections, 1);
+    stubs.reserve(connections);
+    for (uint32_t i = 0; i < connections; ++i) {
+        auto channel = grpc::CreateCustomChannel(info.address, grpc::InsecureChannelCredentials(), arguments);
+        stubs.emplace_back(tensorflow::serving::PredictionService::NewStub(channel));
+    }
+    completionThread = std::thread(&RemoteModelClient::processCompletions, this);
+    SPDLOG_LOGGER_INFO(dag_executor_logger, "Created client of remote model server: {} with: {} connections, compression: {}",
+        info.address, connections, info.compression);
+}
+
+RemoteModelClient::~RemoteModelClient() {
+    // calls in flight are completed before queue reports shutdown
+    completionQueue.Shutdown();
+    completionThread.join();
+}
+
+std::shared_ptr<RemoteModelClient> RemoteModelClient::get(const RemoteModelInfo& info) {
+    static std::mutex clientsMtx;
+    static std::map<std::tuple<std::string, uint32_t, std::string, uint32_t>, std::weak_ptr<RemoteModelClient>> clients;
+    std::lock_guard<std::mutex> lock(clientsMtx);
+    auto& client = clients[std::make_tuple(info.address, info.connections, info.compression, info.timeoutMs)];
+    auto shared = client.lock();
+    if (!shared) {
+        shared = std::make_shared<RemoteModelClient>(info);
+        client = shared;
+    }
+    return shared;
+}
+
+void RemoteModelClient::processCompletions() {
+    void* tag = nullptr;
+    bool ok = false;
+    while (completionQueue.Next(&tag, &ok)) {
+        std::unique_ptr<Call> call(static_cast<Call*>(tag));
+        call->callback(ok ? call->status : grpc::Status(grpc::StatusCode::CANCELLED, "Remote call was not completed"));
+    }
+}
+
+static Status convertSignature(const google::protobuf::Map<std::string, tensorflow::TensorInfo>& signature, tensor_map_t& tensorMap) {
+    tensorMap.clear();
+    for (const auto& [name, tensor] : signature) {
+        auto precision = TensorInfo::getPrecisionFromDataType(tensor.dtype());
+        if (precision == InferenceEngine::Precision::UNSPECIFIED) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Remote model tensor: {} has unsupported data type: {}", name, TensorInfo::getDataTypeAsString(tensor.dtype()));
+            return StatusCode::PIPELINE_REMOTE_MODEL_UNAVAILABLE;
+        }
+        shape_t shape;
+        for (const auto& dim : tensor.tensor_shape().dim()) {
+            shape.push_back(dim.size() > 0 ? dim.size() : 0);
+        }
+        tensorMap.emplace(name, std::make_shared<TensorInfo>(name, precision, shape, InferenceEngine::Layout::ANY));
+    }
+    return StatusCode::OK;
+}
+
+Status RemoteModelClient::getMetadata(const std::string& modelName, std::optional<model_version_t> modelVersion, RemoteModelMetadata& metadata) {
+    tensorflow::serving::GetModelMetadataRequest request;
+    request.mutable_model_spec()->set_name(modelName);
+    if (modelVersion) {
+        request.mutable_model_spec()->mutable_version()->set_value(modelVersion.value());
+    }
+    request.mutable_metadata_field()->Add("signature_def");
+    tensorflow::serving::GetModelMetadataResponse response;
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + METADATA_TIMEOUT);
+    auto grpcStatus = stubs.front()->GetModelMetadata(&context, request, &response);
+    if (!grpcStatus.ok()) {
+        SPDLOG_LOGGER_ERROR(modelmanager_logger, "Failed to get metadata of remote model: {} from: {}; error: {}",
+            modelName, info.address, grpcStatus.error_message());
+        return StatusCode::PIPELINE_REMOTE_MODEL_UNAVAILABLE;
+    }
+    tensorflow::serving::SignatureDefMap def;
+    auto it = response.metadata().find("signature_def");
+    if (it == response.metadata().end() || !it->second.UnpackTo(&def) || def.signature_def().count("serving_default") == 0) {
+        SPDLOG_LOGGER_ERROR(modelmanager_logger, "Remote model: {} from: {} reported invalid metadata", modelName, info.address);
+        return StatusCode::PIPELINE_REMOTE_MODEL_UNAVAILABLE;
+    }
+    const auto& signature = def.signature_def().at("serving_default");
+    auto status = convertSignature(signature.inputs(), metadata.inputsInfo);
+    if (!status.ok()) {
+        return status;
+    }
+    return convertSignature(signature.outputs(), metadata.outputsInfo);
+}
+
+void RemoteModelClient::predict(const tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse* response, std::function<void(const grpc::Status&)> callback) {
+    auto call = std::make_unique<Call>();
+    call->callback = std::move(callback);
+    if (info.timeoutMs > 0) {
+        call->context.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(info.timeoutMs));
+    }
+    auto& stub = *stubs[nextStub++ % stubs.size()];
+    call->reader = stub.PrepareAsyncPredict(&call->context, request, &completionQueue);
+    call->reader->StartCall();
+    // call is owned by completion queue until it is processed
+    Call* tag = call.release();
+    tag->reader->Finish(response, &tag->status, tag);
+}
+
+}  // namespace ovms
@@ -0,0 +1,104 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include <grpcpp/grpcpp.h>
+
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "modelversion.hpp"
+#include "nodeinfo.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Inputs and outputs of remote model as reported by its server
+ */
+struct RemoteModelMetadata {
+    tensor_map_t inputsInfo;
+    tensor_map_t outputsInfo;
+};
+
+/**
+ * @brief Pool of gRPC connections to other model server used by remote model nodes of pipelines
+ *
+ * Predict calls are asynchronous, they are spread over connections in turns and their completions
+ * are handled on a single thread of the client. Clients are shared by nodes with the same remote settings.
+ */
+class RemoteModelClient {
+    struct Call {
+        grpc::ClientContext context;
+        grpc::Status status;
+        std::unique_ptr<grpc::ClientAsyncResponseReader<tensorflow::serving::PredictResponse>> reader;
+        std::function<void(const grpc::Status&)> callback;
+    };
+
+    const RemoteModelInfo info;
+    std::vector<std::unique_ptr<tensorflow::serving::PredictionService::Stub>> stubs;
+    std::atomic<size_t> nextStub = 0;
+    grpc::CompletionQueue completionQueue;
+    std::thread completionThread;
+
+    void processCompletions();
+
+public:
+    /**
+     * @brief Deadline of metadata call made during pipeline validation
+     */
+    static constexpr std::chrono::milliseconds METADATA_TIMEOUT{5000};
+
+    explicit RemoteModelClient(const RemoteModelInfo& info);
+    ~RemoteModelClient();
+
+    RemoteModelClient(const RemoteModelClient&) = delete;
+    RemoteModelClient& operator=(const RemoteModelClient&) = delete;
+
+    /**
+     * @brief Gets client with given settings, creating it if no node uses one
+     */
+    static std::shared_ptr<RemoteModelClient> get(const RemoteModelInfo& info);
+
+    const RemoteModelInfo& getInfo() const { return info; }
+
+    /**
+     * @brief Fetches inputs and outputs of remote model, dimensions reported as dynamic are set to 0
+     *
+     * @return PIPELINE_REMOTE_MODEL_UNAVAILABLE if server cannot be reached or does not serve the model
+     */
+    Status getMetadata(const std::string& modelName, std::optional<model_version_t> modelVersion, RemoteModelMetadata& metadata);
+
+    /**
+     * @brief Starts inference of remote model
+     *
+     * @param response filled before callback is called
+     * @param callback called on completion thread of client with status of the call
+     */
+    void predict(const tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse* response, std::function<void(const grpc::Status&)> callback);
+};
+}  // namespace ovms
@@ -0,0 +1,89 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "remote_node.hpp"
+
+#include <utility>
+
+#include "logging.hpp"
+#include "remote_model_client.hpp"
+#include "remotenodesession.hpp"
+
+namespace ovms {
+
+RemoteNode::RemoteNode(
+    const std::string& nodeName,
+    const std::string& modelName,
+    std::optional<model_version_t> modelVersion,
+    std::shared_ptr<RemoteModelClient> client,
+    const std::unordered_map<std::string, std::string>& nodeOutputNameAlias,
+    std::optional<uint32_t> demultiplyCount,
+    std::set<std::string> gatherFromNode) :
+    Node(nodeName, demultiplyCount, gatherFromNode),
+    modelName(modelName),
+    modelVersion(modelVersion),
+    client(std::move(client)),
+    nodeOutputNameAlias(nodeOutputNameAlias) {
+}
+
+Status RemoteNode::execute(session_key_t sessionKey, PipelineEventQueue& notifyEndQueue) {
+    auto& remoteNodeSession = static_cast<RemoteNodeSession&>(getNodeSession(sessionKey));
+    return remoteNodeSession.execute(notifyEndQueue, *this, *client, modelName, modelVersion);
+}
+
+Status RemoteNode::fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) {
+    auto& remoteNodeSession = static_cast<RemoteNodeSession&>(nodeSession);
+    ReleaseSessionGuard releaseSessionGuard(nodeSession);
+    if (!remoteNodeSession.getExecutionStatus().ok()) {
+        return remoteNodeSession.getExecutionStatus();
+    }
+    const auto& sessionMetadata = nodeSession.getNodeSessionMetadata();
+    auto it = nodeSessionOutputs.emplace(sessionMetadata.getSessionKey(), SessionResult{sessionMetadata, {}});
+    if (!it.second) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Failed to put node: {} session: {} results in node session outputs",
+            getName(), nodeSession.getSessionKey());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    auto& outputs = it.first->second.second;
+    for (const auto& link : getOutputLinks()) {
+        const auto& outputName = *link.outputName;
+        if (outputs.find(outputName) != outputs.end()) {
+            continue;
+        }
+        const auto& realOutputName = this->getRealOutputName(outputName);
+        InferenceEngine::Blob::Ptr resultBlob;
+        auto status = remoteNodeSession.fetchResult(realOutputName, resultBlob, blobAllocator);
+        if (!status.ok()) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} failed to get remote model output: {}; error: {}",
+                getName(), nodeSession.getSessionKey(), realOutputName, status.string());
+            return status;
+        }
+        outputs.emplace(outputName, std::move(resultBlob));
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Node: {} session: {} Blob with name {} has been prepared under alias {}",
+            getName(), nodeSession.getSessionKey(), realOutputName, outputName);
+    }
+    return StatusCode::OK;
+}
+
+void RemoteNode::release(session_key_t sessionId) {
+    SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Release node: {} sessionKey: {}", getName(), sessionId);
+    getNodeSession(sessionId).release();
+}
+
+std::unique_ptr<NodeSession> RemoteNode::createNodeSession(const NodeSessionMetadata& metadata, const CollapseDetails& collapsingDetails) {
+    return std::make_unique<RemoteNodeSession>(metadata, getName(), previous.size(), collapsingDetails);
+}
+
+}  // namespace ovms
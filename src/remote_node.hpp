@@ -0,0 +1,66 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "modelversion.hpp"
+#include "node.hpp"
+#include "pipelineeventqueue.hpp"
+
+namespace ovms {
+
+class RemoteModelClient;
+
+/**
+ * @brief Pipeline node running inference of model served by other model server
+ */
+class RemoteNode : public Node {
+    const std::string modelName;
+    const std::optional<model_version_t> modelVersion;
+    const std::shared_ptr<RemoteModelClient> client;
+    const std::unordered_map<std::string, std::string> nodeOutputNameAlias;
+
+public:
+    RemoteNode(
+        const std::string& nodeName,
+        const std::string& modelName,
+        std::optional<model_version_t> modelVersion,
+        std::shared_ptr<RemoteModelClient> client,
+        const std::unordered_map<std::string, std::string>& nodeOutputNameAlias = {},
+        std::optional<uint32_t> demultiplyCount = std::nullopt,
+        std::set<std::string> gatherFromNode = {});
+
+    Status execute(session_key_t sessionKey, PipelineEventQueue& notifyEndQueue) override;
+
+    Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) override;
+
+    const std::string& getRealOutputName(const std::string& alias) const {
+        auto it = nodeOutputNameAlias.find(alias);
+        return it != nodeOutputNameAlias.end() ? it->second : alias;
+    }
+
+    void release(session_key_t sessionId) override;
+
+protected:
+    std::unique_ptr<NodeSession> createNodeSession(const NodeSessionMetadata& metadata, const CollapseDetails& collapsingDetails) override;
+};
+
+}  // namespace ovms
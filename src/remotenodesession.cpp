@@ -0,0 +1,117 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "remotenodesession.hpp"
+
+#include <cstring>
+#include <utility>
+
+#include "logging.hpp"
+#include "node.hpp"
+#include "nodeinputhandler.hpp"
+#include "ov_utils.hpp"
+#include "remote_model_client.hpp"
+#include "tensorinfo.hpp"
+#include "timer.hpp"
+
+namespace ovms {
+
+RemoteNodeSession::RemoteNodeSession(const NodeSessionMetadata& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails) :
+    NodeSession(metadata, nodeName, inputsCount, collapsingDetails) {}
+
+RemoteNodeSession::RemoteNodeSession(const NodeSessionMetadata&& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails) :
+    NodeSession(std::move(metadata), nodeName, inputsCount, collapsingDetails) {}
+
+RemoteNodeSession::~RemoteNodeSession() = default;
+
+Status RemoteNodeSession::execute(PipelineEventQueue& notifyEndQueue, Node& node, RemoteModelClient& client, const std::string& modelName, std::optional<model_version_t> modelVersion) {
+    request.mutable_model_spec()->set_name(modelName);
+    if (modelVersion) {
+        request.mutable_model_spec()->mutable_version()->set_value(modelVersion.value());
+    }
+    auto& inputs = *request.mutable_inputs();
+    for (const auto& [name, blob] : this->inputHandler->getInputs()) {
+        const auto& desc = blob->getTensorDesc();
+        auto& proto = inputs[name];
+        proto.set_dtype(TensorInfo::getPrecisionAsDataType(desc.getPrecision()));
+        if (proto.dtype() == tensorflow::DataType::DT_INVALID) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} input: {} has precision: {} not supported by remote inference",
+                getName(), getSessionKey(), name, desc.getPrecision().name());
+            return StatusCode::INVALID_PRECISION;
+        }
+        for (const auto dim : desc.getDims()) {
+            proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+        }
+        proto.mutable_tensor_content()->assign(InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const char*>(), blob->byteSize());
+    }
+    // inputs were serialized into request
+    this->inputHandler->clearInputs();
+
+    this->timer.start(INFERENCE);
+    const auto sessionKey = getSessionKey();
+    client.predict(request, &response, [this, &node, &notifyEndQueue, sessionKey, address = client.getInfo().address](const grpc::Status& grpcStatus) {
+        this->timer.stop(INFERENCE);
+        SPDLOG_LOGGER_DEBUG(dag_executor_logger, "Remote inference processing time for node {}; session: {} - {} ms",
+            this->getName(),
+            sessionKey,
+            this->timer.elapsed<std::chrono::microseconds>(INFERENCE) / 1000);
+        node.observeExecutionTime(this->timer.elapsed<std::chrono::microseconds>(INFERENCE));
+        if (!grpcStatus.ok()) {
+            SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} remote inference on: {} failed with code: {}; error: {}",
+                this->getName(), sessionKey, address, grpcStatus.error_code(), grpcStatus.error_message());
+            this->executionStatus = StatusCode::PIPELINE_REMOTE_INFERENCE_FAILED;
+        }
+        notifyEndQueue.push({node, sessionKey});
+    });
+    return StatusCode::OK;
+}
+
+Status RemoteNodeSession::fetchResult(const std::string& name, InferenceEngine::Blob::Ptr& resultBlob, const std::shared_ptr<InferenceEngine::IAllocator>& allocator) const {
+    auto it = response.outputs().find(name);
+    if (it == response.outputs().end()) {
+        return StatusCode::INVALID_MISSING_OUTPUT;
+    }
+    const auto& proto = it->second;
+    const auto precision = TensorInfo::getPrecisionFromDataType(proto.dtype());
+    if (precision == InferenceEngine::Precision::UNSPECIFIED) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} remote output: {} has unsupported data type: {}",
+            getName(), getSessionKey(), name, TensorInfo::getDataTypeAsString(proto.dtype()));
+        return StatusCode::INVALID_PRECISION;
+    }
+    shape_t shape;
+    for (const auto& dim : proto.tensor_shape().dim()) {
+        shape.push_back(dim.size());
+    }
+    const InferenceEngine::TensorDesc desc(precision, shape, InferenceEngine::Layout::ANY);
+    auto status = allocator ? createSharedBlob(resultBlob, desc, allocator) : createSharedBlob(resultBlob, desc);
+    if (!status.ok()) {
+        return status;
+    }
+    // server serializes outputs into tensor content
+    if (proto.tensor_content().size() != resultBlob->byteSize()) {
+        SPDLOG_LOGGER_ERROR(dag_executor_logger, "Node: {} session: {} remote output: {} has content of size: {}, expected: {}",
+            getName(), getSessionKey(), name, proto.tensor_content().size(), resultBlob->byteSize());
+        return StatusCode::INVALID_CONTENT_SIZE;
+    }
+    std::memcpy(InferenceEngine::as<InferenceEngine::MemoryBlob>(resultBlob)->wmap().as<char*>(), proto.tensor_content().data(), proto.tensor_content().size());
+    return StatusCode::OK;
+}
+
+void RemoteNodeSession::release() {
+    request.Clear();
+    response.Clear();
+}
+
+}  // namespace ovms
@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <optional>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "modelversion.hpp"
+#include "nodesession.hpp"
+#include "pipelineeventqueue.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+class Node;
+class RemoteModelClient;
+
+class RemoteNodeSession : public NodeSession {
+    tensorflow::serving::PredictRequest request;
+    tensorflow::serving::PredictResponse response;
+    // Result of remote call, set on completion thread of client before session end is notified
+    Status executionStatus = StatusCode::OK;
+
+public:
+    RemoteNodeSession(const NodeSessionMetadata& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails);
+    RemoteNodeSession(const NodeSessionMetadata&& metadata, const std::string& nodeName, uint32_t inputsCount, const CollapseDetails& collapsingDetails);
+    virtual ~RemoteNodeSession();
+
+    /**
+     * @brief Sends inputs to remote model, session end is notified once the call completes
+     */
+    Status execute(PipelineEventQueue& notifyEndQueue, Node& node, RemoteModelClient& client, const std::string& modelName, std::optional<model_version_t> modelVersion);
+
+    const Status& getExecutionStatus() const { return executionStatus; }
+
+    /**
+     * @brief Converts remote model output into blob
+     */
+    Status fetchResult(const std::string& name, InferenceEngine::Blob::Ptr& resultBlob, const std::shared_ptr<InferenceEngine::IAllocator>& allocator) const;
+
+    void release() override;
+};
+}  // namespace ovms
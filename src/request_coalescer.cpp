@@ -0,0 +1,86 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "request_coalescer.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+Status RequestCoalescer::infer(const ResponseCache::Key& key, tensorflow::serving::PredictResponse& responseProto, const RequestContext& context, const std::function<Status()>& runInference) {
+    std::shared_ptr<Flight> flight;
+    bool leader = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto& entry = flights[key.hash];
+        if (!entry) {
+            entry = std::make_shared<Flight>();
+            entry->inputs = &key.inputs;
+            leader = true;
+            flight = entry;
+        } else if (*entry->inputs == key.inputs) {
+            entry->waiters++;
+            flight = entry;
+        }
+    }
+    if (!flight) {
+        // hash collision with request in flight, its outputs would not match
+        SPDLOG_DEBUG("Request inputs differ from coalesced request with the same hash, request runs its own inference");
+        return runInference();
+    }
+
+    if (leader) {
+        auto status = runInference();
+        size_t waiters = 0;
+        {
+            // requests arriving from now on start their own flight
+            std::lock_guard<std::mutex> lock(mtx);
+            flights.erase(key.hash);
+            waiters = flight->waiters;
+        }
+        if (waiters == 0) {
+            return status;
+        }
+        {
+            std::lock_guard<std::mutex> lock(flight->mtx);
+            if (status.ok()) {
+                flight->outputs = responseProto.outputs();
+            }
+            flight->succeeded = status.ok();
+            flight->done = true;
+        }
+        flight->finished.notify_all();
+        return status;
+    }
+
+    std::unique_lock<std::mutex> lock(flight->mtx);
+    while (!flight->finished.wait_for(lock, CANCELLATION_POLL_INTERVAL, [&flight] { return flight->done; })) {
+        auto status = context.check();
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    if (!flight->succeeded) {
+        lock.unlock();
+        // failure might be specific to the first request, e.g. its deadline passed
+        SPDLOG_DEBUG("Coalesced inference failed, request runs its own");
+        return runInference();
+    }
+    *responseProto.mutable_outputs() = flight->outputs;
+    coalesced++;
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,89 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "requestcontext.hpp"
+#include "response_cache.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Lets concurrent requests with identical inputs share a single inference
+ *
+ * The first request with a key runs inference, requests with the same key arriving before it finishes
+ * wait for it and get copies of its outputs. If the inference fails, waiting requests run their own.
+ * Keys are response cache keys, requests with colliding hash but different inputs run their own inference.
+ */
+class RequestCoalescer {
+    struct Flight {
+        std::mutex mtx;
+        std::condition_variable finished;
+        bool done = false;
+        bool succeeded = false;
+        // number of requests waiting for the flight, modified under coalescer mutex
+        size_t waiters = 0;
+        // key inputs of the request running inference, valid while the flight is registered, modified under coalescer mutex
+        const std::string* inputs = nullptr;
+        google::protobuf::Map<std::string, tensorflow::TensorProto> outputs;
+    };
+
+    std::mutex mtx;
+    std::unordered_map<uint64_t, std::shared_ptr<Flight>> flights;
+
+    std::atomic<uint64_t> coalesced = 0;
+
+public:
+    /**
+     * @brief How often waiting requests check whether they were cancelled
+     */
+    static constexpr std::chrono::milliseconds CANCELLATION_POLL_INTERVAL{10};
+
+    /**
+     * @brief Runs inference unless request with the same key is in flight, then waits for its outputs
+     *
+     * @param key response cache key of the request
+     * @param responseProto
+     * @param context checked while waiting for inference of other request
+     * @param runInference runs inference filling responseProto
+     *
+     * @return status of own inference or OK if outputs of other request were copied
+     */
+    Status infer(const ResponseCache::Key& key, tensorflow::serving::PredictResponse& responseProto, const RequestContext& context, const std::function<Status()>& runInference);
+
+    /**
+     * @brief Number of requests served with outputs of other request
+     */
+    uint64_t getCoalesced() const {
+        return coalesced;
+    }
+};
+}  // namespace ovms
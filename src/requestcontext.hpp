@@ -0,0 +1,121 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "status.hpp"
+#include "stringutils.hpp"
+#include "tracing.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Scheduling information carried by a single predict request
+ *
+ * Higher priority requests are served first when waiting for an idle infer request.
+ * Requests which are still waiting when their deadline passes are dropped.
+ * Work is also skipped at stage boundaries once the deadline passed or the client cancelled the call.
+ * Traced requests carry context of the span their processing stages are children of.
+ */
+struct RequestContext {
+    using clock_t = std::chrono::steady_clock;
+
+    static constexpr const char* PRIORITY_HEADER = "ovms-priority";
+    static constexpr const char* TIMEOUT_HEADER = "ovms-timeout-ms";
+    static constexpr int DEFAULT_PRIORITY = 0;
+
+    int priority = DEFAULT_PRIORITY;
+    clock_t::time_point deadline = clock_t::time_point::max();
+    std::function<bool()> cancellationCheck;
+    std::shared_ptr<const TraceContext> trace;
+
+    bool hasDeadline() const {
+        return deadline != clock_t::time_point::max();
+    }
+
+    bool isDeadlineExceeded() const {
+        return hasDeadline() && clock_t::now() >= deadline;
+    }
+
+    bool isCancellable() const {
+        return static_cast<bool>(cancellationCheck);
+    }
+
+    bool isCancelled() const {
+        return isCancellable() && cancellationCheck();
+    }
+
+    /**
+     * @brief Checks whether processing of the request should continue
+     *
+     * @return REQUEST_CANCELLED if client cancelled the call, REQUEST_DEADLINE_EXCEEDED if deadline passed
+     */
+    Status check() const {
+        if (isCancelled()) {
+            return StatusCode::REQUEST_CANCELLED;
+        }
+        if (isDeadlineExceeded()) {
+            return StatusCode::REQUEST_DEADLINE_EXCEEDED;
+        }
+        return StatusCode::OK;
+    }
+
+    /**
+     * @brief Shortens deadline if the passed one is earlier
+     */
+    void restrictDeadline(clock_t::time_point otherDeadline) {
+        if (otherDeadline < deadline) {
+            deadline = otherDeadline;
+        }
+    }
+
+    /**
+     * @brief Builds context from gRPC metadata or HTTP header values, empty value means not set
+     *
+     * @param priorityValue
+     * @param timeoutMsValue
+     * @param traceparentValue W3C trace context of the caller
+     * @return RequestContext
+     */
+    static RequestContext fromHeaders(const std::string& priorityValue, const std::string& timeoutMsValue, const std::string& traceparentValue = "") {
+        RequestContext context;
+        context.trace = Tracer::instance().startTrace(traceparentValue);
+        if (!priorityValue.empty()) {
+            auto priority = stoi32(priorityValue);
+            if (priority) {
+                context.priority = priority.value();
+            } else {
+                SPDLOG_DEBUG("Ignoring invalid {} header value: {}", PRIORITY_HEADER, priorityValue);
+            }
+        }
+        if (!timeoutMsValue.empty()) {
+            auto timeoutMs = stou32(timeoutMsValue);
+            if (timeoutMs) {
+                context.deadline = clock_t::now() + std::chrono::milliseconds(timeoutMs.value());
+            } else {
+                SPDLOG_DEBUG("Ignoring invalid {} header value: {}", TIMEOUT_HEADER, timeoutMsValue);
+            }
+        }
+        return context;
+    }
+};
+}  // namespace ovms
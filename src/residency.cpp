@@ -0,0 +1,179 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "residency.hpp"
+
+#include <memory>
+#include <shared_mutex>
+#include <utility>
+
+#include <cpprest/http_client.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+#include "model.hpp"
+#include "modelinstance.hpp"
+#include "modelmanager.hpp"
+
+namespace ovms {
+
+ResidencyAdvertiser::ResidencyAdvertiser() {
+    char hostname[256] = {};
+    if (gethostname(hostname, sizeof(hostname) - 1) == 0) {
+        serverId = hostname;
+    }
+}
+
+ResidencyAdvertiser::~ResidencyAdvertiser() {
+    stop();
+}
+
+void ResidencyAdvertiser::setServerId(const std::string& serverId) {
+    this->serverId = serverId;
+}
+
+void ResidencyAdvertiser::start(ModelManager& manager, const std::string& url, std::chrono::milliseconds interval) {
+    stop();
+    std::lock_guard<std::mutex> lock(mtx);
+    pushUrl = url;
+    pushInterval = interval;
+    exiting = false;
+    pusher = std::thread(&ResidencyAdvertiser::pushRoutine, this, std::ref(manager));
+    SPDLOG_INFO("Pushing model residency to {} every {} ms", url, interval.count());
+}
+
+void ResidencyAdvertiser::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!pusher.joinable()) {
+            return;
+        }
+        exiting = true;
+    }
+    exitCondition.notify_one();
+    pusher.join();
+    // registry drops the server instead of waiting for its entry to expire
+    push(toJson(serverId, false, {}));
+}
+
+void ResidencyAdvertiser::pushRoutine(ModelManager& manager) {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!exiting) {
+        lock.unlock();
+        if (!push(toJson(manager))) {
+            pushFailures.fetch_add(1, std::memory_order_relaxed);
+        }
+        lock.lock();
+        exitCondition.wait_for(lock, pushInterval, [this]() { return exiting; });
+    }
+}
+
+bool ResidencyAdvertiser::push(const std::string& body) {
+    try {
+        web::http::client::http_client_config clientConfig;
+        clientConfig.set_timeout(pushInterval);
+        web::http::client::http_client client(utility::conversions::to_string_t(pushUrl), clientConfig);
+        auto response = client.request(web::http::methods::POST, U(""), body, U("application/json")).get();
+        if (response.status_code() >= 300) {
+            SPDLOG_DEBUG("Pushing model residency to {} failed with HTTP status: {}", pushUrl, response.status_code());
+            return false;
+        }
+    } catch (const std::exception& e) {
+        SPDLOG_DEBUG("Pushing model residency to {} failed: {}", pushUrl, e.what());
+        return false;
+    }
+    return true;
+}
+
+std::vector<ModelResidency> ResidencyAdvertiser::collect(ModelManager& manager) {
+    std::vector<std::shared_ptr<Model>> models;
+    {
+        std::shared_lock lock(manager.modelsMtx);
+        for (const auto& [name, model] : manager.getModels()) {
+            models.push_back(model);
+        }
+    }
+    std::vector<ModelResidency> residency;
+    for (const auto& model : models) {
+        for (const auto& [version, unused] : model->getModelVersionsMapCopy()) {
+            auto instance = model->getModelInstanceByVersion(version);
+            if (!instance) {
+                continue;
+            }
+            const auto state = instance->getStatus().getState();
+            if (state == ModelVersionState::END) {
+                continue;
+            }
+            ModelResidency entry;
+            entry.name = instance->getName();
+            entry.version = version;
+            entry.state = state;
+            entry.warm = state == ModelVersionState::AVAILABLE;
+            entry.lazy = instance->isLoadedOnDemand();
+            const auto& metrics = instance->getMetrics();
+            entry.inferRequestsInUse = metrics.inferRequestsInUse ? metrics.inferRequestsInUse->get() : 0;
+            entry.inferRequestsWaiting = metrics.inferRequestsWaiting ? metrics.inferRequestsWaiting->get() : 0;
+            entry.inferRequests = metrics.inferRequests ? metrics.inferRequests->get() : 0;
+            entry.memoryBytes = instance->getMemoryUsage().total();
+            residency.push_back(std::move(entry));
+        }
+    }
+    return residency;
+}
+
+std::string ResidencyAdvertiser::toJson(const std::string& serverId, bool ready, const std::vector<ModelResidency>& models) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("server");
+    writer.String(serverId.c_str());
+    writer.Key("ready");
+    writer.Bool(ready);
+    writer.Key("models");
+    writer.StartArray();
+    for (const auto& model : models) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(model.name.c_str());
+        writer.Key("version");
+        writer.Int64(model.version);
+        writer.Key("state");
+        writer.String(ModelVersionStateToString(model.state).c_str());
+        writer.Key("warm");
+        writer.Bool(model.warm);
+        writer.Key("lazy");
+        writer.Bool(model.lazy);
+        writer.Key("in_use");
+        writer.Int64(model.inferRequestsInUse);
+        writer.Key("waiting");
+        writer.Int64(model.inferRequestsWaiting);
+        writer.Key("infer_requests");
+        writer.Int64(model.inferRequests);
+        writer.Key("memory_bytes");
+        writer.Uint64(model.memoryBytes);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return buffer.GetString();
+}
+
+std::string ResidencyAdvertiser::toJson(ModelManager& manager) const {
+    return toJson(serverId, manager.isReady(), collect(manager));
+}
+
+}  // namespace ovms
@@ -0,0 +1,110 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "modelversion.hpp"
+#include "modelversionstatus.hpp"
+
+namespace ovms {
+
+class ModelManager;
+
+/**
+ * @brief Model version present in server, as advertised to routers
+ */
+struct ModelResidency {
+    std::string name;
+    model_version_t version = 0;
+    ModelVersionState state = ModelVersionState::START;
+    // compiled and able to serve requests without loading
+    bool warm = false;
+    // compiled on first request and unloaded when idle
+    bool lazy = false;
+    int64_t inferRequestsInUse = 0;
+    int64_t inferRequestsWaiting = 0;
+    int64_t inferRequests = 0;
+    uint64_t memoryBytes = 0;
+};
+
+/**
+ * @brief Advertises model versions resident in server, so that routers can send requests to replicas serving them without load
+ *
+ * Residency is served by REST API and optionally pushed as the same JSON to registry URL at fixed interval from background thread.
+ * Versions which ended are left out, lazy loaded versions waiting for the first request or evicted are not warm.
+ */
+class ResidencyAdvertiser {
+    std::string serverId;
+    std::string pushUrl;
+    std::chrono::milliseconds pushInterval{0};
+
+    std::mutex mtx;
+    std::condition_variable exitCondition;
+    bool exiting = false;
+    std::thread pusher;
+    std::atomic<uint64_t> pushFailures{0};
+
+    ResidencyAdvertiser();
+    void pushRoutine(ModelManager& manager);
+    bool push(const std::string& body);
+
+public:
+    static ResidencyAdvertiser& instance() {
+        static ResidencyAdvertiser advertiser;
+        return advertiser;
+    }
+
+    ~ResidencyAdvertiser();
+
+    /**
+     * @brief Identifies server in advertised residency, defaults to host name
+     */
+    void setServerId(const std::string& serverId);
+
+    const std::string& getServerId() const {
+        return serverId;
+    }
+
+    /**
+     * @brief Starts posting residency to URL every interval
+     */
+    void start(ModelManager& manager, const std::string& url, std::chrono::milliseconds interval);
+
+    void stop();
+
+    uint64_t getPushFailuresCount() const {
+        return pushFailures.load(std::memory_order_relaxed);
+    }
+
+    static std::vector<ModelResidency> collect(ModelManager& manager);
+
+    static std::string toJson(const std::string& serverId, bool ready, const std::vector<ModelResidency>& models);
+
+    /**
+     * @brief Residency of server as JSON
+     */
+    std::string toJson(ModelManager& manager) const;
+};
+
+}  // namespace ovms
@@ -0,0 +1,124 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "response_cache.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+namespace {
+void appendValue(std::string& bytes, uint64_t value) {
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// length prefix keeps serialization of different inputs different
+void appendBytes(std::string& bytes, std::string_view value) {
+    appendValue(bytes, value.size());
+    bytes.append(value.data(), value.size());
+}
+}  // namespace
+
+ResponseCache::Key ResponseCache::computeKey(const tensorflow::serving::PredictRequest& requestProto) {
+    // protobuf map iteration order is unspecified
+    std::vector<const google::protobuf::MapPair<std::string, tensorflow::TensorProto>*> inputs;
+    inputs.reserve(requestProto.inputs().size());
+    size_t contentSize = 0;
+    for (const auto& input : requestProto.inputs()) {
+        inputs.push_back(&input);
+        contentSize += input.first.size() + input.second.tensor_content().size();
+    }
+    std::sort(inputs.begin(), inputs.end(), [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+
+    Key key;
+    key.inputs.reserve(contentSize + inputs.size() * 8 * sizeof(uint64_t));
+    appendValue(key.inputs, inputs.size());
+    for (const auto* input : inputs) {
+        const auto& tensorProto = input->second;
+        appendBytes(key.inputs, input->first);
+        appendValue(key.inputs, static_cast<uint64_t>(tensorProto.dtype()));
+        appendValue(key.inputs, static_cast<uint64_t>(tensorProto.tensor_shape().dim_size()));
+        for (const auto& dim : tensorProto.tensor_shape().dim()) {
+            appendValue(key.inputs, static_cast<uint64_t>(dim.size()));
+        }
+        if (tensorProto.tensor_content().size() > 0) {
+            appendBytes(key.inputs, tensorProto.tensor_content());
+        } else {
+            // typed value fields like half_val or string_val
+            appendBytes(key.inputs, tensorProto.SerializeAsString());
+        }
+    }
+    // responses differ in outputs selected by output filter
+    appendValue(key.inputs, static_cast<uint64_t>(requestProto.output_filter_size()));
+    for (const auto& outputName : requestProto.output_filter()) {
+        appendBytes(key.inputs, outputName);
+    }
+    key.hash = std::hash<std::string_view>{}(key.inputs);
+    return key;
+}
+
+bool ResponseCache::find(const Key& key, tensorflow::serving::PredictResponse& responseProto) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key.hash);
+    if (it == index.end() || it->second->key.inputs != key.inputs) {
+        misses++;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    *responseProto.mutable_outputs() = it->second->outputs;
+    hits++;
+    return true;
+}
+
+void ResponseCache::insert(const Key& key, const tensorflow::serving::PredictResponse& responseProto) {
+    const size_t byteSize = responseProto.ByteSizeLong() + key.inputs.size();
+    if (byteSize > capacityBytes) {
+        SPDLOG_DEBUG("Response of size: {} bytes exceeds response cache capacity: {} bytes", byteSize, capacityBytes);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.count(key.hash) > 0) {
+        // concurrent request with the same inputs or colliding hash was stored first
+        return;
+    }
+    while (usedBytes + byteSize > capacityBytes) {
+        SPDLOG_DEBUG("Evicting least recently used response from cache of size: {} bytes", capacityBytes);
+        usedBytes -= entries.back().byteSize;
+        index.erase(entries.back().key.hash);
+        entries.pop_back();
+    }
+    entries.push_front(Entry{key, byteSize, responseProto.outputs()});
+    index.emplace(key.hash, entries.begin());
+    usedBytes += byteSize;
+}
+
+size_t ResponseCache::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t ResponseCache::getUsedBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return usedBytes;
+}
+
+}  // namespace ovms
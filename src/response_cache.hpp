@@ -0,0 +1,120 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+namespace ovms {
+
+/**
+ * @brief Least recently used cache of predict response outputs keyed by request inputs
+ *
+ * Meant for deterministic models, responses are reused without running inference.
+ * Cache is bounded by the serialized size of stored outputs and their keys.
+ */
+class ResponseCache {
+public:
+    /**
+     * @brief Request inputs serialized in canonical order, hash is used for lookup and inputs are compared on hash match
+     */
+    struct Key {
+        uint64_t hash = 0;
+        std::string inputs;
+
+        bool operator==(const Key& rhs) const {
+            return hash == rhs.hash && inputs == rhs.inputs;
+        }
+    };
+
+private:
+    struct Entry {
+        Key key;
+        size_t byteSize;
+        google::protobuf::Map<std::string, tensorflow::TensorProto> outputs;
+    };
+
+    const size_t capacityBytes;
+    size_t usedBytes = 0;
+    std::mutex mutex;
+    // most recently used entry first
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+
+    std::atomic<uint64_t> hits = 0;
+    std::atomic<uint64_t> misses = 0;
+
+public:
+    explicit ResponseCache(size_t capacityBytes) :
+        capacityBytes(capacityBytes) {}
+
+    /**
+     * @brief Computes cache key from names, precisions, shapes and contents of request inputs and from its output filter
+     *
+     * @param requestProto
+     *
+     * @return Key
+     */
+    static Key computeKey(const tensorflow::serving::PredictRequest& requestProto);
+
+    /**
+     * @brief Copies cached outputs into response and marks entry as most recently used
+     *
+     * Entry with the same hash but different inputs is a miss.
+     *
+     * @param key
+     * @param responseProto
+     *
+     * @return true on cache hit
+     */
+    bool find(const Key& key, tensorflow::serving::PredictResponse& responseProto);
+
+    /**
+     * @brief Stores outputs of response evicting least recently used entries when cache is full
+     *
+     * On hash collision the entry already stored is kept.
+     *
+     * @param key
+     * @param responseProto
+     */
+    void insert(const Key& key, const tensorflow::serving::PredictResponse& responseProto);
+
+    size_t size();
+
+    size_t getUsedBytes();
+
+    size_t getCapacityBytes() const {
+        return capacityBytes;
+    }
+
+    uint64_t getHits() const {
+        return hits;
+    }
+
+    uint64_t getMisses() const {
+        return misses;
+    }
+};
+}  // namespace ovms
@@ -16,18 +16,44 @@
 #include "rest_parser.hpp"
 
 #include <functional>
+#include <numeric>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "rest_request_buffers.hpp"
 #include "rest_utils.hpp"
+#include "sparse_tensor.hpp"
 
 namespace ovms {
 
-RestParser::RestParser(const tensor_map_t& tensors) {
+RestParser::RestParser(const tensor_map_t& tensors) :
+    tensors(tensors) {
+    preallocate();
+}
+
+RestParser::RestParser(const tensor_map_t& tensors, tensorflow::serving::PredictRequest& recycledProto) :
+    tensors(tensors) {
+    requestProto.Swap(&recycledProto);
+    clearKeepingTensors(requestProto, *requestProto.mutable_inputs());
+    preallocate();
+}
+
+void RestParser::preallocate() {
+    // entries of recycled proto are reused, only inputs of other servables are dropped
+    auto& inputs = *requestProto.mutable_inputs();
+    for (auto it = inputs.begin(); it != inputs.end();) {
+        if (tensors.count(it->first) == 0) {
+            it = inputs.erase(it);
+        } else {
+            ++it;
+        }
+    }
     for (const auto& kv : tensors) {
         const auto& name = kv.first;
         const auto& tensor = kv.second;
         tensorPrecisionMap[name] = tensor->getPrecision();
-        auto& input = (*requestProto.mutable_inputs())[name];
+        auto& input = inputs[name];
         input.set_dtype(tensor->getPrecisionAsDataType());
         input.mutable_tensor_content()->reserve(std::accumulate(
                                                     tensor->getEffectiveShape().begin(),
@@ -38,6 +64,15 @@ RestParser::RestParser(const tensor_map_t& tensors) {
     }
 }
 
+void RestParser::reset() {
+    order = Order::UNKNOWN;
+    format = Format::UNKNOWN;
+    // buffers filled by streaming parser are reused by document parser
+    clearKeepingTensors(requestProto, *requestProto.mutable_inputs());
+    tensorPrecisionMap.clear();
+    preallocate();
+}
+
 void RestParser::removeUnusedInputs() {
     auto& inputs = (*requestProto.mutable_inputs());
     auto it = inputs.begin();
@@ -145,6 +180,62 @@ bool RestParser::parseArray(rapidjson::Value& doc, int dim, tensorflow::TensorPr
     return false;
 }
 
+bool isSparse(const rapidjson::Value& value) {
+    return value.IsObject() && value.MemberCount() == 3 &&
+           value.HasMember("indices") && value.HasMember("values") && value.HasMember("dense_shape");
+}
+
+bool RestParser::parseSparse(rapidjson::Value& doc, tensorflow::TensorProto& proto, const std::string& tensorName) {
+    auto& indices = doc["indices"];
+    auto& values = doc["values"];
+    auto& denseShape = doc["dense_shape"];
+    if (!indices.IsArray() || !values.IsArray() || !denseShape.IsArray() ||
+        denseShape.GetArray().Size() == 0 || indices.GetArray().Size() != values.GetArray().Size()) {
+        return false;
+    }
+    proto.mutable_tensor_shape()->clear_dim();
+    for (auto& dim : denseShape.GetArray()) {
+        if (!dim.IsInt64() || dim.GetInt64() < 0) {
+            return false;
+        }
+        proto.mutable_tensor_shape()->add_dim()->set_size(dim.GetInt64());
+    }
+    if (values.GetArray().Size() == 0) {
+        if (!tensorPrecisionMap.count(tensorName)) {
+            return false;
+        }
+    } else if (!setDTypeIfNotSet(values.GetArray()[0], proto, tensorName)) {
+        return false;
+    }
+    const auto count = values.GetArray().Size();
+    const auto rank = denseShape.GetArray().Size();
+    auto [indicesProto, valuesProto] = setSparseTensor(proto);
+    indicesProto->set_dtype(tensorflow::DataType::DT_INT64);
+    indicesProto->mutable_tensor_shape()->add_dim()->set_size(count);
+    indicesProto->mutable_tensor_shape()->add_dim()->set_size(rank);
+    indicesProto->mutable_tensor_content()->reserve(count * rank * sizeof(int64_t));
+    for (auto& index : indices.GetArray()) {
+        if (!index.IsArray() || index.GetArray().Size() != rank) {
+            return false;
+        }
+        for (auto& coordinate : index.GetArray()) {
+            if (!coordinate.IsInt64()) {
+                return false;
+            }
+            const int64_t value = coordinate.GetInt64();
+            indicesProto->mutable_tensor_content()->append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+    valuesProto->set_dtype(proto.dtype());
+    valuesProto->mutable_tensor_shape()->add_dim()->set_size(count);
+    for (auto& value : values.GetArray()) {
+        if (!value.IsNumber() || !addValue(*valuesProto, value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool RestParser::parseInstance(rapidjson::Value& doc) {
     if (doc.GetObject().MemberCount() == 0) {
         return false;
@@ -248,6 +339,12 @@ Status RestParser::parseColumnFormat(rapidjson::Value& node) {
     for (auto& kv : node.GetObject()) {
         std::string tensorName = kv.name.GetString();
         auto& proto = (*requestProto.mutable_inputs())[tensorName];
+        if (isSparse(kv.value)) {
+            if (!parseSparse(kv.value, proto, tensorName)) {
+                return StatusCode::REST_COULD_NOT_PARSE_INPUT;
+            }
+            continue;
+        }
         if (!parseArray(kv.value, 0, proto, tensorName)) {
             return StatusCode::REST_COULD_NOT_PARSE_INPUT;
         }
@@ -257,7 +354,418 @@ Status RestParser::parseColumnFormat(rapidjson::Value& node) {
     return StatusCode::OK;
 }
 
+/**
+ * @brief rapidjson SAX handler filling preallocated request proto while request body is being read.
+ *
+ * Follows the same rules as parseRowFormat and parseColumnFormat, but values are appended directly
+ * to tensor content of inputs without building a document first. Handler stops parsing (returns false)
+ * on anything that is invalid or needs the document parser: binary inputs, special inputs and inputs
+ * which are not present in model/DAG.
+ */
+class RestParserStreamingHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, RestParserStreamingHandler> {
+    enum class FrameType {
+        ROOT,
+        SKIPPED,
+        INSTANCES,
+        INSTANCE,
+        INPUTS,
+        ARRAY,
+        OUTPUT_FILTER
+    };
+
+    enum class ElementsType {
+        UNKNOWN,
+        ARRAYS,
+        VALUES
+    };
+
+    struct Frame {
+        FrameType type;
+        int dim = 0;
+        size_t size = 0;
+        ElementsType elements = ElementsType::UNKNOWN;
+    };
+
+    struct Input {
+        tensorflow::TensorProto* proto;
+        std::vector<int64_t> shape;
+    };
+
+    tensorflow::serving::PredictRequest& requestProto;
+    std::unordered_map<std::string, Input> inputs;
+    std::vector<Frame> stack;
+    Input* current = nullptr;
+    std::string rootKey;
+    bool instancesFound = false;
+    bool inputsFound = false;
+
+public:
+    Order order = Order::UNKNOWN;
+    Format format = Format::UNKNOWN;
+
+    RestParserStreamingHandler(tensorflow::serving::PredictRequest& requestProto) :
+        requestProto(requestProto) {
+        for (auto& kv : *requestProto.mutable_inputs()) {
+            inputs[kv.first] = Input{&kv.second, {}};
+        }
+    }
+
+    bool Null() { return skipValue(); }
+    bool Bool(bool) { return skipValue(); }
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        if (!stack.empty() && stack.back().type == FrameType::OUTPUT_FILTER) {
+            requestProto.add_output_filter(str, length);
+            return true;
+        }
+        return skipValue();
+    }
+    bool Int(int value) { return addNumber(value); }
+    bool Uint(unsigned value) { return addNumber(value); }
+    bool Int64(int64_t value) { return addNumber(value); }
+    bool Uint64(uint64_t value) { return addNumber(value); }
+    bool Double(double value) { return addNumber(value); }
+
+    bool StartObject() {
+        if (stack.empty()) {
+            stack.push_back({FrameType::ROOT});
+            return true;
+        }
+        switch (stack.back().type) {
+        case FrameType::ROOT:
+            if (rootKey == "instances" || rootKey == "output_filter") {
+                return false;
+            }
+            if (rootKey == "inputs") {
+                order = Order::COLUMN;
+                format = Format::NAMED;
+                stack.push_back({FrameType::INPUTS});
+            } else {
+                stack.push_back({FrameType::SKIPPED});
+            }
+            rootKey.clear();
+            return true;
+        case FrameType::SKIPPED:
+            stack.push_back({FrameType::SKIPPED});
+            return true;
+        case FrameType::INSTANCES:
+            format = Format::NAMED;
+            stack.back().size++;
+            stack.push_back({FrameType::INSTANCE});
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        auto& frame = stack.back();
+        switch (frame.type) {
+        case FrameType::ROOT:
+            rootKey.assign(str, length);
+            if (rootKey == "instances" || rootKey == "inputs") {
+                if (instancesFound || inputsFound) {
+                    return false;
+                }
+                (rootKey == "instances" ? instancesFound : inputsFound) = true;
+            }
+            return true;
+        case FrameType::SKIPPED:
+            return true;
+        case FrameType::INSTANCE:
+        case FrameType::INPUTS:
+            current = findInput(std::string(str, length));
+            if (current == nullptr) {
+                return false;
+            }
+            if (frame.type == FrameType::INSTANCE) {
+                if (current->shape.empty()) {
+                    current->shape.push_back(0);
+                }
+                current->shape[0]++;
+            }
+            frame.size++;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        const auto& frame = stack.back();
+        if ((frame.type == FrameType::INSTANCE || frame.type == FrameType::INPUTS) && frame.size == 0) {
+            return false;
+        }
+        stack.pop_back();
+        return true;
+    }
+
+    bool StartArray() {
+        if (stack.empty()) {
+            return false;
+        }
+        switch (stack.back().type) {
+        case FrameType::ROOT:
+            if (rootKey == "instances") {
+                order = Order::ROW;
+                stack.push_back({FrameType::INSTANCES});
+            } else if (rootKey == "inputs") {
+                order = Order::COLUMN;
+                if (!startNoNamedInput()) {
+                    return false;
+                }
+                stack.push_back({FrameType::ARRAY, 0});
+            } else if (rootKey == "output_filter") {
+                stack.push_back({FrameType::OUTPUT_FILTER});
+            } else {
+                stack.push_back({FrameType::SKIPPED});
+            }
+            rootKey.clear();
+            return true;
+        case FrameType::SKIPPED:
+            stack.push_back({FrameType::SKIPPED});
+            return true;
+        case FrameType::INSTANCE:
+            stack.push_back({FrameType::ARRAY, 1});
+            return true;
+        case FrameType::INPUTS:
+            stack.push_back({FrameType::ARRAY, 0});
+            return true;
+        case FrameType::INSTANCES:
+            if (!startNoNamedInstances()) {
+                return false;
+            }
+            [[fallthrough]];
+        case FrameType::ARRAY: {
+            auto& frame = stack.back();
+            if (frame.elements == ElementsType::VALUES) {
+                return false;
+            }
+            frame.elements = ElementsType::ARRAYS;
+            frame.size++;
+            int dim = frame.dim + 1;
+            stack.push_back({FrameType::ARRAY, dim});
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        const auto& frame = stack.back();
+        if (frame.type == FrameType::INSTANCES && frame.size == 0) {
+            return false;
+        }
+        if (frame.type == FrameType::ARRAY) {
+            if (frame.size == 0) {
+                return false;
+            }
+            if (!setDimOrValidate(*current, frame.dim, frame.size)) {
+                return false;
+            }
+        }
+        stack.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Writes collected shapes to request proto after successful parsing
+     *
+     * @return false if request did not contain instances nor inputs
+     */
+    bool finish() {
+        if (!instancesFound && !inputsFound) {
+            return false;
+        }
+        for (auto& kv : inputs) {
+            const auto& shape = kv.second.shape;
+            if (shape.empty()) {
+                continue;
+            }
+            auto* tensorShape = kv.second.proto->mutable_tensor_shape();
+            tensorShape->Clear();
+            for (auto dim : shape) {
+                if (dim <= 0) {
+                    return false;
+                }
+                tensorShape->add_dim()->set_size(dim);
+            }
+        }
+        return true;
+    }
+
+private:
+    Input* findInput(const std::string& name) {
+        if (name == "sequence_id" || name == "sequence_control_input") {
+            return nullptr;
+        }
+        auto it = inputs.find(name);
+        if (it == inputs.end()) {
+            return nullptr;
+        }
+        switch (it->second.proto->dtype()) {
+        case tensorflow::DataType::DT_FLOAT:
+        case tensorflow::DataType::DT_INT32:
+        case tensorflow::DataType::DT_INT8:
+        case tensorflow::DataType::DT_UINT8:
+        case tensorflow::DataType::DT_DOUBLE:
+        case tensorflow::DataType::DT_HALF:
+        case tensorflow::DataType::DT_INT16:
+        case tensorflow::DataType::DT_UINT16:
+        case tensorflow::DataType::DT_INT64:
+        case tensorflow::DataType::DT_UINT32:
+        case tensorflow::DataType::DT_UINT64:
+            return &it->second;
+        default:
+            return nullptr;
+        }
+    }
+
+    bool startNoNamedInput() {
+        if (requestProto.inputs_size() != 1) {
+            return false;
+        }
+        current = findInput(requestProto.inputs().begin()->first);
+        if (current == nullptr) {
+            return false;
+        }
+        format = Format::NONAMED;
+        return true;
+    }
+
+    // Instances array which does not start with an object is the outermost array of no named input
+    bool startNoNamedInstances() {
+        auto& frame = stack.back();
+        if (frame.size != 0 || !startNoNamedInput()) {
+            return false;
+        }
+        frame.type = FrameType::ARRAY;
+        frame.dim = 0;
+        return true;
+    }
+
+    static bool setDimOrValidate(Input& input, int dim, size_t size) {
+        if (input.shape.size() <= static_cast<size_t>(dim)) {
+            input.shape.resize(dim + 1, 0);
+        }
+        if (input.shape[dim] == 0) {
+            input.shape[dim] = size;
+            return true;
+        }
+        return input.shape[dim] == static_cast<int64_t>(size);
+    }
+
+    bool skipValue() {
+        if (stack.empty()) {
+            return false;
+        }
+        const auto& frame = stack.back();
+        if (frame.type == FrameType::SKIPPED) {
+            return true;
+        }
+        if (frame.type == FrameType::ROOT && rootKey != "instances" && rootKey != "inputs" && rootKey != "output_filter") {
+            rootKey.clear();
+            return true;
+        }
+        return false;
+    }
+
+    template <typename T, typename V>
+    void appendToTensorContent(V value) {
+        T converted = static_cast<T>(value);
+        current->proto->mutable_tensor_content()->append(reinterpret_cast<const char*>(&converted), sizeof(T));
+    }
+
+    template <typename V>
+    bool addNumber(V value) {
+        if (stack.empty()) {
+            return false;
+        }
+        auto& frame = stack.back();
+        if (frame.type == FrameType::SKIPPED) {
+            return true;
+        }
+        if (frame.type == FrameType::ROOT) {
+            return skipValue();
+        }
+        if (frame.type == FrameType::INSTANCES && !startNoNamedInstances()) {
+            return false;
+        }
+        if (frame.type != FrameType::ARRAY || frame.elements == ElementsType::ARRAYS) {
+            return false;
+        }
+        frame.elements = ElementsType::VALUES;
+        frame.size++;
+        switch (current->proto->dtype()) {
+        case tensorflow::DataType::DT_FLOAT:
+            appendToTensorContent<float>(value);
+            break;
+        case tensorflow::DataType::DT_INT32:
+            appendToTensorContent<int32_t>(value);
+            break;
+        case tensorflow::DataType::DT_INT8:
+            appendToTensorContent<int8_t>(value);
+            break;
+        case tensorflow::DataType::DT_UINT8:
+            appendToTensorContent<uint8_t>(value);
+            break;
+        case tensorflow::DataType::DT_DOUBLE:
+            appendToTensorContent<double>(value);
+            break;
+        case tensorflow::DataType::DT_HALF:
+            current->proto->add_half_val(static_cast<int32_t>(value));
+            break;
+        case tensorflow::DataType::DT_INT16:
+            appendToTensorContent<int16_t>(value);
+            break;
+        case tensorflow::DataType::DT_UINT16:
+            current->proto->add_int_val(static_cast<int32_t>(value));
+            break;
+        case tensorflow::DataType::DT_INT64:
+            appendToTensorContent<int64_t>(value);
+            break;
+        case tensorflow::DataType::DT_UINT32:
+            appendToTensorContent<uint32_t>(value);
+            break;
+        case tensorflow::DataType::DT_UINT64:
+            appendToTensorContent<uint64_t>(value);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+};
+
+bool RestParser::parseStreaming(const char* json) {
+    RestParserStreamingHandler handler(requestProto);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(json);
+    if (reader.Parse(stream, handler).IsError() || !handler.finish()) {
+        return false;
+    }
+    order = handler.order;
+    format = handler.format;
+    if (format == Format::NAMED) {
+        removeUnusedInputs();
+        if (order == Order::ROW && !isBatchSizeEqualForAllInputs()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 Status RestParser::parse(const char* json) {
+    if (parseStreaming(json)) {
+        return StatusCode::OK;
+    }
+    // Streaming parser gives up on invalid requests and on content it does not handle.
+    // Document parser is then the reference for both results and error codes.
+    reset();
+    return parseDocument(json);
+}
+
+Status RestParser::parseDocument(const char* json) {
     rapidjson::Document doc;
     if (doc.Parse(json).HasParseError()) {
         return StatusCode::JSON_INVALID;
@@ -270,6 +778,13 @@ Status RestParser::parse(const char* json) {
     if (instancesItr != doc.MemberEnd() && inputsItr != doc.MemberEnd()) {
         return StatusCode::REST_PREDICT_UNKNOWN_ORDER;
     }
+    auto outputFilterItr = doc.FindMember("output_filter");
+    if (outputFilterItr != doc.MemberEnd()) {
+        auto status = parseOutputFilter(outputFilterItr->value);
+        if (!status.ok()) {
+            return status;
+        }
+    }
     if (instancesItr != doc.MemberEnd()) {
         return parseRowFormat(instancesItr->value);
     }
@@ -279,6 +794,19 @@ Status RestParser::parse(const char* json) {
     return StatusCode::REST_PREDICT_UNKNOWN_ORDER;
 }
 
+Status RestParser::parseOutputFilter(rapidjson::Value& node) {
+    if (!node.IsArray()) {
+        return StatusCode::INVALID_OUTPUT_FILTER;
+    }
+    for (const auto& outputName : node.GetArray()) {
+        if (!outputName.IsString()) {
+            return StatusCode::INVALID_OUTPUT_FILTER;
+        }
+        requestProto.add_output_filter(outputName.GetString(), outputName.GetStringLength());
+    }
+    return StatusCode::OK;
+}
+
 void RestParser::increaseBatchSize(tensorflow::TensorProto& proto) {
     if (proto.tensor_shape().dim_size() < 1) {
         proto.mutable_tensor_shape()->add_dim()->set_size(0);
@@ -298,15 +826,6 @@ bool RestParser::setDimOrValidate(tensorflow::TensorProto& proto, int dim, int s
     }
 }
 
-bool getB64FromValue(const rapidjson::Value& value, std::string& b64Val) {
-    if (!isBinary(value)) {
-        return false;
-    }
-
-    b64Val = value["b64"].GetString();
-    return true;
-}
-
 template <typename T>
 bool addToTensorContent(tensorflow::TensorProto& proto, T value) {
     if (sizeof(T) != DataTypeSize(proto.dtype())) {
@@ -389,15 +908,13 @@ bool addToIntVal(tensorflow::TensorProto& proto, const rapidjson::Value& value)
 
 bool RestParser::addValue(tensorflow::TensorProto& proto, const rapidjson::Value& value) {
     if (isBinary(value)) {
-        std::string b64Val;
-        if (!getB64FromValue(value, b64Val))
-            return false;
-        std::string decodedBytes;
-        if (decodeBase64(b64Val, decodedBytes) == StatusCode::OK) {
-            proto.add_string_val(decodedBytes.c_str(), decodedBytes.length());
+        const auto& b64Val = value["b64"];
+        // decoded straight into string_val storage consumed by deserialization
+        if (decodeBase64(b64Val.GetString(), b64Val.GetStringLength(), *proto.add_string_val()) == StatusCode::OK) {
             proto.set_dtype(tensorflow::DataType::DT_STRING);
             return true;
         } else {
+            proto.mutable_string_val()->RemoveLast();
             return false;
         }
     }
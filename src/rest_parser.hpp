@@ -73,6 +73,21 @@ class RestParser {
      */
     std::map<std::string, InferenceEngine::Precision> tensorPrecisionMap;
 
+    /**
+     * @brief Model/DAG inputs used to preallocate request proto
+     */
+    const tensor_map_t tensors;
+
+    /**
+     * @brief Creates inputs in request proto with data type and tensor content memory reserved for expected shape
+     */
+    void preallocate();
+
+    /**
+     * @brief Restores state from before parsing
+     */
+    void reset();
+
     void removeUnusedInputs();
 
     /**
@@ -114,6 +129,23 @@ class RestParser {
      */
     bool parseArray(rapidjson::Value& doc, int dim, tensorflow::TensorProto& proto, const std::string& tensorName);
 
+    /**
+     * @brief Parses rapidjson Node of input sent in sparse encoding, as a list of indices and values of dense tensor
+     * 
+     * @param doc rapidjson Node
+     * @param input destination marked as sparse tensor
+     * 
+     * @return false if processing failed, true when succeeded
+     * 
+     * Rapid json node expected to be passed in following structure:
+     * {
+     *     "indices": [[0, 3], [1, 7], ...],
+     *     "values": [0.5, 1.5, ...],
+     *     "dense_shape": [2, 1000]
+     * }
+     */
+    bool parseSparse(rapidjson::Value& doc, tensorflow::TensorProto& proto, const std::string& tensorName);
+
     /**
      * @brief Parses rapidjson Node for inputs in a string(name)=>array(data) format
      * 
@@ -167,6 +199,33 @@ class RestParser {
      */
     Status parseColumnFormat(rapidjson::Value& node);
 
+    /**
+     * @brief Parses names of outputs requested by the client
+     *
+     * @param node rapidjson Node
+     *
+     * @return INVALID_OUTPUT_FILTER if node is not an array of strings
+     *
+     * Rapid json node expected to be passed in following structure:
+     * ["outputA", "outputB", ...]
+     */
+    Status parseOutputFilter(rapidjson::Value& node);
+
+    /**
+     * @brief Parses request body with SAX reader, writing values directly into preallocated tensor content
+     *
+     * @return true when request was parsed, false if it is invalid or requires parseDocument
+     *         (binary inputs, special inputs, inputs not present in model/DAG). Request proto is left partially filled then.
+     */
+    bool parseStreaming(const char* json);
+
+    /**
+     * @brief Parses request body into rapidjson document first and then walks it to fill request proto
+     *
+     * @return Status indicating error code or success
+     */
+    Status parseDocument(const char* json);
+
 public:
     bool setDTypeIfNotSet(const rapidjson::Value& value, tensorflow::TensorProto& proto, const std::string& tensorName);
     /**
@@ -176,6 +235,13 @@ public:
      */
     RestParser(const tensor_map_t& tensors);
 
+    /**
+     * @brief Constructor reusing request proto of previous request, cleared input entries keep capacity of their buffers
+     *
+     * @param recycledProto proto swapped into the parser, parsed proto can be swapped back into it once request is processed
+     */
+    RestParser(const tensor_map_t& tensors, tensorflow::serving::PredictRequest& recycledProto);
+
     /**
      * @brief Gets parsed request proto
      * 
@@ -199,6 +265,8 @@ public:
 
     /**
      * @brief Parses http request body string
+     *
+     * Request is streamed into preallocated inputs when possible, otherwise it is parsed as rapidjson document.
      * 
      * @param json request string
      * 
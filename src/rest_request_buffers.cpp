@@ -0,0 +1,79 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "rest_request_buffers.hpp"
+
+#include <utility>
+
+namespace ovms {
+
+namespace {
+void trimString(std::string& buffer) {
+    if (buffer.capacity() > RestRequestBuffers::MAX_REUSED_BUFFER_BYTES) {
+        std::string().swap(buffer);
+    } else {
+        buffer.clear();
+    }
+}
+
+template <typename TensorMap>
+void trimTensors(TensorMap& tensors) {
+    for (auto it = tensors.begin(); it != tensors.end();) {
+        if (it->second.SpaceUsedLong() > RestRequestBuffers::MAX_REUSED_BUFFER_BYTES) {
+            it = tensors.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+}  // namespace
+
+RestRequestBuffers& RestRequestBuffers::current() {
+    thread_local RestRequestBuffers buffers;
+    return buffers;
+}
+
+void RestRequestBuffers::prepareResponse(const tensorflow::serving::PredictRequest& request) {
+    std::string key = request.model_spec().name() + '\n' + std::to_string(request.model_spec().version().value());
+    for (const auto& name : request.output_filter()) {
+        key += '\n' + name;
+    }
+    if (key != responseKey) {
+        response.Clear();
+        responseKey = std::move(key);
+        return;
+    }
+    clearKeepingTensors(response, *response.mutable_outputs());
+}
+
+void RestRequestBuffers::trim() {
+    trimString(body);
+    trimString(output);
+    trimTensors(*request.mutable_inputs());
+    trimTensors(*response.mutable_outputs());
+}
+
+void removeUnwrittenOutputs(tensorflow::serving::PredictResponse& response) {
+    auto& outputs = *response.mutable_outputs();
+    for (auto it = outputs.begin(); it != outputs.end();) {
+        if (it->second.dtype() == tensorflow::DataType::DT_INVALID) {
+            it = outputs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace ovms
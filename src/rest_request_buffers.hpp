@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+namespace ovms {
+
+/**
+ * @brief Buffers of REST worker thread reused by its consecutive requests
+ *
+ * Body and JSON output strings are cleared instead of destroyed and entries of request inputs and response outputs
+ * are cleared in place, so their tensor content and value buffers keep capacity for the next request.
+ * Buffers which grew above MAX_REUSED_BUFFER_BYTES are released after the request.
+ */
+class RestRequestBuffers {
+    // servable and output filter of the request which wrote the kept response entries
+    std::string responseKey;
+
+public:
+    static constexpr size_t MAX_REUSED_BUFFER_BYTES = 64 * 1024 * 1024;
+
+    std::string body;
+    std::string output;
+    tensorflow::serving::PredictRequest request;
+    tensorflow::serving::PredictResponse response;
+
+    /**
+     * @brief Buffers of calling thread
+     */
+    static RestRequestBuffers& current();
+
+    /**
+     * @brief Clears response before infer of request
+     *
+     * Entries written for previous request are kept only when it targeted the same servable version with the same output filter,
+     * so that the same outputs are written into them again.
+     */
+    void prepareResponse(const tensorflow::serving::PredictRequest& request);
+
+    /**
+     * @brief Releases buffers which grew above MAX_REUSED_BUFFER_BYTES, called after response is sent
+     */
+    void trim();
+};
+
+/**
+ * @brief Clears message fields, entries of tensor map are cleared in place and keep capacity of their buffers
+ */
+template <typename Message, typename TensorMap>
+void clearKeepingTensors(Message& message, TensorMap& tensors) {
+    TensorMap kept;
+    kept.swap(tensors);
+    message.Clear();
+    tensors.swap(kept);
+    for (auto& [name, tensor] : tensors) {
+        tensor.Clear();
+    }
+}
+
+/**
+ * @brief Erases output entries which were not written by infer, e.g. kept for outputs of previous request
+ */
+void removeUnwrittenOutputs(tensorflow::serving::PredictResponse& response);
+
+}  // namespace ovms
@@ -15,25 +15,34 @@
 //*****************************************************************************
 #include "rest_utils.hpp"
 
-#include <spdlog/spdlog.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
 
-#include "absl/strings/escaping.h"
+#include <immintrin.h>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wall"
-#include "tensorflow_serving/util/json_tensor.h"
-#pragma GCC diagnostic pop
+#include <rapidjson/internal/dtoa.h>
+#include <rapidjson/prettywriter.h>
+#include <spdlog/spdlog.h>
 
+#include "absl/strings/escaping.h"
+#include "deserialization.hpp"
 #include "timer.hpp"
 
 using tensorflow::DataType;
 using tensorflow::DataTypeSize;
-using tensorflow::serving::JsonPredictRequestFormat;
-using tensorflow::serving::MakeJsonFromTensors;
 using tensorflow::serving::PredictResponse;
 
 namespace ovms {
 
+enum : size_t {
+    CONVERT,
+    TIMER_END
+};
+
 Status checkValField(const size_t& fieldSize, const size_t& expectedElementsNumber) {
     if (fieldSize == 0)
         return StatusCode::REST_SERIALIZE_NO_DATA;
@@ -42,6 +51,264 @@ Status checkValField(const size_t& fieldSize, const size_t& expectedElementsNumb
     return StatusCode::OK;
 }
 
+namespace {
+
+/**
+ * @brief rapidjson output stream appending directly to response string
+ */
+class StringOutputStream {
+    std::string& output;
+
+public:
+    typedef char Ch;
+
+    StringOutputStream(std::string& output) :
+        output(output) {}
+
+    void Put(char c) { output.push_back(c); }
+    void Flush() {}
+};
+
+using JsonWriter = rapidjson::PrettyWriter<StringOutputStream, rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag>;
+
+/**
+ * @brief Writes shortest decimal representation which converts back to the same float.
+ *
+ * Grisu2 from rapidjson used for doubles, with boundaries computed for single precision.
+ * Returns pointer past the last written character.
+ */
+char* writeShortestFloat(float value, char* buffer) {
+    using rapidjson::internal::DiyFp;
+    if (value == 0) {
+        if (std::signbit(value)) {
+            *buffer++ = '-';
+        }
+        std::memcpy(buffer, "0.0", 3);
+        return buffer + 3;
+    }
+    if (value < 0) {
+        *buffer++ = '-';
+        value = -value;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint64_t significand = bits & 0x7FFFFF;
+    const int biasedExponent = bits >> 23;
+    const DiyFp v = biasedExponent ? DiyFp(significand | 0x800000, biasedExponent - 150) : DiyFp(significand, -149);
+
+    DiyFp plus = DiyFp((v.f << 1) + 1, v.e - 1).Normalize();
+    DiyFp minus = (v.f == 0x800000) ? DiyFp((v.f << 2) - 1, v.e - 2) : DiyFp((v.f << 1) - 1, v.e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    int K;
+    const DiyFp cachedPower = rapidjson::internal::GetCachedPower(plus.e, &K);
+    const DiyFp W = v.Normalize() * cachedPower;
+    DiyFp Wp = plus * cachedPower;
+    DiyFp Wm = minus * cachedPower;
+    Wm.f++;
+    Wp.f--;
+    int length;
+    rapidjson::internal::DigitGen(W, Wp, Wp.f - Wm.f, buffer, &length, &K);
+    return rapidjson::internal::Prettify(buffer, length, K, 324);
+}
+
+void writeFloat(JsonWriter& writer, float value) {
+    if (!std::isfinite(value)) {
+        writer.Double(value);
+        return;
+    }
+    char buffer[32];
+    char* end = writeShortestFloat(value, buffer);
+    writer.RawValue(buffer, end - buffer, rapidjson::kNumberType);
+}
+
+template <typename T>
+T getFromTensorContent(const tensorflow::TensorProto& tensor, size_t index) {
+    T value;
+    std::memcpy(&value, tensor.tensor_content().data() + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+void writeValue(JsonWriter& writer, const tensorflow::TensorProto& tensor, bool inValField, size_t index) {
+    switch (tensor.dtype()) {
+    case DataType::DT_FLOAT:
+        writeFloat(writer, inValField ? tensor.float_val(index) : getFromTensorContent<float>(tensor, index));
+        break;
+    case DataType::DT_DOUBLE:
+        writer.Double(inValField ? tensor.double_val(index) : getFromTensorContent<double>(tensor, index));
+        break;
+    case DataType::DT_INT32:
+        writer.Int(inValField ? tensor.int_val(index) : getFromTensorContent<int32_t>(tensor, index));
+        break;
+    case DataType::DT_INT8:
+        writer.Int(inValField ? tensor.int_val(index) : getFromTensorContent<int8_t>(tensor, index));
+        break;
+    case DataType::DT_UINT8:
+        writer.Int(inValField ? tensor.int_val(index) : getFromTensorContent<uint8_t>(tensor, index));
+        break;
+    case DataType::DT_INT16:
+        writer.Int(inValField ? tensor.int_val(index) : getFromTensorContent<int16_t>(tensor, index));
+        break;
+    case DataType::DT_INT64:
+        writer.Int64(inValField ? tensor.int64_val(index) : getFromTensorContent<int64_t>(tensor, index));
+        break;
+    case DataType::DT_UINT32:
+        writer.Uint(inValField ? tensor.uint32_val(index) : getFromTensorContent<uint32_t>(tensor, index));
+        break;
+    case DataType::DT_UINT64:
+        writer.Uint64(inValField ? tensor.uint64_val(index) : getFromTensorContent<uint64_t>(tensor, index));
+        break;
+    case DataType::DT_HALF:
+        writeFloat(writer, convertFp16ToFp32(inValField ? tensor.half_val(index) : getFromTensorContent<uint16_t>(tensor, index)));
+        break;
+    case DataType::DT_BFLOAT16: {
+        const uint32_t bits = static_cast<uint32_t>(inValField ? tensor.half_val(index) : getFromTensorContent<uint16_t>(tensor, index)) << 16;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        writeFloat(writer, value);
+        break;
+    }
+    case DataType::DT_STRING: {
+        // binary data like encoded images is returned the same way as it is sent in requests
+        const std::string encoded = absl::Base64Escape(tensor.string_val(index));
+        writer.StartObject();
+        writer.Key("b64");
+        writer.String(encoded.c_str(), encoded.size());
+        writer.EndObject();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+struct OutputData {
+    const std::string& name;
+    const tensorflow::TensorProto& tensor;
+    bool inValField;
+};
+
+int getValFieldSize(const tensorflow::TensorProto& tensor) {
+    switch (tensor.dtype()) {
+    case DataType::DT_FLOAT:
+        return tensor.float_val_size();
+    case DataType::DT_DOUBLE:
+        return tensor.double_val_size();
+    case DataType::DT_INT32:
+    case DataType::DT_INT8:
+    case DataType::DT_UINT8:
+    case DataType::DT_INT16:
+        return tensor.int_val_size();
+    case DataType::DT_INT64:
+        return tensor.int64_val_size();
+    case DataType::DT_UINT32:
+        return tensor.uint32_val_size();
+    case DataType::DT_UINT64:
+        return tensor.uint64_val_size();
+    case DataType::DT_HALF:
+    case DataType::DT_BFLOAT16:
+        return tensor.half_val_size();
+    case DataType::DT_STRING:
+        return tensor.string_val_size();
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief Writes nested arrays of tensor starting from given dimension, index is advanced past written elements
+ */
+void writeTensor(JsonWriter& writer, const OutputData& output, int dim, size_t& index) {
+    const auto& shape = output.tensor.tensor_shape();
+    if (dim == shape.dim_size()) {
+        writeValue(writer, output.tensor, output.inValField, index++);
+        return;
+    }
+    writer.StartArray();
+    for (int64_t i = 0; i < shape.dim(dim).size(); i++) {
+        writeTensor(writer, output, dim + 1, index);
+    }
+    writer.EndArray();
+}
+
+size_t getNumberOfElements(const tensorflow::TensorProto& tensor, int firstDim = 0) {
+    size_t elements = 1;
+    for (int i = firstDim; i < tensor.tensor_shape().dim_size(); i++) {
+        elements *= tensor.tensor_shape().dim(i).size();
+    }
+    return elements;
+}
+
+Status writeColumnFormat(JsonWriter& writer, const std::vector<OutputData>& outputs) {
+    writer.StartObject();
+    writer.Key("outputs");
+    if (outputs.size() > 1) {
+        writer.StartObject();
+    }
+    for (const auto& output : outputs) {
+        if (outputs.size() > 1) {
+            writer.Key(output.name.c_str(), output.name.size());
+        }
+        size_t index = 0;
+        writeTensor(writer, output, 0, index);
+    }
+    if (outputs.size() > 1) {
+        writer.EndObject();
+    }
+    writer.EndObject();
+    return StatusCode::OK;
+}
+
+Status writeRowFormat(JsonWriter& writer, const std::vector<OutputData>& outputs) {
+    int64_t batchSize = 0;
+    for (const auto& output : outputs) {
+        if (output.tensor.tensor_shape().dim_size() == 0) {
+            SPDLOG_ERROR("Creating json from tensors failed: output {} has no shape information", output.name);
+            return StatusCode::REST_PROTO_TO_STRING_ERROR;
+        }
+        auto outputBatchSize = output.tensor.tensor_shape().dim(0).size();
+        if (outputBatchSize < 1 || (batchSize != 0 && outputBatchSize != batchSize)) {
+            SPDLOG_ERROR("Creating json from tensors failed: output {} batch size {} is invalid or differs from other outputs", output.name, outputBatchSize);
+            return StatusCode::REST_PROTO_TO_STRING_ERROR;
+        }
+        batchSize = outputBatchSize;
+    }
+
+    writer.StartObject();
+    writer.Key("predictions");
+    writer.StartArray();
+    const bool named = outputs.size() > 1;
+    if (!named) {
+        writer.SetFormatOptions(rapidjson::kFormatSingleLineArray);
+    }
+    for (int64_t batch = 0; batch < batchSize; batch++) {
+        if (named) {
+            writer.StartObject();
+        }
+        for (const auto& output : outputs) {
+            size_t index = batch * getNumberOfElements(output.tensor, 1);
+            if (named) {
+                writer.Key(output.name.c_str(), output.name.size());
+                writer.SetFormatOptions(rapidjson::kFormatSingleLineArray);
+            }
+            writeTensor(writer, output, 1, index);
+            if (named) {
+                writer.SetFormatOptions(rapidjson::kFormatDefault);
+            }
+        }
+        if (named) {
+            writer.EndObject();
+        }
+    }
+    writer.SetFormatOptions(rapidjson::kFormatDefault);
+    writer.EndArray();
+    writer.EndObject();
+    return StatusCode::OK;
+}
+
+}  // namespace
+
 Status makeJsonFromPredictResponse(
     PredictResponse& response_proto,
     std::string* response_json,
@@ -50,20 +317,23 @@ Status makeJsonFromPredictResponse(
         return StatusCode::REST_PREDICT_UNKNOWN_ORDER;
     }
 
-    Timer timer;
+    Timer<TIMER_END> timer;
     using std::chrono::microseconds;
 
-    timer.start("convert");
+    timer.start(CONVERT);
 
-    for (auto& kv : *response_proto.mutable_outputs()) {
-        auto& tensor = kv.second;
+    std::vector<OutputData> outputs;
+    outputs.reserve(response_proto.outputs_size());
+    size_t totalElements = 0;
+    for (const auto& kv : response_proto.outputs()) {
+        const auto& tensor = kv.second;
 
-        size_t expectedContentSize = DataTypeSize(tensor.dtype());
-        for (int i = 0; i < tensor.tensor_shape().dim_size(); i++) {
-            expectedContentSize *= tensor.tensor_shape().dim(i).size();
-        }
         size_t dataTypeSize = DataTypeSize(tensor.dtype());
-        size_t expectedElementsNumber = dataTypeSize > 0 ? expectedContentSize / dataTypeSize : 0;
+        size_t expectedElementsNumber = getNumberOfElements(tensor);
+        size_t expectedContentSize = dataTypeSize * expectedElementsNumber;
+        if (dataTypeSize == 0 && tensor.dtype() != DataType::DT_STRING) {
+            expectedElementsNumber = 0;
+        }
         bool seekDataInValField = false;
 
         if (tensor.tensor_content().size() == 0)
@@ -71,127 +341,245 @@ Status makeJsonFromPredictResponse(
         else if (tensor.tensor_content().size() != expectedContentSize)
             return StatusCode::REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE;
 
-        switch (tensor.dtype()) {
-        case DataType::DT_FLOAT:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.float_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(float))
-                    tensor.add_float_val(*reinterpret_cast<float*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT32:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.int_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int32_t))
-                    tensor.add_int_val(*reinterpret_cast<int32_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT8:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.int_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int8_t))
-                    tensor.add_int_val(*reinterpret_cast<int8_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_UINT8:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.int_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(uint8_t))
-                    tensor.add_int_val(*reinterpret_cast<uint8_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_DOUBLE:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.double_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(double))
-                    tensor.add_double_val(*reinterpret_cast<double*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT16:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.int_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int16_t))
-                    tensor.add_int_val(*reinterpret_cast<int16_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT64:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.int64_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int64_t))
-                    tensor.add_int64_val(*reinterpret_cast<int64_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_UINT32:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.uint32_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(uint32_t))
-                    tensor.add_uint32_val(*reinterpret_cast<uint32_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_UINT64:
-            if (seekDataInValField) {
-                auto status = checkValField(tensor.uint64_val_size(), expectedElementsNumber);
-                if (!status.ok())
-                    return status;
-            } else {
-                for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(uint64_t))
-                    tensor.add_uint64_val(*reinterpret_cast<uint64_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        default:
+        int valFieldSize = getValFieldSize(tensor);
+        if (valFieldSize < 0) {
             return StatusCode::REST_UNSUPPORTED_PRECISION;
         }
+        if (seekDataInValField) {
+            auto status = checkValField(valFieldSize, expectedElementsNumber);
+            if (!status.ok())
+                return status;
+        }
+        outputs.push_back({kv.first, tensor, seekDataInValField});
+        totalElements += expectedElementsNumber;
+    }
+
+    if (outputs.empty()) {
+        SPDLOG_ERROR("Creating json from tensors failed: response has no outputs");
+        return StatusCode::REST_PROTO_TO_STRING_ERROR;
     }
 
-    timer.stop("convert");
-    timer.start("MakeJsonFromTensors");
+    response_json->clear();
+    // Rough estimate of formatted number length, avoids most reallocations for large outputs
+    response_json->reserve(totalElements * 12);
+    StringOutputStream stream(*response_json);
+    JsonWriter writer(stream);
+    auto status = order == Order::ROW ? writeRowFormat(writer, outputs) : writeColumnFormat(writer, outputs);
 
-    const auto& tf_status = MakeJsonFromTensors(
-        response_proto.outputs(),
-        order == Order::ROW ? JsonPredictRequestFormat::kRow : JsonPredictRequestFormat::kColumnar,
-        response_json);
+    timer.stop(CONVERT);
+    SPDLOG_DEBUG("Writing json from response outputs: {:.3f} ms", timer.elapsed<microseconds>(CONVERT) / 1000);
 
-    timer.stop("MakeJsonFromTensors");
-    SPDLOG_DEBUG("tensor_content to *_val container conversion: {:.3f} ms", timer.elapsed<microseconds>("convert") / 1000);
-    SPDLOG_DEBUG("MakeJsonFromTensors call: {:.3f} ms", timer.elapsed<microseconds>("MakeJsonFromTensors") / 1000);
+    return status;
+}
 
-    if (!tf_status.ok()) {
-        SPDLOG_ERROR("Creating json from tensors failed: {}", tf_status.error_message());
-        return StatusCode::REST_PROTO_TO_STRING_ERROR;
+namespace {
+// maps base64 alphabet to 6 bit values, other characters to 0xFF
+struct Base64DecodeTable {
+    uint8_t values[256];
+    constexpr Base64DecodeTable() :
+        values() {
+        for (int i = 0; i < 256; i++) {
+            values[i] = 0xFF;
+        }
+        const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; i++) {
+            values[static_cast<uint8_t>(alphabet[i])] = i;
+        }
     }
+};
 
-    return StatusCode::OK;
+constexpr Base64DecodeTable BASE64_DECODE_TABLE;
+
+// Decodes groups of 4 characters, returns false on characters outside of the alphabet
+bool decodeBase64QuadsScalar(const uint8_t* source, size_t count, uint8_t* destination) {
+    const uint8_t* table = BASE64_DECODE_TABLE.values;
+    for (size_t i = 0; i < count; i += 4) {
+        const uint32_t a = table[source[i]], b = table[source[i + 1]], c = table[source[i + 2]], d = table[source[i + 3]];
+        if ((a | b | c | d) & 0x80) {
+            return false;
+        }
+        const uint32_t triple = (a << 18) | (b << 12) | (c << 6) | d;
+        *destination++ = triple >> 16;
+        *destination++ = triple >> 8;
+        *destination++ = triple;
+    }
+    return true;
 }
 
-Status decodeBase64(std::string& bytes, std::string& decodedBytes) {
-    auto status = Status(absl::Base64Unescape(bytes, &decodedBytes) ? StatusCode::OK : StatusCode::REST_BASE64_DECODE_ERROR);
+// Decodes 32 characters into 24 bytes per iteration, destination needs 8 bytes of slack after last block.
+// Returns number of characters decoded, stops before the first block with characters outside of the alphabet
+__attribute__((target("avx2"))) size_t decodeBase64BlocksAvx2(const uint8_t* source, size_t count, uint8_t* destination) {
+    // classification of characters by nibbles, see W. Mula, D. Lemire "Faster Base64 Encoding and Decoding Using AVX2 Instructions"
+    const __m256i lutLo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lutHi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    const __m256i slash = _mm256_set1_epi8('/');
+    const __m256i packBytes = _mm256_set1_epi32(0x01400140);
+    const __m256i packWords = _mm256_set1_epi32(0x00011000);
+    const __m256i shuffleTriples = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i gatherLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), nibbleMask);
+        const __m256i loNibbles = _mm256_and_si256(input, nibbleMask);
+        const __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+        const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+        const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(input, slash), hiNibbles));
+        const __m256i values = _mm256_add_epi8(input, roll);
+        // merge 6 bit values into 24 bit triples stored in 32 bit words
+        const __m256i words = _mm256_madd_epi16(_mm256_maddubs_epi16(values, packBytes), packWords);
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, shuffleTriples), gatherLanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), packed);
+        destination += 24;
+    }
+    return i;
+}
+
+using decode_blocks_function_t = size_t (*)(const uint8_t*, size_t, uint8_t*);
+
+size_t decodeBase64BlocksNone(const uint8_t*, size_t, uint8_t*) {
+    return 0;
+}
+
+decode_blocks_function_t selectDecodeBase64Blocks() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return decodeBase64BlocksAvx2;
+    }
+    return decodeBase64BlocksNone;
+}
+
+const size_t BASE64_BLOCK_SLACK = 8;
+
+// Decodes canonical base64 without whitespace, returns false when input needs the generic decoder
+bool decodeBase64Fast(const char* bytes, size_t size, std::string& decodedBytes) {
+    static const decode_blocks_function_t decodeBlocks = selectDecodeBase64Blocks();
+    if (size % 4 == 0 && size > 0 && bytes[size - 1] == '=') {
+        size -= bytes[size - 2] == '=' ? 2 : 1;
+    }
+    const size_t tail = size % 4;
+    if (tail == 1) {
+        return false;
+    }
+    const size_t quadsSize = size - tail;
+    const size_t decodedSize = quadsSize / 4 * 3 + (tail ? tail - 1 : 0);
+    decodedBytes.resize(decodedSize + BASE64_BLOCK_SLACK);
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(bytes);
+    uint8_t* destination = reinterpret_cast<uint8_t*>(&decodedBytes[0]);
+
+    const size_t decoded = decodeBlocks(source, quadsSize, destination);
+    if (!decodeBase64QuadsScalar(source + decoded, quadsSize - decoded, destination + decoded / 4 * 3)) {
+        return false;
+    }
+    if (tail) {
+        const uint8_t* table = BASE64_DECODE_TABLE.values;
+        const uint32_t a = table[source[quadsSize]], b = table[source[quadsSize + 1]], c = tail == 3 ? table[source[quadsSize + 2]] : 0;
+        // non zero trailing bits are left to the generic decoder
+        if (((a | b | c) & 0x80) || (tail == 2 ? (b & 0x0F) : (c & 0x03))) {
+            return false;
+        }
+        const uint32_t triple = (a << 18) | (b << 12) | (c << 6);
+        uint8_t* end = destination + quadsSize / 4 * 3;
+        end[0] = triple >> 16;
+        if (tail == 3) {
+            end[1] = triple >> 8;
+        }
+    }
+    decodedBytes.resize(decodedSize);
+    return true;
+}
+}  // namespace
+
+Status decodeBase64(const char* bytes, size_t size, std::string& decodedBytes) {
+    if (decodeBase64Fast(bytes, size, decodedBytes)) {
+        return StatusCode::OK;
+    }
+    // whitespace, non canonical endings and invalid input are handled by absl
+    auto status = Status(absl::Base64Unescape(absl::string_view(bytes, size), &decodedBytes) ? StatusCode::OK : StatusCode::REST_BASE64_DECODE_ERROR);
     if (!status.ok()) {
         return status;
     }
     return StatusCode::OK;
 }
+
+Status decodeBase64(std::string& bytes, std::string& decodedBytes) {
+    return decodeBase64(bytes.data(), bytes.size(), decodedBytes);
+}
+
+Status parseMultipartBody(const std::string& contentType, std::string_view body, std::vector<std::string_view>& parts) {
+    const std::string parameter = "boundary=";
+    auto position = contentType.find(parameter);
+    if (position == std::string::npos) {
+        SPDLOG_DEBUG("Missing boundary in Content-Type: {}", contentType);
+        return StatusCode::REST_MALFORMED_REQUEST;
+    }
+    std::string_view boundary(contentType);
+    boundary.remove_prefix(position + parameter.size());
+    boundary = boundary.substr(0, boundary.find(';'));
+    while (!boundary.empty() && boundary.back() == ' ') {
+        boundary.remove_suffix(1);
+    }
+    if (boundary.size() >= 2 && boundary.front() == '"' && boundary.back() == '"') {
+        boundary = boundary.substr(1, boundary.size() - 2);
+    }
+    if (boundary.empty()) {
+        SPDLOG_DEBUG("Empty boundary in Content-Type: {}", contentType);
+        return StatusCode::REST_MALFORMED_REQUEST;
+    }
+    const std::string delimiter = "--" + std::string(boundary);
+    const std::string separator = "\r\n" + delimiter;
+    // preamble before the first delimiter is ignored
+    size_t offset = 0;
+    if (body.substr(0, delimiter.size()) != delimiter) {
+        offset = body.find(separator);
+        if (offset == std::string_view::npos) {
+            SPDLOG_DEBUG("Multipart body has no parts");
+            return StatusCode::REST_MALFORMED_REQUEST;
+        }
+        offset += 2;
+    }
+    offset += delimiter.size();
+    parts.clear();
+    while (body.substr(offset, 2) != "--") {
+        if (body.substr(offset, 2) != "\r\n") {
+            SPDLOG_DEBUG("Malformed multipart delimiter at offset: {}", offset);
+            return StatusCode::REST_MALFORMED_REQUEST;
+        }
+        offset += 2;
+        size_t contentStart = offset + 2;
+        if (body.substr(offset, 2) != "\r\n") {
+            contentStart = body.find("\r\n\r\n", offset);
+            if (contentStart == std::string_view::npos) {
+                SPDLOG_DEBUG("Malformed multipart part headers at offset: {}", offset);
+                return StatusCode::REST_MALFORMED_REQUEST;
+            }
+            contentStart += 4;
+        }
+        const size_t contentEnd = body.find(separator, contentStart);
+        if (contentEnd == std::string_view::npos) {
+            SPDLOG_DEBUG("Multipart part at offset: {} is not terminated", offset);
+            return StatusCode::REST_MALFORMED_REQUEST;
+        }
+        parts.push_back(body.substr(contentStart, contentEnd - contentStart));
+        offset = contentEnd + separator.size();
+    }
+    if (parts.empty()) {
+        SPDLOG_DEBUG("Multipart body has no parts");
+        return StatusCode::REST_MALFORMED_REQUEST;
+    }
+    return StatusCode::OK;
+}
 }  // namespace ovms
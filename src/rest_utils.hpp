@@ -16,6 +16,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
@@ -33,4 +35,20 @@ Status makeJsonFromPredictResponse(
 
 Status decodeBase64(std::string& bytes, std::string& decodedBytes);
 
+/**
+ * @brief Decodes base64 data directly into decodedBytes, with AVX2 when supported by CPU
+ */
+Status decodeBase64(const char* bytes, size_t size, std::string& decodedBytes);
+
+/**
+ * @brief Splits multipart request body into contents of its parts, with part headers skipped
+ *
+ * @param contentType Content-Type header value carrying boundary parameter
+ * @param body
+ * @param parts views into body
+ *
+ * @return REST_MALFORMED_REQUEST if boundary is missing or body has no parts
+ */
+Status parseMultipartBody(const std::string& contentType, std::string_view body, std::vector<std::string_view>& parts);
+
 }  // namespace ovms
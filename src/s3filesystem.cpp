@@ -25,11 +25,14 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "s3filesystem.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <aws/core/Aws.h>
@@ -41,6 +44,7 @@
 #include <aws/s3/model/ListObjectsRequest.h>
 
 #include "logging.hpp"
+#include "remote_files_cache.hpp"
 #include "stringutils.hpp"
 
 namespace ovms {
@@ -50,6 +54,9 @@ namespace fs = std::filesystem;
 
 const std::string S3FileSystem::S3_URL_PREFIX = "s3://";
 
+const uint32_t S3FileSystem::DEFAULT_DOWNLOAD_PART_SIZE_MB = 8;
+const uint32_t S3FileSystem::DEFAULT_DOWNLOAD_CONCURRENCY = 8;
+
 StatusCode S3FileSystem::parsePath(const std::string& path, std::string* bucket, std::string* object) {
     std::smatch sm;
 
@@ -85,6 +92,8 @@ StatusCode S3FileSystem::parsePath(const std::string& path, std::string* bucket,
 
 S3FileSystem::S3FileSystem(const Aws::SDKOptions& options, const std::string& s3_path) :
     options_(options),
+    download_part_size_(static_cast<uint64_t>(getPositiveEnvValue("S3_DOWNLOAD_PART_SIZE_MB", DEFAULT_DOWNLOAD_PART_SIZE_MB)) * 1024 * 1024),
+    download_concurrency_(getPositiveEnvValue("S3_DOWNLOAD_CONCURRENCY", DEFAULT_DOWNLOAD_CONCURRENCY)),
     s3_regex_(S3_URL_PREFIX + "([0-9a-zA-Z-.]+):([0-9]+)/([0-9a-z.-]+)(((/"
                               "[0-9a-zA-Z.-_]+)*)?)"),
     proxy_regex_("^(https?)://(([^:]{1,128}):([^@]{1,256})@)?([^:/]{1,255})(:([0-9]{1,5}))?/?") {
@@ -149,6 +158,9 @@ S3FileSystem::S3FileSystem(const Aws::SDKOptions& options, const std::string& s3
         }
     }
 
+    // Each concurrent ranged GET needs its own connection
+    config.maxConnections = std::max(config.maxConnections, static_cast<unsigned>(download_concurrency_));
+
     if (profile_name) {
         client_ = s3::S3Client(
             config,
@@ -374,13 +386,8 @@ StatusCode S3FileSystem::readTextFile(const std::string& path, std::string* cont
     if (get_object_outcome.IsSuccess()) {
         auto& object_result = get_object_outcome.GetResultWithOwnership().GetBody();
 
-        std::string data = "";
-        char c = 0;
-        while (object_result.get(c)) {
-            data += c;
-        }
-
-        *contents = data;
+        // objects can hold model weights, so they are read in bulk instead of by character
+        contents->assign(std::istreambuf_iterator<char>(object_result), std::istreambuf_iterator<char>());
     } else {
         SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}", path);
         return StatusCode::S3_FILE_INVALID;
@@ -455,60 +462,95 @@ StatusCode S3FileSystem::downloadFileFolder(const std::string& path, const std::
             }
         }
 
+        std::vector<std::pair<std::string, std::string>> objects;
         for (auto iter = files.begin(); iter != files.end(); ++iter) {
             if (std::any_of(acceptedFiles.begin(), acceptedFiles.end(), [&iter](const std::string& x) {
                     return iter->size() > 0 && endsWith(*iter, x);
                 })) {
-                std::string bucket, object;
-                status = parsePath(*iter, &bucket, &object);
-                if (status != StatusCode::OK) {
-                    return status;
-                }
+                std::string s3_removed_path = (*iter).substr(effective_path.size());
+                objects.emplace_back(*iter, joinPath({local_path, s3_removed_path}));
+            }
+        }
+        return downloadObjects(objects);
+    }
 
-                // Send a request for the objects metadata
-                s3::Model::GetObjectRequest object_request;
-                object_request.SetBucket(bucket.c_str());
-                object_request.SetKey(object.c_str());
-
-                auto get_object_outcome = client_.GetObject(object_request);
-                if (get_object_outcome.IsSuccess()) {
-                    auto& retrieved_file =
-                        get_object_outcome.GetResultWithOwnership().GetBody();
-                    std::string s3_removed_path = (*iter).substr(effective_path.size());
-                    std::string local_file_path = joinPath({local_path, s3_removed_path});
-                    std::ofstream output_file(local_file_path.c_str(), std::ios::binary);
-                    output_file << retrieved_file.rdbuf();
-                    output_file.close();
-                } else {
-                    SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}", *iter);
-                    return StatusCode::S3_FAILED_GET_OBJECT;
-                }
+    return downloadObjects({{effective_path, local_path}});
+}
+
+StatusCode S3FileSystem::downloadObjects(const std::vector<std::pair<std::string, std::string>>& objects) {
+    auto cache = RemoteFilesCache::getInstance();
+    std::vector<ObjectDownload> downloads;
+    std::vector<ObjectPart> parts;
+    downloads.reserve(objects.size());
+    for (const auto& [s3_path, local_file_path] : objects) {
+        ObjectDownload download;
+        auto status = parsePath(s3_path, &download.bucket, &download.object);
+        if (status != StatusCode::OK) {
+            return status;
+        }
+        download.localPath = local_file_path;
+
+        s3::Model::HeadObjectRequest head_request;
+        head_request.SetBucket(download.bucket.c_str());
+        head_request.SetKey(download.object.c_str());
+        auto head_object_outcome = client_.HeadObject(head_request);
+        if (!head_object_outcome.IsSuccess()) {
+            SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object metadata at {}", s3_path);
+            return StatusCode::S3_FAILED_GET_OBJECT;
+        }
+        uint64_t object_size = head_object_outcome.GetResult().GetContentLength();
+        if (cache) {
+            download.cacheKey = RemoteFilesCache::makeKey("s3", head_object_outcome.GetResult().GetETag().c_str(), object_size);
+            if (cache->fetch(download.cacheKey, local_file_path)) {
+                continue;
             }
         }
-    } else {
-        std::string bucket, object;
-        auto s = parsePath(effective_path, &bucket, &object);
-        if (s != StatusCode::OK) {
-            return s;
+
+        status = createLocalFile(local_file_path, object_size);
+        if (status != StatusCode::OK) {
+            return status;
         }
 
-        // Send a request for the objects metadata
-        s3::Model::GetObjectRequest object_request;
-        object_request.SetBucket(bucket.c_str());
-        object_request.SetKey(object.c_str());
-
-        auto get_object_outcome = client_.GetObject(object_request);
-        if (get_object_outcome.IsSuccess()) {
-            auto& retrieved_file = get_object_outcome.GetResultWithOwnership().GetBody();
-            std::ofstream output_file(local_path.c_str(), std::ios::binary);
-            output_file << retrieved_file.rdbuf();
-            output_file.close();
-        } else {
-            SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}", effective_path);
-            return StatusCode::S3_FAILED_GET_OBJECT;
+        for (uint64_t offset = 0; offset < object_size; offset += download_part_size_) {
+            parts.push_back({downloads.size(), offset, std::min(download_part_size_, object_size - offset)});
         }
+        downloads.push_back(std::move(download));
     }
 
+    // Parts of all objects share one queue, so the number of connections is bounded
+    // both for a single large file and for many small ones
+    auto status = runConcurrently(parts.size(), download_concurrency_, [this, &downloads, &parts](size_t i) {
+        return downloadObjectPart(downloads[parts[i].downloadIndex], parts[i]);
+    });
+    if (status == StatusCode::OK && cache) {
+        for (const auto& download : downloads) {
+            cache->store(download.cacheKey, download.localPath);
+        }
+    }
+    return status;
+}
+
+StatusCode S3FileSystem::downloadObjectPart(const ObjectDownload& download, const ObjectPart& part) {
+    s3::Model::GetObjectRequest object_request;
+    object_request.SetBucket(download.bucket.c_str());
+    object_request.SetKey(download.object.c_str());
+    object_request.SetRange(("bytes=" + std::to_string(part.offset) + "-" + std::to_string(part.offset + part.size - 1)).c_str());
+
+    auto get_object_outcome = client_.GetObject(object_request);
+    if (!get_object_outcome.IsSuccess()) {
+        SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}/{} range {}-{}: {}",
+            download.bucket, download.object, part.offset, part.offset + part.size - 1, get_object_outcome.GetError().GetMessage());
+        return StatusCode::S3_FAILED_GET_OBJECT;
+    }
+    auto& retrieved_file = get_object_outcome.GetResultWithOwnership().GetBody();
+    std::fstream output_file(download.localPath.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    output_file.seekp(part.offset);
+    output_file << retrieved_file.rdbuf();
+    output_file.close();
+    if (!output_file) {
+        SPDLOG_LOGGER_ERROR(s3_logger, "Failed to write local file: {}", download.localPath);
+        return StatusCode::S3_FAILED_GET_OBJECT;
+    }
     return StatusCode::OK;
 }
 
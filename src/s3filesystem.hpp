@@ -17,6 +17,7 @@
 
 #include <regex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <aws/core/Aws.h>
@@ -126,7 +127,40 @@ public:
 
     static const std::string S3_URL_PREFIX;
 
+    static const uint32_t DEFAULT_DOWNLOAD_PART_SIZE_MB;
+    static const uint32_t DEFAULT_DOWNLOAD_CONCURRENCY;
+
 private:
+    struct ObjectDownload {
+        std::string bucket;
+        std::string object;
+        std::string localPath;
+        std::string cacheKey;
+    };
+
+    struct ObjectPart {
+        size_t downloadIndex;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    /**
+     * @brief Download objects concurrently with ranged GET requests
+     * 
+     * @param objects pairs of s3 path and local file path
+     * @return StatusCode 
+     */
+    StatusCode downloadObjects(const std::vector<std::pair<std::string, std::string>>& objects);
+
+    /**
+     * @brief Download a byte range of an object into already allocated local file
+     * 
+     * @param download 
+     * @param part 
+     * @return StatusCode 
+     */
+    StatusCode downloadObjectPart(const ObjectDownload& download, const ObjectPart& part);
+
     /**
      * @brief 
      * 
@@ -148,6 +182,8 @@ private:
      * 
      */
     Aws::S3::S3Client client_;
+    uint64_t download_part_size_;
+    uint32_t download_concurrency_;
     std::regex s3_regex_;
     std::regex proxy_regex_;
 };
@@ -0,0 +1,116 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "saturation_tracker.hpp"
+
+#include <algorithm>
+
+namespace ovms {
+
+size_t SaturationTracker::getWaitBucket(uint64_t waitUs) {
+    if (waitUs < 4) {
+        return waitUs;
+    }
+    size_t exponent = 63 - __builtin_clzll(waitUs);
+    size_t bucket = 4 * (exponent - 1) + ((waitUs >> (exponent - 2)) & 3);
+    return std::min(bucket, WAIT_BUCKETS - 1);
+}
+
+uint64_t SaturationTracker::getWaitBucketUpperBound(size_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    const size_t exponent = bucket / 4 + 1;
+    const uint64_t subBucket = bucket % 4;
+    return ((5 + subBucket) << (exponent - 2)) - 1;
+}
+
+int64_t SaturationTracker::toSecond(clock_t::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+SaturationTracker::Slot& SaturationTracker::getSlot(clock_t::time_point now) {
+    const int64_t second = toSecond(now);
+    Slot& slot = slots[static_cast<size_t>(second) % (WINDOW_SECONDS + 1)];
+    int64_t slotSecond = slot.second.load(std::memory_order_acquire);
+    if (slotSecond != second && slot.second.compare_exchange_strong(slotSecond, second, std::memory_order_acq_rel)) {
+        slot.returned.store(0, std::memory_order_relaxed);
+        slot.busyUs.store(0, std::memory_order_relaxed);
+        for (auto& wait : slot.waits) {
+            wait.store(0, std::memory_order_relaxed);
+        }
+    }
+    return slot;
+}
+
+void SaturationTracker::recordAcquired(uint64_t waitUs, clock_t::time_point now) {
+    getSlot(now).waits[getWaitBucket(waitUs)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void SaturationTracker::recordReturned(uint64_t serviceUs, clock_t::time_point now) {
+    Slot& slot = getSlot(now);
+    slot.returned.fetch_add(1, std::memory_order_relaxed);
+    slot.busyUs.fetch_add(serviceUs, std::memory_order_relaxed);
+}
+
+Saturation SaturationTracker::getSaturation(int64_t inferRequests, clock_t::time_point now) const {
+    const int64_t currentSecond = toSecond(now);
+    uint64_t returned = 0;
+    uint64_t busyUs = 0;
+    uint64_t waits[WAIT_BUCKETS] = {};
+    uint64_t acquired = 0;
+    for (const auto& slot : slots) {
+        const int64_t second = slot.second.load(std::memory_order_acquire);
+        // current second is not complete yet
+        if (second >= currentSecond || second < currentSecond - static_cast<int64_t>(WINDOW_SECONDS)) {
+            continue;
+        }
+        returned += slot.returned.load(std::memory_order_relaxed);
+        busyUs += slot.busyUs.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < WAIT_BUCKETS; ++i) {
+            const uint64_t count = slot.waits[i].load(std::memory_order_relaxed);
+            waits[i] += count;
+            acquired += count;
+        }
+    }
+    Saturation saturation;
+    const double windowUs = WINDOW_SECONDS * 1'000'000.0;
+    if (inferRequests > 0) {
+        saturation.busyFraction = std::min(1.0, static_cast<double>(busyUs) / (windowUs * static_cast<double>(inferRequests)));
+    }
+    if (acquired > 0) {
+        // smallest bucket with at least 95% of waits at or below it
+        const uint64_t rank = (acquired * 95 + 99) / 100;
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < WAIT_BUCKETS; ++i) {
+            cumulative += waits[i];
+            if (cumulative >= rank) {
+                saturation.queueWaitP95Us = getWaitBucketUpperBound(i);
+                break;
+            }
+        }
+    }
+    saturation.throughput = static_cast<double>(returned) / WINDOW_SECONDS;
+    if (returned > 0) {
+        saturation.serviceTimeUs = static_cast<double>(busyUs) / static_cast<double>(returned);
+        if (saturation.serviceTimeUs > 0) {
+            saturation.capacity = static_cast<double>(std::max<int64_t>(inferRequests, 0)) * 1'000'000.0 / saturation.serviceTimeUs;
+        }
+        saturation.headroom = std::max(0.0, saturation.capacity - saturation.throughput);
+    }
+    return saturation;
+}
+
+}  // namespace ovms
@@ -0,0 +1,104 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ovms {
+
+/**
+ * @brief Saturation of model version infer requests over the last window
+ */
+struct Saturation {
+    /**
+     * @brief Fraction of time infer requests were held by requests, 1 when all of them were busy all the time
+     */
+    double busyFraction = 0;
+    /**
+     * @brief 95th percentile of time requests waited for idle infer request, in microseconds
+     */
+    uint64_t queueWaitP95Us = 0;
+    /**
+     * @brief Mean time infer request was held by request, in microseconds
+     */
+    double serviceTimeUs = 0;
+    /**
+     * @brief Requests per second completed
+     */
+    double throughput = 0;
+    /**
+     * @brief Requests per second infer requests can complete at measured service time, 0 until any request completes
+     */
+    double capacity = 0;
+    /**
+     * @brief Requests per second which can be added before all infer requests are busy
+     */
+    double headroom = 0;
+};
+
+/**
+ * @brief Measures saturation of infer requests over sliding window of last seconds
+ *
+ * Records go to per second slots with atomic counters, so hot path takes no lock. Slot of a new second is reset
+ * by the first thread recording in it, records racing with the reset may be lost, which is tolerated for this signal.
+ * Wait times are counted in logarithmic buckets with 4 sub-buckets per power of two, so percentile is rounded up by less than 25%.
+ */
+class SaturationTracker {
+public:
+    static constexpr size_t WINDOW_SECONDS = 10;
+    static constexpr size_t WAIT_BUCKETS = 4 * 40;
+
+    using clock_t = std::chrono::steady_clock;
+
+    /**
+     * @brief Counts infer request taken by request, waitUs is 0 for requests which got idle infer request right away
+     */
+    void recordAcquired(uint64_t waitUs, clock_t::time_point now = clock_t::now());
+
+    /**
+     * @brief Counts infer request returned after being held for serviceUs
+     */
+    void recordReturned(uint64_t serviceUs, clock_t::time_point now = clock_t::now());
+
+    /**
+     * @brief Computes saturation over last WINDOW_SECONDS complete seconds
+     *
+     * @param inferRequests number of infer requests of model version
+     */
+    Saturation getSaturation(int64_t inferRequests, clock_t::time_point now = clock_t::now()) const;
+
+    static size_t getWaitBucket(uint64_t waitUs);
+    static uint64_t getWaitBucketUpperBound(size_t bucket);
+
+private:
+    struct Slot {
+        std::atomic<int64_t> second{-1};
+        std::atomic<uint64_t> returned{0};
+        std::atomic<uint64_t> busyUs{0};
+        std::atomic<uint64_t> waits[WAIT_BUCKETS] = {};
+    };
+
+    // one more slot than the window, so the slot of current second is not the oldest one of the window
+    Slot slots[WINDOW_SECONDS + 1];
+
+    static int64_t toSecond(clock_t::time_point time);
+    Slot& getSlot(clock_t::time_point now);
+};
+
+}  // namespace ovms
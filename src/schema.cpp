@@ -77,10 +77,158 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 						"layout": {
 							"type": ["object", "string"]
 						},
+						"request_precision": {
+							"type": "object"
+						},
+						"preprocessing": {
+							"type": "object",
+							"additionalProperties": {
+								"type": "object",
+								"properties": {
+									"resize": {"type": "string"},
+									"color_format": {"type": "string"},
+									"mean_values": {"type": "array", "items": {"type": "number"}},
+									"scale_values": {"type": "array", "items": {"type": "number"}}
+								},
+								"additionalProperties": false
+							}
+						},
+						"postprocessing": {
+							"type": "object",
+							"additionalProperties": {
+								"type": "object",
+								"properties": {
+									"type": {"type": "string"},
+									"k": {"type": "integer", "minimum": 1},
+									"threshold": {"type": "number"},
+									"scale": {"type": "number"}
+								},
+								"required": ["type"],
+								"additionalProperties": false
+							}
+						},
 						"nireq": {
 							"type": "integer",
 							"minimum": 0
 						},
+						"max_queue_depth": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"max_queue_wait_ms": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"pipeline_reserved_nireq": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"min_nireq": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"nireq_cooldown_ms": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"shape_cache_size": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"shape_cache_prewarm": {
+							"type": "boolean"
+						},
+						"warmup_iterations": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"auto_tune": {
+							"type": "boolean"
+						},
+						"auto_tune_max_latency_ms": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"lazy_loading": {
+							"type": "boolean"
+						},
+						"critical": {
+							"type": "boolean"
+						},
+						"response_cache_size_mb": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"bind_input_blobs": {
+							"type": "boolean"
+						},
+						"remote_blobs": {
+							"type": "boolean"
+						},
+						"lock_memory": {
+							"type": "boolean"
+						},
+						"coalesce_requests": {
+							"type": "boolean"
+						},
+						"fallback": {
+							"type": "object",
+							"required": ["model_name"],
+							"properties": {
+								"model_name": {"type": "string"},
+								"model_version": {"type": "integer", "minimum": 1},
+								"queue_depth": {"type": "integer", "minimum": 1}
+							},
+							"additionalProperties": false
+						},
+						"layer_profiling_interval": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"version_poll_interval_seconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"batch_split_parallelism": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"scheduling_weight": {
+							"type": "integer",
+							"minimum": 1
+						},
+						"max_concurrent_inferences": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"batch_size_variants": {
+							"type": "array",
+							"items": {
+								"type": "integer",
+								"minimum": 1
+							}
+						},
+						"sequence_length_buckets": {
+							"type": "array",
+							"items": {
+								"type": "integer",
+								"minimum": 1
+							}
+						},
+						"latency_profile": {
+							"type": "object",
+							"properties": {
+								"nireq": {"type": "integer", "minimum": 1},
+								"batch_size": {"type": "integer", "minimum": 1},
+								"plugin_config": {"type": "object"},
+								"min_priority": {"type": "integer"}
+							},
+							"required": ["nireq"],
+							"additionalProperties": false
+						},
+						"attention_mask_input": {
+							"type": "string"
+						},
 						"target_device": {
 							"type": "string"
 						},
@@ -100,6 +248,30 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 							"type": "integer",
 							"minimum": 0
 						},
+						"max_bound_sequences": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"idle_sequence_timeout_seconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"idle_sequence_compression_seconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"max_batch_size": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"batch_timeout_us": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"batch_latency_target_us": {
+							"type": "integer",
+							"minimum": 0
+						},
 						"custom_loader_options": {
 							"type": "object",
                                                         "required": ["loader_name"],
@@ -161,8 +333,13 @@ const char* MODELS_CONFIG_SCHEMA = R"({
     			},
     			{
         			"properties": { "type": { "enum": ["DL model"] } },
-        			"not": { "required": ["library_name"] },
+        			"not": { "anyOf": [{ "required": ["library_name"] }, { "required": ["address"] }] },
 					"required": ["model_name"]
+    			},
+    			{
+        			"properties": { "type": { "enum": ["Remote model"] } },
+        			"not": { "required": ["library_name"] },
+					"required": ["model_name", "address"]
     			}
   			],
 			"properties": {
@@ -177,7 +354,7 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 				},
 				"type": {
 					"type": "string",
-					"enum": ["DL model", "custom"]
+					"enum": ["DL model", "custom", "Remote model"]
 				},
 				"version": {
 					"type": "integer",
@@ -206,6 +383,38 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 				},
 				"gather_from_node": {
 					"type": "string"
+				},
+				"batch_shards": {
+					"type": "boolean"
+				},
+				"roi_inputs": {
+					"type": "object",
+					"additionalProperties": { "type": "string" }
+				},
+				"bind_outputs": {
+					"type": "boolean"
+				},
+				"cache_size_mb": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"address": {
+					"type": "string"
+				},
+				"connections": {
+					"type": "integer",
+					"minimum": 1
+				},
+				"compression": {
+					"type": "string",
+					"enum": ["none", "deflate", "gzip"]
+				},
+				"timeout_ms": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"condition": {
+					"$ref": "#/definitions/source_node_names"
 				}
 			},
 			"additionalProperties": false
@@ -239,7 +448,11 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 			"type": "integer",
 			"minimum": 0,
 			"maximum": 10000
-        }
+        },
+				"max_in_flight_shards": {
+					"type": "integer",
+					"minimum": 0
+				}
 			},
 			"additionalProperties": false
 		},
@@ -252,6 +465,21 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 				},
 				"base_path": {
 					"type": "string"
+				},
+				"max_concurrency": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"worker_threads": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"cpu_affinity": {
+					"type": "array",
+					"items": {
+						"type": "integer",
+						"minimum": 0
+					}
 				}
 			},
 			"additionalProperties": false
@@ -15,12 +15,51 @@
 //*****************************************************************************
 #include "sequence.hpp"
 
+#include <cstring>
+#include <exception>
 #include <utility>
 
+#include "http_compression.hpp"
+
 using namespace InferenceEngine;
 
 namespace ovms {
 
+namespace {
+// Version of serialized memory state layout, states of sequences are exchanged only between servers of the same architecture
+const std::string MEMORY_STATE_MAGIC = "OVMSSEQ1";
+
+template <typename T>
+void appendValue(std::string& serialized, T value) {
+    serialized.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& serialized, const std::string& value) {
+    appendValue<uint64_t>(serialized, value.size());
+    serialized.append(value);
+}
+
+template <typename T>
+bool readValue(const std::string& serialized, size_t& offset, T& value) {
+    if (serialized.size() - offset < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, serialized.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+bool readString(const std::string& serialized, size_t& offset, std::string& value) {
+    uint64_t size;
+    if (!readValue(serialized, offset, size) || serialized.size() - offset < size) {
+        return false;
+    }
+    value.assign(serialized, offset, size);
+    offset += size;
+    return true;
+}
+}  // namespace
+
 const uint64_t Sequence::getId() const {
     return sequenceId;
 }
@@ -41,6 +80,12 @@ Status Sequence::updateMemoryState(model_memory_state_t& newState) {
     for (auto&& state : newState) {
         auto stateName = state.GetName();
         Blob::CPtr originalBlobPtr = state.GetState();
+        auto it = memoryState.find(stateName);
+        // Buffer saved after previous step is reused as long as state description does not change
+        if (it != memoryState.end() && it->second && it->second->getTensorDesc() == originalBlobPtr->getTensorDesc()) {
+            std::memcpy(as<MemoryBlob>(it->second)->wmap().as<void*>(), (const void*)as<MemoryBlob>(originalBlobPtr)->rmap(), originalBlobPtr->byteSize());
+            continue;
+        }
         Blob::Ptr copyBlobPtr;
         auto status = blobClone<InferenceEngine::Blob::CPtr>(copyBlobPtr, originalBlobPtr);
         if (!status.ok()) {
@@ -48,10 +93,194 @@ Status Sequence::updateMemoryState(model_memory_state_t& newState) {
         }
         memoryState[stateName] = copyBlobPtr;
     }
+    updateMemoryStateBytes();
     setIdle(false);
     return StatusCode::OK;
 }
 
+Status Sequence::updateMemoryState(const std::string& stateName, const Blob::CPtr& batchedState, size_t batchIndex) {
+    const auto& batchedDesc = batchedState->getTensorDesc();
+    auto dims = batchedDesc.getDims();
+    if (dims.empty() || batchIndex >= dims[0]) {
+        return StatusCode::INTERNAL_ERROR;
+    }
+    const size_t sampleByteSize = batchedState->byteSize() / dims[0];
+    dims[0] = 1;
+    Blob::Ptr& blob = memoryState[stateName];
+    if (!blob || blob->getTensorDesc().getDims() != dims || blob->getTensorDesc().getPrecision() != batchedDesc.getPrecision()) {
+        auto status = createSharedBlob(blob, TensorDesc(batchedDesc.getPrecision(), dims, batchedDesc.getLayout()));
+        if (!status.ok()) {
+            memoryState.erase(stateName);
+            return status;
+        }
+    }
+    std::memcpy(as<MemoryBlob>(blob)->wmap().as<char*>(), as<MemoryBlob>(batchedState)->rmap().as<const char*>() + batchIndex * sampleByteSize, sampleByteSize);
+    updateMemoryStateBytes();
+    setIdle(false);
+    return StatusCode::OK;
+}
+
+Status Sequence::compressMemoryState() {
+    for (auto& [stateName, blob] : memoryState) {
+        auto memoryBlob = as<MemoryBlob>(blob);
+        auto lockedMemory = memoryBlob->rmap();
+        const std::string stateData(lockedMemory.as<const char*>(), blob->byteSize());
+        CompressedMemoryState& compressedState = compressedMemoryState[stateName];
+        compressedState.tensorDesc = blob->getTensorDesc();
+        // Fastest level, states are compressed in the background and restored on request path
+        auto status = compress(ContentEncoding::DEFLATE, 1, stateData, compressedState.data);
+        if (!status.ok()) {
+            compressedMemoryState.clear();
+            return status;
+        }
+    }
+    memoryState.clear();
+    updateMemoryStateBytes();
+    return StatusCode::OK;
+}
+
+Status Sequence::restoreMemoryState() {
+    for (auto& [stateName, compressedState] : compressedMemoryState) {
+        Blob::Ptr& blob = memoryState[stateName];
+        auto status = createSharedBlob(blob, compressedState.tensorDesc);
+        if (!status.ok()) {
+            memoryState.erase(stateName);
+            return status;
+        }
+        // Imported states are not trusted, so data is not decompressed beyond the size of the state
+        std::string stateData;
+        status = decompress(ContentEncoding::DEFLATE, compressedState.data, stateData, blob->byteSize());
+        if (!status.ok()) {
+            SPDLOG_ERROR("Failed to restore compressed state {} of sequence {}", stateName, sequenceId);
+            memoryState.erase(stateName);
+            return StatusCode::INTERNAL_ERROR;
+        }
+        if (stateData.size() != blob->byteSize()) {
+            SPDLOG_ERROR("Restored state {} of sequence {} has {} bytes, expected {}", stateName, sequenceId, stateData.size(), blob->byteSize());
+            memoryState.erase(stateName);
+            return StatusCode::INTERNAL_ERROR;
+        }
+        std::memcpy(as<MemoryBlob>(blob)->wmap().as<char*>(), stateData.data(), stateData.size());
+    }
+    compressedMemoryState.clear();
+    updateMemoryStateBytes();
+    return StatusCode::OK;
+}
+
+bool Sequence::isMemoryStateCompressed() const {
+    return !compressedMemoryState.empty();
+}
+
+void Sequence::updateMemoryStateBytes() {
+    uint64_t bytes = 0;
+    for (const auto& [stateName, blob] : memoryState) {
+        bytes += blob->byteSize();
+    }
+    for (const auto& [stateName, compressedState] : compressedMemoryState) {
+        bytes += compressedState.data.size();
+    }
+    memoryStateBytes.store(bytes, std::memory_order_relaxed);
+}
+
+uint64_t Sequence::getMemoryStateBytes() const {
+    return memoryStateBytes.load(std::memory_order_relaxed);
+}
+
+Status Sequence::exportMemoryState(std::string& serialized) const {
+    serialized = MEMORY_STATE_MAGIC;
+    const bool compressed = isMemoryStateCompressed();
+    appendValue<uint64_t>(serialized, compressed ? compressedMemoryState.size() : memoryState.size());
+    auto appendState = [&serialized](const std::string& stateName, const TensorDesc& tensorDesc, const std::string& data) {
+        appendString(serialized, stateName);
+        appendValue<uint32_t>(serialized, tensorDesc.getPrecision());
+        appendValue<uint32_t>(serialized, tensorDesc.getLayout());
+        appendValue<uint64_t>(serialized, tensorDesc.getDims().size());
+        for (auto dim : tensorDesc.getDims()) {
+            appendValue<uint64_t>(serialized, dim);
+        }
+        appendString(serialized, data);
+    };
+    if (compressed) {
+        for (const auto& [stateName, compressedState] : compressedMemoryState) {
+            appendState(stateName, compressedState.tensorDesc, compressedState.data);
+        }
+        return StatusCode::OK;
+    }
+    for (const auto& [stateName, blob] : memoryState) {
+        auto lockedMemory = as<MemoryBlob>(blob)->rmap();
+        const std::string stateData(lockedMemory.as<const char*>(), blob->byteSize());
+        std::string data;
+        auto status = compress(ContentEncoding::DEFLATE, 1, stateData, data);
+        if (!status.ok()) {
+            return status;
+        }
+        appendState(stateName, blob->getTensorDesc(), data);
+    }
+    return StatusCode::OK;
+}
+
+Status Sequence::importMemoryState(const std::string& serialized) {
+    sequence_compressed_state_t importedState;
+    size_t offset = MEMORY_STATE_MAGIC.size();
+    uint64_t statesCount;
+    if (serialized.compare(0, offset, MEMORY_STATE_MAGIC) != 0 || !readValue(serialized, offset, statesCount) || statesCount == 0) {
+        return StatusCode::SEQUENCE_STATE_INVALID;
+    }
+    for (uint64_t i = 0; i < statesCount; ++i) {
+        std::string stateName;
+        uint32_t precision;
+        uint32_t layout;
+        uint64_t dimsCount;
+        if (!readString(serialized, offset, stateName) || !readValue(serialized, offset, precision) ||
+            !readValue(serialized, offset, layout) || !readValue(serialized, offset, dimsCount) ||
+            dimsCount > (serialized.size() - offset) / sizeof(uint64_t)) {
+            return StatusCode::SEQUENCE_STATE_INVALID;
+        }
+        SizeVector dims(dimsCount);
+        for (auto& dim : dims) {
+            uint64_t value;
+            readValue(serialized, offset, value);
+            dim = value;
+        }
+        CompressedMemoryState& compressedState = importedState[stateName];
+        if (!readString(serialized, offset, compressedState.data)) {
+            return StatusCode::SEQUENCE_STATE_INVALID;
+        }
+        size_t byteSize = 0;
+        try {
+            compressedState.tensorDesc = TensorDesc(Precision(static_cast<Precision::ePrecision>(precision)), dims, static_cast<Layout>(layout));
+            byteSize = compressedState.tensorDesc.getPrecision().size();
+        } catch (const std::exception& e) {
+            SPDLOG_DEBUG("Invalid description of imported state {} of sequence {}: {}", stateName, sequenceId, e.what());
+            return StatusCode::SEQUENCE_STATE_INVALID;
+        }
+        // Deflate does not compress better than about 1:1032, larger states are not allocated
+        const size_t maxByteSize = (compressedState.data.size() + 1) * 1032;
+        for (auto dim : dims) {
+            if (dim != 0 && byteSize > maxByteSize / dim) {
+                return StatusCode::SEQUENCE_STATE_INVALID;
+            }
+            byteSize *= dim;
+        }
+        if (byteSize == 0 || byteSize > maxByteSize) {
+            return StatusCode::SEQUENCE_STATE_INVALID;
+        }
+    }
+    if (offset != serialized.size()) {
+        return StatusCode::SEQUENCE_STATE_INVALID;
+    }
+    memoryState.clear();
+    compressedMemoryState = std::move(importedState);
+    auto status = restoreMemoryState();
+    if (!status.ok()) {
+        memoryState.clear();
+        compressedMemoryState.clear();
+        updateMemoryStateBytes();
+        return StatusCode::SEQUENCE_STATE_INVALID;
+    }
+    return StatusCode::OK;
+}
+
 std::mutex& Sequence::getMutex() {
     return mutex;
 }
@@ -64,4 +293,44 @@ void Sequence::setTerminated() {
     this->terminated = true;
 }
 
+int Sequence::getBoundStreamId() const {
+    return boundStreamId;
+}
+
+void Sequence::setBoundStreamId(int streamId) {
+    this->boundStreamId = streamId;
+}
+
+bool Sequence::isStreamed() const {
+    return streamed;
+}
+
+void Sequence::setStreamed() {
+    this->streamed = true;
+}
+
+uint64_t Sequence::getLastActivityTick() const {
+    return lastActivityTick;
+}
+
+void Sequence::setLastActivityTick(uint64_t tick) {
+    this->lastActivityTick = tick;
+}
+
+uint64_t Sequence::getExpiryDeadline() const {
+    return expiryDeadline;
+}
+
+void Sequence::setExpiryDeadline(uint64_t deadline) {
+    this->expiryDeadline = deadline;
+}
+
+uint64_t Sequence::getCompressionDeadline() const {
+    return compressionDeadline;
+}
+
+void Sequence::setCompressionDeadline(uint64_t deadline) {
+    this->compressionDeadline = deadline;
+}
+
 }  // namespace ovms
@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -32,13 +33,29 @@ namespace ovms {
 using sequence_memory_state_t = std::unordered_map<std::string, InferenceEngine::Blob::Ptr>;
 using model_memory_state_t = std::vector<InferenceEngine::VariableState>;
 
+// Memory state of idle sequence kept compressed until its next request
+struct CompressedMemoryState {
+    InferenceEngine::TensorDesc tensorDesc;
+    std::string data;
+};
+using sequence_compressed_state_t = std::unordered_map<std::string, CompressedMemoryState>;
+
 class Sequence {
 private:
     uint64_t sequenceId;
     sequence_memory_state_t memoryState;
+    sequence_compressed_state_t compressedMemoryState;
     std::mutex mutex;
     bool terminated;
     bool idle;
+    int boundStreamId = -1;
+    bool streamed = false;
+    uint64_t lastActivityTick = 0;
+    uint64_t expiryDeadline = 0;
+    uint64_t compressionDeadline = 0;
+    std::atomic<uint64_t> memoryStateBytes{0};
+
+    void updateMemoryStateBytes();
 
 public:
     Sequence(uint64_t sequenceId) :
@@ -50,10 +67,44 @@ public:
     const bool isIdle() const;
     void setIdle(bool idle = true);
     // In case updateMemoryState returns non-OK status code the sequence should be dropped
+    // Buffers of previous step are overwritten, new ones are allocated only when state description changes
     Status updateMemoryState(model_memory_state_t& newState);
+    // Saves slice of state batched with states of other sequences, state of the sequence has batch size 1
+    Status updateMemoryState(const std::string& stateName, const InferenceEngine::Blob::CPtr& batchedState, size_t batchIndex);
+    // Releases buffers of memory state and keeps their compressed copies, requires sequence lock
+    Status compressMemoryState();
+    // Restores memory state compressed by compressMemoryState, requires sequence lock
+    Status restoreMemoryState();
+    bool isMemoryStateCompressed() const;
+    // Memory held by memory state, compressed or not, in bytes; can be read without sequence lock
+    uint64_t getMemoryStateBytes() const;
+    // Serializes memory state, compressed or not, into blob accepted by importMemoryState, requires sequence lock
+    Status exportMemoryState(std::string& serialized) const;
+    // Replaces memory state with one serialized by exportMemoryState, requires sequence lock
+    Status importMemoryState(const std::string& serialized);
     std::mutex& getMutex();
     bool isTerminated() const;
     void setTerminated();
+    // Stream whose infer request keeps state of the sequence between steps, -1 when sequence is not bound
+    // Set under sequence manager lock on sequence creation
+    int getBoundStreamId() const;
+    void setBoundStreamId(int streamId);
+    // Sequence owned by streaming call is hidden from other requests and from idle sequence cleanup
+    // Set under sequence manager lock on sequence creation
+    bool isStreamed() const;
+    void setStreamed();
+    // Tick of sequence manager expiry wheel when the sequence received last request
+    // Set under sequence manager lock
+    uint64_t getLastActivityTick() const;
+    void setLastActivityTick(uint64_t tick);
+    // Deadline of the entry scheduled for the sequence in expiry wheel, other entries of its id are stale
+    // Set under sequence manager lock
+    uint64_t getExpiryDeadline() const;
+    void setExpiryDeadline(uint64_t deadline);
+    // Deadline of the entry scheduled for the sequence in compression wheel, 0 when no entry is scheduled
+    // Set under sequence manager lock
+    uint64_t getCompressionDeadline() const;
+    void setCompressionDeadline(uint64_t deadline);
 };
 
 }  // namespace ovms
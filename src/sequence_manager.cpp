@@ -16,23 +16,30 @@
 
 #include "sequence_manager.hpp"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "logging.hpp"
+#include "usdt.hpp"
 
 namespace ovms {
 
 uint64_t SequenceManager::getUniqueSequenceId() {
     SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "No sequence id has been provided on SEQUENCE_START. Seeking unique sequence id...");
-    bool uniqueIdFound = false;
-    while (!uniqueIdFound) {
-        if (sequenceExists(this->sequenceIdCounter) || this->sequenceIdCounter == 0)
-            this->sequenceIdCounter++;
-        else
-            uniqueIdFound = true;
+    uint64_t sequenceId = this->sequenceIdCounter.load();
+    while (true) {
+        if (sequenceId != 0) {
+            std::lock_guard<std::mutex> shardLock(getMutex(sequenceId));
+            if (!sequenceExists(sequenceId)) {
+                break;
+            }
+        }
+        sequenceId++;
     }
-    SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Found unique sequence id: {}", this->sequenceIdCounter);
-    return this->sequenceIdCounter;
+    this->sequenceIdCounter.store(sequenceId);
+    SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Found unique sequence id: {}", sequenceId);
+    return sequenceId;
 }
 
 const uint32_t SequenceManager::getMaxSequenceNumber() const {
@@ -43,37 +50,184 @@ void SequenceManager::setMaxSequenceNumber(uint32_t maxSequenceNumber) {
     this->maxSequenceNumber = maxSequenceNumber;
 }
 
-std::mutex& SequenceManager::getMutex() {
-    return mutex;
+std::mutex& SequenceManager::getMutex(const uint64_t sequenceId) {
+    return getShard(sequenceId).mutex;
+}
+
+std::unique_lock<std::mutex> SequenceManager::lockShard(const uint64_t sequenceId) {
+    auto& shard = getShard(sequenceId);
+    std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        // clock is read only when the lock is contended
+        const auto waitStart = std::chrono::steady_clock::now();
+        lock.lock();
+        shard.lockContentions.fetch_add(1, std::memory_order_relaxed);
+        const auto waitUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - waitStart).count();
+        shard.lockWaitUs.fetch_add(static_cast<uint64_t>(waitUs), std::memory_order_relaxed);
+    }
+    shard.lockAcquisitions.fetch_add(1, std::memory_order_relaxed);
+    return lock;
+}
+
+SequenceManager::ShardLockStats SequenceManager::getShardLockStats() const {
+    ShardLockStats stats;
+    for (const auto& shard : shards) {
+        stats.acquisitions += shard.lockAcquisitions.load(std::memory_order_relaxed);
+        stats.contentions += shard.lockContentions.load(std::memory_order_relaxed);
+        stats.waitUs += shard.lockWaitUs.load(std::memory_order_relaxed);
+    }
+    return stats;
 }
 
 bool SequenceManager::sequenceExists(const uint64_t sequenceId) const {
+    const auto& sequences = getShard(sequenceId).sequences;
     return sequences.find(sequenceId) != sequences.end();
 }
 
 Status SequenceManager::removeIdleSequences() {
-    std::unique_lock<std::mutex> sequenceManagerLock(mutex);
-    for (auto it = sequences.begin(); it != sequences.end();) {
+    for (auto& shard : shards) {
+        std::unique_lock<std::mutex> shardLock(shard.mutex);
+        for (auto it = shard.sequences.begin(); it != shard.sequences.end();) {
+            Sequence& sequence = it->second;
+            // Non blocking try to get mutex
+            std::unique_lock<std::mutex> sequenceLock(sequence.getMutex(), std::try_to_lock);
+            if (!sequence.isTerminated() && !sequence.isStreamed() && sequenceLock.owns_lock()) {
+                sequenceLock.unlock();
+                // We hold shard lock before lock and after unlock so no other thread even attempts accessing that sequence at that moment
+                if (sequence.isIdle()) {
+                    SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "[Idle sequence cleanup] Removing sequence with id: {} on model {}, version: {}", sequence.getId(), modelName, modelVersion);
+                    it = shard.sequences.erase(it);
+                    sequencesCount--;
+                    continue;
+                } else {
+                    sequence.setIdle();
+                }
+            }
+            ++it;
+        }
+    }
+
+    return StatusCode::OK;
+}
+
+uint64_t SequenceManager::scheduleInWheel(TimingWheel& wheel, uint64_t sequenceId, uint64_t deadline) {
+    std::lock_guard<std::mutex> wheelsLock(wheelsMutex);
+    // Wheel moves past deadlines which are already due, entry is identified by deadline it gets in the wheel
+    deadline = std::max(deadline, wheel.getCurrentTick() + 1);
+    wheel.schedule(sequenceId, deadline);
+    return deadline;
+}
+
+void SequenceManager::scheduleExpiry(Sequence& sequence, uint64_t deadline) {
+    sequence.setExpiryDeadline(scheduleInWheel(expiryWheel, sequence.getId(), deadline));
+}
+
+void SequenceManager::scheduleCompression(Sequence& sequence, uint64_t deadline) {
+    sequence.setCompressionDeadline(scheduleInWheel(compressionWheel, sequence.getId(), deadline));
+}
+
+std::vector<TimingWheel::Entry> SequenceManager::advanceWheel(TimingWheel& wheel, uint64_t tick) {
+    std::vector<TimingWheel::Entry> due;
+    std::lock_guard<std::mutex> wheelsLock(wheelsMutex);
+    wheel.advance(tick, due);
+    return due;
+}
+
+uint64_t SequenceManager::getElapsedSeconds() const {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - creationTime).count();
+}
+
+Status SequenceManager::removeExpiredSequences(uint64_t tick) {
+    if (idleSequenceTimeoutSeconds == 0)
+        return StatusCode::OK;
+    currentTick.store(tick);
+    for (const auto& entry : advanceWheel(expiryWheel, tick)) {
+        std::unique_lock<std::mutex> shardLock = lockShard(entry.id);
+        auto& sequences = getShard(entry.id).sequences;
+        auto it = sequences.find(entry.id);
+        // Sequences ended by requests and sequences replaced by ones with the same id leave their entries behind
+        if (it == sequences.end() || it->second.getExpiryDeadline() != entry.deadline)
+            continue;
         Sequence& sequence = it->second;
-        // Non blocking try to get mutex
+        if (sequence.isTerminated() || sequence.isStreamed())
+            continue;
         std::unique_lock<std::mutex> sequenceLock(sequence.getMutex(), std::try_to_lock);
-        if (!sequence.isTerminated() && sequenceLock.owns_lock()) {
-            sequenceLock.unlock();
-            // We hold sequence manager lock before lock and after unlock so no other thread even attempts accessing that sequence at that moment
-            if (sequence.isIdle()) {
-                SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "[Idle sequence cleanup] Removing sequence with id: {} on model {}, version: {}", sequence.getId(), modelName, modelVersion);
-                it = sequences.erase(it);
-                continue;
-            } else {
-                sequence.setIdle();
-            }
+        if (!sequenceLock.owns_lock()) {
+            scheduleExpiry(sequence, tick + idleSequenceTimeoutSeconds);
+            continue;
         }
-        ++it;
+        sequenceLock.unlock();
+        const uint64_t deadline = sequence.getLastActivityTick() + idleSequenceTimeoutSeconds;
+        if (deadline > tick) {
+            scheduleExpiry(sequence, deadline);
+            continue;
+        }
+        SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "[Idle sequence cleanup] Removing expired sequence with id: {} on model {}, version: {}", sequence.getId(), modelName, modelVersion);
+        sequences.erase(it);
+        sequencesCount--;
+        OVMS_TRACEPOINT(sequence_terminate, modelName.c_str(), modelVersion, entry.id);
     }
+    return StatusCode::OK;
+}
 
+Status SequenceManager::removeExpiredSequences() {
+    return removeExpiredSequences(getElapsedSeconds());
+}
+
+Status SequenceManager::compressIdleSequences(uint64_t tick) {
+    if (idleSequenceCompressionSeconds == 0)
+        return StatusCode::OK;
+    currentTick.store(tick);
+    for (const auto& entry : advanceWheel(compressionWheel, tick)) {
+        std::unique_lock<std::mutex> shardLock = lockShard(entry.id);
+        auto& sequences = getShard(entry.id).sequences;
+        auto it = sequences.find(entry.id);
+        if (it == sequences.end() || it->second.getCompressionDeadline() != entry.deadline)
+            continue;
+        Sequence& sequence = it->second;
+        // State of bound sequence stays in its infer request
+        if (sequence.isTerminated() || sequence.isStreamed() || sequence.getBoundStreamId() >= 0)
+            continue;
+        std::unique_lock<std::mutex> sequenceLock(sequence.getMutex(), std::try_to_lock);
+        if (!sequenceLock.owns_lock()) {
+            scheduleCompression(sequence, tick + idleSequenceCompressionSeconds);
+            continue;
+        }
+        const uint64_t deadline = sequence.getLastActivityTick() + idleSequenceCompressionSeconds;
+        if (deadline > tick) {
+            scheduleCompression(sequence, deadline);
+            continue;
+        }
+        // Next request schedules compression again, sequence cannot be removed while its lock is held
+        sequence.setCompressionDeadline(0);
+        shardLock.unlock();
+        if (sequence.isMemoryStateCompressed())
+            continue;
+        auto status = sequence.compressMemoryState();
+        if (!status.ok()) {
+            SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Failed to compress state of sequence with ID: {}", modelName, modelVersion, entry.id);
+            continue;
+        }
+        SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Compressed state of idle sequence with ID: {}", modelName, modelVersion, entry.id);
+    }
     return StatusCode::OK;
 }
 
+Status SequenceManager::compressIdleSequences() {
+    return compressIdleSequences(getElapsedSeconds());
+}
+
+uint64_t SequenceManager::getMemoryStateBytes() {
+    uint64_t bytes = 0;
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [sequenceId, sequence] : shard.sequences) {
+            bytes += sequence.getMemoryStateBytes();
+        }
+    }
+    return bytes;
+}
+
 Status SequenceManager::hasSequence(const uint64_t sequenceId) {
     if (!sequenceExists(sequenceId))
         return StatusCode::SEQUENCE_MISSING;
@@ -81,36 +235,43 @@ Status SequenceManager::hasSequence(const uint64_t sequenceId) {
     if (getSequence(sequenceId).isTerminated())
         return StatusCode::SEQUENCE_MISSING;
 
+    // steps of streamed sequence come only from its stream
+    if (getSequence(sequenceId).isStreamed())
+        return StatusCode::SEQUENCE_MISSING;
+
     return StatusCode::OK;
 }
 
 Status SequenceManager::createSequence(SequenceProcessingSpec& sequenceProcessingSpec) {
-    if (sequences.size() >= this->maxSequenceNumber) {
-        SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Max sequence number has been reached. Could not create new sequence.", modelName, modelVersion);
-        return StatusCode::MAX_SEQUENCE_NUMBER_REACHED;
-    }
-
     uint64_t sequenceId = sequenceProcessingSpec.getSequenceId();
-
     if (sequenceId == 0) {
-        uint64_t uniqueSequenceId = getUniqueSequenceId();
-        SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Adding new sequence with ID: {}", modelName, modelVersion, uniqueSequenceId);
-        sequences.emplace(uniqueSequenceId, uniqueSequenceId);
-        sequenceProcessingSpec.setSequenceId(uniqueSequenceId);
-        return StatusCode::OK;
-    }
-
-    if (sequenceExists(sequenceId)) {
+        sequenceId = getUniqueSequenceId();
+        sequenceProcessingSpec.setSequenceId(sequenceId);
+    } else if (sequenceExists(sequenceId)) {
         if (getSequence(sequenceId).isTerminated()) {
             SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Sequence with provided ID is currently being removed", modelName, modelVersion);
             return StatusCode::SEQUENCE_TERMINATED;
         }
         SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Sequence with provided ID already exists", modelName, modelVersion);
         return StatusCode::SEQUENCE_ALREADY_EXISTS;
-    } else {
-        SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Adding new sequence with ID: {}", modelName, modelVersion, sequenceId);
-        sequences.emplace(sequenceId, sequenceId);
     }
+
+    // sequences of other shards are created concurrently, so place is reserved before adding sequence
+    if (sequencesCount.fetch_add(1) >= this->maxSequenceNumber) {
+        sequencesCount--;
+        SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Max sequence number has been reached. Could not create new sequence.", modelName, modelVersion);
+        return StatusCode::MAX_SEQUENCE_NUMBER_REACHED;
+    }
+    SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Adding new sequence with ID: {}", modelName, modelVersion, sequenceId);
+    auto& sequence = getShard(sequenceId).sequences.emplace(sequenceId, sequenceId).first->second;
+    sequence.setLastActivityTick(currentTick.load());
+    if (idleSequenceTimeoutSeconds > 0) {
+        scheduleExpiry(sequence, currentTick.load() + idleSequenceTimeoutSeconds);
+    }
+    if (idleSequenceCompressionSeconds > 0) {
+        scheduleCompression(sequence, currentTick.load() + idleSequenceCompressionSeconds);
+    }
+    OVMS_TRACEPOINT(sequence_create, modelName.c_str(), modelVersion, sequenceId);
     return StatusCode::OK;
 }
 
@@ -124,14 +285,17 @@ Status SequenceManager::terminateSequence(const uint64_t sequenceId) {
 }
 
 Sequence& SequenceManager::getSequence(const uint64_t sequenceId) {
-    return sequences.at(sequenceId);
+    return getShard(sequenceId).sequences.at(sequenceId);
 }
 
 Status SequenceManager::removeSequence(const uint64_t sequenceId) {
+    auto& sequences = getShard(sequenceId).sequences;
     auto it = sequences.find(sequenceId);
     if (it != sequences.end()) {
         SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} versions {} Removing sequence with ID: {}", modelName, modelVersion, sequenceId);
         sequences.erase(it);
+        sequencesCount--;
+        OVMS_TRACEPOINT(sequence_terminate, modelName.c_str(), modelVersion, sequenceId);
     } else {
         SPDLOG_LOGGER_DEBUG(sequence_manager_logger, "Model {} version {} Sequence with provided ID does not exists", modelName, modelVersion);
         return StatusCode::SEQUENCE_MISSING;
@@ -140,18 +304,43 @@ Status SequenceManager::removeSequence(const uint64_t sequenceId) {
 }
 
 Status SequenceManager::processRequestedSpec(SequenceProcessingSpec& sequenceProcessingSpec) {
+    std::unique_lock<std::mutex> sequencesLock;
+    return processRequestedSpec(sequenceProcessingSpec, sequencesLock);
+}
+
+Status SequenceManager::processRequestedSpec(SequenceProcessingSpec& sequenceProcessingSpec, std::unique_lock<std::mutex>& sequencesLock) {
     const uint32_t sequenceControlInput = sequenceProcessingSpec.getSequenceControlInput();
     const uint64_t sequenceId = sequenceProcessingSpec.getSequenceId();
-    Status status;
 
+    if (sequenceControlInput == SEQUENCE_START && sequenceId == 0) {
+        // generated id can be taken by request with the same id before its shard is locked, then it is generated again
+        while (true) {
+            const uint64_t uniqueSequenceId = getUniqueSequenceId();
+            sequencesLock = lockShard(uniqueSequenceId);
+            if (!sequenceExists(uniqueSequenceId)) {
+                sequenceProcessingSpec.setSequenceId(uniqueSequenceId);
+                return createSequence(sequenceProcessingSpec);
+            }
+            sequencesLock.unlock();
+        }
+    }
+
+    sequencesLock = lockShard(sequenceId);
     if (sequenceControlInput == SEQUENCE_START) {
-        status = createSequence(sequenceProcessingSpec);
+        return createSequence(sequenceProcessingSpec);
     } else if (sequenceControlInput == NO_CONTROL_INPUT) {
-        status = hasSequence(sequenceId);
+        auto status = hasSequence(sequenceId);
+        if (!status.ok())
+            return status;
+        Sequence& sequence = getSequence(sequenceId);
+        sequence.setLastActivityTick(currentTick.load());
+        if (idleSequenceCompressionSeconds > 0 && sequence.getCompressionDeadline() == 0) {
+            scheduleCompression(sequence, currentTick.load() + idleSequenceCompressionSeconds);
+        }
+        return status;
     } else {  // sequenceControlInput == SEQUENCE_END
-        status = terminateSequence(sequenceId);
+        return terminateSequence(sequenceId);
     }
-    return status;
 }
 
 }  // namespace ovms
@@ -16,15 +16,20 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "modelversion.hpp"
 #include "sequence.hpp"
 #include "sequence_processing_spec.hpp"
 #include "status.hpp"
+#include "timing_wheel.hpp"
 
 namespace ovms {
 
@@ -32,18 +37,87 @@ const uint32_t NO_CONTROL_INPUT = 0;
 const uint32_t SEQUENCE_START = 1;
 const uint32_t SEQUENCE_END = 2;
 
+/**
+ * @brief Manages sequences of stateful model version
+ *
+ * Sequences are split into shards by sequence id, each shard with its own mutex,
+ * so requests of sequences from different shards do not contend.
+ * Methods accessing sequence by id require lock of its shard obtained via getMutex(sequenceId),
+ * unless stated otherwise.
+ */
 class SequenceManager {
+public:
+    static const size_t SHARDS_COUNT = 64;
+
+    /**
+     * @brief Counters of shard locks taken by lockShard, lock is contended when another thread holds it
+     */
+    struct ShardLockStats {
+        uint64_t acquisitions = 0;
+        uint64_t contentions = 0;
+        uint64_t waitUs = 0;
+    };
+
 private:
+    struct SequencesShard {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, Sequence> sequences;
+        // updated under the shard lock, so counters do not add contention between shards
+        std::atomic<uint64_t> lockAcquisitions{0};
+        std::atomic<uint64_t> lockContentions{0};
+        std::atomic<uint64_t> lockWaitUs{0};
+    };
+
     uint32_t maxSequenceNumber;
     std::string modelName;
     model_version_t modelVersion;
-    std::mutex mutex;
+    std::array<SequencesShard, SHARDS_COUNT> shards;
+    std::atomic<uint64_t> sequencesCount{0};
+
+    // Sequences inactive for that many seconds are removed by removeExpiredSequences, 0 disables expiry
+    uint32_t idleSequenceTimeoutSeconds = 0;
+    // Memory states of sequences inactive for that many seconds are compressed by compressIdleSequences, 0 disables compression
+    uint32_t idleSequenceCompressionSeconds = 0;
+    // Guards expiry and compression wheels, taken after shard lock when both are held
+    std::mutex wheelsMutex;
+    TimingWheel expiryWheel;
+    TimingWheel compressionWheel;
+    // Last tick passed to removeExpiredSequences or compressIdleSequences, used as activity time of sequences
+    std::atomic<uint64_t> currentTick{0};
+    const std::chrono::steady_clock::time_point creationTime = std::chrono::steady_clock::now();
+
+    /**
+     * @brief Schedules entry of sequence in the wheel
+     *
+     * @return deadline of the entry, not earlier than next tick of the wheel
+     */
+    uint64_t scheduleInWheel(TimingWheel& wheel, uint64_t sequenceId, uint64_t deadline);
+
+    void scheduleExpiry(Sequence& sequence, uint64_t deadline);
+
+    void scheduleCompression(Sequence& sequence, uint64_t deadline);
+
+    /**
+     * @brief Moves the wheel to the tick and returns entries which are due
+     */
+    std::vector<TimingWheel::Entry> advanceWheel(TimingWheel& wheel, uint64_t tick);
+
+    uint64_t getElapsedSeconds() const;
+
+    SequencesShard& getShard(const uint64_t sequenceId) {
+        return shards[sequenceId % SHARDS_COUNT];
+    }
 
-protected:
-    std::unordered_map<uint64_t, Sequence> sequences;
+    const SequencesShard& getShard(const uint64_t sequenceId) const {
+        return shards[sequenceId % SHARDS_COUNT];
+    }
 
-    uint64_t sequenceIdCounter;
+protected:
+    std::atomic<uint64_t> sequenceIdCounter;
 
+    /**
+     * @brief Finds sequence id not used by any sequence, must be called without any shard lock held
+     */
     uint64_t getUniqueSequenceId();
 
     Status hasSequence(const uint64_t sequenceId);
@@ -54,21 +128,49 @@ protected:
 
 public:
     SequenceManager() = default;
-    SequenceManager(uint32_t maxSequenceNumber, std::string modelName, model_version_t modelVersion) :
+    SequenceManager(uint32_t maxSequenceNumber, std::string modelName, model_version_t modelVersion, uint32_t idleSequenceTimeoutSeconds = 0, uint32_t idleSequenceCompressionSeconds = 0) :
         maxSequenceNumber(maxSequenceNumber),
         modelName(modelName),
         modelVersion(modelVersion),
+        idleSequenceTimeoutSeconds(idleSequenceTimeoutSeconds),
+        idleSequenceCompressionSeconds(idleSequenceCompressionSeconds),
         sequenceIdCounter(1) {}
 
-    uint64_t getSequencesCount() {
-        return sequences.size();
+    uint64_t getSequencesCount() const {
+        return sequencesCount.load();
     }
 
     const uint32_t getMaxSequenceNumber() const;
 
+    /**
+     * @brief Gets memory held by states of all sequences in bytes, locks shards one by one
+     */
+    uint64_t getMemoryStateBytes();
+
     void setMaxSequenceNumber(uint32_t maxSequenceNumber);
 
-    std::mutex& getMutex();
+    uint32_t getIdleSequenceTimeoutSeconds() const {
+        return idleSequenceTimeoutSeconds;
+    }
+
+    uint32_t getIdleSequenceCompressionSeconds() const {
+        return idleSequenceCompressionSeconds;
+    }
+
+    /**
+     * @brief Gets mutex of shard containing sequence with given id
+     */
+    std::mutex& getMutex(const uint64_t sequenceId);
+
+    /**
+     * @brief Locks shard containing sequence with given id, counting time spent waiting when the lock is contended
+     */
+    std::unique_lock<std::mutex> lockShard(const uint64_t sequenceId);
+
+    /**
+     * @brief Sums shard lock counters of all shards
+     */
+    ShardLockStats getShardLockStats() const;
 
     bool sequenceExists(const uint64_t sequenceId) const;
 
@@ -76,8 +178,51 @@ public:
 
     Status removeSequence(const uint64_t sequenceId);
 
+    /**
+     * @brief Removes sequences marked idle by previous call and marks remaining ones idle, locks shards one by one
+     */
     Status removeIdleSequences();
 
+    /**
+     * @brief Removes sequences inactive for idle sequence timeout, visits only sequences whose expiry entries are due
+     *
+     * Sequence with later activity or locked by a request is scheduled again. Locks shards of due sequences only.
+     *
+     * @param tick seconds since creation of the manager
+     */
+    Status removeExpiredSequences(uint64_t tick);
+
+    /**
+     * @brief Removes expired sequences at current time
+     */
+    Status removeExpiredSequences();
+
+    /**
+     * @brief Compresses memory states of sequences inactive for idle sequence compression time
+     *
+     * Visits only sequences whose compression entries are due. Sequences bound to infer request or owned by stream are skipped.
+     * Compression runs under sequence lock, shard lock is released before it. State is restored by the next request.
+     *
+     * @param tick seconds since creation of the manager
+     */
+    Status compressIdleSequences(uint64_t tick);
+
+    /**
+     * @brief Compresses memory states of idle sequences at current time
+     */
+    Status compressIdleSequences();
+
+    /**
+     * @brief Creates, checks or terminates sequence according to spec, locks shard of the sequence
+     */
     Status processRequestedSpec(SequenceProcessingSpec& sequenceProcessingSpec);
+
+    /**
+     * @brief Creates, checks or terminates sequence according to spec
+     *
+     * @param sequenceProcessingSpec sequence id is set when new sequence id is generated
+     * @param sequencesLock on return owns lock of shard of the sequence, so it can be accessed with getSequence
+     */
+    Status processRequestedSpec(SequenceProcessingSpec& sequenceProcessingSpec, std::unique_lock<std::mutex>& sequencesLock);
 };
 }  // namespace ovms
@@ -0,0 +1,187 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "sequence_padding.hpp"
+
+#include <cstring>
+
+#include "shared_memory.hpp"
+
+namespace ovms {
+
+namespace {
+const int SEQUENCE_DIMENSION = 1;
+
+bool hasSequenceDimension(const TensorInfo& tensorInfo) {
+    return tensorInfo.getEffectiveShape().size() > SEQUENCE_DIMENSION;
+}
+
+template <typename T>
+void fillAttentionMask(char* data, size_t batchSize, size_t requestLength, size_t bucketLength, size_t positionSize) {
+    T* values = reinterpret_cast<T*>(data);
+    for (size_t i = 0; i < batchSize; ++i) {
+        for (size_t position = 0; position < bucketLength; ++position) {
+            const T value = position < requestLength ? T(1) : T(0);
+            for (size_t j = 0; j < positionSize; ++j) {
+                *values++ = value;
+            }
+        }
+    }
+}
+
+bool generateAttentionMask(const TensorInfo& tensorInfo, size_t batchSize, size_t requestLength, size_t bucketLength,
+    tensorflow::TensorProto& mask) {
+    auto shape = tensorInfo.getEffectiveShape();
+    shape[0] = batchSize;
+    shape[SEQUENCE_DIMENSION] = bucketLength;
+    size_t positionSize = 1;
+    for (size_t i = SEQUENCE_DIMENSION + 1; i < shape.size(); ++i) {
+        positionSize *= shape[i];
+    }
+    const auto precision = tensorInfo.getPrecision();
+    std::string content(batchSize * bucketLength * positionSize * precision.size(), '\0');
+    switch (precision) {
+    case InferenceEngine::Precision::I64:
+        fillAttentionMask<int64_t>(content.data(), batchSize, requestLength, bucketLength, positionSize);
+        break;
+    case InferenceEngine::Precision::I32:
+        fillAttentionMask<int32_t>(content.data(), batchSize, requestLength, bucketLength, positionSize);
+        break;
+    case InferenceEngine::Precision::FP32:
+        fillAttentionMask<float>(content.data(), batchSize, requestLength, bucketLength, positionSize);
+        break;
+    case InferenceEngine::Precision::U8:
+    case InferenceEngine::Precision::I8:
+        fillAttentionMask<uint8_t>(content.data(), batchSize, requestLength, bucketLength, positionSize);
+        break;
+    default:
+        return false;
+    }
+    mask.set_dtype(TensorInfo::getPrecisionAsDataType(precision));
+    for (size_t dimension : shape) {
+        mask.mutable_tensor_shape()->add_dim()->set_size(dimension);
+    }
+    *mask.mutable_tensor_content() = std::move(content);
+    return true;
+}
+
+void padSequence(const tensorflow::TensorProto& input, size_t requestLength, size_t bucketLength, tensorflow::TensorProto& padded) {
+    padded.set_dtype(input.dtype());
+    *padded.mutable_tensor_shape() = input.tensor_shape();
+    padded.mutable_tensor_shape()->mutable_dim(SEQUENCE_DIMENSION)->set_size(bucketLength);
+    const size_t batchSize = input.tensor_shape().dim(0).size();
+    if (batchSize == 0 || requestLength == 0) {
+        return;
+    }
+    const size_t positionByteSize = input.tensor_content().size() / (batchSize * requestLength);
+    std::string content(batchSize * bucketLength * positionByteSize, '\0');
+    for (size_t i = 0; i < batchSize; ++i) {
+        std::memcpy(content.data() + i * bucketLength * positionByteSize,
+            input.tensor_content().data() + i * requestLength * positionByteSize,
+            requestLength * positionByteSize);
+    }
+    *padded.mutable_tensor_content() = std::move(content);
+}
+}  // namespace
+
+bool getRequestSequenceLength(const tensorflow::serving::PredictRequest& request,
+    const tensor_map_t& inputsInfo,
+    const std::string& attentionMaskInput,
+    size_t& sequenceLength) {
+    sequenceLength = 0;
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        if (!hasSequenceDimension(*tensorInfo)) {
+            continue;
+        }
+        auto it = request.inputs().find(name);
+        if (it == request.inputs().end()) {
+            if (name == attentionMaskInput) {
+                continue;
+            }
+            return false;
+        }
+        const auto& input = it->second;
+        // only raw tensor content is padded, typed values, binary and shared memory inputs are served by model shape
+        if (input.dtype() == tensorflow::DataType::DT_STRING || isSharedMemoryReference(input) || input.tensor_content().empty() ||
+            static_cast<size_t>(input.tensor_shape().dim_size()) != tensorInfo->getEffectiveShape().size()) {
+            return false;
+        }
+        const auto length = input.tensor_shape().dim(SEQUENCE_DIMENSION).size();
+        if (length <= 0 || (sequenceLength != 0 && static_cast<size_t>(length) != sequenceLength)) {
+            return false;
+        }
+        sequenceLength = length;
+    }
+    return sequenceLength > 0;
+}
+
+bool padRequestToSequenceLength(const tensorflow::serving::PredictRequest& request,
+    const tensor_map_t& inputsInfo,
+    const std::string& attentionMaskInput,
+    size_t requestLength,
+    size_t bucketLength,
+    tensorflow::serving::PredictRequest& padded) {
+    padded.Clear();
+    *padded.mutable_model_spec() = request.model_spec();
+    *padded.mutable_output_filter() = request.output_filter();
+    size_t batchSize = 0;
+    auto& paddedInputs = *padded.mutable_inputs();
+    for (const auto& [name, input] : request.inputs()) {
+        auto it = inputsInfo.find(name);
+        if (it == inputsInfo.end() || !hasSequenceDimension(*it->second)) {
+            paddedInputs[name] = input;
+            continue;
+        }
+        batchSize = input.tensor_shape().dim(0).size();
+        padSequence(input, requestLength, bucketLength, paddedInputs[name]);
+    }
+    if (attentionMaskInput.empty() || request.inputs().count(attentionMaskInput) > 0) {
+        return true;
+    }
+    auto it = inputsInfo.find(attentionMaskInput);
+    if (it == inputsInfo.end() || !hasSequenceDimension(*it->second)) {
+        return true;
+    }
+    return generateAttentionMask(*it->second, batchSize, requestLength, bucketLength, paddedInputs[attentionMaskInput]);
+}
+
+void trimResponseToSequenceLength(tensorflow::serving::PredictResponse& response,
+    const std::set<std::string>& sequenceOutputs,
+    size_t requestLength,
+    size_t bucketLength) {
+    if (requestLength == bucketLength) {
+        return;
+    }
+    for (auto& [name, output] : *response.mutable_outputs()) {
+        if (sequenceOutputs.count(name) == 0 || output.tensor_shape().dim_size() <= SEQUENCE_DIMENSION ||
+            static_cast<size_t>(output.tensor_shape().dim(SEQUENCE_DIMENSION).size()) != bucketLength) {
+            continue;
+        }
+        output.mutable_tensor_shape()->mutable_dim(SEQUENCE_DIMENSION)->set_size(requestLength);
+        const size_t batchSize = output.tensor_shape().dim(0).size();
+        auto& content = *output.mutable_tensor_content();
+        if (batchSize == 0 || content.empty()) {
+            continue;
+        }
+        const size_t positionByteSize = content.size() / (batchSize * bucketLength);
+        for (size_t i = 1; i < batchSize; ++i) {
+            std::memmove(content.data() + i * requestLength * positionByteSize,
+                content.data() + i * bucketLength * positionByteSize,
+                requestLength * positionByteSize);
+        }
+        content.resize(batchSize * requestLength * positionByteSize);
+    }
+}
+}  // namespace ovms
@@ -0,0 +1,83 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <set>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * Helpers of sequence length buckets. Second dimension of every input with at least two dimensions is the sequence dimension,
+ * as in [batch, tokens] inputs of BERT like models.
+ */
+
+/**
+ * @brief Reads sequence length shared by sequence inputs of the request
+ *
+ * @param request
+ * @param inputsInfo tensors of the network, decide which inputs have sequence dimension
+ * @param attentionMaskInput input which may be missing in request, empty if none
+ * @param sequenceLength
+ *
+ * @return false if request has no sequence inputs, they disagree on the length or cannot be padded
+ */
+bool getRequestSequenceLength(const tensorflow::serving::PredictRequest& request,
+    const tensor_map_t& inputsInfo,
+    const std::string& attentionMaskInput,
+    size_t& sequenceLength);
+
+/**
+ * @brief Creates copy of request with sequence inputs zero padded to bucket length
+ *
+ * Attention mask input missing in request is generated with ones at positions of request sequence and zeros at padding.
+ *
+ * @param request request with sequence length returned by getRequestSequenceLength
+ * @param inputsInfo tensors of the network compiled for bucket length
+ * @param attentionMaskInput empty if mask is not generated
+ * @param requestLength
+ * @param bucketLength not shorter than requestLength
+ * @param padded
+ *
+ * @return false if attention mask has to be generated in precision other than integer or FP32
+ */
+bool padRequestToSequenceLength(const tensorflow::serving::PredictRequest& request,
+    const tensor_map_t& inputsInfo,
+    const std::string& attentionMaskInput,
+    size_t requestLength,
+    size_t bucketLength,
+    tensorflow::serving::PredictRequest& padded);
+
+/**
+ * @brief Trims sequence dimension of response outputs from bucket length back to request length
+ *
+ * @param response
+ * @param sequenceOutputs outputs with sequence dimension
+ * @param requestLength
+ * @param bucketLength
+ */
+void trimResponseToSequenceLength(tensorflow::serving::PredictResponse& response,
+    const std::set<std::string>& sequenceOutputs,
+    size_t requestLength,
+    size_t bucketLength);
+}  // namespace ovms
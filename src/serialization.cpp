@@ -15,20 +15,20 @@
 //*****************************************************************************
 #include "serialization.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+
+#include "deserialization.hpp"
+#include "opencv2/opencv.hpp"
 #include "ov_utils.hpp"
 
 namespace ovms {
 
-Status serializeBlobToTensorProto(
+static Status setTensorProtoDataType(
     tensorflow::TensorProto& responseOutput,
-    const std::shared_ptr<TensorInfo>& networkOutput,
-    InferenceEngine::Blob::Ptr blob) {
-    responseOutput.Clear();
-    if (networkOutput->getPrecision() != blob->getTensorDesc().getPrecision()) {
-        SPDLOG_ERROR("Failed to serialize blob: {}. There is difference in precision expected:{} vs actual:{}",
-            networkOutput->getName(), networkOutput->getPrecision(), blob->getTensorDesc().getPrecision());
-        return StatusCode::INTERNAL_ERROR;
-    }
+    const std::shared_ptr<TensorInfo>& networkOutput) {
     switch (networkOutput->getPrecision()) {
     case InferenceEngine::Precision::FP32:
         responseOutput.set_dtype(tensorflow::DataTypeToEnum<float>::value);
@@ -68,6 +68,32 @@ Status serializeBlobToTensorProto(
         return status;
     }
     }
+    return StatusCode::OK;
+}
+
+Status serializeBlobToTensorProto(
+    tensorflow::TensorProto& responseOutput,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Blob::Ptr blob) {
+    // blob bound by ResponseOutputsBinding already holds the content in place
+    std::string content;
+    auto blobMemory = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap();
+    const char* blobData = blobMemory.as<const char*>();
+    const bool contentInPlace = blobData == responseOutput.tensor_content().data() &&
+                                blob->byteSize() == responseOutput.tensor_content().size();
+    if (contentInPlace) {
+        content.swap(*responseOutput.mutable_tensor_content());
+    }
+    responseOutput.Clear();
+    if (networkOutput->getPrecision() != blob->getTensorDesc().getPrecision()) {
+        SPDLOG_ERROR("Failed to serialize blob: {}. There is difference in precision expected:{} vs actual:{}",
+            networkOutput->getName(), networkOutput->getPrecision(), blob->getTensorDesc().getPrecision());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    auto status = setTensorProtoDataType(responseOutput, networkOutput);
+    if (!status.ok()) {
+        return status;
+    }
     responseOutput.mutable_tensor_shape()->Clear();
     auto& effectiveNetworkOutputShape = networkOutput->getEffectiveShape();
     auto& actualBlobShape = getEffectiveBlobShape(blob);
@@ -90,7 +116,372 @@ Status serializeBlobToTensorProto(
         }
         responseOutput.mutable_tensor_shape()->add_dim()->set_size(dim);
     }
-    responseOutput.mutable_tensor_content()->assign(InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<char*>(), blob->byteSize());
+    if (contentInPlace) {
+        responseOutput.mutable_tensor_content()->swap(content);
+    } else {
+        responseOutput.mutable_tensor_content()->assign(blobData, blob->byteSize());
+    }
+    return StatusCode::OK;
+}
+
+ResponseOutputsBinding::~ResponseOutputsBinding() {
+    restore();
+}
+
+void ResponseOutputsBinding::restore() {
+    for (auto& [name, blob] : originalBlobs) {
+        try {
+            inferRequest.SetBlob(name, blob);
+        } catch (const InferenceEngine::Exception& e) {
+            SPDLOG_ERROR("Failed to restore output blob: {}; exception message: {}", name, e.what());
+        } catch (std::logic_error& e) {
+            SPDLOG_ERROR("Failed to restore output blob: {}; exception message: {}", name, e.what());
+        }
+    }
+    originalBlobs.clear();
+}
+
+Status ResponseOutputsBinding::bind(const tensor_map_t& outputMap, tensorflow::serving::PredictResponse* response,
+    const postprocessing_map_t& postprocessing) {
+    for (const auto& [outputName, outputInfo] : outputMap) {
+        if (postprocessing.count(outputInfo->getName())) {
+            continue;
+        }
+        try {
+            InferenceEngine::Blob::Ptr originalBlob = inferRequest.GetBlob(outputName);
+            // protobuf map values keep their addresses when other entries are added
+            auto& tensorProto = (*response->mutable_outputs())[outputInfo->getMappedName()];
+            tensorProto.Clear();
+            std::string* content = tensorProto.mutable_tensor_content();
+            content->resize(originalBlob->byteSize());
+            InferenceEngine::Blob::Ptr responseBlob;
+            auto status = createSharedBlob(responseBlob, originalBlob->getTensorDesc(), content->data());
+            if (!status.ok()) {
+                restore();
+                return status;
+            }
+            inferRequest.SetBlob(outputName, responseBlob);
+            originalBlobs.emplace_back(outputName, std::move(originalBlob));
+        } catch (const InferenceEngine::Exception& e) {
+            SPDLOG_DEBUG("Binding response buffer to output: {} failed; exception message: {}", outputName, e.what());
+            restore();
+            return StatusCode::OV_INTERNAL_SERIALIZATION_ERROR;
+        } catch (std::logic_error& e) {
+            SPDLOG_DEBUG("Binding response buffer to output: {} failed; exception message: {}", outputName, e.what());
+            restore();
+            return StatusCode::OV_INTERNAL_SERIALIZATION_ERROR;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status serializeBlobBatchSliceToTensorProto(
+    tensorflow::TensorProto& responseOutput,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Blob::Ptr blob,
+    size_t batchOffset,
+    size_t batchCount) {
+    responseOutput.Clear();
+    if (networkOutput->getPrecision() != blob->getTensorDesc().getPrecision()) {
+        SPDLOG_ERROR("Failed to serialize blob: {}. There is difference in precision expected:{} vs actual:{}",
+            networkOutput->getName(), networkOutput->getPrecision(), blob->getTensorDesc().getPrecision());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    auto status = setTensorProtoDataType(responseOutput, networkOutput);
+    if (!status.ok()) {
+        return status;
+    }
+    auto& actualBlobShape = getEffectiveBlobShape(blob);
+    if (actualBlobShape.size() == 0 || batchOffset + batchCount > actualBlobShape[0]) {
+        SPDLOG_ERROR("Failed to serialize blob: {}. Requested batch slice [{}, {}) exceeds blob batch size",
+            networkOutput->getName(), batchOffset, batchOffset + batchCount);
+        return StatusCode::INTERNAL_ERROR;
+    }
+    responseOutput.mutable_tensor_shape()->Clear();
+    responseOutput.mutable_tensor_shape()->add_dim()->set_size(batchCount);
+    for (size_t i = 1; i < actualBlobShape.size(); ++i) {
+        responseOutput.mutable_tensor_shape()->add_dim()->set_size(actualBlobShape[i]);
+    }
+    const size_t sampleByteSize = blob->byteSize() / actualBlobShape[0];
+    responseOutput.mutable_tensor_content()->assign(
+        InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<char*>() + batchOffset * sampleByteSize,
+        batchCount * sampleByteSize);
+    return StatusCode::OK;
+}
+
+Status filterRequestedOutputs(
+    const tensorflow::serving::PredictRequest& request,
+    const tensor_map_t& outputsInfo,
+    tensor_map_t& requestedOutputs) {
+    requestedOutputs.clear();
+    for (const auto& name : request.output_filter()) {
+        auto it = outputsInfo.find(name);
+        if (it == outputsInfo.end()) {
+            std::stringstream ss;
+            ss << "Requested output: " << name;
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("Output filter lists unknown output - {}", details);
+            return Status(StatusCode::INVALID_OUTPUT_FILTER, details);
+        }
+        requestedOutputs.emplace(it->first, it->second);
+    }
+    return StatusCode::OK;
+}
+
+bool isPostprocessingSupported(
+    const OutputPostprocessing& postprocessing,
+    InferenceEngine::Precision precision,
+    const InferenceEngine::SizeVector& dims,
+    InferenceEngine::Layout layout) {
+    if (postprocessing.type == "rle") {
+        return dims.size() >= 1 &&
+               (precision == InferenceEngine::Precision::FP32 ||
+                   precision == InferenceEngine::Precision::I32 ||
+                   precision == InferenceEngine::Precision::I64);
+    }
+    if (precision != InferenceEngine::Precision::FP32) {
+        return false;
+    }
+    if (postprocessing.type == "png" || postprocessing.type == "jpeg") {
+        if (dims.size() != 4) {
+            return false;
+        }
+        const size_t channels = layout == InferenceEngine::Layout::NHWC ? dims[3] : dims[1];
+        return channels == 1 || channels == 3;
+    }
+    if (postprocessing.type == "fp16" || postprocessing.type == "bf16" || postprocessing.type == "int8") {
+        return dims.size() >= 1;
+    }
+    return dims.size() >= 2;
+}
+
+static void setBatchSliceShape(tensorflow::TensorProto& proto, const InferenceEngine::SizeVector& shape, size_t batchCount) {
+    proto.mutable_tensor_shape()->add_dim()->set_size(batchCount);
+    for (size_t i = 1; i < shape.size(); ++i) {
+        proto.mutable_tensor_shape()->add_dim()->set_size(shape[i]);
+    }
+}
+
+static uint16_t convertFp32ToBf16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        // keeps NaN quiet instead of rounding it to infinity
+        return (bits >> 16) | 0x40;
+    }
+    // round to nearest even, carry into exponent is correct up to infinity
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return bits >> 16;
+}
+
+static void serializeDowncastedValues(
+    tensorflow::TensorProto& proto,
+    const float* values,
+    size_t count,
+    const OutputPostprocessing& postprocessing) {
+    std::string& content = *proto.mutable_tensor_content();
+    if (postprocessing.type == "bf16") {
+        proto.set_dtype(tensorflow::DataType::DT_BFLOAT16);
+        content.resize(count * sizeof(uint16_t));
+        auto* destination = reinterpret_cast<uint16_t*>(content.data());
+        for (size_t i = 0; i < count; ++i) {
+            destination[i] = convertFp32ToBf16(values[i]);
+        }
+    } else if (postprocessing.type == "fp16") {
+        proto.set_dtype(tensorflow::DataType::DT_HALF);
+        content.resize(count * sizeof(uint16_t));
+        convertFromFp32(InferenceEngine::Precision::FP16, values, content.data(), count);
+    } else {
+        std::vector<float> scaled(count);
+        std::transform(values, values + count, scaled.begin(), [&postprocessing](float value) { return value / postprocessing.scale; });
+        proto.set_dtype(tensorflow::DataType::DT_INT8);
+        content.resize(count * sizeof(int8_t));
+        convertFromFp32(InferenceEngine::Precision::I8, scaled.data(), content.data(), count);
+    }
+}
+
+template <typename T>
+static void appendRuns(const void* data, size_t count, std::vector<int32_t>& runs) {
+    const T* values = static_cast<const T*>(data);
+    size_t runStart = 0;
+    for (size_t i = 1; i <= count; ++i) {
+        if (i == count || values[i] != values[runStart]) {
+            runs.push_back(static_cast<int32_t>(values[runStart]));
+            runs.push_back(static_cast<int32_t>(i - runStart));
+            runStart = i;
+        }
+    }
+}
+
+static void serializeRunLengthEncodedValues(
+    tensorflow::serving::PredictResponse& response,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Precision precision,
+    const void* values,
+    const InferenceEngine::SizeVector& shape,
+    size_t batchCount) {
+    size_t count = batchCount;
+    for (size_t i = 1; i < shape.size(); ++i) {
+        count *= shape[i];
+    }
+    std::vector<int32_t> runs;
+    switch (precision) {
+    case InferenceEngine::Precision::I32:
+        appendRuns<int32_t>(values, count, runs);
+        break;
+    case InferenceEngine::Precision::I64:
+        appendRuns<int64_t>(values, count, runs);
+        break;
+    default:
+        appendRuns<float>(values, count, runs);
+        break;
+    }
+    // protobuf map values keep their addresses when other entries are added
+    auto& runsProto = (*response.mutable_outputs())[networkOutput->getMappedName()];
+    runsProto.Clear();
+    runsProto.set_dtype(tensorflow::DataTypeToEnum<int32_t>::value);
+    runsProto.mutable_tensor_shape()->add_dim()->set_size(runs.size() / 2);
+    runsProto.mutable_tensor_shape()->add_dim()->set_size(2);
+    runsProto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(runs.data()), runs.size() * sizeof(int32_t));
+
+    std::vector<int64_t> sliceShape(shape.begin(), shape.end());
+    sliceShape[0] = batchCount;
+    auto& shapeProto = (*response.mutable_outputs())[networkOutput->getMappedName() + POSTPROCESSING_SHAPE_SUFFIX];
+    shapeProto.Clear();
+    shapeProto.set_dtype(tensorflow::DataTypeToEnum<int64_t>::value);
+    shapeProto.mutable_tensor_shape()->add_dim()->set_size(sliceShape.size());
+    shapeProto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(sliceShape.data()), sliceShape.size() * sizeof(int64_t));
+}
+
+static Status serializeEncodedImages(
+    tensorflow::TensorProto& proto,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    const float* entries,
+    const InferenceEngine::SizeVector& shape,
+    size_t batchCount,
+    const OutputPostprocessing& postprocessing) {
+    const bool nhwc = networkOutput->getLayout() == InferenceEngine::Layout::NHWC;
+    const size_t channels = nhwc ? shape[3] : shape[1];
+    const size_t height = nhwc ? shape[1] : shape[2];
+    const size_t width = nhwc ? shape[2] : shape[3];
+    const size_t pixelsCount = height * width;
+    const std::string extension = postprocessing.type == "png" ? ".png" : ".jpg";
+    cv::Mat image(height, width, CV_8UC(channels));
+    std::vector<uchar> encoded;
+    proto.set_dtype(tensorflow::DataType::DT_STRING);
+    proto.mutable_tensor_shape()->add_dim()->set_size(batchCount);
+    for (size_t i = 0; i < batchCount; ++i) {
+        const float* entry = entries + i * pixelsCount * channels;
+        uchar* pixels = image.ptr<uchar>();
+        for (size_t pixel = 0; pixel < pixelsCount; ++pixel) {
+            for (size_t channel = 0; channel < channels; ++channel) {
+                const float value = nhwc ? entry[pixel * channels + channel] : entry[channel * pixelsCount + pixel];
+                pixels[pixel * channels + channel] = cv::saturate_cast<uchar>(value / postprocessing.scale);
+            }
+        }
+        try {
+            if (!cv::imencode(extension, image, encoded)) {
+                SPDLOG_ERROR("Failed to encode output: {} as {}", networkOutput->getName(), postprocessing.type);
+                return StatusCode::INTERNAL_ERROR;
+            }
+        } catch (const cv::Exception& e) {
+            SPDLOG_ERROR("Failed to encode output: {} as {}: {}", networkOutput->getName(), postprocessing.type, e.what());
+            return StatusCode::INTERNAL_ERROR;
+        }
+        proto.add_string_val(encoded.data(), encoded.size());
+    }
+    return StatusCode::OK;
+}
+
+Status serializePostprocessedBlobBatchSlice(
+    tensorflow::serving::PredictResponse& response,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Blob::Ptr blob,
+    const OutputPostprocessing& postprocessing,
+    size_t batchOffset,
+    size_t batchCount) {
+    auto& actualBlobShape = getEffectiveBlobShape(blob);
+    const auto precision = blob->getTensorDesc().getPrecision();
+    if (!isPostprocessingSupported(postprocessing, precision, actualBlobShape, networkOutput->getLayout()) ||
+        batchOffset + batchCount > actualBlobShape[0]) {
+        SPDLOG_ERROR("Failed to postprocess blob: {} with {}. It has unsupported precision or shape, or its batch dimension does not cover entries [{}, {})",
+            networkOutput->getName(), postprocessing.type, batchOffset, batchOffset + batchCount);
+        return StatusCode::INTERNAL_ERROR;
+    }
+    const size_t entrySize = blob->size() / actualBlobShape[0];
+    auto blobMemory = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap();
+    if (postprocessing.type == "rle") {
+        serializeRunLengthEncodedValues(response, networkOutput, precision,
+            blobMemory.as<const char*>() + batchOffset * entrySize * blob->element_size(), actualBlobShape, batchCount);
+        return StatusCode::OK;
+    }
+    const float* entries = blobMemory.as<const float*>() + batchOffset * entrySize;
+
+    // protobuf map values keep their addresses when other entries are added
+    auto& scoresProto = (*response.mutable_outputs())[networkOutput->getMappedName()];
+    scoresProto.Clear();
+    if (postprocessing.type == "png" || postprocessing.type == "jpeg") {
+        return serializeEncodedImages(scoresProto, networkOutput, entries, actualBlobShape, batchCount, postprocessing);
+    }
+    if (postprocessing.type == "fp16" || postprocessing.type == "bf16" || postprocessing.type == "int8") {
+        setBatchSliceShape(scoresProto, actualBlobShape, batchCount);
+        serializeDowncastedValues(scoresProto, entries, batchCount * entrySize, postprocessing);
+        return StatusCode::OK;
+    }
+    if (postprocessing.type == "argmax") {
+        std::vector<int32_t> positions(batchCount);
+        for (size_t i = 0; i < batchCount; ++i) {
+            const float* entry = entries + i * entrySize;
+            positions[i] = std::max_element(entry, entry + entrySize) - entry;
+        }
+        scoresProto.set_dtype(tensorflow::DataTypeToEnum<int32_t>::value);
+        scoresProto.mutable_tensor_shape()->add_dim()->set_size(batchCount);
+        scoresProto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(positions.data()), positions.size() * sizeof(int32_t));
+        return StatusCode::OK;
+    }
+
+    auto& indicesProto = (*response.mutable_outputs())[networkOutput->getMappedName() + POSTPROCESSING_INDICES_SUFFIX];
+    indicesProto.Clear();
+    std::vector<float> scores;
+    std::vector<int32_t> indices;
+    if (postprocessing.type == "top_k") {
+        const size_t k = std::min<size_t>(postprocessing.k, entrySize);
+        scores.reserve(batchCount * k);
+        indices.reserve(batchCount * k);
+        std::vector<int32_t> positions(entrySize);
+        for (size_t i = 0; i < batchCount; ++i) {
+            const float* entry = entries + i * entrySize;
+            std::iota(positions.begin(), positions.end(), 0);
+            std::partial_sort(positions.begin(), positions.begin() + k, positions.end(),
+                [entry](int32_t lhs, int32_t rhs) { return entry[lhs] > entry[rhs] || (entry[lhs] == entry[rhs] && lhs < rhs); });
+            for (size_t j = 0; j < k; ++j) {
+                scores.push_back(entry[positions[j]]);
+                indices.push_back(positions[j]);
+            }
+        }
+        for (auto* proto : {&scoresProto, &indicesProto}) {
+            proto->mutable_tensor_shape()->add_dim()->set_size(batchCount);
+            proto->mutable_tensor_shape()->add_dim()->set_size(k);
+        }
+    } else {
+        for (size_t i = 0; i < batchCount; ++i) {
+            const float* entry = entries + i * entrySize;
+            for (size_t position = 0; position < entrySize; ++position) {
+                if (entry[position] >= postprocessing.threshold) {
+                    scores.push_back(entry[position]);
+                    indices.push_back(i);
+                    indices.push_back(position);
+                }
+            }
+        }
+        scoresProto.mutable_tensor_shape()->add_dim()->set_size(scores.size());
+        indicesProto.mutable_tensor_shape()->add_dim()->set_size(scores.size());
+        indicesProto.mutable_tensor_shape()->add_dim()->set_size(2);
+    }
+    scoresProto.set_dtype(tensorflow::DataTypeToEnum<float>::value);
+    scoresProto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(scores.data()), scores.size() * sizeof(float));
+    indicesProto.set_dtype(tensorflow::DataTypeToEnum<int32_t>::value);
+    indicesProto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(int32_t));
     return StatusCode::OK;
 }
 
@@ -109,7 +500,8 @@ Status OutputGetter<InferenceEngine::InferRequest&>::get(const std::string& name
 Status serializePredictResponse(
     InferenceEngine::InferRequest& inferRequest,
     const tensor_map_t& outputMap,
-    tensorflow::serving::PredictResponse* response) {
+    tensorflow::serving::PredictResponse* response,
+    const postprocessing_map_t& postprocessing) {
     Status status;
     for (const auto& pair : outputMap) {
         auto networkOutput = pair.second;
@@ -119,6 +511,15 @@ Status serializePredictResponse(
         if (!status.ok()) {
             return status;
         }
+        auto postprocessingIt = postprocessing.find(networkOutput->getName());
+        if (postprocessingIt != postprocessing.end()) {
+            auto& blobShape = getEffectiveBlobShape(blob);
+            status = serializePostprocessedBlobBatchSlice(*response, networkOutput, blob, postprocessingIt->second, 0, blobShape.empty() ? 0 : blobShape[0]);
+            if (!status.ok()) {
+                return status;
+            }
+            continue;
+        }
         auto& tensorProto = (*response->mutable_outputs())[networkOutput->getMappedName()];
         status = serializeBlobToTensorProto(tensorProto, networkOutput, blob);
         if (!status.ok()) {
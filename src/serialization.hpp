@@ -17,6 +17,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
@@ -27,11 +29,22 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "modelconfig.hpp"
 #include "status.hpp"
 #include "tensorinfo.hpp"
 
 namespace ovms {
 
+/**
+ * @brief Suffix of response output with indices of scores returned by top_k and threshold postprocessing
+ */
+const std::string POSTPROCESSING_INDICES_SUFFIX = "_indices";
+
+/**
+ * @brief Suffix of response output with shape of data encoded by rle postprocessing
+ */
+const std::string POSTPROCESSING_SHAPE_SUFFIX = "_shape";
+
 template <typename T>
 class OutputGetter {
 public:
@@ -43,15 +56,110 @@ private:
     T outputSource;
 };
 
+/**
+ * @brief Serializes blob into tensor proto, content is not copied when blob wraps the tensor_content buffer
+ */
 Status serializeBlobToTensorProto(
     tensorflow::TensorProto& responseOutput,
     const std::shared_ptr<TensorInfo>& networkOutput,
     InferenceEngine::Blob::Ptr blob);
 
+/**
+ * @brief Sets blobs backed by tensor_content buffers of the response as outputs of infer request
+ *
+ * Inference then writes outputs directly into the response and serialization skips the content copy.
+ * Original output blobs are restored on destruction so that infer request can be reused by other requests,
+ * the binding has to be destroyed before infer request is returned to the queue.
+ */
+class ResponseOutputsBinding {
+    InferenceEngine::InferRequest& inferRequest;
+    std::vector<std::pair<std::string, InferenceEngine::Blob::Ptr>> originalBlobs;
+
+    void restore();
+
+public:
+    explicit ResponseOutputsBinding(InferenceEngine::InferRequest& inferRequest) :
+        inferRequest(inferRequest) {}
+    ResponseOutputsBinding(const ResponseOutputsBinding&) = delete;
+    ResponseOutputsBinding& operator=(const ResponseOutputsBinding&) = delete;
+    ~ResponseOutputsBinding();
+
+    /**
+     * @brief Binds all outputs, on failure leaves infer request unchanged
+     *
+     * @param outputMap
+     * @param response
+     * @param postprocessing outputs postprocessed before serialization are not bound
+     *
+     * @return Status
+     */
+    Status bind(const tensor_map_t& outputMap, tensorflow::serving::PredictResponse* response,
+        const postprocessing_map_t& postprocessing = {});
+};
+
+/**
+ * @brief Serializes batchCount entries of the blob starting at batchOffset along the batch dimension
+ */
+Status serializeBlobBatchSliceToTensorProto(
+    tensorflow::TensorProto& responseOutput,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Blob::Ptr blob,
+    size_t batchOffset,
+    size_t batchCount);
+
+/**
+ * @brief Selects outputs listed in output_filter of request by their mapped names
+ *
+ * @param requestedOutputs filled only when request has output filter, otherwise all outputs are served
+ *
+ * @return INVALID_OUTPUT_FILTER if filter lists output which does not exist
+ */
+Status filterRequestedOutputs(
+    const tensorflow::serving::PredictRequest& request,
+    const tensor_map_t& outputsInfo,
+    tensor_map_t& requestedOutputs);
+
+/**
+ * @brief Checks if output of given precision and dimensions can be postprocessed
+ *
+ * Outputs need a batch dimension and FP32 precision, rle accepts also I32 and I64 class indices
+ * and png and jpeg require NCHW or NHWC output with 1 or 3 channels.
+ */
+bool isPostprocessingSupported(
+    const OutputPostprocessing& postprocessing,
+    InferenceEngine::Precision precision,
+    const InferenceEngine::SizeVector& dims,
+    InferenceEngine::Layout layout);
+
+/**
+ * @brief Serializes result of postprocessing batchCount entries of blob starting at batchOffset
+ *
+ * Each batch entry is treated as a flat vector of scores. top_k returns k best scores of each entry
+ * sorted in descending order with their positions in output suffixed with POSTPROCESSING_INDICES_SUFFIX,
+ * argmax returns position of the best score of each entry and threshold returns scores not lower than
+ * the threshold together with [batch entry, position] pairs of them.
+ *
+ * fp16, bf16 and int8 return the slice downcasted, int8 as values divided by scale. rle returns
+ * [value, run length] pairs of the flattened slice with its shape in output suffixed with
+ * POSTPROCESSING_SHAPE_SUFFIX. png and jpeg return one encoded image per batch entry, with pixels
+ * being values divided by scale.
+ */
+Status serializePostprocessedBlobBatchSlice(
+    tensorflow::serving::PredictResponse& response,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Blob::Ptr blob,
+    const OutputPostprocessing& postprocessing,
+    size_t batchOffset,
+    size_t batchCount);
+
+/**
+ * @param postprocessing outputs listed there are postprocessed instead of serialized in full
+ */
 Status serializePredictResponse(
     InferenceEngine::InferRequest& inferRequest,
     const tensor_map_t& outputMap,
-    tensorflow::serving::PredictResponse* response);
+    tensorflow::serving::PredictResponse* response,
+    const postprocessing_map_t& postprocessing = {});
 
 template <typename T>
 Status serializePredictResponse(
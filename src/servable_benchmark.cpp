@@ -0,0 +1,277 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "servable_benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "modelinstance.hpp"
+#include "modelinstanceunloadguard.hpp"
+#include "modelmanager.hpp"
+#include "pipeline.hpp"
+#include "pipelinedefinition.hpp"
+#include "pipelinedefinitionunloadguard.hpp"
+
+namespace ovms {
+
+ServableBenchmark::ServableBenchmark(ModelManager& manager, const std::string& servableName, uint32_t concurrency, std::chrono::milliseconds duration) :
+    manager(manager),
+    servableName(servableName),
+    concurrency(std::max<uint32_t>(1, concurrency)),
+    duration(duration) {}
+
+Status ServableBenchmark::prepareModel(const std::string& name) {
+    std::shared_ptr<ModelInstance> instance;
+    std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+    auto status = manager.getModelInstance(name, 0, instance, unloadGuard);
+    if (!status.ok()) {
+        return status;
+    }
+    auto metrics = ModelMetrics::create(MetricRegistry::getInstance(), name, instance->getVersion());
+    stages = {
+        {"get_infer_request", metrics.getInferRequestTime, {}, {}},
+        {"deserialize", metrics.deserializeTime, {}, {}},
+        {"prediction", metrics.predictionTime, {}, {}},
+        {"serialize", metrics.serializeTime, {}, {}}};
+    addModelUtilization(name, instance->getVersion());
+    return prepareRequest(servableName, instance->getInputsInfo(), request);
+}
+
+Status ServableBenchmark::preparePipeline(const std::string& name) {
+    auto* definition = manager.getPipelineFactory().findDefinitionByName(name);
+    if (definition == nullptr) {
+        return StatusCode::PIPELINE_DEFINITION_NAME_MISSING;
+    }
+    std::unique_ptr<PipelineDefinitionUnloadGuard> unloadGuard;
+    auto status = definition->waitForLoaded(unloadGuard);
+    if (!status.ok()) {
+        return status;
+    }
+    stages.clear();
+    for (const auto& info : definition->getNodeInfos()) {
+        if (info.kind == NodeKind::ENTRY || info.kind == NodeKind::EXIT) {
+            continue;
+        }
+        auto metrics = NodeMetrics::create(MetricRegistry::getInstance(), name, info.nodeName);
+        stages.push_back({info.nodeName + " inputs wait", metrics.inputsWaitTime, {}, {}});
+        if (info.kind == NodeKind::DL) {
+            stages.push_back({info.nodeName + " stream wait", metrics.streamWaitTime, {}, {}});
+            auto instance = manager.findModelInstance(info.modelName, info.modelVersion.value_or(0));
+            if (instance) {
+                addModelUtilization(info.modelName, instance->getVersion());
+            }
+        }
+        stages.push_back({info.nodeName + " execution", metrics.executionTime, {}, {}});
+    }
+    return prepareRequest(servableName, definition->getInputsInfo(), request);
+}
+
+void ServableBenchmark::addModelUtilization(const std::string& name, int64_t version) {
+    for (const auto& utilization : utilizations) {
+        if (utilization.name == name && utilization.version == version) {
+            return;
+        }
+    }
+    auto metrics = ModelMetrics::create(MetricRegistry::getInstance(), name, version);
+    utilizations.push_back({name, version, metrics.inferRequestsInUse, metrics.inferRequests});
+}
+
+Status ServableBenchmark::prepareRequest(const std::string& servableName, const tensor_map_t& inputsInfo, tensorflow::serving::PredictRequest& request) {
+    request.Clear();
+    request.mutable_model_spec()->set_name(servableName);
+    for (const auto& [name, info] : inputsInfo) {
+        const auto dataType = info->getPrecisionAsDataType();
+        const size_t elementSize = info->getPrecision().size();
+        if (dataType == tensorflow::DT_INVALID || dataType == tensorflow::DT_STRING || elementSize == 0) {
+            SPDLOG_ERROR("Cannot build synthetic data of input: {} with precision: {}", name, info->getPrecisionAsString());
+            return StatusCode::INVALID_PRECISION;
+        }
+        auto& proto = (*request.mutable_inputs())[name];
+        proto.set_dtype(dataType);
+        size_t elementsCount = 1;
+        for (auto dim : info->getEffectiveShape()) {
+            // dimensions not known before inference are sent as 1
+            const size_t size = dim == 0 ? 1 : dim;
+            proto.mutable_tensor_shape()->add_dim()->set_size(size);
+            elementsCount *= size;
+        }
+        proto.mutable_tensor_content()->assign(elementsCount * elementSize, '\0');
+    }
+    return StatusCode::OK;
+}
+
+Status ServableBenchmark::sendRequest() {
+    tensorflow::serving::PredictResponse response;
+    std::shared_ptr<ModelInstance> instance;
+    std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+    auto status = manager.getModelInstance(servableName, 0, instance, unloadGuard);
+    if (status.ok()) {
+        return instance->infer(&request, &response, unloadGuard);
+    }
+    if (status != StatusCode::MODEL_NAME_MISSING) {
+        return status;
+    }
+    std::unique_ptr<Pipeline> pipeline;
+    status = manager.createPipeline(pipeline, servableName, &request, &response);
+    if (!status.ok()) {
+        return status;
+    }
+    return pipeline->execute();
+}
+
+void ServableBenchmark::runWorker(std::chrono::steady_clock::time_point end, std::vector<uint64_t>& latencies) {
+    while (std::chrono::steady_clock::now() < end) {
+        const auto start = std::chrono::steady_clock::now();
+        auto status = sendRequest();
+        if (!status.ok()) {
+            failedRequestsCount.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(errorMtx);
+            lastError = status;
+            continue;
+        }
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+Status ServableBenchmark::run() {
+    auto status = prepareModel(servableName);
+    if (status == StatusCode::MODEL_NAME_MISSING) {
+        status = preparePipeline(servableName);
+    }
+    if (!status.ok()) {
+        SPDLOG_ERROR("Cannot benchmark servable: {}; {}", servableName, status.string());
+        return status;
+    }
+    for (auto& stage : stages) {
+        stage.startCounts = stage.histogram->getBucketCounts();
+    }
+    for (auto& utilization : utilizations) {
+        utilization.inUseSum = 0;
+        utilization.totalSum = 0;
+    }
+    latenciesUs.clear();
+    failedRequestsCount = 0;
+    lastError = StatusCode::OK;
+
+    SPDLOG_INFO("Benchmarking servable: {} with {} concurrent requests for {} ms", servableName, concurrency, duration.count());
+    std::vector<std::vector<uint64_t>> workerLatencies(concurrency);
+    std::vector<std::thread> workers;
+    workers.reserve(concurrency);
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + duration;
+    for (uint32_t i = 0; i < concurrency; ++i) {
+        workers.emplace_back(&ServableBenchmark::runWorker, this, end, std::ref(workerLatencies[i]));
+    }
+    while (std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(UTILIZATION_SAMPLING_INTERVAL);
+        for (auto& utilization : utilizations) {
+            utilization.inUseSum += std::max<int64_t>(0, utilization.inUse->get());
+            utilization.totalSum += std::max<int64_t>(0, utilization.total->get());
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    for (auto& latencies : workerLatencies) {
+        latenciesUs.insert(latenciesUs.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    for (auto& stage : stages) {
+        stage.counts = stage.histogram->getBucketCounts();
+        for (size_t i = 0; i < stage.counts.size(); ++i) {
+            stage.counts[i] -= stage.startCounts[i];
+        }
+    }
+    return StatusCode::OK;
+}
+
+double ServableBenchmark::getThroughput() const {
+    if (elapsed.count() == 0) {
+        return 0;
+    }
+    return latenciesUs.size() * 1'000'000.0 / elapsed.count();
+}
+
+uint64_t ServableBenchmark::getLatencyPercentileUs(double percentile) const {
+    if (latenciesUs.empty()) {
+        return 0;
+    }
+    const size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * latenciesUs.size()));
+    return latenciesUs[std::min(latenciesUs.size(), std::max<size_t>(1, rank)) - 1];
+}
+
+uint64_t ServableBenchmark::estimatePercentile(const std::vector<uint64_t>& bucketBounds, const std::vector<uint64_t>& bucketCounts, double percentile) {
+    uint64_t total = 0;
+    for (auto count : bucketCounts) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const double rank = percentile / 100 * total;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bucketBounds.size(); ++i) {
+        if (bucketCounts[i] > 0 && cumulative + bucketCounts[i] >= rank) {
+            const uint64_t lower = i == 0 ? 0 : bucketBounds[i - 1];
+            return lower + static_cast<uint64_t>((bucketBounds[i] - lower) * (rank - cumulative) / bucketCounts[i]);
+        }
+        cumulative += bucketCounts[i];
+    }
+    return bucketBounds.empty() ? 0 : bucketBounds.back();
+}
+
+static void printPercentiles(std::ostream& out, const std::string& name, uint64_t p50, uint64_t p90, uint64_t p99) {
+    out << "  " << std::left << std::setw(32) << name << std::right
+        << " p50: " << std::setw(10) << p50 / 1000.0
+        << " p90: " << std::setw(10) << p90 / 1000.0
+        << " p99: " << std::setw(10) << p99 / 1000.0 << " ms" << std::endl;
+}
+
+void ServableBenchmark::report(std::ostream& out) const {
+    out << std::fixed << std::setprecision(3);
+    out << "Servable: " << servableName << ", concurrency: " << concurrency << ", duration: " << elapsed.count() / 1'000'000.0 << " s" << std::endl;
+    out << "Completed requests: " << getCompletedRequestsCount() << ", failed requests: " << getFailedRequestsCount();
+    {
+        std::lock_guard<std::mutex> lock(errorMtx);
+        if (!lastError.ok()) {
+            out << ", last error: " << lastError.string();
+        }
+    }
+    out << std::endl;
+    out << "Throughput: " << getThroughput() << " requests/s" << std::endl;
+    out << "Latency, stages estimated from metrics histograms:" << std::endl;
+    printPercentiles(out, "end-to-end", getLatencyPercentileUs(50), getLatencyPercentileUs(90), getLatencyPercentileUs(99));
+    for (const auto& stage : stages) {
+        const auto& bounds = stage.histogram->getBucketBounds();
+        printPercentiles(out, stage.name, estimatePercentile(bounds, stage.counts, 50),
+            estimatePercentile(bounds, stage.counts, 90), estimatePercentile(bounds, stage.counts, 99));
+    }
+    out << "Infer requests utilization:" << std::endl;
+    for (const auto& utilization : utilizations) {
+        const double ratio = utilization.totalSum == 0 ? 0 : 100.0 * utilization.inUseSum / utilization.totalSum;
+        out << "  " << utilization.name << " version " << utilization.version << ": " << std::setprecision(1) << ratio << "%" << std::setprecision(3) << std::endl;
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,134 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "metrics.hpp"
+#include "status.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+class ModelManager;
+
+/**
+ * @brief Drives model or pipeline served by ModelManager in-process, without network and client overhead
+ *
+ * Concurrent workers send requests with synthetic inputs built from servable inputs info until the duration passes.
+ * End-to-end latency of each request is measured exactly. Stage latencies are estimated from difference of stage
+ * histograms reported at metrics endpoint: model stages for a model, node stages for a pipeline.
+ * Utilization of infer requests of models involved is sampled while requests are sent.
+ */
+class ServableBenchmark {
+public:
+    static constexpr std::chrono::milliseconds UTILIZATION_SAMPLING_INTERVAL{10};
+
+    ServableBenchmark(ModelManager& manager, const std::string& servableName, uint32_t concurrency, std::chrono::milliseconds duration);
+
+    /**
+     * @brief Sends requests until the duration passes
+     *
+     * @return error if servable does not exist or synthetic request cannot be built for its inputs
+     */
+    Status run();
+
+    /**
+     * @brief Prints throughput, latency percentiles and infer requests utilization of the last run
+     */
+    void report(std::ostream& out) const;
+
+    uint64_t getCompletedRequestsCount() const {
+        return latenciesUs.size();
+    }
+
+    uint64_t getFailedRequestsCount() const {
+        return failedRequestsCount;
+    }
+
+    double getThroughput() const;
+
+    /**
+     * @brief Gets end-to-end latency percentile of completed requests, in microseconds
+     */
+    uint64_t getLatencyPercentileUs(double percentile) const;
+
+    /**
+     * @brief Estimates percentile of observations counted by histogram buckets, interpolating within bucket
+     *
+     * @param bucketBounds upper bounds of buckets
+     * @param bucketCounts counts of buckets, the last one counts observations above all bounds
+     * @param percentile from 0 to 100
+     * @return 0 if there are no observations, the last bound if percentile falls above all bounds
+     */
+    static uint64_t estimatePercentile(const std::vector<uint64_t>& bucketBounds, const std::vector<uint64_t>& bucketCounts, double percentile);
+
+    /**
+     * @brief Builds request with zero-filled inputs, dimensions not known before inference are sent as 1
+     */
+    static Status prepareRequest(const std::string& servableName, const tensor_map_t& inputsInfo, tensorflow::serving::PredictRequest& request);
+
+private:
+    struct Stage {
+        std::string name;
+        Histogram* histogram;
+        std::vector<uint64_t> startCounts;
+        std::vector<uint64_t> counts;
+    };
+
+    struct ModelUtilization {
+        std::string name;
+        int64_t version;
+        Gauge* inUse;
+        Gauge* total;
+        uint64_t inUseSum = 0;
+        uint64_t totalSum = 0;
+    };
+
+    ModelManager& manager;
+    const std::string servableName;
+    const uint32_t concurrency;
+    const std::chrono::milliseconds duration;
+
+    tensorflow::serving::PredictRequest request;
+    std::vector<Stage> stages;
+    std::vector<ModelUtilization> utilizations;
+
+    std::vector<uint64_t> latenciesUs;
+    std::atomic<uint64_t> failedRequestsCount{0};
+    mutable std::mutex errorMtx;
+    Status lastError;
+    std::chrono::microseconds elapsed{0};
+
+    Status prepareModel(const std::string& name);
+    Status preparePipeline(const std::string& name);
+    void addModelUtilization(const std::string& name, int64_t version);
+    Status sendRequest();
+    void runWorker(std::chrono::steady_clock::time_point end, std::vector<uint64_t>& latencies);
+};
+
+}  // namespace ovms
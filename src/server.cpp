@@ -13,10 +13,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <grpcpp/security/server_credentials.h>
@@ -29,14 +32,29 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "binaryutils.hpp"
+#include "compilation_pool.hpp"
 #include "config.hpp"
+#include "cpu_budget.hpp"
+#include "critical_path.hpp"
+#include "deserialization.hpp"
+#include "device_placement.hpp"
+#include "fair_share_scheduler.hpp"
 #include "http_server.hpp"
+#include "kfs_grpc_inference_service.hpp"
 #include "logging.hpp"
 #include "model_service.hpp"
 #include "modelmanager.hpp"
 #include "prediction_service.hpp"
+#include "residency.hpp"
+#include "servable_benchmark.hpp"
+#include "slow_requests.hpp"
 #include "stringutils.hpp"
+#include "tensor_buffer_pool.hpp"
+#include "tracing.hpp"
+#include "traffic_capture.hpp"
 #include "version.hpp"
+#include "workerpool.hpp"
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -59,6 +77,15 @@ uint getGRPCServersCount() {
     return std::max<uint>(1, ovms::Config::instance().grpcWorkers());
 }
 
+uint getGRPCCompletionQueuesCount(uint grpcServersCount) {
+    auto completionQueues = ovms::Config::instance().grpcCompletionQueues();
+    if (completionQueues > 0) {
+        return completionQueues;
+    }
+    // one completion queue per core, shared by all gRPC servers
+    return std::max<uint>(1, std::thread::hardware_concurrency() / std::max<uint>(1, grpcServersCount));
+}
+
 bool isPortAvailable(uint64_t port) {
     struct sockaddr_in addr;
     int s = socket(AF_INET, SOCK_STREAM, 0);
@@ -125,13 +152,23 @@ void logConfig(Config& config) {
     SPDLOG_DEBUG("REST port: {}", config.restPort());
     SPDLOG_DEBUG("gRPC bind address: {}", config.grpcBindAddress());
     SPDLOG_DEBUG("REST bind address: {}", config.restBindAddress());
+    SPDLOG_DEBUG("gRPC unix socket: {}", config.grpcUnixSocket());
+    SPDLOG_DEBUG("REST unix socket: {}", config.restUnixSocket());
     SPDLOG_DEBUG("REST workers: {}", config.restWorkers());
     SPDLOG_DEBUG("gRPC workers: {}", config.grpcWorkers());
+    SPDLOG_DEBUG("gRPC completion queues: {}", config.grpcCompletionQueues());
+    SPDLOG_DEBUG("gRPC max pollers: {}", config.grpcMaxPollers());
+    SPDLOG_DEBUG("frontend CPU affinity: {}", config.frontendCpuAffinity());
+    SPDLOG_DEBUG("background CPU affinity: {}", config.backgroundCpuAffinity());
     SPDLOG_DEBUG("gRPC channel arguments: {}", config.grpcChannelArguments());
     SPDLOG_DEBUG("log level: {}", config.logLevel());
     SPDLOG_DEBUG("log path: {}", config.logPath());
+    SPDLOG_DEBUG("log queue size: {}", config.logQueueSize());
+    SPDLOG_DEBUG("log rate limit: {}", config.logRateLimit());
     SPDLOG_DEBUG("file system poll wait seconds: {}", config.filesystemPollWaitSeconds());
     SPDLOG_DEBUG("sequence cleaner poll wait minutes: {}", config.sequenceCleanerPollWaitMinutes());
+    SPDLOG_DEBUG("trace export path: {}", config.traceExportPath());
+    SPDLOG_DEBUG("trace sampling ratio: {}", config.traceSamplingRatio());
 }
 
 void onInterrupt(int status) {
@@ -164,11 +201,31 @@ void installSignalHandlers() {
     sigemptyset(&sigIllHandler.sa_mask);
     sigIllHandler.sa_flags = 0;
     sigaction(SIGILL, &sigIllHandler, NULL);
+
+    static struct sigaction sigUser1Handler;
+    sigUser1Handler.sa_handler = on_debug_log_level_toggle_signal;
+    sigemptyset(&sigUser1Handler.sa_mask);
+    sigUser1Handler.sa_flags = 0;
+    sigaction(SIGUSR1, &sigUser1Handler, NULL);
+}
+
+static grpc_compression_level getGrpcCompressionLevel(const std::string& level) {
+    if (level == "low") {
+        return GRPC_COMPRESS_LEVEL_LOW;
+    }
+    if (level == "medium") {
+        return GRPC_COMPRESS_LEVEL_MED;
+    }
+    if (level == "high") {
+        return GRPC_COMPRESS_LEVEL_HIGH;
+    }
+    return GRPC_COMPRESS_LEVEL_NONE;
 }
 
 std::vector<std::unique_ptr<Server>> startGRPCServer(
     PredictionServiceImpl& predict_service,
-    ModelServiceImpl& model_service) {
+    ModelServiceImpl& model_service,
+    KFSInferenceServiceImpl& kfs_service) {
     const int GIGABYTE = 1024 * 1024 * 1024;
 
     std::vector<GrpcChannelArgument> channel_arguments;
@@ -179,20 +236,18 @@ std::vector<std::unique_ptr<Server>> startGRPCServer(
         exit(1);
     }
 
-    logConfig(config);
-    auto& manager = ModelManager::getInstance();
-    status = manager.start();
-    if (!status.ok()) {
-        SPDLOG_ERROR("ovms::ModelManager::Start() Error: {}", status.string());
-        exit(1);
-    }
-
     ServerBuilder builder;
     builder.SetMaxReceiveMessageSize(GIGABYTE);
     builder.SetMaxSendMessageSize(GIGABYTE);
-    builder.AddListeningPort(config.grpcBindAddress() + ":" + std::to_string(config.port()), grpc::InsecureServerCredentials());
+    builder.SetDefaultCompressionLevel(getGrpcCompressionLevel(config.grpcCompressionLevel()));
+    // port 0 with unix socket set disables TCP listener, otherwise gRPC picks free port
+    const bool listenOnTcp = config.port() != 0 || config.grpcUnixSocket().empty();
+    if (listenOnTcp) {
+        builder.AddListeningPort(config.grpcBindAddress() + ":" + std::to_string(config.port()), grpc::InsecureServerCredentials());
+    }
     builder.RegisterService(&predict_service);
     builder.RegisterService(&model_service);
+    builder.RegisterService(&kfs_service);
     for (const GrpcChannelArgument& channel_argument : channel_arguments) {
         // gRPC accept arguments of two types, int and string. We will attempt to
         // parse each arg as int and pass it on as such if successful. Otherwise we
@@ -210,76 +265,208 @@ std::vector<std::unique_ptr<Server>> startGRPCServer(
 
     std::vector<std::unique_ptr<Server>> servers;
     uint grpcServersCount = getGRPCServersCount();
+    if (!listenOnTcp && grpcServersCount > 1) {
+        // unix socket path is bound by single server, other servers would not accept any connection
+        SPDLOG_WARN("gRPC listens only on unix socket {}, starting single gRPC server instead of {}", config.grpcUnixSocket(), grpcServersCount);
+        grpcServersCount = 1;
+    }
     servers.reserve(grpcServersCount);
-    SPDLOG_DEBUG("Starting grpc servers: {}", grpcServersCount);
+    uint completionQueuesCount = getGRPCCompletionQueuesCount(grpcServersCount);
+    builder.SetSyncServerOption(ServerBuilder::SyncServerOption::NUM_CQS, completionQueuesCount);
+    if (config.grpcMaxPollers() > 0) {
+        builder.SetSyncServerOption(ServerBuilder::SyncServerOption::MIN_POLLERS, 1);
+        builder.SetSyncServerOption(ServerBuilder::SyncServerOption::MAX_POLLERS, config.grpcMaxPollers());
+    }
+    SPDLOG_DEBUG("Starting grpc servers: {} with {} completion queues each", grpcServersCount, completionQueuesCount);
 
-    if (!isPortAvailable(config.port())) {
+    if (listenOnTcp && !isPortAvailable(config.port())) {
         throw std::runtime_error("Failed to start GRPC server at " + config.grpcBindAddress() + ":" + std::to_string(config.port()));
     }
     for (uint i = 0; i < grpcServersCount; ++i) {
+        // binding unix socket replaces the socket file, so only the last server listens on it
+        if (i + 1 == grpcServersCount && !config.grpcUnixSocket().empty()) {
+            builder.AddListeningPort(UNIX_SOCKET_ADDRESS_PREFIX + config.grpcUnixSocket(), grpc::InsecureServerCredentials());
+        }
         std::unique_ptr<Server> server = builder.BuildAndStart();
         if (server == nullptr) {
             throw std::runtime_error("Failed to start GRPC server at " + std::to_string(config.port()));
         }
         servers.push_back(std::move(server));
     }
-    SPDLOG_INFO("Server started on port {}", config.port());
+    if (listenOnTcp) {
+        SPDLOG_INFO("Server started on port {}", config.port());
+    }
+    if (!config.grpcUnixSocket().empty()) {
+        SPDLOG_INFO("Server started on unix socket {}", config.grpcUnixSocket());
+    }
 
     return servers;
 }
 
-std::unique_ptr<ovms::http_server> startRESTServer() {
+std::vector<std::unique_ptr<ovms::http_server>> startRESTServers() {
     auto& config = ovms::Config::instance();
+    std::vector<std::unique_ptr<ovms::http_server>> restServers;
+    int workers = config.restWorkers() ? config.restWorkers() : 10;
+    // unix socket server is separate, as net_http server listens on single socket
     if (config.restPort() != 0) {
         const std::string server_address = config.restBindAddress() + ":" + std::to_string(config.restPort());
+        // each reactor runs its own accept and IO event loop, the kernel spreads connections between them
+        const int reactors = config.restReactors();
+        const int reactorWorkers = std::max(1, (workers + reactors - 1) / reactors);
+
+        SPDLOG_INFO("Will start {} REST workers in {} reactors", reactorWorkers * reactors, reactors);
+
+        for (int i = 0; i < reactors; ++i) {
+            std::unique_ptr<ovms::http_server> restServer = ovms::createAndStartHttpServer(config.restBindAddress(), config.restPort(), reactorWorkers,
+                config.restMaxBodySizeMb() * 1024 * 1024, config.restCompressionLevel(), config.restCompressionMinSize(), -1, config.frontendCpus(),
+                reactors > 1);
+            if (restServer != nullptr) {
+                SPDLOG_INFO("Started REST server at {}", server_address);
+            } else {
+                throw std::runtime_error("Failed to start REST server at " + server_address);
+            }
+
+            restServers.push_back(std::move(restServer));
+        }
+    }
+    if (!config.restUnixSocket().empty()) {
+        const std::string server_address = UNIX_SOCKET_ADDRESS_PREFIX + config.restUnixSocket();
 
-        int workers = config.restWorkers() ? config.restWorkers() : 10;
-        SPDLOG_INFO("Will start {} REST workers", workers);
+        SPDLOG_INFO("Will start {} REST workers for unix socket", workers);
 
-        std::unique_ptr<ovms::http_server> restServer = ovms::createAndStartHttpServer(config.restBindAddress(), config.restPort(), workers);
+        std::unique_ptr<ovms::http_server> restServer = ovms::createAndStartHttpServer(server_address, 0, workers,
+            config.restMaxBodySizeMb() * 1024 * 1024, config.restCompressionLevel(), config.restCompressionMinSize(), -1, config.frontendCpus());
         if (restServer != nullptr) {
             SPDLOG_INFO("Started REST server at {}", server_address);
         } else {
             throw std::runtime_error("Failed to start REST server at " + server_address);
         }
 
-        return restServer;
+        restServers.push_back(std::move(restServer));
     }
 
-    return nullptr;
+    return restServers;
+}
+
+int runBenchmark() {
+    auto& config = ovms::Config::instance();
+    logConfig(config);
+    auto& manager = ModelManager::getInstance();
+    auto status = manager.start();
+    if (!status.ok()) {
+        SPDLOG_ERROR("ovms::ModelManager::Start() Error: {}", status.string());
+        return EXIT_FAILURE;
+    }
+    ServableBenchmark benchmark(manager, config.benchmarkServable(), config.benchmarkConcurrency(),
+        std::chrono::seconds(config.benchmarkDurationSeconds()));
+    status = benchmark.run();
+    if (status.ok()) {
+        benchmark.report(std::cout);
+    }
+    const auto placementDevices = config.benchmarkPlacementDevices();
+    if (status.ok() && !placementDevices.empty()) {
+        // 1 MB/s is 1 byte per microsecond
+        DevicePlacementProfiler placement(manager, config.benchmarkServable(), placementDevices, config.benchmarkPlacementIterations(),
+            config.benchmarkPlacementTransferBandwidth());
+        status = placement.run();
+        if (status.ok()) {
+            placement.report(std::cout);
+        } else {
+            SPDLOG_ERROR("Cannot plan device placement of pipeline: {}; {}", config.benchmarkServable(), status.string());
+        }
+    }
+    manager.join();
+    return status.ok() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 int server_main(int argc, char** argv) {
     installSignalHandlers();
     try {
         auto& config = ovms::Config::instance().parse(argc, argv);
-        configure_logger(config.logLevel(), config.logPath());
+        const auto backgroundCpus = config.backgroundCpus();
+        // asynchronous logging thread inherits affinity of the thread creating it
+        WorkerPool::runPinned(backgroundCpus, [&config]() {
+            configure_logger(config.logLevel(), config.logPath(), config.logQueueSize(), config.logRateLimit());
+        });
+        setImageDecodeWorkers(config.imageDecodeWorkers());
+        setDeserializationWorkers(config.deserializationWorkers(), config.deserializationParallelMinBytes());
+        if (!loadImageDecoderLibrary(config.imageDecoderLibrary()).ok()) {
+            return EXIT_FAILURE;
+        }
+        FairShareScheduler::instance().setCapacity(config.maxConcurrentInferences());
+        SlowRequestsLog::instance().setCapacity(config.slowRequestsLogSize());
+        CriticalPathAnalyzer::setSamplingInterval(config.pipelineCriticalPathSamplingInterval());
+        CpuBudget::instance().setBudget(config.cpuThreadsBudget(), config.cpuStreamsBudget());
+        CompilationPool::instance().configure(config.compilationWorkers(), config.compilationNice(), backgroundCpus);
+        const HugePages hugePages = config.tensorBufferHugePages() == "explicit" ? HugePages::EXPLICIT : config.tensorBufferHugePages() == "transparent" ? HugePages::TRANSPARENT : HugePages::NONE;
+        // with pooling disabled the pool still allocates buffers backed by huge pages or locked in RAM
+        if (config.tensorBufferPoolSizeMb() > 0 || hugePages != HugePages::NONE || config.tensorBufferLockMemory()) {
+            TensorBufferPool::setGlobal(std::make_shared<TensorBufferPool>(config.tensorBufferPoolSizeMb() * 1024 * 1024,
+                config.tensorBufferPoolMaxBufferMb() * 1024 * 1024, &MetricRegistry::getInstance(), hugePages, config.tensorBufferLockMemory()));
+        }
+        if (!config.traceExportPath().empty()) {
+            Tracer::instance().start(config.traceExportPath(), config.traceSamplingRatio());
+        }
+        if (!config.trafficCapturePath().empty() && !TrafficCapture::instance().start(config.trafficCapturePath(), config.trafficCaptureSamplingRatio())) {
+            Tracer::instance().stop();
+            return EXIT_FAILURE;
+        }
+
+        if (config.benchmark()) {
+            auto result = runBenchmark();
+            TrafficCapture::instance().stop();
+            Tracer::instance().stop();
+            return result;
+        }
 
         PredictionServiceImpl predict_service;
         ModelServiceImpl model_service;
+        KFSInferenceServiceImpl kfs_service;
 
-        auto grpc = startGRPCServer(predict_service, model_service);
-        auto rest = startRESTServer();
+        // frontends serve models as soon as they are loaded, readiness is reported until the whole config is loaded
+        logConfig(config);
+        if (!config.residencyServerId().empty()) {
+            ResidencyAdvertiser::instance().setServerId(config.residencyServerId());
+        }
+        auto grpc = startGRPCServer(predict_service, model_service, kfs_service);
+        auto rest = startRESTServers();
+        auto status = ModelManager::getInstance().start();
+        if (!status.ok()) {
+            SPDLOG_ERROR("ovms::ModelManager::Start() Error: {}", status.string());
+            shutdown_request = 1;
+        } else if (!config.residencyPushUrl().empty()) {
+            ResidencyAdvertiser::instance().start(ModelManager::getInstance(), config.residencyPushUrl(),
+                std::chrono::milliseconds(config.residencyPushIntervalMs()));
+        }
 
         while (!shutdown_request) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
+            if (apply_debug_log_level_toggle_request()) {
+                SPDLOG_WARN("Log level toggled by SIGUSR1");
+            }
         }
         if (shutdown_request == 2) {
             SPDLOG_ERROR("Illegal operation. OVMS started on unsupported device");
         }
         SPDLOG_INFO("Shutting down");
+        ResidencyAdvertiser::instance().stop();
         for (const auto& g : grpc) {
             g->Shutdown();
             SPDLOG_INFO("Shutdown gRPC server");
         }
 
-        if (rest != nullptr) {
-            rest->Terminate();
-            rest->WaitForTermination();
+        for (const auto& r : rest) {
+            r->Terminate();
+            r->WaitForTermination();
             SPDLOG_INFO("Shutdown HTTP server");
         }
 
         ModelManager::getInstance().join();
+        TrafficCapture::instance().stop();
+        Tracer::instance().stop();
+        if (!status.ok()) {
+            return EXIT_FAILURE;
+        }
     } catch (std::exception& e) {
         SPDLOG_ERROR("Exception catch: {} - will now terminate.", e.what());
         return EXIT_FAILURE;
@@ -0,0 +1,64 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace ovms {
+
+/**
+ * @brief Response of metadata or status call together with its JSON serialization
+ */
+template <typename Response>
+struct CachedServiceResponse {
+    uint64_t key;
+    Response response;
+    std::string json;
+};
+
+/**
+ * @brief Keeps last built response of metadata or status call of one servable
+ *
+ * Entry is valid as long as key it was built for is current, key is read before the response is built
+ * so that response built while servable changes is never returned.
+ */
+template <typename Response>
+class ServiceResponseCache {
+    std::shared_ptr<const CachedServiceResponse<Response>> entry;
+
+public:
+    /**
+     * @return entry built for key or nullptr
+     */
+    std::shared_ptr<const CachedServiceResponse<Response>> find(uint64_t key) const {
+        auto current = std::atomic_load(&entry);
+        if (current && current->key == key) {
+            return current;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<const CachedServiceResponse<Response>> insert(uint64_t key, Response response, std::string json) {
+        auto built = std::make_shared<const CachedServiceResponse<Response>>(CachedServiceResponse<Response>{key, std::move(response), std::move(json)});
+        std::atomic_store(&entry, built);
+        return built;
+    }
+};
+
+}  // namespace ovms
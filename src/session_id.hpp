@@ -15,10 +15,10 @@
 //*****************************************************************************
 #pragma once
 
-#include <string>
+#include <cstdint>
 
 namespace ovms {
 
 using session_id_t = uint32_t;
-using session_key_t = std::string;
+using session_key_t = uint64_t;
 }  // namespace ovms
@@ -0,0 +1,52 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "shape_bucket_cache.hpp"
+
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+std::shared_ptr<ShapeBucket> ShapeBucketCache::find(const std::map<std::string, shape_t>& shapes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = buckets.begin(); it != buckets.end(); ++it) {
+        if ((*it)->shapes == shapes) {
+            buckets.splice(buckets.begin(), buckets, it);
+            return buckets.front();
+        }
+    }
+    return nullptr;
+}
+
+void ShapeBucketCache::insert(std::shared_ptr<ShapeBucket> bucket) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0) {
+        return;
+    }
+    while (buckets.size() >= capacity) {
+        SPDLOG_DEBUG("Evicting least recently used shape bucket from cache of size: {}", capacity);
+        buckets.pop_back();
+    }
+    buckets.push_front(std::move(bucket));
+}
+
+size_t ShapeBucketCache::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buckets.size();
+}
+
+}  // namespace ovms
@@ -0,0 +1,82 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <inference_engine.hpp>
+
+#include "ovinferrequestsqueue.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Executable network compiled for input shapes other than the ones of the model instance
+ *
+ * Holds its own infer requests and tensor information matching the compiled shapes.
+ */
+struct ShapeBucket {
+    std::map<std::string, shape_t> shapes;
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> execNetwork;
+    // declared after execNetwork so that infer requests are released first
+    std::unique_ptr<OVInferRequestsQueue> inferRequestsQueue;
+    tensor_map_t inputsInfo;
+    tensor_map_t outputsInfo;
+};
+
+/**
+ * @brief Bounded least recently used cache of shape buckets keyed by request input shapes
+ *
+ * Buckets are shared so that evicted ones stay valid until in-flight requests finish.
+ */
+class ShapeBucketCache {
+    const size_t capacity;
+    std::mutex mutex;
+    // most recently used bucket first
+    std::list<std::shared_ptr<ShapeBucket>> buckets;
+
+public:
+    explicit ShapeBucketCache(size_t capacity) :
+        capacity(capacity) {}
+
+    /**
+     * @brief Finds bucket compiled for the shapes and marks it as most recently used
+     *
+     * @param shapes request input shapes
+     *
+     * @return bucket or nullptr if not cached
+     */
+    std::shared_ptr<ShapeBucket> find(const std::map<std::string, shape_t>& shapes);
+
+    /**
+     * @brief Inserts bucket evicting the least recently used one when cache is full
+     *
+     * @param bucket
+     */
+    void insert(std::shared_ptr<ShapeBucket> bucket);
+
+    size_t size();
+
+    size_t getCapacity() const {
+        return capacity;
+    }
+};
+}  // namespace ovms
@@ -0,0 +1,119 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "shape_histogram.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace ovms {
+
+uint64_t ShapeHistogram::record(const shapes_t& shapes) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = counts.find(shapes);
+        if (it != counts.end()) {
+            ++it->second;
+        } else if (counts.size() < MAX_SHAPES) {
+            counts.emplace(shapes, 1);
+        }
+    }
+    return requests.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+std::vector<std::pair<ShapeHistogram::shapes_t, uint64_t>> ShapeHistogram::getMostFrequent(size_t count) const {
+    std::vector<std::pair<shapes_t, uint64_t>> result;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        result.assign(counts.begin(), counts.end());
+    }
+    std::stable_sort(result.begin(), result.end(), [](const auto& left, const auto& right) { return left.second > right.second; });
+    if (result.size() > count) {
+        result.resize(count);
+    }
+    return result;
+}
+
+std::map<size_t, uint64_t> ShapeHistogram::getDimensionHistogram(const std::string& input, size_t dimension) const {
+    std::map<size_t, uint64_t> sizes;
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto& [shapes, count] : counts) {
+        auto it = shapes.find(input);
+        if (it != shapes.end() && it->second.size() > dimension) {
+            sizes[it->second[dimension]] += count;
+        }
+    }
+    return sizes;
+}
+
+std::vector<size_t> ShapeHistogram::proposePaddedBuckets(const std::map<size_t, uint64_t>& sizes, size_t maxBuckets, uint64_t& paddedElements) {
+    paddedElements = 0;
+    if (sizes.empty() || maxBuckets == 0) {
+        return {};
+    }
+    std::vector<size_t> values;
+    // prefix sums of counts and of sizes weighted by counts
+    std::vector<uint64_t> countSums{0};
+    std::vector<uint64_t> sizeSums{0};
+    for (const auto& [size, count] : sizes) {
+        values.push_back(size);
+        countSums.push_back(countSums.back() + count);
+        sizeSums.push_back(sizeSums.back() + size * count);
+    }
+    const size_t n = values.size();
+    const size_t buckets = std::min(maxBuckets, n);
+    // padding of sizes from first to last up to the last one
+    const auto padding = [&](size_t first, size_t last) {
+        return values[last] * (countSums[last + 1] - countSums[first]) - (sizeSums[last + 1] - sizeSums[first]);
+    };
+    constexpr uint64_t UNREACHABLE = std::numeric_limits<uint64_t>::max();
+    // cost[b][j] - least padding of sizes up to j with b + 1 buckets, the last of them at j
+    std::vector<std::vector<uint64_t>> cost(buckets, std::vector<uint64_t>(n, UNREACHABLE));
+    std::vector<std::vector<size_t>> previous(buckets, std::vector<size_t>(n, 0));
+    for (size_t j = 0; j < n; ++j) {
+        cost[0][j] = padding(0, j);
+    }
+    for (size_t b = 1; b < buckets; ++b) {
+        for (size_t j = b; j < n; ++j) {
+            for (size_t i = b - 1; i < j; ++i) {
+                if (cost[b - 1][i] == UNREACHABLE) {
+                    continue;
+                }
+                const uint64_t candidate = cost[b - 1][i] + padding(i + 1, j);
+                if (candidate < cost[b][j]) {
+                    cost[b][j] = candidate;
+                    previous[b][j] = i;
+                }
+            }
+        }
+    }
+    size_t used = 0;
+    for (size_t b = 1; b < buckets; ++b) {
+        if (cost[b][n - 1] < cost[used][n - 1]) {
+            used = b;
+        }
+    }
+    paddedElements = cost[used][n - 1];
+    std::vector<size_t> result;
+    size_t last = n - 1;
+    for (size_t b = used + 1; b-- > 0;) {
+        result.push_back(values[last]);
+        last = previous[b][last];
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace ovms
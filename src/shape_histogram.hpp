@@ -0,0 +1,80 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Counts input shapes of requests to model version
+ *
+ * Counts of at most MAX_SHAPES distinct sets of input shapes are kept, requests with other shapes once the limit
+ * is reached are only counted in total.
+ */
+class ShapeHistogram {
+public:
+    static constexpr size_t MAX_SHAPES = 64;
+    static constexpr size_t DEFAULT_PADDED_BUCKETS = 4;
+
+    using shapes_t = std::map<std::string, shape_t>;
+
+    /**
+     * @return number of requests recorded so far, including this one
+     */
+    uint64_t record(const shapes_t& shapes);
+
+    uint64_t getRequests() const {
+        return requests.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns tracked sets of input shapes with their request counts, the most frequent first
+     */
+    std::vector<std::pair<shapes_t, uint64_t>> getMostFrequent(size_t count = MAX_SHAPES) const;
+
+    /**
+     * @brief Returns request counts by size of dimension of input, over tracked shapes
+     */
+    std::map<size_t, uint64_t> getDimensionHistogram(const std::string& input, size_t dimension) const;
+
+    /**
+     * @brief Chooses at most maxBuckets of sizes, so that padding each size up to the nearest bucket adds the fewest elements
+     *
+     * Buckets are chosen by dynamic programming over sorted sizes, the largest size is always a bucket.
+     *
+     * @param sizes request counts by size
+     * @param paddedElements set to sum of padding added to requests
+     *
+     * @return buckets in increasing order
+     */
+    static std::vector<size_t> proposePaddedBuckets(const std::map<size_t, uint64_t>& sizes, size_t maxBuckets, uint64_t& paddedElements);
+
+private:
+    mutable std::mutex mtx;
+    std::map<shapes_t, uint64_t> counts;
+    std::atomic<uint64_t> requests{0};
+};
+
+}  // namespace ovms
@@ -0,0 +1,262 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "shared_memory.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "stringutils.hpp"
+
+namespace ovms {
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+}
+
+Status SharedMemoryRegion::map(size_t offset) {
+    int fd = shm_open(key.c_str(), O_RDWR, 0);
+    if (fd == -1) {
+        SPDLOG_WARN("Failed to open shared memory object: {}; error: {}", key, std::strerror(errno));
+        return StatusCode::SHARED_MEMORY_MAPPING_FAILED;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || static_cast<size_t>(fileStat.st_size) < offset + byteSize) {
+        SPDLOG_WARN("Shared memory object: {} is smaller than registered range; offset: {}; byte size: {}", key, offset, byteSize);
+        close(fd);
+        return StatusCode::SHARED_MEMORY_MAPPING_FAILED;
+    }
+    // mapping has to start at page boundary
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t mappingOffset = offset - offset % pageSize;
+    mappingSize = byteSize + (offset - mappingOffset);
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, mappingOffset);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        SPDLOG_WARN("Failed to map shared memory object: {}; error: {}", key, std::strerror(errno));
+        return StatusCode::SHARED_MEMORY_MAPPING_FAILED;
+    }
+    data = static_cast<char*>(mapping) + (offset - mappingOffset);
+    return StatusCode::OK;
+}
+
+Status SharedMemoryRegion::getRange(uint64_t offset, size_t size, char*& rangeData) const {
+    if (offset > byteSize || size > byteSize - offset) {
+        std::stringstream ss;
+        ss << "Region: " << name << " of " << byteSize << " bytes; Requested: " << size << " bytes at offset " << offset;
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Shared memory range out of region - {}", details);
+        return Status(StatusCode::INVALID_CONTENT_SIZE, details);
+    }
+    rangeData = data + offset;
+    return StatusCode::OK;
+}
+
+Status SharedMemoryRegistry::registerRegion(const std::string& name, const std::string& key, size_t offset, size_t byteSize) {
+    if (name.empty() || key.empty() || byteSize == 0) {
+        return StatusCode::SHARED_MEMORY_MAPPING_FAILED;
+    }
+    if (isRequestRegionName(name)) {
+        SPDLOG_WARN("Shared memory region name: {} is reserved for server", name);
+        return StatusCode::SHARED_MEMORY_MAPPING_FAILED;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (regions.count(name)) {
+            SPDLOG_WARN("Shared memory region: {} is already registered", name);
+            return StatusCode::SHARED_MEMORY_REGION_ALREADY_REGISTERED;
+        }
+    }
+    auto region = std::make_shared<SharedMemoryRegion>(name, key, byteSize);
+    auto status = region->map(offset);
+    if (!status.ok()) {
+        return status;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!regions.emplace(name, std::move(region)).second) {
+        SPDLOG_WARN("Shared memory region: {} is already registered", name);
+        return StatusCode::SHARED_MEMORY_REGION_ALREADY_REGISTERED;
+    }
+    SPDLOG_INFO("Registered shared memory region: {}; key: {}; offset: {}; byte size: {}", name, key, offset, byteSize);
+    return StatusCode::OK;
+}
+
+Status SharedMemoryRegistry::registerRequestRegion(const std::string& name, char* data, size_t byteSize, std::shared_ptr<const void> owner) {
+    auto region = std::make_shared<SharedMemoryRegion>(name, data, byteSize, std::move(owner));
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!regions.emplace(name, std::move(region)).second) {
+        SPDLOG_WARN("Shared memory region: {} is already registered", name);
+        return StatusCode::SHARED_MEMORY_REGION_ALREADY_REGISTERED;
+    }
+    return StatusCode::OK;
+}
+
+Status SharedMemoryRegistry::unregisterRegion(const std::string& name) {
+    std::shared_ptr<SharedMemoryRegion> region;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = regions.find(name);
+        if (it == regions.end()) {
+            return StatusCode::SHARED_MEMORY_REGION_NOT_FOUND;
+        }
+        region = std::move(it->second);
+        regions.erase(it);
+    }
+    if (!isRequestRegionName(name)) {
+        SPDLOG_INFO("Unregistered shared memory region: {}", name);
+    }
+    return StatusCode::OK;
+}
+
+Status SharedMemoryRegistry::getRegion(const std::string& name, std::shared_ptr<SharedMemoryRegion>& region) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = regions.find(name);
+    if (it == regions.end()) {
+        SPDLOG_DEBUG("Shared memory region: {} is not registered", name);
+        return Status(StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, "Region: " + name);
+    }
+    region = it->second;
+    return StatusCode::OK;
+}
+
+size_t SharedMemoryRegistry::size() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return regions.size();
+}
+
+bool isSharedMemoryReference(const tensorflow::TensorProto& tensor) {
+    return tensor.resource_handle_val_size() == 1 &&
+           tensor.resource_handle_val(0).device() == SHARED_MEMORY_DEVICE;
+}
+
+bool isRequestRegionName(const std::string& name) {
+    return name.rfind(REQUEST_REGION_PREFIX, 0) == 0;
+}
+
+std::string generateRequestRegionName() {
+    static const uint64_t processId = std::random_device()();
+    static std::atomic<uint64_t> counter{0};
+    return std::string(REQUEST_REGION_PREFIX) + std::to_string(processId) + "/" + std::to_string(counter++);
+}
+
+bool hasSharedMemoryInputs(const tensorflow::serving::PredictRequest& request) {
+    for (const auto& [name, tensor] : request.inputs()) {
+        if (isSharedMemoryReference(tensor)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void setSharedMemoryReference(tensorflow::TensorProto& tensor, const std::string& regionName, uint64_t offset) {
+    tensor.clear_resource_handle_val();
+    auto handle = tensor.add_resource_handle_val();
+    handle->set_device(SHARED_MEMORY_DEVICE);
+    handle->set_name(regionName);
+    handle->set_hash_code(offset);
+}
+
+Status resolveSharedMemoryReference(const tensorflow::TensorProto& tensor, size_t byteSize,
+    std::shared_ptr<SharedMemoryRegion>& region, char*& data) {
+    const auto& handle = tensor.resource_handle_val(0);
+    auto status = SharedMemoryRegistry::getInstance().getRegion(handle.name(), region);
+    if (!status.ok()) {
+        return status;
+    }
+    return region->getRange(handle.hash_code(), byteSize, data);
+}
+
+Status validateSharedMemoryInput(const TensorInfo& networkInput, const tensorflow::TensorProto& requestInput, size_t expectedValueCount) {
+    const bool converted = networkInput.isConvertedFromDataType(requestInput.dtype());
+    if (requestInput.dtype() != networkInput.getPrecisionAsDataType() && !converted) {
+        std::stringstream ss;
+        ss << "Expected: " << networkInput.getPrecisionAsString()
+           << "; Actual: " << TensorInfo::getDataTypeAsString(requestInput.dtype()) << " in shared memory";
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Invalid precision - {}", details);
+        return Status(StatusCode::INVALID_PRECISION, details);
+    }
+    std::shared_ptr<SharedMemoryRegion> region;
+    char* data = nullptr;
+    const auto precision = converted ? networkInput.getRequestPrecision() : networkInput.getPrecision();
+    return resolveSharedMemoryReference(requestInput, expectedValueCount * precision.size(), region, data);
+}
+
+Status parseSharedMemoryOutputs(const std::string& value, shared_memory_outputs_t& outputs) {
+    outputs.clear();
+    for (auto& entry : tokenize(value, ',')) {
+        trim(entry);
+        if (entry.empty()) {
+            continue;
+        }
+        auto equalsPosition = entry.find('=');
+        auto colonPosition = entry.rfind(':');
+        if (equalsPosition == std::string::npos || colonPosition == std::string::npos || colonPosition < equalsPosition) {
+            SPDLOG_DEBUG("Invalid {} entry: {}", SHARED_MEMORY_OUTPUTS_HEADER, entry);
+            return Status(StatusCode::SHARED_MEMORY_INVALID_OUTPUTS, entry);
+        }
+        std::string outputName = entry.substr(0, equalsPosition);
+        std::string regionName = entry.substr(equalsPosition + 1, colonPosition - equalsPosition - 1);
+        auto offset = stou32(entry.substr(colonPosition + 1));
+        trim(outputName);
+        trim(regionName);
+        if (outputName.empty() || regionName.empty() || !offset || isRequestRegionName(regionName)) {
+            SPDLOG_DEBUG("Invalid {} entry: {}", SHARED_MEMORY_OUTPUTS_HEADER, entry);
+            return Status(StatusCode::SHARED_MEMORY_INVALID_OUTPUTS, entry);
+        }
+        outputs[outputName] = {regionName, offset.value()};
+    }
+    return StatusCode::OK;
+}
+
+Status writeOutputsToSharedMemory(const shared_memory_outputs_t& outputs, tensorflow::serving::PredictResponse& response) {
+    for (const auto& [outputName, regionOffset] : outputs) {
+        auto it = response.mutable_outputs()->find(outputName);
+        if (it == response.mutable_outputs()->end()) {
+            SPDLOG_DEBUG("Output: {} requested in shared memory is missing in response", outputName);
+            return Status(StatusCode::INVALID_MISSING_OUTPUT, "Required output: " + outputName);
+        }
+        auto& output = it->second;
+        std::shared_ptr<SharedMemoryRegion> region;
+        auto status = SharedMemoryRegistry::getInstance().getRegion(regionOffset.first, region);
+        if (!status.ok()) {
+            return status;
+        }
+        char* data = nullptr;
+        status = region->getRange(regionOffset.second, output.tensor_content().size(), data);
+        if (!status.ok()) {
+            return status;
+        }
+        std::memcpy(data, output.tensor_content().data(), output.tensor_content().size());
+        output.clear_tensor_content();
+        setSharedMemoryReference(output, regionOffset.first, regionOffset.second);
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,262 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Device of resource handle marking tensor which data is placed in registered shared memory region
+ *
+ * Tensor references the region with single resource_handle_val entry holding region name in name field
+ * and byte offset within the region in hash_code field. Byte size follows from tensor shape and dtype.
+ */
+constexpr const char* SHARED_MEMORY_DEVICE = "ovms_shm";
+
+/**
+ * @brief gRPC metadata or HTTP header requesting outputs to be written into shared memory
+ *
+ * Value is comma separated list of output=region:offset entries.
+ */
+constexpr const char* SHARED_MEMORY_OUTPUTS_HEADER = "ovms-shm-outputs";
+
+/**
+ * @brief Prefix of names of regions registered by the server for data of a single request
+ *
+ * Clients cannot register, reference or write outputs into such regions.
+ */
+constexpr const char* REQUEST_REGION_PREFIX = "ovms_request/";
+
+/**
+ * @brief POSIX shared memory object mapped into server address space
+ */
+class SharedMemoryRegion {
+    const std::string name;
+    const std::string key;
+    const size_t byteSize;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    char* data = nullptr;
+    // keeps memory of regions wrapping data of other objects alive
+    std::shared_ptr<const void> owner;
+
+public:
+    SharedMemoryRegion(const std::string& name, const std::string& key, size_t byteSize) :
+        name(name),
+        key(key),
+        byteSize(byteSize) {}
+
+    /**
+     * @brief Wraps memory owned by other object instead of mapping shared memory object
+     */
+    SharedMemoryRegion(const std::string& name, char* data, size_t byteSize, std::shared_ptr<const void> owner) :
+        name(name),
+        byteSize(byteSize),
+        data(data),
+        owner(std::move(owner)) {}
+    ~SharedMemoryRegion();
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    /**
+     * @brief Maps byteSize bytes of shared memory object starting at offset
+     *
+     * @param offset byte offset within shared memory object
+     *
+     * @return Status
+     */
+    Status map(size_t offset);
+
+    /**
+     * @brief Gets pointer to data range of the region
+     *
+     * @param offset
+     * @param size
+     * @param rangeData set to beginning of the range
+     *
+     * @return INVALID_CONTENT_SIZE if range exceeds the region
+     */
+    Status getRange(uint64_t offset, size_t size, char*& rangeData) const;
+
+    const std::string& getName() const {
+        return name;
+    }
+
+    const std::string& getKey() const {
+        return key;
+    }
+
+    size_t getByteSize() const {
+        return byteSize;
+    }
+};
+
+/**
+ * @brief Shared memory regions registered by co-located clients
+ *
+ * Regions are reference counted, so unregistering a region used by ongoing request
+ * unmaps it when the request completes.
+ */
+class SharedMemoryRegistry {
+    std::mutex mtx;
+    std::unordered_map<std::string, std::shared_ptr<SharedMemoryRegion>> regions;
+
+public:
+    static SharedMemoryRegistry& getInstance() {
+        static SharedMemoryRegistry instance;
+        return instance;
+    }
+
+    /**
+     * @brief Maps shared memory object under given region name
+     *
+     * @param name region name referenced by requests
+     * @param key name of POSIX shared memory object
+     * @param offset byte offset within shared memory object
+     * @param byteSize
+     *
+     * @return Status
+     */
+    Status registerRegion(const std::string& name, const std::string& key, size_t offset, size_t byteSize);
+
+    /**
+     * @brief Registers region wrapping memory owned by other object, used for data of single request
+     *
+     * @param name region name starting with REQUEST_REGION_PREFIX
+     * @param data
+     * @param byteSize
+     * @param owner kept alive as long as the region is used
+     *
+     * @return Status
+     */
+    Status registerRequestRegion(const std::string& name, char* data, size_t byteSize, std::shared_ptr<const void> owner);
+
+    Status unregisterRegion(const std::string& name);
+
+    Status getRegion(const std::string& name, std::shared_ptr<SharedMemoryRegion>& region);
+
+    size_t size();
+};
+
+/**
+ * @brief Keeps owner of wrapped data, like mapped shared memory region, alive for the lifetime of blob wrapping the data
+ */
+class SharedMemoryAllocator : public InferenceEngine::IAllocator {
+    std::shared_ptr<const void> owner;
+    char* data;
+
+public:
+    SharedMemoryAllocator(std::shared_ptr<const void> owner, char* data) :
+        owner(std::move(owner)),
+        data(data) {}
+
+    void* lock(void* handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void* a) noexcept override {}
+
+    void* alloc(size_t size) noexcept override {
+        return data;
+    }
+
+    bool free(void* handle) noexcept override {
+        return true;
+    }
+};
+
+bool isSharedMemoryReference(const tensorflow::TensorProto& tensor);
+
+bool isRequestRegionName(const std::string& name);
+
+/**
+ * @brief Generates unique name of request region, not predictable by clients
+ */
+std::string generateRequestRegionName();
+
+bool hasSharedMemoryInputs(const tensorflow::serving::PredictRequest& request);
+
+void setSharedMemoryReference(tensorflow::TensorProto& tensor, const std::string& regionName, uint64_t offset);
+
+/**
+ * @brief Resolves data of tensor placed in shared memory
+ *
+ * @param tensor tensor referencing shared memory region
+ * @param byteSize expected size of tensor data
+ * @param region set to referenced region, keeps it mapped
+ * @param data set to beginning of tensor data
+ *
+ * @return Status
+ */
+Status resolveSharedMemoryReference(const tensorflow::TensorProto& tensor, size_t byteSize,
+    std::shared_ptr<SharedMemoryRegion>& region, char*& data);
+
+/**
+ * @brief Validates tensor placed in shared memory against network input
+ *
+ * Data has to be in network input precision or in request precision converted to it.
+ *
+ * @param networkInput
+ * @param requestInput
+ * @param expectedValueCount number of values following from request shape
+ *
+ * @return Status
+ */
+Status validateSharedMemoryInput(const TensorInfo& networkInput, const tensorflow::TensorProto& requestInput, size_t expectedValueCount);
+
+using shared_memory_outputs_t = std::map<std::string, std::pair<std::string, uint64_t>>;
+
+/**
+ * @brief Parses value of SHARED_MEMORY_OUTPUTS_HEADER
+ *
+ * @param value
+ * @param outputs maps output name to region name and offset
+ *
+ * @return Status
+ */
+Status parseSharedMemoryOutputs(const std::string& value, shared_memory_outputs_t& outputs);
+
+/**
+ * @brief Moves tensor_content of requested response outputs into shared memory regions
+ *
+ * Outputs keep dtype and shape and reference the region instead of carrying data.
+ *
+ * @param outputs
+ * @param response
+ *
+ * @return Status
+ */
+Status writeOutputsToSharedMemory(const shared_memory_outputs_t& outputs, tensorflow::serving::PredictResponse& response);
+
+}  // namespace ovms
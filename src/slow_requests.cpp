@@ -0,0 +1,197 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "slow_requests.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+void SlowRequestRecord::setInputs(const tensorflow::serving::PredictRequest& request) {
+    inputs.clear();
+    inputs.reserve(request.inputs().size());
+    for (const auto& [name, proto] : request.inputs()) {
+        SlowRequestInput input{name, TensorInfo::getPrecisionAsString(TensorInfo::getPrecisionFromDataType(proto.dtype())), {}, 0};
+        uint64_t elementsCount = 1;
+        for (const auto& dim : proto.tensor_shape().dim()) {
+            input.shape.push_back(dim.size());
+            elementsCount *= std::max<int64_t>(0, dim.size());
+        }
+        if (proto.dtype() == tensorflow::DT_STRING) {
+            for (const auto& value : proto.string_val()) {
+                input.bytes += value.size();
+            }
+        } else if (!proto.tensor_content().empty()) {
+            input.bytes = proto.tensor_content().size();
+        } else {
+            input.bytes = elementsCount * TensorInfo::getPrecisionFromDataType(proto.dtype()).size();
+        }
+        inputs.push_back(std::move(input));
+    }
+}
+
+void SlowRequests::record(SlowRequestRecord&& record) {
+    if (capacity == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (records.size() < capacity) {
+        records.push_back(std::move(record));
+    } else {
+        auto fastest = std::min_element(records.begin(), records.end(),
+            [](const SlowRequestRecord& lhs, const SlowRequestRecord& rhs) { return lhs.durationUs < rhs.durationUs; });
+        // another request could have raised the threshold since it was checked
+        if (fastest->durationUs >= record.durationUs) {
+            return;
+        }
+        *fastest = std::move(record);
+    }
+    if (records.size() == capacity) {
+        auto fastest = std::min_element(records.begin(), records.end(),
+            [](const SlowRequestRecord& lhs, const SlowRequestRecord& rhs) { return lhs.durationUs < rhs.durationUs; });
+        thresholdUs.store(fastest->durationUs, std::memory_order_relaxed);
+    }
+}
+
+std::vector<SlowRequestRecord> SlowRequests::getRecords() const {
+    std::vector<SlowRequestRecord> result;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        result = records;
+    }
+    std::sort(result.begin(), result.end(),
+        [](const SlowRequestRecord& lhs, const SlowRequestRecord& rhs) { return lhs.durationUs > rhs.durationUs; });
+    return result;
+}
+
+void SlowRequestsLog::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mtx);
+    this->capacity = capacity;
+}
+
+SlowRequests& SlowRequestsLog::get(const std::string& name, model_version_t version, bool pipeline) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& entry = servables[std::make_tuple(name, version, pipeline)];
+    if (!entry) {
+        entry = std::make_unique<SlowRequests>(capacity);
+    }
+    return *entry;
+}
+
+static void writeRecord(rapidjson::Writer<rapidjson::StringBuffer>& writer, const SlowRequestRecord& record) {
+    writer.StartObject();
+    writer.Key("timestamp_ms");
+    writer.Uint64(std::chrono::duration_cast<std::chrono::milliseconds>(record.time.time_since_epoch()).count());
+    writer.Key("duration_us");
+    writer.Uint64(record.durationUs);
+    if (!record.stages.empty()) {
+        writer.Key("stages_us");
+        writer.StartObject();
+        for (const auto& stage : record.stages) {
+            writer.Key(stage.name.c_str());
+            writer.Uint64(stage.durationUs);
+        }
+        writer.EndObject();
+    }
+    if (!record.nodes.empty()) {
+        writer.Key("nodes");
+        writer.StartArray();
+        for (const auto& node : record.nodes) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(node.name.c_str());
+            writer.Key("sessions");
+            writer.Uint64(node.sessions);
+            writer.Key("inputs_wait_us");
+            writer.Uint64(node.inputsWaitUs);
+            writer.Key("stream_wait_us");
+            writer.Uint64(node.streamWaitUs);
+            writer.Key("execution_us");
+            writer.Uint64(node.executionUs);
+            writer.Key("output_bytes");
+            writer.Uint64(node.outputBytes);
+            writer.Key("shards");
+            writer.Uint64(node.shards);
+            writer.EndObject();
+        }
+        writer.EndArray();
+    }
+    writer.Key("inputs");
+    writer.StartArray();
+    for (const auto& input : record.inputs) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(input.name.c_str());
+        writer.Key("datatype");
+        writer.String(input.datatype.c_str());
+        writer.Key("shape");
+        writer.StartArray();
+        for (auto dim : input.shape) {
+            writer.Int64(dim);
+        }
+        writer.EndArray();
+        writer.Key("bytes");
+        writer.Uint64(input.bytes);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+}
+
+std::string SlowRequestsLog::toJson() const {
+    std::vector<std::pair<std::tuple<std::string, model_version_t, bool>, std::vector<SlowRequestRecord>>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto& [key, entry] : servables) {
+            snapshot.emplace_back(key, entry->getRecords());
+        }
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("slow_requests");
+    writer.StartArray();
+    for (const auto& [key, records] : snapshot) {
+        if (records.empty()) {
+            continue;
+        }
+        const auto& [name, version, pipeline] = key;
+        writer.StartObject();
+        writer.Key(pipeline ? "pipeline" : "model");
+        writer.String(name.c_str());
+        if (!pipeline) {
+            writer.Key("version");
+            writer.Int64(version);
+        }
+        writer.Key("requests");
+        writer.StartArray();
+        for (const auto& record : records) {
+            writeRecord(writer, record);
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return buffer.GetString();
+}
+
+}  // namespace ovms
@@ -0,0 +1,144 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "modelversion.hpp"
+
+namespace ovms {
+
+struct SlowRequestStage {
+    std::string name;
+    uint64_t durationUs;
+};
+
+struct SlowRequestNode {
+    std::string name;
+    uint64_t sessions;
+    uint64_t inputsWaitUs;
+    uint64_t streamWaitUs;
+    uint64_t executionUs;
+    uint64_t outputBytes;
+    uint64_t shards;
+};
+
+struct SlowRequestInput {
+    std::string name;
+    std::string datatype;
+    std::vector<int64_t> shape;
+    uint64_t bytes;
+};
+
+/**
+ * @brief Breakdown of single completed request, stages for a model and nodes for a pipeline
+ */
+struct SlowRequestRecord {
+    std::chrono::system_clock::time_point time;
+    uint64_t durationUs = 0;
+    std::vector<SlowRequestStage> stages;
+    std::vector<SlowRequestNode> nodes;
+    std::vector<SlowRequestInput> inputs;
+
+    /**
+     * @brief Describes inputs of request, size of inputs placed in shared memory is computed from their shape
+     */
+    void setInputs(const tensorflow::serving::PredictRequest& request);
+};
+
+/**
+ * @brief Keeps the slowest requests to single model version or pipeline
+ *
+ * Once capacity is reached, only requests slower than the fastest kept one are recorded, replacing it.
+ * The check is a single atomic load, so requests which are not slow enough neither lock nor build their record.
+ */
+class SlowRequests {
+    const size_t capacity;
+    std::atomic<uint64_t> thresholdUs{0};
+    mutable std::mutex mtx;
+    std::vector<SlowRequestRecord> records;
+
+public:
+    explicit SlowRequests(size_t capacity) :
+        capacity(capacity) {}
+
+    bool isSlow(uint64_t durationUs) const {
+        return capacity > 0 && durationUs > thresholdUs.load(std::memory_order_relaxed);
+    }
+
+    void record(SlowRequestRecord&& record);
+
+    /**
+     * @brief Gets kept requests, the slowest first
+     */
+    std::vector<SlowRequestRecord> getRecords() const;
+};
+
+/**
+ * @brief Registry of slowest requests of all model versions and pipelines, exposed through REST API
+ *
+ * Entries are created on first use and live until server shutdown, so references to them can be kept.
+ */
+class SlowRequestsLog {
+    size_t capacity = DEFAULT_CAPACITY;
+    mutable std::mutex mtx;
+    // keyed by servable name, version and whether it is a pipeline, pipelines have version 0
+    std::map<std::tuple<std::string, model_version_t, bool>, std::unique_ptr<SlowRequests>> servables;
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 10;
+
+    static SlowRequestsLog& instance() {
+        static SlowRequestsLog instance;
+        return instance;
+    }
+
+    /**
+     * @brief Sets number of requests kept per servable, 0 disables recording, applies to entries created later
+     */
+    void setCapacity(size_t capacity);
+
+    SlowRequests& getModel(const std::string& name, model_version_t version) {
+        return get(name, version, false);
+    }
+
+    SlowRequests& getPipeline(const std::string& name) {
+        return get(name, 0, true);
+    }
+
+    /**
+     * @brief Serializes kept requests of all servables to JSON
+     */
+    std::string toJson() const;
+
+private:
+    SlowRequests& get(const std::string& name, model_version_t version, bool pipeline);
+};
+
+}  // namespace ovms
@@ -0,0 +1,188 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "sparse_tensor.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "deserialization.hpp"
+
+namespace ovms {
+
+namespace {
+
+const tensorflow::TensorProto& getIndices(const tensorflow::TensorProto& tensor) {
+    return tensor.variant_val(0).tensors(0);
+}
+
+const tensorflow::TensorProto& getValues(const tensorflow::TensorProto& tensor) {
+    return tensor.variant_val(0).tensors(1);
+}
+
+template <typename Index>
+int64_t readIndex(const std::string& content, size_t position) {
+    Index index;
+    std::memcpy(&index, content.data() + position * sizeof(Index), sizeof(Index));
+    return static_cast<int64_t>(index);
+}
+
+int64_t readIndex(const tensorflow::TensorProto& indices, size_t position) {
+    return indices.dtype() == tensorflow::DataType::DT_INT64 ? readIndex<int64_t>(indices.tensor_content(), position) : readIndex<int32_t>(indices.tensor_content(), position);
+}
+
+// Values of 16 bit precisions may be sent zero padded in typed fields, as for dense tensors
+size_t getValuesCount(const tensorflow::TensorProto& values, size_t valueSize) {
+    if (!values.tensor_content().empty()) {
+        return values.tensor_content().size() % valueSize == 0 ? values.tensor_content().size() / valueSize : 0;
+    }
+    if (values.dtype() == tensorflow::DataType::DT_HALF) {
+        return static_cast<size_t>(values.half_val_size());
+    }
+    if (values.dtype() == tensorflow::DataType::DT_UINT16) {
+        return static_cast<size_t>(values.int_val_size());
+    }
+    return 0;
+}
+
+Status invalidSparseTensor(const std::string& details) {
+    SPDLOG_DEBUG("Invalid sparse tensor - {}", details);
+    return Status(StatusCode::INVALID_SPARSE_TENSOR, details);
+}
+
+}  // namespace
+
+bool isSparseTensor(const tensorflow::TensorProto& tensor) {
+    return tensor.variant_val_size() == 1 && tensor.variant_val(0).type_name() == SPARSE_TENSOR_TYPE_NAME;
+}
+
+std::pair<tensorflow::TensorProto*, tensorflow::TensorProto*> setSparseTensor(tensorflow::TensorProto& tensor) {
+    tensor.clear_tensor_content();
+    tensor.clear_variant_val();
+    auto variant = tensor.add_variant_val();
+    variant->set_type_name(SPARSE_TENSOR_TYPE_NAME);
+    auto indices = variant->add_tensors();
+    auto values = variant->add_tensors();
+    return {indices, values};
+}
+
+Status validateSparseInput(const TensorInfo& networkInput, const tensorflow::TensorProto& requestInput) {
+    if (networkInput.isTransposedByServer() || networkInput.isPlanarYuv()) {
+        return invalidSparseTensor("Sparse encoding is not supported for input " + networkInput.getMappedName() + " with layout or color format conversion");
+    }
+    const auto& variant = requestInput.variant_val(0);
+    if (variant.tensors_size() != 2) {
+        std::stringstream ss;
+        ss << "Expected: indices and values tensors; Actual: " << variant.tensors_size() << " tensors";
+        return invalidSparseTensor(ss.str());
+    }
+    const auto& denseShape = requestInput.tensor_shape();
+    const auto& indices = getIndices(requestInput);
+    const auto& values = getValues(requestInput);
+    const size_t rank = static_cast<size_t>(denseShape.dim_size());
+    if (indices.dtype() != tensorflow::DataType::DT_INT64 && indices.dtype() != tensorflow::DataType::DT_INT32) {
+        return invalidSparseTensor("Expected indices precision: I64 or I32; Actual: " + TensorInfo::getDataTypeAsString(indices.dtype()));
+    }
+    if (indices.tensor_shape().dim_size() != 2 || indices.tensor_shape().dim(0).size() < 0 ||
+        static_cast<size_t>(indices.tensor_shape().dim(1).size()) != rank) {
+        std::stringstream ss;
+        ss << "Expected indices shape: [N, " << rank << "]; Actual: " << TensorInfo::tensorShapeToString(indices.tensor_shape());
+        return invalidSparseTensor(ss.str());
+    }
+    const size_t count = static_cast<size_t>(indices.tensor_shape().dim(0).size());
+    const size_t indexSize = indices.dtype() == tensorflow::DataType::DT_INT64 ? sizeof(int64_t) : sizeof(int32_t);
+    if (indices.tensor_content().size() != count * rank * indexSize) {
+        std::stringstream ss;
+        ss << "Expected indices content: " << count * rank * indexSize << " bytes; Actual: " << indices.tensor_content().size() << " bytes";
+        return invalidSparseTensor(ss.str());
+    }
+    if (values.dtype() != requestInput.dtype()) {
+        return invalidSparseTensor("Expected values precision: " + TensorInfo::getDataTypeAsString(requestInput.dtype()) +
+                                   "; Actual: " + TensorInfo::getDataTypeAsString(values.dtype()));
+    }
+    const size_t valueSize = TensorInfo::getPrecisionFromDataType(values.dtype()).size();
+    if (values.tensor_shape().dim_size() != 1 || static_cast<size_t>(values.tensor_shape().dim(0).size()) != count ||
+        valueSize == 0 || getValuesCount(values, valueSize) != count) {
+        std::stringstream ss;
+        ss << "Expected " << count << " values; Actual shape: " << TensorInfo::tensorShapeToString(values.tensor_shape())
+           << ", values: " << getValuesCount(values, valueSize == 0 ? 1 : valueSize);
+        return invalidSparseTensor(ss.str());
+    }
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t dimension = 0; dimension < rank; ++dimension) {
+            const int64_t index = readIndex(indices, i * rank + dimension);
+            if (index < 0 || index >= denseShape.dim(static_cast<int>(dimension)).size()) {
+                std::stringstream ss;
+                ss << "Index " << index << " of value " << i << " is out of dense shape " << TensorInfo::tensorShapeToString(denseShape);
+                return invalidSparseTensor(ss.str());
+            }
+        }
+    }
+    return StatusCode::OK;
+}
+
+bool writeSparseTensor(const tensorflow::TensorProto& requestInput, InferenceEngine::Precision precision, void* destination, size_t byteSize) {
+    const auto& denseShape = requestInput.tensor_shape();
+    const size_t rank = static_cast<size_t>(denseShape.dim_size());
+    // row major strides of dense tensor, in elements
+    std::vector<size_t> strides(rank, 1);
+    size_t denseCount = 1;
+    for (size_t dimension = rank; dimension-- > 0;) {
+        strides[dimension] = denseCount;
+        denseCount *= static_cast<size_t>(denseShape.dim(static_cast<int>(dimension)).size());
+    }
+    const size_t elementSize = precision.size();
+    if (denseCount * elementSize != byteSize) {
+        return false;
+    }
+    const auto& indices = getIndices(requestInput);
+    const auto& values = getValues(requestInput);
+    const size_t count = static_cast<size_t>(indices.tensor_shape().dim(0).size());
+
+    const char* source = values.tensor_content().data();
+    std::vector<char> convertedValues;
+    std::vector<uint16_t> narrowedValues;
+    if (values.dtype() == tensorflow::DataType::DT_FLOAT && precision != InferenceEngine::Precision::FP32) {
+        convertedValues.resize(count * elementSize);
+        if (!convertFromFp32(precision, reinterpret_cast<const float*>(source), convertedValues.data(), count)) {
+            return false;
+        }
+        source = convertedValues.data();
+    } else if (TensorInfo::getPrecisionFromDataType(values.dtype()).size() != elementSize) {
+        return false;
+    } else if (values.tensor_content().empty() && count > 0) {
+        const auto& typedValues = values.dtype() == tensorflow::DataType::DT_HALF ? values.half_val() : values.int_val();
+        narrowedValues.resize(count);
+        narrowInt32ToUint16(typedValues.data(), narrowedValues.data(), count);
+        source = reinterpret_cast<const char*>(narrowedValues.data());
+    }
+
+    char* dense = static_cast<char*>(destination);
+    std::memset(dense, 0, byteSize);
+    for (size_t i = 0; i < count; ++i) {
+        size_t offset = 0;
+        for (size_t dimension = 0; dimension < rank; ++dimension) {
+            offset += static_cast<size_t>(readIndex(indices, i * rank + dimension)) * strides[dimension];
+        }
+        std::memcpy(dense + offset * elementSize, source + i * elementSize, elementSize);
+    }
+    return true;
+}
+
+}  // namespace ovms
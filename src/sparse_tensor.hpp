@@ -0,0 +1,70 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <utility>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/tensor.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Type name of variant marking tensor sent in sparse encoding
+ *
+ * Sparse tensor keeps dtype and tensor_shape of the dense tensor, its only variant_val holds two tensors:
+ * indices of DT_INT64 or DT_INT32 with shape [N, rank] and values of tensor dtype with shape [N].
+ * Positions which are not listed are zero.
+ */
+const char SPARSE_TENSOR_TYPE_NAME[] = "ovms.sparse";
+
+bool isSparseTensor(const tensorflow::TensorProto& tensor);
+
+/**
+ * @brief Marks tensor as sparse
+ *
+ * @return indices and values tensors to be filled by caller
+ */
+std::pair<tensorflow::TensorProto*, tensorflow::TensorProto*> setSparseTensor(tensorflow::TensorProto& tensor);
+
+/**
+ * @brief Validates indices and values of sparse tensor against its dense shape
+ *
+ * Dense shape itself is validated against network input as for dense tensors.
+ */
+Status validateSparseInput(const TensorInfo& networkInput, const tensorflow::TensorProto& requestInput);
+
+/**
+ * @brief Zero fills buffer of dense tensor and writes validated sparse values at their indices
+ *
+ * FP32 values are converted to precision of inputs converted by preprocessing.
+ *
+ * @param precision precision of dense tensor
+ * @param destination buffer of dense tensor
+ * @param byteSize size of destination
+ *
+ * @return false if destination does not match dense shape or values cannot be converted
+ */
+bool writeSparseTensor(const tensorflow::TensorProto& requestInput, InferenceEngine::Precision precision, void* destination, size_t byteSize);
+
+}  // namespace ovms
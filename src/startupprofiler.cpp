@@ -0,0 +1,97 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "startupprofiler.hpp"
+
+#include <fstream>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+
+#include "status.hpp"
+
+namespace ovms {
+
+void StartupProfiler::start() {
+    std::lock_guard<std::mutex> lock(mtx);
+    events.clear();
+    threadIds.clear();
+    origin = clock_t::now();
+    enabled = true;
+}
+
+void StartupProfiler::addEvent(const std::string& name, const std::string& category, clock_t::time_point start, clock_t::time_point end, args_t args) {
+    if (!isEnabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    auto threadId = threadIds.emplace(std::this_thread::get_id(), threadIds.size() + 1).first->second;
+    events.push_back({name, category, start, end, threadId, std::move(args)});
+}
+
+std::string StartupProfiler::serialize() {
+    std::lock_guard<std::mutex> lock(mtx);
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("traceEvents");
+    writer.StartArray();
+    for (const auto& event : events) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(event.name.c_str());
+        writer.Key("cat");
+        writer.String(event.category.c_str());
+        writer.Key("ph");
+        writer.String("X");
+        writer.Key("ts");
+        writer.Int64(std::chrono::duration_cast<std::chrono::microseconds>(event.start - origin).count());
+        writer.Key("dur");
+        writer.Int64(std::chrono::duration_cast<std::chrono::microseconds>(event.end - event.start).count());
+        writer.Key("pid");
+        writer.Int(1);
+        writer.Key("tid");
+        writer.Uint64(event.threadId);
+        writer.Key("args");
+        writer.StartObject();
+        for (const auto& [key, value] : event.args) {
+            writer.Key(key.c_str());
+            writer.String(value.c_str());
+        }
+        writer.EndObject();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return buffer.GetString();
+}
+
+Status StartupProfiler::stop(const std::string& path) {
+    enabled = false;
+    const auto trace = serialize();
+    std::ofstream file(path, std::ios::trunc);
+    file << trace;
+    if (!file) {
+        SPDLOG_ERROR("Unable to write startup profile to {}", path);
+        return StatusCode::FILE_INVALID;
+    }
+    SPDLOG_INFO("Startup profile written to {}", path);
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
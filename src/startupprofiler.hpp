@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ovms {
+
+class Status;
+
+/**
+ * @brief Collects durations of server startup phases and writes them as Chrome trace JSON
+ *
+ * Events are collected only between start() and stop(), so model reloads done later by
+ * config watcher are not recorded. The file can be opened in chrome://tracing or Perfetto.
+ */
+class StartupProfiler {
+public:
+    using clock_t = std::chrono::steady_clock;
+    using args_t = std::vector<std::pair<std::string, std::string>>;
+
+private:
+    struct Event {
+        std::string name;
+        std::string category;
+        clock_t::time_point start;
+        clock_t::time_point end;
+        uint64_t threadId;
+        args_t args;
+    };
+
+    std::atomic<bool> enabled{false};
+    clock_t::time_point origin;
+    std::mutex mtx;
+    std::vector<Event> events;
+    // trace viewers expect small thread numbers, threads are numbered in order of first event
+    std::map<std::thread::id, uint64_t> threadIds;
+
+public:
+    static StartupProfiler& instance() {
+        static StartupProfiler profiler;
+        return profiler;
+    }
+
+    /**
+     * @brief Drops previously collected events and starts collecting
+     */
+    void start();
+
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records complete event of calling thread, ignored when profiler is not started
+     */
+    void addEvent(const std::string& name, const std::string& category, clock_t::time_point start, clock_t::time_point end, args_t args = {});
+
+    /**
+     * @brief Serializes collected events in Chrome trace event format
+     */
+    std::string serialize();
+
+    /**
+     * @brief Stops collecting and writes collected events to file
+     */
+    Status stop(const std::string& path);
+};
+
+}  // namespace ovms
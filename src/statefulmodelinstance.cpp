@@ -15,6 +15,12 @@
 //*****************************************************************************
 #include "statefulmodelinstance.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "deserialization.hpp"
 #include "executingstreamidguard.hpp"
 #include "logging.hpp"
@@ -25,6 +31,24 @@ using namespace InferenceEngine;
 
 namespace ovms {
 
+enum : size_t {
+    GET_INFER_REQUEST,
+    PREPROCESS,
+    DESERIALIZE,
+    PREDICTION,
+    SERIALIZE,
+    POSTPROCESS,
+    TIMER_END
+};
+
+// Include sequence_id in server response
+static void addSequenceIdOutput(tensorflow::serving::PredictResponse* response, uint64_t sequenceId) {
+    auto& tensorProto = (*response->mutable_outputs())["sequence_id"];
+    tensorProto.mutable_tensor_shape()->add_dim()->set_size(1);
+    tensorProto.set_dtype(tensorflow::DataType::DT_UINT64);
+    tensorProto.add_uint64_val(sequenceId);
+}
+
 const Status StatefulModelInstance::extractSequenceId(const tensorflow::TensorProto& proto, uint64_t& sequenceId) {
     if (!proto.tensor_shape().dim_size()) {
         SPDLOG_DEBUG("[Model: {} version: {}] Sequence id tensor proto does not contain tensor shape information", getName(), getVersion());
@@ -121,7 +145,8 @@ void StatefulModelInstance::cleanupFailedLoad() {
 
 Status StatefulModelInstance::loadModelImpl(const ModelConfig& config, const DynamicModelParameter& parameter) {
     performLowLatencyTransformation = config.isLowLatencyTransformationUsed();
-    sequenceManager = std::make_shared<SequenceManager>(config.getMaxSequenceNumber(), config.getName(), config.getVersion());
+    sequenceManager = std::make_shared<SequenceManager>(config.getMaxSequenceNumber(), config.getName(), config.getVersion(),
+        config.getIdleSequenceTimeoutSeconds(), config.getIdleSequenceCompressionSeconds());
     return ModelInstance::loadModelImpl(config, parameter);
 }
 
@@ -182,101 +207,423 @@ const Status StatefulModelInstance::validate(const tensorflow::serving::PredictR
     auto status = validateSpecialKeys(request, sequenceProcessingSpec);
     if (!status.ok())
         return status;
+    status = validateModelInputs(request);
+    if (!status.ok())
+        return status;
+    // sequence must not be modified by request which fails on its output filter
+    tensor_map_t requestedOutputs;
+    return filterRequestedOutputs(*request, getOutputsInfo(), requestedOutputs);
+}
 
+const Status StatefulModelInstance::validateModelInputs(const tensorflow::serving::PredictRequest* request) {
+    Status status;
+    if (dynamicBatcher) {
+        size_t requestBatchSize = 0;
+        status = validateForDynamicBatching(request, getModelConfig().getMaxBatchSize(), requestBatchSize);
+        if (!status.ok())
+            return status;
+        if (requestBatchSize != 1) {
+            SPDLOG_DEBUG("[Model: {} version: {}] Batched sequence step has batch size {}", getName(), getVersion(), requestBatchSize);
+            return Status(StatusCode::INVALID_BATCH_SIZE, "Expected: 1; Actual: " + std::to_string(requestBatchSize));
+        }
+        return StatusCode::OK;
+    }
     return ModelInstance::validate(request);
 }
 
 Status StatefulModelInstance::infer(const tensorflow::serving::PredictRequest* requestProto,
     tensorflow::serving::PredictResponse* responseProto,
-    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr) {
-    Timer timer;
-    using std::chrono::microseconds;
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    const RequestContext& context) {
+    // sequence state is modified once stream is acquired, so request is not dropped afterwards
+    auto status = context.check();
+    if (!status.ok())
+        return status;
     SequenceProcessingSpec sequenceProcessingSpec;
-    auto status = validate(requestProto, sequenceProcessingSpec);
+    status = validate(requestProto, sequenceProcessingSpec);
     if (!status.ok())
         return status;
 
-    std::unique_lock<std::mutex> sequenceManagerLock(sequenceManager->getMutex());
-    status = sequenceManager->processRequestedSpec(sequenceProcessingSpec);
+    Sequence* sequence = nullptr;
+    std::unique_lock<std::mutex> sequenceLock;
+    status = openSequence(sequenceProcessingSpec, sequence, sequenceLock, false);
     if (!status.ok())
         return status;
-    const uint64_t sequenceId = sequenceProcessingSpec.getSequenceId();
-    if (!sequenceManager->sequenceExists(sequenceId))
-        return StatusCode::INTERNAL_ERROR;
-    Sequence& sequence = sequenceManager->getSequence(sequenceId);
+    return runSequenceStep(requestProto, responseProto, *sequence, sequenceProcessingSpec, sequenceLock, context);
+}
+
+Status StatefulModelInstance::inferStreamed(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    StreamedSequence& streamedSequence, bool sequenceEnd,
+    const RequestContext& context) {
+    auto status = context.check();
+    if (!status.ok())
+        return status;
+    if (streamedSequence.sequence && streamedSequence.sequenceManager != sequenceManager) {
+        SPDLOG_DEBUG("[Model: {} version: {}] Streamed sequence {} was dropped by model reload", getName(), getVersion(), streamedSequence.sequenceId);
+        streamedSequence = StreamedSequence();
+        return StatusCode::SEQUENCE_MISSING;
+    }
+    status = validateModelInputs(requestProto);
+    if (!status.ok())
+        return status;
+
+    // Control input is implied by position of the request in the stream
+    SequenceProcessingSpec sequenceProcessingSpec;
+    sequenceProcessingSpec.setSequenceId(streamedSequence.sequenceId);
+    Sequence* sequence = streamedSequence.sequence;
+    std::unique_lock<std::mutex> sequenceLock;
+    if (!sequence) {
+        sequenceProcessingSpec.setSequenceControlInput(SEQUENCE_START);
+        status = openSequence(sequenceProcessingSpec, sequence, sequenceLock, true);
+        if (!status.ok())
+            return status;
+        streamedSequence.sequenceManager = sequenceManager;
+        streamedSequence.sequence = sequence;
+        streamedSequence.sequenceId = sequenceProcessingSpec.getSequenceId();
+    } else {
+        // Streamed sequence is hidden from other requests, so it is not removed while the stream holds it
+        sequenceProcessingSpec.setSequenceControlInput(sequenceEnd ? SEQUENCE_END : NO_CONTROL_INPUT);
+        sequenceLock = std::unique_lock<std::mutex>(sequence->getMutex());
+    }
+    status = runSequenceStep(requestProto, responseProto, *sequence, sequenceProcessingSpec, sequenceLock, context);
+    if (!status.ok() || !sequenceEnd)
+        return status;
+    // Sequence of single request is removed after its start step
+    if (sequenceProcessingSpec.getSequenceControlInput() == SEQUENCE_START)
+        status = closeSequence(streamedSequence.sequenceId, sequence->getBoundStreamId());
+    // Id of ended sequence is kept for the response
+    streamedSequence.sequenceManager.reset();
+    streamedSequence.sequence = nullptr;
+    return status;
+}
+
+void StatefulModelInstance::endStreamedSequence(StreamedSequence& streamedSequence) {
+    if (streamedSequence.sequence && streamedSequence.sequenceManager == sequenceManager) {
+        SPDLOG_DEBUG("[Model: {} version: {}] Removing sequence {} of closed stream", getName(), getVersion(), streamedSequence.sequenceId);
+        const int boundStreamId = streamedSequence.sequence->getBoundStreamId();
+        closeSequence(streamedSequence.sequenceId, boundStreamId);
+    }
+    streamedSequence = StreamedSequence();
+}
 
+uint64_t StatefulModelInstance::getSequenceStatesMemoryBytes() {
+    return sequenceManager ? sequenceManager->getMemoryStateBytes() : 0;
+}
+
+Status StatefulModelInstance::exportSequence(uint64_t sequenceId, std::string& serialized, bool removeSequence) {
+    if (sequenceId == 0)
+        return StatusCode::SEQUENCE_ID_NOT_PROVIDED;
+    // Terminated sequence does not accept new requests, so exported state is the last one
+    SequenceProcessingSpec sequenceProcessingSpec(removeSequence ? SEQUENCE_END : NO_CONTROL_INPUT, sequenceId);
+    std::unique_lock<std::mutex> sequenceManagerLock;
+    auto status = sequenceManager->processRequestedSpec(sequenceProcessingSpec, sequenceManagerLock);
+    if (!status.ok())
+        return status;
+    Sequence& sequence = sequenceManager->getSequence(sequenceId);
     std::unique_lock<std::mutex> sequenceLock(sequence.getMutex());
     sequenceManagerLock.unlock();
+    const int boundStreamId = sequence.getBoundStreamId();
+    if (boundStreamId >= 0) {
+        // State of bound sequence stays resident in its infer request
+        auto modelState = getInferRequestsQueue().getInferRequest(boundStreamId).QueryState();
+        status = sequence.updateMemoryState(modelState);
+    }
+    if (status.ok())
+        status = sequence.exportMemoryState(serialized);
+    sequenceLock.unlock();
+    if (removeSequence) {
+        auto closeStatus = closeSequence(sequenceId, boundStreamId);
+        if (status.ok())
+            status = closeStatus;
+    }
+    SPDLOG_DEBUG("[Model: {} version: {}] Exported state of sequence {}: {}", getName(), getVersion(), sequenceId, status.string());
+    return status;
+}
+
+Status StatefulModelInstance::importSequence(uint64_t sequenceId, const std::string& serialized) {
+    if (sequenceId == 0)
+        return StatusCode::SEQUENCE_ID_NOT_PROVIDED;
+    // Imported sequence shares infer requests, its state is loaded by its next request
+    SequenceProcessingSpec sequenceProcessingSpec(SEQUENCE_START, sequenceId);
+    std::unique_lock<std::mutex> sequenceManagerLock;
+    auto status = sequenceManager->processRequestedSpec(sequenceProcessingSpec, sequenceManagerLock);
+    if (!status.ok())
+        return status;
+    // Shard lock is held until the state is imported, so that requests do not see sequence without state
+    Sequence& sequence = sequenceManager->getSequence(sequenceId);
+    {
+        std::lock_guard<std::mutex> sequenceLock(sequence.getMutex());
+        status = sequence.importMemoryState(serialized);
+    }
+    if (!status.ok()) {
+        sequenceManager->removeSequence(sequenceId);
+    }
+    SPDLOG_DEBUG("[Model: {} version: {}] Imported state of sequence {}: {}", getName(), getVersion(), sequenceId, status.string());
+    return status;
+}
+
+Status StatefulModelInstance::openSequence(SequenceProcessingSpec& sequenceProcessingSpec, Sequence*& sequence,
+    std::unique_lock<std::mutex>& sequenceLock, bool streamed) {
+    // Infer request is reserved for the sequence before it is created, so that creation is not blocked on the queue
+    int reservedStreamId = -1;
+    if (sequenceProcessingSpec.getSequenceControlInput() == SEQUENCE_START && maxBoundSequences > 0) {
+        reserveBoundStream(reservedStreamId);
+    }
+    std::unique_lock<std::mutex> sequenceManagerLock;
+    auto status = sequenceManager->processRequestedSpec(sequenceProcessingSpec, sequenceManagerLock);
+    const uint64_t sequenceId = sequenceProcessingSpec.getSequenceId();
+    if (status.ok() && !sequenceManager->sequenceExists(sequenceId))
+        status = StatusCode::INTERNAL_ERROR;
+    if (!status.ok()) {
+        if (reservedStreamId >= 0) {
+            if (sequenceManagerLock.owns_lock())
+                sequenceManagerLock.unlock();
+            releaseBoundStream(reservedStreamId, 0);
+        }
+        return status;
+    }
+    sequence = &sequenceManager->getSequence(sequenceId);
+    if (reservedStreamId >= 0) {
+        sequence->setBoundStreamId(reservedStreamId);
+    }
+    if (streamed) {
+        sequence->setStreamed();
+    }
+
+    sequenceLock = std::unique_lock<std::mutex>(sequence->getMutex());
+    sequenceManagerLock.unlock();
+    if (reservedStreamId >= 0) {
+        bindStream(reservedStreamId, sequenceId);
+        SPDLOG_DEBUG("Sequence {} of model {}, version {} bound to infer request {}",
+            sequenceId, getName(), getVersion(), reservedStreamId);
+    }
+    return StatusCode::OK;
+}
+
+Status StatefulModelInstance::runSequenceStep(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec,
+    std::unique_lock<std::mutex>& sequenceLock, const RequestContext& context) {
+    const uint64_t sequenceId = sequenceProcessingSpec.getSequenceId();
+    const int boundStreamId = sequence.getBoundStreamId();
+    Status status;
+    if (sequence.isMemoryStateCompressed()) {
+        // State of idle sequence was compressed by sequence cleaner
+        status = sequence.restoreMemoryState();
+        if (!status.ok())
+            return status;
+    }
+    if (dynamicBatcher) {
+        // Steps of concurrent sequences are batched, states are stacked and saved back by the batcher
+        status = dynamicBatcher->infer(requestProto, responseProto, sequence, sequenceProcessingSpec.getSequenceControlInput());
+        if (!status.ok())
+            return status;
+        addSequenceIdOutput(responseProto, sequenceId);
+    } else {
+        status = inferWithStream(requestProto, responseProto, sequence, sequenceProcessingSpec, boundStreamId, context);
+        if (!status.ok())
+            return status;
+    }
+
+    sequenceLock.unlock();
+    if (sequenceProcessingSpec.getSequenceControlInput() == SEQUENCE_END) {
+        return closeSequence(sequenceId, boundStreamId);
+    }
+    return StatusCode::OK;
+}
+
+Status StatefulModelInstance::closeSequence(uint64_t sequenceId, int boundStreamId) {
+    std::unique_lock<std::mutex> sequenceManagerLock = sequenceManager->lockShard(sequenceId);
+    auto status = sequenceManager->removeSequence(sequenceId);
+    if (!status.ok())
+        return status;
+    sequenceManagerLock.unlock();
+    if (boundStreamId >= 0) {
+        releaseBoundStream(boundStreamId, sequenceId);
+    }
+    return StatusCode::OK;
+}
 
-    timer.start("get infer request");
-    ExecutingStreamIdGuard executingStreamIdGuard(getInferRequestsQueue());
-    int executingInferId = executingStreamIdGuard.getId();
-    InferenceEngine::InferRequest& inferRequest = executingStreamIdGuard.getInferRequest();
-    timer.stop("get infer request");
+Status StatefulModelInstance::inferWithStream(const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec,
+    int boundStreamId, const RequestContext& context) {
+    Timer<TIMER_END> timer;
+    using std::chrono::microseconds;
+    timer.start(GET_INFER_REQUEST);
+    // Bound sequence has infer request for exclusive use, serialized by the sequence lock
+    std::unique_ptr<ExecutingStreamIdGuard> executingStreamIdGuard;
+    if (boundStreamId < 0) {
+        executingStreamIdGuard = std::make_unique<ExecutingStreamIdGuard>(getInferRequestsQueue(), context, &getSchedulingTenant());
+        if (!executingStreamIdGuard->getStatus().ok()) {
+            SPDLOG_DEBUG("Dropping request for model {}, version {}: {}",
+                requestProto->model_spec().name(), getVersion(), executingStreamIdGuard->getStatus().string());
+            return executingStreamIdGuard->getStatus();
+        }
+    }
+    int executingInferId = executingStreamIdGuard ? executingStreamIdGuard->getId() : boundStreamId;
+    InferenceEngine::InferRequest& inferRequest = executingStreamIdGuard ? executingStreamIdGuard->getInferRequest() : getInferRequestsQueue().getInferRequest(boundStreamId);
+    timer.stop(GET_INFER_REQUEST);
     SPDLOG_DEBUG("Getting infer req duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("get infer request") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(GET_INFER_REQUEST) / 1000);
 
-    timer.start("preprocess");
-    status = preInferenceProcessing(inferRequest, sequence, sequenceProcessingSpec);
-    timer.stop("preprocess");
+    timer.start(PREPROCESS);
+    auto status = preInferenceProcessing(inferRequest, sequence, sequenceProcessingSpec, executingInferId);
+    timer.stop(PREPROCESS);
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Preprocessing duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("preprocess") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(PREPROCESS) / 1000);
 
-    timer.start("deserialize");
+    timer.start(DESERIALIZE);
     InputSink<InferRequest&> inputSink(inferRequest);
     bool isPipeline = false;
     status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, getInputsInfo(), inputSink, isPipeline);
-    timer.stop("deserialize");
+    timer.stop(DESERIALIZE);
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Deserialization duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("deserialize") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(DESERIALIZE) / 1000);
 
-    timer.start("prediction");
+    timer.start(PREDICTION);
     status = performInference(inferRequest);
-    timer.stop("prediction");
+    timer.stop(PREDICTION);
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Prediction duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("prediction") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(PREDICTION) / 1000);
 
-    timer.start("serialize");
-    status = serializePredictResponse(inferRequest, getOutputsInfo(), responseProto);
-    timer.stop("serialize");
+    timer.start(SERIALIZE);
+    tensor_map_t requestedOutputs;
+    status = filterRequestedOutputs(*requestProto, getOutputsInfo(), requestedOutputs);
+    if (status.ok()) {
+        status = serializePredictResponse(inferRequest, requestProto->output_filter_size() > 0 ? requestedOutputs : getOutputsInfo(), responseProto, getModelConfig().getPostprocessing());
+    }
+    timer.stop(SERIALIZE);
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Serialization duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("serialize") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(SERIALIZE) / 1000);
 
-    timer.start("postprocess");
-    status = postInferenceProcessing(responseProto, inferRequest, sequence, sequenceProcessingSpec);
-    timer.stop("postprocess");
+    timer.start(POSTPROCESS);
+    status = postInferenceProcessing(responseProto, inferRequest, sequence, sequenceProcessingSpec, executingInferId);
+    timer.stop(POSTPROCESS);
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Postprocessing duration in model {}, version {}, nireq {}: {:.3f} ms",
-        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>("postprocess") / 1000);
+        requestProto->model_spec().name(), getVersion(), executingInferId, timer.elapsed<microseconds>(POSTPROCESS) / 1000);
 
-    sequenceLock.unlock();
-    if (sequenceProcessingSpec.getSequenceControlInput() == SEQUENCE_END) {
-        sequenceManagerLock.lock();
-        status = sequenceManager->removeSequence(sequenceId);
-        if (!status.ok())
-            return status;
-    }
+    return StatusCode::OK;
+}
 
+Status StatefulModelInstance::prepareInferenceRequestsQueue(const ModelConfig& config) {
+    auto status = ModelInstance::prepareInferenceRequestsQueue(config);
+    if (!status.ok())
+        return status;
+    const uint32_t streamsCount = getNumOfParallelInferRequests(config);
+    streamsStateOwners.assign(streamsCount, 0);
+    // At least one infer request is left for sequences which are not bound
+    maxBoundSequences = std::min(config.getMaxBoundSequences(), streamsCount - 1);
+    if (maxBoundSequences < config.getMaxBoundSequences()) {
+        SPDLOG_LOGGER_WARN(modelmanager_logger, "[Model: {} version: {}] Max bound sequences lowered to {} with {} infer requests",
+            getName(), getVersion(), maxBoundSequences, streamsCount);
+    }
+    std::lock_guard<std::mutex> lock(boundStreamsMutex);
+    boundStreams.clear();
     return StatusCode::OK;
 }
 
+void StatefulModelInstance::prepareDynamicBatcher(const ModelConfig& config) {
+    ModelInstance::prepareDynamicBatcher(config);
+    if (!dynamicBatcher)
+        return;
+    try {
+        for (auto&& state : getInferRequestsQueue().getInferRequest(0).QueryState()) {
+            const auto& dims = state.GetState()->getTensorDesc().getDims();
+            if (dims.empty() || dims[0] != config.getMaxBatchSize()) {
+                SPDLOG_LOGGER_WARN(modelmanager_logger, "[Model: {} version: {}] Dynamic batching disabled. Memory state {} does not have batch dimension {}",
+                    getName(), getVersion(), state.GetName(), config.getMaxBatchSize());
+                dynamicBatcher.reset();
+                return;
+            }
+        }
+    } catch (const InferenceEngine::Exception& e) {
+        SPDLOG_LOGGER_WARN(modelmanager_logger, "[Model: {} version: {}] Dynamic batching disabled. Could not query memory state: {}", getName(), getVersion(), e.what());
+        dynamicBatcher.reset();
+    }
+}
+
+bool StatefulModelInstance::reserveBoundStream(int& streamId) {
+    for (bool afterReclaim : {false, true}) {
+        if (afterReclaim) {
+            reclaimBoundStreams();
+        }
+        std::lock_guard<std::mutex> lock(boundStreamsMutex);
+        if (boundStreams.size() < maxBoundSequences && getInferRequestsQueue().tryGetIdleStream(streamId)) {
+            boundStreams[streamId] = 0;
+            streamsStateOwners[streamId] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void StatefulModelInstance::bindStream(int streamId, uint64_t sequenceId) {
+    std::lock_guard<std::mutex> lock(boundStreamsMutex);
+    boundStreams[streamId] = sequenceId;
+}
+
+void StatefulModelInstance::releaseBoundStream(int streamId, uint64_t sequenceId) {
+    {
+        std::lock_guard<std::mutex> lock(boundStreamsMutex);
+        auto it = boundStreams.find(streamId);
+        if (it == boundStreams.end() || it->second != sequenceId)
+            return;
+        boundStreams.erase(it);
+    }
+    getInferRequestsQueue().returnStream(streamId);
+}
+
+void StatefulModelInstance::reclaimBoundStreams() {
+    std::vector<std::pair<int, uint64_t>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(boundStreamsMutex);
+        for (const auto& [streamId, sequenceId] : boundStreams) {
+            if (sequenceId != 0)
+                candidates.emplace_back(streamId, sequenceId);
+        }
+    }
+    for (const auto& [streamId, sequenceId] : candidates) {
+        std::unique_lock<std::mutex> sequencesLock(sequenceManager->getMutex(sequenceId));
+        if (sequenceManager->sequenceExists(sequenceId)) {
+            Sequence& sequence = sequenceManager->getSequence(sequenceId);
+            if (sequence.getBoundStreamId() == streamId) {
+                // Terminated sequence, which failed on its last request, does not hold the stream when the request is not in progress
+                std::unique_lock<std::mutex> sequenceLock(sequence.getMutex(), std::try_to_lock);
+                if (!sequence.isTerminated() || !sequenceLock.owns_lock())
+                    continue;
+            }
+        }
+        sequencesLock.unlock();
+        SPDLOG_DEBUG("Reclaiming infer request {} bound to removed sequence {}", streamId, sequenceId);
+        releaseBoundStream(streamId, sequenceId);
+    }
+}
+
 const Status StatefulModelInstance::preInferenceProcessing(InferenceEngine::InferRequest& inferRequest, Sequence& sequence,
-    SequenceProcessingSpec& sequenceProcessingSpec) {
+    SequenceProcessingSpec& sequenceProcessingSpec, int executingInferId) {
+    // Stream state is not trusted from now on, until postprocessing saves it again
+    uint64_t stateOwner = 0;
+    if (executingInferId >= 0 && static_cast<size_t>(executingInferId) < streamsStateOwners.size()) {
+        stateOwner = streamsStateOwners[executingInferId];
+        streamsStateOwners[executingInferId] = 0;
+    }
+    const bool stateResident = executingInferId >= 0 && (stateOwner == sequence.getId() || sequence.getBoundStreamId() == executingInferId);
     if (sequenceProcessingSpec.getSequenceControlInput() == SEQUENCE_START) {
         // On SEQUENCE_START reset memory state of infer request to default
         for (auto&& state : inferRequest.QueryState()) {
             state.Reset();
         }
-    } else {
+    } else if (!stateResident) {
         // For next requests in the sequence set infer request memory state to the last state saved by the sequence
         const sequence_memory_state_t& sequenceMemoryState = sequence.getMemoryState();
         for (auto&& state : inferRequest.QueryState()) {
@@ -285,28 +632,32 @@ const Status StatefulModelInstance::preInferenceProcessing(InferenceEngine::Infe
                 return StatusCode::INTERNAL_ERROR;
             state.SetState(sequenceMemoryState.at(stateName));
         }
+    } else {
+        SPDLOG_DEBUG("Infer request {} already holds state of sequence {}", executingInferId, sequence.getId());
     }
     return StatusCode::OK;
 }
 
 const Status StatefulModelInstance::postInferenceProcessing(tensorflow::serving::PredictResponse* response,
-    InferenceEngine::InferRequest& inferRequest, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec) {
+    InferenceEngine::InferRequest& inferRequest, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec, int executingInferId) {
     // Reset inferRequest states on SEQUENCE_END
     if (sequenceProcessingSpec.getSequenceControlInput() == SEQUENCE_END) {
         spdlog::debug("Received SEQUENCE_END signal. Reseting model state and removing sequence");
         for (auto&& state : inferRequest.QueryState()) {
             state.Reset();
         }
+    } else if (executingInferId >= 0 && sequence.getBoundStreamId() == executingInferId) {
+        // State stays resident in infer request bound to the sequence
+        sequence.setIdle(false);
     } else {
         auto modelState = inferRequest.QueryState();
-        sequence.updateMemoryState(modelState);
+        auto status = sequence.updateMemoryState(modelState);
+        if (status.ok() && executingInferId >= 0 && static_cast<size_t>(executingInferId) < streamsStateOwners.size()) {
+            streamsStateOwners[executingInferId] = sequence.getId();
+        }
     }
 
-    // Include sequence_id in server response
-    auto& tensorProto = (*response->mutable_outputs())["sequence_id"];
-    tensorProto.mutable_tensor_shape()->add_dim()->set_size(1);
-    tensorProto.set_dtype(tensorflow::DataType::DT_UINT64);
-    tensorProto.add_uint64_val(sequenceProcessingSpec.getSequenceId());
+    addSequenceIdOutput(response, sequenceProcessingSpec.getSequenceId());
 
     return StatusCode::OK;
 }
@@ -16,7 +16,10 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "global_sequences_viewer.hpp"
 #include "modelconfig.hpp"
@@ -25,6 +28,18 @@
 
 namespace ovms {
 
+/**
+ * @brief Sequence held by streaming call for its whole lifetime, resolved once on start of the stream
+ *
+ * Holding sequence manager keeps the sequence valid between steps and detects model reload, which drops all sequences.
+ */
+struct StreamedSequence {
+    std::shared_ptr<SequenceManager> sequenceManager;
+    Sequence* sequence = nullptr;
+    // Requested id before the sequence is started, 0 for generated id, kept after the sequence is ended
+    uint64_t sequenceId = 0;
+};
+
 class StatefulModelInstance : public ModelInstance {
     static constexpr std::array<const char*, 2> SPECIAL_INPUT_NAMES{"sequence_id", "sequence_control_input"};
 
@@ -48,26 +63,68 @@ public:
     /*
     Performs pre inference operations:
         - for SEQUENCE_START control input - reset InferRequest memory state
-        - for SEQUENCE_END control input or for no control input - load sequence memory state into InferRequest
+        - for SEQUENCE_END control input or for no control input - load sequence memory state into InferRequest,
+          skipped when InferRequest of executingInferId stream still holds state saved by the sequence or is bound to it
 
         Always returns StatusCode::OK
     */
-    const Status preInferenceProcessing(InferenceEngine::InferRequest& inferRequest, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec);
+    const Status preInferenceProcessing(InferenceEngine::InferRequest& inferRequest, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec,
+        int executingInferId = -1);
 
     /*
     Performs pre inference operations:
-        - for SEQUENCE_START or for no control input - save InferRequest memory state in sequence memory state
+        - for SEQUENCE_START or for no control input - save InferRequest memory state in sequence memory state,
+          skipped when InferRequest is bound to the sequence
         - for SEQUENCE_END control input - reset InferRequest memory state
         - for all requests - append sequence id to the response
 
         Always returns StatusCode::OK
     */
     const Status postInferenceProcessing(tensorflow::serving::PredictResponse* response,
-        InferenceEngine::InferRequest& inferRequest, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec);
+        InferenceEngine::InferRequest& inferRequest, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec, int executingInferId = -1);
 
     Status infer(const tensorflow::serving::PredictRequest* requestProto,
         tensorflow::serving::PredictResponse* responseProto,
-        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr) override;
+        std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+        const RequestContext& context = RequestContext()) override;
+
+    /**
+         * @brief Runs step of sequence owned by streaming call
+         *
+         * First step starts the sequence, later steps use the sequence resolved by the first one without lookup.
+         * Requests do not carry sequence_id and sequence_control_input inputs.
+         *
+         * @param sequenceEnd ends the sequence after the step
+         *
+         * @return SEQUENCE_MISSING if sequence was dropped by model reload
+         */
+    Status inferStreamed(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto,
+        StreamedSequence& streamedSequence, bool sequenceEnd,
+        const RequestContext& context = RequestContext());
+
+    /**
+         * @brief Removes sequence of closed stream without running inference, must be called under model unload guard
+         */
+    void endStreamedSequence(StreamedSequence& streamedSequence);
+
+    /**
+         * @brief Serializes memory state of sequence, so that the sequence can be continued on other server
+         *
+         * Waits for request of the sequence in progress. State of sequence bound to infer request is read from the infer request.
+         *
+         * @param removeSequence removes the sequence after export, so it is continued only where it is imported
+         *
+         * @return SEQUENCE_MISSING if sequence does not exist or is owned by streaming call
+         */
+    Status exportSequence(uint64_t sequenceId, std::string& serialized, bool removeSequence = false);
+
+    /**
+         * @brief Creates sequence with given id and memory state serialized by exportSequence, next request continues it
+         *
+         * @return SEQUENCE_STATE_INVALID if serialized state is malformed
+         */
+    Status importSequence(uint64_t sequenceId, const std::string& serialized);
 
     Status loadModel(const ModelConfig& config) override;
 
@@ -86,16 +143,92 @@ protected:
 
     GlobalSequencesViewer* globalSequencesViewer;
 
+    /**
+         * @brief Id of sequence whose saved state is held by infer request of stream, 0 when unknown
+         *
+         * Entry is accessed only by the holder of the stream.
+         */
+    std::vector<uint64_t> streamsStateOwners;
+
+    /**
+         * @brief Streams taken out of the queue for sequences with id of the sequence, 0 while sequence is being created
+         */
+    std::unordered_map<int, uint64_t> boundStreams;
+    std::mutex boundStreamsMutex;
+
+    /**
+         * @brief Limit of bound streams, lower than number of infer requests
+         */
+    uint32_t maxBoundSequences = 0;
+
+    /**
+         * @brief Takes idle stream out of the queue for new sequence, reclaiming streams of removed sequences when limit is reached
+         *
+         * @return false if sequence has to share infer requests with other sequences
+         */
+    bool reserveBoundStream(int& streamId);
+
+    /**
+         * @brief Marks reserved stream as owned by created sequence, must not be called under sequence manager lock
+         */
+    void bindStream(int streamId, uint64_t sequenceId);
+
+    /**
+         * @brief Returns stream to the queue if it is still bound to the sequence
+         */
+    void releaseBoundStream(int streamId, uint64_t sequenceId);
+
+    /**
+         * @brief Returns streams of sequences removed by idle sequence cleanup or terminated without removal
+         */
+    void reclaimBoundStreams();
+
     const Status validate(const tensorflow::serving::PredictRequest* request, SequenceProcessingSpec& processingSpec);
 
+    const Status validateModelInputs(const tensorflow::serving::PredictRequest* request);
+
     const Status validateNumberOfInputs(const tensorflow::serving::PredictRequest* request,
         const size_t expectedNumberOfInputs) override;
 
     Status loadModelImpl(const ModelConfig& config, const DynamicModelParameter& parameter = DynamicModelParameter()) override;
 
+    uint64_t getSequenceStatesMemoryBytes() override;
+
     Status loadOVExecutableNetwork(const ModelConfig& config) override;
 
+    Status prepareInferenceRequestsQueue(const ModelConfig& config) override;
+
+    /**
+         * @brief Prepares dynamic batcher if memory states have batch dimension of max batch size
+         */
+    void prepareDynamicBatcher(const ModelConfig& config) override;
+
 private:
+    /**
+         * @brief Resolves or creates sequence of the request and locks it
+         */
+    Status openSequence(SequenceProcessingSpec& sequenceProcessingSpec, Sequence*& sequence,
+        std::unique_lock<std::mutex>& sequenceLock, bool streamed);
+
+    /**
+         * @brief Runs inference for locked sequence, unlocks it and removes the sequence on SEQUENCE_END
+         */
+    Status runSequenceStep(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec,
+        std::unique_lock<std::mutex>& sequenceLock, const RequestContext& context);
+
+    /**
+         * @brief Removes sequence and returns its bound infer request
+         */
+    Status closeSequence(uint64_t sequenceId, int boundStreamId);
+
+    /**
+         * @brief Runs sequence step on its own infer request, bound to the sequence or taken from the queue
+         */
+    Status inferWithStream(const tensorflow::serving::PredictRequest* requestProto,
+        tensorflow::serving::PredictResponse* responseProto, Sequence& sequence, SequenceProcessingSpec& sequenceProcessingSpec,
+        int boundStreamId, const RequestContext& context);
+
     const Status validateSpecialKeys(const tensorflow::serving::PredictRequest* request, SequenceProcessingSpec& sequenceProcessingSpec);
 };
 }  // namespace ovms
@@ -18,7 +18,23 @@
 
 namespace ovms {
 
-const std::unordered_map<const StatusCode, const std::string> Status::statusMessageMap = {
+namespace {
+constexpr size_t STATUS_TABLE_SIZE = static_cast<size_t>(StatusCode::STATUS_CODE_END) + 1;
+
+/**
+ * @brief Builds table indexed by status code at compile time, codes missing in entries get empty value
+ */
+template <typename T, size_t N>
+constexpr std::array<T, STATUS_TABLE_SIZE> makeStatusTable(const std::pair<StatusCode, T> (&entries)[N]) {
+    std::array<T, STATUS_TABLE_SIZE> table{};
+    for (size_t i = 0; i < N; ++i) {
+        table[static_cast<size_t>(entries[i].first)] = entries[i].second;
+    }
+    return table;
+}
+}  // namespace
+
+const std::array<const char*, Status::TABLE_SIZE> Status::statusMessageTable = makeStatusTable<const char*>({
     {StatusCode::OK, ""},
 
     {StatusCode::PATH_INVALID, "The provided base path is invalid or doesn't exists"},
@@ -51,6 +67,9 @@ const std::unordered_map<const StatusCode, const std::string> Status::statusMess
     {StatusCode::INVALID_SIGNATURE_DEF, "Invalid signature name"},
     {StatusCode::CONFIG_SHAPE_IS_NOT_IN_NETWORK, "Shape from config not found in network"},
     {StatusCode::CONFIG_LAYOUT_IS_NOT_IN_NETWORK, "Layout from config not found in network"},
+    {StatusCode::CONFIG_REQUEST_PRECISION_NOT_SUPPORTED, "Request precision from config not found in network or not convertible to network input precision"},
+    {StatusCode::CONFIG_PREPROCESSING_NOT_SUPPORTED, "Preprocessing from config not found in network or not matching network input layout or channels"},
+    {StatusCode::CONFIG_POSTPROCESSING_NOT_SUPPORTED, "Postprocessing from config not found in network or network output is not FP32 with batch dimension"},
     {StatusCode::INVALID_NIREQ, "Nireq parameter too high"},
     {StatusCode::REQUESTED_DYNAMIC_PARAMETERS_ON_SUBSCRIBED_MODEL, "Requested dynamic parameters but model is used in pipeline"},
     {StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET, "Node is not ready for execution"},
@@ -58,6 +77,26 @@ const std::unordered_map<const StatusCode, const std::string> Status::statusMess
     {StatusCode::REQUESTED_STATEFUL_PARAMETERS_ON_SUBSCRIBED_MODEL, "Stateful model cannot be subscribed to pipeline"},
     {StatusCode::INVALID_NON_STATEFUL_MODEL_PARAMETER, "Stateful model config parameter used for non stateful model"},
     {StatusCode::INVALID_MAX_SEQUENCE_NUMBER, "Sequence max number parameter too high"},
+    {StatusCode::INVALID_MAX_BOUND_SEQUENCES, "Max bound sequences parameter too high"},
+    {StatusCode::INVALID_IDLE_SEQUENCE_TIMEOUT, "Idle sequence timeout parameter too high"},
+    {StatusCode::INVALID_IDLE_SEQUENCE_COMPRESSION, "Idle sequence compression parameter too high"},
+    {StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS, "Invalid dynamic batching parameters"},
+    {StatusCode::INVALID_QUEUE_LIMIT, "Infer request queue limit parameter too high"},
+    {StatusCode::INVALID_SHAPE_CACHE_SIZE, "Shape cache size parameter too high or set without any input shape set to auto, or shape cache prewarm set without shape cache size"},
+    {StatusCode::INVALID_BATCH_SIZE_VARIANTS, "Batch size variants have to be positive integers and require batch size set to auto"},
+    {StatusCode::INVALID_SEQUENCE_LENGTH_BUCKETS, "Sequence length buckets have to be positive integers and cannot be combined with auto or stateful parameters"},
+    {StatusCode::INVALID_LATENCY_PROFILE, "Latency profile requires positive nireq and batch size and cannot be combined with stateful parameter"},
+    {StatusCode::INVALID_WARMUP_ITERATIONS, "Warmup iterations parameter too high"},
+    {StatusCode::INVALID_AUTO_TUNE_MAX_LATENCY, "Auto tune max latency parameter too high"},
+    {StatusCode::INVALID_LAZY_LOADING, "Lazy loading is not supported for stateful models"},
+    {StatusCode::INVALID_RESPONSE_CACHE_SIZE, "Response cache size parameter too high or set for stateful model"},
+    {StatusCode::INVALID_COALESCE_REQUESTS, "Request coalescing is not supported for stateful models"},
+    {StatusCode::INVALID_FALLBACK, "Fallback model is not supported for stateful models and has to differ from the model itself"},
+    {StatusCode::INVALID_BATCH_SPLIT_PARALLELISM, "Batch split parallelism parameter too high or set for stateful model"},
+    {StatusCode::INVALID_SCHEDULING_PARAMS, "Scheduling weight should be positive and both it and max concurrent inferences should fit unsigned int"},
+    {StatusCode::INVALID_REQUEST_PRECISION, "Request precision has to be FP32"},
+    {StatusCode::INVALID_PREPROCESSING, "Invalid preprocessing resize algorithm, color format or mean and scale values"},
+    {StatusCode::INVALID_POSTPROCESSING, "Invalid postprocessing type or its parameters"},
 
     // Sequence management
     {StatusCode::SEQUENCE_MISSING, "Sequence with provided ID does not exist"},
@@ -69,16 +108,39 @@ const std::unordered_map<const StatusCode, const std::string> Status::statusMess
     {StatusCode::SEQUENCE_TERMINATED, "Sequence last request is being processed and it's not available anymore"},
     {StatusCode::SPECIAL_INPUT_NO_TENSOR_SHAPE, "Special input proto does not contain tensor shape information"},
     {StatusCode::MAX_SEQUENCE_NUMBER_REACHED, "Max sequence number has been reached. Could not create new sequence."},
+    {StatusCode::SEQUENCE_STREAM_STATELESS_MODEL, "Sequence stream requires stateful model"},
+    {StatusCode::SEQUENCE_STATE_STATELESS_MODEL, "Sequence state export and import require stateful model"},
+    {StatusCode::SEQUENCE_STATE_INVALID, "Imported sequence state is malformed"},
+
+    // Peer model file serving
+    {StatusCode::PEER_FILE_SERVING_DISABLED, "Serving remote model cache files to peers is disabled"},
+    {StatusCode::PEER_FILE_NOT_FOUND, "Requested file is not in remote model cache"},
+    {StatusCode::PEER_FILE_RANGE_INVALID, "Requested byte range is outside of file or too long"},
 
     // Predict request validation
     {StatusCode::INVALID_NO_OF_INPUTS, "Invalid number of inputs"},
     {StatusCode::INVALID_MISSING_INPUT, "Missing input with specific name"},
+    {StatusCode::INVALID_OUTPUT_FILTER, "Invalid output filter"},
+    {StatusCode::GRPC_REQUEST_PARSING_FAILED, "Failed to parse gRPC request message"},
     {StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS, "Invalid number of shape dimensions"},
     {StatusCode::INVALID_BATCH_SIZE, "Invalid input batch size"},
     {StatusCode::INVALID_SHAPE, "Invalid input shape"},
     {StatusCode::INVALID_PRECISION, "Invalid input precision"},
     {StatusCode::INVALID_VALUE_COUNT, "Invalid number of values in tensor proto container"},
     {StatusCode::INVALID_CONTENT_SIZE, "Invalid content size of tensor proto"},
+    {StatusCode::INVALID_SPARSE_TENSOR, "Invalid indices or values of sparse tensor"},
+
+    // Shared memory
+    {StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, "Shared memory region is not registered"},
+    {StatusCode::SHARED_MEMORY_REGION_ALREADY_REGISTERED, "Shared memory region with the same name is already registered"},
+    {StatusCode::SHARED_MEMORY_MAPPING_FAILED, "Shared memory object cannot be opened or mapped"},
+    {StatusCode::SHARED_MEMORY_INVALID_OUTPUTS, "Invalid list of outputs requested in shared memory"},
+
+    // KServe inference protocol
+    {StatusCode::KFS_UNSUPPORTED_DATATYPE, "Unsupported tensor datatype"},
+    {StatusCode::KFS_INVALID_MODEL_VERSION, "Could not parse model version"},
+    {StatusCode::KFS_INVALID_INPUT_CONTENTS, "Invalid input contents"},
+    {StatusCode::KFS_INVALID_STREAM_PARAMETER, "Invalid frame stream parameter"},
     {StatusCode::UNSUPPORTED_LAYOUT, "Received binary image input but resource not configured to accept NHWC layout"},
 
     // Deserialization
@@ -87,6 +149,11 @@ const std::unordered_map<const StatusCode, const std::string> Status::statusMess
 
     // Inference
     {StatusCode::OV_INTERNAL_INFERENCE_ERROR, "Internal inference error"},
+    {StatusCode::REQUEST_DEADLINE_EXCEEDED, "Request deadline exceeded before inference was started"},
+    {StatusCode::INFER_REQUEST_QUEUE_FULL, "Too many requests waiting for inference, try again later"},
+    {StatusCode::INFER_REQUEST_QUEUE_TIMEOUT, "Request waited for inference longer than allowed, try again later"},
+    {StatusCode::REQUEST_CANCELLED, "Request cancelled by client"},
+    {StatusCode::SERVER_NOT_READY, "Server is not ready yet, models are still loading"},
 
     // Serialization
     {StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION, "Unsupported serialization precision"},
@@ -98,6 +165,10 @@ const std::unordered_map<const StatusCode, const std::string> Status::statusMess
     // Rest handler failure
     {StatusCode::REST_INVALID_URL, "Invalid request URL"},
     {StatusCode::REST_UNSUPPORTED_METHOD, "Unsupported method"},
+    {StatusCode::REST_REQUEST_BODY_TOO_LARGE, "Request body exceeds maximum allowed size"},
+    {StatusCode::REST_UNSUPPORTED_CONTENT_ENCODING, "Unsupported Content-Encoding of request body"},
+    {StatusCode::REST_DECOMPRESSION_FAILED, "Could not decompress request body"},
+    {StatusCode::REST_UNSUPPORTED_CONTENT_TYPE, "Unsupported Content-Type of request body"},
 
     // Rest parser failure
     {StatusCode::REST_BODY_IS_NOT_AN_OBJECT, "Request body should be JSON object"},
@@ -152,6 +223,13 @@ const std::unordered_map<const StatusCode, const std::string> Status::statusMess
     {StatusCode::PIPELINE_WRONG_DEMULTIPLEXER_GATHER_NODES_ORDER, "Demultiplexer and gather nodes are not in LIFO order"},
     {StatusCode::PIPELINE_DEMULTIPLEXER_NO_RESULTS, "Pipeline execution aborted due to no content from custom node"},
     {StatusCode::PIPELINE_INPUTS_AMBIGUOUS_METADATA, "Multiple nodes connected to the same pipeline input require different tensor metadata"},
+    {StatusCode::PIPELINE_INVALID_ROI_INPUT, "Region of interest input refers to invalid model input or coordinates input"},
+    {StatusCode::PIPELINE_INVALID_ROI_COORDINATES, "Region of interest coordinates are invalid or outside of image"},
+    {StatusCode::PIPELINE_INVALID_CONDITION, "Node condition cannot be used in pipeline with demultiplexing"},
+    {StatusCode::PIPELINE_INVALID_CONDITION_VALUE, "Node condition tensor needs to have exactly one element"},
+    {StatusCode::PIPELINE_OUTPUTS_AMBIGUOUS_METADATA, "Multiple nodes connected to the same pipeline output produce different tensor metadata"},
+    {StatusCode::PIPELINE_REMOTE_MODEL_UNAVAILABLE, "Remote model of pipeline node is unavailable"},
+    {StatusCode::PIPELINE_REMOTE_INFERENCE_FAILED, "Inference of remote model of pipeline node failed"},
 
     // Storage errors
     // S3
@@ -200,9 +278,10 @@ const std::unordered_map<const StatusCode, const std::string> Status::statusMess
     {StatusCode::INVALID_NO_OF_CHANNELS, "Invalid number of channels in binary input"},
     {StatusCode::BINARY_IMAGES_RESOLUTION_MISMATCH, "Binary input images for this pipeline are required to have the same resolution"},
     {StatusCode::STRING_VAL_EMPTY, "String val is empty"},
-};
+    {StatusCode::IMAGE_DECODER_LIBRARY_LOAD_FAILED, "Image decoder library not found or does not export decodeImages"},
+});
 
-const std::unordered_map<const StatusCode, grpc::StatusCode> Status::grpcStatusMap = {
+const std::array<std::optional<grpc::StatusCode>, Status::TABLE_SIZE> Status::grpcStatusTable = makeStatusTable<std::optional<grpc::StatusCode>>({
     {StatusCode::OK, grpc::StatusCode::OK},
 
     {StatusCode::PATH_INVALID, grpc::StatusCode::INTERNAL},
@@ -227,6 +306,7 @@ const std::unordered_map<const StatusCode, grpc::StatusCode> Status::grpcStatusM
     {StatusCode::MODEL_SPEC_MISSING, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_SIGNATURE_DEF, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::PIPELINE_DEMULTIPLEXER_NO_RESULTS, grpc::StatusCode::ABORTED},
+    {StatusCode::PIPELINE_REMOTE_INFERENCE_FAILED, grpc::StatusCode::UNAVAILABLE},
     {StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE, grpc::StatusCode::FAILED_PRECONDITION},
 
     // Sequence management
@@ -239,16 +319,39 @@ const std::unordered_map<const StatusCode, grpc::StatusCode> Status::grpcStatusM
     {StatusCode::SEQUENCE_TERMINATED, grpc::StatusCode::FAILED_PRECONDITION},
     {StatusCode::SPECIAL_INPUT_NO_TENSOR_SHAPE, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::MAX_SEQUENCE_NUMBER_REACHED, grpc::StatusCode::UNAVAILABLE},
+    {StatusCode::SEQUENCE_STREAM_STATELESS_MODEL, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::SEQUENCE_STATE_STATELESS_MODEL, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::SEQUENCE_STATE_INVALID, grpc::StatusCode::INVALID_ARGUMENT},
+
+    // Peer model file serving
+    {StatusCode::PEER_FILE_SERVING_DISABLED, grpc::StatusCode::NOT_FOUND},
+    {StatusCode::PEER_FILE_NOT_FOUND, grpc::StatusCode::NOT_FOUND},
+    {StatusCode::PEER_FILE_RANGE_INVALID, grpc::StatusCode::OUT_OF_RANGE},
 
     // Predict request validation
     {StatusCode::INVALID_NO_OF_INPUTS, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_MISSING_INPUT, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::INVALID_OUTPUT_FILTER, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::GRPC_REQUEST_PARSING_FAILED, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::PIPELINE_INVALID_ROI_COORDINATES, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::PIPELINE_INVALID_CONDITION_VALUE, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_BATCH_SIZE, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_SHAPE, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_PRECISION, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_VALUE_COUNT, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_CONTENT_SIZE, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::INVALID_SPARSE_TENSOR, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, grpc::StatusCode::NOT_FOUND},
+    {StatusCode::SHARED_MEMORY_REGION_ALREADY_REGISTERED, grpc::StatusCode::ALREADY_EXISTS},
+    {StatusCode::SHARED_MEMORY_MAPPING_FAILED, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::SHARED_MEMORY_INVALID_OUTPUTS, grpc::StatusCode::INVALID_ARGUMENT},
+
+    // KServe inference protocol
+    {StatusCode::KFS_UNSUPPORTED_DATATYPE, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::KFS_INVALID_MODEL_VERSION, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::KFS_INVALID_INPUT_CONTENTS, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::KFS_INVALID_STREAM_PARAMETER, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::UNSUPPORTED_LAYOUT, grpc::StatusCode::INVALID_ARGUMENT},
 
     // Deserialization
@@ -259,6 +362,11 @@ const std::unordered_map<const StatusCode, grpc::StatusCode> Status::grpcStatusM
 
     // Inference
     {StatusCode::OV_INTERNAL_INFERENCE_ERROR, grpc::StatusCode::INTERNAL},
+    {StatusCode::REQUEST_DEADLINE_EXCEEDED, grpc::StatusCode::DEADLINE_EXCEEDED},
+    {StatusCode::INFER_REQUEST_QUEUE_FULL, grpc::StatusCode::RESOURCE_EXHAUSTED},
+    {StatusCode::INFER_REQUEST_QUEUE_TIMEOUT, grpc::StatusCode::RESOURCE_EXHAUSTED},
+    {StatusCode::REQUEST_CANCELLED, grpc::StatusCode::CANCELLED},
+    {StatusCode::SERVER_NOT_READY, grpc::StatusCode::UNAVAILABLE},
 
     // Serialization
 
@@ -273,9 +381,9 @@ const std::unordered_map<const StatusCode, grpc::StatusCode> Status::grpcStatusM
     {StatusCode::INVALID_NO_OF_CHANNELS, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::BINARY_IMAGES_RESOLUTION_MISMATCH, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::STRING_VAL_EMPTY, grpc::StatusCode::INVALID_ARGUMENT},
-};
+});
 
-const std::unordered_map<const StatusCode, net_http::HTTPStatusCode> Status::httpStatusMap = {
+const std::array<std::optional<net_http::HTTPStatusCode>, Status::TABLE_SIZE> Status::httpStatusTable = makeStatusTable<std::optional<net_http::HTTPStatusCode>>({
     {StatusCode::OK, net_http::HTTPStatusCode::OK},
     {StatusCode::OK_RELOADED, net_http::HTTPStatusCode::CREATED},
     {StatusCode::OK_NOT_RELOADED, net_http::HTTPStatusCode::OK},
@@ -283,6 +391,10 @@ const std::unordered_map<const StatusCode, net_http::HTTPStatusCode> Status::htt
     // REST handler failure
     {StatusCode::REST_INVALID_URL, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::REST_UNSUPPORTED_METHOD, net_http::HTTPStatusCode::NONE_ACC},
+    {StatusCode::REST_REQUEST_BODY_TOO_LARGE, net_http::HTTPStatusCode::PAYLOAD_TOO_LARGE},
+    {StatusCode::REST_UNSUPPORTED_CONTENT_ENCODING, net_http::HTTPStatusCode::UNSUPPORTED_MEDIA},
+    {StatusCode::REST_DECOMPRESSION_FAILED, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::REST_UNSUPPORTED_CONTENT_TYPE, net_http::HTTPStatusCode::UNSUPPORTED_MEDIA},
 
     // REST parser failure
     {StatusCode::REST_BODY_IS_NOT_AN_OBJECT, net_http::HTTPStatusCode::BAD_REQUEST},
@@ -323,6 +435,7 @@ const std::unordered_map<const StatusCode, net_http::HTTPStatusCode> Status::htt
     {StatusCode::MODEL_SPEC_MISSING, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_SIGNATURE_DEF, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::PIPELINE_DEMULTIPLEXER_NO_RESULTS, net_http::HTTPStatusCode::NO_CONTENT},
+    {StatusCode::PIPELINE_REMOTE_INFERENCE_FAILED, net_http::HTTPStatusCode::SERVICE_UNAV},
     {StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE, net_http::HTTPStatusCode::PRECOND_FAILED},
 
     // Sequence management
@@ -335,16 +448,39 @@ const std::unordered_map<const StatusCode, net_http::HTTPStatusCode> Status::htt
     {StatusCode::SEQUENCE_TERMINATED, net_http::HTTPStatusCode::PRECOND_FAILED},
     {StatusCode::SPECIAL_INPUT_NO_TENSOR_SHAPE, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::MAX_SEQUENCE_NUMBER_REACHED, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::SEQUENCE_STREAM_STATELESS_MODEL, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::SEQUENCE_STATE_STATELESS_MODEL, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::SEQUENCE_STATE_INVALID, net_http::HTTPStatusCode::BAD_REQUEST},
+
+    // Peer model file serving
+    {StatusCode::PEER_FILE_SERVING_DISABLED, net_http::HTTPStatusCode::NOT_FOUND},
+    {StatusCode::PEER_FILE_NOT_FOUND, net_http::HTTPStatusCode::NOT_FOUND},
+    {StatusCode::PEER_FILE_RANGE_INVALID, net_http::HTTPStatusCode::BAD_REQUEST},
 
     // Predict request validation
     {StatusCode::INVALID_NO_OF_INPUTS, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_MISSING_INPUT, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::INVALID_OUTPUT_FILTER, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::GRPC_REQUEST_PARSING_FAILED, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::PIPELINE_INVALID_ROI_COORDINATES, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::PIPELINE_INVALID_CONDITION_VALUE, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_BATCH_SIZE, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_SHAPE, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_PRECISION, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_VALUE_COUNT, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_CONTENT_SIZE, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::INVALID_SPARSE_TENSOR, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, net_http::HTTPStatusCode::NOT_FOUND},
+    {StatusCode::SHARED_MEMORY_REGION_ALREADY_REGISTERED, net_http::HTTPStatusCode::CONFLICT},
+    {StatusCode::SHARED_MEMORY_MAPPING_FAILED, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::SHARED_MEMORY_INVALID_OUTPUTS, net_http::HTTPStatusCode::BAD_REQUEST},
+
+    // KServe inference protocol
+    {StatusCode::KFS_UNSUPPORTED_DATATYPE, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::KFS_INVALID_MODEL_VERSION, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::KFS_INVALID_INPUT_CONTENTS, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::KFS_INVALID_STREAM_PARAMETER, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::UNSUPPORTED_LAYOUT, net_http::HTTPStatusCode::BAD_REQUEST},
 
     // Deserialization
@@ -355,6 +491,11 @@ const std::unordered_map<const StatusCode, net_http::HTTPStatusCode> Status::htt
 
     // Inference
     {StatusCode::OV_INTERNAL_INFERENCE_ERROR, net_http::HTTPStatusCode::ERROR},
+    {StatusCode::REQUEST_DEADLINE_EXCEEDED, net_http::HTTPStatusCode::REQUEST_TO},
+    {StatusCode::INFER_REQUEST_QUEUE_FULL, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::INFER_REQUEST_QUEUE_TIMEOUT, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::REQUEST_CANCELLED, net_http::HTTPStatusCode::REQUEST_TO},
+    {StatusCode::SERVER_NOT_READY, net_http::HTTPStatusCode::SERVICE_UNAV},
 
     // Serialization
 
@@ -369,6 +510,17 @@ const std::unordered_map<const StatusCode, net_http::HTTPStatusCode> Status::htt
     {StatusCode::INVALID_NO_OF_CHANNELS, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::BINARY_IMAGES_RESOLUTION_MISMATCH, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::STRING_VAL_EMPTY, net_http::HTTPStatusCode::BAD_REQUEST},
-};
+});
+
+const std::string& Status::getDefaultMessage(StatusCode code) {
+    static const std::array<std::string, TABLE_SIZE> messages = []() {
+        std::array<std::string, TABLE_SIZE> messages;
+        for (size_t i = 0; i < TABLE_SIZE; ++i) {
+            messages[i] = statusMessageTable[i] != nullptr ? statusMessageTable[i] : "Unknown error";
+        }
+        return messages;
+    }();
+    return messages[index(code)];
+}
 
 }  // namespace ovms
@@ -15,8 +15,10 @@
 //*****************************************************************************
 #pragma once
 
+#include <array>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -59,6 +61,9 @@ enum class StatusCode {
     ANONYMOUS_FIXED_LAYOUT_NOT_ALLOWED,     /*!< Anonymous fixed layout is invalid for models with multiple inputs */
     CONFIG_SHAPE_IS_NOT_IN_NETWORK,         /*!< Configured tensor shape is not present in network */
     CONFIG_LAYOUT_IS_NOT_IN_NETWORK,        /*!< Configured tensor layout is not present in network */
+    CONFIG_REQUEST_PRECISION_NOT_SUPPORTED, /*!< Configured request precision input is missing or cannot be converted to its network precision */
+    CONFIG_PREPROCESSING_NOT_SUPPORTED,     /*!< Configured preprocessing input is missing or does not match its layout or channels */
+    CONFIG_POSTPROCESSING_NOT_SUPPORTED,    /*!< Configured postprocessing output is missing or is not FP32 with batch dimension */
     CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE, /*!< Cannot load network into target device */
     REQUESTED_DYNAMIC_PARAMETERS_ON_SUBSCRIBED_MODEL,
 
@@ -76,6 +81,26 @@ enum class StatusCode {
     REQUESTED_MODEL_TYPE_CHANGE,                       /*!< Model type cannot be changed after it's loaded */
     INVALID_NON_STATEFUL_MODEL_PARAMETER,              /*!< Stateful model config parameter used for non stateful model */
     INVALID_MAX_SEQUENCE_NUMBER,                       /*!< Sequence max number parameter too high */
+    INVALID_MAX_BOUND_SEQUENCES,                       /*!< Max bound sequences parameter too high */
+    INVALID_IDLE_SEQUENCE_TIMEOUT,                     /*!< Idle sequence timeout parameter too high */
+    INVALID_IDLE_SEQUENCE_COMPRESSION,                 /*!< Idle sequence compression parameter too high */
+    INVALID_DYNAMIC_BATCHING_PARAMETERS,               /*!< Dynamic batching config parameters are invalid */
+    INVALID_QUEUE_LIMIT,                               /*!< Infer request queue limit parameter too high */
+    INVALID_SHAPE_CACHE_SIZE,                          /*!< Shape cache size invalid or set without any shape auto input */
+    INVALID_BATCH_SIZE_VARIANTS,                       /*!< Batch size variants invalid or set without batch size auto */
+    INVALID_SEQUENCE_LENGTH_BUCKETS,                   /*!< Sequence length buckets invalid or combined with dynamic shapes */
+    INVALID_LATENCY_PROFILE,                           /*!< Latency profile invalid or combined with stateful model */
+    INVALID_WARMUP_ITERATIONS,                         /*!< Warmup iterations parameter too high */
+    INVALID_AUTO_TUNE_MAX_LATENCY,                     /*!< Auto tune max latency parameter too high */
+    INVALID_LAZY_LOADING,                              /*!< Lazy loading requested for stateful model */
+    INVALID_RESPONSE_CACHE_SIZE,                       /*!< Response cache size invalid or set for stateful model */
+    INVALID_COALESCE_REQUESTS,                         /*!< Request coalescing requested for stateful model */
+    INVALID_FALLBACK,                                  /*!< Fallback model set for stateful model or pointing to the model itself */
+    INVALID_BATCH_SPLIT_PARALLELISM,                   /*!< Batch split parallelism too high or set for stateful model */
+    INVALID_SCHEDULING_PARAMS,                         /*!< Scheduling weight or max concurrent inferences invalid */
+    INVALID_REQUEST_PRECISION,                         /*!< Request precision other than FP32 */
+    INVALID_PREPROCESSING,                             /*!< Unknown resize algorithm or color format, or invalid mean and scale values */
+    INVALID_POSTPROCESSING,                            /*!< Unknown postprocessing type or invalid parameters of it */
 
     // Sequence management
     SEQUENCE_MISSING,                /*!< Sequence with provided ID does not exist */
@@ -87,17 +112,40 @@ enum class StatusCode {
     SEQUENCE_TERMINATED,             /*!< Sequence last request is being processed and it's not available anymore */
     SPECIAL_INPUT_NO_TENSOR_SHAPE,   /*!< Special input proto does not contain tensor shape information */
     MAX_SEQUENCE_NUMBER_REACHED,     /*!< Model handles maximum number of sequences and will not accept new ones */
+    SEQUENCE_STREAM_STATELESS_MODEL, /*!< Sequence stream requested for model which is not stateful */
+    SEQUENCE_STATE_STATELESS_MODEL,  /*!< Sequence state export or import requested for model which is not stateful */
+    SEQUENCE_STATE_INVALID,          /*!< Imported sequence state is malformed */
+
+    // Peer model file serving
+    PEER_FILE_SERVING_DISABLED, /*!< Server does not serve remote model cache files to peers */
+    PEER_FILE_NOT_FOUND,        /*!< Requested file is not in remote model cache */
+    PEER_FILE_RANGE_INVALID,    /*!< Requested byte range is outside of file or too long */
 
     // Predict request validation
     INVALID_NO_OF_INPUTS,           /*!< Invalid number of inputs */
     INVALID_MISSING_INPUT,          /*!< Missing one or more of inputs */
     INVALID_MISSING_OUTPUT,         /*!< Missing one or more of outputs */
+    INVALID_OUTPUT_FILTER,          /*!< Output filter lists unknown output or is not a list of output names */
+    GRPC_REQUEST_PARSING_FAILED,    /*!< Serialized gRPC request message is malformed */
     INVALID_NO_OF_SHAPE_DIMENSIONS, /*!< Invalid number of shape dimensions */
     INVALID_BATCH_SIZE,             /*!< Input batch size other than required */
     INVALID_SHAPE,                  /*!< Invalid shape dimension number or dimension value */
     INVALID_PRECISION,              /*!< Invalid precision */
     INVALID_VALUE_COUNT,            /*!< Invalid value count error status for uint16 and half float data types */
     INVALID_CONTENT_SIZE,           /*!< Invalid content size error status for types using tensor_content() */
+    INVALID_SPARSE_TENSOR,          /*!< Indices or values of sparse tensor do not match its dense shape */
+
+    // Shared memory
+    SHARED_MEMORY_REGION_NOT_FOUND,          /*!< Request references shared memory region which is not registered */
+    SHARED_MEMORY_REGION_ALREADY_REGISTERED, /*!< Shared memory region with the same name is already registered */
+    SHARED_MEMORY_MAPPING_FAILED,            /*!< Shared memory object cannot be opened or mapped */
+    SHARED_MEMORY_INVALID_OUTPUTS,           /*!< Malformed list of outputs requested in shared memory */
+
+    // KServe inference protocol
+    KFS_UNSUPPORTED_DATATYPE,     /*!< Tensor datatype is unknown or not supported */
+    KFS_INVALID_MODEL_VERSION,    /*!< Model version is not a non negative integer */
+    KFS_INVALID_INPUT_CONTENTS,   /*!< Input data is missing or does not match inputs declared in request */
+    KFS_INVALID_STREAM_PARAMETER, /*!< Parameter of frame stream has wrong type or value */
 
     // Deserialization
     OV_UNSUPPORTED_DESERIALIZATION_PRECISION, /*!< Unsupported deserialization precision, theoretically should never be returned since ModelInstance::validation checks against network precision */
@@ -105,6 +153,11 @@ enum class StatusCode {
 
     // Inference
     OV_INTERNAL_INFERENCE_ERROR, /*!< Error occured during inference */
+    REQUEST_DEADLINE_EXCEEDED,   /*!< Request deadline passed before inference was started */
+    INFER_REQUEST_QUEUE_FULL,    /*!< Too many requests waiting for idle infer request */
+    INFER_REQUEST_QUEUE_TIMEOUT, /*!< Request waited for idle infer request longer than allowed */
+    REQUEST_CANCELLED,           /*!< Client cancelled the request before inference was completed */
+    SERVER_NOT_READY,            /*!< Server is still loading models required to be ready */
 
     // Serialization
     OV_UNSUPPORTED_SERIALIZATION_PRECISION, /*!< Unsupported serializaton precision */
@@ -163,6 +216,10 @@ enum class StatusCode {
     REST_INVALID_URL,                /*!< Malformed REST request url */
     REST_UNSUPPORTED_METHOD,         /*!< Request sent with unsupported method */
     REST_MALFORMED_REQUEST,          /*!< Malformed REST request */
+    REST_REQUEST_BODY_TOO_LARGE,     /*!< REST request body exceeds configured limit */
+    REST_UNSUPPORTED_CONTENT_ENCODING, /*!< REST request body sent with unsupported Content-Encoding */
+    REST_DECOMPRESSION_FAILED,       /*!< Could not decompress REST request body */
+    REST_UNSUPPORTED_CONTENT_TYPE,   /*!< REST request body sent with Content-Type not accepted by the endpoint */
     UNKNOWN_REQUEST_COMPONENTS_TYPE, /*!< Components type not recognized */
 
     // REST Parse
@@ -225,6 +282,13 @@ enum class StatusCode {
     PIPELINE_WRONG_DEMULTIPLEXER_GATHER_NODES_ORDER,
     PIPELINE_DEMULTIPLEXER_NO_RESULTS,
     PIPELINE_INPUTS_AMBIGUOUS_METADATA,
+    PIPELINE_INVALID_ROI_INPUT,
+    PIPELINE_INVALID_ROI_COORDINATES,
+    PIPELINE_INVALID_CONDITION,
+    PIPELINE_INVALID_CONDITION_VALUE,
+    PIPELINE_OUTPUTS_AMBIGUOUS_METADATA,
+    PIPELINE_REMOTE_MODEL_UNAVAILABLE,
+    PIPELINE_REMOTE_INFERENCE_FAILED,
 
     // Custom Loader
     CUSTOM_LOADER_LIBRARY_INVALID,
@@ -248,6 +312,7 @@ enum class StatusCode {
     NODE_LIBRARY_INVALID_CONTENT_SIZE,
     NODE_LIBRARY_METADATA_FAILED,
     NODE_LIBRARY_OUTPUT_MISSING_NAME,
+    NODE_LIBRARY_INITIALIZE_FAILED,
 
     // Binary inputs
     IMAGE_PARSING_FAILED,
@@ -255,6 +320,7 @@ enum class StatusCode {
     INVALID_NO_OF_CHANNELS,
     BINARY_IMAGES_RESOLUTION_MISMATCH,
     STRING_VAL_EMPTY,
+    IMAGE_DECODER_LIBRARY_LOAD_FAILED,
 
     // Model control API
     OK_NOT_RELOADED, /*!< Operation succeeded but no config reload was needed */
@@ -263,54 +329,48 @@ enum class StatusCode {
     STATUS_CODE_END
 };
 
+/**
+ * @brief Result of an operation, cheap to create, copy and move
+ *
+ * Status without details only holds its code, messages and protocol codes are taken from static tables indexed by code.
+ * Details are formatted once into immutable message shared by all copies of status.
+ */
 class Status {
     StatusCode code;
-    std::unique_ptr<std::string> message;
+    std::shared_ptr<const std::string> message;
 
-    static const std::unordered_map<const StatusCode, const std::string> statusMessageMap;
-    static const std::unordered_map<const StatusCode, grpc::StatusCode> grpcStatusMap;
-    static const std::unordered_map<const StatusCode, net_http::HTTPStatusCode> httpStatusMap;
+    static constexpr size_t TABLE_SIZE = static_cast<size_t>(StatusCode::STATUS_CODE_END) + 1;
 
-    void appendDetails(const std::string& details) {
-        ensureMessageAllocated();
-        *this->message += " - " + details;
-    }
-    void ensureMessageAllocated() {
-        if (nullptr == message) {
-            message = std::make_unique<std::string>();
-        }
+    static const std::array<const char*, TABLE_SIZE> statusMessageTable;
+    static const std::array<std::optional<grpc::StatusCode>, TABLE_SIZE> grpcStatusTable;
+    static const std::array<std::optional<net_http::HTTPStatusCode>, TABLE_SIZE> httpStatusTable;
+
+    static size_t index(StatusCode code) {
+        const size_t i = static_cast<size_t>(code);
+        return i < TABLE_SIZE ? i : static_cast<size_t>(StatusCode::STATUS_CODE_END);
     }
 
+    /**
+     * @brief Messages of all codes materialized once, so string() does not allocate for statuses without details
+     */
+    static const std::string& getDefaultMessage(StatusCode code);
+
 public:
     Status(StatusCode code = StatusCode::OK) :
-        code(code) {
-        if (code == StatusCode::OK) {
-            return;
-        }
-        auto it = statusMessageMap.find(code);
-        if (it != statusMessageMap.end())
-            this->message = std::make_unique<std::string>(it->second);
-        else
-            this->message = std::make_unique<std::string>("Unknown error");
-    }
+        code(code) {}
 
     Status(StatusCode code, const std::string& details) :
-        Status(code) {
-        appendDetails(details);
+        code(code) {
+        const std::string& defaultMessage = getDefaultMessage(code);
+        std::string composed;
+        composed.reserve(defaultMessage.size() + 3 + details.size());
+        composed.append(defaultMessage).append(" - ").append(details);
+        this->message = std::make_shared<const std::string>(std::move(composed));
     }
 
-    Status(const Status& rhs) :
-        code(rhs.code),
-        message(rhs.message != nullptr ? std::make_unique<std::string>(*(rhs.message)) : nullptr) {}
-
+    Status(const Status& rhs) = default;
     Status(Status&& rhs) = default;
-
-    Status operator=(const Status& rhs) {
-        this->code = rhs.code;
-        this->message = (rhs.message != nullptr ? std::make_unique<std::string>(*rhs.message) : nullptr);
-        return *this;
-    }
-
+    Status& operator=(const Status& rhs) = default;
     Status& operator=(Status&&) = default;
 
     bool ok() const {
@@ -338,10 +398,9 @@ public:
     }
 
     const grpc::Status grpc() const {
-        auto it = grpcStatusMap.find(code);
-        if (it != grpcStatusMap.end()) {
-            return grpc::Status(it->second,
-                this->message ? *this->message : "");
+        const auto& grpcCode = grpcStatusTable[index(code)];
+        if (grpcCode) {
+            return grpc::Status(grpcCode.value(), this->string());
         } else {
             return grpc::Status(grpc::StatusCode::UNKNOWN, "Unknown error");
         }
@@ -352,7 +411,7 @@ public:
     }
 
     const std::string& string() const {
-        return this->message ? *this->message : statusMessageMap.at(code);
+        return this->message ? *this->message : getDefaultMessage(code);
     }
 
     operator const std::string&() const {
@@ -360,12 +419,7 @@ public:
     }
 
     const net_http::HTTPStatusCode http() const {
-        auto it = httpStatusMap.find(code);
-        if (it != httpStatusMap.end()) {
-            return it->second;
-        } else {
-            return net_http::HTTPStatusCode::ERROR;
-        }
+        return httpStatusTable[index(code)].value_or(net_http::HTTPStatusCode::ERROR);
     }
 };
 
@@ -149,4 +149,27 @@ static inline std::optional<int32_t> stoi32(const std::string& str) {
     }
 }
 
+/**
+ * @brief Parses list of CPU cores in form of comma separated numbers and ranges, e.g. 0-3,8,10-11
+ *
+ * @param str
+ * @return core numbers in order of appearance or std::nullopt if list is malformed
+ */
+static inline std::optional<std::vector<int>> parseCpuList(const std::string& str) {
+    std::vector<int> cpus;
+    for (const auto& token : tokenize(str, ',')) {
+        auto dash = token.find('-');
+        auto first = stou32(token.substr(0, dash));
+        auto last = dash == std::string::npos ? first : stou32(token.substr(dash + 1));
+        if (!first || !last || first.value() > last.value() ||
+            last.value() > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+            return std::nullopt;
+        }
+        for (uint32_t cpu = first.value(); cpu <= last.value(); ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
 }  // namespace ovms
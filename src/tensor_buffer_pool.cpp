@@ -0,0 +1,308 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "tensor_buffer_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+
+#include "memory_lock.hpp"
+
+namespace ovms {
+
+// size class stored in header preceding buffer data for buffers which are not pooled
+static constexpr size_t NOT_POOLED = std::numeric_limits<size_t>::max();
+// header preceding buffer data keeps size class and size of locked pages
+static constexpr size_t LOCKED_SIZE_OFFSET = sizeof(size_t);
+
+static std::shared_ptr<TensorBufferPool> globalPool;
+
+static size_t currentShard() {
+    static thread_local const size_t shard = std::hash<std::thread::id>()(std::this_thread::get_id()) % TensorBufferPool::SHARDS_COUNT;
+    return shard;
+}
+
+static size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+TensorBufferPool::TensorBufferPool(size_t maxIdleBytes, size_t maxPooledBufferSize, MetricRegistry* registry, HugePages hugePages, bool lockMemory) :
+    maxIdleBytes(maxIdleBytes),
+    hugePages(hugePages),
+    lockMemory(lockMemory),
+    hits(&ownHits),
+    misses(&ownMisses),
+    idleBytesGauge(&ownIdleBytes),
+    lockedBytesGauge(&ownLockedBytes) {
+    for (size_t base = MIN_POOLED_BUFFER_SIZE; classSizes.empty() || classSizes.back() < maxPooledBufferSize; base *= 2) {
+        for (size_t quarter = 4; quarter < 8 && (classSizes.empty() || classSizes.back() < maxPooledBufferSize); ++quarter) {
+            size_t classSize = base / 4 * quarter;
+            if (hugePages != HugePages::NONE && classSize >= HUGE_PAGE_SIZE) {
+                classSize = roundUp(classSize, HUGE_PAGE_SIZE);
+            }
+            if (classSizes.empty() || classSizes.back() != classSize) {
+                classSizes.push_back(classSize);
+            }
+        }
+    }
+    for (auto& shard : shards) {
+        shard.buffers.resize(classSizes.size());
+    }
+    if (registry) {
+        hits = &registry->getCounter("ovms_tensor_buffer_pool_hits_total",
+            "Number of blob allocations served with memory of previously freed blob", "");
+        misses = &registry->getCounter("ovms_tensor_buffer_pool_misses_total",
+            "Number of blob allocations of at least 64KiB which required memory from the system", "");
+        idleBytesGauge = &registry->getGauge("ovms_tensor_buffer_pool_idle_bytes",
+            "Memory kept in freed blob buffers for reuse, in bytes", "");
+        if (lockMemory) {
+            lockedBytesGauge = &registry->getGauge("ovms_tensor_buffer_pool_locked_bytes",
+                "Memory of allocated and idle blob buffers locked in RAM, in bytes", "");
+        }
+    }
+}
+
+TensorBufferPool::~TensorBufferPool() {
+    for (auto& shard : shards) {
+        for (auto& buffers : shard.buffers) {
+            for (void* buffer : buffers) {
+                releaseBuffer(buffer);
+            }
+        }
+    }
+    idleBytesGauge->add(-static_cast<int64_t>(idleBytes.load()));
+}
+
+void* TensorBufferPool::mapHugePages(size_t size, size_t sizeClass) {
+    const size_t mappedSize = roundUp(size, HUGE_PAGE_SIZE);
+    void* buffer = MAP_FAILED;
+    if (hugePages == HugePages::EXPLICIT) {
+        buffer = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        const int mapError = errno;
+        static std::atomic<bool> warned = false;
+        if (buffer == MAP_FAILED && !warned.exchange(true)) {
+            SPDLOG_WARN("Unable to map {} bytes of explicit huge pages, errno: {}. Transparent huge pages are used instead", mappedSize, mapError);
+        }
+    }
+    if (buffer == MAP_FAILED) {
+        // kernel backs only huge page aligned ranges with huge pages, so mapping is aligned by trimming its ends
+        char* memory = static_cast<char*>(mmap(nullptr, mappedSize + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(memory), HUGE_PAGE_SIZE));
+        if (aligned != memory) {
+            munmap(memory, aligned - memory);
+        }
+        if (aligned != memory + HUGE_PAGE_SIZE) {
+            munmap(aligned + mappedSize, memory + HUGE_PAGE_SIZE - aligned);
+        }
+        // without transparent huge pages enabled buffer stays backed by regular pages
+        madvise(aligned, mappedSize, MADV_HUGEPAGE);
+        buffer = aligned;
+    }
+    const size_t lockedSize = lockMemory ? lockBuffer(buffer, mappedSize) : 0;
+    try {
+        std::lock_guard<std::mutex> lock(mappedBuffersMtx);
+        mappedBuffers.emplace(buffer, MappedBuffer{sizeClass, mappedSize, lockedSize});
+    } catch (const std::bad_alloc&) {
+        lockedBytesGauge->add(-static_cast<int64_t>(lockedSize));
+        munmap(buffer, mappedSize);
+        return nullptr;
+    }
+    return buffer;
+}
+
+size_t TensorBufferPool::lockBuffer(void* buffer, size_t size) {
+    // only pages inside buffer are locked, unlocking pages shared with neighbouring allocations would unlock them as well
+    const size_t pageSize = MemoryLock::getPageSize();
+    const uintptr_t begin = roundUp(reinterpret_cast<uintptr_t>(buffer), pageSize);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(buffer) + size) / pageSize * pageSize;
+    if (begin >= end) {
+        return 0;
+    }
+    if (mlock(reinterpret_cast<void*>(begin), end - begin) != 0) {
+        const int lockError = errno;
+        static std::atomic<bool> warned = false;
+        if (!warned.exchange(true)) {
+            SPDLOG_WARN("Unable to lock {} bytes of tensor buffer in RAM, RLIMIT_MEMLOCK: {}, errno: {}. Buffers are only pre-faulted and may be paged out",
+                end - begin, getMemoryLockLimit(), lockError);
+        }
+        prefaultMemory({begin, end});
+        return 0;
+    }
+    lockedBytesGauge->add(static_cast<int64_t>(end - begin));
+    return end - begin;
+}
+
+void TensorBufferPool::unlockBuffer(void* buffer, size_t lockedSize) {
+    if (lockedSize == 0) {
+        return;
+    }
+    const uintptr_t begin = roundUp(reinterpret_cast<uintptr_t>(buffer), MemoryLock::getPageSize());
+    munlock(reinterpret_cast<void*>(begin), lockedSize);
+    lockedBytesGauge->add(-static_cast<int64_t>(lockedSize));
+}
+
+void TensorBufferPool::releaseBuffer(void* buffer) {
+    if (hugePages != HugePages::NONE && reinterpret_cast<uintptr_t>(buffer) % HUGE_PAGE_SIZE == 0) {
+        std::unique_lock<std::mutex> lock(mappedBuffersMtx);
+        auto it = mappedBuffers.find(buffer);
+        if (it != mappedBuffers.end()) {
+            const MappedBuffer mapped = it->second;
+            mappedBuffers.erase(it);
+            lock.unlock();
+            // unmapping unlocks pages, only the gauge is updated
+            if (mapped.lockedSize > 0) {
+                lockedBytesGauge->add(-static_cast<int64_t>(mapped.lockedSize));
+            }
+            munmap(buffer, mapped.mappedSize);
+            return;
+        }
+    }
+    char* memory = static_cast<char*>(buffer) - ALIGNMENT;
+    if (lockMemory) {
+        unlockBuffer(buffer, *reinterpret_cast<size_t*>(memory + LOCKED_SIZE_OFFSET));
+    }
+    std::free(memory);
+}
+
+size_t TensorBufferPool::getSizeClass(void* buffer) {
+    if (hugePages != HugePages::NONE && reinterpret_cast<uintptr_t>(buffer) % HUGE_PAGE_SIZE == 0) {
+        std::lock_guard<std::mutex> lock(mappedBuffersMtx);
+        auto it = mappedBuffers.find(buffer);
+        if (it != mappedBuffers.end()) {
+            return it->second.sizeClass;
+        }
+    }
+    return *reinterpret_cast<size_t*>(static_cast<char*>(buffer) - ALIGNMENT);
+}
+
+void* TensorBufferPool::allocateBuffer(size_t size, size_t sizeClass) noexcept {
+    if (hugePages != HugePages::NONE && size >= HUGE_PAGE_SIZE) {
+        void* buffer = mapHugePages(size, sizeClass);
+        if (buffer != nullptr) {
+            return buffer;
+        }
+    }
+    // header keeps size class for free and is as big as alignment so that data stays aligned
+    const size_t allocationSize = (size + 2 * ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    char* memory = static_cast<char*>(std::aligned_alloc(ALIGNMENT, allocationSize));
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t*>(memory) = sizeClass;
+    *reinterpret_cast<size_t*>(memory + LOCKED_SIZE_OFFSET) = lockMemory ? lockBuffer(memory + ALIGNMENT, size) : 0;
+    return memory + ALIGNMENT;
+}
+
+void* TensorBufferPool::takeIdleBuffer(size_t sizeClass) {
+    const size_t own = currentShard();
+    for (size_t i = 0; i < SHARDS_COUNT; ++i) {
+        auto& shard = shards[(own + i) % SHARDS_COUNT];
+        // other shards are only checked if they are not busy
+        std::unique_lock<std::mutex> lock(shard.mtx, std::defer_lock);
+        if (i == 0) {
+            lock.lock();
+        } else if (!lock.try_lock()) {
+            continue;
+        }
+        auto& buffers = shard.buffers[sizeClass];
+        if (!buffers.empty()) {
+            void* buffer = buffers.back();
+            buffers.pop_back();
+            return buffer;
+        }
+    }
+    return nullptr;
+}
+
+void* TensorBufferPool::alloc(size_t size) noexcept {
+    if (size < MIN_POOLED_BUFFER_SIZE) {
+        return allocateBuffer(size, NOT_POOLED);
+    }
+    auto it = std::lower_bound(classSizes.begin(), classSizes.end(), size);
+    if (it == classSizes.end() || maxIdleBytes == 0) {
+        misses->increment();
+        return allocateBuffer(size, NOT_POOLED);
+    }
+    const size_t sizeClass = it - classSizes.begin();
+    void* buffer = takeIdleBuffer(sizeClass);
+    if (buffer != nullptr) {
+        idleBytes.fetch_sub(*it, std::memory_order_relaxed);
+        idleBytesGauge->add(-static_cast<int64_t>(*it));
+        hits->increment();
+        return buffer;
+    }
+    misses->increment();
+    return allocateBuffer(*it, sizeClass);
+}
+
+bool TensorBufferPool::free(void* handle) noexcept {
+    if (handle == nullptr) {
+        return true;
+    }
+    const size_t sizeClass = getSizeClass(handle);
+    if (sizeClass == NOT_POOLED) {
+        releaseBuffer(handle);
+        return true;
+    }
+    const size_t size = classSizes[sizeClass];
+    auto& shard = shards[currentShard()];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    // idle buffers of other sizes are released first, they might be left by traffic which is gone
+    for (size_t otherClass = classSizes.size(); otherClass-- > 0 && getIdleBytes() + size > maxIdleBytes;) {
+        auto& buffers = shard.buffers[otherClass];
+        while (otherClass != sizeClass && !buffers.empty() && getIdleBytes() + size > maxIdleBytes) {
+            releaseBuffer(buffers.back());
+            buffers.pop_back();
+            idleBytes.fetch_sub(classSizes[otherClass], std::memory_order_relaxed);
+            idleBytesGauge->add(-static_cast<int64_t>(classSizes[otherClass]));
+        }
+    }
+    if (idleBytes.fetch_add(size, std::memory_order_relaxed) + size > maxIdleBytes) {
+        idleBytes.fetch_sub(size, std::memory_order_relaxed);
+        releaseBuffer(handle);
+        return true;
+    }
+    idleBytesGauge->add(size);
+    try {
+        shard.buffers[sizeClass].push_back(handle);
+    } catch (const std::bad_alloc&) {
+        idleBytes.fetch_sub(size, std::memory_order_relaxed);
+        idleBytesGauge->add(-static_cast<int64_t>(size));
+        releaseBuffer(handle);
+    }
+    return true;
+}
+
+void TensorBufferPool::setGlobal(std::shared_ptr<TensorBufferPool> pool) {
+    std::atomic_store(&globalPool, std::move(pool));
+}
+
+std::shared_ptr<TensorBufferPool> TensorBufferPool::getGlobal() {
+    return std::atomic_load(&globalPool);
+}
+
+}  // namespace ovms
@@ -0,0 +1,159 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#include "metrics.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Kind of pages backing buffers of at least huge page size
+ */
+enum class HugePages {
+    NONE,
+    // madvise asks kernel to back buffer with transparent huge pages
+    TRANSPARENT,
+    // buffer is mapped from pages reserved with vm.nr_hugepages, transparent huge pages are used when none is available
+    EXPLICIT
+};
+
+/**
+ * @brief Keeps memory of freed blobs for reuse by following requests
+ *
+ * Buffers are rounded up to size classes, four per power of two, so that blobs of similar size reuse each other's memory.
+ * Freed buffers go to a shard of the freeing thread and allocations look into own shard first,
+ * so threads serving requests mostly reuse buffers they freed without contending with each other.
+ * Buffers smaller than MIN_POOLED_BUFFER_SIZE are left to malloc, which handles them without mmap.
+ * With huge pages, size classes from HUGE_PAGE_SIZE up are multiples of it so that mapped pages are fully used.
+ * With memory locking, pages inside buffers are locked in RAM while buffers are allocated or idle, so that reused
+ * buffers are never paged out.
+ */
+class TensorBufferPool : public InferenceEngine::IAllocator {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t MIN_POOLED_BUFFER_SIZE = 64 * 1024;
+    static constexpr size_t SHARDS_COUNT = 16;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+private:
+    struct alignas(64) Shard {
+        std::mutex mtx;
+        // free buffers of each size class
+        std::vector<std::vector<void*>> buffers;
+    };
+
+    const size_t maxIdleBytes;
+    const HugePages hugePages;
+    const bool lockMemory;
+    std::vector<size_t> classSizes;
+    Shard shards[SHARDS_COUNT];
+    std::atomic<size_t> idleBytes = 0;
+
+    Counter ownHits;
+    Counter ownMisses;
+    Gauge ownIdleBytes;
+    Gauge ownLockedBytes;
+    Counter* hits;
+    Counter* misses;
+    Gauge* idleBytesGauge;
+    Gauge* lockedBytesGauge;
+
+    struct MappedBuffer {
+        size_t sizeClass;
+        size_t mappedSize;
+        size_t lockedSize;
+    };
+
+    // buffers backed by huge pages start at mapping start, they have no header and are looked up here on free
+    std::mutex mappedBuffersMtx;
+    std::unordered_map<void*, MappedBuffer> mappedBuffers;
+
+    void* allocateBuffer(size_t size, size_t sizeClass) noexcept;
+    void* mapHugePages(size_t size, size_t sizeClass);
+    size_t lockBuffer(void* buffer, size_t size);
+    void unlockBuffer(void* buffer, size_t lockedSize);
+    void releaseBuffer(void* buffer);
+    size_t getSizeClass(void* buffer);
+    void* takeIdleBuffer(size_t sizeClass);
+
+public:
+    /**
+     * @param maxIdleBytes memory kept in freed buffers, buffers freed above it are released to the system
+     * @param maxPooledBufferSize buffers above it are not pooled
+     * @param registry if set, hits, misses and idle memory are reported in its metrics
+     * @param hugePages pages backing buffers of at least HUGE_PAGE_SIZE, buffers fall back to regular pages if they are not available
+     * @param lockMemory lock pages of buffers in RAM, buffers are only pre-faulted when RLIMIT_MEMLOCK is insufficient
+     */
+    TensorBufferPool(size_t maxIdleBytes, size_t maxPooledBufferSize, MetricRegistry* registry = nullptr, HugePages hugePages = HugePages::NONE, bool lockMemory = false);
+    ~TensorBufferPool();
+
+    void* lock(void* handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void* a) noexcept override {}
+
+    void* alloc(size_t size) noexcept override;
+
+    bool free(void* handle) noexcept override;
+
+    /**
+     * @brief Number of allocations served with idle buffer
+     */
+    uint64_t getHits() const { return hits->get(); }
+
+    /**
+     * @brief Number of allocations of at least MIN_POOLED_BUFFER_SIZE which required memory from the system
+     */
+    uint64_t getMisses() const { return misses->get(); }
+
+    size_t getIdleBytes() const { return idleBytes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Memory of allocated and idle buffers locked in RAM
+     */
+    size_t getLockedBytes() const { return static_cast<size_t>(lockedBytesGauge->get()); }
+
+    /**
+     * @brief Sets pool used for blobs created by server, empty pool means blobs use default allocator
+     */
+    static void setGlobal(std::shared_ptr<TensorBufferPool> pool);
+
+    static std::shared_ptr<TensorBufferPool> getGlobal();
+};
+
+/**
+ * @brief Creates allocated blob with memory from global tensor buffer pool if it is set
+ */
+template <typename T>
+InferenceEngine::Blob::Ptr makePooledBlob(const InferenceEngine::TensorDesc& tensorDesc) {
+    auto pool = TensorBufferPool::getGlobal();
+    InferenceEngine::Blob::Ptr blob = pool ? InferenceEngine::make_shared_blob<T>(tensorDesc, std::move(pool)) : InferenceEngine::make_shared_blob<T>(tensorDesc);
+    blob->allocate();
+    return blob;
+}
+
+}  // namespace ovms
@@ -0,0 +1,64 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "tensor_metadata.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "modelconfig.hpp"
+
+namespace ovms {
+
+TensorMetadataTable::TensorMetadataTable(const tensor_map_t& tensors, const ModelConfig* config) {
+    entries.reserve(tensors.size());
+    for (const auto& [name, info] : tensors) {
+        TensorMetadata entry;
+        entry.name = name;
+        entry.nameHash = std::hash<std::string>{}(name);
+        entry.info = info;
+        entry.dataType = info->getPrecisionAsDataType();
+        entry.elementSize = info->getPrecision().size();
+        entry.isConverted = info->getRequestPrecision() != InferenceEngine::Precision::UNSPECIFIED &&
+                            info->getRequestPrecision() != info->getPrecision();
+        if (entry.isConverted) {
+            entry.convertedDataType = TensorInfo::getPrecisionAsDataType(info->getRequestPrecision());
+            entry.convertedElementSize = info->getRequestPrecision().size();
+        }
+        entry.isShapeAuto = config != nullptr && config->isShapeAuto(name);
+        entry.isPlanarYuv = info->isPlanarYuv();
+        const auto& shape = info->getEffectiveShape();
+        entry.rank = shape.size();
+        std::copy_n(shape.begin(), std::min(shape.size(), TensorMetadata::MAX_INLINE_DIMENSIONS), entry.dims.begin());
+        for (size_t i = 0; i < std::min<size_t>(shape.size(), 64); ++i) {
+            if (info->isResizedDimension(i)) {
+                entry.resizedDimensions |= uint64_t(1) << i;
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+}
+
+const TensorMetadata* TensorMetadataTable::find(const std::string& name) const {
+    const size_t hash = std::hash<std::string>{}(name);
+    for (const auto& entry : entries) {
+        if (entry.nameHash == hash && entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace ovms
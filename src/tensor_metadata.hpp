@@ -0,0 +1,120 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/tensor.h"
+#pragma GCC diagnostic pop
+
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+class ModelConfig;
+
+/**
+ * @brief Everything request validation needs to know about single tensor, precomputed once per model load
+ *
+ * Effective shape of up to MAX_INLINE_DIMENSIONS dimensions is stored inline, longer shapes are read from TensorInfo.
+ */
+struct TensorMetadata {
+    static constexpr size_t MAX_INLINE_DIMENSIONS = 8;
+
+    std::string name;
+    size_t nameHash = 0;
+    std::shared_ptr<TensorInfo> info;
+    tensorflow::DataType dataType = tensorflow::DataType::DT_INVALID;
+    tensorflow::DataType convertedDataType = tensorflow::DataType::DT_INVALID;
+    bool isConverted = false;
+    bool isShapeAuto = false;
+    bool isPlanarYuv = false;
+    uint32_t elementSize = 0;
+    uint32_t convertedElementSize = 0;
+    uint32_t rank = 0;
+    // bit set for each dimension resized by preprocessing
+    uint64_t resizedDimensions = 0;
+    std::array<size_t, MAX_INLINE_DIMENSIONS> dims{};
+
+    size_t getDimension(size_t index) const {
+        return index < MAX_INLINE_DIMENSIONS ? dims[index] : info->getEffectiveShape()[index];
+    }
+
+    bool isResizedDimension(size_t index) const {
+        return index < 64 && ((resizedDimensions >> index) & 1);
+    }
+
+    /**
+     * @brief Checks if request data type is the tensor precision or precision converted by preprocessing
+     */
+    bool acceptsDataType(tensorflow::DataType requestDataType) const {
+        return requestDataType == dataType || (isConverted && requestDataType == convertedDataType);
+    }
+
+    size_t getElementSize(tensorflow::DataType requestDataType) const {
+        return isConverted && requestDataType == convertedDataType ? convertedElementSize : elementSize;
+    }
+};
+
+/**
+ * @brief Immutable, index addressed metadata of model inputs used on request hot path
+ *
+ * Entries are contiguous and in the order of tensor map, so validation walks them without map nodes and shared pointers.
+ * tensor_map_t stays the source of truth for metadata APIs, table is rebuilt whenever model is loaded.
+ */
+class TensorMetadataTable {
+    std::vector<TensorMetadata> entries;
+
+public:
+    TensorMetadataTable() = default;
+
+    /**
+     * @param tensors tensors by mapped name
+     * @param config provides shape mode of each tensor, shapes are fixed if not given
+     */
+    TensorMetadataTable(const tensor_map_t& tensors, const ModelConfig* config);
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    const TensorMetadata& operator[](size_t index) const {
+        return entries[index];
+    }
+
+    std::vector<TensorMetadata>::const_iterator begin() const {
+        return entries.begin();
+    }
+
+    std::vector<TensorMetadata>::const_iterator end() const {
+        return entries.end();
+    }
+
+    /**
+     * @brief Finds entry by name comparing precomputed hashes first
+     *
+     * @return entry or nullptr if there is no tensor with such name
+     */
+    const TensorMetadata* find(const std::string& name) const;
+};
+
+}  // namespace ovms
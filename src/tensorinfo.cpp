@@ -95,6 +95,71 @@ const InferenceEngine::Precision TensorInfo::getPrecision() const {
 
 void TensorInfo::setPrecision(const InferenceEngine::Precision& requestedPrecision) {
     precision = requestedPrecision;
+    tensorDesc.setPrecision(precision);
+}
+
+const InferenceEngine::Precision TensorInfo::getRequestPrecision() const {
+    return requestPrecision;
+}
+
+void TensorInfo::setRequestPrecision(const InferenceEngine::Precision& requestPrecision) {
+    this->requestPrecision = requestPrecision;
+}
+
+bool TensorInfo::isConvertedFromDataType(tensorflow::DataType dataType) const {
+    return requestPrecision != InferenceEngine::Precision::UNSPECIFIED &&
+           requestPrecision != precision &&
+           dataType == getPrecisionAsDataType(requestPrecision);
+}
+
+bool TensorInfo::isResizedByPreprocessing() const {
+    return resizedByPreprocessing;
+}
+
+void TensorInfo::setResizedByPreprocessing(bool resizedByPreprocessing) {
+    this->resizedByPreprocessing = resizedByPreprocessing;
+}
+
+InferenceEngine::ColorFormat TensorInfo::getColorFormat() const {
+    return colorFormat;
+}
+
+void TensorInfo::setColorFormat(InferenceEngine::ColorFormat colorFormat) {
+    this->colorFormat = colorFormat;
+}
+
+bool TensorInfo::isPlanarYuv() const {
+    return colorFormat == InferenceEngine::ColorFormat::NV12 || colorFormat == InferenceEngine::ColorFormat::I420;
+}
+
+InferenceEngine::Layout TensorInfo::getTransposedLayout() const {
+    return transposedLayout;
+}
+
+void TensorInfo::setTransposedLayout(InferenceEngine::Layout transposedLayout) {
+    this->transposedLayout = transposedLayout;
+}
+
+bool TensorInfo::isTransposedByServer() const {
+    return transposedLayout != InferenceEngine::Layout::ANY;
+}
+
+InferenceEngine::TensorDesc TensorInfo::getTransposedTensorDesc() const {
+    return InferenceEngine::TensorDesc{precision, shape, transposedLayout};
+}
+
+bool TensorInfo::isResizedDimension(size_t index) const {
+    if (!resizedByPreprocessing) {
+        return false;
+    }
+    switch (layout) {
+    case InferenceEngine::Layout::NCHW:
+        return index == 2 || index == 3;
+    case InferenceEngine::Layout::NHWC:
+        return index == 1 || index == 2;
+    default:
+        return false;
+    }
 }
 
 const tensorflow::DataType TensorInfo::getPrecisionAsDataType() const {
@@ -130,6 +195,33 @@ const tensorflow::DataType TensorInfo::getPrecisionAsDataType(InferenceEngine::P
     }
 }
 
+InferenceEngine::Precision TensorInfo::getPrecisionFromDataType(tensorflow::DataType dataType) {
+    switch (dataType) {
+    case tensorflow::DataType::DT_FLOAT:
+        return InferenceEngine::Precision::FP32;
+    case tensorflow::DataType::DT_INT32:
+        return InferenceEngine::Precision::I32;
+    case tensorflow::DataType::DT_INT8:
+        return InferenceEngine::Precision::I8;
+    case tensorflow::DataType::DT_UINT8:
+        return InferenceEngine::Precision::U8;
+    case tensorflow::DataType::DT_HALF:
+        return InferenceEngine::Precision::FP16;
+    case tensorflow::DataType::DT_INT16:
+        return InferenceEngine::Precision::I16;
+    case tensorflow::DataType::DT_UINT16:
+        return InferenceEngine::Precision::U16;
+    case tensorflow::DataType::DT_UINT64:
+        return InferenceEngine::Precision::U64;
+    case tensorflow::DataType::DT_INT64:
+        return InferenceEngine::Precision::I64;
+    case tensorflow::DataType::DT_BOOL:
+        return InferenceEngine::Precision::BOOL;
+    default:
+        return InferenceEngine::Precision::UNSPECIFIED;
+    }
+}
+
 const std::string TensorInfo::getPrecisionAsString() const {
     return getPrecisionAsString(precision);
 }
@@ -295,13 +387,15 @@ void TensorInfo::setLayout(InferenceEngine::Layout layout) {
 }
 
 void TensorInfo::updateEffectiveShape() {
-    this->effectiveShape = this->getTensorDesc().getBlockingDesc().getBlockDims();
+    this->tensorDesc = InferenceEngine::TensorDesc{precision, shape, layout};
+    this->effectiveShape = this->tensorDesc.getBlockingDesc().getBlockDims();
 }
 
 std::shared_ptr<TensorInfo> TensorInfo::createCopyWithNewShape(const shape_t& shape) const {
     auto copy = std::make_shared<TensorInfo>(*this);
     copy->shape = shape;
     copy->layout = InferenceEngine::Layout::ANY;
+    copy->transposedLayout = InferenceEngine::Layout::ANY;
     copy->updateEffectiveShape();
     return copy;
 }
@@ -314,8 +408,8 @@ std::shared_ptr<TensorInfo> TensorInfo::createCopyWithEffectiveDimensionPrefix(s
     return copy;
 }
 
-const InferenceEngine::TensorDesc TensorInfo::getTensorDesc() const {
-    return InferenceEngine::TensorDesc{precision, shape, layout};
+const InferenceEngine::TensorDesc& TensorInfo::getTensorDesc() const {
+    return tensorDesc;
 }
 
 bool TensorInfo::isTensorSpecEqual(const TensorInfo& other) const {
@@ -77,7 +77,27 @@ protected:
     bool influencedByDemultiplexer = false;
 
     /**
-         * @brief TensorDesc
+         * @brief Precision accepted from requests in addition to tensor precision, UNSPECIFIED if none
+         */
+    InferenceEngine::Precision requestPrecision = InferenceEngine::Precision::UNSPECIFIED;
+
+    /**
+         * @brief Information if spatial dimensions of request data are resized to tensor shape by OpenVINO preprocessing
+         */
+    bool resizedByPreprocessing = false;
+
+    /**
+         * @brief Color format of request data converted by OpenVINO preprocessing, RAW if not converted
+         */
+    InferenceEngine::ColorFormat colorFormat = InferenceEngine::ColorFormat::RAW;
+
+    /**
+         * @brief Layout of network input request data is transposed to by the server, ANY if request layout is passed to OpenVINO
+         */
+    InferenceEngine::Layout transposedLayout = InferenceEngine::Layout::ANY;
+
+    /**
+         * @brief TensorDesc built from precision, shape and layout, kept up to date by setters
          */
     InferenceEngine::TensorDesc tensorDesc;
 
@@ -159,6 +179,99 @@ public:
          */
     void setPrecision(const InferenceEngine::Precision& requestedPrecision);
 
+    /**
+         * @brief Get the precision accepted from requests and converted to tensor precision
+         * 
+         * @return const InferenceEngine::Precision
+         */
+    const InferenceEngine::Precision getRequestPrecision() const;
+
+    /**
+         * @brief Set the precision accepted from requests and converted to tensor precision
+         * 
+         * @param requestPrecision
+         */
+    void setRequestPrecision(const InferenceEngine::Precision& requestPrecision);
+
+    /**
+         * @brief Checks if request data of given type is converted to tensor precision
+         * 
+         * @param dataType
+         * @return bool
+         */
+    bool isConvertedFromDataType(tensorflow::DataType dataType) const;
+
+    /**
+         * @brief Get information if request data resolution may differ from tensor shape
+         * 
+         * @return bool
+         */
+    bool isResizedByPreprocessing() const;
+
+    /**
+         * @brief Set information if request data is resized by OpenVINO preprocessing
+         * 
+         * @param resizedByPreprocessing
+         */
+    void setResizedByPreprocessing(bool resizedByPreprocessing);
+
+    /**
+         * @brief Checks if dimension of effective shape is height or width resized by preprocessing
+         * 
+         * @param index
+         * @return bool
+         */
+    bool isResizedDimension(size_t index) const;
+
+    /**
+         * @brief Get color format of request data converted by OpenVINO preprocessing
+         * 
+         * @return InferenceEngine::ColorFormat
+         */
+    InferenceEngine::ColorFormat getColorFormat() const;
+
+    /**
+         * @brief Set color format of request data converted by OpenVINO preprocessing
+         * 
+         * @param colorFormat
+         */
+    void setColorFormat(InferenceEngine::ColorFormat colorFormat);
+
+    /**
+         * @brief Checks if request data are NV12 or I420 frames with Y plane followed by chroma planes
+         * 
+         * @return bool
+         */
+    bool isPlanarYuv() const;
+
+    /**
+         * @brief Get layout of network input request data is transposed to by the server
+         * 
+         * @return InferenceEngine::Layout ANY if data is not transposed
+         */
+    InferenceEngine::Layout getTransposedLayout() const;
+
+    /**
+         * @brief Set layout of network input request data is transposed to by the server
+         * 
+         * @param transposedLayout
+         */
+    void setTransposedLayout(InferenceEngine::Layout transposedLayout);
+
+    /**
+         * @brief Checks if request data is transposed to network input layout by the server
+         * 
+         * @return bool
+         */
+    bool isTransposedByServer() const;
+
+    /**
+         * @brief Get TensorDesc of blob holding request data transposed to network input layout
+         * 
+         * @return InferenceEngine::TensorDesc
+         */
+    InferenceEngine::TensorDesc getTransposedTensorDesc() const;
+
     /**
          * @brief Set the Layout object
          * 
@@ -175,6 +288,11 @@ public:
 
     static const tensorflow::DataType getPrecisionAsDataType(InferenceEngine::Precision precision);
 
+    /**
+         * @brief Get the Precision of DataType, UNSPECIFIED if there is no matching precision
+         */
+    static InferenceEngine::Precision getPrecisionFromDataType(tensorflow::DataType dataType);
+
     /**
         * @brief Get the Precision As String object
         *
@@ -236,7 +354,7 @@ public:
          *
          * @return const InferenceEngine::TensorDesc&
          */
-    const InferenceEngine::TensorDesc getTensorDesc() const;
+    const InferenceEngine::TensorDesc& getTensorDesc() const;
 
     bool isTensorUnspecified() const;
 
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "../adaptive_batch_window.hpp"
+
+using namespace ovms;
+using std::chrono::microseconds;
+
+namespace {
+void arriveEvery(AdaptiveBatchWindow& window, microseconds interval, size_t count) {
+    auto time = AdaptiveBatchWindow::clock::time_point();
+    for (size_t i = 0; i < count; ++i) {
+        window.recordArrival(time, 1);
+        time += interval;
+    }
+}
+}  // namespace
+
+TEST(AdaptiveBatchWindow, BeforeAnyObservationBehavesLikeStaticWindow) {
+    AdaptiveBatchWindow window(8, microseconds(1000), microseconds(20000));
+    EXPECT_EQ(window.getTargetBatchSize(), 8);
+    EXPECT_EQ(window.getWindow(), microseconds(1000));
+}
+
+TEST(AdaptiveBatchWindow, LowTrafficDoesNotWait) {
+    AdaptiveBatchWindow window(8, microseconds(1000), microseconds(20000));
+    window.recordExecution(8, microseconds(5000));
+    arriveEvery(window, microseconds(50000), 20);
+    EXPECT_EQ(window.getTargetBatchSize(), 1);
+    EXPECT_EQ(window.getWindow(), microseconds(0));
+}
+
+TEST(AdaptiveBatchWindow, HighTrafficFillsLargestBatchWithinBudget) {
+    AdaptiveBatchWindow window(8, microseconds(10000), microseconds(10000));
+    window.recordExecution(8, microseconds(5000));
+    // 7 intervals of 1 ms and 5 ms of inference do not fit into 10 ms, 5 intervals do
+    arriveEvery(window, microseconds(1000), 50);
+    EXPECT_EQ(window.getTargetBatchSize(), 6);
+    EXPECT_EQ(window.getWindow(), microseconds(5000));
+    arriveEvery(window, microseconds(100), 50);
+    EXPECT_EQ(window.getTargetBatchSize(), 8);
+}
+
+TEST(AdaptiveBatchWindow, WindowIsCappedByBatchTimeout) {
+    AdaptiveBatchWindow window(8, microseconds(1000), microseconds(20000));
+    window.recordExecution(8, microseconds(5000));
+    arriveEvery(window, microseconds(100), 50);
+    EXPECT_EQ(window.getTargetBatchSize(), 8);
+    EXPECT_EQ(window.getWindow(), microseconds(1000));
+}
+
+TEST(AdaptiveBatchWindow, ExecutionOfUnobservedBatchSizeEstimatedFromNeighbours) {
+    AdaptiveBatchWindow window(8, microseconds(1000), microseconds(20000));
+    EXPECT_EQ(window.getEstimatedExecutionUs(4), 0);
+    window.recordExecution(2, microseconds(1000));
+    EXPECT_EQ(window.getEstimatedExecutionUs(4), 2000);
+    window.recordExecution(6, microseconds(3000));
+    EXPECT_EQ(window.getEstimatedExecutionUs(4), 3000);
+    EXPECT_EQ(window.getEstimatedExecutionUs(2), 1000);
+}
+
+TEST(AdaptiveBatchWindow, BudgetShrinksWhenP99ExceedsTargetAndRecovers) {
+    AdaptiveBatchWindow window(8, microseconds(10000), microseconds(10000));
+    for (size_t i = 0; i < AdaptiveBatchWindow::LATENCY_SAMPLES; ++i) {
+        window.recordLatency(microseconds(15000));
+    }
+    EXPECT_LT(window.getLatencyBudgetUs(), 10000);
+    EXPECT_LT(window.getWindow(), microseconds(10000));
+    for (size_t i = 0; i < 10 * AdaptiveBatchWindow::LATENCY_SAMPLES; ++i) {
+        window.recordLatency(microseconds(2000));
+    }
+    EXPECT_EQ(window.getLatencyBudgetUs(), 10000);
+    EXPECT_EQ(window.getWindow(), microseconds(10000));
+}
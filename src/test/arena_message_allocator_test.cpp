@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <gtest/gtest.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "../arena_message_allocator.hpp"
+
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+using Allocator = ovms::ArenaMessageAllocator<PredictRequest, PredictResponse>;
+
+TEST(ArenaMessageAllocator, MessagesAreAllocatedInArena) {
+    Allocator allocator;
+    auto holder = allocator.AllocateMessages();
+    ASSERT_NE(holder->request(), nullptr);
+    ASSERT_NE(holder->response(), nullptr);
+    EXPECT_NE(holder->request()->GetArena(), nullptr);
+    EXPECT_EQ(holder->request()->GetArena(), holder->response()->GetArena());
+
+    auto& input = (*holder->request()->mutable_inputs())["b"];
+    EXPECT_EQ(input.GetArena(), holder->request()->GetArena());
+    holder->Release();
+}
+
+TEST(ArenaMessageAllocator, ReleasedHolderIsReusedWithEmptyMessages) {
+    Allocator allocator;
+    auto holder = allocator.AllocateMessages();
+    (*holder->request()->mutable_inputs())["b"].set_tensor_content(std::string(1024, 'a'));
+    (*holder->response()->mutable_outputs())["a"].set_tensor_content(std::string(1024, 'b'));
+    holder->Release();
+    EXPECT_EQ(allocator.getIdleHoldersCount(), 1);
+
+    auto reused = allocator.AllocateMessages();
+    EXPECT_EQ(reused, holder);
+    EXPECT_EQ(allocator.getIdleHoldersCount(), 0);
+    EXPECT_EQ(reused->request()->inputs_size(), 0);
+    EXPECT_EQ(reused->response()->outputs_size(), 0);
+    EXPECT_NE(reused->request()->GetArena(), nullptr);
+    reused->Release();
+}
+
+TEST(ArenaMessageAllocator, IdleHoldersAreLimited) {
+    Allocator allocator(Allocator::DEFAULT_INITIAL_BLOCK_SIZE, 1);
+    auto first = allocator.AllocateMessages();
+    auto second = allocator.AllocateMessages();
+    EXPECT_NE(first, second);
+    first->Release();
+    second->Release();
+    EXPECT_EQ(allocator.getIdleHoldersCount(), 1);
+}
@@ -14,7 +14,10 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "../binaryutils.hpp"
 #include "gtest/gtest.h"
@@ -197,4 +200,145 @@ TEST_F(BinaryUtilsTest, positive_resizing) {
     uint8_t* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<uint8_t*>();
     EXPECT_EQ(std::equal(ptr, ptr + blob->size(), rgb_expected_blob), true);
 }
+TEST_F(BinaryUtilsTest, positive_batch_decoded_in_parallel) {
+    const size_t batchSize = 16;
+    for (size_t i = 1; i < batchSize; i++) {
+        stringVal.add_string_val(image_bytes.get(), filesize);
+    }
+    std::shared_ptr<TensorInfo> tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::FP32, shape_t{batchSize, 3, 2, 2}, InferenceEngine::Layout::NHWC);
+
+    InferenceEngine::Blob::Ptr serialBlob;
+    ASSERT_EQ(convertStringValToBlob(stringVal, serialBlob, tensorInfo, false), ovms::StatusCode::OK);
+
+    setImageDecodeWorkers(4);
+    InferenceEngine::Blob::Ptr blob;
+    ASSERT_EQ(convertStringValToBlob(stringVal, blob, tensorInfo, false), ovms::StatusCode::OK);
+    ASSERT_EQ(blob->byteSize(), serialBlob->byteSize());
+    float* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<float*>();
+    float* serialPtr = InferenceEngine::as<InferenceEngine::MemoryBlob>(serialBlob)->rmap().as<float*>();
+    EXPECT_TRUE(std::equal(ptr, ptr + blob->size(), serialPtr));
+    EXPECT_EQ(ptr[blob->size() - 1], 0xed);
+
+    *stringVal.mutable_string_val(batchSize / 2) = "INVALID_IMAGE";
+    InferenceEngine::Blob::Ptr invalidBlob;
+    EXPECT_EQ(convertStringValToBlob(stringVal, invalidBlob, tensorInfo, false), ovms::StatusCode::IMAGE_PARSING_FAILED);
+    EXPECT_EQ(invalidBlob, nullptr);
+    setImageDecodeWorkers(0);
+}
+
+static std::string encodeJpeg(const cv::Mat& image) {
+    std::vector<uchar> encoded;
+    cv::imencode(".jpg", image, encoded);
+    return std::string(encoded.begin(), encoded.end());
+}
+
+TEST_F(BinaryUtilsTest, positive_jpeg_reduced_while_decoding) {
+    tensorflow::TensorProto jpegStringVal;
+    jpegStringVal.set_dtype(tensorflow::DataType::DT_STRING);
+    jpegStringVal.add_string_val(encodeJpeg(cv::Mat(256, 512, CV_8UC3, cv::Scalar(0xed, 0x1b, 0x24))));
+
+    for (shape_t shape : {shape_t{1, 3, 32, 64}, shape_t{1, 3, 100, 100}, shape_t{1, 3, 300, 600}}) {
+        std::shared_ptr<TensorInfo> tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape, InferenceEngine::Layout::NHWC);
+        InferenceEngine::Blob::Ptr blob;
+        ASSERT_EQ(convertStringValToBlob(jpegStringVal, blob, tensorInfo, false), ovms::StatusCode::OK);
+        ASSERT_EQ(blob->size(), shape[1] * shape[2] * shape[3]);
+        uint8_t* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<uint8_t*>();
+        for (size_t i = 0; i < blob->size(); i += 3) {
+            EXPECT_NEAR(ptr[i], 0xed, 4);
+            EXPECT_NEAR(ptr[i + 1], 0x1b, 4);
+            EXPECT_NEAR(ptr[i + 2], 0x24, 4);
+        }
+    }
+}
+
+TEST_F(BinaryUtilsTest, jpeg_reduced_decoding_keeps_number_of_channels) {
+    tensorflow::TensorProto jpegStringVal;
+    jpegStringVal.set_dtype(tensorflow::DataType::DT_STRING);
+    jpegStringVal.add_string_val(encodeJpeg(cv::Mat(256, 256, CV_8UC1, cv::Scalar(0x80))));
+    InferenceEngine::Blob::Ptr blob;
+
+    std::shared_ptr<TensorInfo> tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{1, 3, 32, 32}, InferenceEngine::Layout::NHWC);
+    EXPECT_EQ(convertStringValToBlob(jpegStringVal, blob, tensorInfo, false), ovms::StatusCode::INVALID_NO_OF_CHANNELS);
+
+    tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::FP32, shape_t{1, 1, 32, 32}, InferenceEngine::Layout::NHWC);
+    ASSERT_EQ(convertStringValToBlob(jpegStringVal, blob, tensorInfo, false), ovms::StatusCode::OK);
+    ASSERT_EQ(blob->size(), 32 * 32);
+    float* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<float*>();
+    EXPECT_NEAR(ptr[0], 0x80, 2);
+}
+
+TEST_F(BinaryUtilsTest, raw_binary_input_of_pipeline_is_passed_without_decoding) {
+    InferenceEngine::Blob::Ptr blob;
+    std::shared_ptr<TensorInfo> tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{0}, InferenceEngine::Layout::C);
+    ASSERT_TRUE(isRawBinaryInput(*tensorInfo));
+    ASSERT_EQ(convertStringValToBlob(stringVal, blob, tensorInfo, true), ovms::StatusCode::OK);
+    ASSERT_EQ(blob->getTensorDesc().getPrecision(), InferenceEngine::Precision::U8);
+    ASSERT_EQ(blob->getTensorDesc().getDims(), (InferenceEngine::SizeVector{filesize}));
+    EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const char*>(), stringVal.string_val(0).data());
+
+    tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{filesize + 1}, InferenceEngine::Layout::C);
+    EXPECT_EQ(convertStringValToBlob(stringVal, blob, tensorInfo, true), ovms::StatusCode::INVALID_SHAPE);
+
+    tensorflow::TensorProto batch = stringVal;
+    batch.add_string_val(image_bytes.get(), filesize);
+    tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{0}, InferenceEngine::Layout::C);
+    EXPECT_EQ(convertStringValToBlob(batch, blob, tensorInfo, true), ovms::StatusCode::INVALID_BATCH_SIZE);
+
+    EXPECT_FALSE(isRawBinaryInput(TensorInfo("", InferenceEngine::Precision::FP32, shape_t{0})));
+    EXPECT_FALSE(isRawBinaryInput(TensorInfo("", InferenceEngine::Precision::U8, shape_t{1, 224, 224, 3}, InferenceEngine::Layout::NHWC)));
+}
+
+TEST_F(BinaryUtilsTest, string_input_of_pipeline_is_zero_padded_per_row) {
+    tensorflow::TensorProto texts;
+    texts.set_dtype(tensorflow::DataType::DT_STRING);
+    texts.add_string_val("hello world");
+    texts.add_string_val("hi");
+    InferenceEngine::Blob::Ptr blob;
+    std::shared_ptr<TensorInfo> tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{0, 0}, InferenceEngine::Layout::NC);
+    ASSERT_TRUE(isStringInput(*tensorInfo));
+    ASSERT_EQ(convertStringValToBlob(texts, blob, tensorInfo, true), ovms::StatusCode::OK);
+    ASSERT_EQ(blob->getTensorDesc().getPrecision(), InferenceEngine::Precision::U8);
+    ASSERT_EQ(blob->getTensorDesc().getDims(), (InferenceEngine::SizeVector{2, 12}));
+    const char* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const char*>();
+    EXPECT_EQ(std::string(data), "hello world");
+    EXPECT_EQ(std::string(data + 12), "hi");
+    EXPECT_EQ(std::string(data + 12, 12), std::string("hi") + std::string(10, '\0'));
+
+    tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{0, 8}, InferenceEngine::Layout::NC);
+    EXPECT_EQ(convertStringValToBlob(texts, blob, tensorInfo, true), ovms::StatusCode::INVALID_SHAPE);
+    tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{3, 0}, InferenceEngine::Layout::NC);
+    EXPECT_EQ(convertStringValToBlob(texts, blob, tensorInfo, true), ovms::StatusCode::INVALID_BATCH_SIZE);
+
+    EXPECT_FALSE(isStringInput(TensorInfo("", InferenceEngine::Precision::I32, shape_t{0, 0})));
+    EXPECT_FALSE(isStringInput(TensorInfo("", InferenceEngine::Precision::U8, shape_t{1, 224, 224, 3}, InferenceEngine::Layout::NHWC)));
+}
+
+TEST_F(BinaryUtilsTest, decoder_library_decodes_supported_images_and_cpu_the_others) {
+    ASSERT_EQ(loadImageDecoderLibrary("/ovms/bazel-bin/src/lib_image_decoder_mock.so"), ovms::StatusCode::OK);
+    tensorflow::TensorProto images;
+    images.set_dtype(tensorflow::DataType::DT_STRING);
+    images.add_string_val(std::string("RAW\x07", 4));
+    images.add_string_val(image_bytes.get(), filesize);
+    std::shared_ptr<TensorInfo> tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::U8, shape_t{2, 3, 2, 2}, InferenceEngine::Layout::NHWC);
+
+    InferenceEngine::Blob::Ptr blob;
+    ASSERT_EQ(convertStringValToBlob(images, blob, tensorInfo, false), ovms::StatusCode::OK);
+    ASSERT_EQ(blob->size(), 24);
+    uint8_t* ptr = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<uint8_t*>();
+    EXPECT_TRUE(std::all_of(ptr, ptr + 12, [](uint8_t value) { return value == 7; }));
+    EXPECT_TRUE(std::equal(ptr + 12, ptr + 24, rgb_expected_blob));
+
+    *images.mutable_string_val(1) = "INVALID_IMAGE";
+    EXPECT_EQ(convertStringValToBlob(images, blob, tensorInfo, false), ovms::StatusCode::IMAGE_PARSING_FAILED);
+
+    // FP32 inputs are decoded on CPU only
+    tensorInfo = std::make_shared<TensorInfo>("", InferenceEngine::Precision::FP32, shape_t{2, 3, 2, 2}, InferenceEngine::Layout::NHWC);
+    EXPECT_EQ(convertStringValToBlob(images, blob, tensorInfo, false), ovms::StatusCode::IMAGE_PARSING_FAILED);
+    ASSERT_EQ(loadImageDecoderLibrary(""), ovms::StatusCode::OK);
+}
+
+TEST_F(BinaryUtilsTest, decoder_library_without_decode_images_is_not_loaded) {
+    EXPECT_EQ(loadImageDecoderLibrary("/ovms/bazel-bin/src/lib_node_mock.so"), ovms::StatusCode::IMAGE_DECODER_LIBRARY_LOAD_FAILED);
+    EXPECT_EQ(loadImageDecoderLibrary("/ovms/bazel-bin/src/not_existing.so"), ovms::StatusCode::IMAGE_DECODER_LIBRARY_LOAD_FAILED);
+}
 }  // namespace
@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdint>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../blob_arena.hpp"
+#include "../ov_utils.hpp"
+
+using namespace ovms;
+
+TEST(BlobArena, AllocationsAreAlignedAndDoNotOverlap) {
+    BlobArena arena(1024);
+    auto* first = static_cast<char*>(arena.alloc(10));
+    auto* second = static_cast<char*>(arena.alloc(100));
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % BlobArena::ALIGNMENT, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % BlobArena::ALIGNMENT, 0);
+    EXPECT_GE(second - first, 10);
+    EXPECT_EQ(arena.getUsedBytes(), 64 + 128);
+    EXPECT_EQ(arena.getCapacity(), 1024);
+}
+
+TEST(BlobArena, GrowsAndMergesBlocksOnReset) {
+    BlobArena arena(1024);
+    ASSERT_NE(arena.alloc(1000), nullptr);
+    ASSERT_NE(arena.alloc(1000), nullptr);
+    ASSERT_NE(arena.alloc(10000), nullptr);
+    EXPECT_EQ(arena.getCapacity(), 1024 + 2048 + 10048);
+
+    arena.reset();
+    EXPECT_EQ(arena.getUsedBytes(), 0);
+    EXPECT_EQ(arena.getCapacity(), 1024 + 2048 + 10048);
+    auto* first = static_cast<char*>(arena.alloc(1000));
+    auto* second = static_cast<char*>(arena.alloc(10000));
+    // merged block fits previous allocations at once
+    EXPECT_EQ(second - first, 1024);
+    EXPECT_EQ(arena.getCapacity(), 1024 + 2048 + 10048);
+}
+
+TEST(BlobArenaPool, ReleasedArenaIsReused) {
+    auto pool = std::make_shared<BlobArenaPool>(1024);
+    auto arena = pool->acquire();
+    auto* rawArena = arena.get();
+    auto* data = arena->alloc(100);
+    arena.reset();
+    EXPECT_EQ(pool->getIdleArenasCount(), 1);
+
+    arena = pool->acquire();
+    EXPECT_EQ(arena.get(), rawArena);
+    EXPECT_EQ(pool->getIdleArenasCount(), 0);
+    EXPECT_EQ(arena->getUsedBytes(), 0);
+    EXPECT_EQ(arena->alloc(100), data);
+}
+
+TEST(BlobArenaPool, KeepsLimitedNumberOfSmallArenas) {
+    auto pool = std::make_shared<BlobArenaPool>(1024, 1, 4096);
+    auto first = pool->acquire();
+    auto second = pool->acquire();
+    auto big = pool->acquire();
+    ASSERT_NE(big->alloc(8192), nullptr);
+    big.reset();
+    EXPECT_EQ(pool->getIdleArenasCount(), 0);
+    first.reset();
+    second.reset();
+    EXPECT_EQ(pool->getIdleArenasCount(), 1);
+}
+
+TEST(BlobArenaPool, ArenaOutlivesPool) {
+    auto pool = std::make_shared<BlobArenaPool>(1024);
+    auto arena = pool->acquire();
+    pool.reset();
+    EXPECT_NE(arena->alloc(10), nullptr);
+    arena.reset();
+}
+
+TEST(BlobArenaPool, BlobKeepsArenaAlive) {
+    auto pool = std::make_shared<BlobArenaPool>(1024);
+    InferenceEngine::Blob::Ptr blob;
+    {
+        std::shared_ptr<InferenceEngine::IAllocator> arena = pool->acquire();
+        ASSERT_EQ(createSharedBlob(blob, InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {1, 10}, InferenceEngine::Layout::NC), arena), StatusCode::OK);
+    }
+    EXPECT_EQ(pool->getIdleArenasCount(), 0);
+    InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<float*>()[9] = 1.0;
+    blob.reset();
+    EXPECT_EQ(pool->getIdleArenasCount(), 1);
+}
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../compilation_pool.hpp"
+
+using ovms::CompilationPool;
+
+class CompilationPoolTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        CompilationPool::instance().configure(0);
+    }
+};
+
+TEST_F(CompilationPoolTest, RunsOnCallingThreadWhenNotConfigured) {
+    const auto caller = std::this_thread::get_id();
+    std::thread::id executor;
+    CompilationPool::instance().run([&executor]() { executor = std::this_thread::get_id(); });
+    EXPECT_EQ(executor, caller);
+}
+
+TEST_F(CompilationPoolTest, RunsOnBackgroundThread) {
+    CompilationPool::instance().configure(1, 5);
+    const auto caller = std::this_thread::get_id();
+    std::thread::id executor;
+    int niceness = 0;
+    CompilationPool::instance().run([&executor, &niceness]() {
+        executor = std::this_thread::get_id();
+        niceness = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+    });
+    EXPECT_NE(executor, caller);
+    EXPECT_EQ(niceness, 5);
+}
+
+TEST_F(CompilationPoolTest, LimitsConcurrentCompilations) {
+    CompilationPool::instance().configure(2);
+    std::atomic<int> running{0};
+    std::atomic<int> maxRunning{0};
+    std::vector<std::thread> loaders;
+    for (int i = 0; i < 6; ++i) {
+        loaders.emplace_back([&running, &maxRunning]() {
+            CompilationPool::instance().run([&running, &maxRunning]() {
+                int current = ++running;
+                int previous = maxRunning.load();
+                while (previous < current && !maxRunning.compare_exchange_weak(previous, current)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                --running;
+            });
+        });
+    }
+    for (auto& loader : loaders) {
+        loader.join();
+    }
+    EXPECT_LE(maxRunning, 2);
+}
+
+TEST_F(CompilationPoolTest, RethrowsExceptionAndRunsNestedCompilationInline) {
+    CompilationPool::instance().configure(1);
+    EXPECT_THROW(CompilationPool::instance().run([]() { throw std::runtime_error("compilation failed"); }), std::runtime_error);
+    bool nestedExecuted = false;
+    CompilationPool::instance().run([&nestedExecuted]() {
+        CompilationPool::instance().run([&nestedExecuted]() { nestedExecuted = true; });
+    });
+    EXPECT_TRUE(nestedExecuted);
+}
@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../compiled_network_registry.hpp"
+#include "test_utils.hpp"
+
+using ovms::CompiledNetworkRegistry;
+
+class CompiledNetworkRegistryTest : public TestWithTempDir {
+protected:
+    std::string writeFile(const std::string& name, const std::string& content) {
+        auto path = directoryPath + "/" + name;
+        std::ofstream file(path, std::ios::binary);
+        file << content;
+        return path;
+    }
+};
+
+TEST_F(CompiledNetworkRegistryTest, SharesNetworkWhileInUse) {
+    CompiledNetworkRegistry registry;
+    int compilations = 0;
+    auto compile = [&compilations]() {
+        ++compilations;
+        return std::make_shared<InferenceEngine::ExecutableNetwork>();
+    };
+    bool shared = true;
+    auto first = registry.getOrCompile("key", compile, shared);
+    EXPECT_FALSE(shared);
+    auto second = registry.getOrCompile("key", compile, shared);
+    EXPECT_TRUE(shared);
+    EXPECT_EQ(first, second);
+    auto other = registry.getOrCompile("other", compile, shared);
+    EXPECT_FALSE(shared);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(compilations, 2);
+    EXPECT_EQ(registry.size(), 2);
+
+    first.reset();
+    second.reset();
+    EXPECT_EQ(registry.size(), 1);
+    registry.getOrCompile("key", compile, shared);
+    EXPECT_FALSE(shared);
+    EXPECT_EQ(compilations, 3);
+}
+
+TEST_F(CompiledNetworkRegistryTest, HashesFilesContents) {
+    auto xml = writeFile("model.xml", "model");
+    auto bin = writeFile("model.bin", "weights");
+    auto copy = writeFile("copy.bin", "weights");
+    auto changed = writeFile("changed.bin", "weightz");
+    std::string hash, copyHash, changedHash, swappedHash;
+    ASSERT_TRUE(CompiledNetworkRegistry::hashFiles({xml, bin}, hash));
+    ASSERT_TRUE(CompiledNetworkRegistry::hashFiles({xml, copy}, copyHash));
+    ASSERT_TRUE(CompiledNetworkRegistry::hashFiles({xml, changed}, changedHash));
+    ASSERT_TRUE(CompiledNetworkRegistry::hashFiles({bin, xml}, swappedHash));
+    EXPECT_EQ(hash, copyHash);
+    EXPECT_NE(hash, changedHash);
+    EXPECT_NE(hash, swappedHash);
+    EXPECT_FALSE(CompiledNetworkRegistry::hashFiles({directoryPath + "/missing.bin"}, hash));
+}
@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <gtest/gtest.h>
+
+#include "../cpu_budget.hpp"
+#include "../modelconfig.hpp"
+#include "../modelinstance.hpp"
+
+using namespace ovms;
+
+class CpuBudgetTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        CpuBudget::instance().setBudget(0, 0);
+        CpuBudget::instance().setModelWeights({});
+    }
+};
+
+TEST_F(CpuBudgetTest, DisabledByDefault) {
+    CpuBudget::instance().setModelWeights({{"a", 1}});
+    EXPECT_FALSE(CpuBudget::instance().isEnabled());
+    auto share = CpuBudget::instance().getShare("a");
+    EXPECT_EQ(share.threads, 0);
+    EXPECT_EQ(share.streams, 0);
+}
+
+TEST_F(CpuBudgetTest, DividedByWeight) {
+    CpuBudget::instance().setBudget(16, 8);
+    CpuBudget::instance().setModelWeights({{"a", 3}, {"b", 1}});
+    auto share = CpuBudget::instance().getShare("a");
+    EXPECT_EQ(share.threads, 12);
+    EXPECT_EQ(share.streams, 6);
+    share = CpuBudget::instance().getShare("b");
+    EXPECT_EQ(share.threads, 4);
+    EXPECT_EQ(share.streams, 2);
+}
+
+TEST_F(CpuBudgetTest, UnregisteredModelCountsWithWeightOne) {
+    CpuBudget::instance().setBudget(9, 0);
+    CpuBudget::instance().setModelWeights({{"a", 2}});
+    EXPECT_EQ(CpuBudget::instance().getShare("other").threads, 3);
+    EXPECT_EQ(CpuBudget::instance().getShare("other").streams, 0);
+}
+
+TEST_F(CpuBudgetTest, ShareIsAtLeastOneAndStreamsDoNotExceedThreads) {
+    CpuBudget::instance().setBudget(2, 8);
+    CpuBudget::instance().setModelWeights({{"a", 1}, {"b", 1}, {"c", 1}, {"d", 1}});
+    auto share = CpuBudget::instance().getShare("a");
+    EXPECT_EQ(share.threads, 1);
+    EXPECT_EQ(share.streams, 1);
+}
+
+TEST_F(CpuBudgetTest, AppliedToDefaultPluginConfigUnlessSet) {
+    CpuBudget::instance().setBudget(8, 4);
+    CpuBudget::instance().setModelWeights({{"a", 1}, {"b", 1}});
+    ModelConfig config;
+    config.setName("a");
+    config.setTargetDevice("CPU");
+    config.setPluginConfig({});
+    auto pluginConfig = ModelInstance::prepareDefaultPluginConfig(config);
+    EXPECT_EQ(pluginConfig["CPU_THREADS_NUM"], "4");
+    EXPECT_EQ(pluginConfig["CPU_THROUGHPUT_STREAMS"], "2");
+
+    config.setPluginConfig({{"CPU_THROUGHPUT_STREAMS", "1"}});
+    pluginConfig = ModelInstance::prepareDefaultPluginConfig(config);
+    EXPECT_EQ(pluginConfig["CPU_THREADS_NUM"], "4");
+    EXPECT_EQ(pluginConfig["CPU_THROUGHPUT_STREAMS"], "1");
+
+    config.setTargetDevice("GPU");
+    pluginConfig = ModelInstance::prepareDefaultPluginConfig(config);
+    EXPECT_EQ(pluginConfig.count("CPU_THREADS_NUM"), 0);
+}
@@ -0,0 +1,56 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdio>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "../cpu_topology.hpp"
+
+using namespace ovms;
+
+TEST(CpuTopology, ReadCpuListFile) {
+    const std::string path = "/tmp/ovms_cpu_topology_test_cpus";
+    {
+        std::ofstream file(path);
+        file << "0-3,8\n";
+    }
+    auto cpus = readCpuListFile(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(cpus);
+    EXPECT_EQ(cpus.value(), std::vector<int>({0, 1, 2, 3, 8}));
+}
+
+TEST(CpuTopology, ReadMissingCpuListFile) {
+    EXPECT_FALSE(readCpuListFile("/tmp/ovms_cpu_topology_test_not_existing"));
+}
+
+TEST(CpuTopology, ParseCpuAffinityList) {
+    auto cpus = parseCpuAffinity("1,4-5");
+    ASSERT_TRUE(cpus);
+    EXPECT_EQ(cpus.value(), std::vector<int>({1, 4, 5}));
+    EXPECT_FALSE(parseCpuAffinity("performance,1"));
+    EXPECT_FALSE(parseCpuAffinity("fast"));
+}
+
+TEST(CpuTopology, ParseCpuAffinityKeywords) {
+    for (const char* keyword : {PERFORMANCE_CORES, EFFICIENCY_CORES}) {
+        auto cpus = parseCpuAffinity(keyword);
+        ASSERT_TRUE(cpus) << keyword;
+        auto expected = readCpuListFile(std::string(keyword) == PERFORMANCE_CORES ? PERFORMANCE_CORES_PATH : EFFICIENCY_CORES_PATH);
+        EXPECT_EQ(cpus.value(), expected.value_or(std::vector<int>())) << keyword;
+    }
+}
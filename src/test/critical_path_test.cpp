@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../critical_path.hpp"
+
+using namespace ovms;
+using testing::ElementsAre;
+
+namespace {
+// request branches into slow and fast node, both consumed by response
+CriticalPathAnalyzer createDiamondAnalyzer() {
+    return CriticalPathAnalyzer({"request", "slow", "fast", "response"}, {{0, 1}, {0, 2}, {1, 3}, {2, 3}});
+}
+}  // namespace
+
+TEST(CriticalPathAnalyzer, ComputesContributionAndSlackOfParallelBranches) {
+    auto analyzer = createDiamondAnalyzer();
+    analyzer.record({{"request", 0, 10, 0}, {"slow", 10, 110, 30}, {"fast", 10, 40, 0}, {"response", 110, 115, 0}});
+    const auto report = analyzer.getReport();
+    ASSERT_EQ(report.samples, 1);
+    EXPECT_EQ(report.latencyUs, 115);
+    EXPECT_THAT(report.criticalPath, ElementsAre("request", "slow", "response"));
+    EXPECT_EQ(report.criticalPathFraction, 1);
+    ASSERT_EQ(report.nodes.size(), 4);
+    EXPECT_EQ(report.nodes[0].contributionUs, 10);
+    EXPECT_EQ(report.nodes[0].slackUs, 0);
+    EXPECT_EQ(report.nodes[1].criticalFraction, 1);
+    EXPECT_EQ(report.nodes[1].contributionUs, 100);
+    EXPECT_DOUBLE_EQ(report.nodes[1].contributionShare, 100.0 / 115);
+    EXPECT_EQ(report.nodes[1].slackUs, 0);
+    EXPECT_EQ(report.nodes[1].streamWaitUs, 30);
+    EXPECT_EQ(report.nodes[2].criticalFraction, 0);
+    EXPECT_EQ(report.nodes[2].contributionUs, 0);
+    EXPECT_EQ(report.nodes[2].slackUs, 70);
+    EXPECT_EQ(report.nodes[2].minSlackUs, 70);
+    EXPECT_EQ(report.nodes[3].contributionUs, 5);
+}
+
+TEST(CriticalPathAnalyzer, AggregatesSamplesWithChangingCriticalPath) {
+    auto analyzer = createDiamondAnalyzer();
+    analyzer.record({{"request", 0, 10, 0}, {"slow", 10, 110, 0}, {"fast", 10, 40, 0}, {"response", 110, 115, 0}});
+    analyzer.record({{"request", 0, 10, 0}, {"slow", 10, 110, 0}, {"fast", 10, 60, 0}, {"response", 110, 115, 0}});
+    analyzer.record({{"request", 0, 10, 0}, {"slow", 10, 50, 0}, {"fast", 10, 90, 0}, {"response", 90, 95, 0}});
+    const auto report = analyzer.getReport();
+    ASSERT_EQ(report.samples, 3);
+    EXPECT_THAT(report.criticalPath, ElementsAre("request", "slow", "response"));
+    EXPECT_DOUBLE_EQ(report.criticalPathFraction, 2.0 / 3);
+    EXPECT_DOUBLE_EQ(report.nodes[1].criticalFraction, 2.0 / 3);
+    EXPECT_DOUBLE_EQ(report.nodes[2].criticalFraction, 1.0 / 3);
+    EXPECT_DOUBLE_EQ(report.nodes[2].slackUs, (70.0 + 50.0 + 0.0) / 3);
+    EXPECT_EQ(report.nodes[2].minSlackUs, 0);
+    EXPECT_EQ(report.nodes[1].minSlackUs, 0);
+    EXPECT_DOUBLE_EQ(report.nodes[1].slackUs, 40.0 / 3);
+}
+
+TEST(CriticalPathAnalyzer, LeavesOutNodesNotCreatedForExecution) {
+    auto analyzer = createDiamondAnalyzer();
+    analyzer.record({{"request", 0, 10, 0}, {"fast", 10, 40, 0}, {"response", 40, 45, 0}});
+    const auto report = analyzer.getReport();
+    EXPECT_THAT(report.criticalPath, ElementsAre("request", "fast", "response"));
+    EXPECT_EQ(report.nodes[1].samples, 0);
+    EXPECT_EQ(report.nodes[2].samples, 1);
+    EXPECT_EQ(report.nodes[2].slackUs, 0);
+}
+
+TEST(CriticalPathAnalyzer, KeepsLastSamples) {
+    auto analyzer = createDiamondAnalyzer();
+    for (size_t i = 0; i < CriticalPathAnalyzer::WINDOW_SAMPLES + 5; ++i) {
+        analyzer.record({{"request", 0, 10, 0}, {"slow", 10, 110, 0}, {"fast", 10, 40, 0}, {"response", 110, 115, 0}});
+    }
+    EXPECT_EQ(analyzer.getReport().samples, CriticalPathAnalyzer::WINDOW_SAMPLES);
+}
+
+TEST(CriticalPathAnalyzer, SamplesEveryNthExecution) {
+    auto analyzer = createDiamondAnalyzer();
+    CriticalPathAnalyzer::setSamplingInterval(3);
+    std::vector<bool> sampled;
+    for (int i = 0; i < 6; ++i) {
+        sampled.push_back(analyzer.sample());
+    }
+    EXPECT_THAT(sampled, ElementsAre(true, false, false, true, false, false));
+    CriticalPathAnalyzer::setSamplingInterval(0);
+    EXPECT_FALSE(analyzer.sample());
+    CriticalPathAnalyzer::setSamplingInterval(CriticalPathAnalyzer::DEFAULT_SAMPLING_INTERVAL);
+}
@@ -25,6 +25,8 @@
 #include <inference_engine.hpp>
 #include <stdlib.h>
 
+#include "../customloaderinterface.hpp"
+#include "../customloaders.hpp"
 #include "../executingstreamidguard.hpp"
 #include "../get_model_metadata_impl.hpp"
 #include "../localfilesystem.hpp"
@@ -1325,4 +1327,66 @@ TEST_F(TestCustomLoader, CustomLoaderLoadBlackListedModel) {
     EXPECT_EQ(json_output2, expected_json_available);
 }
 
+class VectorCustomLoader : public CustomLoaderInterface {
+public:
+    CustomLoaderStatus loaderInit(const std::string& loaderConfigFile) override { return CustomLoaderStatus::OK; }
+    CustomLoaderStatus loadModel(const std::string& modelName, const std::string& basePath, const int version,
+        const std::string& loaderOptions, std::vector<uint8_t>& modelBuffer, std::vector<uint8_t>& weights) override {
+        modelBuffer = {'x', 'm', 'l'};
+        weights = {1, 2, 3, 4};
+        return CustomLoaderStatus::MODEL_TYPE_IR;
+    }
+    CustomLoaderStatus unloadModel(const std::string& modelName, const int version) override { return CustomLoaderStatus::OK; }
+    CustomLoaderStatus retireModel(const std::string& modelName) override { return CustomLoaderStatus::OK; }
+    CustomLoaderStatus loaderDeInit() override { return CustomLoaderStatus::OK; }
+};
+
+TEST(CustomLoaderBuffers, DefaultImplementationWrapsLoadedVectors) {
+    VectorCustomLoader loader;
+    CustomLoaderBuffer model;
+    CustomLoaderBuffer weights;
+    ASSERT_EQ(loader.loadModelBuffers("dummy", "/tmp", 1, "", model, weights), CustomLoaderStatus::MODEL_TYPE_IR);
+    EXPECT_EQ(model.fd, -1);
+    ASSERT_EQ(model.size, 3);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(model.data), model.size), "xml");
+    ASSERT_EQ(weights.size, 4);
+    EXPECT_EQ(weights.data[3], 4);
+    ASSERT_TRUE(model.release);
+    ASSERT_TRUE(weights.release);
+    model.release();
+    weights.release();
+}
+
+class CountingBlacklistCustomLoader : public VectorCustomLoader {
+public:
+    int blacklistQueries = 0;
+    CustomLoaderBlacklistCallback callback;
+    CustomLoaderStatus getModelBlacklistStatus(const std::string& modelName, const int version) override {
+        ++blacklistQueries;
+        return CustomLoaderStatus::OK;
+    }
+    bool registerBlacklistCallback(CustomLoaderBlacklistCallback callback) override {
+        this->callback = callback;
+        return true;
+    }
+};
+
+TEST(CustomLoaderBlacklist, PushedStatusIsCached) {
+    auto& customloaders = ovms::CustomLoaders::instance();
+    auto loader = std::make_shared<CountingBlacklistCustomLoader>();
+    const std::string loaderName = "blacklist_pushing_loader";
+    customloaders.setBlacklistPushing(loaderName);
+    EXPECT_EQ(customloaders.getModelBlacklistStatus(loaderName, *loader, "dummy", 1), CustomLoaderStatus::OK);
+    EXPECT_EQ(customloaders.getModelBlacklistStatus(loaderName, *loader, "dummy", 1), CustomLoaderStatus::OK);
+    EXPECT_EQ(loader->blacklistQueries, 1);
+    customloaders.updateBlacklistStatus(loaderName, "dummy", 1, CustomLoaderStatus::MODEL_BLACKLISTED);
+    EXPECT_EQ(customloaders.getModelBlacklistStatus(loaderName, *loader, "dummy", 1), CustomLoaderStatus::MODEL_BLACKLISTED);
+    EXPECT_EQ(loader->blacklistQueries, 1);
+
+    // loaders which do not push changes are polled
+    EXPECT_EQ(customloaders.getModelBlacklistStatus("polled_loader", *loader, "dummy", 1), CustomLoaderStatus::OK);
+    EXPECT_EQ(customloaders.getModelBlacklistStatus("polled_loader", *loader, "dummy", 1), CustomLoaderStatus::OK);
+    EXPECT_EQ(loader->blacklistQueries, 3);
+}
+
 #pragma GCC diagnostic pop
@@ -0,0 +1,87 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../custom_node_executor.hpp"
+
+using ovms::CustomNodeExecutor;
+using ovms::CustomNodeLibraryExecutionConfig;
+
+TEST(CustomNodeExecutor, RunsOnCallingThreadWithoutWorkerThreads) {
+    CustomNodeLibraryExecutionConfig config;
+    config.maxConcurrency = 1;
+    CustomNodeExecutor executor(config);
+    EXPECT_FALSE(executor.isAsync());
+    std::thread::id executionThread;
+    bool notified = false;
+    executor.run([&executionThread]() { executionThread = std::this_thread::get_id(); },
+        [&executor, &notified]() {
+            // execution slot is given back before notification
+            EXPECT_EQ(executor.getRunningCount(), 0);
+            notified = true;
+        });
+    EXPECT_EQ(executionThread, std::this_thread::get_id());
+    EXPECT_TRUE(notified);
+}
+
+TEST(CustomNodeExecutor, LimitsConcurrencyOfWorkerThreads) {
+    CustomNodeLibraryExecutionConfig config;
+    config.maxConcurrency = 2;
+    config.workerThreads = 4;
+    std::atomic<int> running{0};
+    std::atomic<int> maxRunning{0};
+    std::atomic<int> notified{0};
+    {
+        CustomNodeExecutor executor(config);
+        EXPECT_TRUE(executor.isAsync());
+        for (int i = 0; i < 20; ++i) {
+            executor.run([&running, &maxRunning]() {
+                int current = ++running;
+                int previousMax = maxRunning.load();
+                while (current > previousMax && !maxRunning.compare_exchange_weak(previousMax, current)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                --running;
+            },
+                [&notified]() { ++notified; });
+        }
+    }
+    EXPECT_EQ(notified, 20);
+    EXPECT_LE(maxRunning, 2);
+}
+
+TEST(CustomNodeExecutor, RunReturnsBeforeExecutionOnWorkerThreadFinishes) {
+    CustomNodeLibraryExecutionConfig config;
+    config.workerThreads = 1;
+    config.cpuAffinity = {0};
+    CustomNodeExecutor executor(config);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<std::thread::id> finished;
+    executor.run([released]() { released.wait(); },
+        [&finished]() { finished.set_value(std::this_thread::get_id()); });
+    release.set_value();
+    auto finishedFuture = finished.get_future();
+    ASSERT_EQ(finishedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_NE(finishedFuture.get(), std::this_thread::get_id());
+}
@@ -41,12 +41,17 @@ public:
     void setFetchResult(InferenceEngine::Blob::Ptr& intermediateResultBlob) {
         this->intermediateResultBlob = intermediateResultBlob;
     }
+    void setSecondFetchResult(InferenceEngine::Blob::Ptr& secondIntermediateResultBlob) {
+        this->secondIntermediateResultBlob = secondIntermediateResultBlob;
+    }
     using Node::fetchResults;
     Status fetchResults(NodeSession& nodeSession, SessionResults& nodeSessionOutputs) {
         const auto& sessionMetadata = nodeSession.getNodeSessionMetadata();
         const auto sessionKey = sessionMetadata.getSessionKey();
-        InferenceEngine::Blob::Ptr secondOutput;
-        EXPECT_EQ(blobClone(secondOutput, intermediateResultBlob), StatusCode::OK);
+        InferenceEngine::Blob::Ptr secondOutput = secondIntermediateResultBlob;
+        if (!secondOutput) {
+            EXPECT_EQ(blobClone(secondOutput, intermediateResultBlob), StatusCode::OK);
+        }
         BlobMap blobs{{mockerDemutliplexerNodeOutputName, intermediateResultBlob},
             {mockerDemutliplexerNodeOutputName2, secondOutput}};
         std::pair<NodeSessionMetadata, BlobMap> metaBlobsPair{sessionMetadata, std::move(blobs)};
@@ -56,6 +61,7 @@ public:
 
 private:
     InferenceEngine::Blob::Ptr intermediateResultBlob;
+    InferenceEngine::Blob::Ptr secondIntermediateResultBlob;
 };
 
 using ::testing::AnyOf;
@@ -104,6 +110,74 @@ TEST(DemultiplexerTest, CheckDemultipliedBlobsMultipleOutputs) {
     }
 }
 
+TEST(DemultiplexerTest, DemultipliedBlobsAreViewsIntoParentBlob) {
+    const uint16_t demultiplyCount = 3;
+    std::vector<float> blobData{-1, 4, 5, 12, 3, 52};
+    const std::vector<size_t> shape{demultiplyCount, 1, 2};
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::FP32, shape, InferenceEngine::Layout::CHW};
+    InferenceEngine::Blob::Ptr intermediateResultBlob = InferenceEngine::make_shared_blob<float>(desc, blobData.data());
+    NodeSessionMetadata meta;
+    ConstructorEnabledModelManager manager;
+    std::string demultiplexerNodeName("node");
+    DemultiplexerDLNode demultiplexerNode(demultiplexerNodeName, "model", 1, manager, std::unordered_map<std::string, std::string>{{"NOT_USED", "NOT_USED"}}, demultiplyCount, meta);
+    demultiplexerNode.setFetchResult(intermediateResultBlob);
+    SessionResults sessionResults;
+    auto status = demultiplexerNode.fetchResults(meta.getSessionKey(), sessionResults);
+    ASSERT_EQ(status, StatusCode::OK);
+    auto demultiplexedMetadata = meta.generateSubsessions(demultiplexerNodeName, demultiplyCount);
+    for (size_t shardId = 0; shardId < demultiplyCount; ++shardId) {
+        auto& blob = sessionResults.at(demultiplexedMetadata[shardId].getSessionKey()).second.at(mockerDemutliplexerNodeOutputName);
+        const float* shardData = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const float*>();
+        EXPECT_EQ(shardData, blobData.data() + shardId * 2) << "shard: " << shardId << " is not a view into parent blob";
+    }
+}
+
+TEST(DemultiplexerTest, DynamicDemultiplexerPassesSingleElementBlobToEveryShard) {
+    const size_t shardsCount = 3;
+    std::vector<float> blobData{-1, 4, 5, 12, 3, 52};
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::FP32, {shardsCount, 1, 2}, InferenceEngine::Layout::CHW};
+    InferenceEngine::Blob::Ptr intermediateResultBlob = InferenceEngine::make_shared_blob<float>(desc, blobData.data());
+    std::vector<float> broadcastedData{7, 8, 9, 10};
+    const InferenceEngine::TensorDesc broadcastedDesc{InferenceEngine::Precision::FP32, {1, 1, 4}, InferenceEngine::Layout::CHW};
+    InferenceEngine::Blob::Ptr broadcastedBlob = InferenceEngine::make_shared_blob<float>(broadcastedDesc, broadcastedData.data());
+    NodeSessionMetadata meta;
+    ConstructorEnabledModelManager manager;
+    std::string demultiplexerNodeName("node");
+    DemultiplexerDLNode demultiplexerNode(demultiplexerNodeName, "model", 1, manager, std::unordered_map<std::string, std::string>{{"NOT_USED", "NOT_USED"}}, 0, meta);
+    demultiplexerNode.setFetchResult(intermediateResultBlob);
+    demultiplexerNode.setSecondFetchResult(broadcastedBlob);
+    SessionResults sessionResults;
+    auto status = demultiplexerNode.fetchResults(meta.getSessionKey(), sessionResults);
+    ASSERT_EQ(status, StatusCode::OK);
+    ASSERT_EQ(sessionResults.size(), shardsCount);
+    auto demultiplexedMetadata = meta.generateSubsessions(demultiplexerNodeName, shardsCount);
+    for (size_t shardId = 0; shardId < shardsCount; ++shardId) {
+        auto& blobs = sessionResults.at(demultiplexedMetadata[shardId].getSessionKey()).second;
+        const float* shardData = InferenceEngine::as<InferenceEngine::MemoryBlob>(blobs.at(mockerDemutliplexerNodeOutputName))->rmap().as<const float*>();
+        EXPECT_EQ(shardData, blobData.data() + shardId * 2);
+        auto& broadcastedShard = blobs.at(mockerDemutliplexerNodeOutputName2);
+        EXPECT_THAT(broadcastedShard->getTensorDesc().getDims(), ElementsAre(1, 4));
+        const float* broadcastedShardData = InferenceEngine::as<InferenceEngine::MemoryBlob>(broadcastedShard)->rmap().as<const float*>();
+        EXPECT_EQ(broadcastedShardData, broadcastedData.data()) << "shard: " << shardId << " is not a view of whole blob";
+    }
+}
+
+TEST(DemultiplexerTest, DynamicDemultiplexerShouldReturnErrorWhenOutputsFirstDimensionsDiffer) {
+    std::vector<float> blobData{-1, 4, 5, 12, 3, 52};
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::FP32, {3, 1, 2}, InferenceEngine::Layout::CHW};
+    InferenceEngine::Blob::Ptr intermediateResultBlob = InferenceEngine::make_shared_blob<float>(desc, blobData.data());
+    const InferenceEngine::TensorDesc secondDesc{InferenceEngine::Precision::FP32, {2, 1, 3}, InferenceEngine::Layout::CHW};
+    InferenceEngine::Blob::Ptr secondBlob = InferenceEngine::make_shared_blob<float>(secondDesc, blobData.data());
+    NodeSessionMetadata meta;
+    ConstructorEnabledModelManager manager;
+    DemultiplexerDLNode demultiplexerNode("node", "model", 1, manager, std::unordered_map<std::string, std::string>{{"NOT_USED", "NOT_USED"}}, 0, meta);
+    demultiplexerNode.setFetchResult(intermediateResultBlob);
+    demultiplexerNode.setSecondFetchResult(secondBlob);
+    SessionResults sessionResults;
+    auto status = demultiplexerNode.fetchResults(meta.getSessionKey(), sessionResults);
+    EXPECT_EQ(status, StatusCode::PIPELINE_WRONG_DIMENSION_SIZE_TO_DEMULTIPLY);
+}
+
 TEST(DemultiplexerTest, DemultiplyShouldReturnErrorWhenWrongOutputDimensions) {
     const uint16_t demultiplyCount = 3;
     std::vector<float> blobData{-1, 4, 5, 12, 3, 52};
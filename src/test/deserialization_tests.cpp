@@ -14,6 +14,8 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -31,6 +33,7 @@
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
+#include "../blobmap.hpp"
 #include "../deserialization.hpp"
 #include "ovtestutils.hpp"
 
@@ -232,6 +235,168 @@ TEST_P(DeserializeTFTensorProto, ShouldReturnValidBlob) {
                                 << " should return valid blob ptr";
 }
 
+TEST_F(TensorflowGRPCPredict, ShouldNarrowHalfValuesForFP16) {
+    tensorMap[tensorName]->setPrecision(Precision::FP16);
+    tensorProto.set_dtype(tensorflow::DataType::DT_HALF);
+    tensorProto.mutable_tensor_content()->clear();
+    const std::vector<uint16_t> values{0x3C00, 0xC000, 0x7BFF};
+    for (auto value : values) {
+        tensorProto.add_half_val(value);
+    }
+    InferenceEngine::Blob::Ptr blobPtr = deserializeTensorProto<ConcreteTensorProtoDeserializator>(tensorProto, tensorMap[tensorName], isPipeline);
+    ASSERT_NE(nullptr, blobPtr);
+    const uint16_t* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blobPtr)->rmap().as<const uint16_t*>();
+    EXPECT_EQ(std::vector<uint16_t>(data, data + values.size()), values);
+}
+
+TEST_F(TensorflowGRPCPredict, ShouldUseTensorContentForFP16WithoutCopy) {
+    tensorMap[tensorName]->setPrecision(Precision::FP16);
+    tensorProto.set_dtype(tensorflow::DataType::DT_HALF);
+    *(tensorProto.mutable_tensor_content()) = std::string(1 * 3 * 1 * 1 * sizeof(uint16_t), '1');
+    InferenceEngine::Blob::Ptr blobPtr = deserializeTensorProto<ConcreteTensorProtoDeserializator>(tensorProto, tensorMap[tensorName], isPipeline);
+    ASSERT_NE(nullptr, blobPtr);
+    EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(blobPtr)->rmap().as<const char*>(), tensorProto.tensor_content().data());
+}
+
+TEST_F(TensorflowGRPCPredict, ShouldConvertFP32RequestToFP16) {
+    tensorMap[tensorName]->setPrecision(Precision::FP16);
+    tensorMap[tensorName]->setRequestPrecision(Precision::FP32);
+    const std::vector<float> values{1.0f, -2.0f, 65504.0f};
+    tensorProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    *(tensorProto.mutable_tensor_content()) = std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    InferenceEngine::Blob::Ptr blobPtr = deserializeTensorProto<ConcreteTensorProtoDeserializator>(tensorProto, tensorMap[tensorName], isPipeline);
+    ASSERT_NE(nullptr, blobPtr);
+    EXPECT_EQ(blobPtr->getTensorDesc().getPrecision(), Precision::FP16);
+    const uint16_t* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blobPtr)->rmap().as<const uint16_t*>();
+    EXPECT_EQ(std::vector<uint16_t>(data, data + values.size()), std::vector<uint16_t>({0x3C00, 0xC000, 0x7BFF}));
+}
+
+TEST_F(TensorflowGRPCPredict, ShouldConvertFP32RequestToU8WithSaturation) {
+    tensorMap[tensorName]->setPrecision(Precision::U8);
+    tensorMap[tensorName]->setRequestPrecision(Precision::FP32);
+    const std::vector<float> values{-5.0f, 2.5f, 300.0f};
+    tensorProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    *(tensorProto.mutable_tensor_content()) = std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    InferenceEngine::Blob::Ptr blobPtr = deserializeTensorProto<ConcreteTensorProtoDeserializator>(tensorProto, tensorMap[tensorName], isPipeline);
+    ASSERT_NE(nullptr, blobPtr);
+    const uint8_t* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blobPtr)->rmap().as<const uint8_t*>();
+    EXPECT_EQ(std::vector<uint8_t>(data, data + values.size()), std::vector<uint8_t>({0, 2, 255}));
+}
+
+TEST(DeserializePredictRequest, ShouldDeserializeLargeInputsInParallel) {
+    const size_t inputsCount = 16;
+    const size_t elements = 64;
+    setDeserializationWorkers(3, elements * sizeof(int32_t));
+    ovms::tensor_map_t tensorMap;
+    PredictRequest request;
+    for (size_t i = 0; i < inputsCount; i++) {
+        // every other input is below the threshold and stays on the request thread
+        const size_t size = i % 2 ? elements : elements / 2;
+        const std::string name = "input_" + std::to_string(i);
+        tensorMap[name] = std::make_shared<ovms::TensorInfo>(name, Precision::FP16, shape_t{1, size}, InferenceEngine::Layout::NC);
+        auto& tensorProto = (*request.mutable_inputs())[name];
+        tensorProto.set_dtype(tensorflow::DataType::DT_HALF);
+        tensorProto.mutable_tensor_shape()->add_dim()->set_size(1);
+        tensorProto.mutable_tensor_shape()->add_dim()->set_size(size);
+        for (size_t j = 0; j < size; j++) {
+            tensorProto.add_half_val(static_cast<int>(i * elements + j));
+        }
+        EXPECT_EQ(isDeserializedInParallel(tensorProto), i % 2 == 1);
+    }
+    BlobMap blobs;
+    InputSink<BlobMap&> inputSink(blobs);
+    bool isPipeline = true;
+    auto status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(request, tensorMap, inputSink, isPipeline);
+    setDeserializationWorkers(0, 0);
+    ASSERT_EQ(status, ovms::StatusCode::OK) << status.string();
+    ASSERT_EQ(blobs.size(), inputsCount);
+    for (size_t i = 0; i < inputsCount; i++) {
+        const auto& blob = blobs.at("input_" + std::to_string(i));
+        ASSERT_NE(blob, nullptr);
+        const uint16_t* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const uint16_t*>();
+        for (size_t j = 0; j < blob->size(); j++) {
+            ASSERT_EQ(static_cast<size_t>(data[j]), i * elements + j) << "input: " << i << " element: " << j;
+        }
+    }
+}
+
+TEST(MakeTransposedBlob, ShouldTransposeRequestDataToNetworkLayout) {
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>("image", Precision::FP32, shape_t{1, 3, 2, 2}, Layout::NHWC);
+    tensorInfo->setTransposedLayout(Layout::NCHW);
+    TensorProto tensorProto;
+    tensorProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    // 4 pixels of 3 channels
+    const std::vector<float> values{0, 1, 2, 10, 11, 12, 20, 21, 22, 30, 31, 32};
+    *(tensorProto.mutable_tensor_content()) = std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    bool isPipeline = false;
+    InferenceEngine::Blob::Ptr blobPtr = deserializeTensorProto<ConcreteTensorProtoDeserializator>(tensorProto, tensorInfo, isPipeline);
+    ASSERT_NE(nullptr, blobPtr);
+    EXPECT_EQ(blobPtr->getTensorDesc().getLayout(), Layout::NCHW);
+    EXPECT_EQ(blobPtr->getTensorDesc().getDims(), (SizeVector{1, 3, 2, 2}));
+    const float* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blobPtr)->rmap().as<const float*>();
+    EXPECT_EQ(std::vector<float>(data, data + values.size()), std::vector<float>({0, 10, 20, 30, 1, 11, 21, 31, 2, 12, 22, 32}));
+
+    auto boundBlob = InferenceEngine::make_shared_blob<float>(tensorInfo->getTransposedTensorDesc());
+    boundBlob->allocate();
+    ASSERT_TRUE(writeTensorProtoIntoBlob(tensorProto, tensorInfo, boundBlob));
+    EXPECT_EQ(std::vector<float>(boundBlob->buffer().as<float*>(), boundBlob->buffer().as<float*>() + values.size()),
+        std::vector<float>({0, 10, 20, 30, 1, 11, 21, 31, 2, 12, 22, 32}));
+}
+
+TEST(MakePlanarYuvBlob, ShouldWrapPlanesOfEachFrame) {
+    const size_t batch = 2, height = 4, width = 6;
+    const size_t frameSize = height * width * 3 / 2;
+    std::vector<char> data(batch * frameSize);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i);
+    }
+    auto nv12 = makePlanarYuvBlob(ColorFormat::NV12, 1, height, width, data.data(), nullptr);
+    auto nv12Blob = InferenceEngine::as<InferenceEngine::NV12Blob>(nv12);
+    ASSERT_NE(nv12Blob, nullptr);
+    EXPECT_EQ(nv12Blob->y()->getTensorDesc().getDims(), (SizeVector{1, 1, height, width}));
+    EXPECT_EQ(nv12Blob->uv()->getTensorDesc().getDims(), (SizeVector{1, 2, height / 2, width / 2}));
+    EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(nv12Blob->uv())->rmap().as<const char*>(), data.data() + height * width);
+
+    auto i420 = makePlanarYuvBlob(ColorFormat::I420, batch, height, width, data.data(), nullptr);
+    auto batchedBlob = InferenceEngine::as<InferenceEngine::BatchedBlob>(i420);
+    ASSERT_NE(batchedBlob, nullptr);
+    ASSERT_EQ(batchedBlob->size(), batch);
+    auto secondFrame = InferenceEngine::as<InferenceEngine::I420Blob>(batchedBlob->getBlob(1));
+    ASSERT_NE(secondFrame, nullptr);
+    EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(secondFrame->y())->rmap().as<const char*>(), data.data() + frameSize);
+    EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(secondFrame->v())->rmap().as<const char*>(), data.data() + frameSize + height * width * 5 / 4);
+
+    EXPECT_EQ(makePlanarYuvBlob(ColorFormat::BGR, 1, height, width, data.data(), nullptr), nullptr);
+}
+
+TEST(ConvertFromFp32, ShouldMatchScalarConversionForLongBuffers) {
+    // not a multiple of vector width to cover the scalar tail
+    std::vector<float> values(1000 + 13);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = (static_cast<float>(i) - 500.0f) * 0.75f;
+    }
+    std::vector<int8_t> converted(values.size());
+    ASSERT_TRUE(ovms::convertFromFp32(Precision::I8, values.data(), converted.data(), values.size()));
+    for (size_t i = 0; i < values.size(); i++) {
+        float expected = std::min(127.0f, std::max(-128.0f, std::nearbyint(values[i])));
+        ASSERT_EQ(converted[i], static_cast<int8_t>(expected)) << "index: " << i;
+    }
+    EXPECT_FALSE(ovms::convertFromFp32(Precision::I32, values.data(), converted.data(), values.size()));
+}
+
+TEST(NarrowInt32ToUint16, ShouldKeepLowBitsOfEveryValue) {
+    // not a multiple of vector width to cover the scalar tail
+    std::vector<int32_t> values(1000 + 7);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<int32_t>(i * 2654435761u);
+    }
+    std::vector<uint16_t> narrowed(values.size());
+    ovms::narrowInt32ToUint16(values.data(), narrowed.data(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(narrowed[i], static_cast<uint16_t>(values[i])) << "index: " << i;
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     TestDeserialize,
     GRPCPredictRequestNegative,
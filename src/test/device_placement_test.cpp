@@ -0,0 +1,91 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../device_placement.hpp"
+
+using namespace ovms;
+using testing::ElementsAre;
+
+TEST(DevicePlacementPlanner, WeighsTransfersBetweenDevices) {
+    // request -> first -> second -> response, crossing devices costs 10us
+    DevicePlacementPlanner planner(
+        {{"first", 1, {{"CPU", 10}, {"GPU", 4}}}, {"second", 1, {{"CPU", 10}, {"GPU", 4}}}},
+        {{"request", std::nullopt}, {"first", 0}, {"second", 1}, {"response", std::nullopt}},
+        {{0, 1, 1000}, {1, 2, 1000}, {2, 3, 1000}},
+        100);
+    const auto mixed = planner.evaluate({"GPU", "CPU"});
+    EXPECT_DOUBLE_EQ(mixed.latencyUs, 34);
+    EXPECT_DOUBLE_EQ(mixed.bottleneckUs, 20);
+
+    const auto lowestLatency = planner.plan(PlacementObjective::LATENCY);
+    EXPECT_THAT(lowestLatency.devices, ElementsAre("CPU", "CPU"));
+    EXPECT_DOUBLE_EQ(lowestLatency.latencyUs, 20);
+    EXPECT_DOUBLE_EQ(lowestLatency.bottleneckUs, 20);
+
+    const auto highestThroughput = planner.plan(PlacementObjective::THROUGHPUT);
+    EXPECT_THAT(highestThroughput.devices, ElementsAre("GPU", "GPU"));
+    EXPECT_DOUBLE_EQ(highestThroughput.latencyUs, 28);
+    EXPECT_DOUBLE_EQ(highestThroughput.bottleneckUs, 18);
+}
+
+TEST(DevicePlacementPlanner, SpreadsParallelBranchesForThroughput) {
+    DevicePlacementPlanner planner(
+        {{"left", 1, {{"CPU", 10}, {"GPU", 12}}}, {"right", 1, {{"CPU", 10}, {"GPU", 12}}}},
+        {{"request", std::nullopt}, {"left", 0}, {"right", 1}, {"response", std::nullopt}},
+        {{0, 1, 1000}, {0, 2, 1000}, {1, 3, 1000}, {2, 3, 1000}},
+        0);
+    const auto lowestLatency = planner.plan(PlacementObjective::LATENCY);
+    EXPECT_THAT(lowestLatency.devices, ElementsAre("CPU", "CPU"));
+    EXPECT_DOUBLE_EQ(lowestLatency.latencyUs, 10);
+    const auto highestThroughput = planner.plan(PlacementObjective::THROUGHPUT);
+    EXPECT_THAT(highestThroughput.devices, ElementsAre("GPU", "CPU"));
+    EXPECT_DOUBLE_EQ(highestThroughput.bottleneckUs, 12);
+}
+
+TEST(DevicePlacementPlanner, ImprovesFastestDevicesWhenTooManyPlacements) {
+    std::vector<PlacementModel> models;
+    std::vector<PlacementNode> nodes{{"request", std::nullopt}};
+    std::vector<PlacementEdge> edges;
+    for (size_t i = 0; i < 13; ++i) {
+        // the last model is faster on CPU, but not with transfer from GPU
+        models.push_back({"model_" + std::to_string(i), 1, {{"CPU", 10}, {"GPU", i == 12 ? 11.0 : 5.0}}});
+        nodes.push_back({models.back().name, i});
+        edges.push_back({i, i + 1, 1000});
+    }
+    nodes.push_back({"response", std::nullopt});
+    edges.push_back({13, 14, 0});
+    DevicePlacementPlanner planner(std::move(models), std::move(nodes), std::move(edges), 500);
+    const auto placement = planner.plan(PlacementObjective::LATENCY);
+    ASSERT_EQ(placement.devices.size(), 13);
+    for (const auto& device : placement.devices) {
+        EXPECT_EQ(device, "GPU");
+    }
+    EXPECT_DOUBLE_EQ(placement.latencyUs, 2 + 12 * 5 + 11);
+}
+
+TEST(DevicePlacementPlanner, ReturnsNoPlacementWhenModelHasNoDevice) {
+    DevicePlacementPlanner planner(
+        {{"first", 1, {{"CPU", 10}}}, {"second", 1, {}}},
+        {{"first", 0}, {"second", 1}},
+        {{0, 1, 1000}},
+        100);
+    EXPECT_TRUE(planner.plan(PlacementObjective::LATENCY).devices.empty());
+}
@@ -0,0 +1,202 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <inference_engine.hpp>
+
+#include "../dynamic_batcher.hpp"
+#include "../modelinstance.hpp"
+#include "../modelinstanceunloadguard.hpp"
+#include "test_utils.hpp"
+
+using namespace ovms;
+
+namespace {
+// long enough that batches in tests are closed only by reaching max batch size
+const uint32_t LONG_BATCH_TIMEOUT_US = 10'000'000;
+const auto COMPLETION_TIMEOUT = std::chrono::seconds(5);
+
+struct NodeResult {
+    std::promise<Status> completed;
+    BlobMap outputs;
+
+    DynamicBatcher::node_callback_t callback() {
+        return [this](const Status& status, BlobMap& outputs) {
+            this->outputs = std::move(outputs);
+            completed.set_value(status);
+        };
+    }
+};
+
+InferenceEngine::Blob::Ptr prepareBlob(const std::vector<float>& data, size_t batchSize, size_t width = DUMMY_MODEL_INPUT_SIZE) {
+    auto blob = InferenceEngine::make_shared_blob<float>(
+        InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {batchSize, width}, InferenceEngine::Layout::NC));
+    blob->allocate();
+    std::memcpy(blob->buffer().as<float*>(), data.data(), batchSize * width * sizeof(float));
+    return blob;
+}
+
+void checkNodeOutput(const BlobMap& outputs, const std::vector<float>& inputData, size_t batchSize) {
+    ASSERT_EQ(outputs.count(DUMMY_MODEL_OUTPUT_NAME), 1);
+    const auto& blob = outputs.at(DUMMY_MODEL_OUTPUT_NAME);
+    EXPECT_EQ(blob->getTensorDesc().getDims(), (std::vector<size_t>{batchSize, DUMMY_MODEL_OUTPUT_SIZE}));
+    std::vector<float> expected = inputData;
+    for (auto& value : expected) {
+        value += 1.0;
+    }
+    ASSERT_EQ(blob->byteSize(), expected.size() * sizeof(float));
+    auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap();
+    const float* actual = holder.as<const float*>();
+    EXPECT_EQ(0, std::memcmp(actual, expected.data(), blob->byteSize())) << readableError(expected.data(), actual, expected.size());
+}
+}  // namespace
+
+class DynamicBatcherTest : public ::testing::Test {
+protected:
+    ConstructorEnabledModelManager manager;
+    std::shared_ptr<ModelInstance> model;
+    std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+    DynamicBatcher* batcher = nullptr;
+
+    void loadDummyModel(uint32_t maxBatchSize, uint32_t batchTimeoutUs = LONG_BATCH_TIMEOUT_US) {
+        ModelConfig config = DUMMY_MODEL_CONFIG;
+        config.setMaxBatchSize(maxBatchSize);
+        config.setBatchSize(maxBatchSize);
+        config.setBatchTimeoutUs(batchTimeoutUs);
+        config.setNireq(1);
+        ASSERT_EQ(manager.reloadModelWithVersions(config), StatusCode::OK_RELOADED);
+        ASSERT_EQ(manager.getModelInstance(config.getName(), 0, model, unloadGuard), StatusCode::OK);
+        batcher = model->getDynamicBatcher();
+        ASSERT_NE(batcher, nullptr);
+    }
+
+    Status inferDirectly(const std::vector<float>& data, size_t batchSize, tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse& response) {
+        request = preparePredictRequest(
+            {{DUMMY_MODEL_INPUT_NAME,
+                std::tuple<shape_t, tensorflow::DataType>{{batchSize, DUMMY_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}},
+            data);
+        std::unique_ptr<ModelInstanceUnloadGuard> requestUnloadGuard;
+        std::shared_ptr<ModelInstance> instance;
+        auto status = manager.getModelInstance(model->getName(), 0, instance, requestUnloadGuard);
+        if (!status.ok()) {
+            return status;
+        }
+        return instance->infer(&request, &response, requestUnloadGuard);
+    }
+};
+
+TEST_F(DynamicBatcherTest, NodeSessionIsBatchedWithDirectRequest) {
+    loadDummyModel(2);
+    const std::vector<float> nodeData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    const std::vector<float> requestData(DUMMY_MODEL_INPUT_SIZE, 20.);
+
+    // node session opens the batch and does not wait for it
+    NodeResult node;
+    auto nodeCompleted = node.completed.get_future();
+    const auto start = std::chrono::steady_clock::now();
+    batcher->inferAsync({{DUMMY_MODEL_INPUT_NAME, prepareBlob(nodeData, 1)}}, 1, node.callback());
+    EXPECT_EQ(nodeCompleted.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+    // direct request fills the batch, so it is executed without waiting for the batch timeout
+    tensorflow::serving::PredictRequest request;
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(inferDirectly(requestData, 1, request, response), StatusCode::OK);
+    ASSERT_EQ(nodeCompleted.wait_for(COMPLETION_TIMEOUT), std::future_status::ready);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::microseconds(LONG_BATCH_TIMEOUT_US));
+    ASSERT_EQ(nodeCompleted.get(), StatusCode::OK);
+
+    checkNodeOutput(node.outputs, nodeData, 1);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+}
+
+TEST_F(DynamicBatcherTest, NodeSessionsGetTheirOwnSlicesOfBatch) {
+    loadDummyModel(3);
+    const std::vector<float> firstData(DUMMY_MODEL_INPUT_SIZE, 1.);
+    std::vector<float> secondData(2 * DUMMY_MODEL_INPUT_SIZE);
+    for (size_t i = 0; i < secondData.size(); ++i) {
+        secondData[i] = static_cast<float>(i);
+    }
+
+    NodeResult first;
+    NodeResult second;
+    auto firstCompleted = first.completed.get_future();
+    auto secondCompleted = second.completed.get_future();
+    batcher->inferAsync({{DUMMY_MODEL_INPUT_NAME, prepareBlob(firstData, 1)}}, 1, first.callback());
+    batcher->inferAsync({{DUMMY_MODEL_INPUT_NAME, prepareBlob(secondData, 2)}}, 2, second.callback());
+
+    ASSERT_EQ(firstCompleted.wait_for(COMPLETION_TIMEOUT), std::future_status::ready);
+    ASSERT_EQ(secondCompleted.wait_for(COMPLETION_TIMEOUT), std::future_status::ready);
+    ASSERT_EQ(firstCompleted.get(), StatusCode::OK);
+    ASSERT_EQ(secondCompleted.get(), StatusCode::OK);
+    checkNodeOutput(first.outputs, firstData, 1);
+    checkNodeOutput(second.outputs, secondData, 2);
+}
+
+TEST_F(DynamicBatcherTest, PartialBatchOfNodeSessionIsExecutedAfterTimeout) {
+    loadDummyModel(4, 1000);
+    const std::vector<float> nodeData(DUMMY_MODEL_INPUT_SIZE, 7.);
+
+    NodeResult node;
+    auto nodeCompleted = node.completed.get_future();
+    batcher->inferAsync({{DUMMY_MODEL_INPUT_NAME, prepareBlob(nodeData, 1)}}, 1, node.callback());
+
+    ASSERT_EQ(nodeCompleted.wait_for(COMPLETION_TIMEOUT), std::future_status::ready);
+    ASSERT_EQ(nodeCompleted.get(), StatusCode::OK);
+    checkNodeOutput(node.outputs, nodeData, 1);
+}
+
+TEST_F(DynamicBatcherTest, ErrorIsPropagatedToEveryJoinedSession) {
+    loadDummyModel(3);
+    const std::vector<float> nodeData(DUMMY_MODEL_INPUT_SIZE, 1.);
+    const std::vector<float> requestData(DUMMY_MODEL_INPUT_SIZE, 2.);
+
+    NodeResult valid;
+    NodeResult invalid;
+    auto validCompleted = valid.completed.get_future();
+    auto invalidCompleted = invalid.completed.get_future();
+    batcher->inferAsync({{DUMMY_MODEL_INPUT_NAME, prepareBlob(nodeData, 1)}}, 1, valid.callback());
+    // input of the session does not match sample size of the model, so the batch cannot be assembled
+    batcher->inferAsync({{DUMMY_MODEL_INPUT_NAME, prepareBlob(nodeData, 1, DUMMY_MODEL_INPUT_SIZE / 2)}}, 1, invalid.callback());
+
+    tensorflow::serving::PredictRequest request;
+    tensorflow::serving::PredictResponse response;
+    EXPECT_EQ(inferDirectly(requestData, 1, request, response), StatusCode::INTERNAL_ERROR);
+    ASSERT_EQ(validCompleted.wait_for(COMPLETION_TIMEOUT), std::future_status::ready);
+    ASSERT_EQ(invalidCompleted.wait_for(COMPLETION_TIMEOUT), std::future_status::ready);
+    EXPECT_EQ(validCompleted.get(), StatusCode::INTERNAL_ERROR);
+    EXPECT_EQ(invalidCompleted.get(), StatusCode::INTERNAL_ERROR);
+    EXPECT_TRUE(valid.outputs.empty());
+    EXPECT_TRUE(invalid.outputs.empty());
+    EXPECT_EQ(response.outputs().size(), 0);
+
+    // the following batch is not affected
+    NodeResult next;
+    auto nextCompleted = next.completed.get_future();
+    batcher->inferAsync({{DUMMY_MODEL_INPUT_NAME, prepareBlob(nodeData, 1)}}, 1, next.callback());
+    const std::vector<float> nextRequestData(2 * DUMMY_MODEL_INPUT_SIZE, 3.);
+    tensorflow::serving::PredictRequest nextRequest;
+    tensorflow::serving::PredictResponse nextResponse;
+    ASSERT_EQ(inferDirectly(nextRequestData, 2, nextRequest, nextResponse), StatusCode::OK);
+    ASSERT_EQ(nextCompleted.wait_for(COMPLETION_TIMEOUT), std::future_status::ready);
+    ASSERT_EQ(nextCompleted.get(), StatusCode::OK);
+    checkNodeOutput(next.outputs, nodeData, 1);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, nextRequestData, nextRequest, nextResponse, 1, 2);
+}
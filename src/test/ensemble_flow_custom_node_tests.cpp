@@ -14,8 +14,10 @@
 // limitations under the License.
 //*****************************************************************************
 #include <array>
+#include <cstring>
 #include <functional>
 #include <limits>
+#include <map>
 #include <numeric>
 #include <string>
 #include <utility>
@@ -25,6 +27,7 @@
 
 #include "../custom_node.hpp"
 #include "../custom_node_library_manager.hpp"
+#include "../custom_node_library_state.hpp"
 #include "../dl_node.hpp"
 #include "../entry_node.hpp"
 #include "../exit_node.hpp"
@@ -83,7 +86,7 @@ protected:
     }
 
     template <typename T>
-    std::unique_ptr<Pipeline> prepareSingleNodePipelineWithLibraryMock() {
+    std::unique_ptr<Pipeline> prepareSingleNodePipelineWithLibraryMock(const NodeLibrary& libraryMock = createLibraryMock<T>(), std::shared_ptr<CustomNodeLibraryState> libraryState = nullptr) {
         const std::vector<float> inputValues{3.5, 2.1, -0.2};
         auto inputTensorInfo = std::make_shared<ovms::TensorInfo>(pipelineInputName,
             InferenceEngine::Precision::FP32,
@@ -96,8 +99,12 @@ protected:
         auto output_node = std::make_unique<ExitNode>(&response, outputsInfo);
         auto custom_node = std::make_unique<CustomNode>(
             customNodeName,
-            createLibraryMock<T>(),
-            parameters_t{});
+            libraryMock,
+            parameters_t{},
+            std::unordered_map<std::string, std::string>{},
+            std::nullopt,
+            std::set<std::string>{},
+            libraryState);
 
         auto pipeline = std::make_unique<Pipeline>(*input_node, *output_node);
         pipeline->connect(*input_node, *custom_node, {{pipelineInputName, customNodeInputName}});
@@ -348,6 +355,52 @@ TEST_F(EnsembleFlowCustomNodeAndDemultiplexerGatherPipelineExecutionTest, Multip
     this->checkResponse(pipelineOutputName, response, expectedResult, {1, 10});
 }
 
+TEST_F(EnsembleFlowCustomNodeAndDemultiplexerGatherPipelineExecutionTest, DemultiplexerThenBatchedDummyThenGather) {
+    // input  differentOps   dummy(batch 3)  chooseMax  output
+    //  O--------->O------------>O------------>O-------->O
+    // 4 shards are inferred in 2 batches, the last one padded with zeros
+    config.setBatchSize(3);
+    ASSERT_EQ(modelManager.reloadModelWithVersions(config), StatusCode::OK_RELOADED);
+    const std::vector<float> inputValues{0.2, 0.7, -0.4, -0.1, 0.0001, -0.8, 0.7, 0.8, 0.9, 0.1};
+    const std::vector<float> inputFactors{1, -1, 2, 2};
+    parameters_t parameters{
+        {"selection_criteria", "MAXIMUM_MAXIMUM"}};
+    auto expectedResult = inputValues;
+    std::transform(expectedResult.begin(), expectedResult.end(), expectedResult.begin(),
+        [inputFactors](float f) { return f + inputFactors[0] + 1; });
+    PredictRequest predictRequest;
+    this->prepareRequest(predictRequest, inputValues, pipelineInputName);
+    this->prepareRequest(predictRequest, inputFactors, pipelineFactorsName);
+
+    const tensor_map_t inputsInfo{{pipelineInputName, dagDummyModelInputTensorInfo}, {pipelineFactorsName,
+                                                                                         std::make_shared<ovms::TensorInfo>(pipelineFactorsName,
+                                                                                             InferenceEngine::Precision::FP32,
+                                                                                             shape_t{1, 4},
+                                                                                             InferenceEngine::Layout::NC)}};
+    auto inputNode = std::make_unique<EntryNode>(&predictRequest, inputsInfo);
+    const tensor_map_t outputsInfo{{pipelineOutputName, dagDummyModelOutputTensorInfo}};
+    auto outputNode = std::make_unique<ExitNode>(&response, outputsInfo);
+    auto differentOpsNode = std::make_unique<CustomNode>(differentOpsNodeName, differentOpsLibrary, parameters_t{}, differentOpsOutputAlias, demultiplyCount);
+    auto dummyNode = std::make_unique<DLNode>(dummyNodeName, "dummy", std::nullopt, modelManager,
+        std::unordered_map<std::string, std::string>{}, std::nullopt, std::set<std::string>{}, true);
+    auto chooseMaxNode = std::make_unique<CustomNode>(chooseMaxNodeName, chooseMaxLibrary, parameters, chooseMaxOutputAlias, std::nullopt, std::set<std::string>({differentOpsNodeName}));
+
+    Pipeline pipeline(*inputNode, *outputNode);
+    pipeline.connect(*inputNode, *differentOpsNode, {{pipelineFactorsName, differentOpsFactorsInputName}, {pipelineInputName, differentOpsInputName}});
+    pipeline.connect(*differentOpsNode, *dummyNode, {{differentOpsOutputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline.connect(*dummyNode, *chooseMaxNode, {{DUMMY_MODEL_OUTPUT_NAME, chooseMaxInputName}});
+    pipeline.connect(*chooseMaxNode, *outputNode, {{chooseMaxOutputName, pipelineOutputName}});
+    pipeline.push(std::move(inputNode));
+    pipeline.push(std::move(outputNode));
+    pipeline.push(std::move(differentOpsNode));
+    pipeline.push(std::move(dummyNode));
+    pipeline.push(std::move(chooseMaxNode));
+
+    ASSERT_EQ(pipeline.execute(), StatusCode::OK);
+    ASSERT_EQ(response.outputs().size(), 1);
+    this->checkResponse(pipelineOutputName, response, expectedResult, {1, 10});
+}
+
 TEST_F(EnsembleFlowCustomNodeAndDemultiplexerGatherPipelineExecutionTest, MultipleDemultiplexerLevelsThenDummyThenMultipleGathers) {
     // Most basic configuration, just process single add-sub custom node pipeline request
     // input  (differentOps dummy)xN   chooseMax xN    output
@@ -794,6 +847,156 @@ TEST_F(EnsembleFlowCustomNodePipelineExecutionTest, FailInCustomNodeOutputInvali
     ASSERT_EQ(pipeline->execute(), StatusCode::NODE_LIBRARY_INVALID_CONTENT_SIZE);
 }
 
+struct LibraryUsingServerAllocator {
+    static int releaseCallsCount;
+    static int execute(const struct CustomNodeTensor*, int, struct CustomNodeTensor**, int*, const struct CustomNodeParam*, int) {
+        return 1;
+    }
+    static int executeWithAllocator(const struct CustomNodeTensor* inputs, int, struct CustomNodeTensor** handle, int* outputsNum, const struct CustomNodeParam*, int, const struct CustomNodeAllocator* allocator, void*) {
+        const uint64_t elementsCount = 10;
+        auto* outputs = static_cast<struct CustomNodeTensor*>(allocator->allocate(allocator->context, sizeof(struct CustomNodeTensor)));
+        auto* dims = static_cast<uint64_t*>(allocator->allocate(allocator->context, 2 * sizeof(uint64_t)));
+        auto* data = static_cast<float*>(allocator->allocate(allocator->context, elementsCount * sizeof(float)));
+        if (!outputs || !dims || !data) {
+            return 2;
+        }
+        const float* inputData = reinterpret_cast<const float*>(inputs[0].data);
+        for (uint64_t i = 0; i < elementsCount; ++i) {
+            data[i] = inputData[i % 3] + 1;
+        }
+        dims[0] = 1;
+        dims[1] = elementsCount;
+        outputs[0].name = "output_numbers";
+        outputs[0].data = reinterpret_cast<uint8_t*>(data);
+        outputs[0].dataBytes = elementsCount * sizeof(float);
+        outputs[0].dims = dims;
+        outputs[0].dimsCount = 2;
+        outputs[0].precision = CustomNodeTensorPrecision::FP32;
+        *handle = outputs;
+        *outputsNum = 1;
+        return 0;
+    }
+    static int getInputsInfo(struct CustomNodeTensorInfo**, int*, const struct CustomNodeParam*, int) {
+        return 0;
+    }
+    static int getOutputsInfo(struct CustomNodeTensorInfo**, int*, const struct CustomNodeParam*, int) {
+        return 0;
+    }
+    static int release(void* ptr) {
+        releaseCallsCount++;
+        free(ptr);
+        return 0;
+    }
+};
+
+int LibraryUsingServerAllocator::releaseCallsCount = 0;
+
+TEST_F(EnsembleFlowCustomNodePipelineExecutionTest, CustomNodeOutputsAllocatedByServerAreNotReleasedByLibrary) {
+    auto library = createLibraryMock<LibraryUsingServerAllocator>();
+    library.executeWithAllocator = LibraryUsingServerAllocator::executeWithAllocator;
+    LibraryUsingServerAllocator::releaseCallsCount = 0;
+    auto pipeline = this->prepareSingleNodePipelineWithLibraryMock<LibraryUsingServerAllocator>(library);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    pipeline.reset();
+    EXPECT_EQ(LibraryUsingServerAllocator::releaseCallsCount, 0);
+    this->checkResponse(pipelineOutputName, response,
+        std::vector<float>{4.5, 3.1, 0.8, 4.5, 3.1, 0.8, 4.5, 3.1, 0.8, 4.5}, shape_t{1, 10});
+}
+
+struct LibraryWithState : LibraryUsingServerAllocator {
+    static int deinitializeCallsCount;
+    static int initialize(void** state, const struct CustomNodeParam*, int) {
+        *state = new float(10.0);
+        return 0;
+    }
+    static int deinitialize(void* state) {
+        deinitializeCallsCount++;
+        delete static_cast<float*>(state);
+        return 0;
+    }
+    static int executeWithAllocator(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** handle, int* outputsNum, const struct CustomNodeParam* params, int paramsCount, const struct CustomNodeAllocator* allocator, void* state) {
+        int result = LibraryUsingServerAllocator::executeWithAllocator(inputs, inputsCount, handle, outputsNum, params, paramsCount, allocator, nullptr);
+        if (result != 0) {
+            return result;
+        }
+        float* data = reinterpret_cast<float*>((*handle)[0].data);
+        for (uint64_t i = 0; i < (*handle)[0].dataBytes / sizeof(float); ++i) {
+            data[i] += *static_cast<float*>(state);
+        }
+        return 0;
+    }
+};
+
+int LibraryWithState::deinitializeCallsCount = 0;
+
+TEST_F(EnsembleFlowCustomNodePipelineExecutionTest, CustomNodeReceivesStateCreatedByInitialize) {
+    auto library = createLibraryMock<LibraryWithState>();
+    library.executeWithAllocator = LibraryWithState::executeWithAllocator;
+    library.initialize = LibraryWithState::initialize;
+    library.deinitialize = LibraryWithState::deinitialize;
+    LibraryWithState::deinitializeCallsCount = 0;
+    std::shared_ptr<CustomNodeLibraryState> state;
+    ASSERT_EQ(CustomNodeLibraryState::create(library, parameters_t{}, state), StatusCode::OK);
+    ASSERT_NE(state, nullptr);
+    auto pipeline = this->prepareSingleNodePipelineWithLibraryMock<LibraryWithState>(library, state);
+    state.reset();
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    EXPECT_EQ(LibraryWithState::deinitializeCallsCount, 0);
+    pipeline.reset();
+    EXPECT_EQ(LibraryWithState::deinitializeCallsCount, 1);
+    this->checkResponse(pipelineOutputName, response,
+        std::vector<float>{14.5, 13.1, 10.8, 14.5, 13.1, 10.8, 14.5, 13.1, 10.8, 14.5}, shape_t{1, 10});
+}
+
+struct LibraryAliasingInput {
+    static int releaseCallsCount;
+    static const void* inputData;
+    static int execute(const struct CustomNodeTensor* inputs, int, struct CustomNodeTensor** handle, int* outputsNum, const struct CustomNodeParam*, int) {
+        // slice of last two input elements, incremented in place
+        inputData = inputs[0].data;
+        float* data = reinterpret_cast<float*>(inputs[0].data) + 1;
+        data[0] += 1;
+        data[1] += 1;
+        *handle = static_cast<struct CustomNodeTensor*>(malloc(sizeof(struct CustomNodeTensor)));
+        auto* dims = static_cast<uint64_t*>(malloc(2 * sizeof(uint64_t)));
+        dims[0] = 1;
+        dims[1] = 2;
+        (*handle)->name = "output_numbers";
+        (*handle)->data = reinterpret_cast<uint8_t*>(data);
+        (*handle)->dataBytes = 2 * sizeof(float);
+        (*handle)->dims = dims;
+        (*handle)->dimsCount = 2;
+        (*handle)->precision = CustomNodeTensorPrecision::FP32;
+        *outputsNum = 1;
+        return 0;
+    }
+    static int getInputsInfo(struct CustomNodeTensorInfo**, int*, const struct CustomNodeParam*, int) {
+        return 0;
+    }
+    static int getOutputsInfo(struct CustomNodeTensorInfo**, int*, const struct CustomNodeParam*, int) {
+        return 0;
+    }
+    static int release(void* ptr) {
+        EXPECT_NE(ptr, static_cast<const uint8_t*>(inputData) + sizeof(float));
+        releaseCallsCount++;
+        free(ptr);
+        return 0;
+    }
+};
+
+int LibraryAliasingInput::releaseCallsCount = 0;
+const void* LibraryAliasingInput::inputData = nullptr;
+
+TEST_F(EnsembleFlowCustomNodePipelineExecutionTest, CustomNodeOutputAliasingInputIsNotCopiedNorReleasedByLibrary) {
+    LibraryAliasingInput::releaseCallsCount = 0;
+    auto pipeline = this->prepareSingleNodePipelineWithLibraryMock<LibraryAliasingInput>();
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    pipeline.reset();
+    // only outputs array and dims are released
+    EXPECT_EQ(LibraryAliasingInput::releaseCallsCount, 2);
+    this->checkResponse(pipelineOutputName, response, std::vector<float>{3.1, 0.8}, shape_t{1, 2});
+}
+
 class EnsembleFlowCustomNodeFactoryCreateThenExecuteTest : public EnsembleFlowCustomNodePipelineExecutionTest {};
 
 TEST_F(EnsembleFlowCustomNodeFactoryCreateThenExecuteTest, SimplePipelineFactoryCreationWithCustomNode) {
@@ -1905,6 +2108,26 @@ TEST_F(EnsembleFlowCustomNodeAndDemultiplexerLoadConfigThenExecuteTest, Demultip
     this->checkResponse("pipeline_output", response, expectedOutput, {1, 10});
 }
 
+TEST_F(EnsembleFlowCustomNodeAndDemultiplexerLoadConfigThenExecuteTest, DemultiplyThenDummyThenChooseMaximumInWavesOfShards) {
+    std::unique_ptr<Pipeline> pipeline;
+    std::vector<float> input(4 * DUMMY_MODEL_OUTPUT_SIZE);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(1 + i / DUMMY_MODEL_OUTPUT_SIZE);
+    }
+
+    this->prepareRequest(request, input, differentOpsInputName, {4, 1, 10});
+    std::string config = demultiplyThenDummyThenChooseMaximumConfig;
+    const std::string demultiplyCount = R"("demultiply_count": 0,)";
+    config.replace(config.find(demultiplyCount), demultiplyCount.size(), demultiplyCount + R"( "max_in_flight_shards": 1,)");
+    this->loadConfiguration(config.c_str());
+    ASSERT_EQ(manager.createPipeline(pipeline, pipelineName, &request, &response), StatusCode::OK);
+    auto status = pipeline->execute();
+    ASSERT_EQ(status, StatusCode::OK) << status.string();
+
+    std::vector<float> expectedOutput{5, 5, 5, 5, 5, 5, 5, 5, 5, 5};
+    this->checkResponse("pipeline_output", response, expectedOutput, {1, 10});
+}
+
 struct LibraryParamControlledMetadata {
     static bool startsWith(const char* str, const char* prefix) {
         // Ensure null terminated
@@ -2450,6 +2673,81 @@ TEST_F(EnsembleConfigurationValidationWithCustomNode, SharedLibraryErrorsOnMetad
     ASSERT_EQ(pipelineDefinition->validate(manager), StatusCode::NODE_LIBRARY_METADATA_FAILED);
 }
 
+struct LibraryInitializeCounter {
+    static int initializeCallsCount;
+    static int deinitializeCallsCount;
+    static int initializeResult;
+    static int initialize(void** state, const struct CustomNodeParam*, int) {
+        initializeCallsCount++;
+        *state = nullptr;
+        return initializeResult;
+    }
+    static int deinitialize(void*) {
+        deinitializeCallsCount++;
+        return 0;
+    }
+    static void reset(int result) {
+        initializeCallsCount = 0;
+        deinitializeCallsCount = 0;
+        initializeResult = result;
+    }
+};
+
+int LibraryInitializeCounter::initializeCallsCount = 0;
+int LibraryInitializeCounter::deinitializeCallsCount = 0;
+int LibraryInitializeCounter::initializeResult = 0;
+
+TEST_F(EnsembleConfigurationValidationWithCustomNode, InitializesCustomNodesOncePerDefinitionLoad) {
+    for (int result : {0, 1}) {
+        LibraryInitializeCounter::reset(result);
+        NodeLibrary libraryWithState = mockedLibrary;
+        libraryWithState.initialize = LibraryInitializeCounter::initialize;
+        libraryWithState.deinitialize = LibraryInitializeCounter::deinitialize;
+        std::vector<NodeInfo> info{
+            {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{pipelineInputName, pipelineInputName}}},
+            {NodeKind::CUSTOM, "custom_node_1", "", std::nullopt, {{"1", "out_OutputNumbers_1"}, {"2", "out_OutputNumbers_2"}}, std::nullopt, {}, libraryWithState,
+                parameters_t{
+                    {"in_InputNumbers", "1,3,10;FP32"},
+                    {"out_OutputNumbers_1", "1,30,7;I32"},
+                    {"out_OutputNumbers_2", "1,8;I32"}}},
+            {NodeKind::CUSTOM, "custom_node_2", "", std::nullopt, {{"out", "out_OutputNumbers"}}, std::nullopt, {}, libraryWithState,
+                parameters_t{
+                    {"in_InputNumbers_1", "1,30,7;I32"},
+                    {"in_InputNumbers_2", "1,8;I32"},
+                    {"out_OutputNumbers", "1,2000;FP32"}}},
+            {NodeKind::EXIT, EXIT_NODE_NAME},
+        };
+
+        pipeline_connections_t connections;
+
+        connections["custom_node_1"] = {
+            {ENTRY_NODE_NAME, {{pipelineInputName, "in_InputNumbers"}}}};
+
+        connections["custom_node_2"] = {
+            {"custom_node_1", {{"1", "in_InputNumbers_1"},
+                                  {"2", "in_InputNumbers_2"}}}};
+
+        connections[EXIT_NODE_NAME] = {
+            {"custom_node_2", {{"out", pipelineOutputName}}}};
+
+        ConstructorEnabledModelManager manager;
+        std::unique_ptr<PipelineDefinition> pipelineDefinition = std::make_unique<PipelineDefinition>("my_new_pipeline", info, connections);
+        if (result != 0) {
+            EXPECT_EQ(pipelineDefinition->validate(manager), StatusCode::NODE_LIBRARY_INITIALIZE_FAILED);
+            EXPECT_EQ(LibraryInitializeCounter::deinitializeCallsCount, 0);
+            continue;
+        }
+        ASSERT_EQ(pipelineDefinition->validate(manager), StatusCode::OK);
+        EXPECT_EQ(LibraryInitializeCounter::initializeCallsCount, 2);
+        // revalidation, e.g. after used model change, keeps states
+        ASSERT_EQ(pipelineDefinition->validate(manager), StatusCode::OK);
+        EXPECT_EQ(LibraryInitializeCounter::initializeCallsCount, 2);
+        EXPECT_EQ(LibraryInitializeCounter::deinitializeCallsCount, 0);
+        pipelineDefinition->retire(manager);
+        EXPECT_EQ(LibraryInitializeCounter::deinitializeCallsCount, 2);
+    }
+}
+
 class EnsembleConfigurationValidationWithDemultiplexer : public EnsembleConfigurationValidationWithCustomNode {};
 
 TEST_F(EnsembleConfigurationValidationWithDemultiplexer, SuccessfulConfigurationSingleDemultiplexer) {
@@ -4008,17 +4306,7 @@ TEST_F(EnsembleFlowCustomNodeAndDemultiplexerLoadConfigThenExecuteTest, Differen
     this->checkResponse("pipeline_output", response, expectedResult, {1, 10});
 }
 
-TEST_F(EnsembleFlowCustomNodeAndDynamicDemultiplexerLoadConfigThenExecuteTest, DynamicDemultiplexerNoResults) {
-    std::unique_ptr<Pipeline> pipeline;
-    uint8_t dynamicDemultiplyCount = 0;
-    std::vector<float> input{static_cast<float>(dynamicDemultiplyCount), 1, 2, 3, 4, 5, 6, 7, 8, 9};
-    this->prepareRequest(request, input, differentOpsInputName);
-    this->loadConfiguration(pipelineCustomNodeDynamicDemultiplexThenDummyConfig);
-    ASSERT_EQ(manager.createPipeline(pipeline, pipelineName, &request, &response), StatusCode::OK);
-    ASSERT_EQ(pipeline->execute(), StatusCode::PIPELINE_DEMULTIPLEXER_NO_RESULTS);
-}
-
-TEST_F(EnsembleFlowCustomNodeAndDynamicDemultiplexerLoadConfigThenExecuteTest, DISABLED_JustDynamicDemultiplexerConfigReturning0Batch) {
+TEST_F(EnsembleFlowCustomNodeAndDynamicDemultiplexerLoadConfigThenExecuteTest, DynamicDemultiplexerNoResultsReturnsEmptyGatheredOutput) {
     std::unique_ptr<Pipeline> pipeline;
     uint8_t dynamicDemultiplyCount = 0;
     std::vector<float> input{static_cast<float>(dynamicDemultiplyCount), 1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -4027,13 +4315,8 @@ TEST_F(EnsembleFlowCustomNodeAndDynamicDemultiplexerLoadConfigThenExecuteTest, D
     ASSERT_EQ(manager.createPipeline(pipeline, pipelineName, &request, &response), StatusCode::OK);
     ASSERT_EQ(pipeline->execute(), StatusCode::OK);
 
-    std::vector<float> expectedOutput(dynamicDemultiplyCount * DUMMY_MODEL_OUTPUT_SIZE);
-    for (size_t i = 0; i < dynamicDemultiplyCount; ++i) {
-        std::copy(input.begin(), input.end(), expectedOutput.begin() + i * DUMMY_MODEL_OUTPUT_SIZE);
-    }
-    std::transform(expectedOutput.begin(), expectedOutput.end(), expectedOutput.begin(),
-        [](float f) -> float { return f + 1; });
-    this->checkResponse("pipeline_output", response, expectedOutput, {1, dynamicDemultiplyCount, 10});
+    std::vector<float> expectedOutput;
+    this->checkResponse("pipeline_output", response, expectedOutput, {dynamicDemultiplyCount, 1, 10});
 }
 
 static const char* pipelineCustomNode2DynamicDemultiplexConfig = R"(
@@ -4204,3 +4487,170 @@ TEST_F(EnsembleFlowCustomNodePipelineExecutionTest, DemultiplexerConnectedToNhwc
     ASSERT_EQ(pipeline->execute(), ovms::StatusCode::OK);
     checkIncrement4DimResponse(pipelineOutputName, {3.0, 6.0, 4.0, 7.0, 5.0, 8.0, 4.0, 7.0, 5.0, 8.0, 6.0, 9.0, 5.0, 8.0, 6.0, 9.0, 7.0, 10.0}, request, response, {3, 1, 3, 1, 2});
 }
+
+TEST_F(EnsembleFlowCustomNodePipelineExecutionTest, DemultiplexedOutputsAreStreamedPerShard) {
+    const std::vector<float> inputValues{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    PredictRequest request;
+    PredictResponse response;
+    tensorflow::TensorProto& proto = (*request.mutable_inputs())[pipelineInputName];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_content()->assign((char*)inputValues.data(), inputValues.size() * sizeof(float));
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(3);
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(2);
+
+    ConstructorEnabledModelManager manager;
+    ModelConfig config = INCREMENT_1x3x4x5_MODEL_CONFIG;
+    config.setBatchingParams("0");
+    ASSERT_EQ(config.parseShapeParameter("(1,3,1,2)"), ovms::StatusCode::OK);
+    ASSERT_EQ(config.parseLayoutParameter("nhwc"), ovms::StatusCode::OK);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+
+    std::optional<uint32_t> demultiplyCount = 0;
+    std::set<std::string> gather = {"image_demultiplexer_node"};
+    std::unordered_map<std::string, std::string> aliases{{"custom_node_output", "custom_node_output"}};
+
+    auto inputTensorInfo = std::make_shared<ovms::TensorInfo>(pipelineOutputName,
+        InferenceEngine::Precision::FP32,
+        shape_t{0, 3, 1, 2},
+        InferenceEngine::Layout::ANY);
+    const tensor_map_t inputsInfo{{pipelineInputName, inputTensorInfo}};
+    auto input_node = std::make_unique<EntryNode>(&request, inputsInfo);
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>(pipelineOutputName,
+        InferenceEngine::Precision::FP32,
+        shape_t{0, 1, 3, 1, 2},
+        InferenceEngine::Layout::ANY);
+    const tensor_map_t outputsInfo{{pipelineOutputName, tensorInfo}};
+    auto output_node = std::make_unique<ExitNode>(&response, outputsInfo, gather);
+    std::map<session_id_t, std::vector<float>> streamedShards;
+    output_node->setPartialOutputsCallback([this, &streamedShards](const std::string& nodeName, session_id_t shardId, PredictResponse& partialResponse) -> Status {
+        EXPECT_EQ(nodeName, "increment_node");
+        EXPECT_EQ(partialResponse.outputs().size(), 1);
+        const auto& output = partialResponse.outputs().at(pipelineOutputName);
+        EXPECT_THAT(asVector(output.tensor_shape()), ::testing::ElementsAre(1, 3, 1, 2));
+        std::vector<float> values(output.tensor_content().size() / sizeof(float));
+        std::memcpy(values.data(), output.tensor_content().data(), output.tensor_content().size());
+        EXPECT_TRUE(streamedShards.emplace(shardId, std::move(values)).second);
+        return StatusCode::OK;
+    });
+    auto custom_node = std::make_unique<CustomNode>(
+        "image_demultiplexer_node",
+        createLibraryMock<LibraryProduceImages5Dimensions>(),
+        parameters_t{}, aliases, demultiplyCount);
+    auto model_node = std::make_unique<DLNode>("increment_node", "increment_1x3x4x5", std::nullopt, manager);
+
+    auto pipeline = std::make_unique<Pipeline>(*input_node, *output_node);
+    pipeline->connect(*input_node, *custom_node, {{pipelineInputName, "any"}});
+    pipeline->connect(*custom_node, *model_node, {{"custom_node_output", "input"}});
+    pipeline->connect(*model_node, *output_node, {{"output", pipelineOutputName}});
+
+    pipeline->push(std::move(input_node));
+    pipeline->push(std::move(custom_node));
+    pipeline->push(std::move(model_node));
+    pipeline->push(std::move(output_node));
+
+    ASSERT_EQ(pipeline->execute(), ovms::StatusCode::OK);
+    // streamed outputs are not serialized into response again
+    EXPECT_EQ(response.outputs().size(), 0);
+    ASSERT_EQ(streamedShards.size(), 3);
+    EXPECT_THAT(streamedShards.at(0), ::testing::ElementsAre(3.0, 6.0, 4.0, 7.0, 5.0, 8.0));
+    EXPECT_THAT(streamedShards.at(1), ::testing::ElementsAre(4.0, 7.0, 5.0, 8.0, 6.0, 9.0));
+    EXPECT_THAT(streamedShards.at(2), ::testing::ElementsAre(5.0, 8.0, 6.0, 9.0, 7.0, 10.0));
+}
+
+struct LibraryIncrementingInBatches {
+    static std::vector<int> batchSizes;
+    static int execute(const struct CustomNodeTensor*, int, struct CustomNodeTensor**, int*, const struct CustomNodeParam*, int) {
+        return 1;
+    }
+    static int executeBatch(const struct CustomNodeTensor** inputs, int inputsCount, int batchSize, struct CustomNodeTensor** outputs, int* outputsCounts, const struct CustomNodeParam*, int, const struct CustomNodeAllocator*, void*) {
+        batchSizes.push_back(batchSize);
+        for (int i = 0; i < batchSize; ++i) {
+            if (inputsCount != 1) {
+                return 1;
+            }
+            const auto& input = inputs[i][0];
+            auto* output = static_cast<struct CustomNodeTensor*>(malloc(sizeof(struct CustomNodeTensor)));
+            output->name = "out";
+            output->dataBytes = input.dataBytes;
+            output->data = static_cast<uint8_t*>(malloc(input.dataBytes));
+            const float* inputData = reinterpret_cast<const float*>(input.data);
+            float* outputData = reinterpret_cast<float*>(output->data);
+            for (uint64_t j = 0; j < input.dataBytes / sizeof(float); ++j) {
+                outputData[j] = inputData[j] + 1;
+            }
+            output->dimsCount = input.dimsCount;
+            output->dims = static_cast<uint64_t*>(malloc(input.dimsCount * sizeof(uint64_t)));
+            std::memcpy(output->dims, input.dims, input.dimsCount * sizeof(uint64_t));
+            output->precision = input.precision;
+            outputs[i] = output;
+            outputsCounts[i] = 1;
+        }
+        return 0;
+    }
+    static int getInputsInfo(struct CustomNodeTensorInfo**, int*, const struct CustomNodeParam*, int) {
+        return 0;
+    }
+    static int getOutputsInfo(struct CustomNodeTensorInfo**, int*, const struct CustomNodeParam*, int) {
+        return 0;
+    }
+    static int release(void* ptr) {
+        free(ptr);
+        return 0;
+    }
+};
+
+std::vector<int> LibraryIncrementingInBatches::batchSizes;
+
+TEST_F(EnsembleFlowCustomNodePipelineExecutionTest, DemultiplexedShardsAreExecutedInSingleBatchCall) {
+    const std::vector<float> inputValues{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    PredictRequest request;
+    PredictResponse response;
+    tensorflow::TensorProto& proto = (*request.mutable_inputs())[pipelineInputName];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_content()->assign((char*)inputValues.data(), inputValues.size() * sizeof(float));
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(3);
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(2);
+
+    std::optional<uint32_t> demultiplyCount = 0;
+    std::set<std::string> gather = {"image_demultiplexer_node"};
+    std::unordered_map<std::string, std::string> aliases{{"custom_node_output", "custom_node_output"}};
+
+    auto inputTensorInfo = std::make_shared<ovms::TensorInfo>(pipelineOutputName,
+        InferenceEngine::Precision::FP32,
+        shape_t{0, 3, 1, 2},
+        InferenceEngine::Layout::ANY);
+    const tensor_map_t inputsInfo{{pipelineInputName, inputTensorInfo}};
+    auto input_node = std::make_unique<EntryNode>(&request, inputsInfo);
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>(pipelineOutputName,
+        InferenceEngine::Precision::FP32,
+        shape_t{0, 1, 3, 1, 2},
+        InferenceEngine::Layout::ANY);
+    const tensor_map_t outputsInfo{{pipelineOutputName, tensorInfo}};
+    auto output_node = std::make_unique<ExitNode>(&response, outputsInfo, gather);
+    auto custom_node = std::make_unique<CustomNode>(
+        "image_demultiplexer_node",
+        createLibraryMock<LibraryProduceImages5Dimensions>(),
+        parameters_t{}, aliases, demultiplyCount);
+    auto batchLibrary = createLibraryMock<LibraryIncrementingInBatches>();
+    batchLibrary.executeBatch = LibraryIncrementingInBatches::executeBatch;
+    auto batch_node = std::make_unique<CustomNode>("increment_node", batchLibrary, parameters_t{});
+    LibraryIncrementingInBatches::batchSizes.clear();
+
+    auto pipeline = std::make_unique<Pipeline>(*input_node, *output_node);
+    pipeline->connect(*input_node, *custom_node, {{pipelineInputName, "any"}});
+    pipeline->connect(*custom_node, *batch_node, {{"custom_node_output", "input_numbers"}});
+    pipeline->connect(*batch_node, *output_node, {{"out", pipelineOutputName}});
+
+    pipeline->push(std::move(input_node));
+    pipeline->push(std::move(custom_node));
+    pipeline->push(std::move(batch_node));
+    pipeline->push(std::move(output_node));
+
+    ASSERT_EQ(pipeline->execute(), ovms::StatusCode::OK);
+    EXPECT_THAT(LibraryIncrementingInBatches::batchSizes, ::testing::ElementsAre(3));
+    checkIncrement4DimResponse(pipelineOutputName, {3.0, 6.0, 4.0, 7.0, 5.0, 8.0, 4.0, 7.0, 5.0, 8.0, 6.0, 9.0, 5.0, 8.0, 6.0, 9.0, 7.0, 10.0}, request, response, {3, 1, 3, 1, 2});
+}
@@ -13,7 +13,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <chrono>
 #include <cstdio>
+#include <future>
+#include <numeric>
 #include <sstream>
 
 #include <gmock/gmock.h>
@@ -22,13 +25,16 @@
 
 #include "../binaryutils.hpp"
 #include "../dl_node.hpp"
+#include "../dynamic_batcher.hpp"
 #include "../entry_node.hpp"
 #include "../exit_node.hpp"
 #include "../localfilesystem.hpp"
 #include "../logging.hpp"
 #include "../modelconfig.hpp"
 #include "../modelinstance.hpp"
+#include "../modelinstanceunloadguard.hpp"
 #include "../pipeline.hpp"
+#include "../pipeline_executor.hpp"
 #include "../pipeline_factory.hpp"
 #include "../pipelinedefinition.hpp"
 #include "../prediction_service_utils.hpp"
@@ -180,6 +186,101 @@ TEST_F(EnsembleFlowTest, DummyModel) {
     checkDummyResponse(dummySeriallyConnectedCount);
 }
 
+TEST_F(EnsembleFlowTest, ConnectionsAreResolvedByNodeIdentityAndFlattenedIntoOutputLinks) {
+    ConstructorEnabledModelManager manager;
+    DLNode first("dummy_node", dummyModelName, requestedModelVersion, manager);
+    DLNode second("second_node", dummyModelName, requestedModelVersion, manager);
+    // the same name as dependency of second node, but different node
+    DLNode third("dummy_node", dummyModelName, requestedModelVersion, manager);
+    auto sharedMapping = std::make_shared<const Aliases>(Aliases{{"a", "b"}, {"c", "d"}});
+    Pipeline::connect(first, second, sharedMapping);
+    Pipeline::connect(first, third, {{"a", "e"}});
+
+    EXPECT_EQ(&second.getMappingByDependency(first), sharedMapping.get());
+    EXPECT_THROW(second.getMappingByDependency(third), std::out_of_range);
+    const auto& links = first.getOutputLinks();
+    ASSERT_EQ(links.size(), 3);
+    EXPECT_EQ(links[0].node, &second);
+    EXPECT_EQ(links[0].outputName, &(*sharedMapping)[0].first);
+    EXPECT_EQ(links[1].inputName, &(*sharedMapping)[1].second);
+    EXPECT_EQ(links[2].node, &third);
+    EXPECT_EQ(*links[2].outputName, "a");
+    EXPECT_EQ(*links[2].inputName, "e");
+    EXPECT_EQ(&first.getOutputLinks(), &links);
+}
+
+TEST_F(EnsembleFlowTest, DummyModelsWithBoundOutputs) {
+    // Outputs of both nodes are written into server owned blobs handed over without copy
+    // input   dummy    dummy    output
+    //  O------->O------->O------->O
+    config.setNireq(1);
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+    auto instance = managerWithDummyModel.findModelByName(dummyModelName)->getDefaultModelInstance();
+    ASSERT_NE(instance, nullptr);
+    const auto originalOutputBlob = instance->getInferRequestsQueue().getInferRequest(0).GetBlob(DUMMY_MODEL_OUTPUT_NAME);
+
+    for (int execution = 0; execution < 2; ++execution) {
+        response.Clear();
+        const tensor_map_t inputsInfo{{customPipelineInputName, dagDummyModelInputTensorInfo}};
+        auto input_node = std::make_unique<EntryNode>(&request, inputsInfo);
+        auto model_node_1 = std::make_unique<DLNode>("dummy_node_1", dummyModelName, requestedModelVersion, managerWithDummyModel,
+            std::unordered_map<std::string, std::string>{}, std::nullopt, std::set<std::string>{}, false, roi_inputs_t{}, true);
+        auto model_node_2 = std::make_unique<DLNode>("dummy_node_2", dummyModelName, requestedModelVersion, managerWithDummyModel,
+            std::unordered_map<std::string, std::string>{}, std::nullopt, std::set<std::string>{}, false, roi_inputs_t{}, true);
+        const tensor_map_t outputsInfo{{customPipelineOutputName, dagDummyModelOutputTensorInfo}};
+        auto output_node = std::make_unique<ExitNode>(&response, outputsInfo);
+        Pipeline pipeline(*input_node, *output_node);
+        pipeline.connect(*input_node, *model_node_1, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+        pipeline.connect(*model_node_1, *model_node_2, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}});
+        pipeline.connect(*model_node_2, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+        pipeline.push(std::move(input_node));
+        pipeline.push(std::move(model_node_1));
+        pipeline.push(std::move(model_node_2));
+        pipeline.push(std::move(output_node));
+
+        ASSERT_EQ(pipeline.execute(), StatusCode::OK);
+        const int dummySeriallyConnectedCount = 2;
+        checkDummyResponse(dummySeriallyConnectedCount);
+        // infer request gets its own output blob back when stream is returned
+        EXPECT_EQ(instance->getInferRequestsQueue().getInferRequest(0).GetBlob(DUMMY_MODEL_OUTPUT_NAME), originalOutputBlob);
+    }
+}
+
+TEST_F(EnsembleFlowTest, DummyModelWithOutputCache) {
+    // Second execution with the same inputs is served from node outputs cache
+    // input   dummy    output
+    //  O------->O------->O
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+    auto cache = std::make_shared<NodeOutputCache>(1024 * 1024);
+
+    for (int execution = 0; execution < 2; ++execution) {
+        response.Clear();
+        const tensor_map_t inputsInfo{{customPipelineInputName, dagDummyModelInputTensorInfo}};
+        auto input_node = std::make_unique<EntryNode>(&request, inputsInfo);
+        auto model_node = std::make_unique<DLNode>("dummy_node", dummyModelName, requestedModelVersion, managerWithDummyModel);
+        model_node->setOutputCache(cache);
+        const tensor_map_t outputsInfo{{customPipelineOutputName, dagDummyModelOutputTensorInfo}};
+        auto output_node = std::make_unique<ExitNode>(&response, outputsInfo);
+        Pipeline pipeline(*input_node, *output_node);
+        pipeline.connect(*input_node, *model_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+        pipeline.connect(*model_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+        pipeline.push(std::move(input_node));
+        pipeline.push(std::move(model_node));
+        pipeline.push(std::move(output_node));
+
+        ASSERT_EQ(pipeline.execute(), StatusCode::OK);
+        const int dummySeriallyConnectedCount = 1;
+        checkDummyResponse(dummySeriallyConnectedCount);
+    }
+    EXPECT_EQ(cache->getMisses(), 1);
+    EXPECT_EQ(cache->getHits(), 1);
+    EXPECT_EQ(cache->size(), 1);
+}
+
 class EnsembleFlowValidationTest : public EnsembleFlowTest {
 public:
     std::unique_ptr<Pipeline> createDummyPipeline(ConstructorEnabledModelManager& managerWithDummyModel) {
@@ -199,6 +300,61 @@ public:
     }
 };
 
+TEST_F(EnsembleFlowValidationTest, DummyModelSkippedAfterDeadline) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    auto pipeline = createDummyPipeline(managerWithDummyModel);
+    RequestContext context;
+    context.deadline = RequestContext::clock_t::now();
+    ASSERT_EQ(pipeline->execute(context), StatusCode::REQUEST_DEADLINE_EXCEEDED);
+    EXPECT_EQ(response.outputs().count(customPipelineOutputName), 0);
+}
+
+TEST_F(EnsembleFlowValidationTest, DummyModelSkippedAfterCancellation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    auto pipeline = createDummyPipeline(managerWithDummyModel);
+    RequestContext context;
+    context.cancellationCheck = []() { return true; };
+    ASSERT_EQ(pipeline->execute(context), StatusCode::REQUEST_CANCELLED);
+    EXPECT_EQ(response.outputs().count(customPipelineOutputName), 0);
+}
+
+TEST_F(EnsembleFlowValidationTest, DummyModelExecutedAsynchronously) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    PipelineExecutor executor(1);
+    std::promise<Status> completed;
+    auto completedStatus = completed.get_future();
+    executor.execute(createDummyPipeline(managerWithDummyModel), RequestContext(), [&completed](Status status) {
+        completed.set_value(status);
+    });
+    ASSERT_EQ(std::future_status::ready, completedStatus.wait_for(std::chrono::seconds(10)));
+    ASSERT_EQ(completedStatus.get(), StatusCode::OK);
+    const int dummySeriallyConnectedCount = 1;
+    checkDummyResponse(dummySeriallyConnectedCount);
+}
+
+TEST_F(EnsembleFlowValidationTest, DummyModelExecutedAsynchronouslySkippedAfterDeadline) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    PipelineExecutor executor(1);
+    std::promise<Status> completed;
+    auto completedStatus = completed.get_future();
+    RequestContext context;
+    context.deadline = RequestContext::clock_t::now();
+    executor.execute(createDummyPipeline(managerWithDummyModel), context, [&completed](Status status) {
+        completed.set_value(status);
+    });
+    ASSERT_EQ(std::future_status::ready, completedStatus.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(completedStatus.get(), StatusCode::REQUEST_DEADLINE_EXCEEDED);
+    EXPECT_EQ(response.outputs().count(customPipelineOutputName), 0);
+}
+
 TEST_F(EnsembleFlowValidationTest, DummyModelProtoValidationErrorNumberOfInputs) {
     ConstructorEnabledModelManager managerWithDummyModel;
     managerWithDummyModel.reloadModelWithVersions(config);
@@ -413,8 +569,14 @@ TEST_F(EnsembleFlowTest, DummyModelDirectAndPipelineInference) {
 TEST_F(EnsembleFlowTest, SeriesOfDummyModels) {
     // Most basic configuration, just process single dummy model request
 
-    Timer timer;
-    timer.start("prepare pipeline");
+    enum : size_t {
+        PREPARE_PIPELINE,
+        PIPELINE_EXECUTE,
+        COMPARE_RESULTS,
+        TIMER_END
+    };
+    Timer<TIMER_END> timer;
+    timer.start(PREPARE_PIPELINE);
 
     const int N = 100;
     // input      dummy x N      output
@@ -447,18 +609,18 @@ TEST_F(EnsembleFlowTest, SeriesOfDummyModels) {
         pipeline.push(std::move(dummy_node));
     }
 
-    timer.stop("prepare pipeline");
-    timer.start("pipeline::execute");
+    timer.stop(PREPARE_PIPELINE);
+    timer.start(PIPELINE_EXECUTE);
     pipeline.execute();
-    timer.stop("pipeline::execute");
+    timer.stop(PIPELINE_EXECUTE);
 
-    timer.start("compare results");
+    timer.start(COMPARE_RESULTS);
     checkDummyResponse(N);
-    timer.stop("compare results");
+    timer.stop(COMPARE_RESULTS);
 
-    std::cout << "prepare pipeline: " << timer.elapsed<std::chrono::microseconds>("prepare pipeline") / 1000 << "ms\n";
-    std::cout << "pipeline::execute: " << timer.elapsed<std::chrono::microseconds>("pipeline::execute") / 1000 << "ms\n";
-    std::cout << "compare results: " << timer.elapsed<std::chrono::microseconds>("compare results") / 1000 << "ms\n";
+    std::cout << "prepare pipeline: " << timer.elapsed<std::chrono::microseconds>(PREPARE_PIPELINE) / 1000 << "ms\n";
+    std::cout << "pipeline::execute: " << timer.elapsed<std::chrono::microseconds>(PIPELINE_EXECUTE) / 1000 << "ms\n";
+    std::cout << "compare results: " << timer.elapsed<std::chrono::microseconds>(COMPARE_RESULTS) / 1000 << "ms\n";
 }
 
 // Disabled with deserialization unification. For this use case to work we would have to additionally rely on "isPipeline" in getFinalShapedTensorInfo() to not use shape from tensor info but to rely on tensorProto
@@ -653,6 +815,69 @@ TEST_F(EnsembleFlowTest, ExecutePipelineWithDynamicBatchAndShape) {
     EXPECT_EQ(0, std::memcmp(actual_output, expected_output, BATCH_SIZE * WIDTH * sizeof(float)));
 }
 
+TEST_F(EnsembleFlowTest, ExecutePipelineWithShapeCacheWithoutReload) {
+    // Scenario
+
+    // input(1x12)   dummy(1x10), network for 1x12 from shape cache    output(1x12)
+    //  O------------------------------>O----------------------------->O
+
+    // dummy keeps its 1x10 network, node runs network compiled for 1x12 instead of reloading the model
+
+    const int WIDTH = 12;
+
+    tensorflow::TensorProto& proto = (*request.mutable_inputs())[customPipelineInputName];
+    proto.mutable_tensor_shape()->mutable_dim(1)->set_size(WIDTH);
+    std::vector<float> requestData(WIDTH);
+    std::iota(requestData.begin(), requestData.end(), 1.f);
+    proto.mutable_tensor_content()->assign((char*)requestData.data(), requestData.size() * sizeof(float));
+
+    config.setBatchSize(0);  // simulate --batch_size parameter not set
+    config.parseShapeParameter("auto");
+    config.setShapeCacheSize(2);
+    ConstructorEnabledModelManager manager;
+    manager.reloadModelWithVersions(config);
+
+    auto inputTensorInfo = std::make_shared<ovms::TensorInfo>(customPipelineInputName,
+        InferenceEngine::Precision::FP32,
+        shape_t{1, WIDTH},
+        InferenceEngine::Layout::NC);
+    const tensor_map_t inputsInfo{{customPipelineInputName, inputTensorInfo}};
+    auto input_node = std::make_unique<EntryNode>(&request, inputsInfo);
+    auto model_node = std::make_unique<DLNode>("dummy_node", dummyModelName, requestedModelVersion, manager);
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>(customPipelineOutputName,
+        InferenceEngine::Precision::FP32,
+        shape_t{1, WIDTH},
+        InferenceEngine::Layout::NC);
+    const tensor_map_t outputsInfo{{customPipelineOutputName, tensorInfo}};
+    auto output_node = std::make_unique<ExitNode>(&response, outputsInfo);
+
+    Pipeline pipeline(*input_node, *output_node);
+
+    pipeline.connect(*input_node, *model_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline.connect(*model_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+    pipeline.push(std::move(input_node));
+    pipeline.push(std::move(model_node));
+    pipeline.push(std::move(output_node));
+
+    ASSERT_EQ(pipeline.execute(), ovms::StatusCode::OK);
+
+    ASSERT_EQ(response.outputs().count(customPipelineOutputName), 1);
+    const auto& output_proto = response.outputs().at(customPipelineOutputName);
+    ASSERT_EQ(output_proto.tensor_shape().dim_size(), 2);
+    ASSERT_EQ(output_proto.tensor_shape().dim(0).size(), 1);
+    ASSERT_EQ(output_proto.tensor_shape().dim(1).size(), WIDTH);
+
+    std::vector<float> responseData = requestData;
+    std::for_each(responseData.begin(), responseData.end(), [](float& v) { v += 1.0; });
+    EXPECT_EQ(0, std::memcmp(output_proto.tensor_content().data(), responseData.data(), WIDTH * sizeof(float)));
+
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance(dummyModelName, 0, model, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(model->getInputsInfo().at(DUMMY_MODEL_INPUT_NAME)->getShape(), (shape_t{1, DUMMY_MODEL_INPUT_SIZE}));
+}
+
 TEST_F(EnsembleFlowTest, ExecutePipelineWithDynamicShape_RequestHasDifferentDim0) {
     // Scenario
     // Shape is set to auto but only first dimension differs - change batch size via reshape
@@ -921,6 +1146,140 @@ TEST_F(EnsembleFlowTest, FailInDLNodeFetchResultsStreamIdReleasedForDeferredNode
     EXPECT_EQ(status, ovms::StatusCode::UNKNOWN_ERROR) << status.string();
 }
 
+class EnsembleFlowTestModelDynamicBatching : public EnsembleFlowTest {
+protected:
+    // long enough that batches in tests are closed only by reaching max batch size
+    static constexpr uint32_t LONG_BATCH_TIMEOUT_US = 10'000'000;
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    void SetUp() override {
+        EnsembleFlowTest::SetUp();
+        config.setMaxBatchSize(2);
+        config.setBatchSize(2);
+        config.setBatchTimeoutUs(LONG_BATCH_TIMEOUT_US);
+        config.setNireq(1);
+        ASSERT_EQ(managerWithDummyModel.reloadModelWithVersions(config), StatusCode::OK_RELOADED);
+    }
+
+    // input   dummy    output
+    //  O------->O------->O
+    Status executePipeline(PredictRequest& pipelineRequest, PredictResponse& pipelineResponse, const std::shared_ptr<TensorInfo>& inputTensorInfo) {
+        const tensor_map_t inputsInfo{{customPipelineInputName, inputTensorInfo}};
+        auto input_node = std::make_unique<EntryNode>(&pipelineRequest, inputsInfo);
+        auto model_node = std::make_unique<DLNode>("dummy_node", dummyModelName, requestedModelVersion, managerWithDummyModel);
+        const tensor_map_t outputsInfo{{customPipelineOutputName, dagDummyModelOutputTensorInfo}};
+        auto output_node = std::make_unique<ExitNode>(&pipelineResponse, outputsInfo);
+        Pipeline pipeline(*input_node, *output_node);
+        pipeline.connect(*input_node, *model_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+        pipeline.connect(*model_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+        pipeline.push(std::move(input_node));
+        pipeline.push(std::move(model_node));
+        pipeline.push(std::move(output_node));
+        return pipeline.execute();
+    }
+
+    Status inferDirectly(const PredictRequest& directRequest, PredictResponse& directResponse) {
+        std::shared_ptr<ModelInstance> model;
+        std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+        auto status = managerWithDummyModel.getModelInstance(dummyModelName, 0, model, unloadGuard);
+        if (!status.ok()) {
+            return status;
+        }
+        return model->infer(&directRequest, &directResponse, unloadGuard);
+    }
+};
+
+TEST_F(EnsembleFlowTestModelDynamicBatching, PipelineNodeIsBatchedWithDirectRequest) {
+    const std::vector<float> directData(DUMMY_MODEL_INPUT_SIZE, 20.0);
+    auto directRequest = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}},
+        directData);
+    PredictResponse directResponse;
+
+    // batch is closed once it holds both entries, so neither waits for the batch timeout
+    const auto start = std::chrono::steady_clock::now();
+    auto direct = std::async(std::launch::async, [this, &directRequest, &directResponse]() {
+        return inferDirectly(directRequest, directResponse);
+    });
+    ASSERT_EQ(executePipeline(request, response, dagDummyModelInputTensorInfo), StatusCode::OK);
+    ASSERT_EQ(direct.get(), StatusCode::OK);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::microseconds(LONG_BATCH_TIMEOUT_US));
+
+    const int dummySeriallyConnectedCount = 1;
+    checkDummyResponse(dummySeriallyConnectedCount);
+    ::checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, directData, directRequest, directResponse, dummySeriallyConnectedCount);
+}
+
+TEST_F(EnsembleFlowTestModelDynamicBatching, ConcurrentPipelinesShareBatch) {
+    const std::vector<float> otherData(DUMMY_MODEL_INPUT_SIZE, 7.0);
+    PredictRequest otherRequest;
+    PredictResponse otherResponse;
+    prepareRequest(otherData, otherRequest, customPipelineInputName);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto other = std::async(std::launch::async, [this, &otherRequest, &otherResponse]() {
+        return executePipeline(otherRequest, otherResponse, dagDummyModelInputTensorInfo);
+    });
+    ASSERT_EQ(executePipeline(request, response, dagDummyModelInputTensorInfo), StatusCode::OK);
+    ASSERT_EQ(other.get(), StatusCode::OK);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::microseconds(LONG_BATCH_TIMEOUT_US));
+
+    const int dummySeriallyConnectedCount = 1;
+    checkDummyResponse(dummySeriallyConnectedCount);
+    ::checkDummyResponse(customPipelineOutputName, otherData, otherRequest, otherResponse, dummySeriallyConnectedCount);
+}
+
+TEST_F(EnsembleFlowTestModelDynamicBatching, FailedBatchFailsEveryJoinedPipelineNode) {
+    std::shared_ptr<ModelInstance> model;
+    std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(managerWithDummyModel.getModelInstance(dummyModelName, 0, model, unloadGuard), StatusCode::OK);
+    ASSERT_NE(model->getDynamicBatcher(), nullptr);
+
+    // input of this entry does not match sample size of the model, so the batch cannot be assembled
+    auto invalidBlob = InferenceEngine::make_shared_blob<float>(
+        InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {1, DUMMY_MODEL_INPUT_SIZE / 2}, InferenceEngine::Layout::NC));
+    invalidBlob->allocate();
+    std::promise<Status> invalidCompleted;
+    auto invalidStatus = invalidCompleted.get_future();
+    model->getDynamicBatcher()->inferAsync({{DUMMY_MODEL_INPUT_NAME, invalidBlob}}, 1, [&invalidCompleted](const Status& status, BlobMap&) {
+        invalidCompleted.set_value(status);
+    });
+
+    EXPECT_EQ(executePipeline(request, response, dagDummyModelInputTensorInfo), StatusCode::INTERNAL_ERROR);
+    ASSERT_EQ(invalidStatus.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(invalidStatus.get(), StatusCode::INTERNAL_ERROR);
+    EXPECT_EQ(response.outputs().count(customPipelineOutputName), 0);
+}
+
+TEST_F(EnsembleFlowTestModelDynamicBatching, NodeInputOfOtherShapeIsNotQueuedToBatcher) {
+    // node session executes on its own and fails validation instead of joining batch
+    const std::vector<float> data(12, 1.0);
+    prepareRequest(data, request, customPipelineInputName, {1, 12});
+    auto inputTensorInfo = std::make_shared<ovms::TensorInfo>(customPipelineInputName,
+        InferenceEngine::Precision::FP32,
+        shape_t{1, 12},
+        InferenceEngine::Layout::NC);
+    EXPECT_EQ(executePipeline(request, response, inputTensorInfo), StatusCode::INVALID_SHAPE);
+}
+
+TEST_F(EnsembleFlowTestModelDynamicBatching, NodeInputOfOtherPrecisionIsNotQueuedToBatcher) {
+    // node session executes on its own and fails validation instead of joining batch
+    const std::vector<int32_t> data(DUMMY_MODEL_INPUT_SIZE, 1);
+    request.Clear();
+    tensorflow::TensorProto& proto = (*request.mutable_inputs())[customPipelineInputName];
+    proto.set_dtype(tensorflow::DataType::DT_INT32);
+    proto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(int32_t));
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(DUMMY_MODEL_INPUT_SIZE);
+    auto inputTensorInfo = std::make_shared<ovms::TensorInfo>(customPipelineInputName,
+        InferenceEngine::Precision::I32,
+        DUMMY_MODEL_SHAPE,
+        InferenceEngine::Layout::NC);
+    EXPECT_EQ(executePipeline(request, response, inputTensorInfo), StatusCode::INVALID_PRECISION);
+}
+
 TEST_F(EnsembleFlowTest, CorrectPipelineDefinitionNodesValidation) {
     ConstructorEnabledModelManager managerWithDummyModel;
     managerWithDummyModel.reloadModelWithVersions(config);
@@ -947,6 +1306,95 @@ TEST_F(EnsembleFlowTest, CorrectPipelineDefinitionNodesValidation) {
     ASSERT_EQ(pipelineDefinition->validateNodes(managerWithDummyModel), StatusCode::OK);
 }
 
+TEST_F(EnsembleFlowTest, OutputsTakenInTheSameLayoutByDLNodesAreHandedOver) {
+    // input   dummy_1   dummy_2   output
+    //  O-------->O-------->O-------->O
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node_1", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::DL, "dummy_node_2", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node_1"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections["dummy_node_2"] = {
+        {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node_2", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+
+    auto pipelineDefinition = std::make_unique<PipelineDefinition>("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition->validate(managerWithDummyModel), StatusCode::OK);
+    EXPECT_EQ(pipelineDefinition->getHandedOverOutputs("dummy_node_1"), std::set<std::string>{DUMMY_MODEL_OUTPUT_NAME});
+    // response is serialized from output, it is copied as before
+    EXPECT_TRUE(pipelineDefinition->getHandedOverOutputs("dummy_node_2").empty());
+
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(pipelineDefinition->create(pipeline, &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    const int dummySeriallyConnectedCount = 2;
+    checkDummyResponse(dummySeriallyConnectedCount);
+
+    // output used also by response is not handed over
+    connections[EXIT_NODE_NAME]["dummy_node_1"] = {{DUMMY_MODEL_OUTPUT_NAME, "first_output"}};
+    pipelineDefinition = std::make_unique<PipelineDefinition>("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition->validate(managerWithDummyModel), StatusCode::OK);
+    EXPECT_TRUE(pipelineDefinition->getHandedOverOutputs("dummy_node_1").empty());
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionReloadIsSkippedWhenDefinitionDidNotChange) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+
+    std::unique_ptr<PipelineDefinition> pipelineDefinition = std::make_unique<PipelineDefinition>("my_new_pipeline", info, connections);
+    // definition which was not validated yet requires reload
+    EXPECT_TRUE(pipelineDefinition->isReloadRequired(info, connections));
+    ASSERT_EQ(pipelineDefinition->validate(managerWithDummyModel), StatusCode::OK);
+    EXPECT_FALSE(pipelineDefinition->isReloadRequired(info, connections));
+
+    auto changedConnections = connections;
+    changedConnections[EXIT_NODE_NAME]["dummy_node"][0].second = "other_output";
+    EXPECT_TRUE(pipelineDefinition->isReloadRequired(info, changedConnections));
+    auto changedInfo = info;
+    changedInfo[1].modelVersion = 1;
+    EXPECT_TRUE(pipelineDefinition->isReloadRequired(changedInfo, connections));
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionWithUnavailableRemoteModelFailsValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::REMOTE, "remote_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    // nothing listens on this port
+    info[1].remote.address = "localhost:1";
+    pipeline_connections_t connections;
+    connections["remote_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"remote_node", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+
+    std::unique_ptr<PipelineDefinition> pipelineDefinition = std::make_unique<PipelineDefinition>("my_new_pipeline", info, connections);
+    EXPECT_EQ(pipelineDefinition->validate(managerWithDummyModel), StatusCode::PIPELINE_REMOTE_MODEL_UNAVAILABLE);
+}
+
 TEST_F(EnsembleFlowTest, PipelineDefinitionNodesWithModelBatchingModeAutoValidation) {
     ConstructorEnabledModelManager managerWithDummyModel;
     config.setBatchingMode(AUTO);
@@ -971,7 +1419,7 @@ TEST_F(EnsembleFlowTest, PipelineDefinitionNodesWithModelBatchingModeAutoValidat
 
     // Create pipeline definition
     std::unique_ptr<PipelineDefinition> pipelineDefinition = std::make_unique<PipelineDefinition>("my_new_pipeline", info, connections);
-    ASSERT_EQ(pipelineDefinition->validateNodes(managerWithDummyModel), StatusCode::FORBIDDEN_MODEL_DYNAMIC_PARAMETER);
+    ASSERT_EQ(pipelineDefinition->validateNodes(managerWithDummyModel), StatusCode::OK);
 }
 
 TEST_F(EnsembleFlowTest, PipelineDefinitionNodesWithModelShapeModeAutoValidation) {
@@ -998,7 +1446,7 @@ TEST_F(EnsembleFlowTest, PipelineDefinitionNodesWithModelShapeModeAutoValidation
 
     // Create pipeline definition
     std::unique_ptr<PipelineDefinition> pipelineDefinition = std::make_unique<PipelineDefinition>("my_new_pipeline", info, connections);
-    ASSERT_EQ(pipelineDefinition->validateNodes(managerWithDummyModel), StatusCode::FORBIDDEN_MODEL_DYNAMIC_PARAMETER);
+    ASSERT_EQ(pipelineDefinition->validateNodes(managerWithDummyModel), StatusCode::OK);
 }
 
 TEST_F(EnsembleFlowTest, PipelineDefinitionNodesWithMissingNodeModelValidation) {
@@ -1562,6 +2010,52 @@ TEST_F(EnsembleFlowTest, SimplePipelineFactoryCreation) {
     checkDummyResponse(dummySeriallyConnectedCount);
 }
 
+TEST_F(EnsembleFlowTest, PipelineFactoryCreationWithOutputFilter) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    PipelineFactory factory;
+
+    // Nodes
+    // request   dummy_node_1   response
+    //  O---------->O----------->O
+    //  |                        ^
+    //  |        dummy_node_2    |
+    //  L---------->O------------'
+    // Only nodes computing requested outputs are created
+    const std::string pipelineName = "my_new_pipeline";
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node_1", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::DL, "dummy_node_2", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["dummy_node_1"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections["dummy_node_2"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}},
+        {"dummy_node_2", {{DUMMY_MODEL_OUTPUT_NAME, "unrequested_output"}}}};
+
+    ASSERT_EQ(factory.createDefinition(pipelineName, info, connections, managerWithDummyModel), StatusCode::OK);
+
+    request.add_output_filter(customPipelineOutputName);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, pipelineName, &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    EXPECT_EQ(response.outputs().size(), 1);
+    EXPECT_EQ(response.outputs().count("unrequested_output"), 0);
+    const int dummySeriallyConnectedCount = 1;
+    checkDummyResponse(dummySeriallyConnectedCount);
+
+    request.add_output_filter("not_existing_output");
+    pipeline.reset();
+    EXPECT_EQ(factory.create(pipeline, pipelineName, &request, &response, managerWithDummyModel), StatusCode::INVALID_OUTPUT_FILTER);
+}
+
 TEST_F(EnsembleFlowTest, ParallelPipelineFactoryUsage) {
     // Prepare manager
     ConstructorEnabledModelManager managerWithDummyModel;
@@ -1914,6 +2408,108 @@ TEST_F(EnsembleFlowTest, PipelineFactoryCreationWithInputOutputsMappings2Paralle
         << readableError(expected_output, actual_output, dataLengthToCheck);
 }
 
+static const char* pipelineConditionalDummyCascadeConfig = R"(
+{
+    "model_config_list": [
+        {
+            "config": {
+                "name": "dummy",
+                "base_path": "/ovms/src/test/dummy",
+                "target_device": "CPU",
+                "model_version_policy": {"all": {}},
+                "nireq": 1
+            }
+        }
+    ],
+    "pipeline_config_list": [
+        {
+            "name": "pipelineConditionalDummy",
+            "inputs": ["custom_dummy_input", "run_second"],
+            "nodes": [
+                {
+                    "name": "dummyNode",
+                    "model_name": "dummy",
+                    "type": "DL model",
+                    "inputs": [
+                        {"b": {"node_name": "request",
+                               "data_item": "custom_dummy_input"}}
+                    ],
+                    "outputs": [
+                        {"data_item": "a",
+                         "alias": "dummy_output"}
+                    ]
+                },
+                {
+                    "name": "dummyNode2",
+                    "model_name": "dummy",
+                    "type": "DL model",
+                    "condition": {"node_name": "request",
+                                  "data_item": "run_second"},
+                    "inputs": [
+                        {"b": {"node_name": "dummyNode",
+                               "data_item": "dummy_output"}}
+                    ],
+                    "outputs": [
+                        {"data_item": "a",
+                         "alias": "dummy_output2"}
+                    ]
+                }
+            ],
+            "outputs": [
+                {"custom_dummy_output": {"node_name": "dummyNode2",
+                                         "data_item": "dummy_output2"}
+                },
+                {"custom_dummy_output": {"node_name": "dummyNode",
+                                         "data_item": "dummy_output"}
+                }
+            ]
+        }
+    ]
+})";
+
+class EnsembleFlowConditionTest : public EnsembleFlowTest {
+protected:
+    void prepareConditionRequest(const std::vector<int32_t>& condition) {
+        tensorflow::TensorProto& proto = (*request.mutable_inputs())["run_second"];
+        proto.set_dtype(tensorflow::DataType::DT_INT32);
+        proto.mutable_tensor_content()->assign((char*)condition.data(), condition.size() * sizeof(int32_t));
+        proto.mutable_tensor_shape()->add_dim()->set_size(condition.size());
+    }
+
+    Status executeConditionalPipeline() {
+        std::string fileToReload = directoryPath + "/ovms_config_file.json";
+        createConfigFileWithContent(pipelineConditionalDummyCascadeConfig, fileToReload);
+        managerWithDummyModel.loadConfig(fileToReload);
+        std::unique_ptr<Pipeline> pipeline;
+        auto status = managerWithDummyModel.createPipeline(pipeline, "pipelineConditionalDummy", &request, &response);
+        if (!status.ok()) {
+            return status;
+        }
+        return pipeline->execute();
+    }
+
+    ConstructorEnabledModelManager managerWithDummyModel;
+};
+
+TEST_F(EnsembleFlowConditionTest, ConditionMetRunsNode) {
+    prepareConditionRequest({1});
+    ASSERT_EQ(executeConditionalPipeline(), StatusCode::OK);
+    const int dummySeriallyConnectedCount = 2;
+    checkDummyResponse(dummySeriallyConnectedCount);
+}
+
+TEST_F(EnsembleFlowConditionTest, ConditionNotMetSkipsNodeAndTakesAlternativeOutput) {
+    prepareConditionRequest({0});
+    ASSERT_EQ(executeConditionalPipeline(), StatusCode::OK);
+    const int dummySeriallyConnectedCount = 1;
+    checkDummyResponse(dummySeriallyConnectedCount);
+}
+
+TEST_F(EnsembleFlowConditionTest, ConditionWithMultipleElementsFails) {
+    prepareConditionRequest({1, 1});
+    EXPECT_EQ(executeConditionalPipeline(), StatusCode::INVALID_SHAPE);
+}
+
 static const char* pipelineOneDummyConfigWrongNodeKind = R"(
 {
     "model_config_list": [
@@ -0,0 +1,189 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../fair_share_scheduler.hpp"
+
+using namespace ovms;
+
+namespace {
+void waitUntil(const std::function<bool()>& condition) {
+    while (!condition()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+}  // namespace
+
+TEST(FairShareScheduler, UnlimitedTenantDoesNotTakeSlots) {
+    FairShareScheduler scheduler;
+    auto& tenant = scheduler.getTenant("model");
+    bool scheduled = true;
+    EXPECT_EQ(scheduler.acquire(tenant, RequestContext(), scheduled), StatusCode::OK);
+    EXPECT_FALSE(scheduled);
+    EXPECT_EQ(tenant.getInFlight(), 0);
+    EXPECT_EQ(&scheduler.getTenant("model"), &tenant);
+}
+
+TEST(FairShareScheduler, TenantLimitIsEnforced) {
+    FairShareScheduler scheduler;
+    auto& tenant = scheduler.getTenant("model");
+    auto& other = scheduler.getTenant("other");
+    scheduler.configureTenant(tenant, 1, 1);
+    auto slot = std::make_unique<FairShareSlotGuard>(scheduler, &tenant, RequestContext());
+    ASSERT_EQ(slot->getStatus(), StatusCode::OK);
+    EXPECT_EQ(tenant.getInFlight(), 1);
+
+    std::atomic<bool> acquired = false;
+    std::thread waiting([&]() {
+        FairShareSlotGuard waitingSlot(scheduler, &tenant, RequestContext());
+        EXPECT_EQ(waitingSlot.getStatus(), StatusCode::OK);
+        acquired = true;
+    });
+    waitUntil([&tenant]() { return tenant.getWaiting() == 1; });
+    EXPECT_EQ(tenant.getThrottledCount(), 1);
+    // other tenants are not limited by the tenant limit
+    FairShareSlotGuard otherSlot(scheduler, &other, RequestContext());
+    EXPECT_EQ(otherSlot.getStatus(), StatusCode::OK);
+    EXPECT_FALSE(acquired);
+
+    slot.reset();
+    waiting.join();
+    EXPECT_TRUE(acquired);
+    EXPECT_EQ(tenant.getInFlight(), 0);
+    EXPECT_EQ(tenant.getWaiting(), 0);
+}
+
+TEST(FairShareScheduler, FreedSlotsAreSharedByWeight) {
+    FairShareScheduler scheduler;
+    scheduler.setCapacity(3);
+    auto& heavy = scheduler.getTenant("heavy");
+    auto& light = scheduler.getTenant("light");
+    scheduler.configureTenant(heavy, 2, 0);
+    scheduler.configureTenant(light, 1, 0);
+
+    // burst of light tenant takes whole capacity
+    std::vector<std::unique_ptr<FairShareSlotGuard>> slots;
+    for (int i = 0; i < 3; ++i) {
+        slots.push_back(std::make_unique<FairShareSlotGuard>(scheduler, &light, RequestContext()));
+    }
+    std::atomic<int> granted = 0;
+    std::atomic<bool> finished = false;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+        for (auto* tenant : {&light, &heavy}) {
+            threads.emplace_back([&, tenant]() {
+                FairShareSlotGuard slot(scheduler, tenant, RequestContext());
+                EXPECT_EQ(slot.getStatus(), StatusCode::OK);
+                granted++;
+                waitUntil([&finished]() { return finished.load(); });
+            });
+            waitUntil([tenant, i]() { return tenant->getWaiting() == i + 1; });
+        }
+    }
+    slots.clear();
+    waitUntil([&granted]() { return granted == 3; });
+    // heavy tenant gets two of three freed slots
+    EXPECT_EQ(heavy.getInFlight(), 2);
+    EXPECT_EQ(light.getInFlight(), 1);
+    finished = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(heavy.getThrottledCount(), 3);
+    EXPECT_EQ(light.getThrottledCount(), 3);
+}
+
+TEST(FairShareScheduler, WaitingRequestStopsAtDeadline) {
+    FairShareScheduler scheduler;
+    scheduler.setCapacity(1);
+    auto& tenant = scheduler.getTenant("model");
+    FairShareSlotGuard slot(scheduler, &tenant, RequestContext());
+    ASSERT_EQ(slot.getStatus(), StatusCode::OK);
+
+    RequestContext context;
+    context.deadline = RequestContext::clock_t::now() + std::chrono::milliseconds(20);
+    FairShareSlotGuard expired(scheduler, &tenant, context);
+    EXPECT_EQ(expired.getStatus(), StatusCode::REQUEST_DEADLINE_EXCEEDED);
+    EXPECT_EQ(tenant.getWaiting(), 0);
+    EXPECT_EQ(tenant.getInFlight(), 1);
+}
+
+TEST(FairShareScheduler, NodeSlotIsGrantedThroughCallback) {
+    FairShareScheduler scheduler;
+    auto& tenant = scheduler.getTenant("model");
+    scheduler.configureTenant(tenant, 1, 1);
+    auto slot = std::make_unique<FairShareSlotGuard>(scheduler, &tenant, RequestContext());
+    ASSERT_EQ(slot->getStatus(), StatusCode::OK);
+
+    FairShareNodeSlotGuard nodeSlot(scheduler, &tenant);
+    EXPECT_EQ(tenant.getWaiting(), 1);
+    EXPECT_EQ(tenant.getThrottledCount(), 1);
+    int notifications = 0;
+    EXPECT_TRUE(nodeSlot.notifyWhenGranted([&notifications]() { notifications++; }));
+    EXPECT_EQ(notifications, 0);
+
+    slot.reset();
+    EXPECT_EQ(notifications, 1);
+    EXPECT_EQ(tenant.getWaiting(), 0);
+    EXPECT_EQ(tenant.getInFlight(), 1);
+    EXPECT_FALSE(nodeSlot.notifyWhenGranted([&notifications]() { notifications++; }));
+
+    nodeSlot.disarm();
+    EXPECT_EQ(tenant.getInFlight(), 0);
+    EXPECT_EQ(notifications, 1);
+}
+
+TEST(FairShareScheduler, NodeSlotIsTakenRightAwayWhenAvailable) {
+    FairShareScheduler scheduler;
+    auto& tenant = scheduler.getTenant("model");
+    scheduler.configureTenant(tenant, 1, 1);
+    {
+        FairShareNodeSlotGuard nodeSlot(scheduler, &tenant);
+        EXPECT_FALSE(nodeSlot.notifyWhenGranted([]() {}));
+        EXPECT_EQ(tenant.getInFlight(), 1);
+        EXPECT_EQ(tenant.getThrottledCount(), 0);
+    }
+    EXPECT_EQ(tenant.getInFlight(), 0);
+}
+
+TEST(FairShareScheduler, DisarmedNodeSlotStopsWaiting) {
+    FairShareScheduler scheduler;
+    auto& tenant = scheduler.getTenant("model");
+    scheduler.configureTenant(tenant, 1, 1);
+    auto slot = std::make_unique<FairShareSlotGuard>(scheduler, &tenant, RequestContext());
+    ASSERT_EQ(slot->getStatus(), StatusCode::OK);
+
+    int notifications = 0;
+    auto nodeSlot = std::make_unique<FairShareNodeSlotGuard>(scheduler, &tenant);
+    EXPECT_TRUE(nodeSlot->notifyWhenGranted([&notifications]() { notifications++; }));
+    nodeSlot->disarm();
+    EXPECT_EQ(tenant.getWaiting(), 0);
+
+    // freed slot is not handed over to disarmed session
+    slot.reset();
+    EXPECT_EQ(notifications, 0);
+    EXPECT_EQ(tenant.getInFlight(), 0);
+    nodeSlot.reset();
+    EXPECT_EQ(tenant.getInFlight(), 0);
+}
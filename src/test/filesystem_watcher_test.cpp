@@ -0,0 +1,82 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../filesystem_watcher.hpp"
+#include "test_utils.hpp"
+
+using ovms::FileSystemWatcher;
+
+class FileSystemWatcherTest : public TestWithTempDir {};
+
+TEST_F(FileSystemWatcherTest, DetectsChangesOfWatchedDirectories) {
+    FileSystemWatcher watcher;
+    ASSERT_TRUE(watcher.isValid());
+    EXPECT_TRUE(FileSystemWatcher::isWatchable(directoryPath));
+    const std::string versionPath = directoryPath + "/1";
+    std::filesystem::create_directories(versionPath);
+    ASSERT_TRUE(watcher.watchDirectories({directoryPath, versionPath}));
+    EXPECT_FALSE(watcher.waitForChanges(10, 10));
+
+    std::filesystem::create_directories(directoryPath + "/2");
+    EXPECT_TRUE(watcher.waitForChanges(1000, 10));
+    EXPECT_FALSE(watcher.waitForChanges(10, 10));
+
+    std::ofstream(versionPath + "/model.xml") << "<net/>";
+    EXPECT_TRUE(watcher.waitForChanges(1000, 10));
+
+    // Changes of directories no longer watched are not reported
+    ASSERT_TRUE(watcher.watchDirectories({directoryPath}));
+    std::ofstream(versionPath + "/model.bin") << "0";
+    EXPECT_FALSE(watcher.waitForChanges(10, 10));
+}
+
+TEST_F(FileSystemWatcherTest, ReportsChangesOnceAfterDebounce) {
+    FileSystemWatcher watcher;
+    ASSERT_TRUE(watcher.watchDirectories({directoryPath}));
+    std::thread writer([this]() {
+        for (int i = 0; i < 5; ++i) {
+            std::ofstream(directoryPath + "/file" + std::to_string(i)) << i;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    });
+    EXPECT_TRUE(watcher.waitForChanges(1000, 200));
+    writer.join();
+    EXPECT_FALSE(watcher.waitForChanges(10, 10));
+}
+
+TEST_F(FileSystemWatcherTest, ReportsMissingDirectory) {
+    FileSystemWatcher watcher;
+    EXPECT_FALSE(watcher.watchDirectories({directoryPath + "/missing"}));
+}
+
+TEST_F(FileSystemWatcherTest, InterruptWakesUpWaitingThread) {
+    FileSystemWatcher watcher;
+    ASSERT_TRUE(watcher.watchDirectories({directoryPath}));
+    std::thread interrupter([&watcher]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        watcher.interrupt();
+    });
+    EXPECT_FALSE(watcher.waitForChanges(-1, 10));
+    interrupter.join();
+}
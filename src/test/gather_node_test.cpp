@@ -133,6 +133,39 @@ TEST_F(GatherNodeInputHandlerTest, GatheringOnTwoDemultiplexersAtOnce) {
     EXPECT_EQ(std::memcmp((char*)((const void*)InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap()), blobsData.data(), blobsData.size() * sizeof(float)), 0);
 }
 
+TEST_F(GatherNodeInputHandlerTest, ShardsWrittenIntoInputSlotsAreNotCopied) {
+    const std::string inputName{"a"};
+    const uint32_t shardsCount = 2;
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::FP32, {1, 3}, InferenceEngine::Layout::NC};
+    NodeSessionMetadata meta;
+    const std::string demultiplexerName = "NOT_IMPORTANT_NAME";
+    auto newMeta = meta.generateSubsessions(demultiplexerName, shardsCount)[0];
+    auto [_, collapsingDetails] = newMeta.getCollapsedSessionMetadata({demultiplexerName});
+    GatherNodeInputHandler gInputHandler(1, collapsingDetails);
+
+    auto slot = gInputHandler.getInputSlot(inputName, 0, desc);
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(slot->getTensorDesc(), desc);
+    EXPECT_EQ(gInputHandler.getInputSlot(inputName, shardsCount, desc), nullptr);
+    EXPECT_EQ(gInputHandler.getInputSlot(inputName, 1, {InferenceEngine::Precision::FP32, {1, 4}, InferenceEngine::Layout::NC}), nullptr);
+    std::vector<float> slotData{1, 2, 3};
+    float* slotPtr = InferenceEngine::as<InferenceEngine::MemoryBlob>(slot)->wmap().as<float*>();
+    std::copy(slotData.begin(), slotData.end(), slotPtr);
+    std::vector<float> copiedData{4, 5, 6};
+    InferenceEngine::Blob::Ptr copiedShard = InferenceEngine::make_shared_blob<float>(desc, copiedData.data());
+
+    ASSERT_EQ(gInputHandler.setInput(inputName, slot, 0), StatusCode::OK);
+    ASSERT_EQ(gInputHandler.notifyFinishedDependency(), StatusCode::OK);
+    ASSERT_EQ(gInputHandler.setInput(inputName, copiedShard, 1), StatusCode::OK);
+    ASSERT_EQ(gInputHandler.notifyFinishedDependency(), StatusCode::OK);
+    ASSERT_TRUE(gInputHandler.isReady());
+
+    const auto& blob = gInputHandler.getInputs().at(inputName);
+    const float* gatheredData = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const float*>();
+    EXPECT_EQ(gatheredData, slotPtr);
+    EXPECT_THAT(std::vector<float>(gatheredData, gatheredData + blob->size()), ElementsAre(1, 2, 3, 4, 5, 6));
+}
+
 TEST_F(GatherNodeInputHandlerTest, SetInputsWithShardsHavingDifferentShapesShouldReturnErrorWhenGathering) {
     // simulate all 3 inputs comming from different predecessor nodes
     // with session demultiplexed to 2 shards
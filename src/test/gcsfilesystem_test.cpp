@@ -140,3 +140,13 @@ TEST(DISABLED_GCSFileSystem, file_details) {
     check_file_access(getPrivateFilePath(), fs.get());
     check_dir_access(getPrivateDirPath(), fs.get());
 }
+
+TEST(GCSFileSystem, Crc32cMatchesObjectMetadataFormat) {
+    const std::string data = "123456789";
+    EXPECT_EQ(ovms::GCSFileSystem::extendCrc32c(0, data.data(), data.size()), 0xE3069283);
+    uint32_t crc = ovms::GCSFileSystem::extendCrc32c(0, data.data(), 4);
+    crc = ovms::GCSFileSystem::extendCrc32c(crc, data.data() + 4, data.size() - 4);
+    EXPECT_EQ(crc, 0xE3069283);
+    EXPECT_EQ(ovms::GCSFileSystem::encodeCrc32c(crc), "4waSgw==");
+    EXPECT_EQ(ovms::GCSFileSystem::encodeCrc32c(ovms::GCSFileSystem::extendCrc32c(0, nullptr, 0)), "AAAAAA==");
+}
@@ -259,6 +259,28 @@ TEST_F(GetModelMetadataResponseBuild, serialize2Json) {
     EXPECT_TRUE(received_doc.HasMember("metadata"));
 }
 
+TEST(GetModelMetadataCachedResponse, ResponseIsRebuiltAfterReshape) {
+    ConstructorEnabledModelManager manager;
+    auto config = DUMMY_MODEL_CONFIG;
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    tensorflow::serving::GetModelMetadataRequest request;
+    ASSERT_EQ(ovms::GetModelMetadataImpl::createGrpcRequest("dummy", 1, &request), ovms::StatusCode::OK);
+
+    tensorflow::serving::GetModelMetadataResponse first, second;
+    ASSERT_EQ(ovms::GetModelMetadataImpl::getModelStatus(&request, &first, manager), ovms::StatusCode::OK);
+    ASSERT_EQ(ovms::GetModelMetadataImpl::getModelStatus(&request, &second, manager), ovms::StatusCode::OK);
+    EXPECT_EQ(first.SerializeAsString(), second.SerializeAsString());
+
+    config.setBatchSize(5);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    tensorflow::serving::GetModelMetadataResponse reshaped;
+    ASSERT_EQ(ovms::GetModelMetadataImpl::getModelStatus(&request, &reshaped, manager), ovms::StatusCode::OK);
+    tensorflow::serving::SignatureDefMap def;
+    reshaped.metadata().at("signature_def").UnpackTo(&def);
+    const auto& inputs = def.signature_def().at("serving_default").inputs();
+    EXPECT_EQ(inputs.at(DUMMY_MODEL_INPUT_NAME).tensor_shape().dim(0).size(), 5);
+}
+
 TEST(RESTGetModelMetadataResponse, createGrpcRequestVersionSet) {
     std::string model_name = "dummy";
     std::optional<int64_t> model_version = 1;
@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../http_compression.hpp"
+
+using namespace ovms;
+
+static std::string makeBody() {
+    std::string body;
+    for (int i = 0; i < 10000; i++) {
+        body += "{\"instances\": [[1.0, 2.0, 3.0]]},";
+    }
+    return body;
+}
+
+TEST(HttpCompression, ParsesContentEncoding) {
+    EXPECT_EQ(parseContentEncoding(""), ContentEncoding::IDENTITY);
+    EXPECT_EQ(parseContentEncoding("identity"), ContentEncoding::IDENTITY);
+    EXPECT_EQ(parseContentEncoding(" GZIP "), ContentEncoding::GZIP);
+    EXPECT_EQ(parseContentEncoding("x-gzip"), ContentEncoding::GZIP);
+    EXPECT_EQ(parseContentEncoding("deflate"), ContentEncoding::DEFLATE);
+    EXPECT_EQ(parseContentEncoding("br"), ContentEncoding::UNSUPPORTED);
+    EXPECT_EQ(parseContentEncoding("gzip, deflate"), ContentEncoding::UNSUPPORTED);
+}
+
+TEST(HttpCompression, NegotiatesResponseEncoding) {
+    EXPECT_EQ(negotiateContentEncoding(""), ContentEncoding::IDENTITY);
+    EXPECT_EQ(negotiateContentEncoding("identity"), ContentEncoding::IDENTITY);
+    EXPECT_EQ(negotiateContentEncoding("br, deflate"), ContentEncoding::DEFLATE);
+    EXPECT_EQ(negotiateContentEncoding("deflate, gzip;q=0.5"), ContentEncoding::GZIP);
+    EXPECT_EQ(negotiateContentEncoding("gzip;q=0, deflate"), ContentEncoding::DEFLATE);
+    EXPECT_EQ(negotiateContentEncoding("gzip; q=0.0, deflate;q=0"), ContentEncoding::IDENTITY);
+    EXPECT_EQ(negotiateContentEncoding("*"), ContentEncoding::GZIP);
+}
+
+TEST(HttpCompression, CompressedDataIsRestored) {
+    const std::string body = makeBody();
+    for (auto encoding : {ContentEncoding::GZIP, ContentEncoding::DEFLATE}) {
+        std::string compressed;
+        ASSERT_EQ(compress(encoding, 6, body, compressed), StatusCode::OK);
+        EXPECT_LT(compressed.size(), body.size() / 10);
+        EXPECT_EQ(isGzipData(compressed), encoding == ContentEncoding::GZIP);
+        std::string decompressed;
+        ASSERT_EQ(decompress(encoding, compressed, decompressed), StatusCode::OK);
+        EXPECT_EQ(decompressed, body);
+    }
+}
+
+TEST(HttpCompression, DecompressionIsLimitedBySize) {
+    const std::string body = makeBody();
+    std::string compressed;
+    ASSERT_EQ(compress(ContentEncoding::GZIP, 9, body, compressed), StatusCode::OK);
+    std::string decompressed;
+    EXPECT_EQ(decompress(ContentEncoding::GZIP, compressed, decompressed, body.size() - 1), StatusCode::REST_REQUEST_BODY_TOO_LARGE);
+    EXPECT_EQ(decompress(ContentEncoding::GZIP, compressed, decompressed, body.size()), StatusCode::OK);
+}
+
+TEST(HttpCompression, RejectsInvalidData) {
+    std::string compressed;
+    ASSERT_EQ(compress(ContentEncoding::DEFLATE, 1, makeBody(), compressed), StatusCode::OK);
+    std::string decompressed;
+    EXPECT_EQ(decompress(ContentEncoding::DEFLATE, compressed.substr(0, compressed.size() / 2), decompressed), StatusCode::REST_DECOMPRESSION_FAILED);
+    EXPECT_EQ(decompress(ContentEncoding::GZIP, "not compressed", decompressed), StatusCode::REST_DECOMPRESSION_FAILED);
+    EXPECT_EQ(decompress(ContentEncoding::GZIP, "", decompressed), StatusCode::REST_DECOMPRESSION_FAILED);
+}
@@ -13,11 +13,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <chrono>
+#include <regex>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "../config.hpp"
 #include "../http_rest_api_handler.hpp"
 #include "../logging.hpp"
+#include "../metrics.hpp"
 #include "../modelmanager.hpp"
 #include "test_utils.hpp"
 
@@ -924,3 +930,420 @@ TEST_F(ConfigStatus, configWithPipelines) {
     EXPECT_EQ(expectedJson, response);
     EXPECT_EQ(status, ovms::StatusCode::OK);
 }
+
+TEST(HttpRestApiHandler, KFSInferRequestComponents) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    ovms::HttpRequestComponents components;
+
+    ASSERT_EQ(handler.parseRequestComponents(components, "POST", "/v2/models/dummy/versions/2/infer"), ovms::StatusCode::OK);
+    EXPECT_EQ(components.type, ovms::KFSInfer);
+    EXPECT_EQ(components.model_name, "dummy");
+    EXPECT_EQ(components.model_version, 2);
+
+    components = ovms::HttpRequestComponents();
+    ASSERT_EQ(handler.parseRequestComponents(components, "POST", "/v2/models/dummy/infer"), ovms::StatusCode::OK);
+    EXPECT_EQ(components.type, ovms::KFSInfer);
+    EXPECT_FALSE(components.model_version.has_value());
+
+    EXPECT_EQ(handler.parseRequestComponents(components, "GET", "/v2/models/dummy/infer"), ovms::StatusCode::REST_UNSUPPORTED_METHOD);
+}
+
+TEST(HttpRestApiHandler, KFSInferBatchRequestComponents) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    ovms::HttpRequestComponents components;
+
+    ASSERT_EQ(handler.parseRequestComponents(components, "POST", "/v2/infer_batch"), ovms::StatusCode::OK);
+    EXPECT_EQ(components.type, ovms::KFSInferBatch);
+
+    EXPECT_EQ(handler.parseRequestComponents(components, "GET", "/v2/infer_batch"), ovms::StatusCode::REST_UNSUPPORTED_METHOD);
+}
+
+TEST(HttpRestApiHandler, KFSInferBatchRejectsInvalidJson) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    std::string response;
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    EXPECT_EQ(handler.processRequest("POST", "/v2/infer_batch", "{\"requests\": 1}", &headers, &response), ovms::StatusCode::JSON_INVALID);
+}
+
+TEST(HttpRestApiHandler, RawInputPredictRequestComponents) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    ovms::HttpRequestComponents components;
+
+    ASSERT_EQ(handler.parseRequestComponents(components, "POST", "/v1/models/dummy/versions/2/inputs/image:predict"), ovms::StatusCode::OK);
+    EXPECT_EQ(components.type, ovms::RawInputPredict);
+    EXPECT_EQ(components.model_name, "dummy");
+    EXPECT_EQ(components.model_version, 2);
+    EXPECT_EQ(components.input_name, "image");
+
+    EXPECT_EQ(handler.parseRequestComponents(components, "GET", "/v1/models/dummy/inputs/image:predict"), ovms::StatusCode::REST_UNSUPPORTED_METHOD);
+}
+
+TEST(HttpRestApiHandler, RawInputPredictRejectsUnsupportedContentType) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    std::string response;
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    EXPECT_EQ(handler.processRequest("POST", "/v1/models/dummy/inputs/image:predict", "{}", &headers, &response, ovms::RequestContext(), "application/json"),
+        ovms::StatusCode::REST_UNSUPPORTED_CONTENT_TYPE);
+    EXPECT_EQ(handler.processRequest("POST", "/v1/models/dummy/inputs/image:predict", "data", &headers, &response, ovms::RequestContext(), "multipart/form-data"),
+        ovms::StatusCode::REST_MALFORMED_REQUEST);
+}
+
+TEST(HttpRestApiHandler, MetricsRequestComponents) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    ovms::HttpRequestComponents components;
+
+    ASSERT_EQ(handler.parseRequestComponents(components, "GET", "/metrics"), ovms::StatusCode::OK);
+    EXPECT_EQ(components.type, ovms::Metrics);
+
+    EXPECT_EQ(handler.parseRequestComponents(components, "POST", "/metrics"), ovms::StatusCode::REST_UNSUPPORTED_METHOD);
+}
+
+TEST(HttpRestApiHandler, MetricsResponseHasPrometheusContentType) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    ovms::MetricRegistry::getInstance().getHistogram("ovms_test_rest_metric", "Test metric", {1}, "").observe(1);
+    std::string response;
+    std::vector<std::pair<std::string, std::string>> headers{{"Content-Type", "application/json"}};
+
+    ASSERT_EQ(handler.processMetricsRequest(response, &headers), ovms::StatusCode::OK);
+    EXPECT_EQ(headers[0].second, "text/plain; version=0.0.4");
+    EXPECT_NE(response.find("ovms_test_rest_metric_count 1\n"), std::string::npos);
+}
+
+TEST(HttpRestApiHandler, PeerFileRequestComponents) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    ovms::HttpRequestComponents components;
+
+    ASSERT_EQ(handler.parseRequestComponents(components, "GET", "/v1/peer/files/md5-6b41-7/bytes/2-5"), ovms::StatusCode::OK);
+    EXPECT_EQ(components.type, ovms::GetPeerFile);
+    EXPECT_EQ(components.file_key, "md5-6b41-7");
+    EXPECT_EQ(components.range_first, 2);
+    EXPECT_EQ(components.range_last, 5);
+
+    EXPECT_EQ(handler.parseRequestComponents(components, "GET", "/v1/peer/files/md5-6b41-7/bytes/0-99999999999999999999"), ovms::StatusCode::PEER_FILE_RANGE_INVALID);
+    EXPECT_EQ(handler.parseRequestComponents(components, "POST", "/v1/peer/files/md5-6b41-7/bytes/2-5"), ovms::StatusCode::REST_UNSUPPORTED_METHOD);
+}
+
+TEST(HttpRestApiHandler, PeerFilesAreNotServedByDefault) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    std::string response;
+    std::vector<std::pair<std::string, std::string>> headers;
+    EXPECT_EQ(handler.processRequest("GET", "/v1/peer/files/md5-6b41-7/bytes/0-6", "", &headers, &response), ovms::StatusCode::PEER_FILE_SERVING_DISABLED);
+}
+
+namespace {
+struct ExpectedComponents {
+    ovms::StatusCode code = ovms::StatusCode::OK;
+    ovms::RequestType type = ovms::Predict;
+    std::string modelName;
+    std::string modelVersion;
+    std::string modelVersionLabel;
+    std::string processingMethod;
+    std::string modelSubresource;
+    std::string sharedMemoryRegion;
+    std::string inputName;
+    std::string sequenceId;
+    std::string fileKey;
+    std::string byteRange;
+};
+
+// Routing as it used to be done with regular expressions, reference for hand written router
+class RegexRouter {
+    const std::regex prediction{ovms::HttpRestApiHandler::predictionRegexExp};
+    const std::regex modelstatus{ovms::HttpRestApiHandler::modelstatusRegexExp};
+    const std::regex configReload{ovms::HttpRestApiHandler::configReloadRegexExp};
+    const std::regex configStatus{ovms::HttpRestApiHandler::configStatusRegexExp};
+    const std::regex sharedMemory{ovms::HttpRestApiHandler::sharedMemoryRegexExp};
+    const std::regex kfsInfer{ovms::HttpRestApiHandler::kfsInferRegexExp};
+    const std::regex metrics{ovms::HttpRestApiHandler::metricsRegexExp};
+    const std::regex rawInputPrediction{ovms::HttpRestApiHandler::rawInputPredictionRegexExp};
+    const std::regex kfsInferBatch{ovms::HttpRestApiHandler::kfsInferBatchRegexExp};
+    const std::regex sequenceState{ovms::HttpRestApiHandler::sequenceStateRegexExp};
+    const std::regex slowRequests{ovms::HttpRestApiHandler::slowRequestsRegexExp};
+    const std::regex residency{ovms::HttpRestApiHandler::residencyRegexExp};
+    const std::regex peerFile{ovms::HttpRestApiHandler::peerFileRegexExp};
+    const std::regex health{ovms::HttpRestApiHandler::healthRegexExp};
+
+public:
+    ExpectedComponents route(const std::string& method, const std::string& path) const {
+        ExpectedComponents result;
+        std::smatch sm;
+        if (method == "POST") {
+            if (std::regex_match(path, sm, prediction)) {
+                result.type = ovms::Predict;
+                result.modelName = sm[2];
+                result.modelVersion = sm[3];
+                result.modelVersionLabel = sm[4];
+                result.processingMethod = sm[5];
+                return result;
+            }
+            if (std::regex_match(path, sm, configReload)) {
+                result.type = ovms::ConfigReload;
+                return result;
+            }
+            if (std::regex_match(path, sm, sharedMemory)) {
+                result.type = ovms::SharedMemory;
+                result.sharedMemoryRegion = sm[2];
+                result.processingMethod = sm[3];
+                return result;
+            }
+            if (std::regex_match(path, sm, kfsInfer)) {
+                result.type = ovms::KFSInfer;
+                result.modelName = sm[2];
+                result.modelVersion = sm[3];
+                return result;
+            }
+            if (std::regex_match(path, sm, rawInputPrediction)) {
+                result.type = ovms::RawInputPredict;
+                result.modelName = sm[2];
+                result.modelVersion = sm[3];
+                result.modelVersionLabel = sm[4];
+                result.inputName = sm[5];
+                result.processingMethod = "predict";
+                return result;
+            }
+            if (std::regex_match(path, sm, kfsInferBatch)) {
+                result.type = ovms::KFSInferBatch;
+                return result;
+            }
+            if (std::regex_match(path, sm, sequenceState)) {
+                result.type = ovms::SequenceState;
+                result.modelName = sm[2];
+                result.modelVersion = sm[3];
+                result.sequenceId = sm[5];
+                result.processingMethod = sm[6];
+                return result;
+            }
+            if (std::regex_match(path, sm, modelstatus) || std::regex_match(path, sm, metrics) || std::regex_match(path, sm, slowRequests) ||
+                std::regex_match(path, sm, residency) || std::regex_match(path, sm, peerFile) || std::regex_match(path, sm, health)) {
+                result.code = ovms::StatusCode::REST_UNSUPPORTED_METHOD;
+                return result;
+            }
+        } else {
+            if (std::regex_match(path, sm, modelstatus)) {
+                result.modelName = sm[2];
+                result.modelVersion = sm[3];
+                result.modelVersionLabel = sm[4];
+                result.modelSubresource = sm[5];
+                if (result.modelSubresource == "metadata") {
+                    result.type = ovms::GetModelMetadata;
+                } else if (result.modelSubresource == "memory") {
+                    result.type = ovms::GetModelMemory;
+                } else if (result.modelSubresource == "profile") {
+                    result.type = ovms::GetModelProfile;
+                } else if (result.modelSubresource == "saturation") {
+                    result.type = ovms::GetModelSaturation;
+                } else if (result.modelSubresource == "shapes") {
+                    result.type = ovms::GetModelShapes;
+                } else if (result.modelSubresource == "critical_path") {
+                    result.type = ovms::GetPipelineCriticalPath;
+                } else {
+                    result.type = ovms::GetModelStatus;
+                }
+                return result;
+            }
+            if (std::regex_match(path, sm, configStatus)) {
+                result.type = ovms::ConfigStatus;
+                return result;
+            }
+            if (std::regex_match(path, sm, metrics)) {
+                result.type = ovms::Metrics;
+                return result;
+            }
+            if (std::regex_match(path, sm, slowRequests)) {
+                result.type = ovms::GetSlowRequests;
+                return result;
+            }
+            if (std::regex_match(path, sm, residency)) {
+                result.type = ovms::GetResidency;
+                return result;
+            }
+            if (std::regex_match(path, sm, peerFile)) {
+                result.type = ovms::GetPeerFile;
+                result.fileKey = sm[2];
+                result.byteRange = std::string(sm[3]) + "-" + std::string(sm[4]);
+                return result;
+            }
+            if (std::regex_match(path, sm, health)) {
+                result.type = sm[2] == "live" ? ovms::ServerLive : ovms::ServerReady;
+                return result;
+            }
+            if (std::regex_match(path, sm, prediction) || std::regex_match(path, sm, sharedMemory) || std::regex_match(path, sm, kfsInfer) ||
+                std::regex_match(path, sm, rawInputPrediction) || std::regex_match(path, sm, kfsInferBatch) ||
+                std::regex_match(path, sm, sequenceState)) {
+                result.code = ovms::StatusCode::REST_UNSUPPORTED_METHOD;
+                return result;
+            }
+        }
+        result.code = ovms::StatusCode::REST_INVALID_URL;
+        return result;
+    }
+};
+
+const std::vector<std::string> routedPaths = {
+    "/v1/models/dummy:predict",
+    "/v1/models/dummy:classify",
+    "/v1/models/dummy:regress",
+    "/v1/models/dummy:explain",
+    "/v1/models/dummy/versions/1:predict",
+    "/v1/models/dummy/versions/:predict",
+    "/v1/models/dummy/versions/a1:predict",
+    "/v1/models/dummy/labels/latest_1:predict",
+    "/v1/models/dummy/labels/la-test:predict",
+    "/v1/models/dum my:predict",
+    "/v1/models/:predict",
+    "/v1/models/dummy:predict/",
+    "x/v1/models/dummy:predict",
+    "//v1/models/dummy:predict",
+    "xx/v1/models/dummy:predict",
+    "\n/v1/models/dummy:predict",
+    "/v1/models",
+    "/v1/models/",
+    "/v1/modelsx",
+    "/v1/models/dummy",
+    "/v1/models/dummy/",
+    "/v1/models/dummy/metadata",
+    "/v1/models/dummy/metadata/",
+    "/v1/models/dummy/versions/1",
+    "/v1/models/dummy/versions/1/metadata",
+    "/v1/models/dummy/versions/12x",
+    "/v1/models/dummy/labels/abc",
+    "/v1/models/dummy/labels/abc/metadata",
+    "/v1/models/dummy/labels/",
+    "/v1/models/versions",
+    "/v1/models/versions/1",
+    "/v1/models/versions/1/metadata",
+    "/v1/models/labels/abc",
+    "/v1/models/metadata",
+    "/v1/models/versions/metadata",
+    "/v1/models/metadata/metadata",
+    "/v1/models/dummy/other",
+    "/v1/models/dummy/memory",
+    "/v1/models/dummy/versions/1/memory",
+    "/v1/models/dummy/memory/",
+    "/v1/models/memory",
+    "/v1/models/dummy/profile",
+    "/v1/models/dummy/versions/1/profile",
+    "/v1/models/profile",
+    "/v1/models/dummy/saturation",
+    "/v1/models/dummy/versions/1/saturation",
+    "/v1/models/dummy/labels/abc/saturation",
+    "/v1/models/dummy/shapes",
+    "/v1/models/dummy/versions/1/shapes",
+    "/v1/models/dummy/shapes/",
+    "/v1/models/pipeline/critical_path",
+    "/v1/models/critical_path",
+    "/v1/config",
+    "/v1/config/",
+    "/v1/config/reload",
+    "/v1/config/reload/",
+    "x/v1/config",
+    "/v1/shm/regions/region:register",
+    "/v1/shm/regions/region:unregister",
+    "/v1/shm/regions/region:status",
+    "/v1/shm/regions/:register",
+    "/v1/shm/regions/a/b:register",
+    "/v2/models/dummy/infer",
+    "/v2/models/dummy/versions/3/infer",
+    "/v2/models/dummy/versions/infer",
+    "/v2/models/dum:my/infer",
+    "/v2/models//infer",
+    "/v2/models/dummy/infer/",
+    "y/v2/models/dummy/versions/3/infer",
+    "/v2/infer_batch",
+    "/v2/infer_batch/",
+    "x/v2/infer_batch",
+    "/v2/models/infer_batch",
+    "/v1/models/dummy/inputs/image:predict",
+    "/v1/models/dummy/versions/2/inputs/image:predict",
+    "/v1/models/dummy/labels/latest/inputs/image:predict",
+    "/v1/models/dummy/inputs/image:classify",
+    "/v1/models/dummy/inputs/:predict",
+    "/v1/models/dummy/inputs/a/b:predict",
+    "/v1/models/inputs/image:predict",
+    "/v1/models/dummy/sequences/12:export",
+    "/v1/models/dummy/versions/2/sequences/12:import",
+    "/v1/models/dummy/sequences/12:predict",
+    "/v1/models/dummy/sequences/a1:export",
+    "/v1/models/dummy/sequences/:import",
+    "/metrics",
+    "/metrics/",
+    "x/metrics",
+    "/v1/metrics",
+    "/v1/slow_requests",
+    "x/v1/slow_requests",
+    "/v1/slow_requests/",
+    "/v1/slow_requests/dummy",
+    "/v1/residency",
+    "x/v1/residency",
+    "/v1/residency/",
+    "/v1/peer/files/md5-6b41-7/bytes/0-6",
+    "x/v1/peer/files/gcs-crc32c-6b41-7/bytes/16777216-33554431",
+    "/v1/peer/files/md5-6b41-7/bytes/0-",
+    "/v1/peer/files/md5-6b41-7/bytes/-6",
+    "/v1/peer/files/md5-6b41-7/bytes/0-6/",
+    "/v1/peer/files/md5_6b41/bytes/0-6",
+    "/v1/peer/files//bytes/0-6",
+    "/v1/peer/files/md5-6b41-7",
+    "/v2/health/live",
+    "/v2/health/ready",
+    "x/v2/health/ready",
+    "/v2/health/ready/",
+    "/v2/health",
+    "/v2/health/other",
+    "",
+    "/",
+    "/v3/models/dummy",
+};
+
+ExpectedComponents routeWithHandler(ovms::HttpRestApiHandler& handler, const std::string& method, const std::string& path) {
+    ExpectedComponents result;
+    ovms::HttpRequestComponents components;
+    result.code = handler.parseRequestComponents(components, method, path).getCode();
+    if (result.code != ovms::StatusCode::OK) {
+        return result;
+    }
+    result.type = components.type;
+    result.modelName = components.model_name;
+    result.modelVersion = components.model_version.has_value() ? std::to_string(components.model_version.value()) : "";
+    result.modelVersionLabel = components.model_version_label.has_value() ? std::string(components.model_version_label.value()) : "";
+    result.processingMethod = components.processing_method;
+    result.modelSubresource = components.model_subresource;
+    result.sharedMemoryRegion = components.shared_memory_region;
+    result.inputName = components.input_name;
+    result.sequenceId = components.sequence_id ? std::to_string(components.sequence_id) : "";
+    if (components.type == ovms::GetPeerFile) {
+        result.fileKey = components.file_key;
+        result.byteRange = std::to_string(components.range_first) + "-" + std::to_string(components.range_last);
+    }
+    return result;
+}
+}  // namespace
+
+TEST(HttpRestApiHandler, RoutingMatchesRegularExpressions) {
+    auto handler = ovms::HttpRestApiHandler(10);
+    RegexRouter reference;
+    for (const std::string method : {"GET", "POST"}) {
+        for (const auto& path : routedPaths) {
+            SCOPED_TRACE(method + " " + path);
+            auto expected = reference.route(method, path);
+            auto actual = routeWithHandler(handler, method, path);
+            EXPECT_EQ(actual.code, expected.code);
+            if (expected.code != ovms::StatusCode::OK) {
+                continue;
+            }
+            EXPECT_EQ(actual.type, expected.type);
+            EXPECT_EQ(actual.modelName, expected.modelName);
+            EXPECT_EQ(actual.modelVersion, expected.modelVersion);
+            EXPECT_EQ(actual.modelVersionLabel, expected.modelVersionLabel);
+            EXPECT_EQ(actual.processingMethod, expected.processingMethod);
+            EXPECT_EQ(actual.modelSubresource, expected.modelSubresource);
+            EXPECT_EQ(actual.sharedMemoryRegion, expected.sharedMemoryRegion);
+            EXPECT_EQ(actual.inputName, expected.inputName);
+            EXPECT_EQ(actual.sequenceId, expected.sequenceId);
+            EXPECT_EQ(actual.fileKey, expected.fileKey);
+            EXPECT_EQ(actual.byteRange, expected.byteRange);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../http_server.hpp"
+
+using namespace ovms;
+
+namespace {
+const size_t MAX_BODY_SIZE = 1024;
+
+class HttpServerBodyLimit : public ::testing::Test {
+protected:
+    std::string socketPath;
+    std::unique_ptr<http_server> server;
+
+    void SetUp() override {
+        socketPath = "/tmp/ovms_http_server_test_" + std::to_string(getpid()) + ".sock";
+        server = createAndStartHttpServer(UNIX_SOCKET_ADDRESS_PREFIX + socketPath, 0, 1, MAX_BODY_SIZE);
+        ASSERT_NE(server, nullptr);
+    }
+
+    void TearDown() override {
+        if (server) {
+            server->Terminate();
+            server->WaitForTermination();
+        }
+        unlink(socketPath.c_str());
+    }
+
+    // sends raw HTTP request and returns response status line
+    std::string send(const std::string& request) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        EXPECT_GE(fd, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            ADD_FAILURE() << "Could not connect to " << socketPath;
+            return "";
+        }
+        size_t sent = 0;
+        while (sent < request.size()) {
+            auto written = write(fd, request.data() + sent, request.size() - sent);
+            if (written <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+        std::string response;
+        char buffer[4096];
+        ssize_t received = 0;
+        while (response.find("\r\n") == std::string::npos && (received = read(fd, buffer, sizeof(buffer))) > 0) {
+            response.append(buffer, static_cast<size_t>(received));
+        }
+        close(fd);
+        return response.substr(0, response.find("\r\n"));
+    }
+};
+}  // namespace
+
+TEST_F(HttpServerBodyLimit, BodyOverDeclaredLimitIsRejected) {
+    const std::string body(MAX_BODY_SIZE + 1, 'a');
+    std::string request = "POST /v1/models/dummy:predict HTTP/1.1\r\n";
+    request += "Host: localhost\r\n";
+    request += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    request += "Connection: close\r\n\r\n";
+    request += body;
+    EXPECT_EQ(send(request).substr(0, 12), "HTTP/1.1 413");
+}
+
+TEST_F(HttpServerBodyLimit, ChunkedBodyOverLimitIsRejected) {
+    const std::string chunk(MAX_BODY_SIZE / 2 + 1, 'a');
+    char chunkSize[16];
+    snprintf(chunkSize, sizeof(chunkSize), "%zx", chunk.size());
+    std::string request = "POST /v1/models/dummy:predict HTTP/1.1\r\n";
+    request += "Host: localhost\r\n";
+    request += "Transfer-Encoding: chunked\r\n";
+    request += "Connection: close\r\n\r\n";
+    for (int i = 0; i < 2; ++i) {
+        request += std::string(chunkSize) + "\r\n" + chunk + "\r\n";
+    }
+    request += "0\r\n\r\n";
+    EXPECT_EQ(send(request).substr(0, 12), "HTTP/1.1 413");
+}
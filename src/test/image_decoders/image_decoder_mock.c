@@ -0,0 +1,32 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string.h>
+
+#include "../../image_decoder_interface.h"
+
+// Supports only images "RAW" followed by single byte, frame is filled with that byte
+int decodeImages(const struct ImageDecoderImage* images, int imagesCount, uint64_t height, uint64_t width, uint64_t channels, uint8_t* output, int* statuses) {
+    const uint64_t frameBytes = height * width * channels;
+    for (int i = 0; i < imagesCount; i++) {
+        if (images[i].dataBytes != 4 || memcmp(images[i].data, "RAW", 3) != 0) {
+            statuses[i] = 1;
+            continue;
+        }
+        memset(output + i * frameBytes, images[i].data[3], frameBytes);
+        statuses[i] = 0;
+    }
+    return 0;
+}
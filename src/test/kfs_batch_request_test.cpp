@@ -0,0 +1,114 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../kfs_batch_request.hpp"
+#include "../shared_memory.hpp"
+
+using namespace ovms;
+
+using tensorflow::serving::PredictRequest;
+
+namespace {
+inference::ModelInferBatchRequest prepareBatchRequest(const std::string& sharedInputsParameter) {
+    inference::ModelInferBatchRequest request;
+    auto* shared = request.add_shared_inputs();
+    shared->set_name("b");
+    shared->set_datatype("FP32");
+    shared->add_shape(1);
+    shared->add_shape(4);
+    std::vector<float> data{1, 2, 3, 4};
+    request.add_shared_raw_input_contents()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+
+    auto* inferRequest = request.add_requests();
+    inferRequest->set_model_name("dummy");
+    auto* input = inferRequest->add_inputs();
+    input->set_name("a");
+    input->set_datatype("FP32");
+    input->add_shape(1);
+    float value = 7;
+    inferRequest->add_raw_input_contents()->assign(reinterpret_cast<const char*>(&value), sizeof(value));
+    (*inferRequest->mutable_parameters())[KFSBatchRequest::SHARED_INPUTS_PARAMETER].set_string_param(sharedInputsParameter);
+    return request;
+}
+}  // namespace
+
+TEST(KFSBatchRequest, SharedInputReferencesRequestData) {
+    auto request = prepareBatchRequest(" b ");
+    auto batchRequest = std::make_unique<KFSBatchRequest>(request);
+    ASSERT_EQ(batchRequest->registerSharedInputs(), StatusCode::OK);
+    PredictRequest predictRequest;
+    ASSERT_EQ(batchRequest->convertRequest(0, predictRequest), StatusCode::OK);
+    ASSERT_EQ(predictRequest.inputs().size(), 2);
+
+    const auto& input = predictRequest.inputs().at("b");
+    ASSERT_TRUE(isSharedMemoryReference(input));
+    EXPECT_EQ(input.dtype(), tensorflow::DT_FLOAT);
+    ASSERT_EQ(input.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(input.tensor_shape().dim(1).size(), 4);
+    std::shared_ptr<SharedMemoryRegion> region;
+    char* data = nullptr;
+    ASSERT_EQ(resolveSharedMemoryReference(input, 16, region, data), StatusCode::OK);
+    EXPECT_EQ(data, request.shared_raw_input_contents(0).data());
+
+    const std::string regionName = input.resource_handle_val(0).name();
+    batchRequest.reset();
+    EXPECT_EQ(SharedMemoryRegistry::getInstance().getRegion(regionName, region), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+}
+
+TEST(KFSBatchRequest, RejectsUnknownSharedInput) {
+    auto request = prepareBatchRequest("b,c");
+    KFSBatchRequest batchRequest(request);
+    ASSERT_EQ(batchRequest.registerSharedInputs(), StatusCode::OK);
+    PredictRequest predictRequest;
+    EXPECT_EQ(batchRequest.convertRequest(0, predictRequest), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+}
+
+TEST(KFSBatchRequest, RejectsSharedInputSentByRequest) {
+    auto request = prepareBatchRequest("b");
+    request.mutable_shared_inputs(0)->set_name("a");
+    (*request.mutable_requests(0)->mutable_parameters())[KFSBatchRequest::SHARED_INPUTS_PARAMETER].set_string_param("a");
+    KFSBatchRequest batchRequest(request);
+    ASSERT_EQ(batchRequest.registerSharedInputs(), StatusCode::OK);
+    PredictRequest predictRequest;
+    EXPECT_EQ(batchRequest.convertRequest(0, predictRequest), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+}
+
+TEST(KFSBatchRequest, RejectsSharedContentNotMatchingShape) {
+    auto request = prepareBatchRequest("b");
+    request.mutable_shared_inputs(0)->set_shape(1, 5);
+    KFSBatchRequest batchRequest(request);
+    EXPECT_EQ(batchRequest.registerSharedInputs(), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+}
+
+TEST(KFSBatchRequest, ReportsFailedRequestInResponse) {
+    auto request = prepareBatchRequest("c");
+    request.mutable_requests(0)->set_id("1");
+    KFSBatchRequest batchRequest(request);
+    inference::ModelInferBatchResponse response;
+    ASSERT_EQ(batchRequest.infer(response, RequestContext()), StatusCode::OK);
+    ASSERT_EQ(response.responses_size(), 1);
+    const auto& inferResponse = response.responses(0);
+    EXPECT_EQ(inferResponse.model_name(), "dummy");
+    EXPECT_EQ(inferResponse.id(), "1");
+    EXPECT_EQ(inferResponse.outputs_size(), 0);
+    EXPECT_EQ(inferResponse.parameters().count(KFSBatchRequest::ERROR_PARAMETER), 1);
+}
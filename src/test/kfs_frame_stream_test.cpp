@@ -0,0 +1,196 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../kfs_batch_request.hpp"
+#include "../kfs_frame_stream.hpp"
+
+using namespace ovms;
+
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+namespace {
+class KFSFrameStreamTest : public ::testing::Test {
+protected:
+    struct StartedFrame {
+        const PredictRequest* request;
+        PredictResponse* response;
+        std::function<void(Status)> onCompleted;
+    };
+    std::vector<StartedFrame> started;
+
+    KFSFrameStream::infer_t infer = [this](const PredictRequest* request, PredictResponse* response, std::function<void(Status)> onCompleted) {
+        started.push_back({request, response, std::move(onCompleted)});
+    };
+
+    static void pushFrame(KFSFrameStream& stream, const std::string& id) {
+        auto& request = stream.prepareFrame();
+        request.set_model_name("dummy");
+        request.set_id(id);
+        request.clear_inputs();
+        request.clear_raw_input_contents();
+        auto* input = request.add_inputs();
+        input->set_name("b");
+        input->set_datatype("FP32");
+        input->add_shape(1);
+        float value = 1;
+        request.add_raw_input_contents()->assign(reinterpret_cast<const char*>(&value), sizeof(value));
+        stream.pushFrame();
+    }
+
+    // echoes input of the frame as output
+    void complete(size_t index, Status status = StatusCode::OK) {
+        auto& frame = started[index];
+        if (status.ok()) {
+            (*frame.response->mutable_outputs())["a"] = frame.request->inputs().at("b");
+        }
+        frame.onCompleted(status);
+    }
+};
+}  // namespace
+
+TEST(KFSFrameStreamOptions, ParsesParameters) {
+    inference::ModelInferRequest request;
+    KFSFrameStreamOptions options;
+    ASSERT_EQ(KFSFrameStreamOptions::parse(request, options), StatusCode::OK);
+    EXPECT_EQ(options.maxFramesInFlight, KFSFrameStreamOptions::DEFAULT_MAX_FRAMES_IN_FLIGHT);
+    EXPECT_EQ(options.maxQueuedFrames, KFSFrameStreamOptions::DEFAULT_MAX_QUEUED_FRAMES);
+    EXPECT_EQ(options.overloadPolicy, FrameOverloadPolicy::DROP_OLDEST);
+
+    (*request.mutable_parameters())[KFSFrameStream::MAX_FRAMES_IN_FLIGHT_PARAMETER].set_int64_param(4);
+    (*request.mutable_parameters())[KFSFrameStream::MAX_QUEUED_FRAMES_PARAMETER].set_int64_param(3);
+    (*request.mutable_parameters())[KFSFrameStream::OVERLOAD_POLICY_PARAMETER].set_string_param("block");
+    ASSERT_EQ(KFSFrameStreamOptions::parse(request, options), StatusCode::OK);
+    EXPECT_EQ(options.maxFramesInFlight, 4u);
+    EXPECT_EQ(options.maxQueuedFrames, 3u);
+    EXPECT_EQ(options.overloadPolicy, FrameOverloadPolicy::BLOCK);
+}
+
+TEST(KFSFrameStreamOptions, RejectsInvalidParameters) {
+    for (int64_t value : {0, -1, 65}) {
+        inference::ModelInferRequest request;
+        (*request.mutable_parameters())[KFSFrameStream::MAX_FRAMES_IN_FLIGHT_PARAMETER].set_int64_param(value);
+        KFSFrameStreamOptions options;
+        EXPECT_EQ(KFSFrameStreamOptions::parse(request, options), StatusCode::KFS_INVALID_STREAM_PARAMETER) << value;
+    }
+    inference::ModelInferRequest request;
+    (*request.mutable_parameters())[KFSFrameStream::MAX_QUEUED_FRAMES_PARAMETER].set_string_param("2");
+    KFSFrameStreamOptions options;
+    EXPECT_EQ(KFSFrameStreamOptions::parse(request, options), StatusCode::KFS_INVALID_STREAM_PARAMETER);
+    request.Clear();
+    (*request.mutable_parameters())[KFSFrameStream::OVERLOAD_POLICY_PARAMETER].set_string_param("drop_newest");
+    EXPECT_EQ(KFSFrameStreamOptions::parse(request, options), StatusCode::KFS_INVALID_STREAM_PARAMETER);
+}
+
+TEST_F(KFSFrameStreamTest, ReturnsResponsesInOrderOfFrames) {
+    KFSFrameStream stream(KFSFrameStreamOptions{}, infer);
+    pushFrame(stream, "1");
+    pushFrame(stream, "2");
+    ASSERT_EQ(started.size(), 2);
+    complete(1);
+    complete(0);
+    stream.close();
+
+    inference::ModelInferResponse response;
+    ASSERT_TRUE(stream.nextResponse(response));
+    EXPECT_EQ(response.id(), "1");
+    ASSERT_EQ(response.outputs_size(), 1);
+    EXPECT_EQ(response.outputs(0).name(), "a");
+    ASSERT_TRUE(stream.nextResponse(response));
+    EXPECT_EQ(response.id(), "2");
+    EXPECT_FALSE(stream.nextResponse(response));
+}
+
+TEST_F(KFSFrameStreamTest, DropsOldestWaitingFrame) {
+    KFSFrameStreamOptions options;
+    options.maxFramesInFlight = 1;
+    options.maxQueuedFrames = 1;
+    KFSFrameStream stream(options, infer);
+    pushFrame(stream, "1");
+    pushFrame(stream, "2");
+    pushFrame(stream, "3");
+    ASSERT_EQ(started.size(), 1);
+    EXPECT_EQ(stream.getDroppedFramesCount(), 1u);
+    complete(0);
+
+    inference::ModelInferResponse response;
+    ASSERT_TRUE(stream.nextResponse(response));
+    EXPECT_EQ(response.id(), "1");
+    EXPECT_EQ(response.parameters().count(KFSFrameStream::FRAME_DROPPED_PARAMETER), 0);
+    // frame is in flight until its response is taken
+    ASSERT_EQ(started.size(), 2);
+    ASSERT_TRUE(stream.nextResponse(response));
+    EXPECT_EQ(response.id(), "2");
+    EXPECT_TRUE(response.parameters().at(KFSFrameStream::FRAME_DROPPED_PARAMETER).bool_param());
+    EXPECT_EQ(response.outputs_size(), 0);
+    complete(1);
+    ASSERT_TRUE(stream.nextResponse(response));
+    EXPECT_EQ(response.id(), "3");
+    EXPECT_EQ(response.outputs_size(), 1);
+}
+
+TEST_F(KFSFrameStreamTest, FailedFrameDoesNotEndStream) {
+    KFSFrameStream stream(KFSFrameStreamOptions{}, infer);
+    pushFrame(stream, "1");
+    pushFrame(stream, "2");
+    complete(0, StatusCode::INVALID_SHAPE);
+    complete(1);
+    stream.close();
+
+    inference::ModelInferResponse response;
+    ASSERT_TRUE(stream.nextResponse(response));
+    EXPECT_EQ(response.id(), "1");
+    EXPECT_EQ(response.parameters().at(KFSBatchRequest::ERROR_PARAMETER).string_param(), Status(StatusCode::INVALID_SHAPE).string());
+    ASSERT_TRUE(stream.nextResponse(response));
+    EXPECT_EQ(response.id(), "2");
+    EXPECT_EQ(response.outputs_size(), 1);
+    EXPECT_FALSE(stream.nextResponse(response));
+}
+
+TEST_F(KFSFrameStreamTest, ReusesMessagesOfReturnedFrames) {
+    KFSFrameStream stream(KFSFrameStreamOptions{}, infer);
+    pushFrame(stream, "1");
+    const PredictRequest* firstRequest = started[0].request;
+    complete(0);
+    inference::ModelInferResponse response;
+    ASSERT_TRUE(stream.nextResponse(response));
+
+    pushFrame(stream, "2");
+    ASSERT_EQ(started.size(), 2);
+    EXPECT_EQ(started[1].request, firstRequest);
+    ASSERT_EQ(started[1].request->inputs().size(), 1);
+    EXPECT_EQ(started[1].request->inputs().at("b").tensor_content().size(), sizeof(float));
+    complete(1);
+}
+
+TEST_F(KFSFrameStreamTest, CancelDropsWaitingFrames) {
+    KFSFrameStreamOptions options;
+    options.maxFramesInFlight = 1;
+    KFSFrameStream stream(options, infer);
+    pushFrame(stream, "1");
+    pushFrame(stream, "2");
+    stream.cancel();
+    inference::ModelInferResponse response;
+    EXPECT_FALSE(stream.nextResponse(response));
+    ASSERT_EQ(started.size(), 1);
+    // stream waits for frames in flight when destroyed
+    complete(0);
+}
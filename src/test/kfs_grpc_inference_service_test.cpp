@@ -0,0 +1,315 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../kfs_chunked_request.hpp"
+#include "../kfs_grpc_inference_service.hpp"
+#include "../kfs_utils.hpp"
+#include "../shared_memory.hpp"
+#include "test_utils.hpp"
+
+using namespace ovms;
+
+using namespace testing;
+using ::testing::ElementsAre;
+
+using tensorflow::DataType;
+
+template <typename T>
+static std::string asRawContent(const std::vector<T>& values) {
+    return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+class KFSRequestConversion : public ::testing::Test {
+protected:
+    inference::ModelInferRequest request;
+    tensorflow::serving::PredictRequest predictRequest;
+
+    inference::ModelInferRequest::InferInputTensor* addInput(const std::string& name, const std::string& datatype, std::vector<int64_t> shape) {
+        auto* input = request.add_inputs();
+        input->set_name(name);
+        input->set_datatype(datatype);
+        for (auto dim : shape) {
+            input->add_shape(dim);
+        }
+        return input;
+    }
+};
+
+TEST_F(KFSRequestConversion, ConvertsRawInputContents) {
+    request.set_model_name("model");
+    request.set_model_version("2");
+    addInput("a", "FP32", {1, 2});
+    *request.add_raw_input_contents() = asRawContent(std::vector<float>{1.0, 2.0});
+    addInput("b", "UINT16", {2});
+    *request.add_raw_input_contents() = asRawContent(std::vector<uint16_t>{3, 65535});
+    addInput("c", "BYTES", {1});
+    std::string bytes(4, '\0');
+    bytes[0] = 2;
+    bytes += "xy";
+    *request.add_raw_input_contents() = bytes;
+
+    ASSERT_EQ(KFSInferenceServiceImpl::convertRequest(request, predictRequest), StatusCode::OK);
+
+    EXPECT_EQ(predictRequest.model_spec().name(), "model");
+    EXPECT_EQ(predictRequest.model_spec().version().value(), 2);
+    ASSERT_EQ(predictRequest.inputs_size(), 3);
+    const auto& a = predictRequest.inputs().at("a");
+    EXPECT_EQ(a.dtype(), DataType::DT_FLOAT);
+    EXPECT_THAT(asVector(a.tensor_shape()), ElementsAre(1, 2));
+    EXPECT_EQ(a.tensor_content(), request.raw_input_contents(0));
+    const auto& b = predictRequest.inputs().at("b");
+    EXPECT_EQ(b.dtype(), DataType::DT_UINT16);
+    EXPECT_TRUE(b.tensor_content().empty());
+    EXPECT_THAT(b.int_val(), ElementsAre(3, 65535));
+    const auto& c = predictRequest.inputs().at("c");
+    EXPECT_EQ(c.dtype(), DataType::DT_STRING);
+    EXPECT_THAT(c.string_val(), ElementsAre("xy"));
+}
+
+TEST_F(KFSRequestConversion, ConvertsTypedContents) {
+    request.set_model_name("model");
+    auto* a = addInput("a", "INT8", {3});
+    a->mutable_contents()->add_int_contents(-1);
+    a->mutable_contents()->add_int_contents(0);
+    a->mutable_contents()->add_int_contents(5);
+    auto* b = addInput("b", "FP32", {1});
+    b->mutable_contents()->add_fp32_contents(0.25);
+
+    ASSERT_EQ(KFSInferenceServiceImpl::convertRequest(request, predictRequest), StatusCode::OK);
+
+    EXPECT_FALSE(predictRequest.model_spec().has_version());
+    EXPECT_EQ(predictRequest.inputs().at("a").tensor_content(), asRawContent(std::vector<int8_t>{-1, 0, 5}));
+    EXPECT_EQ(predictRequest.inputs().at("b").tensor_content(), asRawContent(std::vector<float>{0.25}));
+}
+
+TEST_F(KFSRequestConversion, RejectsInvalidRequests) {
+    request.set_model_version("latest");
+    EXPECT_EQ(KFSInferenceServiceImpl::convertRequest(request, predictRequest), StatusCode::KFS_INVALID_MODEL_VERSION);
+
+    request.set_model_version("");
+    addInput("a", "FP32", {1});
+    addInput("b", "FP32", {1});
+    *request.add_raw_input_contents() = asRawContent(std::vector<float>{1.0});
+    EXPECT_EQ(KFSInferenceServiceImpl::convertRequest(request, predictRequest), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+
+    request.Clear();
+    addInput("a", "STRING", {1});
+    EXPECT_EQ(KFSInferenceServiceImpl::convertRequest(request, predictRequest), StatusCode::KFS_UNSUPPORTED_DATATYPE);
+
+    request.Clear();
+    addInput("a", "FP16", {1});
+    EXPECT_EQ(KFSInferenceServiceImpl::convertRequest(request, predictRequest), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+
+    request.Clear();
+    addInput("a", "BYTES", {1});
+    *request.add_raw_input_contents() = std::string("\x05\x00\x00\x00" "ab", 6);
+    EXPECT_EQ(KFSInferenceServiceImpl::convertRequest(request, predictRequest), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+}
+
+TEST(KFSResponseConversion, MovesOutputsToRawOutputContents) {
+    tensorflow::serving::PredictResponse predictResponse;
+    auto& x = (*predictResponse.mutable_outputs())["x"];
+    x.set_dtype(DataType::DT_FLOAT);
+    x.mutable_tensor_shape()->add_dim()->set_size(2);
+    *x.mutable_tensor_content() = asRawContent(std::vector<float>{1.0, 2.0});
+    // I64 outputs are serialized with DT_INT32 dtype and raw 64 bit content
+    auto& y = (*predictResponse.mutable_outputs())["y"];
+    y.set_dtype(DataType::DT_INT32);
+    y.mutable_tensor_shape()->add_dim()->set_size(1);
+    *y.mutable_tensor_content() = asRawContent(std::vector<int64_t>{1ll << 40});
+
+    inference::ModelInferRequest request;
+    request.set_model_name("model");
+    request.set_model_version("1");
+    request.set_id("id");
+    request.add_outputs()->set_name("y");
+    request.add_outputs()->set_name("x");
+    inference::ModelInferResponse response;
+
+    ASSERT_EQ(KFSInferenceServiceImpl::convertResponse(request, predictResponse, response), StatusCode::OK);
+
+    EXPECT_EQ(response.model_name(), "model");
+    EXPECT_EQ(response.model_version(), "1");
+    EXPECT_EQ(response.id(), "id");
+    ASSERT_EQ(response.outputs_size(), 2);
+    ASSERT_EQ(response.raw_output_contents_size(), 2);
+    EXPECT_EQ(response.outputs(0).name(), "y");
+    EXPECT_EQ(response.outputs(0).datatype(), "INT64");
+    EXPECT_THAT(response.outputs(0).shape(), ElementsAre(1));
+    EXPECT_EQ(response.raw_output_contents(0), asRawContent(std::vector<int64_t>{1ll << 40}));
+    EXPECT_EQ(response.outputs(1).name(), "x");
+    EXPECT_EQ(response.outputs(1).datatype(), "FP32");
+    EXPECT_EQ(response.raw_output_contents(1), asRawContent(std::vector<float>{1.0, 2.0}));
+}
+
+TEST(KFSResponseConversion, FailsWhenRequestedOutputIsMissing) {
+    tensorflow::serving::PredictResponse predictResponse;
+    inference::ModelInferRequest request;
+    request.add_outputs()->set_name("x");
+    inference::ModelInferResponse response;
+
+    EXPECT_EQ(KFSInferenceServiceImpl::convertResponse(request, predictResponse, response), StatusCode::INVALID_MISSING_OUTPUT);
+}
+
+TEST(KFSResponseConversion, ConvertsPartialResponseWithRequestedOutputsOnly) {
+    tensorflow::serving::PredictResponse partialResponse;
+    auto& x = (*partialResponse.mutable_outputs())["x"];
+    x.set_dtype(DataType::DT_FLOAT);
+    x.mutable_tensor_shape()->add_dim()->set_size(1);
+    *x.mutable_tensor_content() = asRawContent(std::vector<float>{1.0});
+    auto& z = (*partialResponse.mutable_outputs())["z"];
+    z.set_dtype(DataType::DT_FLOAT);
+    z.mutable_tensor_shape()->add_dim()->set_size(1);
+    *z.mutable_tensor_content() = asRawContent(std::vector<float>{2.0});
+
+    inference::ModelInferRequest request;
+    request.set_model_name("pipeline");
+    request.add_outputs()->set_name("x");
+    request.add_outputs()->set_name("y");
+    inference::ModelInferResponse response;
+
+    ASSERT_EQ(KFSInferenceServiceImpl::convertPartialResponse(request, "node", 3, partialResponse, response), StatusCode::OK);
+
+    EXPECT_EQ(response.model_name(), "pipeline");
+    EXPECT_EQ(response.parameters().at("node_name").string_param(), "node");
+    EXPECT_EQ(response.parameters().at("shard_id").int64_param(), 3);
+    ASSERT_EQ(response.outputs_size(), 1);
+    EXPECT_EQ(response.outputs(0).name(), "x");
+    EXPECT_EQ(response.raw_output_contents(0), asRawContent(std::vector<float>{1.0}));
+}
+
+TEST(KFSSequenceStream, ReadsSequenceParameters) {
+    inference::ModelInferRequest request;
+    uint64_t sequenceId = 0;
+    bool sequenceEnd = true;
+    ASSERT_EQ(KFSInferenceServiceImpl::getSequenceParameters(request, sequenceId, sequenceEnd), StatusCode::OK);
+    EXPECT_EQ(sequenceId, 0);
+    EXPECT_FALSE(sequenceEnd);
+
+    (*request.mutable_parameters())["sequence_id"].set_int64_param(12);
+    (*request.mutable_parameters())["sequence_end"].set_bool_param(true);
+    ASSERT_EQ(KFSInferenceServiceImpl::getSequenceParameters(request, sequenceId, sequenceEnd), StatusCode::OK);
+    EXPECT_EQ(sequenceId, 12);
+    EXPECT_TRUE(sequenceEnd);
+
+    (*request.mutable_parameters())["sequence_end"].set_int64_param(1);
+    EXPECT_EQ(KFSInferenceServiceImpl::getSequenceParameters(request, sequenceId, sequenceEnd), StatusCode::SEQUENCE_CONTROL_INPUT_BAD_TYPE);
+    (*request.mutable_parameters())["sequence_id"].set_string_param("12");
+    EXPECT_EQ(KFSInferenceServiceImpl::getSequenceParameters(request, sequenceId, sequenceEnd), StatusCode::SEQUENCE_ID_BAD_TYPE);
+}
+
+static void addChunkData(inference::ModelInferRequest& chunk, const std::string& name, const std::string& data) {
+    chunk.add_inputs()->set_name(name);
+    *chunk.add_raw_input_contents() = data;
+}
+
+TEST_F(KFSRequestConversion, AssemblesChunkedRequest) {
+    request.set_model_name("model");
+    addInput("a", "FP32", {2, 2});
+    addInput("b", "FP16", {1});
+    const std::string data = asRawContent(std::vector<float>{1.0, 2.0, 3.0, 4.0});
+    *request.add_raw_input_contents() = data.substr(0, 4);
+    *request.add_raw_input_contents() = "";
+
+    KFSChunkedRequest chunkedRequest;
+    ASSERT_EQ(chunkedRequest.addChunk(request), StatusCode::OK);
+    EXPECT_FALSE(chunkedRequest.isComplete());
+    EXPECT_EQ(chunkedRequest.getHeader().raw_input_contents_size(), 0);
+    inference::ModelInferRequest chunk;
+    addChunkData(chunk, "a", data.substr(4, 8));
+    addChunkData(chunk, "b", std::string(2, 0));
+    ASSERT_EQ(chunkedRequest.addChunk(chunk), StatusCode::OK);
+    EXPECT_FALSE(chunkedRequest.isComplete());
+    EXPECT_EQ(chunkedRequest.complete(predictRequest), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+    chunk.Clear();
+    addChunkData(chunk, "a", data.substr(12));
+    ASSERT_EQ(chunkedRequest.addChunk(chunk), StatusCode::OK);
+    ASSERT_TRUE(chunkedRequest.isComplete());
+
+    ASSERT_EQ(chunkedRequest.complete(predictRequest), StatusCode::OK);
+    EXPECT_EQ(predictRequest.model_spec().name(), "model");
+    const auto& tensor = predictRequest.inputs().at("a");
+    EXPECT_EQ(tensor.dtype(), DataType::DT_FLOAT);
+    ASSERT_TRUE(isSharedMemoryReference(tensor));
+    std::shared_ptr<SharedMemoryRegion> region;
+    char* tensorData = nullptr;
+    ASSERT_EQ(resolveSharedMemoryReference(tensor, data.size(), region, tensorData), StatusCode::OK);
+    EXPECT_EQ(std::string(tensorData, data.size()), data);
+    EXPECT_TRUE(isSharedMemoryReference(predictRequest.inputs().at("b")));
+}
+
+TEST_F(KFSRequestConversion, RejectsInvalidChunks) {
+    addInput("a", "FP32", {2});
+    inference::ModelInferRequest chunk;
+    addChunkData(chunk, "a", std::string(12, 0));
+    {
+        KFSChunkedRequest chunkedRequest;
+        ASSERT_EQ(chunkedRequest.addChunk(request), StatusCode::OK);
+        EXPECT_EQ(chunkedRequest.addChunk(chunk), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+    }
+    chunk.Clear();
+    addChunkData(chunk, "c", std::string(4, 0));
+    {
+        KFSChunkedRequest chunkedRequest;
+        ASSERT_EQ(chunkedRequest.addChunk(request), StatusCode::OK);
+        EXPECT_EQ(chunkedRequest.addChunk(chunk), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+    }
+    addInput("s", "BYTES", {1});
+    {
+        KFSChunkedRequest chunkedRequest;
+        EXPECT_EQ(chunkedRequest.addChunk(request), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+    }
+}
+
+TEST(KFSUtils, ResolvesDataTypeOfSerializedOutputs) {
+    tensorflow::TensorProto tensor;
+    tensor.mutable_tensor_shape()->add_dim()->set_size(4);
+    std::string datatype;
+
+    tensor.set_dtype(DataType::DT_UINT8);
+    tensor.mutable_tensor_content()->resize(4);
+    ASSERT_EQ(getKFSDataType(tensor, datatype), StatusCode::OK);
+    EXPECT_EQ(datatype, "UINT8");
+
+    tensor.set_dtype(DataType::DT_UINT32);
+    tensor.mutable_tensor_content()->resize(8);
+    ASSERT_EQ(getKFSDataType(tensor, datatype), StatusCode::OK);
+    EXPECT_EQ(datatype, "UINT16");
+
+    tensor.set_dtype(DataType::DT_FLOAT);
+    tensor.mutable_tensor_content()->resize(3);
+    EXPECT_EQ(getKFSDataType(tensor, datatype), StatusCode::REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE);
+
+    tensor.set_dtype(DataType::DT_STRING);
+    EXPECT_EQ(getKFSDataType(tensor, datatype), StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION);
+}
+
+TEST(KFSUtils, ParsesModelVersion) {
+    model_version_t version;
+    ASSERT_EQ(parseKFSModelVersion("", version), StatusCode::OK);
+    EXPECT_EQ(version, 0);
+    ASSERT_EQ(parseKFSModelVersion("12", version), StatusCode::OK);
+    EXPECT_EQ(version, 12);
+    EXPECT_EQ(parseKFSModelVersion("-1", version), StatusCode::KFS_INVALID_MODEL_VERSION);
+    EXPECT_EQ(parseKFSModelVersion("99999999999999999999", version), StatusCode::KFS_INVALID_MODEL_VERSION);
+}
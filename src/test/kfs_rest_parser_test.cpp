@@ -0,0 +1,205 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include "../kfs_rest_parser.hpp"
+#include "test_utils.hpp"
+
+using namespace ovms;
+
+using namespace testing;
+using ::testing::ElementsAre;
+
+using tensorflow::DataType;
+
+template <typename T>
+static std::vector<T> contentAsVector(const std::string& content) {
+    std::vector<T> values(content.size() / sizeof(T));
+    std::memcpy(values.data(), content.data(), values.size() * sizeof(T));
+    return values;
+}
+
+TEST(KFSRestParser, ParsesJsonDataOfInputs) {
+    KFSRestParser parser;
+    auto status = parser.parse(R"({
+        "id": "request-1",
+        "inputs": [
+            {"name": "a", "datatype": "FP32", "shape": [1, 2, 2], "data": [[1.0, 2.0], [3.0, 4.5]]},
+            {"name": "b", "datatype": "UINT16", "shape": [2], "data": [1, 65535]},
+            {"name": "c", "datatype": "INT8", "shape": [3], "data": [-128, 0, 127]}
+        ]
+    })");
+
+    ASSERT_EQ(status, StatusCode::OK);
+    EXPECT_EQ(parser.getId(), "request-1");
+    ASSERT_EQ(parser.getProto().inputs_size(), 3);
+    const auto& a = parser.getProto().inputs().at("a");
+    EXPECT_EQ(a.dtype(), DataType::DT_FLOAT);
+    EXPECT_THAT(asVector(a.tensor_shape()), ElementsAre(1, 2, 2));
+    EXPECT_THAT(contentAsVector<float>(a.tensor_content()), ElementsAre(1.0, 2.0, 3.0, 4.5));
+    const auto& b = parser.getProto().inputs().at("b");
+    EXPECT_EQ(b.dtype(), DataType::DT_UINT16);
+    EXPECT_THAT(b.int_val(), ElementsAre(1, 65535));
+    const auto& c = parser.getProto().inputs().at("c");
+    EXPECT_THAT(contentAsVector<int8_t>(c.tensor_content()), ElementsAre(-128, 0, 127));
+    EXPECT_TRUE(parser.getRequestedOutputs().empty());
+}
+
+TEST(KFSRestParser, ParsesBinaryDataFollowingJsonHeader) {
+    const std::string header = R"({
+        "parameters": {"binary_data_output": true},
+        "inputs": [
+            {"name": "a", "datatype": "FP32", "shape": [2], "parameters": {"binary_data_size": 8}},
+            {"name": "b", "datatype": "INT32", "shape": [1], "data": [7]},
+            {"name": "c", "datatype": "UINT8", "shape": [3], "parameters": {"binary_data_size": 3}}
+        ],
+        "outputs": [
+            {"name": "x"},
+            {"name": "y", "parameters": {"binary_data": false}}
+        ]
+    })";
+    std::vector<float> a{1.5, -2.0};
+    std::string body = header;
+    body.append(reinterpret_cast<const char*>(a.data()), a.size() * sizeof(float));
+    body.append("\x00\x01\xff", 3);
+
+    KFSRestParser parser;
+    auto status = parser.parse(body);
+
+    ASSERT_EQ(status, StatusCode::OK);
+    EXPECT_THAT(contentAsVector<float>(parser.getProto().inputs().at("a").tensor_content()), ElementsAre(1.5, -2.0));
+    EXPECT_THAT(contentAsVector<int32_t>(parser.getProto().inputs().at("b").tensor_content()), ElementsAre(7));
+    EXPECT_THAT(contentAsVector<uint8_t>(parser.getProto().inputs().at("c").tensor_content()), ElementsAre(0, 1, 255));
+    EXPECT_TRUE(parser.areBinaryOutputsByDefault());
+    EXPECT_THAT(parser.getRequestedOutputs(), ElementsAre(std::make_pair(std::string("x"), true), std::make_pair(std::string("y"), false)));
+}
+
+TEST(KFSRestParser, ParsesBinaryBytesInput) {
+    std::string body = R"({"inputs": [{"name": "image", "datatype": "BYTES", "shape": [2], "parameters": {"binary_data_size": 11}}]})";
+    const uint32_t firstLength = 3;
+    const uint32_t secondLength = 0;
+    body.append(reinterpret_cast<const char*>(&firstLength), sizeof(firstLength));
+    body.append("abc");
+    body.append(reinterpret_cast<const char*>(&secondLength), sizeof(secondLength));
+
+    KFSRestParser parser;
+    ASSERT_EQ(parser.parse(body), StatusCode::OK);
+    const auto& image = parser.getProto().inputs().at("image");
+    EXPECT_EQ(image.dtype(), DataType::DT_STRING);
+    EXPECT_THAT(image.string_val(), ElementsAre("abc", ""));
+}
+
+TEST(KFSRestParser, RejectsInvalidRequests) {
+    KFSRestParser parser;
+    EXPECT_EQ(parser.parse(R"({"inputs": )"), StatusCode::JSON_INVALID);
+    EXPECT_EQ(KFSRestParser().parse(R"([])"), StatusCode::REST_BODY_IS_NOT_AN_OBJECT);
+    EXPECT_EQ(KFSRestParser().parse(R"({})"), StatusCode::REST_NO_INPUTS_FOUND);
+    EXPECT_EQ(KFSRestParser().parse(R"({"inputs": [{"name": "a", "datatype": "FP8", "shape": [1], "data": [1]}]})"), StatusCode::KFS_UNSUPPORTED_DATATYPE);
+    EXPECT_EQ(KFSRestParser().parse(R"({"inputs": [{"name": "a", "datatype": "FP32", "shape": [1]}]})"), StatusCode::KFS_INVALID_INPUT_CONTENTS);
+    EXPECT_EQ(KFSRestParser().parse(R"({"inputs": [{"name": "a", "datatype": "FP32", "shape": [-1], "data": [1]}]})"), StatusCode::INVALID_SHAPE);
+    EXPECT_EQ(KFSRestParser().parse(R"({"inputs": [{"name": "a", "datatype": "INT8", "shape": [1], "data": [128]}]})"), StatusCode::REST_COULD_NOT_PARSE_INPUT);
+    EXPECT_EQ(KFSRestParser().parse(R"({"inputs": [{"name": "a", "datatype": "FP32", "shape": [1], "data": ["a"]}]})"), StatusCode::REST_COULD_NOT_PARSE_INPUT);
+    EXPECT_EQ(KFSRestParser().parse(std::string(R"({"inputs": [{"name": "a", "datatype": "FP32", "shape": [1], "parameters": {"binary_data_size": 4}}]})") + "ab"),
+        StatusCode::KFS_INVALID_INPUT_CONTENTS);
+    EXPECT_EQ(KFSRestParser().parse(std::string(R"({"inputs": [{"name": "a", "datatype": "INT32", "shape": [1], "data": [1]}]})") + "trailing"),
+        StatusCode::KFS_INVALID_INPUT_CONTENTS);
+}
+
+class KFSRestResponse : public ::testing::Test {
+protected:
+    tensorflow::serving::PredictResponse responseProto;
+
+    void SetUp() override {
+        auto& x = (*responseProto.mutable_outputs())["x"];
+        x.set_dtype(DataType::DT_FLOAT);
+        x.mutable_tensor_shape()->add_dim()->set_size(1);
+        x.mutable_tensor_shape()->add_dim()->set_size(2);
+        std::vector<float> xData{0.5, 3.0};
+        x.mutable_tensor_content()->assign(reinterpret_cast<const char*>(xData.data()), xData.size() * sizeof(float));
+
+        // FP16 outputs are serialized with DT_FLOAT dtype and raw half precision content
+        auto& y = (*responseProto.mutable_outputs())["y"];
+        y.set_dtype(DataType::DT_FLOAT);
+        y.mutable_tensor_shape()->add_dim()->set_size(2);
+        std::vector<uint16_t> yData{0x3c00, 0xc000};
+        y.mutable_tensor_content()->assign(reinterpret_cast<const char*>(yData.data()), yData.size() * sizeof(uint16_t));
+    }
+};
+
+TEST_F(KFSRestResponse, WritesBinaryAndJsonOutputs) {
+    KFSRestParser parser;
+    ASSERT_EQ(parser.parse(R"({
+        "id": "abc",
+        "inputs": [{"name": "a", "datatype": "FP32", "shape": [1], "data": [1]}],
+        "outputs": [{"name": "x", "parameters": {"binary_data": true}}, {"name": "y"}]
+    })"),
+        StatusCode::OK);
+
+    std::string response;
+    size_t headerLength = 0;
+    ASSERT_EQ(makeKFSRestResponse(parser, responseProto, "model", "1", response, headerLength), StatusCode::OK);
+
+    ASSERT_GT(headerLength, 0);
+    ASSERT_EQ(response.size(), headerLength + 2 * sizeof(float));
+    rapidjson::Document doc;
+    ASSERT_FALSE(doc.Parse(response.data(), headerLength).HasParseError());
+    EXPECT_STREQ(doc["model_name"].GetString(), "model");
+    EXPECT_STREQ(doc["model_version"].GetString(), "1");
+    EXPECT_STREQ(doc["id"].GetString(), "abc");
+    const auto& outputs = doc["outputs"];
+    ASSERT_EQ(outputs.Size(), 2);
+    EXPECT_STREQ(outputs[0]["name"].GetString(), "x");
+    EXPECT_STREQ(outputs[0]["datatype"].GetString(), "FP32");
+    EXPECT_EQ(outputs[0]["shape"].Size(), 2);
+    EXPECT_EQ(outputs[0]["parameters"]["binary_data_size"].GetUint64(), 8);
+    EXPECT_FALSE(outputs[0].HasMember("data"));
+    EXPECT_STREQ(outputs[1]["name"].GetString(), "y");
+    EXPECT_STREQ(outputs[1]["datatype"].GetString(), "FP16");
+    ASSERT_EQ(outputs[1]["data"].Size(), 2);
+    EXPECT_EQ(outputs[1]["data"][0].GetDouble(), 1.0);
+    EXPECT_EQ(outputs[1]["data"][1].GetDouble(), -2.0);
+    EXPECT_THAT(contentAsVector<float>(response.substr(headerLength)), ElementsAre(0.5, 3.0));
+}
+
+TEST_F(KFSRestResponse, WritesAllOutputsAsJsonByDefault) {
+    KFSRestParser parser;
+    ASSERT_EQ(parser.parse(R"({"inputs": [{"name": "a", "datatype": "FP32", "shape": [1], "data": [1]}]})"), StatusCode::OK);
+
+    std::string response;
+    size_t headerLength = 0;
+    ASSERT_EQ(makeKFSRestResponse(parser, responseProto, "model", "", response, headerLength), StatusCode::OK);
+
+    EXPECT_EQ(headerLength, 0);
+    rapidjson::Document doc;
+    ASSERT_FALSE(doc.Parse(response.c_str()).HasParseError());
+    EXPECT_FALSE(doc.HasMember("id"));
+    EXPECT_EQ(doc["outputs"].Size(), 2);
+}
+
+TEST_F(KFSRestResponse, FailsWhenRequestedOutputIsMissing) {
+    KFSRestParser parser;
+    ASSERT_EQ(parser.parse(R"({"inputs": [{"name": "a", "datatype": "FP32", "shape": [1], "data": [1]}], "outputs": [{"name": "z"}]})"), StatusCode::OK);
+
+    std::string response;
+    size_t headerLength = 0;
+    EXPECT_EQ(makeKFSRestResponse(parser, responseProto, "model", "", response, headerLength), StatusCode::INVALID_MISSING_OUTPUT);
+}
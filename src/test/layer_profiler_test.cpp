@@ -0,0 +1,60 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../layer_profiler.hpp"
+
+using namespace ovms;
+
+namespace {
+InferenceEngine::InferenceEngineProfileInfo makeProfileInfo(InferenceEngine::InferenceEngineProfileInfo::LayerStatus status,
+    long long realTimeUs, long long cpuTimeUs, const char* layerType) {
+    InferenceEngine::InferenceEngineProfileInfo info{};
+    info.status = status;
+    info.realTime_uSec = realTimeUs;
+    info.cpu_uSec = cpuTimeUs;
+    std::strncpy(info.layer_type, layerType, sizeof(info.layer_type) - 1);
+    std::strncpy(info.exec_type, "jit_avx2_FP32", sizeof(info.exec_type) - 1);
+    return info;
+}
+}  // namespace
+
+TEST(LayerTimings, SumsExecutedLayersOrderedByRealTime) {
+    LayerTimings timings;
+    std::map<std::string, InferenceEngine::InferenceEngineProfileInfo> counts{
+        {"conv", makeProfileInfo(InferenceEngine::InferenceEngineProfileInfo::EXECUTED, 300, 280, "Convolution")},
+        {"relu", makeProfileInfo(InferenceEngine::InferenceEngineProfileInfo::OPTIMIZED_OUT, 0, 0, "ReLU")},
+        {"add", makeProfileInfo(InferenceEngine::InferenceEngineProfileInfo::EXECUTED, 500, 450, "Eltwise")}};
+    timings.record(counts);
+    counts["add"].realTime_uSec = 50;
+    timings.record(counts);
+
+    EXPECT_EQ(timings.getSamples(), 2);
+    auto layers = timings.getLayers();
+    ASSERT_EQ(layers.size(), 2);
+    EXPECT_EQ(layers[0].first, "conv");
+    EXPECT_EQ(layers[0].second.layerType, "Convolution");
+    EXPECT_EQ(layers[0].second.execType, "jit_avx2_FP32");
+    EXPECT_EQ(layers[0].second.executions, 2);
+    EXPECT_EQ(layers[0].second.realTimeUs, 600);
+    EXPECT_EQ(layers[0].second.cpuTimeUs, 560);
+    EXPECT_EQ(layers[1].first, "add");
+    EXPECT_EQ(layers[1].second.realTimeUs, 550);
+}
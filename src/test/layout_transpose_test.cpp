@@ -0,0 +1,77 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../layout_transpose.hpp"
+
+using namespace ovms;
+using InferenceEngine::Layout;
+using InferenceEngine::Precision;
+
+namespace {
+template <typename T>
+void checkTranspose(Precision precision, size_t batch, size_t channels, size_t height, size_t width) {
+    std::vector<T> nhwc(batch * channels * height * width);
+    for (size_t i = 0; i < nhwc.size(); i++) {
+        nhwc[i] = static_cast<T>(i % 251);
+    }
+    std::vector<T> nchw(nhwc.size());
+    const InferenceEngine::SizeVector dims{batch, channels, height, width};
+    ASSERT_TRUE(transposeLayout(precision, dims, Layout::NHWC, nhwc.data(), Layout::NCHW, nchw.data()));
+    for (size_t n = 0; n < batch; n++) {
+        for (size_t c = 0; c < channels; c++) {
+            for (size_t h = 0; h < height; h++) {
+                for (size_t w = 0; w < width; w++) {
+                    ASSERT_EQ(nchw[((n * channels + c) * height + h) * width + w], nhwc[((n * height + h) * width + w) * channels + c])
+                        << "n: " << n << " c: " << c << " h: " << h << " w: " << w;
+                }
+            }
+        }
+    }
+    std::vector<T> back(nhwc.size());
+    ASSERT_TRUE(transposeLayout(precision, dims, Layout::NCHW, nchw.data(), Layout::NHWC, back.data()));
+    EXPECT_EQ(back, nhwc);
+}
+}  // namespace
+
+TEST(LayoutTranspose, FP32) {
+    // 3 channels with pixel counts not divisible by vector width exercise both vectorized and scalar paths
+    for (size_t channels : {1, 3, 4, 64}) {
+        for (size_t width : {1, 7, 40}) {
+            checkTranspose<float>(Precision::FP32, 2, channels, 5, width);
+        }
+    }
+}
+
+TEST(LayoutTranspose, U8) {
+    for (size_t channels : {1, 3, 4, 64}) {
+        for (size_t width : {1, 7, 40}) {
+            checkTranspose<uint8_t>(Precision::U8, 2, channels, 5, width);
+        }
+    }
+}
+
+TEST(LayoutTranspose, Unsupported) {
+    std::vector<int32_t> source(24), destination(24);
+    EXPECT_FALSE(isLayoutTransposeSupported(Precision::I32, Layout::NHWC, Layout::NCHW));
+    EXPECT_FALSE(isLayoutTransposeSupported(Precision::FP32, Layout::NCHW, Layout::NCHW));
+    EXPECT_FALSE(isLayoutTransposeSupported(Precision::FP32, Layout::NDHWC, Layout::NCDHW));
+    EXPECT_FALSE(transposeLayout(Precision::I32, {1, 3, 2, 4}, Layout::NHWC, source.data(), Layout::NCHW, destination.data()));
+    EXPECT_FALSE(transposeLayout(Precision::FP32, {3, 2, 4}, Layout::NHWC, source.data(), Layout::NCHW, destination.data()));
+}
@@ -14,9 +14,11 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -158,3 +160,25 @@ TEST(FileSystem, CreateTempFolder) {
     EXPECT_TRUE((p & fs::perms::others_read) == fs::perms::none);
     EXPECT_TRUE((p & fs::perms::owner_read) != fs::perms::none);
 }
+
+TEST(FileSystem, RunConcurrentlyRunsAllTasks) {
+    std::vector<std::atomic<int>> runs(100);
+    auto status = ovms::FileSystem::runConcurrently(runs.size(), 8, [&runs](size_t i) {
+        runs[i]++;
+        return ovms::StatusCode::OK;
+    });
+    EXPECT_EQ(status, ovms::StatusCode::OK);
+    for (auto& count : runs) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(FileSystem, RunConcurrentlyReturnsFirstFailure) {
+    std::atomic<size_t> started{0};
+    auto status = ovms::FileSystem::runConcurrently(1000, 4, [&started](size_t i) {
+        started++;
+        return i == 10 ? ovms::StatusCode::PATH_INVALID : ovms::StatusCode::OK;
+    });
+    EXPECT_EQ(status, ovms::StatusCode::PATH_INVALID);
+    EXPECT_LT(started, 1000);
+}
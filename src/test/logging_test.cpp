@@ -0,0 +1,127 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include "../logging.hpp"
+#include "../rate_limited_sink.hpp"
+
+using namespace ovms;
+
+namespace {
+class CollectingSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::vector<std::string> messages;
+    std::vector<spdlog::level::level_enum> levels;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        messages.emplace_back(msg.payload.data(), msg.payload.size());
+        levels.push_back(msg.level);
+    }
+    void flush_() override {}
+};
+
+spdlog::details::log_msg prepareMessage(spdlog::level::level_enum level, std::chrono::system_clock::time_point time) {
+    spdlog::details::log_msg msg("test", level, "message");
+    msg.time = time;
+    return msg;
+}
+
+class LogLevelToggle : public ::testing::Test {
+protected:
+    void SetUp() override {
+        configure_logger("WARNING", "");
+    }
+    void TearDown() override {
+        // restore level set by test environment
+        configure_logger("DEBUG", "");
+    }
+};
+}  // namespace
+
+TEST(RateLimitedSink, MessagesOverLimitAreDroppedAndCountedInNextSecond) {
+    auto collecting = std::make_shared<CollectingSink>();
+    RateLimitedSink sink(2);
+    sink.add_sink(collecting);
+    const auto second = std::chrono::system_clock::time_point(std::chrono::seconds(1000));
+    for (int i = 0; i < 5; ++i) {
+        sink.log(prepareMessage(spdlog::level::info, second));
+    }
+    EXPECT_EQ(collecting->messages.size(), 2u);
+
+    sink.log(prepareMessage(spdlog::level::debug, second + std::chrono::seconds(1)));
+    ASSERT_EQ(collecting->messages.size(), 4u);
+    EXPECT_EQ(collecting->messages[2], "3 log messages dropped by log_rate_limit");
+    EXPECT_EQ(collecting->levels[2], spdlog::level::warn);
+    EXPECT_EQ(collecting->messages[3], "message");
+
+    // summary is logged only once
+    sink.log(prepareMessage(spdlog::level::info, second + std::chrono::seconds(2)));
+    EXPECT_EQ(collecting->messages.size(), 5u);
+}
+
+TEST(RateLimitedSink, WarningsAreNotLimited) {
+    auto collecting = std::make_shared<CollectingSink>();
+    RateLimitedSink sink(1);
+    sink.add_sink(collecting);
+    const auto second = std::chrono::system_clock::time_point(std::chrono::seconds(1000));
+    sink.log(prepareMessage(spdlog::level::info, second));
+    for (int i = 0; i < 3; ++i) {
+        sink.log(prepareMessage(spdlog::level::warn, second));
+        sink.log(prepareMessage(spdlog::level::err, second));
+    }
+    EXPECT_EQ(collecting->messages.size(), 7u);
+
+    sink.log(prepareMessage(spdlog::level::info, second + std::chrono::seconds(1)));
+    EXPECT_EQ(collecting->messages.size(), 8u);
+}
+
+TEST_F(LogLevelToggle, SwitchesBetweenDebugAndConfiguredLevel) {
+    EXPECT_EQ(modelmanager_logger->level(), spdlog::level::warn);
+    toggle_debug_log_level();
+    EXPECT_EQ(modelmanager_logger->level(), spdlog::level::debug);
+    EXPECT_EQ(spdlog::default_logger()->level(), spdlog::level::debug);
+    toggle_debug_log_level();
+    EXPECT_EQ(modelmanager_logger->level(), spdlog::level::warn);
+    EXPECT_EQ(spdlog::default_logger()->level(), spdlog::level::warn);
+}
+
+TEST_F(LogLevelToggle, SignalRequestsToggle) {
+    EXPECT_FALSE(apply_debug_log_level_toggle_request());
+    struct sigaction handler = {};
+    struct sigaction previous = {};
+    handler.sa_handler = on_debug_log_level_toggle_signal;
+    sigemptyset(&handler.sa_mask);
+    ASSERT_EQ(sigaction(SIGUSR1, &handler, &previous), 0);
+    raise(SIGUSR1);
+    sigaction(SIGUSR1, &previous, nullptr);
+
+    // level is switched only when request is applied, outside of signal handler
+    EXPECT_EQ(dag_executor_logger->level(), spdlog::level::warn);
+    EXPECT_TRUE(apply_debug_log_level_toggle_request());
+    EXPECT_EQ(dag_executor_logger->level(), spdlog::level::debug);
+    EXPECT_FALSE(apply_debug_log_level_toggle_request());
+    toggle_debug_log_level();
+    EXPECT_EQ(dag_executor_logger->level(), spdlog::level::warn);
+}
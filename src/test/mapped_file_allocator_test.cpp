@@ -0,0 +1,101 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "../mapped_file_allocator.hpp"
+#include "../ov_utils.hpp"
+#include "test_utils.hpp"
+
+using ovms::MappedFile;
+using ovms::MappedFileAllocator;
+
+class MappedFileTest : public TestWithTempDir {
+protected:
+    std::string writeFile(const std::string& name, const std::string& content) {
+        auto path = directoryPath + "/" + name;
+        std::ofstream file(path, std::ios::binary);
+        file << content;
+        return path;
+    }
+};
+
+TEST_F(MappedFileTest, MapsFileContent) {
+    auto path = writeFile("weights.bin", "weights");
+    auto file = MappedFile::open(path);
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(file->getSize(), 7);
+    EXPECT_EQ(std::memcmp(file->getData(), "weights", 7), 0);
+}
+
+TEST_F(MappedFileTest, SharesMappingOfUnchangedFile) {
+    auto path = writeFile("weights.bin", "weights");
+    auto first = MappedFile::open(path);
+    auto second = MappedFile::open(path);
+    EXPECT_EQ(first, second);
+
+    writeFile("weights.bin", "changed weights");
+    auto changed = MappedFile::open(path);
+    ASSERT_NE(changed, nullptr);
+    EXPECT_NE(changed, first);
+    EXPECT_EQ(changed->getSize(), 15);
+}
+
+TEST_F(MappedFileTest, WritesDoNotModifyFile) {
+    auto path = writeFile("weights.bin", "weights");
+    auto file = MappedFile::open(path);
+    ASSERT_NE(file, nullptr);
+    static_cast<char*>(file->getData())[0] = 'W';
+    file.reset();
+    std::ifstream stream(path);
+    std::string content;
+    stream >> content;
+    EXPECT_EQ(content, "weights");
+}
+
+TEST_F(MappedFileTest, FailsForMissingAndEmptyFiles) {
+    EXPECT_EQ(MappedFile::open(directoryPath + "/missing.bin"), nullptr);
+    EXPECT_EQ(MappedFile::open(writeFile("empty.bin", "")), nullptr);
+}
+
+TEST_F(MappedFileTest, MapsFileDescriptor) {
+    auto path = writeFile("weights.bin", "weights");
+    int fd = ::open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    auto file = MappedFile::map(fd);
+    ::close(fd);
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(file->getSize(), 7);
+    EXPECT_EQ(std::memcmp(file->getData(), "weights", 7), 0);
+    EXPECT_EQ(MappedFile::map(-1), nullptr);
+}
+
+TEST_F(MappedFileTest, BlobUsesMappedMemory) {
+    auto file = MappedFile::open(writeFile("weights.bin", "weights"));
+    ASSERT_NE(file, nullptr);
+    InferenceEngine::Blob::Ptr blob;
+    auto status = ovms::createSharedBlob(blob,
+        InferenceEngine::TensorDesc(InferenceEngine::Precision::U8, {file->getSize()}, InferenceEngine::Layout::C),
+        std::make_shared<MappedFileAllocator>(file));
+    ASSERT_TRUE(status.ok());
+    EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<void*>(), file->getData());
+}
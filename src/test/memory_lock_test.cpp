@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "../memory_lock.hpp"
+
+using namespace ovms;
+
+namespace {
+class MappedPages {
+public:
+    const size_t size;
+    char* data;
+
+    explicit MappedPages(size_t pages) :
+        size(pages * MemoryLock::getPageSize()),
+        data(static_cast<char*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0))) {}
+    ~MappedPages() {
+        munmap(data, size);
+    }
+};
+
+class MemoryLockLimit {
+    struct rlimit original;
+
+public:
+    explicit MemoryLockLimit(rlim_t limit) {
+        getrlimit(RLIMIT_MEMLOCK, &original);
+        struct rlimit lowered = original;
+        lowered.rlim_cur = limit;
+        setrlimit(RLIMIT_MEMLOCK, &lowered);
+    }
+    ~MemoryLockLimit() {
+        setrlimit(RLIMIT_MEMLOCK, &original);
+    }
+};
+}  // namespace
+
+TEST(MemoryLock, SubtractsSortedRanges) {
+    std::vector<MemoryRange> ranges{{0, 100}, {200, 300}, {400, 500}};
+    std::vector<MemoryRange> subtracted{{50, 60}, {70, 250}, {450, 600}};
+    std::vector<MemoryRange> expected{{0, 50}, {60, 70}, {250, 300}, {400, 450}};
+    EXPECT_EQ(subtractRanges(ranges, subtracted), expected);
+    EXPECT_EQ(subtractRanges(ranges, {}), ranges);
+    EXPECT_TRUE(subtractRanges({{10, 20}}, {{0, 100}}).empty());
+}
+
+TEST(MemoryLock, FindsNewMappings) {
+    auto before = getMappedMemory();
+    MappedPages pages(4);
+    ASSERT_NE(pages.data, MAP_FAILED);
+    auto added = subtractRanges(getMappedMemory(), before);
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(pages.data);
+    bool found = false;
+    for (const auto& range : added) {
+        found |= range.begin <= begin && begin + pages.size <= range.end;
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(MemoryLock, LocksWholePagesOnce) {
+    const size_t pageSize = MemoryLock::getPageSize();
+    MappedPages pages(4);
+    ASSERT_NE(pages.data, MAP_FAILED);
+    MemoryLock lock;
+    if (!lock.lock(pages.data, 2 * pageSize)) {
+        GTEST_SKIP() << "RLIMIT_MEMLOCK does not allow locking 2 pages";
+    }
+    EXPECT_EQ(lock.getLockedBytes(), 2 * pageSize);
+    // range is rounded inwards, only the third page is not locked yet
+    EXPECT_TRUE(lock.lock(pages.data + pageSize + 1, 2 * pageSize));
+    EXPECT_EQ(lock.getLockedBytes(), 3 * pageSize);
+    EXPECT_TRUE(lock.lock(pages.data + 1, pageSize));
+    EXPECT_EQ(lock.getLockedBytes(), 3 * pageSize);
+    EXPECT_EQ(lock.getPrefaultedBytes(), 0);
+    EXPECT_EQ(lock.getLockError(), 0);
+}
+
+TEST(MemoryLock, PrefaultsWhenLimitIsInsufficient) {
+    const size_t pageSize = MemoryLock::getPageSize();
+    MappedPages pages(4);
+    ASSERT_NE(pages.data, MAP_FAILED);
+    MemoryLockLimit limit(0);
+    MemoryLock lock;
+    if (lock.lock(pages.data, pages.size)) {
+        GTEST_SKIP() << "Process is allowed to lock memory above RLIMIT_MEMLOCK";
+    }
+    EXPECT_EQ(lock.getLockedBytes(), 0);
+    EXPECT_EQ(lock.getPrefaultedBytes(), 4 * pageSize);
+    EXPECT_NE(lock.getLockError(), 0);
+    // pre-faulted memory stays usable
+    pages.data[0] = 1;
+}
@@ -0,0 +1,133 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../metrics.hpp"
+
+using namespace ovms;
+
+TEST(Histogram, SerializesCumulativeBuckets) {
+    Histogram histogram({10, 100});
+    histogram.observe(5);
+    histogram.observe(10);
+    histogram.observe(50);
+    histogram.observe(1000);
+
+    EXPECT_EQ(histogram.getCount(), 4);
+    EXPECT_EQ(histogram.getSum(), 1065);
+
+    std::string out;
+    histogram.serialize("metric", "a=\"b\"", out);
+    EXPECT_EQ(out,
+        "metric_bucket{a=\"b\",le=\"10\"} 2\n"
+        "metric_bucket{a=\"b\",le=\"100\"} 3\n"
+        "metric_bucket{a=\"b\",le=\"+Inf\"} 4\n"
+        "metric_sum{a=\"b\"} 1065\n"
+        "metric_count{a=\"b\"} 4\n");
+}
+
+TEST(Histogram, SerializesWithoutLabels) {
+    Histogram histogram({1});
+    std::string out;
+    histogram.serialize("metric", "", out);
+    EXPECT_EQ(out,
+        "metric_bucket{le=\"1\"} 0\n"
+        "metric_bucket{le=\"+Inf\"} 0\n"
+        "metric_sum 0\n"
+        "metric_count 0\n");
+}
+
+TEST(MetricRegistry, ReturnsSameHistogramForSameLabels) {
+    MetricRegistry registry;
+    auto& first = registry.getHistogram("family", "Help text", {1, 2}, "x=\"1\"");
+    auto& second = registry.getHistogram("family", "Other help", {5}, "x=\"1\"");
+    auto& other = registry.getHistogram("family", "Help text", {1, 2}, "x=\"2\"");
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+
+    first.observe(2);
+    const std::string out = registry.serialize();
+    EXPECT_EQ(out.find("# HELP family Help text\n# TYPE family histogram\n"), 0);
+    EXPECT_NE(out.find("family_bucket{x=\"1\",le=\"2\"} 1\n"), std::string::npos);
+    EXPECT_NE(out.find("family_count{x=\"2\"} 0\n"), std::string::npos);
+    EXPECT_EQ(out.find("Other help"), std::string::npos);
+}
+
+TEST(NodeMetrics, EscapesLabelValues) {
+    MetricRegistry registry;
+    auto metrics = NodeMetrics::create(registry, "pipe\"line", "node\\1");
+    ASSERT_NE(metrics.executionTime, nullptr);
+    observe(metrics.executionTime, 42);
+    observe(NodeMetrics{}.executionTime, 42);
+
+    const std::string out = registry.serialize();
+    EXPECT_NE(out.find("ovms_pipeline_node_execution_time_us_sum{pipeline=\"pipe\\\"line\",node=\"node\\\\1\"} 42\n"), std::string::npos);
+    EXPECT_NE(out.find("ovms_pipeline_node_shards_count{pipeline=\"pipe\\\"line\",node=\"node\\\\1\"} 0\n"), std::string::npos);
+}
+
+TEST(Counter, SumsIncrementsFromManyThreads) {
+    Counter counter;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&counter]() {
+            for (int j = 0; j < 1000; ++j) {
+                counter.increment();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    counter.increment(5);
+    EXPECT_EQ(counter.get(), 8005);
+}
+
+TEST(MetricRegistry, SerializesCountersAndGauges) {
+    MetricRegistry registry;
+    registry.getCounter("requests_total", "Requests", "m=\"a\"").increment(3);
+    auto& gauge = registry.getGauge("in_use", "In use", "m=\"a\"");
+    gauge.add(2);
+    gauge.add(-5);
+    EXPECT_EQ(&registry.getCounter("requests_total", "Requests", "m=\"a\""), &registry.getCounter("requests_total", "", "m=\"a\""));
+
+    const std::string out = registry.serialize();
+    EXPECT_NE(out.find("# TYPE requests_total counter\nrequests_total{m=\"a\"} 3\n"), std::string::npos);
+    EXPECT_NE(out.find("# TYPE in_use gauge\nin_use{m=\"a\"} -3\n"), std::string::npos);
+}
+
+TEST(ModelMetrics, CountsRequestsErrorsAndStages) {
+    MetricRegistry registry;
+    auto metrics = ModelMetrics::create(registry, "dummy", 1);
+    increment(metrics.requests);
+    increment(metrics.requests);
+    observe(metrics.predictionTime, 250);
+    add(metrics.inferRequests, 4);
+    set(metrics.inferRequestsMemory, 320);
+    ModelMetrics::countError(registry, "dummy", 1, "7");
+    increment(ModelMetrics{}.requests);
+
+    const std::string out = registry.serialize();
+    EXPECT_NE(out.find("ovms_model_requests_total{model=\"dummy\",version=\"1\"} 2\n"), std::string::npos);
+    EXPECT_NE(out.find("ovms_model_request_errors_total{model=\"dummy\",version=\"1\",code=\"7\"} 1\n"), std::string::npos);
+    EXPECT_NE(out.find("ovms_model_stage_time_us_sum{model=\"dummy\",version=\"1\",stage=\"prediction\"} 250\n"), std::string::npos);
+    EXPECT_NE(out.find("ovms_model_stage_time_us_count{model=\"dummy\",version=\"1\",stage=\"serialize\"} 0\n"), std::string::npos);
+    EXPECT_NE(out.find("ovms_model_infer_requests{model=\"dummy\",version=\"1\"} 4\n"), std::string::npos);
+    EXPECT_NE(out.find("ovms_model_memory_bytes{model=\"dummy\",version=\"1\",component=\"infer_requests\"} 320\n"), std::string::npos);
+}
@@ -217,6 +217,26 @@ TEST_F(ModelServiceDummyWith2Versions, all_versions) {
     }
 }
 
+TEST(ModelService, cached_response_is_rebuilt_on_status_change) {
+    ConstructorEnabledModelManager manager;
+    auto config = DUMMY_MODEL_CONFIG;
+    ASSERT_EQ(manager.reloadModelWithVersions(config), StatusCode::OK_RELOADED);
+    tensorflow::serving::GetModelStatusRequest req;
+    req.mutable_model_spec()->set_name("dummy");
+
+    std::string first, second;
+    ASSERT_EQ(GetModelStatusImpl::getModelStatusJson(&req, &first, manager), StatusCode::OK);
+    ASSERT_EQ(GetModelStatusImpl::getModelStatusJson(&req, &second, manager), StatusCode::OK);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first.find("AVAILABLE"), std::string::npos);
+
+    manager.findModelByName("dummy")->getModelInstanceByVersion(1)->retireModel();
+    tensorflow::serving::GetModelStatusResponse res;
+    ASSERT_EQ(GetModelStatusImpl::getModelStatus(&req, &res, manager), StatusCode::OK);
+    ASSERT_EQ(res.model_version_status_size(), 1);
+    EXPECT_EQ(res.model_version_status(0).state(), tensorflow::serving::ModelVersionStatus_State_END);
+}
+
 TEST(ModelService, non_existing_model) {
     ConstructorEnabledModelManager manager;
     auto config = DUMMY_MODEL_CONFIG;
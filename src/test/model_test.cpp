@@ -136,3 +136,23 @@ TEST_F(ModelDefaultVersions, DefaultVersionShouldReturnHighestWhenVersionReloade
     EXPECT_TRUE(nullptr != defaultInstance);
     EXPECT_EQ(2, defaultInstance->getVersion());
 }
+
+TEST_F(ModelDefaultVersions, ReloadOfAvailableVersionSwitchesToNewInstance) {
+    MockModelWithInstancesJustChangingStates mockModel;
+    std::shared_ptr<ovms::model_versions_t> versionsToChange = std::make_shared<ovms::model_versions_t>();
+    std::shared_ptr<ovms::model_versions_t> versionsFailed = std::make_shared<ovms::model_versions_t>();
+    versionsToChange->push_back(1);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    auto fs = ovms::ModelManager::getFilesystem(config.getBasePath());
+    ASSERT_EQ(mockModel.addVersions(versionsToChange, config, fs, versionsFailed), ovms::StatusCode::OK);
+    auto previousInstance = mockModel.getModelInstanceByVersion(1);
+    ASSERT_NE(nullptr, previousInstance);
+
+    ASSERT_EQ(mockModel.reloadVersions(versionsToChange, config, fs, versionsFailed), ovms::StatusCode::OK);
+    auto currentInstance = mockModel.getModelInstanceByVersion(1);
+    ASSERT_NE(nullptr, currentInstance);
+    EXPECT_NE(previousInstance, currentInstance);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, currentInstance->getStatus().getState());
+    EXPECT_EQ(ovms::ModelVersionState::END, previousInstance->getStatus().getState());
+    EXPECT_EQ(currentInstance, mockModel.getDefaultModelInstance());
+}
@@ -745,3 +745,707 @@ INSTANTIATE_TEST_SUITE_P(
     Test,
     ModelConfigParseModel,
     ::testing::ValuesIn(configs));
+
+TEST(ModelConfig, parseDynamicBatchingParameters) {
+    std::string config = R"#(
+        {
+            "name": "dynamic_batching",
+            "base_path": "/tmp/models/dummy1",
+            "max_batch_size": 8,
+            "batch_timeout_us": 500
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isDynamicBatchingEnabled());
+    EXPECT_EQ(modelConfig.getMaxBatchSize(), 8);
+    EXPECT_EQ(modelConfig.getBatchTimeoutUs(), 500);
+    EXPECT_EQ(modelConfig.getBatchingMode(), ovms::FIXED);
+    EXPECT_EQ(modelConfig.getBatchSize(), 8);
+}
+
+TEST(ModelConfig, parseDynamicBatchingWithAutoBatchSizeFails) {
+    std::string config = R"#(
+        {
+            "name": "dynamic_batching",
+            "base_path": "/tmp/models/dummy1",
+            "batch_size": "auto",
+            "max_batch_size": 8
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS);
+}
+
+TEST(ModelConfig, parseStatefulDynamicBatching) {
+    std::string config = R"#(
+        {
+            "name": "dynamic_batching",
+            "base_path": "/tmp/models/dummy1",
+            "stateful": true,
+            "max_batch_size": 8
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isDynamicBatchingEnabled());
+    EXPECT_EQ(modelConfig.getBatchSize(), 8);
+}
+
+TEST(ModelConfig, parseDynamicBatchingWithBoundSequencesFails) {
+    std::string config = R"#(
+        {
+            "name": "dynamic_batching",
+            "base_path": "/tmp/models/dummy1",
+            "stateful": true,
+            "max_bound_sequences": 2,
+            "max_batch_size": 8
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS);
+}
+
+TEST(ModelConfig, parseBatchTimeoutWithoutMaxBatchSizeFails) {
+    std::string config = R"#(
+        {
+            "name": "dynamic_batching",
+            "base_path": "/tmp/models/dummy1",
+            "batch_timeout_us": 500
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS);
+}
+
+TEST(ModelConfig, parseBatchLatencyTarget) {
+    std::string config = R"#(
+        {
+            "name": "dynamic_batching",
+            "base_path": "/tmp/models/dummy1",
+            "max_batch_size": 8,
+            "batch_latency_target_us": 20000
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getBatchLatencyTargetUs(), 20000);
+    EXPECT_EQ(modelConfig.getBatchTimeoutUs(), ovms::DEFAULT_BATCH_TIMEOUT_US);
+}
+
+TEST(ModelConfig, parseBatchLatencyTargetWithoutMaxBatchSizeFails) {
+    std::string config = R"#(
+        {
+            "name": "dynamic_batching",
+            "base_path": "/tmp/models/dummy1",
+            "batch_latency_target_us": 20000
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_DYNAMIC_BATCHING_PARAMETERS);
+}
+
+TEST(ModelConfig, parseQueueLimits) {
+    std::string config = R"#(
+        {
+            "name": "queue_limits",
+            "base_path": "/tmp/models/dummy1",
+            "max_queue_depth": 16,
+            "max_queue_wait_ms": 200
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getMaxQueueDepth(), 16);
+    EXPECT_EQ(modelConfig.getMaxQueueWaitMs(), 200);
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    otherConfig.setMaxQueueDepth(8);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+}
+
+TEST(ModelConfig, queueOnlyChangeDoesNotRecompileNetwork) {
+    ovms::ModelConfig modelConfig;
+    modelConfig.setName("dummy");
+    modelConfig.setNireq(2);
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    otherConfig.setNireq(4);
+    otherConfig.setMaxQueueDepth(16);
+    otherConfig.setPipelineReservedNireq(1);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+    EXPECT_TRUE(modelConfig.isInferRequestsQueueReloadSufficient(otherConfig));
+
+    otherConfig.setPluginConfig({{"CPU_THROUGHPUT_STREAMS", "2"}});
+    EXPECT_FALSE(modelConfig.isInferRequestsQueueReloadSufficient(otherConfig));
+
+    otherConfig = modelConfig;
+    otherConfig.setNireq(4);
+    otherConfig.setStateful(true);
+    modelConfig.setStateful(true);
+    EXPECT_FALSE(modelConfig.isInferRequestsQueueReloadSufficient(otherConfig));
+}
+
+TEST(ModelConfig, parseMinNireq) {
+    std::string config = R"#(
+        {
+            "name": "dummy",
+            "base_path": "/tmp/models/dummy1",
+            "nireq": 8,
+            "min_nireq": 2,
+            "nireq_cooldown_ms": 1000
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getMinNireq(), 2);
+    EXPECT_EQ(modelConfig.getNireqCooldownMs(), 1000);
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    otherConfig.setMinNireq(4);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+    EXPECT_TRUE(modelConfig.isInferRequestsQueueReloadSufficient(otherConfig));
+}
+
+TEST(ModelConfig, parseMinNireqForStatefulFails) {
+    std::string config = R"#(
+        {
+            "name": "dummy",
+            "base_path": "/tmp/models/dummy1",
+            "stateful": true,
+            "min_nireq": 2
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_NIREQ);
+}
+
+TEST(ModelConfig, parseNegativeQueueLimitFails) {
+    std::string config = R"#(
+        {
+            "name": "queue_limits",
+            "base_path": "/tmp/models/dummy1",
+            "max_queue_depth": -1
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_QUEUE_LIMIT);
+}
+
+TEST(ModelConfig, parseShapeCacheSize) {
+    std::string config = R"#(
+        {
+            "name": "shape_cache",
+            "base_path": "/tmp/models/dummy1",
+            "shape": "auto",
+            "shape_cache_size": 4
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isShapeCacheEnabled());
+    EXPECT_EQ(modelConfig.getShapeCacheSize(), 4);
+}
+
+TEST(ModelConfig, parseShapeCacheSizeWithoutShapeAutoFails) {
+    std::string config = R"#(
+        {
+            "name": "shape_cache",
+            "base_path": "/tmp/models/dummy1",
+            "shape_cache_size": 4
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_SHAPE_CACHE_SIZE);
+}
+
+TEST(ModelConfig, parseBatchSizeVariants) {
+    std::string config = R"#(
+        {
+            "name": "batch_size_variants",
+            "base_path": "/tmp/models/dummy1",
+            "batch_size": "auto",
+            "batch_size_variants": [16, 1, 4, 4]
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getBatchSizeVariants(), (std::set<size_t>{1, 4, 16}));
+}
+
+TEST(ModelConfig, parseBatchSizeVariantsWithoutBatchSizeAutoFails) {
+    std::string config = R"#(
+        {
+            "name": "batch_size_variants",
+            "base_path": "/tmp/models/dummy1",
+            "batch_size_variants": [1, 4]
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_BATCH_SIZE_VARIANTS);
+}
+
+TEST(ModelConfig, parseSequenceLengthBuckets) {
+    std::string config = R"#(
+        {
+            "name": "sequence_length_buckets",
+            "base_path": "/tmp/models/dummy1",
+            "sequence_length_buckets": [512, 64, 128, 64],
+            "attention_mask_input": "attention_mask"
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getSequenceLengthBuckets(), (std::set<size_t>{64, 128, 512}));
+    EXPECT_EQ(modelConfig.getAttentionMaskInput(), "attention_mask");
+}
+
+TEST(ModelConfig, parseSequenceLengthBucketsWithShapeAutoFails) {
+    std::string config = R"#(
+        {
+            "name": "sequence_length_buckets",
+            "base_path": "/tmp/models/dummy1",
+            "shape": "auto",
+            "sequence_length_buckets": [64, 128]
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_SEQUENCE_LENGTH_BUCKETS);
+}
+
+TEST(ModelConfig, parseAttentionMaskInputWithoutSequenceLengthBucketsFails) {
+    std::string config = R"#(
+        {
+            "name": "sequence_length_buckets",
+            "base_path": "/tmp/models/dummy1",
+            "attention_mask_input": "attention_mask"
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_SEQUENCE_LENGTH_BUCKETS);
+}
+
+TEST(ModelConfig, parseLatencyProfile) {
+    std::string config = R"#(
+        {
+            "name": "latency_profile",
+            "base_path": "/tmp/models/dummy1",
+            "batch_size": 16,
+            "latency_profile": {"nireq": 2, "batch_size": 1, "plugin_config": {"CPU_THREADS_NUM": "4"}, "min_priority": 5}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    const auto& profile = modelConfig.getLatencyProfile();
+    EXPECT_TRUE(profile.isEnabled());
+    EXPECT_EQ(profile.nireq, 2);
+    EXPECT_EQ(profile.batchSize, 1);
+    EXPECT_EQ(profile.pluginConfig, (ovms::plugin_config_t{{"CPU_THREADS_NUM", "4"}}));
+    EXPECT_EQ(profile.minPriority, 5);
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    auto otherProfile = profile;
+    otherProfile.nireq = 1;
+    otherConfig.setLatencyProfile(otherProfile);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+}
+
+TEST(ModelConfig, parseLatencyProfileWithoutNireqFails) {
+    std::string config = R"#(
+        {
+            "name": "latency_profile",
+            "base_path": "/tmp/models/dummy1",
+            "latency_profile": {"batch_size": 1}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_LATENCY_PROFILE);
+}
+
+TEST(ModelConfig, parseLatencyProfileWithStatefulFails) {
+    std::string config = R"#(
+        {
+            "name": "latency_profile",
+            "base_path": "/tmp/models/dummy1",
+            "stateful": true,
+            "latency_profile": {"nireq": 1}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_LATENCY_PROFILE);
+}
+
+TEST(ModelConfig, parseWarmupIterations) {
+    std::string config = R"#(
+        {
+            "name": "warmup",
+            "base_path": "/tmp/models/dummy1",
+            "warmup_iterations": 3
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getWarmupIterations(), 3);
+}
+
+TEST(ModelConfig, parseBatchSplitParallelism) {
+    std::string config = R"#(
+        {
+            "name": "split",
+            "base_path": "/tmp/models/dummy1",
+            "batch_split_parallelism": 4
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getBatchSplitParallelism(), 4);
+}
+
+TEST(ModelConfig, parseBatchSplitParallelismForStatefulFails) {
+    std::string config = R"#(
+        {
+            "name": "split",
+            "base_path": "/tmp/models/dummy1",
+            "stateful": true,
+            "batch_split_parallelism": 2
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_BATCH_SPLIT_PARALLELISM);
+}
+
+TEST(ModelConfig, parseLazyLoading) {
+    std::string config = R"#(
+        {
+            "name": "lazy",
+            "base_path": "/tmp/models/dummy1",
+            "lazy_loading": true
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isLazyLoadingEnabled());
+}
+
+TEST(ModelConfig, parseCritical) {
+    std::string config = R"#(
+        {
+            "name": "critical",
+            "base_path": "/tmp/models/dummy1",
+            "critical": true
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isCritical());
+}
+
+TEST(ModelConfig, parseAutoTune) {
+    std::string config = R"#(
+        {
+            "name": "tuned",
+            "base_path": "/tmp/models/dummy1",
+            "auto_tune": true,
+            "auto_tune_max_latency_ms": 20
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isAutoTuneEnabled());
+    EXPECT_EQ(modelConfig.getAutoTuneMaxLatencyMs(), 20);
+
+    ovms::ModelConfig untuned = modelConfig;
+    untuned.setAutoTune(false);
+    EXPECT_TRUE(modelConfig.isReloadRequired(untuned));
+}
+
+TEST(ModelConfig, parseLazyLoadingForStatefulFails) {
+    std::string config = R"#(
+        {
+            "name": "lazy",
+            "base_path": "/tmp/models/dummy1",
+            "stateful": true,
+            "lazy_loading": true
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_LAZY_LOADING);
+}
+
+TEST(ModelConfig, parseResponseCacheSize) {
+    std::string config = R"#(
+        {
+            "name": "cached",
+            "base_path": "/tmp/models/dummy1",
+            "response_cache_size_mb": 16
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isResponseCacheEnabled());
+    EXPECT_EQ(modelConfig.getResponseCacheSizeMb(), 16);
+}
+
+TEST(ModelConfig, parseResponseCacheSizeForStatefulFails) {
+    std::string config = R"#(
+        {
+            "name": "cached",
+            "base_path": "/tmp/models/dummy1",
+            "stateful": true,
+            "response_cache_size_mb": 16
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_RESPONSE_CACHE_SIZE);
+}
+
+TEST(ModelConfig, parseFallback) {
+    std::string config = R"#(
+        {
+            "name": "resnet",
+            "base_path": "/tmp/models/dummy1",
+            "fallback": {"model_name": "resnet_int8", "model_version": 2, "queue_depth": 4}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isFallbackEnabled());
+    EXPECT_EQ(modelConfig.getFallbackModelName(), "resnet_int8");
+    EXPECT_EQ(modelConfig.getFallbackModelVersion(), 2);
+    EXPECT_EQ(modelConfig.getFallbackQueueDepth(), 4);
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    otherConfig.setFallback("resnet_int8", 2, 8);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+}
+
+TEST(ModelConfig, parseFallbackToItselfFails) {
+    std::string config = R"#(
+        {
+            "name": "resnet",
+            "base_path": "/tmp/models/dummy1",
+            "fallback": {"model_name": "resnet"}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_FALLBACK);
+}
+
+TEST(ModelConfig, parseSchedulingParams) {
+    std::string config = R"#(
+        {
+            "name": "tenant",
+            "base_path": "/tmp/models/dummy1",
+            "scheduling_weight": 3,
+            "max_concurrent_inferences": 4
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    EXPECT_EQ(modelConfig.getSchedulingWeight(), 3);
+    EXPECT_EQ(modelConfig.getMaxConcurrentInferences(), 4);
+}
+
+TEST(ModelConfig, parseZeroSchedulingWeightFails) {
+    std::string config = R"#(
+        {
+            "name": "tenant",
+            "base_path": "/tmp/models/dummy1",
+            "scheduling_weight": 0
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_SCHEDULING_PARAMS);
+}
+
+TEST(ModelConfig, parseRequestPrecision) {
+    std::string config = R"#(
+        {
+            "name": "converted",
+            "base_path": "/tmp/models/dummy1",
+            "request_precision": {"b": "fp32"}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    ASSERT_EQ(modelConfig.getRequestPrecisions().size(), 1);
+    EXPECT_EQ(modelConfig.getRequestPrecisions().at("b"), "FP32");
+}
+
+TEST(ModelConfig, parseRequestPrecisionOtherThanFP32Fails) {
+    std::string config = R"#(
+        {
+            "name": "converted",
+            "base_path": "/tmp/models/dummy1",
+            "request_precision": {"b": "I32"}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_REQUEST_PRECISION);
+}
+
+TEST(ModelConfig, parsePreprocessing) {
+    std::string config = R"#(
+        {
+            "name": "preprocessed",
+            "base_path": "/tmp/models/dummy1",
+            "preprocessing": {"b": {"resize": "bilinear", "color_format": "rgb", "mean_values": [1, 2.5, 3], "scale_values": [255]}}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    ASSERT_EQ(modelConfig.getPreprocessing().size(), 1);
+    const auto& preprocessing = modelConfig.getPreprocessing().at("b");
+    EXPECT_EQ(preprocessing.resizeAlgorithm, "BILINEAR");
+    EXPECT_EQ(preprocessing.colorFormat, "RGB");
+    EXPECT_THAT(preprocessing.meanValues, ElementsAre(1.0, 2.5, 3.0));
+    EXPECT_THAT(preprocessing.scaleValues, ElementsAre(255.0));
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    EXPECT_FALSE(modelConfig.isReloadRequired(otherConfig));
+    auto otherPreprocessing = modelConfig.getPreprocessing();
+    otherPreprocessing["b"].resizeAlgorithm = "AREA";
+    otherConfig.setPreprocessing(otherPreprocessing);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+}
+
+TEST(ModelConfig, parseInvalidPreprocessingFails) {
+    for (const std::string preprocessing : {
+             R"({"b": {"resize": "cubic"}})",
+             R"({"b": {"color_format": "YUV"}})",
+             R"({"b": {"mean_values": []}})",
+             R"({"b": {"scale_values": [1, 0, 1]}})",
+             R"({"b": {"crop": true}})",
+             R"({"b": "bilinear"})"}) {
+        std::string config = R"({"name": "preprocessed", "base_path": "/tmp/models/dummy1", "preprocessing": )" + preprocessing + "}";
+        rapidjson::Document configJson;
+        ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+        ovms::ModelConfig modelConfig;
+        EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_PREPROCESSING) << preprocessing;
+    }
+}
+
+TEST(ModelConfig, parsePostprocessing) {
+    std::string config = R"#(
+        {
+            "name": "postprocessed",
+            "base_path": "/tmp/models/dummy1",
+            "postprocessing": {"a": {"type": "top_k", "k": 5}, "c": {"type": "argmax"}, "d": {"type": "threshold", "threshold": 0.5},
+                "e": {"type": "int8", "scale": 0.25}, "f": {"type": "PNG"}, "g": {"type": "fp16"}}
+        }
+    )#";
+    rapidjson::Document configJson;
+    ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+    ovms::ModelConfig modelConfig;
+    ASSERT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::OK);
+    ASSERT_EQ(modelConfig.getPostprocessing().size(), 6);
+    EXPECT_EQ(modelConfig.getPostprocessing().at("a").type, "top_k");
+    EXPECT_EQ(modelConfig.getPostprocessing().at("a").k, 5);
+    EXPECT_EQ(modelConfig.getPostprocessing().at("c").type, "argmax");
+    EXPECT_EQ(modelConfig.getPostprocessing().at("d").threshold, 0.5);
+    EXPECT_EQ(modelConfig.getPostprocessing().at("e").scale, 0.25);
+    EXPECT_EQ(modelConfig.getPostprocessing().at("f").type, "png");
+    EXPECT_EQ(modelConfig.getPostprocessing().at("f").scale, 1.0);
+    EXPECT_EQ(modelConfig.getPostprocessing().at("g").type, "fp16");
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    EXPECT_FALSE(modelConfig.isReloadRequired(otherConfig));
+    auto otherPostprocessing = modelConfig.getPostprocessing();
+    otherPostprocessing["a"].k = 1;
+    otherConfig.setPostprocessing(otherPostprocessing);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+}
+
+TEST(ModelConfig, parseInvalidPostprocessingFails) {
+    for (const std::string postprocessing : {
+             R"({"a": {"type": "softmax"}})",
+             R"({"a": {"type": "top_k"}})",
+             R"({"a": {"type": "top_k", "k": 0}})",
+             R"({"a": {"type": "argmax", "k": 1}})",
+             R"({"a": {"type": "threshold"}})",
+             R"({"a": {"type": "int8"}})",
+             R"({"a": {"type": "jpeg", "scale": 0}})",
+             R"({"a": {"type": "fp16", "scale": 1}})",
+             R"({"a": {"k": 1}})",
+             R"({"a": "argmax"})"}) {
+        std::string config = R"({"name": "postprocessed", "base_path": "/tmp/models/dummy1", "postprocessing": )" + postprocessing + "}";
+        rapidjson::Document configJson;
+        ASSERT_EQ(configJson.Parse(config.c_str()).HasParseError(), false);
+        ovms::ModelConfig modelConfig;
+        EXPECT_EQ(modelConfig.parseNode(configJson), ovms::StatusCode::INVALID_POSTPROCESSING) << postprocessing;
+    }
+}
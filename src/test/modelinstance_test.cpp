@@ -16,6 +16,8 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <iterator>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -84,6 +86,21 @@ TEST_F(TestUnloadModel, CanUnloadModelNotHoldingModelInstanceAtPredictPath) {
     EXPECT_TRUE(modelInstance.canUnloadInstance());
 }
 
+TEST_F(TestUnloadModel, RetireCompletesWhenLastUnloadGuardIsReleased) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(DUMMY_MODEL_CONFIG), ovms::StatusCode::OK);
+    auto firstGuard = std::make_unique<ovms::ModelInstanceUnloadGuard>(modelInstance);
+    auto secondGuard = std::make_unique<ovms::ModelInstanceUnloadGuard>(modelInstance);
+    auto retired = std::async(std::launch::async, [&modelInstance]() { modelInstance.retireModel(); });
+    EXPECT_EQ(retired.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    EXPECT_EQ(ovms::ModelVersionState::UNLOADING, modelInstance.getStatus().getState());
+    firstGuard.reset();
+    EXPECT_EQ(retired.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    secondGuard.reset();
+    ASSERT_EQ(retired.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(ovms::ModelVersionState::END, modelInstance.getStatus().getState());
+}
+
 TEST_F(TestUnloadModel, UnloadWaitsUntilMetadataResponseIsBuilt) {
     static std::thread thread;
     static std::shared_ptr<ovms::ModelInstance> instance;
@@ -267,6 +284,43 @@ TEST_F(TestLoadModel, SuccessfulLoad) {
     EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
 }
 
+TEST_F(TestLoadModel, SuccessfulLoadFromFilesInMemory) {
+    auto config = DUMMY_MODEL_CONFIG;
+    auto files = std::make_shared<std::map<ovms::model_version_t, ovms::model_files_contents_t>>();
+    for (const std::string name : {"dummy.xml", "dummy.bin"}) {
+        std::ifstream file(config.getPath() + "/" + name, std::ios::binary);
+        (*files)[config.getVersion()][name] = std::make_shared<const std::string>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    config.setBasePath("s3://bucket/dummy");
+    config.setLocalPath("s3://bucket/dummy");
+    config.setInMemoryFiles(files);
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+    EXPECT_EQ(modelInstance.getMemoryFootprint(), files->at(config.getVersion()).at("dummy.bin")->size() + files->at(config.getVersion()).at("dummy.xml")->size());
+
+    files->at(config.getVersion()).erase("dummy.bin");
+    ovms::ModelInstance missingWeightsInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    EXPECT_EQ(missingWeightsInstance.loadModel(config), ovms::StatusCode::FILE_INVALID);
+}
+
+TEST_F(TestLoadModel, ReportsMemoryUsage) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setNireq(2);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    auto usage = modelInstance.getMemoryUsage();
+    EXPECT_EQ(usage.modelFiles, modelInstance.getMemoryFootprint());
+    EXPECT_GT(usage.modelFiles, 0);
+    // dummy input and output of 10 floats in each of 2 infer requests
+    EXPECT_EQ(usage.inferRequests, 2 * 2 * 10 * sizeof(float));
+    EXPECT_EQ(usage.sequenceStates, 0);
+    EXPECT_EQ(usage.total(), usage.modelFiles + usage.inferRequests);
+
+    modelInstance.retireModel();
+    EXPECT_EQ(modelInstance.getMemoryUsage().total(), 0);
+}
+
 TEST_F(TestLoadModel, UnSuccessfulLoadWhenNireqTooHigh) {
     ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
     auto config = DUMMY_MODEL_CONFIG;
@@ -444,6 +444,77 @@ TEST(ModelManager, ReadVersionsInvalidPath) {
     EXPECT_EQ(status, ovms::StatusCode::PATH_INVALID);
 }
 
+class ListingCountingFileSystem : public ovms::LocalFileSystem {
+public:
+    static constexpr const char* PREFIX = "test://";
+    int listingsCount = 0;
+
+    ovms::StatusCode isDirectory(const std::string& path, bool* is_dir) override {
+        return LocalFileSystem::isDirectory(path.substr(std::string(PREFIX).size()), is_dir);
+    }
+    ovms::StatusCode getDirectorySubdirs(const std::string& path, ovms::files_list_t* subdirs) override {
+        listingsCount++;
+        return LocalFileSystem::getDirectorySubdirs(path.substr(std::string(PREFIX).size()), subdirs);
+    }
+};
+
+TEST(ModelManager, ReusesRemoteListingWithinTtl) {
+    const std::string path = "/tmp/test_remote_listing_model/";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path + "1");
+    auto countingFs = std::make_shared<ListingCountingFileSystem>();
+    std::shared_ptr<ovms::FileSystem> fs = countingFs;
+    const std::string remotePath = std::string(ListingCountingFileSystem::PREFIX) + path;
+
+    ConstructorEnabledModelManager manager;
+    ovms::model_versions_t versions;
+    EXPECT_EQ(manager.readAvailableVersions(fs, remotePath, versions), ovms::StatusCode::OK);
+    EXPECT_EQ(manager.readAvailableVersions(fs, remotePath, versions), ovms::StatusCode::OK);
+    EXPECT_EQ(countingFs->listingsCount, 2);
+
+    manager.setRemoteListingTtlSec(60);
+    std::filesystem::create_directories(path + "2");
+    versions.clear();
+    EXPECT_EQ(manager.readAvailableVersions(fs, remotePath, versions), ovms::StatusCode::OK);
+    EXPECT_THAT(versions, ::testing::UnorderedElementsAre(1, 2));
+    std::filesystem::create_directories(path + "3");
+    versions.clear();
+    EXPECT_EQ(manager.readAvailableVersions(fs, remotePath, versions), ovms::StatusCode::OK);
+    EXPECT_THAT(versions, ::testing::UnorderedElementsAre(1, 2));
+    EXPECT_EQ(countingFs->listingsCount, 3);
+
+    manager.invalidateRemoteListings();
+    versions.clear();
+    EXPECT_EQ(manager.readAvailableVersions(fs, remotePath, versions), ovms::StatusCode::OK);
+    EXPECT_THAT(versions, ::testing::UnorderedElementsAre(1, 2, 3));
+    EXPECT_EQ(countingFs->listingsCount, 4);
+    std::filesystem::remove_all(path);
+}
+
+class ModelManagerVersionPollInterval : public TestWithTempDir {};
+
+TEST_F(ModelManagerVersionPollInterval, SkipsModelsCheckedWithinInterval) {
+    const std::string modelPath = directoryPath + "/dummy/";
+    std::filesystem::copy("/ovms/src/test/dummy", modelPath, std::filesystem::copy_options::recursive);
+    const std::string configFile = directoryPath + "/config.json";
+    const std::string config = R"({"model_config_list": [{"config": {"name": "dummy", "base_path": ")" + modelPath +
+                               R"(", "model_version_policy": {"all": {}}, "version_poll_interval_seconds": 3600}}]})";
+    createConfigFileWithContent(config, configFile);
+    ConstructorEnabledModelManager manager;
+    ASSERT_EQ(manager.loadConfig(configFile), ovms::StatusCode::OK);
+    manager.updateConfigurationWithoutConfigFile(false);
+
+    std::filesystem::copy(modelPath + "1", modelPath + "2", std::filesystem::copy_options::recursive);
+    manager.updateConfigurationWithoutConfigFile(false);
+    auto model = manager.findModelByName("dummy");
+    ASSERT_NE(model, nullptr);
+    EXPECT_EQ(model->getModelInstanceByVersion(2), nullptr);
+
+    manager.updateConfigurationWithoutConfigFile(true);
+    ASSERT_NE(model->getModelInstanceByVersion(2), nullptr);
+    EXPECT_EQ(model->getModelInstanceByVersion(2)->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+}
+
 TEST(ModelManager, StartFromFile) {
     std::filesystem::create_directories(model_1_path);
     std::filesystem::create_directories(model_2_path);
@@ -678,6 +749,43 @@ TEST(ModelManager, ModelVersionFailedReloadReportsFailedStatus) {
     ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE);
 }
 
+class LowMemoryModelManager : public ConstructorEnabledModelManager {
+protected:
+    uint64_t getAvailableMemoryBytes() const override {
+        return 1;
+    }
+};
+
+TEST(ModelManager, VersionSwapWithoutMemoryHeadroomUnloadsRetiredVersionFirst) {
+    DummyModelDirectoryStructure modelDirectory("VersionSwapWithoutMemoryHeadroomUnloadsRetiredVersionFirst");
+    bool validVersion = true;
+    modelDirectory.addVersion(1, validVersion);
+    ovms::ModelConfig config;
+    config.setBasePath("/tmp/" + modelDirectory.name);
+    config.setName(modelDirectory.name);
+    config.setNireq(1);
+    LowMemoryModelManager manager;
+    manager.setVersionSwapPolicy(ovms::VersionSwapPolicy::AUTO);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto model = manager.findModelByName(modelDirectory.name);
+    ASSERT_NE(model, nullptr);
+    auto modelInstance1 = model->getModelInstanceByVersion(1);
+    ASSERT_EQ(modelInstance1->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+
+    // version 1 is unloaded before invalid version 2 and loaded back after it fails
+    modelDirectory.addVersion(2, !validVersion);
+    manager.reloadModelWithVersions(config);
+    EXPECT_EQ(modelInstance1->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+    EXPECT_EQ(model->getDefaultVersion(), 1);
+
+    modelDirectory.removeVersion(2);
+    modelDirectory.addVersion(2, validVersion);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    EXPECT_EQ(modelInstance1->getStatus().getState(), ovms::ModelVersionState::END);
+    EXPECT_EQ(model->getModelInstanceByVersion(2)->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+    EXPECT_EQ(model->getDefaultVersion(), 2);
+}
+
 TEST(ModelManager, ConfigReloadingWithTwoModelsWithTheSameName) {
     const char* configWithTwoSameNames = R"({
    "model_config_list": [
@@ -727,11 +835,36 @@ public:
     void registerVersionToLoad(ovms::model_version_t version) {
         toRegister.emplace_back(version);
     }
+    void setModelLoadWorkers(uint32_t workers) {
+        modelLoadWorkers = workers;
+    }
 
 private:
     std::vector<ovms::model_version_t> toRegister;
 };
 
+TEST(ModelManager, ConfigLoadingWithMultipleWorkersLoadsAllModels) {
+    std::filesystem::create_directories(model_1_path);
+    std::filesystem::create_directories(model_2_path);
+    std::string fileToReload = "/tmp/ovms_config_file2.json";
+    createConfigFileWithContent(config_2_models, fileToReload);
+    MockModelManagerWithModelInstancesJustChangingStates manager;
+    manager.setModelLoadWorkers(4);
+    manager.registerVersionToLoad(1);
+    manager.registerVersionToLoad(2);
+    auto status = manager.startFromFile(fileToReload);
+    ASSERT_EQ(status, ovms::StatusCode::OK);
+    auto models = manager.getModels();
+    ASSERT_EQ(models.size(), 2);
+    for (auto& nameModel : models) {
+        ASSERT_EQ(nameModel.second->getModelVersions().size(), 2);
+        for (auto& versionModelInstance : nameModel.second->getModelVersions()) {
+            EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, versionModelInstance.second->getStatus().getState());
+        }
+    }
+    manager.join();
+}
+
 TEST(ModelManager, ConfigReloadingShouldRetireModelInstancesOfModelRemovedFromJson) {
     std::filesystem::create_directories(model_1_path);
     std::filesystem::create_directories(model_2_path);
@@ -1345,7 +1478,7 @@ protected:
         std::thread([this]() {
             std::this_thread::sleep_for(std::chrono::milliseconds(modelInstanceLoadDelayInMilliseconds));
             status.setAvailable();
-            modelLoadedNotify.notify_all();
+            notifyLoadingWaiters();
         })
             .detach();
         return ovms::StatusCode::OK;
@@ -1419,3 +1552,43 @@ TEST_F(ModelInstanceModelLoadedNotify, WhenChangedStateFromLoadingToAvailableInR
     spdlog::error("State: {}", (int)modelInstance->getStatus().getState());
     EXPECT_EQ(status, ovms::StatusCode::MODEL_VERSION_NOT_LOADED_YET);
 }
+
+TEST(ModelManagerReadiness, ReadyWhenCriticalModelsAreAvailable) {
+    const char* config = R"({
+   "model_config_list": [
+    {
+      "config": {
+        "name": "dummy",
+        "base_path": "/ovms/src/test/dummy",
+        "critical": true
+      }
+   }]
+})";
+    std::string configFile = "/tmp/ovms_config_critical.json";
+    createConfigFileWithContent(config, configFile);
+    ConstructorEnabledModelManager manager;
+    EXPECT_FALSE(manager.isReady());
+    ASSERT_EQ(manager.startFromFile(configFile), ovms::StatusCode::OK);
+    // start was not called, readiness comes from critical model only
+    EXPECT_TRUE(manager.isReady());
+    EXPECT_FALSE(manager.isModelLoadPending("dummy"));
+    manager.join();
+}
+
+TEST(ModelManagerReadiness, NotReadyBeforeStartupWithoutCriticalModels) {
+    const char* config = R"({
+   "model_config_list": [
+    {
+      "config": {
+        "name": "dummy",
+        "base_path": "/ovms/src/test/dummy"
+      }
+   }]
+})";
+    std::string configFile = "/tmp/ovms_config_not_critical.json";
+    createConfigFileWithContent(config, configFile);
+    ConstructorEnabledModelManager manager;
+    ASSERT_EQ(manager.startFromFile(configFile), ovms::StatusCode::OK);
+    EXPECT_FALSE(manager.isReady());
+    manager.join();
+}
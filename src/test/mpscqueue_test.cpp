@@ -0,0 +1,95 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../mpscqueue.hpp"
+
+using ovms::MPSCQueue;
+
+const uint MPSC_WAIT_TIMEOUT_MICROSECONDS = 1'000'000;
+
+TEST(TestMPSCQueue, SeveralElementsInFIFOOrder) {
+    const std::vector<int> elements = {1, 2, 3, 4, 5, 6};
+    MPSCQueue<int> queue;
+    for (auto& e : elements) {
+        queue.push(e);
+    }
+    EXPECT_EQ(queue.size(), elements.size());
+    for (auto& e : elements) {
+        EXPECT_EQ(e, queue.tryPull(MPSC_WAIT_TIMEOUT_MICROSECONDS));
+    }
+    EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(TestMPSCQueue, NoElementsPushedTimesOut) {
+    MPSCQueue<int> queue;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(std::nullopt, queue.tryPull(10'000));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::microseconds(10'000));
+}
+
+TEST(TestMPSCQueue, MoveOnlyElementsAndNotPulledAreReleased) {
+    auto element = std::make_shared<int>(1);
+    {
+        MPSCQueue<std::unique_ptr<std::shared_ptr<int>>> queue;
+        queue.push(std::make_unique<std::shared_ptr<int>>(element));
+        queue.push(std::make_unique<std::shared_ptr<int>>(element));
+        EXPECT_EQ(**queue.pull(), 1);
+        EXPECT_EQ(element.use_count(), 2);
+    }
+    EXPECT_EQ(element.use_count(), 1);
+}
+
+TEST(TestMPSCQueue, SleepingConsumerIsWokenByProducer) {
+    MPSCQueue<int> queue;
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        queue.push(7);
+    });
+    EXPECT_EQ(queue.pull(), 7);
+    producer.join();
+}
+
+TEST(TestMPSCQueue, SeveralProducersAllElementsPulledInProducerOrder) {
+    const int PRODUCERS = 16;
+    const int ELEMENTS_PER_PRODUCER = 10'000;
+    MPSCQueue<std::pair<int, int>> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < ELEMENTS_PER_PRODUCER; ++i) {
+                queue.push({p, i});
+            }
+        });
+    }
+    std::vector<int> expectedNext(PRODUCERS, 0);
+    for (int i = 0; i < PRODUCERS * ELEMENTS_PER_PRODUCER; ++i) {
+        auto element = queue.tryPull(MPSC_WAIT_TIMEOUT_MICROSECONDS);
+        ASSERT_TRUE(element.has_value());
+        auto [producer, value] = element.value();
+        EXPECT_EQ(value, expectedNext[producer]);
+        expectedNext[producer] = value + 1;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_EQ(std::nullopt, queue.tryPull(1));
+}
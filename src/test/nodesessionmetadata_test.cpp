@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <set>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -33,15 +35,15 @@ class NodeSessionMetadataTest : public ::testing::Test {
 
 TEST_F(NodeSessionMetadataTest, GenerateSessionKeyWhenNoSubsessions) {
     NodeSessionMetadata meta;
-    EXPECT_EQ(meta.getSessionKey(), "");
+    EXPECT_EQ(meta.getSessionName(), "");
 }
 
 TEST_F(NodeSessionMetadataTest, GenerateSubsession) {
     NodeSessionMetadata meta;
     auto demultiplexedMetas = meta.generateSubsessions("request", 2);
     ASSERT_EQ(demultiplexedMetas.size(), 2);
-    EXPECT_EQ(demultiplexedMetas[0].getSessionKey(), "request_0");
-    EXPECT_EQ(demultiplexedMetas[1].getSessionKey(), "request_1");
+    EXPECT_EQ(demultiplexedMetas[0].getSessionName(), "request_0");
+    EXPECT_EQ(demultiplexedMetas[1].getSessionName(), "request_1");
 }
 
 TEST_F(NodeSessionMetadataTest, GenerateTwoLevelsOfSubsession) {
@@ -56,11 +58,11 @@ TEST_F(NodeSessionMetadataTest, GenerateTwoLevelsOfSubsession) {
         std::move(newLevelMetas.begin(), newLevelMetas.end(), secondLevelMetas.begin() + demMetaId * secondLevelDemultiplexSize);
     }
     for (size_t demMetaId = 0; demMetaId != demultiplexedMetas.size(); ++demMetaId) {
-        EXPECT_EQ(demultiplexedMetas[demMetaId].getSessionKey(), std::string("request_") + std::to_string(demMetaId));
+        EXPECT_EQ(demultiplexedMetas[demMetaId].getSessionName(), std::string("request_") + std::to_string(demMetaId));
     }
     for (size_t demMetaId = 0; demMetaId != firstLevelDemultiplexSize; ++demMetaId) {
         for (size_t demMetaLev2Id = 0; demMetaLev2Id != secondLevelDemultiplexSize; ++demMetaLev2Id) {
-            auto hash = secondLevelMetas[demMetaLev2Id + demMetaId * secondLevelDemultiplexSize].getSessionKey();
+            auto hash = secondLevelMetas[demMetaLev2Id + demMetaId * secondLevelDemultiplexSize].getSessionName();
             EXPECT_THAT(hash, HasSubstr(std::string("request_") + std::to_string(demMetaId)));
             EXPECT_THAT(hash, HasSubstr(std::string("2ndDemultiplexer_") + std::to_string(demMetaLev2Id)));
         }
@@ -76,12 +78,31 @@ TEST_F(NodeSessionMetadataTest, GenerateThreeLevelsOfSubsession) {
                                      .generateSubsessions("request", firstLevelDemultiplexSize)[2]
                                      .generateSubsessions("extract1st", secondLevelDemultiplexSize)[0]
                                      .generateSubsessions("extract2nd", thirdLevelDemultiplexSize)[2];
-    auto hash = demultiplexedMetaLev3.getSessionKey();
+    auto hash = demultiplexedMetaLev3.getSessionName();
     EXPECT_THAT(hash, HasSubstr("request_2"));
     EXPECT_THAT(hash, HasSubstr("extract1st_0"));
     EXPECT_THAT(hash, HasSubstr("extract2nd_2"));
 }
 
+TEST_F(NodeSessionMetadataTest, SessionKeysAreUniqueAmongSubsessions) {
+    const uint firstLevelDemultiplexSize = 3;
+    const uint secondLevelDemultiplexSize = 4;
+    NodeSessionMetadata meta;
+    EXPECT_EQ(meta.getSessionKey(), 0);
+    std::set<session_key_t> keys;
+    std::set<session_key_t> collapsedKeys;
+    for (auto& firstLevelMeta : meta.generateSubsessions("request", firstLevelDemultiplexSize)) {
+        for (auto& secondLevelMeta : firstLevelMeta.generateSubsessions("extract", secondLevelDemultiplexSize)) {
+            keys.insert(secondLevelMeta.getSessionKey());
+            auto collapsedKey = secondLevelMeta.getSessionKey({"extract"});
+            EXPECT_EQ(collapsedKey, firstLevelMeta.getSessionKey());
+            collapsedKeys.insert(collapsedKey);
+        }
+    }
+    EXPECT_EQ(keys.size(), firstLevelDemultiplexSize * secondLevelDemultiplexSize);
+    EXPECT_EQ(collapsedKeys.size(), firstLevelDemultiplexSize);
+}
+
 TEST_F(NodeSessionMetadataTest, GenerateSubsessionWithEmptyNameShouldThrow) {
     NodeSessionMetadata meta;
     EXPECT_THROW(meta.generateSubsessions("", 3), std::logic_error);
@@ -90,7 +111,7 @@ TEST_F(NodeSessionMetadataTest, GenerateSubsessionWithEmptyNameShouldThrow) {
 TEST_F(NodeSessionMetadataTest, CanGenerateEmptySubsession) {
     NodeSessionMetadata startMeta;
     auto meta = startMeta.generateSubsessions("someName", 0);
-    EXPECT_EQ(meta.size(), 0) << meta[0].getSessionKey();
+    EXPECT_EQ(meta.size(), 0) << meta[0].getSessionName();
 }
 
 TEST_F(NodeSessionMetadataTest, GenerateTwoSubsessionsWithTheSameNameShouldThrow) {
@@ -109,16 +130,17 @@ TEST_F(NodeSessionMetadataTest, CollapseSubsession1Level) {
                                      .generateSubsessions("request", firstLevelDemultiplexSize)[2]
                                      .generateSubsessions("extract1st", secondLevelDemultiplexSize)[0]
                                      .generateSubsessions("extract2nd", thirdLevelDemultiplexSize)[2];
-    auto hash = demultiplexedMetaLev3.getSessionKey();
+    auto hash = demultiplexedMetaLev3.getSessionName();
     ASSERT_THAT(hash, HasSubstr("request_2"));
     ASSERT_THAT(hash, HasSubstr("extract1st_0"));
     ASSERT_THAT(hash, HasSubstr("extract2nd_2"));
     NodeSessionMetadata metaCollapsedOnExtract1st;
     CollapseDetails collapsingDetails;
     std::tie(metaCollapsedOnExtract1st, collapsingDetails) = demultiplexedMetaLev3.getCollapsedSessionMetadata({"extract2nd"});
-    auto hashCollapsed = metaCollapsedOnExtract1st.getSessionKey();
+    auto hashCollapsed = metaCollapsedOnExtract1st.getSessionName();
     // need to ensure that generated collapsed session key before collapsing and after are the same
-    EXPECT_EQ(hashCollapsed, demultiplexedMetaLev3.getSessionKey({std::string("extract2nd")}));
+    EXPECT_EQ(hashCollapsed, demultiplexedMetaLev3.getSessionName({std::string("extract2nd")}));
+    EXPECT_EQ(metaCollapsedOnExtract1st.getSessionKey(), demultiplexedMetaLev3.getSessionKey({std::string("extract2nd")}));
 
     ASSERT_THAT(hashCollapsed, HasSubstr("request_2"));
     ASSERT_THAT(hashCollapsed, HasSubstr("extract1st_0"));
@@ -138,7 +160,7 @@ TEST_F(NodeSessionMetadataTest, CollapseSubsession1LevelNotInLIFOOrderShouldThro
                                      .generateSubsessions("request", firstLevelDemultiplexSize)[2]
                                      .generateSubsessions("extract1st", secondLevelDemultiplexSize)[0]
                                      .generateSubsessions("extract2nd", thirdLevelDemultiplexSize)[2];
-    auto hash = demultiplexedMetaLev3.getSessionKey();
+    auto hash = demultiplexedMetaLev3.getSessionName();
     ASSERT_THAT(hash, HasSubstr("request_2"));
     ASSERT_THAT(hash, HasSubstr("extract1st_0"));
     ASSERT_THAT(hash, HasSubstr("extract2nd_2"));
@@ -156,7 +178,7 @@ TEST_F(NodeSessionMetadataTest, CollapseSubsessions2LevelsAtOnce) {
                                      .generateSubsessions("request", firstLevelDemultiplexSize)[12]
                                      .generateSubsessions("extract1st", secondLevelDemultiplexSize)[32]
                                      .generateSubsessions("extract2nd", thirdLevelDemultiplexSize)[512];
-    auto hash = demultiplexedMetaLev3.getSessionKey();
+    auto hash = demultiplexedMetaLev3.getSessionName();
     ASSERT_THAT(hash, HasSubstr("request_12"));
     ASSERT_THAT(hash, HasSubstr("extract1st_32"));
     ASSERT_THAT(hash, HasSubstr("extract2nd_512"));
@@ -164,7 +186,7 @@ TEST_F(NodeSessionMetadataTest, CollapseSubsessions2LevelsAtOnce) {
     NodeSessionMetadata metaCollapsed;
     CollapseDetails collapsingDetails;
     std::tie(metaCollapsed, collapsingDetails) = demultiplexedMetaLev3.getCollapsedSessionMetadata({"extract1st", "extract2nd"});
-    auto hashCollapsed = metaCollapsed.getSessionKey();
+    auto hashCollapsed = metaCollapsed.getSessionName();
     ASSERT_THAT(hashCollapsed, HasSubstr("request_12"));
     ASSERT_THAT(hashCollapsed, Not(HasSubstr("extract1st")));
     ASSERT_THAT(hashCollapsed, Not(HasSubstr("extract2nd")));
@@ -193,7 +215,7 @@ TEST_F(NodeSessionMetadataTest, GenerateCollapsedSubsessionKey) {
     NodeSessionMetadata meta;
     auto subsessionMeta = meta.generateSubsessions("request", 2)[0]
                               .generateSubsessions("anotherSession", 5)[1];
-    auto hash = subsessionMeta.getSessionKey({"anotherSession"});
+    auto hash = subsessionMeta.getSessionName({"anotherSession"});
     ASSERT_THAT(hash, HasSubstr("request_0"));
     ASSERT_THAT(hash, Not(HasSubstr("anotherSession")));
 }
@@ -203,7 +225,7 @@ TEST_F(NodeSessionMetadataTest, GenerateCollapsedSeveralSubsessionsAtOnceKey) {
     auto subsessionMeta = meta.generateSubsessions("request", 2)[0]
                               .generateSubsessions("anotherSession", 5)[1]
                               .generateSubsessions("yetAnotherSession", 3)[2];
-    auto hash = subsessionMeta.getSessionKey({"anotherSession", "yetAnotherSession"});
+    auto hash = subsessionMeta.getSessionName({"anotherSession", "yetAnotherSession"});
     ASSERT_THAT(hash, HasSubstr("request"));
     ASSERT_THAT(hash, Not(HasSubstr("anotherSession")));
     ASSERT_THAT(hash, Not(HasSubstr("yetAnotherSession")));
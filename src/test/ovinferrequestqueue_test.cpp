@@ -14,16 +14,21 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <atomic>
 #include <chrono>
 #include <filesystem>
+#include <future>
+#include <mutex>
 #include <random>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "../ovinferrequestsqueue.hpp"
+#include "../requestcontext.hpp"
 #include "../timer.hpp"
 
 using namespace testing;
@@ -53,7 +58,11 @@ void releaseStream(ovms::OVInferRequestsQueue& requestsQueue) {
 }
 
 TEST(OVInferRequestQueue, FullQueue) {
-    ovms::Timer timer;
+    enum : size_t {
+        QUEUE,
+        TIMER_END
+    };
+    ovms::Timer<TIMER_END> timer;
     InferenceEngine::Core engine;
     InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
     InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
@@ -62,13 +71,13 @@ TEST(OVInferRequestQueue, FullQueue) {
     for (int i = 0; i < 50; i++) {
         reqid = inferRequestsQueue.getIdleStream().get();
     }
-    timer.start("queue");
+    timer.start(QUEUE);
     std::thread th(&releaseStream, std::ref(inferRequestsQueue));
     th.detach();
     reqid = inferRequestsQueue.getIdleStream().get();  // it should wait 1s for released request
-    timer.stop("queue");
+    timer.stop(QUEUE);
 
-    EXPECT_GT(timer.elapsed<std::chrono::microseconds>("queue"), 1'000'000);
+    EXPECT_GT(timer.elapsed<std::chrono::microseconds>(QUEUE), 1'000'000);
     EXPECT_EQ(reqid, 3);
 }
 
@@ -126,3 +135,325 @@ TEST(OVInferRequestQueue, AsyncGetInferRequest) {
     const int secondStreamId = secondStreamRequest.get();
     EXPECT_EQ(firstStreamId, secondStreamId);
 }
+
+TEST(OVInferRequestQueue, TryGetIdleStreamDoesNotWait) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    const int nireq = 2;
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, nireq);
+
+    int firstStreamId = -1;
+    int secondStreamId = -1;
+    int thirdStreamId = -1;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(firstStreamId));
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(secondStreamId));
+    EXPECT_NE(firstStreamId, secondStreamId);
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream(thirdStreamId));
+
+    std::future<int> waitingStreamRequest = inferRequestsQueue.getIdleStream();
+    EXPECT_EQ(std::future_status::timeout, waitingStreamRequest.wait_for(std::chrono::milliseconds(1)));
+    inferRequestsQueue.returnStream(secondStreamId);
+    ASSERT_EQ(std::future_status::ready, waitingStreamRequest.wait_for(std::chrono::microseconds(1)));
+    EXPECT_EQ(waitingStreamRequest.get(), secondStreamId);
+    // stream handed over to the waiting caller must not stay in the ring
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream(thirdStreamId));
+}
+
+TEST(OVInferRequestQueue, WaitersServedByPriority) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+
+    int busyStreamId;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(busyStreamId));
+    std::mutex servedOrderMutex;
+    std::vector<int> servedOrder;
+    std::vector<std::thread> clients;
+    for (int priority : {1, 5, 3}) {
+        clients.emplace_back([&inferRequestsQueue, &servedOrderMutex, &servedOrder, priority]() {
+            ovms::RequestContext context;
+            context.priority = priority;
+            int streamId;
+            ASSERT_EQ(inferRequestsQueue.acquireIdleStream(streamId, context), ovms::StatusCode::OK);
+            {
+                std::lock_guard<std::mutex> lock(servedOrderMutex);
+                servedOrder.push_back(priority);
+            }
+            inferRequestsQueue.returnStream(streamId);
+        });
+        // make sure all clients are parked before the stream is returned
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    inferRequestsQueue.returnStream(busyStreamId);
+    for (auto& client : clients) {
+        client.join();
+    }
+    EXPECT_THAT(servedOrder, ElementsAre(5, 3, 1));
+}
+
+TEST(OVInferRequestQueue, WaiterDroppedAfterDeadline) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+
+    int busyStreamId;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(busyStreamId));
+    ovms::RequestContext context;
+    context.deadline = ovms::RequestContext::clock_t::now() + std::chrono::milliseconds(10);
+    int streamId;
+    EXPECT_EQ(inferRequestsQueue.acquireIdleStream(streamId, context), ovms::StatusCode::REQUEST_DEADLINE_EXCEEDED);
+
+    // expired waiter must not swallow the returned stream
+    inferRequestsQueue.returnStream(busyStreamId);
+    EXPECT_TRUE(inferRequestsQueue.tryGetIdleStream(streamId));
+    EXPECT_EQ(streamId, busyStreamId);
+}
+
+TEST(OVInferRequestQueue, RejectWhenQueueDepthExceeded) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1, 1);
+
+    int busyStreamId;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(busyStreamId));
+    std::thread waitingClient([&inferRequestsQueue]() {
+        int streamId;
+        ASSERT_EQ(inferRequestsQueue.acquireIdleStream(streamId, ovms::RequestContext()), ovms::StatusCode::OK);
+        inferRequestsQueue.returnStream(streamId);
+    });
+    // make sure the first client is parked before the second one arrives
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int streamId;
+    EXPECT_EQ(inferRequestsQueue.acquireIdleStream(streamId, ovms::RequestContext()), ovms::StatusCode::INFER_REQUEST_QUEUE_FULL);
+    EXPECT_EQ(inferRequestsQueue.getRejectedRequestsCount(), 1);
+    inferRequestsQueue.returnStream(busyStreamId);
+    waitingClient.join();
+}
+
+TEST(OVInferRequestQueue, RejectWhenQueueWaitExceeded) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1, 0, 10);
+
+    int busyStreamId;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(busyStreamId));
+    int streamId;
+    EXPECT_EQ(inferRequestsQueue.acquireIdleStream(streamId, ovms::RequestContext()), ovms::StatusCode::INFER_REQUEST_QUEUE_TIMEOUT);
+    EXPECT_EQ(inferRequestsQueue.getRejectedRequestsCount(), 1);
+
+    // the shorter request deadline takes precedence over the queue wait limit
+    ovms::RequestContext context;
+    context.deadline = ovms::RequestContext::clock_t::now() + std::chrono::milliseconds(1);
+    EXPECT_EQ(inferRequestsQueue.acquireIdleStream(streamId, context), ovms::StatusCode::REQUEST_DEADLINE_EXCEEDED);
+    EXPECT_EQ(inferRequestsQueue.getRejectedRequestsCount(), 1);
+    inferRequestsQueue.returnStream(busyStreamId);
+}
+
+TEST(OVInferRequestQueue, WaiterDroppedAfterCancellation) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+
+    int busyStreamId;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(busyStreamId));
+    std::atomic<bool> cancelled{false};
+    ovms::RequestContext context;
+    context.cancellationCheck = [&cancelled]() { return cancelled.load(); };
+    std::thread canceller([&cancelled]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        cancelled = true;
+    });
+    int streamId;
+    EXPECT_EQ(inferRequestsQueue.acquireIdleStream(streamId, context), ovms::StatusCode::REQUEST_CANCELLED);
+    canceller.join();
+
+    // cancelled waiter must not swallow the returned stream
+    inferRequestsQueue.returnStream(busyStreamId);
+    EXPECT_TRUE(inferRequestsQueue.tryGetIdleStream(streamId));
+    EXPECT_EQ(streamId, busyStreamId);
+}
+
+TEST(OVInferRequestQueue, NotifiedWaiterGetsReturnedStream) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+
+    int busyStreamId = -1;
+    ovms::OVInferRequestsQueue::WaiterKey firstKey, secondKey;
+    ASSERT_TRUE(inferRequestsQueue.getIdleStreamOrNotify(
+        busyStreamId, [](int) { FAIL() << "Idle stream should be returned right away"; }, firstKey));
+
+    int notifiedStreamId = -1;
+    int streamId = -1;
+    EXPECT_FALSE(inferRequestsQueue.getIdleStreamOrNotify(
+        streamId, [&notifiedStreamId](int id) { notifiedStreamId = id; }, firstKey));
+    EXPECT_FALSE(inferRequestsQueue.getIdleStreamOrNotify(
+        streamId, [](int) { FAIL() << "Cancelled waiter should not be notified"; }, secondKey));
+    EXPECT_TRUE(inferRequestsQueue.cancelWaiter(secondKey));
+    EXPECT_FALSE(inferRequestsQueue.cancelWaiter(secondKey));
+
+    inferRequestsQueue.returnStream(busyStreamId);
+    EXPECT_EQ(notifiedStreamId, busyStreamId);
+    // stream was already handed over
+    EXPECT_FALSE(inferRequestsQueue.cancelWaiter(firstKey));
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream(streamId));
+}
+
+TEST(OVInferRequestQueue, NotifiedWaiterCanReturnStreamFromCallback) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+
+    int busyStreamId = -1;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(busyStreamId));
+    int streamId = -1;
+    ovms::OVInferRequestsQueue::WaiterKey key;
+    ASSERT_FALSE(inferRequestsQueue.getIdleStreamOrNotify(
+        streamId, [&inferRequestsQueue](int id) { inferRequestsQueue.returnStream(id); }, key));
+    std::future<int> waitingStreamRequest = inferRequestsQueue.getIdleStream();
+
+    inferRequestsQueue.returnStream(busyStreamId);
+    ASSERT_EQ(std::future_status::ready, waitingStreamRequest.wait_for(std::chrono::milliseconds(100)));
+    EXPECT_EQ(waitingStreamRequest.get(), busyStreamId);
+}
+
+TEST(OVInferRequestQueue, ReservedStreamIsTakenOnlyByPipeline) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    const uint32_t reservedStreams = 1;
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 2, 0, 0, reservedStreams);
+
+    int directStreamId = -1;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(directStreamId));
+    int streamId = -1;
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream(streamId));
+    ovms::RequestContext context;
+    context.deadline = ovms::RequestContext::clock_t::now() + std::chrono::milliseconds(10);
+    EXPECT_EQ(inferRequestsQueue.acquireIdleStream(streamId, context), ovms::StatusCode::REQUEST_DEADLINE_EXCEEDED);
+
+    int pipelineStreamId = -1;
+    ovms::OVInferRequestsQueue::WaiterKey key;
+    ASSERT_TRUE(inferRequestsQueue.getIdleStreamOrNotify(
+        pipelineStreamId, [](int) { FAIL() << "Reserved stream should be taken right away"; }, key));
+    EXPECT_NE(pipelineStreamId, directStreamId);
+
+    inferRequestsQueue.returnStream(pipelineStreamId);
+    inferRequestsQueue.returnStream(directStreamId);
+    EXPECT_TRUE(inferRequestsQueue.tryGetIdleStream(streamId));
+}
+
+TEST(OVInferRequestQueue, EarlierStartedPipelineIsServedFirst) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+
+    int busyStreamId = -1;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(busyStreamId));
+    std::future<int> directRequest = inferRequestsQueue.getIdleStream();
+
+    const auto now = ovms::RequestContext::clock_t::now();
+    std::vector<int> servedPipelines;
+    int streamId = -1;
+    ovms::OVInferRequestsQueue::WaiterKey laterKey, earlierKey;
+    ASSERT_FALSE(inferRequestsQueue.getIdleStreamOrNotify(
+        streamId, [&](int id) { servedPipelines.push_back(2); inferRequestsQueue.returnStream(id); }, laterKey, now));
+    ASSERT_FALSE(inferRequestsQueue.getIdleStreamOrNotify(
+        streamId, [&](int id) { servedPipelines.push_back(1); inferRequestsQueue.returnStream(id); }, earlierKey, now - std::chrono::seconds(1)));
+
+    inferRequestsQueue.returnStream(busyStreamId);
+    EXPECT_THAT(servedPipelines, ElementsAre(1, 2));
+    ASSERT_EQ(std::future_status::ready, directRequest.wait_for(std::chrono::milliseconds(100)));
+    EXPECT_EQ(directRequest.get(), busyStreamId);
+}
+
+TEST(RequestContext, FromHeaders) {
+    auto context = ovms::RequestContext::fromHeaders("7", "100");
+    EXPECT_EQ(context.priority, 7);
+    EXPECT_TRUE(context.hasDeadline());
+    EXPECT_FALSE(context.isDeadlineExceeded());
+
+    context = ovms::RequestContext::fromHeaders("", "");
+    EXPECT_EQ(context.priority, ovms::RequestContext::DEFAULT_PRIORITY);
+    EXPECT_FALSE(context.hasDeadline());
+
+    context = ovms::RequestContext::fromHeaders("high", "-1");
+    EXPECT_EQ(context.priority, ovms::RequestContext::DEFAULT_PRIORITY);
+    EXPECT_FALSE(context.hasDeadline());
+}
+
+TEST(RequestContext, Check) {
+    ovms::RequestContext context;
+    EXPECT_EQ(context.check(), ovms::StatusCode::OK);
+
+    context.restrictDeadline(ovms::RequestContext::clock_t::now());
+    EXPECT_EQ(context.check(), ovms::StatusCode::REQUEST_DEADLINE_EXCEEDED);
+
+    context.cancellationCheck = []() { return true; };
+    EXPECT_EQ(context.check(), ovms::StatusCode::REQUEST_CANCELLED);
+}
+
+TEST(OVInferRequestQueue, InterleavesDevicesAndRecordsRequestTime) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork firstNetwork = engine.LoadNetwork(network, "CPU");
+    InferenceEngine::ExecutableNetwork secondNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::Histogram firstRequestTime({1'000'000});
+    ovms::Histogram secondRequestTime({1'000'000});
+    ovms::OVInferRequestsQueue inferRequestsQueue({{"FIRST", firstNetwork, 2, &firstRequestTime},
+        {"SECOND", secondNetwork, 1, &secondRequestTime}});
+    int reqid;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(reqid));
+    EXPECT_EQ(reqid, 0);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(reqid), "FIRST");
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(reqid));
+    EXPECT_EQ(reqid, 2);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(reqid), "SECOND");
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(reqid));
+    EXPECT_EQ(reqid, 1);
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream(reqid));
+
+    inferRequestsQueue.returnStream(2);
+    EXPECT_EQ(secondRequestTime.getCount(), 1);
+    EXPECT_EQ(firstRequestTime.getCount(), 0);
+}
+
+TEST(OVInferRequestQueue, ElasticQueueGrowsForWaitersAndShrinksAfterCooldown) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 3);
+    inferRequestsQueue.enableElasticity(1, std::chrono::milliseconds(50));
+    EXPECT_EQ(inferRequestsQueue.getActiveStreamsCount(), 1);
+
+    int firstStreamId = -1;
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(firstStreamId));
+    int streamId = -1;
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream(streamId));
+    // parked caller creates infer request of a dormant stream and gets it
+    ovms::RequestContext context;
+    ASSERT_EQ(inferRequestsQueue.acquireIdleStream(streamId, context), ovms::StatusCode::OK);
+    EXPECT_NE(streamId, firstStreamId);
+    EXPECT_EQ(inferRequestsQueue.getActiveStreamsCount(), 2);
+    EXPECT_NO_THROW(inferRequestsQueue.getInferRequest(streamId).Infer());
+
+    // right after waiting the stream is kept, after cooldown it is released
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(inferRequestsQueue.getActiveStreamsCount(), 2);
+    ASSERT_TRUE(inferRequestsQueue.tryGetIdleStream(streamId));
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(inferRequestsQueue.getActiveStreamsCount(), 1);
+    inferRequestsQueue.returnStream(firstStreamId);
+    EXPECT_EQ(inferRequestsQueue.getActiveStreamsCount(), 1);
+    EXPECT_TRUE(inferRequestsQueue.tryGetIdleStream(streamId));
+}
@@ -170,12 +170,37 @@ TEST_F(OvmsConfigDeathTest, negativeGrpcWorkersMax) {
     EXPECT_EXIT(ovms::Config::instance().parse(arg_count, n_argv), ::testing::ExitedWithCode(EX_USAGE), "grpc_workers count should be from 1");
 }
 
+TEST_F(OvmsConfigDeathTest, negativeRestReactorsMax) {
+    char* n_argv[] = {"ovms", "--model_path", "/path1", "--model_name", "model", "--rest_port", "8080", "--rest_reactors", "10000"};
+    int arg_count = 9;
+    EXPECT_EXIT(ovms::Config::instance().parse(arg_count, n_argv), ::testing::ExitedWithCode(EX_USAGE), "rest_reactors count should be from 1");
+}
+
 TEST_F(OvmsConfigDeathTest, negativeUint64Max) {
     char* n_argv[] = {"ovms", "--config_path", "/path1", "--rest_port", "0xffffffffffffffff"};
     int arg_count = 5;
     EXPECT_EXIT(ovms::Config::instance().parse(arg_count, n_argv), ::testing::ExitedWithCode(EX_USAGE), "rest_port number out of range from 0 to 65535");
 }
 
+TEST_F(OvmsConfigDeathTest, negativeCacheDirNotCreatable) {
+    char* n_argv[] = {"ovms", "--model_path", "/path1", "--model_name", "model", "--cache_dir", "/proc/ovms_cache"};
+    int arg_count = 7;
+    EXPECT_EXIT(ovms::Config::instance().parse(arg_count, n_argv), ::testing::ExitedWithCode(EX_USAGE), "--cache_dir parameter cannot be created");
+}
+
+TEST_F(OvmsConfigDeathTest, negativeUnixSocketPathTooLong) {
+    std::string path = "/tmp/" + std::string(200, 'a') + ".sock";
+    char* n_argv[] = {"ovms", "--config_path", "/path1", "--grpc_unix_socket", &path[0]};
+    int arg_count = 5;
+    EXPECT_EXIT(ovms::Config::instance().parse(arg_count, n_argv), ::testing::ExitedWithCode(EX_USAGE), "grpc_unix_socket path should be from 1 to");
+}
+
+TEST_F(OvmsConfigDeathTest, negativeSameUnixSockets) {
+    char* n_argv[] = {"ovms", "--config_path", "/path1", "--grpc_unix_socket", "/tmp/ovms.sock", "--rest_unix_socket", "/tmp/ovms.sock"};
+    int arg_count = 7;
+    EXPECT_EXIT(ovms::Config::instance().parse(arg_count, n_argv), ::testing::ExitedWithCode(EX_USAGE), "grpc_unix_socket and rest_unix_socket cannot");
+}
+
 class OvmsParamsTest : public ::testing::Test {
 };
 
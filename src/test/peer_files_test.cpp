@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <fstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../peer_files.hpp"
+#include "../remote_files_cache.hpp"
+#include "test_utils.hpp"
+
+using ovms::PeerFilesClient;
+using ovms::RemoteFilesCache;
+using testing::ElementsAre;
+
+class PeerFilesClientTest : public TestWithTempDir {
+protected:
+    std::string writeFile(const std::string& content) {
+        auto path = directoryPath + "/file";
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+        return path;
+    }
+};
+
+TEST(PeerFilesClient, ParsesPeers) {
+    EXPECT_THAT(PeerFilesClient::parsePeers("replica-0:8000, replica-1:8000,,"), ElementsAre("replica-0:8000", "replica-1:8000"));
+    EXPECT_TRUE(PeerFilesClient::parsePeers("").empty());
+}
+
+TEST(PeerFilesClient, ParsesKeysBuiltByCache) {
+    ovms::RemoteFileIdentity identity;
+    ASSERT_TRUE(PeerFilesClient::parseKey(RemoteFilesCache::makeKey("gcs-crc32c", "4waSgw==", 9), identity));
+    EXPECT_EQ(identity.storage, "gcs-crc32c");
+    EXPECT_EQ(identity.contentId, "4waSgw==");
+    EXPECT_EQ(identity.size, 9);
+
+    EXPECT_FALSE(PeerFilesClient::parseKey("md5-616-3", identity));
+    EXPECT_FALSE(PeerFilesClient::parseKey("md5-6x-3", identity));
+    EXPECT_FALSE(PeerFilesClient::parseKey("md5-61-", identity));
+    EXPECT_FALSE(PeerFilesClient::parseKey("6162-3", identity));
+}
+
+TEST(PeerFilesClient, FilesIdentifiedByETagOnlyAreNotVerifiable) {
+    EXPECT_TRUE(PeerFilesClient::isVerifiable(RemoteFilesCache::makeKey("md5", "kAFQmDzST7DWlj99KOF/cg==", 3)));
+    EXPECT_TRUE(PeerFilesClient::isVerifiable(RemoteFilesCache::makeKey("s3", "\"900150983cd24fb0d6963f7d28e17f72\"", 3)));
+    EXPECT_FALSE(PeerFilesClient::isVerifiable(RemoteFilesCache::makeKey("s3", "\"some-etag\"", 3)));
+    EXPECT_FALSE(PeerFilesClient::isVerifiable(RemoteFilesCache::makeKey("azure-etag", "0x8D9", 3)));
+}
+
+TEST_F(PeerFilesClientTest, VerifiesMd5) {
+    auto key = RemoteFilesCache::makeKey("md5", "kAFQmDzST7DWlj99KOF/cg==", 3);
+    EXPECT_TRUE(PeerFilesClient::verify(key, writeFile("abc")));
+    EXPECT_FALSE(PeerFilesClient::verify(key, writeFile("abd")));
+    EXPECT_FALSE(PeerFilesClient::verify(key, writeFile("abcd")));
+}
+
+TEST_F(PeerFilesClientTest, VerifiesGcsCrc32c) {
+    auto key = RemoteFilesCache::makeKey("gcs-crc32c", "4waSgw==", 9);
+    EXPECT_TRUE(PeerFilesClient::verify(key, writeFile("123456789")));
+    EXPECT_FALSE(PeerFilesClient::verify(key, writeFile("123456780")));
+}
+
+TEST_F(PeerFilesClientTest, VerifiesS3SinglePartETag) {
+    auto key = RemoteFilesCache::makeKey("s3", "\"900150983cd24fb0d6963f7d28e17f72\"", 3);
+    EXPECT_TRUE(PeerFilesClient::verify(key, writeFile("abc")));
+    EXPECT_FALSE(PeerFilesClient::verify(key, writeFile("abd")));
+}
+
+TEST_F(PeerFilesClientTest, VerifiesS3MultipartETag) {
+    std::string content(5 * 1024 * 1024 + 3, '\0');
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>(i % 251);
+    }
+    auto path = writeFile(content);
+    EXPECT_TRUE(PeerFilesClient::verify(RemoteFilesCache::makeKey("s3", "\"aefaf346b764d808d1c99a1e03b85319-2\"", content.size()), path));
+    // Whole file MD5 is not ETag of multipart upload
+    EXPECT_FALSE(PeerFilesClient::verify(RemoteFilesCache::makeKey("s3", "\"eb646f361b0e8190355d40d9c69b295a-2\"", content.size()), path));
+}
+
+TEST(PeerFilesClient, DownloadFailsWithoutPeers) {
+    PeerFilesClient client({});
+    EXPECT_FALSE(client.download(RemoteFilesCache::makeKey("md5", "kAFQmDzST7DWlj99KOF/cg==", 3), "/tmp/unused"));
+}
@@ -31,12 +31,19 @@ using ::testing::ReturnRef;
 #pragma GCC diagnostic ignored "-Wunused-variable"
 class PredictValidation : public ::testing::Test {
     class MockModelInstance : public ovms::ModelInstance {
+        mutable ovms::TensorMetadataTable mockedInputsMetadata;
+
     public:
         MockModelInstance() :
             ModelInstance("UNUSED_NAME", 42) {}
         MOCK_METHOD(const ovms::tensor_map_t&, getInputsInfo, (), (const, override));
         MOCK_METHOD(size_t, getBatchSize, (), (const, override));
         MOCK_METHOD(const ovms::ModelConfig&, getModelConfig, (), (const, override));
+        // tests change mocked inputs and config after setup, so table is built from them on each validation
+        const ovms::TensorMetadataTable& getInputsMetadata() const override {
+            mockedInputsMetadata = ovms::TensorMetadataTable(getInputsInfo(), &getModelConfig());
+            return mockedInputsMetadata;
+        }
         const ovms::Status mockValidate(const tensorflow::serving::PredictRequest* request) {
             return validate(request);
         }
@@ -19,6 +19,7 @@
 #include <filesystem>
 #include <fstream>
 #include <future>
+#include <numeric>
 #include <thread>
 
 #include <gmock/gmock.h>
@@ -32,6 +33,7 @@
 #include "../prediction_service_utils.hpp"
 #include "../sequence_processing_spec.hpp"
 #include "../serialization.hpp"
+#include "../slow_requests.hpp"
 #include "test_utils.hpp"
 
 using testing::Each;
@@ -212,6 +214,9 @@ public:
     const ovms::Status mockValidate(const tensorflow::serving::PredictRequest* request) {
         return validate(request);
     }
+    const ovms::Status mockValidateAndDeserialize(const tensorflow::serving::PredictRequest* request, ovms::input_blobs_t& inputBlobs) {
+        return validateAndDeserialize(request, inputBlobs);
+    }
 };
 
 void performPrediction(const std::string modelName,
@@ -795,4 +800,558 @@ TEST_F(TestPredict, PerformInferenceWithBinaryInputNoInputShape) {
     ASSERT_EQ(performInferenceWithRequest(request, response, "increment_1x3x4x5"), ovms::StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS);
 }
 
+/*
+ * Scenario - concurrent requests are coalesced by dynamic batching.
+ *
+ * 1. Load dummy model with max_batch_size=4 and long batch timeout
+ * 2. Send requests with batch 1, 2 and 1 concurrently - expect each response to contain only its own results
+ */
+TEST_F(TestPredict, DynamicBatchingScattersOutputsToEachRequest) {
+    config.setMaxBatchSize(4);
+    config.setBatchTimeoutUs(1000000);
+    config.setBatchSize(4);
+    config.setNireq(1);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+
+    const std::vector<size_t> batchSizes{1, 2, 1};
+    std::vector<tensorflow::serving::PredictRequest> requests;
+    std::vector<std::vector<float>> requestData;
+    for (size_t i = 0; i < batchSizes.size(); ++i) {
+        requestData.emplace_back(batchSizes[i] * DUMMY_MODEL_INPUT_SIZE, static_cast<float>(i));
+        requests.emplace_back(preparePredictRequest(
+            {{DUMMY_MODEL_INPUT_NAME,
+                std::tuple<ovms::shape_t, tensorflow::DataType>{{batchSizes[i], 10}, tensorflow::DataType::DT_FLOAT}}},
+            requestData[i]));
+    }
+    std::vector<tensorflow::serving::PredictResponse> responses(batchSizes.size());
+    std::vector<ovms::Status> statuses(batchSizes.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < batchSizes.size(); ++i) {
+        threads.emplace_back([this, &requests, &responses, &statuses, i]() {
+            statuses[i] = performInferenceWithRequest(requests[i], responses[i]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < batchSizes.size(); ++i) {
+        ASSERT_EQ(statuses[i], ovms::StatusCode::OK) << statuses[i].string();
+        checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData[i], requests[i], responses[i], 1, batchSizes[i]);
+    }
+}
+
+TEST_F(TestPredict, DynamicBatchingRejectsRequestAboveMaxBatchSize) {
+    config.setMaxBatchSize(2);
+    config.setBatchSize(2);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithBatchSize(response, 3), ovms::StatusCode::INVALID_BATCH_SIZE);
+    ASSERT_EQ(performInferenceWithBatchSize(response, 1), ovms::StatusCode::OK);
+    ASSERT_EQ(response.outputs().at(DUMMY_MODEL_OUTPUT_NAME).tensor_shape().dim(0).size(), 1);
+}
+
+/**
+ * Scenario - alternate request shapes on shape=auto model with shape cache
+ *
+ * 1. Load model with shape=auto and shape_cache_size=1, initial internal shape (1,10)
+ * 2. Do the inferences with (1,12), (1,10) and again (1,12) shape - expect results matching each request
+ * 3. Expect model input shape untouched - no reload was performed
+ * 4. Do the inference with (1,5) shape - expect (1,12) network evicted and results still correct
+ */
+TEST_F(TestPredict, ShapeCacheServesAlternatingShapesWithoutReload) {
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setBatchingParams("0");
+    config.parseShapeParameter("auto");
+    config.setShapeCacheSize(1);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+
+    tensorflow::serving::PredictResponse response;
+    for (const ovms::shape_t& shape : std::vector<ovms::shape_t>{{1, 12}, {1, 10}, {1, 12}, {1, 5}}) {
+        ASSERT_EQ(performInferenceWithShape(response, shape), ovms::StatusCode::OK);
+        checkOutputShape(response, shape);
+    }
+
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, model, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(model->getInputsInfo().at(DUMMY_MODEL_INPUT_NAME)->getShape(), (ovms::shape_t{1, 10}));
+}
+
+/**
+ * Scenario - route requests to batch size variants without model reload
+ *
+ * 1. Load model with bs=auto and batch size variants 2 and 4, initial internal shape (1,10)
+ * 2. Do the inference with batch 2 - expect variant 2 used
+ * 3. Do the inference with batch 3 - expect padding to variant 4 and result (3,10) with request data
+ * 4. Expect default network batch size untouched - no reload was performed
+ */
+TEST_F(TestPredict, BatchSizeVariantsServeRequestsWithoutReload) {
+    config.setBatchingParams("auto");
+    config.setBatchSizeVariants({2, 4});
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithBatchSize(response, 2), ovms::StatusCode::OK);
+    checkOutputShape(response, {2, 10});
+
+    std::vector<float> requestData(3 * DUMMY_MODEL_INPUT_SIZE);
+    std::iota(requestData.begin(), requestData.end(), 0.f);
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{3, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1, 3);
+
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, model, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(model->getBatchSize(), 1);
+}
+
+/**
+ * Scenario - pad requests to sequence length buckets
+ *
+ * 1. Load model with sequence length buckets 4 and 10, second dimension of dummy input is the sequence dimension
+ * 2. Do the inference with shape (1,3) - expect padding to bucket 4 and result (1,3) with request data
+ */
+TEST_F(TestPredict, SequenceLengthBucketsPadRequestsAndTrimOutputs) {
+    config.setSequenceLengthBuckets({4, 10});
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+
+    std::vector<float> requestData{1., 2., 3.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 3}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    checkOutputShape(response, {1, 3});
+    const auto& output = response.outputs().at(DUMMY_MODEL_OUTPUT_NAME);
+    ASSERT_EQ(output.tensor_content().size(), 3 * sizeof(float));
+    const float* values = reinterpret_cast<const float*>(output.tensor_content().data());
+    for (size_t i = 0; i < requestData.size(); ++i) {
+        EXPECT_EQ(values[i], requestData[i] + 1) << i;
+    }
+}
+
+/*
+ * Scenario - pad asynchronous requests to sequence length buckets, as gRPC predict calls are served
+ *
+ * 1. Load model with sequence length buckets 4 and 10 and without dynamic batching
+ * 2. Do the inference with shape (1,3) through inferAsync - expect result (1,3) with request data
+ */
+TEST_F(TestPredict, SequenceLengthBucketsPadAsyncRequestsAndTrimOutputs) {
+    config.setSequenceLengthBuckets({4, 10});
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance(config.getName(), 0, model, unloadGuard), ovms::StatusCode::OK);
+
+    std::vector<float> requestData{1., 2., 3.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 3}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    std::promise<ovms::Status> completed;
+    auto completedFuture = completed.get_future();
+    ASSERT_EQ(model->inferAsync(&request, &response, unloadGuard,
+                  [&completed](const ovms::Status& status) { completed.set_value(status); }),
+        ovms::StatusCode::OK);
+    ASSERT_EQ(completedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    ASSERT_EQ(completedFuture.get(), ovms::StatusCode::OK);
+
+    checkOutputShape(response, {1, 3});
+    const auto& output = response.outputs().at(DUMMY_MODEL_OUTPUT_NAME);
+    ASSERT_EQ(output.tensor_content().size(), 3 * sizeof(float));
+    const float* values = reinterpret_cast<const float*>(output.tensor_content().data());
+    for (size_t i = 0; i < requestData.size(); ++i) {
+        EXPECT_EQ(values[i], requestData[i] + 1) << i;
+    }
+}
+
+/*
+ * Scenario - generate attention mask omitted from asynchronous request
+ *
+ * 1. Load sum model with sequence length buckets 4 and 10, second input is attention mask
+ * 2. Do the inference with only first input of shape (1,3) through inferAsync - expect result (1,3) with request data increased by mask of ones
+ */
+TEST_F(TestPredict, SequenceLengthBucketsGenerateAttentionMaskOfAsyncRequests) {
+    ovms::ModelConfig config = SUM_MODEL_CONFIG;
+    config.setSequenceLengthBuckets({4, 10});
+    config.setAttentionMaskInput(SUM_MODEL_INPUT_NAME_2);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance(config.getName(), 0, model, unloadGuard), ovms::StatusCode::OK);
+
+    std::vector<float> requestData{1., 2., 3.};
+    auto request = preparePredictRequest(
+        {{SUM_MODEL_INPUT_NAME_1,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 3}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    std::promise<ovms::Status> completed;
+    auto completedFuture = completed.get_future();
+    ASSERT_EQ(model->inferAsync(&request, &response, unloadGuard,
+                  [&completed](const ovms::Status& status) { completed.set_value(status); }),
+        ovms::StatusCode::OK);
+    ASSERT_EQ(completedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    ASSERT_EQ(completedFuture.get(), ovms::StatusCode::OK);
+
+    checkOutputShape(response, {1, 3}, SUM_MODEL_OUTPUT_NAME);
+    const auto& output = response.outputs().at(SUM_MODEL_OUTPUT_NAME);
+    ASSERT_EQ(output.tensor_content().size(), 3 * sizeof(float));
+    const float* values = reinterpret_cast<const float*>(output.tensor_content().data());
+    for (size_t i = 0; i < requestData.size(); ++i) {
+        EXPECT_EQ(values[i], requestData[i] + 1) << i;
+    }
+}
+
+TEST_F(TestPredict, WarmupOnLoadKeepsModelServing) {
+    config.setWarmupIterations(2);
+    config.setNireq(2);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, model, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(model->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+    // all infer requests are returned after warmup
+    int streamId;
+    EXPECT_TRUE(model->getInferRequestsQueue().tryGetIdleStream(streamId));
+    model->getInferRequestsQueue().returnStream(streamId);
+    unloadGuard.reset();
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+}
+
+TEST_F(TestPredict, LazyLoadingCompilesVersionOnFirstRequest) {
+    config.setLazyLoading(true);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto instance = manager.findModelByName("dummy")->getModelInstanceByVersion(1);
+    ASSERT_NE(instance, nullptr);
+    EXPECT_EQ(instance->getStatus().getState(), ovms::ModelVersionState::START);
+    EXPECT_EQ(instance->getMemoryFootprint(), 0);
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+    EXPECT_EQ(instance->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+    EXPECT_GT(instance->getMemoryFootprint(), 0);
+}
+
+TEST_F(TestPredict, LazyLoadingUnloadsLeastRecentlyUsedVersionOverMemoryBudget) {
+    config.setLazyLoading(true);
+    ovms::ModelConfig secondConfig = config;
+    secondConfig.setName("dummy_second");
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    ASSERT_EQ(manager.reloadModelWithVersions(secondConfig), ovms::StatusCode::OK_RELOADED);
+    // budget fits only one version
+    manager.setModelsMemoryBudgetBytes(1);
+
+    std::shared_ptr<ovms::ModelInstance> first;
+    std::shared_ptr<ovms::ModelInstance> second;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, first, unloadGuard), ovms::StatusCode::OK);
+    unloadGuard.reset();
+    EXPECT_EQ(first->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+
+    ASSERT_EQ(manager.getModelInstance("dummy_second", 0, second, unloadGuard), ovms::StatusCode::OK);
+    unloadGuard.reset();
+    EXPECT_EQ(second->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+    EXPECT_EQ(first->getStatus().getState(), ovms::ModelVersionState::START);
+
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, first, unloadGuard), ovms::StatusCode::OK);
+    unloadGuard.reset();
+    EXPECT_EQ(first->getStatus().getState(), ovms::ModelVersionState::AVAILABLE);
+    EXPECT_EQ(second->getStatus().getState(), ovms::ModelVersionState::START);
+}
+
+TEST_F(TestPredict, ResponseCacheServesRepeatedInputsWithoutInference) {
+    config.setResponseCacheSizeMb(1);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto instance = manager.findModelByName("dummy")->getModelInstanceByVersion(1);
+    ASSERT_NE(instance, nullptr);
+    ASSERT_NE(instance->getResponseCache(), nullptr);
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    EXPECT_EQ(instance->getResponseCache()->getMisses(), 1);
+    EXPECT_EQ(instance->getResponseCache()->size(), 1);
+
+    response.Clear();
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+    EXPECT_EQ(instance->getResponseCache()->getHits(), 1);
+
+    std::vector<float> otherRequestData{2., 3., 4., 5., 6., 7., 8., 9., 10., 11.};
+    auto otherRequest = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        otherRequestData);
+    response.Clear();
+    ASSERT_EQ(performInferenceWithRequest(otherRequest, response), ovms::StatusCode::OK);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, otherRequestData, otherRequest, response, 1);
+    EXPECT_EQ(instance->getResponseCache()->getMisses(), 2);
+
+    // reload drops cached responses
+    config.setNireq(3);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    ASSERT_NE(instance->getResponseCache(), nullptr);
+    EXPECT_EQ(instance->getResponseCache()->size(), 0);
+}
+
+TEST_F(TestPredict, BoundInputBlobsAreWrittenInPlace) {
+    config.setBindInputBlobs(true);
+    config.setNireq(1);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto instance = manager.findModelByName("dummy")->getModelInstanceByVersion(1);
+    ASSERT_NE(instance, nullptr);
+    auto& queue = instance->getInferRequestsQueue();
+    ASSERT_TRUE(queue.hasBoundInputBlobs());
+    auto boundBlob = queue.getBoundInputBlobs(0).at(DUMMY_MODEL_INPUT_NAME);
+
+    for (float offset : {0., 10.}) {
+        std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+        std::transform(requestData.begin(), requestData.end(), requestData.begin(), [offset](float value) { return value + offset; });
+        auto request = preparePredictRequest(
+            {{DUMMY_MODEL_INPUT_NAME,
+                std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+            requestData);
+        tensorflow::serving::PredictResponse response;
+        ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+        checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+        EXPECT_EQ(queue.getInferRequest(0).GetBlob(DUMMY_MODEL_INPUT_NAME), boundBlob);
+        EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(boundBlob)->rmap().as<const float*>()[0], requestData[0]);
+    }
+}
+
+TEST_F(TestPredict, RemoteBlobsFallBackToHostMemoryOnCpu) {
+    config.setRemoteBlobs(true);
+    config.setNireq(0);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto instance = manager.findModelByName("dummy")->getModelInstanceByVersion(1);
+    ASSERT_NE(instance, nullptr);
+    EXPECT_EQ(instance->getRemoteContext(), nullptr);
+    EXPECT_FALSE(instance->getInferRequestsQueue().hasBoundInputBlobs());
+    EXPECT_GE(instance->getNumOfParallelInferRequests(config), 2u);
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+}
+
+TEST_F(TestPredict, LockedMemoryIsReported) {
+    config.setLockMemory(true);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto instance = manager.findModelByName("dummy")->getModelInstanceByVersion(1);
+    ASSERT_NE(instance, nullptr);
+    // without enough RLIMIT_MEMLOCK memory is only pre-faulted, locked memory is counted in VmLck of the process
+    const auto usage = instance->getMemoryUsage();
+    EXPECT_LE(usage.locked, ovms::getLockedMemoryBytes());
+    EXPECT_EQ(usage.total(), usage.modelFiles + usage.inferRequests + usage.sequenceStates);
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+
+    config.setLockMemory(false);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    EXPECT_EQ(instance->getMemoryUsage().locked, 0);
+}
+
+TEST_F(TestPredict, SampledRequestsAreProfiledPerLayer) {
+    config.setLayerProfilingInterval(2);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto instance = manager.findModelByName("dummy")->getModelInstanceByVersion(1);
+    ASSERT_NE(instance, nullptr);
+    auto profiler = instance->getLayerProfiler();
+    ASSERT_NE(profiler, nullptr);
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    for (int i = 0; i < 4; ++i) {
+        tensorflow::serving::PredictResponse response;
+        ASSERT_EQ(performInferenceWithRequest(request, response), ovms::StatusCode::OK);
+        checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+    }
+    EXPECT_EQ(profiler->getTimings().getSamples(), 2);
+    EXPECT_FALSE(profiler->getTimings().getLayers().empty());
+
+    config.setLayerProfilingInterval(0);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    EXPECT_EQ(instance->getLayerProfiler(), nullptr);
+}
+
+TEST_F(TestPredict, ValidateAndDeserializeWrapsRequestDataInBlobsInSinglePass) {
+    config.setBatchingParams("auto");
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    auto instance = manager.findModelByName("dummy")->getModelInstanceByVersion(1);
+    ASSERT_NE(instance, nullptr);
+    auto mockInstance = std::static_pointer_cast<MockModelInstance>(instance);
+
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}});
+    ovms::input_blobs_t inputBlobs;
+    ASSERT_EQ(mockInstance->mockValidateAndDeserialize(&request, inputBlobs), ovms::StatusCode::OK);
+    ASSERT_EQ(inputBlobs.size(), 1);
+    EXPECT_EQ(inputBlobs[0].first, DUMMY_MODEL_INPUT_NAME);
+    EXPECT_EQ(inputBlobs[0].second->getTensorDesc(), instance->getInputsInfo().at(DUMMY_MODEL_INPUT_NAME)->getTensorDesc());
+    auto blobData = InferenceEngine::as<InferenceEngine::MemoryBlob>(inputBlobs[0].second)->rmap();
+    EXPECT_EQ(blobData.as<const char*>(), request.inputs().at(DUMMY_MODEL_INPUT_NAME).tensor_content().data());
+
+    // request served after reload gets no blobs built for current network
+    auto otherBatchRequest = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{2, 10}, tensorflow::DataType::DT_FLOAT}}});
+    EXPECT_EQ(mockInstance->mockValidateAndDeserialize(&otherBatchRequest, inputBlobs), ovms::StatusCode::BATCHSIZE_CHANGE_REQUIRED);
+    EXPECT_TRUE(inputBlobs.empty());
+}
+
+TEST_F(TestPredict, GetModelInstanceResolvesVersionsAddedAfterSnapshotWasPublished) {
+    manager.publishServablesSnapshot();
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    // served model is missing in published snapshot
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, model, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(model, manager.findModelByName("dummy")->getModelInstanceByVersion(1));
+    unloadGuard.reset();
+
+    std::shared_ptr<ovms::ModelInstance> modelFromSnapshot;
+    ASSERT_EQ(manager.getModelInstance("dummy", 1, modelFromSnapshot, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(model, modelFromSnapshot);
+    unloadGuard.reset();
+    EXPECT_EQ(manager.getModelInstance("dummy", 2, modelFromSnapshot, unloadGuard), ovms::StatusCode::MODEL_VERSION_MISSING);
+    EXPECT_EQ(manager.getModelInstance("missing", 0, modelFromSnapshot, unloadGuard), ovms::StatusCode::MODEL_NAME_MISSING);
+}
+
+TEST_F(TestPredict, InferAsyncInvokesCallbackWithSerializedResponse) {
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, model, unloadGuard), ovms::StatusCode::OK);
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    tensorflow::serving::PredictRequest request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    std::promise<ovms::Status> completed;
+    auto completedFuture = completed.get_future();
+    ASSERT_EQ(model->inferAsync(&request, &response, unloadGuard,
+                  [&completed](const ovms::Status& status) { completed.set_value(status); }),
+        ovms::StatusCode::OK);
+    EXPECT_EQ(unloadGuard, nullptr);
+    ASSERT_EQ(completedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    auto status = completedFuture.get();
+    ASSERT_EQ(status, ovms::StatusCode::OK) << status.string();
+    checkDummyResponse(DUMMY_MODEL_OUTPUT_NAME, requestData, request, response, 1);
+}
+
+TEST_F(TestPredict, InferAsyncRecordsStageTimeMetrics) {
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance("dummy", 0, model, unloadGuard), ovms::StatusCode::OK);
+    const auto& metrics = model->getMetrics();
+    const std::vector<ovms::Histogram*> stages{metrics.getInferRequestTime, metrics.deserializeTime, metrics.predictionTime, metrics.serializeTime};
+    std::vector<uint64_t> countsBefore;
+    for (auto* histogram : stages) {
+        ASSERT_NE(histogram, nullptr);
+        countsBefore.push_back(histogram->getCount());
+    }
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    tensorflow::serving::PredictRequest request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    std::promise<ovms::Status> completed;
+    auto completedFuture = completed.get_future();
+    ASSERT_EQ(model->inferAsync(&request, &response, unloadGuard,
+                  [&completed](const ovms::Status& status) { completed.set_value(status); }),
+        ovms::StatusCode::OK);
+    ASSERT_EQ(completedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    ASSERT_EQ(completedFuture.get(), ovms::StatusCode::OK);
+
+    // histograms are shared with other tests using the same model version
+    for (size_t i = 0; i < stages.size(); ++i) {
+        SCOPED_TRACE(i);
+        EXPECT_EQ(stages[i]->getCount(), countsBefore[i] + 1);
+    }
+}
+
+TEST_F(TestPredict, InferAsyncRecordsSlowRequest) {
+    // slow requests are kept per model name, so that records of other tests do not raise the threshold
+    config.setName("dummy_async_slow_requests");
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK_RELOADED);
+    std::shared_ptr<ovms::ModelInstance> model;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(manager.getModelInstance(config.getName(), 0, model, unloadGuard), ovms::StatusCode::OK);
+    auto& slowRequests = ovms::SlowRequestsLog::instance().getModel(config.getName(), model->getVersion());
+    ASSERT_TRUE(slowRequests.getRecords().empty());
+
+    std::vector<float> requestData{1., 2., 3., 4., 5., 6., 7., 8., 9., 10.};
+    tensorflow::serving::PredictRequest request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, 10}, tensorflow::DataType::DT_FLOAT}}},
+        requestData);
+    tensorflow::serving::PredictResponse response;
+    std::promise<ovms::Status> completed;
+    auto completedFuture = completed.get_future();
+    ASSERT_EQ(model->inferAsync(&request, &response, unloadGuard,
+                  [&completed](const ovms::Status& status) { completed.set_value(status); }),
+        ovms::StatusCode::OK);
+    ASSERT_EQ(completedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    ASSERT_EQ(completedFuture.get(), ovms::StatusCode::OK);
+
+    // record is completed before completion callback is called
+    auto records = slowRequests.getRecords();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_GT(records[0].durationUs, 0u);
+    ASSERT_EQ(records[0].stages.size(), 4u);
+    EXPECT_EQ(records[0].stages[0].name, "stream_wait");
+    EXPECT_EQ(records[0].stages[2].name, "inference");
+    ASSERT_EQ(records[0].inputs.size(), 1u);
+    EXPECT_EQ(records[0].inputs[0].name, DUMMY_MODEL_INPUT_NAME);
+    EXPECT_EQ(records[0].inputs[0].shape, (std::vector<int64_t>{1, 10}));
+}
+
 #pragma GCC diagnostic pop
@@ -0,0 +1,122 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../remote_files_cache.hpp"
+#include "test_utils.hpp"
+
+using ovms::RemoteFilesCache;
+
+class RemoteFilesCacheTest : public TestWithTempDir {
+protected:
+    void SetUp() override {
+        TestWithTempDir::SetUp();
+        cachePath = directoryPath + "/cache";
+        modelPath = directoryPath + "/model";
+        std::filesystem::create_directories(cachePath);
+        std::filesystem::create_directories(modelPath);
+    }
+
+    std::string writeModelFile(const std::string& name, const std::string& content) {
+        auto path = modelPath + "/" + name;
+        std::ofstream file(path, std::ios::binary);
+        file << content;
+        return path;
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    std::string cachePath;
+    std::string modelPath;
+};
+
+TEST_F(RemoteFilesCacheTest, KeysDifferForDifferentIdentities) {
+    EXPECT_EQ(RemoteFilesCache::makeKey("s3", "\"ab\"", 10), RemoteFilesCache::makeKey("s3", "\"ab\"", 10));
+    EXPECT_NE(RemoteFilesCache::makeKey("s3", "ab", 10), RemoteFilesCache::makeKey("s3", "ab", 11));
+    EXPECT_NE(RemoteFilesCache::makeKey("s3", "ab", 10), RemoteFilesCache::makeKey("s3", "ac", 10));
+    EXPECT_NE(RemoteFilesCache::makeKey("s3", "ab", 10), RemoteFilesCache::makeKey("md5", "ab", 10));
+    EXPECT_EQ(RemoteFilesCache::makeKey("md5", "a/+=", 4).find('/'), std::string::npos);
+}
+
+TEST_F(RemoteFilesCacheTest, FetchesStoredFileAfterRestart) {
+    auto key = RemoteFilesCache::makeKey("md5", "hash", 7);
+    {
+        RemoteFilesCache cache(cachePath, 1024);
+        EXPECT_FALSE(cache.fetch(key, modelPath + "/copy.bin"));
+        cache.store(key, writeModelFile("model.bin", "content"));
+        EXPECT_EQ(cache.getTotalSize(), 7);
+    }
+    RemoteFilesCache cache(cachePath, 1024);
+    EXPECT_EQ(cache.getTotalSize(), 7);
+    ASSERT_TRUE(cache.fetch(key, modelPath + "/copy.bin"));
+    EXPECT_EQ(readFile(modelPath + "/copy.bin"), "content");
+
+    // Cached file stays valid after local copy of the model is removed
+    std::filesystem::remove_all(modelPath);
+    std::filesystem::create_directories(modelPath);
+    ASSERT_TRUE(cache.fetch(key, modelPath + "/other.bin"));
+    EXPECT_EQ(readFile(modelPath + "/other.bin"), "content");
+}
+
+TEST_F(RemoteFilesCacheTest, EvictsLeastRecentlyUsedFiles) {
+    RemoteFilesCache cache(cachePath, 10);
+    auto first = RemoteFilesCache::makeKey("md5", "first", 4);
+    auto second = RemoteFilesCache::makeKey("md5", "second", 4);
+    auto third = RemoteFilesCache::makeKey("md5", "third", 4);
+    cache.store(first, writeModelFile("1.bin", "1111"));
+    cache.store(second, writeModelFile("2.bin", "2222"));
+    ASSERT_TRUE(cache.fetch(first, modelPath + "/1_copy.bin"));
+    cache.store(third, writeModelFile("3.bin", "3333"));
+
+    EXPECT_EQ(cache.getTotalSize(), 8);
+    EXPECT_TRUE(cache.fetch(first, modelPath + "/1_copy.bin"));
+    EXPECT_FALSE(cache.fetch(second, modelPath + "/2_copy.bin"));
+    EXPECT_TRUE(cache.fetch(third, modelPath + "/3_copy.bin"));
+    EXPECT_FALSE(std::filesystem::exists(cachePath + "/" + second));
+}
+
+TEST_F(RemoteFilesCacheTest, SkipsFilesLargerThanLimit) {
+    RemoteFilesCache cache(cachePath, 4);
+    auto key = RemoteFilesCache::makeKey("md5", "large", 5);
+    cache.store(key, writeModelFile("large.bin", "55555"));
+    EXPECT_EQ(cache.getTotalSize(), 0);
+    EXPECT_FALSE(cache.fetch(key, modelPath + "/large_copy.bin"));
+}
+
+TEST_F(RemoteFilesCacheTest, ReadsRangesOfCachedFiles) {
+    RemoteFilesCache cache(cachePath, 1024);
+    auto key = RemoteFilesCache::makeKey("md5", "hash", 7);
+    std::string bytes;
+    EXPECT_EQ(cache.readRange(key, 0, 6, bytes), ovms::StatusCode::PEER_FILE_NOT_FOUND);
+    cache.store(key, writeModelFile("model.bin", "content"));
+
+    ASSERT_EQ(cache.readRange(key, 0, 6, bytes), ovms::StatusCode::OK);
+    EXPECT_EQ(bytes, "content");
+    ASSERT_EQ(cache.readRange(key, 3, 4, bytes), ovms::StatusCode::OK);
+    EXPECT_EQ(bytes, "te");
+    EXPECT_EQ(cache.readRange(key, 3, 7, bytes), ovms::StatusCode::PEER_FILE_RANGE_INVALID);
+    EXPECT_EQ(cache.readRange(key, 4, 3, bytes), ovms::StatusCode::PEER_FILE_RANGE_INVALID);
+}
@@ -0,0 +1,168 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../request_coalescer.hpp"
+
+using namespace ovms;
+
+namespace {
+const size_t REQUESTS_COUNT = 8;
+
+ResponseCache::Key makeKey(uint64_t hash, const std::string& inputs = "inputs") {
+    ResponseCache::Key key;
+    key.hash = hash;
+    key.inputs = inputs;
+    return key;
+}
+
+Status fillOutput(tensorflow::serving::PredictResponse& response, float value) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto& output = (*response.mutable_outputs())["output"];
+    output.set_dtype(tensorflow::DataType::DT_FLOAT);
+    output.add_float_val(value);
+    return StatusCode::OK;
+}
+}  // namespace
+
+TEST(RequestCoalescer, ConcurrentIdenticalRequestsShareInference) {
+    RequestCoalescer coalescer;
+    std::atomic<int> inferences = 0;
+    std::vector<tensorflow::serving::PredictResponse> responses(REQUESTS_COUNT);
+    std::vector<Status> statuses(REQUESTS_COUNT);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < REQUESTS_COUNT; ++i) {
+        threads.emplace_back([&, i]() {
+            statuses[i] = coalescer.infer(makeKey(1), responses[i], RequestContext(), [&]() {
+                inferences++;
+                return fillOutput(responses[i], 1.0);
+            });
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // requests started after the first one finished run their own inference
+    EXPECT_EQ(inferences + coalescer.getCoalesced(), REQUESTS_COUNT);
+    EXPECT_LT(inferences, REQUESTS_COUNT);
+    for (size_t i = 0; i < REQUESTS_COUNT; ++i) {
+        EXPECT_EQ(statuses[i], StatusCode::OK);
+        ASSERT_EQ(responses[i].outputs().count("output"), 1);
+        EXPECT_EQ(responses[i].outputs().at("output").float_val(0), 1.0);
+    }
+}
+
+TEST(RequestCoalescer, RequestsWithDifferentKeysRunOwnInference) {
+    RequestCoalescer coalescer;
+    std::vector<tensorflow::serving::PredictResponse> responses(2);
+    std::thread other([&]() {
+        EXPECT_EQ(coalescer.infer(makeKey(2), responses[1], RequestContext(), [&]() { return fillOutput(responses[1], 2.0); }), StatusCode::OK);
+    });
+    EXPECT_EQ(coalescer.infer(makeKey(1), responses[0], RequestContext(), [&]() { return fillOutput(responses[0], 1.0); }), StatusCode::OK);
+    other.join();
+    EXPECT_EQ(coalescer.getCoalesced(), 0);
+    EXPECT_EQ(responses[0].outputs().at("output").float_val(0), 1.0);
+    EXPECT_EQ(responses[1].outputs().at("output").float_val(0), 2.0);
+}
+
+TEST(RequestCoalescer, RequestsWithCollidingHashRunOwnInference) {
+    RequestCoalescer coalescer;
+    tensorflow::serving::PredictResponse leaderResponse;
+    std::atomic<bool> started = false;
+    std::thread leader([&]() {
+        EXPECT_EQ(coalescer.infer(makeKey(1, "first"), leaderResponse, RequestContext(), [&]() {
+            started = true;
+            return fillOutput(leaderResponse, 1.0);
+        }),
+            StatusCode::OK);
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    tensorflow::serving::PredictResponse response;
+    bool ranOwnInference = false;
+    EXPECT_EQ(coalescer.infer(makeKey(1, "second"), response, RequestContext(), [&]() {
+        ranOwnInference = true;
+        return fillOutput(response, 2.0);
+    }),
+        StatusCode::OK);
+    leader.join();
+    EXPECT_TRUE(ranOwnInference);
+    EXPECT_EQ(coalescer.getCoalesced(), 0);
+    EXPECT_EQ(leaderResponse.outputs().at("output").float_val(0), 1.0);
+    EXPECT_EQ(response.outputs().at("output").float_val(0), 2.0);
+}
+
+TEST(RequestCoalescer, WaitingRequestsRunOwnInferenceWhenSharedOneFails) {
+    RequestCoalescer coalescer;
+    std::atomic<int> inferences = 0;
+    std::vector<tensorflow::serving::PredictResponse> responses(REQUESTS_COUNT);
+    std::vector<Status> statuses(REQUESTS_COUNT);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < REQUESTS_COUNT; ++i) {
+        threads.emplace_back([&, i]() {
+            statuses[i] = coalescer.infer(makeKey(1), responses[i], RequestContext(), [&]() {
+                if (++inferences == 1) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    return Status(StatusCode::INTERNAL_ERROR);
+                }
+                return fillOutput(responses[i], 1.0);
+            });
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    size_t failed = 0;
+    for (size_t i = 0; i < REQUESTS_COUNT; ++i) {
+        if (!statuses[i].ok()) {
+            failed++;
+            continue;
+        }
+        EXPECT_EQ(responses[i].outputs().at("output").float_val(0), 1.0);
+    }
+    EXPECT_EQ(failed, 1);
+}
+
+TEST(RequestCoalescer, CancelledWaitingRequestStopsWaiting) {
+    RequestCoalescer coalescer;
+    tensorflow::serving::PredictResponse leaderResponse;
+    std::atomic<bool> started = false;
+    std::thread leader([&]() {
+        coalescer.infer(makeKey(1), leaderResponse, RequestContext(), [&]() {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            return fillOutput(leaderResponse, 1.0);
+        });
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    RequestContext context;
+    context.deadline = RequestContext::clock_t::now() + std::chrono::milliseconds(50);
+    tensorflow::serving::PredictResponse response;
+    bool ranOwnInference = false;
+    EXPECT_EQ(coalescer.infer(makeKey(1), response, context, [&]() { ranOwnInference = true; return Status(StatusCode::OK); }), StatusCode::REQUEST_DEADLINE_EXCEEDED);
+    EXPECT_FALSE(ranOwnInference);
+    leader.join();
+    EXPECT_EQ(coalescer.getCoalesced(), 0);
+}
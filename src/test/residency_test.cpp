@@ -0,0 +1,47 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../residency.hpp"
+
+using namespace ovms;
+
+TEST(ResidencyAdvertiser, SerializesResidentModels) {
+    ModelResidency warm;
+    warm.name = "resnet";
+    warm.version = 2;
+    warm.state = ModelVersionState::AVAILABLE;
+    warm.warm = true;
+    warm.inferRequestsInUse = 3;
+    warm.inferRequestsWaiting = 1;
+    warm.inferRequests = 4;
+    warm.memoryBytes = 1024;
+    ModelResidency cold;
+    cold.name = "bert";
+    cold.version = 1;
+    cold.lazy = true;
+    EXPECT_EQ(ResidencyAdvertiser::toJson("replica-0", true, {warm, cold}),
+        R"({"server":"replica-0","ready":true,"models":[)"
+        R"({"name":"resnet","version":2,"state":"AVAILABLE","warm":true,"lazy":false,"in_use":3,"waiting":1,"infer_requests":4,"memory_bytes":1024},)"
+        R"({"name":"bert","version":1,"state":"START","warm":false,"lazy":true,"in_use":0,"waiting":0,"infer_requests":0,"memory_bytes":0}]})");
+}
+
+TEST(ResidencyAdvertiser, SerializesServerWithoutModels) {
+    EXPECT_EQ(ResidencyAdvertiser::toJson("replica-0", false, {}), R"({"server":"replica-0","ready":false,"models":[]})");
+}
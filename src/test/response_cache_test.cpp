@@ -0,0 +1,96 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../response_cache.hpp"
+
+using namespace ovms;
+
+namespace {
+tensorflow::serving::PredictRequest prepareRequest(const std::vector<float>& data) {
+    tensorflow::serving::PredictRequest request;
+    auto& input = (*request.mutable_inputs())["input"];
+    input.set_dtype(tensorflow::DataType::DT_FLOAT);
+    input.mutable_tensor_shape()->add_dim()->set_size(data.size());
+    input.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    return request;
+}
+
+tensorflow::serving::PredictResponse prepareResponse(float value) {
+    tensorflow::serving::PredictResponse response;
+    auto& output = (*response.mutable_outputs())["output"];
+    output.set_dtype(tensorflow::DataType::DT_FLOAT);
+    output.add_float_val(value);
+    return response;
+}
+}  // namespace
+
+TEST(ResponseCache, KeyDependsOnInputContentsAndOutputFilter) {
+    auto request = prepareRequest({1., 2., 3.});
+    EXPECT_EQ(ResponseCache::computeKey(request), ResponseCache::computeKey(prepareRequest({1., 2., 3.})));
+    EXPECT_FALSE(ResponseCache::computeKey(request) == ResponseCache::computeKey(prepareRequest({1., 2., 4.})));
+
+    auto filtered = request;
+    filtered.add_output_filter("output");
+    EXPECT_FALSE(ResponseCache::computeKey(request) == ResponseCache::computeKey(filtered));
+}
+
+TEST(ResponseCache, FindReturnsStoredOutputs) {
+    ResponseCache cache(1024 * 1024);
+    auto key = ResponseCache::computeKey(prepareRequest({1., 2., 3.}));
+    tensorflow::serving::PredictResponse response;
+    EXPECT_FALSE(cache.find(key, response));
+    cache.insert(key, prepareResponse(1.0));
+    ASSERT_TRUE(cache.find(key, response));
+    ASSERT_EQ(response.outputs().count("output"), 1u);
+    EXPECT_EQ(response.outputs().at("output").float_val(0), 1.0);
+    EXPECT_EQ(cache.getHits(), 1u);
+    EXPECT_EQ(cache.getMisses(), 1u);
+}
+
+TEST(ResponseCache, HashCollisionWithDifferentInputsIsMiss) {
+    ResponseCache cache(1024 * 1024);
+    auto key = ResponseCache::computeKey(prepareRequest({1., 2., 3.}));
+    auto colliding = ResponseCache::computeKey(prepareRequest({4., 5., 6.}));
+    colliding.hash = key.hash;
+    cache.insert(key, prepareResponse(1.0));
+
+    tensorflow::serving::PredictResponse response;
+    EXPECT_FALSE(cache.find(colliding, response));
+    EXPECT_EQ(response.outputs().size(), 0u);
+
+    // entry stored first is kept
+    cache.insert(colliding, prepareResponse(2.0));
+    EXPECT_EQ(cache.size(), 1u);
+    ASSERT_TRUE(cache.find(key, response));
+    EXPECT_EQ(response.outputs().at("output").float_val(0), 1.0);
+}
+
+TEST(ResponseCache, StoredInputsCountTowardsCapacity) {
+    auto key = ResponseCache::computeKey(prepareRequest(std::vector<float>(256, 1.0)));
+    auto response = prepareResponse(1.0);
+    ResponseCache tooSmall(response.ByteSizeLong() + key.inputs.size() - 1);
+    tooSmall.insert(key, response);
+    EXPECT_EQ(tooSmall.size(), 0u);
+
+    ResponseCache cache(response.ByteSizeLong() + key.inputs.size());
+    cache.insert(key, response);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.getUsedBytes(), cache.getCapacityBytes());
+}
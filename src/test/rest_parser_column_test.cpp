@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include "../rest_parser.hpp"
+#include "../sparse_tensor.hpp"
 #include "test_utils.hpp"
 
 using namespace ovms;
@@ -611,3 +612,72 @@ TEST(RestParserColumn, RemoveUnnecessaryInputs) {
     ASSERT_EQ(parser.getProto().inputs().count("k"), 1);
     ASSERT_EQ(parser.getProto().inputs().count("l"), 1);
 }
+
+TEST(RestParserColumn, StreamedInputsFollowedByInstancesHaveUnknownOrder) {
+    RestParser parser(prepareTensors({{"i", {1, 2}}}));
+
+    EXPECT_EQ(parser.parse(R"({"inputs":{"i":[[1,2]]},"signature_name":"","instances":[{"i":[1,2]}]})"), StatusCode::REST_PREDICT_UNKNOWN_ORDER);
+}
+
+TEST(RestParserColumn, SkipsUnrelatedMembersWhileStreaming) {
+    RestParser parser(prepareTensors({{"i", {2, 2}}}, InferenceEngine::Precision::I64));
+
+    ASSERT_EQ(parser.parse(R"({"meta":{"inputs":[1,{"a":null}],"flag":true},"inputs":{"i":[[1,-2],[3,4]]}})"), StatusCode::OK);
+
+    EXPECT_EQ(parser.getOrder(), Order::COLUMN);
+    EXPECT_EQ(parser.getFormat(), Format::NAMED);
+    const auto& input = parser.getProto().inputs().at("i");
+    EXPECT_THAT(asVector(input.tensor_shape()), ElementsAre(2, 2));
+    EXPECT_THAT(asVector<int64_t>(input.tensor_content()), ElementsAre(1, -2, 3, 4));
+}
+
+TEST(RestParserColumn, ParsesOutputFilter) {
+    RestParser parser(prepareTensors({{"i", {1, 2}}}));
+
+    ASSERT_EQ(parser.parse(R"({"output_filter":["a","b"],"inputs":{"i":[[1,2]]}})"), StatusCode::OK);
+    EXPECT_THAT(parser.getProto().output_filter(), ElementsAre("a", "b"));
+
+    // binary input is parsed by document parser
+    RestParser binaryParser(prepareTensors({{"i", {1, 1}}}));
+    ASSERT_EQ(binaryParser.parse(R"({"inputs":{"i":[{"b64":"AQI="}]},"output_filter":["b"]})"), StatusCode::OK);
+    EXPECT_THAT(binaryParser.getProto().output_filter(), ElementsAre("b"));
+}
+
+TEST(RestParserColumn, OutputFilterHasToListNames) {
+    for (const std::string outputFilter : {R"("a")", R"([1])", R"([["a"]])", R"({"a":1})"}) {
+        RestParser parser(prepareTensors({{"i", {1, 2}}}));
+        EXPECT_EQ(parser.parse((R"({"inputs":{"i":[[1,2]]},"output_filter":)" + outputFilter + "}").c_str()), StatusCode::INVALID_OUTPUT_FILTER) << outputFilter;
+    }
+}
+
+TEST(RestParserColumn, ParsesSparseInput) {
+    RestParser parser(prepareTensors({{"i", {2, 1000}}}));
+
+    ASSERT_EQ(parser.parse(R"({"inputs":{"i":{"indices":[[0,3],[1,999]],"values":[0.5,1.5],"dense_shape":[2,1000]}}})"), StatusCode::OK);
+    const auto& input = parser.getProto().inputs().at("i");
+    ASSERT_TRUE(isSparseTensor(input));
+    EXPECT_EQ(input.dtype(), DataType::DT_FLOAT);
+    EXPECT_THAT(asVector(input.tensor_shape()), ElementsAre(2, 1000));
+    EXPECT_TRUE(input.tensor_content().empty());
+    const auto& indices = input.variant_val(0).tensors(0);
+    const auto& values = input.variant_val(0).tensors(1);
+    EXPECT_EQ(indices.dtype(), DataType::DT_INT64);
+    EXPECT_THAT(asVector(indices.tensor_shape()), ElementsAre(2, 2));
+    EXPECT_THAT(asVector<int64_t>(indices.tensor_content()), ElementsAre(0, 3, 1, 999));
+    EXPECT_EQ(values.dtype(), DataType::DT_FLOAT);
+    EXPECT_THAT(asVector(values.tensor_shape()), ElementsAre(2));
+    EXPECT_THAT(asVector<float>(values.tensor_content()), ElementsAre(0.5, 1.5));
+}
+
+TEST(RestParserColumn, SparseInputHasToListIndexOfEachValue) {
+    for (const std::string sparse : {
+             R"({"indices":[[0,3]],"values":[0.5,1.5],"dense_shape":[2,1000]})",
+             R"({"indices":[[0,3],[1]],"values":[0.5,1.5],"dense_shape":[2,1000]})",
+             R"({"indices":[[0,3],[1,0.5]],"values":[0.5,1.5],"dense_shape":[2,1000]})",
+             R"({"indices":[[0,3],[1,2]],"values":[0.5,"a"],"dense_shape":[2,1000]})",
+             R"({"indices":[[0,3],[1,2]],"values":[0.5,1.5],"dense_shape":[]})",
+             R"({"indices":[[0,3],[1,2]],"values":[0.5,1.5],"dense_shape":[2,-1]})"}) {
+        RestParser parser(prepareTensors({{"i", {2, 1000}}}));
+        EXPECT_EQ(parser.parse((R"({"inputs":{"i":)" + sparse + "}}").c_str()), StatusCode::REST_COULD_NOT_PARSE_INPUT) << sparse;
+    }
+}
@@ -639,3 +639,28 @@ TEST(RestParserRow, RemoveUnnecessaryInputs) {
     ASSERT_EQ(parser.getProto().inputs().count("k"), 1);
     ASSERT_EQ(parser.getProto().inputs().count("l"), 1);
 }
+
+TEST(RestParserRow, ValuesAreWrittenToPreallocatedTensorContent) {
+    RestParser parser(prepareTensors({{"i", {2, 3}}}));
+    const char* buffer = parser.getProto().inputs().at("i").tensor_content().data();
+
+    ASSERT_EQ(parser.parse(R"({"instances":[{"i":[1,2.5,3]},{"i":[4,5,6]}]})"), StatusCode::OK);
+
+    const auto& input = parser.getProto().inputs().at("i");
+    EXPECT_EQ(input.tensor_content().data(), buffer);
+    EXPECT_THAT(asVector(input.tensor_shape()), ElementsAre(2, 3));
+    EXPECT_THAT(asVector<float>(input.tensor_content()), ElementsAre(1, 2.5, 3, 4, 5, 6));
+}
+
+TEST(RestParserRow, InputNotInModelIsParsedAfterPartiallyStreamedRequest) {
+    RestParser parser(prepareTensors({{"i", {1, 2}}}));
+
+    ASSERT_EQ(parser.parse(R"({"instances":[{"i":[1.0,2.0],"extra":[7]}]})"), StatusCode::OK);
+
+    EXPECT_EQ(parser.getOrder(), Order::ROW);
+    EXPECT_EQ(parser.getFormat(), Format::NAMED);
+    ASSERT_EQ(parser.getProto().inputs().size(), 2);
+    EXPECT_THAT(asVector<float>(parser.getProto().inputs().at("i").tensor_content()), ElementsAre(1.0, 2.0));
+    EXPECT_EQ(parser.getProto().inputs().at("extra").dtype(), DataType::DT_INT32);
+    EXPECT_THAT(asVector<int32_t>(parser.getProto().inputs().at("extra").tensor_content()), ElementsAre(7));
+}
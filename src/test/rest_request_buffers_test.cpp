@@ -0,0 +1,95 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../rest_parser.hpp"
+#include "../rest_request_buffers.hpp"
+#include "test_utils.hpp"
+
+using namespace ovms;
+
+TEST(RestRequestBuffers, ParserReusesBuffersOfRecycledProto) {
+    tensorflow::serving::PredictRequest recycled;
+    auto tensors = prepareTensors({{"i", {1, 4}}});
+    const char* json = R"({"instances": [[1.0, 2.0, 3.0, 4.0]]})";
+    const char* content = nullptr;
+    {
+        RestParser parser(tensors, recycled);
+        ASSERT_EQ(parser.parse(json), StatusCode::OK);
+        content = parser.getProto().inputs().at("i").tensor_content().data();
+        parser.getProto().mutable_model_spec()->set_name("dummy");
+        recycled.Swap(&parser.getProto());
+    }
+    (*recycled.mutable_inputs())["other"].set_dtype(tensorflow::DataType::DT_FLOAT);
+    RestParser parser(tensors, recycled);
+    ASSERT_EQ(parser.parse(R"({"instances": [[5.0, 6.0, 7.0, 8.0]]})"), StatusCode::OK);
+    const auto& proto = parser.getProto();
+    EXPECT_FALSE(proto.has_model_spec());
+    ASSERT_EQ(proto.inputs().size(), 1u);
+    const auto& input = proto.inputs().at("i");
+    EXPECT_EQ(input.tensor_content().data(), content);
+    ASSERT_EQ(input.tensor_content().size(), 4 * sizeof(float));
+    EXPECT_EQ(reinterpret_cast<const float*>(input.tensor_content().data())[3], 8.0f);
+    ASSERT_EQ(input.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(input.tensor_shape().dim(1).size(), 4);
+}
+
+TEST(RestRequestBuffers, KeepsResponseEntriesForTheSameServableAndOutputFilter) {
+    RestRequestBuffers buffers;
+    tensorflow::serving::PredictRequest request;
+    request.mutable_model_spec()->set_name("dummy");
+    buffers.prepareResponse(request);
+    auto& output = (*buffers.response.mutable_outputs())["a"];
+    output.set_dtype(tensorflow::DataType::DT_FLOAT);
+    output.mutable_tensor_content()->assign(1024, '1');
+    const char* content = output.tensor_content().data();
+    buffers.response.mutable_model_spec()->set_name("fallback");
+
+    buffers.prepareResponse(request);
+    EXPECT_FALSE(buffers.response.has_model_spec());
+    ASSERT_EQ(buffers.response.outputs().size(), 1u);
+    auto& kept = (*buffers.response.mutable_outputs())["a"];
+    EXPECT_EQ(kept.dtype(), tensorflow::DataType::DT_INVALID);
+    EXPECT_TRUE(kept.tensor_content().empty());
+    kept.set_dtype(tensorflow::DataType::DT_FLOAT);
+    kept.mutable_tensor_content()->assign(1024, '2');
+    EXPECT_EQ(kept.tensor_content().data(), content);
+
+    // entries not written by infer are not part of the response
+    (*buffers.response.mutable_outputs())["b"];
+    removeUnwrittenOutputs(buffers.response);
+    EXPECT_EQ(buffers.response.outputs().size(), 1u);
+
+    request.add_output_filter("a");
+    buffers.prepareResponse(request);
+    EXPECT_TRUE(buffers.response.outputs().empty());
+}
+
+TEST(RestRequestBuffers, ReleasesBuffersAboveLimit) {
+    RestRequestBuffers buffers;
+    buffers.body.reserve(RestRequestBuffers::MAX_REUSED_BUFFER_BYTES + 1);
+    buffers.output.assign(1024, 'x');
+    (*buffers.request.mutable_inputs())["small"].mutable_tensor_content()->assign(1024, '1');
+    (*buffers.request.mutable_inputs())["large"].mutable_tensor_content()->reserve(RestRequestBuffers::MAX_REUSED_BUFFER_BYTES + 1);
+    buffers.trim();
+    EXPECT_LE(buffers.body.capacity(), RestRequestBuffers::MAX_REUSED_BUFFER_BYTES);
+    EXPECT_TRUE(buffers.output.empty());
+    EXPECT_GE(buffers.output.capacity(), 1024u);
+    EXPECT_EQ(buffers.request.inputs().count("small"), 1u);
+    EXPECT_EQ(buffers.request.inputs().count("large"), 0u);
+}
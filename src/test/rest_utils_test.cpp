@@ -13,10 +13,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <limits>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "../rest_utils.hpp"
+#include "absl/strings/escaping.h"
 
 using namespace ovms;
 
@@ -280,6 +285,31 @@ TEST_F(RestUtilsTest, Base64DecodeWrongLength) {
     EXPECT_EQ(decodeBase64(bytes, decodedBytes), StatusCode::REST_BASE64_DECODE_ERROR);
 }
 
+TEST_F(RestUtilsTest, Base64DecodeMatchesAbsl) {
+    std::string data(1000, '\0');
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i * 7919 % 251);
+    }
+    for (size_t size : {0, 1, 2, 3, 23, 24, 25, 100, 1000}) {
+        std::string encoded;
+        absl::Base64Escape(data.substr(0, size), &encoded);
+        std::vector<std::string> inputs{encoded, encoded.substr(0, encoded.find('=')), " " + encoded, encoded + "*"};
+        if (encoded.size() > 40) {
+            inputs.push_back(encoded.substr(0, 33) + '\n' + encoded.substr(33));
+            inputs.push_back(encoded.substr(0, 10) + '\xc3' + encoded.substr(11));
+        }
+        for (auto& input : inputs) {
+            std::string expected;
+            const bool valid = absl::Base64Unescape(input, &expected);
+            std::string decodedBytes;
+            EXPECT_EQ(decodeBase64(input.data(), input.size(), decodedBytes), valid ? StatusCode::OK : StatusCode::REST_BASE64_DECODE_ERROR) << input;
+            if (valid) {
+                EXPECT_EQ(decodedBytes, expected) << input;
+            }
+        }
+    }
+}
+
 TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_Float) {
     float data = 92.5f;
     output->set_dtype(tensorflow::DataType::DT_FLOAT);
@@ -299,6 +329,31 @@ TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_Float) {
 })");
 }
 
+TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_FloatShortestRepresentation) {
+    output->mutable_tensor_shape()->mutable_dim(1)->set_size(6);
+    float data[6] = {0.1f, -0.0f, 1e-7f, 3.0e20f, std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::infinity()};
+    output->set_dtype(tensorflow::DataType::DT_FLOAT);
+    output->mutable_tensor_content()->assign(reinterpret_cast<const char*>(data), sizeof(data));
+    ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, Order::ROW), StatusCode::OK);
+    EXPECT_EQ(json, R"({
+    "predictions": [[0.1, -0.0, 1e-7, 300000000000000000000.0, NaN, -Infinity]
+    ]
+})");
+}
+
+TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_RowOrderBatchSizeDiffer) {
+    float data = 1.0f;
+    output->set_dtype(tensorflow::DataType::DT_FLOAT);
+    output->mutable_tensor_content()->assign(reinterpret_cast<const char*>(&data), sizeof(float));
+    auto& other = (*proto.mutable_outputs())["other"];
+    other.set_dtype(tensorflow::DataType::DT_FLOAT);
+    other.mutable_tensor_shape()->add_dim()->set_size(2);
+    other.add_float_val(1.0f);
+    other.add_float_val(2.0f);
+    EXPECT_EQ(makeJsonFromPredictResponse(proto, &json, Order::ROW), StatusCode::REST_PROTO_TO_STRING_ERROR);
+    EXPECT_EQ(makeJsonFromPredictResponse(proto, &json, Order::COLUMN), StatusCode::OK);
+}
+
 TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_Double) {
     double data = 15.99;
     output->set_dtype(tensorflow::DataType::DT_DOUBLE);
@@ -570,3 +625,27 @@ TEST_F(RestUtilsValTest, MakeJsonFromPredictResponse_ColumnOrder_ContainTwoUint3
 
     EXPECT_TRUE(is_in_first_order || is_in_second_order);
 }
+
+TEST(RestUtils, ParsesMultipartBody) {
+    const std::string body =
+        "preamble\r\n"
+        "--boundary\r\n"
+        "Content-Disposition: form-data; name=\"image\"; filename=\"a.png\"\r\n"
+        "Content-Type: image/png\r\n"
+        "\r\n"
+        "first\r\nimage\r\n"
+        "--boundary\r\n"
+        "\r\n"
+        "second\r\n"
+        "--boundary--\r\n";
+    std::vector<std::string_view> parts;
+    ASSERT_EQ(parseMultipartBody("multipart/form-data; boundary=\"boundary\"", body, parts), StatusCode::OK);
+    ASSERT_EQ(parts.size(), 2);
+    EXPECT_EQ(parts[0], "first\r\nimage");
+    EXPECT_EQ(parts[1], "second");
+
+    EXPECT_EQ(parseMultipartBody("multipart/form-data", body, parts), StatusCode::REST_MALFORMED_REQUEST);
+    EXPECT_EQ(parseMultipartBody("multipart/form-data; boundary=other", body, parts), StatusCode::REST_MALFORMED_REQUEST);
+    EXPECT_EQ(parseMultipartBody("multipart/form-data; boundary=boundary", "--boundary--", parts), StatusCode::REST_MALFORMED_REQUEST);
+    EXPECT_EQ(parseMultipartBody("multipart/form-data; boundary=boundary", "--boundary\r\n\r\nunterminated", parts), StatusCode::REST_MALFORMED_REQUEST);
+}
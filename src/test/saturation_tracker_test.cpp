@@ -0,0 +1,63 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "../saturation_tracker.hpp"
+
+using namespace ovms;
+
+TEST(SaturationTracker, WaitBucketBoundsCoverWaits) {
+    for (uint64_t waitUs : {0, 1, 3, 4, 5, 7, 8, 100, 1000, 123456}) {
+        const size_t bucket = SaturationTracker::getWaitBucket(waitUs);
+        EXPECT_GE(SaturationTracker::getWaitBucketUpperBound(bucket), waitUs);
+        if (bucket > 0) {
+            EXPECT_LT(SaturationTracker::getWaitBucketUpperBound(bucket - 1), waitUs);
+        }
+    }
+}
+
+TEST(SaturationTracker, ComputesSaturationOfCompleteSeconds) {
+    SaturationTracker tracker;
+    const auto start = SaturationTracker::clock_t::time_point(std::chrono::seconds(1000));
+    // 2 infer requests, each held for 10ms by 100 requests per second over the whole window, so half busy
+    for (int second = 0; second < 10; ++second) {
+        const auto now = start + std::chrono::seconds(second);
+        for (int i = 0; i < 100; ++i) {
+            tracker.recordAcquired(i < 90 ? 0 : 5000, now);
+            tracker.recordReturned(10'000, now);
+        }
+    }
+    // records of the current second are not included
+    tracker.recordReturned(1'000'000, start + std::chrono::seconds(10));
+
+    auto saturation = tracker.getSaturation(2, start + std::chrono::seconds(10));
+    EXPECT_DOUBLE_EQ(saturation.busyFraction, 0.5);
+    EXPECT_GE(saturation.queueWaitP95Us, 5000);
+    EXPECT_LT(saturation.queueWaitP95Us, 5000 * 5 / 4);
+    EXPECT_DOUBLE_EQ(saturation.serviceTimeUs, 10'000);
+    EXPECT_DOUBLE_EQ(saturation.throughput, 100);
+    EXPECT_DOUBLE_EQ(saturation.capacity, 200);
+    EXPECT_DOUBLE_EQ(saturation.headroom, 100);
+
+    // seconds older than the window are dropped
+    saturation = tracker.getSaturation(2, start + std::chrono::seconds(30));
+    EXPECT_EQ(saturation.busyFraction, 0);
+    EXPECT_EQ(saturation.queueWaitP95Us, 0);
+    EXPECT_EQ(saturation.throughput, 0);
+    EXPECT_EQ(saturation.headroom, 0);
+}
@@ -15,7 +15,9 @@
 //*****************************************************************************
 #include <chrono>
 #include <limits>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -310,6 +312,90 @@ TEST(SequenceManager, MultiManagersAllIdleSequences) {
     }
 }
 
+TEST(SequenceManager, RemoveExpiredSequences) {
+    MockedSequenceManager sequenceManager(24, "dummy", 1, 10);
+    ovms::SequenceProcessingSpec spec1(ovms::SEQUENCE_START, 42);
+    ovms::SequenceProcessingSpec spec2(ovms::SEQUENCE_START, 314);
+    ASSERT_EQ(sequenceManager.mockCreateSequence(spec1), ovms::StatusCode::OK);
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(5), ovms::StatusCode::OK);
+    ASSERT_EQ(sequenceManager.mockCreateSequence(spec2), ovms::StatusCode::OK);
+
+    // Request of sequence 42 postpones its expiry
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(8), ovms::StatusCode::OK);
+    ovms::SequenceProcessingSpec step(ovms::NO_CONTROL_INPUT, 42);
+    ASSERT_EQ(sequenceManager.processRequestedSpec(step), ovms::StatusCode::OK);
+
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(10), ovms::StatusCode::OK);
+    EXPECT_TRUE(sequenceManager.sequenceExists(42));
+    EXPECT_TRUE(sequenceManager.sequenceExists(314));
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(15), ovms::StatusCode::OK);
+    EXPECT_TRUE(sequenceManager.sequenceExists(42));
+    EXPECT_FALSE(sequenceManager.sequenceExists(314));
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(18), ovms::StatusCode::OK);
+    EXPECT_FALSE(sequenceManager.sequenceExists(42));
+    EXPECT_EQ(sequenceManager.getSequencesCount(), 0);
+}
+
+TEST(SequenceManager, RemoveExpiredSequencesSkipsLockedAndRecreatedSequences) {
+    MockedSequenceManager sequenceManager(24, "dummy", 1, 10);
+    ovms::SequenceProcessingSpec spec1(ovms::SEQUENCE_START, 42);
+    ovms::SequenceProcessingSpec spec2(ovms::SEQUENCE_START, 314);
+    ASSERT_EQ(sequenceManager.mockCreateSequence(spec1), ovms::StatusCode::OK);
+    ASSERT_EQ(sequenceManager.mockCreateSequence(spec2), ovms::StatusCode::OK);
+
+    // Sequence 314 is ended and started again later, entry of the first one is stale
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(5), ovms::StatusCode::OK);
+    ASSERT_EQ(sequenceManager.removeSequence(314), ovms::StatusCode::OK);
+    ASSERT_EQ(sequenceManager.mockCreateSequence(spec2), ovms::StatusCode::OK);
+
+    std::unique_lock<std::mutex> sequenceLock(sequenceManager.getSequence(42).getMutex());
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(10), ovms::StatusCode::OK);
+    EXPECT_TRUE(sequenceManager.sequenceExists(42));
+    EXPECT_TRUE(sequenceManager.sequenceExists(314));
+    sequenceLock.unlock();
+
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(15), ovms::StatusCode::OK);
+    EXPECT_FALSE(sequenceManager.sequenceExists(314));
+    ASSERT_EQ(sequenceManager.removeExpiredSequences(20), ovms::StatusCode::OK);
+    EXPECT_FALSE(sequenceManager.sequenceExists(42));
+}
+
+TEST(SequenceManager, CompressIdleSequences) {
+    ovms::model_memory_state_t newState;
+    DummyStatefulModel model;
+    InferenceEngine::InferRequest auxInferRequest = model.createInferRequest();
+    model.setVariableState(auxInferRequest, std::vector<float>{10});
+    newState.push_back(model.getVariableState(auxInferRequest));
+
+    MockedSequenceManager sequenceManager(24, "dummy", 1, 0, 10);
+    ovms::SequenceProcessingSpec spec1(ovms::SEQUENCE_START, 42);
+    ovms::SequenceProcessingSpec spec2(ovms::SEQUENCE_START, 314);
+    ASSERT_EQ(sequenceManager.mockCreateSequence(spec1), ovms::StatusCode::OK);
+    ASSERT_EQ(sequenceManager.mockCreateSequence(spec2), ovms::StatusCode::OK);
+    sequenceManager.getSequence(42).updateMemoryState(newState);
+    sequenceManager.getSequence(314).updateMemoryState(newState);
+
+    ASSERT_EQ(sequenceManager.compressIdleSequences(5), ovms::StatusCode::OK);
+    ovms::SequenceProcessingSpec step(ovms::NO_CONTROL_INPUT, 42);
+    ASSERT_EQ(sequenceManager.processRequestedSpec(step), ovms::StatusCode::OK);
+
+    ASSERT_EQ(sequenceManager.compressIdleSequences(10), ovms::StatusCode::OK);
+    EXPECT_FALSE(sequenceManager.getSequence(42).isMemoryStateCompressed());
+    EXPECT_TRUE(sequenceManager.getSequence(314).isMemoryStateCompressed());
+    ASSERT_EQ(sequenceManager.compressIdleSequences(15), ovms::StatusCode::OK);
+    EXPECT_TRUE(sequenceManager.getSequence(42).isMemoryStateCompressed());
+
+    // Compressed sequences are kept and next request schedules compression again
+    ASSERT_EQ(sequenceManager.getSequence(314).restoreMemoryState(), ovms::StatusCode::OK);
+    ovms::SequenceProcessingSpec restoreStep(ovms::NO_CONTROL_INPUT, 314);
+    ASSERT_EQ(sequenceManager.processRequestedSpec(restoreStep), ovms::StatusCode::OK);
+    ASSERT_EQ(sequenceManager.compressIdleSequences(24), ovms::StatusCode::OK);
+    EXPECT_FALSE(sequenceManager.getSequence(314).isMemoryStateCompressed());
+    ASSERT_EQ(sequenceManager.compressIdleSequences(25), ovms::StatusCode::OK);
+    EXPECT_TRUE(sequenceManager.getSequence(314).isMemoryStateCompressed());
+    EXPECT_EQ(sequenceManager.getSequencesCount(), 2);
+}
+
 TEST(SequenceManager, ExceedMaxSequenceNumber) {
     MockedSequenceManager sequenceManager(5, "dummy", 1);
     uint64_t sequenceId = 1;
@@ -324,4 +410,58 @@ TEST(SequenceManager, ExceedMaxSequenceNumber) {
         ASSERT_EQ(sequenceManager.mockCreateSequence(spec), ovms::StatusCode::MAX_SEQUENCE_NUMBER_REACHED);
     }
 }
+TEST(SequenceManager, ConcurrentSequenceCreationWithGeneratedIds) {
+    const uint32_t threadsCount = 8;
+    const uint32_t sequencesPerThread = 100;
+    const uint32_t maxSequenceNumber = threadsCount * sequencesPerThread / 2;
+    MockedSequenceManager sequenceManager(maxSequenceNumber, "dummy", 1);
+    std::vector<std::vector<uint64_t>> createdIds(threadsCount);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadsCount; t++) {
+        threads.emplace_back([&sequenceManager, &createdIds, t]() {
+            for (uint32_t i = 0; i < sequencesPerThread; i++) {
+                ovms::SequenceProcessingSpec spec(ovms::SEQUENCE_START, 0);
+                if (sequenceManager.processRequestedSpec(spec) == ovms::StatusCode::OK) {
+                    createdIds[t].push_back(spec.getSequenceId());
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::set<uint64_t> uniqueIds;
+    for (const auto& ids : createdIds) {
+        uniqueIds.insert(ids.begin(), ids.end());
+    }
+    EXPECT_EQ(uniqueIds.size(), maxSequenceNumber);
+    EXPECT_EQ(sequenceManager.getSequencesCount(), maxSequenceNumber);
+    for (auto sequenceId : uniqueIds) {
+        EXPECT_TRUE(sequenceManager.sequenceExists(sequenceId));
+    }
+}
+
+TEST(SequenceManager, ShardLockStatsCountContendedLocks) {
+    MockedSequenceManager sequenceManager(24, "dummy", 1);
+    ovms::SequenceProcessingSpec spec(ovms::SEQUENCE_START, 1);
+    ASSERT_EQ(sequenceManager.processRequestedSpec(spec), ovms::StatusCode::OK);
+    auto stats = sequenceManager.getShardLockStats();
+    EXPECT_EQ(stats.acquisitions, 1);
+    EXPECT_EQ(stats.contentions, 0);
+
+    // sequence of the same shard waits for the held lock
+    auto heldLock = sequenceManager.lockShard(1);
+    std::thread waiting([&sequenceManager]() {
+        ovms::SequenceProcessingSpec spec(ovms::SEQUENCE_START, 1 + ovms::SequenceManager::SHARDS_COUNT);
+        EXPECT_EQ(sequenceManager.processRequestedSpec(spec), ovms::StatusCode::OK);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    heldLock.unlock();
+    waiting.join();
+    stats = sequenceManager.getShardLockStats();
+    EXPECT_EQ(stats.acquisitions, 3);
+    EXPECT_EQ(stats.contentions, 1);
+    EXPECT_GE(stats.waitUs, 10'000);
+}
+
 #pragma GCC diagnostic pop
@@ -0,0 +1,130 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../sequence_padding.hpp"
+#include "../tensorinfo.hpp"
+
+using namespace ovms;
+
+namespace {
+template <typename T>
+void setTensor(tensorflow::TensorProto& tensor, tensorflow::DataType dtype, const std::vector<int64_t>& shape, const std::vector<T>& values) {
+    tensor.set_dtype(dtype);
+    for (auto dimension : shape) {
+        tensor.mutable_tensor_shape()->add_dim()->set_size(dimension);
+    }
+    tensor.set_tensor_content(std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T)));
+}
+
+template <typename T>
+std::vector<T> getValues(const tensorflow::TensorProto& tensor) {
+    const T* data = reinterpret_cast<const T*>(tensor.tensor_content().data());
+    return std::vector<T>(data, data + tensor.tensor_content().size() / sizeof(T));
+}
+
+tensor_map_t createBertInputs(size_t sequenceLength) {
+    tensor_map_t inputs;
+    inputs["input_ids"] = std::make_shared<TensorInfo>("input_ids", InferenceEngine::Precision::I32, shape_t{2, sequenceLength});
+    inputs["attention_mask"] = std::make_shared<TensorInfo>("attention_mask", InferenceEngine::Precision::I64, shape_t{2, sequenceLength});
+    inputs["scale"] = std::make_shared<TensorInfo>("scale", InferenceEngine::Precision::FP32, shape_t{1});
+    return inputs;
+}
+}  // namespace
+
+TEST(SequencePadding, RequestSequenceLengthSharedBySequenceInputs) {
+    auto inputs = createBertInputs(512);
+    tensorflow::serving::PredictRequest request;
+    setTensor<int32_t>((*request.mutable_inputs())["input_ids"], tensorflow::DataType::DT_INT32, {2, 3}, {1, 2, 3, 4, 5, 6});
+    setTensor<float>((*request.mutable_inputs())["scale"], tensorflow::DataType::DT_FLOAT, {1}, {1.0});
+    size_t length = 0;
+    EXPECT_FALSE(getRequestSequenceLength(request, inputs, "", length));
+    ASSERT_TRUE(getRequestSequenceLength(request, inputs, "attention_mask", length));
+    EXPECT_EQ(length, 3);
+
+    setTensor<int64_t>((*request.mutable_inputs())["attention_mask"], tensorflow::DataType::DT_INT64, {2, 4}, {1, 1, 1, 1, 1, 1, 1, 1});
+    EXPECT_FALSE(getRequestSequenceLength(request, inputs, "attention_mask", length));
+}
+
+TEST(SequencePadding, TypedValuesAreNotPadded) {
+    auto inputs = createBertInputs(512);
+    tensorflow::serving::PredictRequest request;
+    auto& input = (*request.mutable_inputs())["input_ids"];
+    input.set_dtype(tensorflow::DataType::DT_INT32);
+    input.mutable_tensor_shape()->add_dim()->set_size(1);
+    input.mutable_tensor_shape()->add_dim()->set_size(2);
+    input.add_int_val(1);
+    input.add_int_val(2);
+    size_t length = 0;
+    EXPECT_FALSE(getRequestSequenceLength(request, inputs, "attention_mask", length));
+}
+
+TEST(SequencePadding, SequenceInputsZeroPaddedAndAttentionMaskGenerated) {
+    auto inputs = createBertInputs(5);
+    tensorflow::serving::PredictRequest request;
+    request.mutable_model_spec()->set_name("bert");
+    request.add_output_filter("logits");
+    setTensor<int32_t>((*request.mutable_inputs())["input_ids"], tensorflow::DataType::DT_INT32, {2, 3}, {1, 2, 3, 4, 5, 6});
+    setTensor<float>((*request.mutable_inputs())["scale"], tensorflow::DataType::DT_FLOAT, {1}, {0.5});
+
+    tensorflow::serving::PredictRequest padded;
+    ASSERT_TRUE(padRequestToSequenceLength(request, inputs, "attention_mask", 3, 5, padded));
+    EXPECT_EQ(padded.model_spec().name(), "bert");
+    ASSERT_EQ(padded.output_filter_size(), 1);
+    ASSERT_EQ(padded.inputs_size(), 3);
+
+    const auto& ids = padded.inputs().at("input_ids");
+    ASSERT_EQ(ids.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(ids.tensor_shape().dim(0).size(), 2);
+    EXPECT_EQ(ids.tensor_shape().dim(1).size(), 5);
+    EXPECT_EQ(getValues<int32_t>(ids), (std::vector<int32_t>{1, 2, 3, 0, 0, 4, 5, 6, 0, 0}));
+
+    const auto& mask = padded.inputs().at("attention_mask");
+    EXPECT_EQ(mask.dtype(), tensorflow::DataType::DT_INT64);
+    EXPECT_EQ(mask.tensor_shape().dim(1).size(), 5);
+    EXPECT_EQ(getValues<int64_t>(mask), (std::vector<int64_t>{1, 1, 1, 0, 0, 1, 1, 1, 0, 0}));
+
+    EXPECT_EQ(getValues<float>(padded.inputs().at("scale")), (std::vector<float>{0.5}));
+}
+
+TEST(SequencePadding, AttentionMaskFromRequestIsPadded) {
+    auto inputs = createBertInputs(4);
+    tensorflow::serving::PredictRequest request;
+    setTensor<int32_t>((*request.mutable_inputs())["input_ids"], tensorflow::DataType::DT_INT32, {1, 2}, {7, 8});
+    setTensor<int64_t>((*request.mutable_inputs())["attention_mask"], tensorflow::DataType::DT_INT64, {1, 2}, {1, 0});
+    tensorflow::serving::PredictRequest padded;
+    ASSERT_TRUE(padRequestToSequenceLength(request, inputs, "attention_mask", 2, 4, padded));
+    EXPECT_EQ(getValues<int64_t>(padded.inputs().at("attention_mask")), (std::vector<int64_t>{1, 0, 0, 0}));
+}
+
+TEST(SequencePadding, SequenceOutputsTrimmedToRequestLength) {
+    tensorflow::serving::PredictResponse response;
+    setTensor<float>((*response.mutable_outputs())["logits"], tensorflow::DataType::DT_FLOAT, {2, 3, 2},
+        {1, 2, 3, 4, 0, 0, 5, 6, 7, 8, 0, 0});
+    setTensor<float>((*response.mutable_outputs())["pooled"], tensorflow::DataType::DT_FLOAT, {2, 3}, {1, 2, 3, 4, 5, 6});
+    trimResponseToSequenceLength(response, {"logits"}, 2, 3);
+
+    const auto& logits = response.outputs().at("logits");
+    EXPECT_EQ(logits.tensor_shape().dim(1).size(), 2);
+    EXPECT_EQ(getValues<float>(logits), (std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8}));
+    const auto& pooled = response.outputs().at("pooled");
+    EXPECT_EQ(pooled.tensor_shape().dim(1).size(), 3);
+    EXPECT_EQ(getValues<float>(pooled).size(), 6);
+}
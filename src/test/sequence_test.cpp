@@ -14,6 +14,7 @@
 // limitations under the License.
 //*****************************************************************************
 #include <chrono>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -58,4 +59,102 @@ TEST(Sequence, UpdateSequenceState) {
     stateBlobSequenceData.assign(InferenceEngine::as<InferenceEngine::MemoryBlob>(sequenceMemoryState.at(stateName))->rmap().as<float*>(), InferenceEngine::as<InferenceEngine::MemoryBlob>(sequenceMemoryState.at(stateName))->rmap().as<float*>() + 1);
     EXPECT_EQ(stateBlobSequenceData, expectedState);
 }
+
+TEST(Sequence, CompressAndRestoreSequenceState) {
+    ovms::model_memory_state_t newState;
+    DummyStatefulModel model;
+    std::vector<float> expectedState{10};
+    InferenceEngine::InferRequest auxInferRequest = model.createInferRequest();
+    model.setVariableState(auxInferRequest, expectedState);
+    newState.push_back(model.getVariableState(auxInferRequest));
+    ovms::Sequence sequence(3);
+    ASSERT_EQ(sequence.updateMemoryState(newState), ovms::StatusCode::OK);
+    const std::string stateName = model.getStateName();
+
+    EXPECT_EQ(sequence.getMemoryStateBytes(), sizeof(float));
+    ASSERT_EQ(sequence.compressMemoryState(), ovms::StatusCode::OK);
+    EXPECT_TRUE(sequence.isMemoryStateCompressed());
+    EXPECT_TRUE(sequence.getMemoryState().empty());
+    EXPECT_GT(sequence.getMemoryStateBytes(), 0);
+
+    ASSERT_EQ(sequence.restoreMemoryState(), ovms::StatusCode::OK);
+    EXPECT_FALSE(sequence.isMemoryStateCompressed());
+    ASSERT_TRUE(sequence.getMemoryState().count(stateName));
+    const auto& blob = sequence.getMemoryState().at(stateName);
+    EXPECT_EQ(blob->getTensorDesc(), model.getVariableState(auxInferRequest).GetState()->getTensorDesc());
+    float* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<float*>();
+    EXPECT_EQ(std::vector<float>(data, data + 1), expectedState);
+}
+
+TEST(Sequence, ExportAndImportSequenceState) {
+    ovms::model_memory_state_t newState;
+    DummyStatefulModel model;
+    std::vector<float> expectedState{10};
+    InferenceEngine::InferRequest auxInferRequest = model.createInferRequest();
+    model.setVariableState(auxInferRequest, expectedState);
+    newState.push_back(model.getVariableState(auxInferRequest));
+    ovms::Sequence sequence(3);
+    ASSERT_EQ(sequence.updateMemoryState(newState), ovms::StatusCode::OK);
+    const std::string stateName = model.getStateName();
+
+    std::string serialized;
+    ASSERT_EQ(sequence.exportMemoryState(serialized), ovms::StatusCode::OK);
+    // compressed state is exported as it is
+    ASSERT_EQ(sequence.compressMemoryState(), ovms::StatusCode::OK);
+    std::string serializedCompressed;
+    ASSERT_EQ(sequence.exportMemoryState(serializedCompressed), ovms::StatusCode::OK);
+    EXPECT_EQ(serialized, serializedCompressed);
+
+    ovms::Sequence imported(3);
+    ASSERT_EQ(imported.importMemoryState(serialized), ovms::StatusCode::OK);
+    ASSERT_TRUE(imported.getMemoryState().count(stateName));
+    const auto& blob = imported.getMemoryState().at(stateName);
+    EXPECT_EQ(blob->getTensorDesc(), model.getVariableState(auxInferRequest).GetState()->getTensorDesc());
+    float* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<float*>();
+    EXPECT_EQ(std::vector<float>(data, data + 1), expectedState);
+
+    ovms::Sequence malformed(4);
+    EXPECT_EQ(malformed.importMemoryState(serialized.substr(0, serialized.size() - 1)), ovms::StatusCode::SEQUENCE_STATE_INVALID);
+    EXPECT_EQ(malformed.importMemoryState("state"), ovms::StatusCode::SEQUENCE_STATE_INVALID);
+    EXPECT_TRUE(malformed.getMemoryState().empty());
+}
+
+TEST(Sequence, UpdateSequenceStateReusesBuffers) {
+    ovms::model_memory_state_t newState;
+    DummyStatefulModel model;
+    InferenceEngine::InferRequest auxInferRequest = model.createInferRequest();
+    model.setVariableState(auxInferRequest, std::vector<float>{10});
+    newState.push_back(model.getVariableState(auxInferRequest));
+    ovms::Sequence sequence(3);
+    ASSERT_EQ(sequence.updateMemoryState(newState), ovms::StatusCode::OK);
+    const std::string stateName = model.getStateName();
+    InferenceEngine::Blob::Ptr firstBlob = sequence.getMemoryState().at(stateName);
+
+    std::vector<float> expectedState{20};
+    model.setVariableState(auxInferRequest, expectedState);
+    newState.clear();
+    newState.push_back(model.getVariableState(auxInferRequest));
+    ASSERT_EQ(sequence.updateMemoryState(newState), ovms::StatusCode::OK);
+
+    const InferenceEngine::Blob::Ptr& secondBlob = sequence.getMemoryState().at(stateName);
+    EXPECT_EQ(firstBlob.get(), secondBlob.get());
+    EXPECT_EQ(*InferenceEngine::as<InferenceEngine::MemoryBlob>(secondBlob)->rmap().as<float*>(), expectedState[0]);
+}
+
+TEST(Sequence, UpdateSequenceStateFromBatchedState) {
+    InferenceEngine::Blob::Ptr batchedState;
+    ASSERT_EQ(ovms::createSharedBlob(batchedState, InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {3, 2}, InferenceEngine::Layout::NC)), ovms::StatusCode::OK);
+    std::vector<float> data{1, 2, 3, 4, 5, 6};
+    std::memcpy(InferenceEngine::as<InferenceEngine::MemoryBlob>(batchedState)->wmap().as<float*>(), data.data(), data.size() * sizeof(float));
+    ovms::Sequence sequence(3);
+    sequence.setIdle();
+    ASSERT_EQ(sequence.updateMemoryState("state", batchedState, 1), ovms::StatusCode::OK);
+    EXPECT_FALSE(sequence.isIdle());
+
+    const InferenceEngine::Blob::Ptr& blob = sequence.getMemoryState().at("state");
+    EXPECT_EQ(blob->getTensorDesc().getDims(), (InferenceEngine::SizeVector{1, 2}));
+    const float* saved = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const float*>();
+    EXPECT_EQ(std::vector<float>(saved, saved + 2), (std::vector<float>{3, 4}));
+    EXPECT_EQ(sequence.updateMemoryState("state", batchedState, 3), ovms::StatusCode::INTERNAL_ERROR);
+}
 #pragma GCC diagnostic pop
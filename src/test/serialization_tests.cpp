@@ -29,6 +29,7 @@
 #pragma GCC diagnostic pop
 
 #include "../serialization.hpp"
+#include "opencv2/opencv.hpp"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #include "ovtestutils.hpp"
@@ -218,6 +219,168 @@ TEST(SerializeTFGRPCPredictResponse, ShouldSuccessForSupportedPrecision) {
     EXPECT_TRUE(status.ok());
 }
 
+TEST(SerializeTFGRPCPredictResponse, ShouldWriteOutputsDirectlyIntoBoundResponseBuffers) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(std::filesystem::current_path().u8string() + "/src/test/dummy/1/dummy.xml");
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    InferenceEngine::InferRequest inferRequest = execNetwork.CreateInferRequest();
+    float* input = InferenceEngine::as<InferenceEngine::MemoryBlob>(inferRequest.GetBlob("b"))->wmap().as<float*>();
+    for (size_t i = 0; i < 10; i++) {
+        input[i] = i;
+    }
+    ovms::tensor_map_t outputs;
+    outputs["a"] = std::make_shared<ovms::TensorInfo>("a", Precision::FP32, shape_t{1, 10}, InferenceEngine::Layout::NC);
+    auto originalOutput = inferRequest.GetBlob("a");
+
+    PredictResponse response;
+    {
+        ResponseOutputsBinding binding(inferRequest);
+        ASSERT_EQ(binding.bind(outputs, &response), ovms::StatusCode::OK);
+        const char* content = response.outputs().at("a").tensor_content().data();
+        inferRequest.Infer();
+        ASSERT_EQ(serializePredictResponse(inferRequest, outputs, &response), ovms::StatusCode::OK);
+        EXPECT_EQ(response.outputs().at("a").tensor_content().data(), content);
+    }
+    EXPECT_EQ(inferRequest.GetBlob("a"), originalOutput);
+
+    const auto& output = response.outputs().at("a");
+    ASSERT_EQ(output.tensor_content().size(), 10 * sizeof(float));
+    ASSERT_EQ(output.tensor_shape().dim_size(), 2);
+    const float* values = reinterpret_cast<const float*>(output.tensor_content().data());
+    for (size_t i = 0; i < 10; i++) {
+        EXPECT_EQ(values[i], i + 1);
+    }
+}
+
+TEST(SerializeTFGRPCPredictResponse, ShouldPostprocessOutputsInsteadOfSerializingThem) {
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>("scores", "prob", Precision::FP32, shape_t{3, 4}, InferenceEngine::Layout::NC);
+    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<float>(tensorInfo->getTensorDesc());
+    blob->allocate();
+    const std::vector<float> scores{
+        0.1, 0.6, 0.2, 0.1,
+        0.7, 0.1, 0.7, 0.5,
+        0.0, 0.0, 0.3, 0.9};
+    std::copy(scores.begin(), scores.end(), InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<float*>());
+
+    PredictResponse response;
+    OutputPostprocessing topK{"top_k", 2, 0.0f};
+    // skips the first entry of batch
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, topK, 1, 2), ovms::StatusCode::OK);
+    const auto& values = response.outputs().at("prob");
+    const auto& indices = response.outputs().at("prob" + POSTPROCESSING_INDICES_SUFFIX);
+    EXPECT_EQ(values.dtype(), tensorflow::DataType::DT_FLOAT);
+    EXPECT_EQ(indices.dtype(), tensorflow::DataType::DT_INT32);
+    ASSERT_EQ(values.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(values.tensor_shape().dim(0).size(), 2);
+    EXPECT_EQ(values.tensor_shape().dim(1).size(), 2);
+    const float* topValues = reinterpret_cast<const float*>(values.tensor_content().data());
+    const int32_t* topIndices = reinterpret_cast<const int32_t*>(indices.tensor_content().data());
+    EXPECT_THAT(std::vector<float>(topValues, topValues + 4), testing::ElementsAre(0.7f, 0.7f, 0.9f, 0.3f));
+    EXPECT_THAT(std::vector<int32_t>(topIndices, topIndices + 4), testing::ElementsAre(0, 2, 3, 2));
+
+    OutputPostprocessing argmax{"argmax", 0, 0.0f};
+    response.Clear();
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, argmax, 0, 3), ovms::StatusCode::OK);
+    const auto& positions = response.outputs().at("prob");
+    ASSERT_EQ(positions.tensor_content().size(), 3 * sizeof(int32_t));
+    const int32_t* best = reinterpret_cast<const int32_t*>(positions.tensor_content().data());
+    EXPECT_THAT(std::vector<int32_t>(best, best + 3), testing::ElementsAre(1, 0, 3));
+    EXPECT_EQ(response.outputs().count("prob" + POSTPROCESSING_INDICES_SUFFIX), 0);
+
+    OutputPostprocessing threshold{"threshold", 0, 0.6f};
+    response.Clear();
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, threshold, 0, 3), ovms::StatusCode::OK);
+    const auto& selected = response.outputs().at("prob");
+    const auto& selectedIndices = response.outputs().at("prob" + POSTPROCESSING_INDICES_SUFFIX);
+    ASSERT_EQ(selected.tensor_content().size(), 4 * sizeof(float));
+    ASSERT_EQ(selectedIndices.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(selectedIndices.tensor_shape().dim(0).size(), 4);
+    const int32_t* pairs = reinterpret_cast<const int32_t*>(selectedIndices.tensor_content().data());
+    EXPECT_THAT(std::vector<int32_t>(pairs, pairs + 8), testing::ElementsAre(0, 1, 1, 0, 1, 2, 2, 3));
+}
+
+TEST(SerializeTFGRPCPredictResponse, ShouldDowncastAndEncodeOutputs) {
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>("scores", "prob", Precision::FP32, shape_t{2, 2}, InferenceEngine::Layout::NC);
+    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<float>(tensorInfo->getTensorDesc());
+    blob->allocate();
+    const std::vector<float> values{1.0, 0.5, -2.0, 65504.0};
+    std::copy(values.begin(), values.end(), InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<float*>());
+
+    PredictResponse response;
+    OutputPostprocessing fp16{"fp16"};
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, fp16, 0, 2), ovms::StatusCode::OK);
+    EXPECT_EQ(response.outputs().at("prob").dtype(), tensorflow::DataType::DT_HALF);
+    ASSERT_EQ(response.outputs().at("prob").tensor_shape().dim_size(), 2);
+    ASSERT_EQ(response.outputs().at("prob").tensor_content().size(), 4 * sizeof(uint16_t));
+    const uint16_t* halves = reinterpret_cast<const uint16_t*>(response.outputs().at("prob").tensor_content().data());
+    EXPECT_THAT(std::vector<uint16_t>(halves, halves + 4), testing::ElementsAre(0x3C00, 0x3800, 0xC000, 0x7BFF));
+
+    OutputPostprocessing bf16{"bf16"};
+    response.Clear();
+    // skips the first entry of batch
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, bf16, 1, 1), ovms::StatusCode::OK);
+    EXPECT_EQ(response.outputs().at("prob").dtype(), tensorflow::DataType::DT_BFLOAT16);
+    EXPECT_EQ(response.outputs().at("prob").tensor_shape().dim(0).size(), 1);
+    ASSERT_EQ(response.outputs().at("prob").tensor_content().size(), 2 * sizeof(uint16_t));
+    const uint16_t* bfloats = reinterpret_cast<const uint16_t*>(response.outputs().at("prob").tensor_content().data());
+    EXPECT_THAT(std::vector<uint16_t>(bfloats, bfloats + 2), testing::ElementsAre(0xC000, 0x4780));
+
+    OutputPostprocessing int8{"int8"};
+    int8.scale = 0.5f;
+    response.Clear();
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, int8, 0, 2), ovms::StatusCode::OK);
+    EXPECT_EQ(response.outputs().at("prob").dtype(), tensorflow::DataType::DT_INT8);
+    ASSERT_EQ(response.outputs().at("prob").tensor_content().size(), 4);
+    const int8_t* quantized = reinterpret_cast<const int8_t*>(response.outputs().at("prob").tensor_content().data());
+    EXPECT_THAT(std::vector<int8_t>(quantized, quantized + 4), testing::ElementsAre(2, 1, -4, 127));
+}
+
+TEST(SerializeTFGRPCPredictResponse, ShouldRunLengthEncodeOutputs) {
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>("mask", Precision::I32, shape_t{2, 3}, InferenceEngine::Layout::NC);
+    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<int32_t>(tensorInfo->getTensorDesc());
+    blob->allocate();
+    const std::vector<int32_t> mask{1, 1, 1, 0, 0, 2};
+    std::copy(mask.begin(), mask.end(), InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<int32_t*>());
+
+    PredictResponse response;
+    OutputPostprocessing rle{"rle"};
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, rle, 0, 2), ovms::StatusCode::OK);
+    const auto& runs = response.outputs().at("mask");
+    ASSERT_EQ(runs.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(runs.tensor_shape().dim(0).size(), 3);
+    const int32_t* pairs = reinterpret_cast<const int32_t*>(runs.tensor_content().data());
+    EXPECT_THAT(std::vector<int32_t>(pairs, pairs + 6), testing::ElementsAre(1, 3, 0, 2, 2, 1));
+    const auto& shape = response.outputs().at("mask" + POSTPROCESSING_SHAPE_SUFFIX);
+    ASSERT_EQ(shape.tensor_content().size(), 2 * sizeof(int64_t));
+    const int64_t* dims = reinterpret_cast<const int64_t*>(shape.tensor_content().data());
+    EXPECT_THAT(std::vector<int64_t>(dims, dims + 2), testing::ElementsAre(2, 3));
+}
+
+TEST(SerializeTFGRPCPredictResponse, ShouldEncodeImageOutputs) {
+    auto tensorInfo = std::make_shared<ovms::TensorInfo>("image", Precision::FP32, shape_t{2, 1, 2, 2}, InferenceEngine::Layout::NCHW);
+    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<float>(tensorInfo->getTensorDesc());
+    blob->allocate();
+    const std::vector<float> pixels{0.0, 0.25, 1.0, 2.0, 0.1, 0.2, 0.3, 0.4};
+    std::copy(pixels.begin(), pixels.end(), InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<float*>());
+
+    PredictResponse response;
+    OutputPostprocessing png{"png"};
+    png.scale = 1.0f / 255;
+    ASSERT_EQ(serializePostprocessedBlobBatchSlice(response, tensorInfo, blob, png, 0, 2), ovms::StatusCode::OK);
+    const auto& images = response.outputs().at("image");
+    EXPECT_EQ(images.dtype(), tensorflow::DataType::DT_STRING);
+    ASSERT_EQ(images.string_val_size(), 2);
+    const std::string& encoded = images.string_val(0);
+    cv::Mat image = cv::imdecode(std::vector<uchar>(encoded.begin(), encoded.end()), cv::IMREAD_UNCHANGED);
+    ASSERT_EQ(image.rows, 2);
+    ASSERT_EQ(image.cols, 2);
+    ASSERT_EQ(image.channels(), 1);
+    EXPECT_EQ(image.at<uchar>(0, 0), 0);
+    EXPECT_EQ(image.at<uchar>(0, 1), 64);
+    EXPECT_EQ(image.at<uchar>(1, 0), 255);
+    EXPECT_EQ(image.at<uchar>(1, 1), 255);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Test,
     SerializeTFTensorProto,
@@ -0,0 +1,56 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../servable_benchmark.hpp"
+#include "test_utils.hpp"
+
+using namespace ovms;
+
+TEST(ServableBenchmark, EstimatesPercentileWithinBucket) {
+    const std::vector<uint64_t> bounds{100, 200, 400};
+    EXPECT_EQ(ServableBenchmark::estimatePercentile(bounds, {0, 0, 0, 0}, 50), 0);
+    EXPECT_EQ(ServableBenchmark::estimatePercentile(bounds, {0, 10, 0, 0}, 50), 150);
+    EXPECT_EQ(ServableBenchmark::estimatePercentile(bounds, {10, 0, 10, 0}, 50), 100);
+    EXPECT_EQ(ServableBenchmark::estimatePercentile(bounds, {10, 0, 10, 0}, 75), 300);
+    EXPECT_EQ(ServableBenchmark::estimatePercentile(bounds, {1, 0, 0, 9}, 99), 400);
+}
+
+TEST(ServableBenchmark, RunsModel) {
+    ConstructorEnabledModelManager manager;
+    ASSERT_EQ(manager.reloadModelWithVersions(DUMMY_MODEL_CONFIG), StatusCode::OK_RELOADED);
+    ServableBenchmark benchmark(manager, "dummy", 2, std::chrono::milliseconds(200));
+    ASSERT_EQ(benchmark.run(), StatusCode::OK);
+    EXPECT_GT(benchmark.getCompletedRequestsCount(), 0);
+    EXPECT_EQ(benchmark.getFailedRequestsCount(), 0);
+    EXPECT_GT(benchmark.getThroughput(), 0);
+    EXPECT_LE(benchmark.getLatencyPercentileUs(50), benchmark.getLatencyPercentileUs(99));
+
+    std::stringstream report;
+    benchmark.report(report);
+    EXPECT_NE(report.str().find("prediction"), std::string::npos);
+    EXPECT_NE(report.str().find("dummy version 1"), std::string::npos);
+}
+
+TEST(ServableBenchmark, RejectsMissingServable) {
+    ConstructorEnabledModelManager manager;
+    ServableBenchmark benchmark(manager, "missing", 1, std::chrono::milliseconds(10));
+    EXPECT_EQ(benchmark.run(), StatusCode::PIPELINE_DEFINITION_NAME_MISSING);
+}
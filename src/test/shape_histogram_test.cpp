@@ -0,0 +1,86 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <map>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../shape_histogram.hpp"
+
+using namespace ovms;
+using testing::ElementsAre;
+
+namespace {
+ShapeHistogram::shapes_t createShapes(size_t sequenceLength) {
+    return {{"input_ids", {1, sequenceLength}}, {"attention_mask", {1, sequenceLength}}};
+}
+}  // namespace
+
+TEST(ShapeHistogram, ReturnsMostFrequentShapesFirst) {
+    ShapeHistogram histogram;
+    histogram.record(createShapes(8));
+    histogram.record(createShapes(16));
+    histogram.record(createShapes(16));
+    EXPECT_EQ(histogram.record(createShapes(32)), 4);
+    histogram.record(createShapes(16));
+    histogram.record(createShapes(32));
+    const auto shapes = histogram.getMostFrequent();
+    ASSERT_EQ(shapes.size(), 3);
+    EXPECT_EQ(shapes[0].first, createShapes(16));
+    EXPECT_EQ(shapes[0].second, 3);
+    EXPECT_EQ(shapes[1].first, createShapes(32));
+    EXPECT_EQ(shapes[1].second, 2);
+    EXPECT_EQ(shapes[2].first, createShapes(8));
+    EXPECT_EQ(histogram.getMostFrequent(1).size(), 1);
+    EXPECT_EQ(histogram.getRequests(), 6);
+}
+
+TEST(ShapeHistogram, CountsOnlyRequestsOfShapesOverLimit) {
+    ShapeHistogram histogram;
+    for (size_t i = 1; i <= ShapeHistogram::MAX_SHAPES + 10; ++i) {
+        histogram.record(createShapes(i));
+    }
+    EXPECT_EQ(histogram.getMostFrequent().size(), ShapeHistogram::MAX_SHAPES);
+    EXPECT_EQ(histogram.getRequests(), ShapeHistogram::MAX_SHAPES + 10);
+}
+
+TEST(ShapeHistogram, ReturnsDimensionHistogram) {
+    ShapeHistogram histogram;
+    histogram.record(createShapes(8));
+    histogram.record(createShapes(8));
+    histogram.record(createShapes(20));
+    histogram.record({{"input_ids", {1}}});
+    const auto sizes = histogram.getDimensionHistogram("input_ids", 1);
+    EXPECT_EQ(sizes, (std::map<size_t, uint64_t>{{8, 2}, {20, 1}}));
+    EXPECT_TRUE(histogram.getDimensionHistogram("unknown", 1).empty());
+}
+
+TEST(ShapeHistogram, ProposesBucketsWithLeastPadding) {
+    uint64_t paddedElements = 0;
+    const std::map<size_t, uint64_t> sizes{{10, 5}, {12, 5}, {60, 2}, {64, 3}, {100, 1}, {128, 4}};
+    EXPECT_THAT(ShapeHistogram::proposePaddedBuckets(sizes, 3, paddedElements), ElementsAre(12, 64, 128));
+    EXPECT_EQ(paddedElements, 10 + 8 + 28);
+}
+
+TEST(ShapeHistogram, ProposesAllSizesWhenBucketsSuffice) {
+    uint64_t paddedElements = 1;
+    const std::map<size_t, uint64_t> sizes{{10, 5}, {12, 5}};
+    EXPECT_THAT(ShapeHistogram::proposePaddedBuckets(sizes, 4, paddedElements), ElementsAre(10, 12));
+    EXPECT_EQ(paddedElements, 0);
+    EXPECT_THAT(ShapeHistogram::proposePaddedBuckets(sizes, 1, paddedElements), ElementsAre(12));
+    EXPECT_EQ(paddedElements, 10);
+}
@@ -0,0 +1,148 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../deserialization.hpp"
+#include "../shared_memory.hpp"
+
+using namespace ovms;
+
+class SharedMemoryTest : public ::testing::Test {
+protected:
+    const std::string key = "/ovms_shared_memory_test_" + std::to_string(getpid());
+    const std::string regionName = "region";
+    static constexpr size_t OBJECT_SIZE = 4096 * 2;
+    void* objectData = nullptr;
+
+    void SetUp() override {
+        int fd = shm_open(key.c_str(), O_CREAT | O_RDWR, 0600);
+        ASSERT_NE(fd, -1);
+        ASSERT_EQ(ftruncate(fd, OBJECT_SIZE), 0);
+        objectData = mmap(nullptr, OBJECT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        ASSERT_NE(objectData, MAP_FAILED);
+    }
+
+    void TearDown() override {
+        SharedMemoryRegistry::getInstance().unregisterRegion(regionName);
+        munmap(objectData, OBJECT_SIZE);
+        shm_unlink(key.c_str());
+    }
+
+    float* objectFloats(size_t byteOffset) {
+        return reinterpret_cast<float*>(static_cast<char*>(objectData) + byteOffset);
+    }
+};
+
+TEST_F(SharedMemoryTest, RegisterAndUnregisterRegion) {
+    auto& registry = SharedMemoryRegistry::getInstance();
+    EXPECT_EQ(registry.registerRegion(regionName, key, 0, OBJECT_SIZE), StatusCode::OK);
+    EXPECT_EQ(registry.registerRegion(regionName, key, 0, OBJECT_SIZE), StatusCode::SHARED_MEMORY_REGION_ALREADY_REGISTERED);
+    std::shared_ptr<SharedMemoryRegion> region;
+    EXPECT_EQ(registry.getRegion(regionName, region), StatusCode::OK);
+    EXPECT_EQ(region->getByteSize(), OBJECT_SIZE);
+    EXPECT_EQ(registry.unregisterRegion(regionName), StatusCode::OK);
+    EXPECT_EQ(registry.unregisterRegion(regionName), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+    EXPECT_EQ(registry.getRegion(regionName, region), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+}
+
+TEST_F(SharedMemoryTest, RegisterFailsForMissingObjectOrTooBigRange) {
+    auto& registry = SharedMemoryRegistry::getInstance();
+    EXPECT_EQ(registry.registerRegion(regionName, key + "_missing", 0, 16), StatusCode::SHARED_MEMORY_MAPPING_FAILED);
+    EXPECT_EQ(registry.registerRegion(regionName, key, 8, OBJECT_SIZE), StatusCode::SHARED_MEMORY_MAPPING_FAILED);
+    EXPECT_EQ(registry.size(), 0);
+}
+
+TEST_F(SharedMemoryTest, DeserializesInputWithoutCopyAtUnalignedOffset) {
+    const size_t regionOffset = 100;
+    const size_t tensorOffset = 4000;
+    std::vector<float> data{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::memcpy(objectFloats(regionOffset + tensorOffset), data.data(), data.size() * sizeof(float));
+    ASSERT_EQ(SharedMemoryRegistry::getInstance().registerRegion(regionName, key, regionOffset, OBJECT_SIZE - regionOffset), StatusCode::OK);
+
+    tensorflow::TensorProto tensor;
+    tensor.set_dtype(tensorflow::DataType::DT_FLOAT);
+    tensor.mutable_tensor_shape()->add_dim()->set_size(1);
+    tensor.mutable_tensor_shape()->add_dim()->set_size(10);
+    setSharedMemoryReference(tensor, regionName, tensorOffset);
+    ASSERT_TRUE(isSharedMemoryReference(tensor));
+
+    auto tensorInfo = std::make_shared<TensorInfo>("b", InferenceEngine::Precision::FP32, shape_t{1, 10}, InferenceEngine::Layout::NC);
+    EXPECT_EQ(validateSharedMemoryInput(*tensorInfo, tensor, data.size()), StatusCode::OK);
+    EXPECT_EQ(validateSharedMemoryInput(*tensorInfo, tensor, 2000), StatusCode::INVALID_CONTENT_SIZE);
+
+    auto blob = deserializeTensorProto<ConcreteTensorProtoDeserializator>(tensor, tensorInfo, false);
+    ASSERT_NE(blob, nullptr);
+    // region stays mapped as long as blob exists
+    ASSERT_EQ(SharedMemoryRegistry::getInstance().unregisterRegion(regionName), StatusCode::OK);
+    auto holder = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap();
+    const float* blobData = holder.as<const float*>();
+    EXPECT_EQ(std::vector<float>(blobData, blobData + data.size()), data);
+}
+
+TEST_F(SharedMemoryTest, ValidateRejectsMissingRegionAndOtherPrecision) {
+    tensorflow::TensorProto tensor;
+    tensor.set_dtype(tensorflow::DataType::DT_FLOAT);
+    setSharedMemoryReference(tensor, regionName, 0);
+    auto tensorInfo = std::make_shared<TensorInfo>("b", InferenceEngine::Precision::FP32, shape_t{1, 10}, InferenceEngine::Layout::NC);
+    EXPECT_EQ(validateSharedMemoryInput(*tensorInfo, tensor, 10), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+    tensor.set_dtype(tensorflow::DataType::DT_HALF);
+    EXPECT_EQ(validateSharedMemoryInput(*tensorInfo, tensor, 10), StatusCode::INVALID_PRECISION);
+}
+
+TEST(SharedMemoryOutputs, ParseHeader) {
+    shared_memory_outputs_t outputs;
+    ASSERT_EQ(parseSharedMemoryOutputs("", outputs), StatusCode::OK);
+    EXPECT_TRUE(outputs.empty());
+    ASSERT_EQ(parseSharedMemoryOutputs("a=region:0, b = other:128", outputs), StatusCode::OK);
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(outputs.at("a"), std::make_pair(std::string("region"), uint64_t{0}));
+    EXPECT_EQ(outputs.at("b"), std::make_pair(std::string("other"), uint64_t{128}));
+    EXPECT_EQ(parseSharedMemoryOutputs("a=region", outputs), StatusCode::SHARED_MEMORY_INVALID_OUTPUTS);
+    EXPECT_EQ(parseSharedMemoryOutputs("a:12", outputs), StatusCode::SHARED_MEMORY_INVALID_OUTPUTS);
+    EXPECT_EQ(parseSharedMemoryOutputs("a=region:x", outputs), StatusCode::SHARED_MEMORY_INVALID_OUTPUTS);
+}
+
+TEST_F(SharedMemoryTest, WritesOutputsIntoRegion) {
+    ASSERT_EQ(SharedMemoryRegistry::getInstance().registerRegion(regionName, key, 0, OBJECT_SIZE), StatusCode::OK);
+    std::vector<float> data{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    tensorflow::serving::PredictResponse response;
+    auto& output = (*response.mutable_outputs())["a"];
+    output.set_dtype(tensorflow::DataType::DT_FLOAT);
+    output.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+
+    shared_memory_outputs_t outputs{{"a", {regionName, 64}}};
+    ASSERT_EQ(writeOutputsToSharedMemory(outputs, response), StatusCode::OK);
+    EXPECT_TRUE(output.tensor_content().empty());
+    ASSERT_TRUE(isSharedMemoryReference(output));
+    EXPECT_EQ(output.resource_handle_val(0).name(), regionName);
+    EXPECT_EQ(output.resource_handle_val(0).hash_code(), 64);
+    EXPECT_EQ(std::vector<float>(objectFloats(64), objectFloats(64) + data.size()), data);
+
+    shared_memory_outputs_t tooFar{{"a", {regionName, OBJECT_SIZE}}};
+    output.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    EXPECT_EQ(writeOutputsToSharedMemory(tooFar, response), StatusCode::INVALID_CONTENT_SIZE);
+    shared_memory_outputs_t missing{{"c", {regionName, 0}}};
+    EXPECT_EQ(writeOutputsToSharedMemory(missing, response), StatusCode::INVALID_MISSING_OUTPUT);
+}
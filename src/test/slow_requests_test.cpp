@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "../slow_requests.hpp"
+
+using namespace ovms;
+
+namespace {
+SlowRequestRecord prepareRecord(uint64_t durationUs) {
+    SlowRequestRecord record;
+    record.durationUs = durationUs;
+    record.stages = {{"inference", durationUs}};
+    return record;
+}
+}  // namespace
+
+TEST(SlowRequests, KeepsSlowestRequests) {
+    SlowRequests slowRequests(2);
+    EXPECT_TRUE(slowRequests.isSlow(1));
+    slowRequests.record(prepareRecord(10));
+    slowRequests.record(prepareRecord(30));
+    EXPECT_FALSE(slowRequests.isSlow(10));
+    EXPECT_TRUE(slowRequests.isSlow(11));
+    slowRequests.record(prepareRecord(20));
+    slowRequests.record(prepareRecord(5));
+
+    auto records = slowRequests.getRecords();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].durationUs, 30);
+    EXPECT_EQ(records[1].durationUs, 20);
+    EXPECT_FALSE(slowRequests.isSlow(20));
+}
+
+TEST(SlowRequests, DisabledWithZeroCapacity) {
+    SlowRequests slowRequests(0);
+    EXPECT_FALSE(slowRequests.isSlow(1'000'000));
+    slowRequests.record(prepareRecord(10));
+    EXPECT_TRUE(slowRequests.getRecords().empty());
+}
+
+TEST(SlowRequests, DescribesInputs) {
+    tensorflow::serving::PredictRequest request;
+    auto& content = (*request.mutable_inputs())["content"];
+    content.set_dtype(tensorflow::DT_FLOAT);
+    content.mutable_tensor_shape()->add_dim()->set_size(1);
+    content.mutable_tensor_shape()->add_dim()->set_size(10);
+    content.mutable_tensor_content()->assign(40, '\0');
+    auto& values = (*request.mutable_inputs())["values"];
+    values.set_dtype(tensorflow::DT_INT32);
+    values.mutable_tensor_shape()->add_dim()->set_size(3);
+
+    SlowRequestRecord record;
+    record.setInputs(request);
+    ASSERT_EQ(record.inputs.size(), 2);
+    for (const auto& input : record.inputs) {
+        if (input.name == "content") {
+            EXPECT_EQ(input.datatype, "FP32");
+            EXPECT_EQ(input.shape, (std::vector<int64_t>{1, 10}));
+            EXPECT_EQ(input.bytes, 40);
+        } else {
+            EXPECT_EQ(input.name, "values");
+            EXPECT_EQ(input.datatype, "I32");
+            EXPECT_EQ(input.bytes, 12);
+        }
+    }
+}
+
+TEST(SlowRequestsLog, SerializesRecordsOfServables) {
+    auto& log = SlowRequestsLog::instance();
+    log.getModel("slow_requests_test_model", 2).record(prepareRecord(100));
+    auto record = prepareRecord(200);
+    record.stages.clear();
+    record.nodes.push_back({"node", 2, 10, 20, 150, 1024, 2});
+    log.getPipeline("slow_requests_test_pipeline").record(std::move(record));
+
+    const auto json = log.toJson();
+    EXPECT_NE(json.find(R"({"model":"slow_requests_test_model","version":2,"requests":[{"timestamp_ms":)"), std::string::npos) << json;
+    EXPECT_NE(json.find(R"("duration_us":100,"stages_us":{"inference":100},"inputs":[])"), std::string::npos) << json;
+    EXPECT_NE(json.find(R"({"pipeline":"slow_requests_test_pipeline","requests":[)"), std::string::npos) << json;
+    EXPECT_NE(json.find(R"("nodes":[{"name":"node","sessions":2,"inputs_wait_us":10,"stream_wait_us":20,"execution_us":150,"output_bytes":1024,"shards":2}])"), std::string::npos) << json;
+}
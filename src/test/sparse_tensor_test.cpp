@@ -0,0 +1,119 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../deserialization.hpp"
+#include "../sparse_tensor.hpp"
+
+using namespace ovms;
+using InferenceEngine::Layout;
+using InferenceEngine::Precision;
+using testing::ElementsAre;
+
+namespace {
+tensorflow::TensorProto makeSparseTensor(const std::vector<int64_t>& denseShape, const std::vector<int64_t>& indices, const std::vector<float>& values) {
+    tensorflow::TensorProto tensor;
+    tensor.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : denseShape) {
+        tensor.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    auto [indicesProto, valuesProto] = setSparseTensor(tensor);
+    indicesProto->set_dtype(tensorflow::DataType::DT_INT64);
+    indicesProto->mutable_tensor_shape()->add_dim()->set_size(values.size());
+    indicesProto->mutable_tensor_shape()->add_dim()->set_size(denseShape.size());
+    indicesProto->mutable_tensor_content()->assign(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(int64_t));
+    valuesProto->set_dtype(tensorflow::DataType::DT_FLOAT);
+    valuesProto->mutable_tensor_shape()->add_dim()->set_size(values.size());
+    valuesProto->mutable_tensor_content()->assign(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    return tensor;
+}
+}  // namespace
+
+TEST(SparseTensor, IsMarkedByVariant) {
+    tensorflow::TensorProto tensor;
+    EXPECT_FALSE(isSparseTensor(tensor));
+    setSparseTensor(tensor);
+    EXPECT_TRUE(isSparseTensor(tensor));
+}
+
+TEST(SparseTensor, ValidatesIndicesAndValues) {
+    TensorInfo networkInput("input", Precision::FP32, shape_t{2, 4}, Layout::NC);
+    EXPECT_EQ(validateSparseInput(networkInput, makeSparseTensor({2, 4}, {0, 1, 1, 3}, {0.5, 1.5})), StatusCode::OK);
+    EXPECT_EQ(validateSparseInput(networkInput, makeSparseTensor({2, 4}, {}, {})), StatusCode::OK);
+    // index out of dense shape
+    EXPECT_EQ(validateSparseInput(networkInput, makeSparseTensor({2, 4}, {0, 1, 1, 4}, {0.5, 1.5})), StatusCode::INVALID_SPARSE_TENSOR);
+    EXPECT_EQ(validateSparseInput(networkInput, makeSparseTensor({2, 4}, {0, 1, -1, 3}, {0.5, 1.5})), StatusCode::INVALID_SPARSE_TENSOR);
+
+    auto tensor = makeSparseTensor({2, 4}, {0, 1, 1, 3}, {0.5, 1.5});
+    tensor.mutable_variant_val(0)->mutable_tensors(1)->mutable_tensor_content()->resize(sizeof(float));
+    EXPECT_EQ(validateSparseInput(networkInput, tensor), StatusCode::INVALID_SPARSE_TENSOR);
+
+    tensor = makeSparseTensor({2, 4}, {0, 1, 1, 3}, {0.5, 1.5});
+    tensor.mutable_variant_val(0)->mutable_tensors(0)->set_dtype(tensorflow::DataType::DT_FLOAT);
+    EXPECT_EQ(validateSparseInput(networkInput, tensor), StatusCode::INVALID_SPARSE_TENSOR);
+
+    tensor = makeSparseTensor({2, 4}, {0, 1, 1, 3}, {0.5, 1.5});
+    tensor.mutable_variant_val(0)->mutable_tensors()->RemoveLast();
+    EXPECT_EQ(validateSparseInput(networkInput, tensor), StatusCode::INVALID_SPARSE_TENSOR);
+}
+
+TEST(SparseTensor, IsNotSupportedForTransposedInputs) {
+    TensorInfo networkInput("input", Precision::FP32, shape_t{1, 3, 2, 2}, Layout::NHWC);
+    networkInput.setTransposedLayout(Layout::NCHW);
+    EXPECT_EQ(validateSparseInput(networkInput, makeSparseTensor({1, 2, 2, 3}, {0, 1, 1, 2}, {0.5})), StatusCode::INVALID_SPARSE_TENSOR);
+}
+
+TEST(SparseTensor, WritesValuesAtIndicesOfZeroFilledTensor) {
+    std::vector<float> dense(8, 7.0);
+    ASSERT_TRUE(writeSparseTensor(makeSparseTensor({2, 4}, {0, 1, 1, 3}, {0.5, 1.5}), Precision::FP32, dense.data(), dense.size() * sizeof(float)));
+    EXPECT_THAT(dense, ElementsAre(0, 0.5, 0, 0, 0, 0, 0, 1.5));
+    EXPECT_FALSE(writeSparseTensor(makeSparseTensor({2, 4}, {0, 1, 1, 3}, {0.5, 1.5}), Precision::FP32, dense.data(), 4 * sizeof(float)));
+}
+
+TEST(SparseTensor, ConvertsFp32ValuesToNetworkPrecision) {
+    std::vector<uint8_t> dense(4, 7);
+    ASSERT_TRUE(writeSparseTensor(makeSparseTensor({4}, {2}, {200.4f}), Precision::U8, dense.data(), dense.size()));
+    EXPECT_THAT(dense, ElementsAre(0, 0, 200, 0));
+}
+
+TEST(SparseTensor, NarrowsHalfValues) {
+    auto tensor = makeSparseTensor({3}, {1}, {1.0});
+    tensor.set_dtype(tensorflow::DataType::DT_HALF);
+    auto values = tensor.mutable_variant_val(0)->mutable_tensors(1);
+    values->set_dtype(tensorflow::DataType::DT_HALF);
+    values->clear_tensor_content();
+    values->add_half_val(0x3c00);
+
+    TensorInfo networkInput("input", Precision::FP16, shape_t{3}, Layout::C);
+    ASSERT_EQ(validateSparseInput(networkInput, tensor), StatusCode::OK);
+    std::vector<uint16_t> dense(3, 7);
+    ASSERT_TRUE(writeSparseTensor(tensor, Precision::FP16, dense.data(), dense.size() * sizeof(uint16_t)));
+    EXPECT_THAT(dense, ElementsAre(0, 0x3c00, 0));
+}
+
+TEST(SparseTensor, IsDeserializedIntoDenseBlob) {
+    auto tensorInfo = std::make_shared<TensorInfo>("input", Precision::FP32, shape_t{2, 4}, Layout::NC);
+    auto blob = deserializeTensorProto<ConcreteTensorProtoDeserializator>(makeSparseTensor({2, 4}, {0, 0, 1, 2}, {3, 4}), tensorInfo, false);
+    ASSERT_NE(blob, nullptr);
+    EXPECT_EQ(blob->getTensorDesc().getDims(), (InferenceEngine::SizeVector{2, 4}));
+    const float* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->rmap().as<const float*>();
+    EXPECT_EQ(std::vector<float>(data, data + 8), std::vector<float>({3, 0, 0, 0, 0, 0, 4, 0}));
+}
@@ -0,0 +1,104 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include "../metrics.hpp"
+#include "../startupprofiler.hpp"
+#include "../status.hpp"
+#include "test_utils.hpp"
+
+using namespace ovms;
+
+using testing::HasSubstr;
+
+class StartupProfilerTest : public TestWithTempDir {
+protected:
+    void TearDown() override {
+        StartupProfiler::instance().stop(directoryPath + "/teardown.json");
+        TestWithTempDir::TearDown();
+    }
+
+    rapidjson::Document readProfile(const std::string& path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        rapidjson::Document document;
+        document.Parse(content.str().c_str());
+        return document;
+    }
+};
+
+TEST_F(StartupProfilerTest, WritesChromeTraceEvents) {
+    auto& profiler = StartupProfiler::instance();
+    const auto start = StartupProfiler::clock_t::now();
+    profiler.addEvent("ignored", "test", start, start + std::chrono::milliseconds(1));
+
+    profiler.start();
+    const auto eventStart = StartupProfiler::clock_t::now();
+    profiler.addEvent("compile", "model_load", eventStart, eventStart + std::chrono::milliseconds(5), {{"model", "dummy"}});
+    const std::string path = directoryPath + "/profile.json";
+    ASSERT_EQ(profiler.stop(path), StatusCode::OK);
+    profiler.addEvent("after_stop", "test", start, start + std::chrono::milliseconds(1));
+
+    auto profile = readProfile(path);
+    ASSERT_FALSE(profile.HasParseError());
+    ASSERT_TRUE(profile.HasMember("traceEvents"));
+    const auto& events = profile["traceEvents"].GetArray();
+    ASSERT_EQ(events.Size(), 1);
+    EXPECT_STREQ(events[0]["name"].GetString(), "compile");
+    EXPECT_STREQ(events[0]["cat"].GetString(), "model_load");
+    EXPECT_STREQ(events[0]["ph"].GetString(), "X");
+    EXPECT_GE(events[0]["ts"].GetInt64(), 0);
+    EXPECT_EQ(events[0]["dur"].GetInt64(), 5000);
+    EXPECT_EQ(events[0]["tid"].GetUint64(), 1);
+    EXPECT_STREQ(events[0]["args"]["model"].GetString(), "dummy");
+}
+
+TEST_F(StartupProfilerTest, RecordsModelLoadPhases) {
+    auto& profiler = StartupProfiler::instance();
+    profiler.start();
+    ConstructorEnabledModelManager manager;
+    ModelConfig config = DUMMY_MODEL_CONFIG;
+    ASSERT_EQ(manager.reloadModelWithVersions(config), StatusCode::OK_RELOADED);
+    const std::string path = directoryPath + "/profile.json";
+    ASSERT_EQ(profiler.stop(path), StatusCode::OK);
+
+    auto instance = manager.findModelInstance("dummy");
+    ASSERT_NE(instance, nullptr);
+    const auto& loadTimes = instance->getStatus().getLoadTimes();
+    for (const char* phase : {"read_network", "reshape", "compile", "create_infer_requests", "warmup", "total"}) {
+        EXPECT_THAT(loadTimes, HasSubstr(std::string(phase) + " ")) << phase;
+        EXPECT_THAT(MetricRegistry::getInstance().serialize(),
+            HasSubstr("ovms_model_load_time_us_count{model=\"dummy\",version=\"1\",phase=\"" + std::string(phase) + "\"}"));
+    }
+
+    auto profile = readProfile(path);
+    ASSERT_FALSE(profile.HasParseError());
+    std::set<std::string> names;
+    for (const auto& event : profile["traceEvents"].GetArray()) {
+        names.insert(event["name"].GetString());
+    }
+    for (const char* name : {"read_network", "reshape", "compile", "create_infer_requests", "warmup", "load"}) {
+        EXPECT_EQ(names.count(name), 1) << name;
+    }
+}
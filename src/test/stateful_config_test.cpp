@@ -19,6 +19,7 @@
 
 #include "../modelconfig.hpp"
 #include "../modelinstance.hpp"
+#include "../statefulmodelinstance.hpp"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #include "test_utils.hpp"
@@ -57,6 +58,7 @@ static const char* modelStatefulChangedConfig = R"(
                 "stateful": true,
                 "low_latency_transformation": true,
                 "max_sequence_number": 1000,
+                "idle_sequence_timeout_seconds": 30,
                 "shape": {"b": "(1,10) "}
             }
         }
@@ -103,6 +105,7 @@ TEST_F(StatefulConfigTest, DefaultValues) {
     ASSERT_EQ(maxSequenceNumber, 500);
     auto idleSequenceCleanup = modelConfig.getIdleSequenceCleanup();
     ASSERT_EQ(idleSequenceCleanup, true);
+    ASSERT_EQ(modelConfig.getIdleSequenceTimeoutSeconds(), 0);
 }
 
 TEST_F(StatefulConfigTest, ChangedValues) {
@@ -123,5 +126,8 @@ TEST_F(StatefulConfigTest, ChangedValues) {
     ASSERT_EQ(maxSequenceNumber, 1000);
     auto idleSequenceCleanup = modelConfig.getIdleSequenceCleanup();
     ASSERT_EQ(idleSequenceCleanup, true);
+    ASSERT_EQ(modelConfig.getIdleSequenceTimeoutSeconds(), 30);
+    auto statefulModelInstance = std::static_pointer_cast<ovms::StatefulModelInstance>(modelInstance);
+    ASSERT_EQ(statefulModelInstance->getSequenceManager()->getIdleSequenceTimeoutSeconds(), 30);
 }
 #pragma GCC diagnostic pop
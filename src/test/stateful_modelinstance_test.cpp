@@ -86,6 +86,24 @@ static const char* modelStatefulConfig = R"(
     ]
 })";
 
+static const char* modelStatefulBoundSequencesConfig = R"(
+{
+    "model_config_list": [
+        {
+            "config": {
+                "name": "dummy",
+                "base_path": "/ovms/src/test/dummy",
+                "target_device": "CPU",
+                "model_version_policy": {"latest": {"num_versions":1}},
+                "nireq": 2,
+                "stateful": true,
+                "max_bound_sequences": 1,
+                "shape": {"b": "(1,10) "}
+            }
+        }
+    ]
+})";
+
 constexpr const char* DUMMY_MODEL_INPUT_NAME = "b";
 class StatefulModelInstanceTempDir : public TestWithTempDir {
 public:
@@ -171,6 +189,10 @@ public:
         return static_cast<MockedGlobalSequencesViewer*>(this->globalSequencesViewer);
     }
 
+    void prepareStreamsStateOwners(size_t streamsCount) {
+        streamsStateOwners.assign(streamsCount, 0);
+    }
+
     void injectSequence(uint64_t sequenceId, ovms::model_memory_state_t state) {
         ovms::SequenceProcessingSpec spec(ovms::SEQUENCE_START, sequenceId);
         getMockedSequenceManager()->mockCreateSequence(spec);
@@ -188,7 +210,16 @@ public:
             std::cout << "[WARNING] This method must be kept up to date with StatefulModelInstance::infer for tests to function properly." << std::endl;
             testWarningPrinted = true;
         }
-        ovms::Timer timer;
+        enum : size_t {
+            GET_INFER_REQUEST,
+            PREPROCESS,
+            DESERIALIZE,
+            PREDICTION,
+            SERIALIZE,
+            POSTPROCESS,
+            TIMER_END
+        };
+        ovms::Timer<TIMER_END> timer;
         using std::chrono::microseconds;
         ovms::SequenceProcessingSpec sequenceProcessingSpec;
         auto status = validate(requestProto, sequenceProcessingSpec);
@@ -199,8 +230,8 @@ public:
             std::cout << "Waiting before sequenceManagerLock" << std::endl;
             waitBeforeManagerLock->get();
         }
-        std::unique_lock<std::mutex> sequenceManagerLock(sequenceManager->getMutex());
-        status = sequenceManager->processRequestedSpec(sequenceProcessingSpec);
+        std::unique_lock<std::mutex> sequenceManagerLock;
+        status = sequenceManager->processRequestedSpec(sequenceProcessingSpec, sequenceManagerLock);
         if (!status.ok())
             return status;
         const uint64_t sequenceId = sequenceProcessingSpec.getSequenceId();
@@ -216,41 +247,42 @@ public:
         std::unique_lock<std::mutex> sequenceLock(sequence.getMutex());
         sequenceManagerLock.unlock();
 
-        timer.start("get infer request");
+        timer.start(GET_INFER_REQUEST);
         ovms::ExecutingStreamIdGuard executingStreamIdGuard(getInferRequestsQueue());
 
+        int executingInferId = executingStreamIdGuard.getId();
         InferenceEngine::InferRequest& inferRequest = executingStreamIdGuard.getInferRequest();
-        timer.stop("get infer request");
+        timer.stop(GET_INFER_REQUEST);
 
-        timer.start("preprocess");
-        status = preInferenceProcessing(inferRequest, sequence, sequenceProcessingSpec);
-        timer.stop("preprocess");
+        timer.start(PREPROCESS);
+        status = preInferenceProcessing(inferRequest, sequence, sequenceProcessingSpec, executingInferId);
+        timer.stop(PREPROCESS);
         if (!status.ok())
             return status;
 
-        timer.start("deserialize");
+        timer.start(DESERIALIZE);
         ovms::InputSink<InferRequest&> inputSink(inferRequest);
         bool isPipeline = false;
         status = ovms::deserializePredictRequest<ovms::ConcreteTensorProtoDeserializator>(*requestProto, getInputsInfo(), inputSink, isPipeline);
-        timer.stop("deserialize");
+        timer.stop(DESERIALIZE);
         if (!status.ok())
             return status;
 
-        timer.start("prediction");
+        timer.start(PREDICTION);
         status = performInference(inferRequest);
-        timer.stop("prediction");
+        timer.stop(PREDICTION);
         if (!status.ok())
             return status;
 
-        timer.start("serialize");
+        timer.start(SERIALIZE);
         status = serializePredictResponse(inferRequest, getOutputsInfo(), responseProto);
-        timer.stop("serialize");
+        timer.stop(SERIALIZE);
         if (!status.ok())
             return status;
 
-        timer.start("postprocess");
-        status = postInferenceProcessing(responseProto, inferRequest, sequence, sequenceProcessingSpec);
-        timer.stop("postprocess");
+        timer.start(POSTPROCESS);
+        status = postInferenceProcessing(responseProto, inferRequest, sequence, sequenceProcessingSpec, executingInferId);
+        timer.stop(POSTPROCESS);
         if (!status.ok())
             return status;
 
@@ -703,10 +735,12 @@ TEST_F(StatefulModelInstanceTempDir, statefulInferManagerMutexTest) {
     });
 
     stetefulMockedModelInstance->getSequencesViewer()->removeIdleSequences();
-    std::unique_lock<std::mutex> sequenceManagerLock(stetefulMockedModelInstance->getSequenceManager()->getMutex());
+    // Only cleanup of sequences sharing lock with the last sequence is blocked
+    std::unique_lock<std::mutex> sequenceManagerLock(stetefulMockedModelInstance->getSequenceManager()->getMutex(sequenceCounter));
     cleanerStartPromise.set_value();
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    ASSERT_EQ(stetefulMockedModelInstance->getSequenceManager()->getSequencesCount(), sequenceCounter);
+    ASSERT_EQ(stetefulMockedModelInstance->getSequenceManager()->getSequencesCount(), 1);
+    ASSERT_TRUE(stetefulMockedModelInstance->getSequenceManager()->sequenceExists(sequenceCounter));
     sequenceManagerLock.unlock();
     cleanerEndFuture.get();
     ASSERT_EQ(stetefulMockedModelInstance->getSequenceManager()->getSequencesCount(), 0);
@@ -1039,6 +1073,86 @@ TEST_F(StatefulModelInstanceTempDir, statefulInferStandardFlow) {
     EXPECT_TRUE(CheckSequenceIdResponse(lastResponse, seqId));
 }
 
+TEST_F(StatefulModelInstanceTempDir, statefulInferBoundSequences) {
+    ConstructorEnabledModelManager manager;
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unload_guard;
+    SetUpConfig(modelStatefulBoundSequencesConfig);
+    createConfigFileWithContent(ovmsConfig, configFilePath);
+    auto status = manager.loadConfig(configFilePath);
+    ASSERT_TRUE(status.ok());
+    auto modelInstance = std::static_pointer_cast<ovms::StatefulModelInstance>(manager.findModelInstance(dummyModelName));
+    auto sequenceManager = modelInstance->getSequenceManager();
+
+    auto runStep = [&](uint64_t seqId, uint32_t sequenceControl, tensorflow::serving::PredictResponse& response) {
+        tensorflow::serving::PredictRequest request = preparePredictRequest(modelInput);
+        setRequestSequenceId(&request, seqId);
+        setRequestSequenceControl(&request, sequenceControl);
+        ASSERT_EQ(modelInstance->infer(&request, &response, unload_guard), ovms::StatusCode::OK);
+        EXPECT_TRUE(CheckSequenceIdResponse(response, seqId));
+    };
+    tensorflow::serving::PredictResponse boundResponse, sharedResponse;
+    runStep(1, ovms::SEQUENCE_START, boundResponse);
+    runStep(2, ovms::SEQUENCE_START, sharedResponse);
+    EXPECT_GE(sequenceManager->getSequence(1).getBoundStreamId(), 0);
+    // Limit of bound sequences is reached
+    EXPECT_EQ(sequenceManager->getSequence(2).getBoundStreamId(), -1);
+
+    // Bound and shared sequences produce the same results
+    runStep(1, ovms::NO_CONTROL_INPUT, boundResponse);
+    runStep(2, ovms::NO_CONTROL_INPUT, sharedResponse);
+    EXPECT_EQ(boundResponse.outputs().at(DUMMY_MODEL_OUTPUT_NAME).tensor_content(), sharedResponse.outputs().at(DUMMY_MODEL_OUTPUT_NAME).tensor_content());
+
+    // Stream is released on sequence end
+    runStep(1, ovms::SEQUENCE_END, boundResponse);
+    runStep(3, ovms::SEQUENCE_START, boundResponse);
+    EXPECT_GE(sequenceManager->getSequence(3).getBoundStreamId(), 0);
+
+    // Stream of sequence removed by idle sequence cleanup is reclaimed
+    sequenceManager->removeIdleSequences();
+    sequenceManager->removeIdleSequences();
+    ASSERT_FALSE(sequenceManager->sequenceExists(3));
+    runStep(4, ovms::SEQUENCE_START, boundResponse);
+    EXPECT_GE(sequenceManager->getSequence(4).getBoundStreamId(), 0);
+}
+
+TEST_F(StatefulModelInstanceTempDir, statefulInferStreamedSequence) {
+    ConstructorEnabledModelManager manager;
+    createConfigFileWithContent(ovmsConfig, configFilePath);
+    auto status = manager.loadConfig(configFilePath);
+    ASSERT_TRUE(status.ok());
+    auto modelInstance = std::static_pointer_cast<ovms::StatefulModelInstance>(manager.findModelInstance(dummyModelName));
+    auto sequenceManager = modelInstance->getSequenceManager();
+
+    // Streamed requests do not carry special inputs
+    tensorflow::serving::PredictRequest request = preparePredictRequest(modelInput);
+    tensorflow::serving::PredictResponse response;
+    ovms::StreamedSequence streamedSequence;
+    streamedSequence.sequenceId = 5;
+    ASSERT_EQ(modelInstance->inferStreamed(&request, &response, streamedSequence, false), ovms::StatusCode::OK);
+    EXPECT_TRUE(CheckSequenceIdResponse(response, 5));
+    ASSERT_TRUE(sequenceManager->sequenceExists(5));
+
+    // Streamed sequence is not available to other requests and idle sequence cleanup
+    EXPECT_EQ(sequenceManager->hasSequence(5), ovms::StatusCode::SEQUENCE_MISSING);
+    sequenceManager->removeIdleSequences();
+    sequenceManager->removeIdleSequences();
+    ASSERT_TRUE(sequenceManager->sequenceExists(5));
+
+    ASSERT_EQ(modelInstance->inferStreamed(&request, &response, streamedSequence, false), ovms::StatusCode::OK);
+    ASSERT_EQ(modelInstance->inferStreamed(&request, &response, streamedSequence, true), ovms::StatusCode::OK);
+    EXPECT_TRUE(CheckSequenceIdResponse(response, 5));
+    EXPECT_FALSE(sequenceManager->sequenceExists(5));
+    EXPECT_EQ(streamedSequence.sequence, nullptr);
+
+    // Sequence of closed stream is removed
+    streamedSequence.sequenceId = 0;
+    ASSERT_EQ(modelInstance->inferStreamed(&request, &response, streamedSequence, false), ovms::StatusCode::OK);
+    const uint64_t generatedSequenceId = streamedSequence.sequenceId;
+    ASSERT_TRUE(sequenceManager->sequenceExists(generatedSequenceId));
+    modelInstance->endStreamedSequence(streamedSequence);
+    EXPECT_FALSE(sequenceManager->sequenceExists(generatedSequenceId));
+}
+
 TEST_F(StatefulModelInstanceTempDir, loadModel) {
     ovms::GlobalSequencesViewer sequencesViewer;
     ovms::StatefulModelInstance modelInstance(dummyModelName, modelVersion, &sequencesViewer);
@@ -1351,6 +1465,41 @@ TEST_F(StatefulModelInstanceTest, PostprocessingStartAndNoControl) {
     }
 }
 
+TEST_F(StatefulModelInstanceTest, PreprocessingSkipsLoadingStateHeldByStream) {
+    const int executingInferId = 0;
+    modelInstance->prepareStreamsStateOwners(1);
+    uint64_t sequenceId = 42;
+    ovms::SequenceProcessingSpec sequenceProcessingSpec(ovms::NO_CONTROL_INPUT, sequenceId);
+
+    InferenceEngine::InferRequest inferRequest = realModel.createInferRequest();
+    realModel.setVariableState(inferRequest, newState);
+    ovms::model_memory_state_t memoryState;
+    InferenceEngine::InferRequest auxInferRequest = realModel.createInferRequest();
+    realModel.setVariableState(auxInferRequest, currentState);
+    memoryState.push_back(realModel.getVariableState(auxInferRequest));
+    modelInstance->injectSequence(sequenceId, memoryState);
+    ovms::Sequence& sequence = modelInstance->getMockedSequenceManager()->getSequence(sequenceId);
+
+    // Saving state marks stream as holding state of the sequence
+    tensorflow::serving::PredictResponse response;
+    modelInstance->postInferenceProcessing(&response, inferRequest, sequence, sequenceProcessingSpec, executingInferId);
+
+    auto readIrState = [&]() {
+        InferenceEngine::Blob::Ptr stateCloneBlob = nullptr;
+        EXPECT_EQ(ovms::blobClone(stateCloneBlob, inferRequest.QueryState()[0].GetState()), ovms::StatusCode::OK);
+        auto data = InferenceEngine::as<InferenceEngine::MemoryBlob>(stateCloneBlob)->rmap().as<float*>();
+        return std::vector<float>(data, data + elementsCount);
+    };
+    // State modified directly in infer request is kept, since loading from sequence is skipped
+    realModel.setVariableState(inferRequest, currentState);
+    modelInstance->preInferenceProcessing(inferRequest, sequence, sequenceProcessingSpec, executingInferId);
+    EXPECT_EQ(readIrState(), currentState);
+
+    // Preprocessing clears stream owner, so state is loaded from sequence when postprocessing did not follow
+    modelInstance->preInferenceProcessing(inferRequest, sequence, sequenceProcessingSpec, executingInferId);
+    EXPECT_EQ(readIrState(), newState);
+}
+
 TEST_F(StatefulModelInstanceTest, extractSequenceId_OK) {
     tensorflow::TensorProto proto;
     proto.set_dtype(tensorflow::DataType::DT_UINT64);
@@ -129,8 +129,8 @@ public:
 
 class MockedSequenceManager : public ovms::SequenceManager {
 public:
-    MockedSequenceManager(uint32_t maxSequenceNumber, std::string name, ovms::model_version_t version) :
-        ovms::SequenceManager(maxSequenceNumber, name, version) {}
+    MockedSequenceManager(uint32_t maxSequenceNumber, std::string name, ovms::model_version_t version, uint32_t idleSequenceTimeoutSeconds = 0, uint32_t idleSequenceCompressionSeconds = 0) :
+        ovms::SequenceManager(maxSequenceNumber, name, version, idleSequenceTimeoutSeconds, idleSequenceCompressionSeconds) {}
 
     void setSequenceIdCounter(uint64_t newValue) {
         this->sequenceIdCounter = newValue;
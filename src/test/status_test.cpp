@@ -0,0 +1,57 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../status.hpp"
+
+using namespace ovms;
+
+TEST(Status, MessageAndProtocolCodesFromTables) {
+    Status status(StatusCode::INVALID_SHAPE);
+    EXPECT_EQ(status.string(), "Invalid input shape");
+    EXPECT_EQ(status.http(), net_http::HTTPStatusCode::BAD_REQUEST);
+    EXPECT_EQ(status.grpc().error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_EQ(status.grpc().error_message(), "Invalid input shape");
+    EXPECT_EQ(Status().string(), "");
+    EXPECT_EQ(Status().grpc().error_code(), grpc::StatusCode::OK);
+    EXPECT_EQ(Status(StatusCode::OK_RELOADED).http(), net_http::HTTPStatusCode::CREATED);
+}
+
+TEST(Status, StatusWithoutDetailsReturnsSharedDefaultMessage) {
+    Status first(StatusCode::INVALID_PRECISION);
+    Status second(StatusCode::INVALID_PRECISION);
+    Status copy = first;
+    EXPECT_EQ(&first.string(), &second.string());
+    EXPECT_EQ(&first.string(), &copy.string());
+}
+
+TEST(Status, DetailsAppendedToMessageAndSharedByCopies) {
+    Status status(StatusCode::INVALID_BATCH_SIZE, "Expected: 1; Actual: 2");
+    EXPECT_EQ(status.string(), "Invalid input batch size - Expected: 1; Actual: 2");
+    Status copy = status;
+    EXPECT_EQ(&status.string(), &copy.string());
+    EXPECT_EQ(copy, Status(StatusCode::INVALID_BATCH_SIZE));
+    EXPECT_EQ(copy.grpc().error_message(), status.string());
+}
+
+TEST(Status, CodesWithoutMappingFallBackToUnknown) {
+    Status status(StatusCode::STATUS_CODE_END);
+    EXPECT_EQ(status.string(), "Unknown error");
+    EXPECT_EQ(status.http(), net_http::HTTPStatusCode::ERROR);
+    EXPECT_EQ(status.grpc().error_code(), grpc::StatusCode::UNKNOWN);
+}
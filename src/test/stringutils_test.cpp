@@ -150,3 +150,18 @@ TEST(StringUtils, stoi32) {
     EXPECT_TRUE(result);
     EXPECT_EQ(result.value(), -2147483648);
 }
+
+TEST(StringUtils, parseCpuList) {
+    auto result = ovms::parseCpuList("0-3,8,10-11");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value(), std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+
+    result = ovms::parseCpuList("");
+    ASSERT_TRUE(result);
+    EXPECT_TRUE(result.value().empty());
+
+    EXPECT_FALSE(ovms::parseCpuList("3-1"));
+    EXPECT_FALSE(ovms::parseCpuList("1,,2"));
+    EXPECT_FALSE(ovms::parseCpuList("-1"));
+    EXPECT_FALSE(ovms::parseCpuList("a"));
+}
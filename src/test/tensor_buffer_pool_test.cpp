@@ -0,0 +1,143 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../memory_lock.hpp"
+#include "../ov_utils.hpp"
+#include "../tensor_buffer_pool.hpp"
+
+using namespace ovms;
+
+namespace {
+const size_t KB = 1024;
+const size_t MB = 1024 * KB;
+}  // namespace
+
+TEST(TensorBufferPool, FreedBufferIsReusedForSimilarSize) {
+    TensorBufferPool pool(16 * MB, 4 * MB);
+    auto* first = pool.alloc(100 * KB);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % TensorBufferPool::ALIGNMENT, 0);
+    pool.free(first);
+    // 100KB and 110KB are both in 112KB size class
+    EXPECT_EQ(pool.getIdleBytes(), 112 * KB);
+
+    auto* second = pool.alloc(110 * KB);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(pool.getIdleBytes(), 0);
+    EXPECT_EQ(pool.getHits(), 1);
+    EXPECT_EQ(pool.getMisses(), 1);
+
+    auto* bigger = pool.alloc(120 * KB);
+    EXPECT_NE(bigger, second);
+    EXPECT_EQ(pool.getMisses(), 2);
+    pool.free(second);
+    pool.free(bigger);
+}
+
+TEST(TensorBufferPool, SmallAndOversizedBuffersAreNotPooled) {
+    TensorBufferPool pool(16 * MB, 1 * MB);
+    pool.free(pool.alloc(100));
+    EXPECT_EQ(pool.getMisses(), 0);
+    pool.free(pool.alloc(2 * MB));
+    EXPECT_EQ(pool.getMisses(), 1);
+    EXPECT_EQ(pool.getIdleBytes(), 0);
+    pool.free(pool.alloc(2 * MB));
+    EXPECT_EQ(pool.getHits(), 0);
+    EXPECT_EQ(pool.getMisses(), 2);
+}
+
+TEST(TensorBufferPool, IdleMemoryIsLimited) {
+    TensorBufferPool pool(256 * KB, 1 * MB);
+    auto* first = pool.alloc(128 * KB);
+    auto* second = pool.alloc(128 * KB);
+    auto* third = pool.alloc(128 * KB);
+    pool.free(first);
+    pool.free(second);
+    pool.free(third);
+    EXPECT_EQ(pool.getIdleBytes(), 256 * KB);
+
+    // buffers of other size make room for recently freed one
+    pool.free(pool.alloc(192 * KB));
+    EXPECT_EQ(pool.getIdleBytes(), 192 * KB);
+    pool.free(pool.alloc(192 * KB));
+    EXPECT_EQ(pool.getHits(), 1);
+}
+
+TEST(TensorBufferPool, LargeBuffersAreBackedByHugePages) {
+    for (auto hugePages : {HugePages::TRANSPARENT, HugePages::EXPLICIT}) {
+        TensorBufferPool pool(64 * MB, 32 * MB, nullptr, hugePages);
+        auto* large = static_cast<char*>(pool.alloc(3 * MB));
+        ASSERT_NE(large, nullptr);
+        // explicit huge pages fall back to transparent ones, both are aligned to huge page
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % TensorBufferPool::HUGE_PAGE_SIZE, 0);
+        std::fill(large, large + 3 * MB, 1);
+        pool.free(large);
+        // size classes from huge page size up are its multiples
+        EXPECT_EQ(pool.getIdleBytes(), 4 * MB);
+        EXPECT_EQ(pool.alloc(4 * MB), large);
+        pool.free(large);
+
+        auto* oversized = static_cast<char*>(pool.alloc(40 * MB));
+        ASSERT_NE(oversized, nullptr);
+        std::fill(oversized, oversized + 40 * MB, 1);
+        pool.free(oversized);
+        EXPECT_EQ(pool.getIdleBytes(), 4 * MB);
+    }
+}
+
+TEST(TensorBufferPool, BuffersAreLockedWhileKept) {
+    for (auto hugePages : {HugePages::NONE, HugePages::TRANSPARENT}) {
+        TensorBufferPool pool(16 * MB, 8 * MB, nullptr, hugePages, true);
+        auto* buffer = static_cast<char*>(pool.alloc(3 * MB));
+        ASSERT_NE(buffer, nullptr);
+        if (pool.getLockedBytes() == 0) {
+            GTEST_SKIP() << "RLIMIT_MEMLOCK does not allow locking tensor buffers";
+        }
+        // pages inside buffer are locked, with huge pages whole mapping is
+        EXPECT_GE(pool.getLockedBytes(), 3 * MB - 2 * MemoryLock::getPageSize());
+        std::fill(buffer, buffer + 3 * MB, 1);
+        pool.free(buffer);
+        // idle buffer stays locked until it is released
+        EXPECT_GT(pool.getLockedBytes(), 0);
+        auto* oversized = pool.alloc(10 * MB);
+        ASSERT_NE(oversized, nullptr);
+        const size_t lockedWithOversized = pool.getLockedBytes();
+        pool.free(oversized);
+        EXPECT_LT(pool.getLockedBytes(), lockedWithOversized);
+    }
+}
+
+TEST(TensorBufferPool, GlobalPoolIsUsedForServerCreatedBlobs) {
+    auto pool = std::make_shared<TensorBufferPool>(16 * MB, 4 * MB);
+    TensorBufferPool::setGlobal(pool);
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::FP32, {1, 3, 224, 224}, InferenceEngine::Layout::NCHW};
+    InferenceEngine::Blob::Ptr blob;
+    ASSERT_EQ(createSharedBlob(blob, desc), StatusCode::OK);
+    void* data = InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<void*>();
+    blob.reset();
+    EXPECT_GT(pool->getIdleBytes(), 0);
+
+    blob = makePooledBlob<float>(desc);
+    EXPECT_EQ(InferenceEngine::as<InferenceEngine::MemoryBlob>(blob)->wmap().as<void*>(), data);
+    EXPECT_EQ(pool->getHits(), 1);
+    blob.reset();
+    TensorBufferPool::setGlobal(nullptr);
+}
@@ -0,0 +1,91 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../modelconfig.hpp"
+#include "../tensor_metadata.hpp"
+#include "../tensorinfo.hpp"
+
+using namespace ovms;
+
+TEST(TensorMetadataTable, EntriesFollowTensorMapOrder) {
+    tensor_map_t tensors;
+    tensors["b"] = std::make_shared<TensorInfo>("b", InferenceEngine::Precision::FP32, shape_t{1, 3, 224, 224}, InferenceEngine::Layout::NCHW);
+    tensors["a"] = std::make_shared<TensorInfo>("a", InferenceEngine::Precision::I64, shape_t{1, 10}, InferenceEngine::Layout::NC);
+    TensorMetadataTable table(tensors, nullptr);
+    ASSERT_EQ(table.size(), 2);
+    EXPECT_EQ(table[0].name, "a");
+    EXPECT_EQ(table[0].dataType, tensorflow::DataType::DT_INT64);
+    EXPECT_EQ(table[0].elementSize, 8);
+    EXPECT_EQ(table[0].rank, 2);
+    EXPECT_EQ(table[1].name, "b");
+    EXPECT_EQ(table[1].info, tensors["b"]);
+    EXPECT_EQ(table[1].rank, 4);
+    EXPECT_EQ(table[1].getDimension(1), 3);
+    EXPECT_EQ(table[1].getDimension(3), 224);
+    EXPECT_FALSE(table[1].isShapeAuto);
+}
+
+TEST(TensorMetadataTable, FindByName) {
+    tensor_map_t tensors;
+    tensors["input"] = std::make_shared<TensorInfo>("input", InferenceEngine::Precision::FP32, shape_t{1, 10});
+    TensorMetadataTable table(tensors, nullptr);
+    ASSERT_NE(table.find("input"), nullptr);
+    EXPECT_EQ(table.find("input")->info, tensors["input"]);
+    EXPECT_EQ(table.find("output"), nullptr);
+    EXPECT_EQ(TensorMetadataTable().find("input"), nullptr);
+}
+
+TEST(TensorMetadataTable, ShapeLongerThanInlineStorageIsReadFromTensorInfo) {
+    tensor_map_t tensors;
+    tensors["input"] = std::make_shared<TensorInfo>("input", InferenceEngine::Precision::U8, shape_t{1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+    TensorMetadataTable table(tensors, nullptr);
+    ASSERT_EQ(table[0].rank, 10);
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(table[0].getDimension(i), i + 1);
+    }
+}
+
+TEST(TensorMetadataTable, ConvertedPrecisionAndResizedDimensions) {
+    auto info = std::make_shared<TensorInfo>("input", InferenceEngine::Precision::FP32, shape_t{1, 224, 224, 3}, InferenceEngine::Layout::NHWC);
+    info->setRequestPrecision(InferenceEngine::Precision::U8);
+    info->setResizedByPreprocessing(true);
+    tensor_map_t tensors{{"input", info}};
+    TensorMetadataTable table(tensors, nullptr);
+    const auto& metadata = table[0];
+    EXPECT_TRUE(metadata.acceptsDataType(tensorflow::DataType::DT_FLOAT));
+    EXPECT_TRUE(metadata.acceptsDataType(tensorflow::DataType::DT_UINT8));
+    EXPECT_FALSE(metadata.acceptsDataType(tensorflow::DataType::DT_INT32));
+    EXPECT_EQ(metadata.getElementSize(tensorflow::DataType::DT_FLOAT), 4);
+    EXPECT_EQ(metadata.getElementSize(tensorflow::DataType::DT_UINT8), 1);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(metadata.isResizedDimension(i), info->isResizedDimension(i)) << i;
+    }
+}
+
+TEST(TensorMetadataTable, ShapeModeFromConfig) {
+    tensor_map_t tensors;
+    tensors["auto"] = std::make_shared<TensorInfo>("auto", InferenceEngine::Precision::FP32, shape_t{1, 10});
+    tensors["fixed"] = std::make_shared<TensorInfo>("fixed", InferenceEngine::Precision::FP32, shape_t{1, 10});
+    ModelConfig config;
+    ASSERT_EQ(config.parseShapeParameter("{\"auto\": \"auto\"}"), StatusCode::OK);
+    TensorMetadataTable table(tensors, &config);
+    EXPECT_TRUE(table.find("auto")->isShapeAuto);
+    EXPECT_FALSE(table.find("fixed")->isShapeAuto);
+}
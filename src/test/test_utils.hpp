@@ -205,8 +205,20 @@ public:
     /**
      * @brief Updates OVMS configuration with cached configuration file. Will check for newly added model versions
      */
-    void updateConfigurationWithoutConfigFile() {
-        ModelManager::updateConfigurationWithoutConfigFile();
+    void updateConfigurationWithoutConfigFile(bool checkAllModels = true) {
+        ModelManager::updateConfigurationWithoutConfigFile(checkAllModels);
+    }
+
+    void setModelsMemoryBudgetBytes(uint64_t budget) {
+        modelsMemoryBudgetBytes = budget;
+    }
+
+    void setRemoteListingTtlSec(uint seconds) {
+        remoteListingTtlSec = seconds;
+    }
+
+    void setVersionSwapPolicy(ovms::VersionSwapPolicy policy) {
+        versionSwapPolicy = policy;
     }
 };
 class TestWithTempDir : public ::testing::Test {
@@ -0,0 +1,89 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../timing_wheel.hpp"
+
+using ovms::TimingWheel;
+
+static std::vector<uint64_t> advance(TimingWheel& wheel, uint64_t tick) {
+    std::vector<TimingWheel::Entry> expired;
+    wheel.advance(tick, expired);
+    std::vector<uint64_t> ids;
+    for (const auto& entry : expired) {
+        EXPECT_LE(entry.deadline, tick);
+        ids.push_back(entry.id);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+TEST(TimingWheel, ExpiresEntriesAtDeadline) {
+    TimingWheel wheel;
+    wheel.schedule(1, 3);
+    wheel.schedule(2, 3);
+    wheel.schedule(3, 5);
+    EXPECT_EQ(wheel.size(), 3);
+
+    EXPECT_TRUE(advance(wheel, 2).empty());
+    EXPECT_EQ(advance(wheel, 3), (std::vector<uint64_t>{1, 2}));
+    EXPECT_TRUE(advance(wheel, 4).empty());
+    EXPECT_EQ(advance(wheel, 5), (std::vector<uint64_t>{3}));
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(TimingWheel, PastDeadlineExpiresOnNextTick) {
+    TimingWheel wheel;
+    advance(wheel, 100);
+    wheel.schedule(1, 50);
+    EXPECT_EQ(advance(wheel, 101), (std::vector<uint64_t>{1}));
+}
+
+TEST(TimingWheel, CascadesEntriesFromHigherLevels) {
+    TimingWheel wheel;
+    const uint64_t start = 1000;
+    advance(wheel, start);
+    // Deadlines spread over all levels of the wheel
+    std::vector<uint64_t> deadlines{start + 63, start + 64, start + 4095, start + 4097, start + 300000, start + 1000000};
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+        wheel.schedule(i, deadlines[i]);
+    }
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+        EXPECT_TRUE(advance(wheel, deadlines[i] - 1).empty()) << "deadline: " << deadlines[i];
+        EXPECT_EQ(advance(wheel, deadlines[i]), (std::vector<uint64_t>{i})) << "deadline: " << deadlines[i];
+    }
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(TimingWheel, KeepsDeadlineBeyondRange) {
+    TimingWheel wheel;
+    const uint64_t deadline = 100000000;
+    wheel.schedule(1, deadline);
+    EXPECT_TRUE(advance(wheel, deadline - 1).empty());
+    EXPECT_EQ(advance(wheel, deadline), (std::vector<uint64_t>{1}));
+}
+
+TEST(TimingWheel, JumpsOverTicksWhenEmpty) {
+    TimingWheel wheel;
+    advance(wheel, 1ULL << 40);
+    EXPECT_EQ(wheel.getCurrentTick(), 1ULL << 40);
+    wheel.schedule(1, (1ULL << 40) + 10);
+    EXPECT_EQ(advance(wheel, (1ULL << 40) + 10), (std::vector<uint64_t>{1}));
+}
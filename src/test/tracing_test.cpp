@@ -0,0 +1,104 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../status.hpp"
+#include "../tracing.hpp"
+#include "test_utils.hpp"
+
+using ovms::Span;
+using ovms::TraceContext;
+using ovms::Tracer;
+
+TEST(TraceContext, ParsesTraceparent) {
+    auto context = TraceContext::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+    ASSERT_TRUE(context.has_value());
+    EXPECT_EQ(context->traceIdHigh, 0x4bf92f3577b34da6);
+    EXPECT_EQ(context->traceIdLow, 0xa3ce929d0e0e4736);
+    EXPECT_EQ(context->spanId, 0x00f067aa0ba902b7);
+    EXPECT_TRUE(context->sampled);
+    EXPECT_EQ(context->toTraceparent(), "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+
+    EXPECT_FALSE(TraceContext::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00")->sampled);
+    EXPECT_FALSE(TraceContext::fromTraceparent(""));
+    EXPECT_FALSE(TraceContext::fromTraceparent("00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01"));
+    EXPECT_FALSE(TraceContext::fromTraceparent("00-00000000000000000000000000000000-00f067aa0ba902b7-01"));
+    EXPECT_FALSE(TraceContext::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01"));
+    EXPECT_FALSE(TraceContext::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-extra"));
+    EXPECT_TRUE(TraceContext::fromTraceparent("01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-extra"));
+}
+
+class TracerTest : public TestWithTempDir {
+protected:
+    void TearDown() override {
+        Tracer::instance().stop();
+        TestWithTempDir::TearDown();
+    }
+
+    std::vector<std::string> readSpans() {
+        std::vector<std::string> lines;
+        std::ifstream file(directoryPath + "/spans.json");
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+};
+
+TEST_F(TracerTest, DisabledTracerDoesNotTrace) {
+    EXPECT_EQ(Tracer::instance().startTrace("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01"), nullptr);
+    Span span(nullptr, "request");
+    EXPECT_FALSE(span.isRecording());
+    EXPECT_EQ(span.getContext(), nullptr);
+}
+
+TEST_F(TracerTest, FollowsCallerSamplingDecision) {
+    Tracer::instance().start(directoryPath + "/spans.json", 0);
+    EXPECT_EQ(Tracer::instance().startTrace(""), nullptr);
+    EXPECT_EQ(Tracer::instance().startTrace("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00"), nullptr);
+    auto context = Tracer::instance().startTrace("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+    ASSERT_NE(context, nullptr);
+    EXPECT_EQ(context->spanId, 0x00f067aa0ba902b7);
+}
+
+TEST_F(TracerTest, ExportsNestedSpans) {
+    Tracer::instance().start(directoryPath + "/spans.json", 1);
+    auto trace = Tracer::instance().startTrace("");
+    ASSERT_NE(trace, nullptr);
+    {
+        Span request(trace, "request");
+        request.setAttribute("model", "dummy\"1");
+        Span child(request.getContext(), "inference");
+        ASSERT_TRUE(child.isRecording());
+        EXPECT_EQ(child.getContext()->traceIdLow, trace->traceIdLow);
+        child.setStatus(ovms::StatusCode::REQUEST_CANCELLED);
+    }
+    Tracer::instance().stop();
+
+    auto spans = readSpans();
+    ASSERT_EQ(spans.size(), 2);
+    EXPECT_NE(spans[0].find("\"name\":\"inference\""), std::string::npos);
+    EXPECT_NE(spans[0].find("\"status\":{\"code\":2"), std::string::npos);
+    EXPECT_NE(spans[1].find("\"name\":\"request\""), std::string::npos);
+    EXPECT_NE(spans[1].find("{\"key\":\"model\",\"value\":{\"stringValue\":\"dummy\\\"1\"}}"), std::string::npos);
+    EXPECT_EQ(spans[1].find("parentSpanId"), std::string::npos);
+    EXPECT_EQ(spans[1].find("status"), std::string::npos);
+}
@@ -0,0 +1,124 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../traffic_capture.hpp"
+#include "test_utils.hpp"
+
+using ovms::TrafficCapture;
+
+namespace {
+uint64_t readLittleEndian(const std::string& data, size_t offset, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+    }
+    return value;
+}
+
+tensorflow::serving::PredictRequest makeRequest(const std::string& modelName) {
+    tensorflow::serving::PredictRequest request;
+    request.mutable_model_spec()->set_name(modelName);
+    auto& input = (*request.mutable_inputs())["b"];
+    input.set_dtype(tensorflow::DataType::DT_FLOAT);
+    input.mutable_tensor_shape()->add_dim()->set_size(2);
+    input.add_float_val(1.0);
+    input.add_float_val(2.0);
+    return request;
+}
+}  // namespace
+
+class TrafficCaptureTest : public TestWithTempDir {
+protected:
+    void TearDown() override {
+        TrafficCapture::instance().stop();
+        TestWithTempDir::TearDown();
+    }
+
+    std::string readCapture() {
+        std::ifstream file(directoryPath + "/capture.bin", std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // parses records of capture file, returns requests and arrival times in microseconds
+    std::vector<std::pair<uint64_t, tensorflow::serving::PredictRequest>> readRecords(const std::string& data) {
+        std::vector<std::pair<uint64_t, tensorflow::serving::PredictRequest>> records;
+        size_t offset = TrafficCapture::MAGIC_SIZE;
+        while (offset + TrafficCapture::RECORD_HEADER_SIZE <= data.size()) {
+            const uint64_t arrivalUs = readLittleEndian(data, offset, sizeof(uint64_t));
+            const size_t size = readLittleEndian(data, offset + sizeof(uint64_t), sizeof(uint32_t));
+            offset += TrafficCapture::RECORD_HEADER_SIZE;
+            EXPECT_LE(offset + size, data.size());
+            tensorflow::serving::PredictRequest request;
+            EXPECT_TRUE(request.ParseFromArray(data.data() + offset, static_cast<int>(size)));
+            records.emplace_back(arrivalUs, std::move(request));
+            offset += size;
+        }
+        EXPECT_EQ(offset, data.size());
+        return records;
+    }
+};
+
+TEST_F(TrafficCaptureTest, RecordHoldsArrivalTimeAndRequest) {
+    std::string record;
+    const auto arrivalTime = std::chrono::system_clock::time_point(std::chrono::microseconds(1'600'000'000'123'456));
+    ASSERT_TRUE(TrafficCapture::appendRecord(record, arrivalTime, makeRequest("dummy")));
+    auto records = readRecords(std::string(TrafficCapture::MAGIC) + record);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].first, 1'600'000'000'123'456);
+    EXPECT_EQ(records[0].second.model_spec().name(), "dummy");
+    EXPECT_EQ(records[0].second.inputs().at("b").float_val_size(), 2);
+}
+
+TEST_F(TrafficCaptureTest, DisabledCaptureDoesNotCapture) {
+    const auto captured = TrafficCapture::instance().getCapturedRequestsCount();
+    TrafficCapture::instance().capture(makeRequest("dummy"));
+    EXPECT_EQ(TrafficCapture::instance().getCapturedRequestsCount(), captured);
+}
+
+TEST_F(TrafficCaptureTest, AppendsSampledRequestsToCaptureFile) {
+    const auto start = std::chrono::system_clock::now();
+    ASSERT_TRUE(TrafficCapture::instance().start(directoryPath + "/capture.bin", 1));
+    TrafficCapture::instance().capture(makeRequest("first"));
+    TrafficCapture::instance().capture(makeRequest("second"));
+    TrafficCapture::instance().stop();
+    // records of the next run are appended after magic written once
+    ASSERT_TRUE(TrafficCapture::instance().start(directoryPath + "/capture.bin", 1));
+    TrafficCapture::instance().capture(makeRequest("third"));
+    TrafficCapture::instance().stop();
+
+    const auto data = readCapture();
+    ASSERT_EQ(data.compare(0, TrafficCapture::MAGIC_SIZE, TrafficCapture::MAGIC), 0);
+    auto records = readRecords(data);
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_EQ(records[0].second.model_spec().name(), "first");
+    EXPECT_EQ(records[1].second.model_spec().name(), "second");
+    EXPECT_EQ(records[2].second.model_spec().name(), "third");
+    EXPECT_GE(records[0].first, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(start.time_since_epoch()).count()));
+    EXPECT_LE(records[0].first, records[2].first);
+
+    ASSERT_TRUE(TrafficCapture::instance().start(directoryPath + "/capture.bin", 0));
+    TrafficCapture::instance().capture(makeRequest("fourth"));
+    TrafficCapture::instance().stop();
+    EXPECT_EQ(readRecords(readCapture()).size(), 3);
+}
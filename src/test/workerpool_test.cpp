@@ -0,0 +1,67 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../workerpool.hpp"
+
+using ovms::WorkerPool;
+
+TEST(WorkerPool, DestructorWaitsForScheduledTasks) {
+    std::atomic<int> executed{0};
+    {
+        WorkerPool pool(2);
+        for (int i = 0; i < 100; ++i) {
+            pool.schedule([&executed]() { ++executed; });
+        }
+        EXPECT_LE(pool.getThreadsCount(), 2);
+    }
+    EXPECT_EQ(executed, 100);
+}
+
+TEST(WorkerPool, SpawnsThreadWhenAllWorkersAreBusy) {
+    WorkerPool pool(2);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> secondStarted;
+    pool.schedule([released]() { released.wait(); });
+    pool.schedule([&secondStarted]() { secondStarted.set_value(); });
+    EXPECT_EQ(secondStarted.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(pool.getThreadsCount(), 2);
+    release.set_value();
+}
+
+TEST(WorkerPool, ParallelForStopsStartingIndexesAfterFailure) {
+    WorkerPool pool(3);
+    std::vector<std::atomic<int>> visits(1000);
+    WorkerPool::parallelFor(&pool, 0, visits.size(), [&visits](size_t i) {
+        ++visits[i];
+        return true;
+    });
+    for (const auto& count : visits) {
+        EXPECT_EQ(count, 1);
+    }
+    std::atomic<size_t> started{0};
+    WorkerPool::parallelFor(nullptr, 0, visits.size(), [&started](size_t i) {
+        ++started;
+        return i < 10;
+    });
+    EXPECT_EQ(started, 11);
+}
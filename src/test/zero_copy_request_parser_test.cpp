@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../shared_memory.hpp"
+#include "../zero_copy_request_parser.hpp"
+
+using namespace ovms;
+
+using tensorflow::serving::PredictRequest;
+
+namespace {
+const size_t MIN_ALIASED_CONTENT_SIZE = 64;
+
+PredictRequest prepareRequest(size_t contentSize) {
+    PredictRequest request;
+    request.mutable_model_spec()->set_name("dummy");
+    request.mutable_model_spec()->mutable_version()->set_value(1);
+    request.add_output_filter("a");
+    auto& big = (*request.mutable_inputs())["big"];
+    big.set_dtype(tensorflow::DT_FLOAT);
+    big.mutable_tensor_shape()->add_dim()->set_size(contentSize / sizeof(float));
+    std::vector<float> data(contentSize / sizeof(float));
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = i;
+    }
+    big.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), contentSize);
+    auto& small = (*request.mutable_inputs())["small"];
+    small.set_dtype(tensorflow::DT_FLOAT);
+    small.mutable_tensor_shape()->add_dim()->set_size(1);
+    float value = 7;
+    small.mutable_tensor_content()->assign(reinterpret_cast<const char*>(&value), sizeof(value));
+    return request;
+}
+
+grpc::ByteBuffer toByteBuffer(const std::string& message, const std::vector<size_t>& splits) {
+    std::vector<grpc::Slice> slices;
+    size_t start = 0;
+    for (size_t split : splits) {
+        slices.emplace_back(message.data() + start, split - start);
+        start = split;
+    }
+    slices.emplace_back(message.data() + start, message.size() - start);
+    return grpc::ByteBuffer(slices.data(), slices.size());
+}
+}  // namespace
+
+TEST(ZeroCopyRequestParser, AliasesLargeContent) {
+    auto expected = prepareRequest(1024);
+    auto buffer = toByteBuffer(expected.SerializeAsString(), {});
+    PredictRequest request;
+    auto parser = std::make_unique<ZeroCopyRequestParser>(MIN_ALIASED_CONTENT_SIZE);
+    ASSERT_EQ(parser->parse(buffer, request), StatusCode::OK);
+    EXPECT_EQ(parser->getAliasedInputsCount(), 1);
+    EXPECT_EQ(request.model_spec().name(), "dummy");
+    EXPECT_EQ(request.model_spec().version().value(), 1);
+    ASSERT_EQ(request.output_filter_size(), 1);
+    EXPECT_EQ(request.output_filter(0), "a");
+    ASSERT_EQ(request.inputs().size(), 2);
+
+    const auto& small = request.inputs().at("small");
+    EXPECT_FALSE(isSharedMemoryReference(small));
+    EXPECT_EQ(small.tensor_content(), expected.inputs().at("small").tensor_content());
+
+    const auto& big = request.inputs().at("big");
+    ASSERT_TRUE(isSharedMemoryReference(big));
+    EXPECT_TRUE(big.tensor_content().empty());
+    EXPECT_EQ(big.tensor_shape().dim(0).size(), 256);
+    std::shared_ptr<SharedMemoryRegion> region;
+    char* data = nullptr;
+    ASSERT_EQ(resolveSharedMemoryReference(big, 1024, region, data), StatusCode::OK);
+    EXPECT_EQ(std::memcmp(data, expected.inputs().at("big").tensor_content().data(), 1024), 0);
+
+    const std::string regionName = big.resource_handle_val(0).name();
+    EXPECT_TRUE(isRequestRegionName(regionName));
+    parser.reset();
+    EXPECT_EQ(SharedMemoryRegistry::getInstance().getRegion(regionName, region), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+}
+
+TEST(ZeroCopyRequestParser, CopiesContentSplitBetweenSlices) {
+    auto expected = prepareRequest(1024);
+    const auto message = expected.SerializeAsString();
+    const auto contentPosition = message.find(expected.inputs().at("big").tensor_content());
+    ASSERT_NE(contentPosition, std::string::npos);
+    auto buffer = toByteBuffer(message, {contentPosition + 100});
+    PredictRequest request;
+    ZeroCopyRequestParser parser(MIN_ALIASED_CONTENT_SIZE);
+    ASSERT_EQ(parser.parse(buffer, request), StatusCode::OK);
+    EXPECT_EQ(parser.getAliasedInputsCount(), 0);
+    const auto& big = request.inputs().at("big");
+    EXPECT_FALSE(isSharedMemoryReference(big));
+    EXPECT_EQ(big.tensor_content(), expected.inputs().at("big").tensor_content());
+    EXPECT_EQ(request.model_spec().name(), "dummy");
+}
+
+TEST(ZeroCopyRequestParser, ParsesMessageSplitAnywhere) {
+    auto expected = prepareRequest(1024);
+    const auto message = expected.SerializeAsString();
+    for (size_t split = 1; split < message.size(); split += 7) {
+        auto buffer = toByteBuffer(message, {split});
+        PredictRequest request;
+        ZeroCopyRequestParser parser(MIN_ALIASED_CONTENT_SIZE);
+        ASSERT_EQ(parser.parse(buffer, request), StatusCode::OK) << "split: " << split;
+        EXPECT_EQ(request.inputs().at("small").tensor_content(), expected.inputs().at("small").tensor_content());
+        EXPECT_EQ(request.output_filter(0), "a");
+    }
+}
+
+TEST(ZeroCopyRequestParser, RejectsReferenceToRequestRegion) {
+    auto expected = prepareRequest(16);
+    auto& input = (*expected.mutable_inputs())["small"];
+    input.clear_tensor_content();
+    setSharedMemoryReference(input, std::string(REQUEST_REGION_PREFIX) + "0/0", 0);
+    auto buffer = toByteBuffer(expected.SerializeAsString(), {});
+    PredictRequest request;
+    ZeroCopyRequestParser parser(MIN_ALIASED_CONTENT_SIZE);
+    EXPECT_EQ(parser.parse(buffer, request), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+}
+
+TEST(ZeroCopyRequestParser, RejectsTruncatedMessage) {
+    auto expected = prepareRequest(1024);
+    const auto message = expected.SerializeAsString();
+    auto buffer = toByteBuffer(message.substr(0, message.size() - 10), {});
+    PredictRequest request;
+    ZeroCopyRequestParser parser(MIN_ALIASED_CONTENT_SIZE);
+    EXPECT_EQ(parser.parse(buffer, request), StatusCode::GRPC_REQUEST_PARSING_FAILED);
+}
@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
 #include <optional>
 #include <queue>
@@ -44,6 +45,25 @@ public:
         signal.notify_one();
     }
 
+    T pull() {
+        std::unique_lock<std::mutex> lock(mtx);
+        signal.wait(lock, [this]() { return queue.size() > 0; });
+        T element = std::move(queue.front());
+        queue.pop();
+        return element;
+    }
+
+    template <typename Clock, typename Duration>
+    std::optional<T> tryPullUntil(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!signal.wait_until(lock, deadline, [this]() { return queue.size() > 0; })) {
+            return std::nullopt;
+        }
+        T element = std::move(queue.front());
+        queue.pop();
+        return std::optional<T>{std::move(element)};
+    }
+
     std::optional<T> tryPull(const uint waitDurationMicroseconds) {
         std::unique_lock<std::mutex> lock(mtx);
         if (signal.wait_for(lock,
@@ -15,9 +15,9 @@
 //*****************************************************************************
 #pragma once
 
+#include <array>
 #include <chrono>
-#include <string>
-#include <unordered_map>
+#include <cstddef>
 
 namespace ovms {
 
@@ -27,23 +27,32 @@ struct is_chrono_duration_type : std::false_type {};
 template <typename T, typename U>
 struct is_chrono_duration_type<std::chrono::duration<T, U>> : std::true_type {};
 
+/**
+ * @brief Measures durations of fixed set of stages
+ *
+ * Stages are indexes known at compile time, typically enumerators ending with number of stages,
+ * so measuring does not hash or allocate and is cheap enough for every request.
+ */
+template <size_t N>
 class Timer {
-    std::unordered_map<std::string, std::chrono::high_resolution_clock::time_point> startTimestamps;
-    std::unordered_map<std::string, std::chrono::high_resolution_clock::time_point> stopTimestamps;
+    using clock_t = std::chrono::steady_clock;
+
+    std::array<clock_t::time_point, N> startTimestamps;
+    std::array<clock_t::time_point, N> stopTimestamps;
 
 public:
-    void start(const std::string& name) {
-        startTimestamps[name] = std::chrono::high_resolution_clock::now();
+    void start(size_t index) {
+        startTimestamps[index] = clock_t::now();
     }
 
-    void stop(const std::string& name) {
-        stopTimestamps[name] = std::chrono::high_resolution_clock::now();
+    void stop(size_t index) {
+        stopTimestamps[index] = clock_t::now();
     }
 
     template <typename T>
-    double elapsed(const std::string& name) {
+    double elapsed(size_t index) const {
         static_assert(is_chrono_duration_type<T>::value, "Non supported type.");
-        return std::chrono::duration_cast<T>(stopTimestamps[name] - startTimestamps[name]).count();
+        return std::chrono::duration_cast<T>(stopTimestamps[index] - startTimestamps[index]).count();
     }
 };
 
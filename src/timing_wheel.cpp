@@ -0,0 +1,87 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "timing_wheel.hpp"
+
+#include <algorithm>
+
+namespace ovms {
+
+void TimingWheel::place(const Entry& entry) {
+    for (uint32_t level = 0; level < LEVELS_COUNT; ++level) {
+        const uint32_t parentShift = SLOT_BITS * (level + 1);
+        if ((entry.deadline >> parentShift) == (currentTick >> parentShift)) {
+            levels[level][(entry.deadline >> (SLOT_BITS * level)) % SLOTS_COUNT].push_back(entry);
+            levelEntriesCount[level]++;
+            return;
+        }
+    }
+    // Deadline beyond range of the wheel, entry is placed again after almost full rotation of the top level
+    const uint32_t topShift = SLOT_BITS * (LEVELS_COUNT - 1);
+    levels[LEVELS_COUNT - 1][((currentTick >> topShift) + SLOTS_COUNT - 1) % SLOTS_COUNT].push_back(entry);
+    levelEntriesCount[LEVELS_COUNT - 1]++;
+}
+
+void TimingWheel::schedule(uint64_t id, uint64_t deadline) {
+    place({id, deadline > currentTick ? deadline : currentTick + 1});
+    entriesCount++;
+}
+
+void TimingWheel::advance(uint64_t tick, std::vector<Entry>& expired) {
+    if (entriesCount == 0 && tick > currentTick) {
+        currentTick = tick;
+        return;
+    }
+    while (currentTick < tick) {
+        // Ticks before next slot boundary of the lowest level with entries have nothing to expire or cascade
+        uint32_t emptyLevels = 0;
+        while (emptyLevels < LEVELS_COUNT - 1 && levelEntriesCount[emptyLevels] == 0) {
+            emptyLevels++;
+        }
+        if (emptyLevels > 0) {
+            const uint64_t boundary = ((currentTick >> (SLOT_BITS * emptyLevels)) + 1) << (SLOT_BITS * emptyLevels);
+            currentTick = std::min(tick, boundary) - 1;
+        }
+        currentTick++;
+        // Higher levels are cascaded first, so their entries reach level 0 slot of current tick
+        for (uint32_t level = LEVELS_COUNT - 1; level > 0; --level) {
+            const uint32_t shift = SLOT_BITS * level;
+            if ((currentTick & ((uint64_t(1) << shift) - 1)) != 0) {
+                continue;
+            }
+            std::vector<Entry> cascaded;
+            cascaded.swap(levels[level][(currentTick >> shift) % SLOTS_COUNT]);
+            levelEntriesCount[level] -= cascaded.size();
+            for (const auto& entry : cascaded) {
+                if (entry.deadline <= currentTick) {
+                    expired.push_back(entry);
+                    entriesCount--;
+                } else {
+                    place(entry);
+                }
+            }
+        }
+        auto& slot = levels[0][currentTick % SLOTS_COUNT];
+        entriesCount -= slot.size();
+        levelEntriesCount[0] -= slot.size();
+        expired.insert(expired.end(), slot.begin(), slot.end());
+        slot.clear();
+        if (entriesCount == 0) {
+            currentTick = tick;
+        }
+    }
+}
+
+}  // namespace ovms
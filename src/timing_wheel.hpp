@@ -0,0 +1,77 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Hierarchical timing wheel of entries identified by id, with deadlines in ticks
+ *
+ * Each level has SLOTS_COUNT slots, slot of level L covers SLOTS_COUNT^L ticks. Entries are placed
+ * at the lowest level where they share parent slot with the current tick and are cascaded to lower
+ * levels when the wheel reaches their slot, so advancing the wheel costs O(expired) amortized.
+ * Ticks without entries due at any level are skipped.
+ * Entries cannot be cancelled, owner is expected to ignore expired ids which are no longer valid.
+ * Not thread safe.
+ */
+class TimingWheel {
+public:
+    static const uint32_t SLOT_BITS = 6;
+    static const uint32_t SLOTS_COUNT = 1 << SLOT_BITS;
+    static const uint32_t LEVELS_COUNT = 4;
+
+    struct Entry {
+        uint64_t id;
+        uint64_t deadline;
+    };
+
+private:
+    uint64_t currentTick = 0;
+    size_t entriesCount = 0;
+    std::array<std::array<std::vector<Entry>, SLOTS_COUNT>, LEVELS_COUNT> levels;
+    std::array<size_t, LEVELS_COUNT> levelEntriesCount{};
+
+    void place(const Entry& entry);
+
+public:
+    uint64_t getCurrentTick() const {
+        return currentTick;
+    }
+
+    size_t size() const {
+        return entriesCount;
+    }
+
+    /**
+     * @brief Schedules entry, deadlines not later than current tick expire on the next tick
+     */
+    void schedule(uint64_t id, uint64_t deadline);
+
+    /**
+     * @brief Moves the wheel to the given tick
+     *
+     * @param tick ticks before current one are ignored
+     * @param expired entries with deadline up to the tick are appended
+     */
+    void advance(uint64_t tick, std::vector<Entry>& expired);
+};
+
+}  // namespace ovms
@@ -0,0 +1,287 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "tracing.hpp"
+
+#include <fstream>
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+#include "status.hpp"
+
+namespace ovms {
+
+static std::string toHex(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        hex[i] = digits[value & 0x0F];
+        value >>= 4;
+    }
+    return hex;
+}
+
+static bool parseHex(const std::string& value, size_t pos, size_t length, uint64_t& result) {
+    result = 0;
+    for (size_t i = pos; i < pos + length; ++i) {
+        char c = value[i];
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else {
+            return false;
+        }
+        result = (result << 4) | digit;
+    }
+    return true;
+}
+
+std::optional<TraceContext> TraceContext::fromTraceparent(const std::string& value) {
+    // version-traceid-parentid-flags
+    static const size_t LENGTH = 55;
+    if (value.size() < LENGTH || value[2] != '-' || value[35] != '-' || value[52] != '-') {
+        return std::nullopt;
+    }
+    uint64_t version, flags;
+    TraceContext context;
+    if (!parseHex(value, 0, 2, version) || version == 0xff ||
+        (version == 0 && value.size() != LENGTH) ||
+        !parseHex(value, 3, 16, context.traceIdHigh) ||
+        !parseHex(value, 19, 16, context.traceIdLow) ||
+        !parseHex(value, 36, 16, context.spanId) ||
+        !parseHex(value, 53, 2, flags)) {
+        return std::nullopt;
+    }
+    if ((context.traceIdHigh == 0 && context.traceIdLow == 0) || context.spanId == 0) {
+        return std::nullopt;
+    }
+    context.sampled = flags & 0x01;
+    return context;
+}
+
+std::string TraceContext::toTraceparent() const {
+    return "00-" + toHex(traceIdHigh) + toHex(traceIdLow) + "-" + toHex(spanId) + (sampled ? "-01" : "-00");
+}
+
+struct Span::State {
+    SpanData data;
+    std::shared_ptr<const TraceContext> context;
+    bool ended = false;
+
+    ~State() {
+        if (!ended) {
+            data.endTime = std::chrono::system_clock::now();
+        }
+        Tracer::instance().exportSpan(std::move(data));
+    }
+};
+
+Span::Span(const std::shared_ptr<const TraceContext>& parent, const char* name) {
+    if (!parent) {
+        return;
+    }
+    state = std::make_shared<State>();
+    state->data.name = name;
+    state->data.traceIdHigh = parent->traceIdHigh;
+    state->data.traceIdLow = parent->traceIdLow;
+    state->data.parentSpanId = parent->spanId;
+    state->data.spanId = Tracer::generateId();
+    state->data.startTime = std::chrono::system_clock::now();
+    auto context = std::make_shared<TraceContext>(*parent);
+    context->spanId = state->data.spanId;
+    state->context = std::move(context);
+}
+
+void Span::setAttribute(const char* key, const std::string& value) {
+    if (state) {
+        state->data.attributes.emplace_back(key, value);
+    }
+}
+
+void Span::setStatus(const Status& status) {
+    if (state && !status.ok()) {
+        state->data.error = status.string();
+    }
+}
+
+void Span::end() {
+    if (state && !state->ended) {
+        state->data.endTime = std::chrono::system_clock::now();
+        state->ended = true;
+    }
+}
+
+std::shared_ptr<const TraceContext> Span::getContext() const {
+    return state ? state->context : nullptr;
+}
+
+uint64_t Tracer::generateId() {
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    uint64_t id;
+    do {
+        id = generator();
+    } while (id == 0);
+    return id;
+}
+
+Tracer::~Tracer() {
+    stop();
+}
+
+void Tracer::start(const std::string& exportPath, double samplingRatio) {
+    stop();
+    std::lock_guard<std::mutex> lock(mtx);
+    this->exportPath = exportPath;
+    this->samplingRatio = samplingRatio;
+    exiting = false;
+    exporter = std::thread(&Tracer::exportRoutine, this);
+    enabled.store(true, std::memory_order_relaxed);
+    SPDLOG_INFO("Exporting traces to {}, sampling ratio: {}", exportPath, samplingRatio);
+}
+
+void Tracer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!exporter.joinable()) {
+            return;
+        }
+        enabled.store(false, std::memory_order_relaxed);
+        exiting = true;
+    }
+    exportCondition.notify_one();
+    exporter.join();
+}
+
+std::shared_ptr<const TraceContext> Tracer::startTrace(const std::string& traceparent) {
+    if (!isEnabled()) {
+        return nullptr;
+    }
+    if (!traceparent.empty()) {
+        auto parent = TraceContext::fromTraceparent(traceparent);
+        if (parent) {
+            if (!parent->sampled) {
+                return nullptr;
+            }
+            return std::make_shared<const TraceContext>(parent.value());
+        }
+        SPDLOG_DEBUG("Ignoring invalid {} header value: {}", TraceContext::TRACEPARENT_HEADER, traceparent);
+    }
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    if (std::uniform_real_distribution<double>(0, 1)(generator) >= samplingRatio) {
+        return nullptr;
+    }
+    // request span started by the frontend becomes the root of the trace
+    auto context = std::make_shared<TraceContext>();
+    context->traceIdHigh = generateId();
+    context->traceIdLow = generateId();
+    context->sampled = true;
+    return context;
+}
+
+void Tracer::exportSpan(SpanData&& span) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (exiting || !exporter.joinable() || pending.size() >= MAX_PENDING_SPANS) {
+        droppedSpans.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending.push_back(std::move(span));
+}
+
+void Tracer::exportRoutine() {
+    std::vector<SpanData> spans;
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        exportCondition.wait_for(lock, EXPORT_INTERVAL, [this]() { return exiting; });
+        spans.swap(pending);
+        bool exit = exiting;
+        lock.unlock();
+        if (!spans.empty()) {
+            write(spans);
+            spans.clear();
+        }
+        if (exit) {
+            return;
+        }
+        lock.lock();
+    }
+}
+
+static void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += ' ';
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+static std::string toUnixNano(std::chrono::system_clock::time_point time) {
+    return std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+}
+
+void Tracer::write(const std::vector<SpanData>& spans) {
+    std::string out;
+    for (const auto& span : spans) {
+        out += "{\"traceId\":\"" + toHex(span.traceIdHigh) + toHex(span.traceIdLow) + "\"";
+        out += ",\"spanId\":\"" + toHex(span.spanId) + "\"";
+        if (span.parentSpanId != 0) {
+            out += ",\"parentSpanId\":\"" + toHex(span.parentSpanId) + "\"";
+        }
+        out += ",\"name\":";
+        appendJsonString(out, span.name);
+        out += ",\"startTimeUnixNano\":\"" + toUnixNano(span.startTime) + "\"";
+        out += ",\"endTimeUnixNano\":\"" + toUnixNano(span.endTime) + "\"";
+        out += ",\"attributes\":[";
+        for (size_t i = 0; i < span.attributes.size(); ++i) {
+            out += i ? ",{\"key\":" : "{\"key\":";
+            appendJsonString(out, span.attributes[i].first);
+            out += ",\"value\":{\"stringValue\":";
+            appendJsonString(out, span.attributes[i].second);
+            out += "}}";
+        }
+        out += "]";
+        if (span.error) {
+            out += ",\"status\":{\"code\":2,\"message\":";
+            appendJsonString(out, span.error.value());
+            out += "}";
+        }
+        out += "}\n";
+    }
+    std::ofstream file(exportPath, std::ios::app);
+    file << out;
+    if (!file) {
+        SPDLOG_WARN("Unable to write {} spans to {}", spans.size(), exportPath);
+    }
+}
+
+}  // namespace ovms
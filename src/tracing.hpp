@@ -0,0 +1,167 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ovms {
+
+class Status;
+
+/**
+ * @brief Identity of a span as propagated in W3C trace context
+ */
+struct TraceContext {
+    static constexpr const char* TRACEPARENT_HEADER = "traceparent";
+
+    uint64_t traceIdHigh = 0;
+    uint64_t traceIdLow = 0;
+    uint64_t spanId = 0;
+    bool sampled = false;
+
+    /**
+     * @brief Parses traceparent header value, e.g. 00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01
+     */
+    static std::optional<TraceContext> fromTraceparent(const std::string& value);
+
+    std::string toTraceparent() const;
+};
+
+/**
+ * @brief Finished span waiting for export
+ */
+struct SpanData {
+    std::string name;
+    uint64_t traceIdHigh = 0;
+    uint64_t traceIdLow = 0;
+    uint64_t spanId = 0;
+    uint64_t parentSpanId = 0;
+    std::chrono::system_clock::time_point startTime;
+    std::chrono::system_clock::time_point endTime;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::optional<std::string> error;
+};
+
+/**
+ * @brief Handle of span being recorded, empty when request is not traced
+ *
+ * Copies share the same span so it can be passed to completion callbacks.
+ * Span ends on end() or when the last copy is destroyed, and is exported then.
+ */
+class Span {
+    struct State;
+    std::shared_ptr<State> state;
+
+public:
+    Span() = default;
+
+    /**
+     * @brief Starts child span of parent, records nothing if parent is null
+     */
+    Span(const std::shared_ptr<const TraceContext>& parent, const char* name);
+
+    bool isRecording() const {
+        return state != nullptr;
+    }
+
+    void setAttribute(const char* key, const std::string& value);
+    void setStatus(const Status& status);
+    void end();
+
+    /**
+     * @brief Context to start children of this span with, null when not recording
+     */
+    std::shared_ptr<const TraceContext> getContext() const;
+};
+
+/**
+ * @brief Samples requests and exports their spans
+ *
+ * Spans are exported as JSON lines in OpenTelemetry span format by a background thread.
+ * Request threads only append finished spans to a bounded buffer, spans are dropped when it is full.
+ */
+class Tracer {
+    static constexpr size_t MAX_PENDING_SPANS = 65536;
+    static constexpr std::chrono::milliseconds EXPORT_INTERVAL{1000};
+
+    std::atomic<bool> enabled{false};
+    double samplingRatio = 0;
+    std::string exportPath;
+
+    std::mutex mtx;
+    std::condition_variable exportCondition;
+    std::vector<SpanData> pending;
+    bool exiting = false;
+    std::thread exporter;
+    std::atomic<uint64_t> droppedSpans{0};
+
+    void exportRoutine();
+    void write(const std::vector<SpanData>& spans);
+
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    ~Tracer();
+
+    /**
+     * @brief Starts exporting spans to file, traces without sampled parent are started with given probability
+     */
+    void start(const std::string& exportPath, double samplingRatio);
+
+    /**
+     * @brief Exports pending spans and stops exporting
+     */
+    void stop();
+
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Context of incoming request, null when the request is not traced
+     *
+     * Requests with traceparent follow sampling decision of the caller and continue its trace.
+     *
+     * @param traceparent header value, empty if not sent
+     */
+    std::shared_ptr<const TraceContext> startTrace(const std::string& traceparent);
+
+    void exportSpan(SpanData&& span);
+
+    uint64_t getDroppedSpansCount() const {
+        return droppedSpans.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Random non zero span or trace id part
+     */
+    static uint64_t generateId();
+};
+
+}  // namespace ovms
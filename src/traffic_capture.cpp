@@ -0,0 +1,130 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "traffic_capture.hpp"
+
+#include <limits>
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+static void appendLittleEndian(std::string& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+bool TrafficCapture::appendRecord(std::string& out, std::chrono::system_clock::time_point arrivalTime, const tensorflow::serving::PredictRequest& request) {
+    const size_t size = request.ByteSizeLong();
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    const auto arrivalUs = std::chrono::duration_cast<std::chrono::microseconds>(arrivalTime.time_since_epoch()).count();
+    out.reserve(out.size() + RECORD_HEADER_SIZE + size);
+    appendLittleEndian(out, static_cast<uint64_t>(arrivalUs), sizeof(uint64_t));
+    appendLittleEndian(out, size, sizeof(uint32_t));
+    return request.AppendToString(&out);
+}
+
+TrafficCapture::~TrafficCapture() {
+    stop();
+}
+
+bool TrafficCapture::start(const std::string& capturePath, double samplingRatio) {
+    stop();
+    std::lock_guard<std::mutex> lock(mtx);
+    file.open(capturePath, std::ios::binary | std::ios::app);
+    if (!file) {
+        SPDLOG_ERROR("Unable to open traffic capture file {}", capturePath);
+        return false;
+    }
+    // new capture file starts with magic, records of further runs are appended after existing ones
+    if (file.tellp() == 0) {
+        file.write(MAGIC, MAGIC_SIZE);
+    }
+    this->capturePath = capturePath;
+    this->samplingRatio = samplingRatio;
+    exiting = false;
+    writer = std::thread(&TrafficCapture::writeRoutine, this);
+    enabled.store(true, std::memory_order_relaxed);
+    SPDLOG_INFO("Capturing requests to {}, sampling ratio: {}", capturePath, samplingRatio);
+    return true;
+}
+
+void TrafficCapture::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!writer.joinable()) {
+            return;
+        }
+        enabled.store(false, std::memory_order_relaxed);
+        exiting = true;
+    }
+    writeCondition.notify_one();
+    writer.join();
+    file.close();
+    SPDLOG_INFO("Captured {} requests to {}, dropped: {}", getCapturedRequestsCount(), capturePath, getDroppedRequestsCount());
+}
+
+void TrafficCapture::capture(const tensorflow::serving::PredictRequest& request) {
+    if (!isEnabled()) {
+        return;
+    }
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    if (std::uniform_real_distribution<double>(0, 1)(generator) >= samplingRatio) {
+        return;
+    }
+    // serialized outside of the lock, request threads only contend for copying the record
+    std::string record;
+    if (!appendRecord(record, std::chrono::system_clock::now(), request)) {
+        droppedRequests.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (exiting || pending.size() + record.size() > MAX_PENDING_BYTES) {
+        droppedRequests.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending.append(record);
+    capturedRequests.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TrafficCapture::writeRoutine() {
+    std::string records;
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        writeCondition.wait_for(lock, WRITE_INTERVAL, [this]() { return exiting; });
+        records.swap(pending);
+        bool exit = exiting;
+        lock.unlock();
+        if (!records.empty()) {
+            file.write(records.data(), static_cast<std::streamsize>(records.size()));
+            file.flush();
+            if (!file) {
+                SPDLOG_WARN("Unable to write {} bytes of captured requests to {}", records.size(), capturePath);
+                file.clear();
+            }
+            records.clear();
+        }
+        if (exit) {
+            return;
+        }
+        lock.lock();
+    }
+}
+
+}  // namespace ovms
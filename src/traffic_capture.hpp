@@ -0,0 +1,110 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+namespace ovms {
+
+/**
+ * @brief Samples predict requests and appends them to capture file to be replayed by load generator
+ *
+ * File starts with 8 bytes of MAGIC, followed by records of little endian uint64 arrival time in microseconds
+ * since Unix epoch, little endian uint32 size and serialized PredictRequest of that size.
+ * Request threads serialize sampled requests into a bounded buffer, background thread appends it to the file.
+ * Requests are dropped when the buffer is full.
+ */
+class TrafficCapture {
+    static constexpr size_t MAX_PENDING_BYTES = 256 * 1024 * 1024;
+    static constexpr std::chrono::milliseconds WRITE_INTERVAL{1000};
+
+    std::atomic<bool> enabled{false};
+    double samplingRatio = 0;
+    std::string capturePath;
+    std::ofstream file;
+
+    std::mutex mtx;
+    std::condition_variable writeCondition;
+    std::string pending;
+    bool exiting = false;
+    std::thread writer;
+    std::atomic<uint64_t> capturedRequests{0};
+    std::atomic<uint64_t> droppedRequests{0};
+
+    void writeRoutine();
+
+public:
+    static constexpr const char MAGIC[] = "OVMSCAP1";
+    static constexpr size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+    static constexpr size_t RECORD_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+    static TrafficCapture& instance() {
+        static TrafficCapture capture;
+        return capture;
+    }
+
+    ~TrafficCapture();
+
+    /**
+     * @brief Starts capturing requests with given probability, appending to existing capture file
+     *
+     * @return false if capture file cannot be opened
+     */
+    bool start(const std::string& capturePath, double samplingRatio);
+
+    /**
+     * @brief Writes pending requests and stops capturing
+     */
+    void stop();
+
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Captures request if it is sampled, arrival time is the time of the call
+     */
+    void capture(const tensorflow::serving::PredictRequest& request);
+
+    uint64_t getCapturedRequestsCount() const {
+        return capturedRequests.load(std::memory_order_relaxed);
+    }
+
+    uint64_t getDroppedRequestsCount() const {
+        return droppedRequests.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Serializes request as a capture file record
+     *
+     * @return false if request is too large for a record
+     */
+    static bool appendRecord(std::string& out, std::chrono::system_clock::time_point arrivalTime, const tensorflow::serving::PredictRequest& request);
+};
+
+}  // namespace ovms
@@ -0,0 +1,52 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+
+// Static tracepoints of provider ovms, attached to at runtime by bpftrace, perf or other USDT consumers.
+// With systemtap sdt.h available at build time each tracepoint is a single nop instruction with its arguments
+// described in an ELF note, so tracepoints cost nothing until attached. Without it they compile to nothing.
+// Tracepoints and their arguments are listed in docs/tracepoints.md.
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>) && !defined(OVMS_DISABLE_USDT)
+#include <sys/sdt.h>
+#define OVMS_USDT_ENABLED 1
+#endif
+#endif
+
+#ifdef OVMS_USDT_ENABLED
+#define OVMS_TRACEPOINT(name, ...) STAP_PROBEV(ovms, name, __VA_ARGS__)
+#else
+// arguments are referenced in unevaluated context only, so they are neither computed nor reported as unused
+#define OVMS_TRACEPOINT(name, ...) static_cast<void>(sizeof(ovms::tracepointArguments(__VA_ARGS__)))
+#endif
+
+namespace ovms {
+
+template <typename... Args>
+inline int tracepointArguments(const Args&...) {
+    return 0;
+}
+
+/**
+ * @brief Identifier of request in tracepoint arguments, address of its response which stays the same through all stages
+ */
+inline uint64_t tracepointRequestId(const void* response) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(response));
+}
+
+}  // namespace ovms
@@ -0,0 +1,179 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "workerpool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <memory>
+#include <utility>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "logging.hpp"
+
+namespace ovms {
+
+WorkerPool::WorkerPool(size_t maxThreads, std::vector<int> cpuAffinity, std::optional<int> niceness) :
+    maxThreads(std::max<size_t>(1, maxThreads)),
+    cpuAffinity(std::move(cpuAffinity)),
+    niceness(niceness) {}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::schedule(std::function<void()> task) {
+    std::unique_lock<std::mutex> lock(mtx);
+    tasks.push(std::move(task));
+    if (idleThreads < tasks.size() && threads.size() < maxThreads) {
+        threads.emplace_back(&WorkerPool::workerRoutine, this);
+    }
+    lock.unlock();
+    cv.notify_one();
+}
+
+size_t WorkerPool::getThreadsCount() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return threads.size();
+}
+
+namespace {
+struct ParallelForState {
+    std::atomic<size_t> next;
+    size_t end;
+    std::atomic<bool> failed{false};
+    const std::function<bool(size_t)>* task;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t active = 0;
+    bool closed = false;
+};
+
+void runParallelForTasks(ParallelForState& state) {
+    for (size_t i = state.next++; i < state.end && !state.failed; i = state.next++) {
+        if (!(*state.task)(i)) {
+            state.failed = true;
+        }
+    }
+}
+}  // namespace
+
+void WorkerPool::parallelFor(WorkerPool* pool, size_t begin, size_t end, const std::function<bool(size_t)>& task) {
+    auto state = std::make_shared<ParallelForState>();
+    state->next = begin;
+    state->end = end;
+    state->task = &task;
+    if (pool != nullptr && end > begin + 1) {
+        const size_t helpers = std::min<size_t>(pool->maxThreads, end - begin - 1);
+        for (size_t i = 0; i < helpers; i++) {
+            pool->schedule([state]() {
+                {
+                    std::lock_guard<std::mutex> lock(state->mtx);
+                    if (state->closed) {
+                        return;
+                    }
+                    ++state->active;
+                }
+                runParallelForTasks(*state);
+                {
+                    std::lock_guard<std::mutex> lock(state->mtx);
+                    --state->active;
+                }
+                state->cv.notify_all();
+            });
+        }
+    }
+    runParallelForTasks(*state);
+    std::unique_lock<std::mutex> lock(state->mtx);
+    state->closed = true;
+    state->cv.wait(lock, [&state]() { return state->active == 0; });
+}
+
+void WorkerPool::pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &cpuSet);
+    }
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (result != 0) {
+        SPDLOG_WARN("Failed to set CPU affinity of worker thread, error: {}", result);
+    }
+}
+
+void WorkerPool::runPinned(const std::vector<int>& cpus, const std::function<void()>& function) {
+    cpu_set_t previous;
+    if (cpus.empty() || pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) != 0) {
+        function();
+        return;
+    }
+    pinCurrentThread(cpus);
+    function();
+    pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+}
+
+void WorkerPool::setCurrentThreadBackground(int niceness) {
+    sched_param param{};
+    param.sched_priority = 0;
+    int result = pthread_setschedparam(pthread_self(), SCHED_BATCH, &param);
+    if (result != 0) {
+        SPDLOG_WARN("Failed to set SCHED_BATCH policy of worker thread, error: {}", result);
+    }
+    // on Linux nice value is an attribute of a thread
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, niceness) != 0) {
+        SPDLOG_WARN("Failed to set nice value: {} of worker thread, error: {}", niceness, errno);
+    }
+}
+
+void WorkerPool::workerRoutine() {
+    pinCurrentThread(cpuAffinity);
+    if (niceness) {
+        setCurrentThreadBackground(niceness.value());
+    }
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        ++idleThreads;
+        cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+        --idleThreads;
+        if (tasks.empty()) {
+            return;
+        }
+        auto task = std::move(tasks.front());
+        tasks.pop();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+}  // namespace ovms
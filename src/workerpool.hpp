@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Runs blocking tasks on threads spawned on demand
+ *
+ * A new thread is started only when no worker is idle, up to maxThreads.
+ * Above that limit tasks wait in queue. Threads are kept until the pool is destroyed,
+ * which waits for all scheduled tasks to finish. Threads can be pinned to set of CPU cores
+ * and can run with background priority.
+ */
+class WorkerPool {
+    const size_t maxThreads;
+    const std::vector<int> cpuAffinity;
+    const std::optional<int> niceness;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::queue<std::function<void()>> tasks;
+    std::vector<std::thread> threads;
+    size_t idleThreads = 0;
+    bool stopping = false;
+
+    void workerRoutine();
+
+public:
+    WorkerPool(size_t maxThreads, std::vector<int> cpuAffinity = {}, std::optional<int> niceness = std::nullopt);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void schedule(std::function<void()> task);
+
+    size_t getThreadsCount();
+
+    /**
+     * @brief Runs task for indexes from begin to end on calling thread and idle workers of pool
+     *
+     * Indexes are handed out in increasing order, after task returns false no more indexes are started.
+     * Helpers which did not start before calling thread is done are skipped, so the call never waits for queued tasks
+     * and can be nested in tasks of the same pool.
+     *
+     * @param pool nullptr runs all indexes on calling thread
+     */
+    static void parallelFor(WorkerPool* pool, size_t begin, size_t end, const std::function<bool(size_t)>& task);
+
+    /**
+     * @brief Pins calling thread to given CPU cores, empty set leaves affinity unchanged
+     */
+    static void pinCurrentThread(const std::vector<int>& cpus);
+
+    /**
+     * @brief Runs function with calling thread pinned to given CPU cores and restores its affinity afterwards
+     *
+     * Threads started by the function inherit the affinity, e.g. threads of libraries which cannot be pinned directly.
+     */
+    static void runPinned(const std::vector<int>& cpus, const std::function<void()>& function);
+
+    /**
+     * @brief Switches calling thread to SCHED_BATCH policy with given nice value, so it yields cores to other threads
+     */
+    static void setCurrentThreadBackground(int niceness);
+};
+
+}  // namespace ovms
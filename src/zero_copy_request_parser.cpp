@@ -0,0 +1,294 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "zero_copy_request_parser.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "shared_memory.hpp"
+
+namespace ovms {
+
+namespace {
+// field numbers of tensorflow_serving/apis/predict.proto and tensorflow/core/framework/tensor.proto
+constexpr uint32_t PREDICT_REQUEST_INPUTS_FIELD = 2;
+constexpr uint32_t MAP_ENTRY_KEY_FIELD = 1;
+constexpr uint32_t MAP_ENTRY_VALUE_FIELD = 2;
+constexpr uint32_t TENSOR_CONTENT_FIELD = 4;
+
+constexpr uint32_t WIRETYPE_VARINT = 0;
+constexpr uint32_t WIRETYPE_FIXED64 = 1;
+constexpr uint32_t WIRETYPE_LENGTH_DELIMITED = 2;
+constexpr uint32_t WIRETYPE_FIXED32 = 5;
+}  // namespace
+
+/**
+ * @brief Reads message split into gRPC slices, tracking position within the whole message
+ */
+class ZeroCopyRequestParser::SliceReader {
+    const std::vector<grpc::Slice>& slices;
+    size_t slice = 0;
+    size_t offset = 0;
+    size_t position = 0;
+
+    void skipExhaustedSlices() {
+        while (slice < slices.size() && offset == slices[slice].size()) {
+            ++slice;
+            offset = 0;
+        }
+    }
+
+    template <typename F>
+    bool consume(size_t size, F&& onChunk) {
+        while (size > 0) {
+            if (slice == slices.size()) {
+                return false;
+            }
+            const size_t chunk = std::min(size, slices[slice].size() - offset);
+            onChunk(slices[slice].begin() + offset, chunk);
+            size -= chunk;
+            offset += chunk;
+            position += chunk;
+            skipExhaustedSlices();
+        }
+        return true;
+    }
+
+public:
+    explicit SliceReader(const std::vector<grpc::Slice>& slices) :
+        slices(slices) {
+        skipExhaustedSlices();
+    }
+
+    size_t getPosition() const {
+        return position;
+    }
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            if (slice == slices.size()) {
+                return false;
+            }
+            const uint8_t byte = slices[slice].begin()[offset];
+            ++offset;
+            ++position;
+            skipExhaustedSlices();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool read(size_t size, char* destination) {
+        return consume(size, [&destination](const uint8_t* data, size_t chunk) {
+            std::memcpy(destination, data, chunk);
+            destination += chunk;
+        });
+    }
+
+    bool append(size_t size, std::string& destination) {
+        const size_t start = destination.size();
+        destination.resize(start + size);
+        return read(size, &destination[start]);
+    }
+
+    bool skip(size_t size) {
+        return consume(size, [](const uint8_t*, size_t) {});
+    }
+
+    /**
+     * @brief Gets size bytes starting at current position without advancing, nullptr if they do not lie in single slice
+     */
+    const uint8_t* getContiguous(size_t size) const {
+        if (slice == slices.size() || slices[slice].size() - offset < size) {
+            return nullptr;
+        }
+        return slices[slice].begin() + offset;
+    }
+
+    /**
+     * @brief Skips payload of field with given wire type, groups are not supported
+     */
+    bool skipField(uint32_t wireType) {
+        uint64_t value;
+        switch (wireType) {
+        case WIRETYPE_VARINT:
+            return readVarint(value);
+        case WIRETYPE_FIXED64:
+            return skip(8);
+        case WIRETYPE_LENGTH_DELIMITED:
+            return readVarint(value) && skip(value);
+        case WIRETYPE_FIXED32:
+            return skip(4);
+        default:
+            return false;
+        }
+    }
+};
+
+ZeroCopyRequestParser::~ZeroCopyRequestParser() {
+    for (const auto& name : regionNames) {
+        SharedMemoryRegistry::getInstance().unregisterRegion(name);
+    }
+}
+
+Status ZeroCopyRequestParser::parse(const grpc::ByteBuffer& buffer, tensorflow::serving::PredictRequest& request) {
+    slices = std::make_shared<std::vector<grpc::Slice>>();
+    if (!buffer.Dump(slices.get()).ok()) {
+        return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+    }
+    SliceReader reader(*slices);
+    // fields other than inputs are small and are parsed by protobuf at once
+    std::string otherFields;
+    const size_t end = buffer.Length();
+    while (reader.getPosition() < end) {
+        SliceReader fieldStart = reader;
+        uint64_t tag;
+        if (!reader.readVarint(tag)) {
+            return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+        }
+        if ((tag >> 3) == PREDICT_REQUEST_INPUTS_FIELD && (tag & 7) == WIRETYPE_LENGTH_DELIMITED) {
+            uint64_t length;
+            if (!reader.readVarint(length) || length > end - reader.getPosition()) {
+                return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+            }
+            auto status = parseInput(reader, reader.getPosition() + length, request);
+            if (!status.ok()) {
+                return status;
+            }
+            continue;
+        }
+        if (!reader.skipField(tag & 7) || !fieldStart.append(reader.getPosition() - fieldStart.getPosition(), otherFields)) {
+            return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+        }
+    }
+    if (!otherFields.empty() && !request.MergeFromString(otherFields)) {
+        return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+    }
+    return StatusCode::OK;
+}
+
+Status ZeroCopyRequestParser::parseInput(SliceReader& reader, size_t end, tensorflow::serving::PredictRequest& request) {
+    std::string name;
+    // serialized fields of tensor except content
+    std::string tensorFields;
+    const uint8_t* aliasedContent = nullptr;
+    size_t aliasedContentSize = 0;
+    std::string copiedContent;
+    bool hasCopiedContent = false;
+    while (reader.getPosition() < end) {
+        uint64_t tag;
+        uint64_t length;
+        if (!reader.readVarint(tag)) {
+            return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+        }
+        if ((tag >> 3) == MAP_ENTRY_KEY_FIELD && (tag & 7) == WIRETYPE_LENGTH_DELIMITED) {
+            name.clear();
+            if (!reader.readVarint(length) || length > end - reader.getPosition() || !reader.append(length, name)) {
+                return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+            }
+            continue;
+        }
+        if ((tag >> 3) != MAP_ENTRY_VALUE_FIELD || (tag & 7) != WIRETYPE_LENGTH_DELIMITED) {
+            if (!reader.skipField(tag & 7)) {
+                return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+            }
+            continue;
+        }
+        // repeated value of map entry replaces the previous one
+        tensorFields.clear();
+        aliasedContent = nullptr;
+        hasCopiedContent = false;
+        if (!reader.readVarint(length) || length > end - reader.getPosition()) {
+            return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+        }
+        const size_t tensorEnd = reader.getPosition() + length;
+        while (reader.getPosition() < tensorEnd) {
+            SliceReader fieldStart = reader;
+            if (!reader.readVarint(tag)) {
+                return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+            }
+            if ((tag >> 3) == TENSOR_CONTENT_FIELD && (tag & 7) == WIRETYPE_LENGTH_DELIMITED) {
+                if (!reader.readVarint(length) || length > tensorEnd - reader.getPosition()) {
+                    return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+                }
+                if (length >= minAliasedContentSize) {
+                    aliasedContent = reader.getContiguous(length);
+                    aliasedContentSize = length;
+                    hasCopiedContent = aliasedContent == nullptr;
+                    if (hasCopiedContent) {
+                        copiedContent.clear();
+                        if (!reader.append(length, copiedContent)) {
+                            return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+                        }
+                    } else if (!reader.skip(length)) {
+                        return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+                    }
+                    continue;
+                }
+                // small content is parsed together with other fields, the last content wins
+                aliasedContent = nullptr;
+                hasCopiedContent = false;
+                if (!reader.skip(length) || !fieldStart.append(reader.getPosition() - fieldStart.getPosition(), tensorFields)) {
+                    return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+                }
+                continue;
+            }
+            if (!reader.skipField(tag & 7) || !fieldStart.append(reader.getPosition() - fieldStart.getPosition(), tensorFields)) {
+                return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+            }
+        }
+        if (reader.getPosition() != tensorEnd) {
+            return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+        }
+    }
+    if (reader.getPosition() != end) {
+        return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+    }
+
+    auto& tensor = (*request.mutable_inputs())[name];
+    tensor.Clear();
+    if (!tensor.ParseFromString(tensorFields)) {
+        return StatusCode::GRPC_REQUEST_PARSING_FAILED;
+    }
+    for (const auto& handle : tensor.resource_handle_val()) {
+        if (handle.device() == SHARED_MEMORY_DEVICE && isRequestRegionName(handle.name())) {
+            SPDLOG_DEBUG("Input: {} references shared memory region: {} reserved for server", name, handle.name());
+            return Status(StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, "Region: " + handle.name());
+        }
+    }
+    if (hasCopiedContent) {
+        tensor.mutable_tensor_content()->swap(copiedContent);
+    } else if (aliasedContent != nullptr) {
+        const std::string regionName = generateRequestRegionName();
+        auto status = SharedMemoryRegistry::getInstance().registerRequestRegion(regionName,
+            const_cast<char*>(reinterpret_cast<const char*>(aliasedContent)), aliasedContentSize, slices);
+        if (!status.ok()) {
+            return status;
+        }
+        regionNames.push_back(regionName);
+        setSharedMemoryReference(tensor, regionName, 0);
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/slice.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Parses serialized PredictRequest received by gRPC without copying large tensor_content of inputs
+ *
+ * tensor_content placed within single slice of the message is not copied into the request. It is registered
+ * as request region of SharedMemoryRegistry and the input references it like inputs placed in shared memory
+ * by co-located clients, so validation and deserialization wrap message memory into blobs.
+ * Blobs keep the message slices alive, regions are unregistered when the parser is destroyed.
+ * Smaller content and content split between slices is copied, the latter directly into the request.
+ */
+class ZeroCopyRequestParser {
+public:
+    static constexpr size_t MIN_ALIASED_CONTENT_SIZE = 64 * 1024;
+
+    explicit ZeroCopyRequestParser(size_t minAliasedContentSize = MIN_ALIASED_CONTENT_SIZE) :
+        minAliasedContentSize(minAliasedContentSize) {}
+    ~ZeroCopyRequestParser();
+
+    ZeroCopyRequestParser(const ZeroCopyRequestParser&) = delete;
+    ZeroCopyRequestParser& operator=(const ZeroCopyRequestParser&) = delete;
+
+    /**
+     * @brief Parses message into request, parser has to outlive use of the request
+     *
+     * @return Status
+     */
+    Status parse(const grpc::ByteBuffer& buffer, tensorflow::serving::PredictRequest& request);
+
+    /**
+     * @brief Number of inputs referencing message memory instead of holding a copy of it
+     */
+    size_t getAliasedInputsCount() const {
+        return regionNames.size();
+    }
+
+private:
+    const size_t minAliasedContentSize;
+    std::shared_ptr<std::vector<grpc::Slice>> slices;
+    std::vector<std::string> regionNames;
+
+    class SliceReader;
+
+    Status parseInput(SliceReader& reader, size_t end, tensorflow::serving::PredictRequest& request);
+};
+
+}  // namespace ovms
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import os
+import sys
+import json
+import time
+import shutil
+import argparse
+import tempfile
+import subprocess
+import urllib.error
+import urllib.request
+import numpy as np
+
+REPO_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..'))
+REGRESSION_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'regression')
+CONTAINER_NAME = 'ovms_perf_regression'
+
+parser = argparse.ArgumentParser(
+    description='Starts model server with reference configurations, drives them with open-loop load generator'
+                ' and compares throughput and tail latency with stored baselines.')
+parser.add_argument('--ovms_image', required=False, default='openvino/model_server:latest',
+                    help='Model server docker image. default: openvino/model_server:latest')
+parser.add_argument('--load_generator_image', required=False, default='cpp_clients_build_image:latest',
+                    help='Image built in example_client/cpp. default: cpp_clients_build_image:latest')
+parser.add_argument('--scenarios', required=False, default=os.path.join(REGRESSION_DIR, 'scenarios.json'),
+                    help='Scenarios definition file')
+parser.add_argument('--baselines', required=False, default=os.path.join(REGRESSION_DIR, 'baselines.json'),
+                    help='Baselines file')
+parser.add_argument('--only', required=False, default='',
+                    help='Comma separated list of scenarios to run, all by default')
+parser.add_argument('--grpc_port', required=False, default=9178, type=int,
+                    help='Model server gRPC port. default: 9178')
+parser.add_argument('--rest_port', required=False, default=8178, type=int,
+                    help='Model server REST port. default: 8178')
+parser.add_argument('--duration', required=False, default=30, type=float,
+                    help='Duration of each load phase in seconds. default: 30')
+parser.add_argument('--update_baselines', required=False, action='store_true',
+                    help='Store measured values as new baselines instead of comparing')
+parser.add_argument('--summary', required=False, default='',
+                    help='Path to JSON summary with measured values and comparison results')
+args = vars(parser.parse_args())
+
+
+def run(command, check=True):
+    print('[--] ' + ' '.join(command))
+    return subprocess.run(command, check=check, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+
+
+def prepare_data(scenario, work_dir):
+    data = scenario['data']
+    if data['type'] == 'npy':
+        path = os.path.join(work_dir, 'input.npy')
+        # Fixed seed keeps the payload identical between runs
+        np.random.seed(0)
+        np.save(path, np.random.rand(*data['shape']).astype(data['dtype']))
+        return ['--npy_files=/data/input.npy']
+    images_dir = os.path.join(REPO_ROOT, data['path'])
+    shutil.copytree(images_dir, os.path.join(work_dir, 'images'))
+    with open(os.path.join(work_dir, 'images.txt'), 'w') as images_list:
+        for image in sorted(os.listdir(images_dir)):
+            images_list.write('/data/images/{}\n'.format(image))
+    return ['--images_list=/data/images.txt']
+
+
+def start_ovms(scenario, work_dir):
+    with open(os.path.join(work_dir, 'config.json'), 'w') as config:
+        json.dump(scenario['config'], config)
+    command = ['docker', 'run', '-d', '--name', CONTAINER_NAME,
+               '-v', '{}:/config:ro'.format(work_dir),
+               '-p', '{0}:{0}'.format(args['grpc_port']),
+               '-p', '{0}:{0}'.format(args['rest_port'])]
+    for name, path in scenario['models'].items():
+        model_path = os.path.join(REPO_ROOT, os.path.expandvars(path))
+        command += ['-v', '{}:/models/{}:ro'.format(model_path, name)]
+    command += [args['ovms_image'], '--config_path', '/config/config.json',
+                '--port', str(args['grpc_port']), '--rest_port', str(args['rest_port'])]
+    run(command)
+    wait_for_servable(scenario['load']['model_name'])
+
+
+def wait_for_servable(name, timeout=120):
+    url = 'http://localhost:{}/v1/models/{}/metadata'.format(args['rest_port'], name)
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            with urllib.request.urlopen(url, timeout=5) as response:
+                if response.status == 200:
+                    return
+        except (urllib.error.URLError, ConnectionError):
+            pass
+        time.sleep(1)
+    logs = run(['docker', 'logs', CONTAINER_NAME], check=False).stdout
+    raise RuntimeError('{} is not available after {}s, server logs:\n{}'.format(name, timeout, logs))
+
+
+def stop_ovms():
+    run(['docker', 'rm', '--force', CONTAINER_NAME], check=False)
+
+
+def generate_load(scenario, work_dir, data_args, phase, rate):
+    load = scenario['load']
+    report = '{}.json'.format(phase)
+    command = ['docker', 'run', '--rm', '--network', 'host', '-v', '{}:/data'.format(work_dir),
+               '--entrypoint', '/build/bazel-bin/src/load_generator', args['load_generator_image'],
+               '--grpc_port={}'.format(args['grpc_port']), '--rest_port={}'.format(args['rest_port']),
+               '--protocol={}'.format(load['protocol']), '--model_name={}'.format(load['model_name']),
+               '--input_name={}'.format(load['input_name']), '--connections={}'.format(load['connections']),
+               '--rate={}'.format(rate), '--duration={}'.format(args['duration']),
+               '--report=/data/{}'.format(report)] + data_args
+    for option in ['sequence_length', 'concurrent_sequences']:
+        if option in load:
+            command.append('--{}={}'.format(option, load[option]))
+    result = run(command, check=False)
+    if result.returncode != 0:
+        raise RuntimeError('Load generator failed:\n' + result.stdout)
+    with open(os.path.join(work_dir, report)) as report_file:
+        return json.load(report_file)
+
+
+def measure(scenario):
+    """
+    Latency is measured at rate the deployment is expected to sustain,
+    throughput as rate of completed requests when offered load exceeds capacity.
+    """
+    work_dir = tempfile.mkdtemp(prefix='ovms_perf_')
+    try:
+        data_args = prepare_data(scenario, work_dir)
+        stop_ovms()
+        start_ovms(scenario, work_dir)
+        latency = generate_load(scenario, work_dir, data_args, 'latency', scenario['load']['latency_rate'])
+        saturation = generate_load(scenario, work_dir, data_args, 'saturation', scenario['load']['saturation_rate'])
+    finally:
+        stop_ovms()
+        shutil.rmtree(work_dir, ignore_errors=True)
+    return {
+        'throughput': saturation['achieved_rate'],
+        'p99_us': latency['latency_us']['p99'],
+        'p99.9_us': latency['latency_us']['p99.9'],
+        'latency_phase_errors': latency['errors'],
+    }
+
+
+def compare(name, measured, baseline, tolerance):
+    checks = []
+    if measured['latency_phase_errors'] > 0:
+        checks.append((name, 'errors', 0, measured['latency_phase_errors'], 'FAIL'))
+    if baseline is None:
+        for metric in ['throughput', 'p99_us', 'p99.9_us']:
+            checks.append((name, metric, None, measured[metric], 'NO BASELINE'))
+        return checks
+    for metric in ['throughput', 'p99_us', 'p99.9_us']:
+        if metric == 'throughput':
+            passed = measured[metric] >= baseline[metric] * (1 - tolerance[metric])
+        else:
+            passed = measured[metric] <= baseline[metric] * (1 + tolerance[metric])
+        checks.append((name, metric, baseline[metric], measured[metric], 'PASS' if passed else 'FAIL'))
+    return checks
+
+
+def print_summary(checks):
+    print('\n{:<24} {:<12} {:>14} {:>14} {:>9}  {}'.format('scenario', 'metric', 'baseline', 'measured', 'change', 'result'))
+    for name, metric, baseline, value, result in checks:
+        change = '{:+.1f}%'.format((value - baseline) * 100 / baseline) if baseline else '-'
+        print('{:<24} {:<12} {:>14} {:>14.1f} {:>9}  {}'.format(
+            name, metric, '-' if baseline is None else '{:.1f}'.format(baseline), value, change, result))
+
+
+with open(args['scenarios']) as f:
+    scenarios = json.load(f)['scenarios']
+with open(args['baselines']) as f:
+    baselines = json.load(f)
+if args['only']:
+    selected = args['only'].split(',')
+    scenarios = [scenario for scenario in scenarios if scenario['name'] in selected]
+
+results = {}
+checks = []
+for scenario in scenarios:
+    print('[--] Running scenario {}'.format(scenario['name']))
+    results[scenario['name']] = measure(scenario)
+    checks += compare(scenario['name'], results[scenario['name']],
+                      baselines['scenarios'].get(scenario['name']), baselines['tolerance'])
+
+print_summary(checks)
+if args['summary']:
+    with open(args['summary'], 'w') as f:
+        json.dump({'results': results, 'checks': [dict(zip(['scenario', 'metric', 'baseline', 'measured', 'result'], check))
+                                                  for check in checks]}, f, indent=4)
+
+if args['update_baselines']:
+    for name, measured in results.items():
+        baselines['scenarios'][name] = {metric: measured[metric] for metric in ['throughput', 'p99_us', 'p99.9_us']}
+    with open(args['baselines'], 'w') as f:
+        json.dump(baselines, f, indent=4)
+        f.write('\n')
+    print('[--] Baselines saved to {}'.format(args['baselines']))
+    sys.exit(0)
+
+failed = [check for check in checks if check[4] == 'FAIL']
+print('\n[--] {}: {} of {} checks failed'.format('FAILED' if failed else 'PASSED', len(failed), len(checks)))
+sys.exit(1 if failed else 0)